@@ -52,6 +52,8 @@
 #include "utils/error_injection.hh"
 #include "db/schema_tables.hh"
 #include "utils/rjson.hh"
+#include "utils/chunked_vector.hh"
+#include <seastar/coroutine/maybe_yield.hh>
 
 using namespace std::chrono_literals;
 
@@ -128,6 +130,50 @@ json::json_return_type make_streamed(rjson::value&& value) {
     return func;
 }
 
+// Like make_streamed(), but for a Query or Scan response whose items are
+// kept in a chunked vector instead of in a single JSON array: the members of
+// "descr" are written first, and then each item is serialized straight to the
+// output stream and freed, so neither a huge contiguous JSON array nor a copy
+// of the entire response is ever held in memory.
+static json::json_return_type make_streamed_items(rjson::value&& descr, utils::chunked_vector<rjson::value>&& items) {
+    auto rs = make_shared<std::tuple<rjson::value, utils::chunked_vector<rjson::value>>>(std::move(descr), std::move(items));
+    std::function<future<>(output_stream<char>&&)> func = [rs](output_stream<char>&& os) mutable -> future<> {
+        auto los = std::move(os);
+        auto lrs = std::move(rs);
+        auto& [ldescr, litems] = *lrs;
+        std::exception_ptr ex;
+        try {
+            co_await los.write("{");
+            for (const auto& m : ldescr.GetObject()) {
+                co_await rjson::print(m.name, los);
+                co_await los.write(":");
+                co_await rjson::print(m.value, los);
+                co_await los.write(",");
+            }
+            co_await los.write("\"Items\":[");
+            for (size_t i = 0; i < litems.size(); ++i) {
+                if (i) {
+                    co_await los.write(",");
+                }
+                rjson::value item = std::move(litems[i]);
+                co_await rjson::print(item, los);
+                co_await coroutine::maybe_yield();
+            }
+            co_await los.write("]}");
+        } catch (...) {
+            // See make_streamed() - the headers were already sent, so all
+            // we can do is log and let the connection be closed.
+            ex = std::current_exception();
+            elogger.error("Exception during streaming HTTP response: {}", ex);
+        }
+        co_await los.close();
+        if (ex) {
+            co_await coroutine::return_exception_ptr(std::move(ex));
+        }
+    };
+    return func;
+}
+
 json_string::json_string(std::string&& value)
     : _value(std::move(value))
 {}
@@ -1925,6 +1971,10 @@ struct schema_decorated_key_equal {
     }
 };
 
+// The maximum number of partitions of a BatchWriteItem written concurrently
+// with LWT. Each of them may be bounced to the shard owning its token.
+static constexpr size_t max_concurrent_batch_lwt_writes = 16;
+
 // FIXME: if we failed writing some of the mutations, need to return a list
 // of these failed mutations rather than fail the whole write (issue #5650).
 static future<> do_batch_write(service::storage_proxy& proxy,
@@ -1946,12 +1996,23 @@ static future<> do_batch_write(service::storage_proxy& proxy,
         return rmw_operation::get_write_isolation_for_schema(schema) == rmw_operation::write_isolation::LWT_ALWAYS;
     });
     if (!needs_lwt) {
-        // Do a normal write, without LWT:
-        std::vector<mutation> mutations;
-        mutations.reserve(mutation_builders.size());
+        // Do a normal write, without LWT.
+        // Items written to the same partition are merged into one mutation,
+        // so that each replica applies the partition's writes once.
+        std::unordered_map<schema_decorated_key, mutation, schema_decorated_key_hash, schema_decorated_key_equal>
+            partition_mutations(mutation_builders.size(), schema_decorated_key_hash{}, schema_decorated_key_equal{});
         api::timestamp_type now = api::new_timestamp();
         for (auto& b : mutation_builders) {
-            mutations.push_back(b.second.build(b.first, now));
+            mutation m = b.second.build(b.first, now);
+            auto [it, added] = partition_mutations.try_emplace(schema_decorated_key{b.first, m.decorated_key()}, std::move(m));
+            if (!added) {
+                it->second.apply(std::move(m));
+            }
+        }
+        std::vector<mutation> mutations;
+        mutations.reserve(partition_mutations.size());
+        for (auto& [_, m] : partition_mutations) {
+            mutations.push_back(std::move(m));
         }
         return proxy.mutate(std::move(mutations),
                 db::consistency_level::LOCAL_QUORUM,
@@ -1971,34 +2032,36 @@ static future<> do_batch_write(service::storage_proxy& proxy,
             auto [it, added] = key_builders.try_emplace(schema_decorated_key{b.first, dk});
             it->second.push_back(std::move(b.second));
         }
-        return parallel_for_each(std::move(key_builders), [&proxy, &client_state, &stats, trace_state, ssg, permit = std::move(permit)] (auto& e) {
-            stats.write_using_lwt++;
-            auto desired_shard = service::storage_proxy::cas_shard(*e.first.schema, e.first.dk.token());
-            if (desired_shard == this_shard_id()) {
-                return cas_write(proxy, e.first.schema, e.first.dk, std::move(e.second), client_state, trace_state, permit);
-            } else {
-                stats.shard_bounce_for_lwt++;
-                return proxy.container().invoke_on(desired_shard, ssg,
-                            [cs = client_state.move_to_other_shard(),
-                             mb = e.second,
-                             dk = e.first.dk,
-                             ks = e.first.schema->ks_name(),
-                             cf = e.first.schema->cf_name(),
-                             gt =  tracing::global_trace_state_ptr(trace_state),
-                             permit = std::move(permit)]
-                            (service::storage_proxy& proxy) mutable {
-                    return do_with(cs.get(), [&proxy, mb = std::move(mb), dk = std::move(dk), ks = std::move(ks), cf = std::move(cf),
-                                              trace_state = tracing::trace_state_ptr(gt)]
-                                              (service::client_state& client_state) mutable {
-                        auto schema = proxy.data_dictionary().find_schema(ks, cf);
-                        //FIXME: A corresponding FIXME can be found in transport/server.cc when a message must be bounced
-                        // to another shard - once it is solved, this place can use a similar solution. Instead of passing
-                        // empty_service_permit() to the background operation, the current permit's lifetime should be prolonged,
-                        // so that it's destructed only after all background operations are finished as well.
-                        return cas_write(proxy, schema, dk, std::move(mb), client_state, std::move(trace_state), empty_service_permit());
+        return do_with(std::move(key_builders), [&proxy, &client_state, &stats, trace_state, ssg, permit = std::move(permit)] (auto& key_builders) mutable {
+            return max_concurrent_for_each(key_builders, max_concurrent_batch_lwt_writes, [&proxy, &client_state, &stats, trace_state, ssg, permit] (auto& e) {
+                stats.write_using_lwt++;
+                auto desired_shard = service::storage_proxy::cas_shard(*e.first.schema, e.first.dk.token());
+                if (desired_shard == this_shard_id()) {
+                    return cas_write(proxy, e.first.schema, e.first.dk, std::move(e.second), client_state, trace_state, permit);
+                } else {
+                    stats.shard_bounce_for_lwt++;
+                    return proxy.container().invoke_on(desired_shard, ssg,
+                                [cs = client_state.move_to_other_shard(),
+                                 mb = e.second,
+                                 dk = e.first.dk,
+                                 ks = e.first.schema->ks_name(),
+                                 cf = e.first.schema->cf_name(),
+                                 gt =  tracing::global_trace_state_ptr(trace_state),
+                                 permit = std::move(permit)]
+                                (service::storage_proxy& proxy) mutable {
+                        return do_with(cs.get(), [&proxy, mb = std::move(mb), dk = std::move(dk), ks = std::move(ks), cf = std::move(cf),
+                                                  trace_state = tracing::trace_state_ptr(gt)]
+                                                  (service::client_state& client_state) mutable {
+                            auto schema = proxy.data_dictionary().find_schema(ks, cf);
+                            //FIXME: A corresponding FIXME can be found in transport/server.cc when a message must be bounced
+                            // to another shard - once it is solved, this place can use a similar solution. Instead of passing
+                            // empty_service_permit() to the background operation, the current permit's lifetime should be prolonged,
+                            // so that it's destructed only after all background operations are finished as well.
+                            return cas_write(proxy, schema, dk, std::move(mb), client_state, std::move(trace_state), empty_service_permit());
+                        });
                     });
-                });
-            }
+                }
+            });
         });
     }
 }
@@ -2402,6 +2465,69 @@ void executor::describe_single_item(const cql3::selection::selection& selection,
     }
 }
 
+// Like describe_single_item() above, but appends the JSON text of the item
+// to out directly: attributes are transcoded from their stored encoding with
+// no intermediate JSON document. Only attributes of which attrs_to_get asks
+// for just a part are still deserialized, to be trimmed by hierarchy_filter().
+static void describe_single_item_to_json(const cql3::selection::selection& selection,
+        const std::vector<managed_bytes_opt>& result_row,
+        const std::optional<attrs_to_get>& attrs_to_get,
+        std::string& out) {
+    bool first = true;
+    auto add_name = [&] (std::string_view name) {
+        if (!first) {
+            out.push_back(',');
+        }
+        first = false;
+        rjson::append_quoted_json_string(out, name);
+        out.push_back(':');
+    };
+    out.push_back('{');
+    const auto& columns = selection.get_columns();
+    auto column_it = columns.begin();
+    for (const managed_bytes_opt& cell : result_row) {
+        std::string column_name = (*column_it)->name_as_text();
+        if (cell && column_name != executor::ATTRS_COLUMN_NAME) {
+            if (!attrs_to_get || attrs_to_get->contains(column_name)) {
+                add_name(column_name);
+                out.push_back('{');
+                rjson::append_quoted_json_string(out, type_to_string((*column_it)->type));
+                out.push_back(':');
+                cell->with_linearized([&] (bytes_view linearized_cell) {
+                    out.append(rjson::print(json_key_column_value(linearized_cell, **column_it)));
+                });
+                out.push_back('}');
+            }
+        } else if (cell) {
+            auto deserialized = attrs_type()->deserialize(*cell);
+            auto keys_and_values = value_cast<map_type_impl::native_type>(deserialized);
+            for (auto entry : keys_and_values) {
+                std::string attr_name = value_cast<sstring>(entry.first);
+                bytes value = value_cast<bytes>(entry.second);
+                if (attrs_to_get) {
+                    auto it = attrs_to_get->find(attr_name);
+                    if (it == attrs_to_get->end()) {
+                        continue;
+                    }
+                    if (!it->second.has_value()) {
+                        rjson::value v = deserialize_item(value);
+                        if (!hierarchy_filter(v, it->second)) {
+                            continue;
+                        }
+                        add_name(attr_name);
+                        out.append(rjson::print(v));
+                        continue;
+                    }
+                }
+                add_name(attr_name);
+                deserialize_item_to_json(value, out);
+            }
+        }
+        ++column_it;
+    }
+    out.push_back('}');
+}
+
 std::optional<rjson::value> executor::describe_single_item(schema_ptr schema,
         const query::partition_slice& slice,
         const cql3::selection::selection& selection,
@@ -3112,22 +3238,29 @@ static db::consistency_level get_read_consistency(const rjson::value& request) {
     return consistent_read ? db::consistency_level::LOCAL_QUORUM : db::consistency_level::LOCAL_ONE;
 }
 
-// describe_item() wraps the result of describe_single_item() by a map
-// as needed by the GetItem request. It should not be used for other purposes,
-// use describe_single_item() instead.
-static rjson::value describe_item(schema_ptr schema,
+// describe_item() returns the JSON text of the response to the GetItem
+// request: the item read, as written by describe_single_item_to_json(),
+// wrapped by a map. It should not be used for other purposes.
+static std::string describe_item(schema_ptr schema,
         const query::partition_slice& slice,
         const cql3::selection::selection& selection,
         const query::result& query_result,
         const std::optional<attrs_to_get>& attrs_to_get) {
-    std::optional<rjson::value> opt_item = executor::describe_single_item(std::move(schema), slice, selection, std::move(query_result), attrs_to_get);
-    if (!opt_item) {
+    cql3::selection::result_set_builder builder(selection, gc_clock::now());
+    query::result_view::consume(query_result, slice, cql3::selection::result_set_builder::visitor(builder, *schema, selection));
+
+    auto result_set = builder.build();
+    if (result_set->empty()) {
         // If there is no matching item, we're supposed to return an empty
         // object without an Item member - not one with an empty Item member
-        return rjson::empty_object();
+        return "{}";
     }
-    rjson::value item_descr = rjson::empty_object();
-    rjson::add(item_descr, "Item", std::move(*opt_item));
+    if (result_set->size() > 1) {
+        throw std::logic_error("describe_item() asked to describe multiple items");
+    }
+    std::string item_descr = "{\"Item\":";
+    describe_single_item_to_json(selection, *result_set->rows().begin(), attrs_to_get, item_descr);
+    item_descr.push_back('}');
     return item_descr;
 }
 
@@ -3174,7 +3307,7 @@ future<executor::request_return_type> executor::get_item(client_state& client_st
             service::storage_proxy::coordinator_query_options(executor::default_timeout(), std::move(permit), client_state, trace_state)).then(
             [this, schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = std::move(attrs_to_get), start_time = std::move(start_time)] (service::storage_proxy::coordinator_query_result qr) mutable {
         _stats.api_operations.get_item_latency.add(std::chrono::steady_clock::now() - start_time);
-        return make_ready_future<executor::request_return_type>(make_jsonable(describe_item(schema, partition_slice, *selection, *qr.query_result, std::move(attrs_to_get))));
+        return make_ready_future<executor::request_return_type>(json_string(describe_item(schema, partition_slice, *selection, *qr.query_result, std::move(attrs_to_get))));
     });
 }
 
@@ -3194,6 +3327,22 @@ bool is_big(const rjson::value& val, int big_size) {
     return false;
 }
 
+// Like is_big(), for the items of a Query or Scan response which are not
+// (yet) gathered in a JSON array.
+static bool items_are_big(const utils::chunked_vector<rjson::value>& items, int big_size = 100'000) {
+    if (items.size() > size_t(big_size / 10)) {
+        return true;
+    }
+    int size_left = big_size - 10 * items.size();
+    for (const auto& item : items) {
+        check_big_object(item, size_left);
+        if (size_left < 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static void check_big_array(const rjson::value& val, int& size_left) {
     // Assume a fixed size of 10 bytes for each number, boolean, etc., or
     // beginning of a sub-object. This doesn't have to be accurate.
@@ -3289,36 +3438,62 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
         requests.emplace_back(std::move(rs));
     }
 
-    // If we got here, all "requests" are valid, so let's start the
-    // requests for the different partitions all in parallel.
-    std::vector<future<std::vector<rjson::value>>> response_futures;
+    // If we got here, all "requests" are valid, so let's start the reads,
+    // all in parallel. A table without a clustering key has a single item
+    // per partition and all its keys are fetched whole, so they are read by a
+    // single multi-partition query, with the keys in ring order. Reads from
+    // tables with a clustering key need a different clustering slice for each
+    // partition, so these are sent per partition.
+    struct read_group {
+        const table_requests& rs;
+        // The keys read by this group, to be listed in UnprocessedKeys if
+        // the read fails.
+        std::vector<const table_requests::clustering_keys*> keys;
+        future<std::vector<rjson::value>> result = make_ready_future<std::vector<rjson::value>>();
+    };
+    auto start_read = [&] (const table_requests& rs, dht::partition_range_vector partition_ranges, std::vector<query::clustering_range> bounds) {
+        auto regular_columns = boost::copy_range<query::column_id_vector>(
+                rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
+        auto selection = cql3::selection::selection::wildcard(rs.schema);
+        auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
+        auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice),
+                query::tombstone_limit(_proxy.get_tombstone_limit()));
+        command->allow_limit = db::allow_per_partition_rate_limit::yes;
+        return _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl,
+                service::storage_proxy::coordinator_query_options(executor::default_timeout(), permit, client_state, trace_state)).then(
+                [schema = rs.schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = rs.attrs_to_get] (service::storage_proxy::coordinator_query_result qr) mutable {
+            utils::get_local_injector().inject("alternator_batch_get_item", [] { throw std::runtime_error("batch_get_item injection"); });
+            return describe_multi_item(std::move(schema), std::move(partition_slice), std::move(selection), std::move(qr.query_result), std::move(attrs_to_get));
+        });
+    };
+    std::vector<read_group> read_groups;
     for (const auto& rs : requests) {
-        for (const auto &r : rs.requests) {
+        if (rs.schema->clustering_key_size() == 0) {
+            read_group group{rs};
+            dht::partition_range_vector partition_ranges;
+            partition_ranges.reserve(rs.requests.size());
+            group.keys.reserve(rs.requests.size());
+            for (const auto& r : rs.requests) {
+                partition_ranges.emplace_back(dht::decorate_key(*rs.schema, r.first));
+                group.keys.push_back(&r.second);
+            }
+            std::ranges::sort(partition_ranges, dht::ring_position_less_comparator(*rs.schema), [] (const dht::partition_range& pr) -> const dht::ring_position& {
+                return pr.start()->value();
+            });
+            std::vector<query::clustering_range> bounds{query::clustering_range::make_open_ended_both_sides()};
+            group.result = start_read(rs, std::move(partition_ranges), std::move(bounds));
+            read_groups.push_back(std::move(group));
+            continue;
+        }
+        for (const auto& r : rs.requests) {
             auto& pk = r.first;
             auto& cks = r.second;
             dht::partition_range_vector partition_ranges{dht::partition_range(dht::decorate_key(*rs.schema, pk))};
             std::vector<query::clustering_range> bounds;
-            if (rs.schema->clustering_key_size() == 0) {
-                bounds.push_back(query::clustering_range::make_open_ended_both_sides());
-            } else {
-                for (auto& ck : cks) {
-                    bounds.push_back(query::clustering_range::make_singular(ck.first));
-                }
+            for (auto& ck : cks) {
+                bounds.push_back(query::clustering_range::make_singular(ck.first));
             }
-            auto regular_columns = boost::copy_range<query::column_id_vector>(
-                    rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
-            auto selection = cql3::selection::selection::wildcard(rs.schema);
-            auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
-            auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, _proxy.get_max_result_size(partition_slice),
-                    query::tombstone_limit(_proxy.get_tombstone_limit()));
-            command->allow_limit = db::allow_per_partition_rate_limit::yes;
-            future<std::vector<rjson::value>> f = _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl,
-                    service::storage_proxy::coordinator_query_options(executor::default_timeout(), permit, client_state, trace_state)).then(
-                    [schema = rs.schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = rs.attrs_to_get] (service::storage_proxy::coordinator_query_result qr) mutable {
-                utils::get_local_injector().inject("alternator_batch_get_item", [] { throw std::runtime_error("batch_get_item injection"); });
-                return describe_multi_item(std::move(schema), std::move(partition_slice), std::move(selection), std::move(qr.query_result), std::move(attrs_to_get));
-            });
-            response_futures.push_back(std::move(f));
+            read_groups.push_back(read_group{rs, {&cks}, start_read(rs, std::move(partition_ranges), std::move(bounds))});
         }
     }
 
@@ -3332,43 +3507,38 @@ future<executor::request_return_type> executor::batch_get_item(client_state& cli
     rjson::add(response, "Responses", rjson::empty_object());
     rjson::add(response, "UnprocessedKeys", rjson::empty_object());
 
-    auto fut_it = response_futures.begin();
-    for (const auto& rs : requests) {
-        auto table = table_name(*rs.schema);
-        for (const auto &r : rs.requests) {
-            auto& pk = r.first;
-            auto& cks = r.second;
-            auto& fut = *fut_it;
-            ++fut_it;
-            try {
-                std::vector<rjson::value> results = co_await std::move(fut);
-                some_succeeded = true;
-                if (!response["Responses"].HasMember(table)) {
-                    rjson::add_with_string_name(response["Responses"], table, rjson::empty_array());
-                }
-                for (rjson::value& json : results) {
-                    rjson::push_back(response["Responses"][table], std::move(json));
-                }
-            } catch(...) {
-                eptr = std::current_exception();
-                // This read of potentially several rows in one partition,
-                // failed. We need to add the row key(s) to UnprocessedKeys.
-                if (!response["UnprocessedKeys"].HasMember(table)) {
-                    // Add the table's entry in UnprocessedKeys. Need to copy
-                    // all the table's parameters from the request except the
-                    // Keys field, which we start empty and then build below.
-                    rjson::add_with_string_name(response["UnprocessedKeys"], table, rjson::empty_object());
-                    rjson::value& unprocessed_item = response["UnprocessedKeys"][table];
-                    rjson::value& request_item = request_items[table];
-                    for (auto it = request_item.MemberBegin(); it != request_item.MemberEnd(); ++it) {
-                        if (it->name != "Keys") {
-                            rjson::add_with_string_name(unprocessed_item,
-                                rjson::to_string_view(it->name), rjson::copy(it->value));
-                        }
+    for (auto& group : read_groups) {
+        auto table = table_name(*group.rs.schema);
+        try {
+            std::vector<rjson::value> results = co_await std::move(group.result);
+            some_succeeded = true;
+            if (!response["Responses"].HasMember(table)) {
+                rjson::add_with_string_name(response["Responses"], table, rjson::empty_array());
+            }
+            for (rjson::value& json : results) {
+                rjson::push_back(response["Responses"][table], std::move(json));
+            }
+        } catch(...) {
+            eptr = std::current_exception();
+            // This read of potentially several rows in one or more partitions
+            // failed. We need to add the row key(s) to UnprocessedKeys.
+            if (!response["UnprocessedKeys"].HasMember(table)) {
+                // Add the table's entry in UnprocessedKeys. Need to copy
+                // all the table's parameters from the request except the
+                // Keys field, which we start empty and then build below.
+                rjson::add_with_string_name(response["UnprocessedKeys"], table, rjson::empty_object());
+                rjson::value& unprocessed_item = response["UnprocessedKeys"][table];
+                rjson::value& request_item = request_items[table];
+                for (auto it = request_item.MemberBegin(); it != request_item.MemberEnd(); ++it) {
+                    if (it->name != "Keys") {
+                        rjson::add_with_string_name(unprocessed_item,
+                            rjson::to_string_view(it->name), rjson::copy(it->value));
                     }
-                    rjson::add_with_string_name(unprocessed_item, "Keys", rjson::empty_array());
                 }
-                for (auto& ck : cks) {
+                rjson::add_with_string_name(unprocessed_item, "Keys", rjson::empty_array());
+            }
+            for (auto cks : group.keys) {
+                for (auto& ck : *cks) {
                     rjson::push_back(response["UnprocessedKeys"][table]["Keys"], std::move(*ck.second));
                 }
             }
@@ -3525,7 +3695,7 @@ class describe_items_visitor {
     const filter& _filter;
     typename columns_t::const_iterator _column_it;
     rjson::value _item;
-    rjson::value _items;
+    utils::chunked_vector<rjson::value> _items;
     size_t _scanned_count;
 
 public:
@@ -3535,7 +3705,6 @@ class describe_items_visitor {
             , _filter(filter)
             , _column_it(columns.begin())
             , _item(rjson::empty_object())
-            , _items(rjson::empty_array())
             , _scanned_count(0)
     {
         // _filter.check() may need additional attributes not listed in
@@ -3614,13 +3783,13 @@ class describe_items_visitor {
                 rjson::remove_member(_item, attr);
             }
 
-            rjson::push_back(_items, std::move(_item));
+            _items.push_back(std::move(_item));
         }
         _item = rjson::empty_object();
         ++_scanned_count;
     }
 
-    rjson::value get_items() && {
+    utils::chunked_vector<rjson::value> get_items() && {
         return std::move(_items);
     }
 
@@ -3629,13 +3798,17 @@ class describe_items_visitor {
     }
 };
 
-static std::tuple<rjson::value, size_t> describe_items(const cql3::selection::selection& selection, std::unique_ptr<cql3::result_set> result_set, std::optional<attrs_to_get>&& attrs_to_get, filter&& filter) {
+// The items are returned separately from the rest of the response description
+// (Count and ScannedCount), so that a large result can be streamed item by item
+// without first being gathered into a single JSON array. The items are not
+// returned at all (nullopt) if the user asked not to return any attributes.
+static std::tuple<rjson::value, std::optional<utils::chunked_vector<rjson::value>>, size_t> describe_items(const cql3::selection::selection& selection, std::unique_ptr<cql3::result_set> result_set, std::optional<attrs_to_get>&& attrs_to_get, filter&& filter) {
     describe_items_visitor visitor(selection.get_columns(), attrs_to_get, filter);
     result_set->visit(visitor);
     auto scanned_count = visitor.get_scanned_count();
-    rjson::value items = std::move(visitor).get_items();
+    utils::chunked_vector<rjson::value> items = std::move(visitor).get_items();
     rjson::value items_descr = rjson::empty_object();
-    auto size = items.Size();
+    auto size = items.size();
     rjson::add(items_descr, "Count", rjson::value(size));
     rjson::add(items_descr, "ScannedCount", rjson::value(scanned_count));
     // If attrs_to_get && attrs_to_get->empty(), this means the user asked not
@@ -3646,9 +3819,9 @@ static std::tuple<rjson::value, size_t> describe_items(const cql3::selection::se
     // it. We could just count the items and not bother with the empty items.
     // (However, remember that when we do have a filter, we need the items).
     if (!attrs_to_get || !attrs_to_get->empty()) {
-        rjson::add(items_descr, "Items", std::move(items));
+        return {std::move(items_descr), std::move(items), size};
     }
-    return {std::move(items_descr), size};
+    return {std::move(items_descr), std::nullopt, size};
 }
 
 static rjson::value encode_paging_state(const schema& schema, const service::pager::paging_state& paging_state) {
@@ -3743,19 +3916,26 @@ static future<executor::request_return_type> do_query(service::storage_proxy& pr
         }
         auto paging_state = rs->get_metadata().paging_state();
         bool has_filter = filter;
-        auto [items, size] = describe_items(*selection, std::move(rs), std::move(attrs_to_get), std::move(filter));
+        auto [descr, items, size] = describe_items(*selection, std::move(rs), std::move(attrs_to_get), std::move(filter));
         if (paging_state) {
-            rjson::add(items, "LastEvaluatedKey", encode_paging_state(*schema, *paging_state));
+            rjson::add(descr, "LastEvaluatedKey", encode_paging_state(*schema, *paging_state));
         }
         if (has_filter){
             cql_stats.filtered_rows_read_total += p->stats().rows_read_total;
             // update our "filtered_row_matched_total" for all the rows matched, despited the filter
             cql_stats.filtered_rows_matched_total += size;
         }
-        if (is_big(items)) {
-            return make_ready_future<executor::request_return_type>(make_streamed(std::move(items)));
+        if (items) {
+            if (items_are_big(*items)) {
+                return make_ready_future<executor::request_return_type>(make_streamed_items(std::move(descr), std::move(*items)));
+            }
+            rjson::value items_array = rjson::empty_array();
+            for (auto& item : *items) {
+                rjson::push_back(items_array, std::move(item));
+            }
+            rjson::add(descr, "Items", std::move(items_array));
         }
-        return make_ready_future<executor::request_return_type>(make_jsonable(std::move(items)));
+        return make_ready_future<executor::request_return_type>(make_jsonable(std::move(descr)));
     });
 }
 
@@ -4488,4 +4668,14 @@ future<> executor::start() {
     return make_ready_future<>();
 }
 
+future<> executor::stop() {
+    // disconnect from the value source, but keep the value unchanged.
+    s_default_timeout_in_ms = utils::updateable_value<uint32_t>{s_default_timeout_in_ms()};
+    for (auto& [_, p] : _prefetched_records) {
+        (void)std::move(p.response).discard_result().handle_exception([] (std::exception_ptr) {});
+    }
+    _prefetched_records.clear();
+    return _prefetch_gate.close();
+}
+
 }
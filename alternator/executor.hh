@@ -13,6 +13,8 @@
 #include "seastarx.hh"
 #include <seastar/json/json_elements.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
 
 #include "service/migration_manager.hh"
 #include "service/client_state.hh"
@@ -54,6 +56,7 @@ class gossiper;
 namespace alternator {
 
 class rmw_operation;
+struct shard_iterator;
 
 struct make_jsonable : public json::jsonable {
     rjson::value _value;
@@ -162,6 +165,15 @@ class executor : public peering_sharded_service<executor> {
     // An smp_service_group to be used for limiting the concurrency when
     // forwarding Alternator request between shards - if necessary for LWT.
     smp_service_group _ssg;
+    // GetRecords responses read ahead for the iterators returned by previous
+    // GetRecords calls, keyed by the iterator (see alternator_streams_prefetch).
+    struct prefetched_records {
+        size_t limit;
+        lowres_clock::time_point expires;
+        future<rjson::value> response;
+    };
+    std::unordered_map<sstring, prefetched_records> _prefetched_records;
+    seastar::gate _prefetch_gate;
 
 public:
     using client_state = service::client_state;
@@ -208,11 +220,7 @@ class executor : public peering_sharded_service<executor> {
     future<request_return_type> describe_continuous_backups(client_state& client_state, service_permit permit, rjson::value request);
 
     future<> start();
-    future<> stop() {
-        // disconnect from the value source, but keep the value unchanged.
-        s_default_timeout_in_ms = utils::updateable_value<uint32_t>{s_default_timeout_in_ms()};
-        return make_ready_future<>();
-    }
+    future<> stop();
 
     static sstring table_name(const schema&);
     static db::timeout_clock::time_point default_timeout();
@@ -224,6 +232,10 @@ class executor : public peering_sharded_service<executor> {
 private:
     friend class rmw_operation;
 
+    future<rjson::value> read_records(client_state& client_state, tracing::trace_state_ptr trace_state, service_permit permit, const shard_iterator& iter, size_t limit);
+    future<std::optional<rjson::value>> take_prefetched_records(std::string_view iterator, size_t limit);
+    void maybe_prefetch_records(const rjson::value& response, size_t limit);
+
     static void describe_key_schema(rjson::value& parent, const schema&, std::unordered_map<std::string,std::string> * = nullptr);
     
 public:
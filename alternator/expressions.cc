@@ -24,6 +24,7 @@
 #include <boost/algorithm/cxx11/all_of.hpp>
 
 #include <functional>
+#include <list>
 #include <unordered_map>
 
 namespace alternator {
@@ -65,19 +66,63 @@ static Result parse(const char* input_name, std::string_view input, Func&& f) {
     }
 }
 
+// Applications typically send the same few expressions over and over, with
+// different ExpressionAttributeValues, so the recently parsed expressions
+// are kept in a per-shard LRU cache. The cached expressions are the parser's
+// output, with the name and value placeholders still unresolved, so a cached
+// expression only depends on its text, and every request gets its own copy
+// to resolve. Expressions which fail to parse are not cached.
+template <typename T>
+class parsed_expression_cache {
+    static constexpr size_t max_entries = 256;
+    struct entry {
+        std::string text;
+        T parsed;
+    };
+    // Most recently used first.
+    std::list<entry> _entries;
+    std::unordered_map<std::string_view, typename std::list<entry>::iterator> _index;
+public:
+    template <typename Func>
+    T get(std::string_view text, Func&& parse) {
+        if (auto it = _index.find(text); it != _index.end()) {
+            _entries.splice(_entries.begin(), _entries, it->second);
+            return it->second->parsed;
+        }
+        T parsed = parse(text);
+        if (_entries.size() >= max_entries) {
+            _index.erase(_entries.back().text);
+            _entries.pop_back();
+        }
+        _entries.push_front(entry{std::string(text), parsed});
+        _index.emplace(_entries.front().text, _entries.begin());
+        return parsed;
+    }
+};
+
+static thread_local parsed_expression_cache<parsed::update_expression> update_expression_cache;
+static thread_local parsed_expression_cache<std::vector<parsed::path>> projection_expression_cache;
+static thread_local parsed_expression_cache<parsed::condition_expression> condition_expression_cache;
+
 parsed::update_expression
 parse_update_expression(std::string_view query) {
-    return parse("UpdateExpression", query,  std::mem_fn(&expressionsParser::update_expression));
+    return update_expression_cache.get(query, [] (std::string_view query) {
+        return parse("UpdateExpression", query,  std::mem_fn(&expressionsParser::update_expression));
+    });
 }
 
 std::vector<parsed::path>
 parse_projection_expression(std::string_view query) {
-    return parse ("ProjectionExpression", query,  std::mem_fn(&expressionsParser::projection_expression));
+    return projection_expression_cache.get(query, [] (std::string_view query) {
+        return parse ("ProjectionExpression", query,  std::mem_fn(&expressionsParser::projection_expression));
+    });
 }
 
 parsed::condition_expression
 parse_condition_expression(std::string_view query, const char* caller) {
-    return parse(caller, query,  std::mem_fn(&expressionsParser::condition_expression));
+    return condition_expression_cache.get(query, [caller] (std::string_view query) {
+        return parse(caller, query,  std::mem_fn(&expressionsParser::condition_expression));
+    });
 }
 
 namespace parsed {
@@ -246,6 +246,47 @@ rjson::value deserialize_item(bytes_view bv) {
     return deserialized;
 }
 
+struct to_json_text_visitor {
+    std::string& out;
+    bytes_view bv;
+
+    void operator()(const reversed_type_impl& t) const { visit(*t.underlying_type(), to_json_text_visitor{out, bv}); };
+    void operator()(const decimal_type_impl& t) const {
+        rjson::append_quoted_json_string(out, to_json_string(*decimal_type, bytes(bv)));
+    }
+    void operator()(const string_type_impl& t) const {
+        rjson::append_quoted_json_string(out, std::string_view(reinterpret_cast<const char *>(bv.data()), bv.size()));
+    }
+    void operator()(const bytes_type_impl& t) const {
+        rjson::append_quoted_json_string(out, base64_encode(bv));
+    }
+    // default
+    void operator()(const abstract_type& t) const {
+        out.append(to_json_string(t, bytes(bv)));
+    }
+};
+
+void deserialize_item_to_json(bytes_view bv, std::string& out) {
+    if (bv.empty()) {
+        throw api_error::validation("Serialized value empty");
+    }
+
+    alternator_type atype = alternator_type(bv[0]);
+    bv.remove_prefix(1);
+
+    if (atype == alternator_type::NOT_SUPPORTED_YET) {
+        // These types are stored as the JSON text of the entire typed value.
+        out.append(reinterpret_cast<const char *>(bv.data()), bv.size());
+        return;
+    }
+    type_representation type_representation = represent_type(atype);
+    out.push_back('{');
+    rjson::append_quoted_json_string(out, type_representation.ident);
+    out.push_back(':');
+    visit(*type_representation.dtype, to_json_text_visitor{out, bv});
+    out.push_back('}');
+}
+
 std::string type_to_string(data_type type) {
     static thread_local std::unordered_map<data_type, std::string> types = {
         {utf8_type, "S"},
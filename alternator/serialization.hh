@@ -43,6 +43,9 @@ type_representation represent_type(alternator_type atype);
 
 bytes serialize_item(const rjson::value& item);
 rjson::value deserialize_item(bytes_view bv);
+// Like deserialize_item(), but appends the JSON text of the value to out
+// directly, without building a JSON document first.
+void deserialize_item_to_json(bytes_view bv, std::string& out);
 
 std::string type_to_string(data_type type);
 
@@ -94,6 +94,8 @@ static sstring stream_label(const schema& log_schema) {
 
 namespace alternator {
 
+extern logging::logger elogger;
+
 // stream arn _has_ to be 37 or more characters long. ugh...
 // see https://docs.aws.amazon.com/amazondynamodb/latest/APIReference/API_streams_DescribeStream.html#API_streams_DescribeStream_RequestSyntax
 // UUID is 36 bytes as string (including dashes). 
@@ -817,6 +819,88 @@ future<executor::request_return_type> executor::get_records(client_state& client
         throw api_error::validation("Limit must be 1 or more");
     }
 
+    std::optional<rjson::value> ret = co_await take_prefetched_records(rjson::to_string_view(request["ShardIterator"]), limit);
+    if (!ret) {
+        ret = co_await read_records(client_state, std::move(trace_state), std::move(permit), iter, limit);
+    }
+    maybe_prefetch_records(*ret, limit);
+    _stats.api_operations.get_records_latency.add(std::chrono::steady_clock::now() - start_time);
+    if (is_big(*ret)) {
+        co_return make_streamed(std::move(*ret));
+    }
+    co_return make_jsonable(std::move(*ret));
+}
+
+// The maximum number of GetRecords responses prefetched on a shard, and for
+// how long a prefetched response may be used.
+static constexpr size_t max_prefetched_records = 1024;
+static constexpr auto prefetched_records_ttl = std::chrono::seconds(10);
+
+// Returns the response prefetched for the given iterator, if there is one
+// which can be used for a GetRecords call with the given limit.
+future<std::optional<rjson::value>> executor::take_prefetched_records(std::string_view iterator, size_t limit) {
+    auto it = _prefetched_records.find(sstring(iterator));
+    if (it == _prefetched_records.end()) {
+        co_return std::nullopt;
+    }
+    auto p = std::move(it->second);
+    _prefetched_records.erase(it);
+    if (p.limit > limit || p.expires < lowres_clock::now()) {
+        (void)std::move(p.response).discard_result().handle_exception([] (std::exception_ptr) {});
+        co_return std::nullopt;
+    }
+    try {
+        rjson::value ret = co_await std::move(p.response);
+        // A prefetched read which found no records may have missed records
+        // written since, so the iterator is read again.
+        const rjson::value* records = rjson::find(ret, "Records");
+        if (records && !records->Empty()) {
+            co_return ret;
+        }
+    } catch (...) {
+        elogger.debug("Prefetching records for {} failed: {}", iterator, std::current_exception());
+    }
+    co_return std::nullopt;
+}
+
+// A Streams consumer which is behind keeps calling GetRecords with the
+// iterator returned by its previous call as soon as it has processed the
+// records. When alternator_streams_prefetch is enabled, a GetRecords which
+// returned records starts reading the records for the iterator it returned,
+// so that the consumer's next call, if it comes to the same shard, finds them
+// already read. The prefetched records are those which were there when the
+// prefetch read was done, so they are a valid response also later.
+void executor::maybe_prefetch_records(const rjson::value& response, size_t limit) {
+    if (!_proxy.data_dictionary().get_config().alternator_streams_prefetch() || _prefetch_gate.is_closed()) {
+        return;
+    }
+    const rjson::value* records = rjson::find(response, "Records");
+    const rjson::value* next = rjson::find(response, "NextShardIterator");
+    if (!records || records->Empty() || !next) {
+        return;
+    }
+    auto now = lowres_clock::now();
+    std::erase_if(_prefetched_records, [now] (auto& e) {
+        if (e.second.expires >= now) {
+            return false;
+        }
+        (void)std::move(e.second.response).discard_result().handle_exception([] (std::exception_ptr) {});
+        return true;
+    });
+    sstring key(rjson::to_string_view(*next));
+    if (_prefetched_records.size() >= max_prefetched_records || _prefetched_records.contains(key)) {
+        return;
+    }
+    shard_iterator iter(key);
+    auto f = with_gate(_prefetch_gate, [this, iter, limit] {
+        return do_with(client_state(client_state::internal_tag()), [this, iter, limit] (client_state& cs) {
+            return read_records(cs, nullptr, empty_service_permit(), iter, limit);
+        });
+    });
+    _prefetched_records.emplace(std::move(key), prefetched_records{limit, now + prefetched_records_ttl, std::move(f)});
+}
+
+future<rjson::value> executor::read_records(client_state& client_state, tracing::trace_state_ptr trace_state, service_permit permit, const shard_iterator& iter, size_t limit) {
     auto db = _proxy.data_dictionary();
     schema_ptr schema, base;
     try {
@@ -897,7 +981,7 @@ future<executor::request_return_type> executor::get_records(client_state& client
             query::tombstone_limit(_proxy.get_tombstone_limit()), query::row_limit(limit * mul));
 
     return _proxy.query(schema, std::move(command), std::move(partition_ranges), cl, service::storage_proxy::coordinator_query_options(default_timeout(), std::move(permit), client_state)).then(
-            [this, schema, partition_slice = std::move(partition_slice), selection = std::move(selection), start_time = std::move(start_time), limit, key_names = std::move(key_names), attr_names = std::move(attr_names), type, iter, high_ts] (service::storage_proxy::coordinator_query_result qr) mutable {       
+            [this, schema, partition_slice = std::move(partition_slice), selection = std::move(selection), limit, key_names = std::move(key_names), attr_names = std::move(attr_names), type, iter, high_ts] (service::storage_proxy::coordinator_query_result qr) mutable {       
         cql3::selection::result_set_builder builder(*selection, gc_clock::now());
         query::result_view::consume(*qr.query_result, partition_slice, cql3::selection::result_set_builder::visitor(builder, *schema, *selection));
 
@@ -1020,14 +1104,13 @@ future<executor::request_return_type> executor::get_records(client_state& client
             // shard did end, then the next read will have nrecords == 0 and
             // will notice end end of shard and not return NextShardIterator.
             rjson::add(ret, "NextShardIterator", next_iter);
-            _stats.api_operations.get_records_latency.add(std::chrono::steady_clock::now() - start_time);
-            return make_ready_future<executor::request_return_type>(make_jsonable(std::move(ret)));
+            return make_ready_future<rjson::value>(std::move(ret));
         }
 
         // ugh. figure out if we are and end-of-shard
         auto normal_token_owners = _proxy.get_token_metadata_ptr()->count_normal_token_owners();
 
-        return _sdks.cdc_current_generation_timestamp({ normal_token_owners }).then([this, iter, high_ts, start_time, ret = std::move(ret)](db_clock::time_point ts) mutable {
+        return _sdks.cdc_current_generation_timestamp({ normal_token_owners }).then([iter, high_ts, ret = std::move(ret)](db_clock::time_point ts) mutable {
             auto& shard = iter.shard;            
 
             if (shard.time < ts && ts < high_ts) {
@@ -1043,11 +1126,7 @@ future<executor::request_return_type> executor::get_records(client_state& client
                 shard_iterator next_iter(iter.table, iter.shard, utils::UUID_gen::min_time_UUID(high_ts.time_since_epoch()), true);
                 rjson::add(ret, "NextShardIterator", iter);
             }
-            _stats.api_operations.get_records_latency.add(std::chrono::steady_clock::now() - start_time);
-            if (is_big(ret)) {
-                return make_ready_future<executor::request_return_type>(make_streamed(std::move(ret)));
-            }
-            return make_ready_future<executor::request_return_type>(make_jsonable(std::move(ret)));
+            return make_ready_future<rjson::value>(std::move(ret));
         });
     });
 }
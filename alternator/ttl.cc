@@ -16,6 +16,7 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/lowres_clock.hh>
 #include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/core/loop.hh>
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include "exceptions/exceptions.hh"
@@ -156,8 +157,11 @@ future<executor::request_return_type> executor::describe_time_to_live(client_sta
 // with this range), but when this node is down, the secondary owner (the
 // second in the ring) may take over.
 // An expiration thread is reponsible for all tables which need expiration
-// scans. Currently, the different tables are scanned sequentially (not in
-// parallel).
+// scans. Up to alternator_ttl_scan_concurrency tables are scanned in
+// parallel, and in each of them as many token ranges, and tables in which
+// the previous scan found a larger fraction of expired items are scanned
+// first. The page semaphore bounds the total number of pages processed at
+// once on a shard.
 // The expiration thread scans item using CL=QUORUM to ensures that it reads
 // a consistent expiration-time attribute. This means that the items are read
 // locally and in addition QUORUM-1 additional nodes (one additional node
@@ -172,6 +176,8 @@ expiration_service::expiration_service(data_dictionary::database db, service::st
         : _db(db)
         , _proxy(proxy)
         , _gossiper(g)
+        , _scan_concurrency(std::max(db.get_config().alternator_ttl_scan_concurrency(), 1u))
+        , _page_sem(_scan_concurrency, named_semaphore_exception_factory{"alternator_ttl"})
 {
 }
 
@@ -236,12 +242,10 @@ static bool is_expired(const rjson::value& expiration_time, gc_clock::time_point
     return n && is_expired(*n, now);
 }
 
-// expire_item() expires an item - i.e., deletes it as appropriate for
-// expiration - with CL=QUORUM and (FIXME!) in a way Alternator Streams
-// understands it is an expiration event - not a user-initiated deletion.
-static future<> expire_item(service::storage_proxy& proxy,
-                            const service::query_state& qs,
-                            const std::vector<managed_bytes_opt>& row,
+// make_expiration_mutation() builds the mutation which expires an item -
+// i.e., deletes it as appropriate for expiration. It returns nullopt if the
+// item's key can't be read from the row.
+static std::optional<mutation> make_expiration_mutation(const std::vector<managed_bytes_opt>& row,
                             schema_ptr schema,
                             api::timestamp_type ts) {
     // Prepare the row key to delete
@@ -258,7 +262,7 @@ static future<> expire_item(service::storage_proxy& proxy,
             // This shouldn't happen - all key columns must have values.
             // But if it ever happens, let's just *not* expire the item.
             // FIXME: log or increment a metric if this happens.
-            return make_ready_future<>();
+            return std::nullopt;
         }
         exploded_pk.push_back(to_bytes(*row_c));
     }
@@ -278,15 +282,25 @@ static future<> expire_item(service::storage_proxy& proxy,
                 // This shouldn't happen - all key columns must have values.
                 // But if it ever happens, let's just *not* expire the item.
                 // FIXME: log or increment a metric if this happens.
-                return make_ready_future<>();
+                return std::nullopt;
             }
             exploded_ck.push_back(to_bytes(*row_c));
         }
         auto ck = clustering_key::from_exploded(exploded_ck);
         m.partition().clustered_row(*schema, ck).apply(tombstone(ts, gc_clock::now()));
     }
-    std::vector<mutation> mutations;
-    mutations.push_back(std::move(m));
+    return m;
+}
+
+// The maximum number of expired items deleted by a single expire_items() call.
+static constexpr size_t expiration_batch_size = 64;
+
+// expire_items() expires a batch of items, with CL=QUORUM and (FIXME!) in a
+// way Alternator Streams understands it is an expiration event - not a
+// user-initiated deletion.
+static future<> expire_items(service::storage_proxy& proxy,
+                            const service::query_state& qs,
+                            std::vector<mutation> mutations) {
     return proxy.mutate(std::move(mutations),
         db::consistency_level::LOCAL_QUORUM,
         executor::default_timeout(), // FIXME - which timeout?
@@ -536,13 +550,17 @@ struct scan_ranges_context {
 // items and deleting them.
 // Because of issue #9167, partition_ranges must have a single partition
 // range for this code to work correctly.
+// The number of items scanned and found expired in a table are counted in
+// scanned and expired.
 static future<> scan_table_ranges(
         service::storage_proxy& proxy,
         const scan_ranges_context& scan_ctx,
         dht::partition_range_vector&& partition_ranges,
         abort_source& abort_source,
         named_semaphore& page_sem,
-        expiration_service::stats& expiration_stats)
+        expiration_service::stats& expiration_stats,
+        uint64_t& scanned,
+        uint64_t& expired_count)
 {
     const schema_ptr& s = scan_ctx.s;
     assert (partition_ranges.size() == 1); // otherwise issue #9167 will cause incorrect results.
@@ -594,6 +612,9 @@ static future<> scan_table_ranges(
         if (!expiration_column) {
             continue;
         }
+        scanned += rows.size();
+        expiration_stats.items_scanned += rows.size();
+        std::vector<mutation> expired_items;
         for (const auto& row : rows) {
             const managed_bytes_opt& cell = row[*expiration_column];
             if (!cell) {
@@ -631,13 +652,22 @@ static future<> scan_table_ranges(
                 expired = is_expired(n, now);
             }
             if (expired) {
-                expiration_stats.items_deleted++;
                 // FIXME: maybe don't recalculate new_timestamp() all the time
-                // FIXME: if expire_item() throws on timeout, we need to retry it.
                 auto ts = api::new_timestamp();
-                co_await expire_item(proxy, *scan_ctx.query_state_ptr, row, s, ts);
+                if (auto m = make_expiration_mutation(row, s, ts)) {
+                    expiration_stats.items_deleted++;
+                    expired_count++;
+                    expired_items.push_back(std::move(*m));
+                }
+                if (expired_items.size() >= expiration_batch_size) {
+                    // FIXME: if expire_items() throws on timeout, we need to retry it.
+                    co_await expire_items(proxy, *scan_ctx.query_state_ptr, std::exchange(expired_items, {}));
+                }
             }
         }
+        if (!expired_items.empty()) {
+            co_await expire_items(proxy, *scan_ctx.query_state_ptr, std::move(expired_items));
+        }
         // FIXME: once in a while, persist p->state(), so on reboot
         // we don't start from scratch.
     }
@@ -662,6 +692,8 @@ static future<> scan_table_ranges(
 // how to pace this scan, how and when to repeat it, how to interleave or
 // parallelize scanning of multiple tables, and how to continue scans after a
 // reboot.
+// Up to "concurrency" token ranges are scanned in parallel. The fraction of
+// the scanned items which were found expired is returned in expired_fraction.
 static future<bool> scan_table(
     service::storage_proxy& proxy,
     data_dictionary::database db,
@@ -669,7 +701,9 @@ static future<bool> scan_table(
     schema_ptr s,
     abort_source& abort_source,
     named_semaphore& page_sem,
-    expiration_service::stats& expiration_stats)
+    expiration_service::stats& expiration_stats,
+    size_t concurrency,
+    double& expired_fraction)
 {
     // Check if an expiration-time attribute is enabled for this table.
     // If not, just return false immediately.
@@ -718,19 +752,24 @@ static future<bool> scan_table(
     expiration_stats.scan_table++;
     // FIXME: need to pace the scan, not do it all at once.
     scan_ranges_context scan_ctx{s, proxy, std::move(column_name), std::move(member)};
+    uint64_t scanned = 0;
+    uint64_t expired = 0;
+    // Note that because of issue #9167 we need to run a separate
+    // query on each partition range, and can't pass several of
+    // them into one partition_range_vector.
+    auto scan_range = [&] (dht::partition_range& range) {
+        return scan_table_ranges(proxy, scan_ctx, dht::partition_range_vector{std::move(range)}, abort_source, page_sem, expiration_stats, scanned, expired);
+    };
+    std::vector<dht::partition_range> ranges;
     token_ranges_owned_by_this_shard<primary> my_ranges(db.real_database(), gossiper, s);
     while (std::optional<dht::partition_range> range = my_ranges.next_partition_range()) {
-        // Note that because of issue #9167 we need to run a separate
-        // query on each partition range, and can't pass several of
-        // them into one partition_range_vector.
-        dht::partition_range_vector partition_ranges;
-        partition_ranges.push_back(std::move(*range));
-        // FIXME: if scanning a single range fails, including network errors,
-        // we fail the entire scan (and rescan from the beginning). Need to
-        // reconsider this. Saving the scan position might be a good enough
-        // solution for this problem.
-        co_await scan_table_ranges(proxy, scan_ctx, std::move(partition_ranges), abort_source, page_sem, expiration_stats);
+        ranges.push_back(std::move(*range));
     }
+    // FIXME: if scanning a single range fails, including network errors,
+    // we fail the entire scan (and rescan from the beginning). Need to
+    // reconsider this. Saving the scan position might be a good enough
+    // solution for this problem.
+    co_await max_concurrent_for_each(ranges, concurrency, scan_range);
     // If each node only scans its own primary ranges, then when any node is
     // down part of the token range will not get scanned. This can be viewed
     // as acceptable (when the comes back online, it will resume its scan),
@@ -738,13 +777,14 @@ static future<bool> scan_table(
     // by tasking another node to take over scanning of the dead node's primary
     // ranges. What we do here is that this node will also check expiration
     // on its *secondary* ranges - but only those whose primary owner is down.
+    ranges.clear();
     token_ranges_owned_by_this_shard<secondary> my_secondary_ranges(db.real_database(), gossiper, s);
     while (std::optional<dht::partition_range> range = my_secondary_ranges.next_partition_range()) {
         expiration_stats.secondary_ranges_scanned++;
-        dht::partition_range_vector partition_ranges;
-        partition_ranges.push_back(std::move(*range));
-        co_await scan_table_ranges(proxy, scan_ctx, std::move(partition_ranges), abort_source, page_sem, expiration_stats);
+        ranges.push_back(std::move(*range));
     }
+    co_await max_concurrent_for_each(ranges, concurrency, scan_range);
+    expired_fraction = scanned ? double(expired) / scanned : 0;
     co_return true;
 }
 
@@ -752,8 +792,7 @@ static future<bool> scan_table(
 future<> expiration_service::run() {
     // FIXME: don't just tight-loop, think about timing, pace, and
     // store position in durable storage, etc.
-    // FIXME: think about working on different tables in parallel.
-    // also need to notice when a new table is added, a table is
+    // FIXME: need to notice when a new table is added, a table is
     // deleted or when ttl is enabled or disabled for a table!
     for (;;) {
         auto start = lowres_clock::now();
@@ -764,13 +803,25 @@ future<> expiration_service::run() {
         for (auto cf : _db.get_tables()) {
             schemas.push_back(cf.schema());
         }
-        for (schema_ptr s : schemas) {
+        // Scan first the tables in which the previous pass found the
+        // largest fraction of expired items. Tables not scanned before
+        // come first.
+        auto priority = [this] (const schema_ptr& s) {
+            auto it = _expired_fraction.find(s->id());
+            return it == _expired_fraction.end() ? 2.0 : it->second;
+        };
+        std::ranges::stable_sort(schemas, std::greater<double>(), priority);
+        std::unordered_map<table_id, double> expired_fraction;
+        co_await max_concurrent_for_each(schemas, _scan_concurrency, [&] (schema_ptr s) -> future<> {
             co_await coroutine::maybe_yield();
             if (shutting_down()) {
                 co_return;
             }
             try {
-                co_await scan_table(_proxy, _db, _gossiper, s, _abort_source, _page_sem, _expiration_stats);
+                double fraction = 0;
+                if (co_await scan_table(_proxy, _db, _gossiper, s, _abort_source, _page_sem, _expiration_stats, _scan_concurrency, fraction)) {
+                    expired_fraction.emplace(s->id(), fraction);
+                }
             } catch (...) {
                 // The scan of a table may fail in the middle for many
                 // reasons, including network failure and even the table
@@ -788,7 +839,11 @@ future<> expiration_service::run() {
                         s->ks_name(), s->cf_name());
                 }
             }
+        });
+        if (shutting_down()) {
+            co_return;
         }
+        _expired_fraction = std::move(expired_fraction);
         _expiration_stats.scan_passes++;
         // The TTL scanner runs above once over all tables, at full steam.
         // After completing such a scan, we sleep until it's time start
@@ -844,6 +899,8 @@ expiration_service::stats::stats() {
             seastar::metrics::description("number of items deleted after expiration")),
         seastar::metrics::make_total_operations("secondary_ranges_scanned", secondary_ranges_scanned,
             seastar::metrics::description("number of token ranges scanned by this node while their primary owner was down")),
+        seastar::metrics::make_total_operations("items_scanned", items_scanned,
+            seastar::metrics::description("number of items read by the expiration scan")),
     });
 }
 
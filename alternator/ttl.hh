@@ -13,6 +13,8 @@
 #include <seastar/core/abort_source.hh>
 #include <seastar/core/semaphore.hh>
 #include "data_dictionary/data_dictionary.hh"
+#include "schema/schema_fwd.hh"
+#include <unordered_map>
 
 namespace gms {
 class gossiper;
@@ -43,6 +45,7 @@ class expiration_service final : public seastar::peering_sharded_service<expirat
         uint64_t scan_table = 0;
         uint64_t items_deleted = 0;
         uint64_t secondary_ranges_scanned = 0;
+        uint64_t items_scanned = 0;
     private:
         // The metric_groups object holds this stat object's metrics registered
         // as long as the stats object is alive.
@@ -57,8 +60,16 @@ class expiration_service final : public seastar::peering_sharded_service<expirat
     // should be triggered. stop() below uses both _abort_source and _end.
     std::optional<future<>> _end;
     abort_source _abort_source;
-    // Ensures that at most 1 page of scan results at a time is processed by the TTL service
-    named_semaphore _page_sem{1, named_semaphore_exception_factory{"alternator_ttl"}};
+    // The number of tables, and of token ranges in a table, scanned
+    // concurrently (alternator_ttl_scan_concurrency).
+    size_t _scan_concurrency;
+    // Ensures that at most _scan_concurrency pages of scan results at a time
+    // are processed by the TTL service
+    named_semaphore _page_sem;
+    // The fraction of the items scanned in each table which were found
+    // expired in its last scan. Tables with more expired items are scanned
+    // first in the next pass.
+    std::unordered_map<table_id, double> _expired_fraction;
     bool shutting_down() { return _abort_source.abort_requested(); }
     stats _expiration_stats;
 public:
@@ -1046,6 +1046,84 @@ void set_column_family(http_context& ctx, routes& r, sharded<db::system_keyspace
         });
     });
 
+    cf::get_rate_limited_partitions.set(r, [&ctx] (std::unique_ptr<http::request> req) -> future<json::json_return_type> {
+        auto uuid = get_uuid(req->param["name"], ctx.db.local());
+        api::req_param<unsigned> list_size(*req, "list_size", 10);
+
+        // Tokens of rate limited partitions, and their rejected operations, for reads and writes.
+        using rejected_counts = std::array<std::unordered_map<uint64_t, uint64_t>, 2>;
+        auto counts = co_await ctx.db.map_reduce0([uuid, k = list_size.value] (replica::database& local_db) {
+            auto& tbl = local_db.find_column_family(uuid);
+            rejected_counts ret;
+            for (auto op_type : {db::operation_type::read, db::operation_type::write}) {
+                for (auto& p : local_db.get_top_rate_limited_partitions(tbl, op_type, k)) {
+                    ret[op_type == db::operation_type::write][p.token] += p.count;
+                }
+            }
+            return ret;
+        }, rejected_counts(), [] (rejected_counts a, const rejected_counts& b) {
+            for (size_t i = 0; i < a.size(); i++) {
+                for (auto& [token, count] : b[i]) {
+                    a[i][token] += count;
+                }
+            }
+            return a;
+        });
+
+        cf::rate_limited_partitions_results results;
+        auto add_records = [k = list_size.value] (json::json_list<cf::rate_limited_partition>& records, const std::unordered_map<uint64_t, uint64_t>& counts) {
+            std::vector<std::pair<uint64_t, uint64_t>> sorted(counts.begin(), counts.end());
+            std::sort(sorted.begin(), sorted.end(), [] (const auto& a, const auto& b) { return a.second > b.second; });
+            sorted.resize(std::min<size_t>(k, sorted.size()));
+            for (auto& [token, count] : sorted) {
+                cf::rate_limited_partition rec;
+                rec.token = fmt::to_string(int64_t(token));
+                rec.count = count;
+                records.push(rec);
+            }
+        };
+        add_records(results.read, counts[0]);
+        add_records(results.write, counts[1]);
+        co_return results;
+    });
+
+    cf::get_heavy_hitters.set(r, [&ctx] (std::unique_ptr<http::request> req) -> future<json::json_return_type> {
+        auto uuid = get_uuid(req->param["name"], ctx.db.local());
+        api::req_param<unsigned> list_size(*req, "list_size", 10);
+
+        // The hottest partitions of every shard, for reads and writes.
+        using heavy_hitters = std::array<std::vector<db::partition_heavy_hitters::partition>, 2>;
+        auto partitions = co_await ctx.db.map_reduce0([uuid, k = list_size.value] (replica::database& local_db) {
+            auto& tbl = local_db.find_column_family(uuid);
+            heavy_hitters ret;
+            for (auto op_type : {db::operation_type::read, db::operation_type::write}) {
+                ret[op_type == db::operation_type::write] = tbl.get_heavy_hitters_for_op_type(op_type).top(k);
+            }
+            return ret;
+        }, heavy_hitters(), [] (heavy_hitters a, const heavy_hitters& b) {
+            for (size_t i = 0; i < a.size(); i++) {
+                a[i].insert(a[i].end(), b[i].begin(), b[i].end());
+            }
+            return a;
+        });
+
+        cf::heavy_hitters_results results;
+        auto add_records = [k = list_size.value] (json::json_list<cf::heavy_hitter>& records, std::vector<db::partition_heavy_hitters::partition>& partitions) {
+            std::sort(partitions.begin(), partitions.end(), [] (const auto& a, const auto& b) { return a.operations > b.operations; });
+            partitions.resize(std::min<size_t>(k, partitions.size()));
+            for (auto& p : partitions) {
+                cf::heavy_hitter rec;
+                rec.token = fmt::to_string(p.token);
+                rec.operations = p.operations;
+                rec.bytes = p.bytes;
+                records.push(rec);
+            }
+        };
+        add_records(results.read, partitions[0]);
+        add_records(results.write, partitions[1]);
+        co_return results;
+    });
+
     cf::force_major_compaction.set(r, [&ctx](std::unique_ptr<http::request> req) -> future<json::json_return_type> {
         if (req->get_query_param("split_output") != "") {
             fail(unimplemented::cause::API);
@@ -1171,6 +1249,8 @@ void unset_column_family(http_context& ctx, routes& r) {
     cf::get_sstable_count_per_level.unset(r);
     cf::get_sstables_for_key.unset(r);
     cf::toppartitions.unset(r);
+    cf::get_rate_limited_partitions.unset(r);
+    cf::get_heavy_hitters.unset(r);
     cf::force_major_compaction.unset(r);
 }
 }
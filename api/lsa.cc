@@ -29,6 +29,42 @@ void set_lsa(http_context& ctx, routes& r) {
             return json::json_return_type(json::json_void());
         });
     });
+
+    httpd::lsa_json::lsa_objects.set(r, [&ctx](std::unique_ptr<request> req) {
+        auto max_segments = api::req_param<unsigned>(*req, "max_segments", 64).value;
+        if (max_segments == 0) {
+            throw bad_param_exception("max_segments must be positive");
+        }
+        return ctx.db.map([max_segments] (replica::database& db) {
+            return std::vector<logalloc::object_sample>{
+                db.row_cache_tracker().region().sample_objects(max_segments),
+                logalloc::shard_tracker().sample_objects(max_segments),
+            };
+        }).then([] (std::vector<std::vector<logalloc::object_sample>> shards) {
+            static constexpr std::array<const char*, 2> groups = {"cache", "all"};
+            std::vector<httpd::lsa_json::lsa_object_sample> res;
+            for (unsigned shard = 0; shard < shards.size(); ++shard) {
+                for (size_t i = 0; i < groups.size(); ++i) {
+                    auto& sample = shards[shard][i];
+                    httpd::lsa_json::lsa_object_sample s;
+                    s.shard = shard;
+                    s.group = groups[i];
+                    s.total_space = sample.occupancy.total_space();
+                    s.used_space = sample.occupancy.used_space();
+                    s.sampled_segments = sample.sampled_segments;
+                    for (auto& [type, stats] : sample.types) {
+                        httpd::lsa_json::lsa_object_type t;
+                        t.type = type;
+                        t.count = stats.count;
+                        t.bytes = stats.bytes;
+                        s.objects.push(std::move(t));
+                    }
+                    res.push_back(std::move(s));
+                }
+            }
+            return json::json_return_type(std::move(res));
+        });
+    });
 }
 
 }
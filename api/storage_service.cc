@@ -743,6 +743,24 @@ void set_storage_service(http_context& ctx, routes& r, sharded<service::storage_
         co_return json::json_return_type(0);
     }));
 
+    ss::recompress_sstables.set(r, wrap_ks_cf(ctx, [] (http_context& ctx, std::unique_ptr<http::request> req, sstring keyspace, std::vector<table_info> table_infos) -> future<json::json_return_type> {
+        auto& db = ctx.db;
+        uint32_t io_budget_mb_per_sec = req_param<uint32_t>(*req, "io_budget_mb_per_sec", 0);
+
+        apilog.info("recompress_sstables: keyspace={} tables={} io_budget_mb_per_sec={}", keyspace, table_infos, io_budget_mb_per_sec);
+
+        auto& compaction_module = db.local().get_compaction_manager().get_task_manager_module();
+        auto task = co_await compaction_module.make_and_start_task<recompress_sstables_compaction_task_impl>({}, std::move(keyspace), db, table_infos, io_budget_mb_per_sec);
+        try {
+            co_await task->done();
+        } catch (...) {
+            apilog.error("recompress_sstables: keyspace={} tables={} failed: {}", keyspace, table_infos, std::current_exception());
+            throw;
+        }
+
+        co_return json::json_return_type(0);
+    }));
+
     ss::force_keyspace_flush.set(r, [&ctx](std::unique_ptr<http::request> req) -> future<json::json_return_type> {
         auto keyspace = validate_keyspace(ctx, req->param);
         auto column_families = parse_tables(keyspace, ctx, req->query_parameters, "cf");
@@ -1391,6 +1409,7 @@ void unset_storage_service(http_context& ctx, routes& r) {
     ss::force_keyspace_cleanup.unset(r);
     ss::perform_keyspace_offstrategy_compaction.unset(r);
     ss::upgrade_sstables.unset(r);
+    ss::recompress_sstables.unset(r);
     ss::force_keyspace_flush.unset(r);
     ss::decommission.unset(r);
     ss::move.unset(r);
@@ -1552,6 +1571,22 @@ void set_snapshot(http_context& ctx, routes& r, sharded<db::snapshot_ctl>& snap_
         });
     });
 
+    ss::start_backup.set(r, [&ctx, &snap_ctl] (std::unique_ptr<http::request> req) -> future<json::json_return_type> {
+        auto rp = req_params({
+            {"endpoint", {mandatory::yes}},
+            {"bucket", {mandatory::yes}},
+            {"prefix", {mandatory::yes}},
+            {"keyspace", {mandatory::yes}},
+            {"table", {mandatory::yes}},
+            {"snapshot", {mandatory::yes}},
+        });
+        rp.process(*req);
+        auto keyspace = validate_keyspace(ctx, *rp.get("keyspace"));
+        auto task_id = co_await snap_ctl.local().start_backup(*rp.get("endpoint"), *rp.get("bucket"), *rp.get("prefix"),
+                std::move(keyspace), *rp.get("table"), *rp.get("snapshot"));
+        co_return json::json_return_type(task_id.to_sstring());
+    });
+
     ss::scrub.set(r, [&ctx, &snap_ctl] (std::unique_ptr<http::request> req) -> future<json::json_return_type> {
         auto& db = ctx.db;
         auto rp = req_params({
@@ -1637,6 +1672,7 @@ void unset_snapshot(http_context& ctx, routes& r) {
     ss::take_snapshot.unset(r);
     ss::del_snapshot.unset(r);
     ss::true_snapshots_size.unset(r);
+    ss::start_backup.unset(r);
     ss::scrub.unset(r);
 }
 
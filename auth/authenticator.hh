@@ -140,6 +140,12 @@ class authenticator {
     virtual const resource_set& protected_resources() const = 0;
 
     virtual ::shared_ptr<sasl_challenge> new_sasl_challenge() const = 0;
+
+    ///
+    /// Drop the credentials cached by this shard's instance, if any. Called on all shards of all nodes
+    /// after roles change, together with the invalidation of the other authorization caches.
+    ///
+    virtual void invalidate_cache() const {}
 };
 
 }
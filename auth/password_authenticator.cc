@@ -18,6 +18,7 @@
 
 #include <boost/algorithm/cxx11/all_of.hpp>
 #include <seastar/core/seastar.hh>
+#include <seastar/core/coroutine.hh>
 
 #include "auth/authenticated_user.hh"
 #include "auth/common.hh"
@@ -30,6 +31,8 @@
 #include "replica/database.hh"
 #include "cql3/query_processor.hh"
 #include "db/config.hh"
+#include "utils/alien_worker.hh"
+#include "utils/hashers.hh"
 
 namespace auth {
 
@@ -51,6 +54,33 @@ static const class_registrator<
 
 static thread_local auto rng_for_salt = std::default_random_engine(std::random_device{}());
 
+// Keys the digests of verified passwords, so that they can't be compared
+// with digests computed elsewhere.
+static thread_local const auto verified_password_digest_key = [] {
+    std::random_device rd;
+    std::array<uint8_t, 32> key;
+    std::generate(key.begin(), key.end(), [&rd] { return uint8_t(rd()); });
+    return key;
+}();
+
+static std::array<uint8_t, 32> verified_password_digest(const sstring& password, const sstring& salted_hash) {
+    sha256_hasher h;
+    h.update(reinterpret_cast<const char*>(verified_password_digest_key.data()), verified_password_digest_key.size());
+    h.update(salted_hash.data(), salted_hash.size());
+    h.update(password.data(), password.size());
+    return h.finalize_array();
+}
+
+// Checking a password costs milliseconds of CPU, which would stall the
+// reactor when many clients log in at once, e.g. when they all reconnect.
+// The threads are shared by all shards, and are stopped at exit.
+static utils::alien_worker& password_hashing_worker() {
+    static utils::alien_worker worker(std::max(1u, smp::count / 8), 10, plogger);
+    return worker;
+}
+
+static constexpr size_t max_queued_password_checks_per_shard = 16;
+
 static std::string_view get_config_value(std::string_view value, std::string_view def) {
     return value.empty() ? def : value;
 }
@@ -67,7 +97,22 @@ password_authenticator::password_authenticator(cql3::query_processor& qp, ::serv
     , _migration_manager(mm)
     , _stopped(make_ready_future<>()) 
     , _superuser(default_superuser(qp.db().get_config()))
-{}
+    , _verified_password_validity(std::chrono::milliseconds(qp.db().get_config().credentials_validity_in_ms()))
+    , _password_checks(max_queued_password_checks_per_shard)
+{
+    const auto& cfg = qp.db().get_config();
+    if (cfg.credentials_validity_in_ms()) {
+        utils::loading_cache_config cache_cfg;
+        cache_cfg.max_size = cfg.credentials_cache_max_entries();
+        cache_cfg.expiry = std::chrono::milliseconds(cfg.credentials_validity_in_ms());
+        cache_cfg.refresh = std::chrono::milliseconds(cfg.credentials_update_interval_in_ms());
+        _salted_hashes.emplace(cache_cfg, plogger, [this] (const sstring& role_name) {
+            plogger.debug("Refreshing credentials for {}", role_name);
+            return get_salted_hash(role_name);
+        });
+        _verified_passwords.emplace(cache_cfg.max_size, cache_cfg.expiry, plogger);
+    }
+}
 
 static bool has_salted_hash(const cql3::untyped_result_set_row& row) {
     return !row.get_or<sstring>(SALTED_HASH, "").empty();
@@ -171,7 +216,14 @@ future<> password_authenticator::start() {
 
 future<> password_authenticator::stop() {
     _as.request_abort();
-    return _stopped.handle_exception_type([] (const sleep_aborted&) { }).handle_exception_type([](const abort_requested_exception&) {});
+    return _stopped.handle_exception_type([] (const sleep_aborted&) { }).handle_exception_type([](const abort_requested_exception&) {}).then([this] {
+        // The hashing threads must not resolve checks of a stopped shard.
+        return _password_checks_gate.close();
+    }).then([this] {
+        return _verified_passwords ? _verified_passwords->stop() : make_ready_future<>();
+    }).then([this] {
+        return _salted_hashes ? _salted_hashes->stop() : make_ready_future<>();
+    });
 }
 
 db::consistency_level password_authenticator::consistency_for_user(std::string_view role_name) {
@@ -211,31 +263,18 @@ future<authenticated_user> password_authenticator::authenticate(
     auto& username = credentials.at(USERNAME_KEY);
     auto& password = credentials.at(PASSWORD_KEY);
 
-    // Here was a thread local, explicit cache of prepared statement. In normal execution this is
-    // fine, but since we in testing set up and tear down system over and over, we'd start using
-    // obsolete prepared statements pretty quickly.
-    // Rely on query processing caching statements instead, and lets assume
-    // that a map lookup string->statement is not gonna kill us much.
-    return futurize_invoke([this, username, password] {
-        static const sstring query = format("SELECT {} FROM {} WHERE {} = ?",
-                SALTED_HASH,
-                meta::roles_table::qualified_name,
-                meta::roles_table::role_col_name);
-
-        return _qp.execute_internal(
-                query,
-                consistency_for_user(username),
-                internal_distributed_query_state(),
-                {username},
-                cql3::query_processor::cache_internal::yes);
-    }).then_wrapped([=](future<::shared_ptr<cql3::untyped_result_set>> f) {
+    return futurize_invoke([this, username] {
+        if (!_salted_hashes) {
+            return get_salted_hash(username);
+        }
+        return _salted_hashes->get(username);
+    }).then([this, username, password] (sstring salted_hash) {
+        return do_with(username, password, std::move(salted_hash), [this] (const sstring& username, const sstring& password, const sstring& salted_hash) {
+            return check_password(username, password, salted_hash);
+        });
+    }).then_wrapped([=](future<bool> f) {
         try {
-            auto res = f.get0();
-            auto salted_hash = std::optional<sstring>();
-            if (!res->empty()) {
-                salted_hash = res->one().get_opt<sstring>(SALTED_HASH);
-            }
-            if (!salted_hash || !passwords::check(password, *salted_hash)) {
+            if (!f.get0()) {
                 throw exceptions::authentication_exception("Username and/or password are incorrect");
             }
             return make_ready_future<authenticated_user>(username);
@@ -251,6 +290,67 @@ future<authenticated_user> password_authenticator::authenticate(
     });
 }
 
+future<sstring> password_authenticator::get_salted_hash(sstring role_name) const {
+    // Here was a thread local, explicit cache of prepared statement. In normal execution this is
+    // fine, but since we in testing set up and tear down system over and over, we'd start using
+    // obsolete prepared statements pretty quickly.
+    // Rely on query processing caching statements instead, and lets assume
+    // that a map lookup string->statement is not gonna kill us much.
+    static const sstring query = format("SELECT {} FROM {} WHERE {} = ?",
+            SALTED_HASH,
+            meta::roles_table::qualified_name,
+            meta::roles_table::role_col_name);
+
+    auto res = co_await _qp.execute_internal(
+            query,
+            consistency_for_user(role_name),
+            internal_distributed_query_state(),
+            {role_name},
+            cql3::query_processor::cache_internal::yes);
+    auto salted_hash = std::optional<sstring>();
+    if (!res->empty()) {
+        salted_hash = res->one().get_opt<sstring>(SALTED_HASH);
+    }
+    if (!salted_hash) {
+        // Not cached, so that a role created later can log in immediately.
+        throw exceptions::authentication_exception("Username and/or password are incorrect");
+    }
+    co_return std::move(*salted_hash);
+}
+
+void password_authenticator::invalidate_cache() const {
+    if (_salted_hashes) {
+        _salted_hashes->reset();
+    }
+    if (_verified_passwords) {
+        _verified_passwords->reset();
+    }
+}
+
+future<bool> password_authenticator::check_password(const sstring& role_name, const sstring& password, const sstring& salted_hash) const {
+    auto digest = verified_password_digest(password, salted_hash);
+    if (_verified_passwords) {
+        auto v = _verified_passwords->find(role_name);
+        if (v && v->salted_hash == salted_hash && v->digest == digest && lowres_clock::now() - v->verified_at < _verified_password_validity) {
+            co_return true;
+        }
+    }
+
+    auto holder = _password_checks_gate.hold();
+    auto units = co_await get_units(_password_checks, 1);
+    // The arguments outlive the check, which only reads them.
+    bool ok = co_await password_hashing_worker().submit([&password, &salted_hash] {
+        return passwords::check(password, salted_hash);
+    });
+    if (ok && _verified_passwords) {
+        _verified_passwords->remove(role_name);
+        co_await _verified_passwords->get_ptr(role_name, [&] (const sstring&) {
+            return make_ready_future<verified_password>(verified_password{salted_hash, digest, lowres_clock::now()});
+        }).discard_result();
+    }
+    co_return ok;
+}
+
 future<> password_authenticator::create(std::string_view role_name, const authentication_options& options) const {
     if (!options.password) {
         return make_ready_future<>();
@@ -10,9 +10,15 @@
 
 #pragma once
 
+#include <array>
+#include <optional>
+
 #include <seastar/core/abort_source.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/semaphore.hh>
 
 #include "auth/authenticator.hh"
+#include "utils/loading_cache.hh"
 
 namespace db {
     class config;
@@ -33,11 +39,33 @@ namespace auth {
 extern const std::string_view password_authenticator_name;
 
 class password_authenticator : public authenticator {
+    // Salted hashes of the roles which logged in recently, keyed by role name.
+    using salted_hash_cache = utils::loading_cache<sstring, sstring, 1, utils::loading_cache_reload_enabled::yes>;
+
     cql3::query_processor& _qp;
     ::service::migration_manager& _migration_manager;
     future<> _stopped;
     seastar::abort_source _as;
     std::string _superuser;
+    // Disengaged if credentials caching is disabled.
+    mutable std::optional<salted_hash_cache> _salted_hashes;
+
+    // A digest of the password a role recently logged in with, so that
+    // reconnecting clients don't need to be hashed again.
+    struct verified_password {
+        sstring salted_hash;
+        std::array<uint8_t, 32> digest;
+        seastar::lowres_clock::time_point verified_at;
+    };
+    using verified_password_cache = utils::loading_cache<sstring, verified_password, 1, utils::loading_cache_reload_enabled::no>;
+
+    // Disengaged if credentials caching is disabled.
+    mutable std::optional<verified_password_cache> _verified_passwords;
+    seastar::lowres_clock::duration _verified_password_validity;
+
+    // Bounds the passwords of this shard waiting to be checked by the hashing threads.
+    mutable seastar::semaphore _password_checks;
+    mutable seastar::gate _password_checks_gate;
 
 public:
     static db::consistency_level consistency_for_user(std::string_view role_name);
@@ -73,7 +101,16 @@ class password_authenticator : public authenticator {
 
     virtual ::shared_ptr<sasl_challenge> new_sasl_challenge() const override;
 
+    virtual void invalidate_cache() const override;
+
 private:
+    // Throws authentication_exception if the role doesn't exist or has no password.
+    future<sstring> get_salted_hash(sstring role_name) const;
+
+    // Hashes the password on a thread outside of the reactor, unless the same
+    // password was verified against the same salted hash recently.
+    future<bool> check_password(const sstring& role_name, const sstring& password, const sstring& salted_hash) const;
+
     bool legacy_metadata_exists() const;
 
     future<> migrate_legacy_metadata() const;
@@ -18,15 +18,20 @@ permissions_cache::permissions_cache(const utils::loading_cache_config& c, servi
         : _cache(c, log, [&ser, &log](const key_type& k) {
               log.debug("Refreshing permissions for {}", k.first);
               return ser.get_uncached_permissions(k.first, k.second);
+          })
+        , _roles_cache(c, log, [&ser, &log](const sstring& role_name) {
+              log.debug("Refreshing granted roles of {}", role_name);
+              return ser.underlying_role_manager().query_granted(role_name, recursive_role_query::yes);
           }) {
 }
 
 bool permissions_cache::update_config(utils::loading_cache_config c) {
-    return _cache.update_config(std::move(c));
+    return _roles_cache.update_config(c) && _cache.update_config(std::move(c));
 }
 
 void permissions_cache::reset() {
     _cache.reset();
+    _roles_cache.reset();
 }
 
 future<permission_set> permissions_cache::get(const role_or_anonymous& maybe_role, const resource& r) {
@@ -35,4 +40,10 @@ future<permission_set> permissions_cache::get(const role_or_anonymous& maybe_rol
     });
 }
 
+future<role_set> permissions_cache::get_roles(std::string_view role_name) {
+    return do_with(sstring(role_name), [this](const auto& k) {
+        return _roles_cache.get(k);
+    });
+}
+
 }
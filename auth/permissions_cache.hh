@@ -16,12 +16,14 @@
 #include <utility>
 
 #include <seastar/core/future.hh>
+#include <seastar/core/when_all.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
 
 #include "auth/authenticated_user.hh"
 #include "auth/permission.hh"
 #include "auth/resource.hh"
+#include "auth/role_manager.hh"
 #include "auth/role_or_anonymous.hh"
 #include "log.hh"
 #include "utils/hash.hh"
@@ -55,18 +57,28 @@ class permissions_cache final {
 
     using key_type = typename cache_type::key_type;
 
+    // The closure of roles granted to a role, directly and through other roles.
+    using roles_cache_type = utils::loading_cache<
+            sstring,
+            role_set,
+            1,
+            utils::loading_cache_reload_enabled::yes,
+            utils::simple_entry_size<role_set>>;
+
     cache_type _cache;
+    roles_cache_type _roles_cache;
 
 public:
     explicit permissions_cache(const utils::loading_cache_config&, service&, logging::logger&);
 
     future <> stop() {
-        return _cache.stop();
+        return when_all_succeed(_cache.stop(), _roles_cache.stop()).discard_result();
     }
 
     bool update_config(utils::loading_cache_config);
     void reset();
     future<permission_set> get(const role_or_anonymous&, const resource&);
+    future<role_set> get_roles(std::string_view role_name);
 };
 
 }
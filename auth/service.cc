@@ -16,6 +16,7 @@
 #include <seastar/core/future-util.hh>
 #include <seastar/core/sharded.hh>
 #include <seastar/core/shared_ptr.hh>
+#include <seastar/core/sleep.hh>
 
 #include "auth/allow_all_authenticator.hh"
 #include "auth/allow_all_authorizer.hh"
@@ -49,9 +50,10 @@ static logging::logger log("auth_service");
 
 class auth_migration_listener final : public ::service::migration_listener {
     authorizer& _authorizer;
+    service& _service;
 
 public:
-    explicit auth_migration_listener(authorizer& a) : _authorizer(a) {
+    auth_migration_listener(authorizer& a, service& s) : _authorizer(a), _service(s) {
     }
 
 private:
@@ -84,6 +86,7 @@ class auth_migration_listener final : public ::service::migration_listener {
         }).handle_exception([] (std::exception_ptr e) {
             log.error("Unexpected exception while revoking all permissions on functions in dropped keyspace: {}", e);
         });
+        invalidate_caches();
     }
 
     void on_drop_column_family(const sstring& ks_name, const sstring& cf_name) override {
@@ -95,6 +98,7 @@ class auth_migration_listener final : public ::service::migration_listener {
         }).handle_exception([] (std::exception_ptr e) {
             log.error("Unexpected exception while revoking all permissions on dropped table: {}", e);
         });
+        invalidate_caches();
     }
 
     void on_drop_user_type(const sstring& ks_name, const sstring& type_name) override {}
@@ -105,6 +109,7 @@ class auth_migration_listener final : public ::service::migration_listener {
         }).handle_exception([] (std::exception_ptr e) {
             log.error("Unexpected exception while revoking all permissions on dropped function: {}", e);
         });
+        invalidate_caches();
     }
     void on_drop_aggregate(const sstring& ks_name, const sstring& aggregate_name) override {
         (void)_authorizer.revoke_all(
@@ -113,8 +118,19 @@ class auth_migration_listener final : public ::service::migration_listener {
         }).handle_exception([] (std::exception_ptr e) {
             log.error("Unexpected exception while revoking all permissions on dropped aggregate: {}", e);
         });
+        invalidate_caches();
     }
     void on_drop_view(const sstring& ks_name, const sstring& view_name) override {}
+
+    // Schema changes are applied by every node, so a node only needs to drop
+    // the permissions cached on its own shards, e.g. so that a resource
+    // re-created with the same name doesn't inherit them.
+    void invalidate_caches() {
+        // Do it in the background.
+        (void)_service.invalidate_local_authorization_caches().handle_exception([] (std::exception_ptr e) {
+            log.error("Unexpected exception while invalidating authorization caches after a drop: {}", e);
+        });
+    }
 };
 
 static future<> validate_role_exists(const service& ser, std::string_view role_name) {
@@ -125,6 +141,26 @@ static future<> validate_role_exists(const service& ser, std::string_view role_n
     });
 }
 
+static constexpr std::string_view CACHE_GENERATION_CF = "cache_generation";
+static constexpr std::string_view CACHE_GENERATION_KEY = "authorization";
+
+// With push invalidation, cache entries are not refreshed in the background,
+// and are only evicted after a long safety period in case a bump of the
+// generation is lost.
+static constexpr auto push_invalidated_entry_validity = std::chrono::hours(24);
+
+static bool push_invalidation_enabled(const db::config& cfg) {
+    return cfg.auth_cache_invalidation_poll_interval_in_ms() != 0;
+}
+
+static utils::loading_cache_config adjust_cache_config(utils::loading_cache_config c, const db::config& cfg) {
+    if (push_invalidation_enabled(cfg) && c.expiry != lowres_clock::duration(0)) {
+        c.expiry = push_invalidated_entry_validity;
+        c.refresh = push_invalidated_entry_validity;
+    }
+    return c;
+}
+
 service::service(
         utils::loading_cache_config c,
         cql3::query_processor& qp,
@@ -132,14 +168,14 @@ service::service(
         std::unique_ptr<authorizer> z,
         std::unique_ptr<authenticator> a,
         std::unique_ptr<role_manager> r)
-            : _loading_cache_config(std::move(c))
+            : _loading_cache_config(adjust_cache_config(std::move(c), qp.db().get_config()))
             , _permissions_cache(nullptr)
             , _qp(qp)
             , _mnotifier(mn)
             , _authorizer(std::move(z))
             , _authenticator(std::move(a))
             , _role_manager(std::move(r))
-            , _migration_listener(std::make_unique<auth_migration_listener>(*_authorizer))
+            , _migration_listener(std::make_unique<auth_migration_listener>(*_authorizer, *this))
             , _permissions_cache_cfg_cb([this] (uint32_t) { (void) _permissions_cache_config_action.trigger_later(); })
             , _permissions_cache_config_action([this] { update_cache_config(); return make_ready_future<>(); })
             , _permissions_cache_max_entries_observer(_qp.db().get_config().permissions_cache_max_entries.observe(_permissions_cache_cfg_cb))
@@ -193,10 +229,27 @@ future<> service::start(::service::migration_manager& mm) {
         });
     }).then([this] {
         _permissions_cache = std::make_unique<permissions_cache>(_loading_cache_config, *this, log);
-    }).then([this] {
-        return once_among_shards([this] {
+    }).then([this, &mm] {
+        return once_among_shards([this, &mm] {
             _mnotifier.register_listener(_migration_listener.get());
-            return make_ready_future<>();
+
+            const auto& cfg = _qp.db().get_config();
+            if (!push_invalidation_enabled(cfg)) {
+                return make_ready_future<>();
+            }
+
+            static const sstring create_table = fmt::format(
+                    "CREATE TABLE {}.{} ("
+                    "key text PRIMARY KEY,"
+                    "generation timeuuid"
+                    ")",
+                    meta::AUTH_KS,
+                    CACHE_GENERATION_CF);
+
+            return create_metadata_table_if_missing(CACHE_GENERATION_CF, _qp, create_table, mm).then([this, &cfg] {
+                _cache_generation_poller = poll_cache_generation(
+                        std::chrono::milliseconds(cfg.auth_cache_invalidation_poll_interval_in_ms()));
+            });
         });
     });
 }
@@ -204,7 +257,10 @@ future<> service::start(::service::migration_manager& mm) {
 future<> service::stop() {
     // Only one of the shards has the listener registered, but let's try to
     // unregister on each one just to make sure.
+    _as.request_abort();
     return _mnotifier.unregister_listener(_migration_listener.get()).then([this] {
+        return std::exchange(_cache_generation_poller, make_ready_future<>());
+    }).then([this] {
         if (_permissions_cache) {
             return _permissions_cache->stop();
         }
@@ -222,7 +278,7 @@ void service::update_cache_config() {
     perm_cache_config.expiry = std::chrono::milliseconds(db.get_config().permissions_validity_in_ms());
     perm_cache_config.refresh = std::chrono::milliseconds(db.get_config().permissions_update_interval_in_ms());
 
-    if (!_permissions_cache->update_config(std::move(perm_cache_config))) {
+    if (!_permissions_cache->update_config(adjust_cache_config(std::move(perm_cache_config), db.get_config()))) {
         log.error("Failed to apply permissions cache changes. Please read the documentation of these parameters");
     }
 }
@@ -232,6 +288,67 @@ void service::reset_authorization_cache() {
     _qp.reset_cache();
 }
 
+future<> service::invalidate_local_authorization_caches() const {
+    return smp::invoke_on_all([&sharded_service = container()] {
+        const service& s = sharded_service.local();
+        s._permissions_cache->reset();
+        s._authenticator->invalidate_cache();
+        s._qp.reset_cache();
+    });
+}
+
+future<> service::bump_cache_generation() const {
+    static const sstring query = format("UPDATE {}.{} SET generation = now() WHERE key = ?",
+            meta::AUTH_KS,
+            CACHE_GENERATION_CF);
+
+    return _qp.execute_internal(
+            query,
+            db::consistency_level::QUORUM,
+            internal_distributed_query_state(),
+            {sstring(CACHE_GENERATION_KEY)},
+            cql3::query_processor::cache_internal::yes).discard_result();
+}
+
+future<> service::invalidate_authorization_caches() const {
+    co_await invalidate_local_authorization_caches();
+    if (push_invalidation_enabled(_qp.db().get_config())) {
+        co_await bump_cache_generation();
+    }
+}
+
+future<> service::poll_cache_generation(std::chrono::milliseconds interval) {
+    static const sstring query = format("SELECT generation FROM {}.{} WHERE key = ?",
+            meta::AUTH_KS,
+            CACHE_GENERATION_CF);
+
+    std::optional<utils::UUID> last_seen;
+    while (!_as.abort_requested()) {
+        try {
+            auto rs = co_await _qp.execute_internal(
+                    query,
+                    db::consistency_level::QUORUM,
+                    internal_distributed_query_state(),
+                    {sstring(CACHE_GENERATION_KEY)},
+                    cql3::query_processor::cache_internal::yes);
+            auto generation = (rs->empty() || !rs->one().has("generation"))
+                    ? utils::UUID() : rs->one().get_as<utils::UUID>("generation");
+            if (last_seen && *last_seen != generation) {
+                log.debug("Authorization cache generation changed to {}, invalidating caches", generation);
+                co_await invalidate_local_authorization_caches();
+            }
+            last_seen = generation;
+        } catch (...) {
+            // The table may not be readable until the node joins the cluster.
+            log.debug("Failed to read the authorization cache generation: {}", std::current_exception());
+        }
+        try {
+            co_await sleep_abortable(interval, _as);
+        } catch (const sleep_aborted&) {
+        }
+    }
+}
+
 future<bool> service::has_existing_legacy_users() const {
     if (!_qp.db().has_schema(meta::AUTH_KS, meta::USERS_CF)) {
         return make_ready_future<bool>(false);
@@ -333,11 +450,7 @@ future<bool> service::has_superuser(std::string_view role_name) const {
 }
 
 future<role_set> service::get_roles(std::string_view role_name) const {
-    //
-    // We may wish to cache this information in the future (as Apache Cassandra does).
-    //
-
-    return _role_manager->query_granted(role_name, recursive_role_query::yes);
+    return _permissions_cache->get_roles(role_name);
 }
 
 future<bool> service::exists(const resource& r) const {
@@ -497,6 +610,11 @@ future<> alter_role(
                 ser.underlying_authenticator().supported_options()).then([&ser, name, &options] {
             return ser.underlying_authenticator().alter(name, options);
         });
+    }).finally([&ser] {
+        // The superuser status of roles is a part of cached permissions, and passwords
+        // a part of cached credentials. Invalidate even if altering failed, as the
+        // change may have been applied anyway.
+        return ser.invalidate_authorization_caches();
     });
 }
 
@@ -515,6 +633,8 @@ future<> drop_role(const service& ser, std::string_view name) {
         return ser.underlying_authenticator().drop(name);
     }).then([&ser, name] {
         return ser.underlying_role_manager().drop(name);
+    }).then([&ser] {
+        return ser.invalidate_authorization_caches();
     });
 }
 
@@ -540,6 +660,8 @@ future<> grant_permissions(
         const resource& r) {
     return validate_role_exists(ser, role_name).then([&ser, role_name, perms, &r] {
         return ser.underlying_authorizer().grant(role_name, perms, r);
+    }).then([&ser] {
+        return ser.invalidate_authorization_caches();
     });
 }
 
@@ -561,6 +683,8 @@ future<> revoke_permissions(
         const resource& r) {
     return validate_role_exists(ser, role_name).then([&ser, role_name, perms, &r] {
         return ser.underlying_authorizer().revoke(role_name, perms, r);
+    }).then([&ser] {
+        return ser.invalidate_authorization_caches();
     });
 }
 
@@ -12,6 +12,7 @@
 #include <memory>
 #include <optional>
 
+#include <seastar/core/abort_source.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/sstring.hh>
 #include <seastar/util/bool_class.hh>
@@ -39,6 +40,7 @@ class migration_listener;
 namespace auth {
 
 class role_or_anonymous;
+class auth_migration_listener;
 
 struct service_config final {
     sstring authorizer_java_name;
@@ -93,6 +95,11 @@ class service final : public seastar::peering_sharded_service<service> {
     utils::observer<uint32_t> _permissions_cache_update_interval_in_ms_observer;
     utils::observer<uint32_t> _permissions_cache_validity_in_ms_observer;
 
+    // Polls the generation of the authorization caches bumped by changes of
+    // grants and roles, on shard 0 only, when push invalidation is enabled.
+    seastar::abort_source _as;
+    future<> _cache_generation_poller = make_ready_future<>();
+
 public:
     service(
             utils::loading_cache_config,
@@ -122,6 +129,12 @@ class service final : public seastar::peering_sharded_service<service> {
 
     void reset_authorization_cache();
 
+    ///
+    /// Drops the cached permissions and roles on all shards of this node and, when push invalidation is enabled,
+    /// makes the other nodes drop theirs. Called after grants or roles change.
+    ///
+    future<> invalidate_authorization_caches() const;
+
     ///
     /// \returns an exceptional future with \ref nonexistant_role if the named role does not exist.
     ///
@@ -144,6 +157,8 @@ class service final : public seastar::peering_sharded_service<service> {
     ///
     /// Return the set of all roles granted to the given role, including itself and roles granted through other roles.
     ///
+    /// The set is cached along with permissions.
+    ///
     /// \returns an exceptional future with \ref nonexistent_role if the role does not exist.
     future<role_set> get_roles(std::string_view role_name) const;
 
@@ -162,9 +177,17 @@ class service final : public seastar::peering_sharded_service<service> {
     }
 
 private:
+    friend class auth_migration_listener;
+
     future<bool> has_existing_legacy_users() const;
 
     future<> create_keyspace_if_missing(::service::migration_manager& mm) const;
+
+    future<> invalidate_local_authorization_caches() const;
+
+    future<> bump_cache_generation() const;
+
+    future<> poll_cache_generation(std::chrono::milliseconds interval);
 };
 
 future<bool> has_superuser(const service&, const authenticated_user&);
@@ -106,6 +106,10 @@ class transitional_authenticator : public authenticator {
         return _authenticator->protected_resources();
     }
 
+    virtual void invalidate_cache() const override {
+        _authenticator->invalidate_cache();
+    }
+
     virtual ::shared_ptr<sasl_challenge> new_sasl_challenge() const override {
         class sasl_wrapper : public sasl_challenge {
         public:
@@ -13,6 +13,7 @@
 #include <seastar/core/file.hh>
 #include <chrono>
 #include <cmath>
+#include <algorithm>
 
 #include "seastarx.hh"
 
@@ -128,6 +129,19 @@ class compaction_controller : public backlog_controller {
     static constexpr unsigned normalization_factor = 30;
     static constexpr float disable_backlog = std::numeric_limits<double>::infinity();
     static constexpr float backlog_disabled(float backlog) { return std::isinf(backlog); }
+    // Translates the read amplification, the average number of sstables a single
+    // partition read touches, into the controller's input, so that compaction speeds
+    // up when reads suffer even if the size-based backlog is low.
+    //
+    // On or below the threshold the reads don't contribute; the input then grows
+    // linearly, reaching the maximum output when the read amplification is four
+    // times the threshold. A threshold of 0 disables the read feedback.
+    static float read_amplification_backlog(float sstables_per_read, float threshold) noexcept {
+        if (threshold <= 0 || sstables_per_read <= threshold) {
+            return 0.0f;
+        }
+        return std::min((sstables_per_read - threshold) / (3 * threshold), 1.0f) * normalization_factor;
+    }
     compaction_controller(backlog_controller::scheduling_group sg, float static_shares, std::chrono::milliseconds interval, std::function<float()> current_backlog)
         : backlog_controller(std::move(sg), std::move(interval),
           std::vector<backlog_controller::control_point>({{0.0, 50}, {1.5, 100} , {normalization_factor, 1000}}),
@@ -130,6 +130,8 @@ class cache_flat_mutation_reader final : public flat_mutation_reader_v2::impl {
     void start_reading_from_underlying();
     bool after_current_range(position_in_partition_view position);
     bool can_populate() const;
+    // Links an entry populated into the latest version in the cache LRU.
+    void link_populated_entry(rows_entry&) noexcept;
     // Marks the range between _last_row (exclusive) and _next_row (exclusive) as continuous,
     // provided that the underlying reader still matches the latest version of the partition.
     // Invalidates _last_row.
@@ -285,7 +287,11 @@ future<> cache_flat_mutation_reader::process_static_row() {
 
 inline
 void cache_flat_mutation_reader::touch_partition() {
-    _snp->touch();
+    // Scans which populate on probation don't promote the partitions they pass through,
+    // only the rows they find in cache.
+    if (!_read_context.populate_on_probation()) {
+        _snp->touch();
+    }
 }
 
 inline
@@ -445,7 +451,7 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
                                 auto insert_result = rows.insert_before_hint(_next_row.get_iterator_in_latest_version(), std::move(e), cmp);
                                 if (insert_result.second) {
                                     auto it = insert_result.first;
-                                    _snp->tracker()->insert(*it);
+                                    link_populated_entry(*it);
                                     auto next = std::next(it);
                                     // Also works in reverse read mode.
                                     // It preserves the continuity of the range the entry falls into.
@@ -462,7 +468,7 @@ future<> cache_flat_mutation_reader::read_from_underlying() {
                                 auto insert_result = rows.insert_before_hint(_next_row.get_iterator_in_latest_version(), std::move(e), cmp);
                                 if (insert_result.second) {
                                     clogger.trace("csm {}: L{}: inserted dummy at {}", fmt::ptr(this), __LINE__, _upper_bound);
-                                    _snp->tracker()->insert(*insert_result.first);
+                                    link_populated_entry(*insert_result.first);
                                 }
                                 if (_read_context.is_reversed()) [[unlikely]] {
                                     clogger.trace("csm {}: set_continuous({}), prev={}, rt={}", fmt::ptr(this), _last_row.position(), insert_result.first->position(), _current_tombstone);
@@ -549,7 +555,7 @@ void cache_flat_mutation_reader::maybe_update_continuity() {
                         auto insert_result = rows.insert(std::move(e2), table_cmp);
                         if (insert_result.second) {
                             clogger.trace("csm {}: L{}: inserted dummy at {}", fmt::ptr(this), __LINE__, insert_result.first->position());
-                            _snp->tracker()->insert(*insert_result.first);
+                            link_populated_entry(*insert_result.first);
                         }
                         clogger.trace("csm {}: set_continuous({}), prev={}, rt={}", fmt::ptr(this), insert_result.first->position(),
                                       _last_row.position(), _current_tombstone);
@@ -577,7 +583,7 @@ void cache_flat_mutation_reader::maybe_update_continuity() {
                         auto insert_result = rows.insert_before_hint(_next_row.get_iterator_in_latest_version(), std::move(e2), table_cmp);
                         if (insert_result.second) {
                             clogger.trace("csm {}: L{}: inserted dummy at {}", fmt::ptr(this), __LINE__, insert_result.first->position());
-                            _snp->tracker()->insert(*insert_result.first);
+                            link_populated_entry(*insert_result.first);
                         }
                         clogger.trace("csm {}: set_continuous({}), prev={}, rt={}", fmt::ptr(this), insert_result.first->position(),
                                       _last_row.position(), _current_tombstone);
@@ -624,7 +630,7 @@ void cache_flat_mutation_reader::maybe_add_to_cache(const clustering_row& cr) {
         auto insert_result = mp.mutable_clustered_rows().insert_before_hint(it, std::move(new_entry), cmp);
         it = insert_result.first;
         if (insert_result.second) {
-            _snp->tracker()->insert(*it);
+            link_populated_entry(*it);
         }
 
         rows_entry& e = *it;
@@ -688,7 +694,7 @@ bool cache_flat_mutation_reader::maybe_add_to_cache(const range_tombstone_change
         auto insert_result = mp.mutable_clustered_rows().insert_before_hint(it, std::move(new_entry), cmp);
         it = insert_result.first;
         if (insert_result.second) {
-            _snp->tracker()->insert(*it);
+            link_populated_entry(*it);
         }
 
         rows_entry& e = *it;
@@ -717,6 +723,17 @@ bool cache_flat_mutation_reader::maybe_add_to_cache(const range_tombstone_change
     return true;
 }
 
+inline
+void cache_flat_mutation_reader::link_populated_entry(rows_entry& e) noexcept {
+    // Entries may be inserted on probation only if there are no older versions,
+    // see cache_tracker::insert_on_probation().
+    if (_read_context.populate_on_probation() && _snp->at_oldest_version()) {
+        _snp->tracker()->insert_on_probation(e);
+    } else {
+        _snp->tracker()->insert(e);
+    }
+}
+
 inline
 bool cache_flat_mutation_reader::after_current_range(position_in_partition_view p) {
     position_in_partition::tri_compare cmp(*_schema);
@@ -727,7 +744,11 @@ inline
 void cache_flat_mutation_reader::start_reading_from_underlying() {
     clogger.trace("csm {}: start_reading_from_underlying(), range=[{}, {})", fmt::ptr(this), _lower_bound, _next_row_in_range ? _next_row.position() : _upper_bound);
     _state = state::move_to_underlying;
-    _next_row.touch();
+    // See touch_partition(). The entry bounding the range is often the one the scan
+    // has just inserted.
+    if (!_read_context.populate_on_probation()) {
+        _next_row.touch();
+    }
 }
 
 inline
@@ -885,7 +906,7 @@ void cache_flat_mutation_reader::move_to_range(query::clustering_row_ranges::con
                 });
                 auto it = insert_result.first;
                 if (insert_result.second) {
-                    _snp->tracker()->insert(*it);
+                    link_populated_entry(*it);
                 }
                 _last_row = partition_snapshot_row_weakref(*_snp, it, true);
             } else {
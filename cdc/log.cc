@@ -1672,18 +1672,38 @@ class transformer final : public change_processor {
 
         const auto select_cl = adjust_cl(write_cl);
 
-      try {
-        return _ctx._proxy.query(_schema, std::move(command), std::move(partition_ranges), select_cl, service::storage_proxy::coordinator_query_options(default_timeout(), empty_service_permit(), client_state)).then(
-                [s = _schema, partition_slice = std::move(partition_slice), selection = std::move(selection)] (service::storage_proxy::coordinator_query_result qr) -> lw_shared_ptr<cql3::untyped_result_set> {
-            return make_lw_shared<cql3::untyped_result_set>(*s, std::move(qr.query_result), *selection, partition_slice);
-        });
-      } catch (exceptions::unavailable_exception& e) {
-        // `query` can throw `unavailable_exception`, which is seen by clients as ~ "NoHostAvailable". 
-        // So, we'll translate it to a `read_failure_exception` with custom message.
-        cdc_log.debug("Preimage: translating a (read) `unavailable_exception` to `request_execution_exception` - {}", e);
-        throw exceptions::read_failure_exception("CDC preimage query could not achieve the CL.",
-                e.consistency, e.alive, 0, e.required, false);
-      }
+        auto to_result_set = [s = _schema, partition_slice = std::move(partition_slice), selection = std::move(selection)] (foreign_ptr<lw_shared_ptr<query::result>> result) {
+            return make_lw_shared<cql3::untyped_result_set>(*s, std::move(result), *selection, partition_slice);
+        };
+        // Note: the continuations must not refer to this transformer, which
+        // the caller moves away while the select is in progress.
+        auto select = [&proxy = _ctx._proxy, s = _schema, command, partition_ranges, select_cl, &client_state, to_result_set] () mutable {
+          try {
+            return proxy.query(s, std::move(command), std::move(partition_ranges), select_cl, service::storage_proxy::coordinator_query_options(default_timeout(), empty_service_permit(), client_state)).then(
+                    [to_result_set = std::move(to_result_set)] (service::storage_proxy::coordinator_query_result qr) {
+                return to_result_set(std::move(qr.query_result));
+            });
+          } catch (exceptions::unavailable_exception& e) {
+            // `query` can throw `unavailable_exception`, which is seen by clients as ~ "NoHostAvailable".
+            // So, we'll translate it to a `read_failure_exception` with custom message.
+            cdc_log.debug("Preimage: translating a (read) `unavailable_exception` to `request_execution_exception` - {}", e);
+            throw exceptions::read_failure_exception("CDC preimage query could not achieve the CL.",
+                    e.consistency, e.alive, 0, e.required, false);
+          }
+        };
+        // Any replica's data will do for a CL=ONE select, so if this node is
+        // a replica of the partition, read the preimage straight from its
+        // memtables, cache and sstables, skipping the coordinator read path.
+        if (select_cl == db::consistency_level::ONE || select_cl == db::consistency_level::LOCAL_ONE) {
+            return _ctx._proxy.query_singular_locally(_schema, command, partition_ranges.front(), default_timeout()).then(
+                    [to_result_set, select = std::move(select)] (foreign_ptr<lw_shared_ptr<query::result>> result) mutable {
+                if (result) {
+                    return make_ready_future<lw_shared_ptr<cql3::untyped_result_set>>(to_result_set(std::move(result)));
+                }
+                return select();
+            });
+        }
+        return select();
     }
 
     // Note: this assumes that the results are from one partition only
@@ -95,6 +95,30 @@ api::timestamp_type collection_mutation_view::last_update(const abstract_type& t
     return max;
 }
 
+collection_mutation_cell_cursor::collection_mutation_cell_cursor(const abstract_type& type, collection_mutation_view v)
+        : _type(type)
+        , _in(v.data) {
+    auto has_tomb = read_simple<uint8_t>(_in);
+    if (has_tomb) {
+        auto ts = read_simple<api::timestamp_type>(_in);
+        auto ttl = read_simple<gc_clock::duration::rep>(_in);
+        _tomb = tombstone{ts, gc_clock::time_point(gc_clock::duration(ttl))};
+    }
+    _size = read_simple<uint32_t>(_in);
+    _cells = _in;
+}
+
+bool collection_mutation_cell_cursor::next() {
+    if (_in.empty()) {
+        return false;
+    }
+    auto ksize = read_simple<uint32_t>(_in);
+    _key = read_simple_bytes(_in, ksize);
+    auto vsize = read_simple<uint32_t>(_in);
+    _value = read_simple_bytes(_in, vsize);
+    return true;
+}
+
 std::ostream& operator<<(std::ostream& os, const collection_mutation_view::printer& cmvp) {
     fmt::print(os, "{{collection_mutation_view ");
     cmvp._cmv.with_deserialized(cmvp._type, [&os, &type = cmvp._type] (const collection_mutation_view_description& cmvd) {
@@ -301,7 +325,89 @@ merge(collection_mutation_view_description a, collection_mutation_view_descripti
     return merged;
 }
 
+// When the keys of one side all sort before the keys of the other, as is the case when appending to a list
+// or adding new keys to a map, and neither side's tombstone kills a cell of the other side, the merged
+// cells are just the serialized cells of both sides, one after the other. Detect that with a scan that
+// doesn't deserialize or copy anything, and splice the raw bytes instead of rebuilding every cell.
+static std::optional<collection_mutation>
+merge_disjoint(const abstract_type& type, const abstract_type& key_type, collection_mutation_view a, collection_mutation_view b) {
+    collection_mutation_cell_cursor a_cells(type, a);
+    collection_mutation_cell_cursor b_cells(type, b);
+
+    struct key_range {
+        managed_bytes_view first;
+        managed_bytes_view last;
+    };
+    // Same rule as cell_killed() in the general merge: the tombstone wins if timestamps are equal.
+    auto scan = [] (collection_mutation_cell_cursor& cells, tombstone other) -> std::optional<key_range> {
+        key_range range;
+        bool first = true;
+        while (cells.next()) {
+            if (other.timestamp >= cells.cell().timestamp()) {
+                return std::nullopt;
+            }
+            if (first) {
+                range.first = cells.key();
+                first = false;
+            }
+            range.last = cells.key();
+        }
+        return range;
+    };
+    auto a_range = scan(a_cells, b_cells.tomb());
+    if (!a_range) {
+        return std::nullopt;
+    }
+    auto b_range = scan(b_cells, a_cells.tomb());
+    if (!b_range) {
+        return std::nullopt;
+    }
+
+    const collection_mutation_cell_cursor* lower;
+    const collection_mutation_cell_cursor* upper;
+    if (!a_cells.size() || !b_cells.size() || key_type.compare(a_range->last, b_range->first) < 0) {
+        lower = &a_cells;
+        upper = &b_cells;
+    } else if (key_type.compare(b_range->last, a_range->first) < 0) {
+        lower = &b_cells;
+        upper = &a_cells;
+    } else {
+        return std::nullopt;
+    }
+
+    auto tomb = std::max(a_cells.tomb(), b_cells.tomb());
+    size_t size = 1 + sizeof(uint32_t) + lower->serialized_cells().size() + upper->serialized_cells().size();
+    if (tomb) {
+        size += sizeof(int64_t) + sizeof(int64_t);
+    }
+    managed_bytes ret(managed_bytes::initialized_later(), size);
+    managed_bytes_mutable_view out(ret);
+    write<uint8_t>(out, uint8_t(bool(tomb)));
+    if (tomb) {
+        write<int64_t>(out, tomb.timestamp);
+        write<int64_t>(out, tomb.deletion_time.time_since_epoch().count());
+    }
+    write<int32_t>(out, lower->size() + upper->size());
+    write_fragmented(out, lower->serialized_cells());
+    write_fragmented(out, upper->serialized_cells());
+    return collection_mutation(type, std::move(ret));
+}
+
 collection_mutation merge(const abstract_type& type, collection_mutation_view a, collection_mutation_view b) {
+    auto spliced = visit(type, make_visitor(
+    [&] (const collection_type_impl& ctype) {
+        return merge_disjoint(type, *ctype.name_comparator(), a, b);
+    },
+    [&] (const user_type_impl& utype) {
+        return merge_disjoint(type, *short_type, a, b);
+    },
+    [] (const abstract_type& o) -> std::optional<collection_mutation> {
+        throw std::runtime_error(format("collection_mutation merge: unknown type: {}", o.name()));
+    }
+    ));
+    if (spliced) {
+        return std::move(*spliced);
+    }
     return a.with_deserialized(type, [&] (collection_mutation_view_description a_view) {
         return b.with_deserialized(type, [&] (collection_mutation_view_description b_view) {
             return visit(type, make_visitor(
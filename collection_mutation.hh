@@ -105,6 +105,35 @@ class collection_mutation_view {
     };
 };
 
+// A forward-only cursor over the cells of a collection_mutation_view.
+// Unlike with_deserialized(), it neither materializes the cells into a vector nor linearizes fragmented keys:
+// each cell is decoded only when the cursor reaches it, so callers that can stop early, or that only need
+// to look at the raw bytes, don't pay for the whole collection.
+class collection_mutation_cell_cursor {
+    const abstract_type& _type;
+    managed_bytes_view _in;
+    tombstone _tomb;
+    uint32_t _size;
+    managed_bytes_view _cells;
+    managed_bytes_view _key;
+    managed_bytes_view _value;
+public:
+    collection_mutation_cell_cursor(const abstract_type&, collection_mutation_view);
+
+    tombstone tomb() const { return _tomb; }
+    // The number of cells in the mutation.
+    uint32_t size() const { return _size; }
+    // All the cells, in their serialized form.
+    managed_bytes_view serialized_cells() const { return _cells; }
+
+    // Moves to the next cell. Returns false if there are no more cells.
+    bool next();
+
+    // Valid only after next() returned true.
+    managed_bytes_view key() const { return _key; }
+    atomic_cell_view cell() const { return atomic_cell_view::from_bytes(_type, _value); }
+};
+
 // A serialized mutation of a collection of cells.
 // Used to represent mutations of collections (lists, maps, sets) or non-frozen user defined types.
 // It contains a sequence of cells, each representing a mutation of a single entry (element or field) of the collection.
@@ -15,6 +15,7 @@
 #include <utility>
 #include <assert.h>
 #include <algorithm>
+#include <ranges>
 
 #include <boost/range/algorithm.hpp>
 #include <boost/range/adaptors.hpp>
@@ -143,28 +144,98 @@ std::ostream& operator<<(std::ostream& os, compaction_type_options::scrub::quara
     return os << to_string(quarantine_mode);
 }
 
-static api::timestamp_type get_max_purgeable_timestamp(const table_state& table_s, sstable_set::incremental_selector& selector,
-        const std::unordered_set<shared_sstable>& compacting_set, const dht::decorated_key& dk, uint64_t& bloom_filter_checks) {
-    if (!table_s.tombstone_gc_enabled()) [[unlikely]] {
-        return api::min_timestamp;
+// Computes the max purgeable timestamp of the partitions of a compaction, that is the minimum
+// timestamp of the data outside of the compaction which their tombstones may shadow.
+//
+// The sstables which don't take part in the compaction and may hold the partitions are cached,
+// sorted by minimum timestamp, for as long as the compaction is within the token range they were
+// selected for. A partition is checked only against the sstables whose key range includes it, and
+// only as long as their minimum timestamp could lower the result, so the first one whose bloom
+// filter has the key ends the search. Memtables only count if they hold the partition.
+class max_purgeable_timestamp_tracker {
+    const table_state& _table_s;
+    const std::unordered_set<shared_sstable>& _compacting_set;
+    uint64_t& _bloom_filter_checks;
+    dht::ring_position_comparator _cmp;
+    std::vector<shared_sstable> _candidates;
+    // The candidates are valid for the positions before this one.
+    std::optional<dht::ring_position_ext> _candidates_end;
+private:
+    bool may_hold(const shared_sstable& sst, const dht::decorated_key& dk) const {
+        const auto& s = *_table_s.schema();
+        return sst->get_first_decorated_key().tri_compare(s, dk) <= 0 && sst->get_last_decorated_key().tri_compare(s, dk) >= 0;
     }
 
-    auto timestamp = table_s.min_memtable_timestamp();
-    std::optional<utils::hashed_key> hk;
-    for (auto&& sst : boost::range::join(selector.select(dk).sstables, table_s.compacted_undeleted_sstables())) {
-        if (compacting_set.contains(sst)) {
-            continue;
+    void select_candidates(sstable_set::incremental_selector& selector, const dht::decorated_key& dk) {
+        auto selection = selector.select(dk);
+        _candidates.clear();
+        for (auto& sst : selection.sstables) {
+            if (!_compacting_set.contains(sst)) {
+                _candidates.push_back(sst);
+            }
         }
-        if (!hk) {
-            hk = sstables::sstable::make_hashed_key(*table_s.schema(), dk.key());
+        std::ranges::sort(_candidates, std::less<>(), [] (const shared_sstable& sst) {
+            return sst->get_stats_metadata().min_timestamp;
+        });
+        _candidates_end.emplace(selection.next_position);
+    }
+public:
+    max_purgeable_timestamp_tracker(const table_state& table_s, const std::unordered_set<shared_sstable>& compacting_set, uint64_t& bloom_filter_checks)
+        : _table_s(table_s)
+        , _compacting_set(compacting_set)
+        , _bloom_filter_checks(bloom_filter_checks)
+        , _cmp(*table_s.schema())
+    { }
+
+    // Must be called when the selector is replaced.
+    void invalidate() noexcept {
+        _candidates_end.reset();
+    }
+
+    // Must be called for increasing keys.
+    api::timestamp_type get(sstable_set::incremental_selector& selector, const dht::decorated_key& dk) {
+        if (!_table_s.tombstone_gc_enabled()) [[unlikely]] {
+            return api::min_timestamp;
+        }
+
+        if (!_candidates_end || _cmp(dht::ring_position_view(dk), dht::ring_position_view(*_candidates_end)) >= 0) {
+            select_candidates(selector, dk);
+        }
+
+        auto timestamp = _table_s.min_memtable_timestamp(dk);
+        std::optional<utils::hashed_key> hk;
+        auto has_key = [&] (const shared_sstable& sst) {
+            if (!may_hold(sst, dk)) {
+                return false;
+            }
+            if (!hk) {
+                hk = sstables::sstable::make_hashed_key(*_table_s.schema(), dk.key());
+            }
+            if (sst->filter_has_key(*hk)) {
+                _bloom_filter_checks++;
+                return true;
+            }
+            return false;
+        };
+        for (auto& sst : _candidates) {
+            auto min_timestamp = sst->get_stats_metadata().min_timestamp;
+            if (min_timestamp >= timestamp) {
+                break;
+            }
+            if (has_key(sst)) {
+                timestamp = min_timestamp;
+                break;
+            }
         }
-        if (sst->filter_has_key(*hk)) {
-            bloom_filter_checks++;
-            timestamp = std::min(timestamp, sst->get_stats_metadata().min_timestamp);
+        for (auto& sst : _table_s.compacted_undeleted_sstables()) {
+            auto min_timestamp = sst->get_stats_metadata().min_timestamp;
+            if (min_timestamp < timestamp && !_compacting_set.contains(sst) && has_key(sst)) {
+                timestamp = min_timestamp;
+            }
         }
+        return timestamp;
     }
-    return timestamp;
-}
+};
 
 static std::vector<shared_sstable> get_uncompacting_sstables(const table_state& table_s, std::vector<shared_sstable> sstables) {
     auto all_sstables = boost::copy_range<std::vector<shared_sstable>>(*table_s.main_sstable_set().all());
@@ -472,6 +543,8 @@ class compaction {
     const sstables::compaction_type _type;
     const uint64_t _max_sstable_size;
     const uint32_t _sstable_level;
+    // The output is repaired only if all the input is.
+    uint64_t _repaired_at = 0;
     uint64_t _start_size = 0;
     uint64_t _end_size = 0;
     // fully expired files, which are skipped, aren't taken into account.
@@ -490,11 +563,14 @@ class compaction {
     // used to incrementally calculate max purgeable timestamp, as we iterate through decorated keys.
     std::optional<sstable_set::incremental_selector> _selector;
     std::unordered_set<shared_sstable> _compacting_for_max_purgeable_func;
+    max_purgeable_timestamp_tracker _max_purgeable_tracker;
     // optional owned_ranges vector for cleanup;
     const owned_ranges_ptr _owned_ranges = {};
     // required for reshard compaction.
     const dht::sharder* _sharder = nullptr;
     const std::optional<dht::incremental_owned_ranges_checker> _owned_ranges_checker;
+    // Partitions left to compact, when resuming an interrupted compaction.
+    const std::optional<dht::partition_range> _resume_range;
     // Garbage collected sstables that are sealed but were not added to SSTable set yet.
     std::vector<shared_sstable> _unused_garbage_collected_sstables;
     // Garbage collected sstables that were added to SSTable set and should be eventually removed from it.
@@ -525,14 +601,21 @@ class compaction {
         , _sstable_set(std::move(descriptor.all_sstables_snapshot))
         , _selector(_sstable_set ? _sstable_set->make_incremental_selector() : std::optional<sstable_set::incremental_selector>{})
         , _compacting_for_max_purgeable_func(std::unordered_set<shared_sstable>(_sstables.begin(), _sstables.end()))
+        , _max_purgeable_tracker(_table_s, _compacting_for_max_purgeable_func, _bloom_filter_checks)
         , _owned_ranges(std::move(descriptor.owned_ranges))
         , _sharder(descriptor.sharder)
         , _owned_ranges_checker(_owned_ranges ? std::optional<dht::incremental_owned_ranges_checker>(*_owned_ranges) : std::nullopt)
+        , _resume_range(descriptor.resume_after
+                ? std::optional<dht::partition_range>(dht::partition_range::make_starting_with({dht::ring_position(*descriptor.resume_after), false}))
+                : std::nullopt)
         , _progress_monitor(progress_monitor)
     {
         for (auto& sst : _sstables) {
             _stats_collector.update(sst->get_encoding_stats_for_compaction());
         }
+        if (!_sstables.empty() && std::ranges::all_of(_sstables, std::mem_fn(&sstable::is_repaired))) {
+            _repaired_at = std::ranges::min(_sstables | std::views::transform(std::mem_fn(&sstable::get_repaired_at)));
+        }
         std::unordered_set<run_id> ssts_run_ids;
         _contains_multi_fragment_runs = std::any_of(_sstables.begin(), _sstables.end(), [&ssts_run_ids] (shared_sstable& sst) {
             return !ssts_run_ids.insert(sst->run_identifier()).second;
@@ -578,13 +661,34 @@ class compaction {
         });
         sstable_writer_config cfg = _table_s.configure_writer(std::move(s));
         cfg.max_sstable_size = _max_sstable_size;
+        cfg.estimated_data_size = std::min(_start_size, _max_sstable_size);
         cfg.monitor = &default_write_monitor();
         cfg.run_identifier = _run_identifier;
         cfg.replay_position = _rp;
         cfg.sstable_level = _sstable_level;
+        cfg.repaired_at = _repaired_at;
+        if (writes_checkpoints()) {
+            scylla_metadata::compaction_checkpoint checkpoint;
+            checkpoint.inputs.elements.reserve(_input_sstable_generations.size());
+            for (auto gen : _input_sstable_generations) {
+                auto s = fmt::to_string(gen);
+                checkpoint.inputs.elements.push_back(disk_string<uint32_t>{bytes(to_bytes_view(sstring_view(s)))});
+            }
+            checkpoint.max_sstable_size = _max_sstable_size;
+            cfg.compaction_checkpoint = std::move(checkpoint);
+        }
         return cfg;
     }
 
+    // Regular compactions producing sstable runs record their inputs in their output sstables,
+    // so that they can be resumed after the last sealed output if they're stopped by a shutdown.
+    // That's not needed when the inputs are released incrementally, as the outputs are then
+    // already in use, and not possible when a partition can span outputs.
+    bool writes_checkpoints() const noexcept {
+        return _type == compaction_type::Compaction && _max_sstable_size != std::numeric_limits<uint64_t>::max()
+                && !_owned_ranges && !_can_split_large_partition && !enable_garbage_collected_sstable_writer();
+    }
+
     api::timestamp_type maximum_timestamp() const {
         auto m = std::max_element(_sstables.begin(), _sstables.end(), [] (const shared_sstable& sst1, const shared_sstable& sst2) {
             return sst1->get_stats_metadata().max_timestamp < sst2->get_stats_metadata().max_timestamp;
@@ -613,6 +717,7 @@ class compaction {
         auto monitor = std::make_unique<compaction_write_monitor>(sst, _table_s, maximum_timestamp(), _sstable_level);
         sstable_writer_config cfg = _table_s.configure_writer("garbage_collection");
         cfg.run_identifier = gc_run;
+        cfg.repaired_at = _repaired_at;
         cfg.monitor = monitor.get();
         auto writer = sst->get_writer(*schema(), partitions_per_sstable(), cfg, get_encoding_stats());
         return compaction_writer(std::move(monitor), std::move(writer), std::move(sst));
@@ -684,7 +789,7 @@ class compaction {
         if (!_owned_ranges_checker) {
             return make_sstable_reader(_schema,
                                        _permit,
-                                       query::full_partition_range,
+                                       _resume_range ? *_resume_range : query::full_partition_range,
                                        _schema->full_slice(),
                                        tracing::trace_state_ptr(),
                                        ::streamed_mutation::forwarding::no,
@@ -772,6 +877,9 @@ class compaction {
             _rp = std::max(_rp, sst_stats.position);
         }
         log_info("{} {}", report_start_desc(), formatted_msg);
+        if (_resume_range) {
+            log_info("Resuming interrupted compaction after partition {}", _resume_range->start()->value());
+        }
         if (ssts->size() < _sstables.size()) {
             log_debug("{} out of {} input sstables are fully expired sstables that will not be actually compacted",
                       _sstables.size() - ssts->size(), _sstables.size());
@@ -877,6 +985,10 @@ class compaction {
 private:
     void on_interrupt(std::exception_ptr ex) {
         log_info("{} of {} sstables interrupted due to: {}", report_start_desc(), _input_sstable_generations.size(), ex);
+        if (_cdata.keep_checkpoint_on_stop && _cdata.is_stop_requested() && writes_checkpoints()) {
+            keep_sstables_for_interrupted_compaction();
+            return;
+        }
         delete_sstables_for_interrupted_compaction();
     }
 
@@ -890,7 +1002,7 @@ class compaction {
             };
         }
         return [this] (const dht::decorated_key& dk) {
-            return get_max_purgeable_timestamp(_table_s, *_selector, _compacting_for_max_purgeable_func, dk, _bloom_filter_checks);
+            return _max_purgeable_tracker.get(*_selector, dk);
         };
     }
 
@@ -922,6 +1034,18 @@ class compaction {
             sst->mark_for_deletion();
         }
     }
+
+    void keep_sstables_for_interrupted_compaction() {
+        // Only the partially written sstables have to be deleted. The sealed ones hold
+        // the checkpoint of the compaction and will be loaded on restart, to resume it.
+        for (auto& sst : _new_partial_sstables) {
+            log_debug("Deleting sstable {} of interrupted compaction for {}.{}", sst->get_filename(), _schema->ks_name(), _schema->cf_name());
+            sst->mark_for_deletion();
+        }
+        if (!_new_unused_sstables.empty()) {
+            log_info("Keeping sstables {} of interrupted compaction, to resume it on restart", formatted_sstables_list(_new_unused_sstables, true));
+        }
+    }
 protected:
     template <typename... Args>
     void log(log_level level, std::string_view fmt, const Args&... args) const {
@@ -1221,6 +1345,7 @@ class regular_compaction : public compaction {
             }
         }
         _selector.emplace(_sstable_set->make_incremental_selector());
+        _max_purgeable_tracker.invalidate();
     }
 };
 
@@ -1853,12 +1978,14 @@ get_fully_expired_sstables(const table_state& table_s, const std::vector<sstable
     auto uncompacting_sstables = get_uncompacting_sstables(table_s, compacting);
     // Get list of uncompacting sstables that overlap the ones being compacted.
     std::vector<sstables::shared_sstable> overlapping = leveled_manifest::overlapping(*table_s.schema(), compacting, uncompacting_sstables);
-    int64_t min_timestamp = std::numeric_limits<int64_t>::max();
+    // The sstables which may hold data that is not expired, and so may be shadowed
+    // by the tombstones and expired cells of the candidates.
+    std::vector<sstables::shared_sstable> live;
 
     for (auto& sstable : overlapping) {
         auto gc_before = sstable->get_gc_before_for_fully_expire(compaction_time, table_s.get_tombstone_gc_state());
         if (sstable->get_max_local_deletion_time() >= gc_before) {
-            min_timestamp = std::min(min_timestamp, sstable->get_stats_metadata().min_timestamp);
+            live.push_back(sstable);
         }
     }
 
@@ -1885,15 +2012,31 @@ get_fully_expired_sstables(const table_state& table_s, const std::vector<sstable
             clogger.debug("Adding candidate of generation {} to list of possibly expired sstables", candidate->generation());
             candidates.insert(candidate);
         } else {
-            min_timestamp = std::min(min_timestamp, candidate->get_stats_metadata().min_timestamp);
+            live.push_back(candidate);
         }
     }
 
+    // A candidate may shadow the data of a live sstable only if the two overlap both
+    // in token range and in time, that is, the live sstable has data older than the
+    // newest tombstone of the candidate. Checking each candidate against the sstables
+    // it overlaps with, rather than against the oldest data of all of them, keeps a
+    // single out-of-order write from holding back the expiry of unrelated sstables.
+    auto shadows_live_data = [&live] (const sstables::shared_sstable& candidate) {
+        auto first = candidate->get_first_decorated_key()._token;
+        auto last = candidate->get_last_decorated_key()._token;
+        auto max_timestamp = candidate->get_stats_metadata().max_timestamp;
+        return boost::algorithm::any_of(live, [&] (const sstables::shared_sstable& sst) {
+            return sst->get_stats_metadata().min_timestamp <= max_timestamp
+                && sst->get_first_decorated_key()._token <= last
+                && sst->get_last_decorated_key()._token >= first;
+        });
+    };
+
     auto it = candidates.begin();
     while (it != candidates.end()) {
         auto& candidate = *it;
         // Remove from list any candidate that may contain a tombstone that covers older data.
-        if (candidate->get_stats_metadata().max_timestamp >= min_timestamp) {
+        if (shadows_live_data(candidate)) {
             it = candidates.erase(it);
         } else {
             clogger.debug("Dropping expired SSTable {} (maxLocalDeletionTime={})",
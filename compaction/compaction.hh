@@ -55,6 +55,9 @@ struct compaction_data {
     abort_source abort;
     utils::UUID compaction_uuid;
     unsigned compaction_fan_in = 0;
+    // If set when the compaction is stopped, its sealed output sstables are
+    // kept so that it can be resumed after a restart, if it writes checkpoints.
+    bool keep_checkpoint_on_stop = false;
     struct replacement {
         const std::vector<shared_sstable> removed;
         const std::vector<shared_sstable> added;
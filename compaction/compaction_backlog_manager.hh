@@ -79,6 +79,15 @@ class compaction_backlog_tracker {
     void copy_ongoing_charges(compaction_backlog_tracker& new_bt, bool move_read_charges = true) const;
     void revert_charges(sstables::shared_sstable sst);
 
+    // Scales the backlog of this tracker, e.g. to make the tables of a tenant with
+    // lower priority contribute less to the shares of compaction.
+    void set_weight(double weight) noexcept {
+        _weight = weight;
+    }
+    double weight() const noexcept {
+        return _weight;
+    }
+
     void disable() {
         _impl = {};
         _ongoing_writes = {};
@@ -94,6 +103,7 @@ class compaction_backlog_tracker {
     ongoing_writes _ongoing_writes;
     ongoing_compactions _ongoing_compactions;
     compaction_backlog_manager* _manager = nullptr;
+    double _weight = 1;
     friend class compaction_backlog_manager;
 };
 
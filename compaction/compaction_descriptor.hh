@@ -163,6 +163,9 @@ struct compaction_descriptor {
     compaction::owned_ranges_ptr owned_ranges;
     // Required for reshard compaction.
     const dht::sharder* sharder;
+    // If engaged, compaction resumes an interrupted compaction of the same sstables,
+    // whose output already covers all the partitions up to and including this key.
+    std::optional<dht::decorated_key> resume_after;
 
     compaction_sstable_creator_fn creator;
     compaction_sstable_replacer_fn replacer;
@@ -13,21 +13,27 @@
 #include "compaction_weight_registration.hh"
 #include "sstables/sstables.hh"
 #include "sstables/sstables_manager.hh"
+#include "sstables/compress.hh"
 #include <memory>
 #include <seastar/core/metrics.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/switch_to.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/core/sleep.hh>
 #include "sstables/exceptions.hh"
 #include "sstables/sstable_directory.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include "utils/fb_utilities.hh"
 #include "utils/UUID_gen.hh"
 #include "db/system_keyspace.hh"
+#include <bit>
 #include <cmath>
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
+#include <boost/range/irange.hpp>
+#include <boost/range/numeric.hpp>
+#include <ranges>
 
 static logging::logger cmlog("compaction_manager");
 using namespace std::chrono_literals;
@@ -241,6 +247,52 @@ std::vector<sstables::shared_sstable> compaction_manager::get_candidates(table_s
     return get_candidates(t, *t.main_sstable_set().all());
 }
 
+void compaction_manager::keep_checkpoints_of_ongoing_compactions() noexcept {
+    for (auto& task : _tasks) {
+        task->keep_checkpoint_on_stop();
+    }
+}
+
+sstables::compaction_descriptor compaction_manager::get_resumable_compaction_job(table_state& t) const {
+    auto candidates = get_candidates(t);
+    std::unordered_map<sstables::run_id, std::vector<sstables::shared_sstable>> checkpointed_runs;
+    std::unordered_map<sstables::generation_type, sstables::shared_sstable> by_generation;
+    for (auto& sst : candidates) {
+        by_generation.emplace(sst->generation(), sst);
+        if (sst->get_compaction_checkpoint()) {
+            checkpointed_runs[sst->run_identifier()].push_back(sst);
+        }
+    }
+
+    auto s = t.schema();
+    for (auto& [id, fragments] : checkpointed_runs) {
+        auto& checkpoint = *fragments.front()->get_compaction_checkpoint();
+        std::vector<sstables::shared_sstable> inputs;
+        inputs.reserve(checkpoint.inputs.elements.size());
+        for (auto& input : checkpoint.inputs.elements) {
+            auto gen = sstables::generation_type::from_string(std::string(reinterpret_cast<const char*>(input.value.data()), input.value.size()));
+            auto it = by_generation.find(gen);
+            if (it == by_generation.end()) {
+                break;
+            }
+            inputs.push_back(it->second);
+        }
+        if (inputs.size() != checkpoint.inputs.elements.size()) {
+            continue;
+        }
+        // The fragments are disjoint, and were written in key order.
+        auto& last = *std::ranges::max_element(fragments, [&s] (const sstables::shared_sstable& a, const sstables::shared_sstable& b) {
+            return a->get_last_decorated_key().tri_compare(*s, b->get_last_decorated_key()) < 0;
+        });
+        cmlog.info("Resuming compaction of {} sstable(s) for {} after {}, interrupted with {} output sstable(s)",
+                inputs.size(), t, last->get_last_decorated_key(), fragments.size());
+        sstables::compaction_descriptor descriptor(std::move(inputs), last->get_sstable_level(), checkpoint.max_sstable_size, id);
+        descriptor.resume_after = last->get_last_decorated_key();
+        return descriptor;
+    }
+    return sstables::compaction_descriptor();
+}
+
 bool compaction_manager::eligible_for_compaction(const sstables::shared_sstable& sstable) const {
     return sstables::is_eligible_for_compaction(sstable) && !_compacting_sstables.contains(sstable);
 }
@@ -358,6 +410,29 @@ future<compaction_manager::compaction_stats_opt> compaction_manager::perform_tas
     co_return std::nullopt;
 }
 
+// Loads the index pages which are hot in the index cache of the replaced sstables into the index
+// cache of their replacements, so that reads of the hot partitions don't all miss the cache once
+// the replacements are in place. Failing to do so only costs those misses.
+static future<> warm_index_caches(table_state& t, const std::vector<sstables::shared_sstable>& old_sstables,
+        const std::vector<sstables::shared_sstable>& new_sstables) {
+    dht::token_range_vector hot_ranges;
+    for (auto& sst : old_sstables) {
+        auto ranges = sst->get_hot_index_ranges();
+        std::move(ranges.begin(), ranges.end(), std::back_inserter(hot_ranges));
+    }
+    if (hot_ranges.empty()) {
+        co_return;
+    }
+    hot_ranges = dht::token_range::deoverlap(std::move(hot_ranges), dht::token_comparator());
+    for (auto& sst : new_sstables) {
+        try {
+            co_await sst->warm_index_cache(hot_ranges, t.make_compaction_reader_permit());
+        } catch (...) {
+            cmlog.warn("Failed to warm the index cache of {}: {}", sst->get_filename(), std::current_exception());
+        }
+    }
+}
+
 future<> compaction_manager::on_compaction_completion(table_state& t, sstables::compaction_completion_desc desc, sstables::offstrategy offstrategy) {
     auto& cs = get_compaction_state(&t);
     auto new_sstables = boost::copy_range<std::unordered_set<sstables::shared_sstable>>(desc.new_sstables);
@@ -413,6 +488,9 @@ future<sstables::compaction_result> compaction_task_executor::compact_sstables(s
         // - are still in the main set
         // - are not being compacted.
         on_replace.on_addition(desc.new_sstables);
+        if (_cm.index_cache_warming()) {
+            warm_index_caches(t, desc.old_sstables, desc.new_sstables).get();
+        }
         auto old_sstables = desc.old_sstables;
         _cm.on_compaction_completion(t, std::move(desc), offstrategy).get();
         on_replace.on_removal(old_sstables);
@@ -543,12 +621,147 @@ class major_compaction_task_executor : public compaction_task_executor, public m
         // the exclusive lock can be freed to let regular compaction run in parallel to major
         lock_holder.return_all();
 
-        co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, on_replace);
+        auto sub_ranges = split_into_sub_ranges(descriptor);
+        if (sub_ranges.size() > 1) {
+            co_await compact_sstables_in_sub_ranges(std::move(descriptor), std::move(sub_ranges), on_replace);
+        } else {
+            co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, on_replace);
+        }
 
         finish_compaction();
 
         co_return std::nullopt;
     }
+private:
+    // Splits the token span of the input into as many sub-ranges of equal token width as
+    // allowed by the configured parallelism and the minimum input size per sub-compaction.
+    // Returns a single range if the job shouldn't be split.
+    dht::token_range_vector split_into_sub_ranges(const sstables::compaction_descriptor& descriptor) const {
+        auto& cs = _cm.get_compaction_state(_compacting_table);
+        // Inputs that require cleanup have to be compacted with the owned ranges, keep it simple
+        // and don't split such jobs.
+        if (descriptor.sstables.empty() || std::ranges::any_of(descriptor.sstables, [&cs] (const sstables::shared_sstable& sst) {
+                    return cs.sstables_requiring_cleanup.contains(sst);
+                })) {
+            return { dht::token_range::make_open_ended_both_sides() };
+        }
+        uint64_t input_size = boost::accumulate(descriptor.sstables | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::data_size)), uint64_t(0));
+        uint64_t count = _cm.major_compaction_max_parallelism();
+        if (auto min_split_size = _cm.major_compaction_min_split_size()) {
+            count = std::min(count, input_size / min_split_size);
+        }
+        if (count <= 1) {
+            return { dht::token_range::make_open_ended_both_sides() };
+        }
+
+        auto first = std::ranges::min(descriptor.sstables | std::views::transform([] (const sstables::shared_sstable& sst) {
+            return dht::token::to_int64(sst->get_first_decorated_key().token());
+        }));
+        auto last = std::ranges::max(descriptor.sstables | std::views::transform([] (const sstables::shared_sstable& sst) {
+            return dht::token::to_int64(sst->get_last_decorated_key().token());
+        }));
+        auto step = (uint64_t(last) - uint64_t(first)) / count;
+        if (step == 0) {
+            return { dht::token_range::make_open_ended_both_sides() };
+        }
+
+        // The first and last ranges are open-ended, so the sub-ranges cover the whole ring.
+        dht::token_range_vector ranges;
+        ranges.reserve(count);
+        std::optional<dht::token_range::bound> start;
+        for (uint64_t i = 1; i < count; ++i) {
+            auto end = dht::token(dht::token_kind::key, int64_t(uint64_t(first) + step * i));
+            ranges.emplace_back(std::move(start), dht::token_range::bound(end, true));
+            start = dht::token_range::bound(end, false);
+        }
+        ranges.emplace_back(std::move(start), std::nullopt);
+        return ranges;
+    }
+
+    // Runs one compaction per sub-range concurrently, all reading the same input, each restricted to
+    // its own sub-range. The input is only replaced by the output once all of them are done, so the
+    // job commits atomically, just like an unsplit one.
+    future<> compact_sstables_in_sub_ranges(sstables::compaction_descriptor descriptor, dht::token_range_vector sub_ranges, on_replacement& on_replace) {
+        table_state& t = *_compacting_table;
+        cmlog.info("{}: splitting major compaction into {} sub-compactions", *this, sub_ranges.size());
+
+        struct sub_compaction {
+            sstables::compaction_data cdata;
+            sstables::compaction_progress_monitor progress_monitor;
+        };
+        std::vector<std::unique_ptr<sub_compaction>> subs;
+        for (size_t i = 0; i < sub_ranges.size(); ++i) {
+            subs.push_back(std::make_unique<sub_compaction>(sub_compaction{_cm.create_compaction_data()}));
+        }
+        auto stop_subs = [&subs] (sstring reason) noexcept {
+            for (auto& sub : subs) {
+                sub->cdata.stop(reason);
+            }
+        };
+        auto stop_subscription = _compaction_data.abort.subscribe([this, &stop_subs] () noexcept {
+            stop_subs(_compaction_data.stop_requested);
+        });
+
+        // Output of all sub-compactions, including the garbage-collected sstables they wrote
+        // and are still using.
+        std::unordered_set<sstables::shared_sstable> new_sstables;
+        sstables::compaction_result res;
+        std::exception_ptr ex;
+        try {
+            co_await coroutine::parallel_for_each(boost::irange(size_t(0), sub_ranges.size()), [&] (size_t i) -> future<> {
+                auto desc = sstables::compaction_descriptor(descriptor.sstables, descriptor.level, descriptor.max_sstable_bytes,
+                        descriptor.run_identifier, descriptor.options, make_lw_shared<const dht::token_range_vector>(dht::token_range_vector{sub_ranges[i]}));
+                desc.enable_garbage_collection(t.main_sstable_set());
+                desc.creator = [&t] (shard_id dummy) {
+                    return t.make_sstable();
+                };
+                // The input is still being read by the other sub-compactions, so nothing is
+                // replaced in the table before all of them are done.
+                desc.replacer = [&new_sstables] (sstables::compaction_completion_desc desc) {
+                    new_sstables.insert(desc.new_sstables.begin(), desc.new_sstables.end());
+                    for (auto& sst : desc.old_sstables) {
+                        if (new_sstables.erase(sst)) {
+                            sst->mark_for_deletion();
+                        }
+                    }
+                };
+                try {
+                    auto sub_res = co_await sstables::compact_sstables(std::move(desc), subs[i]->cdata, t, subs[i]->progress_monitor);
+                    // All sub-compactions have the same input.
+                    res.stats.start_size = sub_res.stats.start_size;
+                    res.stats.end_size += sub_res.stats.end_size;
+                    res.stats.ended_at = std::max(res.stats.ended_at, sub_res.stats.ended_at);
+                    res.stats.bloom_filter_checks += sub_res.stats.bloom_filter_checks;
+                } catch (...) {
+                    stop_subs("sub-compaction failed");
+                    throw;
+                }
+            });
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        res.new_sstables = boost::copy_range<std::vector<sstables::shared_sstable>>(new_sstables);
+        if (ex) {
+            for (auto& sst : res.new_sstables) {
+                sst->mark_for_deletion();
+            }
+            if (_compaction_data.is_stop_requested()) {
+                co_await coroutine::return_exception(make_compaction_stopped_exception());
+            }
+            co_await coroutine::return_exception_ptr(std::move(ex));
+        }
+
+        t.get_compaction_strategy().notify_completion(t, descriptor.sstables, res.new_sstables);
+        _cm.propagate_replacement(t, descriptor.sstables, res.new_sstables);
+        on_replace.on_addition(res.new_sstables);
+        co_await _cm.on_compaction_completion(t, sstables::compaction_completion_desc{
+            .old_sstables = descriptor.sstables,
+            .new_sstables = res.new_sstables,
+        }, sstables::offstrategy::no);
+        on_replace.on_removal(descriptor.sstables);
+
+        co_await update_history(t, res, _compaction_data);
+    }
 };
 
 }
@@ -867,7 +1080,7 @@ compaction_manager::compaction_manager(config cfg, abort_source& as, tasks::task
             // all strategies.
             return compaction_controller::normalization_factor;
         }
-        return b;
+        return std::max(b, double(update_read_amplification_backlog()));
     }))
     , _backlog_manager(_compaction_controller)
     , _early_abort_subscription(as.subscribe([this] () noexcept {
@@ -926,6 +1139,18 @@ future<> compaction_manager::update_throughput(uint32_t value_mbs) {
     });
 }
 
+float compaction_manager::update_read_amplification_backlog() noexcept {
+    const auto& st = sstables::sstables_stats::get_shard_stats();
+    auto reads = st.single_key_reads - std::exchange(_last_single_key_reads, st.single_key_reads);
+    auto sstables = st.single_key_read_sstables - std::exchange(_last_single_key_read_sstables, st.single_key_read_sstables);
+    // Smooth the per-interval average, so that shares don't jump with every
+    // short burst of reads. An interval without reads pulls it down.
+    constexpr float alpha = 0.25f;
+    float current = reads ? float(sstables) / reads : 0.0f;
+    _read_amplification += (current - _read_amplification) * alpha;
+    return compaction_controller::read_amplification_backlog(_read_amplification, read_amplification_threshold());
+}
+
 void compaction_manager::register_metrics() {
     namespace sm = seastar::metrics;
 
@@ -944,8 +1169,14 @@ void compaction_manager::register_metrics() {
                        sm::description("Holds the sum of compaction backlog for all tables in the system.")),
         sm::make_gauge("normalized_backlog", [this] { return _last_backlog / available_memory(); },
                        sm::description("Holds the sum of normalized compaction backlog for all tables in the system. Backlog is normalized by dividing backlog by shard's available memory.")),
+        sm::make_gauge("read_amplification", [this] { return _read_amplification; },
+                       sm::description("Holds the smoothed average number of sstables read by single partition reads, as seen by the compaction controller.")),
         sm::make_counter("validation_errors", [this] { return _validation_errors; },
                        sm::description("Holds the number of encountered validation errors.")),
+        sm::make_counter("cleanup_dropped_sstables", [this] { return _stats.cleanup_dropped_sstables; },
+                       sm::description("Holds the number of sstables with no owned data dropped by cleanup without reading them.")),
+        sm::make_counter("cleanup_skipped_bytes", [this] { return _stats.cleanup_skipped_bytes; },
+                       sm::description("Holds the number of data bytes cleanup didn't have to read, because they were in dropped sstables, in sstables with no unowned data, or in unowned partitions.")),
     });
 }
 
@@ -1049,6 +1280,7 @@ future<> compaction_manager::drain() {
     cmlog.info("Asked to drain");
     if (*_early_abort_subscription) {
         _state = state::disabled;
+        keep_checkpoints_of_ongoing_compactions();
         co_await stop_ongoing_compactions("drain");
     }
     cmlog.info("Drained");
@@ -1068,6 +1300,7 @@ future<> compaction_manager::really_do_stop() {
     cmlog.info("Asked to stop");
     // Reset the metrics registry
     _metrics.clear();
+    keep_checkpoints_of_ongoing_compactions();
     co_await stop_ongoing_compactions("shutdown");
     co_await coroutine::parallel_for_each(_compaction_state | boost::adaptors::map_values, [] (compaction_state& cs) -> future<> {
         if (!cs.gate.is_closed()) {
@@ -1179,7 +1412,10 @@ class regular_compaction_task_executor : public compaction_task_executor, public
 
             table_state& t = *_compacting_table;
             sstables::compaction_strategy cs = t.get_compaction_strategy();
-            sstables::compaction_descriptor descriptor = cs.get_sstables_for_compaction(t, _cm.get_strategy_control());
+            sstables::compaction_descriptor descriptor = _cm.get_resumable_compaction_job(t);
+            if (descriptor.sstables.empty()) {
+                descriptor = cs.get_sstables_for_compaction(t, _cm.get_strategy_control());
+            }
             int weight = calculate_weight(descriptor);
 
             if (descriptor.sstables.empty() || !can_proceed() || t.is_auto_compaction_disabled_by_user()) {
@@ -1481,9 +1717,13 @@ class rewrite_sstables_compaction_task_executor : public sstables_task_executor
         co_return stats;
     }
 
-private:
+protected:
     future<sstables::compaction_result> rewrite_sstable(const sstables::shared_sstable sst) {
-        co_await coroutine::switch_to(_cm.compaction_sg());
+        return rewrite_sstable(std::move(sst), _cm.compaction_sg());
+    }
+
+    future<sstables::compaction_result> rewrite_sstable(const sstables::shared_sstable sst, const compaction_manager::scheduling_group& sg) {
+        co_await coroutine::switch_to(sg);
 
         for (;;) {
             switch_state(state::active);
@@ -1520,6 +1760,64 @@ class rewrite_sstables_compaction_task_executor : public sstables_task_executor
     }
 };
 
+// Rewrites sstables, one at a time, with maintenance priority, the largest and coldest first,
+// as they're the ones the rewrite is most worth for, while the rest of the table keeps being
+// compacted as usual. The rewrite is paced so that it reads at most the given number of bytes
+// per second on average, if any.
+class recompress_sstables_compaction_task_executor : public rewrite_sstables_compaction_task_executor {
+    uint64_t _io_budget_bytes_per_second;
+public:
+    recompress_sstables_compaction_task_executor(compaction_manager& mgr, throw_if_stopping do_throw_if_stopping, table_state* t, tasks::task_id parent_id, sstables::compaction_type_options options, owned_ranges_ptr owned_ranges_ptr,
+                                     std::vector<sstables::shared_sstable> sstables, compacting_sstable_registration compacting, uint64_t io_budget_bytes_per_second)
+        : rewrite_sstables_compaction_task_executor(mgr, do_throw_if_stopping, t, parent_id, std::move(options), std::move(owned_ranges_ptr), std::move(sstables), std::move(compacting),
+                compaction_manager::can_purge_tombstones::yes)
+        , _io_budget_bytes_per_second(io_budget_bytes_per_second)
+    {
+        // Sstables are consumed from the back. Order them by size tier, so that the largest are rewritten
+        // first, and by age of their newest data within a tier, so that the coldest are rewritten first.
+        std::sort(_sstables.begin(), _sstables.end(), [] (const sstables::shared_sstable& a, const sstables::shared_sstable& b) {
+            auto tier_a = std::bit_width(a->data_size());
+            auto tier_b = std::bit_width(b->data_size());
+            if (tier_a != tier_b) {
+                return tier_a < tier_b;
+            }
+            return a->get_stats_metadata().max_timestamp > b->get_stats_metadata().max_timestamp;
+        });
+    }
+
+protected:
+    virtual future<compaction_manager::compaction_stats_opt> do_run() override {
+        sstables::compaction_stats stats{};
+
+        switch_state(state::pending);
+        auto maintenance_permit = co_await acquire_semaphore(_cm._maintenance_ops_sem);
+
+        auto start = seastar::lowres_clock::now();
+        uint64_t bytes_read = 0;
+        while (!_sstables.empty() && can_proceed()) {
+            auto sst = consume_sstable();
+            bytes_read += sst->data_size();
+            auto res = co_await rewrite_sstable(std::move(sst), _cm.maintenance_sg());
+            stats += res.stats;
+
+            if (!_io_budget_bytes_per_second || _sstables.empty()) {
+                continue;
+            }
+            auto due = start + std::chrono::duration_cast<seastar::lowres_clock::duration>(
+                    std::chrono::duration<double>(double(bytes_read) / _io_budget_bytes_per_second));
+            if (due > seastar::lowres_clock::now()) {
+                try {
+                    co_await seastar::sleep_abortable<seastar::lowres_clock>(due - seastar::lowres_clock::now(), _compaction_data.abort);
+                } catch (const sleep_aborted&) {
+                    break;
+                }
+            }
+        }
+
+        co_return stats;
+    }
+};
+
 }
 
 template<typename TaskType, typename... Args>
@@ -1638,6 +1936,10 @@ class cleanup_sstables_compaction_task_executor : public compaction_task_executo
     owned_ranges_ptr _owned_ranges_ptr;
     compacting_sstable_registration _compacting;
     std::vector<sstables::compaction_descriptor> _pending_cleanup_jobs;
+    // Data of the sstables that cleanup didn't have to read, see skip_sstables_not_requiring_rewrite().
+    uint64_t _dropped_bytes = 0;
+    uint64_t _kept_bytes = 0;
+    uint64_t _skipped_bytes = 0;
 public:
     cleanup_sstables_compaction_task_executor(compaction_manager& mgr, throw_if_stopping do_throw_if_stopping, table_state* t, tasks::task_id parent_id, sstables::compaction_type_options options, owned_ranges_ptr owned_ranges_ptr,
                                      std::vector<sstables::shared_sstable> candidates, compacting_sstable_registration compacting)
@@ -1685,9 +1987,70 @@ class cleanup_sstables_compaction_task_executor : public compaction_task_executo
             _cm._stats.pending_tasks--;
         }
 
+        if (_dropped_bytes || _kept_bytes || _skipped_bytes) {
+            cmlog.info("Cleanup of {} skipped {} bytes: {} bytes of sstables with no owned data were dropped, {} bytes of sstables with no unowned data were kept, "
+                    "and {} unowned bytes of the rewritten sstables were skipped", *_compacting_table,
+                    _dropped_bytes + _kept_bytes + _skipped_bytes, _dropped_bytes, _kept_bytes, _skipped_bytes);
+        }
+
         co_return std::nullopt;
     }
 private:
+    // Avoids rewriting the sstables of the job that don't need it.
+    // Sstables with no owned token in their range are dropped without being read. Sstables with
+    // no partition in the unowned parts of their range, according to their index, are kept as they are.
+    // The others are rewritten, and the reader skips their unowned partitions through the index, so
+    // those are not read either.
+    future<> skip_sstables_not_requiring_rewrite(sstables::compaction_descriptor& descriptor, on_replacement& on_replace) {
+        if (!_owned_ranges_ptr) {
+            co_return;
+        }
+        auto& t = *_compacting_table;
+        auto s = t.schema();
+        const auto& owned_ranges = *_owned_ranges_ptr;
+        auto owned_partition_ranges = dht::to_partition_ranges(owned_ranges);
+
+        std::vector<sstables::shared_sstable> unowned;
+        std::vector<sstables::shared_sstable> owned;
+        dht::partition_range_vector ranges_for_cache_invalidation;
+        for (const auto& sst : descriptor.sstables) {
+            auto sst_range = dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true});
+            auto sst_token_range = dht::token_range::make(sst->get_first_decorated_key().token(), sst->get_last_decorated_key().token());
+            if (std::ranges::none_of(owned_ranges, [&] (const dht::token_range& r) { return r.overlaps(sst_token_range, dht::token_comparator()); })) {
+                unowned.push_back(sst);
+                ranges_for_cache_invalidation.push_back(std::move(sst_range));
+                _dropped_bytes += sst->data_size();
+                continue;
+            }
+            auto unowned_ranges = co_await dht::subtract_ranges(*s, {sst_range}, owned_partition_ranges);
+            auto unowned_bytes = co_await sst->data_size_in_ranges(unowned_ranges, t.make_compaction_reader_permit());
+            if (!unowned_bytes) {
+                owned.push_back(sst);
+                _kept_bytes += sst->data_size();
+            } else {
+                _skipped_bytes += unowned_bytes;
+            }
+        }
+        _cm._stats.cleanup_dropped_sstables += unowned.size();
+        _cm._stats.cleanup_skipped_bytes += _dropped_bytes + _kept_bytes + _skipped_bytes;
+
+        if (!unowned.empty()) {
+            cmlog.debug("Cleanup of {} drops {} sstables with no owned data: {}", t, unowned.size(), unowned);
+            t.get_compaction_strategy().notify_completion(t, unowned, {});
+            _cm.propagate_replacement(t, unowned, {});
+            co_await _cm.on_compaction_completion(t, sstables::compaction_completion_desc{
+                .old_sstables = unowned,
+                .ranges_for_cache_invalidation = std::move(ranges_for_cache_invalidation),
+            }, sstables::offstrategy::no);
+            // Releases the sstables and removes them from the job.
+            on_replace.on_removal(unowned);
+        }
+        if (!owned.empty()) {
+            cmlog.debug("Cleanup of {} keeps {} sstables with no unowned data: {}", t, owned.size(), owned);
+            on_replace.on_removal(owned);
+        }
+    }
+
     future<> run_cleanup_job(sstables::compaction_descriptor descriptor) {
         co_await coroutine::switch_to(_cm.compaction_sg());
 
@@ -1708,6 +2071,10 @@ class cleanup_sstables_compaction_task_executor : public compaction_task_executo
             }
         };
         release_exhausted on_replace{_compacting, descriptor};
+        co_await skip_sstables_not_requiring_rewrite(descriptor, on_replace);
+        if (descriptor.sstables.empty()) {
+            co_return;
+        }
         for (;;) {
             compaction_backlog_tracker user_initiated(std::make_unique<user_initiated_backlog_tracker>(_cm._compaction_controller.backlog_of_shares(200), _cm.available_memory()));
             _cm.register_backlog_tracker(user_initiated);
@@ -1907,6 +2274,24 @@ future<> compaction_manager::perform_sstable_upgrade(owned_ranges_ptr sorted_own
     return rewrite_sstables(t, sstables::compaction_type_options::make_upgrade(), std::move(sorted_owned_ranges), std::move(get_sstables), info).discard_result();
 }
 
+// Submit a table to be recompressed and wait for its termination.
+future<compaction_manager::compaction_stats_opt> compaction_manager::perform_sstable_recompression(owned_ranges_ptr sorted_owned_ranges, table_state& t, uint32_t io_budget_mb_per_sec, std::optional<tasks::task_info> info) {
+    auto get_sstables = [this, &t] {
+        std::vector<sstables::shared_sstable> tables;
+        auto last_version = t.get_sstables_manager().get_highest_supported_format();
+        const auto& compression = t.schema()->get_compressor_params();
+        for (auto& sst : get_candidates(t)) {
+            if (sst->get_version() < last_version || !sstables::is_compressed_with(sst->get_compression(), compression)) {
+                tables.emplace_back(sst);
+            }
+        }
+        return make_ready_future<std::vector<sstables::shared_sstable>>(std::move(tables));
+    };
+
+    return perform_task_on_all_files<recompress_sstables_compaction_task_executor>(info, t, sstables::compaction_type_options::make_upgrade(), std::move(sorted_owned_ranges),
+            std::move(get_sstables), uint64_t(io_budget_mb_per_sec) << 20);
+}
+
 // Submit a table to be scrubbed and wait for its termination.
 future<compaction_manager::compaction_stats_opt> compaction_manager::perform_sstable_scrub(table_state& t, sstables::compaction_type_options::scrub opts, std::optional<tasks::task_info> info) {
     auto scrub_mode = opts.operation_mode;
@@ -2075,7 +2460,7 @@ void compaction_manager::unplug_system_keyspace() noexcept {
 }
 
 double compaction_backlog_tracker::backlog() const {
-    return disabled() ? compaction_controller::disable_backlog : _impl->backlog(_ongoing_writes, _ongoing_compactions);
+    return disabled() ? compaction_controller::disable_backlog : _impl->backlog(_ongoing_writes, _ongoing_compactions) * _weight;
 }
 
 void compaction_backlog_tracker::replace_sstables(const std::vector<sstables::shared_sstable>& old_ssts, const std::vector<sstables::shared_sstable>& new_ssts) {
@@ -2155,6 +2540,7 @@ compaction_backlog_tracker::compaction_backlog_tracker(compaction_backlog_tracke
         : _impl(std::move(other._impl))
         , _ongoing_writes(std::move(other._ongoing_writes))
         , _ongoing_compactions(std::move(other._ongoing_compactions))
+        , _weight(other._weight)
 {
     if (other._manager) {
         on_internal_error(cmlog, "compaction_backlog_tracker is moved while registered");
@@ -2201,6 +2587,9 @@ compaction_backlog_manager::~compaction_backlog_manager() {
 
 void compaction_manager::register_backlog_tracker(table_state& t, compaction_backlog_tracker new_backlog_tracker) {
     auto& cs = get_compaction_state(&t);
+    if (cs.backlog_tracker) {
+        new_backlog_tracker.set_weight(cs.backlog_tracker->weight());
+    }
     cs.backlog_tracker.emplace(std::move(new_backlog_tracker));
     register_backlog_tracker(*cs.backlog_tracker);
 }
@@ -61,6 +61,7 @@ class custom_compaction_task_executor;
 class regular_compaction_task_executor;
 class offstrategy_compaction_task_executor;
 class rewrite_sstables_compaction_task_executor;
+class recompress_sstables_compaction_task_executor;
 class cleanup_sstables_compaction_task_executor;
 class validate_sstables_compaction_task_executor;
 }
@@ -74,6 +75,8 @@ class compaction_manager {
         int64_t completed_tasks = 0;
         uint64_t active_tasks = 0; // Number of compaction going on.
         int64_t errors = 0;
+        uint64_t cleanup_dropped_sstables = 0; // Number of sstables cleanup dropped without reading them.
+        uint64_t cleanup_skipped_bytes = 0; // Number of data bytes cleanup didn't have to read.
     };
     using scheduling_group = backlog_controller::scheduling_group;
     struct config {
@@ -82,6 +85,10 @@ class compaction_manager {
         size_t available_memory = 0;
         utils::updateable_value<float> static_shares = utils::updateable_value<float>(0);
         utils::updateable_value<uint32_t> throughput_mb_per_sec = utils::updateable_value<uint32_t>(0);
+        utils::updateable_value<uint32_t> major_compaction_max_parallelism = utils::updateable_value<uint32_t>(1);
+        utils::updateable_value<uint32_t> major_compaction_min_split_size_in_mb = utils::updateable_value<uint32_t>(1024);
+        utils::updateable_value<bool> index_cache_warming = utils::updateable_value<bool>(false);
+        utils::updateable_value<float> read_amplification_threshold = utils::updateable_value<float>(0);
     };
 
 public:
@@ -113,6 +120,11 @@ class compaction_manager {
     stats _stats;
     seastar::metrics::metric_groups _metrics;
     double _last_backlog = 0.0f;
+    // Smoothed number of sstables touched per single partition read, and the
+    // shard-wide read counters it was last updated from.
+    float _read_amplification = 0.0f;
+    uint64_t _last_single_key_reads = 0;
+    uint64_t _last_single_key_read_sstables = 0;
 
     // Store sstables that are being compacted at the moment. That's needed to prevent
     // a sstable from being compacted twice.
@@ -194,6 +206,9 @@ class compaction_manager {
     // Get candidates for compaction strategy, which are all sstables but the ones being compacted.
     std::vector<sstables::shared_sstable> get_candidates(compaction::table_state& t) const;
 
+    // Make the ongoing compactions keep their checkpoints when they're stopped.
+    void keep_checkpoints_of_ongoing_compactions() noexcept;
+
     bool eligible_for_compaction(const sstables::shared_sstable& sstable) const;
     bool eligible_for_compaction(const sstables::frozen_sstable_run& sstable_run) const;
 
@@ -281,6 +296,26 @@ class compaction_manager {
         return _cfg.throughput_mb_per_sec.get();
     }
 
+    uint32_t major_compaction_max_parallelism() const noexcept {
+        return _cfg.major_compaction_max_parallelism.get();
+    }
+
+    uint64_t major_compaction_min_split_size() const noexcept {
+        return uint64_t(_cfg.major_compaction_min_split_size_in_mb.get()) << 20;
+    }
+
+    bool index_cache_warming() const noexcept {
+        return _cfg.index_cache_warming.get();
+    }
+
+    float read_amplification_threshold() const noexcept {
+        return _cfg.read_amplification_threshold.get();
+    }
+
+    // Updates the read amplification from the reads done since the last call,
+    // and returns the controller input it translates to.
+    float update_read_amplification_backlog() noexcept;
+
     void register_metrics();
 
     // enable the compaction manager.
@@ -331,6 +366,12 @@ class compaction_manager {
     // Submit a table to be upgraded and wait for its termination.
     future<> perform_sstable_upgrade(owned_ranges_ptr sorted_owned_ranges, compaction::table_state& t, bool exclude_current_version, std::optional<tasks::task_info> info = std::nullopt);
 
+    // Submit a table to have the sstables which are not compressed with its current compression
+    // parameters, or not in the latest format, rewritten, and wait for its termination.
+    // Unlike an upgrade, it runs with maintenance priority, rewrites the largest and coldest sstables
+    // first, and, if io_budget_mb_per_sec is not 0, is paced to read at most that much data per second.
+    future<compaction_stats_opt> perform_sstable_recompression(owned_ranges_ptr sorted_owned_ranges, compaction::table_state& t, uint32_t io_budget_mb_per_sec, std::optional<tasks::task_info> info = std::nullopt);
+
     // Submit a table to be scrubbed and wait for its termination.
     future<compaction_stats_opt> perform_sstable_scrub(compaction::table_state& t, sstables::compaction_type_options::scrub opts, std::optional<tasks::task_info> info = std::nullopt);
 
@@ -408,6 +449,12 @@ class compaction_manager {
         return _backlog_manager.backlog();
     }
 
+    // The backlog last seen by the compaction controller, normalized by the
+    // shard's available memory, or 0 if the backlog is disabled. Cheap, unlike backlog().
+    double last_normalized_backlog() const noexcept {
+        return compaction_controller::backlog_disabled(_last_backlog) ? 0 : _last_backlog / available_memory();
+    }
+
     void register_backlog_tracker(compaction_backlog_tracker& backlog_tracker) {
         _backlog_manager.register_backlog_tracker(backlog_tracker);
     }
@@ -419,6 +466,12 @@ class compaction_manager {
 
     compaction::strategy_control& get_strategy_control() const noexcept;
 
+    // Returns a job that resumes a compaction of the table interrupted by a shutdown,
+    // or an empty descriptor if there is none.
+    // The sealed output sstables of such a compaction hold its checkpoint, and it can
+    // be resumed, into the same run, if none of its inputs was compacted since.
+    sstables::compaction_descriptor get_resumable_compaction_job(compaction::table_state& t) const;
+
     tombstone_gc_state& get_tombstone_gc_state() noexcept {
         return _tombstone_gc_state;
     };
@@ -446,6 +499,7 @@ class compaction_manager {
     friend class compaction::regular_compaction_task_executor;
     friend class compaction::offstrategy_compaction_task_executor;
     friend class compaction::rewrite_sstables_compaction_task_executor;
+    friend class compaction::recompress_sstables_compaction_task_executor;
     friend class compaction::cleanup_sstables_compaction_task_executor;
     friend class compaction::validate_sstables_compaction_task_executor;
 };
@@ -583,6 +637,11 @@ class compaction_task_executor : public enable_shared_from_this<compaction_task_
 
     void stop_compaction(sstring reason) noexcept;
 
+    // Keep the checkpoint of the compaction, if any, when it's stopped.
+    void keep_checkpoint_on_stop() noexcept {
+        _compaction_data.keep_checkpoint_on_stop = true;
+    }
+
     sstables::compaction_stopped_exception make_compaction_stopped_exception() const;
 
     template<typename TaskExecutor, typename... Args>
@@ -21,6 +21,7 @@
 #include "compaction_strategy_state.hh"
 #include "schema/schema.hh"
 #include "sstables/sstable_set.hh"
+#include "sstables/hyperloglog.hh"
 #include <boost/range/algorithm/find.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
 #include <boost/range/adaptors.hpp>
@@ -28,6 +29,7 @@
 #include "size_tiered_compaction_strategy.hh"
 #include "leveled_compaction_strategy.hh"
 #include "time_window_compaction_strategy.hh"
+#include "incremental_compaction_strategy.hh"
 #include "backlog_controller.hh"
 #include "compaction_backlog_manager.hh"
 #include "size_tiered_backlog_tracker.hh"
@@ -66,6 +68,44 @@ bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& s
     return sst->estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold;
 }
 
+shared_sstable compaction_strategy_impl::get_most_droppable_sstable(table_state& table_s, const std::vector<shared_sstable>& candidates, gc_clock::time_point compaction_time) {
+    shared_sstable most_droppable;
+    double max_droppable_bytes = 0;
+    for (const auto& sst : candidates) {
+        if (!worth_dropping_tombstones(sst, compaction_time, table_s.get_tombstone_gc_state())) {
+            continue;
+        }
+        auto gc_before = sst->get_gc_before_for_drop_estimation(compaction_time, table_s.get_tombstone_gc_state());
+        auto droppable_bytes = sst->data_size() * sst->estimate_droppable_tombstone_ratio(gc_before);
+        if (!most_droppable || droppable_bytes > max_droppable_bytes) {
+            most_droppable = sst;
+            max_droppable_bytes = droppable_bytes;
+        }
+    }
+    return most_droppable;
+}
+
+std::optional<double> compaction_strategy_impl::estimate_duplicate_partitions(const std::vector<shared_sstable>& sstables) {
+    std::optional<hll::HyperLogLog> merged;
+    double sum = 0;
+    for (const auto& sst : sstables) {
+        auto sketch = sst->get_partition_key_sketch();
+        if (!sketch || (merged && merged->registerSize() != sketch->registerSize())) {
+            return std::nullopt;
+        }
+        sum += sketch->estimate();
+        if (!merged) {
+            merged = std::move(sketch);
+        } else {
+            merged->merge(*sketch);
+        }
+    }
+    if (!merged) {
+        return 0;
+    }
+    return std::max(sum - merged->estimate(), 0.0);
+}
+
 uint64_t compaction_strategy_impl::adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) const {
     return partition_estimate;
 }
@@ -137,6 +177,40 @@ static db_clock::duration validate_tombstone_compaction_interval(const std::map<
     return tombstone_compaction_interval;
 }
 
+static bool validate_proactive_tombstone_compaction(const std::map<sstring, sstring>& options) {
+    auto tmp_value = compaction_strategy_impl::get_value(options, compaction_strategy_impl::PROACTIVE_TOMBSTONE_COMPACTION_OPTION);
+    if (!tmp_value) {
+        return false;
+    }
+    if (*tmp_value != "true" && *tmp_value != "false") {
+        throw exceptions::configuration_exception(fmt::format("{} value ({}) must be \"true\" or \"false\"", compaction_strategy_impl::PROACTIVE_TOMBSTONE_COMPACTION_OPTION, *tmp_value));
+    }
+    return *tmp_value == "true";
+}
+
+static bool validate_proactive_tombstone_compaction(const std::map<sstring, sstring>& options, std::map<sstring, sstring>& unchecked_options) {
+    auto proactive_tombstone_compaction = validate_proactive_tombstone_compaction(options);
+    unchecked_options.erase(compaction_strategy_impl::PROACTIVE_TOMBSTONE_COMPACTION_OPTION);
+    return proactive_tombstone_compaction;
+}
+
+static bool validate_prefer_overlapping_sstables(const std::map<sstring, sstring>& options) {
+    auto tmp_value = compaction_strategy_impl::get_value(options, compaction_strategy_impl::PREFER_OVERLAPPING_SSTABLES_OPTION);
+    if (!tmp_value) {
+        return false;
+    }
+    if (*tmp_value != "true" && *tmp_value != "false") {
+        throw exceptions::configuration_exception(fmt::format("{} value ({}) must be \"true\" or \"false\"", compaction_strategy_impl::PREFER_OVERLAPPING_SSTABLES_OPTION, *tmp_value));
+    }
+    return *tmp_value == "true";
+}
+
+static bool validate_prefer_overlapping_sstables(const std::map<sstring, sstring>& options, std::map<sstring, sstring>& unchecked_options) {
+    auto prefer_overlapping_sstables = validate_prefer_overlapping_sstables(options);
+    unchecked_options.erase(compaction_strategy_impl::PREFER_OVERLAPPING_SSTABLES_OPTION);
+    return prefer_overlapping_sstables;
+}
+
 void compaction_strategy_impl::validate_options_for_strategy_type(const std::map<sstring, sstring>& options, sstables::compaction_strategy_type type) {
     auto unchecked_options = options;
     compaction_strategy_impl::validate_options(options, unchecked_options);
@@ -150,6 +224,9 @@ void compaction_strategy_impl::validate_options_for_strategy_type(const std::map
         case compaction_strategy_type::time_window:
             time_window_compaction_strategy::validate_options(options, unchecked_options);
             break;
+        case compaction_strategy_type::incremental:
+            incremental_compaction_strategy::validate_options(options, unchecked_options);
+            break;
         default:
             break;
     }
@@ -167,6 +244,9 @@ void compaction_strategy_impl::validate_options(const std::map<sstring, sstring>
     validate_tombstone_threshold(options, unchecked_options);
     validate_tombstone_compaction_interval(options, unchecked_options);
 
+    validate_proactive_tombstone_compaction(options, unchecked_options);
+    validate_prefer_overlapping_sstables(options, unchecked_options);
+
     auto it = options.find("enabled");
     if (it != options.end() && it->second != "true" && it->second != "false") {
         throw exceptions::configuration_exception(fmt::format("enabled value ({}) must be \"true\" or \"false\"", it->second));
@@ -177,6 +257,8 @@ void compaction_strategy_impl::validate_options(const std::map<sstring, sstring>
 compaction_strategy_impl::compaction_strategy_impl(const std::map<sstring, sstring>& options) {
     _tombstone_threshold = validate_tombstone_threshold(options);
     _tombstone_compaction_interval = validate_tombstone_compaction_interval(options);
+    _proactive_tombstone_compaction = validate_proactive_tombstone_compaction(options);
+    _prefer_overlapping_sstables = validate_prefer_overlapping_sstables(options);
 }
 
 } // namespace sstables
@@ -286,6 +368,101 @@ void size_tiered_backlog_tracker::replace_sstables(const std::vector<sstables::s
     });
 }
 
+// The backlog for ICS is the STCS backlog (see size_tiered_backlog_tracker.hh), with sstable runs in
+// place of sstables: each fragment contributes Ei * log4(T / Sr), where Sr is the size of its run, so
+// that a tier of runs has the backlog STCS would have for a tier of sstables of the same sizes.
+class incremental_backlog_tracker final : public compaction_backlog_tracker::impl {
+    sstables::size_tiered_compaction_strategy_options _stcs_options;
+    int64_t _total_bytes = 0;
+    std::unordered_set<sstables::shared_sstable> _all;
+
+    struct sstables_backlog_contribution {
+        // Sum of Si * log4(Sr) of the contributing fragments.
+        double value = 0;
+        uint64_t total_bytes = 0;
+        // Contributing fragments, with the size of their run.
+        std::unordered_map<sstables::shared_sstable, uint64_t> sstables;
+    };
+    sstables_backlog_contribution _contrib;
+
+    static double log4(double x) {
+        double inv_log_4 = 1.0f / std::log(4);
+        return log(x) * inv_log_4;
+    }
+
+    static sstables_backlog_contribution calculate_sstables_backlog_contribution(const std::vector<sstables::shared_sstable>& all,
+            const sstables::size_tiered_compaction_strategy_options& stcs_options) {
+        using namespace sstables;
+
+        sstables_backlog_contribution contrib;
+        if (all.empty()) {
+            return contrib;
+        }
+        // Deduce threshold from the last SSTable added to the set, see size_tiered_backlog_tracker.
+        const auto& newest_sst = std::ranges::max(all, std::less<generation_type>(), std::mem_fn(&sstable::generation));
+        size_t threshold = newest_sst->get_schema()->min_compaction_threshold();
+
+        for (auto& bucket : incremental_compaction_strategy::get_buckets(incremental_compaction_strategy::get_runs(all), stcs_options)) {
+            if (bucket.size() < threshold) {
+                continue;
+            }
+            for (auto& run : bucket) {
+                auto run_size = incremental_compaction_strategy::run_size(run);
+                for (auto& sst : run) {
+                    contrib.value += sst->data_size() * log4(run_size);
+                    contrib.total_bytes += sst->data_size();
+                    contrib.sstables.emplace(sst, run_size);
+                }
+            }
+        }
+        return contrib;
+    }
+public:
+    incremental_backlog_tracker(sstables::size_tiered_compaction_strategy_options stcs_options) : _stcs_options(stcs_options) {}
+
+    virtual double backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const override {
+        uint64_t compacted_bytes = 0;
+        double compacted_contribution = 0;
+        for (auto const& crp : oc) {
+            auto it = _contrib.sstables.find(crp.first);
+            if (it == _contrib.sstables.end()) {
+                continue;
+            }
+            auto compacted = crp.second->compacted();
+            compacted_bytes += compacted;
+            compacted_contribution += compacted * log4(it->second);
+        }
+        if (_contrib.total_bytes <= compacted_bytes) {
+            return 0;
+        }
+        auto b = ((_contrib.total_bytes - compacted_bytes) * log4(_total_bytes)) - (_contrib.value - compacted_contribution);
+        return b > 0 ? b : 0;
+    }
+
+    // Provides strong exception safety guarantees.
+    virtual void replace_sstables(const std::vector<sstables::shared_sstable>& old_ssts, const std::vector<sstables::shared_sstable>& new_ssts) override {
+        auto tmp_all = _all;
+        auto tmp_total_bytes = _total_bytes;
+        for (auto& sst : old_ssts) {
+            if (sst->data_size() > 0 && tmp_all.erase(sst)) {
+                tmp_total_bytes -= sst->data_size();
+            }
+        }
+        for (auto& sst : new_ssts) {
+            if (sst->data_size() > 0 && tmp_all.insert(sst).second) {
+                tmp_total_bytes += sst->data_size();
+            }
+        }
+        auto tmp_contrib = calculate_sstables_backlog_contribution(boost::copy_range<std::vector<shared_sstable>>(tmp_all), _stcs_options);
+
+        std::invoke([&] () noexcept {
+            _all = std::move(tmp_all);
+            _total_bytes = tmp_total_bytes;
+            _contrib = std::move(tmp_contrib);
+        });
+    }
+};
+
 namespace sstables {
 
 extern logging::logger clogger;
@@ -631,6 +808,35 @@ std::unique_ptr<compaction_backlog_tracker::impl> time_window_compaction_strateg
     return std::make_unique<time_window_backlog_tracker>(_options, _stcs_options);
 }
 
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _stcs_options(options)
+    , _fragment_size(calculate_fragment_size(options))
+{
+}
+
+uint64_t incremental_compaction_strategy::calculate_fragment_size(const std::map<sstring, sstring>& options) {
+    auto tmp_value = compaction_strategy_impl::get_value(options, SSTABLE_SIZE_OPTION);
+    auto size_in_mb = cql3::statements::property_definitions::to_long(SSTABLE_SIZE_OPTION, tmp_value, DEFAULT_MAX_SSTABLE_SIZE_IN_MB);
+    if (size_in_mb <= 0) {
+        throw exceptions::configuration_exception(fmt::format("{} value ({}) must be positive", SSTABLE_SIZE_OPTION, size_in_mb));
+    }
+    return uint64_t(size_in_mb) * 1024 * 1024;
+}
+
+// options is a map of compaction strategy options and their values.
+// unchecked_options is an analogical map from which already checked options are deleted.
+// This helps making sure that only allowed options are being set.
+void incremental_compaction_strategy::validate_options(const std::map<sstring, sstring>& options, std::map<sstring, sstring>& unchecked_options) {
+    size_tiered_compaction_strategy_options::validate(options, unchecked_options);
+    calculate_fragment_size(options);
+    unchecked_options.erase(SSTABLE_SIZE_OPTION);
+}
+
+std::unique_ptr<compaction_backlog_tracker::impl> incremental_compaction_strategy::make_backlog_tracker() const {
+    return std::make_unique<incremental_backlog_tracker>(_stcs_options);
+}
+
 } // namespace sstables
 
 namespace sstables {
@@ -667,8 +873,58 @@ compaction_strategy_type compaction_strategy::type() const {
     return _compaction_strategy_impl->type();
 }
 
+namespace {
+
+// Presents the strategy either only the repaired or only the unrepaired
+// candidates, so that the two are never compacted together and the repaired
+// data stays repaired.
+class repaired_state_strategy_control : public strategy_control {
+    strategy_control& _control;
+    const bool _repaired;
+
+    static bool is_repaired(const sstable_run& run) {
+        return std::ranges::all_of(run.all(), std::mem_fn(&sstable::is_repaired));
+    }
+public:
+    repaired_state_strategy_control(strategy_control& control, bool repaired) noexcept
+        : _control(control)
+        , _repaired(repaired)
+    {}
+
+    virtual bool has_ongoing_compaction(table_state& table_s) const noexcept override {
+        return _control.has_ongoing_compaction(table_s);
+    }
+
+    virtual std::vector<sstables::shared_sstable> candidates(table_state& table_s) const override {
+        auto candidates = _control.candidates(table_s);
+        std::erase_if(candidates, [this] (const shared_sstable& sst) { return sst->is_repaired() != _repaired; });
+        return candidates;
+    }
+
+    virtual std::vector<sstables::frozen_sstable_run> candidates_as_runs(table_state& table_s) const override {
+        auto runs = _control.candidates_as_runs(table_s);
+        std::erase_if(runs, [this] (const frozen_sstable_run& run) { return is_repaired(*run) != _repaired; });
+        return runs;
+    }
+};
+
+}
+
 compaction_descriptor compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control) {
-    return _compaction_strategy_impl->get_sstables_for_compaction(table_s, control);
+    auto candidates = control.candidates(table_s);
+    auto repaired = std::ranges::count_if(candidates, std::mem_fn(&sstable::is_repaired));
+    if (repaired == 0 || size_t(repaired) == candidates.size()) {
+        return _compaction_strategy_impl->get_sstables_for_compaction(table_s, control);
+    }
+    // The unrepaired data is the one which keeps growing, so it goes first.
+    for (bool repaired_data : {false, true}) {
+        repaired_state_strategy_control filtered_control(control, repaired_data);
+        auto desc = _compaction_strategy_impl->get_sstables_for_compaction(table_s, filtered_control);
+        if (!desc.sstables.empty()) {
+            return desc;
+        }
+    }
+    return compaction_descriptor();
 }
 
 compaction_descriptor compaction_strategy::get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) {
@@ -732,6 +988,9 @@ compaction_strategy make_compaction_strategy(compaction_strategy_type strategy,
     case compaction_strategy_type::time_window:
         impl = ::make_shared<time_window_compaction_strategy>(options);
         break;
+    case compaction_strategy_type::incremental:
+        impl = ::make_shared<incremental_compaction_strategy>(options);
+        break;
     default:
         throw std::runtime_error("strategy not supported");
     }
@@ -747,6 +1006,7 @@ compaction_strategy_state compaction_strategy_state::make(const compaction_strat
     switch (cs.type()) {
         case compaction_strategy_type::null:
         case compaction_strategy_type::size_tiered:
+        case compaction_strategy_type::incremental:
             return compaction_strategy_state(default_empty_state{});
         case compaction_strategy_type::leveled:
             return compaction_strategy_state(leveled_compaction_strategy_state{});
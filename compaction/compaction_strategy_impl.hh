@@ -27,11 +27,18 @@ class compaction_strategy_impl {
     static constexpr std::chrono::seconds DEFAULT_TOMBSTONE_COMPACTION_INTERVAL() { return std::chrono::seconds(86400); }
     static constexpr auto TOMBSTONE_THRESHOLD_OPTION = "tombstone_threshold";
     static constexpr auto TOMBSTONE_COMPACTION_INTERVAL_OPTION = "tombstone_compaction_interval";
+    static constexpr auto PROACTIVE_TOMBSTONE_COMPACTION_OPTION = "proactive_tombstone_compaction";
+    static constexpr auto PREFER_OVERLAPPING_SSTABLES_OPTION = "prefer_overlapping_sstables";
 protected:
     bool _use_clustering_key_filter = false;
     bool _disable_tombstone_compaction = false;
     float _tombstone_threshold = DEFAULT_TOMBSTONE_THRESHOLD;
     db_clock::duration _tombstone_compaction_interval = DEFAULT_TOMBSTONE_COMPACTION_INTERVAL();
+    // Whether tombstone compaction takes precedence over the regular work of the strategy.
+    bool _proactive_tombstone_compaction = false;
+    // Whether size-tiered strategies pick the bucket with the most partitions in common
+    // between its sstables, rather than the one with the most sstables.
+    bool _prefer_overlapping_sstables = false;
 public:
     static std::optional<sstring> get_value(const std::map<sstring, sstring>& options, const sstring& name);
     static void validate_min_max_threshold(const std::map<sstring, sstring>& options, std::map<sstring, sstring>& unchecked_options);
@@ -43,6 +50,27 @@ class compaction_strategy_impl {
     static compaction_descriptor make_major_compaction_job(std::vector<sstables::shared_sstable> candidates,
             int level = compaction_descriptor::default_level,
             uint64_t max_sstable_bytes = compaction_descriptor::default_max_sstable_bytes);
+
+    // Returns the bucket whose sstables share the most partitions, as estimated by
+    // estimate_duplicate_partitions(), or buckets.end() if the estimate isn't available
+    // for every bucket or no bucket has any overlap, in which case the caller should
+    // fall back to its regular choice.
+    template <typename Bucket, typename ToSSTables>
+    static typename std::vector<Bucket>::iterator pick_most_overlapping_bucket(std::vector<Bucket>& buckets, ToSSTables to_sstables) {
+        auto best = buckets.end();
+        double best_duplicates = 0;
+        for (auto it = buckets.begin(); it != buckets.end(); ++it) {
+            auto duplicates = estimate_duplicate_partitions(to_sstables(*it));
+            if (!duplicates) {
+                return buckets.end();
+            }
+            if (*duplicates > best_duplicates) {
+                best = it;
+                best_duplicates = *duplicates;
+            }
+        }
+        return best;
+    }
 public:
     virtual ~compaction_strategy_impl() {}
     virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control) = 0;
@@ -66,6 +94,16 @@ class compaction_strategy_impl {
     // droppable tombstone histogram and gc_before.
     bool worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point compaction_time, const tombstone_gc_state& gc_state);
 
+    // Returns the candidate worth dropping tombstones whose rewrite is estimated to
+    // free the most space, or nullptr if there is none.
+    shared_sstable get_most_droppable_sstable(table_state& table_s, const std::vector<shared_sstable>& candidates, gc_clock::time_point compaction_time);
+
+    // Estimates how many partitions compacting the sstables together would merge away,
+    // i.e. the sum of their partition counts minus the count of the union, from the
+    // partition key sketches in their compaction metadata. Disengaged if some sstable
+    // has no sketch, or the sketches have different precisions.
+    static std::optional<double> estimate_duplicate_partitions(const std::vector<shared_sstable>& sstables);
+
     virtual std::unique_ptr<compaction_backlog_tracker::impl> make_backlog_tracker() const = 0;
 
     virtual uint64_t adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) const;
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "sstables/sstables.hh"
+#include "incremental_compaction_strategy.hh"
+
+#include <boost/range/adaptor/map.hpp>
+#include <boost/range/adaptor/reversed.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/numeric.hpp>
+
+namespace sstables {
+
+std::vector<incremental_compaction_strategy::run>
+incremental_compaction_strategy::get_runs(const std::vector<shared_sstable>& sstables) {
+    std::unordered_map<run_id, run> runs;
+    for (auto& sst : sstables) {
+        runs[sst->run_identifier()].push_back(sst);
+    }
+    return boost::copy_range<std::vector<run>>(runs | boost::adaptors::map_values);
+}
+
+uint64_t incremental_compaction_strategy::run_size(const run& r) {
+    return boost::accumulate(r | boost::adaptors::transformed(std::mem_fn(&sstable::data_size)), uint64_t(0));
+}
+
+std::vector<std::vector<incremental_compaction_strategy::run>>
+incremental_compaction_strategy::get_buckets(std::vector<run> runs, const size_tiered_compaction_strategy_options& options) {
+    auto sorted_runs = boost::copy_range<std::vector<std::pair<run, uint64_t>>>(runs | boost::adaptors::transformed([] (run& r) {
+        auto size = run_size(r);
+        return std::pair(std::move(r), size);
+    }));
+    std::sort(sorted_runs.begin(), sorted_runs.end(), [] (auto& i, auto& j) {
+        return i.second < j.second;
+    });
+
+    using bucket_type = std::vector<run>;
+    std::vector<bucket_type> bucket_list;
+    std::vector<double> bucket_average_size_list;
+    std::vector<uint64_t> bucket_smallest_size_list;
+
+    for (auto& [r, size] : sorted_runs) {
+        // See size_tiered_compaction_strategy::get_buckets() for the rules.
+        if (!bucket_list.empty()) {
+            auto& bucket_average_size = bucket_average_size_list.back();
+
+            if ((size > (bucket_average_size * options.bucket_low) && size < (bucket_average_size * options.bucket_high)) ||
+                    (size < options.min_sstable_size && bucket_average_size < options.min_sstable_size)) {
+                auto& bucket = bucket_list.back();
+                auto total_size = bucket.size() * bucket_average_size;
+                auto new_average_size = (total_size + size) / (bucket.size() + 1);
+
+                if (size < options.min_sstable_size || bucket_smallest_size_list.back() > new_average_size * options.bucket_low) {
+                    bucket.push_back(std::move(r));
+                    bucket_average_size = new_average_size;
+                    continue;
+                }
+            }
+        }
+
+        bucket_type new_bucket;
+        new_bucket.push_back(std::move(r));
+        bucket_list.push_back(std::move(new_bucket));
+        bucket_average_size_list.push_back(size);
+        bucket_smallest_size_list.push_back(size);
+    }
+
+    return bucket_list;
+}
+
+std::vector<incremental_compaction_strategy::run>
+incremental_compaction_strategy::most_interesting_bucket(std::vector<std::vector<run>> buckets, size_t min_threshold, size_t max_threshold) {
+    std::vector<std::vector<run>> pruned_buckets;
+    for (auto& bucket : buckets) {
+        if (bucket.size() < min_threshold) {
+            continue;
+        }
+        bucket.resize(std::min(bucket.size(), max_threshold));
+        pruned_buckets.push_back(std::move(bucket));
+    }
+
+    if (_prefer_overlapping_sstables && pruned_buckets.size() > 1) {
+        if (auto i = pick_most_overlapping_bucket(pruned_buckets, [] (const std::vector<run>& b) { return flatten(b); }); i != pruned_buckets.end()) {
+            return std::move(*i);
+        }
+    }
+
+    std::vector<run>* max = nullptr;
+    for (auto& bucket : pruned_buckets) {
+        // Pick the bucket with more runs, as efficiency of same-tier compactions increases with the fan-in.
+        if (!max || max->size() < bucket.size()) {
+            max = &bucket;
+        }
+    }
+    return max ? std::move(*max) : std::vector<run>();
+}
+
+std::vector<shared_sstable> incremental_compaction_strategy::flatten(std::vector<run> runs) {
+    std::vector<shared_sstable> sstables;
+    for (auto& r : runs) {
+        std::move(r.begin(), r.end(), std::back_inserter(sstables));
+    }
+    return sstables;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control) {
+    size_t min_threshold = table_s.min_compaction_threshold();
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+    auto compaction_time = gc_clock::now();
+    auto candidates = control.candidates(table_s);
+
+    // The fragment is rewritten into the same run, see below.
+    if (_proactive_tombstone_compaction && table_s.tombstone_gc_enabled()) {
+        if (auto sst = get_most_droppable_sstable(table_s, candidates, compaction_time)) {
+            return compaction_descriptor({ sst }, sst->get_sstable_level(), _fragment_size, sst->run_identifier());
+        }
+    }
+
+    auto buckets = get_buckets(get_runs(candidates), _stcs_options);
+
+    auto most_interesting = most_interesting_bucket(buckets, min_threshold, max_threshold);
+    // If we are not enforcing min_threshold explicitly, try any pair of runs in the same tier.
+    if (most_interesting.empty() && !table_s.compaction_enforce_min_threshold()) {
+        most_interesting = most_interesting_bucket(buckets, 2, max_threshold);
+    }
+    if (!most_interesting.empty()) {
+        return compaction_descriptor(flatten(std::move(most_interesting)), compaction_descriptor::default_level, _fragment_size);
+    }
+
+    if (!table_s.tombstone_gc_enabled()) {
+        return compaction_descriptor();
+    }
+
+    // Like STCS, fall back to rewriting a single sstable whose droppable tombstone ratio is greater
+    // than the threshold, preferring the oldest fragments from the biggest tiers.
+    // The fragment is rewritten into the same run, which stays disjoint as the output doesn't extend
+    // the token range of the input.
+    for (auto& bucket : buckets | boost::adaptors::reversed) {
+        auto sstables = flatten(std::move(bucket));
+        std::erase_if(sstables, [this, compaction_time, &table_s] (const shared_sstable& sst) {
+            return !worth_dropping_tombstones(sst, compaction_time, table_s.get_tombstone_gc_state());
+        });
+        if (sstables.empty()) {
+            continue;
+        }
+        auto it = std::min_element(sstables.begin(), sstables.end(), [] (auto& i, auto& j) {
+            return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
+        });
+        return compaction_descriptor({ *it }, (*it)->get_sstable_level(), _fragment_size, (*it)->run_identifier());
+    }
+    return compaction_descriptor();
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_major_compaction_job(table_state& table_s, std::vector<shared_sstable> candidates) {
+    return make_major_compaction_job(std::move(candidates), compaction_descriptor::default_level, _fragment_size);
+}
+
+std::vector<compaction_descriptor>
+incremental_compaction_strategy::get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const {
+    // Clean up one run at a time, into the same run, so that its fragments are released incrementally
+    // and the run structure, and thus the tiers, are preserved.
+    return boost::copy_range<std::vector<compaction_descriptor>>(get_runs(candidates) | boost::adaptors::transformed([this] (run& r) {
+        auto run_identifier = r.front()->run_identifier();
+        return compaction_descriptor(std::move(r), compaction_descriptor::default_level, _fragment_size, run_identifier);
+    }));
+}
+
+int64_t incremental_compaction_strategy::estimated_pending_compactions(table_state& table_s) const {
+    size_t min_threshold = table_s.min_compaction_threshold();
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+    auto all_sstables = table_s.main_sstable_set().all();
+    auto sstables = std::vector<shared_sstable>(all_sstables->begin(), all_sstables->end());
+
+    int64_t n = 0;
+    for (auto& bucket : get_buckets(get_runs(sstables), _stcs_options)) {
+        if (bucket.size() >= min_threshold) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    return n;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, reshape_mode mode) const {
+    size_t offstrategy_threshold = std::max(schema->min_compaction_threshold(), 4);
+    size_t max_runs = std::max(schema->max_compaction_threshold(), int(offstrategy_threshold));
+
+    if (mode == reshape_mode::relaxed) {
+        offstrategy_threshold = max_runs;
+    }
+
+    for (auto& bucket : get_buckets(get_runs(input), _stcs_options)) {
+        if (bucket.size() >= offstrategy_threshold) {
+            // Reshape the runs with the smallest tokens first, to preserve token contiguity if they're disjoint.
+            if (bucket.size() > max_runs) {
+                std::partial_sort(bucket.begin(), bucket.begin() + max_runs, bucket.end(), [&schema] (const run& a, const run& b) {
+                    auto first_key = [] (const run& r) -> const dht::decorated_key& {
+                        return (*std::ranges::min_element(r, [s = r.front()->get_schema()] (const shared_sstable& x, const shared_sstable& y) {
+                            return x->get_first_decorated_key().tri_compare(*s, y->get_first_decorated_key()) < 0;
+                        }))->get_first_decorated_key();
+                    };
+                    return first_key(a).tri_compare(*schema, first_key(b)) < 0;
+                });
+                bucket.resize(max_runs);
+            }
+            compaction_descriptor desc(flatten(std::move(bucket)), compaction_descriptor::default_level, _fragment_size);
+            desc.options = compaction_type_options::make_reshape();
+            return desc;
+        }
+    }
+
+    return compaction_descriptor();
+}
+
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "compaction_strategy_impl.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "sstables/shared_sstable.hh"
+
+class incremental_backlog_tracker;
+
+namespace sstables {
+
+// Size-tiered compaction over sstable runs.
+//
+// Compaction output is split into a run of non-overlapping fragments of at most
+// sstable_size_in_mb each. When the inputs are themselves multi-fragment runs,
+// compaction releases every input fragment as soon as the output is past its
+// last key, so a job needs temporary space for a few fragments rather than
+// for the whole of its input.
+// Runs are tiered by their total size, using the same options as STCS, so the
+// write amplification is that of STCS.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+public:
+    static constexpr uint64_t DEFAULT_MAX_SSTABLE_SIZE_IN_MB = 1000;
+    static constexpr auto SSTABLE_SIZE_OPTION = "sstable_size_in_mb";
+
+    // All fragments of one sstable run.
+    using run = std::vector<shared_sstable>;
+private:
+    size_tiered_compaction_strategy_options _stcs_options;
+    uint64_t _fragment_size;
+
+    static uint64_t calculate_fragment_size(const std::map<sstring, sstring>& options);
+
+    // Group the sstables into runs, by run identifier.
+    static std::vector<run> get_runs(const std::vector<shared_sstable>& sstables);
+
+    static uint64_t run_size(const run& r);
+
+    // Group runs of similar size into buckets, like size_tiered_compaction_strategy::get_buckets() does for
+    // sstables.
+    static std::vector<std::vector<run>> get_buckets(std::vector<run> runs, const size_tiered_compaction_strategy_options& options);
+
+    // Returns the bucket with the most runs among those with at least min_threshold runs, trimmed to max_threshold runs.
+    // Returns an empty bucket if there are none.
+    std::vector<run> most_interesting_bucket(std::vector<std::vector<run>> buckets, size_t min_threshold, size_t max_threshold);
+
+    static std::vector<shared_sstable> flatten(std::vector<run> runs);
+public:
+    incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+    static void validate_options(const std::map<sstring, sstring>& options, std::map<sstring, sstring>& unchecked_options);
+
+    virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control) override;
+
+    virtual compaction_descriptor get_major_compaction_job(table_state& table_s, std::vector<shared_sstable> candidates) override;
+
+    virtual std::vector<compaction_descriptor> get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const override;
+
+    virtual int64_t estimated_pending_compactions(table_state& table_s) const override;
+
+    virtual compaction_strategy_type type() const override {
+        return compaction_strategy_type::incremental;
+    }
+
+    virtual std::unique_ptr<sstable_set_impl> make_sstable_set(schema_ptr schema) const override;
+
+    virtual std::unique_ptr<compaction_backlog_tracker::impl> make_backlog_tracker() const override;
+
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, reshape_mode mode) const override;
+
+    uint64_t fragment_size() const noexcept {
+        return _fragment_size;
+    }
+
+    friend class ::incremental_backlog_tracker;
+};
+
+}
@@ -22,6 +22,13 @@ leveled_compaction_strategy_state& leveled_compaction_strategy::get_state(table_
 compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control) {
     auto& state = get_state(table_s);
     auto candidates = control.candidates(table_s);
+    // The sstable is rewritten into the same level, which stays disjoint as the output doesn't
+    // extend the token range of the input.
+    if (_proactive_tombstone_compaction && table_s.tombstone_gc_enabled()) {
+        if (auto sst = get_most_droppable_sstable(table_s, candidates, gc_clock::now())) {
+            return sstables::compaction_descriptor({ sst }, sst->get_sstable_level());
+        }
+    }
     // NOTE: leveled_manifest creation may be slightly expensive, so later on,
     // we may want to store it in the strategy itself. However, the sstable
     // lists managed by the manifest may become outdated. For example, one
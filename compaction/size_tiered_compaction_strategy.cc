@@ -201,6 +201,12 @@ size_tiered_compaction_strategy::most_interesting_bucket(std::vector<std::vector
         return std::vector<sstables::shared_sstable>();
     }
 
+    if (_prefer_overlapping_sstables && pruned_buckets.size() > 1) {
+        if (auto i = pick_most_overlapping_bucket(pruned_buckets, [] (const bucket_t& b) -> const bucket_t& { return b; }); i != pruned_buckets.end()) {
+            return std::move(*i);
+        }
+    }
+
     // Pick the bucket with more elements, as efficiency of same-tier compactions increases with number of files.
     auto& max = *std::max_element(pruned_buckets.begin(), pruned_buckets.end(), [] (const bucket_t& i, const bucket_t& j) {
         // FIXME: ignoring hotness by the time being.
@@ -219,6 +225,12 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(table_state& table_
 
     // TODO: Add support to filter cold sstables (for reference: SizeTieredCompactionStrategy::filterColdSSTables).
 
+    if (_proactive_tombstone_compaction && table_s.tombstone_gc_enabled()) {
+        if (auto sst = get_most_droppable_sstable(table_s, candidates, compaction_time)) {
+            return sstables::compaction_descriptor({ sst });
+        }
+    }
+
     auto buckets = get_buckets(candidates);
 
     if (is_any_bucket_interesting(buckets, min_threshold)) {
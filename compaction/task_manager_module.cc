@@ -10,9 +10,11 @@
 
 #include "compaction/task_manager_module.hh"
 #include "compaction/compaction_manager.hh"
+#include "db/config.hh"
 #include "replica/database.hh"
 #include "sstables/sstables.hh"
 #include "sstables/sstable_directory.hh"
+#include "utils/error_injection.hh"
 #include "utils/pretty_printers.hh"
 
 namespace replica {
@@ -208,19 +210,29 @@ future<> run_on_existing_tables(sstring op, replica::database& db, std::string k
     }
 }
 
-future<> wait_for_your_turn(seastar::condition_variable& cv, tasks::task_manager::task_ptr& current_task, tasks::task_id id) {
+future<> wait_for_your_turn(seastar::condition_variable& cv, const std::unordered_set<tasks::task_id>& current_tasks, tasks::task_id id) {
     co_await cv.wait([&] {
-        return current_task && current_task->id() == id;
+        return current_tasks.contains(id);
     });
 }
 
-future<> run_table_tasks(replica::database& db, std::vector<table_tasks_info> table_tasks, seastar::condition_variable& cv, tasks::task_manager::task_ptr& current_task, bool sort) {
+// Lets the table tasks run, up to compaction_tables_concurrency of them at a time,
+// so that small tables don't wait for the large ones to finish.
+// Once the parent task is aborted, the remaining tables are not started.
+future<> run_table_tasks(replica::database& db, std::vector<table_tasks_info> table_tasks, seastar::condition_variable& cv, std::unordered_set<tasks::task_id>& current_tasks, bool sort, seastar::abort_source& as) {
     std::exception_ptr ex;
+    seastar::gate running_tasks;
+    seastar::semaphore concurrency(std::max<uint32_t>(db.get_config().compaction_tables_concurrency(), 1));
 
-    // While compaction is run on one table, the size of tables may significantly change.
-    // Thus, they are sorted before each invidual compaction and the smallest table is chosen.
-    while (!table_tasks.empty()) {
+    // While compaction is run on some tables, the size of tables may significantly change.
+    // Thus, they are sorted before each invidual compaction is started and the smallest table is chosen.
+    while (!table_tasks.empty() && !ex) {
         try {
+            as.check();
+            auto units = co_await get_units(concurrency, 1, as);
+            if (ex) {
+                break;
+            }
             if (sort) {
                 // Major compact smaller tables first, to increase chances of success if low on space.
                 // Tables will be kept in descending order.
@@ -233,23 +245,33 @@ future<> run_table_tasks(replica::database& db, std::vector<table_tasks_info> ta
                 });
             }
             // Task responsible for the smallest table.
-            current_task = table_tasks.back().task;
+            auto task = table_tasks.back().task;
             table_tasks.pop_back();
+            current_tasks.insert(task->id());
             cv.broadcast();
-            co_await current_task->done();
+            // Runs in the background, waited for by closing running_tasks below.
+            (void)task->done().then_wrapped([&ex, &current_tasks, task, units = std::move(units), holder = running_tasks.hold()] (future<> f) {
+                current_tasks.erase(task->id());
+                if (f.failed() && !ex) {
+                    ex = f.get_exception();
+                } else {
+                    f.ignore_ready_future();
+                }
+            });
         } catch (...) {
             ex = std::current_exception();
-            current_task = nullptr;
-            cv.broken(ex);
-            break;
         }
     }
 
     if (ex) {
+        cv.broken(ex);
         // Wait for all tasks even on failure.
         for (auto& tti: table_tasks) {
-            co_await tti.task->done();
+            co_await tti.task->done().handle_exception([] (std::exception_ptr) {});
         }
+    }
+    co_await running_tasks.close();
+    if (ex) {
         co_await coroutine::return_exception_ptr(std::move(ex));
     }
 }
@@ -276,18 +298,22 @@ future<> major_keyspace_compaction_task_impl::run() {
 
 future<> shard_major_keyspace_compaction_task_impl::run() {
     seastar::condition_variable cv;
-    tasks::task_manager::task_ptr current_task;
+    std::unordered_set<tasks::task_id> current_tasks;
     tasks::task_info parent_info{_status.id, _status.shard};
     std::vector<table_tasks_info> table_tasks;
     for (auto& ti : _local_tables) {
-        table_tasks.emplace_back(co_await _module->make_and_start_task<table_major_keyspace_compaction_task_impl>(parent_info, _status.keyspace, ti.name, _status.id, _db, ti, cv, current_task), ti);
+        table_tasks.emplace_back(co_await _module->make_and_start_task<table_major_keyspace_compaction_task_impl>(parent_info, _status.keyspace, ti.name, _status.id, _db, ti, cv, current_tasks), ti);
     }
 
-    co_await run_table_tasks(_db, std::move(table_tasks), cv, current_task, true);
+    co_await run_table_tasks(_db, std::move(table_tasks), cv, current_tasks, true, _as);
 }
 
 future<> table_major_keyspace_compaction_task_impl::run() {
-    co_await wait_for_your_turn(_cv, _current_task, _status.id);
+    co_await wait_for_your_turn(_cv, _current_tasks, _status.id);
+    co_await utils::get_local_injector().inject_with_handler("major_keyspace_compaction_table_task_wait", [] (auto& handler) {
+        return handler.wait_for_message(std::chrono::steady_clock::now() + std::chrono::minutes{5});
+    });
+    utils::get_local_injector().inject("major_keyspace_compaction_table_task_fail", [] { throw std::runtime_error("injected table task failure"); });
     tasks::task_info info{_status.id, _status.shard};
     co_await run_on_table("force_keyspace_compaction", _db, _status.keyspace, _ti, [info] (replica::table& t) {
         return t.compact_all_sstables(info);
@@ -304,18 +330,18 @@ future<> cleanup_keyspace_compaction_task_impl::run() {
 
 future<> shard_cleanup_keyspace_compaction_task_impl::run() {
     seastar::condition_variable cv;
-    tasks::task_manager::task_ptr current_task;
+    std::unordered_set<tasks::task_id> current_tasks;
     tasks::task_info parent_info{_status.id, _status.shard};
     std::vector<table_tasks_info> table_tasks;
     for (auto& ti : _local_tables) {
-        table_tasks.emplace_back(co_await _module->make_and_start_task<table_cleanup_keyspace_compaction_task_impl>(parent_info, _status.keyspace, ti.name, _status.id, _db, ti, cv, current_task), ti);
+        table_tasks.emplace_back(co_await _module->make_and_start_task<table_cleanup_keyspace_compaction_task_impl>(parent_info, _status.keyspace, ti.name, _status.id, _db, ti, cv, current_tasks), ti);
     }
 
-    co_await run_table_tasks(_db, std::move(table_tasks), cv, current_task, true);
+    co_await run_table_tasks(_db, std::move(table_tasks), cv, current_tasks, true, _as);
 }
 
 future<> table_cleanup_keyspace_compaction_task_impl::run() {
-    co_await wait_for_your_turn(_cv, _current_task, _status.id);
+    co_await wait_for_your_turn(_cv, _current_tasks, _status.id);
     auto owned_ranges_ptr = compaction::make_owned_ranges_ptr(_db.get_keyspace_local_ranges(_status.keyspace));
     co_await run_on_table("force_keyspace_cleanup", _db, _status.keyspace, _ti, [&] (replica::table& t) {
         return t.perform_cleanup_compaction(owned_ranges_ptr, tasks::task_info{_status.id, _status.shard});
@@ -335,18 +361,18 @@ future<> offstrategy_keyspace_compaction_task_impl::run() {
 
 future<> shard_offstrategy_keyspace_compaction_task_impl::run() {
     seastar::condition_variable cv;
-    tasks::task_manager::task_ptr current_task;
+    std::unordered_set<tasks::task_id> current_tasks;
     tasks::task_info parent_info{_status.id, _status.shard};
     std::vector<table_tasks_info> table_tasks;
     for (auto& ti : _table_infos) {
-        table_tasks.emplace_back(co_await _module->make_and_start_task<table_offstrategy_keyspace_compaction_task_impl>(parent_info, _status.keyspace, ti.name, _status.id, _db, ti, cv, current_task, _needed), ti);
+        table_tasks.emplace_back(co_await _module->make_and_start_task<table_offstrategy_keyspace_compaction_task_impl>(parent_info, _status.keyspace, ti.name, _status.id, _db, ti, cv, current_tasks, _needed), ti);
     }
 
-    co_await run_table_tasks(_db, std::move(table_tasks), cv, current_task, false);
+    co_await run_table_tasks(_db, std::move(table_tasks), cv, current_tasks, false, _as);
 }
 
 future<> table_offstrategy_keyspace_compaction_task_impl::run() {
-    co_await wait_for_your_turn(_cv, _current_task, _status.id);
+    co_await wait_for_your_turn(_cv, _current_tasks, _status.id);
     tasks::task_info info{_status.id, _status.shard};
     co_await run_on_table("perform_keyspace_offstrategy_compaction", _db, _status.keyspace, _ti, [this, info] (replica::table& t) -> future<> {
         _needed |= co_await t.perform_offstrategy_compaction(info);
@@ -364,18 +390,18 @@ future<> upgrade_sstables_compaction_task_impl::run() {
 
 future<> shard_upgrade_sstables_compaction_task_impl::run() {
     seastar::condition_variable cv;
-    tasks::task_manager::task_ptr current_task;
+    std::unordered_set<tasks::task_id> current_tasks;
     tasks::task_info parent_info{_status.id, _status.shard};
     std::vector<table_tasks_info> table_tasks;
     for (auto& ti : _table_infos) {
-        table_tasks.emplace_back(co_await _module->make_and_start_task<table_upgrade_sstables_compaction_task_impl>(parent_info, _status.keyspace, ti.name, _status.id, _db, ti, cv, current_task, _exclude_current_version), ti);
+        table_tasks.emplace_back(co_await _module->make_and_start_task<table_upgrade_sstables_compaction_task_impl>(parent_info, _status.keyspace, ti.name, _status.id, _db, ti, cv, current_tasks, _exclude_current_version), ti);
     }
 
-    co_await run_table_tasks(_db, std::move(table_tasks), cv, current_task, false);
+    co_await run_table_tasks(_db, std::move(table_tasks), cv, current_tasks, false, _as);
 }
 
 future<> table_upgrade_sstables_compaction_task_impl::run() {
-    co_await wait_for_your_turn(_cv, _current_task, _status.id);
+    co_await wait_for_your_turn(_cv, _current_tasks, _status.id);
     auto owned_ranges_ptr = compaction::make_owned_ranges_ptr(_db.get_keyspace_local_ranges(_status.keyspace));
     tasks::task_info info{_status.id, _status.shard};
     co_await run_on_table("upgrade_sstables", _db, _status.keyspace, _ti, [&] (replica::table& t) -> future<> {
@@ -385,6 +411,38 @@ future<> table_upgrade_sstables_compaction_task_impl::run() {
     });
 }
 
+future<> recompress_sstables_compaction_task_impl::run() {
+    co_await _db.invoke_on_all([&] (replica::database& db) -> future<> {
+        tasks::task_info parent_info{_status.id, _status.shard};
+        auto& compaction_module = db.get_compaction_manager().get_task_manager_module();
+        auto task = co_await compaction_module.make_and_start_task<shard_recompress_sstables_compaction_task_impl>(parent_info, _status.keyspace, _status.id, db, _table_infos, _io_budget_mb_per_sec);
+        co_await task->done();
+    });
+}
+
+future<> shard_recompress_sstables_compaction_task_impl::run() {
+    seastar::condition_variable cv;
+    std::unordered_set<tasks::task_id> current_tasks;
+    tasks::task_info parent_info{_status.id, _status.shard};
+    std::vector<table_tasks_info> table_tasks;
+    for (auto& ti : _table_infos) {
+        table_tasks.emplace_back(co_await _module->make_and_start_task<table_recompress_sstables_compaction_task_impl>(parent_info, _status.keyspace, ti.name, _status.id, _db, ti, cv, current_tasks, _io_budget_mb_per_sec), ti);
+    }
+
+    co_await run_table_tasks(_db, std::move(table_tasks), cv, current_tasks, false, _as);
+}
+
+future<> table_recompress_sstables_compaction_task_impl::run() {
+    co_await wait_for_your_turn(_cv, _current_tasks, _status.id);
+    auto owned_ranges_ptr = compaction::make_owned_ranges_ptr(_db.get_keyspace_local_ranges(_status.keyspace));
+    tasks::task_info info{_status.id, _status.shard};
+    co_await run_on_table("recompress_sstables", _db, _status.keyspace, _ti, [&] (replica::table& t) -> future<> {
+        return t.parallel_foreach_table_state([&] (compaction::table_state& ts) -> future<> {
+            return t.get_compaction_manager().perform_sstable_recompression(owned_ranges_ptr, ts, _io_budget_mb_per_sec, info).discard_result();
+        });
+    });
+}
+
 future<> scrub_sstables_compaction_task_impl::run() {
     _stats = co_await _db.map_reduce0([&] (replica::database& db) -> future<sstables::compaction_stats> {
         sstables::compaction_stats stats;
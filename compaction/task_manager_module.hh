@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <unordered_set>
+
 #include "compaction/compaction.hh"
 #include "replica/database_fwd.hh"
 #include "schema/schema_fwd.hh"
@@ -80,6 +82,11 @@ class major_keyspace_compaction_task_impl : public major_compaction_task_impl {
         , _db(db)
         , _table_infos(std::move(table_infos))
     {}
+
+    // Aborting leaves the tables which were not started yet untouched.
+    virtual tasks::is_abortable is_abortable() const noexcept override {
+        return tasks::is_abortable::yes;
+    }
 protected:
     virtual future<> run() override;
 };
@@ -107,7 +114,7 @@ class table_major_keyspace_compaction_task_impl : public major_compaction_task_i
     replica::database& _db;
     table_info _ti;
     seastar::condition_variable& _cv;
-    tasks::task_manager::task_ptr& _current_task;
+    std::unordered_set<tasks::task_id>& _current_tasks;
 public:
     table_major_keyspace_compaction_task_impl(tasks::task_manager::module_ptr module,
             std::string keyspace,
@@ -116,12 +123,12 @@ class table_major_keyspace_compaction_task_impl : public major_compaction_task_i
             replica::database& db,
             table_info ti,
             seastar::condition_variable& cv,
-            tasks::task_manager::task_ptr& current_task) noexcept
+            std::unordered_set<tasks::task_id>& current_tasks) noexcept
         : major_compaction_task_impl(module, tasks::task_id::create_random_id(), 0, "table", std::move(keyspace), std::move(table), "", parent_id)
         , _db(db)
         , _ti(std::move(ti))
         , _cv(cv)
-        , _current_task(current_task)
+        , _current_tasks(current_tasks)
     {}
 protected:
     virtual future<> run() override;
@@ -163,6 +170,10 @@ class cleanup_keyspace_compaction_task_impl : public cleanup_compaction_task_imp
         , _db(db)
         , _table_infos(std::move(table_infos))
     {}
+
+    virtual tasks::is_abortable is_abortable() const noexcept override {
+        return tasks::is_abortable::yes;
+    }
 protected:
     virtual future<> run() override;
 };
@@ -190,7 +201,7 @@ class table_cleanup_keyspace_compaction_task_impl : public cleanup_compaction_ta
     replica::database& _db;
     table_info _ti;
     seastar::condition_variable& _cv;
-    tasks::task_manager::task_ptr& _current_task;
+    std::unordered_set<tasks::task_id>& _current_tasks;
 public:
     table_cleanup_keyspace_compaction_task_impl(tasks::task_manager::module_ptr module,
             std::string keyspace,
@@ -199,12 +210,12 @@ class table_cleanup_keyspace_compaction_task_impl : public cleanup_compaction_ta
             replica::database& db,
             table_info ti,
             seastar::condition_variable& cv,
-            tasks::task_manager::task_ptr& current_task) noexcept
+            std::unordered_set<tasks::task_id>& current_tasks) noexcept
         : cleanup_compaction_task_impl(module, tasks::task_id::create_random_id(), 0, "table", std::move(keyspace), std::move(table), "", parent_id)
         , _db(db)
         , _ti(std::move(ti))
         , _cv(cv)
-        , _current_task(current_task)
+        , _current_tasks(current_tasks)
     {}
 protected:
     virtual future<> run() override;
@@ -248,6 +259,10 @@ class offstrategy_keyspace_compaction_task_impl : public offstrategy_compaction_
         , _table_infos(std::move(table_infos))
         , _needed(needed)
     {}
+
+    virtual tasks::is_abortable is_abortable() const noexcept override {
+        return tasks::is_abortable::yes;
+    }
 protected:
     virtual future<> run() override;
 };
@@ -278,7 +293,7 @@ class table_offstrategy_keyspace_compaction_task_impl : public offstrategy_compa
     replica::database& _db;
     table_info _ti;
     seastar::condition_variable& _cv;
-    tasks::task_manager::task_ptr& _current_task;
+    std::unordered_set<tasks::task_id>& _current_tasks;
     bool& _needed;
 public:
     table_offstrategy_keyspace_compaction_task_impl(tasks::task_manager::module_ptr module,
@@ -288,13 +303,13 @@ class table_offstrategy_keyspace_compaction_task_impl : public offstrategy_compa
             replica::database& db,
             table_info ti,
             seastar::condition_variable& cv,
-            tasks::task_manager::task_ptr& current_task,
+            std::unordered_set<tasks::task_id>& current_tasks,
             bool& needed) noexcept
         : offstrategy_compaction_task_impl(module, tasks::task_id::create_random_id(), 0, "table", std::move(keyspace), std::move(table), "", parent_id)
         , _db(db)
         , _ti(std::move(ti))
         , _cv(cv)
-        , _current_task(current_task)
+        , _current_tasks(current_tasks)
         , _needed(needed)
     {}
 protected:
@@ -343,6 +358,10 @@ class upgrade_sstables_compaction_task_impl : public sstables_compaction_task_im
     virtual std::string type() const override {
         return "upgrade " + sstables_compaction_task_impl::type();
     }
+
+    virtual tasks::is_abortable is_abortable() const noexcept override {
+        return tasks::is_abortable::yes;
+    }
 protected:
     virtual future<> run() override;
 };
@@ -377,7 +396,7 @@ class table_upgrade_sstables_compaction_task_impl : public sstables_compaction_t
     replica::database& _db;
     table_info _ti;
     seastar::condition_variable& _cv;
-    tasks::task_manager::task_ptr& _current_task;
+    std::unordered_set<tasks::task_id>& _current_tasks;
     bool _exclude_current_version;
 public:
     table_upgrade_sstables_compaction_task_impl(tasks::task_manager::module_ptr module,
@@ -387,13 +406,13 @@ class table_upgrade_sstables_compaction_task_impl : public sstables_compaction_t
             replica::database& db,
             table_info ti,
             seastar::condition_variable& cv,
-            tasks::task_manager::task_ptr& current_task,
+            std::unordered_set<tasks::task_id>& current_tasks,
             bool exclude_current_version) noexcept
         : sstables_compaction_task_impl(module, tasks::task_id::create_random_id(), 0, "table", std::move(keyspace), std::move(table), "", parent_id)
         , _db(db)
         , _ti(std::move(ti))
         , _cv(cv)
-        , _current_task(current_task)
+        , _current_tasks(current_tasks)
         , _exclude_current_version(exclude_current_version)
     {}
 
@@ -404,6 +423,91 @@ class table_upgrade_sstables_compaction_task_impl : public sstables_compaction_t
     virtual future<> run() override;
 };
 
+class recompress_sstables_compaction_task_impl : public sstables_compaction_task_impl {
+private:
+    sharded<replica::database>& _db;
+    std::vector<table_info> _table_infos;
+    uint32_t _io_budget_mb_per_sec;
+public:
+    recompress_sstables_compaction_task_impl(tasks::task_manager::module_ptr module,
+            std::string keyspace,
+            sharded<replica::database>& db,
+            std::vector<table_info> table_infos,
+            uint32_t io_budget_mb_per_sec) noexcept
+        : sstables_compaction_task_impl(module, tasks::task_id::create_random_id(), module->new_sequence_number(), "keyspace", std::move(keyspace), "", "", tasks::task_id::create_null_id())
+        , _db(db)
+        , _table_infos(std::move(table_infos))
+        , _io_budget_mb_per_sec(io_budget_mb_per_sec)
+    {}
+
+    virtual std::string type() const override {
+        return "recompress " + sstables_compaction_task_impl::type();
+    }
+
+    virtual tasks::is_abortable is_abortable() const noexcept override {
+        return tasks::is_abortable::yes;
+    }
+protected:
+    virtual future<> run() override;
+};
+
+class shard_recompress_sstables_compaction_task_impl : public sstables_compaction_task_impl {
+private:
+    replica::database& _db;
+    std::vector<table_info> _table_infos;
+    uint32_t _io_budget_mb_per_sec;
+public:
+    shard_recompress_sstables_compaction_task_impl(tasks::task_manager::module_ptr module,
+            std::string keyspace,
+            tasks::task_id parent_id,
+            replica::database& db,
+            std::vector<table_info> table_infos,
+            uint32_t io_budget_mb_per_sec) noexcept
+        : sstables_compaction_task_impl(module, tasks::task_id::create_random_id(), 0, "shard", std::move(keyspace), "", "", parent_id)
+        , _db(db)
+        , _table_infos(std::move(table_infos))
+        , _io_budget_mb_per_sec(io_budget_mb_per_sec)
+    {}
+
+    virtual std::string type() const override {
+        return "recompress " + sstables_compaction_task_impl::type();
+    }
+protected:
+    virtual future<> run() override;
+};
+
+class table_recompress_sstables_compaction_task_impl : public sstables_compaction_task_impl {
+private:
+    replica::database& _db;
+    table_info _ti;
+    seastar::condition_variable& _cv;
+    std::unordered_set<tasks::task_id>& _current_tasks;
+    uint32_t _io_budget_mb_per_sec;
+public:
+    table_recompress_sstables_compaction_task_impl(tasks::task_manager::module_ptr module,
+            std::string keyspace,
+            std::string table,
+            tasks::task_id parent_id,
+            replica::database& db,
+            table_info ti,
+            seastar::condition_variable& cv,
+            std::unordered_set<tasks::task_id>& current_tasks,
+            uint32_t io_budget_mb_per_sec) noexcept
+        : sstables_compaction_task_impl(module, tasks::task_id::create_random_id(), 0, "table", std::move(keyspace), std::move(table), "", parent_id)
+        , _db(db)
+        , _ti(std::move(ti))
+        , _cv(cv)
+        , _current_tasks(current_tasks)
+        , _io_budget_mb_per_sec(io_budget_mb_per_sec)
+    {}
+
+    virtual std::string type() const override {
+        return "recompress " + sstables_compaction_task_impl::type();
+    }
+protected:
+    virtual future<> run() override;
+};
+
 class scrub_sstables_compaction_task_impl : public sstables_compaction_task_impl {
 private:
     sharded<replica::database>& _db;
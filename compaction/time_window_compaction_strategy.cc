@@ -311,9 +311,24 @@ time_window_compaction_strategy::get_sstables_for_compaction(table_state& table_
         return compaction_descriptor();
     }
 
+    // Whether an sstable may be fully expired is known from its stats alone, and it's only
+    // worth looking for the ones that can be dropped when some may be. Windows expire in
+    // order, so when one with a newer deletion time than seen before becomes expirable,
+    // it's checked right away, rather than at the next periodic check.
+    auto newest_expirable_deletion_time = gc_clock::time_point::min();
+    for (auto& sst : candidates) {
+        auto max_deletion_time = sst->get_max_local_deletion_time();
+        if (max_deletion_time < sst->get_gc_before_for_fully_expire(compaction_time, table_s.get_tombstone_gc_state())) {
+            newest_expirable_deletion_time = std::max(newest_expirable_deletion_time, max_deletion_time);
+        }
+    }
+    bool any_expirable = newest_expirable_deletion_time != gc_clock::time_point::min();
+    bool new_expirable = newest_expirable_deletion_time > state.last_expirable_deletion_time;
+
     auto now = db_clock::now();
-    if (now - state.last_expired_check > _options.expired_sstable_check_frequency) {
-        clogger.debug("[{}] TWCS expired check sufficiently far in the past, checking for fully expired SSTables", fmt::ptr(this));
+    if (any_expirable && (new_expirable || now - state.last_expired_check > _options.expired_sstable_check_frequency)) {
+        clogger.debug("[{}] TWCS checking for fully expired SSTables, new expirable ones: {}", fmt::ptr(this), new_expirable);
+        state.last_expirable_deletion_time = newest_expirable_deletion_time;
 
         // Find fully expired SSTables. Those will be included no matter what.
         auto expired = table_s.fully_expired_sstables(candidates, compaction_time);
@@ -353,6 +368,12 @@ time_window_compaction_strategy::compaction_mode(const time_window_compaction_st
 std::vector<shared_sstable>
 time_window_compaction_strategy::get_next_non_expired_sstables(table_state& table_s, strategy_control& control,
         std::vector<shared_sstable> non_expiring_sstables, gc_clock::time_point compaction_time) {
+    if (_proactive_tombstone_compaction && table_s.tombstone_gc_enabled()) {
+        if (auto sst = get_most_droppable_sstable(table_s, non_expiring_sstables, compaction_time)) {
+            return { sst };
+        }
+    }
+
     auto most_interesting = get_compaction_candidates(table_s, control, non_expiring_sstables);
 
     if (!most_interesting.empty()) {
@@ -64,6 +64,8 @@ using timestamp_type = api::timestamp_type;
 struct time_window_compaction_strategy_state {
     int64_t estimated_remaining_tasks = 0;
     db_clock::time_point last_expired_check;
+    // The newest deletion time of the sstables which were past it at the last expired check.
+    gc_clock::time_point last_expirable_deletion_time = gc_clock::time_point::min();
     // As timestamp_type is an int64_t, a primitive type, it must be initialized here.
     timestamp_type highest_window_seen = 0;
     // Keep track of all recent active windows that still need to be compacted into a single SSTable
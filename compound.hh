@@ -16,6 +16,7 @@
 #include <boost/range/iterator_range.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include "utils/serialization.hh"
+#include <seastar/core/byteorder.hh>
 #include <seastar/util/backtrace.hh>
 
 enum class allow_prefixes { no, yes };
@@ -23,10 +24,25 @@ enum class allow_prefixes { no, yes };
 template<allow_prefixes AllowPrefixes = allow_prefixes::no>
 class compound_type final {
 private:
+    // How prefix_equality_tri_compare() compares a component without going through abstract_type::compare().
+    enum class fixed_width_kind : uint8_t {
+        none,
+        int32,
+        int64,
+        timeuuid,
+    };
+    struct fixed_width_component {
+        fixed_width_kind kind;
+        uint16_t size;
+        bool reversed;
+    };
+
     const std::vector<data_type> _types;
     const bool _byte_order_equal;
     const bool _byte_order_comparable;
     const bool _is_reversed;
+    // Empty unless all components have types with fixed_width_kind other than none.
+    const std::vector<fixed_width_component> _fixed_width_components;
 public:
     static constexpr bool is_prefixable = AllowPrefixes == allow_prefixes::yes;
     using prefix_type = compound_type<allow_prefixes::yes>;
@@ -40,6 +56,7 @@ class compound_type final {
             }))
         , _byte_order_comparable(false)
         , _is_reversed(_types.size() == 1 && _types[0]->is_reversed())
+        , _fixed_width_components(make_fixed_width_components(_types))
     { }
 
     compound_type(compound_type&&) = default;
@@ -56,6 +73,80 @@ class compound_type final {
         return prefix_type(_types);
     }
 private:
+    static std::vector<fixed_width_component> make_fixed_width_components(const std::vector<data_type>& types) {
+        std::vector<fixed_width_component> components;
+        components.reserve(types.size());
+        for (auto& type : types) {
+            const bool reversed = type->is_reversed();
+            switch (type->without_reversed().get_kind()) {
+            case abstract_type::kind::int32:
+                components.push_back({fixed_width_kind::int32, sizeof(int32_t), reversed});
+                break;
+            case abstract_type::kind::long_kind:
+            case abstract_type::kind::timestamp:
+                components.push_back({fixed_width_kind::int64, sizeof(int64_t), reversed});
+                break;
+            case abstract_type::kind::timeuuid:
+                components.push_back({fixed_width_kind::timeuuid, utils::UUID::serialized_size(), reversed});
+                break;
+            default:
+                return {};
+            }
+        }
+        return components;
+    }
+
+    // A component of v, as iterated over by iterator.
+    static bytes_view read_component(bytes_view& v) {
+        if (v.size() < sizeof(size_type)) {
+            throw_with_backtrace<marshal_exception>(format("compound_type iterator - not enough bytes, expected {:d}, got {:d}", sizeof(size_type), v.size()));
+        }
+        auto len = read_be<size_type>(reinterpret_cast<const char*>(v.data()));
+        v.remove_prefix(sizeof(size_type));
+        if (v.size() < len) {
+            throw_with_backtrace<marshal_exception>(format("compound_type iterator - not enough bytes, expected {:d}, got {:d}", len, v.size()));
+        }
+        auto c = v.substr(0, len);
+        v.remove_prefix(len);
+        return c;
+    }
+
+    // Same result as _types[i]->compare(c1, c2) when both components have the size of the type.
+    static std::strong_ordering compare_fixed_width(fixed_width_kind kind, const int8_t* c1, const int8_t* c2) noexcept {
+        switch (kind) {
+        case fixed_width_kind::int32:
+            return read_be<int32_t>(reinterpret_cast<const char*>(c1)) <=> read_be<int32_t>(reinterpret_cast<const char*>(c2));
+        case fixed_width_kind::int64:
+            return read_be<int64_t>(reinterpret_cast<const char*>(c1)) <=> read_be<int64_t>(reinterpret_cast<const char*>(c2));
+        case fixed_width_kind::timeuuid:
+            return utils::timeuuid_tri_compare(c1, c2);
+        case fixed_width_kind::none:
+            break;
+        }
+        __builtin_unreachable();
+    }
+
+    std::strong_ordering prefix_equality_tri_compare_fixed_width(bytes_view b1, bytes_view b2) const {
+        auto t = _fixed_width_components.begin();
+        for (size_t i = 0; !b1.empty() && !b2.empty(); ++i, ++t) {
+            auto c1 = read_component(b1);
+            auto c2 = read_component(b2);
+            std::strong_ordering res = std::strong_ordering::equal;
+            if (c1.size() == t->size && c2.size() == t->size) [[likely]] {
+                res = compare_fixed_width(t->kind, c1.data(), c2.data());
+                if (t->reversed) {
+                    res = 0 <=> res;
+                }
+            } else {
+                // Empty values.
+                res = _types[i]->compare(c1, c2);
+            }
+            if (res != 0) {
+                return res;
+            }
+        }
+        return std::strong_ordering::equal;
+    }
     /*
      * Format:
      *   <len(value1)><value1><len(value2)><value2>...<len(value_n)><value_n>
@@ -255,6 +346,21 @@ class compound_type final {
                 return type->compare(v1, v2);
             });
     }
+    // Compares the values component by component, like ::prefix_equality_tri_compare() with ::tri_compare,
+    // so one value is equal to all values it is a prefix of.
+    //
+    // When all components are integers or timeuuids, they are decoded and compared in place,
+    // without the per-component virtual dispatch of abstract_type::compare().
+    std::strong_ordering prefix_equality_tri_compare(managed_bytes_view b1, managed_bytes_view b2) const {
+        if (!_fixed_width_components.empty()) {
+            return with_linearized(b1, [&] (bytes_view bv1) {
+                return with_linearized(b2, [&] (bytes_view bv2) {
+                    return prefix_equality_tri_compare_fixed_width(bv1, bv2);
+                });
+            });
+        }
+        return ::prefix_equality_tri_compare(_types.begin(), begin(b1), end(b1), begin(b2), end(b2), ::tri_compare);
+    }
     // Retruns true iff given prefix has no missing components
     bool is_full(managed_bytes_view v) const {
         assert(AllowPrefixes == allow_prefixes::yes);
@@ -10,11 +10,14 @@
 
 #include <map>
 #include <set>
+#include <string_view>
+#include <vector>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
 
+#include "bytes.hh"
 #include "exceptions/exceptions.hh"
 
 
@@ -42,6 +45,31 @@ class compressor {
      */
     virtual size_t compress_max_size(size_t input_len) const = 0;
 
+    /**
+     * Returns the size of the dictionary sstable writers should train for
+     * this compressor, or 0 if it doesn't use dictionaries.
+     */
+    virtual size_t dictionary_size() const {
+        return 0;
+    }
+    /**
+     * Trains a dictionary on the given samples and returns it, or an empty
+     * one if no dictionary could be trained. Training takes long and can't
+     * be preempted, but touches no shard-local state, so it can run on a
+     * thread outside the reactor.
+     */
+    virtual bytes train_dictionary(const std::vector<std::string_view>& samples) const {
+        return {};
+    }
+    /**
+     * Returns a compressor using a dictionary returned by train_dictionary().
+     * The returned compressor's options() carry the dictionary, so that
+     * create() can instantiate it again for reading.
+     */
+    virtual shared_ptr<compressor> with_dictionary(const bytes& dictionary) const {
+        return nullptr;
+    }
+
     /**
      * Returns accepted option names for this compressor
      */
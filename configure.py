@@ -524,6 +524,7 @@ scylla_tests = set([
     'test/boost/flush_queue_test',
     'test/boost/fragmented_temporary_buffer_test',
     'test/boost/frozen_mutation_test',
+    'test/boost/gossiper_test',
     'test/boost/gossiping_property_file_snitch_test',
     'test/boost/hash_test',
     'test/boost/hashers_test',
@@ -540,6 +541,7 @@ scylla_tests = set([
     'test/boost/linearizing_input_stream_test',
     'test/boost/loading_cache_test',
     'test/boost/log_heap_test',
+    'test/boost/loser_tree_test',
     'test/boost/estimated_histogram_test',
     'test/boost/summary_test',
     'test/boost/logalloc_test',
@@ -563,10 +565,12 @@ scylla_tests = set([
     'test/boost/tablets_test',
     'test/boost/nonwrapping_range_test',
     'test/boost/observable_test',
+    'test/boost/otlp_exporter_test',
     'test/boost/partitioner_test',
     'test/boost/querier_cache_test',
     'test/boost/query_processor_test',
     'test/boost/range_test',
+    'test/boost/range_streamer_test',
     'test/boost/range_tombstone_list_test',
     'test/boost/reusable_buffer_test',
     'test/boost/restrictions_test',
@@ -628,15 +632,20 @@ scylla_tests = set([
     'test/boost/exception_container_test',
     'test/boost/result_utils_test',
     'test/boost/rate_limiter_test',
+    'test/boost/partition_heavy_hitters_test',
     'test/boost/per_partition_rate_limit_test',
     'test/boost/expr_test',
     'test/boost/exceptions_optimized_test',
     'test/boost/exceptions_fallback_test',
     'test/boost/s3_test',
+    'test/boost/s3_disk_cache_test',
     'test/boost/locator_topology_test',
     'test/boost/string_format_test',
     'test/boost/tagged_integer_test',
     'test/boost/group0_cmd_merge_test',
+    'test/boost/zstd_rpc_compressor_test',
+    'test/boost/messaging_service_test',
+    'test/boost/paxos_state_test',
     'test/manual/ec2_snitch_test',
     'test/manual/enormous_table_scan_test',
     'test/manual/gce_snitch_test',
@@ -806,6 +815,7 @@ scylla_raft_core = [
 ]
 
 scylla_core = (['message/messaging_service.cc',
+                'message/zstd_rpc_compressor.cc',
                 'replica/database.cc',
                 'replica/table.cc',
                 'replica/tablets.cc',
@@ -851,6 +861,7 @@ scylla_core = (['message/messaging_service.cc',
                 'gms/generation-number.cc',
                 'utils/rjson.cc',
                 'utils/human_readable.cc',
+                'utils/alien_worker.cc',
                 'utils/histogram_metrics_helper.cc',
                 'utils/pretty_printers.cc',
                 'converting_mutation_partition_applier.cc',
@@ -876,6 +887,7 @@ scylla_core = (['message/messaging_service.cc',
                 'sstables/sstable_mutation_reader.cc',
                 'compaction/compaction.cc',
                 'compaction/compaction_strategy.cc',
+                'compaction/incremental_compaction_strategy.cc',
                 'compaction/size_tiered_compaction_strategy.cc',
                 'compaction/leveled_compaction_strategy.cc',
                 'compaction/task_manager_module.cc',
@@ -1024,6 +1036,9 @@ scylla_core = (['message/messaging_service.cc',
                 'db/commitlog/commitlog_replayer.cc',
                 'db/commitlog/commitlog_entry.cc',
                 'db/data_listeners.cc',
+                'db/compressed_partition_store.cc',
+                'db/absent_partition_store.cc',
+                'db/hot_partition_replicas.cc',
                 'db/functions/function.cc',
                 'db/hints/internal/hint_endpoint_manager.cc',
                 'db/hints/internal/hint_sender.cc',
@@ -1044,11 +1059,13 @@ scylla_core = (['message/messaging_service.cc',
                 'db/view/row_locking.cc',
                 'db/sstables-format-selector.cc',
                 'db/snapshot-ctl.cc',
+                'db/partition_heavy_hitters.cc',
                 'db/rate_limiter.cc',
                 'db/per_partition_rate_limit_options.cc',
                 'index/secondary_index_manager.cc',
                 'index/secondary_index.cc',
                 'utils/UUID_gen.cc',
+                'utils/background_disposer.cc',
                 'utils/i_filter.cc',
                 'utils/bloom_filter.cc',
                 'utils/bloom_calculations.cc',
@@ -1062,6 +1079,7 @@ scylla_core = (['message/messaging_service.cc',
                 'utils/gz/crc_combine.cc',
                 'utils/gz/crc_combine_table.cc',
                 'utils/s3/client.cc',
+                'utils/s3/disk_cache.cc',
                 'gms/version_generator.cc',
                 'gms/versioned_value.cc',
                 'gms/gossiper.cc',
@@ -1080,6 +1098,7 @@ scylla_core = (['message/messaging_service.cc',
                 'unimplemented.cc',
                 'query.cc',
                 'query-result-set.cc',
+                'query-result-columnar.cc',
                 'locator/abstract_replication_strategy.cc',
                 'locator/tablets.cc',
                 'locator/azure_snitch.cc',
@@ -1103,6 +1122,7 @@ scylla_core = (['message/messaging_service.cc',
                 'service/misc_services.cc',
                 'service/pager/paging_state.cc',
                 'service/pager/query_pagers.cc',
+                'service/qos/compaction_shares_updater.cc',
                 'service/qos/qos_common.cc',
                 'service/qos/service_level_controller.cc',
                 'service/qos/standard_service_level_distributed_data_accessor.cc',
@@ -1147,6 +1167,7 @@ scylla_core = (['message/messaging_service.cc',
                 'auth/certificate_authenticator.cc',
                 'tracing/tracing.cc',
                 'tracing/trace_keyspace_helper.cc',
+                'tracing/otlp_exporter.cc',
                 'tracing/trace_state.cc',
                 'tracing/traced_file.cc',
                 'table_helper.cc',
@@ -1338,7 +1359,10 @@ scylla_tests_dependencies = scylla_core + alternator + idls + scylla_tests_gener
 scylla_raft_dependencies = scylla_raft_core + ['utils/uuid.cc', 'utils/error_injection.cc']
 
 scylla_tools = ['tools/scylla-types.cc', 'tools/scylla-sstable.cc', 'tools/scylla-nodetool.cc', 'tools/schema_loader.cc', 'tools/utils.cc', 'tools/lua_sstable_consumer.cc']
-scylla_perfs = ['test/perf/perf_fast_forward.cc',
+scylla_perfs = ['test/perf/perf_alternator.cc',
+                'test/perf/perf_compaction.cc',
+                'test/perf/perf_fast_forward.cc',
+                'test/perf/perf_repair.cc',
                 'test/perf/perf_row_cache_update.cc',
                 'test/perf/perf_simple_query.cc',
                 'test/perf/perf_sstable.cc',
@@ -1455,6 +1479,7 @@ deps['test/boost/UUID_test'] = ['utils/UUID_gen.cc', 'test/boost/UUID_test.cc',
 deps['test/boost/murmur_hash_test'] = ['bytes.cc', 'utils/murmur_hash.cc', 'test/boost/murmur_hash_test.cc']
 deps['test/boost/allocation_strategy_test'] = ['test/boost/allocation_strategy_test.cc', 'utils/logalloc.cc', 'utils/dynamic_bitset.cc']
 deps['test/boost/log_heap_test'] = ['test/boost/log_heap_test.cc']
+deps['test/boost/loser_tree_test'] = ['test/boost/loser_tree_test.cc']
 deps['test/boost/estimated_histogram_test'] = ['test/boost/estimated_histogram_test.cc']
 deps['test/boost/summary_test'] = ['test/boost/summary_test.cc']
 deps['test/boost/anchorless_list_test'] = ['test/boost/anchorless_list_test.cc']
@@ -1473,6 +1498,7 @@ deps['test/boost/linearizing_input_stream_test'] = [
 ]
 deps['test/boost/expr_test'] = ['test/boost/expr_test.cc', 'test/lib/expr_test_utils.cc'] + scylla_core
 deps['test/boost/rate_limiter_test'] = ['test/boost/rate_limiter_test.cc', 'db/rate_limiter.cc']
+deps['test/boost/partition_heavy_hitters_test'] = ['test/boost/partition_heavy_hitters_test.cc', 'db/partition_heavy_hitters.cc']
 deps['test/boost/exceptions_optimized_test'] = ['test/boost/exceptions_optimized_test.cc', 'utils/exceptions.cc']
 deps['test/boost/exceptions_fallback_test'] = ['test/boost/exceptions_fallback_test.cc', 'utils/exceptions.cc']
 
@@ -6,6 +6,7 @@
 #include "expression.hh"
 
 #include "bytes.hh"
+#include <variant>
 #include <vector>
 
 namespace cql3 {
@@ -36,5 +37,33 @@ cql3::raw_value evaluate(const expression& e, const evaluation_inputs&);
 
 cql3::raw_value evaluate(const expression& e, const query_options&);
 
+// A restriction prepared for being checked against many rows of one query,
+// e.g. when filtering. Factors of the form `column <op> value`, where value is
+// a constant or a bind variable, have the value evaluated once and compare it
+// with each row's cell directly, with dedicated comparisons for int, bigint,
+// timestamp and text columns. Other factors are evaluated with is_satisfied_by().
+class compiled_restriction {
+    struct comparison {
+        enum class kind : uint8_t { int32, int64, text, generic };
+
+        const column_definition* column;
+        int32_t index; // of the column in evaluation_inputs::static_and_regular_columns
+        oper_t op;
+        kind cmp_kind;
+        data_type type; // without reversed
+        managed_bytes_opt value;
+        int64_t int_value = 0;
+
+        bool matches(const evaluation_inputs& inputs) const;
+    };
+    std::vector<std::variant<comparison, expression>> _factors;
+public:
+    compiled_restriction(const expression& restr, const cql3::selection::selection& selection, const query_options& options);
+
+    // Same as is_satisfied_by(restr, inputs), for inputs from the selection
+    // and options the restriction was compiled with.
+    bool is_satisfied_by(const evaluation_inputs& inputs) const;
+};
+
 
 }
@@ -371,6 +371,7 @@ struct aggregation_split_result {
     std::vector<expression> inner_loop;
     std::vector<expression> outer_loop;
     std::vector<cql3::raw_value> initial_values_for_temporaries; // same size as inner_loop
+    std::vector<shared_ptr<functions::function>> aggregates; // same size as inner_loop, the aggregate each one was split from
 };
 
 // Given a vector of aggergation expressions, split them into an inner loop that
@@ -12,6 +12,7 @@
 #include "cql3/expr/expr-utils.hh"
 
 #include <seastar/core/on_internal_error.hh>
+#include <seastar/core/byteorder.hh>
 
 #include <boost/algorithm/cxx11/all_of.hpp>
 #include <boost/algorithm/cxx11/any_of.hpp>
@@ -32,6 +33,7 @@
 #include "types/list.hh"
 #include "types/map.hh"
 #include "types/set.hh"
+#include "types/listlike_partial_deserializing_iterator.hh"
 #include "utils/like_matcher.hh"
 #include "query-result-reader.hh"
 #include "types/user.hh"
@@ -154,7 +156,6 @@ get_value(const subscript& s, const evaluation_inputs& inputs) {
         return std::nullopt;
     }
     auto col_type = static_pointer_cast<const collection_type_impl>(type_of(s.val));
-    const auto deserialized = type_of(s.val)->deserialize(managed_bytes_view(*serialized));
     const auto key = evaluate(s.sub, inputs);
     auto&& key_type = col_type->is_map() ? col_type->name_comparator() : int32_type;
     if (key.is_null()) {
@@ -168,25 +169,34 @@ get_value(const subscript& s, const evaluation_inputs& inputs) {
         // not an error.
         return std::nullopt;
     }
+    // Walk the serialized collection instead of deserializing it: only the entries
+    // before the one we're after are looked at, and none of them is copied.
+    managed_bytes_view in(*serialized);
     if (col_type->is_map()) {
-        const auto& data_map = value_cast<map_type_impl::native_type>(deserialized);
-        const auto found = key.view().with_linearized([&] (bytes_view key_bv) {
-            using entry = std::pair<data_value, data_value>;
-            return std::find_if(data_map.cbegin(), data_map.cend(), [&] (const entry& element) {
-                return key_type->compare(element.first.serialize_nonnull(), key_bv) == 0;
-            });
+        return key.view().with_linearized([&] (bytes_view key_bv) -> managed_bytes_opt {
+            auto size = read_collection_size(in);
+            for (int i = 0; i < size; ++i) {
+                auto element_key = read_collection_key(in);
+                auto element_value = read_collection_value_nonnull(in);
+                if (key_type->compare(element_key, key_bv) == 0) {
+                    return managed_bytes(element_value);
+                }
+            }
+            return std::nullopt;
         });
-        return found == data_map.cend() ? std::nullopt : managed_bytes_opt(found->second.serialize_nonnull());
     } else if (col_type->is_list()) {
-        const auto& data_list = value_cast<list_type_impl::native_type>(deserialized);
         auto key_deserialized = key.view().with_linearized([&] (bytes_view key_bv) {
             return key_type->deserialize(key_bv);
         });
         auto key_int = value_cast<int32_t>(key_deserialized);
-        if (key_int < 0 || size_t(key_int) >= data_list.size()) {
+        auto size = read_collection_size(in);
+        if (key_int < 0 || key_int >= size) {
             return std::nullopt;
         }
-        return managed_bytes_opt(data_list[key_int].serialize_nonnull());
+        for (int i = 0; i < key_int; ++i) {
+            read_collection_value(in);
+        }
+        return managed_bytes(read_collection_value_nonnull(in));
     } else {
         throw exceptions::invalid_request_exception(fmt::format("subscripting non-map, non-list column {:user}", s.val));
     }
@@ -1838,6 +1848,146 @@ cql3::raw_value evaluate(const expression& e, const query_options& options) {
     return evaluate(e, evaluation_inputs{.options = &options});
 }
 
+compiled_restriction::compiled_restriction(const expression& restr, const selection& selection, const query_options& options) {
+    for_each_boolean_factor(restr, [&] (const expression& factor) {
+        auto binop = as_if<binary_operator>(&factor);
+        auto col = binop ? as_if<column_value>(&binop->lhs) : nullptr;
+        if (!col
+                || binop->order != comparison_order::cql
+                || binop->null_handling != null_handling_style::sql
+                || !(binop->op == oper_t::EQ || binop->op == oper_t::NEQ || is_slice(binop->op))
+                || !(is<constant>(binop->rhs) || is<bind_variable>(binop->rhs))) {
+            _factors.emplace_back(factor);
+            return;
+        }
+        int32_t index = -1;
+        if (col->col->kind == column_kind::static_column || col->col->kind == column_kind::regular_column) {
+            index = selection.index_of(*col->col);
+            if (index == -1) {
+                // Let is_satisfied_by() report the error, if the factor is ever evaluated.
+                _factors.emplace_back(factor);
+                return;
+            }
+        }
+        comparison c{
+            .column = col->col,
+            .index = index,
+            .op = binop->op,
+            .cmp_kind = comparison::kind::generic,
+            .type = col->col->type->without_reversed(),
+            .value = evaluate(binop->rhs, options).to_managed_bytes_opt(),
+        };
+        if (c.value && c.value->is_linearized()) {
+            auto v = managed_bytes_view(*c.value).current_fragment();
+            switch (c.type->get_kind()) {
+            case abstract_type::kind::int32:
+                if (v.size() == sizeof(int32_t)) {
+                    c.cmp_kind = comparison::kind::int32;
+                    c.int_value = read_be<int32_t>(reinterpret_cast<const char*>(v.data()));
+                }
+                break;
+            case abstract_type::kind::long_kind:
+            case abstract_type::kind::timestamp:
+                if (v.size() == sizeof(int64_t)) {
+                    c.cmp_kind = comparison::kind::int64;
+                    c.int_value = read_be<int64_t>(reinterpret_cast<const char*>(v.data()));
+                }
+                break;
+            case abstract_type::kind::ascii:
+            case abstract_type::kind::utf8:
+                c.cmp_kind = comparison::kind::text;
+                break;
+            default:
+                break;
+            }
+        }
+        _factors.emplace_back(std::move(c));
+    });
+}
+
+bool compiled_restriction::comparison::matches(const evaluation_inputs& inputs) const {
+    if (!value) {
+        // Comparing with NULL yields NULL, which doesn't satisfy the restriction.
+        return false;
+    }
+    managed_bytes_view cell;
+    switch (column->kind) {
+    case column_kind::partition_key:
+        cell = managed_bytes_view(bytes_view(inputs.partition_key[column->id]));
+        break;
+    case column_kind::clustering_key:
+        if (column->id >= inputs.clustering_key.size()) {
+            return false;
+        }
+        cell = managed_bytes_view(bytes_view(inputs.clustering_key[column->id]));
+        break;
+    default:
+        if (!inputs.static_and_regular_columns[index]) {
+            return false;
+        }
+        cell = managed_bytes_view(*inputs.static_and_regular_columns[index]);
+        break;
+    }
+
+    auto compare_ints = [&] <typename T> () -> std::optional<std::strong_ordering> {
+        if (cell.size() != sizeof(T) || !cell.is_linearized()) {
+            return std::nullopt;
+        }
+        return read_be<T>(reinterpret_cast<const char*>(cell.current_fragment().data())) <=> T(int_value);
+    };
+    std::optional<std::strong_ordering> cmp;
+    switch (cmp_kind) {
+    case kind::int32:
+        cmp = compare_ints.template operator()<int32_t>();
+        break;
+    case kind::int64:
+        cmp = compare_ints.template operator()<int64_t>();
+        break;
+    case kind::text:
+        cmp = compare_unsigned(cell, managed_bytes_view(*value));
+        break;
+    case kind::generic:
+        break;
+    }
+    if (!cmp) {
+        if (op == oper_t::EQ) {
+            return type->equal(cell, managed_bytes_view(*value));
+        } else if (op == oper_t::NEQ) {
+            return !type->equal(cell, managed_bytes_view(*value));
+        }
+        return limits(cell, op, managed_bytes_view(*value), *type);
+    }
+    switch (op) {
+    case oper_t::EQ:
+        return *cmp == 0;
+    case oper_t::NEQ:
+        return *cmp != 0;
+    case oper_t::LT:
+        return *cmp < 0;
+    case oper_t::LTE:
+        return *cmp <= 0;
+    case oper_t::GT:
+        return *cmp > 0;
+    case oper_t::GTE:
+        return *cmp >= 0;
+    default:
+        on_internal_error(expr_logger, format("compiled_restriction: unexpected operator {}", op));
+    }
+}
+
+bool compiled_restriction::is_satisfied_by(const evaluation_inputs& inputs) const {
+    for (auto& factor : _factors) {
+        bool satisfied = std::visit(overloaded_functor{
+            [&] (const comparison& c) { return c.matches(inputs); },
+            [&] (const expression& e) { return expr::is_satisfied_by(e, inputs); },
+        }, factor);
+        if (!satisfied) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // Takes a value and reserializes it where needs_to_be_reserialized() says it's needed
 template <FragmentedView View>
 static managed_bytes reserialize_value(View value_bytes,
@@ -2937,6 +3087,7 @@ split_aggregation(std::span<const expression> aggregation) {
     std::vector<expression> inner_vec;
     std::vector<expression> outer_vec;
     std::vector<raw_value> initial_values_vec;
+    std::vector<shared_ptr<functions::function>> aggregates_vec;
     for (auto& e : aggregation) {
         auto outer = search_and_replace(e, [&] (const expression& e) -> std::optional<expression> {
             auto fc = as_if<function_call>(&e);
@@ -2983,6 +3134,7 @@ split_aggregation(std::span<const expression> aggregation) {
                     });
                     inner_vec.push_back(std::move(inner));
                     initial_values_vec.push_back(raw_value::make_value(agg.initial_state));
+                    aggregates_vec.push_back(fn);
                     return outer;
                 }
             }, fc->func);
@@ -2994,6 +3146,7 @@ split_aggregation(std::span<const expression> aggregation) {
         .inner_loop = std::move(inner_vec),
         .outer_loop = std::move(outer_vec),
         .initial_values_for_temporaries = std::move(initial_values_vec),
+        .aggregates = std::move(aggregates_vec),
     };
 }
 
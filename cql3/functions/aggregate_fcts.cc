@@ -21,6 +21,8 @@
 #include "first_function.hh"
 #include "exceptions/exceptions.hh"
 #include "utils/multiprecision_int.hh"
+#include "utils/fragment_range.hh"
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -165,6 +167,139 @@ narrow(WideT acc) {
 template <typename T>
 using accumulator_for = std::conditional_t<std::is_integral_v<T>, utils::multiprecision_int, T>;
 
+using db::functions::aggregate_accumulator;
+
+// Deserializes an argument of an aggregate function, without going through
+// a data_value for fixed-size numeric types.
+template <typename T>
+T deserialize_argument(managed_bytes_view v) {
+    if constexpr (std::is_arithmetic_v<T>) {
+        if (v.size_bytes() == sizeof(T)) {
+            if constexpr (std::is_integral_v<T>) {
+                return read_simple_exactly<T>(v);
+            } else {
+                using bits_type = std::conditional_t<sizeof(T) == sizeof(int32_t), int32_t, int64_t>;
+                return std::bit_cast<T>(read_simple_exactly<bits_type>(v));
+            }
+        }
+    }
+    return value_cast<T>(data_type_for<T>()->deserialize_value(v));
+}
+
+// Sums inputs into accumulator_for<Type>, with the same result as the sum and
+// avg step functions.
+template <typename Type>
+class native_sum {
+    using Acc = accumulator_for<Type>;
+    Acc _sum = Acc(0);
+    // Integral inputs are summed in a machine word first, which is folded
+    // into the arbitrary precision _sum only when it would overflow.
+    int64_t _partial = 0;
+public:
+    void add(const Type& v) {
+        if constexpr (std::is_integral_v<Type>) {
+            int64_t partial;
+            if (__builtin_add_overflow(_partial, int64_t(v), &partial)) {
+                _sum += _partial;
+                partial = v;
+            }
+            _partial = partial;
+        } else {
+            _sum = _sum + v;
+        }
+    }
+    Acc get() const {
+        if constexpr (std::is_integral_v<Type>) {
+            return _sum + _partial;
+        } else {
+            return _sum;
+        }
+    }
+};
+
+template <typename Type>
+class sum_accumulator final : public aggregate_accumulator {
+    native_sum<Type> _sum;
+public:
+    virtual void add(managed_bytes_view_opt input) override {
+        if (input) {
+            _sum.add(deserialize_argument<Type>(*input));
+        }
+    }
+    virtual bytes_opt state() const override {
+        return data_type_for<accumulator_for<Type>>()->decompose(_sum.get());
+    }
+    virtual void reset() override {
+        _sum = {};
+    }
+};
+
+template <typename Type>
+class avg_accumulator final : public aggregate_accumulator {
+    data_type _state_type;
+    native_sum<Type> _sum;
+    int64_t _count = 0;
+public:
+    explicit avg_accumulator(data_type state_type) : _state_type(std::move(state_type)) {}
+    virtual void add(managed_bytes_view_opt input) override {
+        if (input) {
+            _sum.add(deserialize_argument<Type>(*input));
+            _count++;
+        }
+    }
+    virtual bytes_opt state() const override {
+        return make_tuple_value(_state_type, std::vector({data_value(_sum.get()), data_value(_count)})).serialize();
+    }
+    virtual void reset() override {
+        _sum = {};
+        _count = 0;
+    }
+};
+
+class count_accumulator final : public aggregate_accumulator {
+    // countRows() counts its (argument-less) inputs, count(x) the non-null ones.
+    bool _count_nulls;
+    int64_t _count = 0;
+public:
+    explicit count_accumulator(bool count_nulls) : _count_nulls(count_nulls) {}
+    virtual void add(managed_bytes_view_opt input) override {
+        if (input || _count_nulls) {
+            _count++;
+        }
+    }
+    virtual bytes_opt state() const override {
+        return data_value(_count).serialize();
+    }
+    virtual void reset() override {
+        _count = 0;
+    }
+};
+
+// Keeps the greatest (or least) input, as max_step (min_step) does, but
+// compares inputs with the current value in place instead of copying both
+// for each input.
+class extremum_accumulator final : public aggregate_accumulator {
+    data_type _type;
+    bool _greatest;
+    managed_bytes_opt _value;
+public:
+    extremum_accumulator(data_type type, bool greatest) : _type(std::move(type)), _greatest(greatest) {}
+    virtual void add(managed_bytes_view_opt input) override {
+        if (!input) {
+            return;
+        }
+        if (!_value || (_greatest ? _type->compare(*input, *_value) > 0 : _type->compare(*input, *_value) < 0)) {
+            _value = managed_bytes(*input);
+        }
+    }
+    virtual bytes_opt state() const override {
+        return _value ? bytes_opt(to_bytes(*_value)) : std::nullopt;
+    }
+    virtual void reset() override {
+        _value = std::nullopt;
+    }
+};
+
 template <typename Type>
 static
 shared_ptr<aggregate_function>
@@ -180,6 +315,7 @@ make_sum_function() {
             .aggregation_function = make_internal_scalar_function("sum_step", return_accumulator_on_null, [] (Acc acc, Type addend) -> Acc { return acc + addend; }),
             .state_to_result_function = make_internal_scalar_function("sum_finalizer", return_any_nonnull, [] (Acc acc) -> Type { return narrow<Type>(acc); }),
             .state_reduction_function = make_internal_scalar_function("sum_reducer", return_any_nonnull, [] (Acc a1, Acc a2) -> Acc { return a1 + a2; }),
+            .make_accumulator = [] { return std::make_unique<sum_accumulator<Type>>(); },
         }
     );
 }
@@ -263,6 +399,7 @@ make_avg_function() {
                         acc1[1] = data_value(count1 + count2);
                         return make_tuple_value(accumulator_tuple_type, acc1).serialize();
                     }),
+            .make_accumulator = [accumulator_tuple_type] { return std::make_unique<avg_accumulator<Type>>(accumulator_tuple_type); },
         });
 }
 
@@ -322,6 +459,7 @@ aggregate_fcts::make_count_function(data_type input_type) {
                     }),
             .state_to_result_function = make_internal_scalar_function("count_finalizer", return_any_nonnull, [] (int64_t count) { return count; }),
             .state_reduction_function = make_internal_scalar_function("count_reducer", return_any_nonnull, [] (int64_t c1, int64_t c2) { return c1 + c2; }),
+            .make_accumulator = [] { return std::make_unique<count_accumulator>(false); },
         });
 }
 
@@ -404,6 +542,7 @@ aggregate_fcts::make_count_rows_function() {
             .state_reduction_function = make_internal_scalar_function("count_reducer", return_any_nonnull, [] (int64_t acc1, int64_t acc2) {
                 return acc1 + acc2;
             }),
+            .make_accumulator = [] { return std::make_unique<count_accumulator>(true); },
         }
     );
 }
@@ -432,6 +571,7 @@ aggregate_fcts::make_max_function(data_type io_type) {
                 return args[0];
             }),
             .state_reduction_function = max,
+            .make_accumulator = [io_type] { return std::make_unique<extremum_accumulator>(io_type, true); },
         }
     );
 }
@@ -460,6 +600,7 @@ aggregate_fcts::make_min_function(data_type io_type) {
                 return args[0];
             }),
             .state_reduction_function = min,
+            .make_accumulator = [io_type] { return std::make_unique<extremum_accumulator>(io_type, false); },
         }
     );
 }
@@ -213,7 +213,13 @@ shared_ptr<function>
 make_to_json_function(data_type t) {
     return make_native_scalar_function<true>("tojson", utf8_type, {t},
             [t](std::span<const bytes_opt> parameters) -> bytes_opt {
-        return utf8_type->decompose(to_json_string(*t, parameters[0]));
+        bytes_ostream out;
+        if (parameters[0]) {
+            to_json_string(out, *t, bytes_view(*parameters[0]));
+        } else {
+            out.write("null", 4);
+        }
+        return bytes(out.linearize());
     });
 }
 
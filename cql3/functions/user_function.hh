@@ -32,6 +32,7 @@ class user_function final : public abstract_function, public scalar_function, pu
         // lua_runtime in a thread_local variable, but that is one extra
         // global.
         lua::runtime_config cfg;
+        lua::state_pool states;
     };
 
     using context = std::variant<lua_context, wasm::context>;
@@ -11,6 +11,7 @@
 #include "selection/selection.hh"
 #include "stats.hh"
 #include "utils/buffer_view-to-managed_bytes_view.hh"
+#include "utils/fragment_range.hh"
 
 namespace cql3 {
 class untyped_result_set;
@@ -23,11 +24,44 @@ class result_generator {
     cql_stats* _stats;
 private:
     friend class untyped_result_set;
+    // Components of a key, linearized into a buffer which is reused from key to
+    // key, so that visiting a row doesn't allocate once the buffer is large enough.
+    class key_components {
+        bytes _buffer;
+        std::vector<bytes_view> _views;
+    public:
+        template<typename Key>
+        void assign(const Key& key, const schema& s) {
+            size_t size = 0;
+            for (managed_bytes_view c : key.components(s)) {
+                size += c.size();
+            }
+            if (_buffer.size() < size) {
+                _buffer = bytes(bytes::initialized_later(), size);
+            }
+            _views.clear();
+            auto out = _buffer.data();
+            for (managed_bytes_view c : key.components(s)) {
+                auto start = out;
+                for (bytes_view frag : fragment_range(c)) {
+                    out = std::copy(frag.begin(), frag.end(), out);
+                }
+                _views.emplace_back(start, c.size());
+            }
+        }
+        size_t size() const {
+            return _views.size();
+        }
+        bytes_view operator[](size_t i) const {
+            return _views[i];
+        }
+    };
+
     template<typename Visitor>
     class query_result_visitor {
         const schema& _schema;
-        std::vector<bytes> _partition_key;
-        std::vector<bytes> _clustering_key;
+        key_components _partition_key;
+        key_components _clustering_key;
         uint64_t _partition_row_count = 0;
         uint64_t _total_row_count = 0;
         Visitor& _visitor;
@@ -46,7 +80,7 @@ class result_generator {
             : _schema(s), _visitor(visitor), _selection(select) { }
 
         void accept_new_partition(const partition_key& key, uint64_t row_count) {
-            _partition_key = key.explode(_schema);
+            _partition_key.assign(key, _schema);
             accept_new_partition(row_count);
         }
         void accept_new_partition(uint64_t row_count) {
@@ -56,7 +90,7 @@ class result_generator {
 
         void accept_new_row(const clustering_key& key, query::result_row_view static_row,
                             query::result_row_view row) {
-            _clustering_key = key.explode(_schema);
+            _clustering_key.assign(key, _schema);
             accept_new_row(static_row, row);
         }
         void accept_new_row(query::result_row_view static_row, query::result_row_view row) {
@@ -66,11 +100,11 @@ class result_generator {
             for (auto&& def : _selection.get_columns()) {
                 switch (def->kind) {
                 case column_kind::partition_key:
-                    _visitor.accept_value(bytes_view(_partition_key[def->component_index()]));
+                    _visitor.accept_value(_partition_key[def->component_index()]);
                     break;
                 case column_kind::clustering_key:
                     if (_clustering_key.size() > def->component_index()) {
-                        _visitor.accept_value(bytes_view(_clustering_key[def->component_index()]));
+                        _visitor.accept_value(_clustering_key[def->component_index()]);
                     } else {
                         _visitor.accept_value(std::nullopt);
                     }
@@ -93,7 +127,7 @@ class result_generator {
                 auto static_row_iterator = static_row.iterator();
                 for (auto&& def : _selection.get_columns()) {
                     if (def->is_partition_key()) {
-                        _visitor.accept_value(bytes_view(_partition_key[def->component_index()]));
+                        _visitor.accept_value(_partition_key[def->component_index()]);
                     } else if (def->is_static()) {
                         accept_cell_value(*def, static_row_iterator);
                     } else {
@@ -196,6 +196,8 @@ class selection_with_processing : public selection {
     std::vector<expr::expression> _inner_loop;
     std::vector<expr::expression> _outer_loop;
     std::vector<raw_value> _initial_values_for_temporaries;
+    // The aggregate each element of _inner_loop was split from
+    std::vector<shared_ptr<functions::function>> _aggregates;
 public:
     selection_with_processing(schema_ptr schema, std::vector<const column_definition*> columns,
             std::vector<lw_shared_ptr<column_specification>> metadata,
@@ -209,6 +211,7 @@ class selection_with_processing : public selection {
         _outer_loop = std::move(agg_split.outer_loop);
         _inner_loop = std::move(agg_split.inner_loop);
         _initial_values_for_temporaries = std::move(agg_split.initial_values_for_temporaries);
+        _aggregates = std::move(agg_split.aggregates);
     }
 
     virtual uint32_t add_column_for_post_processing(const column_definition& c) override {
@@ -232,6 +235,7 @@ class selection_with_processing : public selection {
                     .args = {temp, expr::column_value(&c)},
                 });
             _initial_values_for_temporaries.push_back(raw_value::make_value(agg.initial_state));
+            _aggregates.push_back(first_func);
             _outer_loop.push_back(
                 expr::function_call{
                     .func = agg.state_to_result_function,
@@ -253,29 +257,34 @@ class selection_with_processing : public selection {
             });
     }
 
+    static bool is_reducible_selector(const expr::expression& e) {
+        auto fc = expr::as_if<expr::function_call>(&e);
+        if (!fc) {
+            return false;
+        }
+        auto func = std::get<shared_ptr<cql3::functions::function>>(fc->func);
+        if (!func->is_aggregate()) {
+            return false;
+        }
+        auto agg_func = dynamic_pointer_cast<functions::aggregate_function>(std::move(func));
+        if (!agg_func->get_aggregate().state_reduction_function) {
+            return false;
+        }
+        // We only support transforming columns directly for parallel queries
+        if (!boost::algorithm::all_of(fc->args, expr::is<expr::column_value>)) {
+            return false;
+        }
+        return true;
+    }
+
     virtual bool is_reducible() const override {
-        return boost::algorithm::all_of(
-                _selectors,
-               [] (const expr::expression& e) {
-                    auto fc = expr::as_if<expr::function_call>(&e);
-                    if (!fc) {
-                        return false;
-                    }
-                    auto func = std::get<shared_ptr<cql3::functions::function>>(fc->func);
-                    if (!func->is_aggregate()) {
-                        return false;
-                    }
-                    auto agg_func = dynamic_pointer_cast<functions::aggregate_function>(std::move(func));
-                    if (!agg_func->get_aggregate().state_reduction_function) {
-                        return false;
-                    }
-                    // We only support transforming columns directly for parallel queries
-                    if (!boost::algorithm::all_of(fc->args, expr::is<expr::column_value>)) {
-                        return false;
-                    }
-                    return true;
-                }
-        );
+        return boost::algorithm::all_of(_selectors, is_reducible_selector);
+    }
+
+    virtual bool is_reducible_per_group() const override {
+        return boost::algorithm::all_of(_selectors, [] (const expr::expression& e) {
+            return expr::is<expr::column_value>(e) || is_reducible_selector(e);
+        });
     }
 
     virtual query::forward_request::reductions_info get_reductions() const override {
@@ -285,6 +294,15 @@ class selection_with_processing : public selection {
             throw std::runtime_error("Selection doesn't have a reduction");
         };
         for (const auto& e : _selectors) {
+            if (auto col = expr::as_if<expr::column_value>(&e)) {
+                // A column added for GROUP BY post-processing, see is_reducible_per_group().
+                types.push_back(query::forward_request::reduction_type::aggregate);
+                infos.push_back(query::forward_request::aggregation_info {
+                    .name = functions::aggregate_fcts::first_function_name(),
+                    .column_names = {col->col->name_as_text()},
+                });
+                continue;
+            }
             auto fc = expr::as_if<expr::function_call>(&e);
             if (!fc) {
                 bad();
@@ -343,7 +361,24 @@ class selection_with_processing : public selection {
     private:
         const selection_with_processing& _sel;
         std::vector<raw_value> _temporaries;
+        // Native accumulators standing in for the elements of _inner_loop whose
+        // aggregate provides one (null otherwise). They keep their state
+        // deserialized across input rows, and store it in the temporary only
+        // when the output row is computed.
+        std::vector<std::unique_ptr<db::functions::aggregate_accumulator>> _accumulators;
         bool _requires_thread;
+
+        static std::unique_ptr<db::functions::aggregate_accumulator> make_accumulator(const shared_ptr<functions::function>& fn, const expr::expression& inner) {
+            auto agg_fn = dynamic_pointer_cast<functions::aggregate_function>(fn);
+            if (!agg_fn || !agg_fn->get_aggregate().make_accumulator) {
+                return nullptr;
+            }
+            // The temporary, and at most one argument
+            if (expr::as<expr::function_call>(inner).args.size() > 2) {
+                return nullptr;
+            }
+            return agg_fn->get_aggregate().make_accumulator();
+        }
     public:
         explicit selectors_with_processing(const selection_with_processing& sel)
             : _sel(sel)
@@ -353,7 +388,12 @@ class selection_with_processing : public selection {
                     return std::get<shared_ptr<functions::function>>(fc.func)->requires_thread();
                 });
              }))
-        { }
+        {
+            _accumulators.reserve(_sel._inner_loop.size());
+            for (size_t i = 0; i != _sel._inner_loop.size(); ++i) {
+                _accumulators.push_back(make_accumulator(_sel._aggregates[i], _sel._inner_loop[i]));
+            }
+        }
 
         virtual bool requires_thread() const override {
             return _requires_thread;
@@ -361,6 +401,11 @@ class selection_with_processing : public selection {
 
         virtual void reset() override {
             _temporaries = _sel._initial_values_for_temporaries;
+            for (auto& acc : _accumulators) {
+                if (acc) {
+                    acc->reset();
+                }
+            }
         }
 
         virtual bool is_aggregate() const override {
@@ -388,6 +433,11 @@ class selection_with_processing : public selection {
         }
 
         virtual std::vector<managed_bytes_opt> get_output_row() override {
+            for (size_t i = 0; i != _accumulators.size(); ++i) {
+                if (_accumulators[i]) {
+                    _temporaries[i] = raw_value::make_value(_accumulators[i]->state());
+                }
+            }
             std::vector<managed_bytes_opt> output_row;
             output_row.reserve(_sel._outer_loop.size());
             auto inputs = expr::evaluation_inputs{
@@ -419,6 +469,16 @@ class selection_with_processing : public selection {
                     .temporaries = _temporaries,
             };
             for (size_t i = 0; i != _sel._inner_loop.size(); ++i) {
+                if (auto& acc = _accumulators[i]) {
+                    auto& args = expr::as<expr::function_call>(_sel._inner_loop[i]).args;
+                    if (args.size() < 2) {
+                        acc->add(std::nullopt);
+                        continue;
+                    }
+                    auto arg = expr::evaluate(args[1], inputs).to_managed_bytes_opt();
+                    acc->add(arg ? managed_bytes_view_opt(*arg) : std::nullopt);
+                    continue;
+                }
                 _temporaries[i] = expr::evaluate(_sel._inner_loop[i], inputs);
             }
         }
@@ -619,6 +679,40 @@ result_set_builder::restrictions_filter::restrictions_filter(::shared_ptr<const
     , _last_pkey(std::move(last_pkey))
 { }
 
+void result_set_builder::restrictions_filter::compile_column_restrictions(const selection& selection) const {
+    const auto& columns = selection.get_columns();
+    _column_restrictions.resize(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const expr::single_column_restrictions_map* restrictions_map = nullptr;
+        switch (columns[i]->kind) {
+        case column_kind::static_column:
+        case column_kind::regular_column:
+            restrictions_map = &_restrictions->get_non_pk_restriction();
+            break;
+        case column_kind::partition_key:
+            if (!_skip_pk_restrictions) {
+                restrictions_map = &_restrictions->get_single_column_partition_key_restrictions();
+            }
+            break;
+        case column_kind::clustering_key:
+            if (!_skip_ck_restrictions) {
+                restrictions_map = &_restrictions->get_single_column_clustering_key_restrictions();
+            }
+            break;
+        default:
+            break;
+        }
+        if (!restrictions_map) {
+            continue;
+        }
+        auto restr_it = restrictions_map->find(columns[i]);
+        if (restr_it != restrictions_map->end()) {
+            _column_restrictions[i].emplace(restr_it->second, selection, _options);
+        }
+    }
+    _column_restrictions_compiled = true;
+}
+
 bool result_set_builder::restrictions_filter::do_filter(const selection& selection,
                                                          const std::vector<bytes>& partition_key,
                                                          const std::vector<bytes>& clustering_key,
@@ -629,18 +723,28 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
     if (_current_partition_key_does_not_match || _current_static_row_does_not_match || _remaining == 0 || _per_partition_remaining == 0) {
         return false;
     }
+    if (!_column_restrictions_compiled) {
+        compile_column_restrictions(selection);
+    }
+
+    // Values of the static and regular columns are extracted once per row,
+    // and only if some restriction needs them.
+    std::optional<std::vector<managed_bytes_opt>> static_and_regular_columns;
+    auto get_static_and_regular_columns = [&] () -> const std::vector<managed_bytes_opt>& {
+        if (!static_and_regular_columns) {
+            static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
+        }
+        return *static_and_regular_columns;
+    };
 
     const expr::expression& clustering_columns_restrictions = _restrictions->get_clustering_columns_restrictions();
     if (expr::contains_multi_column_restriction(clustering_columns_restrictions)) {
-        clustering_key_prefix ckey = clustering_key_prefix::from_exploded(clustering_key);
-        // FIXME: push to upper layer so it happens once per row
-        auto static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
         bool multi_col_clustering_satisfied = expr::is_satisfied_by(
                 clustering_columns_restrictions,
                 expr::evaluation_inputs{
                     .partition_key = partition_key,
                     .clustering_key = clustering_key,
-                    .static_and_regular_columns = static_and_regular_columns,
+                    .static_and_regular_columns = get_static_and_regular_columns(),
                     .selection = &selection,
                     .options = &_options,
                 });
@@ -649,30 +753,25 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
         }
     }
 
-    auto static_row_iterator = static_row.iterator();
-    auto row_iterator = row ? std::optional<query::result_row_view::iterator_type>(row->iterator()) : std::nullopt;
-    const expr::single_column_restrictions_map& non_pk_restrictions_map = _restrictions->get_non_pk_restriction();
-    for (auto&& cdef : selection.get_columns()) {
+    const auto& columns = selection.get_columns();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const auto& restriction = _column_restrictions[i];
+        if (!restriction) {
+            continue;
+        }
+        const column_definition* cdef = columns[i];
         switch (cdef->kind) {
         case column_kind::static_column:
             // fallthrough
         case column_kind::regular_column: {
-            if (cdef->kind == column_kind::regular_column && !row_iterator) {
-                continue;
-            }
-            auto restr_it = non_pk_restrictions_map.find(cdef);
-            if (restr_it == non_pk_restrictions_map.end()) {
+            if (cdef->kind == column_kind::regular_column && !row) {
                 continue;
             }
-            const expr::expression& single_col_restriction = restr_it->second;
-            // FIXME: push to upper layer so it happens once per row
-            auto static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
-            bool regular_restriction_matches = expr::is_satisfied_by(
-                    single_col_restriction,
+            bool regular_restriction_matches = restriction->is_satisfied_by(
                     expr::evaluation_inputs{
                         .partition_key = partition_key,
                         .clustering_key = clustering_key,
-                        .static_and_regular_columns = static_and_regular_columns,
+                        .static_and_regular_columns = get_static_and_regular_columns(),
                         .selection = &selection,
                         .options = &_options,
                     });
@@ -683,17 +782,7 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
             }
             break;
         case column_kind::partition_key: {
-            if (_skip_pk_restrictions) {
-                continue;
-            }
-            auto partition_key_restrictions_map = _restrictions->get_single_column_partition_key_restrictions();
-            auto restr_it = partition_key_restrictions_map.find(cdef);
-            if (restr_it == partition_key_restrictions_map.end()) {
-                continue;
-            }
-            const expr::expression& single_col_restriction = restr_it->second;
-            if (!expr::is_satisfied_by(
-                        single_col_restriction,
+            if (!restriction->is_satisfied_by(
                         expr::evaluation_inputs{
                             .partition_key = partition_key,
                             .clustering_key = clustering_key,
@@ -707,21 +796,10 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
             }
             break;
         case column_kind::clustering_key: {
-            if (_skip_ck_restrictions) {
-                continue;
-            }
-            const expr::single_column_restrictions_map& clustering_key_restrictions_map =
-                _restrictions->get_single_column_clustering_key_restrictions();
-            auto restr_it = clustering_key_restrictions_map.find(cdef);
-            if (restr_it == clustering_key_restrictions_map.end()) {
-                continue;
-            }
             if (clustering_key.empty()) {
                 return false;
             }
-            const expr::expression& single_col_restriction = restr_it->second;
-            if (!expr::is_satisfied_by(
-                        single_col_restriction,
+            if (!restriction->is_satisfied_by(
                         expr::evaluation_inputs{
                             .partition_key = partition_key,
                             .clustering_key = clustering_key,
@@ -16,6 +16,7 @@
 #include "selector.hh"
 #include "cql3/column_specification.hh"
 #include "cql3/functions/function.hh"
+#include "cql3/expr/evaluate.hh"
 #include "exceptions/exceptions.hh"
 #include "unimplemented.hh"
 #include <seastar/core/thread.hh>
@@ -153,6 +154,10 @@ class selection {
 
     virtual bool is_reducible() const {return false;}
 
+    // Like is_reducible(), but also accepts plain columns, which GROUP BY
+    // adds for post-processing. get_reductions() reduces them with first().
+    virtual bool is_reducible_per_group() const {return false;}
+
     virtual query::forward_request::reductions_info get_reductions() const {return {{}, {}};}
 
     /**
@@ -217,6 +222,10 @@ class result_set_builder {
         mutable uint64_t _rows_fetched_for_last_partition;
         mutable std::optional<partition_key> _last_pkey;
         mutable bool _is_first_partition_on_page = true;
+        // Restrictions of the selection's columns, indexed like selection::get_columns(),
+        // compiled on the first filtered row.
+        mutable std::vector<std::optional<expr::compiled_restriction>> _column_restrictions;
+        mutable bool _column_restrictions_compiled = false;
     public:
         explicit restrictions_filter(::shared_ptr<const restrictions::statement_restrictions> restrictions,
                 const query_options& options,
@@ -231,6 +240,7 @@ class result_set_builder {
             return _rows_dropped;
         }
     private:
+        void compile_column_restrictions(const selection& selection) const;
         bool do_filter(const selection& selection, const std::vector<bytes>& pk, const std::vector<bytes>& ck, const query::result_row_view& static_row, const query::result_row_view* row) const;
     };
 
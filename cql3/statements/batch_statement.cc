@@ -352,6 +352,15 @@ future<shared_ptr<cql_transport::messages::result_message>> batch_statement::exe
             continue;
         }
         if (request.get() == nullptr) {
+            // Bounce as soon as the partition key is known: the target shard
+            // rebuilds the whole request, and checks the remaining statements, anyway.
+            auto shard = service::storage_proxy::cas_shard(*statement.s, keys[0].start()->value().as_decorated_key().token());
+            if (shard != this_shard_id()) {
+                cached_fn_calls.merge(std::move(const_cast<cql3::query_options&>(statement_options).take_cached_pk_function_calls()));
+                return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(
+                        qp.bounce_to_shard(shard, std::move(cached_fn_calls))
+                    );
+            }
             schema = statement.s;
             request = seastar::make_shared<cas_request>(schema, std::move(keys));
         } else if (keys.size() != 1 || keys.front().equal(request->key().front(), dht::ring_position_comparator(*schema)) == false) {
@@ -367,13 +376,6 @@ future<shared_ptr<cql_transport::messages::result_message>> batch_statement::exe
         throw exceptions::invalid_request_exception(format("Unrestricted partition key in a conditional BATCH"));
     }
 
-    auto shard = service::storage_proxy::cas_shard(*_statements[0].statement->s, request->key()[0].start()->value().as_decorated_key().token());
-    if (shard != this_shard_id()) {
-        return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(
-                qp.bounce_to_shard(shard, std::move(cached_fn_calls))
-            );
-    }
-
     return qp.proxy().cas(schema, request, request->read_command(qp), request->key(),
             {read_timeout, qs.get_permit(), qs.get_client_state(), qs.get_trace_state()},
             cl_for_paxos, cl_for_learn, batch_timeout, cas_timeout).then([this, request] (bool is_applied) {
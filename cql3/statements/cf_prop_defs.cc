@@ -20,6 +20,8 @@
 #include "tombstone_gc.hh"
 #include "db/per_partition_rate_limit_extension.hh"
 #include "db/per_partition_rate_limit_options.hh"
+#include "db/commitlog_bypass_extension.hh"
+#include "locator/abstract_replication_strategy.hh"
 #include "utils/bloom_calculations.hh"
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -141,6 +143,12 @@ void cf_prop_defs::validate(const data_dictionary::database db, sstring ks_name,
     auto tombstone_gc_options = get_tombstone_gc_options(schema_extensions);
     validate_tombstone_gc_options(tombstone_gc_options, db, ks_name);
 
+    // Writes which bypass the commitlog are recovered by repair, so there must be other replicas to repair from.
+    if (get_commitlog_bypass(schema_extensions)
+            && db.find_keyspace(ks_name).get_replication_strategy().get_type() == locator::replication_strategy_type::local) {
+        throw exceptions::configuration_exception(format("{} option not supported for tables with local replication strategy", db::commitlog_bypass_extension::NAME));
+    }
+
     validate_minimum_int(KW_DEFAULT_TIME_TO_LIVE, 0, DEFAULT_DEFAULT_TIME_TO_LIVE);
     validate_minimum_int(KW_PAXOSGRACESECONDS, 0, DEFAULT_GC_GRACE_SECONDS);
 
@@ -254,6 +262,16 @@ const db::per_partition_rate_limit_options* cf_prop_defs::get_per_partition_rate
     return &ext->get_options();
 }
 
+bool cf_prop_defs::get_commitlog_bypass(const schema::extensions_map& schema_exts) const {
+    auto it = schema_exts.find(db::commitlog_bypass_extension::NAME);
+    if (it == schema_exts.end()) {
+        return false;
+    }
+
+    auto ext = dynamic_pointer_cast<db::commitlog_bypass_extension>(it->second);
+    return ext->get_commitlog_bypass();
+}
+
 void cf_prop_defs::apply_to_builder(schema_builder& builder, schema::extensions_map schema_extensions) const {
     if (has_property(KW_COMMENT)) {
         builder.set_comment(get_string(KW_COMMENT, ""));
@@ -202,9 +202,10 @@ std::vector<mutation> modification_statement::apply_updates(
 
     std::vector<mutation> mutations;
     mutations.reserve(keys.size());
-    for (auto key : keys) {
+    for (const auto& key : keys) {
         // We know key.start() must be defined since we only allow EQ relations on the partition key.
-        mutations.emplace_back(s, std::move(*key.start()->value().key()));
+        // Reuse the decorated key computed by build_partition_keys() rather than hashing the key again.
+        mutations.emplace_back(s, key.start()->value().as_decorated_key());
         auto& m = mutations.back();
         for (auto&& r : ranges) {
             this->add_update_for_key(m, r, params, json_cache);
@@ -312,12 +313,22 @@ modification_statement::execute_with_condition(query_processor& qp, service::que
 
     json_cache_opt json_cache = maybe_prepare_json_cache(options);
     std::vector<dht::partition_range> keys = build_partition_keys(options, json_cache);
-    std::vector<query::clustering_range> ranges = create_clustering_ranges(options, json_cache);
 
     if (keys.empty()) {
         throw exceptions::invalid_request_exception(format("Unrestricted partition key in a conditional {}",
                     type.is_update() ? "update" : "deletion"));
     }
+
+    // Bounce as soon as the partition key is known: the target shard rebuilds
+    // the whole request anyway.
+    auto shard = service::storage_proxy::cas_shard(*s, keys[0].start()->value().as_decorated_key().token());
+    if (shard != this_shard_id()) {
+        return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(
+                qp.bounce_to_shard(shard, std::move(const_cast<cql3::query_options&>(options).take_cached_pk_function_calls()))
+            );
+    }
+
+    std::vector<query::clustering_range> ranges = create_clustering_ranges(options, json_cache);
     if (ranges.empty()) {
         throw exceptions::invalid_request_exception(format("Unrestricted clustering key in a conditional {}",
                     type.is_update() ? "update" : "deletion"));
@@ -328,13 +339,6 @@ modification_statement::execute_with_condition(query_processor& qp, service::que
     // modification in the list of CAS commands, since we're handling single-statement execution.
     request->add_row_update(*this, std::move(ranges), std::move(json_cache), options);
 
-    auto shard = service::storage_proxy::cas_shard(*s, request->key()[0].start()->value().as_decorated_key().token());
-    if (shard != this_shard_id()) {
-        return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(
-                qp.bounce_to_shard(shard, std::move(const_cast<cql3::query_options&>(options).take_cached_pk_function_calls()))
-            );
-    }
-
     return qp.proxy().cas(s, request, request->read_command(qp), request->key(),
             {read_timeout, qs.get_permit(), qs.get_client_state(), qs.get_trace_state()},
             cl_for_paxos, cl_for_learn, statement_timeout, cas_timeout).then([this, request] (bool is_applied) {
@@ -714,18 +714,38 @@ indexed_table_select_statement::do_execute_base_query(
         auto key_it_end = key_it + next_iteration_size;
         auto command = ::make_lw_shared<query::read_command>(*cmd);
 
+        // Consecutive rows of the same partition, listed in the base clustering
+        // order, are read with a single query. This is the common case for local
+        // indexes, whose entries all belong to the restricted base partition.
+        // The results of such a query come in the same order as the keys, so
+        // a short read still leaves a valid last position for paging.
+        using key_group = std::pair<std::vector<primary_key>::iterator, std::vector<primary_key>::iterator>;
+        std::vector<key_group> key_groups;
+        const bool group_keys = !cmd->slice.is_reversed() && cmd->slice.partition_row_limit() == query::partition_max_rows;
+        for (auto it = key_it; it != key_it_end;) {
+            auto group_end = std::next(it);
+            while (group_keys && group_end != key_it_end && group_end->clustering && std::prev(group_end)->clustering
+                    && group_end->partition.equal(*_schema, it->partition)
+                    && clustering_key_prefix::tri_compare(*_schema)(std::prev(group_end)->clustering, group_end->clustering) < 0) {
+                ++group_end;
+            }
+            key_groups.emplace_back(it, group_end);
+            it = group_end;
+        }
+
         query::result_merger oneshot_merger(cmd->get_row_limit(), query::max_partitions);
-        coordinator_result<foreign_ptr<lw_shared_ptr<query::result>>> rresult = co_await utils::result_map_reduce(key_it, key_it_end, coroutine::lambda([&] (auto& key)
+        coordinator_result<foreign_ptr<lw_shared_ptr<query::result>>> rresult = co_await utils::result_map_reduce(key_groups.begin(), key_groups.end(), coroutine::lambda([&] (key_group& group)
                 -> future<coordinator_result<foreign_ptr<lw_shared_ptr<query::result>>>> {
             auto command = ::make_lw_shared<query::read_command>(*cmd);
-            // for each partition, read just one clustering row (TODO: can
-            // get all needed rows of one partition at once.)
+            // for each partition, read just the needed clustering rows
             command->slice._row_ranges.clear();
-            if (key.clustering) {
-                command->slice._row_ranges.push_back(query::clustering_range::make_singular(key.clustering));
+            for (auto it = group.first; it != group.second; ++it) {
+                if (it->clustering) {
+                    command->slice._row_ranges.push_back(query::clustering_range::make_singular(it->clustering));
+                }
             }
             coordinator_result<service::storage_proxy::coordinator_query_result> rqr
-                    = co_await qp.proxy().query_result(_schema, command, {dht::partition_range::make_singular(key.partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()});
+                    = co_await qp.proxy().query_result(_schema, command, {dht::partition_range::make_singular(group.first->partition)}, options.get_consistency(), {timeout, state.get_permit(), state.get_client_state(), state.get_trace_state()});
             if (!rqr.has_value()) {
                 co_return std::move(rqr).as_failure();
             }
@@ -1611,12 +1631,22 @@ parallelized_select_statement::do_execute(
         .timeout = timeout,
         .aggregation_infos = reductions.infos,
     };
+    if (!_group_by_cell_indices->empty()) {
+        req.group_by_column_names = boost::copy_range<std::vector<sstring>>(*_group_by_cell_indices
+                | boost::adaptors::transformed([this] (size_t idx) { return _selection->get_columns()[idx]->name_as_text(); }));
+    }
 
     // dispatch execution of this statement to other nodes
     return qp.forward(req, state.get_trace_state()).then([this] (query::forward_result res) {
         auto meta = _selection->get_result_metadata();
         auto rs = std::make_unique<result_set>(std::move(meta));
-        rs->add_row(res.query_results);
+        if (!_group_by_cell_indices->empty()) {
+            for (auto& group : res.groups) {
+                rs->add_row(std::move(group.query_results));
+            }
+        } else {
+            rs->add_row(res.query_results);
+        }
         update_stats_rows_read(rs->size());
         return shared_ptr<cql_transport::messages::result_message>(
             make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs)))
@@ -1887,6 +1917,24 @@ group_by_references_clustering_keys(const selection::selection& sel, const std::
     });
 }
 
+// Whether the GROUP BY columns are the leading primary key columns, without
+// skipping any equality-restricted ones, so that a group's key identifies its
+// partition and clustering prefix.
+static
+bool
+group_by_is_primary_key_prefix(const schema& s, const selection::selection& sel, const std::vector<size_t>& group_by_cell_indices) {
+    for (size_t i = 0; i < group_by_cell_indices.size(); ++i) {
+        auto& col = *sel.get_columns()[group_by_cell_indices[i]];
+        auto expected = i < s.partition_key_size()
+                ? std::make_pair(column_kind::partition_key, i)
+                : std::make_pair(column_kind::clustering_key, i - s.partition_key_size());
+        if (col.kind != expected.first || col.id != expected.second) {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::database db, cql_stats& stats, bool for_view) {
     schema_ptr underlying_schema = validation::validate_column_family(db, keyspace(), column_family());
     schema_ptr schema = _parameters->is_mutation_fragments() ? mutation_fragments_select_statement::generate_output_schema(underlying_schema) : underlying_schema;
@@ -1985,6 +2033,24 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
             && db.get_config().enable_parallelized_aggregation();
     };
 
+    // GROUP BY always covers the whole partition key, so every group is
+    // aggregated by the single shard owning its partition, and only the
+    // per-group partial results travel back to the coordinator.
+    auto can_be_forwarded_per_group = [&] {
+        return !group_by_cell_indices->empty()
+            && db.features().parallelized_group_by
+            && selection->is_reducible_per_group()
+            && group_by_is_primary_key_prefix(*schema, *selection, *group_by_cell_indices)
+            && !restrictions->need_filtering()  // No filtering
+            && _parameters->orderings().empty() // Groups are returned in primary key order
+            && !_parameters->is_distinct()
+            // The forwarded query reads all rows of all groups, LIMIT and
+            // PER PARTITION LIMIT are only applied by the regular path.
+            && !_limit
+            && !_per_partition_limit
+            && db.get_config().enable_parallelized_aggregation();
+    };
+
     if (_parameters->is_prune_materialized_view()) {
         stmt = ::make_shared<cql3::statements::prune_materialized_view_statement>(
                 schema,
@@ -2029,7 +2095,7 @@ std::unique_ptr<prepared_statement> select_statement::prepare(data_dictionary::d
                 prepare_limit(db, ctx, _per_partition_limit),
                 stats,
                 std::move(prepared_attrs));
-    } else if (can_be_forwarded()) {
+    } else if (can_be_forwarded() || can_be_forwarded_per_group()) {
         stmt = parallelized_select_statement::prepare(
             schema,
             ctx.bound_variables_size(),
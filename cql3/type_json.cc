@@ -17,7 +17,9 @@
 #include "types/user.hh"
 #include "types/listlike_partial_deserializing_iterator.hh"
 #include "utils/managed_bytes.hh"
+#include "bytes_ostream.hh"
 #include "exceptions/exceptions.hh"
+#include <cstring>
 #include <limits>
 #include <utility>
 #include <boost/algorithm/string/trim_all.hpp>
@@ -27,55 +29,87 @@ static inline bool is_control_char(char c) {
     return c >= 0 && c <= 0x1F;
 }
 
-static inline bool needs_escaping(const sstring& s) {
-    return std::any_of(s.begin(), s.end(), [](char c) {return is_control_char(c) || c == '"' || c == '\\';});
+static inline bool needs_escaping(char c) {
+    return is_control_char(c) || c == '"' || c == '\\';
 }
 
+// Returns the position of the first character in `s` that has to be escaped,
+// or s.size() if there is none.
+// Strings rarely need escaping, so scan 8 bytes at a time (SWAR): a word is
+// only examined byte by byte if it contains a control character, a quote or
+// a backslash.
+static size_t find_first_to_escape(std::string_view s) {
+    constexpr uint64_t ones = 0x0101010101010101;
+    constexpr uint64_t highs = 0x8080808080808080;
+    auto has_zero_byte = [] (uint64_t x) { return (x - ones) & ~x & highs; };
+    size_t pos = 0;
+    for (; pos + sizeof(uint64_t) <= s.size(); pos += sizeof(uint64_t)) {
+        uint64_t x;
+        std::memcpy(&x, s.data() + pos, sizeof(x));
+        // Bytes >= 0x80 are not control characters, ~x masks them out.
+        const auto control = (x - ones * 0x20) & ~x & highs;
+        if (control | has_zero_byte(x ^ (ones * '"')) | has_zero_byte(x ^ (ones * '\\'))) {
+            break;
+        }
+    }
+    for (; pos < s.size(); ++pos) {
+        if (needs_escaping(s[pos])) {
+            return pos;
+        }
+    }
+    return pos;
+}
 
-static sstring quote_json_string(const sstring& value) {
-    if (!needs_escaping(value)) {
-        return format("\"{}\"", value);
+static void write_escaped(bytes_ostream& out, char c) {
+    switch (c) {
+    case '"':
+        out.write("\\\"", 2);
+        break;
+    case '\\':
+        out.write("\\\\", 2);
+        break;
+    case '\b':
+        out.write("\\b", 2);
+        break;
+    case '\f':
+        out.write("\\f", 2);
+        break;
+    case '\n':
+        out.write("\\n", 2);
+        break;
+    case '\r':
+        out.write("\\r", 2);
+        break;
+    case '\t':
+        out.write("\\t", 2);
+        break;
+    default: {
+        char buf[6];
+        auto end = fmt::format_to(buf, "\\u{:04X}", static_cast<int>(c));
+        out.write(buf, end - buf);
+        break;
     }
-    std::ostringstream oss;
-    oss << std::hex << std::uppercase << std::setfill('0');
-    oss.put('"');
-    for (char c : value) {
-        switch (c) {
-        case '"':
-            oss.put('\\').put('"');
-            break;
-        case '\\':
-            oss.put('\\').put('\\');
-            break;
-        case '\b':
-            oss.put('\\').put('b');
-            break;
-        case '\f':
-            oss.put('\\').put('f');
-            break;
-        case '\n':
-            oss.put('\\').put('n');
-            break;
-        case '\r':
-            oss.put('\\').put('r');
-            break;
-        case '\t':
-            oss.put('\\').put('t');
-            break;
-        default:
-            if (is_control_char(c)) {
-                oss.put('\\').put('u') << std::setw(4) << static_cast<int>(c);
-            } else {
-                oss.put(c);
-            }
+    }
+}
+
+static void write(bytes_ostream& out, std::string_view s) {
+    out.write(s.data(), s.size());
+}
+
+static void write_quoted_json_string(bytes_ostream& out, std::string_view value) {
+    out.write("\"", 1);
+    while (!value.empty()) {
+        auto pos = find_first_to_escape(value);
+        write(out, value.substr(0, pos));
+        if (pos == value.size()) {
             break;
         }
+        write_escaped(out, value[pos]);
+        value.remove_prefix(pos + 1);
     }
-    oss.put('"');
-    return oss.str();
+    out.write("\"", 1);
 }
 
-
 template <typename T> static T to_int(const rjson::value& value) {
     int64_t result;
 
@@ -347,195 +381,228 @@ template <typename T> static T compose_value(const integer_type_impl<T>& t, byte
     return read_be<T>(reinterpret_cast<const char*>(bv.data()));
 }
 
-static sstring to_json_string_aux(const map_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
+static void write_json(bytes_ostream& out, const abstract_type& t, bytes_view bv);
+
+static void write_json(bytes_ostream& out, const abstract_type& t, const managed_bytes_view& mbv) {
+    if (mbv.is_linearized()) {
+        write_json(out, t, mbv.current_fragment());
+    } else {
+        write_json(out, t, linearized(mbv));
+    }
+}
 
-    out << '{';
+static void write_json_aux(bytes_ostream& out, const map_type_impl& t, bytes_view bv) {
+    out.write("{", 1);
     auto size = read_collection_size(bv);
+    bytes_ostream key;
     for (int i = 0; i < size; ++i) {
         auto kb = read_collection_key(bv);
         auto vb = read_collection_value_nonnull(bv);
 
         if (i > 0) {
-            out << ", ";
+            out.write(", ", 2);
         }
 
         // Valid keys in JSON map must be quoted strings
-        sstring string_key = to_json_string(*t.get_keys_type(), kb);
-        bool is_unquoted = string_key.empty() || string_key[0] != '"';
+        key.clear();
+        write_json(key, *t.get_keys_type(), kb);
+        bool is_unquoted = key.size_bytes() == 0 || (*key.begin())[0] != '"';
         if (is_unquoted) {
-            out << '"';
+            out.write("\"", 1);
+        }
+        for (bytes_view frag : key) {
+            out.write(frag);
         }
-        out << string_key;
         if (is_unquoted) {
-            out << '"';
+            out.write("\"", 1);
         }
-        out << ": ";
-        out << to_json_string(*t.get_values_type(), vb);
+        out.write(": ", 2);
+        write_json(out, *t.get_values_type(), vb);
     }
-    out << '}';
-    return out.str();
+    out.write("}", 1);
 }
 
-static sstring to_json_string_aux(const set_type_impl& t, bytes_view bv) {
+static void write_json_listlike(bytes_ostream& out, const abstract_type& elements_type, bytes_view bv) {
     using llpdi = listlike_partial_deserializing_iterator;
-    std::ostringstream out;
     bool first = true;
-    out << '[';
+    out.write("[", 1);
     managed_bytes_view mbv(bv);
-    std::for_each(llpdi::begin(mbv), llpdi::end(mbv), [&first, &out, &t] (const managed_bytes_view_opt& e) {
+    std::for_each(llpdi::begin(mbv), llpdi::end(mbv), [&first, &out, &elements_type] (const managed_bytes_view_opt& e) {
         if (first) {
             first = false;
         } else {
-            out << ", ";
+            out.write(", ", 2);
         }
         if (e) {
-            out << to_json_string(*t.get_elements_type(), *e);
+            write_json(out, elements_type, *e);
         } else {
             // Impossible in sets, but let's not insist here.
-            out << "null";
+            out.write("null", 4);
         }
     });
-    out << ']';
-    return out.str();
+    out.write("]", 1);
 }
 
-static sstring to_json_string_aux(const list_type_impl& t, bytes_view bv) {
-    using llpdi = listlike_partial_deserializing_iterator;
-    std::ostringstream out;
-    bool first = true;
-    out << '[';
-    managed_bytes_view mbv(bv);
-    std::for_each(llpdi::begin(mbv), llpdi::end(mbv), [&first, &out, &t] (const managed_bytes_view_opt& e) {
-        if (first) {
-            first = false;
-        } else {
-            out << ", ";
-        }
-        if (e) {
-            out << to_json_string(*t.get_elements_type(), *e);
-        } else {
-            out << "null";
-        }
-    });
-    out << ']';
-    return out.str();
-}
-
-static sstring to_json_string_aux(const tuple_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
-    out << '[';
+static void write_json_aux(bytes_ostream& out, const tuple_type_impl& t, bytes_view bv) {
+    out.write("[", 1);
 
     auto ti = t.all_types().begin();
     auto vi = tuple_deserializing_iterator::start(bv);
     while (ti != t.all_types().end() && vi != tuple_deserializing_iterator::finish(bv)) {
         if (ti != t.all_types().begin()) {
-            out << ", ";
+            out.write(", ", 2);
         }
         if (*vi) {
-            // TODO(sarna): We can avoid copying if to_json_string accepted bytes_view
-            out << to_json_string(**ti, **vi);
+            write_json(out, **ti, **vi);
         } else {
-            out << "null";
+            out.write("null", 4);
         }
         ++ti;
         ++vi;
     }
 
-    out << ']';
-    return out.str();
+    out.write("]", 1);
 }
 
-static sstring to_json_string_aux(const user_type_impl& t, bytes_view bv) {
-    std::ostringstream out;
-    out << '{';
+static void write_json_aux(bytes_ostream& out, const user_type_impl& t, bytes_view bv) {
+    out.write("{", 1);
 
     auto ti = t.all_types().begin();
     auto vi = tuple_deserializing_iterator::start(bv);
     int i = 0;
     while (ti != t.all_types().end() && vi != tuple_deserializing_iterator::finish(bv)) {
         if (ti != t.all_types().begin()) {
-            out << ", ";
+            out.write(", ", 2);
         }
-        out << quote_json_string(t.field_name_as_string(i)) << ": ";
+        write_quoted_json_string(out, t.field_name_as_string(i));
+        out.write(": ", 2);
         if (*vi) {
-            //TODO(sarna): We can avoid copying if to_json_string accepted bytes_view
-            out << to_json_string(**ti, **vi);
+            write_json(out, **ti, **vi);
         } else {
-            out << "null";
+            out.write("null", 4);
         }
         ++ti;
         ++i;
         ++vi;
     }
 
-    out << '}';
-    return out.str();
+    out.write("}", 1);
+}
+
+static void write_hex_json_string(bytes_ostream& out, bytes_view bv) {
+    static constexpr char digits[] = "0123456789abcdef";
+    out.write("\"0x", 3);
+    char buf[256];
+    while (!bv.empty()) {
+        auto n = std::min(bv.size(), sizeof(buf) / 2);
+        for (size_t i = 0; i < n; ++i) {
+            auto b = static_cast<uint8_t>(bv[i]);
+            buf[2 * i] = digits[b >> 4];
+            buf[2 * i + 1] = digits[b & 0xf];
+        }
+        out.write(buf, 2 * n);
+        bv.remove_prefix(n);
+    }
+    out.write("\"", 1);
 }
 
 namespace {
-struct to_json_string_visitor {
+struct to_json_visitor {
+    bytes_ostream& out;
     bytes_view bv;
-    sstring operator()(const reversed_type_impl& t) { return to_json_string(*t.underlying_type(), bv); }
-    template <typename T> sstring operator()(const integer_type_impl<T>& t) { return to_sstring(compose_value(t, bv)); }
-    template <typename T> sstring operator()(const floating_type_impl<T>& t) {
+    void operator()(const reversed_type_impl& t) { write_json(out, *t.underlying_type(), bv); }
+    template <typename T> void operator()(const integer_type_impl<T>& t) {
+        char buf[32];
+        auto end = fmt::format_to(buf, "{}", compose_value(t, bv));
+        out.write(buf, end - buf);
+    }
+    template <typename T> void operator()(const floating_type_impl<T>& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
         T d = value_cast<T>(v);
         if (std::isnan(d) || std::isinf(d)) {
-            return "null";
-        }
-        return to_sstring(d);
-    }
-    sstring operator()(const uuid_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const inet_addr_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const string_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const bytes_type_impl& t) { return quote_json_string("0x" + t.to_string(bv)); }
-    sstring operator()(const boolean_type_impl& t) { return t.to_string(bv); }
-    sstring operator()(const timestamp_date_base_class& t) { return quote_json_string(timestamp_to_json_string(t, bv)); }
-    sstring operator()(const timeuuid_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const map_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const set_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const list_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const tuple_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const user_type_impl& t) { return to_json_string_aux(t, bv); }
-    sstring operator()(const simple_date_type_impl& t) { return quote_json_string(t.to_string(bv)); }
-    sstring operator()(const time_type_impl& t) { return t.to_string(bv); }
-    sstring operator()(const empty_type_impl& t) { return "null"; }
-    sstring operator()(const duration_type_impl& t) {
+            out.write("null", 4);
+            return;
+        }
+        write(out, to_sstring(d));
+    }
+    void operator()(const uuid_type_impl& t) { write_quoted_json_string(out, t.to_string(bv)); }
+    void operator()(const inet_addr_type_impl& t) { write_quoted_json_string(out, t.to_string(bv)); }
+    void operator()(const string_type_impl& t) {
+        // Text is stored as is, so quote it straight from the serialized value.
+        write_quoted_json_string(out, std::string_view(reinterpret_cast<const char*>(bv.data()), bv.size()));
+    }
+    void operator()(const bytes_type_impl& t) { write_hex_json_string(out, bv); }
+    void operator()(const boolean_type_impl& t) { write(out, t.to_string(bv)); }
+    void operator()(const timestamp_date_base_class& t) { write_quoted_json_string(out, timestamp_to_json_string(t, bv)); }
+    void operator()(const timeuuid_type_impl& t) { write_quoted_json_string(out, t.to_string(bv)); }
+    void operator()(const map_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const set_type_impl& t) { write_json_listlike(out, *t.get_elements_type(), bv); }
+    void operator()(const list_type_impl& t) { write_json_listlike(out, *t.get_elements_type(), bv); }
+    void operator()(const tuple_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const user_type_impl& t) { write_json_aux(out, t, bv); }
+    void operator()(const simple_date_type_impl& t) { write_quoted_json_string(out, t.to_string(bv)); }
+    void operator()(const time_type_impl& t) { write(out, t.to_string(bv)); }
+    void operator()(const empty_type_impl& t) { out.write("null", 4); }
+    void operator()(const duration_type_impl& t) {
         auto v = t.deserialize(bv);
         if (v.is_null()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
-        return quote_json_string(t.to_string(bv));
+        write_quoted_json_string(out, t.to_string(bv));
     }
-    sstring operator()(const counter_type_impl& t) {
+    void operator()(const counter_type_impl& t) {
         // It will be called only from cql3 layer while processing query results.
-        return to_json_string(*counter_cell_view::total_value_type(), bv);
+        write_json(out, *counter_cell_view::total_value_type(), bv);
     }
-    sstring operator()(const decimal_type_impl& t) {
+    void operator()(const decimal_type_impl& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
-        return value_cast<big_decimal>(v).to_string();
+        write(out, value_cast<big_decimal>(v).to_string());
     }
-    sstring operator()(const varint_type_impl& t) {
+    void operator()(const varint_type_impl& t) {
         if (bv.empty()) {
             throw exceptions::invalid_request_exception("Cannot create JSON string - deserialization error");
         }
         auto v = t.deserialize(bv);
-        return value_cast<utils::multiprecision_int>(v).str();
+        write(out, value_cast<utils::multiprecision_int>(v).str());
     }
 };
 }
 
+static void write_json(bytes_ostream& out, const abstract_type& t, bytes_view bv) {
+    visit(t, to_json_visitor{out, bv});
+}
+
+void to_json_string(bytes_ostream& out, const abstract_type& t, bytes_view bv) {
+    write_json(out, t, bv);
+}
+
+void to_json_string(bytes_ostream& out, const abstract_type& t, const managed_bytes_view& mbv) {
+    write_json(out, t, mbv);
+}
+
+static sstring to_json_sstring(const bytes_ostream& out) {
+    sstring ret(sstring::initialized_later(), out.size_bytes());
+    auto p = ret.begin();
+    for (bytes_view frag : out) {
+        p = std::copy(frag.begin(), frag.end(), p);
+    }
+    return ret;
+}
+
 sstring to_json_string(const abstract_type& t, bytes_view bv) {
-    return visit(t, to_json_string_visitor{bv});
+    bytes_ostream out;
+    write_json(out, t, bv);
+    return to_json_sstring(out);
 }
 
 sstring to_json_string(const abstract_type& t, const managed_bytes_view& mbv) {
-    return visit(t, to_json_string_visitor{linearized(mbv)});
+    bytes_ostream out;
+    write_json(out, t, mbv);
+    return to_json_sstring(out);
 }
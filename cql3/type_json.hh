@@ -10,11 +10,17 @@
 
 #include "types/types.hh"
 #include "utils/rjson.hh"
+#include "bytes_ostream.hh"
 
 bytes from_json_object(const abstract_type &t, const rjson::value& value);
 sstring to_json_string(const abstract_type &t, bytes_view bv);
 sstring to_json_string(const abstract_type &t, const managed_bytes_view& bv);
 
+// Appends the JSON representation of the value to `out`, without building
+// intermediate strings for nested values.
+void to_json_string(bytes_ostream& out, const abstract_type& t, bytes_view bv);
+void to_json_string(bytes_ostream& out, const abstract_type& t, const managed_bytes_view& bv);
+
 inline sstring to_json_string(const abstract_type &t, const bytes& b) {
     return to_json_string(t, bytes_view(b));
 }
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "db/absent_partition_store.hh"
+#include "schema/schema.hh"
+#include "utils/allocation_strategy.hh"
+
+// The row cache calls into the store under its own allocator, so keys are
+// copied and destroyed explicitly in the standard one.
+
+absent_partition_store::~absent_partition_store() {
+    clear();
+}
+
+void absent_partition_store::erase(partitions_type& partitions, partitions_type::iterator it) noexcept {
+    entry& e = it->second;
+    _memory_usage -= e.memory_usage();
+    _lru.erase(_lru.iterator_to(e));
+    with_allocator(standard_allocator(), [&] {
+        partitions.erase(it);
+    });
+}
+
+void absent_partition_store::shrink(size_t capacity) noexcept {
+    while (_memory_usage > capacity && !_lru.empty()) {
+        entry& e = _lru.front();
+        auto& partitions = _tables.at(e._table);
+        auto [it, end] = partitions.equal_range(e._key.token());
+        while (&it->second != &e) {
+            ++it;
+        }
+        erase(partitions, it);
+        ++_stats.evictions;
+    }
+}
+
+absent_partition_store::partitions_type::iterator
+absent_partition_store::find(partitions_type& partitions, const schema& s, const dht::decorated_key& dk) noexcept {
+    auto [it, end] = partitions.equal_range(dk.token());
+    while (it != end && !it->second._key.equal(s, dk)) {
+        ++it;
+    }
+    return it == end ? partitions.end() : it;
+}
+
+void absent_partition_store::insert(const schema& s, const dht::decorated_key& dk, size_t capacity) {
+    auto& partitions = _tables[s.id()];
+    if (auto it = find(partitions, s, dk); it != partitions.end()) {
+        _lru.erase(_lru.iterator_to(it->second));
+        _lru.push_back(it->second);
+        return;
+    }
+    auto it = with_allocator(standard_allocator(), [&] {
+        return partitions.emplace(dk.token(), entry{
+            ._table = s.id(),
+            ._key = dk,
+        });
+    });
+    _lru.push_back(it->second);
+    _memory_usage += it->second.memory_usage();
+    ++_stats.insertions;
+    shrink(capacity);
+}
+
+bool absent_partition_store::contains(const schema& s, const dht::decorated_key& dk) noexcept {
+    auto t = _tables.find(s.id());
+    if (t == _tables.end()) {
+        return false;
+    }
+    auto it = find(t->second, s, dk);
+    if (it == t->second.end()) {
+        return false;
+    }
+    _lru.erase(_lru.iterator_to(it->second));
+    _lru.push_back(it->second);
+    ++_stats.hits;
+    return true;
+}
+
+void absent_partition_store::invalidate(const schema& s, const dht::decorated_key& dk) noexcept {
+    auto t = _tables.find(s.id());
+    if (t == _tables.end()) {
+        return;
+    }
+    if (auto it = find(t->second, s, dk); it != t->second.end()) {
+        erase(t->second, it);
+        ++_stats.invalidations;
+    }
+}
+
+void absent_partition_store::invalidate(table_id table, const dht::partition_range& range) noexcept {
+    auto t = _tables.find(table);
+    if (t == _tables.end()) {
+        return;
+    }
+    // Conservative, drops all entries whose tokens fall into the range.
+    auto& partitions = t->second;
+    auto it = range.start() ? partitions.lower_bound(range.start()->value().token()) : partitions.begin();
+    auto end = range.end() ? partitions.upper_bound(range.end()->value().token()) : partitions.end();
+    while (it != end) {
+        erase(partitions, it++);
+        ++_stats.invalidations;
+    }
+}
+
+void absent_partition_store::clear(table_id table) noexcept {
+    auto t = _tables.find(table);
+    if (t == _tables.end()) {
+        return;
+    }
+    auto& partitions = t->second;
+    while (!partitions.empty()) {
+        erase(partitions, partitions.begin());
+    }
+    _tables.erase(t);
+}
+
+void absent_partition_store::clear() noexcept {
+    for (auto& [table, partitions] : _tables) {
+        while (!partitions.empty()) {
+            erase(partitions, partitions.begin());
+        }
+    }
+    _tables.clear();
+}
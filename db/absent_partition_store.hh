@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <boost/intrusive/list.hpp>
+
+#include <map>
+#include <unordered_map>
+
+#include "dht/i_partitioner.hh"
+#include "schema/schema_fwd.hh"
+
+// Remembers the keys of partitions which single-partition reads found missing in
+// the underlying mutation source of the row cache, see row_cache::make_reader().
+//
+// The cache can tell that a key is absent only through the continuity of the entries
+// around it, which lookups of random keys don't leave behind, and an empty cache_entry
+// per absent key takes far more memory than the key itself. So with the store enabled,
+// reads which find a partition missing record its key here instead, and the next
+// single-partition read of it is answered without going to sstables.
+//
+// Like compressed_partition_store, the store doesn't follow changes to the underlying
+// mutation source by itself. row_cache drops the keys of partitions which it merges from
+// memtables or invalidates, so a key is in the store only while it's absent from the
+// current snapshot of the source.
+//
+// Entries live in the standard allocator. When the store grows above the capacity
+// it's given, the least recently used keys are dropped.
+class absent_partition_store {
+public:
+    struct stats {
+        uint64_t insertions = 0;
+        uint64_t hits = 0;
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;
+    };
+private:
+    struct entry {
+        boost::intrusive::list_member_hook<> _lru_link;
+        table_id _table;
+        dht::decorated_key _key;
+
+        size_t memory_usage() const noexcept {
+            return sizeof(entry) + _key.external_memory_usage();
+        }
+    };
+    using partitions_type = std::multimap<dht::token, entry>;
+    using lru_type = boost::intrusive::list<entry,
+        boost::intrusive::member_hook<entry, boost::intrusive::list_member_hook<>, &entry::_lru_link>>;
+
+    std::unordered_map<table_id, partitions_type> _tables;
+    lru_type _lru;
+    size_t _memory_usage = 0;
+    stats _stats;
+private:
+    void erase(partitions_type& partitions, partitions_type::iterator it) noexcept;
+    void shrink(size_t capacity) noexcept;
+    partitions_type::iterator find(partitions_type& partitions, const schema& s, const dht::decorated_key& dk) noexcept;
+public:
+    absent_partition_store() = default;
+    absent_partition_store(absent_partition_store&&) = delete;
+    ~absent_partition_store();
+
+    // Records that the partition of the table of s is absent from the cache's underlying source.
+    // Then drops the least recently used entries until memory_usage() is within capacity.
+    void insert(const schema& s, const dht::decorated_key& dk, size_t capacity);
+
+    // Whether the partition is known to be absent.
+    bool contains(const schema& s, const dht::decorated_key& dk) noexcept;
+
+    // Drops the entries of the given table which fall into the range.
+    void invalidate(const schema& s, const dht::decorated_key& dk) noexcept;
+    void invalidate(table_id, const dht::partition_range&) noexcept;
+
+    void clear(table_id) noexcept;
+    void clear() noexcept;
+
+    size_t memory_usage() const noexcept { return _memory_usage; }
+    size_t size() const noexcept { return _lru.size(); }
+    const stats& get_stats() const noexcept { return _stats; }
+};
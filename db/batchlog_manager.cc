@@ -135,10 +135,13 @@ future<> db::batchlog_manager::stop() {
 }
 
 future<size_t> db::batchlog_manager::count_all_batches() const {
-    sstring query = format("SELECT count(*) FROM {}.{}", system_keyspace::NAME, system_keyspace::BATCHLOG);
-    return _qp.execute_internal(query, cql3::query_processor::cache_internal::yes).then([](::shared_ptr<cql3::untyped_result_set> rs) {
-       return size_t(rs->one().get_as<int64_t>("count"));
-    });
+    size_t count = 0;
+    for (auto table : {system_keyspace::BATCHLOG, system_keyspace::BATCHLOG_V2}) {
+        sstring query = format("SELECT count(*) FROM {}.{}", system_keyspace::NAME, table);
+        auto rs = co_await _qp.execute_internal(query, cql3::query_processor::cache_internal::yes);
+        count += rs->one().get_as<int64_t>("count");
+    }
+    co_return count;
 }
 
 db_clock::duration db::batchlog_manager::get_batch_log_timeout() const {
@@ -146,160 +149,200 @@ db_clock::duration db::batchlog_manager::get_batch_log_timeout() const {
     return _write_request_timeout * 2;
 }
 
-future<> db::batchlog_manager::replay_all_failed_batches() {
-    typedef db_clock::rep clock_type;
+db_clock::time_point db::batchlog_manager::segment_of(db_clock::time_point written_at) {
+    return written_at - written_at.time_since_epoch() % segment_duration;
+}
 
-    // rate limit is in bytes per second. Uses Double.MAX_VALUE if disabled (set to 0 in cassandra.yaml).
-    // max rate is scaled by the number of nodes in the cluster (same as for HHOM - see CASSANDRA-5272).
-    auto throttle = _replay_rate / _qp.proxy().get_token_metadata_ptr()->count_normal_token_owners();
-    auto limiter = make_lw_shared<utils::rate_limiter>(throttle);
+mutation db::batchlog_manager::make_delete_mutation(schema_ptr s, int32_t shard, db_clock::time_point written_at, const utils::UUID& id, api::timestamp_type now) {
+    auto key = partition_key::from_exploded(*s, {int32_type->decompose(shard), timestamp_type->decompose(segment_of(written_at))});
+    auto ckey = clustering_key::from_exploded(*s, {timestamp_type->decompose(written_at), uuid_type->decompose(id)});
+    mutation m(s, key);
+    m.partition().apply_delete(*s, ckey, tombstone(now, gc_clock::now()));
+    return m;
+}
 
-    auto batch = [this, limiter](const cql3::untyped_result_set::row& row) {
-        auto written_at = row.get_as<db_clock::time_point>("written_at");
-        auto id = row.get_as<utils::UUID>("id");
-        // enough time for the actual write + batchlog entry mutation delivery (two separate requests).
-        auto timeout = get_batch_log_timeout();
-        if (db_clock::now() < written_at + timeout) {
-            blogger.debug("Skipping replay of {}, too fresh", id);
-            return make_ready_future<>();
-        }
+mutation db::batchlog_manager::make_legacy_delete_mutation(schema_ptr s, const utils::UUID& id, api::timestamp_type now) {
+    auto key = partition_key::from_singular(*s, id);
+    mutation m(s, key);
+    m.partition().apply_delete(*s, clustering_key_prefix::make_empty(), tombstone(now, gc_clock::now()));
+    return m;
+}
 
-        // check version of serialization format
-        if (!row.has("version")) {
-            blogger.warn("Skipping logged batch because of unknown version");
-            return make_ready_future<>();
-        }
+future<db::batchlog_manager::replay_status> db::batchlog_manager::replay_batch(utils::UUID id, db_clock::time_point written_at, std::optional<int32_t> version, bytes data, utils::rate_limiter& limiter) {
+    typedef db_clock::rep clock_type;
 
-        auto version = row.get_as<int32_t>("version");
-        if (version != netw::messaging_service::current_version) {
-            blogger.warn("Skipping logged batch because of incorrect version");
-            return make_ready_future<>();
-        }
+    // enough time for the actual write + batchlog entry mutation delivery (two separate requests).
+    auto timeout = get_batch_log_timeout();
+    if (db_clock::now() < written_at + timeout) {
+        blogger.debug("Skipping replay of {}, too fresh", id);
+        co_return replay_status::kept;
+    }
 
-        auto data = row.get_blob("data");
+    // check version of serialization format
+    if (!version) {
+        blogger.warn("Skipping logged batch because of unknown version");
+        co_return replay_status::kept;
+    }
+    if (*version != netw::messaging_service::current_version) {
+        blogger.warn("Skipping logged batch because of incorrect version");
+        co_return replay_status::kept;
+    }
 
-        blogger.debug("Replaying batch {}", id);
+    blogger.debug("Replaying batch {}", id);
 
-        auto fms = make_lw_shared<std::deque<canonical_mutation>>();
+    try {
+        std::vector<mutation> mutations;
         auto in = ser::as_input_stream(data);
         while (in.size()) {
-            fms->emplace_back(ser::deserialize(in, boost::type<canonical_mutation>()));
-        }
-
-        auto size = data.size();
-
-        return map_reduce(*fms, [this, written_at] (canonical_mutation& fm) {
+            auto fm = ser::deserialize(in, boost::type<canonical_mutation>());
             const auto& cf = _qp.proxy().local_db().find_column_family(fm.column_family_id());
-            return make_ready_future<canonical_mutation*>(written_at > cf.get_truncation_time() ? &fm : nullptr);
-        },
-        std::vector<mutation>(),
-        [this] (std::vector<mutation> mutations, canonical_mutation* fm) {
-            if (fm) {
-                schema_ptr s = _qp.db().find_schema(fm->column_family_id());
-                mutations.emplace_back(fm->to_mutation(s));
+            if (written_at > cf.get_truncation_time()) {
+                mutations.emplace_back(fm.to_mutation(cf.schema()));
             }
-            return mutations;
-        }).then([this, limiter, written_at, size, fms] (std::vector<mutation> mutations) {
-            if (mutations.empty()) {
-                return make_ready_future<>();
-            }
-            const auto ttl = [written_at]() -> clock_type {
-                /*
-                 * Calculate ttl for the mutations' hints (and reduce ttl by the time the mutations spent in the batchlog).
-                 * This ensures that deletes aren't "undone" by an old batch replay.
-                 */
-                auto unadjusted_ttl = std::numeric_limits<gc_clock::rep>::max();
-                warn(unimplemented::cause::HINT);
+        }
+        if (mutations.empty()) {
+            co_return replay_status::replayed;
+        }
+
+        const auto ttl = [written_at]() -> clock_type {
+            /*
+             * Calculate ttl for the mutations' hints (and reduce ttl by the time the mutations spent in the batchlog).
+             * This ensures that deletes aren't "undone" by an old batch replay.
+             */
+            auto unadjusted_ttl = std::numeric_limits<gc_clock::rep>::max();
+            warn(unimplemented::cause::HINT);
 #if 0
-                for (auto& m : *mutations) {
-                    unadjustedTTL = Math.min(unadjustedTTL, HintedHandOffManager.calculateHintTTL(mutation));
-                }
+            for (auto& m : *mutations) {
+                unadjustedTTL = Math.min(unadjustedTTL, HintedHandOffManager.calculateHintTTL(mutation));
+            }
 #endif
-                return unadjusted_ttl - std::chrono::duration_cast<gc_clock::duration>(db_clock::now() - written_at).count();
-            }();
+            return unadjusted_ttl - std::chrono::duration_cast<gc_clock::duration>(db_clock::now() - written_at).count();
+        }();
 
-            if (ttl <= 0) {
-                return make_ready_future<>();
-            }
-            // Origin does the send manually, however I can't see a super great reason to do so.
-            // Our normal write path does not add much redundancy to the dispatch, and rate is handled after send
-            // in both cases.
-            // FIXME: verify that the above is reasonably true.
-            return limiter->reserve(size).then([this, mutations = std::move(mutations)] {
-                _stats.write_attempts += mutations.size();
-                // #1222 - change cl level to ALL, emulating origins behaviour of sending/hinting
-                // to all natural end points.
-                // Note however that origin uses hints here, and actually allows for this
-                // send to partially or wholly fail in actually sending stuff. Since we don't
-                // have hints (yet), send with CL=ALL, and hope we can re-do this soon.
-                // See below, we use retry on write failure.
-                return _qp.proxy().mutate(mutations, db::consistency_level::ALL, db::no_timeout, nullptr, empty_service_permit(), db::allow_per_partition_rate_limit::no);
-            });
-        }).then_wrapped([this, id](future<> batch_result) {
-            try {
-                batch_result.get();
-            } catch (data_dictionary::no_such_keyspace& ex) {
-                // should probably ignore and drop the batch
-            } catch (...) {
-                blogger.warn("Replay failed (will retry): {}", std::current_exception());
-                // timeout, overload etc.
-                // Do _not_ remove the batch, assuning we got a node write error.
-                // Since we don't have hints (which origin is satisfied with),
-                // we have to resort to keeping this batch to next lap.
+        if (ttl <= 0) {
+            co_return replay_status::replayed;
+        }
+        // Origin does the send manually, however I can't see a super great reason to do so.
+        // Our normal write path does not add much redundancy to the dispatch, and rate is handled after send
+        // in both cases.
+        // FIXME: verify that the above is reasonably true.
+        co_await limiter.reserve(data.size());
+        _stats.write_attempts += mutations.size();
+        // #1222 - change cl level to ALL, emulating origins behaviour of sending/hinting
+        // to all natural end points.
+        // Note however that origin uses hints here, and actually allows for this
+        // send to partially or wholly fail in actually sending stuff. Since we don't
+        // have hints (yet), send with CL=ALL, and hope we can re-do this soon.
+        // See below, we use retry on write failure.
+        co_await _qp.proxy().mutate(std::move(mutations), db::consistency_level::ALL, db::no_timeout, nullptr, empty_service_permit(), db::allow_per_partition_rate_limit::no);
+    } catch (data_dictionary::no_such_keyspace& ex) {
+        // should probably ignore and drop the batch
+    } catch (...) {
+        blogger.warn("Replay failed (will retry): {}", std::current_exception());
+        // timeout, overload etc.
+        // Do _not_ remove the batch, assuning we got a node write error.
+        // Since we don't have hints (which origin is satisfied with),
+        // we have to resort to keeping this batch to next lap.
+        co_return replay_status::kept;
+    }
+    co_return replay_status::replayed;
+}
+
+future<> db::batchlog_manager::replay_legacy_batches(utils::rate_limiter& limiter) {
+    auto schema = _qp.db().find_schema(system_keyspace::NAME, system_keyspace::BATCHLOG);
+    auto batch = [this, &limiter, schema] (const cql3::untyped_result_set::row& row) {
+        auto id = row.get_as<utils::UUID>("id");
+        auto version = row.has("version") ? std::make_optional(row.get_as<int32_t>("version")) : std::nullopt;
+        return replay_batch(id, row.get_as<db_clock::time_point>("written_at"), version, row.get_blob("data"), limiter).then([this, schema, id] (replay_status status) {
+            if (status == replay_status::kept) {
                 return make_ready_future<>();
             }
             // delete batch
-            auto schema = _qp.db().find_schema(system_keyspace::NAME, system_keyspace::BATCHLOG);
-            auto key = partition_key::from_singular(*schema, id);
-            mutation m(schema, key);
             auto now = service::client_state(service::client_state::internal_tag()).get_timestamp();
-            m.partition().apply_delete(*schema, clustering_key_prefix::make_empty(), tombstone(now, gc_clock::now()));
-            return _qp.proxy().mutate_locally(m, tracing::trace_state_ptr(), db::commitlog::force_sync::no);
+            return _qp.proxy().mutate_locally(make_legacy_delete_mutation(schema, id, now), tracing::trace_state_ptr(), db::commitlog::force_sync::no);
         });
     };
 
-    return seastar::with_gate(_gate, [this, batch = std::move(batch)] {
-        blogger.debug("Started replayAllFailedBatches (cpu {})", this_shard_id());
-
-        typedef ::shared_ptr<cql3::untyped_result_set> page_ptr;
-        sstring query = format("SELECT id, data, written_at, version FROM {}.{} LIMIT {:d}", system_keyspace::NAME, system_keyspace::BATCHLOG, page_size);
-        return _qp.execute_internal(query, cql3::query_processor::cache_internal::yes).then([this, batch = std::move(batch)](page_ptr page) {
-            return do_with(std::move(page), [this, batch = std::move(batch)](page_ptr & page) mutable {
-                return repeat([this, &page, batch = std::move(batch)]() mutable {
-                    if (page->empty()) {
-                        return make_ready_future<stop_iteration>(stop_iteration::yes);
-                    }
-                    auto id = page->back().get_as<utils::UUID>("id");
-                    return parallel_for_each(*page, batch).then([this, &page, id]() {
-                        if (page->size() < page_size) {
-                            return make_ready_future<stop_iteration>(stop_iteration::yes); // we've exhausted the batchlog, next query would be empty.
-                        }
-                        sstring query = format("SELECT id, data, written_at, version FROM {}.{} WHERE token(id) > token(?) LIMIT {:d}",
-                                system_keyspace::NAME,
-                                system_keyspace::BATCHLOG,
-                                page_size);
-                        return _qp.execute_internal(query, {id}, cql3::query_processor::cache_internal::yes).then([&page](auto res) {
-                                    page = std::move(res);
-                                    return make_ready_future<stop_iteration>(stop_iteration::no);
-                                });
-                    });
-                });
-            });
-        }).then([] {
-        // TODO FIXME : cleanup()
-#if 0
-            ColumnFamilyStore cfs = Keyspace.open(SystemKeyspace.NAME).getColumnFamilyStore(SystemKeyspace.BATCHLOG);
-            cfs.forceBlockingFlush();
-            Collection<Descriptor> descriptors = new ArrayList<>();
-            for (SSTableReader sstr : cfs.getSSTables())
-            descriptors.add(sstr.descriptor);
-            if (!descriptors.isEmpty()) // don't pollute the logs if there is nothing to compact.
-            CompactionManager.instance.submitUserDefined(cfs, descriptors, Integer.MAX_VALUE).get();
-
-#endif
+    sstring query = format("SELECT id, data, written_at, version FROM {}.{} LIMIT {:d}", system_keyspace::NAME, system_keyspace::BATCHLOG, page_size);
+    auto page = co_await _qp.execute_internal(query, cql3::query_processor::cache_internal::yes);
+    while (!page->empty()) {
+        auto id = page->back().get_as<utils::UUID>("id");
+        co_await parallel_for_each(*page, batch);
+        if (page->size() < page_size) {
+            break; // we've exhausted the batchlog, next query would be empty.
+        }
+        query = format("SELECT id, data, written_at, version FROM {}.{} WHERE token(id) > token(?) LIMIT {:d}",
+                system_keyspace::NAME,
+                system_keyspace::BATCHLOG,
+                page_size);
+        page = co_await _qp.execute_internal(query, {id}, cql3::query_processor::cache_internal::yes);
+    }
+}
 
-        }).then([] {
-            blogger.debug("Finished replayAllFailedBatches");
+future<> db::batchlog_manager::replay_segment(utils::rate_limiter& limiter, schema_ptr schema, int32_t shard, db_clock::time_point segment) {
+    auto batch = [&] (const cql3::untyped_result_set::row& row) {
+        auto written_at = row.get_as<db_clock::time_point>("written_at");
+        auto id = row.get_as<utils::UUID>("id");
+        auto ts = row.get_as<int64_t>("ts");
+        auto version = row.has("version") ? std::make_optional(row.get_as<int32_t>("version")) : std::nullopt;
+        return replay_batch(id, written_at, version, row.get_blob("data"), limiter).then([this, schema, shard, written_at, id, ts] (replay_status status) {
+            if (status == replay_status::kept) {
+                return make_ready_future<>();
+            }
+            // Several coordinators share the segment, so only the replayed entry
+            // is deleted. The tombstone carries its own write timestamp rather
+            // than this node's clock, so it covers the entry no matter how the
+            // clocks of the two nodes differ.
+            return _qp.proxy().mutate_locally(make_delete_mutation(schema, shard, written_at, id, ts), tracing::trace_state_ptr(), db::commitlog::force_sync::no);
         });
-    });
+    };
+
+    sstring query = format("SELECT written_at, id, data, version, writetime(data) AS ts FROM {}.{} WHERE shard = ? AND segment = ? LIMIT {:d}",
+            system_keyspace::NAME, system_keyspace::BATCHLOG_V2, page_size);
+    auto page = co_await _qp.execute_internal(query, {shard, segment}, cql3::query_processor::cache_internal::yes);
+    while (!page->empty()) {
+        auto last_written_at = page->back().get_as<db_clock::time_point>("written_at");
+        auto last_id = page->back().get_as<utils::UUID>("id");
+        co_await parallel_for_each(*page, batch);
+        if (page->size() < page_size) {
+            break;
+        }
+        query = format("SELECT written_at, id, data, version, writetime(data) AS ts FROM {}.{} WHERE shard = ? AND segment = ? AND (written_at, id) > (?, ?) LIMIT {:d}",
+                system_keyspace::NAME, system_keyspace::BATCHLOG_V2, page_size);
+        page = co_await _qp.execute_internal(query, {shard, segment, last_written_at, last_id}, cql3::query_processor::cache_internal::yes);
+    }
+}
+
+future<> db::batchlog_manager::replay_segments(utils::rate_limiter& limiter) {
+    auto schema = _qp.db().find_schema(system_keyspace::NAME, system_keyspace::BATCHLOG_V2);
+    sstring query = format("SELECT DISTINCT shard, segment FROM {}.{}", system_keyspace::NAME, system_keyspace::BATCHLOG_V2);
+    auto rs = co_await _qp.execute_internal(query, cql3::query_processor::cache_internal::yes);
+
+    std::vector<std::pair<db_clock::time_point, int32_t>> segments;
+    segments.reserve(rs->size());
+    for (const auto& row : *rs) {
+        segments.emplace_back(row.get_as<db_clock::time_point>("segment"), row.get_as<int32_t>("shard"));
+    }
+    // Segments are replayed one after another, oldest first, so that only
+    // one page of batches is read at a time.
+    std::ranges::sort(segments);
+    for (auto [segment, shard] : segments) {
+        co_await replay_segment(limiter, schema, shard, segment);
+    }
+}
+
+future<> db::batchlog_manager::replay_all_failed_batches() {
+    // rate limit is in bytes per second. Uses Double.MAX_VALUE if disabled (set to 0 in cassandra.yaml).
+    // max rate is scaled by the number of nodes in the cluster (same as for HHOM - see CASSANDRA-5272).
+    auto throttle = _replay_rate / _qp.proxy().get_token_metadata_ptr()->count_normal_token_owners();
+    utils::rate_limiter limiter(throttle);
+
+    auto gate_holder = _gate.hold();
+    blogger.debug("Started replayAllFailedBatches (cpu {})", this_shard_id());
+
+    // Entries written before the cluster switched to system.batchlog_v2.
+    co_await replay_legacy_batches(limiter);
+    co_await replay_segments(limiter);
+
+    blogger.debug("Finished replayAllFailedBatches");
 }
@@ -33,6 +33,12 @@ class query_processor;
 
 } // namespace cql3
 
+namespace utils {
+
+class rate_limiter;
+
+} // namespace utils
+
 namespace db {
 
 class system_keyspace;
@@ -68,8 +74,26 @@ class batchlog_manager : public peering_sharded_service<batchlog_manager> {
     seastar::abort_source _stop;
     future<> _loop_done;
 
+    // Whether a batch was replayed (or can't ever be) and its entry can be
+    // deleted, or the entry has to be kept for a later replay.
+    enum class replay_status { replayed, kept };
+
     future<> replay_all_failed_batches();
+    future<> replay_legacy_batches(utils::rate_limiter& limiter);
+    future<> replay_segments(utils::rate_limiter& limiter);
+    future<> replay_segment(utils::rate_limiter& limiter, schema_ptr schema, int32_t shard, db_clock::time_point segment);
+    future<replay_status> replay_batch(utils::UUID id, db_clock::time_point written_at, std::optional<int32_t> version, bytes data, utils::rate_limiter& limiter);
 public:
+    // The entries of system.batchlog_v2 are grouped into segments, by the
+    // shard which wrote them and by the period they were written in, so that
+    // replay reads them partition by partition. Coordinators on different
+    // nodes share a segment, so replayed entries are deleted one by one.
+    static constexpr std::chrono::milliseconds segment_duration = std::chrono::minutes(1);
+    static db_clock::time_point segment_of(db_clock::time_point written_at);
+    // Deletes the entry of a single batch, written no later than `now`.
+    static mutation make_delete_mutation(schema_ptr s, int32_t shard, db_clock::time_point written_at, const utils::UUID& id, api::timestamp_type now);
+    static mutation make_legacy_delete_mutation(schema_ptr s, const utils::UUID& id, api::timestamp_type now);
+
     // Takes a QP, not a distributes. Because this object is supposed
     // to be per shard and does no dispatching beyond delegating the the
     // shard qp (which is what you feed here).
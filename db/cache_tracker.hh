@@ -15,9 +15,17 @@
 #include "mutation/mutation_cleaner.hh"
 #include "utils/cached_file_stats.hh"
 #include "sstables/partition_index_cache_stats.hh"
+#include "sstables/promoted_index_block_cache_stats.hh"
+#include "db/compressed_partition_store.hh"
+#include "db/absent_partition_store.hh"
 
 #include <seastar/core/metrics_registration.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
 
+#include <optional>
+#include <string_view>
+#include <vector>
 #include <stdint.h>
 
 class cache_entry;
@@ -32,6 +40,22 @@ class lsa_manager;
 
 }
 
+// How reads of a given class are admitted to the row cache.
+enum class cache_admission {
+    // Reads go through the cache and populate it.
+    populate,
+    // Single partition reads go through the cache when the partition is already
+    // cached, or when it was recently requested by another such read, see
+    // cache_tracker::is_reused(). Otherwise they read from sstables, so the
+    // partition isn't populated. Range scans bypass the cache.
+    populate_on_reuse,
+    // Reads bypass the cache, as with BYPASS CACHE.
+    bypass,
+};
+
+// Returns std::nullopt if the name doesn't denote a cache_admission.
+std::optional<cache_admission> parse_cache_admission(std::string_view);
+
 // Tracks accesses and performs eviction of cache entries.
 class cache_tracker final {
 public:
@@ -73,6 +97,13 @@ class cache_tracker final {
         uint64_t row_tombstone_reads;
         uint64_t rows_compacted;
         uint64_t rows_compacted_away;
+        uint64_t probation_row_hits;
+        uint64_t protected_row_hits;
+        uint64_t reads_bypassed_by_admission;
+        uint64_t partition_compressions;
+        uint64_t compressed_partition_hits;
+        uint64_t absent_partition_hits;
+        uint64_t partitions_invalidated_on_update;
 
         uint64_t active_reads() const {
             return reads - reads_done;
@@ -82,6 +113,7 @@ class cache_tracker final {
     stats _stats{};
     cached_file_stats _index_cached_file_stats{};
     partition_index_cache_stats _partition_index_cache_stats{};
+    promoted_index_block_cache_stats _promoted_index_block_cache_stats{};
     seastar::metrics::metric_groups _metrics;
     logalloc::region _region;
     lru _lru;
@@ -89,12 +121,34 @@ class cache_tracker final {
     mutation_cleaner _memtable_cleaner;
     mutation_application_stats& _app_stats;
     utils::updateable_value<double> _index_cache_fraction;
+    utils::updateable_value<bool> _scans_on_probation;
+    // Hashes of the partitions recently requested by reads admitted with
+    // cache_admission::populate_on_reuse. Direct-mapped, allocated on first use.
+    std::vector<size_t> _admission_ghost;
+    // Complete partitions demoted from the cache, see compress_cold_partitions().
+    compressed_partition_store _compressed;
+    utils::updateable_value<uint32_t> _compressed_cache_size_in_mb;
+    logalloc::allocating_section _compression_section;
+    seastar::timer<seastar::lowres_clock> _compression_timer;
+    uint64_t _evictions_at_last_compression = 0;
+    utils::observer<uint32_t> _compressed_cache_size_observer;
+    // Keys of partitions which reads found missing, used instead of empty entries.
+    absent_partition_store _absent;
+    utils::updateable_value<uint32_t> _absent_partition_cache_size_in_mb;
+    utils::observer<uint32_t> _absent_partition_cache_size_observer;
+    utils::updateable_value<uint32_t> _update_max_rows_per_partition;
 private:
     void setup_metrics();
+    void update_compression_timer() noexcept;
+    void on_compression_timer() noexcept;
 public:
     using register_metrics = bool_class<class register_metrics_tag>;
-    cache_tracker(utils::updateable_value<double> index_cache_fraction, mutation_application_stats&, register_metrics);
-    cache_tracker(utils::updateable_value<double> index_cache_fraction, register_metrics);
+    cache_tracker(utils::updateable_value<double> index_cache_fraction, utils::updateable_value<bool> scans_on_probation,
+            utils::updateable_value<uint32_t> compressed_cache_size_in_mb, utils::updateable_value<uint32_t> absent_partition_cache_size_in_mb,
+            utils::updateable_value<uint32_t> update_max_rows_per_partition, mutation_application_stats&, register_metrics);
+    cache_tracker(utils::updateable_value<double> index_cache_fraction, utils::updateable_value<bool> scans_on_probation,
+            utils::updateable_value<uint32_t> compressed_cache_size_in_mb, utils::updateable_value<uint32_t> absent_partition_cache_size_in_mb,
+            utils::updateable_value<uint32_t> update_max_rows_per_partition, register_metrics);
     cache_tracker();
     ~cache_tracker();
     void clear();
@@ -107,6 +161,32 @@ class cache_tracker final {
     void remove(rows_entry&) noexcept;
     // Inserts e such that it will be evicted right before more_recent in the absence of later touches.
     void insert(rows_entry& more_recent, rows_entry& e) noexcept;
+    // Like insert(rows_entry&), but links the entry in the probationary segment of the LRU,
+    // so that it is evicted before the re-referenced entries unless it's touched again.
+    // To keep the "older versions are evicted first" rule, the entry must belong to
+    // the only version of its partition.
+    void insert_on_probation(rows_entry&) noexcept;
+    void insert_on_probation(cache_entry&);
+    // Whether rows populated by range scans should be inserted on probation.
+    bool scans_on_probation() const noexcept { return _scans_on_probation.get(); }
+    // Records the partition with the given hash in the ghost cache used by
+    // cache_admission::populate_on_reuse. Returns true if it was already there.
+    bool is_reused(size_t partition_hash);
+    void on_read_bypassed_by_admission() noexcept { ++_stats.reads_bypassed_by_admission; }
+    // Moves up to max_partitions complete partitions, found among the least recently used
+    // entries, out of the cache into compressed_partitions(). Returns the number of partitions moved.
+    // Does nothing when the compressed cache is disabled.
+    //
+    // Called periodically while the cache is evicting, so that the partitions which would
+    // be evicted next are kept in memory in a more compact form instead.
+    size_t compress_cold_partitions(size_t max_partitions);
+    compressed_partition_store& compressed_partitions() noexcept { return _compressed; }
+    size_t compressed_cache_capacity() const noexcept { return size_t(_compressed_cache_size_in_mb.get()) << 20; }
+    absent_partition_store& absent_partitions() noexcept { return _absent; }
+    // 0 when absent partitions are cached as empty entries.
+    size_t absent_partition_cache_capacity() const noexcept { return size_t(_absent_partition_cache_size_in_mb.get()) << 20; }
+    // Flushed partitions with more rows are invalidated in cache instead of merged into it, 0 means no limit.
+    size_t update_max_rows_per_partition() const noexcept { return _update_max_rows_per_partition.get(); }
     void clear_continuity(cache_entry& ce) noexcept;
     void on_partition_erase() noexcept;
     void on_partition_merge() noexcept;
@@ -139,6 +219,7 @@ class cache_tracker final {
     lru& get_lru() { return _lru; }
     cached_file_stats& get_index_cached_file_stats() { return _index_cached_file_stats; }
     partition_index_cache_stats& get_partition_index_cache_stats() { return _partition_index_cache_stats; }
+    promoted_index_block_cache_stats& get_promoted_index_block_cache_stats() { return _promoted_index_block_cache_stats; }
     seastar::memory::reclaiming_result evict_from_lru_shallow() noexcept;
 };
 
@@ -158,6 +239,13 @@ void cache_tracker::insert(rows_entry& entry) noexcept {
     _lru.add(entry);
 }
 
+inline
+void cache_tracker::insert_on_probation(rows_entry& entry) noexcept {
+    ++_stats.row_insertions;
+    ++_stats.rows;
+    _lru.add_on_probation(entry);
+}
+
 inline
 void cache_tracker::insert(rows_entry& more_recent, rows_entry& entry) noexcept {
     ++_stats.row_insertions;
@@ -108,6 +108,17 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     c.mode = cfg.commitlog_sync() == "batch" ? sync_mode::BATCH : sync_mode::PERIODIC;
     c.extensions = &cfg.extensions();
     c.use_o_dsync = cfg.commitlog_use_o_dsync();
+    c.batch_group_commit_max_wait = std::chrono::microseconds(cfg.commitlog_sync_batch_group_commit_max_wait_in_us());
+    c.dedicated_streams = cfg.commitlog_dedicated_segment_streams();
+    c.min_reserve_segments = cfg.commitlog_reserve_segments();
+    c.max_reserve_segments = cfg.commitlog_max_reserve_segments();
+    c.reserve_lookahead_in_ms = cfg.commitlog_reserve_lookahead_in_ms();
+    if (!cfg.commitlog_compression().empty()) {
+        c.compressor = compressor::create(cfg.commitlog_compression(), [] (const sstring&) { return compressor::opt_string(); });
+        if (!c.compressor) {
+            throw std::invalid_argument(format("Unknown commitlog_compression {}", cfg.commitlog_compression()));
+        }
+    }
     c.allow_going_over_size_limit = !cfg.commitlog_use_hard_size_limit();
 
     if (cfg.commitlog_flush_threshold_in_mb() >= 0) {
@@ -378,7 +389,61 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         uint64_t requests_blocked_memory = 0;
         uint64_t blocked_on_new_segment = 0;
         uint64_t active_allocations = 0;
+        // batch mode writes, the syncs issued for them, and the time they spent waiting for others to join
+        uint64_t batch_writes = 0;
+        uint64_t batch_syncs = 0;
+        uint64_t batch_wait_us = 0;
+        // entries written compressed, and their size before and after compression
+        uint64_t compressed_entries = 0;
+        uint64_t bytes_before_compression = 0;
+        uint64_t bytes_after_compression = 0;
+        // allocations which waited for a new segment, and the time they waited
+        uint64_t segment_waits = 0;
+        uint64_t segment_wait_us = 0;
+    };
+
+    // Decides how long a write in batch mode waits for other writes to join its sync.
+    //
+    // Each sync in batch mode costs a write and a flush of the buffer. A write which
+    // waits a little before issuing it lets others which arrive meanwhile append to the
+    // same buffer and be acknowledged by the same sync, trading latency for throughput.
+    // Waiting pays off only when at least one more write is expected to arrive, and
+    // never for longer than a sync takes, so the controller keeps moving averages of
+    // the interval between writes and of the sync time, and waits for the shorter of
+    // the sync time and the configured budget when writes arrive more often than that.
+    class group_commit_controller {
+    public:
+        using clock = std::chrono::steady_clock;
+    private:
+        static constexpr double alpha = 0.1;
+        std::chrono::microseconds _max_wait;
+        double _arrival_interval_us = std::numeric_limits<double>::infinity();
+        double _sync_us = 0;
+        std::optional<clock::time_point> _last_arrival;
+    public:
+        explicit group_commit_controller(std::chrono::microseconds max_wait) noexcept
+            : _max_wait(max_wait)
+        {}
+        void on_write(clock::time_point now) noexcept {
+            if (_last_arrival) {
+                double interval = std::chrono::duration<double, std::micro>(now - *_last_arrival).count();
+                _arrival_interval_us = std::isinf(_arrival_interval_us) ? interval : (1 - alpha) * _arrival_interval_us + alpha * interval;
+            }
+            _last_arrival = now;
+        }
+        void on_sync(clock::duration d) noexcept {
+            double us = std::chrono::duration<double, std::micro>(d).count();
+            _sync_us = _sync_us == 0 ? us : (1 - alpha) * _sync_us + alpha * us;
+        }
+        std::chrono::microseconds wait_time() const noexcept {
+            double w = std::min<double>(_max_wait.count(), _sync_us);
+            if (w < 1 || _arrival_interval_us > w) {
+                return std::chrono::microseconds(0);
+            }
+            return std::chrono::microseconds(int64_t(w));
+        }
     };
+    group_commit_controller group_commit;
 
     class scope_increment_counter {
         uint64_t& _dst;
@@ -434,8 +499,9 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     }
 
     future<> init();
-    future<sseg_ptr> new_segment();
-    future<sseg_ptr> active_segment(db::timeout_clock::time_point timeout);
+    future<sseg_ptr> new_segment(unsigned stream);
+    future<sseg_ptr> active_segment(db::timeout_clock::time_point timeout, unsigned stream = 0);
+    sseg_ptr find_active_segment(unsigned stream) const noexcept;
     future<sseg_ptr> allocate_segment();
     future<sseg_ptr> allocate_segment_ex(descriptor, named_file, open_flags);
 
@@ -465,6 +531,37 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
 
     void on_timer();
     void sync();
+
+    // With dedicated streams enabled, the segments of the tables which wrote the most are
+    // not shared with other tables.
+    //
+    // A segment can be freed only once all tables which wrote to it flushed their memtables,
+    // so with shared segments a table which is written to slowly pins segments filled mostly
+    // by others, and commitlog pressure forces flushes of all of them. Each of the top
+    // cfg.dedicated_streams tables by bytes written in the last timer period gets a stream
+    // of segments of its own, which is freed whenever the table flushes, while the rest
+    // share stream 0. The assignment is recomputed by update_streams() on every timer tick.
+    //
+    // Replay skips the entries of a table up to the replay position its sstables were
+    // flushed at, so the entries of a table must get increasing replay positions. Streams
+    // write to segments with interleaved ids, so when a table moves to a stream whose
+    // active segment is older than the last segment the table wrote to, that segment is
+    // closed and the entry goes to a new one, which is younger than all others.
+    struct table_stream {
+        // bytes written since the last update_streams(), decaying
+        uint64_t bytes = 0;
+        segment_id_type last_segment = 0;
+        unsigned stream = 0;
+    };
+    std::unordered_map<cf_id_type, table_stream> _table_streams;
+
+    unsigned stream_of(const cf_id_type& id) const noexcept {
+        auto i = _table_streams.find(id);
+        return i == _table_streams.end() ? 0 : i->second.stream;
+    }
+    segment_id_type min_segment_id(const entry_writer& writer) const noexcept;
+    void note_written(const entry_writer& writer, const segment& s);
+    void update_streams();
     void arm(uint32_t extra = 0) {
         if (!_shutdown) {
             _timer.arm(std::chrono::milliseconds(cfg.commitlog_sync_period_in_ms + extra));
@@ -512,7 +609,11 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     replay_position _flush_position;
     timer<clock_type> _timer;
     future<> replenish_reserve();
+    void update_reserve_target();
     future<> _reserve_replenisher;
+    // Moving average of the time it takes to make a segment ready, which
+    // includes zero-filling it when using O_DSYNC.
+    double _segment_allocation_us = 0;
     future<> _background_sync;
     seastar::gate _gate;
     uint64_t _new_counter = 0;
@@ -686,6 +787,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     bool _closed = false;
     bool _terminated = false;
 
+    // The stream of segments this one belongs to, see segment_manager::update_streams().
+    unsigned _stream = 0;
+
     using buffer_type = segment_manager::buffer_type;
     using sseg_ptr = segment_manager::sseg_ptr;
     using clock_type = segment_manager::clock_type;
@@ -698,6 +802,11 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     time_point _sync_time;
     utils::flush_queue<replay_position, std::less<replay_position>, clock_type> _pending_ops;
 
+    // The file position of the buffer whose writes are waiting for others to join
+    // its sync in batch mode, and until when.
+    uint64_t _group_commit_pos = std::numeric_limits<uint64_t>::max();
+    segment_manager::group_commit_controller::clock::time_point _group_commit_deadline;
+
     uint64_t _num_allocs = 0;
 
     std::unordered_set<table_schema_version> _known_schema_versions;
@@ -782,6 +891,19 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     void add_schema_version(schema_ptr s) {
         _known_schema_versions.emplace(s->version());
     }
+    const compressor_ptr& entry_compressor() const {
+        return _segment_manager->cfg.compressor;
+    }
+    void add_entry(const commitlog_entry_writer& w) {
+        if (w.with_schema()) {
+            add_schema_version(w.schema());
+        }
+        if (w.compressed()) {
+            ++_segment_manager->totals.compressed_entries;
+            _segment_manager->totals.bytes_before_compression += w.uncompressed_size();
+            _segment_manager->totals.bytes_after_compression += w.size();
+        }
+    }
     void forget_schema_versions() {
         _known_schema_versions.clear();
     }
@@ -812,7 +934,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     future<sseg_ptr> finish_and_get_new(db::timeout_clock::time_point timeout) {
         //FIXME: discarded future.
         (void)close();
-        return _segment_manager->active_segment(timeout);
+        return _segment_manager->active_segment(timeout, _stream);
     }
     void reset_sync_time() {
         _sync_time = clock_type::now();
@@ -1083,7 +1205,24 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
          */
         auto me = shared_from_this();
         auto fp = _file_pos;
+        auto& gc = _segment_manager->group_commit;
+        auto now = segment_manager::group_commit_controller::clock::now();
+        gc.on_write(now);
+        ++_segment_manager->totals.batch_writes;
         try {
+            // Let the writes which arrive shortly after the first one to the buffer
+            // join it, all of them wait until the same deadline.
+            if (auto wait = gc.wait_time(); wait.count()) {
+                if (_group_commit_pos != fp) {
+                    _group_commit_pos = fp;
+                    _group_commit_deadline = now + wait;
+                }
+                if (_group_commit_deadline > now) {
+                    auto d = _group_commit_deadline - now;
+                    _segment_manager->totals.batch_wait_us += std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+                    co_await seastar::sleep(d);
+                }
+            }
             co_await _pending_ops.wait_for_pending(timeout);
             if (fp != _file_pos) {
                 // some other request already wrote this buffer.
@@ -1103,7 +1242,10 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             } else {
                 // It is ok to leave the sync behind on timeout because there will be at most one
                 // such sync, all later allocations will block on _pending_ops until it is done.
+                auto start = segment_manager::group_commit_controller::clock::now();
                 co_await with_timeout(timeout, sync());
+                gc.on_sync(segment_manager::group_commit_controller::clock::now() - start);
+                ++_segment_manager->totals.batch_syncs;
             }
         } catch (...) {
             // If we get an IO exception (which we assume this is)
@@ -1327,12 +1469,18 @@ future<R> db::commitlog::segment_manager::allocate_when_possible(T writer, db::t
     scope_increment_counter allocating(totals.active_allocations);
 
     auto permit = co_await std::move(fut);
-    sseg_ptr s;
+    const unsigned stream = cfg.dedicated_streams ? stream_of(writer.id(0)) : 0;
+    sseg_ptr s = find_active_segment(stream);
 
-    if (!_segments.empty() && _segments.back()->is_still_allocating()) {
-        s = _segments.back();
-    } else {
-        s = co_await active_segment(timeout);
+    if (!s) {
+        s = co_await active_segment(timeout, stream);
+    }
+    if (cfg.dedicated_streams) {
+        // Keep the replay positions of each table increasing, see table_stream.
+        const auto min_id = min_segment_id(writer);
+        while (s->_desc.id < min_id) {
+            s = co_await s->finish_and_get_new(timeout);
+        }
     }
 
     for (;;) {
@@ -1340,6 +1488,7 @@ future<R> db::commitlog::segment_manager::allocate_when_possible(T writer, db::t
 
         switch (s->allocate(writer, permit, timeout)) {
             case write_result::ok:
+                note_written(writer, *s);
                 co_return writer.result();
             case write_result::must_sync:
                 s = co_await with_timeout(timeout, s->sync());
@@ -1348,6 +1497,7 @@ future<R> db::commitlog::segment_manager::allocate_when_possible(T writer, db::t
                 s = co_await s->finish_and_get_new(timeout);
                 continue;
             case write_result::ok_need_batch_sync:
+                note_written(writer, *s);
                 s = co_await s->batch_cycle(timeout);
                 co_return writer.result();
         }
@@ -1374,6 +1524,9 @@ db::commitlog::segment_manager::segment_manager(config c)
             cfg.base_segment_id = std::chrono::duration_cast<std::chrono::milliseconds>(runtime::get_boot_time().time_since_epoch()).count() + 1;
         }
 
+        cfg.min_reserve_segments = std::max(uint64_t(1), cfg.min_reserve_segments);
+        cfg.max_reserve_segments = std::max(cfg.min_reserve_segments, cfg.max_reserve_segments);
+
         return cfg;
     }())
     , max_size(std::min<size_t>(std::numeric_limits<position_type>::max() / (1024 * 1024), std::max<size_t>(cfg.commitlog_segment_size_in_mb, 1)) * 1024 * 1024)
@@ -1391,7 +1544,8 @@ db::commitlog::segment_manager::segment_manager(config c)
     // than default_size at the end of the allocation, that allows for every valid mutation to
     // always be admitted for processing.
     , _request_controller(max_request_controller_units(), request_controller_timeout_exception_factory{})
-    , _reserve_segments(1)
+    , group_commit(cfg.mode == sync_mode::BATCH ? cfg.batch_group_commit_max_wait : std::chrono::microseconds(0))
+    , _reserve_segments(cfg.min_reserve_segments)
     , _recycled_segments(std::numeric_limits<size_t>::max())
     , _reserve_replenisher(make_ready_future<>())
     , _background_sync(make_ready_future<>())
@@ -1428,7 +1582,10 @@ future<> db::commitlog::segment_manager::replenish_reserve() {
             // trust that flush logic will absolutely free up an existing 
             // segment (because colocation stuff etc), so always allow a new
             // file if needed. That and performance stuff...
+            auto start = std::chrono::steady_clock::now();
             auto s = co_await allocate_segment();
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            _segment_allocation_us = _segment_allocation_us * 0.8 + us * 0.2;
             auto ret = _reserve_segments.push(std::move(s));
             if (!ret) {
                 clogger.error("Segment reserve is full! Ignoring and trying to continue, but shouldn't happen");
@@ -1547,6 +1704,33 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
         sm::make_counter("cycle", totals.cycle_count,
                        sm::description("Counts number of commitlog write cycles - when the data is written from the internal memory buffer to the disk.")),
 
+        sm::make_counter("batch_writes", totals.batch_writes,
+                       sm::description("Counts number of writes acknowledged after a sync in batch mode. "
+                                       "Divide by batch_syncs to get the average number of writes per sync.")),
+
+        sm::make_counter("batch_syncs", totals.batch_syncs,
+                       sm::description("Counts number of syncs issued for writes in batch mode.")),
+
+        sm::make_counter("batch_wait_us", totals.batch_wait_us,
+                       sm::description("Counts the total time, in microseconds, writes in batch mode waited for others to join their sync.")),
+
+        sm::make_gauge("batch_group_commit_window_us", [this] { return group_commit.wait_time().count(); },
+                       sm::description("Holds the current time, in microseconds, a write in batch mode waits for others to join its sync.")),
+
+        sm::make_gauge("dedicated_segment_streams", [this] {
+                            return std::count_if(_table_streams.begin(), _table_streams.end(), [] (auto& p) { return p.second.stream != 0; });
+                       },
+                       sm::description("Holds the number of tables currently writing to segments of their own.")),
+
+        sm::make_counter("compressed_entries", totals.compressed_entries,
+                       sm::description("Counts number of entries written compressed.")),
+
+        sm::make_counter("bytes_before_compression", totals.bytes_before_compression,
+                       sm::description("Counts number of bytes of entries written compressed, before compression.")),
+
+        sm::make_counter("bytes_after_compression", totals.bytes_after_compression,
+                       sm::description("Counts number of bytes of entries written compressed, after compression.")),
+
         sm::make_counter("flush", totals.flush_count,
                        sm::description("Counts number of times the flush() method was called for a file.")),
 
@@ -1598,6 +1782,22 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
         sm::make_gauge("blocked_on_new_segment", totals.blocked_on_new_segment,
                        sm::description("Number of allocations blocked on acquiring new segment.")),
 
+        sm::make_counter("segment_waits", totals.segment_waits,
+                       sm::description("Counts number of allocations which waited for a new segment to be made ready. "
+                                       "A growing value indicates that the segment reserve is too small for the write rate.")),
+
+        sm::make_counter("segment_wait_us", totals.segment_wait_us,
+                       sm::description("Counts the total time, in microseconds, allocations waited for a new segment to be made ready.")),
+
+        sm::make_gauge("reserve_segments", [this] { return _reserve_segments.size(); },
+                       sm::description("Holds the number of segments ready to be used.")),
+
+        sm::make_gauge("reserve_segments_target", [this] { return _reserve_segments.max_size(); },
+                       sm::description("Holds the number of segments the commitlog tries to keep ready to be used.")),
+
+        sm::make_gauge("segment_allocation_us", [this] { return _segment_allocation_us; },
+                       sm::description("Holds the average time, in microseconds, it takes to make a segment ready to be used.")),
+
         sm::make_gauge("active_allocations", totals.active_allocations,
                        sm::description("Current number of active allocations.")),
     });
@@ -1627,11 +1827,14 @@ void db::commitlog::segment_manager::flush_segments(uint64_t size_to_remove) {
     uint64_t flushing = 0;
 
     for (auto& s : _segments) {
-        // if a segment is allocating, it should be included in flush request,
-        // because we cannot free anything there anyway. If a segment is allocating,
-        // it is the last one, so just break.
+        // if a segment is allocating, it should not be included in flush request,
+        // because we cannot free anything there anyway. With dedicated streams
+        // there may be closed segments after it.
         if (s->is_still_allocating()) {
-            break;
+            if (!cfg.dedicated_streams) {
+                break;
+            }
+            continue;
         }
 
         auto rp = replay_position(s->_desc.id, db::position_type(s->size_on_disk()));
@@ -1833,7 +2036,7 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
     }
 }
 
-future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::new_segment() {
+future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::new_segment(unsigned stream) {
     gate::holder g(_gate);
 
     if (_shutdown) {
@@ -1857,17 +2060,122 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
     }
 
     auto s = co_await _reserve_segments.pop_eventually();
+    s->_stream = stream;
     _segments.push_back(s);
     _segments.back()->reset_sync_time();
     co_return s;
 }
 
-future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::active_segment(db::timeout_clock::time_point timeout) {
+db::commitlog::segment_manager::sseg_ptr db::commitlog::segment_manager::find_active_segment(unsigned stream) const noexcept {
+    if (!cfg.dedicated_streams) {
+        if (!_segments.empty() && _segments.back()->is_still_allocating()) {
+            return _segments.back();
+        }
+        return nullptr;
+    }
+    for (auto i = _segments.rbegin(); i != _segments.rend(); ++i) {
+        if ((*i)->_stream == stream && (*i)->is_still_allocating()) {
+            return *i;
+        }
+    }
+    return nullptr;
+}
+
+db::segment_id_type db::commitlog::segment_manager::min_segment_id(const entry_writer& writer) const noexcept {
+    segment_id_type res = 0;
+    for (size_t i = 0; i < writer.num_entries; ++i) {
+        if (auto t = _table_streams.find(writer.id(i)); t != _table_streams.end()) {
+            res = std::max(res, t->second.last_segment);
+        }
+    }
+    return res;
+}
+
+void db::commitlog::segment_manager::note_written(const entry_writer& writer, const segment& s) {
+    if (!cfg.dedicated_streams) {
+        return;
+    }
+    const auto bytes = writer.size() / writer.num_entries;
+    for (size_t i = 0; i < writer.num_entries; ++i) {
+        auto& t = _table_streams[writer.id(i)];
+        t.bytes += bytes;
+        t.last_segment = std::max(t.last_segment, s._desc.id);
+    }
+}
+
+void db::commitlog::segment_manager::update_streams() {
+    std::vector<std::pair<uint64_t, cf_id_type>> ranked;
+    for (auto& [id, t] : _table_streams) {
+        if (t.bytes) {
+            ranked.emplace_back(t.bytes, id);
+        }
+    }
+    const auto n = std::min<size_t>(cfg.dedicated_streams, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + n, ranked.end(), std::greater<>());
+    std::unordered_set<cf_id_type> top;
+    for (size_t i = 0; i < n; ++i) {
+        top.insert(ranked[i].second);
+    }
+
+    // Tables which stay on top keep their streams, the others go back to the shared one.
+    std::vector<bool> used(cfg.dedicated_streams + 1, false);
+    for (auto& [id, t] : _table_streams) {
+        if (t.stream && !top.contains(id)) {
+            clogger.debug("Table {} moves back to the shared segments", id);
+            t.stream = 0;
+        } else if (t.stream) {
+            used[t.stream] = true;
+        }
+    }
+    unsigned next = 1;
+    for (auto& id : top) {
+        auto& t = _table_streams[id];
+        if (!t.stream) {
+            while (used[next]) {
+                ++next;
+            }
+            clogger.debug("Table {} gets dedicated segment stream {}", id, next);
+            t.stream = next;
+            used[next] = true;
+        }
+    }
+
+    // Streams which lost their table are closed, so that their segments can be freed.
+    segment_id_type min_active = std::numeric_limits<segment_id_type>::max();
+    for (auto& s : _segments) {
+        if (!s->is_still_allocating()) {
+            continue;
+        }
+        if (s->_stream && !used[s->_stream] && s->position()) {
+            //FIXME: discarded future.
+            (void)s->close();
+            continue;
+        }
+        min_active = std::min(min_active, s->_desc.id);
+    }
+
+    // Tables in the shared stream whose last entry is older than all active segments
+    // can't get out of order anymore, no need to remember them.
+    std::erase_if(_table_streams, [min_active] (auto& p) {
+        return p.second.stream == 0 && p.second.last_segment < min_active;
+    });
+    for (auto& [id, t] : _table_streams) {
+        t.bytes /= 2;
+    }
+}
+
+future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::active_segment(db::timeout_clock::time_point timeout, unsigned stream) {
     // If there is no active segment, try to allocate one using new_segment(). If we time out,
     // make sure later invocations can still pick that segment up once it's ready.
+    std::optional<std::chrono::steady_clock::time_point> wait_start;
+    auto note_wait = defer([&] () noexcept {
+        if (wait_start) {
+            totals.segment_wait_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - *wait_start).count();
+        }
+    });
     for (;;) {
-        if (!_segments.empty() && _segments.back()->is_still_allocating()) {
-            co_return _segments.back();
+        if (auto s = find_active_segment(stream)) {
+            co_return s;
         }
 
         scope_increment_counter blocked_on_new(totals.blocked_on_new_segment);
@@ -1876,7 +2184,7 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
         // the old one has terminated with either result or exception.
         // Do all waiting through the shared_future
         if (!_segment_allocating) {
-            auto f = new_segment();
+            auto f = new_segment(stream);
             // must check that we are not already done.
             if (f.available()) {
                 f.get(); // maybe force exception
@@ -1888,6 +2196,10 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
                 _segment_allocating = std::nullopt;
             }));
         }
+        if (!wait_start) {
+            ++totals.segment_waits;
+            wait_start = std::chrono::steady_clock::now();
+        }
         co_await _segment_allocating->get_future(timeout);
     }
 }
@@ -1919,6 +2231,17 @@ void db::commitlog::segment_manager::discard_completed_segments(const cf_id_type
 }
 
 future<> db::commitlog::segment_manager::force_new_active_segment() noexcept {
+    if (cfg.dedicated_streams) {
+        auto def_copy = _segments;
+        for (auto& s : def_copy) {
+            if (s->is_still_allocating() && s->position()) {
+                co_await s->close();
+            }
+        }
+        discard_unused_segments();
+        co_return;
+    }
+
     if (_segments.empty() || !_segments.back()->is_still_allocating()) {
         co_return;
     }
@@ -2253,6 +2576,28 @@ void db::commitlog::segment_manager::sync() {
     });
 }
 
+// Sizes the segment reserve for the recent write rate, so that bursts find segments
+// ready instead of waiting for new ones. The reserve should hold what is written over
+// the configured lookahead, or over the time it takes to make a new segment ready if
+// that is longer, as with O_DSYNC, where new segments are zero-filled first. It never
+// goes below min_reserve_segments, above max_reserve_segments, or over the disk limit.
+void db::commitlog::segment_manager::update_reserve_target() {
+    if (cfg.reserve_lookahead_in_ms == 0) {
+        return;
+    }
+    auto lookahead = std::max(cfg.reserve_lookahead_in_ms / 1000.0, 2 * _segment_allocation_us / 1000000);
+    auto target = std::clamp(uint64_t(std::ceil(bytes_rate.bytes_written * lookahead / max_size)), cfg.min_reserve_segments, cfg.max_reserve_segments);
+    if (max_disk_size != 0 && target > _reserve_segments.size()) {
+        auto room = totals.total_size_on_disk < max_disk_size ? (max_disk_size - totals.total_size_on_disk) / max_size : 0;
+        target = std::max(cfg.min_reserve_segments, std::min(target, _reserve_segments.size() + room));
+    }
+    if (target != _reserve_segments.max_size()) {
+        clogger.debug("Changing segment reserve count {} -> {} (write rate {} B/s, segment allocation {} us)",
+                _reserve_segments.max_size(), target, bytes_rate.bytes_written, _segment_allocation_us);
+        _reserve_segments.set_max_size(target);
+    }
+}
+
 void db::commitlog::segment_manager::on_timer() {
     // Gate, because we are starting potentially blocking ops
     // without waiting for them, so segement_manager could be shut down
@@ -2261,6 +2606,9 @@ void db::commitlog::segment_manager::on_timer() {
         if (cfg.mode != sync_mode::BATCH) {
             sync();
         }
+        if (cfg.dedicated_streams) {
+            update_streams();
+        }
 
         byte_flow<uint64_t> curr = totals;
         auto diff = curr - std::exchange(last_bytes, curr);
@@ -2274,6 +2622,8 @@ void db::commitlog::segment_manager::on_timer() {
         bytes_rate = rate;
         last_time = now;
 
+        update_reserve_target();
+
         clogger.debug("Rate: {} / s ({} s)", rate, seconds);
 
         // IFF a new segment was put in use since last we checked, and we're
@@ -2398,6 +2748,7 @@ future<db::rp_handle> db::commitlog::add_entry(const cf_id_type& id, const commi
             return _writer.schema()->id();
         }
         size_t size(segment& seg) override {
+            _writer.set_compressor(seg.entry_compressor());
             _writer.set_with_schema(!seg.is_schema_version_known(_writer.schema()));
             return _writer.size();
         }
@@ -2408,9 +2759,7 @@ future<db::rp_handle> db::commitlog::add_entry(const cf_id_type& id, const commi
             return _writer.mutation_size();
         }
         void write(segment& seg, output& out, size_t) const override {
-            if (_writer.with_schema()) {
-                seg.add_schema_version(_writer.schema());
-            }
+            seg.add_entry(_writer);
             _writer.write(out);
         }
         void result(size_t, rp_handle h) override {
@@ -2452,6 +2801,7 @@ db::commitlog::add_entries(std::vector<commitlog_entry_writer> entry_writers, db
                 if (!known) {
                     _known.emplace(i->schema()->version());
                 }
+                i->set_compressor(seg.entry_compressor());
                 i->set_with_schema(!known);
                 res += i->size();
             }
@@ -2467,9 +2817,7 @@ db::commitlog::add_entries(std::vector<commitlog_entry_writer> entry_writers, db
         }
         void write(segment& seg, output& out, size_t i) const override {
             auto& w = _writers.at(i);
-            if (w.with_schema()) {
-                seg.add_schema_version(w.schema());
-            }
+            seg.add_entry(w);
             w.write(out);
         }
         void result(size_t i, rp_handle h) override {
@@ -2981,6 +3329,14 @@ uint64_t db::commitlog::get_num_active_allocations() const {
     return _segment_manager->totals.active_allocations;
 }
 
+uint64_t db::commitlog::get_num_batch_writes() const {
+    return _segment_manager->totals.batch_writes;
+}
+
+uint64_t db::commitlog::get_num_batch_syncs() const {
+    return _segment_manager->totals.batch_syncs;
+}
+
 future<std::vector<db::commitlog::descriptor>> db::commitlog::list_existing_descriptors() const {
     return list_existing_descriptors(active_config().commit_log_location);
 }
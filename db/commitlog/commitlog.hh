@@ -97,17 +97,27 @@ class commitlog {
         std::optional<uint64_t> commitlog_flush_threshold_in_mb = {};
         uint64_t commitlog_segment_size_in_mb = 32;
         uint64_t commitlog_sync_period_in_ms = 10 * 1000; //TODO: verify default!
-        // Max number of segments to keep in pre-alloc reserve.
-        // Not (yet) configurable from scylla.conf.
+        // Min and max number of segments to keep in pre-alloc reserve.
+        uint64_t min_reserve_segments = 1;
         uint64_t max_reserve_segments = 12;
+        // If not zero, the reserve is sized to hold what is written over this many
+        // milliseconds at the recent write rate, within the limits above.
+        uint64_t reserve_lookahead_in_ms = 0;
         // Max active flushes. Default value
         // zero means try to figure it out ourselves
         uint64_t max_active_flushes = 0;
 
         sync_mode mode = sync_mode::PERIODIC;
+        // Max time a write in batch mode waits for others to join its sync, zero disables.
+        std::chrono::microseconds batch_group_commit_max_wait{0};
         std::string fname_prefix = descriptor::FILENAME_PREFIX;
 
         bool use_o_dsync = false;
+        // Entries written with add_entry()/add_entries() are compressed with it, if set.
+        compressor_ptr compressor;
+        // The number of tables, the ones written to the most, which get segments not shared
+        // with other tables. Zero means all tables share segments.
+        unsigned dedicated_streams = 0;
         bool warn_about_segments_left_on_disk_after_shutdown = true;
         bool allow_going_over_size_limit = true;
 
@@ -298,6 +308,8 @@ class commitlog {
     uint64_t get_num_segments_destroyed() const;
     uint64_t get_num_blocked_on_new_segment() const;
     uint64_t get_num_active_allocations() const;
+    uint64_t get_num_batch_writes() const;
+    uint64_t get_num_batch_syncs() const;
 
 
     /**
@@ -8,35 +8,184 @@
 
 #include "counters.hh"
 #include "commitlog_entry.hh"
+#include "mutation/mutation.hh"
+#include "mutation/mutation_partition_serializer.hh"
 #include "idl/commitlog.dist.hh"
 #include "idl/commitlog.dist.impl.hh"
+#include "idl/mutation.dist.hh"
+#include "idl/mutation.dist.impl.hh"
 
 #include <seastar/core/simple-stream.hh>
 
+#include <unordered_map>
+
+// Writes m in the format of frozen_mutation::representation(), see frozen_mutation(const mutation&).
+template<typename Output>
+static void write_mutation(Output& out, const mutation& m) {
+    mutation_partition_serializer part_ser(*m.schema(), m.partition());
+
+    ser::writer_of_mutation<Output> wom(out);
+    std::move(wom).write_table_id(m.schema()->id())
+                  .write_schema_version(m.schema()->version())
+                  .write_key(m.key())
+                  .partition([&] (auto wr) {
+                      part_ser.write(std::move(wr));
+                  }).end_mutation();
+}
+
+commitlog_entry_writer::commitlog_entry_writer(schema_ptr s, const mutation& m, force_sync sync)
+    : _schema(std::move(s)), _mutation(&m), _sync(sync)
+{
+    seastar::measuring_output_stream ms;
+    write_mutation(ms, m);
+    _mutation_size = ms.size();
+}
+
+// Produces the same bytes as ser::writer_of_commitlog_entry given a frozen_mutation
+// of _mutation: the entry frame, the optional column mapping, and the mutation
+// representation prefixed with its size.
+template<typename Output>
+void commitlog_entry_writer::serialize_mutation(Output& out) const {
+    auto frame = ser::start_frame(out);
+    if (_with_schema) {
+        ser::serialize(out, true);
+        ser::serialize(out, _schema->get_column_mapping());
+    } else {
+        ser::serialize(out, false);
+    }
+    ser::serialize(out, uint32_t(_mutation_size));
+    write_mutation(out, *_mutation);
+    frame.end(out);
+}
+
 template<typename Output>
 void commitlog_entry_writer::serialize(Output& out) const {
+    if (_mutation) {
+        serialize_mutation(out);
+        return;
+    }
     [this, wr = ser::writer_of_commitlog_entry<Output>(out)] () mutable {
         if (_with_schema) {
             return std::move(wr).write_mapping(_schema->get_column_mapping());
         } else {
             return std::move(wr).skip_mapping();
         }
-    }().write_mutation(_mutation).end_commitlog_entry();
+    }().write_mutation(*_frozen_mutation).end_commitlog_entry();
 }
 
 void commitlog_entry_writer::compute_size() {
     seastar::measuring_output_stream ms;
     serialize(ms);
     _size = ms.size();
+    _compressed.reset();
+    if (_compressor && _size >= min_compressed_entry_size) {
+        compress();
+    }
+}
+
+void commitlog_entry_writer::compress() {
+    bytes_ostream plain;
+    serialize(plain);
+
+    bytes_ostream out;
+    ser::serialize(out, compressed_entry_magic);
+    ser::serialize(out, uint32_t(_size));
+    ser::serialize(out, _compressor->name());
+
+    std::vector<char> chunk;
+    chunk.reserve(compression_chunk_size);
+    std::vector<char> compressed;
+    auto compress_chunk = [&] {
+        compressed.resize(_compressor->compress_max_size(chunk.size()));
+        auto len = _compressor->compress(chunk.data(), chunk.size(), compressed.data(), compressed.size());
+        ser::serialize(out, uint32_t(chunk.size()));
+        ser::serialize(out, uint32_t(len));
+        out.write(compressed.data(), len);
+        chunk.clear();
+    };
+    for (bytes_view frag : plain.fragments()) {
+        while (!frag.empty()) {
+            auto n = std::min(frag.size(), compression_chunk_size - chunk.size());
+            auto data = reinterpret_cast<const char*>(frag.data());
+            chunk.insert(chunk.end(), data, data + n);
+            frag.remove_prefix(n);
+            if (chunk.size() == compression_chunk_size) {
+                compress_chunk();
+            }
+        }
+    }
+    if (!chunk.empty()) {
+        compress_chunk();
+    }
+
+    if (out.size() < _size) {
+        _uncompressed_size = _size;
+        _size = out.size();
+        _compressed = std::move(out);
+    }
 }
 
 void commitlog_entry_writer::write(typename seastar::memory_output_stream<std::vector<temporary_buffer<char>>::iterator>& out) const {
+    if (_compressed) {
+        for (bytes_view frag : _compressed->fragments()) {
+            out.write(reinterpret_cast<const char*>(frag.data()), frag.size());
+        }
+        return;
+    }
     serialize(out);
 }
 
+static const compressor_ptr& get_entry_compressor(const sstring& name) {
+    static thread_local std::unordered_map<sstring, compressor_ptr> compressors;
+    auto it = compressors.find(name);
+    if (it == compressors.end()) {
+        auto c = compressor::create(name, [] (const sstring&) { return compressor::opt_string(); });
+        if (!c) {
+            throw std::runtime_error(format("Unknown compressor {} of commitlog entry", name));
+        }
+        it = compressors.emplace(name, std::move(c)).first;
+    }
+    return it->second;
+}
+
+template<typename Input>
+static commitlog_entry read_compressed_entry(Input& in) {
+    auto size = ser::deserialize(in, boost::type<uint32_t>());
+    auto& c = get_entry_compressor(ser::deserialize(in, boost::type<sstring>()));
+
+    std::vector<temporary_buffer<char>> chunks;
+    size_t total = 0;
+    std::vector<char> compressed;
+    while (total < size) {
+        auto chunk_size = ser::deserialize(in, boost::type<uint32_t>());
+        auto len = ser::deserialize(in, boost::type<uint32_t>());
+        compressed.resize(len);
+        in.read(compressed.data(), len);
+        temporary_buffer<char> chunk(chunk_size);
+        if (c->uncompress(compressed.data(), len, chunk.get_write(), chunk_size) != chunk_size) {
+            throw std::runtime_error(format("Corrupt compressed commitlog entry, chunk of {} bytes didn't uncompress to {} bytes", len, chunk_size));
+        }
+        total += chunk_size;
+        chunks.push_back(std::move(chunk));
+    }
+    if (total != size) {
+        throw std::runtime_error(format("Corrupt compressed commitlog entry, uncompressed to {} bytes instead of {}", total, size));
+    }
+
+    fragmented_temporary_buffer plain(std::move(chunks), total);
+    auto plain_in = seastar::fragmented_memory_input_stream(fragmented_temporary_buffer::view(plain).begin(), plain.size_bytes());
+    return ser::deserialize(plain_in, boost::type<commitlog_entry>());
+}
+
 commitlog_entry_reader::commitlog_entry_reader(const fragmented_temporary_buffer& buffer)
     : _ce([&] {
     auto in = seastar::fragmented_memory_input_stream(fragmented_temporary_buffer::view(buffer).begin(), buffer.size_bytes());
+    if (buffer.size_bytes() >= sizeof(uint32_t)) {
+        auto peek = in;
+        if (ser::deserialize(peek, boost::type<uint32_t>()) == commitlog_entry_writer::compressed_entry_magic) {
+            return read_compressed_entry(peek);
+        }
+    }
     return ser::deserialize(in, boost::type<commitlog_entry>());
 }())
 {
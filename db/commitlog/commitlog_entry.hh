@@ -13,6 +13,8 @@
 #include "commitlog_types.hh"
 #include "mutation/frozen_mutation.hh"
 #include "schema/schema_fwd.hh"
+#include "bytes_ostream.hh"
+#include "compress.hh"
 
 class commitlog_entry {
     std::optional<column_mapping> _mapping;
@@ -25,23 +27,52 @@ class commitlog_entry {
     frozen_mutation&& mutation() && { return std::move(_mutation); }
 };
 
+// Writes a commitlog_entry, optionally compressed.
+//
+// A compressed entry starts with compressed_entry_magic, which can't be the size
+// of a serialized commitlog_entry, followed by its uncompressed size, the name of
+// the compressor, and the serialized commitlog_entry split into chunks which are
+// compressed separately. commitlog_entry_reader tells the two apart, so compressed
+// and plain entries can be mixed in a segment.
+//
+// The writer can be given either a frozen_mutation or a mutation. A mutation is
+// serialized straight into the segment buffer, in the same format a frozen_mutation
+// of it would have, which saves freezing it into a temporary first.
 class commitlog_entry_writer {
 public:
     using force_sync = db::commitlog_force_sync;
+
+    static constexpr uint32_t compressed_entry_magic = 0xffffffff;
+    // Entries smaller than this when serialized are not worth compressing.
+    static constexpr size_t min_compressed_entry_size = 512;
+    // The size of the chunks compressed separately, so that neither writing nor
+    // reading a large entry needs large contiguous buffers.
+    static constexpr size_t compression_chunk_size = 64 * 1024;
 private:
     schema_ptr _schema;
-    const frozen_mutation& _mutation;
+    const frozen_mutation* _frozen_mutation = nullptr;
+    const mutation* _mutation = nullptr;
+    // The size of the serialized mutation, as in frozen_mutation::representation().
+    size_t _mutation_size;
     bool _with_schema = true;
     size_t _size = std::numeric_limits<size_t>::max();
     force_sync _sync;
+    compressor_ptr _compressor;
+    // The compressed entry, when compression is enabled and saves space.
+    std::optional<bytes_ostream> _compressed;
+    size_t _uncompressed_size = 0;
 private:
     template<typename Output>
     void serialize(Output&) const;
+    template<typename Output>
+    void serialize_mutation(Output&) const;
     void compute_size();
+    void compress();
 public:
     commitlog_entry_writer(schema_ptr s, const frozen_mutation& fm, force_sync sync)
-        : _schema(std::move(s)), _mutation(fm), _sync(sync)
+        : _schema(std::move(s)), _frozen_mutation(&fm), _mutation_size(fm.representation().size()), _sync(sync)
     {}
+    commitlog_entry_writer(schema_ptr s, const mutation& m, force_sync sync);
 
     void set_with_schema(bool value) {
         _with_schema = value;
@@ -50,6 +81,17 @@ class commitlog_entry_writer {
     bool with_schema() const {
         return _with_schema;
     }
+    // Entries are compressed with c, if not null, from the next call to set_with_schema() on.
+    void set_compressor(compressor_ptr c) {
+        _compressor = std::move(c);
+    }
+    bool compressed() const {
+        return bool(_compressed);
+    }
+    // The size of the entry before compression, valid only if compressed().
+    size_t uncompressed_size() const {
+        return _uncompressed_size;
+    }
     schema_ptr schema() const {
         return _schema;
     }
@@ -60,7 +102,7 @@ class commitlog_entry_writer {
     }
 
     size_t mutation_size() const {
-        return _mutation.representation().size();
+        return _mutation_size;
     }
     force_sync sync() const {
         return _sync;
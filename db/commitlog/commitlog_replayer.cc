@@ -12,9 +12,14 @@
 #include <algorithm>
 #include <unordered_map>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 
 #include "commitlog.hh"
 #include "commitlog_replayer.hh"
@@ -51,25 +56,7 @@ class db::commitlog_replayer::impl {
 
     future<> init();
 
-    struct stats {
-        uint64_t invalid_mutations = 0;
-        uint64_t skipped_mutations = 0;
-        uint64_t applied_mutations = 0;
-        uint64_t corrupt_bytes = 0;
-
-        stats& operator+=(const stats& s) {
-            invalid_mutations += s.invalid_mutations;
-            skipped_mutations += s.skipped_mutations;
-            applied_mutations += s.applied_mutations;
-            corrupt_bytes += s.corrupt_bytes;
-            return *this;
-        }
-        stats operator+(const stats& s) const {
-            stats tmp = *this;
-            tmp += s;
-            return tmp;
-        }
-    };
+    using stats = commitlog_replayer::stats;
 
     // move start/stop of the thread local bookkeep to "top level"
     // and also make sure to assert on it actually being started.
@@ -80,8 +67,47 @@ class db::commitlog_replayer::impl {
         return _column_mappings.stop();
     }
 
-    future<> process(stats*, commitlog::buffer_and_replay_position buf_rp) const;
+    // An entry read from a segment, to be applied on the shard which owns it.
+    // Only the mutation crosses shards: the column mapping of the reading shard
+    // is copied into the local _column_mappings of the applying one, since it
+    // holds types which can't be shared between shards.
+    struct replay_entry {
+        frozen_mutation fm;
+        // The mapping of the entry's schema version, in _column_mappings of the reading shard.
+        const column_mapping* src_cm;
+        replay_position rp;
+    };
+
+    // Entries of a segment which belong to the same shard are sent there in batches,
+    // so that replay doesn't pay for a cross-shard round trip per mutation, and a few
+    // batches are applied while the rest of the segment is being read.
+    class apply_batches {
+        const impl& _impl;
+        stats& _stats;
+        std::vector<std::vector<replay_entry>> _pending;
+        std::vector<size_t> _pending_bytes;
+        semaphore _in_flight;
+    private:
+        future<> send(unsigned shard);
+    public:
+        static constexpr size_t max_batch_entries = 256;
+        static constexpr size_t max_batch_bytes = 1024 * 1024;
+        static constexpr size_t max_in_flight = 8;
+
+        apply_batches(const impl& i, stats& s);
+
+        future<> add(unsigned shard, replay_entry e, size_t bytes);
+        // Sends the remaining entries and waits for all batches to be applied.
+        future<> flush();
+    };
+
+    // The number of segments each shard replays at a time.
+    static constexpr size_t max_concurrent_segments = 4;
+
+    future<> process(stats*, apply_batches&, commitlog::buffer_and_replay_position buf_rp) const;
     future<stats> recover(sstring file, const sstring& fname_prefix) const;
+    future<stats> apply(replica::database& db, std::vector<replay_entry> batch) const;
+    future<> apply(replica::database& db, replay_entry& e) const;
 
     typedef std::unordered_map<table_id, replay_position> rp_map;
     typedef std::unordered_map<unsigned, rp_map> shard_rpm_map;
@@ -163,31 +189,80 @@ db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix)
 
     if (rp.id < gp.id) {
         rlogger.debug("skipping replay of fully-flushed {}", file);
-        return make_ready_future<stats>();
+        co_return stats();
     }
     position_type p = 0;
     if (rp.id == gp.id) {
         p = gp.pos;
     }
 
-    auto s = make_lw_shared<stats>();
+    stats s;
+    apply_batches batches(*this, s);
     auto& exts = _db.local().extensions();
+    std::exception_ptr ex;
 
-    return db::commitlog::read_log_file(file, fname_prefix,
-            std::bind(&impl::process, this, s.get(), std::placeholders::_1),
-            p, &exts).then_wrapped([s](future<> f) {
-        try {
-            f.get();
-        } catch (commitlog::segment_data_corruption_error& e) {
-            s->corrupt_bytes += e.bytes();
-        } catch (...) {
-            throw;
+    try {
+        co_await db::commitlog::read_log_file(file, fname_prefix, [this, &s, &batches] (commitlog::buffer_and_replay_position buf_rp) {
+            return process(&s, batches, std::move(buf_rp));
+        }, p, &exts);
+    } catch (commitlog::segment_data_corruption_error& e) {
+        s.corrupt_bytes += e.bytes();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await batches.flush();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+    co_return s;
+}
+
+db::commitlog_replayer::impl::apply_batches::apply_batches(const impl& i, stats& s)
+    : _impl(i)
+    , _stats(s)
+    , _pending(smp::count)
+    , _pending_bytes(smp::count, 0)
+    , _in_flight(max_in_flight)
+{}
+
+future<> db::commitlog_replayer::impl::apply_batches::add(unsigned shard, replay_entry e, size_t bytes) {
+    _pending[shard].push_back(std::move(e));
+    _pending_bytes[shard] += bytes;
+    if (_pending[shard].size() >= max_batch_entries || _pending_bytes[shard] >= max_batch_bytes) {
+        return send(shard);
+    }
+    return make_ready_future<>();
+}
+
+future<> db::commitlog_replayer::impl::apply_batches::send(unsigned shard) {
+    auto batch = std::exchange(_pending[shard], {});
+    _pending_bytes[shard] = 0;
+    const auto size = batch.size();
+    auto units = co_await get_units(_in_flight, 1);
+    // Applied in the background, flush() waits for all units to be returned.
+    (void)_impl._db.invoke_on(shard, [&impl = _impl, batch = std::move(batch)] (replica::database& db) mutable {
+        return impl.apply(db, std::move(batch));
+    }).then_wrapped([this, size, units = std::move(units)] (future<stats> f) {
+        if (f.failed()) {
+            _stats.invalid_mutations += size;
+            rlogger.warn("error replaying: {}", f.get_exception());
+        } else {
+            _stats += f.get();
         }
-        return make_ready_future<stats>(*s);
     });
 }
 
-future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_replay_position buf_rp) const {
+future<> db::commitlog_replayer::impl::apply_batches::flush() {
+    for (unsigned shard = 0; shard < _pending.size(); ++shard) {
+        if (!_pending[shard].empty()) {
+            co_await send(shard);
+        }
+    }
+    co_await _in_flight.wait(max_in_flight);
+    _in_flight.signal(max_in_flight);
+}
+
+future<> db::commitlog_replayer::impl::process(stats* s, apply_batches& batches, commitlog::buffer_and_replay_position buf_rp) const {
     auto&& buf = buf_rp.buffer;
     auto&& rp = buf_rp.position;
     try {
@@ -225,51 +300,7 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
         auto& table = _db.local().find_column_family(uuid);
         const auto& schema = *table.schema();
         auto shard = table.get_effective_replication_map()->shard_of(schema, fm.token(schema));
-        return _db.invoke_on(shard, [this, cer = std::move(cer), &src_cm, rp] (replica::database& db) mutable -> future<> {
-            auto& fm = cer.mutation();
-            // TODO: might need better verification that the deserialized mutation
-            // is schema compatible. My guess is that just applying the mutation
-            // will not do this.
-            auto& cf = db.find_column_family(fm.column_family_id());
-
-            if (rlogger.is_enabled(logging::log_level::debug)) {
-                rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
-                        cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
-            }
-            if (const auto err = validation::is_cql_key_invalid(*cf.schema(), fm.key()); err) {
-                throw std::runtime_error(fmt::format("found entry with invalid key {} at {} v={} {}:{} at {}: {}.", fm.key(), fm.column_family_id(),
-                        fm.schema_version(), cf.schema()->ks_name(), cf.schema()->cf_name(), rp, *err));
-            }
-            // Removed forwarding "new" RP. Instead give none/empty.
-            // This is what origin does, and it should be fine.
-            // The end result should be that once sstables are flushed out
-            // their "replay_position" attribute will be empty, which is
-            // lower than anything the new session will produce.
-            if (cf.schema()->version() != fm.schema_version()) {
-                auto& local_cm = _column_mappings.local().map;
-                auto cm_it = local_cm.try_emplace(fm.schema_version(), src_cm).first;
-                const column_mapping& cm = cm_it->second;
-                mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
-                converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
-                fm.partition().accept(cm, v);
-                return do_with(std::move(m), [&db, &cf] (const mutation& m) {
-                    return db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
-                });
-            } else {
-                return do_with(std::move(cer).mutation(), [&](const frozen_mutation& m) {
-                    return db.apply_in_memory(m, cf.schema(), db::rp_handle(), db::no_timeout);
-                });
-            }
-        }).then_wrapped([s] (future<> f) {
-            try {
-                f.get();
-                s->applied_mutations++;
-            } catch (...) {
-                s->invalid_mutations++;
-                // TODO: write mutation to file like origin.
-                rlogger.warn("error replaying: {}", std::current_exception());
-            }
-        });
+        return batches.add(shard, replay_entry{std::move(cer).mutation(), &src_cm, rp}, buf.size_bytes());
     } catch (replica::no_such_column_family&) {
         // No such CF now? Origin just ignores this.
     } catch (...) {
@@ -281,12 +312,63 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
     return make_ready_future<>();
 }
 
+future<db::commitlog_replayer::impl::stats>
+db::commitlog_replayer::impl::apply(replica::database& db, std::vector<replay_entry> batch) const {
+    stats s;
+    for (auto& e : batch) {
+        try {
+            co_await apply(db, e);
+            s.applied_mutations++;
+        } catch (...) {
+            s.invalid_mutations++;
+            // TODO: write mutation to file like origin.
+            rlogger.warn("error replaying: {}", std::current_exception());
+        }
+        co_await coroutine::maybe_yield();
+    }
+    co_return s;
+}
+
+future<> db::commitlog_replayer::impl::apply(replica::database& db, replay_entry& e) const {
+    auto& fm = e.fm;
+    // TODO: might need better verification that the deserialized mutation
+    // is schema compatible. My guess is that just applying the mutation
+    // will not do this.
+    auto& cf = db.find_column_family(fm.column_family_id());
+
+    if (rlogger.is_enabled(logging::log_level::debug)) {
+        rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
+                cf.schema()->ks_name(), cf.schema()->cf_name(), e.rp);
+    }
+    if (const auto err = validation::is_cql_key_invalid(*cf.schema(), fm.key()); err) {
+        throw std::runtime_error(fmt::format("found entry with invalid key {} at {} v={} {}:{} at {}: {}.", fm.key(), fm.column_family_id(),
+                fm.schema_version(), cf.schema()->ks_name(), cf.schema()->cf_name(), e.rp, *err));
+    }
+    // Removed forwarding "new" RP. Instead give none/empty.
+    // This is what origin does, and it should be fine.
+    // The end result should be that once sstables are flushed out
+    // their "replay_position" attribute will be empty, which is
+    // lower than anything the new session will produce.
+    if (cf.schema()->version() != fm.schema_version()) {
+        auto& local_cm = _column_mappings.local().map;
+        auto cm_it = local_cm.try_emplace(fm.schema_version(), *e.src_cm).first;
+        const column_mapping& cm = cm_it->second;
+        mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
+        converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
+        fm.partition().accept(cm, v);
+        co_await db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
+    } else {
+        co_await db.apply_in_memory(fm, cf.schema(), db::rp_handle(), db::no_timeout);
+    }
+}
+
 db::commitlog_replayer::commitlog_replayer(seastar::sharded<replica::database>& db, seastar::sharded<db::system_keyspace>& sys_ks)
     : _impl(std::make_unique<impl>(db, sys_ks))
 {}
 
 db::commitlog_replayer::commitlog_replayer(commitlog_replayer&& r) noexcept
     : _impl(std::move(r._impl))
+    , _stats(r._stats)
 {}
 
 db::commitlog_replayer::~commitlog_replayer()
@@ -319,12 +401,12 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
             return map_reduce(smp::all_cpus(), [this, map, &fname_prefix] (unsigned id) {
                 return smp::submit_to(id, [this, id, map, &fname_prefix] () {
                     auto total = ::make_lw_shared<impl::stats>();
-                    // TODO: or something. For now, we do this serialized per shard,
-                    // to reduce mutation congestion. We could probably (says avi)
-                    // do 2 segments in parallel or something, but lets use this first.
+                    // A few segments at a time, each applying its entries in batches,
+                    // see impl::apply_batches.
                     auto range = map->equal_range(id);
-                    return do_for_each(range.first, range.second, [this, total, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
-                        auto&f = p.second;
+                    auto shard_files = boost::copy_range<std::vector<sstring>>(boost::make_iterator_range(range.first, range.second) | boost::adaptors::map_values);
+                    return do_with(std::move(shard_files), [this, total, &fname_prefix] (std::vector<sstring>& shard_files) {
+                      return max_concurrent_for_each(shard_files, impl::max_concurrent_segments, [this, total, &fname_prefix] (const sstring& f) {
                         rlogger.debug("Replaying {}", f);
                         return _impl->recover(f, fname_prefix).then([f, total](impl::stats stats) {
                             if (stats.corrupt_bytes != 0) {
@@ -338,11 +420,13 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
                             );
                             *total += stats;
                         });
+                      });
                     }).then([total] {
                         return make_ready_future<impl::stats>(*total);
                     });
                 });
-            }, impl::stats(), std::plus<impl::stats>()).then([](impl::stats totals) {
+            }, impl::stats(), std::plus<impl::stats>()).then([this] (impl::stats totals) {
+                _stats = totals;
                 rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped)"
                                 , totals.applied_mutations
                                 , totals.invalid_mutations
@@ -26,6 +26,26 @@ class system_keyspace;
 
 class commitlog_replayer {
 public:
+    struct stats {
+        uint64_t invalid_mutations = 0;
+        uint64_t skipped_mutations = 0;
+        uint64_t applied_mutations = 0;
+        uint64_t corrupt_bytes = 0;
+
+        stats& operator+=(const stats& s) {
+            invalid_mutations += s.invalid_mutations;
+            skipped_mutations += s.skipped_mutations;
+            applied_mutations += s.applied_mutations;
+            corrupt_bytes += s.corrupt_bytes;
+            return *this;
+        }
+        stats operator+(const stats& s) const {
+            stats tmp = *this;
+            tmp += s;
+            return tmp;
+        }
+    };
+
     commitlog_replayer(commitlog_replayer&&) noexcept;
     ~commitlog_replayer();
 
@@ -34,11 +54,17 @@ class commitlog_replayer {
     future<> recover(std::vector<sstring> files, sstring fname_prefix);
     future<> recover(sstring file, sstring fname_prefix);
 
+    // Totals of the last recover().
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+
 private:
     commitlog_replayer(seastar::sharded<replica::database>&, seastar::sharded<db::system_keyspace>&);
 
     class impl;
     std::unique_ptr<impl> _impl;
+    stats _stats;
 };
 
 }
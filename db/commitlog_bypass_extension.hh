@@ -0,0 +1,69 @@
+/*
+ * Copyright 2026-present ScyllaDB
+ */
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "serializer.hh"
+#include "schema/schema.hh"
+#include "exceptions/exceptions.hh"
+#include "log.hh"
+
+extern logging::logger dblog;
+
+namespace db {
+
+/**
+ * \brief Schema extension which represents `commitlog_bypass` per-table option.
+ *
+ * Writes to a table with the option set are applied to memtables only, even
+ * if the keyspace has durable_writes enabled. Their durability comes from
+ * replication: data which wasn't flushed when a node stops uncleanly is lost
+ * on that node, and is brought back by repairing the table once the node
+ * restarts (see system_keyspace::commitlog_bypass_dirty()).
+ */
+class commitlog_bypass_extension : public schema_extension {
+    bool _bypass = false;
+public:
+    static constexpr auto NAME = "commitlog_bypass";
+
+    commitlog_bypass_extension() = default;
+
+    explicit commitlog_bypass_extension(bool bypass)
+        : _bypass(bypass)
+    {}
+
+    explicit commitlog_bypass_extension(const std::map<sstring, sstring>& map) {
+        on_internal_error(dblog, "Cannot create commitlog_bypass_extension from map");
+    }
+
+    explicit commitlog_bypass_extension(bytes b) : _bypass(deserialize(b))
+    {}
+
+    explicit commitlog_bypass_extension(const sstring& s) {
+        if (boost::iequals(s, "true")) {
+            _bypass = true;
+        } else if (!boost::iequals(s, "false")) {
+            throw exceptions::configuration_exception(format("Invalid value for {}: {}, expected true or false", NAME, s));
+        }
+    }
+
+    bytes serialize() const override {
+        return ser::serialize_to_buffer<bytes>(_bypass);
+    }
+
+    static bool deserialize(const bytes_view& buffer) {
+        return ser::deserialize_from_buffer(buffer, boost::type<bool>());
+    }
+
+    bool get_commitlog_bypass() const {
+        return _bypass;
+    }
+};
+
+} // namespace db
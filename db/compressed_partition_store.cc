@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "db/compressed_partition_store.hh"
+#include "mutation/frozen_mutation.hh"
+#include "mutation/mutation.hh"
+#include "utils/allocation_strategy.hh"
+
+#include <lz4.h>
+
+compressed_partition_store::~compressed_partition_store() {
+    clear();
+}
+
+void compressed_partition_store::erase(partitions_type& partitions, partitions_type::iterator it) noexcept {
+    entry& e = it->second;
+    _memory_usage -= e.memory_usage();
+    _lru.erase(_lru.iterator_to(e));
+    // The row cache invalidates entries under its own allocator.
+    with_allocator(standard_allocator(), [&] {
+        partitions.erase(it);
+    });
+}
+
+void compressed_partition_store::shrink(size_t capacity) noexcept {
+    while (_memory_usage > capacity && !_lru.empty()) {
+        entry& e = _lru.front();
+        auto& partitions = _tables.at(e._table);
+        auto [it, end] = partitions.equal_range(e._key.token());
+        while (&it->second != &e) {
+            ++it;
+        }
+        erase(partitions, it);
+        ++_stats.evictions;
+    }
+}
+
+bool compressed_partition_store::insert(const mutation& m, size_t capacity) {
+    frozen_mutation fm(m);
+    const bytes_ostream& rep = fm.representation();
+    if (rep.size() > max_partition_size) {
+        return false;
+    }
+    bytes raw(bytes::initialized_later(), rep.size());
+    auto out = raw.begin();
+    for (bytes_view fragment : rep) {
+        out = std::copy(fragment.begin(), fragment.end(), out);
+    }
+    bytes buf(bytes::initialized_later(), LZ4_compressBound(raw.size()));
+    auto len = LZ4_compress_default(reinterpret_cast<const char*>(raw.data()), reinterpret_cast<char*>(buf.data()), raw.size(), buf.size());
+    if (len <= 0) {
+        return false;
+    }
+
+    auto& partitions = _tables[m.schema()->id()];
+    invalidate(m.schema()->id(), m.decorated_key());
+    auto it = partitions.emplace(m.token(), entry{
+        ._table = m.schema()->id(),
+        ._key = m.decorated_key(),
+        ._schema = m.schema(),
+        ._data = bytes(buf.begin(), len),
+        ._size = raw.size(),
+    });
+    _lru.push_back(it->second);
+    _memory_usage += it->second.memory_usage();
+    ++_stats.insertions;
+    shrink(capacity);
+    return true;
+}
+
+std::optional<mutation> compressed_partition_store::take(const schema_ptr& s, const dht::decorated_key& dk) {
+    auto t = _tables.find(s->id());
+    if (t == _tables.end()) {
+        return std::nullopt;
+    }
+    auto& partitions = t->second;
+    auto [it, end] = partitions.equal_range(dk.token());
+    while (it != end && !it->second._key.equal(*s, dk)) {
+        ++it;
+    }
+    if (it == end) {
+        return std::nullopt;
+    }
+    entry& e = it->second;
+    bytes raw(bytes::initialized_later(), e._size);
+    auto len = LZ4_decompress_safe(reinterpret_cast<const char*>(e._data.data()), reinterpret_cast<char*>(raw.data()), e._data.size(), raw.size());
+    schema_ptr entry_schema = e._schema;
+    erase(partitions, it);
+    if (len < 0 || size_t(len) != raw.size()) {
+        throw std::runtime_error(format("compressed_partition_store: failed to decompress partition {} of {}.{}",
+                dk, s->ks_name(), s->cf_name()));
+    }
+    bytes_ostream b;
+    b.write(raw);
+    mutation m = frozen_mutation(std::move(b)).unfreeze(entry_schema);
+    if (m.schema() != s) {
+        m.upgrade(s);
+    }
+    ++_stats.hits;
+    return m;
+}
+
+void compressed_partition_store::invalidate(table_id table, const dht::decorated_key& dk) noexcept {
+    auto t = _tables.find(table);
+    if (t == _tables.end()) {
+        return;
+    }
+    auto& partitions = t->second;
+    auto [it, end] = partitions.equal_range(dk.token());
+    while (it != end) {
+        auto next = std::next(it);
+        if (it->second._key.equal(*it->second._schema, dk)) {
+            erase(partitions, it);
+            ++_stats.invalidations;
+        }
+        it = next;
+    }
+}
+
+void compressed_partition_store::invalidate(table_id table, const dht::partition_range& range) noexcept {
+    auto t = _tables.find(table);
+    if (t == _tables.end()) {
+        return;
+    }
+    // Conservative, drops all entries whose tokens fall into the range.
+    auto& partitions = t->second;
+    auto it = range.start() ? partitions.lower_bound(range.start()->value().token()) : partitions.begin();
+    auto end = range.end() ? partitions.upper_bound(range.end()->value().token()) : partitions.end();
+    while (it != end) {
+        erase(partitions, it++);
+        ++_stats.invalidations;
+    }
+}
+
+void compressed_partition_store::clear(table_id table) noexcept {
+    auto t = _tables.find(table);
+    if (t == _tables.end()) {
+        return;
+    }
+    auto& partitions = t->second;
+    while (!partitions.empty()) {
+        erase(partitions, partitions.begin());
+    }
+    _tables.erase(t);
+}
+
+void compressed_partition_store::clear() noexcept {
+    for (auto& [table, partitions] : _tables) {
+        while (!partitions.empty()) {
+            erase(partitions, partitions.begin());
+        }
+    }
+    _tables.clear();
+}
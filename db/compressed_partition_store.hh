@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <boost/intrusive/list.hpp>
+
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+#include "bytes.hh"
+#include "dht/i_partitioner.hh"
+#include "schema/schema_fwd.hh"
+
+class mutation;
+
+// Holds serialized, lz4-compressed copies of complete partitions which were
+// demoted from the row cache to save memory, see cache_tracker::compress_cold_partitions().
+//
+// Those copies are several times smaller than the partitions in cache, at the cost
+// of decoding them when they're read again, which is still much cheaper than a disk read.
+//
+// The store doesn't follow changes to the underlying mutation source by itself.
+// An entry must be equal to what the cache would read from the underlying source,
+// so the cache drops the entries of partitions which it updates or invalidates.
+//
+// Entries live in the standard allocator. When the store grows above the capacity
+// it's given, the entries which were stored the longest time ago are dropped.
+class compressed_partition_store {
+public:
+    struct stats {
+        uint64_t insertions = 0;
+        uint64_t hits = 0;
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;
+    };
+    // Partitions which are larger than this when serialized are not stored.
+    static constexpr size_t max_partition_size = 1 << 20;
+private:
+    struct entry {
+        boost::intrusive::list_member_hook<> _lru_link;
+        table_id _table;
+        dht::decorated_key _key;
+        schema_ptr _schema;
+        bytes _data; // lz4-compressed frozen_mutation
+        size_t _size; // size of the frozen_mutation
+
+        size_t memory_usage() const noexcept {
+            return sizeof(entry) + _data.size() + _key.external_memory_usage();
+        }
+    };
+    using partitions_type = std::multimap<dht::token, entry>;
+    using lru_type = boost::intrusive::list<entry,
+        boost::intrusive::member_hook<entry, boost::intrusive::list_member_hook<>, &entry::_lru_link>>;
+
+    std::unordered_map<table_id, partitions_type> _tables;
+    lru_type _lru;
+    size_t _memory_usage = 0;
+    stats _stats;
+private:
+    void erase(partitions_type& partitions, partitions_type::iterator it) noexcept;
+    void shrink(size_t capacity) noexcept;
+public:
+    compressed_partition_store() = default;
+    compressed_partition_store(compressed_partition_store&&) = delete;
+    ~compressed_partition_store();
+
+    // Stores a compressed copy of m, which must be complete, replacing the existing one.
+    // Then drops the oldest entries until memory_usage() is within capacity.
+    // Returns false if m wasn't stored because it's too large.
+    bool insert(const mutation& m, size_t capacity);
+
+    // Removes the partition of the given table from the store and returns its
+    // contents converted to schema s, if it's there.
+    std::optional<mutation> take(const schema_ptr& s, const dht::decorated_key&);
+
+    // Drops the entries of the given table which fall into the range.
+    void invalidate(table_id, const dht::decorated_key&) noexcept;
+    void invalidate(table_id, const dht::partition_range&) noexcept;
+
+    void clear(table_id) noexcept;
+    void clear() noexcept;
+
+    size_t memory_usage() const noexcept { return _memory_usage; }
+    size_t size() const noexcept { return _lru.size(); }
+    const stats& get_stats() const noexcept { return _stats; }
+};
@@ -25,6 +25,7 @@
 #include "cdc/cdc_extension.hh"
 #include "tombstone_gc_extension.hh"
 #include "db/per_partition_rate_limit_extension.hh"
+#include "db/commitlog_bypass_extension.hh"
 #include "config.hh"
 #include "extensions.hh"
 #include "log.hh"
@@ -341,6 +342,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
         "If set to true, enforce the min_threshold option for compactions strictly. If false (default), Scylla may decide to compact even if below min_threshold")
+    , compaction_tables_concurrency(this, "compaction_tables_concurrency", liveness::LiveUpdate, value_status::Used, 4,
+        "The maximum number of tables a keyspace-wide major compaction, cleanup, off-strategy compaction, upgrade or recompression works on at a time, on each shard. The sstables are still rewritten one at a time, but the per-table work around it (flushing, stopping the ongoing compactions, selecting the sstables) overlaps, so small tables don't wait behind large ones. Set to 1 to go through the tables one by one.")
+    , keyspace_service_levels(this, "keyspace_service_levels", liveness::LiveUpdate, value_status::Used, {},
+        "Attributes keyspaces to service levels, e.g. {\"ks1\": \"sl1\"}. The compaction of the tables of a keyspace contributes to the compaction backlog, from which the compaction controller derives how much CPU and disk bandwidth compaction gets, in proportion to the shares option of the keyspace's service level (1000, the maximum, when not set). A tenant with low shares can't then raise the priority of compaction as a whole with a compaction storm of its own. Keyspaces not listed count with 1000 shares.")
     /**
     * @Group Initialization properties
     * @GroupDescription The minimal properties needed for configuring a cluster.
@@ -445,6 +450,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , compaction_throughput_mb_per_sec(this, "compaction_throughput_mb_per_sec", liveness::LiveUpdate, value_status::Used, 0,
         "Throttles compaction to the specified total throughput across the entire system. The faster you insert data, the faster you need to compact in order to keep the SSTable count down. The recommended Value is 16 to 32 times the rate of write throughput (in MBs/second). Setting the value to 0 disables compaction throttling.\n"
         "Related information: Configuring compaction")
+    , major_compaction_max_parallelism(this, "major_compaction_max_parallelism", liveness::LiveUpdate, value_status::Used, 1,
+        "The maximum number of concurrent sub-compactions a major compaction is split into. Each sub-compaction compacts a disjoint token sub-range of the input, and the output of all of them replaces the input at once, when they are all done. Splitting lets a large major compaction use more of the disk bandwidth than a single compaction can. Setting the value to 1 disables splitting.")
+    , major_compaction_min_split_size_in_mb(this, "major_compaction_min_split_size_in_mb", liveness::LiveUpdate, value_status::Used, 1024,
+        "The minimum amount of input data, in megabytes, for each sub-compaction of a major compaction. Major compactions with less input than this per sub-compaction are split less, or not at all.")
+    , compaction_index_cache_warming(this, "compaction_index_cache_warming", liveness::LiveUpdate, value_status::Used, false,
+        "When enabled, the index pages which are hot in the index cache of the sstables being compacted are loaded into the index cache of the compaction output before the output replaces them, so that reads of those partitions don't miss the cache right after compaction. Costs some index reads at the end of each compaction.")
+    , compaction_read_amplification_threshold(this, "compaction_read_amplification_threshold", liveness::LiveUpdate, value_status::Used, 0,
+        "If set to higher than 0, the compaction controller also considers the average number of sstables read by single partition reads: above this many sstables per read, compaction shares grow with the read amplification, reaching the maximum at four times this value, even if the compaction backlog is low. Ignored when compaction_static_shares is set.")
     , compaction_large_partition_warning_threshold_mb(this, "compaction_large_partition_warning_threshold_mb", liveness::LiveUpdate, value_status::Used, 1000,
         "Log a warning when writing partitions larger than this value")
     , compaction_large_row_warning_threshold_mb(this, "compaction_large_row_warning_threshold_mb", liveness::LiveUpdate, value_status::Used, 10,
@@ -510,6 +523,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     /* Note: does not exist on the listing page other than in above comment, wtf? */
     , commitlog_sync_batch_window_in_ms(this, "commitlog_sync_batch_window_in_ms", value_status::Used, 10000,
         "Controls how long the system waits for other writes before performing a sync in \"batch\" mode.")
+    , commitlog_sync_batch_group_commit_max_wait_in_us(this, "commitlog_sync_batch_group_commit_max_wait_in_us", value_status::Used, 0,
+        "The maximum time, in microseconds, a write in \"batch\" mode waits for other writes to share its sync. The actual wait adapts to the rate of writes and to the time a sync takes, "
+        "and is zero when writes are too sparse to share syncs. Waiting increases the latency of writes, in exchange for fewer syncs. 0 disables waiting.")
     , commitlog_total_space_in_mb(this, "commitlog_total_space_in_mb", value_status::Used, -1,
         "Total space used for commitlogs. If the used space goes above this value, Scylla rounds up to the next nearest segment multiple and flushes memtables to disk for the oldest commitlog segments, removing those log segments. This reduces the amount of data to replay on startup, and prevents infrequently-updated tables from indefinitely keeping commitlog segments. A small total commitlog space tends to cause more flush activity on less-active tables.\n"
         "Related information: Configuring memtable throughput")
@@ -522,6 +538,19 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Whether or not to use O_DSYNC mode for commitlog segments IO. Can improve commitlog latency on some file systems.\n")
     , commitlog_use_hard_size_limit(this, "commitlog_use_hard_size_limit", value_status::Used, false,
         "Whether or not to use a hard size limit for commitlog disk usage. Default is false. Enabling this can cause latency spikes, whereas the default can lead to occasional disk usage peaks.\n")
+    , commitlog_compression(this, "commitlog_compression", value_status::Used, "",
+        "The compressor used for commitlog entries, e.g. LZ4Compressor or ZstdCompressor. Entries which don't shrink when compressed are written as is. Empty disables compression.\n"
+        "Segments with compressed entries can't be replayed by versions which don't support it, so drain the node before downgrading.")
+    , commitlog_dedicated_segment_streams(this, "commitlog_dedicated_segment_streams", value_status::Used, 0,
+        "The number of tables, per shard, which get commitlog segments of their own instead of sharing them with other tables. The tables written to the most are picked, and re-picked every commitlog_sync_period_in_ms. "
+        "A segment is freed only once all tables which wrote to it are flushed, so with shared segments a slowly written table makes commitlog pressure force flushes of the others. 0 disables.")
+    , commitlog_reserve_segments(this, "commitlog_reserve_segments", value_status::Used, 1,
+        "The minimum number of commitlog segments, per shard, kept allocated and ready to be used, so that writes don't wait for a new segment to be created (and zero-filled, with commitlog_use_o_dsync).")
+    , commitlog_max_reserve_segments(this, "commitlog_max_reserve_segments", value_status::Used, 12,
+        "The maximum number of commitlog segments, per shard, kept allocated and ready to be used. The reserve never grows over the commitlog disk limit.")
+    , commitlog_reserve_lookahead_in_ms(this, "commitlog_reserve_lookahead_in_ms", value_status::Used, 1000,
+        "Size the commitlog segment reserve to hold what is written over this many milliseconds at the write rate measured every commitlog_sync_period_in_ms, "
+        "or over the time it takes to make a new segment ready if that is longer. 0 only grows the reserve by one segment whenever a write waits for a new segment.")
     /**
     * @Group Compaction settings
     * @GroupDescription Related information: Configuring compaction
@@ -563,8 +592,20 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     */
     , column_index_size_in_kb(this, "column_index_size_in_kb", value_status::Used, 64,
         "Granularity of the index of rows within a partition. For huge rows, decrease this setting to improve seek time. If you use key cache, be careful not to make this setting too large because key cache will be overwhelmed. If you're unsure of the size of the rows, it's best to use the default setting.")
+    , column_index_initial_size_in_kb(this, "column_index_initial_size_in_kb", liveness::LiveUpdate, value_status::Used, 0,
+        "Granularity of the index of rows at the start of each partition. Following index blocks double in size up to column_index_size_in_kb. Smaller values let reads which start in the middle of partitions smaller than column_index_size_in_kb, such as paged reads, skip the rows before their start, at the cost of a few more index entries per partition. Set to 0 to use column_index_size_in_kb for all blocks.")
     , column_index_auto_scale_threshold_in_kb(this, "column_index_auto_scale_threshold_in_kb", liveness::LiveUpdate, value_status::Used, 10240,
         "Auto-reduce the promoted index granularity by half when reaching this threshold, to prevent promoted index bloating due to partitions with too many rows. Set to 0 to disable this feature.")
+    , enable_sstable_clustering_filter(this, "enable_sstable_clustering_filter", liveness::LiveUpdate, value_status::Used, false,
+        "Write a bloom filter over the primary keys of the rows of partitions which have a promoted index into new SSTables. Single row reads use it to skip SSTables which contain the partition but not the row, without reading the promoted index.")
+    , enable_sstable_column_value_stats(this, "enable_sstable_column_value_stats", liveness::LiveUpdate, value_status::Used, false,
+        "Record the number of nulls and the smallest and largest value of every atomic regular column in the Scylla component of new SSTables. Nothing reads these statistics yet, so keep this disabled unless they are needed for inspecting SSTables with scylla-sstable, as collecting them costs a comparison per cell written.")
+    , sstable_write_batch_size_in_kb(this, "sstable_write_batch_size_in_kb", liveness::LiveUpdate, value_status::Used, 0,
+        "Size of the writes issued for the data and index components of new SSTables. Sizes of 1024 to 4096 raise the write bandwidth of flushes and compactions on fast disks. When set, data files are also preallocated in extents sized after the estimated SSTable size, to reduce fragmentation and filesystem metadata updates. Set to 0 to use the regular SSTable buffer size and preallocation.")
+    , sstable_write_behind(this, "sstable_write_behind", liveness::LiveUpdate, value_status::Used, 10,
+        "Maximum number of writes in flight for each data or index component of an SSTable being written.")
+    , sstable_index_read_ahead_in_kb(this, "sstable_index_read_ahead_in_kb", value_status::Used, 64,
+        "Maximum amount of SSTable index data read ahead in the background when the index is read sequentially, such as during range scans. Applies to SSTables opened after the change. Set to 0 to disable.")
     , index_summary_capacity_in_mb(this, "index_summary_capacity_in_mb", value_status::Unused, 0,
         "Fixed memory pool size in MB for SSTable index summaries. If the memory usage of all index summaries exceeds this limit, any SSTables with low read rates shrink their index summaries to meet this limit. This is a best-effort process. In extreme conditions, Cassandra may need to use more than this amount of memory.")
     , index_summary_resize_interval_in_minutes(this, "index_summary_resize_interval_in_minutes", value_status::Unused, 60,
@@ -584,6 +625,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Throttles streaming I/O to the specified total throughput (in MiBs/s) across the entire system. Streaming I/O includes the one performed by repair and both RBNO and legacy topology operations such as adding or removing a node. Setting the value to 0 disables stream throttling")
     , stream_plan_ranges_fraction(this, "stream_plan_ranges_fraction", liveness::LiveUpdate, value_status::Used, 0.1,
         "Specify the fraction of ranges to stream in a single stream plan. Value is between 0 and 1.")
+    , enable_file_streaming(this, "enable_file_streaming", liveness::LiveUpdate, value_status::Used, false,
+        "When migrating a tablet, send the sstables which contain only data of the tablet as files, as-is, instead of reading them and writing them again on the receiver. Requires all nodes to support it. Not used for tables with materialized views or non-local storage.")
+    , stream_fragment_batch_max_size_in_kb(this, "stream_fragment_batch_max_size_in_kb", liveness::LiveUpdate, value_status::Used, 1024,
+        "The maximum size of a batch of mutation fragments sent as a single message by streaming. Batches grow up to this size while the connection to the peer is the bottleneck, which makes internode_compression more effective. Set to 0 to send fragments one by one.")
+    , enable_pipelined_load_and_stream(this, "enable_pipelined_load_and_stream", liveness::LiveUpdate, value_status::Used, true,
+        "When loading sstables with load_and_stream, spread the uploaded sstables evenly across all shards by size and stream the sstables of a shard in batches of up to 256 with a single reader each, reading the next mutation fragment while the previous one is being sent to the replicas. When disabled, every shard streams the sstables it found in batches of 16.")
     , trickle_fsync(this, "trickle_fsync", value_status::Unused, false,
         "When doing sequential writing, enabling this option tells fsync to force the operating system to flush the dirty buffers at a set interval trickle_fsync_interval_in_kb. Enable this parameter to avoid sudden dirty buffer flushing from impacting read latencies. Recommended to use on SSDs, but not on HDDs.")
     , trickle_fsync_interval_in_kb(this, "trickle_fsync_interval_in_kb", value_status::Unused, 10240,
@@ -690,6 +737,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , write_request_timeout_in_ms(this, "write_request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 2000,
         "The time in milliseconds that the coordinator waits for write operations to complete.\n"
         "Related information: About hinted handoff writes")
+    , write_batching_window_in_us(this, "write_batching_window_in_us", liveness::LiveUpdate, value_status::Used, 0,
+        "The time in microseconds for which the coordinator holds a write to a remote replica, so that writes to the same replica issued within that window are sent together in a single message. "
+        "Each write is still acknowledged separately, and is never held past its own timeout. Useful for workloads of many small writes, where the number of messages rather than their size limits throughput. "
+        "0 disables batching.")
+    , background_write_timeout_in_ms(this, "background_write_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 0,
+        "The time in milliseconds that the coordinator waits for the remaining replicas of a write after its consistency level was achieved and the client got its response. "
+        "Such writes release their admission resources right away, and the replicas which did not respond in time are hinted, as on a write timeout. "
+        "Lower values free the coordinator's memory sooner when a replica is slow, at the cost of more hints. 0 waits for the whole write_request_timeout_in_ms, and keeps the resources until then.")
     , request_timeout_in_ms(this, "request_timeout_in_ms", liveness::LiveUpdate, value_status::Used, 10000,
         "The default timeout for other, miscellaneous operations.\n"
         "Related information: About hinted handoff writes")
@@ -716,8 +771,16 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\tall: All traffic is compressed.\n"
         "\tdc : Traffic between data centers is compressed.\n"
         "\tnone : No compression.")
+    , internode_compression_inter_dc_algorithm(this, "internode_compression_inter_dc_algorithm", value_status::Used, "lz4",
+        "The algorithm used to compress traffic between data centers, when internode_compression enables it. "
+        "zstd compresses considerably better than lz4, at a higher CPU cost; it is only used between nodes which both set it, others keep using lz4. Traffic within a data center always uses lz4.",
+        {"lz4", "zstd"})
     , inter_dc_tcp_nodelay(this, "inter_dc_tcp_nodelay", value_status::Used, false,
         "Enable or disable tcp_nodelay for inter-data center communication. When disabled larger, but fewer, network packets are sent. This reduces overhead from the TCP protocol itself. However, if cross data-center responses are blocked, it will increase latency.")
+    , internode_shard_aware_connections(this, "internode_shard_aware_connections", value_status::Used, false,
+        "Open the connections to other nodes from local ports chosen so that each connection is accepted by the peer's shard with the same id as the connecting shard. "
+        "When the nodes have the same number of shards, requests and their responses are then handled on the shard owning the data on both sides, without hopping between shards. "
+        "The local ports are taken from the range 49152-65535.")
     , streaming_socket_timeout_in_ms(this, "streaming_socket_timeout_in_ms", value_status::Unused, 0,
         "Enable or disable socket timeout for streaming operations. When a timeout occurs during streaming, streaming is retried from the start of the current file. Avoid setting this value too low, as it can result in a significant amount of data re-streaming.")
     /**
@@ -773,6 +836,27 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\tYour own RPC server: You must provide a fully-qualified class name of an o.a.c.t.TServerFactory that can create a server instance.")
     , cache_hit_rate_read_balancing(this, "cache_hit_rate_read_balancing", value_status::Used, true,
         "This boolean controls whether the replicas for read query will be choosen based on cache hit ratio")
+    , speculative_retry_adaptive(this, "speculative_retry_adaptive", liveness::LiveUpdate, value_status::Used, false,
+        "For tables with a PERCENTILE speculative_retry, also track the recent read latency of each replica. When the replicas chosen for a read are expected to respond later than the table's percentile, and the extra replica is expected to respond sooner, the extra read is sent right away instead of after the percentile elapses. Speculative reads of such tables are limited by speculative_retry_max_extra_load.")
+    , speculative_retry_max_extra_load(this, "speculative_retry_max_extra_load", liveness::LiveUpdate, value_status::Used, 0.1,
+        "The maximum number of speculative reads sent for tables with a PERCENTILE speculative_retry, as a fraction of all reads, when speculative_retry_adaptive is enabled. Speculative reads over the limit are not sent.")
+    , columnar_query_result_min_rows(this, "columnar_query_result_min_rows", liveness::LiveUpdate, value_status::Used, 1000,
+        "Replicas send the pages of range scans in the column oriented encoding when the page may hold at least this many rows. Small pages gain little from the encoding, but still pay for converting it. Set to 0 to disable the columnar encoding.")
+    , load_aware_read_balancing(this, "load_aware_read_balancing", liveness::LiveUpdate, value_status::Used, false,
+        "When choosing replicas for a read, also take into account how loaded they are: replicas report the length of their read queue and their service time with every read reply, and the coordinator counts the reads it has in flight to each of them. A replica chosen by proximity or cache hit rate is replaced by another one when that one is expected to respond much sooner, e.g. because the first one is busy compacting or recovering.")
+    , load_aware_write_throttling(this, "load_aware_write_throttling", liveness::LiveUpdate, value_status::Used, false,
+        "Delay acknowledging writes whose replicas report, in their write replies, that their dirty memory is more than half full. The delay grows with the fill of the fullest replica, the same way it does with the view update backlog, so that clients slow down before the replicas start blocking writes.")
+    , digest_reads_compare_versions(this, "digest_reads_compare_versions", liveness::LiveUpdate, value_status::Used, false,
+        "Compute the digests of reads from the timestamps, expiry and size of the cells instead of their values, once all nodes support it. This makes digests of results with large values much cheaper to compute, but writes of different values with the same timestamp are no longer detected as a mismatch, and so are not repaired by reads.")
+    , paxos_state_cache_size(this, "paxos_state_cache_size", liveness::LiveUpdate, value_status::Used, 0,
+        "The number of partitions whose Paxos state (promised ballot, accepted proposal and most recent decision) each shard keeps in memory, so that lightweight transactions on them don't read it from system.paxos on each round. "
+        "The state is still written to system.paxos, so it survives restarts. 0 disables the cache.")
+    , range_scan_initial_concurrency(this, "range_scan_initial_concurrency", liveness::LiveUpdate, value_status::Used, 1,
+        "The number of token ranges a range scan queries concurrently in its first round of each page. The concurrency then doubles with every round until the page is full. "
+        "Higher values make large pages, e.g. of bulk exports, fill faster, but each range may read up to a full page, so scans with small pages read more than they return.")
+    , range_scan_adaptive_concurrency(this, "range_scan_adaptive_concurrency", liveness::LiveUpdate, value_status::Used, false,
+        "Adapt the concurrency of range scans to the load of the replicas: it only doubles after a round in which none of the queried replicas had reads queued on their reader concurrency semaphore, and is halved otherwise. "
+        "Replicas report the length of that queue with every read reply.")
     /**
     * @Group Advanced fault detection settings
     * @GroupDescription Settings to handle poorly performing or failing nodes.
@@ -788,6 +872,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Related information: About hinted handoff writes")
     , max_hinted_handoff_concurrency(this, "max_hinted_handoff_concurrency", liveness::LiveUpdate, value_status::Used, 0,
         "Maximum concurrency allowed for sending hints. The concurrency is divided across shards and rounded up if not divisible by the number of shards. By default (or when set to 0), concurrency of 8*shard_count will be used.")
+    , hints_send_batch_size_in_kb(this, "hints_send_batch_size_in_kb", liveness::LiveUpdate, value_status::Used, 64,
+        "Hints to a node are sent in batches of up to this size, or of up to 128 hints. The number of batches in flight to a node adapts to its latency, and every hint sent from a batch takes a slot of max_hinted_handoff_concurrency. 0 sends hints one by one.")
+    , hints_merge_window_in_kb(this, "hints_merge_window_in_kb", liveness::LiveUpdate, value_status::Used, 0,
+        "If not 0, hints to a node are read in windows of up to this size instead of hints_send_batch_size_in_kb batches, and the hints of a window for the same partition are merged into a single mutation before being sent. "
+        "Merging keeps the semantics of timestamps and tombstones. It helps workloads which update a few hot partitions repeatedly, at the cost of keeping a window per node in memory while it is sent.")
+    , hints_compression(this, "hints_compression", value_status::Used, "",
+        "The compressor used for hints written to disk, e.g. LZ4Compressor or ZstdCompressor. Hints which don't shrink when compressed are written as is. Empty disables compression.\n"
+        "Hint files with compressed hints can't be replayed by versions which don't support it, so make sure all hints are sent before downgrading.")
     , hinted_handoff_throttle_in_kb(this, "hinted_handoff_throttle_in_kb", value_status::Unused, 1024,
         "Maximum throttle per delivery thread in kilobytes per second. This rate reduces proportionally to the number of nodes in the cluster. For example, if there are two nodes in the cluster, each delivery thread will use the maximum rate. If there are three, each node will throttle to half of the maximum, since the two nodes are expected to deliver hints simultaneously.")
     , max_hint_window_in_ms(this, "max_hint_window_in_ms", value_status::Used, 10800000,
@@ -859,6 +951,20 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Refresh interval for permissions cache (if enabled). After this interval, cache entries become eligible for refresh. An async reload is scheduled every permissions_update_interval_in_ms time period and the old value is returned until it completes. If permissions_validity_in_ms has a non-zero value, then this property must also have a non-zero value. It's recommended to set this value to be at least 3 times smaller than the permissions_validity_in_ms.")
     , permissions_cache_max_entries(this, "permissions_cache_max_entries", liveness::LiveUpdate, value_status::Used, 1000,
         "Maximum cached permission entries. Must have a non-zero value if permissions caching is enabled (see a permissions_validity_in_ms description).")
+    , auth_cache_invalidation_poll_interval_in_ms(this, "auth_cache_invalidation_poll_interval_in_ms", value_status::Used, 0,
+        "When non-zero, cached permissions and granted roles are not refreshed periodically and stay valid until a GRANT, REVOKE or a role change drops them. "
+        "The node which executes the change drops its caches at once and bumps a generation stored in system_auth.cache_generation, which every other node reads once per this interval. "
+        "This trades the background reads of system_auth done by permissions_update_interval_in_ms, for every cached role and resource on every shard, for a single read per node. "
+        "Cached entries still expire after a day. When 0, the caches are refreshed as described in permissions_update_interval_in_ms.")
+    , credentials_validity_in_ms(this, "credentials_validity_in_ms", value_status::Used, 2000,
+        "How long credentials in cache remain valid, when PasswordAuthenticator is used. Caching lets a node authenticate clients which log in repeatedly, e.g. when many clients reconnect at once, without reading system_auth.roles each time, "
+        "nor hashing a password which was verified against the same salted hash within this period, "
+        "at the cost of a password change or a dropped role taking up to credentials_validity_in_ms to take effect on other nodes, or up to auth_cache_invalidation_poll_interval_in_ms when that is set. Credentials caching is disabled when this property is set to 0.")
+    , credentials_update_interval_in_ms(this, "credentials_update_interval_in_ms", value_status::Used, 1000,
+        "Refresh interval for credentials cache (if enabled). After this interval, cache entries become eligible for refresh, like in the permissions cache (see a permissions_update_interval_in_ms description). "
+        "If credentials_validity_in_ms has a non-zero value, then this property must also have a non-zero value.")
+    , credentials_cache_max_entries(this, "credentials_cache_max_entries", value_status::Used, 1000,
+        "Maximum cached credentials entries. Must have a non-zero value if credentials caching is enabled (see a credentials_validity_in_ms description).")
     , server_encryption_options(this, "server_encryption_options", value_status::Used, {/*none*/},
         "Enable or disable inter-node encryption. You must also generate keys and provide the appropriate key and trust store locations and passwords. The available options are:\n"
         "\n"
@@ -922,6 +1028,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , enable_repair_based_node_ops(this, "enable_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, true, "Set true to use enable repair based node operations instead of streaming based")
     , allowed_repair_based_node_ops(this, "allowed_repair_based_node_ops", liveness::LiveUpdate, value_status::Used, "replace,removenode,rebuild,bootstrap,decommission", "A comma separated list of node operations which are allowed to enable repair based node operations. The operations can be bootstrap, replace, removenode, decommission and rebuild")
     , enable_compacting_data_for_streaming_and_repair(this, "enable_compacting_data_for_streaming_and_repair", liveness::LiveUpdate, value_status::Used, true, "Enable the compacting reader, which compacts the data for streaming and repair (load'n'stream included) before sending it to, or synchronizing it with peers. Can reduce the amount of data to be processed by removing dead data, but adds CPU overhead.")
+    , incremental_repair(this, "incremental_repair", liveness::LiveUpdate, value_status::Used, false,
+        "Mark the sstables whose data was synchronized with all replicas by repair as repaired (repaired_at in their statistics), compact them separately from the unrepaired ones, and leave them out of the data compared by later repairs, so that these only read the data written since. "
+        "Enable it on all nodes: repairs between nodes which disagree on it transfer the repaired data again. It does not apply to tables using tablets.")
+    , repair_range_summary_splits(this, "repair_range_summary_splits", liveness::LiveUpdate, value_status::Used, 16,
+        "Before synchronizing the rows of a range, row level repair splits it into this many sub-ranges and compares a combined hash of each sub-range across the replicas. Only the sub-ranges whose hashes differ are synchronized row by row. "
+        "Saves most of the network traffic and CPU when replicas are mostly in sync. The rows of out of sync sub-ranges are synchronized from memory, only sub-ranges larger than the repair row buffer are read twice. Set to 0 to disable.")
+    , repair_latency_target_in_ms(this, "repair_latency_target_in_ms", liveness::LiveUpdate, value_status::Used, 0,
+        "The p99 latency of local reads and writes which repair tries not to exceed. When set, every repair job adjusts, once a second, the number of ranges it repairs in parallel and the size of its row buffers: they are halved while the p99 latency of the repaired tables is above the target or user reads are queued for admission, and grow back otherwise, up to the limits repair uses without a target. Applies to repairs started after it is set. Set to 0 to use a fixed parallelism.")
     , ring_delay_ms(this, "ring_delay_ms", value_status::Used, 30 * 1000, "Time a node waits to hear from other nodes before joining the ring in milliseconds. Same as -Dcassandra.ring_delay_ms in cassandra.")
     , shadow_round_ms(this, "shadow_round_ms", value_status::Used, 300 * 1000, "The maximum gossip shadow round time. Can be used to reduce the gossip feature check time during node boot up.")
     , fd_max_interval_ms(this, "fd_max_interval_ms", value_status::Used, 2 * 1000, "The maximum failure_detector interval time in milliseconds. Interval larger than the maximum will be ignored. Larger cluster may need to increase the default.")
@@ -932,14 +1046,24 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , force_gossip_generation(this, "force_gossip_generation", liveness::LiveUpdate, value_status::Used, -1 , "Force gossip to use the generation number provided by user")
     , experimental_features(this, "experimental_features", value_status::Used, {}, experimental_features_help_string())
     , lsa_reclamation_step(this, "lsa_reclamation_step", value_status::Used, 1, "Minimum number of segments to reclaim in a single step")
+    , lsa_reclaim_huge_page_spans(this, "lsa_reclaim_huge_page_spans", value_status::Used, false, "Give LSA memory back to the general purpose allocator in whole 2MiB huge pages, so that cache and memtable segments are grouped in huge pages of their own. Reduces TLB misses of cache reads, at the cost of reclaiming up to a huge page more than needed each time.")
     , prometheus_port(this, "prometheus_port", value_status::Used, 9180, "Prometheus port, set to zero to disable")
     , prometheus_address(this, "prometheus_address", value_status::Used, {/* listen_address */}, "Prometheus listening address, defaulting to listen_address if not explicitly set")
     , prometheus_prefix(this, "prometheus_prefix", value_status::Used, "scylla", "Set the prefix of the exported Prometheus metrics. Changing this will break Scylla's dashboard compatibility, do not change unless you know what you are doing.")
     , abort_on_lsa_bad_alloc(this, "abort_on_lsa_bad_alloc", value_status::Used, false, "Abort when allocation in LSA region fails")
     , murmur3_partitioner_ignore_msb_bits(this, "murmur3_partitioner_ignore_msb_bits", value_status::Used, default_murmur3_partitioner_ignore_msb_bits, "Number of most siginificant token bits to ignore in murmur3 partitioner; increase for very large clusters")
     , unspooled_dirty_soft_limit(this, "unspooled_dirty_soft_limit", value_status::Used, 0.6, "Soft limit of unspooled dirty memory expressed as a portion of the hard limit")
+    , memtable_flush_concurrency(this, "memtable_flush_concurrency", value_status::Used, 1, "The number of memtables each shard writes to sstables concurrently. "
+        "Flushes which are done with writing the data overlap with the next one regardless, raising this lets the data writes overlap too, "
+        "which helps when a single flush is CPU bound and leaves the disk idle.")
+    , dirty_memory_table_shares(this, "dirty_memory_table_shares", value_status::Used, false, "Divide the unspooled dirty memory of user tables into equal shares of the tables which write to it. "
+        "The table which is the most over its share is flushed first, and writes to tables within their share are not throttled until the real dirty memory limit is reached.")
+    , memtable_cache_borrowing_ratio(this, "memtable_cache_borrowing_ratio", liveness::LiveUpdate, value_status::Used, 0.0, "The portion of the shard's memory which memtables may borrow from the row cache, "
+        "on top of the half of the memory they are given, while writes are throttled and the cache is cold. 0 disables borrowing, values above 0.4 are treated as 0.4.")
     , sstable_summary_ratio(this, "sstable_summary_ratio", value_status::Used, 0.0005, "Enforces that 1 byte of summary is written for every N (2000 by default) "
         "bytes written to data file. Value must be between 0 and 1.")
+    , components_memory_reclaim_threshold(this, "components_memory_reclaim_threshold", liveness::LiveUpdate, value_status::Used, .2, "Ratio of available memory for all in-memory components of SSTables in a shard beyond which the memory will be reclaimed from components until it falls back under the threshold. "
+        "Reclaimed components are reloaded once enough memory is freed. Currently, this limit is only enforced for bloom filters.")
     , large_memory_allocation_warning_threshold(this, "large_memory_allocation_warning_threshold", value_status::Used, size_t(1) << 20, "Warn about memory allocations above this size; set to zero to disable")
     , enable_deprecated_partitioners(this, "enable_deprecated_partitioners", value_status::Used, false, "Enable the byteordered and random partitioners. These partitioners are deprecated and will be removed in a future version.")
     , enable_keyspace_column_family_metrics(this, "enable_keyspace_column_family_metrics", value_status::Used, false, "Enable per keyspace and per column family metrics reporting")
@@ -947,9 +1071,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , enable_sstable_data_integrity_check(this, "enable_sstable_data_integrity_check", value_status::Used, false, "Enable interposer which checks for integrity of every sstable write."
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , enable_sstable_key_validation(this, "enable_sstable_key_validation", value_status::Used, ENABLE_SSTABLE_KEY_VALIDATION, "Enable validation of partition and clustering keys monotonicity"
-        " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
+        " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers."
+        " When disabled, partition keys and a sample of the clustering keys are still validated.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
+    , view_update_coalescing_window_in_us(this, "view_update_coalescing_window_in_us", liveness::LiveUpdate, value_status::Used, 0,
+        "The time in microseconds for which asynchronous view updates are held before being sent, so that updates to the same view partition, going to the same view replica, are merged into a single write. "
+        "The held updates keep their view update backlog units until they are sent. Useful when bursts of base writes map to the same view partitions. "
+        "0 disables coalescing.")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Unused, true, "Enable SSTables 'mc' format to be used as the default file format.  Deprecated, please use \"sstable_format\" instead.")
     , enable_sstables_md_format(this, "enable_sstables_md_format", value_status::Unused, true, "Enable SSTables 'md' format to be used as the default file format.  Deprecated, please use \"sstable_format\" instead.")
     , sstable_format(this, "sstable_format", value_status::Used, "me", "Default sstable file format", {"md", "me"})
@@ -960,6 +1089,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
             "When enabled, per-table schema digest calculation ignores empty partitions.")
     , enable_dangerous_direct_import_of_cassandra_counters(this, "enable_dangerous_direct_import_of_cassandra_counters", value_status::Used, false, "Only turn this option on if you want to import tables from Cassandra containing counters, and you are SURE that no counters in that table were created in a version earlier than Cassandra 2.1."
         " It is not enough to have ever since upgraded to newer versions of Cassandra. If you EVER used a version earlier than 2.1 in the cluster where these SSTables come from, DO NOT TURN ON THIS OPTION! You will corrupt your data. You have been warned.")
+    , enable_background_reshape(this, "enable_background_reshape", liveness::LiveUpdate, value_status::Used, true,
+        "When enabled, sstables found on startup and sstables loaded from the upload directory are made available for reads right away, "
+        "instead of being reshaped before the table starts serving them. Uploaded and repair-originated sstables are reshaped by off-strategy "
+        "compaction in the background, the others found on startup are left to the compaction strategy. Resharding is still done up front.")
+    , enable_counter_update_coalescing(this, "enable_counter_update_coalescing", liveness::LiveUpdate, value_status::Used, false,
+        "When enabled, increments of a counter partition which arrive while an update of the partition is in progress are summed, and applied "
+        "together as a single update of the counter shard of this node once the update in progress is done. This replaces a lock, read and write "
+        "per increment of a hot counter with one per batch of increments, each of which is acknowledged only after its batch is written.")
     , enable_shard_aware_drivers(this, "enable_shard_aware_drivers", value_status::Used, true, "Enable native transport drivers to use connection-per-shard for better performance")
     , enable_ipv6_dns_lookup(this, "enable_ipv6_dns_lookup", value_status::Used, false, "Use IPv6 address resolution")
     , abort_on_internal_error(this, "abort_on_internal_error", liveness::LiveUpdate, value_status::Used, false, "Abort the server instead of throwing exception when internal invariants are violated")
@@ -979,6 +1116,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
             "Start serializing reads after their collective memory consumption goes above $normal_limit * $multiplier.")
     , reader_concurrency_semaphore_kill_limit_multiplier(this, "reader_concurrency_semaphore_kill_limit_multiplier", liveness::LiveUpdate, value_status::Used, 4,
             "Start killing reads after their collective memory consumption goes above $normal_limit * $multiplier.")
+    , reader_concurrency_semaphore_admission_by_deadline(this, "reader_concurrency_semaphore_admission_by_deadline", liveness::LiveUpdate, value_status::Used, false,
+            "Admit queued user reads in the order of their timeouts instead of their arrival, and reject reads right away, instead of queueing them, when they are expected to time out in the queue given the recently observed queue times. Under overload, this makes a fraction of the reads fail fast, instead of all of them timing out.")
+    , batch_workload_bypass_cache(this, "batch_workload_bypass_cache", liveness::LiveUpdate, value_status::Used, true,
+            "Read directly from sstables, as with BYPASS CACHE, in sessions whose service level has the batch workload type, so that large scans of analytical workloads don't evict the working set of interactive ones from the row cache.")
+    , hot_partition_replicas(this, "hot_partition_replicas", liveness::LiveUpdate, value_status::Used, 0,
+            "The number of other shards to copy the partitions which are read the most on a shard to. Single-partition reads coordinated on a shard holding a copy are served from it, instead of being sent to the shard owning the partition. Spreads the load of reading a hot partition across several shards. Copies are dropped on writes, which makes writes to these partitions slower. 0 disables.")
+    , hot_partition_read_threshold(this, "hot_partition_read_threshold", liveness::LiveUpdate, value_status::Used, 10000,
+            "The number of reads per second above which a partition is copied to other shards, see hot_partition_replicas.")
     , twcs_max_window_count(this, "twcs_max_window_count", liveness::LiveUpdate, value_status::Used, 50,
             "The maximum number of compaction windows allowed when making use of TimeWindowCompactionStrategy. A setting of 0 effectively disables the restriction.")
     , initial_sstable_loading_concurrency(this, "initial_sstable_loading_concurrency", value_status::Used, 4u,
@@ -1020,6 +1165,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
             "Make the system.config table UPDATEable")
     , enable_parallelized_aggregation(this, "enable_parallelized_aggregation", liveness::LiveUpdate, value_status::Used, true,
             "Use on a new, parallel algorithm for performing aggregate queries.")
+    , enable_paged_query_prefetch(this, "enable_paged_query_prefetch", liveness::LiveUpdate, value_status::Used, false,
+            "When a page of a paged query ends, start reading the next page in the background on the replica, "
+            "while the reader concurrency semaphore has spare memory.")
     , alternator_port(this, "alternator_port", value_status::Used, 0, "Alternator API port")
     , alternator_https_port(this, "alternator_https_port", value_status::Used, 0, "Alternator API HTTPS port")
     , alternator_address(this, "alternator_address", value_status::Used, "0.0.0.0", "Alternator API listening address")
@@ -1031,6 +1179,14 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , alternator_ttl_period_in_seconds(this, "alternator_ttl_period_in_seconds", value_status::Used,
         60*60*24,
         "The default period for Alternator's expiration scan. Alternator attempts to scan every table within that period.")
+    , alternator_ttl_scan_concurrency(this, "alternator_ttl_scan_concurrency", value_status::Used,
+        4,
+        "The number of tables, and of token ranges in each table, which Alternator's expiration scan processes concurrently on each shard. "
+        "At most this many pages of scan results are processed at a time on each shard.")
+    , alternator_streams_prefetch(this, "alternator_streams_prefetch", liveness::LiveUpdate, value_status::Used,
+        false,
+        "When a Streams GetRecords request returns records, read ahead the records for the iterator it returns, so that a consumer catching up on a busy stream gets its next batch without waiting for the read. "
+        "The read ahead records are kept on the shard which served the request, and used only if the next request comes to the same shard.")
     , alternator_describe_endpoints(this, "alternator_describe_endpoints", liveness::LiveUpdate, value_status::Used,
         "",
         "Overrides the behavior of Alternator's DescribeEndpoints operation. "
@@ -1072,15 +1228,38 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Keep SSTable index pages in the global cache after a SSTable read. Expected to improve performance for workloads with big partitions, but may degrade performance for workloads with small partitions. The amount of memory usable by index cache is limited with `index_cache_fraction`.")
     , index_cache_fraction(this, "index_cache_fraction", liveness::LiveUpdate, value_status::Used, 0.2,
         "The maximum fraction of cache memory permitted for use by index cache. Clamped to the [0.0; 1.0] range. Must be small enough to not deprive the row cache of memory, but should be big enough to fit a large fraction of the index. The default value 0.2 means that at least 80\% of cache memory is reserved for the row cache, while at most 20\% is usable by the index cache.")
+    , cache_scans_on_probation(this, "cache_scans_on_probation", liveness::LiveUpdate, value_status::Used, false,
+        "Insert rows populated into the row cache by range scans in the probationary segment of the cache, from which they are evicted before the rows that were read more than once. Rows are promoted out of probation when read again. Prevents large scans from pushing the working set of other reads out of the cache.")
+    , cache_admission_policy(this, "cache_admission_policy", liveness::LiveUpdate, value_status::Used, {},
+        "How reads are admitted to the row cache, by the name of the scheduling group they run in, e.g. {\"streaming\": \"bypass\"}. \"populate\" (the default for groups not listed) reads through the cache and populates it. \"populate_on_reuse\" reads a partition through the cache if it is already cached or was recently read by another such read, and otherwise reads it directly from sstables without populating the cache; range scans bypass the cache. \"bypass\" reads directly from sstables, as with BYPASS CACHE. Unknown values mean \"populate\".")
+    , compressed_cache_size_in_mb(this, "compressed_cache_size_in_mb", liveness::LiveUpdate, value_status::Used, 0,
+        "Memory per shard, in megabytes, for keeping cold partitions evicted from the row cache in serialized and lz4-compressed form, which takes several times less memory than the cache. Reads of such partitions restore them in the cache without reading sstables. Only complete partitions, which were fully read into the cache, are kept. 0 disables the compressed cache.")
+    , absent_partition_cache_size_in_mb(this, "absent_partition_cache_size_in_mb", liveness::LiveUpdate, value_status::Used, 0,
+        "Memory per shard, in megabytes, for remembering the keys of partitions which reads found missing from sstables, so that further single-partition reads of those keys don't have to look them up in sstables again. Takes much less memory than caching absent partitions as empty row cache entries, which is what happens when this is 0. The keys are forgotten when memtables or streaming add the partitions.")
+    , cache_update_max_rows_per_partition(this, "cache_update_max_rows_per_partition", liveness::LiveUpdate, value_status::Used, 0,
+        "Flushed memtable partitions with more rows than this are not merged into the row cache row by row. The cached partition is evicted instead, and populated again from sstables by its next read. Merging is the most expensive part of updating the cache after a flush and delays the release of the memtable memory, which this trades for cache misses on the partitions that were heavily written to. 0 merges all partitions.")
      , consistent_cluster_management(this, "consistent_cluster_management", value_status::Used, true, "Use RAFT for cluster management and DDL")
+    , tablet_load_stats_refresh_interval_in_seconds(this, "tablet_load_stats_refresh_interval_in_seconds", liveness::LiveUpdate, value_status::Used, 60,
+        "How often the topology coordinator collects the size and request rates of tablets from nodes. The tablet load balancer weights tablets by this load, so that hot or big tablets are spread between shards.")
+    , target_tablet_size_in_mb(this, "target_tablet_size_in_mb", liveness::LiveUpdate, value_status::Used, 5 * 1024,
+        "The average tablet size the load balancer aims for. The tablets of a table are split when their average size grows above twice this value, "
+        "and merged when it drops below half of it. Set to 0 to disable resizing based on size.")
+    , target_tablet_request_rate(this, "target_tablet_request_rate", liveness::LiveUpdate, value_status::Used, 0,
+        "The average number of requests per second per tablet the load balancer aims for. The tablets of a table are split when their average request rate "
+        "grows above twice this value, and are only merged when it is below half of it. Set to 0 to disable resizing based on request rate.")
     , wasm_cache_memory_fraction(this, "wasm_cache_memory_fraction", value_status::Used, 0.01, "Maximum total size of all WASM instances stored in the cache as fraction of total shard memory")
     , wasm_cache_timeout_in_ms(this, "wasm_cache_timeout_in_ms", value_status::Used, 5000, "Time after which an instance is evicted from the cache")
     , wasm_cache_instance_size_limit(this, "wasm_cache_instance_size_limit", value_status::Used, 1024*1024, "Instances with size above this limit will not be stored in the cache")
     , wasm_udf_yield_fuel(this, "wasm_udf_yield_fuel", value_status::Used, 100000, "Wasmtime fuel a WASM UDF can consume before yielding")
     , wasm_udf_total_fuel(this, "wasm_udf_total_fuel", value_status::Used, 100000000, "Wasmtime fuel a WASM UDF can consume before termination")
     , wasm_udf_memory_limit(this, "wasm_udf_memory_limit", value_status::Used, 2*1024*1024, "How much memory each WASM UDF can allocate at most")
+    , wasm_precompiled_modules_directory(this, "wasm_precompiled_modules_directory", value_status::Used, "", "Optionally, store WASM UDFs compiled to native code in this local directory, so that they aren't compiled again when the node restarts.")
     , relabel_config_file(this, "relabel_config_file", value_status::Used, "", "Optionally, read relabel config from file")
     , object_storage_config_file(this, "object_storage_config_file", value_status::Used, "", "Optionally, read object-storage endpoints config from file")
+    , object_storage_cache_directory(this, "object_storage_cache_directory", value_status::Used, "", "Optionally, cache ranges of sstables stored in object-storage in this local directory, so that reads don't have to go to the object storage every time. Each shard uses its own subdirectory. Survives restarts.")
+    , object_storage_cache_size_in_mb(this, "object_storage_cache_size_in_mb", value_status::Used, 1024, "Size of the local object-storage cache of each shard, see object_storage_cache_directory.")
+    , tracing_otlp_collector_address(this, "tracing_otlp_collector_address", value_status::Used, "", "Optionally, export tracing sessions as spans to the OpenTelemetry collector listening at this host[:port] for OTLP over HTTP (port 4318 by default, IPv6 addresses in brackets, e.g. [::1]:4318), instead of writing them to the system_traces keyspace, where clients such as cqlsh look for them.")
+    , tracing_otlp_max_buffered_spans(this, "tracing_otlp_max_buffered_spans", value_status::Used, 10000, "Maximum number of spans each shard holds while waiting to send them to the OpenTelemetry collector, see tracing_otlp_collector_address. Further spans are dropped.")
     , live_updatable_config_params_changeable_via_cql(this, "live_updatable_config_params_changeable_via_cql", liveness::MustRestart, value_status::Used, true, "If set to true, configuration parameters defined with LiveUpdate can be updated in runtime via CQL (by updating system.config virtual table), otherwise they can't.")
     , auth_superuser_name(this, "auth_superuser_name", value_status::Used, "",
         "Initial authentication super username. Ignored if authentication tables already contain a super user")
@@ -1116,6 +1295,10 @@ void db::config::add_per_partition_rate_limit_extension() {
     _extensions->add_schema_extension<db::per_partition_rate_limit_extension>(db::per_partition_rate_limit_extension::NAME);
 }
 
+void db::config::add_commitlog_bypass_extension() {
+    _extensions->add_schema_extension<db::commitlog_bypass_extension>(db::commitlog_bypass_extension::NAME);
+}
+
 void db::config::setup_directories() {
     maybe_in_workdir(commitlog_directory, "commitlog");
     if (!schema_commitlog_directory.is_set()) {
@@ -130,6 +130,7 @@ class config final : public utils::config_file {
     // For testing only
     void add_cdc_extension();
     void add_per_partition_rate_limit_extension();
+    void add_commitlog_bypass_extension();
 
     /// True iff the feature is enabled.
     bool check_experimental(experimental_features_t::feature f) const;
@@ -163,6 +164,8 @@ class config final : public utils::config_file {
     named_value<float> memtable_flush_static_shares;
     named_value<float> compaction_static_shares;
     named_value<bool> compaction_enforce_min_threshold;
+    named_value<uint32_t> compaction_tables_concurrency;
+    named_value<string_map> keyspace_service_levels;
     named_value<sstring> cluster_name;
     named_value<sstring> listen_address;
     named_value<sstring> listen_interface;
@@ -182,6 +185,10 @@ class config final : public utils::config_file {
     named_value<bool> rpc_interface_prefer_ipv6;
     named_value<seed_provider_type> seed_provider;
     named_value<uint32_t> compaction_throughput_mb_per_sec;
+    named_value<uint32_t> major_compaction_max_parallelism;
+    named_value<uint32_t> major_compaction_min_split_size_in_mb;
+    named_value<bool> compaction_index_cache_warming;
+    named_value<float> compaction_read_amplification_threshold;
     named_value<uint32_t> compaction_large_partition_warning_threshold_mb;
     named_value<uint32_t> compaction_large_row_warning_threshold_mb;
     named_value<uint32_t> compaction_large_cell_warning_threshold_mb;
@@ -200,11 +207,17 @@ class config final : public utils::config_file {
     named_value<uint32_t> schema_commitlog_segment_size_in_mb;
     named_value<uint32_t> commitlog_sync_period_in_ms;
     named_value<uint32_t> commitlog_sync_batch_window_in_ms;
+    named_value<uint32_t> commitlog_sync_batch_group_commit_max_wait_in_us;
     named_value<int64_t> commitlog_total_space_in_mb;
     named_value<bool> commitlog_reuse_segments; // unused. retained for upgrade compat
     named_value<int64_t> commitlog_flush_threshold_in_mb;
     named_value<bool> commitlog_use_o_dsync;
     named_value<bool> commitlog_use_hard_size_limit;
+    named_value<sstring> commitlog_compression;
+    named_value<uint32_t> commitlog_dedicated_segment_streams;
+    named_value<uint32_t> commitlog_reserve_segments;
+    named_value<uint32_t> commitlog_max_reserve_segments;
+    named_value<uint32_t> commitlog_reserve_lookahead_in_ms;
     named_value<bool> compaction_preheat_key_cache;
     named_value<uint32_t> concurrent_compactors;
     named_value<uint32_t> in_memory_compaction_limit_in_mb;
@@ -219,7 +232,13 @@ class config final : public utils::config_file {
     named_value<uint32_t> memtable_heap_space_in_mb;
     named_value<uint32_t> memtable_offheap_space_in_mb;
     named_value<uint32_t> column_index_size_in_kb;
+    named_value<uint32_t> column_index_initial_size_in_kb;
     named_value<uint32_t> column_index_auto_scale_threshold_in_kb;
+    named_value<bool> enable_sstable_clustering_filter;
+    named_value<bool> enable_sstable_column_value_stats;
+    named_value<uint32_t> sstable_write_batch_size_in_kb;
+    named_value<uint32_t> sstable_write_behind;
+    named_value<uint32_t> sstable_index_read_ahead_in_kb;
     named_value<uint32_t> index_summary_capacity_in_mb;
     named_value<uint32_t> index_summary_resize_interval_in_minutes;
     named_value<double> reduce_cache_capacity_to;
@@ -228,6 +247,9 @@ class config final : public utils::config_file {
     named_value<uint32_t> inter_dc_stream_throughput_outbound_megabits_per_sec;
     named_value<uint32_t> stream_io_throughput_mb_per_sec;
     named_value<double> stream_plan_ranges_fraction;
+    named_value<bool> enable_file_streaming;
+    named_value<uint32_t> stream_fragment_batch_max_size_in_kb;
+    named_value<bool> enable_pipelined_load_and_stream;
     named_value<bool> trickle_fsync;
     named_value<uint32_t> trickle_fsync_interval_in_kb;
     named_value<bool> auto_bootstrap;
@@ -259,12 +281,16 @@ class config final : public utils::config_file {
     named_value<uint32_t> cas_contention_timeout_in_ms;
     named_value<uint32_t> truncate_request_timeout_in_ms;
     named_value<uint32_t> write_request_timeout_in_ms;
+    named_value<uint32_t> write_batching_window_in_us;
+    named_value<uint32_t> background_write_timeout_in_ms;
     named_value<uint32_t> request_timeout_in_ms;
     named_value<bool> cross_node_timeout;
     named_value<uint32_t> internode_send_buff_size_in_bytes;
     named_value<uint32_t> internode_recv_buff_size_in_bytes;
     named_value<sstring> internode_compression;
+    named_value<sstring> internode_compression_inter_dc_algorithm;
     named_value<bool> inter_dc_tcp_nodelay;
+    named_value<bool> internode_shard_aware_connections;
     named_value<uint32_t> streaming_socket_timeout_in_ms;
     named_value<bool> start_native_transport;
     named_value<uint16_t> native_transport_port;
@@ -283,11 +309,23 @@ class config final : public utils::config_file {
     named_value<uint32_t> rpc_send_buff_size_in_bytes;
     named_value<sstring> rpc_server_type;
     named_value<bool> cache_hit_rate_read_balancing;
+    named_value<bool> speculative_retry_adaptive;
+    named_value<double> speculative_retry_max_extra_load;
+    named_value<uint32_t> columnar_query_result_min_rows;
+    named_value<bool> load_aware_read_balancing;
+    named_value<bool> load_aware_write_throttling;
+    named_value<bool> digest_reads_compare_versions;
+    named_value<uint32_t> paxos_state_cache_size;
+    named_value<uint32_t> range_scan_initial_concurrency;
+    named_value<bool> range_scan_adaptive_concurrency;
     named_value<double> dynamic_snitch_badness_threshold;
     named_value<uint32_t> dynamic_snitch_reset_interval_in_ms;
     named_value<uint32_t> dynamic_snitch_update_interval_in_ms;
     named_value<hinted_handoff_enabled_type> hinted_handoff_enabled;
     named_value<uint32_t> max_hinted_handoff_concurrency;
+    named_value<uint32_t> hints_send_batch_size_in_kb;
+    named_value<uint32_t> hints_merge_window_in_kb;
+    named_value<sstring> hints_compression;
     named_value<uint32_t> hinted_handoff_throttle_in_kb;
     named_value<uint32_t> max_hint_window_in_ms;
     named_value<uint32_t> max_hints_delivery_threads;
@@ -304,6 +342,10 @@ class config final : public utils::config_file {
     named_value<uint32_t> permissions_validity_in_ms;
     named_value<uint32_t> permissions_update_interval_in_ms;
     named_value<uint32_t> permissions_cache_max_entries;
+    named_value<uint32_t> auth_cache_invalidation_poll_interval_in_ms;
+    named_value<uint32_t> credentials_validity_in_ms;
+    named_value<uint32_t> credentials_update_interval_in_ms;
+    named_value<uint32_t> credentials_cache_max_entries;
     named_value<string_map> server_encryption_options;
     named_value<string_map> client_encryption_options;
     named_value<string_map> alternator_encryption_options;
@@ -328,6 +370,9 @@ class config final : public utils::config_file {
     named_value<bool> enable_repair_based_node_ops;
     named_value<sstring> allowed_repair_based_node_ops;
     named_value<bool> enable_compacting_data_for_streaming_and_repair;
+    named_value<bool> incremental_repair;
+    named_value<uint32_t> repair_range_summary_splits;
+    named_value<uint32_t> repair_latency_target_in_ms;
     named_value<uint32_t> ring_delay_ms;
     named_value<uint32_t> shadow_round_ms;
     named_value<uint32_t> fd_max_interval_ms;
@@ -338,13 +383,18 @@ class config final : public utils::config_file {
     named_value<int32_t> force_gossip_generation;
     named_value<std::vector<enum_option<experimental_features_t>>> experimental_features;
     named_value<size_t> lsa_reclamation_step;
+    named_value<bool> lsa_reclaim_huge_page_spans;
     named_value<uint16_t> prometheus_port;
     named_value<sstring> prometheus_address;
     named_value<sstring> prometheus_prefix;
     named_value<bool> abort_on_lsa_bad_alloc;
     named_value<unsigned> murmur3_partitioner_ignore_msb_bits;
     named_value<double> unspooled_dirty_soft_limit;
+    named_value<uint32_t> memtable_flush_concurrency;
+    named_value<bool> dirty_memory_table_shares;
+    named_value<double> memtable_cache_borrowing_ratio;
     named_value<double> sstable_summary_ratio;
+    named_value<double> components_memory_reclaim_threshold;
     named_value<size_t> large_memory_allocation_warning_threshold;
     named_value<bool> enable_deprecated_partitioners;
     named_value<bool> enable_keyspace_column_family_metrics;
@@ -353,12 +403,15 @@ class config final : public utils::config_file {
     named_value<bool> enable_sstable_key_validation;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
+    named_value<uint32_t> view_update_coalescing_window_in_us;
     named_value<bool> enable_sstables_mc_format;
     named_value<bool> enable_sstables_md_format;
     named_value<sstring> sstable_format;
     named_value<bool> uuid_sstable_identifiers_enabled;
     named_value<bool> table_digest_insensitive_to_expiry;
     named_value<bool> enable_dangerous_direct_import_of_cassandra_counters;
+    named_value<bool> enable_background_reshape;
+    named_value<bool> enable_counter_update_coalescing;
     named_value<bool> enable_shard_aware_drivers;
     named_value<bool> enable_ipv6_dns_lookup;
     named_value<bool> abort_on_internal_error;
@@ -368,6 +421,10 @@ class config final : public utils::config_file {
     named_value<uint64_t> max_memory_for_unlimited_query_hard_limit;
     named_value<uint32_t> reader_concurrency_semaphore_serialize_limit_multiplier;
     named_value<uint32_t> reader_concurrency_semaphore_kill_limit_multiplier;
+    named_value<bool> reader_concurrency_semaphore_admission_by_deadline;
+    named_value<bool> batch_workload_bypass_cache;
+    named_value<uint32_t> hot_partition_replicas;
+    named_value<uint32_t> hot_partition_read_threshold;
     named_value<uint32_t> twcs_max_window_count;
     named_value<unsigned> initial_sstable_loading_concurrency;
     named_value<bool> enable_3_1_0_compatibility_mode;
@@ -384,6 +441,7 @@ class config final : public utils::config_file {
     named_value<bool> enable_optimized_reversed_reads;
     named_value<bool> enable_cql_config_updates;
     named_value<bool> enable_parallelized_aggregation;
+    named_value<bool> enable_paged_query_prefetch;
 
     named_value<uint16_t> alternator_port;
     named_value<uint16_t> alternator_https_port;
@@ -393,6 +451,8 @@ class config final : public utils::config_file {
     named_value<uint32_t> alternator_streams_time_window_s;
     named_value<uint32_t> alternator_timeout_in_ms;
     named_value<double> alternator_ttl_period_in_seconds;
+    named_value<uint32_t> alternator_ttl_scan_concurrency;
+    named_value<bool> alternator_streams_prefetch;
     named_value<sstring> alternator_describe_endpoints;
 
     named_value<bool> abort_on_ebadf;
@@ -424,8 +484,16 @@ class config final : public utils::config_file {
 
     named_value<bool> cache_index_pages;
     named_value<double> index_cache_fraction;
+    named_value<bool> cache_scans_on_probation;
+    named_value<string_map> cache_admission_policy;
+    named_value<uint32_t> compressed_cache_size_in_mb;
+    named_value<uint32_t> absent_partition_cache_size_in_mb;
+    named_value<uint32_t> cache_update_max_rows_per_partition;
 
     named_value<bool> consistent_cluster_management;
+    named_value<uint32_t> tablet_load_stats_refresh_interval_in_seconds;
+    named_value<uint64_t> target_tablet_size_in_mb;
+    named_value<double> target_tablet_request_rate;
 
     named_value<double> wasm_cache_memory_fraction;
     named_value<uint32_t> wasm_cache_timeout_in_ms;
@@ -433,8 +501,13 @@ class config final : public utils::config_file {
     named_value<uint64_t> wasm_udf_yield_fuel;
     named_value<uint64_t> wasm_udf_total_fuel;
     named_value<size_t> wasm_udf_memory_limit;
+    named_value<sstring> wasm_precompiled_modules_directory;
     named_value<sstring> relabel_config_file;
     named_value<sstring> object_storage_config_file;
+    named_value<sstring> object_storage_cache_directory;
+    named_value<uint64_t> object_storage_cache_size_in_mb;
+    named_value<sstring> tracing_otlp_collector_address;
+    named_value<uint32_t> tracing_otlp_max_buffered_spans;
     // wasm_udf_reserved_memory is static because the options in db::config
     // are parsed using seastar::app_template, while this option is used for
     // configuring the Seastar memory subsystem.
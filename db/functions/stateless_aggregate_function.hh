@@ -5,10 +5,29 @@
 
 #include "scalar_function.hh"
 #include "function_name.hh"
+#include "utils/managed_bytes.hh"
+#include <functional>
+#include <memory>
 #include <optional>
 
 namespace db::functions {
 
+// Aggregates the inputs of a native aggregate function keeping the state in its
+// native representation, so that the state is serialized once per group rather
+// than once per input, as calling aggregation_function for each input does.
+class aggregate_accumulator {
+public:
+    virtual ~aggregate_accumulator() = default;
+    // Aggregates another input, disengaged if the argument is null or if the
+    // function takes no argument.
+    virtual void add(managed_bytes_view_opt input) = 0;
+    // The state aggregation_function would have computed from initial_state
+    // and the same inputs.
+    virtual bytes_opt state() const = 0;
+    // Goes back to initial_state.
+    virtual void reset() = 0;
+};
+
 struct stateless_aggregate_function final {
     function_name name;
     std::optional<sstring> column_name_override; // if unset, column name is synthesized from name and argument names
@@ -30,6 +49,10 @@ struct stateless_aggregate_function final {
     // optional: reduces states computed in parallel
     // signature: (state_type, state_type) -> state_type
     shared_ptr<scalar_function> state_reduction_function;
+
+    // optional: creates an accumulator equivalent to aggregation_function,
+    // for functions taking at most one argument
+    std::function<std::unique_ptr<aggregate_accumulator>()> make_accumulator;
 };
 
 }
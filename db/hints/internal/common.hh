@@ -42,6 +42,7 @@ struct hint_stats {
     uint64_t discarded                  = 0;
     uint64_t send_errors                = 0;
     uint64_t corrupted_files            = 0;
+    uint64_t merged                     = 0;
 };
 
 } // namespace internal
@@ -20,6 +20,8 @@
 #include "db/hints/internal/hint_logger.hh"
 #include "db/hints/internal/hint_storage.hh"
 #include "db/hints/manager.hh"
+#include "db/config.hh"
+#include "compress.hh"
 #include "replica/database.hh"
 #include "utils/disk-error-handler.hh"
 #include "utils/runtime.hh"
@@ -172,6 +174,12 @@ future<db::commitlog> hint_endpoint_manager::add_store() noexcept {
             cfg.commitlog_total_space_in_mb = resource_manager::max_hints_per_ep_size_mb;
             cfg.fname_prefix = manager::FILENAME_PREFIX;
             cfg.extensions = &_shard_manager.local_db().extensions();
+            if (const auto& name = _shard_manager.local_db().get_config().hints_compression(); !name.empty()) {
+                cfg.compressor = compressor::create(name, [] (const sstring&) { return compressor::opt_string(); });
+                if (!cfg.compressor) {
+                    throw std::invalid_argument(format("Unknown hints_compression {}", name));
+                }
+            }
 
             // HH leaves segments on disk after commitlog shutdown, and later reads
             // them when commitlog is re-created. This is expected to happen regularly
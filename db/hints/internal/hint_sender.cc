@@ -13,9 +13,13 @@
 #include <exception>
 #include <seastar/core/abort_source.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/as_future.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/core/file.hh>
 #include <seastar/core/file-types.hh>
 #include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/core/sleep.hh>
 #include <seastar/core/print.hh>
 #include <seastar/core/seastar.hh>
@@ -29,6 +33,7 @@
 #include "db/hints/internal/hint_endpoint_manager.hh"
 #include "db/hints/manager.hh"
 #include "db/hints/resource_manager.hh"
+#include "db/config.hh"
 #include "gms/gossiper.hh"
 #include "gms/inet_address.hh"
 #include "replica/database.hh"
@@ -40,6 +45,7 @@
 #include "gc_clock.hh"
 
 // STD.
+#include <limits>
 #include <ranges>
 #include <span>
 #include <stdexcept>
@@ -263,76 +269,192 @@ future<> hint_sender::send_one_mutation(frozen_mutation_and_schema m) {
     return do_send_one_mutation(std::move(m), std::move(erm), std::move(natural_endpoints));
 }
 
-future<> hint_sender::send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
-    return _resource_manager.get_send_units_for(buf.size_bytes()).then([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] (auto units) mutable {
-        ctx_ptr->mark_hint_as_in_progress(rp);
+std::optional<frozen_mutation_and_schema> hint_sender::get_hint_to_send(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer& buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
+    try {
+        auto m = this->get_mutation(ctx_ptr, buf);
+        gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
+
+        // The hint is too old - drop it.
+        //
+        // Files are aggregated for at most manager::hints_timer_period therefore the oldest hint there is
+        // (last_modification - manager::hints_timer_period) old.
+        if (const auto now = gc_clock::now().time_since_epoch(); now - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
+            manager_logger.debug("send_hints(): the hint is too old, skipping it, "
+                "secs since file last modification {}, gc_grace_sec {}, hints_flush_period {}",
+                now - secs_since_file_mod, gc_grace_sec, manager::hints_flush_period);
+            return std::nullopt;
+        }
 
-        // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
-        auto h = ctx_ptr->file_send_gate.hold();
-        (void)std::invoke([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] () mutable {
-            try {
-                auto m = this->get_mutation(ctx_ptr, buf);
-                gc_clock::duration gc_grace_sec = m.s->gc_grace_seconds();
-
-                // The hint is too old - drop it.
-                //
-                // Files are aggregated for at most manager::hints_timer_period therefore the oldest hint there is
-                // (last_modification - manager::hints_timer_period) old.
-                if (const auto now = gc_clock::now().time_since_epoch(); now - secs_since_file_mod > gc_grace_sec - manager::hints_flush_period) {
-                    manager_logger.debug("send_hints(): the hint is too old, skipping it, "
-                        "secs since file last modification {}, gc_grace_sec {}, hints_flush_period {}",
-                        now - secs_since_file_mod, gc_grace_sec, manager::hints_flush_period);
-                    return make_ready_future<>();
-                }
+        return m;
+
+    // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
+    } catch (replica::no_such_column_family& e) {
+        manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
+        ++this->shard_stats().discarded;
+    } catch (replica::no_such_keyspace& e) {
+        manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
+        ++this->shard_stats().discarded;
+    } catch (no_column_mapping& e) {
+        manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
+        ++this->shard_stats().discarded;
+    } catch (...) {
+        manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, std::current_exception());
+        ++this->shard_stats().send_errors;
+        throw;
+    }
+    return std::nullopt;
+}
 
-                return this->send_one_mutation(std::move(m)).then([this, ctx_ptr] {
-                    ++this->shard_stats().sent;
-                }).handle_exception([this, ctx_ptr] (auto eptr) {
-                    manager_logger.trace("send_one_hint(): failed to send to {}: {}", end_point_key(), eptr);
-                    ++this->shard_stats().send_errors;
-                    return make_exception_future<>(std::move(eptr));
-                });
-
-            // ignore these errors and move on - probably this hint is too old and the KS/CF has been deleted...
-            } catch (replica::no_such_column_family& e) {
-                manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
-                ++this->shard_stats().discarded;
-            } catch (replica::no_such_keyspace& e) {
-                manager_logger.debug("send_hints(): no_such_keyspace: {}", e.what());
-                ++this->shard_stats().discarded;
-            } catch (no_column_mapping& e) {
-                manager_logger.debug("send_hints(): {} at {}: {}", fname, rp, e.what());
-                ++this->shard_stats().discarded;
-            } catch (...) {
-                auto eptr = std::current_exception();
-                manager_logger.debug("send_hints(): unexpected error in file {} at {}: {}", fname, rp, eptr);
-                ++this->shard_stats().send_errors;
-                return make_exception_future<>(std::move(eptr));
+future<> hint_sender::send_hint_mutation(frozen_mutation_and_schema m) {
+    future<> f = make_ready_future<>();
+    try {
+        f = this->send_one_mutation(std::move(m));
+    } catch (replica::no_such_column_family& e) {
+        // the table was dropped after the hint was read
+        manager_logger.debug("send_hints(): no_such_column_family: {}", e.what());
+        ++this->shard_stats().discarded;
+        co_return;
+    }
+
+    try {
+        co_await std::move(f);
+    } catch (...) {
+        manager_logger.trace("send_one_hint(): failed to send to {}: {}", end_point_key(), std::current_exception());
+        ++this->shard_stats().send_errors;
+        throw;
+    }
+}
+
+future<> hint_sender::send_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, gc_clock::duration secs_since_file_mod, const sstring& fname) {
+    auto batch = std::exchange(ctx_ptr->batch, {});
+    const auto batch_size = std::exchange(ctx_ptr->batch_size, 0);
+
+    co_await _batch_done.wait([this] { return _batches_in_flight < _batch_concurrency; });
+    auto units_f = co_await coroutine::as_future(_resource_manager.get_send_units_for(batch_size));
+    if (units_f.failed()) {
+        manager_logger.trace("send_one_file(): Hmmm. Something bad had happend: {}", units_f.get_exception());
+        for (auto& h : batch) {
+            ctx_ptr->on_hint_send_failure(h.rp);
+        }
+        co_return;
+    }
+
+    auto units = units_f.get0();
+
+    for (auto& h : batch) {
+        ctx_ptr->mark_hint_as_in_progress(h.rp);
+    }
+    ++_batches_in_flight;
+
+    // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
+    (void)with_gate(ctx_ptr->file_send_gate, [this, ctx_ptr, batch = std::move(batch), secs_since_file_mod, &fname, units = std::move(units)] () mutable {
+        return do_send_batch(ctx_ptr, std::move(batch), secs_since_file_mod, fname).finally([this, units = std::move(units)] {
+            --_batches_in_flight;
+            _batch_done.signal();
+        });
+    });
+}
+
+future<> hint_sender::do_send_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, std::vector<hint_to_send> batch, gc_clock::duration secs_since_file_mod, const sstring& fname) noexcept {
+    const auto start = std::chrono::steady_clock::now();
+    bool failed = false;
+
+    auto f = co_await coroutine::as_future(send_batch_hints(ctx_ptr, batch, secs_since_file_mod, fname, failed));
+    if (f.failed()) {
+        manager_logger.warn("[{}] failed to send a batch of hints from {}: {}", end_point_key(), fname, f.get_exception());
+        // Hints of the batch which weren't sent are retried with the rest of the file.
+        for (auto& h : batch) {
+            if (ctx_ptr->in_progress_rps.contains(h.rp)) {
+                ctx_ptr->on_hint_send_failure(h.rp);
             }
-            return make_ready_future<>();
-        }).then_wrapped([this, units = std::move(units), rp, ctx_ptr, h = std::move(h)] (future<>&& f) {
-            // Information about the error was already printed somewhere higher.
-            // We just need to account in the ctx that sending of this hint has failed.
-            if (!f.failed()) {
-                ctx_ptr->on_hint_send_success(rp);
-                auto new_bound = ctx_ptr->get_replayed_bound();
-                // Segments from other shards are replayed first and are considered to be "before" replay position 0.
-                // Update the sent upper bound only if it is a local segment.
-                if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
-                    _sent_upper_bound_rp = new_bound;
-                    notify_replay_waiters();
-                }
+        }
+        failed = true;
+    }
+
+    adjust_batch_concurrency(std::chrono::steady_clock::now() - start, failed);
+}
+
+future<> hint_sender::send_batch_hints(lw_shared_ptr<send_one_file_ctx> ctx_ptr, std::vector<hint_to_send>& batch, gc_clock::duration secs_since_file_mod, const sstring& fname, bool& failed) {
+    // Information about errors was already printed somewhere higher.
+    // We just need to account in the ctx whether sending of each hint has failed.
+    auto on_sent = [&] (db::replay_position rp) {
+        ctx_ptr->on_hint_send_success(rp);
+        auto new_bound = ctx_ptr->get_replayed_bound();
+        // Segments from other shards are replayed first and are considered to be "before" replay position 0.
+        // Update the sent upper bound only if it is a local segment.
+        if (new_bound.shard_id() == this_shard_id() && _sent_upper_bound_rp < new_bound) {
+            _sent_upper_bound_rp = new_bound;
+            notify_replay_waiters();
+        }
+    };
+    auto on_failed = [&] (db::replay_position rp) {
+        ctx_ptr->on_hint_send_failure(rp);
+        failed = true;
+    };
+
+    utils::get_local_injector().inject("hint_sender_batch_fail", [] { throw std::runtime_error("injected hint batch failure"); });
+
+    // Decode all hints of the batch first, so that the ones for the same partition can be merged.
+    std::vector<std::pair<frozen_mutation_and_schema, std::vector<db::replay_position>>> to_send;
+    hint_merger merger;
+    for (auto& h : batch) {
+        try {
+            auto m = get_hint_to_send(ctx_ptr, h.buf, h.rp, secs_since_file_mod, fname);
+            if (!m) {
+                on_sent(h.rp);
+            } else if (ctx_ptr->merge_hints) {
+                merger.add(m->fm.unfreeze(m->s), h.rp);
             } else {
-                ctx_ptr->on_hint_send_failure(rp);
+                to_send.emplace_back(std::move(*m), std::vector<db::replay_position>{h.rp});
             }
+        } catch (...) {
+            on_failed(h.rp);
+        }
+        co_await coroutine::maybe_yield();
+    }
+    if (ctx_ptr->merge_hints) {
+        shard_stats().merged += merger.merged();
+        for (auto& mh : std::move(merger).get()) {
+            auto s = mh.m.schema();
+            to_send.emplace_back(frozen_mutation_and_schema{freeze(mh.m), std::move(s)}, std::move(mh.rps));
+        }
+    }
+
+    // The hints of all batches in flight share the shard's max_hinted_handoff_concurrency.
+    co_await max_concurrent_for_each(to_send, _resource_manager.per_shard_send_concurrency(), [&] (std::pair<frozen_mutation_and_schema, std::vector<db::replay_position>>& p) -> future<> {
+        auto slot = co_await _resource_manager.get_send_slot();
+        auto f = co_await coroutine::as_future(send_hint_mutation(std::move(p.first)));
+        if (f.failed()) {
             f.ignore_ready_future();
-        });
-    }).handle_exception([ctx_ptr, rp] (auto eptr) {
-        manager_logger.trace("send_one_file(): Hmmm. Something bad had happend: {}", eptr);
-        ctx_ptr->on_hint_send_failure(rp);
+            for (auto rp : p.second) {
+                on_failed(rp);
+            }
+            co_return;
+        }
+        shard_stats().sent += p.second.size();
+        for (auto rp : p.second) {
+            on_sent(rp);
+        }
     });
 }
 
+void hint_sender::adjust_batch_concurrency(std::chrono::steady_clock::duration latency, bool failed) noexcept {
+    // Let the baseline creep up slowly, so that it follows a destination which got slower for good.
+    if (_min_batch_latency.count() == 0) {
+        _min_batch_latency = latency;
+    } else {
+        _min_batch_latency = std::min(latency, _min_batch_latency + _min_batch_latency / 64);
+    }
+
+    if (failed || latency > 2 * _min_batch_latency) {
+        _batch_concurrency = std::max<size_t>(1, _batch_concurrency / 2);
+    } else {
+        _batch_concurrency = std::min(_batch_concurrency + 1, max_batch_concurrency);
+    }
+    manager_logger.trace("[{}] batch latency {}us, concurrency {}", end_point_key(),
+            std::chrono::duration_cast<std::chrono::microseconds>(latency).count(), _batch_concurrency);
+}
+
 void hint_sender::notify_replay_waiters() noexcept {
     if (!_foreign_segments_to_replay.empty()) {
         manager_logger.trace("[{}] notify_replay_waiters(): not notifying because there are still {} foreign segments to replay", end_point_key(), _foreign_segments_to_replay.size());
@@ -443,9 +565,14 @@ bool hint_sender::send_one_file(const sstring& fname) {
     timespec last_mod = get_last_file_modification(fname).get0();
     gc_clock::duration secs_since_file_mod = std::chrono::seconds(last_mod.tv_sec);
     lw_shared_ptr<send_one_file_ctx> ctx_ptr = make_lw_shared<send_one_file_ctx>(_last_schema_ver_to_column_mapping);
+    // With merging, a batch is the window in which hints for the same partition are merged.
+    const size_t merge_window = size_t(_db.get_config().hints_merge_window_in_kb()) * 1024;
+    const size_t batch_size_limit = merge_window ? merge_window : size_t(_db.get_config().hints_send_batch_size_in_kb()) * 1024;
+    const size_t max_hints = merge_window ? std::numeric_limits<size_t>::max() : max_hints_per_batch;
+    ctx_ptr->merge_hints = merge_window != 0;
 
     try {
-        commitlog::read_log_file(fname, manager::FILENAME_PREFIX, [this, secs_since_file_mod, &fname, ctx_ptr] (commitlog::buffer_and_replay_position buf_rp) -> future<> {
+        commitlog::read_log_file(fname, manager::FILENAME_PREFIX, [this, secs_since_file_mod, &fname, ctx_ptr, batch_size_limit, max_hints] (commitlog::buffer_and_replay_position buf_rp) -> future<> {
             auto& buf = buf_rp.buffer;
             auto& rp = buf_rp.position;
 
@@ -477,7 +604,11 @@ bool hint_sender::send_one_file(const sstring& fname) {
                     co_await sleep(std::chrono::milliseconds(100));
                     continue;
                 } else {
-                    co_await send_one_hint(ctx_ptr, std::move(buf), rp, secs_since_file_mod, fname);
+                    ctx_ptr->batch_size += buf.size_bytes();
+                    ctx_ptr->batch.push_back(hint_to_send{std::move(buf), rp});
+                    if (ctx_ptr->batch_size >= batch_size_limit || ctx_ptr->batch.size() >= max_hints) {
+                        co_await send_batch(ctx_ptr, secs_since_file_mod, fname);
+                    }
                     break;
                 }
             };
@@ -491,6 +622,18 @@ bool hint_sender::send_one_file(const sstring& fname) {
         ctx_ptr->segment_replay_failed = true;
     }
 
+    // Send out the last batch, unless the replay already failed - then its hints will be retried from the file.
+    if (!ctx_ptr->batch.empty()) {
+        if (!draining() && ctx_ptr->segment_replay_failed) {
+            for (auto& h : ctx_ptr->batch) {
+                ctx_ptr->on_hint_send_failure(h.rp);
+            }
+            ctx_ptr->batch.clear();
+        } else {
+            send_batch(ctx_ptr, secs_since_file_mod, fname).get();
+        }
+    }
+
     // wait till all background hints sending is complete
     ctx_ptr->file_send_gate.close().get();
 
@@ -10,6 +10,7 @@
 
 // Seastar features.
 #include <seastar/core/abort_source.hh>
+#include <seastar/core/condition-variable.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
 #include <seastar/core/lowres_clock.hh>
@@ -31,11 +32,13 @@
 #include "gc_clock.hh"
 
 // STD.
+#include <chrono>
 #include <list>
 #include <map>
 #include <optional>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 namespace service {
 class storage_proxy;
@@ -74,6 +77,11 @@ class hint_sender {
         state::ep_state_left_the_ring,
         state::draining>>;
 
+    struct hint_to_send {
+        fragmented_temporary_buffer buf;
+        db::replay_position rp;
+    };
+
     struct send_one_file_ctx {
         send_one_file_ctx(std::unordered_map<table_schema_version, column_mapping>& last_schema_ver_to_column_mapping)
             : schema_ver_to_column_mapping(last_schema_ver_to_column_mapping)
@@ -84,6 +92,11 @@ class hint_sender {
         std::optional<db::replay_position> last_succeeded_rp;
         std::set<db::replay_position> in_progress_rps;
         bool segment_replay_failed = false;
+        // Hints read from the file but not sent yet, see send_batch().
+        std::vector<hint_to_send> batch;
+        size_t batch_size = 0;
+        // Whether hints of a batch for the same partition are merged before sending, see hint_merger.
+        bool merge_hints = false;
 
         void mark_hint_as_in_progress(db::replay_position rp);
         void on_hint_send_success(db::replay_position rp) noexcept;
@@ -117,6 +130,15 @@ class hint_sender {
 
     std::multimap<db::replay_position, lw_shared_ptr<std::optional<promise<>>>> _replay_waiters;
 
+    // Batches in flight to the destination and their limit, see adjust_batch_concurrency().
+    static constexpr size_t initial_batch_concurrency = 4;
+    static constexpr size_t max_batch_concurrency = 32;
+    static constexpr size_t max_hints_per_batch = 128;
+    size_t _batches_in_flight = 0;
+    size_t _batch_concurrency = initial_batch_concurrency;
+    std::chrono::steady_clock::duration _min_batch_latency{0};
+    seastar::condition_variable _batch_done;
+
 public:
     hint_sender(hint_endpoint_manager& parent, service::storage_proxy& local_storage_proxy, replica::database& local_db, gms::gossiper& local_gossiper) noexcept;
     ~hint_sender();
@@ -194,19 +216,44 @@ class hint_sender {
 
     bool replay_allowed() const noexcept;
 
-    /// \brief Try to send one hint read from the file.
-    ///  - Limit the maximum memory size of hints "in the air" and the maximum total number of hints "in the air".
-    ///  - Discard the hints that are older than the grace seconds value of the corresponding table.
+    /// \brief Try to send the hints batched in the file sending context.
+    ///  - Limit the maximum memory size of hints "in the air" and the maximum total number of batches "in the air".
+    ///  - Limit the number of batches in flight to the destination, see adjust_batch_concurrency().
+    ///  - Limit the number of hint mutations in flight from the shard, across all batches, to
+    ///    resource_manager::per_shard_send_concurrency().
     ///
-    /// If sending fails we are going to set the state::segment_replay_failed in the _state and _first_failed_rp will be updated to min(_first_failed_rp, \ref rp).
+    /// The hints of a batch are sent concurrently in the background, under ctx_ptr->file_send_gate. If sending a hint fails, segment_replay_failed
+    /// is set in the context and first_failed_rp will be updated to min(first_failed_rp, rp of the hint).
     ///
     /// \param ctx_ptr shared pointer to the file sending context
-    /// \param buf buffer representing the hint
-    /// \param rp replay position of this hint in the file (see commitlog for more details on "replay position")
     /// \param secs_since_file_mod last modification time stamp (in seconds since Epoch) of the current hints file
-    /// \param fname name of the hints file this hint was read from
-    /// \return future that resolves when next hint may be sent
-    future<> send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
+    /// \param fname name of the hints file the hints were read from
+    /// \return future that resolves when next batch may be collected
+    future<> send_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, gc_clock::duration secs_since_file_mod, const sstring& fname);
+
+    /// \brief Send the hints of a batch and account for the results in the file sending context.
+    ///
+    /// If ctx_ptr->merge_hints is set, hints for the same partition are merged and sent as a single mutation.
+    /// If sending the batch fails as a whole, its hints which weren't sent yet are accounted as failed.
+    future<> do_send_batch(lw_shared_ptr<send_one_file_ctx> ctx_ptr, std::vector<hint_to_send> batch, gc_clock::duration secs_since_file_mod, const sstring& fname) noexcept;
+    future<> send_batch_hints(lw_shared_ptr<send_one_file_ctx> ctx_ptr, std::vector<hint_to_send>& batch, gc_clock::duration secs_since_file_mod, const sstring& fname, bool& failed);
+
+    /// \brief Restore the mutation of a hint read from the file, unless the hint should be discarded.
+    ///
+    /// Discards the hints that are older than the grace seconds value of the corresponding table, or whose table is gone.
+    ///
+    /// \return the mutation to send, or std::nullopt if the hint was discarded
+    std::optional<frozen_mutation_and_schema> get_hint_to_send(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer& buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname);
+
+    /// \brief Send the mutation of one or more hints.
+    /// \return future that resolves when the mutation is sent, and fails if sending it failed
+    future<> send_hint_mutation(frozen_mutation_and_schema m);
+
+    /// \brief Adapt the limit of batches in flight to the destination to the latency of the last batch.
+    ///
+    /// The limit grows by one for each batch completed within twice the lowest latency seen, and is halved when
+    /// a batch takes longer or fails, so a destination which is catching up is not swamped with hints.
+    void adjust_batch_concurrency(std::chrono::steady_clock::duration latency, bool failed) noexcept;
 
     /// \brief Send all hint from a single file and delete it after it has been successfully sent.
     /// Send all hints from the given file. If we failed to send the current segment we will pick up in the next
@@ -273,5 +273,30 @@ future<> rebalance_hints(fs::path hint_directory) {
     co_await remove_irrelevant_shards_directories(hint_directory);
 }
 
+void hint_merger::add(mutation m, db::replay_position rp) {
+    auto s = m.schema();
+    auto& parts = _tables.try_emplace(s->version(), dht::decorated_key::less_comparator(s)).first->second;
+    auto it = parts.find(m.decorated_key());
+    if (it == parts.end()) {
+        auto key = m.decorated_key();
+        parts.emplace(std::move(key), merged_hint{std::move(m), {rp}});
+        return;
+    }
+    it->second.m.apply(std::move(m));
+    it->second.rps.push_back(rp);
+    ++_merged;
+}
+
+std::vector<hint_merger::merged_hint> hint_merger::get() && {
+    std::vector<merged_hint> res;
+    for (auto& [version, parts] : _tables) {
+        for (auto& [key, mh] : parts) {
+            res.push_back(std::move(mh));
+        }
+    }
+    _tables.clear();
+    return res;
+}
+
 } // namespace internal
 } // namespace db::hints
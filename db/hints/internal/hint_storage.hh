@@ -12,10 +12,15 @@
 #include "db/commitlog/commitlog.hh"
 #include "db/commitlog/commitlog_entry.hh"
 #include "db/hints/internal/common.hh"
+#include "dht/i_partitioner.hh"
+#include "mutation/mutation.hh"
 #include "utils/loading_shared_values.hh"
 
 // STD.
 #include <filesystem>
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 /// This file is supposed to gather meta information about data structures
 /// and types related to storing hints.
@@ -46,5 +51,37 @@ using hint_entry_reader = commitlog_entry_reader;
 /// \return A future that resolves when the operation is complete.
 future<> rebalance_hints(std::filesystem::path hint_directory);
 
+/// \brief Merges hints for the same partition, so that each partition is sent once.
+///
+/// Hints are merged with mutation::apply(), which reconciles cells by timestamp and
+/// keeps tombstones, so sending the merged mutation has the same effect on the
+/// destination as sending all the hints it was merged from, in any order.
+class hint_merger {
+public:
+    struct merged_hint {
+        mutation m;
+        // Replay positions of all hints merged into m.
+        std::vector<db::replay_position> rps;
+    };
+
+private:
+    using partitions = std::map<dht::decorated_key, merged_hint, dht::decorated_key::less_comparator>;
+    // Hints of different schema versions of a table are not merged with each other.
+    std::unordered_map<table_schema_version, partitions> _tables;
+    size_t _merged = 0;
+
+public:
+    /// \brief Adds the mutation of the hint at \p rp, merging it into an earlier hint for the same partition if there is one.
+    void add(mutation m, db::replay_position rp);
+
+    /// \brief The number of hints merged into earlier ones so far.
+    size_t merged() const noexcept {
+        return _merged;
+    }
+
+    /// \brief Returns the merged hints, in no particular order.
+    std::vector<merged_hint> get() &&;
+};
+
 } // namespace internal
 } // namespace db::hints
@@ -179,6 +179,9 @@ void manager::register_metrics(const sstring& group_name) {
         sm::make_counter("corrupted_files", _stats.corrupted_files,
                         sm::description("Number of hints files that were discarded during sending because the file was corrupted.")),
 
+        sm::make_counter("merged", _stats.merged,
+                        sm::description("Number of hints merged into another hint for the same partition before sending (see hints_merge_window_in_kb).")),
+
         sm::make_gauge("pending_drains", 
                         sm::description("Number of tasks waiting in the queue for draining hints"),
                         [this] { return _drain_lock.waiters(); }),
@@ -39,14 +39,32 @@ future<bool> is_mountpoint(const fs::path& path) {
     });
 }
 
-future<semaphore_units<named_semaphore::exception_factory>> resource_manager::get_send_units_for(size_t buf_size) {
-    // In order to impose a limit on the number of hints being sent concurrently,
-    // require each hint to reserve at least 1/(max concurrency) of the shard budget
+size_t resource_manager::per_shard_send_concurrency() const {
     const size_t per_node_concurrency_limit = _max_hints_send_queue_length();
-    const size_t per_shard_concurrency_limit = (per_node_concurrency_limit > 0)
+    return (per_node_concurrency_limit > 0)
             ? div_ceil(per_node_concurrency_limit, smp::count)
             : default_per_shard_concurrency_limit;
-    const size_t min_send_hint_budget = _max_send_in_flight_memory / per_shard_concurrency_limit;
+}
+
+void resource_manager::update_send_slots() noexcept {
+    const size_t limit = per_shard_send_concurrency();
+    // Slots taken over a lowered limit are given back as their sends complete.
+    if (limit > _send_slots_limit) {
+        _send_slots.signal(limit - _send_slots_limit);
+    } else {
+        _send_slots.consume(_send_slots_limit - limit);
+    }
+    _send_slots_limit = limit;
+}
+
+future<semaphore_units<named_semaphore::exception_factory>> resource_manager::get_send_slot() {
+    return get_units(_send_slots, 1);
+}
+
+future<semaphore_units<named_semaphore::exception_factory>> resource_manager::get_send_units_for(size_t buf_size) {
+    // In order to impose a limit on the number of hints being sent concurrently,
+    // require each hint to reserve at least 1/(max concurrency) of the shard budget
+    const size_t min_send_hint_budget = _max_send_in_flight_memory / per_shard_send_concurrency();
     // Let's approximate the memory size the mutation is going to consume by the size of its serialized form
     size_t hint_memory_budget = std::max(min_send_hint_budget, buf_size);
     // Allow a very big mutation to be sent out by consuming the whole shard budget
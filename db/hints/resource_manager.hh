@@ -119,6 +119,10 @@ class resource_manager {
     const size_t _max_send_in_flight_memory;
     utils::updateable_value<uint32_t> _max_hints_send_queue_length;
     seastar::named_semaphore _send_limiter;
+    // Hint mutations being sent by this shard, see get_send_slot().
+    size_t _send_slots_limit;
+    seastar::named_semaphore _send_slots;
+    utils::observer<uint32_t> _send_slots_observer;
 
     seastar::named_semaphore _operation_lock;
     space_watchdog::shard_managers_set _shard_managers;
@@ -159,6 +163,7 @@ class resource_manager {
     }
 
     future<> prepare_per_device_limits(manager& shard_manager);
+    void update_send_slots() noexcept;
 
 public:
     static constexpr size_t hint_segment_size_in_mb = 32;
@@ -171,6 +176,9 @@ class resource_manager {
         : _max_send_in_flight_memory(max_send_in_flight_memory)
         , _max_hints_send_queue_length(std::move(max_hint_sending_concurrency))
         , _send_limiter(_max_send_in_flight_memory, named_semaphore_exception_factory{"send limiter"})
+        , _send_slots_limit(per_shard_send_concurrency())
+        , _send_slots(_send_slots_limit, named_semaphore_exception_factory{"send slots"})
+        , _send_slots_observer(_max_hints_send_queue_length.observe([this] (uint32_t) { update_send_slots(); }))
         , _operation_lock(1, named_semaphore_exception_factory{"operation lock"})
         , _space_watchdog(_shard_managers, _per_device_limits_map)
         , _proxy(proxy)
@@ -180,6 +188,10 @@ class resource_manager {
     resource_manager& operator=(resource_manager&&) = delete;
 
     future<semaphore_units<named_semaphore::exception_factory>> get_send_units_for(size_t buf_size);
+    /// \brief The number of hint mutations a shard may send concurrently, derived from max_hinted_handoff_concurrency.
+    size_t per_shard_send_concurrency() const;
+    /// \brief Takes one of the per_shard_send_concurrency() slots, to be held while a hint mutation is being sent.
+    future<semaphore_units<named_semaphore::exception_factory>> get_send_slot();
     size_t sending_queue_length() const;
 
     future<> start(shared_ptr<gms::gossiper> gossiper_ptr);
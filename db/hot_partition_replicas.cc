@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/metrics.hh>
+#include <seastar/core/when_all.hh>
+
+#include "db/hot_partition_replicas.hh"
+#include "replica/database.hh"
+#include "mutation/frozen_mutation.hh"
+#include "mutation_query.hh"
+#include "readers/flat_mutation_reader_v2.hh"
+
+extern logging::logger dblog;
+
+namespace db {
+
+hot_partition_replicas::hot_partition_replicas(replica::database& db, config cfg)
+    : _db(db)
+    , _cfg(std::move(cfg))
+    , _timer([this] { on_timer(); })
+{
+    namespace sm = seastar::metrics;
+    _metrics.add_group("database", {
+        sm::make_counter("hot_partition_replications", _stats.replications,
+                       sm::description("The number of times a hot partition owned by this shard was copied to other shards.")),
+        sm::make_counter("hot_partition_replica_reads", _stats.reads,
+                       sm::description("The number of reads served from copies of hot partitions owned by other shards.")),
+        sm::make_counter("hot_partition_replica_invalidations", _stats.invalidations,
+                       sm::description("The number of times the copies of a hot partition owned by this shard were dropped due to writes.")),
+        sm::make_counter("hot_partition_replica_evictions", _stats.evictions,
+                       sm::description("The number of copies of hot partitions dropped to stay within the memory limit.")),
+    });
+    _timer.arm_periodic(period);
+}
+
+hot_partition_replicas::~hot_partition_replicas() {
+    while (!_copies.empty()) {
+        erase(_copies.begin());
+    }
+}
+
+future<> hot_partition_replicas::stop() {
+    _timer.cancel();
+    return _gate.close();
+}
+
+bool hot_partition_replicas::enabled() const noexcept {
+    return _cfg.replicas() > 0 && smp::count > 1;
+}
+
+void hot_partition_replicas::on_read(const schema_ptr& s, const dht::decorated_key& dk) {
+    if (!enabled() || s->per_partition_rate_limit_options().get_max_reads_per_second()) {
+        return;
+    }
+    _reads.append(key(s, dk));
+}
+
+void hot_partition_replicas::on_timer() {
+    if (_gate.is_closed()) {
+        return;
+    }
+    const unsigned replicas = enabled() ? std::min<unsigned>(_cfg.replicas(), smp::count - 1) : 0;
+    const auto threshold = _cfg.read_threshold();
+    std::vector<key> hot;
+    if (replicas) {
+        for (auto& r : _reads.top(max_hot_partitions)) {
+            if (r.count >= threshold) {
+                hot.push_back(std::move(r.item));
+            }
+        }
+    }
+    _reads = top_k();
+
+    // Partitions which cooled down are not copied anymore.
+    for (auto it = _replicated.begin(); it != _replicated.end();) {
+        if (std::ranges::none_of(hot, [&] (const key& k) { return key::comp{}(k, it->first); })) {
+            (void)with_gate(_gate, [this, k = it->first, replicas = it->second.replicas] {
+                return drop_copies(k.schema, k.key, replicas);
+            });
+            it = _replicated.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Hot partitions are copied again each period, which refreshes the copies
+    // after a schema change or an eviction.
+    for (auto& k : hot) {
+        auto& r = _replicated.try_emplace(k, replicated{0, replicas}).first->second;
+        r.epoch = ++_epoch;
+        r.replicas = std::max(r.replicas, replicas);
+        (void)with_gate(_gate, [this, k = std::move(k), epoch = r.epoch] () mutable {
+            return replicate(std::move(k), epoch);
+        });
+    }
+}
+
+future<> hot_partition_replicas::replicate(key k, uint64_t epoch) {
+    std::exception_ptr ex;
+    try {
+        auto& cf = _db.find_column_family(k.schema->id());
+        auto s = cf.schema();
+        auto permit = co_await _db.obtain_reader_permit(cf, "hot-partition-replication", db::no_timeout, {});
+        auto range = dht::partition_range::make_singular(k.key);
+        auto rd = cf.make_reader_v2(s, std::move(permit), range);
+        mutation_opt mo;
+        try {
+            mo = co_await read_mutation_from_flat_mutation_reader(rd);
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await rd.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+
+        // A write was applied while the partition was being read, so the contents
+        // may lack it. The next period will try again if it's still hot.
+        auto it = _replicated.find(k);
+        if (it == _replicated.end() || it->second.epoch != epoch) {
+            co_return;
+        }
+        frozen_mutation fm(mo ? *mo : mutation(s, k.key));
+        if (fm.representation().size() > max_partition_size) {
+            auto replicas = it->second.replicas;
+            _replicated.erase(it);
+            co_await drop_copies(s, k.key, replicas);
+            co_return;
+        }
+
+        // Copies are installed and dropped in the order the messages are submitted
+        // here and in drop_copies(), so no yielding between the check above and the submission.
+        const auto owner = this_shard_id();
+        std::vector<future<>> installed;
+        installed.reserve(it->second.replicas);
+        for (unsigned i = 1; i <= it->second.replicas; ++i) {
+            installed.push_back(_db.container().invoke_on((owner + i) % smp::count, [gs = global_schema_ptr(s), &fm] (replica::database& db) {
+                db.get_hot_partition_replicas().install(gs.get(), fm);
+            }));
+        }
+        ++_stats.replications;
+        co_await when_all_succeed(installed.begin(), installed.end()).discard_result();
+    } catch (replica::no_such_column_family&) {
+        _replicated.erase(k);
+    } catch (...) {
+        dblog.warn("Failed to copy hot partition {} of {}.{} to other shards: {}", k.key, k.schema->ks_name(), k.schema->cf_name(),
+                std::current_exception());
+    }
+}
+
+future<> hot_partition_replicas::drop_copies(const schema_ptr& s, const dht::decorated_key& dk, unsigned replicas) {
+    const auto owner = this_shard_id();
+    std::vector<future<>> dropped;
+    dropped.reserve(replicas);
+    for (unsigned i = 1; i <= replicas; ++i) {
+        dropped.push_back(_db.container().invoke_on((owner + i) % smp::count, [table = s->id(), dk] (replica::database& db) {
+            db.get_hot_partition_replicas().drop(table, dk);
+        }));
+    }
+    return when_all_succeed(dropped.begin(), dropped.end()).discard_result();
+}
+
+future<> hot_partition_replicas::on_write(const schema_ptr& s, const dht::decorated_key& dk) {
+    auto it = _replicated.find(key(s, dk));
+    if (it == _replicated.end()) {
+        return make_ready_future<>();
+    }
+    auto replicas = it->second.replicas;
+    _replicated.erase(it);
+    ++_stats.invalidations;
+    return drop_copies(s, dk, replicas);
+}
+
+future<> hot_partition_replicas::invalidate(table_id table) {
+    unsigned replicas = 0;
+    for (auto it = _replicated.begin(); it != _replicated.end();) {
+        if (it->first.schema->id() == table) {
+            replicas = std::max(replicas, it->second.replicas);
+            it = _replicated.erase(it);
+            ++_stats.invalidations;
+        } else {
+            ++it;
+        }
+    }
+    const auto owner = this_shard_id();
+    std::vector<future<>> dropped;
+    dropped.reserve(replicas);
+    for (unsigned i = 1; i <= replicas; ++i) {
+        dropped.push_back(_db.container().invoke_on((owner + i) % smp::count, [table] (replica::database& db) {
+            db.get_hot_partition_replicas().drop(table);
+        }));
+    }
+    return when_all_succeed(dropped.begin(), dropped.end()).discard_result();
+}
+
+shard_id hot_partition_replicas::read_shard(const schema_ptr& s, const dht::decorated_key& dk) {
+    const auto owner = this_shard_id();
+    if (_replicated.empty()) {
+        return owner;
+    }
+    auto it = _replicated.find(key(s, dk));
+    if (it == _replicated.end()) {
+        return owner;
+    }
+    auto& r = it->second;
+    auto i = r.next_read++ % (r.replicas + 1);
+    return (owner + i) % smp::count;
+}
+
+hot_partition_replicas::copies_type::iterator hot_partition_replicas::find(const schema& s, const dht::decorated_key& dk) noexcept {
+    auto [it, end] = _copies.equal_range(dk.token());
+    while (it != end && (it->second._mutation.schema()->id() != s.id() || !it->second._mutation.decorated_key().equal(s, dk))) {
+        ++it;
+    }
+    return it == end ? _copies.end() : it;
+}
+
+void hot_partition_replicas::erase(copies_type::iterator it) noexcept {
+    _memory_usage -= it->second._size;
+    _lru.erase(_lru.iterator_to(it->second));
+    _copies.erase(it);
+}
+
+void hot_partition_replicas::install(const schema_ptr& s, const frozen_mutation& fm) {
+    if (_gate.is_closed()) {
+        return;
+    }
+    auto m = fm.unfreeze(s);
+    if (auto it = find(*s, m.decorated_key()); it != _copies.end()) {
+        erase(it);
+    }
+    const auto size = fm.representation().size();
+    auto it = _copies.emplace(m.token(), partition_copy{
+        ._mutation = std::move(m),
+        ._size = size,
+    });
+    _lru.push_back(it->second);
+    _memory_usage += size;
+    while (_memory_usage > max_memory) {
+        auto& oldest = _lru.front();
+        erase(find(*oldest._mutation.schema(), oldest._mutation.decorated_key()));
+        ++_stats.evictions;
+    }
+}
+
+void hot_partition_replicas::drop(table_id table, const dht::decorated_key& dk) noexcept {
+    auto [it, end] = _copies.equal_range(dk.token());
+    while (it != end) {
+        auto next = std::next(it);
+        const auto& m = it->second._mutation;
+        if (m.schema()->id() == table && m.decorated_key().equal(*m.schema(), dk)) {
+            erase(it);
+        }
+        it = next;
+    }
+}
+
+void hot_partition_replicas::drop(table_id table) noexcept {
+    for (auto it = _copies.begin(); it != _copies.end();) {
+        auto next = std::next(it);
+        if (it->second._mutation.schema()->id() == table) {
+            erase(it);
+        }
+        it = next;
+    }
+}
+
+lw_shared_ptr<query::result> hot_partition_replicas::query(const schema_ptr& s, const query::read_command& cmd, const dht::partition_range& pr,
+        query::result_options opts) {
+    if (_copies.empty() || !pr.is_singular() || !pr.start()->value().has_key() || cmd.slice.is_reversed()) {
+        return {};
+    }
+    auto it = find(*s, pr.start()->value().as_decorated_key());
+    // Copies are made with the current schema of the owner, which may differ from
+    // the read's while a schema change propagates. Let the owner take care of those.
+    if (it == _copies.end() || it->second._mutation.schema()->version() != s->version()) {
+        return {};
+    }
+    _lru.erase(_lru.iterator_to(it->second));
+    _lru.push_back(it->second);
+    ++_stats.reads;
+    return make_lw_shared<query::result>(query_mutation(mutation(it->second._mutation), cmd.slice, cmd.get_row_limit(), cmd.timestamp, opts));
+}
+
+} // namespace db
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/timer.hh>
+
+#include <boost/intrusive/list.hpp>
+
+#include <unordered_map>
+
+#include "db/data_listeners.hh"
+#include "mutation/mutation.hh"
+#include "query-result.hh"
+#include "utils/updateable_value.hh"
+
+namespace replica {
+class database;
+}
+
+namespace query {
+class read_command;
+}
+
+namespace db {
+
+// Offloads the reads of read-hot partitions from the shards which own them.
+//
+// The sharder pins a partition to a single shard, so a flood of reads of one
+// partition saturates that shard while the other shards sit idle. When enabled,
+// each shard counts the single-partition reads it serves, and once per period it
+// copies the partitions which were read more than `read_threshold` times to the
+// `replicas` shards following it. Reads coordinated on a shard which holds a copy
+// are served from it by storage_proxy, instead of being sent to the owner.
+//
+// The owner remembers which partitions it copied. A write to such a partition drops
+// its copies after it's applied to the memtable and before it's acknowledged, so a
+// read never sees a copy older than an acknowledged write. Events which change the
+// contents of a table outside of the write path (truncate, streaming, ...) drop all
+// copies of the table's partitions.
+class hot_partition_replicas {
+public:
+    struct config {
+        // The number of shards to copy a hot partition to, 0 disables.
+        utils::updateable_value<uint32_t> replicas;
+        // The number of reads per period above which a partition is considered hot.
+        utils::updateable_value<uint32_t> read_threshold;
+    };
+    struct stats {
+        uint64_t replications = 0;
+        uint64_t reads = 0;
+        uint64_t invalidations = 0;
+        uint64_t evictions = 0;
+    };
+    // Max number of partitions each shard copies to others at a time.
+    static constexpr size_t max_hot_partitions = 16;
+    // Partitions which are larger than this when serialized are not copied.
+    static constexpr size_t max_partition_size = 128 * 1024;
+    // Max size of the copies held by a shard, the oldest are dropped to stay under it.
+    static constexpr size_t max_memory = 16 * 1024 * 1024;
+    static constexpr std::chrono::seconds period{1};
+private:
+    using key = toppartitions_item_key;
+    using top_k = toppartitions_data_listener::top_k;
+
+    // A partition owned by this shard, which was copied to others.
+    struct replicated {
+        uint64_t epoch;
+        unsigned replicas;
+        // Picks the shard serving the next read, see read_shard().
+        unsigned next_read = 0;
+    };
+
+    // A copy of a partition owned by another shard.
+    struct partition_copy {
+        boost::intrusive::list_member_hook<> _lru_link;
+        mutation _mutation;
+        size_t _size;
+    };
+    using copies_type = std::unordered_multimap<dht::token, partition_copy>;
+    using lru_type = boost::intrusive::list<partition_copy,
+        boost::intrusive::member_hook<partition_copy, boost::intrusive::list_member_hook<>, &partition_copy::_lru_link>>;
+
+    replica::database& _db;
+    config _cfg;
+    stats _stats;
+    top_k _reads;
+    std::unordered_map<key, replicated, key::hash, key::comp> _replicated;
+    uint64_t _epoch = 0;
+    copies_type _copies;
+    lru_type _lru;
+    size_t _memory_usage = 0;
+    timer<lowres_clock> _timer;
+    seastar::gate _gate;
+    seastar::metrics::metric_groups _metrics;
+private:
+    bool enabled() const noexcept;
+    void on_timer();
+    future<> replicate(key k, uint64_t epoch);
+    future<> drop_copies(const schema_ptr& s, const dht::decorated_key& dk, unsigned replicas);
+    void install(const schema_ptr& s, const frozen_mutation& fm);
+    void drop(table_id table, const dht::decorated_key& dk) noexcept;
+    void drop(table_id table) noexcept;
+    void erase(copies_type::iterator it) noexcept;
+    copies_type::iterator find(const schema& s, const dht::decorated_key& dk) noexcept;
+public:
+    hot_partition_replicas(replica::database& db, config cfg);
+    ~hot_partition_replicas();
+
+    future<> stop();
+
+    // Accounts a single-partition read served by the owning shard.
+    void on_read(const schema_ptr& s, const dht::decorated_key& dk);
+
+    // Whether this shard has partitions copied to others, i.e. writes need to call on_write().
+    bool empty() const noexcept { return _replicated.empty(); }
+
+    // Drops the copies of the partition, to be called after a write to it is applied on the owning shard.
+    future<> on_write(const schema_ptr& s, const dht::decorated_key& dk);
+
+    // Drops the copies of all partitions of the table owned by this shard.
+    future<> invalidate(table_id table);
+
+    // Returns the shard a read of the partition, arriving at its owner (this shard), should
+    // be served by. Reads of copied partitions are spread over the owner and the shards holding
+    // the copies in turns, so that the owner is offloaded even when clients send their requests
+    // straight to it. If the chosen shard has no copy after all, query() returns nullptr there
+    // and the owner has to serve the read.
+    shard_id read_shard(const schema_ptr& s, const dht::decorated_key& dk);
+
+    // Serves the read from the copy of the partition held by this shard, if there is one.
+    // Returns nullptr when the read has to be sent to the owning shard.
+    lw_shared_ptr<query::result> query(const schema_ptr& s, const query::read_command& cmd, const dht::partition_range& pr,
+            query::result_options opts);
+
+    const stats& get_stats() const noexcept { return _stats; }
+};
+
+} // namespace db
@@ -35,20 +35,85 @@ large_data_handler::large_data_handler(uint64_t partition_threshold_bytes, uint6
         partition_threshold_bytes, row_threshold_bytes, cell_threshold_bytes, rows_count_threshold, _collection_elements_count_threshold);
 }
 
-future<large_data_handler::partition_above_threshold> large_data_handler::maybe_record_large_partitions(const sstables::sstable& sst, const sstables::key& key, uint64_t partition_size, uint64_t rows) {
+template <typename T> static std::string key_to_str(const T& key, const schema& s) {
+    return fmt::to_string(key.with_schema(s));
+}
+
+large_data_handler::partition_above_threshold large_data_handler::maybe_record_large_partitions(const sstables::sstable& sst, const sstables::key& key, uint64_t partition_size, uint64_t rows) {
     assert(running());
     partition_above_threshold above_threshold{partition_size > _partition_threshold_bytes, rows > _rows_count_threshold};
     if (above_threshold.size) [[unlikely]] {
         ++_stats.partitions_bigger_than_threshold;
+        update_top_partitions(sst, key, partition_size, rows);
     }
     if (above_threshold.size || above_threshold.rows) [[unlikely]] {
-        return with_sem([&sst, &key, partition_size, rows, this] {
-            return record_large_partitions(sst, key, partition_size, rows);
-        }).then([above_threshold] {
-            return above_threshold;
-        });
+        record_large_partitions(sst, key, partition_size, rows);
+    }
+    return above_threshold;
+}
+
+void large_data_handler::update_top_partitions(const sstables::sstable& sst, const sstables::key& key, uint64_t partition_size, uint64_t rows) {
+    const schema& s = *sst.get_schema();
+    auto& top = _top_partitions[s.id()];
+    if (top.size() == top_partitions_per_table && top.back().size >= partition_size) {
+        return;
+    }
+    auto pk_str = key_to_str(key.to_partition_key(s), s);
+    // Compaction rewrites the partition to a new sstable, keep only the latest one.
+    std::erase_if(top, [&] (const large_partition_entry& e) { return e.partition_key == pk_str; });
+    auto it = std::ranges::upper_bound(top, partition_size, std::greater<uint64_t>(), &large_partition_entry::size);
+    top.insert(it, large_partition_entry{sstring(pk_str), sst_filename(sst), partition_size, rows});
+    if (top.size() > top_partitions_per_table) {
+        top.pop_back();
+    }
+}
+
+void large_data_handler::enqueue_record(sstring sstable_name, sstring key, noncopyable_function<future<> ()> write) {
+    key = format("{}:{}", sstable_name, key);
+    if (_queued_keys.contains(key)) {
+        return;
+    }
+    if (_queue.size() >= max_queued_records) {
+        static thread_local logging::logger::rate_limit rate_limit(std::chrono::seconds(30));
+        large_data_logger.log(log_level::warn, rate_limit, "Too many large data records pending, dropping {}", key);
+        ++_stats.records_dropped;
+        return;
+    }
+    _queued_keys.insert(key);
+    _queue.push_back(queued_record{std::move(sstable_name), std::move(key), std::move(write)});
+    if (!_drainer) {
+        _drainer = drain_records();
     }
-    return make_ready_future<partition_above_threshold>();
+    _queue_cv.signal();
+}
+
+future<> large_data_handler::drain_records() {
+    while (true) {
+        co_await _queue_cv.wait([this] { return !_queue.empty() || !running(); });
+        if (_queue.empty()) {
+            _queue_empty_cv.broadcast();
+            break;
+        }
+        auto rec = std::move(_queue.front());
+        _queue.pop_front();
+        _queued_keys.erase(rec.key);
+        if (_queue.empty()) {
+            _queue_empty_cv.broadcast();
+        }
+        auto units = co_await get_units(_sem, 1);
+        // Up to max_concurrency records are written in parallel, stop() waits for them.
+        (void)do_with(std::move(rec.write), [] (noncopyable_function<future<> ()>& write) {
+            return futurize_invoke(write);
+        }).handle_exception([key = std::move(rec.key)] (std::exception_ptr ep) {
+            large_data_logger.warn("Failed to write large data record {}: {}", key, ep);
+        }).finally([units = std::move(units)] {});
+    }
+}
+
+future<> large_data_handler::flush_records() {
+    co_await _queue_empty_cv.wait([this] { return _queue.empty(); });
+    // Wait for the records taken off the queue to be written
+    co_await get_units(_sem, max_concurrency);
 }
 
 void large_data_handler::start() {
@@ -58,6 +123,11 @@ void large_data_handler::start() {
 future<> large_data_handler::stop() {
     if (running()) {
         _running = false;
+        if (_drainer) {
+            large_data_logger.info("Writing {} queued records", _queue.size());
+            _queue_cv.signal();
+            co_await *std::exchange(_drainer, std::nullopt);
+        }
         large_data_logger.info("Waiting for {} background handlers", max_concurrency - _sem.available_units());
         co_await _sem.wait(max_concurrency);
     }
@@ -71,10 +141,6 @@ void large_data_handler::unplug_system_keyspace() noexcept {
     _sys_ks = nullptr;
 }
 
-template <typename T> static std::string key_to_str(const T& key, const schema& s) {
-    return fmt::to_string(key.with_schema(s));
-}
-
 sstring large_data_handler::sst_filename(const sstables::sstable& sst) {
     return sst.component_basename(sstables::component_type::Data);
 }
@@ -83,6 +149,23 @@ future<> large_data_handler::maybe_delete_large_data_entries(sstables::shared_ss
     assert(running());
     auto schema = sst->get_schema();
     auto filename = sst_filename(*sst);
+    if (auto it = _top_partitions.find(schema->id()); it != _top_partitions.end()) {
+        std::erase_if(it->second, [&] (const large_partition_entry& e) { return e.sstable_name == filename; });
+        if (it->second.empty()) {
+            _top_partitions.erase(it);
+        }
+    }
+    // The records of the sstable that are not written yet are stale now
+    std::erase_if(_queue, [&] (const queued_record& rec) {
+        if (rec.sstable_name != filename) {
+            return false;
+        }
+        _queued_keys.erase(rec.key);
+        return true;
+    });
+    if (_queue.empty()) {
+        _queue_empty_cv.broadcast();
+    }
     using ldt = sstables::large_data_type;
     auto above_threshold = [sst] (ldt type) -> bool {
         auto entry = sst->get_large_data_stat(type);
@@ -119,12 +202,12 @@ cql_table_large_data_handler::cql_table_large_data_handler(gms::feature_service&
     : large_data_handler(partition_threshold_mb() * MB, row_threshold_mb() * MB, cell_threshold_mb() * MB, rows_count_threshold(), collection_elements_count_threshold())
     , _feat(feat)
     , _record_large_cells([this] (const sstables::sstable& sst, const sstables::key& pk, const clustering_key_prefix* ck, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
-        return internal_record_large_cells(sst, pk, ck, cdef, cell_size, collection_elements);
+        internal_record_large_cells(sst, pk, ck, cdef, cell_size, collection_elements);
     })
     , _feat_listener(_feat.large_collection_detection.when_enabled([this] {
         large_data_logger.debug("Enabled large_collection detection");
         _record_large_cells = [this] (const sstables::sstable& sst, const sstables::key& pk, const clustering_key_prefix* ck, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
-            return internal_record_large_cells_and_collections(sst, pk, ck, cdef, cell_size, collection_elements);
+            internal_record_large_cells_and_collections(sst, pk, ck, cdef, cell_size, collection_elements);
         };
     }))
     , _partition_threshold_mb_updater(_partition_threshold_bytes, std::move(partition_threshold_mb), [] (uint32_t threshold_mb) { return uint64_t(threshold_mb) * MB; })
@@ -135,10 +218,10 @@ cql_table_large_data_handler::cql_table_large_data_handler(gms::feature_service&
 {}
 
 template <typename... Args>
-future<> cql_table_large_data_handler::try_record(std::string_view large_table, const sstables::sstable& sst,  const sstables::key& partition_key, int64_t size,
-        std::string_view desc, std::string_view extra_path, const std::vector<sstring> &extra_fields, Args&&... args) const {
+void cql_table_large_data_handler::try_record(std::string_view large_table, const sstables::sstable& sst,  const sstables::key& partition_key, int64_t size,
+        std::string_view desc, std::string_view extra_path, const std::vector<sstring> &extra_fields, Args&&... args) {
     if (!_sys_ks) {
-        return make_ready_future<>();
+        return;
     }
 
     sstring extra_fields_str;
@@ -156,63 +239,69 @@ future<> cql_table_large_data_handler::try_record(std::string_view large_table,
     std::string pk_str = key_to_str(partition_key.to_partition_key(s), s);
     auto timestamp = db_clock::now();
     large_data_logger.warn("Writing large {} {}/{}: {}{} ({} bytes) to {}", desc, ks_name, cf_name, pk_str, extra_path, size, sstable_name);
-    return _sys_ks->execute_cql(req, ks_name, cf_name, sstable_name, size, pk_str, timestamp, args...)
-            .discard_result()
-            .handle_exception([ks_name, cf_name, large_table, sstable_name] (std::exception_ptr ep) {
-                large_data_logger.warn("Failed to add a record to system.large_{}s: ks = {}, table = {}, sst = {} exception = {}",
-                        large_table, ks_name, cf_name, sstable_name, ep);
-            })
-            .finally([ p = _sys_ks ] {});
+    auto key = format("{}/{}{}", large_table, pk_str, extra_path);
+    enqueue_record(sstable_name, std::move(key), [this, req, ks_name, cf_name, sstable_name, size, pk_str, timestamp, large_table, ...args = std::forward<Args>(args)] () mutable {
+        if (!_sys_ks) {
+            return make_ready_future<>();
+        }
+        return _sys_ks->execute_cql(req, ks_name, cf_name, sstable_name, size, pk_str, timestamp, std::move(args)...)
+                .discard_result()
+                .handle_exception([ks_name, cf_name, large_table, sstable_name] (std::exception_ptr ep) {
+                    large_data_logger.warn("Failed to add a record to system.large_{}s: ks = {}, table = {}, sst = {} exception = {}",
+                            large_table, ks_name, cf_name, sstable_name, ep);
+                })
+                .finally([ p = _sys_ks ] {});
+    });
 }
 
-future<> cql_table_large_data_handler::record_large_partitions(const sstables::sstable& sst, const sstables::key& key, uint64_t partition_size, uint64_t rows) const {
-    return try_record("partition", sst, key, int64_t(partition_size), "partition", "", {"rows"}, data_value((int64_t)rows));
+void cql_table_large_data_handler::record_large_partitions(const sstables::sstable& sst, const sstables::key& key, uint64_t partition_size, uint64_t rows) {
+    try_record("partition", sst, key, int64_t(partition_size), "partition", "", {"rows"}, data_value((int64_t)rows));
 }
 
-future<> cql_table_large_data_handler::record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
-        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const {
-    return _record_large_cells(sst, partition_key, clustering_key, cdef, cell_size, collection_elements);
+void cql_table_large_data_handler::record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
+    _record_large_cells(sst, partition_key, clustering_key, cdef, cell_size, collection_elements);
 }
 
-future<> cql_table_large_data_handler::internal_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
-        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const {
+void cql_table_large_data_handler::internal_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
     auto column_name = cdef.name_as_text();
     std::string_view cell_type = cdef.is_atomic() ? "cell" : "collection";
     static const std::vector<sstring> extra_fields{"clustering_key", "column_name"};
     if (clustering_key) {
         const schema &s = *sst.get_schema();
         auto ck_str = key_to_str(*clustering_key, s);
-        return try_record("cell", sst, partition_key, int64_t(cell_size), cell_type, format("/{}/{}", ck_str, column_name), extra_fields, ck_str, column_name);
+        try_record("cell", sst, partition_key, int64_t(cell_size), cell_type, format("/{}/{}", ck_str, column_name), extra_fields, ck_str, column_name);
     } else {
         auto desc = format("static {}", cell_type);
-        return try_record("cell", sst, partition_key, int64_t(cell_size), desc, format("//{}", column_name), extra_fields, data_value::make_null(utf8_type), column_name);
+        try_record("cell", sst, partition_key, int64_t(cell_size), desc, format("//{}", column_name), extra_fields, data_value::make_null(utf8_type), column_name);
     }
 }
 
-future<> cql_table_large_data_handler::internal_record_large_cells_and_collections(const sstables::sstable& sst, const sstables::key& partition_key,
-        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const {
+void cql_table_large_data_handler::internal_record_large_cells_and_collections(const sstables::sstable& sst, const sstables::key& partition_key,
+        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
     auto column_name = cdef.name_as_text();
     std::string_view cell_type = cdef.is_atomic() ? "cell" : "collection";
     static const std::vector<sstring> extra_fields{"clustering_key", "column_name", "collection_elements"};
     if (clustering_key) {
         const schema &s = *sst.get_schema();
         auto ck_str = key_to_str(*clustering_key, s);
-        return try_record("cell", sst, partition_key, int64_t(cell_size), cell_type, format("/{}/{}", ck_str, column_name), extra_fields, ck_str, column_name, data_value((int64_t)collection_elements));
+        try_record("cell", sst, partition_key, int64_t(cell_size), cell_type, format("/{}/{}", ck_str, column_name), extra_fields, ck_str, column_name, data_value((int64_t)collection_elements));
     } else {
         auto desc = format("static {}", cell_type);
-        return try_record("cell", sst, partition_key, int64_t(cell_size), desc, format("//{}", column_name), extra_fields, data_value::make_null(utf8_type), column_name, data_value((int64_t)collection_elements));
+        try_record("cell", sst, partition_key, int64_t(cell_size), desc, format("//{}", column_name), extra_fields, data_value::make_null(utf8_type), column_name, data_value((int64_t)collection_elements));
     }
 }
 
-future<> cql_table_large_data_handler::record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
-        const clustering_key_prefix* clustering_key, uint64_t row_size) const {
+void cql_table_large_data_handler::record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
+        const clustering_key_prefix* clustering_key, uint64_t row_size) {
     static const std::vector<sstring> extra_fields{"clustering_key"};
     if (clustering_key) {
         const schema &s = *sst.get_schema();
         std::string ck_str = key_to_str(*clustering_key, s);
-        return try_record("row", sst, partition_key, int64_t(row_size), "row", format("/{}", ck_str), extra_fields,  ck_str);
+        try_record("row", sst, partition_key, int64_t(row_size), "row", format("/{}", ck_str), extra_fields,  ck_str);
     } else {
-        return try_record("row", sst, partition_key, int64_t(row_size), "static row", "", extra_fields, data_value::make_null(utf8_type));
+        try_record("row", sst, partition_key, int64_t(row_size), "static row", "", extra_fields, data_value::make_null(utf8_type));
     }
 }
 
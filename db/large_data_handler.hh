@@ -9,6 +9,11 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <seastar/core/condition-variable.hh>
+#include <seastar/util/noncopyable_function.hh>
 #include "schema/schema_fwd.hh"
 #include "system_keyspace.hh"
 #include "sstables/shared_sstable.hh"
@@ -27,8 +32,19 @@ class large_data_handler {
 public:
     struct stats {
         int64_t partitions_bigger_than_threshold = 0; // number of large partition updates exceeding threshold_bytes
+        uint64_t records_dropped = 0; // number of records not written because the queue was full
     };
 
+    // One of the largest partitions written by this shard to the sstables of a table.
+    struct large_partition_entry {
+        sstring partition_key;
+        sstring sstable_name;
+        uint64_t size;
+        uint64_t rows;
+    };
+    // The number of largest partitions remembered per table.
+    static constexpr size_t top_partitions_per_table = 10;
+
 private:
     // Assuming:
     // * there is at most one log entry every 1MB
@@ -40,6 +56,24 @@ class large_data_handler {
     static constexpr size_t max_concurrency = 16;
     semaphore _sem{max_concurrency};
 
+    // Records are written in the background, so that writers never wait for
+    // the system tables. When the queue is full, new records are dropped.
+    static constexpr size_t max_queued_records = 1024;
+    struct queued_record {
+        sstring sstable_name;
+        sstring key;
+        noncopyable_function<future<> ()> write;
+    };
+    std::deque<queued_record> _queue;
+    // Keys of the queued records, a record of the same key is not queued twice.
+    std::unordered_set<sstring> _queued_keys;
+    condition_variable _queue_cv;
+    condition_variable _queue_empty_cv;
+    // Started with the first queued record.
+    std::optional<future<>> _drainer;
+
+    std::unordered_map<table_id, std::vector<large_partition_entry>> _top_partitions;
+
     // A convenience function for using the above semaphore. Unlike the global with_semaphore, this will not wait on the
     // future returned by func. The objective is for the future returned by func to run in parallel with whatever the
     // caller is doing, but limit how far behind we can get.
@@ -76,42 +110,45 @@ class large_data_handler {
     void start();
     future<> stop();
 
-    future<bool> maybe_record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
+    // Waits until the records found so far are written.
+    future<> flush_records();
+
+    bool maybe_record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, uint64_t row_size) {
         assert(running());
         if (__builtin_expect(row_size > _row_threshold_bytes, false)) {
-            return with_sem([&sst, &partition_key, clustering_key, row_size, this] {
-                return record_large_rows(sst, partition_key, clustering_key, row_size);
-            }).then([] {
-                return true;
-            });
+            record_large_rows(sst, partition_key, clustering_key, row_size);
+            return true;
         }
-        return make_ready_future<bool>(false);
+        return false;
     }
 
     struct partition_above_threshold {
         bool size = false;
         bool rows = false;
     };
-    future<partition_above_threshold> maybe_record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows);
+    partition_above_threshold maybe_record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows);
 
-    future<bool> maybe_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+    bool maybe_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) {
         assert(running());
         if (__builtin_expect(cell_size > _cell_threshold_bytes || collection_elements > _collection_elements_count_threshold, false)) {
-            return with_sem([&sst, &partition_key, clustering_key, &cdef, cell_size, collection_elements, this] {
-                return record_large_cells(sst, partition_key, clustering_key, cdef, cell_size, collection_elements);
-            }).then([] {
-                return true;
-            });
+            record_large_cells(sst, partition_key, clustering_key, cdef, cell_size, collection_elements);
+            return true;
         }
-        return make_ready_future<bool>(false);
+        return false;
     }
 
     future<> maybe_delete_large_data_entries(sstables::shared_sstable sst);
 
     const large_data_handler::stats& stats() const { return _stats; }
 
+    // The largest partitions above the partition size threshold in the live
+    // sstables written by this shard, per table, in descending order of size.
+    const std::unordered_map<table_id, std::vector<large_partition_entry>>& top_partitions() const noexcept {
+        return _top_partitions;
+    }
+
     uint64_t get_partition_threshold_bytes() const noexcept {
         return _partition_threshold_bytes;
     }
@@ -134,16 +171,26 @@ class large_data_handler {
     void unplug_system_keyspace() noexcept;
 
 protected:
-    virtual future<> record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
-            const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const = 0;
-    virtual future<> record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key, const clustering_key_prefix* clustering_key, uint64_t row_size) const = 0;
+    // Queues a record of a large data item found in the given sstable for
+    // writing in the background. key identifies the item within the sstable.
+    void enqueue_record(sstring sstable_name, sstring key, noncopyable_function<future<> ()> write);
+
+    // The record_large_*() functions are called by the sstable writer and must
+    // not wait for the records to be written, see enqueue_record().
+    virtual void record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+            const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) = 0;
+    virtual void record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key, const clustering_key_prefix* clustering_key, uint64_t row_size) = 0;
     virtual future<> delete_large_data_entries(const schema& s, sstring sstable_name, std::string_view large_table_name) const = 0;
-    virtual future<> record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const = 0;
+    virtual void record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) = 0;
+
+private:
+    future<> drain_records();
+    void update_top_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows);
 };
 
 class cql_table_large_data_handler : public large_data_handler {
     gms::feature_service& _feat;
-    std::function<future<> (const sstables::sstable& sst, const sstables::key& partition_key,
+    std::function<void (const sstables::sstable& sst, const sstables::key& partition_key,
             const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements)> _record_large_cells;
     std::optional<std::any> _feat_listener;
 
@@ -164,44 +211,38 @@ class cql_table_large_data_handler : public large_data_handler {
             utils::updateable_value<uint32_t> collection_elements_count_threshold);
 
 protected:
-    virtual future<> record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const override;
+    virtual void record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) override;
     virtual future<> delete_large_data_entries(const schema& s, sstring sstable_name, std::string_view large_table_name) const override;
-    virtual future<> record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
-            const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const override;
-    virtual future<> record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key, const clustering_key_prefix* clustering_key, uint64_t row_size) const override;
+    virtual void record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+            const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) override;
+    virtual void record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key, const clustering_key_prefix* clustering_key, uint64_t row_size) override;
 
 private:
-    future<> internal_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
-            const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const;
-    future<> internal_record_large_cells_and_collections(const sstables::sstable& sst, const sstables::key& partition_key,
-            const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const;
+    void internal_record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+            const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements);
+    void internal_record_large_cells_and_collections(const sstables::sstable& sst, const sstables::key& partition_key,
+            const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements);
 
 private:
     template <typename... Args>
-    future<> try_record(std::string_view large_table, const sstables::sstable& sst,  const sstables::key& partition_key, int64_t size,
-            std::string_view desc, std::string_view extra_path, const std::vector<sstring> &extra_fields, Args&&... args) const;
+    void try_record(std::string_view large_table, const sstables::sstable& sst,  const sstables::key& partition_key, int64_t size,
+            std::string_view desc, std::string_view extra_path, const std::vector<sstring> &extra_fields, Args&&... args);
 };
 
 class nop_large_data_handler : public large_data_handler {
 public:
     nop_large_data_handler();
-    virtual future<> record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) const override {
-        return make_ready_future<>();
-    }
+    virtual void record_large_partitions(const sstables::sstable& sst, const sstables::key& partition_key, uint64_t partition_size, uint64_t rows) override {}
 
     virtual future<> delete_large_data_entries(const schema& s, sstring sstable_name, std::string_view large_table_name) const override {
         return make_ready_future<>();
     }
 
-    virtual future<> record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
-        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const override {
-        return make_ready_future<>();
-    }
+    virtual void record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) override {}
 
-    virtual future<> record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
-            const clustering_key_prefix* clustering_key, uint64_t row_size) const override {
-        return make_ready_future<>();
-    }
+    virtual void record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
+            const clustering_key_prefix* clustering_key, uint64_t row_size) override {}
 };
 
 }
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+
+#include "db/partition_heavy_hitters.hh"
+
+namespace db {
+
+void partition_heavy_hitters::maybe_switch_window(clock::time_point now) noexcept {
+    if (now - _current_window_start < window) {
+        return;
+    }
+    // If no operation came during the whole current window, the previous one
+    // is stale too.
+    if (now - _current_window_start < 2 * window) {
+        _previous = std::exchange(_current, counters{});
+    } else {
+        _previous = counters{};
+        _current = counters{};
+    }
+    _current_window_start = now;
+}
+
+void partition_heavy_hitters::record(int64_t token, uint64_t bytes) noexcept {
+    maybe_switch_window(clock::now());
+    try {
+        _current.operations.append(token);
+        if (bytes) {
+            _current.bytes.append(token, std::min<uint64_t>(bytes, std::numeric_limits<unsigned>::max()));
+        }
+    } catch (...) {
+        // The lists are only informational. A list is invalidated by the
+        // failure, and starts over in the next window.
+    }
+}
+
+std::vector<partition_heavy_hitters::partition> partition_heavy_hitters::top(size_t k) const {
+    std::unordered_map<int64_t, partition> partitions;
+    for (auto* c : {&_previous, &_current}) {
+        if (c->operations.valid()) {
+            for (auto& r : c->operations.top(capacity)) {
+                auto& p = partitions.try_emplace(r.item, partition{r.item, 0, 0}).first->second;
+                p.operations += r.count;
+            }
+        }
+        if (c->bytes.valid()) {
+            for (auto& r : c->bytes.top(capacity)) {
+                auto& p = partitions.try_emplace(r.item, partition{r.item, 0, 0}).first->second;
+                p.bytes += r.count;
+            }
+        }
+    }
+
+    std::vector<partition> ret;
+    ret.reserve(partitions.size());
+    for (auto& [_, p] : partitions) {
+        ret.push_back(p);
+    }
+    std::sort(ret.begin(), ret.end(), [] (const partition& a, const partition& b) {
+        return std::tie(a.operations, a.bytes) > std::tie(b.operations, b.bytes);
+    });
+    if (ret.size() > k) {
+        ret.resize(k);
+    }
+    return ret;
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <seastar/core/lowres_clock.hh>
+
+#include "utils/top_k.hh"
+
+namespace db {
+
+// Tracks the partitions of a table which receive the most operations of
+// a given kind on a shard, and the partitions which move the most bytes,
+// using space-saving top-k lists (utils/top_k.hh). Unlike the toppartitions
+// query, it is always on, so the hot partitions of the last seconds can be
+// looked up while a problem is happening.
+//
+// Partitions are identified by token, so that recording an operation of
+// a partition which is already tracked allocates nothing. Counting is done
+// in time windows, the current one and the previous one are kept. Windows
+// are switched lazily, by the operations themselves.
+class partition_heavy_hitters {
+public:
+    using clock = seastar::lowres_clock;
+
+    // How many partitions are tracked per window, by operations and by bytes.
+    static constexpr size_t capacity = 64;
+    static constexpr clock::duration window = std::chrono::seconds(10);
+
+    struct partition {
+        int64_t token;
+        uint64_t operations;
+        uint64_t bytes;
+    };
+
+private:
+    using top_k = utils::space_saving_top_k<int64_t>;
+
+    struct counters {
+        top_k operations{capacity};
+        top_k bytes{capacity};
+    };
+
+    counters _current;
+    counters _previous;
+    clock::time_point _current_window_start = clock::now();
+
+    void maybe_switch_window(clock::time_point now) noexcept;
+
+public:
+    // Records an operation which moved `bytes` bytes of the partition.
+    void record(int64_t token, uint64_t bytes) noexcept;
+
+    // Returns up to `k` partitions with the most operations in the current
+    // and the previous window, followed by those which only made it to the
+    // top by bytes.
+    std::vector<partition> top(size_t k) const;
+};
+
+}
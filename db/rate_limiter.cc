@@ -6,12 +6,14 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <algorithm>
 #include <cmath>
 #include <numbers>
 #include <array>
 #include <random>
 #include <variant>
 #include <chrono>
+#include <unordered_map>
 
 #include <seastar/core/metrics.hh>
 
@@ -39,6 +41,12 @@
 // time window. This strategy is also known as "lossy counting".
 //
 // Both mechanisms 1) and 2) are implemented in a lazy manner.
+//
+// When the hashmap is so full that no entry can be found for an operation,
+// the operation is counted in a count-min sketch with conservative update
+// instead. The sketch never underestimates, so a hot partition is still
+// limited under heavy key churn. It can overestimate the partitions which
+// collide with hot ones, but only those which don't fit in the hashmap.
 
 namespace db {
 
@@ -46,6 +54,12 @@ static constexpr size_t hash_bits = 16;
 static constexpr size_t entry_count = 1 << hash_bits;
 static constexpr size_t bucket_size = 10000;
 
+static constexpr size_t sketch_depth = 4;
+static constexpr size_t sketch_width = 1 << 14;
+
+// How many partitions with rejected operations are tracked per time window.
+static constexpr size_t rejected_top_k_capacity = 256;
+
 
 void rate_limiter_base::on_timer() noexcept {
     _time_window_history.pop_back();
@@ -60,6 +74,9 @@ void rate_limiter_base::on_timer() noexcept {
 
     _current_time_window = (_current_time_window + 1) % (1 << time_window_bits);
 
+    sketch_halve();
+    _previously_rejected = std::exchange(_rejected, rejected_top_k(rejected_top_k_capacity));
+
     // Because time window ids are 12 bit numbers and we increase the current
     // time window number by 1 every second, it wraps around every 4096
     // seconds (more than an hour). Because of this, some very old entry
@@ -139,6 +156,10 @@ rate_limiter_base::entry* rate_limiter_base::get_entry(uint32_t label, uint64_t
 }
 
 size_t rate_limiter_base::compute_hash(uint32_t label, uint64_t token) noexcept {
+    return compute_hash128(label, token)[0];
+}
+
+std::array<uint64_t, 2> rate_limiter_base::compute_hash128(uint32_t label, uint64_t token) noexcept {
     // The map key is a tuple (token, key) + salt
     // The key is hashed with murmur hash for good hash quality
 
@@ -154,7 +175,44 @@ size_t rate_limiter_base::compute_hash(uint32_t label, uint64_t token) noexcept
 
     std::array<uint64_t, 2> out;
     utils::murmur_hash::hash3_x64_128(key.data(), key_length, 0, out);
-    return out[0];
+    return out;
+}
+
+uint32_t rate_limiter_base::sketch_increase_and_get(uint32_t label, uint64_t token) noexcept {
+    // The counters of each row are chosen by combining the two halves of
+    // a single hash (Kirsch and Mitzenmacher).
+    const auto hash = compute_hash128(label, token);
+    std::array<size_t, sketch_depth> counters;
+    uint32_t estimate = std::numeric_limits<uint32_t>::max();
+    for (size_t i = 0; i < sketch_depth; i++) {
+        counters[i] = i * sketch_width + (hash[0] + i * hash[1]) % sketch_width;
+        estimate = std::min(estimate, _sketch[counters[i]]);
+    }
+
+    // Conservative update: raise only the counters which are below the new
+    // estimate. Counters shared with hotter partitions already account for
+    // this operation, and raising them would only add to the overestimation.
+    estimate = std::min<uint32_t>(estimate + 1, (1 << op_count_bits) - 1);
+    for (auto c : counters) {
+        _sketch[c] = std::max(_sketch[c], estimate);
+    }
+    return estimate;
+}
+
+void rate_limiter_base::sketch_halve() noexcept {
+    for (auto& c : _sketch) {
+        c /= 2;
+    }
+}
+
+void rate_limiter_base::record_rejection(uint32_t label, uint64_t token) noexcept {
+    ++_metrics.rejected_operations;
+    try {
+        _rejected.append(partition_id{label, token});
+    } catch (...) {
+        // The list is only informational. It is invalidated by the failure,
+        // and starts over in the next time window.
+    }
 }
 
 void rate_limiter_base::entry_refresh(rate_limiter_base::entry& b) noexcept {
@@ -206,7 +264,10 @@ void rate_limiter_base::register_metrics() {
                 sm::description("Number of times a lookup returned an already allocated entry.")),
 
         sm::make_counter("failed_allocations", _metrics.failed_allocations,
-                sm::description("Number of times the rate limiter gave up trying to allocate.")),
+                sm::description("Number of times the rate limiter gave up trying to allocate, and counted the operation in the sketch instead.")),
+
+        sm::make_counter("rejected_operations", _metrics.rejected_operations,
+                sm::description("Number of operations rejected because their partition was over the limit.")),
 
         sm::make_counter("probe_count", _metrics.probe_count,
                 sm::description("Number of probes made during lookups.")),
@@ -225,8 +286,11 @@ void rate_limiter_base::register_metrics() {
 rate_limiter_base::rate_limiter_base()
         : _salt(std::random_device{}())
         , _entries(entry_count)
-        , _time_window_history(op_count_bits - 1) {
-    
+        , _time_window_history(op_count_bits - 1)
+        , _sketch(sketch_depth * sketch_width)
+        , _rejected(rejected_top_k_capacity)
+        , _previously_rejected(rejected_top_k_capacity) {
+
     register_metrics();
 }
 
@@ -238,10 +302,10 @@ uint64_t rate_limiter_base::increase_and_get_counter(label& l, uint64_t token) n
 
     entry* b = get_entry(l._label, token);
     if (!b) {
-        // We failed to allocate a entry for this partition. This means that
-        // we won't track hit count for this partition during this time window.
-        // Assume that it's OK to admit the operation.
-        return 0;
+        // We failed to allocate a entry for this partition, count it in
+        // the sketch. The sketch doesn't do lossy counting, it doesn't need
+        // to protect the hashmap from flooding.
+        return sketch_increase_and_get(l._label, token);
     }
 
     // Protect from wrap-around
@@ -292,6 +356,7 @@ rate_limiter_base::can_proceed rate_limiter_base::account_operation(
             if (info->get_random_variable_as_double() * double(count) * std::numbers::ln2 < double(limit)) {
                 return can_proceed::yes;
             } else {
+                record_rejection(l._label, token);
                 return can_proceed::no;
             }
         }
@@ -300,6 +365,33 @@ rate_limiter_base::can_proceed rate_limiter_base::account_operation(
     }
 }
 
+std::vector<rate_limiter_base::rejected_partition> rate_limiter_base::top_rejected(const label& l, size_t k) const {
+    std::unordered_map<uint64_t, uint64_t> counts;
+    for (auto* top : {&_previously_rejected, &_rejected}) {
+        if (!top->valid()) {
+            continue;
+        }
+        for (auto& r : top->top(rejected_top_k_capacity)) {
+            if (r.item.label == l._label) {
+                counts[r.item.token] += r.count;
+            }
+        }
+    }
+
+    std::vector<rejected_partition> ret;
+    ret.reserve(counts.size());
+    for (auto& [token, count] : counts) {
+        ret.push_back(rejected_partition{token, count});
+    }
+    std::sort(ret.begin(), ret.end(), [] (const rejected_partition& a, const rejected_partition& b) {
+        return a.count > b.count;
+    });
+    if (ret.size() > k) {
+        ret.resize(k);
+    }
+    return ret;
+}
+
 template class generic_rate_limiter<seastar::lowres_clock>;
 
 }
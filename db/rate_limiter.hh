@@ -14,6 +14,7 @@
 #include <limits>
 #include <concepts>
 #include <vector>
+#include <array>
 #include <optional>
 #include <random>
 
@@ -24,6 +25,7 @@
 #include <seastar/util/bool_class.hh>
 
 #include "utils/chunked_vector.hh"
+#include "utils/top_k.hh"
 #include "db/per_partition_rate_limit_info.hh"
 
 // A data structure used to implement per-partition rate limiting. It accounts
@@ -43,6 +45,7 @@ class rate_limiter_base {
         uint64_t successful_lookups = 0;
         uint64_t failed_allocations = 0;
         uint64_t probe_count = 0;
+        uint64_t rejected_operations = 0;
     };
 
     // Represents a piece of the hashmap storage.
@@ -77,10 +80,31 @@ class rate_limiter_base {
         uint32_t lossy_counting_decrease = 0;
     };
 
+    // Identifies a partition within a label, for the list of the partitions
+    // with the most rejected operations.
+    struct partition_id {
+        uint32_t label;
+        uint64_t token;
+
+        bool operator==(const partition_id&) const = default;
+    };
+    struct partition_id_hash {
+        size_t operator()(const partition_id& id) const noexcept {
+            return std::hash<uint64_t>()(id.token) ^ id.label;
+        }
+    };
+    using rejected_top_k = utils::space_saving_top_k<partition_id, partition_id_hash>;
+
 public:
     struct can_proceed_tag{};
     using can_proceed = seastar::bool_class<can_proceed_tag>;
 
+    struct rejected_partition {
+        uint64_t token;
+        // Operations rejected in the current and the previous time window.
+        uint64_t count;
+    };
+
     // Identifies a type of operation which is counted separately from other
     // operations. For example, reads and writes for given table should have
     // separate labels.
@@ -106,12 +130,28 @@ class rate_limiter_base {
     utils::chunked_vector<entry> _entries;
     std::vector<time_window_entry> _time_window_history;
 
+    // Count-min sketch counting the operations which didn't get an entry
+    // in the hashmap, `sketch_depth` rows of counters stored one after
+    // another. Halved on each time window change, like the entries.
+    utils::chunked_vector<uint32_t> _sketch;
+
+    // Partitions with the most rejected operations in the current and
+    // the previous time window.
+    rejected_top_k _rejected;
+    rejected_top_k _previously_rejected;
+
     metrics _metrics;
     seastar::metrics::metric_groups _metric_group;
 
 private:
     entry* get_entry(uint32_t label, uint64_t token) noexcept;
     size_t compute_hash(uint32_t label, uint64_t token) noexcept;
+    std::array<uint64_t, 2> compute_hash128(uint32_t label, uint64_t token) noexcept;
+
+    uint32_t sketch_increase_and_get(uint32_t label, uint64_t token) noexcept;
+    void sketch_halve() noexcept;
+
+    void record_rejection(uint32_t label, uint64_t token) noexcept;
 
     void entry_refresh(entry& b) noexcept;
     bool entry_is_empty(const entry& b) noexcept;
@@ -147,6 +187,10 @@ class rate_limiter_base {
     // only `limit` operations per second are admitted.
     can_proceed account_operation(label& l, uint64_t token, uint64_t limit,
             const db::per_partition_rate_limit::info& rate_limit_info) noexcept;
+
+    // Returns up to `k` partitions with the most operations rejected
+    // for given label recently, most rejected first.
+    std::vector<rejected_partition> top_rejected(const label& l, size_t k) const;
 };
 
 template<typename ClockType>
@@ -1271,14 +1271,31 @@ static future<> do_merge_schema(distributed<service::storage_proxy>& proxy, shar
         slogger.debug("Affected tables for keyspace {}: {}", keyspace_name, sel.tables);
     }
 
+    // Only the schema tables which the mutations modify can differ before and after
+    // applying them, so don't read the others, e.g. the types and functions of the
+    // affected keyspaces when a table is created or altered.
+    auto read_if_modified = [&] (const schema_ptr& table) -> future<schema_result> {
+        if (!reload && !column_families.contains(table->id())) {
+            return make_ready_future<schema_result>();
+        }
+        return read_schema_for_keyspaces(proxy, table->cf_name(), keyspaces);
+    };
+    auto read_aggregates_if_modified = [&] (const schema_ptr& table) -> future<schema_result> {
+        // Aggregates are merged from both tables, so read both if either is modified.
+        if (!reload && !column_families.contains(aggregates()->id()) && !column_families.contains(scylla_aggregates()->id())) {
+            return make_ready_future<schema_result>();
+        }
+        return read_schema_for_keyspaces(proxy, table->cf_name(), keyspaces);
+    };
+
     // current state of the schema
-    auto&& old_keyspaces = co_await read_schema_for_keyspaces(proxy, KEYSPACES, keyspaces);
+    auto&& old_keyspaces = co_await read_if_modified(s);
     auto&& old_column_families = co_await read_tables_for_keyspaces(proxy, keyspaces, table_kind::table, affected_tables);
-    auto&& old_types = co_await read_schema_for_keyspaces(proxy, TYPES, keyspaces);
+    auto&& old_types = co_await read_if_modified(types());
     auto&& old_views = co_await read_tables_for_keyspaces(proxy, keyspaces, table_kind::view, affected_tables);
-    auto old_functions = co_await read_schema_for_keyspaces(proxy, FUNCTIONS, keyspaces);
-    auto old_aggregates = co_await read_schema_for_keyspaces(proxy, AGGREGATES, keyspaces);
-    auto old_scylla_aggregates = co_await read_schema_for_keyspaces(proxy, SCYLLA_AGGREGATES, keyspaces);
+    auto old_functions = co_await read_if_modified(functions());
+    auto old_aggregates = co_await read_aggregates_if_modified(aggregates());
+    auto old_scylla_aggregates = co_await read_aggregates_if_modified(scylla_aggregates());
 
     if (proxy.local().get_db().local().uses_schema_commitlog()) {
         co_await proxy.local().get_db().local().apply(freeze(mutations), db::no_timeout);
@@ -1294,13 +1311,13 @@ static future<> do_merge_schema(distributed<service::storage_proxy>& proxy, shar
     }
 
     // with new data applied
-    auto&& new_keyspaces = co_await read_schema_for_keyspaces(proxy, KEYSPACES, keyspaces);
+    auto&& new_keyspaces = co_await read_if_modified(s);
     auto&& new_column_families = co_await read_tables_for_keyspaces(proxy, keyspaces, table_kind::table, affected_tables);
-    auto&& new_types = co_await read_schema_for_keyspaces(proxy, TYPES, keyspaces);
+    auto&& new_types = co_await read_if_modified(types());
     auto&& new_views = co_await read_tables_for_keyspaces(proxy, keyspaces, table_kind::view, affected_tables);
-    auto new_functions = co_await read_schema_for_keyspaces(proxy, FUNCTIONS, keyspaces);
-    auto new_aggregates = co_await read_schema_for_keyspaces(proxy, AGGREGATES, keyspaces);
-    auto new_scylla_aggregates = co_await read_schema_for_keyspaces(proxy, SCYLLA_AGGREGATES, keyspaces);
+    auto new_functions = co_await read_if_modified(functions());
+    auto new_aggregates = co_await read_aggregates_if_modified(aggregates());
+    auto new_scylla_aggregates = co_await read_aggregates_if_modified(scylla_aggregates());
 
     std::set<sstring> keyspaces_to_drop = co_await merge_keyspaces(proxy, std::move(old_keyspaces), std::move(new_keyspaces));
     auto types_to_drop = co_await merge_types(proxy, std::move(old_types), std::move(new_types));
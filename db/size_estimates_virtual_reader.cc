@@ -161,7 +161,7 @@ static dht::partition_range as_ring_position_range(dht::token_range& r) {
  */
 static system_keyspace::range_estimates estimate(const replica::column_family& cf, const token_range& r) {
     int64_t count{0};
-    utils::estimated_histogram hist{0};
+    uint64_t size{0};
     auto from_bytes = [] (auto& b) {
         return dht::token::from_sstring(utf8_type->to_string(b));
     };
@@ -174,10 +174,10 @@ static system_keyspace::range_estimates estimate(const replica::column_family& c
         auto rp_range = as_ring_position_range(r);
         for (auto&& sstable : cf.select_sstables(rp_range)) {
             count += sstable->estimated_keys_for_range(r);
-            hist.merge(sstable->get_stats_metadata().estimated_partition_size);
+            size += sstable->estimated_size_for_range(r);
         }
     }
-    return {cf.schema(), r.start, r.end, count, count > 0 ? hist.mean() : 0};
+    return {cf.schema(), r.start, r.end, count, count > 0 ? int64_t(size / count) : 0};
 }
 
 /**
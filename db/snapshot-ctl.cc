@@ -12,13 +12,216 @@
 
 #include <boost/range/adaptors.hpp>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/coroutine/exception.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/http/exception.hh>
+#include <seastar/util/file.hh>
 #include "db/snapshot-ctl.hh"
 #include "replica/database.hh"
+#include "sstables/open_info.hh"
+#include "sstables/sstables.hh"
+#include "sstables/sstables_manager.hh"
+#include "utils/lister.hh"
+#include "utils/s3/client.hh"
+
+static logging::logger snap_log("snapshots");
 
 namespace db {
 
+class snapshot_ctl::task_manager_module : public tasks::task_manager::module {
+public:
+    task_manager_module(tasks::task_manager& tm) noexcept : tasks::task_manager::module(tm, "snapshot") {}
+};
+
+// Uploads the components found in a table's snapshot directory to an S3 bucket.
+// Snapshots hard-link the sstables of all shards into the same directory, so a
+// single task on the shard the backup was started on uploads all of them.
+//
+// Sstables are immutable and their component names carry the generation, so an
+// object of the same name and size under the same prefix is a copy of the local
+// component, as long as it was uploaded by a backup of the same sstable. The
+// latter is checked by tagging every uploaded component with the full checksum
+// of its sstable (the content of the Digest component), which also guards
+// against objects left behind by uploads interrupted before the tag was set.
+class backup_task_impl : public tasks::task_manager::task::impl {
+    static constexpr auto digest_tag = "scylla-digest";
+
+    snapshot_ctl& _snap_ctl;
+    shared_ptr<s3::client> _client;
+    sstring _bucket;
+    sstring _prefix;
+    std::filesystem::path _snapshot_dir;
+    tasks::task_manager::task::progress _progress;
+    size_t _uploaded = 0;
+    size_t _skipped = 0;
+
+    sstring object_name(const sstring& name) const {
+        return format("/{}/{}/{}", _bucket, _prefix, name);
+    }
+
+    std::optional<sstables::entry_descriptor> parse_component(const sstring& name) const;
+    future<std::optional<sstring>> read_digest(const sstables::entry_descriptor& desc) const;
+    future<bool> is_uploaded(const sstring& object, uint64_t size, const std::optional<sstring>& digest) const;
+    future<> upload_file(const sstring& name, uint64_t size);
+    future<> do_backup();
+public:
+    backup_task_impl(tasks::task_manager::module_ptr module, snapshot_ctl& ctl, shared_ptr<s3::client> client,
+            sstring bucket, sstring prefix, sstring ks_name, sstring cf_name, sstring tag, std::filesystem::path snapshot_dir) noexcept
+        : tasks::task_manager::task::impl(module, tasks::task_id::create_random_id(), module->new_sequence_number(), "table", std::move(ks_name), std::move(cf_name), std::move(tag), tasks::task_id::create_null_id())
+        , _snap_ctl(ctl)
+        , _client(std::move(client))
+        , _bucket(std::move(bucket))
+        , _prefix(std::move(prefix))
+        , _snapshot_dir(std::move(snapshot_dir))
+    {
+        _status.progress_units = "bytes";
+    }
+
+    virtual std::string type() const override {
+        return "backup";
+    }
+
+    virtual tasks::is_abortable is_abortable() const noexcept override {
+        return tasks::is_abortable::yes;
+    }
+
+    virtual future<tasks::task_manager::task::progress> get_progress() const override {
+        return make_ready_future<tasks::task_manager::task::progress>(_progress);
+    }
+protected:
+    virtual future<> run() override {
+        return with_scheduling_group(_snap_ctl._config.backup_sched_group, [this] {
+            return do_backup();
+        });
+    }
+};
+
+// Returns the descriptor of an sstable component, or nothing for the other
+// files of a snapshot (manifest.json, schema.cql).
+std::optional<sstables::entry_descriptor> backup_task_impl::parse_component(const sstring& name) const {
+    try {
+        return sstables::parse_path(_snapshot_dir / name, sstring(_status.keyspace), sstring(_status.table));
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+// Returns the content of the Digest component of the given sstable, or
+// nothing if it has none.
+future<std::optional<sstring>> backup_task_impl::read_digest(const sstables::entry_descriptor& desc) const {
+    auto digest_name = sstables::sstable::component_basename(sstring(_status.keyspace), sstring(_status.table), desc.version, desc.generation, desc.format, sstables::component_type::Digest);
+    auto digest_path = _snapshot_dir / digest_name;
+    if (!co_await file_exists(digest_path.native())) {
+        co_return std::nullopt;
+    }
+    auto content = co_await util::read_entire_file_contiguous(digest_path);
+    co_return sstring(content.begin(), content.end());
+}
+
+future<bool> backup_task_impl::is_uploaded(const sstring& object, uint64_t size, const std::optional<sstring>& digest) const {
+    if (!digest) {
+        co_return false;
+    }
+    try {
+        auto st = co_await _client->get_object_stats(object);
+        if (st.size != size) {
+            co_return false;
+        }
+        auto tags = co_await _client->get_object_tagging(object);
+        co_return std::ranges::find(tags, s3::tag{digest_tag, *digest}) != tags.end();
+    } catch (const seastar::httpd::unexpected_status_error& e) {
+        if (e.status() != seastar::http::reply::status_type::not_found) {
+            throw;
+        }
+    }
+    co_return false;
+}
+
+future<> backup_task_impl::upload_file(const sstring& name, uint64_t size) {
+    auto object = object_name(name);
+    auto desc = parse_component(name);
+    std::optional<sstring> digest;
+    if (desc) {
+        digest = co_await read_digest(*desc);
+    }
+    if (co_await is_uploaded(object, size, digest)) {
+        snap_log.debug("Backup: {} is already uploaded as {}", name, object);
+        ++_skipped;
+        co_return;
+    }
+
+    snap_log.debug("Backup: uploading {} to {}", name, object);
+    auto f = co_await open_file_dma((_snapshot_dir / name).native(), open_flags::ro);
+    auto in = make_file_input_stream(std::move(f));
+    // The plain upload sink is limited in the number of parts, see s3_storage::make_data_or_index_sink()
+    bool jumbo = desc && (desc->component == sstables::component_type::Data || desc->component == sstables::component_type::Index);
+    auto out = output_stream<char>(jumbo ? _client->make_upload_jumbo_sink(object) : _client->make_upload_sink(object));
+    std::exception_ptr ex;
+    try {
+        co_await copy(in, out);
+        co_await out.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await out.close();
+    co_await in.close();
+    if (ex) {
+        co_await coroutine::return_exception_ptr(std::move(ex));
+    }
+    if (digest) {
+        co_await _client->put_object_tagging(object, {s3::tag{digest_tag, *digest}});
+    }
+    ++_uploaded;
+}
+
+future<> backup_task_impl::do_backup() {
+    // Keep the snapshot from being cleared while it's being uploaded
+    auto lock_holder = co_await _snap_ctl._lock.hold_read_lock();
+
+    std::vector<std::pair<sstring, uint64_t>> files;
+    directory_lister lister(_snapshot_dir, lister::dir_entry_types::of<directory_entry_type::regular>());
+    std::exception_ptr ex;
+    try {
+        while (auto de = co_await lister.get()) {
+            auto size = co_await file_size((_snapshot_dir / de->name).native());
+            files.emplace_back(de->name, size);
+            _progress.total += size;
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await lister.close();
+    if (ex) {
+        co_await coroutine::return_exception_ptr(std::move(ex));
+    }
+
+    for (const auto& [name, size] : files) {
+        _as.check();
+        co_await upload_file(name, size);
+        _progress.completed += size;
+    }
+    snap_log.info("Backup of snapshot {} of {}.{} to {}: uploaded {} and skipped {} of {} files",
+            _status.entity, _status.keyspace, _status.table, object_name(""), _uploaded, _skipped, files.size());
+}
+
+snapshot_ctl::snapshot_ctl(sharded<replica::database>& db, tasks::task_manager& tm, config cfg)
+    : _config(std::move(cfg))
+    , _db(db)
+    , _task_manager_module(make_shared<task_manager_module>(tm))
+{
+    tm.register_module(_task_manager_module->get_name(), _task_manager_module);
+}
+
+future<> snapshot_ctl::stop() {
+    if (auto tm = std::exchange(_task_manager_module, nullptr)) {
+        co_await tm->stop();
+    }
+    co_await _ops.close();
+}
+
 future<> snapshot_ctl::check_snapshot_not_exist(sstring ks_name, sstring name, std::optional<std::vector<sstring>> filter) {
     auto& ks = _db.local().find_keyspace(ks_name);
     return parallel_for_each(ks.metadata()->cf_meta_data(), [this, ks_name = std::move(ks_name), name = std::move(name), filter = std::move(filter)] (auto& pair) {
@@ -130,4 +333,25 @@ future<int64_t> snapshot_ctl::true_snapshots_size() {
     }));
 }
 
+future<tasks::task_id> snapshot_ctl::start_backup(sstring endpoint, sstring bucket, sstring prefix, sstring ks_name, sstring cf_name, sstring tag) {
+    if (this_shard_id() != 0) {
+        co_return co_await container().invoke_on(0, [&] (snapshot_ctl& snap) {
+            return snap.start_backup(std::move(endpoint), std::move(bucket), std::move(prefix), std::move(ks_name), std::move(cf_name), std::move(tag));
+        });
+    }
+
+    auto& table = _db.local().find_column_family(ks_name, cf_name);
+    if (!table.get_storage_options().is_local_type()) {
+        throw std::invalid_argument(format("Table {}.{} is not stored locally", ks_name, cf_name));
+    }
+    if (!co_await table.snapshot_exists(tag)) {
+        throw std::invalid_argument(format("Table {}.{} has no snapshot {}", ks_name, cf_name, tag));
+    }
+    auto client = _db.local().get_user_sstables_manager().get_endpoint_client(endpoint);
+    auto snapshot_dir = std::filesystem::path(table.dir()) / sstables::snapshots_dir / tag;
+    auto task = co_await _task_manager_module->make_and_start_task<backup_task_impl>({}, *this, std::move(client),
+            std::move(bucket), std::move(prefix), std::move(ks_name), std::move(cf_name), std::move(tag), std::move(snapshot_dir));
+    co_return task->id();
+}
+
 }
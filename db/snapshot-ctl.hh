@@ -16,7 +16,9 @@
 
 #include <seastar/core/sharded.hh>
 #include <seastar/core/future.hh>
+#include <seastar/core/scheduling.hh>
 #include "replica/database_fwd.hh"
+#include "tasks/task_manager.hh"
 #include <seastar/core/gate.hh>
 #include <seastar/core/rwlock.hh>
 
@@ -29,6 +31,14 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
     using skip_flush = bool_class<class skip_flush_tag>;
     using snap_views = bool_class<class snap_views_tag>;
 
+    struct config {
+        // The group backups run in, which bounds the disk and network
+        // bandwidth they take away from the regular workload.
+        seastar::scheduling_group backup_sched_group;
+    };
+
+    class task_manager_module;
+
     struct snapshot_details {
         int64_t live;
         int64_t total;
@@ -37,11 +47,9 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
 
         bool operator==(const snapshot_details&) const = default;
     };
-    explicit snapshot_ctl(sharded<replica::database>& db) : _db(db) {}
+    snapshot_ctl(sharded<replica::database>& db, tasks::task_manager& tm, config cfg);
 
-    future<> stop() {
-        return _ops.close();
-    }
+    future<> stop();
 
     /**
      * Takes the snapshot for all keyspaces. A snapshot name must be specified.
@@ -88,8 +96,20 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
     future<std::unordered_map<sstring, std::vector<snapshot_details>>> get_snapshot_details();
 
     future<int64_t> true_snapshots_size();
+
+    /**
+     * Starts uploading the sstables of a table's snapshot to the given bucket
+     * of an S3 endpoint, under the given prefix. Components already present in
+     * the bucket from an earlier backup to the same prefix are not uploaded again.
+     * The upload runs as a task of the "snapshot" task manager module.
+     *
+     * @return the id of the started task
+     */
+    future<tasks::task_id> start_backup(sstring endpoint, sstring bucket, sstring prefix, sstring ks_name, sstring cf_name, sstring tag);
 private:
+    config _config;
     sharded<replica::database>& _db;
+    shared_ptr<task_manager_module> _task_manager_module;
     seastar::rwlock _lock;
     seastar::gate _ops;
 
@@ -103,6 +123,8 @@ class snapshot_ctl : public peering_sharded_service<snapshot_ctl> {
 
     future<> do_take_snapshot(sstring tag, std::vector<sstring> keyspace_names, skip_flush sf = skip_flush::no);
     future<> do_take_column_family_snapshot(sstring ks_name, std::vector<sstring> tables, sstring tag, snap_views, skip_flush sf = skip_flush::no);
+
+    friend class backup_task_impl;
 };
 
 }
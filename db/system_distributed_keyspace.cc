@@ -211,7 +211,8 @@ system_distributed_keyspace::system_distributed_keyspace(cql3::query_processor&
 
 static thread_local std::pair<std::string_view, data_type> new_columns[] {
     {"timeout", duration_type},
-    {"workload_type", utf8_type}
+    {"workload_type", utf8_type},
+    {"shares", int32_type}
 };
 
 static bool has_missing_columns(data_dictionary::database db) noexcept {
@@ -784,6 +785,14 @@ static qos::service_level_options::timeout_type get_duration(const cql3::untyped
     return std::chrono::duration_cast<lowres_clock::duration>(std::chrono::nanoseconds(dur_opt->nanoseconds));
 };
 
+static qos::service_level_options::shares_type get_shares(const cql3::untyped_result_set_row& row) {
+    auto shares_opt = row.get_opt<int32_t>("shares");
+    if (!shares_opt) {
+        return qos::service_level_options::unset_marker{};
+    }
+    return *shares_opt;
+}
+
 future<qos::service_levels_info> system_distributed_keyspace::get_service_levels() const {
     static sstring prepared_query = format("SELECT * FROM {}.{};", NAME, SERVICE_LEVELS);
 
@@ -796,6 +805,7 @@ future<qos::service_levels_info> system_distributed_keyspace::get_service_levels
                 qos::service_level_options slo{
                     .timeout = get_duration(row, "timeout"),
                     .workload = workload.value_or(qos::service_level_options::workload_type::unspecified),
+                    .shares = get_shares(row),
                 };
                 service_levels.emplace(service_level_name, slo);
             } catch (...) {
@@ -818,6 +828,7 @@ future<qos::service_levels_info> system_distributed_keyspace::get_service_level(
                 qos::service_level_options slo{
                     .timeout = get_duration(row, "timeout"),
                     .workload = workload.value_or(qos::service_level_options::workload_type::unspecified),
+                    .shares = get_shares(row),
                 };
                 service_levels.emplace(service_level_name, slo);
             } catch (...) {
@@ -849,11 +860,14 @@ future<> system_distributed_keyspace::set_service_level(sstring service_level_na
     data_value workload = slo.workload == qos::service_level_options::workload_type::unspecified
             ? data_value::make_null(utf8_type)
             : data_value(qos::service_level_options::to_string(slo.workload));
-    co_await _qp.execute_internal(format("UPDATE {}.{} SET timeout = ?, workload_type = ? WHERE service_level = ?;", NAME, SERVICE_LEVELS),
+    auto* shares_value = std::get_if<int32_t>(&slo.shares);
+    data_value shares = shares_value ? data_value(*shares_value) : data_value::make_null(int32_type);
+    co_await _qp.execute_internal(format("UPDATE {}.{} SET timeout = ?, workload_type = ?, shares = ? WHERE service_level = ?;", NAME, SERVICE_LEVELS),
                 db::consistency_level::ONE,
                 internal_distributed_query_state(),
                 {to_data_value(slo.timeout),
                     workload,
+                    shares,
                     service_level_name},
                 cql3::query_processor::cache_internal::no);
 }
@@ -171,6 +171,29 @@ schema_ptr system_keyspace::batchlog() {
     return batchlog;
 }
 
+schema_ptr system_keyspace::batchlog_v2() {
+    static thread_local auto batchlog_v2 = [] {
+        schema_builder builder(generate_legacy_id(NAME, BATCHLOG_V2), NAME, BATCHLOG_V2,
+        // partition key
+        {{"shard", int32_type}, {"segment", timestamp_type}},
+        // clustering key
+        {{"written_at", timestamp_type}, {"id", uuid_type}},
+        // regular columns
+        {{"data", bytes_type}, {"version", int32_type}},
+        // static columns
+        {},
+        // regular column name type
+        utf8_type,
+        // comment
+        "batches awaiting replay, grouped into segments by the shard and time they were written at"
+       );
+       builder.set_gc_grace_seconds(0);
+       builder.with_version(generate_schema_version(builder.uuid()));
+       return builder.build(schema_builder::compact_storage::no);
+    }();
+    return batchlog_v2;
+}
+
 /*static*/ schema_ptr system_keyspace::paxos() {
     static thread_local auto paxos = [] {
         // FIXME: switch to the new schema_builder interface (with_column(...), etc)
@@ -193,11 +216,13 @@ schema_ptr system_keyspace::batchlog() {
         utf8_type,
         // comment
         "in-progress paxos proposals"
-        // FIXME: the original Java code also had:
-        // operations on resulting CFMetaData:
-        //    .compactionStrategyClass(LeveledCompactionStrategy.class);
        );
        builder.set_gc_grace_seconds(0);
+       // Each Paxos round reads a row and overwrites it, and rows expire after
+       // paxos_grace_seconds. Leveled compaction keeps each row in few sstables,
+       // so a read after a cache miss touches few of them, and expired rows are
+       // dropped as levels are compacted.
+       builder.set_compaction_strategy(sstables::compaction_strategy_type::leveled);
        builder.with_version(generate_schema_version(builder.uuid()));
        return builder.build(schema_builder::compact_storage::no);
     }();
@@ -1874,7 +1899,7 @@ std::vector<schema_ptr> system_keyspace::all_tables(const db::config& cfg) {
     std::vector<schema_ptr> r;
     auto schema_tables = db::schema_tables::all_tables(schema_features::full());
     std::copy(schema_tables.begin(), schema_tables.end(), std::back_inserter(r));
-    r.insert(r.end(), { built_indexes(), hints(), batchlog(), paxos(), local(),
+    r.insert(r.end(), { built_indexes(), hints(), batchlog(), batchlog_v2(), paxos(), local(),
                     peers(), peer_events(), range_xfers(),
                     compactions_in_progress(), compaction_history(),
                     sstable_activity(), size_estimates(), large_partitions(), large_rows(), large_cells(),
@@ -1915,7 +1940,8 @@ std::vector<schema_ptr> system_keyspace::all_tables(const db::config& cfg) {
 }
 
 static bool maybe_write_in_user_memory(schema_ptr s) {
-    return (s.get() == system_keyspace::batchlog().get()) || (s.get() == system_keyspace::paxos().get())
+    return (s.get() == system_keyspace::batchlog().get()) || (s.get() == system_keyspace::batchlog_v2().get())
+            || (s.get() == system_keyspace::paxos().get())
             || s == system_keyspace::v3::scylla_views_builds_in_progress()
             || s == system_keyspace::raft();
 }
@@ -2428,6 +2454,17 @@ future<> system_keyspace::set_must_synchronize_topology(bool value) {
     return set_scylla_local_param_as<bool>(MUST_SYNCHRONIZE_TOPOLOGY_KEY, value, false);
 }
 
+static constexpr auto COMMITLOG_BYPASS_DIRTY_KEY = "commitlog_bypass_dirty";
+
+future<bool> system_keyspace::get_commitlog_bypass_dirty() {
+    auto opt = co_await get_scylla_local_param_as<bool>(COMMITLOG_BYPASS_DIRTY_KEY);
+    co_return opt.value_or(false);
+}
+
+future<> system_keyspace::set_commitlog_bypass_dirty(bool value) {
+    return set_scylla_local_param_as<bool>(COMMITLOG_BYPASS_DIRTY_KEY, value, false);
+}
+
 static std::set<sstring> decode_features(const set_type_impl::native_type& features) {
     std::set<sstring> fset;
     for (auto& f : features) {
@@ -133,6 +133,7 @@ class system_keyspace : public seastar::peering_sharded_service<system_keyspace>
     static constexpr auto NAME = "system";
     static constexpr auto HINTS = "hints";
     static constexpr auto BATCHLOG = "batchlog";
+    static constexpr auto BATCHLOG_V2 = "batchlog_v2";
     static constexpr auto PAXOS = "paxos";
     static constexpr auto BUILT_INDEXES = "IndexInfo";
     static constexpr auto LOCAL = "local";
@@ -231,6 +232,7 @@ class system_keyspace : public seastar::peering_sharded_service<system_keyspace>
 
     static schema_ptr hints();
     static schema_ptr batchlog();
+    static schema_ptr batchlog_v2();
     static schema_ptr paxos();
     static schema_ptr built_indexes(); // TODO (from Cassandra): make private
     static schema_ptr raft();
@@ -511,6 +513,11 @@ class system_keyspace : public seastar::peering_sharded_service<system_keyspace>
     future<bool> get_must_synchronize_topology();
     future<> set_must_synchronize_topology(bool);
 
+    // Set while the node accepts writes, cleared by drain once all memtables are flushed.
+    // If it is still set at boot, tables with commitlog_bypass may have lost writes.
+    future<bool> get_commitlog_bypass_dirty();
+    future<> set_commitlog_bypass_dirty(bool);
+
 private:
     static service::topology_features decode_topology_features_state(::shared_ptr<cql3::untyped_result_set> rs);
 
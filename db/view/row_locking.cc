@@ -6,6 +6,8 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <seastar/core/coroutine.hh>
+
 #include "row_locking.hh"
 #include "log.hh"
 
@@ -29,7 +31,6 @@ row_locker::lock_holder::lock_holder()
     : _locker(nullptr)
     , _partition(nullptr)
     , _partition_exclusive(true)
-    , _row(nullptr)
     , _row_exclusive(true) {
 }
 
@@ -37,7 +38,6 @@ row_locker::lock_holder::lock_holder(row_locker* locker, const dht::decorated_ke
     : _locker(locker)
     , _partition(pk)
     , _partition_exclusive(exclusive)
-    , _row(nullptr)
     , _row_exclusive(true) {
 }
 
@@ -45,7 +45,7 @@ row_locker::lock_holder::lock_holder(row_locker* locker, const dht::decorated_ke
     : _locker(locker)
     , _partition(pk)
     , _partition_exclusive(false)
-    , _row(cpk)
+    , _rows({cpk})
     , _row_exclusive(exclusive) {
 }
 
@@ -111,18 +111,52 @@ row_locker::lock_ck(const dht::decorated_key& pk, const clustering_key_prefix& c
     });
 }
 
+future<row_locker::lock_holder>
+row_locker::lock_cks(const dht::decorated_key& pk, std::vector<clustering_key_prefix> ckps, bool exclusive, db::timeout_clock::time_point timeout, stats& stats) {
+    mylog.debug("taking shared lock on partition {}, and {} locks on {} rows in it", pk, (exclusive ? "exclusive" : "shared"), ckps.size());
+    auto tracker = latency_stats_tracker(exclusive ? stats.exclusive_row : stats.shared_row);
+    std::ranges::sort(ckps, clustering_key_prefix::less_compare(*_schema));
+    ckps.erase(std::unique(ckps.begin(), ckps.end(), clustering_key_prefix::equality(*_schema)), ckps.end());
+
+    // See lock_ck() for why the entries are kept alive while we wait for them.
+    // Note that unlike the entries themselves, iterators to _two_level_locks
+    // don't survive a rehash, so we hold on to a pointer to the entry.
+    auto* entry = &*_two_level_locks.try_emplace(pk, this).first;
+    co_await entry->second._partition_lock.read_lock(timeout);
+    // From now on the holder releases whatever was acquired, should acquiring the next row lock fail.
+    auto holder = lock_holder(this, &entry->first, false);
+    holder._row_exclusive = exclusive;
+    holder._rows.reserve(ckps.size());
+    auto& row_locks = entry->second._row_locks;
+    for (auto& ck : ckps) {
+        auto j = row_locks.try_emplace(std::move(ck), lock_type()).first;
+        auto& row_lock = j->second;
+        try {
+            co_await (exclusive ? row_lock.write_lock(timeout) : row_lock.read_lock(timeout));
+        } catch (...) {
+            if (!row_lock.locked()) {
+                row_locks.erase(j);
+            }
+            throw;
+        }
+        holder._rows.push_back(&j->first);
+        tracker.lock_acquired();
+    }
+    co_return std::move(holder);
+}
+
 row_locker::lock_holder::lock_holder(row_locker::lock_holder&& old) noexcept
         : _locker(old._locker)
         , _partition(old._partition)
         , _partition_exclusive(old._partition_exclusive)
-        , _row(old._row)
+        , _rows(std::move(old._rows))
         , _row_exclusive(old._row_exclusive)
 {
-    // We also need to zero old's _partition and _row, so when destructed
+    // We also need to zero old's _partition and _rows, so when destructed
     // the destructor will do nothing and further moves will not create
     // duplicates.
     old._partition = nullptr;
-    old._row = nullptr;
+    old._rows.clear();
 }
 
 row_locker::lock_holder& row_locker::lock_holder::operator=(row_locker::lock_holder&& old) noexcept {
@@ -131,18 +165,18 @@ row_locker::lock_holder& row_locker::lock_holder::operator=(row_locker::lock_hol
         _locker = old._locker;
         _partition = old._partition;
         _partition_exclusive = old._partition_exclusive;
-        _row = old._row;
+        _rows = std::move(old._rows);
         _row_exclusive = old._row_exclusive;
         // As above, need to also zero other's data
         old._partition = nullptr;
-        old._row = nullptr;
+        old._rows.clear();
     }
     return *this;
 }
 
 void
 row_locker::unlock(const dht::decorated_key* pk, bool partition_exclusive,
-                    const clustering_key_prefix* cpk, bool row_exclusive) {
+                    std::span<const clustering_key_prefix* const> cpks, bool row_exclusive) {
     // Look for the partition and/or row locks given keys, release the locks,
     // and if nobody is using one of lock objects any more, delete it:
     if (pk) {
@@ -153,7 +187,7 @@ row_locker::unlock(const dht::decorated_key* pk, bool partition_exclusive,
             return;
         }
         assert(&pli->first == pk);
-        if (cpk) {
+        for (auto cpk : cpks) {
             auto rli = pli->second._row_locks.find(*cpk);
             if (rli == pli->second._row_locks.end()) {
                 mylog.error("column_family::local_base_lock_holder::~local_base_lock_holder() can't find lock for row", *cpk);
@@ -188,6 +222,6 @@ row_locker::unlock(const dht::decorated_key* pk, bool partition_exclusive,
 
 row_locker::lock_holder::~lock_holder() {
     if (_locker) {
-        _locker->unlock(_partition,  _partition_exclusive, _row, _row_exclusive);
+        _locker->unlock(_partition,  _partition_exclusive, _rows, _row_exclusive);
     }
 }
@@ -21,6 +21,8 @@
 
 #include <unordered_map>
 #include <memory>
+#include <span>
+#include <vector>
 
 #include <seastar/core/rwlock.hh>
 #include <seastar/core/future.hh>
@@ -31,6 +33,7 @@
 #include "query-request.hh"
 #include "utils/estimated_histogram.hh"
 #include "utils/latency.hh"
+#include "utils/small_vector.hh"
 
 class row_locker {
 public:
@@ -54,10 +57,10 @@ class row_locker {
 
         void lock_acquired();
     };
-    // row_locker's locking functions lock_pk(), lock_ck() return a
-    // "lock_holder" object. When the caller destroys the object it received,
-    // the lock is released. The same type "lock_holder" is used regardless
-    // of whether a row or partition was locked, for read or write.
+    // row_locker's locking functions lock_pk(), lock_ck() and lock_cks()
+    // return a "lock_holder" object. When the caller destroys the object it
+    // received, the locks are released. The same type "lock_holder" is used
+    // regardless of whether rows or a partition were locked, for read or write.
     class lock_holder {
         row_locker* _locker;
         // The lock holder pointers to the partition and clustering keys,
@@ -66,8 +69,9 @@ class row_locker {
         // this partition or row are released).
         const dht::decorated_key* _partition;
         bool _partition_exclusive;
-        const clustering_key_prefix* _row;
+        utils::small_vector<const clustering_key_prefix*, 1> _rows;
         bool _row_exclusive;
+        friend class row_locker;
     public:
         lock_holder();
         lock_holder(row_locker* locker, const dht::decorated_key* pk, bool exclusive);
@@ -108,7 +112,7 @@ class row_locker {
         }
     };
     std::unordered_map<dht::decorated_key, two_level_lock, decorated_key_hash, decorated_key_equals_comparator> _two_level_locks;
-    void unlock(const dht::decorated_key* pk, bool partition_exclusive, const clustering_key_prefix* cpk, bool row_exclusive);
+    void unlock(const dht::decorated_key* pk, bool partition_exclusive, std::span<const clustering_key_prefix* const> cpks, bool row_exclusive);
 public:
     // row_locker needs to know the column_family's schema because key
     // comparisons needs the schema.
@@ -134,5 +138,13 @@ class row_locker {
     // schema, call upgrade() before taking the lock.
     future<lock_holder> lock_ck(const dht::decorated_key& pk, const clustering_key_prefix& ckp, bool exclusive, db::timeout_clock::time_point timeout, stats& stats);
 
+    // Lock several clustering rows of the same partition with shared or
+    // exclusive locks, under a single shared lock on the partition, so that
+    // writers of disjoint rows in the partition don't wait for each other.
+    // The row locks are taken in clustering order, so concurrent callers
+    // locking overlapping sets of rows cannot deadlock. The same assumption
+    // about the schema as for lock_ck() applies.
+    future<lock_holder> lock_cks(const dht::decorated_key& pk, std::vector<clustering_key_prefix> ckps, bool exclusive, db::timeout_clock::time_point timeout, stats& stats);
+
     bool empty() const { return _two_level_locks.empty(); }
 };
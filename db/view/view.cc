@@ -1632,10 +1632,25 @@ future<> view_update_generator::mutate_MV(
         db::timeout_semaphore_units pending_view_updates,
         service::allow_hints allow_hints,
         wait_for_all_updates wait_for_all)
+{
+    return do_mutate_MV(base_token, std::move(view_updates), stats, cf_stats, std::move(tr_state),
+            std::move(pending_view_updates), allow_hints, wait_for_all, coalesce_view_updates::yes);
+}
+
+future<> view_update_generator::do_mutate_MV(
+        dht::token base_token,
+        utils::chunked_vector<frozen_mutation_and_schema> view_updates,
+        db::view::stats& stats,
+        replica::cf_stats& cf_stats,
+        tracing::trace_state_ptr tr_state,
+        db::timeout_semaphore_units pending_view_updates,
+        service::allow_hints allow_hints,
+        wait_for_all_updates wait_for_all,
+        coalesce_view_updates coalesce)
 {
     static constexpr size_t max_concurrent_updates = 128;
     co_await max_concurrent_for_each(view_updates, max_concurrent_updates,
-            [this, base_token, &stats, &cf_stats, tr_state, &pending_view_updates, allow_hints, wait_for_all] (frozen_mutation_and_schema mut) mutable -> future<> {
+            [this, base_token, &stats, &cf_stats, tr_state, &pending_view_updates, allow_hints, wait_for_all, coalesce] (frozen_mutation_and_schema mut) mutable -> future<> {
         auto view_token = dht::get_token(*mut.s, mut.fm.key());
         auto& keyspace_name = mut.s->ks_name();
         auto& ks = _proxy.local().local_db().find_keyspace(keyspace_name);
@@ -1654,6 +1669,13 @@ future<> view_update_generator::mutate_MV(
         // If a view is marked with the synchronous_updates property, we should wait for all.
         const bool apply_update_synchronously = wait_for_all || update_synchronously;
 
+        // Asynchronous updates may be held for a short while, to be merged with
+        // later updates to the same view partition, see coalesce_view_update().
+        if (coalesce && !apply_update_synchronously && allow_hints && target_endpoint
+                && coalesce_view_update(mut, *target_endpoint, base_token, stats, cf_stats, tr_state, sem_units)) {
+            return make_ready_future<>();
+        }
+
         // First, find the local endpoint and ensure that if it exists,
         // it will be the target endpoint. That way, all endpoints in the
         // remote_endpoints list are guaranteed to be remote.
@@ -2259,6 +2281,23 @@ future<> view_builder::do_build_step() {
     });
 }
 
+// Batches of base rows flushed by view_builder::consumer, whose view updates
+// are still being propagated. A build step waits for all of them before its
+// progress is recorded.
+struct view_builder::in_flight_flushes {
+    seastar::semaphore sem{max_concurrent_flushes};
+    seastar::gate gate;
+    std::exception_ptr ex;
+
+    // Must be called in a seastar thread.
+    void wait() {
+        gate.close().get();
+        if (ex) {
+            std::rethrow_exception(std::exchange(ex, nullptr));
+        }
+    }
+};
+
 // Called in the context of a seastar::thread.
 class view_builder::consumer {
 public:
@@ -2291,6 +2330,7 @@ class view_builder::consumer {
     view_builder& _builder;
     shared_ptr<view_update_generator> _gen;
     build_step& _step;
+    in_flight_flushes& _in_flight;
     built_views _built_views;
     gc_clock::time_point _now;
     std::vector<view_ptr> _views_to_build;
@@ -2306,10 +2346,11 @@ class view_builder::consumer {
     // beyond our limit on mutation size (by default 32 MB).
     size_t _fragments_memory_usage = 0;
 public:
-    consumer(view_builder& builder, shared_ptr<view_update_generator> gen, build_step& step, gc_clock::time_point now)
+    consumer(view_builder& builder, shared_ptr<view_update_generator> gen, build_step& step, in_flight_flushes& in_flight, gc_clock::time_point now)
             : _builder(builder)
             , _gen(std::move(gen))
             , _step(step)
+            , _in_flight(in_flight)
             , _built_views{step}
             , _now(now) {
         if (!step.current_key.key().is_empty(*_step.reader.schema())) {
@@ -2414,13 +2455,23 @@ class view_builder::consumer {
             auto reader = make_flat_mutation_reader_from_fragments(_step.reader.schema(), _builder._permit, std::move(_fragments));
             auto close_reader = defer([&reader] { reader.close().get(); });
             reader.upgrade_schema(base_schema);
-            _step.base->populate_views(
-                    _gen,
-                    std::move(views),
-                    _step.current_token(),
-                    std::move(reader),
-                    _now).get();
+            // Propagating the view updates waits for the view replicas. Let it
+            // proceed in the background, so that the next base rows are read
+            // meanwhile, and fail the step on the first error.
+            auto units = get_units(_in_flight.sem, 1).get0();
+            if (_in_flight.ex) {
+                std::rethrow_exception(std::exchange(_in_flight.ex, nullptr));
+            }
             close_reader.cancel();
+            (void)with_gate(_in_flight.gate, [&in_flight = _in_flight, base = _step.base, gen = _gen, views = std::move(views),
+                    token = _step.current_token(), reader = std::move(reader), now = _now, units = std::move(units)] () mutable {
+                return base->populate_views(std::move(gen), std::move(views), token, std::move(reader), now).handle_exception(
+                        [&in_flight, units = std::move(units)] (std::exception_ptr ep) {
+                    if (!in_flight.ex) {
+                        in_flight.ex = std::move(ep);
+                    }
+                });
+            });
             _fragments.clear();
             _fragments_memory_usage = 0;
         }
@@ -2435,6 +2486,7 @@ class view_builder::consumer {
     // Must be called in a seastar thread.
     built_views consume_end_of_stream() {
         inject_failure("view_builder_consume_end_of_stream");
+        _in_flight.wait();
         if (vlogger.is_enabled(log_level::debug)) {
             auto view_names = boost::copy_range<std::vector<sstring>>(
                     _views_to_build | boost::adaptors::transformed([](auto v) {
@@ -2464,7 +2516,14 @@ void view_builder::execute(build_step& step, exponential_backoff_retry r) {
             step.pslice,
             batch_size,
             query::max_partitions);
-    auto consumer = compact_for_query_v2<view_builder::consumer>(compaction_state, view_builder::consumer{*this, _vug.shared_from_this(), step, now});
+    in_flight_flushes in_flight;
+    // On failure, the batches still in flight must finish before the step is retried.
+    auto wait_in_flight = defer([&in_flight] {
+        if (!in_flight.gate.is_closed()) {
+            in_flight.gate.close().get();
+        }
+    });
+    auto consumer = compact_for_query_v2<view_builder::consumer>(compaction_state, view_builder::consumer{*this, _vug.shared_from_this(), step, in_flight, now});
     auto built = step.reader.consume_in_thread(std::move(consumer));
     if (auto ds = std::move(*compaction_state).detach_state()) {
         if (ds->current_tombstone) {
@@ -188,6 +188,9 @@ class view_builder final : public service::migration_listener::only_view_notific
     // collected batch_memory_max bytes, we can process the rows read so far.
     static constexpr size_t batch_size = 128;
     static constexpr size_t batch_memory_max = 1024*1024;
+    // The view updates of up to max_concurrent_flushes batches of base rows are
+    // propagated to the view replicas while the next base rows are read.
+    static constexpr size_t max_concurrent_flushes = 16;
 
     replica::database& get_db() noexcept { return _db; }
 
@@ -235,6 +238,7 @@ class view_builder final : public service::migration_listener::only_view_notific
     void setup_metrics();
 
     struct consumer;
+    struct in_flight_flushes;
 };
 
 }
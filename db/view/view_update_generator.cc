@@ -17,6 +17,12 @@
 #include "readers/evictable.hh"
 #include "dht/partition_filter.hh"
 #include "utils/pretty_printers.hh"
+#include "utils/hash.hh"
+#include "mutation/frozen_mutation.hh"
+#include "mutation/mutation.hh"
+#include "db/config.hh"
+#include "gms/inet_address.hh"
+#include "tracing/trace_state.hh"
 
 static logging::logger vug_logger("view_update_generator");
 
@@ -90,12 +96,56 @@ class view_update_generator::progress_tracker final : public sstables::read_moni
     }
 };
 
+// Asynchronous view updates waiting to be sent, see view_update_coalescing_window_in_us.
+// Updates are merged when they modify the same view partition, with the same view
+// schema version, and are paired with the same view replica.
+class view_update_generator::coalescing_buffer {
+public:
+    struct pending_update {
+        schema_ptr s;
+        mutation m;
+        dht::token base_token;
+        db::view::stats& stats;
+        replica::cf_stats& cf_stats;
+        tracing::trace_state_ptr tr_state;
+        db::timeout_semaphore_units units;
+        size_t size;
+    };
+    using key = std::tuple<table_schema_version, gms::inet_address, managed_bytes>;
+
+    // Bound the memory held by the buffer, on top of the units it keeps.
+    static constexpr size_t max_pending_updates = 1024;
+    static constexpr size_t max_update_size = 128 * 1024;
+
+    std::unordered_map<key, pending_update, utils::tuple_hash> updates;
+    timer<> flush_timer;
+    seastar::gate gate;
+    uint64_t coalesced_updates = 0;
+
+    void send(view_update_generator& gen, pending_update u) noexcept {
+        auto s = u.s;
+        try {
+            utils::chunked_vector<frozen_mutation_and_schema> muts;
+            muts.emplace_back(frozen_mutation_and_schema{freeze(u.m), u.s});
+            // Failures are logged and accounted by do_mutate_MV().
+            (void)with_gate(gate, [&gen, u = std::move(u), muts = std::move(muts)] () mutable {
+                return gen.do_mutate_MV(u.base_token, std::move(muts), u.stats, u.cf_stats, std::move(u.tr_state),
+                        std::move(u.units), service::allow_hints::yes, wait_for_all_updates::no, coalesce_view_updates::no);
+            }).handle_exception([] (std::exception_ptr) {});
+        } catch (...) {
+            vug_logger.warn("Failed to send coalesced view update to {}.{}: {}", s->ks_name(), s->cf_name(), std::current_exception());
+        }
+    }
+};
+
 view_update_generator::view_update_generator(replica::database& db, sharded<service::storage_proxy>& proxy, abort_source& as)
         : _db(db)
         , _proxy(proxy)
         , _progress_tracker(std::make_unique<progress_tracker>())
+        , _coalescing_buffer(std::make_unique<coalescing_buffer>())
         , _early_abort_subscription(as.subscribe([this] () noexcept { do_abort(); }))
 {
+    _coalescing_buffer->flush_timer.set_callback([this] { flush_coalesced_view_updates(); });
     setup_metrics();
     discover_staging_sstables();
     _db.plug_view_update_generator(*this);
@@ -241,11 +291,66 @@ void view_update_generator::do_abort() noexcept {
 
 future<> view_update_generator::stop() {
     do_abort();
-    return std::move(_started).then([this] {
+    flush_coalesced_view_updates();
+    return _coalescing_buffer->gate.close().then([this] {
+        return std::move(_started);
+    }).then([this] {
         _registration_sem.broken();
     });
 }
 
+bool view_update_generator::coalesce_view_update(frozen_mutation_and_schema& mut, gms::inet_address target, dht::token base_token,
+        db::view::stats& stats, replica::cf_stats& cf_stats, tracing::trace_state_ptr tr_state,
+        db::timeout_semaphore_units& units) {
+    auto window = std::chrono::microseconds(_db.get_config().view_update_coalescing_window_in_us());
+    auto& b = *_coalescing_buffer;
+    if (!window.count() || b.gate.is_closed()) {
+        return false;
+    }
+    auto k = coalescing_buffer::key(mut.s->version(), target, managed_bytes(mut.fm.key().representation()));
+    auto it = b.updates.find(k);
+    if (it == b.updates.end()) {
+        if (b.updates.size() >= coalescing_buffer::max_pending_updates) {
+            return false;
+        }
+        auto m = mut.fm.unfreeze(mut.s);
+        auto size = mut.fm.representation().size();
+        it = b.updates.emplace(std::move(k), coalescing_buffer::pending_update{
+                mut.s, std::move(m), base_token, stats, cf_stats, std::move(tr_state), std::move(units), size}).first;
+        if (!b.flush_timer.armed()) {
+            b.flush_timer.arm(window);
+        }
+    } else {
+        auto& u = it->second;
+        u.m.apply(mut.fm.unfreeze(mut.s));
+        u.units.adopt(std::move(units));
+        u.size += mut.fm.representation().size();
+        ++b.coalesced_updates;
+    }
+    if (it->second.size >= coalescing_buffer::max_update_size) {
+        auto u = std::move(b.updates.extract(it).mapped());
+        b.send(*this, std::move(u));
+    }
+    return true;
+}
+
+void view_update_generator::flush_coalesced_view_updates() noexcept {
+    auto& b = *_coalescing_buffer;
+    b.flush_timer.cancel();
+    auto updates = std::exchange(b.updates, {});
+    for (auto& [k, u] : updates) {
+        b.send(*this, std::move(u));
+    }
+}
+
+size_t view_update_generator::coalescing_view_updates() const noexcept {
+    return _coalescing_buffer->updates.size();
+}
+
+uint64_t view_update_generator::coalesced_view_updates() const noexcept {
+    return _coalescing_buffer->coalesced_updates;
+}
+
 bool view_update_generator::should_throttle() const {
     return !_started.available();
 }
@@ -284,7 +389,15 @@ void view_update_generator::setup_metrics() {
 
         sm::make_gauge("sstables_pending_work",
                 sm::description("Number of bytes remaining to be processed from SSTables for view updates"),
-                [this] { return _progress_tracker ? _progress_tracker->sstables_pending_work() : 0; })
+                [this] { return _progress_tracker ? _progress_tracker->sstables_pending_work() : 0; }),
+
+        sm::make_gauge("coalescing_view_updates",
+                sm::description("Number of view partition updates held to be merged with later updates, see view_update_coalescing_window_in_us"),
+                [this] { return coalescing_view_updates(); }),
+
+        sm::make_counter("coalesced_view_updates",
+                sm::description("Number of view updates merged into an update to the same view partition held before them"),
+                [this] { return coalesced_view_updates(); })
     });
 }
 
@@ -17,6 +17,7 @@
 #include <seastar/core/abort_source.hh>
 #include <seastar/core/condition-variable.hh>
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/gate.hh>
 
 using namespace seastar;
 
@@ -26,6 +27,10 @@ namespace dht {
 class token;
 }
 
+namespace gms {
+class inet_address;
+}
+
 namespace tracing {
 class trace_state_ptr;
 }
@@ -64,6 +69,8 @@ class view_update_generator : public async_sharded_service<view_update_generator
     metrics::metric_groups _metrics;
     class progress_tracker;
     std::unique_ptr<progress_tracker> _progress_tracker;
+    class coalescing_buffer;
+    std::unique_ptr<coalescing_buffer> _coalescing_buffer;
     optimized_optional<abort_source::subscription> _early_abort_subscription;
     void do_abort() noexcept;
 public:
@@ -88,7 +95,29 @@ class view_update_generator : public async_sharded_service<view_update_generator
 
     ssize_t available_register_units() const { return _registration_sem.available_units(); }
     size_t queued_batches_count() const { return _sstables_with_tables.size(); }
+    // View partition updates held to be merged with later ones, and updates merged into them so far.
+    size_t coalescing_view_updates() const noexcept;
+    uint64_t coalesced_view_updates() const noexcept;
 private:
+    using coalesce_view_updates = bool_class<class coalesce_view_updates_tag>;
+    future<> do_mutate_MV(
+            dht::token base_token,
+            utils::chunked_vector<frozen_mutation_and_schema> view_updates,
+            db::view::stats& stats,
+            replica::cf_stats& cf_stats,
+            tracing::trace_state_ptr tr_state,
+            db::timeout_semaphore_units pending_view_updates,
+            service::allow_hints allow_hints,
+            wait_for_all_updates wait_for_all,
+            coalesce_view_updates coalesce);
+    // Holds an asynchronous view update for view_update_coalescing_window_in_us,
+    // merging it with the other updates to the same view partition and paired
+    // view replica. Returns false, leaving mut and units untouched, if the update
+    // should be sent right away.
+    bool coalesce_view_update(frozen_mutation_and_schema& mut, gms::inet_address target, dht::token base_token,
+            db::view::stats& stats, replica::cf_stats& cf_stats, tracing::trace_state_ptr tr_state,
+            db::timeout_semaphore_units& units);
+    void flush_coalesced_view_updates() noexcept;
     bool should_throttle() const;
     void setup_metrics();
     void discover_staging_sstables();
@@ -14,6 +14,7 @@
 #include <seastar/core/reactor.hh>
 
 #include "db/config.hh"
+#include "db/large_data_handler.hh"
 #include "db/system_keyspace.hh"
 #include "db/virtual_table.hh"
 #include "db/virtual_tables.hh"
@@ -28,6 +29,7 @@
 #include "schema/schema_registry.hh"
 #include "service/raft/raft_group_registry.hh"
 #include "service/storage_service.hh"
+#include "sstables/sstables.hh"
 #include "types/list.hh"
 #include "types/types.hh"
 #include "utils/build_id.hh"
@@ -306,6 +308,531 @@ class snapshots_table : public streaming_virtual_table {
     }
 };
 
+class heavy_hitters_table : public streaming_virtual_table {
+    distributed<replica::database>& _db;
+public:
+    explicit heavy_hitters_table(distributed<replica::database>& db)
+            : streaming_virtual_table(build_schema())
+            , _db(db)
+    {
+        _shard_aware = true;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "heavy_hitters");
+        return schema_builder(system_keyspace::NAME, "heavy_hitters", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::clustering_key)
+            .with_column("operation", utf8_type, column_kind::clustering_key)
+            .with_column("token", long_type, column_kind::clustering_key)
+            .with_column("operations", long_type)
+            .with_column("bytes", long_type)
+            .set_comment("Lists the partitions with the most reads and writes in the last ten to twenty seconds, by token.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    dht::decorated_key make_partition_key(const sstring& name) {
+        return dht::decorate_key(*_s, partition_key::from_single_value(*_s, data_value(name).serialize_nonnull()));
+    }
+
+    clustering_key make_clustering_key(sstring table_name, sstring operation, int64_t token) {
+        return clustering_key::from_exploded(*_s, {
+            data_value(std::move(table_name)).serialize_nonnull(),
+            data_value(std::move(operation)).serialize_nonnull(),
+            data_value(token).serialize_nonnull()
+        });
+    }
+
+    future<> execute(reader_permit permit, result_collector& result, const query_restrictions& qr) override {
+        struct decorated_keyspace_name {
+            sstring name;
+            dht::decorated_key key;
+        };
+        std::vector<decorated_keyspace_name> keyspace_names;
+
+        for (const auto& [name, _] : _db.local().get_keyspaces()) {
+            auto dk = make_partition_key(name);
+            if (!this_shard_owns(dk) || !contains_key(qr.partition_range(), dk)) {
+                continue;
+            }
+            keyspace_names.push_back({std::move(name), std::move(dk)});
+        }
+
+        boost::sort(keyspace_names, [less = dht::ring_position_less_comparator(*_s)]
+                (const decorated_keyspace_name& l, const decorated_keyspace_name& r) {
+            return less(l.key, r.key);
+        });
+
+        // table name -> operation -> token -> (operations, bytes), in clustering order
+        using heavy_hitters_map = std::map<sstring, std::map<sstring, std::map<int64_t, std::pair<uint64_t, uint64_t>>>>;
+
+        for (auto& ks_data : keyspace_names) {
+            co_await result.emit_partition_start(ks_data.key);
+
+            const auto heavy_hitters = co_await _db.map_reduce0([ks_name = ks_data.name] (replica::database& local_db) {
+                heavy_hitters_map ret;
+                local_db.get_tables_metadata().for_each_table([&] (table_id, lw_shared_ptr<replica::table> table) {
+                    if (table->schema()->ks_name() != ks_name) {
+                        return;
+                    }
+                    for (auto op_type : {db::operation_type::read, db::operation_type::write}) {
+                        auto partitions = table->get_heavy_hitters_for_op_type(op_type).top(partition_heavy_hitters::capacity);
+                        if (partitions.empty()) {
+                            continue;
+                        }
+                        auto& by_token = ret[table->schema()->cf_name()][op_type == db::operation_type::write ? "write" : "read"];
+                        for (auto& p : partitions) {
+                            by_token.emplace(p.token, std::pair(p.operations, p.bytes));
+                        }
+                    }
+                });
+                return ret;
+            }, heavy_hitters_map(), [] (heavy_hitters_map a, const heavy_hitters_map& b) {
+                for (auto& [table_name, by_operation] : b) {
+                    for (auto& [operation, by_token] : by_operation) {
+                        auto& tokens = a[table_name][operation];
+                        for (auto& [token, counts] : by_token) {
+                            auto& c = tokens[token];
+                            c.first += counts.first;
+                            c.second += counts.second;
+                        }
+                    }
+                }
+                return a;
+            });
+
+            for (const auto& [table_name, by_operation] : heavy_hitters) {
+                for (const auto& [operation, by_token] : by_operation) {
+                    for (const auto& [token, counts] : by_token) {
+                        clustering_row cr(make_clustering_key(table_name, operation, token));
+                        set_cell(cr.cells(), "operations", int64_t(counts.first));
+                        set_cell(cr.cells(), "bytes", int64_t(counts.second));
+                        co_await result.emit_row(std::move(cr));
+                    }
+                }
+            }
+
+            co_await result.emit_partition_end();
+        }
+    }
+};
+
+class top_large_partitions_table : public streaming_virtual_table {
+    distributed<replica::database>& _db;
+public:
+    explicit top_large_partitions_table(distributed<replica::database>& db)
+            : streaming_virtual_table(build_schema())
+            , _db(db)
+    {
+        _shard_aware = true;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "top_large_partitions");
+        return schema_builder(system_keyspace::NAME, "top_large_partitions", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::clustering_key)
+            .with_column("rank", int32_type, column_kind::clustering_key)
+            .with_column("partition_key", utf8_type)
+            .with_column("partition_size", long_type)
+            .with_column("rows", long_type)
+            .with_column("sstable_name", utf8_type)
+            .set_comment("Lists the largest partitions above the large partition threshold in the live sstables, by table.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    dht::decorated_key make_partition_key(const sstring& name) {
+        return dht::decorate_key(*_s, partition_key::from_single_value(*_s, data_value(name).serialize_nonnull()));
+    }
+
+    clustering_key make_clustering_key(sstring table_name, int32_t rank) {
+        return clustering_key::from_exploded(*_s, {
+            data_value(std::move(table_name)).serialize_nonnull(),
+            data_value(rank).serialize_nonnull()
+        });
+    }
+
+    future<> execute(reader_permit permit, result_collector& result, const query_restrictions& qr) override {
+        struct decorated_keyspace_name {
+            sstring name;
+            dht::decorated_key key;
+        };
+        std::vector<decorated_keyspace_name> keyspace_names;
+
+        for (const auto& [name, _] : _db.local().get_keyspaces()) {
+            auto dk = make_partition_key(name);
+            if (!this_shard_owns(dk) || !contains_key(qr.partition_range(), dk)) {
+                continue;
+            }
+            keyspace_names.push_back({std::move(name), std::move(dk)});
+        }
+
+        boost::sort(keyspace_names, [less = dht::ring_position_less_comparator(*_s)]
+                (const decorated_keyspace_name& l, const decorated_keyspace_name& r) {
+            return less(l.key, r.key);
+        });
+
+        using entry = large_data_handler::large_partition_entry;
+        // table name -> the largest partitions of all shards
+        using top_partitions_map = std::map<sstring, std::vector<entry>>;
+
+        for (auto& ks_data : keyspace_names) {
+            co_await result.emit_partition_start(ks_data.key);
+
+            auto top_partitions = co_await _db.map_reduce0([ks_name = ks_data.name] (replica::database& local_db) {
+                top_partitions_map ret;
+                for (const auto& [id, partitions] : local_db.get_large_data_handler().top_partitions()) {
+                    auto table = local_db.get_tables_metadata().get_table_if_exists(id);
+                    if (!table || table->schema()->ks_name() != ks_name) {
+                        continue;
+                    }
+                    ret.emplace(table->schema()->cf_name(), partitions);
+                }
+                return ret;
+            }, top_partitions_map(), [] (top_partitions_map a, const top_partitions_map& b) {
+                for (const auto& [table_name, partitions] : b) {
+                    auto& top = a[table_name];
+                    top.insert(top.end(), partitions.begin(), partitions.end());
+                }
+                return a;
+            });
+
+            for (auto& [table_name, partitions] : top_partitions) {
+                std::ranges::stable_sort(partitions, std::greater<uint64_t>(), &entry::size);
+                partitions.resize(std::min(partitions.size(), large_data_handler::top_partitions_per_table));
+                int32_t rank = 0;
+                for (const auto& p : partitions) {
+                    clustering_row cr(make_clustering_key(table_name, ++rank));
+                    set_cell(cr.cells(), "partition_key", p.partition_key);
+                    set_cell(cr.cells(), "partition_size", int64_t(p.size));
+                    set_cell(cr.cells(), "rows", int64_t(p.rows));
+                    set_cell(cr.cells(), "sstable_name", p.sstable_name);
+                    co_await result.emit_row(std::move(cr));
+                }
+            }
+
+            co_await result.emit_partition_end();
+        }
+    }
+};
+
+// Base for the tables with one partition per shard, see shard_partition_key().
+class per_shard_virtual_table : public streaming_virtual_table {
+protected:
+    distributed<replica::database>& _db;
+
+    explicit per_shard_virtual_table(schema_ptr s, distributed<replica::database>& db)
+            : streaming_virtual_table(std::move(s))
+            , _db(db)
+    {
+        _shard_aware = true;
+    }
+
+    dht::decorated_key make_partition_key(int32_t shard) {
+        return dht::decorate_key(*_s, partition_key::from_single_value(*_s, data_value(shard).serialize_nonnull()));
+    }
+
+    struct decorated_shard {
+        unsigned shard;
+        dht::decorated_key key;
+    };
+
+    // The shards whose partition is owned by this shard and is selected by the query, in ring order.
+    std::vector<decorated_shard> selected_shards(const query_restrictions& qr) {
+        std::vector<decorated_shard> shards;
+        for (unsigned shard = 0; shard < smp::count; ++shard) {
+            auto dk = make_partition_key(shard);
+            if (!this_shard_owns(dk) || !contains_key(qr.partition_range(), dk)) {
+                continue;
+            }
+            shards.push_back({shard, std::move(dk)});
+        }
+        boost::sort(shards, [less = dht::ring_position_less_comparator(*_s)] (const decorated_shard& l, const decorated_shard& r) {
+            return less(l.key, r.key);
+        });
+        return shards;
+    }
+};
+
+class reader_semaphores_table : public per_shard_virtual_table {
+public:
+    explicit reader_semaphores_table(distributed<replica::database>& db)
+            : per_shard_virtual_table(build_schema(), db)
+    { }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "reader_semaphores");
+        return schema_builder(system_keyspace::NAME, "reader_semaphores", std::make_optional(id))
+            .with_column("shard", int32_type, column_kind::partition_key)
+            .with_column("semaphore", utf8_type, column_kind::clustering_key)
+            .with_column("active_reads", long_type)
+            .with_column("waiting_reads", long_type)
+            .with_column("inactive_reads", long_type)
+            .with_column("used_count", long_type)
+            .with_column("total_count", long_type)
+            .with_column("used_memory", long_type)
+            .with_column("total_memory", long_type)
+            .set_comment("Lists the current state of the reader concurrency semaphores of each shard.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    clustering_key make_clustering_key(sstring semaphore) {
+        return clustering_key::from_single_value(*_s, data_value(std::move(semaphore)).serialize_nonnull());
+    }
+
+    future<> execute(reader_permit permit, result_collector& result, const query_restrictions& qr) override {
+        struct semaphore_state {
+            uint64_t active_reads;
+            uint64_t waiting_reads;
+            uint64_t inactive_reads;
+            reader_resources used;
+            reader_resources total;
+        };
+
+        for (auto& shard_data : selected_shards(qr)) {
+            co_await result.emit_partition_start(shard_data.key);
+
+            auto semaphores = co_await _db.invoke_on(shard_data.shard, [] (replica::database& local_db) {
+                std::map<sstring, semaphore_state> ret;
+                local_db.foreach_reader_concurrency_semaphore([&] (std::string_view name, const reader_concurrency_semaphore& sem) {
+                    const auto& stats = sem.get_stats();
+                    ret.emplace(sstring(name), semaphore_state{
+                        .active_reads = sem.active_reads(),
+                        .waiting_reads = stats.waiters,
+                        .inactive_reads = stats.inactive_reads,
+                        .used = sem.consumed_resources(),
+                        .total = sem.initial_resources(),
+                    });
+                });
+                return ret;
+            });
+
+            for (const auto& [name, s] : semaphores) {
+                clustering_row cr(make_clustering_key(name));
+                set_cell(cr.cells(), "active_reads", int64_t(s.active_reads));
+                set_cell(cr.cells(), "waiting_reads", int64_t(s.waiting_reads));
+                set_cell(cr.cells(), "inactive_reads", int64_t(s.inactive_reads));
+                set_cell(cr.cells(), "used_count", int64_t(s.used.count));
+                set_cell(cr.cells(), "total_count", int64_t(s.total.count));
+                set_cell(cr.cells(), "used_memory", int64_t(s.used.memory));
+                set_cell(cr.cells(), "total_memory", int64_t(s.total.memory));
+                co_await result.emit_row(std::move(cr));
+            }
+
+            co_await result.emit_partition_end();
+        }
+    }
+};
+
+class reader_permits_table : public per_shard_virtual_table {
+public:
+    explicit reader_permits_table(distributed<replica::database>& db)
+            : per_shard_virtual_table(build_schema(), db)
+    { }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "reader_permits");
+        return schema_builder(system_keyspace::NAME, "reader_permits", std::make_optional(id))
+            .with_column("shard", int32_type, column_kind::partition_key)
+            .with_column("semaphore", utf8_type, column_kind::clustering_key)
+            .with_column("permit", int32_type, column_kind::clustering_key)
+            .with_column("keyspace_name", utf8_type)
+            .with_column("table_name", utf8_type)
+            .with_column("operation", utf8_type)
+            .with_column("state", utf8_type)
+            .with_column("age_ms", long_type)
+            .with_column("used_count", long_type)
+            .with_column("used_memory", long_type)
+            .set_comment("Lists the reader permits currently alive on each shard, with the read they belong to.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    clustering_key make_clustering_key(sstring semaphore, int32_t permit) {
+        return clustering_key::from_exploded(*_s, {
+            data_value(std::move(semaphore)).serialize_nonnull(),
+            data_value(permit).serialize_nonnull()
+        });
+    }
+
+    future<> execute(reader_permit permit, result_collector& result, const query_restrictions& qr) override {
+        struct permit_state {
+            sstring keyspace_name;
+            sstring table_name;
+            sstring operation;
+            sstring state;
+            int64_t age_ms;
+            reader_resources resources;
+        };
+        // semaphore name -> permits, in the order the semaphore lists them
+        using permits_map = std::map<sstring, std::vector<permit_state>>;
+
+        for (auto& shard_data : selected_shards(qr)) {
+            co_await result.emit_partition_start(shard_data.key);
+
+            auto permits = co_await _db.invoke_on(shard_data.shard, [] (replica::database& local_db) {
+                const auto now = std::chrono::steady_clock::now();
+                permits_map ret;
+                local_db.foreach_reader_concurrency_semaphore([&] (std::string_view name, const reader_concurrency_semaphore& sem) {
+                    auto& semaphore_permits = ret[sstring(name)];
+                    sem.foreach_permit([&] (const reader_permit& p) {
+                        const auto* s = p.get_schema();
+                        semaphore_permits.push_back(permit_state{
+                            .keyspace_name = s ? s->ks_name() : sstring(),
+                            .table_name = s ? s->cf_name() : sstring(),
+                            .operation = sstring(p.get_op_name()),
+                            .state = fmt::format("{}", p.get_state()),
+                            .age_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - p.created_at()).count(),
+                            .resources = p.consumed_resources(),
+                        });
+                    });
+                });
+                return ret;
+            });
+
+            for (const auto& [semaphore, semaphore_permits] : permits) {
+                int32_t i = 0;
+                for (const auto& p : semaphore_permits) {
+                    clustering_row cr(make_clustering_key(semaphore, i++));
+                    if (!p.keyspace_name.empty()) {
+                        set_cell(cr.cells(), "keyspace_name", p.keyspace_name);
+                        set_cell(cr.cells(), "table_name", p.table_name);
+                    }
+                    set_cell(cr.cells(), "operation", p.operation);
+                    set_cell(cr.cells(), "state", p.state);
+                    set_cell(cr.cells(), "age_ms", p.age_ms);
+                    set_cell(cr.cells(), "used_count", int64_t(p.resources.count));
+                    set_cell(cr.cells(), "used_memory", int64_t(p.resources.memory));
+                    co_await result.emit_row(std::move(cr));
+                }
+            }
+
+            co_await result.emit_partition_end();
+        }
+    }
+};
+
+class table_cache_state_table : public streaming_virtual_table {
+    distributed<replica::database>& _db;
+public:
+    explicit table_cache_state_table(distributed<replica::database>& db)
+            : streaming_virtual_table(build_schema())
+            , _db(db)
+    {
+        _shard_aware = true;
+    }
+
+    static schema_ptr build_schema() {
+        auto id = generate_legacy_id(system_keyspace::NAME, "table_cache_state");
+        return schema_builder(system_keyspace::NAME, "table_cache_state", std::make_optional(id))
+            .with_column("keyspace_name", utf8_type, column_kind::partition_key)
+            .with_column("table_name", utf8_type, column_kind::clustering_key)
+            .with_column("shard", int32_type, column_kind::clustering_key)
+            .with_column("cache_hits", long_type)
+            .with_column("cache_misses", long_type)
+            .with_column("cache_hit_rate", double_type)
+            .with_column("index_file_cached_bytes", long_type)
+            .with_column("partition_index_cached_bytes", long_type)
+            .set_comment("Lists the row cache hits and the memory used by the cached sstable indexes, by table and shard.")
+            .with_version(system_keyspace::generate_schema_version(id))
+            .build();
+    }
+
+    dht::decorated_key make_partition_key(const sstring& name) {
+        return dht::decorate_key(*_s, partition_key::from_single_value(*_s, data_value(name).serialize_nonnull()));
+    }
+
+    clustering_key make_clustering_key(sstring table_name, int32_t shard) {
+        return clustering_key::from_exploded(*_s, {
+            data_value(std::move(table_name)).serialize_nonnull(),
+            data_value(shard).serialize_nonnull()
+        });
+    }
+
+    future<> execute(reader_permit permit, result_collector& result, const query_restrictions& qr) override {
+        struct decorated_keyspace_name {
+            sstring name;
+            dht::decorated_key key;
+        };
+        std::vector<decorated_keyspace_name> keyspace_names;
+
+        for (const auto& [name, _] : _db.local().get_keyspaces()) {
+            auto dk = make_partition_key(name);
+            if (!this_shard_owns(dk) || !contains_key(qr.partition_range(), dk)) {
+                continue;
+            }
+            keyspace_names.push_back({std::move(name), std::move(dk)});
+        }
+
+        boost::sort(keyspace_names, [less = dht::ring_position_less_comparator(*_s)]
+                (const decorated_keyspace_name& l, const decorated_keyspace_name& r) {
+            return less(l.key, r.key);
+        });
+
+        struct cache_state {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            double hit_rate = 0;
+            size_t index_file_bytes = 0;
+            size_t partition_index_bytes = 0;
+        };
+        // table name -> shard -> state, in clustering order
+        using cache_state_map = std::map<sstring, std::map<int32_t, cache_state>>;
+
+        for (auto& ks_data : keyspace_names) {
+            co_await result.emit_partition_start(ks_data.key);
+
+            const auto states = co_await _db.map_reduce0([ks_name = ks_data.name] (replica::database& local_db) {
+                cache_state_map ret;
+                local_db.get_tables_metadata().for_each_table([&] (table_id, lw_shared_ptr<replica::table> table) {
+                    if (table->schema()->ks_name() != ks_name) {
+                        return;
+                    }
+                    const auto& stats = table->get_row_cache().stats();
+                    cache_state state;
+                    state.hits = stats.hits.count();
+                    state.misses = stats.misses.count();
+                    // Over the last minute, so that it reflects the current workload.
+                    const auto hits_rate = stats.hits.rate().rates[0];
+                    const auto misses_rate = stats.misses.rate().rates[0];
+                    if (hits_rate + misses_rate > 0) {
+                        state.hit_rate = hits_rate / (hits_rate + misses_rate);
+                    }
+                    for (const auto& sst : *table->get_sstables()) {
+                        auto residency = sst->get_index_cache_residency();
+                        state.index_file_bytes += residency.index_file_bytes;
+                        state.partition_index_bytes += residency.partition_index_bytes;
+                    }
+                    ret[table->schema()->cf_name()].emplace(this_shard_id(), state);
+                });
+                return ret;
+            }, cache_state_map(), [] (cache_state_map a, const cache_state_map& b) {
+                for (const auto& [table_name, by_shard] : b) {
+                    a[table_name].insert(by_shard.begin(), by_shard.end());
+                }
+                return a;
+            });
+
+            for (const auto& [table_name, by_shard] : states) {
+                for (const auto& [shard, state] : by_shard) {
+                    clustering_row cr(make_clustering_key(table_name, shard));
+                    set_cell(cr.cells(), "cache_hits", int64_t(state.hits));
+                    set_cell(cr.cells(), "cache_misses", int64_t(state.misses));
+                    set_cell(cr.cells(), "cache_hit_rate", state.hit_rate);
+                    set_cell(cr.cells(), "index_file_cached_bytes", int64_t(state.index_file_bytes));
+                    set_cell(cr.cells(), "partition_index_cached_bytes", int64_t(state.partition_index_bytes));
+                    co_await result.emit_row(std::move(cr));
+                }
+            }
+
+            co_await result.emit_partition_end();
+        }
+    }
+};
+
 class protocol_servers_table : public memtable_filling_virtual_table {
 private:
     service::storage_service& _ss;
@@ -998,6 +1525,11 @@ static void register_virtual_tables(distributed<replica::database>& dist_db, dis
     add_table(std::make_unique<cluster_status_table>(ss, gossiper));
     add_table(std::make_unique<token_ring_table>(db, ss));
     add_table(std::make_unique<snapshots_table>(dist_db));
+    add_table(std::make_unique<heavy_hitters_table>(dist_db));
+    add_table(std::make_unique<top_large_partitions_table>(dist_db));
+    add_table(std::make_unique<reader_semaphores_table>(dist_db));
+    add_table(std::make_unique<reader_permits_table>(dist_db));
+    add_table(std::make_unique<table_cache_state_table>(dist_db));
     add_table(std::make_unique<protocol_servers_table>(ss));
     add_table(std::make_unique<runtime_info_table>(dist_db, ss));
     add_table(std::make_unique<versions_table>());
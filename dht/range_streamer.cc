@@ -30,12 +30,15 @@ using inet_address = gms::inet_address;
 std::unordered_map<inet_address, dht::token_range_vector>
 range_streamer::get_range_fetch_map(const std::unordered_map<dht::token_range, std::vector<inet_address>>& ranges_with_sources,
                                     const std::unordered_set<std::unique_ptr<i_source_filter>>& source_filters,
-                                    const sstring& keyspace) {
+                                    const sstring& keyspace,
+                                    std::unordered_map<dht::token_range, std::vector<inet_address>>& sources_for_range) {
     std::unordered_map<inet_address, dht::token_range_vector> range_fetch_map_map;
+    const auto& topo = get_token_metadata().get_topology();
     for (const auto& x : ranges_with_sources) {
         const dht::token_range& range_ = x.first;
         const std::vector<inet_address>& addresses = x.second;
         bool found_source = false;
+        std::vector<inet_address> sources;
         for (const auto& address : addresses) {
             if (address == utils::fb_utilities::get_broadcast_address()) {
                 // If localhost is a source, we have found one, but we don't add it to the map to avoid streaming locally
@@ -56,9 +59,20 @@ range_streamer::get_range_fetch_map(const std::unordered_map<dht::token_range, s
                 continue;
             }
 
+            if (!sources.empty()) {
+                // The range is fetched from sources.front(), but other sources from the same
+                // datacenter may take it over if they're done with their own ranges first.
+                if (topo.get_datacenter(address) == topo.get_datacenter(sources.front())) {
+                    sources.push_back(address);
+                }
+                continue;
+            }
             range_fetch_map_map[address].push_back(range_);
+            sources.push_back(address);
             found_source = true;
-            break; // ensure we only stream from one other node for each range
+        }
+        if (sources.size() > 1) {
+            sources_for_range.emplace(range_, std::move(sources));
         }
 
         if (!found_source) {
@@ -230,8 +244,16 @@ future<> range_streamer::add_ranges(const sstring& keyspace_name, locator::vnode
         }
     }
 
-    std::unordered_map<inet_address, dht::token_range_vector> range_fetch_map = get_range_fetch_map(ranges_for_keyspace, _source_filters, keyspace_name);
+    std::unordered_map<dht::token_range, std::vector<inet_address>> sources_for_range;
+    std::unordered_map<inet_address, dht::token_range_vector> range_fetch_map = get_range_fetch_map(ranges_for_keyspace, _source_filters, keyspace_name, sources_for_range);
     utils::clear_gently(ranges_for_keyspace).get();
+    // Sources which weren't picked for any range still stream those they can take over
+    for (auto& [range, sources] : sources_for_range) {
+        for (auto& source : sources) {
+            range_fetch_map.try_emplace(source);
+        }
+    }
+    _sources_for_range[keyspace_name].merge(sources_for_range);
 
     if (logger.is_enabled(logging::log_level::debug)) {
         for (auto& x : range_fetch_map) {
@@ -253,18 +275,18 @@ future<> range_streamer::stream_async() {
         auto ips = boost::copy_range<std::list<inet_address>>(ip_range_vec | boost::adaptors::map_keys);
         // Fetch from or send to peer node in parallel
         logger.info("{} with {} for keyspace={} started, nodes_to_stream={}", description, ips, keyspace, ip_range_vec.size());
-        return parallel_for_each(ip_range_vec, [this, description, keyspace] (auto& ip_range) {
+        return parallel_for_each(ip_range_vec, [this, description, keyspace, &ip_range_vec] (auto& ip_range) {
           auto& source = ip_range.first;
           auto& range_vec = ip_range.second;
-          return seastar::with_semaphore(_limiter, 1, [this, description, keyspace, source, &range_vec] () mutable {
-            return seastar::async([this, description, keyspace, source, &range_vec] () mutable {
+          return seastar::with_semaphore(_limiter, 1, [this, description, keyspace, source, &range_vec, &ip_range_vec] () mutable {
+            return seastar::async([this, description, keyspace, source, &range_vec, &ip_range_vec] () mutable {
                 // TODO: It is better to use fiber instead of thread here because
                 // creating a thread per peer can be some memory in a large cluster.
                 auto start_time = lowres_clock::now();
                 unsigned sp_index = 0;
                 unsigned nr_ranges_streamed = 0;
                 size_t nr_ranges_total = range_vec.size();
-                auto do_streaming = [&] (dht::token_range_vector&& ranges_to_stream) {
+                auto do_streaming = [&] (const dht::token_range_vector& ranges_to_stream) {
                     auto sp = stream_plan(_stream_manager.local(), format("{}-{}-index-{:d}", description, keyspace, sp_index++), _reason);
                     auto abort_listener = _abort_source.subscribe([&] () noexcept { sp.abort(); });
                     _abort_source.check();
@@ -273,9 +295,9 @@ future<> range_streamer::stream_async() {
                             nr_ranges_streamed, nr_ranges_streamed + ranges_to_stream.size(), nr_ranges_total);
                     auto ranges_streamed = ranges_to_stream.size();
                     if (_nr_rx_added) {
-                        sp.request_ranges(source, keyspace, std::move(ranges_to_stream), _tables);
+                        sp.request_ranges(source, keyspace, ranges_to_stream, _tables);
                     } else if (_nr_tx_added) {
-                        sp.transfer_ranges(source, keyspace, std::move(ranges_to_stream), _tables);
+                        sp.transfer_ranges(source, keyspace, ranges_to_stream, _tables);
                     }
                     sp.execute().discard_result().get();
                     // Update finished percentage
@@ -286,24 +308,9 @@ future<> range_streamer::stream_async() {
                     logger.info("Finished {} out of {} ranges for {}, finished percentage={}",
                             _nr_total_ranges - _nr_ranges_remaining, _nr_total_ranges, _reason, percentage);
                 };
-                dht::token_range_vector ranges_to_stream;
                 try {
-                    for (auto it = range_vec.begin(); it < range_vec.end();) {
-                        ranges_to_stream.push_back(*it);
-                        ++it;
-                        auto fraction = _db.local().get_config().stream_plan_ranges_fraction();
-                        size_t nr_ranges_per_stream_plan = nr_ranges_total * fraction;
-                        if (ranges_to_stream.size() < nr_ranges_per_stream_plan) {
-                            continue;
-                        } else {
-                            do_streaming(std::exchange(ranges_to_stream, {}));
-                            it = range_vec.erase(range_vec.begin(), it);
-                        }
-                    }
-                    if (ranges_to_stream.size() > 0) {
-                        do_streaming(std::exchange(ranges_to_stream, {}));
-                        range_vec.clear();
-                    }
+                    auto fraction = _db.local().get_config().stream_plan_ranges_fraction();
+                    stream_ranges_from(keyspace, source, ip_range_vec, fraction, nr_ranges_total, do_streaming);
                 } catch (...) {
                     auto t = std::chrono::duration_cast<std::chrono::duration<float>>(lowres_clock::now() - start_time).count();
                     logger.warn("{} with {} for keyspace={} failed, took {} seconds: {}", description, source, keyspace, t, std::current_exception());
@@ -325,6 +332,82 @@ future<> range_streamer::stream_async() {
     });
 }
 
+void range_streamer::stream_ranges_from(const sstring& keyspace, inet_address source,
+                                        std::unordered_map<inet_address, dht::token_range_vector>& ranges_per_source,
+                                        double fraction, size_t& nr_ranges_total,
+                                        noncopyable_function<void (const dht::token_range_vector&)> do_streaming) {
+    auto& range_vec = ranges_per_source[source];
+    // Ranges are removed from range_vec when their stream plan starts, so that
+    // the ones left there can be taken over by other sources meanwhile.
+    dht::token_range_vector ranges_to_stream;
+    try {
+        for (;;) {
+            if (range_vec.empty()) {
+                range_vec = steal_ranges(keyspace, source, ranges_per_source);
+                if (range_vec.empty()) {
+                    break;
+                }
+                nr_ranges_total += range_vec.size();
+            }
+            size_t nr_ranges_per_stream_plan = std::max(size_t(nr_ranges_total * fraction), size_t(1));
+            auto end = range_vec.begin() + std::min(range_vec.size(), nr_ranges_per_stream_plan);
+            ranges_to_stream.assign(std::make_move_iterator(range_vec.begin()), std::make_move_iterator(end));
+            range_vec.erase(range_vec.begin(), end);
+            do_streaming(ranges_to_stream);
+            ranges_to_stream.clear();
+        }
+    } catch (...) {
+        // The ranges of the failed stream plan remain to be streamed, and the
+        // operation fails, so the other sources don't take over more ranges.
+        range_vec.insert(range_vec.begin(), std::make_move_iterator(ranges_to_stream.begin()), std::make_move_iterator(ranges_to_stream.end()));
+        _stream_failed = true;
+        throw;
+    }
+}
+
+dht::token_range_vector range_streamer::steal_ranges(const sstring& keyspace, inet_address thief,
+                                                     std::unordered_map<inet_address, dht::token_range_vector>& ranges_per_source) {
+    auto it = _sources_for_range.find(keyspace);
+    if (_stream_failed || it == _sources_for_range.end()) {
+        return {};
+    }
+    const auto& sources_for_range = it->second;
+    auto can_take = [&] (const dht::token_range& range) {
+        auto sources = sources_for_range.find(range);
+        return sources != sources_for_range.end() && std::ranges::find(sources->second, thief) != sources->second.end();
+    };
+    dht::token_range_vector* victim = nullptr;
+    inet_address victim_address;
+    size_t nr_victim_ranges = 0;
+    for (auto& [source, ranges] : ranges_per_source) {
+        if (source == thief || ranges.size() <= nr_victim_ranges) {
+            continue;
+        }
+        size_t nr_ranges = std::ranges::count_if(ranges, can_take);
+        if (nr_ranges > nr_victim_ranges) {
+            victim = &ranges;
+            victim_address = source;
+            nr_victim_ranges = nr_ranges;
+        }
+    }
+    dht::token_range_vector stolen;
+    if (!victim) {
+        return stolen;
+    }
+    // Take half of them, from the back of the queue, which the victim would stream last
+    size_t nr_to_steal = (nr_victim_ranges + 1) / 2;
+    for (auto r = victim->end(); r != victim->begin() && stolen.size() < nr_to_steal;) {
+        --r;
+        if (can_take(*r)) {
+            stolen.push_back(std::move(*r));
+            r = victim->erase(r);
+        }
+    }
+    logger.info("{} with {} for keyspace={}, taking over {} ranges from {}, which has {} ranges left",
+            _description, thief, keyspace, stolen.size(), victim_address, victim->size());
+    return stolen;
+}
+
 size_t range_streamer::nr_ranges_to_stream() {
     size_t nr_ranges_remaining = 0;
     for (auto& fetch : _to_stream) {
@@ -18,6 +18,7 @@
 #include "range.hh"
 #include <seastar/core/distributed.hh>
 #include <seastar/core/abort_source.hh>
+#include <seastar/util/noncopyable_function.hh>
 #include <unordered_map>
 #include <memory>
 
@@ -28,11 +29,14 @@ class database;
 namespace gms { class gossiper; }
 namespace locator { class topology; }
 
+class range_streamer_test;
+
 namespace dht {
 /**
  * Assists in streaming ranges to a node.
  */
 class range_streamer {
+    friend class ::range_streamer_test;
 public:
     using inet_address = gms::inet_address;
     using token_metadata = locator::token_metadata;
@@ -125,12 +129,34 @@ class range_streamer {
      * @param rangesWithSources The ranges we want to fetch (key) and their potential sources (value)
      * @param sourceFilters A (possibly empty) collection of source filters to apply. In addition to any filters given
      *                      here, we always exclude ourselves.
+     * @param sources_for_range Filled with the sources each range may be fetched from, for the ranges which
+     *                          have more than one, see steal_ranges()
      * @return
      */
     std::unordered_map<inet_address, dht::token_range_vector>
     get_range_fetch_map(const std::unordered_map<dht::token_range, std::vector<inet_address>>& ranges_with_sources,
                         const std::unordered_set<std::unique_ptr<i_source_filter>>& source_filters,
-                        const sstring& keyspace);
+                        const sstring& keyspace,
+                        std::unordered_map<dht::token_range, std::vector<inet_address>>& sources_for_range);
+
+    /**
+     * Moves to thief some of the ranges which are still queued for the source that has the most
+     * of them that thief can stream as well, so that sources which are done with their own ranges
+     * help the slower ones. Returns an empty vector if there is no such range.
+     */
+    dht::token_range_vector steal_ranges(const sstring& keyspace, inet_address thief,
+                                         std::unordered_map<inet_address, dht::token_range_vector>& ranges_per_source);
+
+    /**
+     * Streams the ranges queued for source, fraction of them per stream plan, and then the ones
+     * it takes over from other sources. The ranges of a failed stream plan are put back in the
+     * queue of source, and no source takes over ranges anymore.
+     * Must run inside a seastar thread.
+     */
+    void stream_ranges_from(const sstring& keyspace, inet_address source,
+                            std::unordered_map<inet_address, dht::token_range_vector>& ranges_per_source,
+                            double fraction, size_t& nr_ranges_total,
+                            noncopyable_function<void (const dht::token_range_vector&)> do_streaming);
 
 #if 0
 
@@ -160,6 +186,10 @@ class range_streamer {
     std::vector<sstring> _tables;
     std::unordered_multimap<sstring, std::unordered_map<inet_address, dht::token_range_vector>> _to_stream;
     std::unordered_set<std::unique_ptr<i_source_filter>> _source_filters;
+    // For each keyspace, the sources each range can be fetched from, when there is more than one
+    std::unordered_map<sstring, std::unordered_map<dht::token_range, std::vector<inet_address>>> _sources_for_range;
+    // Set once streaming from a source fails
+    bool _stream_failed = false;
     // Number of tx and rx ranges added
     unsigned _nr_tx_added = 0;
     unsigned _nr_rx_added = 0;
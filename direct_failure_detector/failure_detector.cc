@@ -6,6 +6,9 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
 #include <unordered_set>
 
 #include <seastar/core/abort_source.hh>
@@ -51,6 +54,19 @@ struct listeners_liveness {
     std::unordered_map<pinger::endpoint_id, direct_failure_detector::endpoint_liveness> endpoint_liveness;
 };
 
+// Estimates how long a ping to an endpoint may take, based on the round-trip times of the previous pings.
+class rtt_estimate {
+    clock::interval_t _srtt;
+    clock::interval_t _rttvar;
+public:
+    explicit rtt_estimate(clock::interval_t first_rtt) noexcept;
+
+    void update(clock::interval_t rtt) noexcept;
+
+    // A ping taking longer than this is very unlikely to return, clamped to [`min`, `max`].
+    clock::interval_t timeout(clock::interval_t min, clock::interval_t max) const noexcept;
+};
+
 enum class endpoint_update {
     added,
     removed
@@ -522,6 +538,20 @@ static future<bool> ping_with_timeout(pinger::endpoint_id id, clock::timepoint_t
     co_return result;
 }
 
+rtt_estimate::rtt_estimate(clock::interval_t first_rtt) noexcept
+        : _srtt(first_rtt), _rttvar(first_rtt / 2) {
+}
+
+void rtt_estimate::update(clock::interval_t rtt) noexcept {
+    // The gains recommended by RFC 6298: 1/8 for the mean, 1/4 for the deviation.
+    _rttvar += (std::abs(_srtt - rtt) - _rttvar) / 4;
+    _srtt += (rtt - _srtt) / 8;
+}
+
+clock::interval_t rtt_estimate::timeout(clock::interval_t min, clock::interval_t max) const noexcept {
+    return std::clamp(_srtt + 4 * _rttvar, min, max);
+}
+
 future<> endpoint_worker::ping_fiber() noexcept {
     auto& pinger = _fd._pinger;
     auto& clock = _fd._clock;
@@ -531,6 +561,10 @@ future<> endpoint_worker::ping_fiber() noexcept {
     // which can only be true if there was a successful ping response).
     clock::timepoint_t last_response;
 
+    // Round-trip time of successful pings: the smoothed mean and the mean deviation,
+    // estimated like TCP's retransmission timer (RFC 6298). Unset until the first response.
+    std::optional<rtt_estimate> rtt;
+
     while (!_as.abort_requested()) {
         bool success = false;
         auto start = clock.now();
@@ -538,9 +572,11 @@ future<> endpoint_worker::ping_fiber() noexcept {
 
         // A ping should take significantly less time than _ping_period, but we give it a multiple of ping_period before it times out
         // just in case of transient network partitions.
+        // Once the endpoint's round-trip times are known, a ping taking much longer than them is unlikely to return soon,
+        // so we give it only a single ping_period and start the next ping sooner.
         // However, if there's a listener that's going to timeout soon (before the ping returns), we abort the ping in order to handle
         // the listener (mark it as dead).
-        auto timeout = start + 3 * _fd._ping_period;
+        auto timeout = start + (rtt ? rtt->timeout(_fd._ping_period, 3 * _fd._ping_period) : 3 * _fd._ping_period);
         for (auto& [threshold, l]: _fd._listeners_liveness) {
             if (l.endpoint_liveness[_id].alive && last_response + threshold < timeout) {
                 timeout = last_response + threshold;
@@ -571,6 +607,11 @@ future<> endpoint_worker::ping_fiber() noexcept {
         bool alive_changed = false;
         if (success) {
             last_response = clock.now();
+            if (rtt) {
+                rtt->update(last_response - start);
+            } else {
+                rtt.emplace(last_response - start);
+            }
 
             for (auto& [_, l]: _fd._listeners_liveness) {
                 bool& alive = l.endpoint_liveness[_id].alive;
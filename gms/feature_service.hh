@@ -130,6 +130,33 @@ class feature_service final : public peering_sharded_service<feature_service> {
     gms::feature tablets { *this, "TABLETS"sv };
     gms::feature uuid_sstable_identifiers { *this, "UUID_SSTABLE_IDENTIFIERS"sv };
     gms::feature table_digest_insensitive_to_expiry { *this, "TABLE_DIGEST_INSENSITIVE_TO_EXPIRY"sv };
+    // The node understands the MUTATION_BATCH verb, which carries several
+    // writes, each acknowledged on its own with MUTATION_DONE/MUTATION_FAILED.
+    gms::feature mutation_batch_verb { *this, "MUTATION_BATCH_VERB"sv };
+    // The node can execute forward_requests carrying GROUP BY columns and
+    // returns per-group partial aggregation states.
+    gms::feature parallelized_group_by { *this, "PARALLELIZED_GROUP_BY"sv };
+    // The node can compute digests with digest_algorithm::xxHash_of_versions.
+    gms::feature digest_of_versions { *this, "DIGEST_OF_VERSIONS"sv };
+    // The node has the system.batchlog_v2 table and replays it.
+    gms::feature batchlog_v2 { *this, "BATCHLOG_V2"sv };
+    // The node answers the REPAIR_GET_RANGE_SUMMARY verb.
+    gms::feature repair_range_summary { *this, "REPAIR_RANGE_SUMMARY"sv };
+    // The node can receive sstables streamed as files with STREAM_SSTABLE_FILES.
+    gms::feature file_streaming { *this, "FILE_STREAMING"sv };
+    // The node accepts stream_mutation_fragments_cmd::mutation_fragment_batch.
+    gms::feature streaming_fragment_batch { *this, "STREAMING_FRAGMENT_BATCH"sv };
+    // The node answers the TABLET_LOAD_STATS verb.
+    gms::feature tablet_load_stats { *this, "TABLET_LOAD_STATS"sv };
+    // The node understands tablet resize decisions in system.tablets: it splits its
+    // compaction groups ahead of a tablet split and reports when they are ready.
+    gms::feature tablet_resize { *this, "TABLET_RESIZE"sv };
+    // Repair hashes clustering and static rows of tables without collections
+    // or counters over their serialized form, with xxh3.
+    gms::feature repair_serialized_row_hash { *this, "REPAIR_SERIALIZED_ROW_HASH"sv };
+    // The node can send and receive READ_DATA results in the columnar encoding
+    // (partition_slice::option::columnar_result).
+    gms::feature columnar_query_result { *this, "COLUMNAR_QUERY_RESULT"sv };
 
     // A feature just for use in tests. It must not be advertised unless
     // the "features_enable_test_feature" injection is enabled.
@@ -709,6 +709,7 @@ future<> gossiper::remove_endpoint(inet_address endpoint, permit_id pid) {
     });
     _syn_handlers.erase(endpoint);
     _ack_handlers.erase(endpoint);
+    _heartbeat_replicated_at.erase(endpoint);
     quarantine_endpoint(endpoint);
     logger.info("Removed endpoint {}", endpoint);
 
@@ -1211,6 +1212,7 @@ future<> gossiper::evict_from_membership(inet_address endpoint, permit_id pid) {
     co_await container().invoke_on_all([endpoint] (auto& g) {
         g._endpoint_state_map.erase(endpoint);
     });
+    _heartbeat_replicated_at.erase(endpoint);
     _expire_time_endpoint_map.erase(endpoint);
     quarantine_endpoint(endpoint);
     logger.debug("evicting {} from gossip", endpoint);
@@ -1265,13 +1267,15 @@ future<> gossiper::replicate(inet_address ep, endpoint_state es, permit_id pid)
     // Second pass: set replicated endpoint_state on all shards
     // Must not throw
     try {
-        co_return co_await container().invoke_on_all([&] (gossiper& g) {
+        co_await container().invoke_on_all([&] (gossiper& g) {
             auto eps = ep_states[this_shard_id()].release();
             g._endpoint_state_map[ep] = std::move(eps);
         });
     } catch (...) {
         on_fatal_internal_error(logger, fmt::format("Failed to replicate endpoint_state: {}", std::current_exception()));
     }
+    // All shards have the heartbeat now, whatever made it replicate the state.
+    _heartbeat_replicated_at[ep] = clk::now();
 }
 
 future<> gossiper::advertise_token_removed(inet_address endpoint, locator::host_id host_id, permit_id pid) {
@@ -1443,6 +1447,7 @@ future<> gossiper::reset_endpoint_state_map() {
         g._live_endpoints.clear();
         g._live_endpoints_version = version;
         g._endpoint_state_map.clear();
+        g._heartbeat_replicated_at.clear();
     });
 }
 
@@ -1809,6 +1814,21 @@ future<> gossiper::apply_new_states(inet_address addr, endpoint_state local_stat
         ep = std::current_exception();
     }
 
+    // Every gossip round brings a new heartbeat for each live node. Copying the
+    // whole endpoint_state to every shard for each of them dominates gossip's
+    // CPU cost in large clusters, yet only this shard, which runs the gossip
+    // protocol, needs the heartbeat to be current. When nothing else changed,
+    // update this shard only, and let the other shards catch up with the next
+    // application state change, or after HEARTBEAT_REPLICATION_INTERVAL.
+    if (changed.empty() && !ep) {
+        auto it = _heartbeat_replicated_at.find(addr);
+        if (it != _heartbeat_replicated_at.end() && clk::now() - it->second < HEARTBEAT_REPLICATION_INTERVAL) {
+            local_state.update_is_normal();
+            _endpoint_state_map[addr] = make_endpoint_state_ptr(std::move(local_state));
+            co_return;
+        }
+    }
+
     // We must replicate endpoint states before listeners run.
     // Exceptions during replication will cause abort because node's state
     // would be inconsistent across shards. Changes listeners depend on state
@@ -185,6 +185,9 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
 
     /* map where key is the endpoint and value is the state associated with the endpoint */
     std::unordered_map<inet_address, endpoint_state_ptr> _endpoint_state_map;
+    // When the state of a node, heartbeat included, was last copied to the
+    // other shards by replicate(), see apply_new_states().
+    std::unordered_map<inet_address, clk::time_point> _heartbeat_replicated_at;
     // Used for serializing changes to _endpoint_state_map and running of associated change listeners.
     endpoint_locks_map _endpoint_locks;
 
@@ -201,6 +204,9 @@ class gossiper : public seastar::async_sharded_service<gossiper>, public seastar
         versioned_value::STATUS_UNKNOWN,
     };
     static constexpr std::chrono::milliseconds INTERVAL{1000};
+    // Changes of a node's state which only bump its heartbeat are copied
+    // to the other shards at most this often, see apply_new_states().
+    static constexpr std::chrono::milliseconds HEARTBEAT_REPLICATION_INTERVAL{10000};
     static constexpr std::chrono::hours A_VERY_LONG_TIME{24 * 3};
 
     static constexpr std::chrono::milliseconds GOSSIP_SETTLE_MIN_WAIT_MS{5000};
@@ -824,6 +824,33 @@ struct serializer<const {name}> : public serializer<{name}>
 """)
 
 
+# Serialized sizes of the integral types and of the types declared so far
+# whose serialized form has a fixed size, by qualified name.
+fixed_sizes = {
+    'bool': 1,
+    'int8_t': 1, 'uint8_t': 1,
+    'int16_t': 2, 'uint16_t': 2,
+    'int32_t': 4, 'uint32_t': 4,
+    'int64_t': 8, 'uint64_t': 8,
+}
+
+
+def fixed_size(t):
+    if not isinstance(t, BasicType):
+        return None
+    return fixed_sizes.get(t.name.removeprefix('::'))
+
+
+def declare_fixed_size(hout, name, size):
+    '''Specialize ser::fixed_serialized_size for a type which has no size frame
+    and whose members all have fixed sizes.'''
+    fixed_sizes[name] = size
+    fprintln(hout, f"""
+template <>
+struct fixed_serialized_size<{name}> : std::integral_constant<size_t, {size}> {{}};
+""")
+
+
 def template_params_str(template_params):
     if not template_params:
         return ""
@@ -835,6 +862,9 @@ def handle_enum(enum, hout, cout):
     temp_def = template_params_str(enum.parent_template_params)
     name = enum.ns_qualified_name()
     declare_methods(hout, name, temp_def)
+    size = fixed_sizes.get(enum.underlying_type)
+    if not enum.parent_template_params and size:
+        declare_fixed_size(hout, name, size)
 
     enum.serializer_write_impl(cout)
     enum.serializer_read_impl(cout)
@@ -1572,6 +1602,11 @@ def handle_class(cls, hout, cout):
         elif isinstance(member, EnumDef):
             handle_enum(member, hout, cout)
     declare_methods(hout, full_name, template_params)
+    members = get_members(cls)
+    if cls.final and not template_params and members and not any(m.attribute for m in members):
+        sizes = [fixed_size(m.type) for m in members]
+        if all(sizes):
+            declare_fixed_size(hout, full_name, sum(sizes))
 
     cls.serializer_write_impl(cout)
     cls.serializer_read_impl(cout)
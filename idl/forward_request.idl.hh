@@ -39,10 +39,17 @@ struct forward_request {
     lowres_system_clock::time_point timeout;
 
     std::optional<std::vector<query::forward_request::aggregation_info>> aggregation_infos [[version 5.1]];
+    std::optional<std::vector<sstring>> group_by_column_names [[version 5.5]];
 };
 
 struct forward_result {
+    struct group {
+        std::vector<bytes_opt> key;
+        std::vector<bytes_opt> query_results;
+    };
+
     std::vector<bytes_opt> query_results;
+    std::vector<query::forward_result::group> groups [[version 5.5]];
 };
 
 verb forward_request(query::forward_request req [[ref]], std::optional<tracing::trace_info> trace_info [[ref]]) -> query::forward_result;
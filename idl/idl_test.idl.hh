@@ -15,6 +15,11 @@ class simple_compound {
     uint32_t bar;
 };
 
+class final_simple_compound final {
+    uint32_t foo;
+    uint32_t bar;
+};
+
 class writable_final_simple_compound final stub [[writable]] {
     uint32_t foo;
     uint32_t bar;
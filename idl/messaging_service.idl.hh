@@ -11,6 +11,7 @@ namespace netw {
 struct schema_pull_options {
     bool remote_supports_canonical_mutation_retval;
     bool group0_snapshot_transfer [[version 4.7]] = false;
+    std::optional<utils::UUID> group0_last_state_id [[version 5.5]];
 };
 
 } // namespace netw
@@ -146,5 +146,11 @@ struct repair_flush_hints_batchlog_request {
 struct repair_flush_hints_batchlog_response {
 };
 
+struct repair_range_summary {
+    repair_hash hash;
+    bool rows_kept;
+};
+
 verb [[with_client_info]] repair_update_system_table (repair_update_system_table_request req [[ref]]) -> repair_update_system_table_response;
 verb [[with_client_info]] repair_flush_hints_batchlog (repair_flush_hints_batchlog_request req [[ref]]) -> repair_flush_hints_batchlog_response;
+verb [[with_client_info]] repair_get_range_summary (uint32_t repair_meta_id, dht::token_range range [[ref]]) -> repair_range_summary;
@@ -59,6 +59,7 @@ class read_command {
     std::optional<query::max_result_size> max_result_size [[version 4.3]] = std::nullopt;
     uint32_t row_limit_high_bits [[version 4.3]] = 0;
     uint64_t tombstone_limit [[version 5.2]] = query::max_tombstones;
+    query::is_batch_workload batch_workload [[version 5.5]] = query::is_batch_workload::no;
 };
 
 }
@@ -53,6 +53,14 @@ enum class stream_mutation_fragments_cmd : uint8_t {
     error,
     mutation_fragment_data,
     end_of_stream,
+    // Several mutation fragments, serialized as a vector of frozen_mutation_fragment
+    mutation_fragment_batch,
+};
+
+enum class stream_sstable_files_cmd : uint8_t {
+    error,
+    component_data,
+    end_of_stream,
 };
 
 }
@@ -402,6 +402,9 @@ static const struct luaL_Reg decimal_methods[] {
     {nullptr, nullptr}
 };
 
+// Its address is the registry key of the loaded script.
+static const char script_key = 0;
+
 static int load_script_l(lua_State* l) {
     const auto& bitcode = *reinterpret_cast<lua::bitcode_view*>(lua_touserdata(l, 1));
     const auto& binary = bitcode.bitcode;
@@ -416,8 +419,11 @@ static int load_script_l(lua_State* l) {
     if (luaL_loadbufferx(l, binary.data(), binary.size(), "<internal>", "b")) {
         lua_error(l);
     }
+    // Kept in the registry, rather than on the stack, so that each call of
+    // the script starts from an empty stack.
+    lua_rawsetp(l, LUA_REGISTRYINDEX, &script_key);
 
-    return 1;
+    return 0;
 }
 
 static lua_slice_state load_script(const lua::runtime_config& cfg, lua::bitcode_view binary) {
@@ -428,7 +434,7 @@ static lua_slice_state load_script(const lua::runtime_config& cfg, lua::bitcode_
     // stack slots and the following push calls don't allocate.
     lua_pushcfunction(l, load_script_l);
     lua_pushlightuserdata(l, &binary);
-    if (lua_pcall(l, 1, 1, 0)) {
+    if (lua_pcall(l, 1, 0, 0)) {
         throw std::runtime_error(std::string("could not initiate: ") + lua_tostring(l, -1));
     }
 
@@ -1057,13 +1063,60 @@ lua::runtime_config lua::make_runtime_config(const db::config& config) {
     return lua::runtime_config{std::move(timeout_in_ms), std::move(max_bytes), std::move(max_contiguous)};
 }
 
+class lua::state_pool::state {
+public:
+    lua_slice_state l;
+    explicit state(lua_slice_state l) : l(std::move(l)) {}
+};
+
+lua::state_pool::state_pool() noexcept = default;
+lua::state_pool::state_pool(state_pool&&) noexcept = default;
+lua::state_pool::~state_pool() = default;
+
+std::unique_ptr<lua::state_pool::state> lua::state_pool::get(const runtime_config& cfg, bitcode_view bitcode) {
+    if (_idle.empty()) {
+        return std::make_unique<state>(load_script(cfg, bitcode));
+    }
+    auto s = std::move(_idle.back());
+    _idle.pop_back();
+    return s;
+}
+
+void lua::state_pool::put(std::unique_ptr<state> s) {
+    if (_idle.size() < max_idle_states) {
+        _idle.push_back(std::move(s));
+    }
+}
+
+// Gives the script on the top of the stack a fresh table of globals, so that
+// the globals set by a call are not seen by the following calls which reuse
+// the state. Globals the call didn't set are read from the shared table of
+// globals, which holds the libraries.
+static void set_fresh_env(lua_State* l) {
+    lua_createtable(l, 0, 1);
+    // Assignments through _G go to the fresh table as well.
+    lua_pushvalue(l, -1);
+    lua_setfield(l, -2, "_G");
+    lua_createtable(l, 0, 1);
+    lua_pushglobaltable(l);
+    lua_setfield(l, -2, "__index");
+    lua_setmetatable(l, -2);
+    // The only upvalue of a main chunk is its _ENV.
+    if (!lua_setupvalue(l, -2, 1)) {
+        lua_pop(l, 1);
+    }
+}
+
 // run the script for at most max_instructions
-future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<data_value>& values, data_type return_type, const lua::runtime_config& cfg) {
-    lua_slice_state l = load_script(cfg, bitcode);
+future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, state_pool& states, const std::vector<data_value>& values, data_type return_type, const lua::runtime_config& cfg) {
+    auto s = states.get(cfg, bitcode);
+    lua_slice_state& l = s->l;
     unsigned nargs = values.size();
-    if (!lua_checkstack(l, nargs)) {
+    if (!lua_checkstack(l, nargs + 4)) {
         throw std::runtime_error("could push args to the stack");
     }
+    lua_rawgetp(l, LUA_REGISTRYINDEX, &script_key);
+    set_fresh_env(l);
     for (const data_value& arg : values) {
         push_argument(l, arg);
     }
@@ -1073,7 +1126,8 @@ future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<d
     using duration = std::chrono::system_clock::duration;
     duration elapsed{0};
     duration timeout = std::chrono::duration_cast<duration>(millisecond(cfg.timeout_in_ms));
-    return repeat_until_value([l = std::move(l), elapsed, return_type, nargs, timeout = std::move(timeout)] () mutable {
+    return repeat_until_value([&states, s = std::move(s), elapsed, return_type, nargs, timeout = std::move(timeout)] () mutable {
+        lua_slice_state& l = s->l;
         // Set the hook before resuming. We have to do it here since the hook can reset itself
         // if it detects we are spending too much time in C.
         // The hook will be called after 1000 instructions.
@@ -1081,8 +1135,13 @@ future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<d
         auto start = ::now();
         LUA_504_PLUS(int nresults;)
         switch (lua_resume(l, nullptr, nargs LUA_504_PLUS(, &nresults))) {
-        case LUA_OK:
-            return make_ready_future<std::optional<bytes_opt>>(convert_return(l, return_type));
+        case LUA_OK: {
+            auto ret = convert_return(l, return_type);
+            // The main thread finished running the script, so it can run it again.
+            lua_settop(l, 0);
+            states.put(std::move(s));
+            return make_ready_future<std::optional<bytes_opt>>(std::move(ret));
+        }
         case LUA_YIELD: {
             nargs = 0;
             elapsed += ::now() - start;
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
 #include "types/types.hh"
 #include "utils/updateable_value.hh"
 #include <seastar/core/future.hh>
@@ -30,7 +32,30 @@ struct runtime_config {
 
 runtime_config make_runtime_config(const db::config& config);
 
+// Interpreter states with a function's script already loaded, kept between
+// calls of the function, so that creating a state and loading the script
+// into it is only paid for by the first of concurrent calls. Each call runs
+// with its own table of globals, so globals set by the script don't survive
+// between calls which reuse a state. A call which fails doesn't return its
+// state to the pool.
+class state_pool {
+public:
+    class state;
+private:
+    std::vector<std::unique_ptr<state>> _idle;
+public:
+    // Bounds the memory held by a function which isn't being called.
+    static constexpr size_t max_idle_states = 4;
+
+    state_pool() noexcept;
+    state_pool(state_pool&&) noexcept;
+    ~state_pool();
+
+    std::unique_ptr<state> get(const runtime_config& cfg, bitcode_view bitcode);
+    void put(std::unique_ptr<state> s);
+};
+
 sstring compile(const runtime_config& cfg, const std::vector<sstring>& arg_names, sstring script);
-seastar::future<bytes_opt> run_script(bitcode_view bitcode, const std::vector<data_value>& values,
+seastar::future<bytes_opt> run_script(bitcode_view bitcode, state_pool& states, const std::vector<data_value>& values,
                                       data_type return_type, const runtime_config& cfg);
 }
@@ -22,6 +22,9 @@
 #include <seastar/coroutine/exception.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 #include "lang/wasm_alien_thread_runner.hh"
+#include "utils/hashers.hh"
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
 
 logging::logger wasm_logger("wasm");
 
@@ -33,12 +36,16 @@ startup_context::startup_context(db::config& cfg, replica::database_config& dbcf
     , cache_size(dbcfg.available_memory * cfg.wasm_cache_memory_fraction())
     , instance_size(cfg.wasm_cache_instance_size_limit())
     , timer_period(std::chrono::milliseconds(cfg.wasm_cache_timeout_in_ms())) {
+    if (!cfg.wasm_precompiled_modules_directory().empty()) {
+        precompiled_modules_dir = std::filesystem::path(cfg.wasm_precompiled_modules_directory());
+    }
 }
 
 manager::manager(const std::optional<wasm::startup_context>& ctx)
         : _engine(ctx ? ctx->engine : nullptr)
         , _instance_cache(ctx ? std::make_optional<wasm::instance_cache>(ctx->cache_size, ctx->instance_size, ctx->timer_period) : std::nullopt)
         , _alien_runner(ctx ? ctx->alien_runner : nullptr)
+        , _precompiled_modules_dir(ctx ? ctx->precompiled_modules_dir : std::nullopt)
 {}
 
 future<> manager::stop() {
@@ -243,8 +250,89 @@ struct from_val_visitor {
     }
 };
 
+// Makes sure that the module can be instantiated and exports the function, throws rust::Error otherwise.
+// The compiled code is dropped afterwards, and created again for UDF execution.
+static void validate_module(context& ctx) {
+    ctx.module.value()->compile(ctx.engine_ptr);
+    auto store = wasmtime::create_store(ctx.engine_ptr, ctx.total_fuel, ctx.yield_fuel);
+    auto inst = create_instance(ctx.engine_ptr, **ctx.module, *store);
+    create_func(*inst, *store, ctx.function_name);
+    ctx.module.value()->release();
+}
+
+future<bool> manager::load_precompiled_module(context& ctx, const sstring& path) {
+    std::exception_ptr ex;
+    try {
+        if (!co_await file_exists(path)) {
+            co_return false;
+        }
+        auto f = co_await open_file_dma(path, open_flags::ro);
+        temporary_buffer<char> buf;
+        try {
+            auto size = co_await f.size();
+            buf = co_await f.dma_read_bulk<char>(0, size);
+            if (buf.size() != size) {
+                throw std::runtime_error(format("short read: {} out of {} bytes", buf.size(), size));
+            }
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await f.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+        ctx.module = wasmtime::create_module_from_precompiled(ctx.engine_ptr, rust::Slice<const uint8_t>(reinterpret_cast<const uint8_t*>(buf.get()), buf.size()));
+        validate_module(ctx);
+        co_return true;
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    // E.g. compiled by a different version of wasmtime, it will be replaced.
+    wasm_logger.info("Ignoring precompiled module {}: {}", path, ex);
+    ctx.module = std::nullopt;
+    co_return false;
+}
+
+future<> manager::store_precompiled_module(const wasmtime::Module& module, const sstring& path) {
+    auto serialized = module.serialized();
+    temporary_buffer<char> data(reinterpret_cast<const char*>(serialized.data()), serialized.size());
+    co_await recursive_touch_directory(_precompiled_modules_dir->native());
+    // All shards compile the same functions, so each writes its own temporary file.
+    auto tmp_path = format("{}.{}.tmp", path, this_shard_id());
+    auto f = co_await open_file_dma(tmp_path, open_flags::wo | open_flags::create | open_flags::truncate);
+    auto out = co_await make_file_output_stream(std::move(f));
+    std::exception_ptr ex;
+    try {
+        co_await out.write(data.get(), data.size());
+        co_await out.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await out.close();
+    if (ex) {
+        co_await remove_file(tmp_path);
+        std::rethrow_exception(std::move(ex));
+    }
+    // Publish the module only once it is complete, so that a restart never picks up a partial one.
+    co_await rename_file(tmp_path, path);
+}
+
 seastar::future<> manager::precompile(context& ctx, const std::vector<sstring>& arg_names, std::string script) {
-    return ::wasm::precompile(*_alien_runner, ctx, arg_names, std::move(script));
+    if (!_precompiled_modules_dir) {
+        co_await ::wasm::precompile(*_alien_runner, ctx, arg_names, std::move(script));
+        co_return;
+    }
+    auto path = sstring((*_precompiled_modules_dir / format("{}.cwasm", to_hex(sha256_hasher::calculate(script))).c_str()).native());
+    if (co_await load_precompiled_module(ctx, path)) {
+        wasm_logger.debug("Loaded precompiled module of {} from {}", ctx.function_name, path);
+        co_return;
+    }
+    co_await ::wasm::precompile(*_alien_runner, ctx, arg_names, std::move(script));
+    try {
+        co_await store_precompiled_module(**ctx.module, path);
+    } catch (...) {
+        wasm_logger.warn("Failed to store precompiled module of {} in {}: {}", ctx.function_name, path, std::current_exception());
+    }
 }
 
 seastar::future<> precompile(alien_thread_runner& alien_runner, context& ctx, const std::vector<sstring>& arg_names, std::string script) {
@@ -256,13 +344,7 @@ seastar::future<> precompile(alien_thread_runner& alien_runner, context& ctx, co
     ctx.module = co_await done.get_future();
     std::exception_ptr ex;
     try {
-        // After precompiling the module, we try creating a store, an instance and a function with it to make sure it's valid.
-        // If we succeed, we drop them and keep the module, knowing that we will be able to create them again for UDF execution.
-        ctx.module.value()->compile(ctx.engine_ptr);
-        auto store = wasmtime::create_store(ctx.engine_ptr, ctx.total_fuel, ctx.yield_fuel);
-        auto inst = create_instance(ctx.engine_ptr, **ctx.module, *store);
-        create_func(*inst, *store, ctx.function_name);
-        ctx.module.value()->release();
+        validate_module(ctx);
     } catch (const rust::Error& e) {
         ex = std::make_exception_ptr(wasm::exception(format("Compilation failed: {}", e.what())));
     }
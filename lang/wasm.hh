@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <filesystem>
 #include <span>
 #include "types/types.hh"
 #include <seastar/core/future.hh>
@@ -41,6 +42,7 @@ struct startup_context {
     size_t cache_size;
     size_t instance_size;
     seastar::lowres_clock::duration timer_period;
+    std::optional<std::filesystem::path> precompiled_modules_dir;
 
     startup_context(db::config& cfg, replica::database_config& dbcfg);
 };
@@ -49,6 +51,11 @@ class manager {
     std::shared_ptr<rust::Box<wasmtime::Engine>> _engine;
     std::optional<wasm::instance_cache> _instance_cache;
     std::shared_ptr<wasm::alien_thread_runner> _alien_runner;
+    // Modules compiled on earlier runs, named after the hash of their source.
+    std::optional<std::filesystem::path> _precompiled_modules_dir;
+
+    future<bool> load_precompiled_module(context& ctx, const sstring& path);
+    future<> store_precompiled_module(const wasmtime::Module& module, const sstring& path);
 
 public:
     manager(const std::optional<wasm::startup_context>&);
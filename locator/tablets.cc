@@ -195,6 +195,53 @@ future<> tablet_map::for_each_tablet(seastar::noncopyable_function<void(tablet_i
     }
 }
 
+void tablet_map::set_resize_decision(locator::resize_decision decision) {
+    _resize_decision = std::move(decision);
+}
+
+tablet_map tablet_map::split() const {
+    if (!_transitions.empty()) {
+        on_internal_error(tablet_logger, "Cannot split a tablet map with transitions");
+    }
+    tablet_map result(tablet_count() * 2);
+    for (auto tid : tablet_ids()) {
+        auto& info = get_tablet_info(tid);
+        result.set_tablet(tablet_id(size_t(tid) * 2), info);
+        result.set_tablet(tablet_id(size_t(tid) * 2 + 1), info);
+    }
+    result.set_resize_decision(resize_decision{resize_decision::way_type::none, _resize_decision.sequence_number});
+    return result;
+}
+
+bool tablet_map::can_merge() const {
+    if (tablet_count() < 2) {
+        return false;
+    }
+    for (size_t i = 0; i < tablet_count(); i += 2) {
+        auto& left = _tablets[i].replicas;
+        auto& right = _tablets[i + 1].replicas;
+        if (std::unordered_set<tablet_replica>(left.begin(), left.end()) != std::unordered_set<tablet_replica>(right.begin(), right.end())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+tablet_map tablet_map::merge() const {
+    if (!_transitions.empty()) {
+        on_internal_error(tablet_logger, "Cannot merge a tablet map with transitions");
+    }
+    if (!can_merge()) {
+        on_internal_error(tablet_logger, "Cannot merge a tablet map with sibling tablets on different replicas");
+    }
+    tablet_map result(tablet_count() / 2);
+    for (auto tid : result.tablet_ids()) {
+        result.set_tablet(tid, get_tablet_info(tablet_id(size_t(tid) * 2)));
+    }
+    result.set_resize_decision(resize_decision{resize_decision::way_type::none, _resize_decision.sequence_number});
+    return result;
+}
+
 void tablet_map::clear_transitions() {
     _transitions.clear();
 }
@@ -259,6 +306,32 @@ tablet_transition_stage tablet_transition_stage_from_string(const sstring& name)
     return tablet_transition_stage_from_name.at(name);
 }
 
+static const std::unordered_map<resize_decision::way_type, sstring> resize_decision_way_to_name = {
+    {resize_decision::way_type::none, "none"},
+    {resize_decision::way_type::split, "split"},
+    {resize_decision::way_type::merge, "merge"},
+};
+
+static const std::unordered_map<sstring, resize_decision::way_type> resize_decision_way_from_name = std::invoke([] {
+    std::unordered_map<sstring, resize_decision::way_type> result;
+    for (auto&& [v, s] : resize_decision_way_to_name) {
+        result.emplace(s, v);
+    }
+    return result;
+});
+
+sstring resize_decision_way_to_string(resize_decision::way_type way) {
+    auto i = resize_decision_way_to_name.find(way);
+    if (i == resize_decision_way_to_name.end()) {
+        on_internal_error(tablet_logger, format("Invalid resize decision: {}", static_cast<int>(way)));
+    }
+    return i->second;
+}
+
+resize_decision::way_type resize_decision_way_from_string(const sstring& name) {
+    return resize_decision_way_from_name.at(name);
+}
+
 std::ostream& operator<<(std::ostream& out, tablet_id id) {
     return out << size_t(id);
 }
@@ -285,6 +358,9 @@ std::ostream& operator<<(std::ostream& out, const tablet_map& r) {
         first = false;
         tid = *r.next_tablet(tid);
     }
+    if (r._resize_decision.split_or_merge()) {
+        out << format(",\n    resize={}, seq={}", resize_decision_way_to_string(r._resize_decision.way), r._resize_decision.sequence_number);
+    }
     return out << "\n  }";
 }
 
@@ -324,9 +400,28 @@ size_t tablet_metadata::external_memory_usage() const {
     return result;
 }
 
+load_stats& load_stats::operator+=(const load_stats& other) {
+    for (auto&& [tablet, stats] : other.tablets) {
+        auto& s = tablets[tablet];
+        s.size_in_bytes += stats.size_in_bytes;
+        s.reads += stats.reads;
+        s.writes += stats.writes;
+    }
+    for (auto&& [table, stats] : other.tables) {
+        auto [it, inserted] = tables.try_emplace(table, stats);
+        if (!inserted) {
+            it->second.split_ready_seq_number = std::min(it->second.split_ready_seq_number, stats.split_ready_seq_number);
+        }
+    }
+    return *this;
+}
+
 class tablet_effective_replication_map : public effective_replication_map {
     table_id _table;
     tablet_sharder _sharder;
+    // Resolved once, so that replica lookups don't search tablet_metadata for the table on every request.
+    // Lazily initialized for the same reason as in tablet_sharder.
+    mutable const tablet_map* _tmap = nullptr;
 private:
     gms::inet_address get_endpoint_for_host_id(host_id host) const {
         auto endpoint_opt = _tmptr->get_endpoint_for_host_id(host);
@@ -344,7 +439,10 @@ class tablet_effective_replication_map : public effective_replication_map {
         return result;
     }
     const tablet_map& get_tablet_map() const {
-        return _tmptr->tablets().get_tablet_map(_table);
+        if (!_tmap) {
+            _tmap = &_tmptr->tablets().get_tablet_map(_table);
+        }
+        return *_tmap;
     }
 public:
     tablet_effective_replication_map(table_id table,
@@ -180,6 +180,33 @@ struct tablet_migration_streaming_info {
 
 tablet_migration_streaming_info get_migration_streaming_info(const tablet_info&, const tablet_transition_info&);
 
+/// A decision to change the tablet count of a table, made by the load balancer.
+///
+/// The decision is first recorded in the tablet map, so that replicas can prepare for it,
+/// e.g. by splitting their storage along the boundaries of the new tablets. Once all
+/// replicas are ready, the topology change coordinator finalizes the decision by replacing
+/// the tablet map with one which has the new tablet count.
+struct resize_decision {
+    enum class way_type {
+        none,
+        split, // Doubles the tablet count.
+        merge, // Halves the tablet count.
+    };
+    way_type way = way_type::none;
+    // Increases with every decision made for a table, so that replicas can tell
+    // which decision they are ready for.
+    uint64_t sequence_number = 0;
+
+    bool split_or_merge() const {
+        return way != way_type::none;
+    }
+
+    bool operator==(const resize_decision&) const = default;
+};
+
+sstring resize_decision_way_to_string(resize_decision::way_type);
+resize_decision::way_type resize_decision_way_from_string(const sstring&);
+
 /// Stores information about tablets of a single table.
 ///
 /// The map contains a constant number of tablets, tablet_count().
@@ -206,6 +233,7 @@ class tablet_map {
     tablet_container _tablets;
     size_t _log2_tablets; // log_2(_tablets.size())
     std::unordered_map<tablet_id, tablet_transition_info> _transitions;
+    resize_decision _resize_decision;
 public:
     /// Constructs a tablet map.
     ///
@@ -283,6 +311,27 @@ class tablet_map {
         return _tablets.size();
     }
 
+    size_t log2_tablets() const {
+        return _log2_tablets;
+    }
+
+    const locator::resize_decision& get_resize_decision() const {
+        return _resize_decision;
+    }
+
+    /// Returns a map with twice as many tablets, in which tablets 2i and 2i+1
+    /// own the two halves of tablet i of this map, and inherit its replicas.
+    /// The map must not have transitions.
+    tablet_map split() const;
+
+    /// Returns true iff each pair of sibling tablets, 2i and 2i+1, has the same replicas,
+    /// so that they can be merged without moving data between nodes.
+    bool can_merge() const;
+
+    /// Returns a map with half as many tablets, in which tablet i owns the range of
+    /// tablets 2i and 2i+1 of this map. Requires can_merge() and no transitions.
+    tablet_map merge() const;
+
     /// Returns tablet_info associated with the tablet which owns a given token.
     const tablet_info& get_tablet_info(token t) const {
         return get_tablet_info(get_tablet_id(t));
@@ -294,6 +343,7 @@ class tablet_map {
 public:
     void set_tablet(tablet_id, tablet_info);
     void set_tablet_transition_info(tablet_id, tablet_transition_info);
+    void set_resize_decision(locator::resize_decision);
     void clear_transitions();
 
     // Destroys gently.
@@ -339,6 +389,33 @@ class tablet_metadata {
     friend std::ostream& operator<<(std::ostream&, const tablet_metadata&);
 };
 
+/// Load of a tablet replica, as reported by the node which hosts it.
+struct tablet_load_stats {
+    uint64_t size_in_bytes = 0;
+
+    // Number of requests served by the replica since the node started hosting it.
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+};
+
+/// Per-table stats, as reported by the node which hosts replicas of the table.
+struct table_load_stats {
+    // Sequence number of the split decision for which the storage of all
+    // the replicas on the node is already split, or 0 if none is.
+    uint64_t split_ready_seq_number = 0;
+};
+
+/// Load of all tablet replicas hosted by a node.
+struct load_stats {
+    std::unordered_map<global_tablet_id, tablet_load_stats> tablets;
+    // Only tables with a pending resize decision are reported.
+    std::unordered_map<table_id, table_load_stats> tables;
+
+    // Adds up stats of the same tablets, e.g. reported by different shards.
+    // A table is split-ready only as far as all the reports agree.
+    load_stats& operator+=(const load_stats&);
+};
+
 }
 
 template <>
@@ -61,7 +61,11 @@ class token_metadata_impl final {
 
     std::optional<topology_change_info> _topology_change_info;
 
-    std::vector<token> _sorted_tokens;
+    // Immutable once set, so that clones on the same shard can share it
+    // instead of copying it; see clone_only_token_map().
+    lw_shared_ptr<const std::vector<token>> _sorted_tokens;
+    // The shard on which this object, and so _sorted_tokens, was created.
+    unsigned _shard = this_shard_id();
 
     tablet_metadata _tablets;
 
@@ -83,6 +87,9 @@ class token_metadata_impl final {
     // clone_async() must be updated to copy that member.
 
     void sort_tokens();
+    // Drops `removed` from, and merges `added` into, the sorted tokens,
+    // without re-sorting the whole ring.
+    void update_sorted_tokens(const std::unordered_set<token>& removed, std::vector<token> added);
 
     const tablet_metadata& tablets() const { return _tablets; }
     tablet_metadata& tablets() { return _tablets; }
@@ -368,8 +375,14 @@ future<std::unique_ptr<token_metadata_impl>> token_metadata_impl::clone_only_tok
     }
     ret->_normal_token_owners = _normal_token_owners;
     ret->_topology = co_await _topology.clone_gently();
-    if (clone_sorted_tokens) {
-        ret->_sorted_tokens = _sorted_tokens;
+    if (clone_sorted_tokens && _sorted_tokens) {
+        // lw_shared_ptr can't be shared across shards, so only clones
+        // on other shards need a copy of their own.
+        if (ret->_shard == _shard) {
+            ret->_sorted_tokens = _sorted_tokens;
+        } else {
+            ret->_sorted_tokens = make_lw_shared<const std::vector<token>>(*_sorted_tokens);
+        }
         co_await coroutine::maybe_yield();
     }
     ret->_tablets = _tablets;
@@ -383,7 +396,7 @@ future<> token_metadata_impl::clear_gently() noexcept {
     co_await utils::clear_gently(_bootstrap_tokens);
     co_await utils::clear_gently(_leaving_endpoints);
     co_await utils::clear_gently(_replacing_endpoints);
-    co_await utils::clear_gently(_sorted_tokens);
+    _sorted_tokens = nullptr;
     co_await _topology.clear_gently();
     co_await _tablets.clear_gently();
     co_return;
@@ -399,7 +412,22 @@ void token_metadata_impl::sort_tokens() {
 
     std::sort(sorted.begin(), sorted.end());
 
-    _sorted_tokens = std::move(sorted);
+    _sorted_tokens = make_lw_shared<const std::vector<token>>(std::move(sorted));
+}
+
+void token_metadata_impl::update_sorted_tokens(const std::unordered_set<token>& removed, std::vector<token> added) {
+    const auto& old = sorted_tokens();
+    // The sorted tokens may be stale, e.g. in a clone made without them.
+    if (old.size() + added.size() != _token_to_endpoint_map.size() + removed.size()) {
+        sort_tokens();
+        return;
+    }
+    std::sort(added.begin(), added.end());
+    std::vector<token> sorted;
+    sorted.reserve(_token_to_endpoint_map.size());
+    auto kept = old | boost::adaptors::filtered([&] (const token& t) { return !removed.contains(t); });
+    std::merge(kept.begin(), kept.end(), added.begin(), added.end(), std::back_inserter(sorted));
+    _sorted_tokens = make_lw_shared<const std::vector<token>>(std::move(sorted));
 }
 
 const tablet_metadata& token_metadata::tablets() const {
@@ -415,7 +443,8 @@ void token_metadata::set_tablets(tablet_metadata tm) {
 }
 
 const std::vector<token>& token_metadata_impl::sorted_tokens() const {
-    return _sorted_tokens;
+    static const thread_local std::vector<token> no_tokens;
+    return _sorted_tokens ? *_sorted_tokens : no_tokens;
 }
 
 std::vector<token> token_metadata_impl::get_tokens(const inet_address& addr) const {
@@ -438,7 +467,8 @@ future<> token_metadata_impl::update_normal_tokens(std::unordered_set<token> tok
         on_internal_error(tlogger, format("token_metadata_impl: {} must be a member of topology to update normal tokens", endpoint));
     }
 
-    bool should_sort_tokens = false;
+    std::unordered_set<token> removed_tokens;
+    std::vector<token> added_tokens;
 
     // Phase 1: erase all tokens previously owned by the endpoint.
     for(auto it = _token_to_endpoint_map.begin(), ite = _token_to_endpoint_map.end(); it != ite;) {
@@ -447,6 +477,7 @@ future<> token_metadata_impl::update_normal_tokens(std::unordered_set<token> tok
             auto tokit = tokens.find(it->first);
             if (tokit == tokens.end()) {
                 // token no longer owned by endpoint
+                removed_tokens.insert(it->first);
                 it = _token_to_endpoint_map.erase(it);
                 continue;
             }
@@ -461,7 +492,7 @@ future<> token_metadata_impl::update_normal_tokens(std::unordered_set<token> tok
     // a. ...
     // b. update pending _bootstrap_tokens and _leaving_endpoints
     // c. update _token_to_endpoint_map with the new endpoint->token mappings
-    //    - set `should_sort_tokens` if new tokens were added
+    //    - collect the newly added tokens in `added_tokens`
     remove_by_value(_bootstrap_tokens, endpoint);
     _leaving_endpoints.erase(endpoint);
     invalidate_cached_rings();
@@ -469,7 +500,9 @@ future<> token_metadata_impl::update_normal_tokens(std::unordered_set<token> tok
     {
         co_await coroutine::maybe_yield();
         auto prev = _token_to_endpoint_map.insert(std::pair<token, inet_address>(t, endpoint));
-        should_sort_tokens |= prev.second; // new token inserted -> sort
+        if (prev.second) {
+            added_tokens.push_back(t);
+        }
         if (prev.first->second != endpoint) {
             tlogger.debug("Token {} changing ownership from {} to {}", t, prev.first->second, endpoint);
             prev.first->second = endpoint;
@@ -478,30 +511,31 @@ future<> token_metadata_impl::update_normal_tokens(std::unordered_set<token> tok
 
     co_await update_normal_token_owners();
 
-    // New tokens were added to _token_to_endpoint_map
-    // so re-sort all tokens.
-    if (should_sort_tokens) {
-        sort_tokens();
+    // Tokens were added to or removed from _token_to_endpoint_map
+    // so update the sorted tokens.
+    if (!removed_tokens.empty() || !added_tokens.empty()) {
+        update_sorted_tokens(removed_tokens, std::move(added_tokens));
     }
     co_return;
 }
 
 size_t token_metadata_impl::first_token_index(const token& start) const {
-    if (_sorted_tokens.empty()) {
+    const auto& sorted = sorted_tokens();
+    if (sorted.empty()) {
         auto msg = format("sorted_tokens is empty in first_token_index!");
         tlogger.error("{}", msg);
         throw std::runtime_error(msg);
     }
-    auto it = std::lower_bound(_sorted_tokens.begin(), _sorted_tokens.end(), start);
-    if (it == _sorted_tokens.end()) {
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), start);
+    if (it == sorted.end()) {
         return 0;
     } else {
-        return std::distance(_sorted_tokens.begin(), it);
+        return std::distance(sorted.begin(), it);
     }
 }
 
 const token& token_metadata_impl::first_token(const token& start) const {
-    return _sorted_tokens[first_token_index(start)];
+    return sorted_tokens()[first_token_index(start)];
 }
 
 std::optional<inet_address> token_metadata_impl::get_endpoint(const token& token) const {
@@ -521,7 +555,7 @@ void token_metadata_impl::debug_show() const {
             fmt::print("inet_address={}, token={}\n", x.second, x.first);
         }
         fmt::print("Sorted Token\n");
-        for (auto x : _sorted_tokens) {
+        for (auto x : sorted_tokens()) {
             fmt::print("token={}\n", x);
         }
     });
@@ -14,6 +14,7 @@
 #include <seastar/core/abort_source.hh>
 #include "tasks/task_manager.hh"
 #include "utils/build_id.hh"
+#include "utils/background_disposer.hh"
 #include "supervisor.hh"
 #include "replica/database.hh"
 #include <seastar/core/reactor.hh>
@@ -31,6 +32,7 @@
 #include "service/load_meter.hh"
 #include "service/view_update_backlog_broker.hh"
 #include "service/qos/service_level_controller.hh"
+#include "service/qos/compaction_shares_updater.hh"
 #include "streaming/stream_session.hh"
 #include "db/system_keyspace.hh"
 #include "db/system_distributed_keyspace.hh"
@@ -85,6 +87,7 @@
 #include "tombstone_gc_extension.hh"
 #include "db/tags/extension.hh"
 #include "db/paxos_grace_seconds_extension.hh"
+#include "db/commitlog_bypass_extension.hh"
 #include "service/qos/standard_service_level_distributed_data_accessor.hh"
 #include "service/storage_proxy.hh"
 #include "service/forward_service.hh"
@@ -165,6 +168,12 @@ struct convert<::object_storage_endpoint_param> {
         ep.endpoint = node["name"].as<std::string>();
         ep.config.port = node["port"].as<unsigned>();
         ep.config.use_https = node["https"].as<bool>(false);
+        if (node["max_connections"]) {
+            ep.config.max_connections = node["max_connections"].as<unsigned>();
+        }
+        if (node["upload_parts_in_flight"]) {
+            ep.config.upload_parts_in_flight = node["upload_parts_in_flight"].as<unsigned>();
+        }
         if (node["aws_region"]) {
             ep.config.aws.emplace();
             ep.config.aws->region = node["aws_region"].as<std::string>();
@@ -595,6 +604,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
     ext->add_schema_extension<db::paxos_grace_seconds_extension>(db::paxos_grace_seconds_extension::NAME);
     ext->add_schema_extension<tombstone_gc_extension>(tombstone_gc_extension::NAME);
     ext->add_schema_extension<db::per_partition_rate_limit_extension>(db::per_partition_rate_limit_extension::NAME);
+    ext->add_schema_extension<db::commitlog_bypass_extension>(db::commitlog_bypass_extension::NAME);
 
     auto cfg = make_lw_shared<db::config>(ext);
     auto init = app.get_options_description().add_options();
@@ -651,6 +661,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
     sharded<service::forward_service> forward_service;
     sharded<gms::gossiper> gossiper;
     sharded<locator::snitch_ptr> snitch;
+    sharded<qos::compaction_shares_updater> compaction_shares_updater;
 
     return app.run(ac, av, [&] () -> future<int> {
 
@@ -788,6 +799,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 st_cfg.defragment_on_idle = cfg->defragment_memory_on_idle();
                 st_cfg.abort_on_lsa_bad_alloc = cfg->abort_on_lsa_bad_alloc();
                 st_cfg.lsa_reclamation_step = cfg->lsa_reclamation_step();
+                st_cfg.reclaim_huge_page_spans = cfg->lsa_reclaim_huge_page_spans();
                 st_cfg.background_reclaim_sched_group = background_reclaim_scheduling_group;
                 st_cfg.sanitizer_report_backtrace = cfg->sanitizer_report_backtrace();
                 logalloc::shard_tracker().configure(st_cfg);
@@ -799,6 +811,15 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 }).get();
             });
 
+            smp::invoke_on_all([maintenance_scheduling_group] {
+                utils::local_background_disposer().start(maintenance_scheduling_group);
+            }).get();
+            auto stop_background_disposer = defer_verbose_shutdown("background disposer", [] {
+                smp::invoke_on_all([] {
+                    return utils::local_background_disposer().stop();
+                }).get();
+            });
+
             if (cfg->broadcast_address().empty() && cfg->listen_address().empty()) {
                 startlog.error("Bad configuration: neither listen_address nor broadcast_address are defined\n");
                 throw bad_configuration_error();
@@ -985,6 +1006,10 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                     .available_memory = dbcfg.available_memory,
                     .static_shares = cfg->compaction_static_shares,
                     .throughput_mb_per_sec = cfg->compaction_throughput_mb_per_sec,
+                    .major_compaction_max_parallelism = cfg->major_compaction_max_parallelism,
+                    .major_compaction_min_split_size_in_mb = cfg->major_compaction_min_split_size_in_mb,
+                    .index_cache_warming = cfg->compaction_index_cache_warming,
+                    .read_amplification_threshold = cfg->compaction_read_amplification_threshold,
                 };
             });
             cm.start(std::move(get_cm_cfg), std::ref(stop_signal.as_sharded_abort_source()), std::ref(task_manager)).get();
@@ -994,6 +1019,10 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
 
             sstables::storage_manager::config stm_cfg;
             stm_cfg.s3_clients_memory = std::clamp<size_t>(memory::stats().total_memory() * 0.01, 10 << 20, 100 << 20);
+            if (!cfg->object_storage_cache_directory().empty()) {
+                stm_cfg.object_cache_dir = std::filesystem::path(cfg->object_storage_cache_directory());
+                stm_cfg.object_cache_size = cfg->object_storage_cache_size_in_mb() << 20;
+            }
             sstm.start(std::ref(*cfg), stm_cfg).get();
             auto stop_sstm = defer_verbose_shutdown("sstables storage manager", [&sstm] {
                 sstm.stop().get();
@@ -1099,7 +1128,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
 
             supervisor::notify("creating tracing");
             sharded<tracing::tracing>& tracing = tracing::tracing::tracing_instance();
-            tracing.start(sstring("trace_keyspace_helper")).get();
+            tracing.start(sstring(cfg->tracing_otlp_collector_address().empty() ? "trace_keyspace_helper" : "otlp_exporter")).get();
             auto destroy_tracing = defer_verbose_shutdown("tracing instance", [&tracing] {
                 tracing.stop().get();
             });
@@ -1123,6 +1152,12 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 sl_controller.stop().get();
             });
 
+            compaction_shares_updater.start(std::ref(sl_controller), std::ref(db), std::cref(*cfg)).get();
+            compaction_shares_updater.invoke_on_all(&qos::compaction_shares_updater::start).get();
+            auto stop_compaction_shares_updater = defer_verbose_shutdown("compaction shares updater", [&compaction_shares_updater] {
+                compaction_shares_updater.stop().get();
+            });
+
             //This starts the update loop - but no real update happens until the data accessor is not initialized.
             sl_controller.local().update_from_distributed_data(std::chrono::seconds(10));
 
@@ -1243,6 +1278,8 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             if (!cfg->inter_dc_tcp_nodelay()) {
                 mscfg.tcp_nodelay = netw::messaging_service::tcp_nodelay_what::local;
             }
+            mscfg.shard_aware_connections = cfg->internode_shard_aware_connections();
+            mscfg.inter_dc_zstd = cfg->internode_compression_inter_dc_algorithm() == "zstd";
 
             netw::messaging_service::scheduling_config scfg;
             scfg.statement_tenants = { {dbcfg.statement_scheduling_group, "$user"}, {default_scheduling_group(), "$system"} };
@@ -1478,6 +1515,11 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 }
             }
 
+            // Tables with commitlog_bypass lose the writes they didn't flush unless the node
+            // was drained. Remember whether that happened and repair them once we joined.
+            const bool commitlog_bypass_dirty = sys_ks.local().get_commitlog_bypass_dirty().get0();
+            sys_ks.local().set_commitlog_bypass_dirty(true).get();
+
             // Once stuff is replayed, we can empty RP:s from truncation records. 
             // This ensures we can't mis-mash older records with a newer crashed run.
             // I.e: never keep replay_positions alive across a restart cycle.
@@ -1605,7 +1647,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             api::set_server_task_manager_test(ctx).get();
 #endif
             supervisor::notify("starting sstables loader");
-            sst_loader.start(std::ref(db), std::ref(sys_dist_ks), std::ref(view_update_generator), std::ref(messaging)).get();
+            sst_loader.start(std::ref(db), std::ref(sys_dist_ks), std::ref(view_update_generator), std::ref(messaging), std::ref(task_manager)).get();
             auto stop_sst_loader = defer_verbose_shutdown("sstables loader", [&sst_loader] {
                 sst_loader.stop().get();
             });
@@ -1679,6 +1721,25 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 return ss.local().join_cluster(sys_dist_ks, proxy);
             }).get();
 
+            if (commitlog_bypass_dirty) {
+                std::map<sstring, std::vector<sstring>> bypass_tables;
+                db.local().get_tables_metadata().for_each_table([&] (table_id, lw_shared_ptr<replica::table> table) {
+                    if (table->schema()->commitlog_bypass()) {
+                        bypass_tables[table->schema()->ks_name()].push_back(table->schema()->cf_name());
+                    }
+                });
+                for (auto& [ks_name, cf_names] : bypass_tables) {
+                    auto tables = boost::algorithm::join(cf_names, ",");
+                    try {
+                        auto id = repair_start(repair, ks_name, {{"columnFamilies", tables}}).get0();
+                        startlog.info("Node was not drained before it stopped, repairing tables {}.{{{}}} which bypass the commitlog, repair id {}", ks_name, tables, id);
+                    } catch (...) {
+                        startlog.warn("Node was not drained before it stopped, but repairing tables {}.{{{}}} which bypass the commitlog failed: {}. Repair them manually",
+                                ks_name, tables, std::current_exception());
+                    }
+                }
+            }
+
             sl_controller.invoke_on_all([&lifecycle_notifier] (qos::service_level_controller& controller) {
                 controller.set_distributed_data_accessor(::static_pointer_cast<qos::service_level_controller::service_level_distributed_data_accessor>(
                         ::make_shared<qos::standard_service_level_distributed_data_accessor>(sys_dist_ks.local())));
@@ -1722,7 +1783,10 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                 api::unset_server_authorization_cache(ctx).get();
             });
 
-            snapshot_ctl.start(std::ref(db)).get();
+            db::snapshot_ctl::config snap_cfg = {
+                .backup_sched_group = dbcfg.streaming_scheduling_group,
+            };
+            snapshot_ctl.start(std::ref(db), std::ref(task_manager), std::move(snap_cfg)).get();
             auto stop_snapshot_ctl = defer_verbose_shutdown("snapshots", [&snapshot_ctl] {
                 snapshot_ctl.stop().get();
             });
@@ -1964,7 +2028,10 @@ int main(int ac, char** av) {
         {"types", tools::scylla_types_main, "a command-line tool to examine values belonging to scylla types"},
         {"sstable", tools::scylla_sstable_main, "a multifunctional command-line tool to examine the content of sstables"},
         {"nodetool", tools::scylla_nodetool_main, "a command-line tool to administer local or remote ScyllaDB nodes"},
+        {"perf-alternator", perf::scylla_alternator_main, "run performance tests by sending requests to the alternator HTTP server of this server"},
+        {"perf-compaction", perf::scylla_compaction_main, "run performance tests of compaction across strategies and data shapes on this server"},
         {"perf-fast-forward", perf::scylla_fast_forward_main, "run performance tests by fast forwarding the reader on this server"},
+        {"perf-repair", perf::scylla_repair_main, "run performance tests of row-level repair and streaming between simulated nodes on this server"},
         {"perf-row-cache-update", perf::scylla_row_cache_update_main, "run performance tests by updating row cache on this server"},
         {"perf-tablets", perf::scylla_tablets_main, "run performance tests of tablet metadata management"},
         {"perf-simple-query", perf::scylla_simple_query_main, "run performance tests by sending simple queries to this server"},
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
+#include <random>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/as_future.hh>
 #include <seastar/coroutine/exception.hh>
@@ -40,6 +41,7 @@
 #include "utils/digest_algorithm.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "cache_temperature.hh"
 #include "raft/raft.hh"
 #include "service/raft/group0_fwd.hh"
@@ -110,6 +112,7 @@
 #include <seastar/rpc/lz4_compressor.hh>
 #include <seastar/rpc/lz4_fragmented_compressor.hh>
 #include <seastar/rpc/multi_algo_compressor_factory.hh>
+#include "message/zstd_rpc_compressor.hh"
 #include "partition_range_compat.hh"
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/indirected.hpp>
@@ -143,6 +146,16 @@ static rpc::multi_algo_compressor_factory compressor_factory {
     &lz4_fragmented_compressor_factory,
     &lz4_compressor_factory,
 };
+// Offered to peers in other datacenters when inter_dc_zstd is set (see
+// get_rpc_client()), falling back to lz4 for peers which don't support zstd.
+// Servers advertise zstd only when inter_dc_zstd is set too, so that it is
+// used only between nodes which both enable it.
+static netw::zstd_rpc_compressor::factory zstd_compressor_factory(3);
+static rpc::multi_algo_compressor_factory zstd_or_lz4_compressor_factory {
+    &zstd_compressor_factory,
+    &lz4_fragmented_compressor_factory,
+    &lz4_compressor_factory,
+};
 
 struct messaging_service::rpc_protocol_server_wrapper : public rpc_protocol::server { using rpc_protocol::server::server; };
 
@@ -318,7 +331,7 @@ void messaging_service::do_start_listen() {
     bool listen_to_bc = _cfg.listen_on_broadcast_address && _cfg.ip != utils::fb_utilities::get_broadcast_address();
     rpc::server_options so;
     if (_cfg.compress != compress_what::none) {
-        so.compressor_factory = &compressor_factory;
+        so.compressor_factory = _cfg.inter_dc_zstd ? &zstd_or_lz4_compressor_factory : &compressor_factory;
     }
     so.load_balancing_algorithm = server_socket::load_balancing_algorithm::port;
 
@@ -409,6 +422,7 @@ messaging_service::messaging_service(config cfg, scheduling_config scfg, std::sh
     , _rpc(new rpc_protocol_wrapper(serializer { }))
     , _credentials_builder(credentials ? std::make_unique<seastar::tls::credentials_builder>(*credentials) : nullptr)
     , _clients(PER_SHARD_CONNECTION_COUNT + scfg.statement_tenants.size() * PER_TENANT_CONNECTION_COUNT)
+    , _next_local_port_slot(std::random_device{}())
     , _scheduling_config(scfg)
     , _scheduling_info_for_connection_index(initial_scheduling_info())
 {
@@ -585,6 +599,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::UNUSED__REPLICATION_FINISHED:
     case messaging_verb::UNUSED__REPAIR_CHECKSUM_RANGE:
     case messaging_verb::STREAM_MUTATION_FRAGMENTS:
+    case messaging_verb::STREAM_SSTABLE_FILES:
     case messaging_verb::REPAIR_ROW_LEVEL_START:
     case messaging_verb::REPAIR_ROW_LEVEL_STOP:
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES:
@@ -600,6 +615,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::REPAIR_GET_FULL_ROW_HASHES_WITH_RPC_STREAM:
     case messaging_verb::REPAIR_UPDATE_SYSTEM_TABLE:
     case messaging_verb::REPAIR_FLUSH_HINTS_BATCHLOG:
+    case messaging_verb::REPAIR_GET_RANGE_SUMMARY:
     case messaging_verb::NODE_OPS_CMD:
     case messaging_verb::HINT_MUTATION:
     case messaging_verb::TABLET_STREAM_DATA:
@@ -607,6 +623,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
         return 1;
     case messaging_verb::CLIENT_ID:
     case messaging_verb::MUTATION:
+    case messaging_verb::MUTATION_BATCH:
     case messaging_verb::READ_DATA:
     case messaging_verb::READ_MUTATION_DATA:
     case messaging_verb::READ_DIGEST:
@@ -634,6 +651,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::RAFT_MODIFY_CONFIG:
     case messaging_verb::DIRECT_FD_PING:
     case messaging_verb::RAFT_PULL_TOPOLOGY_SNAPSHOT:
+    case messaging_verb::TABLET_LOAD_STATS:
         return 2;
     case messaging_verb::MUTATION_DONE:
     case messaging_verb::MUTATION_FAILED:
@@ -786,6 +804,44 @@ gms::inet_address messaging_service::get_public_endpoint_for(const gms::inet_add
     return i != _preferred_to_endpoint.end() ? i->second : ip;
 }
 
+// Servers balance connections by the port they come from (see do_start_listen()):
+// a connection from port p is accepted on shard p % smp::count. Connecting from
+// a port equal to this shard's id modulo the shard count makes a peer with the
+// same number of shards handle the connection's messages on this shard's peer,
+// which for writes and reads is also the shard owning the data, so neither the
+// replica nor the responses hop to another shard. Peers with a different number
+// of shards hop between shards as before.
+static uint16_t shard_aware_local_port(unsigned& next_slot) {
+    static constexpr unsigned first_port = 49152;
+    static constexpr unsigned last_port = 65535;
+    const unsigned first = first_port + (this_shard_id() + smp::count - first_port % smp::count) % smp::count;
+    const unsigned slots = (last_port - first) / smp::count + 1;
+    // Spread the connections over the range, so that a port still used by a
+    // previous connection, or by another process, is not picked again right away.
+    return first + (next_slot++ % slots) * smp::count;
+}
+
+socket_address messaging_service::shard_aware_local_address(gms::inet_address ip, unsigned& next_slot) {
+    static constexpr unsigned max_attempts = 16;
+    for (unsigned attempt = 0; attempt < max_attempts; ++attempt) {
+        auto laddr = socket_address(ip, shard_aware_local_port(next_slot));
+        // The rpc client binds its socket in the background, where a failure
+        // to bind only shows up as a broken connection. Check that the port
+        // can be bound first.
+        try {
+            seastar::listen(laddr).abort_accept();
+            return laddr;
+        } catch (const std::system_error& e) {
+            if (e.code().value() != EADDRINUSE && e.code().value() != EADDRNOTAVAIL) {
+                throw;
+            }
+            mlogger.debug("Cannot connect from {}: {}", laddr, e.what());
+        }
+    }
+    mlogger.debug("No free shard-aware port for connections from {}, using an ephemeral port", ip);
+    return socket_address(ip, 0);
+}
+
 shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::get_rpc_client(messaging_verb verb, msg_addr id) {
     assert(!_shutting_down);
     auto idx = get_rpc_client_idx(verb);
@@ -805,7 +861,9 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
     auto my_host_id = _cfg.id;
     auto broadcast_address = utils::fb_utilities::get_broadcast_address();
     bool listen_to_bc = _cfg.listen_on_broadcast_address && _cfg.ip != broadcast_address;
-    auto laddr = socket_address(listen_to_bc ? broadcast_address : _cfg.ip, 0);
+    auto laddr = _cfg.shard_aware_connections
+            ? shard_aware_local_address(listen_to_bc ? broadcast_address : _cfg.ip, _next_local_port_slot)
+            : socket_address(listen_to_bc ? broadcast_address : _cfg.ip, 0);
 
     std::optional<bool> topology_status;
     auto has_topology = [&] {
@@ -879,7 +937,8 @@ shared_ptr<messaging_service::rpc_protocol_client_wrapper> messaging_service::ge
     // send keepalive messages each minute if connection is idle, drop connection after 10 failures
     opts.keepalive = std::optional<net::tcp_keepalive_params>({60s, 60s, 10});
     if (must_compress) {
-        opts.compressor_factory = &compressor_factory;
+        bool use_zstd = _cfg.inter_dc_zstd && idx != TOPOLOGY_INDEPENDENT_IDX && has_topology() && !is_same_dc(id.addr);
+        opts.compressor_factory = use_zstd ? &zstd_or_lz4_compressor_factory : &compressor_factory;
     }
     opts.tcp_nodelay = must_tcp_nodelay;
     opts.reuseaddr = true;
@@ -996,6 +1055,35 @@ future<> messaging_service::unregister_stream_mutation_fragments() {
     return unregister_handler(messaging_verb::STREAM_MUTATION_FRAGMENTS);
 }
 
+rpc::sink<int32_t> messaging_service::make_sink_for_stream_sstable_files(rpc::source<streaming::stream_sstable_files_cmd, sstring, bytes>& source) {
+    return source.make_sink<netw::serializer, int32_t>();
+}
+
+future<std::tuple<rpc::sink<streaming::stream_sstable_files_cmd, sstring, bytes>, rpc::source<int32_t>>>
+messaging_service::make_sink_and_source_for_stream_sstable_files(streaming::plan_id plan_id, table_id cf_id, sstring version, sstring format, std::vector<sstring> components, dht::token first_token, streaming::stream_reason reason, msg_addr id) {
+    using value_type = std::tuple<rpc::sink<streaming::stream_sstable_files_cmd, sstring, bytes>, rpc::source<int32_t>>;
+    if (is_shutting_down()) {
+        return make_exception_future<value_type>(rpc::closed_error());
+    }
+    auto rpc_client = get_rpc_client(messaging_verb::STREAM_SSTABLE_FILES, id);
+    return rpc_client->make_stream_sink<netw::serializer, streaming::stream_sstable_files_cmd, sstring, bytes>().then([this, plan_id, cf_id, version = std::move(version), format = std::move(format), components = std::move(components), first_token, reason, rpc_client] (rpc::sink<streaming::stream_sstable_files_cmd, sstring, bytes> sink) mutable {
+        auto rpc_handler = rpc()->make_client<rpc::source<int32_t> (streaming::plan_id, table_id, sstring, sstring, std::vector<sstring>, dht::token, streaming::stream_reason, rpc::sink<streaming::stream_sstable_files_cmd, sstring, bytes>)>(messaging_verb::STREAM_SSTABLE_FILES);
+        return rpc_handler(*rpc_client, plan_id, cf_id, std::move(version), std::move(format), std::move(components), first_token, reason, sink).then_wrapped([sink, rpc_client] (future<rpc::source<int32_t>> source) mutable {
+            return (source.failed() ? sink.close() : make_ready_future<>()).then([sink = std::move(sink), source = std::move(source)] () mutable {
+                return make_ready_future<value_type>(value_type(std::move(sink), source.get0()));
+            });
+        });
+    });
+}
+
+void messaging_service::register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_id cf_id, sstring version, sstring format, std::vector<sstring> components, dht::token first_token, streaming::stream_reason reason, rpc::source<streaming::stream_sstable_files_cmd, sstring, bytes> source)>&& func) {
+    register_handler(this, messaging_verb::STREAM_SSTABLE_FILES, std::move(func));
+}
+
+future<> messaging_service::unregister_stream_sstable_files() {
+    return unregister_handler(messaging_verb::STREAM_SSTABLE_FILES);
+}
+
 template<class SinkType, class SourceType>
 future<std::tuple<rpc::sink<SinkType>, rpc::source<SourceType>>>
 do_make_sink_source(messaging_verb verb, uint32_t repair_meta_id, shared_ptr<messaging_service::rpc_protocol_client_wrapper> rpc_client, std::unique_ptr<messaging_service::rpc_protocol_wrapper>& rpc) {
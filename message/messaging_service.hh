@@ -32,6 +32,7 @@
 namespace streaming {
     class prepare_message;
     enum class stream_mutation_fragments_cmd : uint8_t;
+    enum class stream_sstable_files_cmd : uint8_t;
 }
 
 namespace gms {
@@ -186,7 +187,11 @@ enum class messaging_verb : int32_t {
     TABLET_CLEANUP = 67,
     JOIN_NODE_REQUEST = 68,
     JOIN_NODE_RESPONSE = 69,
-    LAST = 70,
+    MUTATION_BATCH = 70,
+    REPAIR_GET_RANGE_SUMMARY = 71,
+    STREAM_SSTABLE_FILES = 72,
+    TABLET_LOAD_STATS = 73,
+    LAST = 74,
 };
 
 } // namespace netw
@@ -212,6 +217,11 @@ struct schema_pull_options {
     // which contain additional data (besides schema tables mutations).
     // When used inside group 0 snapshot transfer, this is `true`.
     bool group0_snapshot_transfer = false;
+
+    // The last group 0 state ID applied by the puller, if it is pulling a group 0
+    // snapshot. If it's also the last one applied by the remote, the puller
+    // already has the remote's state, which is then not sent.
+    std::optional<utils::UUID> group0_last_state_id;
 };
 
 class messaging_service : public seastar::async_sharded_service<messaging_service>, public peering_sharded_service<messaging_service> {
@@ -276,6 +286,11 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
         bool listen_on_broadcast_address = false;
         size_t rpc_memory_limit = 1'000'000;
         std::unordered_map<gms::inet_address, gms::inet_address> preferred_ips;
+        // Pick the local port of outgoing connections, so that they are accepted
+        // on the peer's shard with the same id as the connecting shard.
+        bool shard_aware_connections = false;
+        // Compress traffic to other datacenters with zstd rather than lz4.
+        bool inter_dc_zstd = false;
     };
 
     struct scheduling_config {
@@ -316,6 +331,8 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     std::vector<clients_map> _clients;
     uint64_t _dropped_messages[static_cast<int32_t>(messaging_verb::LAST)] = {};
     bool _shutting_down = false;
+    // See shard_aware_local_address().
+    unsigned _next_local_port_slot;
     connection_drop_signal_t _connection_dropped;
     scheduling_config _scheduling_config;
     std::vector<scheduling_info_for_connection_index> _scheduling_info_for_connection_index;
@@ -371,6 +388,13 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     rpc::sink<int32_t> make_sink_for_stream_mutation_fragments(rpc::source<frozen_mutation_fragment, rpc::optional<streaming::stream_mutation_fragments_cmd>>& source);
     future<std::tuple<rpc::sink<frozen_mutation_fragment, streaming::stream_mutation_fragments_cmd>, rpc::source<int32_t>>> make_sink_and_source_for_stream_mutation_fragments(table_schema_version schema_id, streaming::plan_id plan_id, table_id cf_id, uint64_t estimated_partitions, streaming::stream_reason reason, msg_addr id);
 
+    // Wrapper for STREAM_SSTABLE_FILES
+    // Sends the component files of one sstable as-is, as (cmd, component name, data) chunks. The receiver replies with a status code like for STREAM_MUTATION_FRAGMENTS.
+    void register_stream_sstable_files(std::function<future<rpc::sink<int32_t>> (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_id cf_id, sstring version, sstring format, std::vector<sstring> components, dht::token first_token, streaming::stream_reason reason, rpc::source<streaming::stream_sstable_files_cmd, sstring, bytes> source)>&& func);
+    future<> unregister_stream_sstable_files();
+    rpc::sink<int32_t> make_sink_for_stream_sstable_files(rpc::source<streaming::stream_sstable_files_cmd, sstring, bytes>& source);
+    future<std::tuple<rpc::sink<streaming::stream_sstable_files_cmd, sstring, bytes>, rpc::source<int32_t>>> make_sink_and_source_for_stream_sstable_files(streaming::plan_id plan_id, table_id cf_id, sstring version, sstring format, std::vector<sstring> components, dht::token first_token, streaming::stream_reason reason, msg_addr id);
+
     // Wrapper for REPAIR_GET_ROW_DIFF_WITH_RPC_STREAM
     future<std::tuple<rpc::sink<repair_hash_with_cmd>, rpc::source<repair_row_on_wire_with_cmd>>> make_sink_and_source_for_repair_get_row_diff_with_rpc_stream(uint32_t repair_meta_id, msg_addr id);
     rpc::sink<repair_row_on_wire_with_cmd> make_sink_for_repair_get_row_diff_with_rpc_stream(rpc::source<repair_hash_with_cmd>& source);
@@ -529,6 +553,12 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     bool is_host_banned(locator::host_id);
 
 public:
+    // Picks the local address of a new connection from ip, from a port which makes
+    // the peer accept it on the shard with this shard's id. next_slot chooses
+    // among such ports. Falls back to an ephemeral port when none of the ports
+    // tried can be bound.
+    static socket_address shard_aware_local_address(gms::inet_address ip, unsigned& next_slot);
+
     // Return rpc::protocol::client for a shard which is a ip + cpuid pair.
     shared_ptr<rpc_protocol_client_wrapper> get_rpc_client(messaging_verb verb, msg_addr id);
     void remove_error_rpc_client(messaging_verb verb, msg_addr id);
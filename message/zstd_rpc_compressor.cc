@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <seastar/util/variant_utils.hh>
+#include <fmt/format.h>
+
+#include "zstd.h"
+
+#include "message/zstd_rpc_compressor.hh"
+
+namespace netw {
+
+using namespace seastar;
+
+// Output is produced in fragments of this size at most.
+static constexpr size_t max_fragment_size = rpc::snd_buf::chunk_size;
+
+static size_t check_zstd(size_t ret, const char* what) {
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(fmt::format("ZSTD RPC {} failure: {}", what, ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+template <typename Buf, typename Func>
+static void for_each_fragment(Buf& buf, Func&& func) {
+    std::visit(make_visitor(
+        [&] (temporary_buffer<char>& b) {
+            func(b);
+        },
+        [&] (std::vector<temporary_buffer<char>>& bufs) {
+            for (auto& b : bufs) {
+                func(b);
+            }
+        }), buf.bufs);
+}
+
+// Collects the output of a zstd stream into fragments.
+class fragmented_output {
+    std::vector<temporary_buffer<char>> _fragments;
+    temporary_buffer<char> _current;
+    size_t _size = 0;
+public:
+    ZSTD_outBuffer out;
+
+    fragmented_output(size_t first_fragment_size, size_t head_space)
+        : _current(first_fragment_size)
+        , out{_current.get_write(), _current.size(), head_space}
+    {}
+
+    bool full() const noexcept {
+        return out.pos == out.size;
+    }
+
+    void next_fragment(size_t size) {
+        _current.trim(out.pos);
+        _size += out.pos;
+        _fragments.push_back(std::move(_current));
+        _current = temporary_buffer<char>(size);
+        out = ZSTD_outBuffer{_current.get_write(), _current.size(), 0};
+    }
+
+    template <typename Buf>
+    Buf finish() && {
+        _current.trim(out.pos);
+        _size += out.pos;
+        if (_fragments.empty()) {
+            return Buf(std::move(_current));
+        }
+        if (_current.size()) {
+            _fragments.push_back(std::move(_current));
+        }
+        return Buf(std::move(_fragments), _size);
+    }
+
+    size_t size() const noexcept {
+        return _size + out.pos;
+    }
+};
+
+namespace {
+
+struct cctx_deleter {
+    void operator()(ZSTD_CCtx* cctx) const noexcept {
+        ZSTD_freeCCtx(cctx);
+    }
+};
+
+struct dctx_deleter {
+    void operator()(ZSTD_DCtx* dctx) const noexcept {
+        ZSTD_freeDCtx(dctx);
+    }
+};
+
+}
+
+// A context holds the window and the tables of a stream, hundreds of KiB
+// at the levels used here. Messages are compressed and decompressed without
+// yielding, so all connections of a shard share a context of each kind,
+// instead of each connection keeping its own.
+static ZSTD_CCtx* local_cctx() {
+    static thread_local std::unique_ptr<ZSTD_CCtx, cctx_deleter> cctx;
+    if (!cctx) {
+        cctx.reset(ZSTD_createCCtx());
+        if (!cctx) {
+            throw std::runtime_error("Unable to initialize ZSTD RPC compression context");
+        }
+    }
+    return cctx.get();
+}
+
+static ZSTD_DCtx* local_dctx() {
+    static thread_local std::unique_ptr<ZSTD_DCtx, dctx_deleter> dctx;
+    if (!dctx) {
+        dctx.reset(ZSTD_createDCtx());
+        if (!dctx) {
+            throw std::runtime_error("Unable to initialize ZSTD RPC decompression context");
+        }
+    }
+    return dctx.get();
+}
+
+zstd_rpc_compressor::factory::factory(int level)
+    : _level(level)
+{}
+
+const sstring& zstd_rpc_compressor::factory::supported() const {
+    return _name;
+}
+
+std::unique_ptr<rpc::compressor> zstd_rpc_compressor::factory::negotiate(sstring feature, bool is_server) const {
+    return feature == _name ? std::make_unique<zstd_rpc_compressor>(_level) : nullptr;
+}
+
+sstring zstd_rpc_compressor::name() const {
+    return sstring(name_string);
+}
+
+rpc::snd_buf zstd_rpc_compressor::compress(size_t head_space, rpc::snd_buf data) {
+    auto cctx = local_cctx();
+    // The context may have been left mid-frame by a failed call.
+    check_zstd(ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters), "compression");
+    check_zstd(ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, _level), "compression");
+    // Lets the receiver detect corrupted frames, see decompress().
+    check_zstd(ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1), "compression");
+    // Recorded in the frame header, so that the receiver can size its buffers.
+    check_zstd(ZSTD_CCtx_setPledgedSrcSize(cctx, data.size), "compression");
+
+    fragmented_output output(std::min(head_space + ZSTD_compressBound(data.size), head_space + max_fragment_size), head_space);
+    for_each_fragment(data, [&] (temporary_buffer<char>& b) {
+        ZSTD_inBuffer in{b.get(), b.size(), 0};
+        while (in.pos < in.size) {
+            check_zstd(ZSTD_compressStream2(cctx, &output.out, &in, ZSTD_e_continue), "compression");
+            if (output.full()) {
+                output.next_fragment(max_fragment_size);
+            }
+        }
+        // Release the input as soon as it is consumed.
+        b = temporary_buffer<char>();
+    });
+    ZSTD_inBuffer no_input{nullptr, 0, 0};
+    while (check_zstd(ZSTD_compressStream2(cctx, &output.out, &no_input, ZSTD_e_end), "compression")) {
+        if (output.full()) {
+            output.next_fragment(max_fragment_size);
+        }
+    }
+    return std::move(output).finish<rpc::snd_buf>();
+}
+
+rpc::rcv_buf zstd_rpc_compressor::decompress(rpc::rcv_buf data) {
+    auto dctx = local_dctx();
+    check_zstd(ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only), "decompression");
+
+    // The frame header holds the decompressed size, see compress().
+    std::optional<size_t> content_size;
+    for_each_fragment(data, [&] (temporary_buffer<char>& b) {
+        if (!content_size && b.size()) {
+            auto size = ZSTD_getFrameContentSize(b.get(), b.size());
+            if (size != ZSTD_CONTENTSIZE_UNKNOWN && size != ZSTD_CONTENTSIZE_ERROR) {
+                content_size = size;
+            }
+        }
+    });
+    size_t expected = content_size.value_or(max_fragment_size);
+    auto next_fragment_size = [&] (size_t produced) {
+        return std::clamp<size_t>(expected > produced ? expected - produced : 1, 1, max_fragment_size);
+    };
+
+    fragmented_output output(next_fragment_size(0), 0);
+    // Non-zero until a whole frame is decoded, so that empty input is rejected too.
+    size_t ret = 1;
+    for_each_fragment(data, [&] (temporary_buffer<char>& b) {
+        ZSTD_inBuffer in{b.get(), b.size(), 0};
+        while (in.pos < in.size) {
+            ret = check_zstd(ZSTD_decompressStream(dctx, &output.out, &in), "decompression");
+            if (output.full()) {
+                output.next_fragment(next_fragment_size(output.size()));
+            }
+        }
+        b = temporary_buffer<char>();
+    });
+    // Flush what the context still holds, once the output had no room for it.
+    ZSTD_inBuffer no_input{nullptr, 0, 0};
+    while (ret) {
+        auto pos = output.out.pos;
+        ret = check_zstd(ZSTD_decompressStream(dctx, &output.out, &no_input), "decompression");
+        if (output.full()) {
+            output.next_fragment(next_fragment_size(output.size()));
+        } else if (ret && output.out.pos == pos) {
+            throw std::runtime_error("ZSTD RPC decompression failure: truncated frame");
+        }
+    }
+    if (content_size && output.size() != *content_size) {
+        throw std::runtime_error(fmt::format("ZSTD RPC decompression failure: decompressed {} bytes, frame header says {}", output.size(), *content_size));
+    }
+    return std::move(output).finish<rpc::rcv_buf>();
+}
+
+}
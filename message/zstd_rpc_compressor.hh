@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <string_view>
+#include <seastar/rpc/rpc_types.hh>
+
+namespace netw {
+
+// An RPC compressor using zstd streaming compression. It compresses
+// considerably better than lz4, at a higher CPU cost, which pays off on
+// links where bandwidth, rather than CPU, is scarce, like those between
+// datacenters. Like lz4_fragmented_compressor, it works on fragmented
+// buffers, so large messages don't require large contiguous allocations.
+class zstd_rpc_compressor final : public seastar::rpc::compressor {
+    int _level;
+public:
+    static constexpr std::string_view name_string = "ZSTD";
+
+    class factory final : public seastar::rpc::compressor::factory {
+        // A member rather than a global, since multi_algo_compressor_factory
+        // instances defined as globals call supported() at initialization.
+        const seastar::sstring _name{name_string};
+        int _level;
+    public:
+        explicit factory(int level);
+        virtual const seastar::sstring& supported() const override;
+        virtual std::unique_ptr<seastar::rpc::compressor> negotiate(seastar::sstring feature, bool is_server) const override;
+    };
+
+    explicit zstd_rpc_compressor(int level) noexcept : _level(level) {}
+
+    virtual seastar::rpc::snd_buf compress(size_t head_space, seastar::rpc::snd_buf data) override;
+    virtual seastar::rpc::rcv_buf decompress(seastar::rpc::rcv_buf data) override;
+    virtual seastar::sstring name() const override;
+};
+
+}
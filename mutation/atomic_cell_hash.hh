@@ -15,6 +15,7 @@
 #include "atomic_cell.hh"
 #include "atomic_cell_or_collection.hh"
 #include "utils/hashing.hh"
+#include "utils/xx_hasher.hh"
 #include "counters.hh"
 
 template<>
@@ -46,7 +47,11 @@ struct appending_hash<atomic_cell_view> {
                 feed_hash(h, cell.expiry());
                 feed_hash(h, cell.ttl());
             }
-            feed_hash(h, cell.value());
+            if constexpr (std::is_same_v<Hasher, xx_version_hasher>) {
+                feed_hash(h, cell.value_size());
+            } else {
+                feed_hash(h, cell.value());
+            }
         } else {
             feed_hash(h, cell.deletion_time());
         }
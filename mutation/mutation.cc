@@ -12,6 +12,9 @@
 #include "mutation/json.hh"
 #include "types/tuple.hh"
 
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+
 mutation::data::data(dht::decorated_key&& key, schema_ptr&& schema)
     : _schema(std::move(schema))
     , _dk(std::move(key))
@@ -94,6 +97,15 @@ mutation::live_row_count(gc_clock::time_point query_time) const {
     return partition().live_row_count(*schema(), query_time);
 }
 
+future<> mutation::clear_gently() noexcept {
+    if (!_ptr) {
+        co_return;
+    }
+    while (_ptr->_p.clear_gently(nullptr) == stop_iteration::no) {
+        co_await coroutine::maybe_yield();
+    }
+}
+
 bool
 mutation_decorated_key_less_comparator::operator()(const mutation& m1, const mutation& m2) const {
     return m1.decorated_key().less_compare(*m1.schema(), m2.decorated_key());
@@ -166,6 +166,10 @@ class mutation final {
     // See mutation_partition::live_row_count()
     uint64_t live_row_count(gc_clock::time_point query_time = gc_clock::time_point::min()) const;
 
+    // Destroys the rows and range tombstones of the partition, yielding in between.
+    // The mutation is left with an empty partition, but keeps its key and schema.
+    future<> clear_gently() noexcept;
+
     void apply(mutation&&);
     void apply(const mutation&);
     void apply(const mutation_fragment&);
@@ -286,6 +286,9 @@ mutation_fragment_stream_validating_filter::mutation_fragment_stream_validating_
             case mutation_fragment_stream_validation_level::partition_key:
                 what = "partition region and partition key";
                 break;
+            case mutation_fragment_stream_validation_level::sampled_clustering_key:
+                what = "partition region, partition key and sampled clustering key";
+                break;
             case mutation_fragment_stream_validation_level::clustering_key:
                 what = "partition region, partition key and clustering key";
                 break;
@@ -312,6 +315,13 @@ bool mutation_fragment_stream_validating_filter::operator()(mutation_fragment_v2
 
     if (_validation_level >= mutation_fragment_stream_validation_level::clustering_key) {
         res = _validator(kind, pos, new_current_tombstone);
+    } else if (_validation_level == mutation_fragment_stream_validation_level::sampled_clustering_key
+            && pos.region() == partition_region::clustered
+            && _clustering_fragments++ % clustering_key_sample_interval == 0) {
+        // Positions are monotonic, so comparing the sampled fragments with
+        // each other still catches them being out of order, although not
+        // necessarily at the first out-of-order fragment.
+        res = _validator(kind, pos, new_current_tombstone);
     } else {
         res = _validator(kind, new_current_tombstone);
     }
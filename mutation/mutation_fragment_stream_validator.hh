@@ -15,6 +15,7 @@ enum class mutation_fragment_stream_validation_level {
     partition_region, // fragment kind
     token,
     partition_key,
+    sampled_clustering_key, // clustering key of one in every mutation_fragment_stream_validating_filter::clustering_key_sample_interval clustering fragments
     clustering_key,
 };
 
@@ -59,7 +60,10 @@ class mutation_fragment_stream_validator {
     /// Should be used when the full, more heavy-weight position-in-partition
     /// monotonicity validation provided by
     /// `operator()(const mutation_fragment&)` is not desired.
-    /// Using both overloads for the same stream is not supported.
+    /// Using both overloads for the same stream is only supported to skip
+    /// the position validation of some clustering fragments, in which case
+    /// the position of the others is validated against the last validated
+    /// position of the partition.
     /// Advances the previous fragment kind, but only if the validation passes.
     /// `new_current_tombstone` should be engaged only when the fragment changes
     /// the current tombstone (range tombstone change fragments).
@@ -185,11 +189,17 @@ class mutation_fragment_stream_validating_filter {
     sstring _name_storage;
     std::string_view _name_view; // always valid
     mutation_fragment_stream_validation_level _validation_level;
+    // Clustering fragments seen, for sampled_clustering_key
+    uint64_t _clustering_fragments = 0;
 
 private:
     mutation_fragment_stream_validating_filter(const char* name_literal, sstring name_value, const schema& s, mutation_fragment_stream_validation_level level);
 
 public:
+    /// With mutation_fragment_stream_validation_level::sampled_clustering_key,
+    /// the position of one in every this many clustering fragments is validated.
+    static constexpr uint64_t clustering_key_sample_interval = 16;
+
     /// Constructor.
     ///
     /// \arg name is used in log messages to identify the validator, the
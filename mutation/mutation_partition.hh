@@ -944,7 +944,9 @@ class rows_entry final : public evictable {
         // Marks a dummy entry which is after_all_clustered_rows() position.
         // Needed so that eviction, which can't use comparators, can check if it's dealing with it.
         bool _last_dummy : 1;
-        flags() : _before_ck(0), _after_ck(0), _continuous(true), _dummy(false), _last_dummy(false) { }
+        // Set while linked in the probationary segment of the cache LRU.
+        bool _on_probation : 1;
+        flags() : _before_ck(0), _after_ck(0), _continuous(true), _dummy(false), _last_dummy(false), _on_probation(false) { }
     } _flags{};
 public:
     struct last_dummy_tag {};
@@ -1068,6 +1070,11 @@ class rows_entry final : public evictable {
 
     void on_evicted(cache_tracker&) noexcept;
     void on_evicted() noexcept override;
+    bool set_on_probation(bool v) noexcept override {
+        _flags._on_probation = v;
+        return true;
+    }
+    bool on_probation() const noexcept override { return _flags._on_probation; }
 
     void compact(const schema&, tombstone);
 
@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <seastar/core/simple-stream.hh>
+#include <seastar/core/temporary_buffer.hh>
+
 #include "replica/database_fwd.hh"
 #include "bytes_ostream.hh"
 #include "mutation_fragment.hh"
@@ -33,6 +36,9 @@ class mutation_partition_serializer {
 public:
     void write(bytes_ostream&) const;
     void write(ser::writer_of_mutation_partition<bytes_ostream>&&) const;
+    // Used by commitlog_entry_writer to serialize a mutation directly into a segment buffer.
+    void write(ser::writer_of_mutation_partition<seastar::measuring_output_stream>&&) const;
+    void write(ser::writer_of_mutation_partition<seastar::memory_output_stream<std::vector<temporary_buffer<char>>::iterator>>&&) const;
 };
 
 void serialize_mutation_fragments(const schema& s, tombstone partition_tombstone,
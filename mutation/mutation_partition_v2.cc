@@ -196,6 +196,12 @@ stop_iteration mutation_partition_v2::apply_monotonically(const schema& s, const
     auto i = _rows.begin();
     rows_type::iterator lb_i; // iterator into _rows for previously inserted entry.
 
+    // Appends past the last row, typical for time series, don't need to look up
+    // where entries of p go. Same as what lower_bound() below would find.
+    if (p_i != p._rows.end() && !_rows.empty() && cmp(*std::prev(_rows.end()), *p_i) < 0) {
+        i = _rows.end();
+    }
+
     // When resuming, the predecessor of the sentinel may have been compacted.
     bool prev_compacted = true;
 
@@ -592,6 +592,11 @@ class partition_entry {
         return _snapshot && _snapshot->is_locked();
     }
 
+    // Tells whether any snapshot of the latest version is alive.
+    bool has_snapshot() const noexcept {
+        return _snapshot;
+    }
+
     // Strong exception guarantees.
     // Assumes this instance and mp are fully continuous.
     // Use only on non-evictable entries.
@@ -617,6 +622,14 @@ class partition_entry {
                const schema& mp_schema,
                mutation_application_stats& app_stats);
 
+    // Like the above, but consumes mp instead of copying it.
+    void apply(logalloc::region&,
+               mutation_cleaner&,
+               const schema& s,
+               mutation_partition&& mp,
+               const schema& mp_schema,
+               mutation_application_stats& app_stats);
+
     // Adds mutation_partition represented by "pe" to the one represented
     // by this entry.
     // This entry must be evictable.
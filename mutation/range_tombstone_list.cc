@@ -178,6 +178,38 @@ void range_tombstone_list::insert_from(const schema& s,
     rt.release();
 }
 
+std::optional<range_tombstone_list::range_tombstones_type::iterator>
+range_tombstone_list::find_gap(const schema& s, const range_tombstone& rt) {
+    position_in_partition::tri_compare cmp(s);
+    auto start = rt.position();
+    auto end = rt.end_position();
+
+    if (cmp(start, end) >= 0) {
+        return std::nullopt;
+    }
+
+    auto it = _tombstones.end();
+    if (!_tombstones.empty() && cmp(start, std::prev(it)->end_position()) < 0) {
+        it = _tombstones.upper_bound(start, [&cmp] (auto&& sb, auto&& e) {
+            return cmp(sb, e.end_position()) < 0;
+        });
+    }
+    // Here (it - 1)->end <= start < it->end, see insert_from().
+    if (it != _tombstones.begin()) {
+        auto prev = std::prev(it);
+        if (prev->tombstone().tomb == rt.tomb && cmp(prev->end_position(), start) == 0) {
+            return std::nullopt;
+        }
+    }
+    if (it != _tombstones.end()) {
+        auto c = cmp(end, it->position());
+        if (c > 0 || (c == 0 && it->tombstone().tomb == rt.tomb)) {
+            return std::nullopt;
+        }
+    }
+    return it;
+}
+
 range_tombstone_list::range_tombstones_type::iterator range_tombstone_list::find(const schema& s, const range_tombstone_entry& rt) {
     bound_view::compare less(s);
     auto it = _tombstones.find(rt, [less](auto&& rt1, auto&& rt2) {
@@ -434,9 +466,15 @@ stop_iteration range_tombstone_list::apply_monotonically(const schema& s, range_
     auto del = current_deleter<range_tombstone_entry>();
     auto it = list.begin();
     while (it != list.end()) {
-        // FIXME: Optimize by stealing the entry
-        apply_monotonically(s, it->tombstone());
-        it = list._tombstones.erase_and_dispose(it, del);
+        if (auto gap = find_gap(s, it->tombstone())) {
+            // Nothing to merge with, steal the entry. Both lists share the allocator.
+            auto& rt = *it;
+            it = list._tombstones.erase(it);
+            _tombstones.insert_before(*gap, rt);
+        } else {
+            apply_monotonically(s, it->tombstone());
+            it = list._tombstones.erase_and_dispose(it, del);
+        }
         if (preemptible && need_preempt()) {
             return stop_iteration::no;
         }
@@ -451,6 +489,13 @@ void range_tombstone_list::apply_monotonically(const schema& s, const range_tomb
 }
 
 void range_tombstone_list::apply_monotonically(const schema& s, const range_tombstone& rt) {
+    // The common case of many small, disjoint deletions doesn't touch existing entries,
+    // so it needs neither the general merge nor undo information.
+    if (auto gap = find_gap(s, rt)) {
+        auto e = construct_range_tombstone_entry(rt);
+        _tombstones.insert_before(*gap, *e.release());
+        return;
+    }
     // FIXME: Optimize given this has relaxed exception guarantees.
     // Note that apply() doesn't have monotonic guarantee because it doesn't restore erased entries.
     reverter rev(s, *this);
@@ -298,6 +298,10 @@ class range_tombstone_list final {
                      reverter& rev);
 
     range_tombstones_type::iterator find(const schema& s, const range_tombstone_entry& rt);
+
+    // If rt neither overlaps nor can be coalesced with any existing tombstone,
+    // returns the iterator before which it should be inserted as-is.
+    std::optional<range_tombstones_type::iterator> find_gap(const schema& s, const range_tombstone& rt);
 };
 
 template <>
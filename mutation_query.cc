@@ -10,9 +10,14 @@
 #include "gc_clock.hh"
 #include "mutation/mutation_partition_serializer.hh"
 #include "query-result-writer.hh"
+#include "utils/stall_free.hh"
 
 reconcilable_result::~reconcilable_result() {}
 
+future<> reconcilable_result::clear_gently() noexcept {
+    return utils::clear_gently(_partitions);
+}
+
 reconcilable_result::reconcilable_result()
     : _row_count_low_bits(0)
     , _row_count_high_bits(0)
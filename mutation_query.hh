@@ -57,6 +57,9 @@ struct partition {
         return _m;
     }
 
+    future<> clear_gently() noexcept {
+        return _m.clear_gently();
+    }
 
     bool operator==(const partition& other) const {
         return row_count() == other.row_count() && _m.representation() == other._m.representation();
@@ -106,6 +109,9 @@ class reconcilable_result {
         return _memory_tracker.used_memory();
     }
 
+    // Destroys the partitions, yielding between them.
+    future<> clear_gently() noexcept;
+
     bool operator==(const reconcilable_result& other) const;
 
     struct printer {
@@ -230,8 +230,108 @@ struct querier_utils {
     static void set_inactive_read_handle(querier_base& q, reader_concurrency_semaphore::inactive_read_handle h) noexcept {
         q._reader = std::move(h);
     }
+    static flat_mutation_reader_v2& reader(querier_base& q) noexcept {
+        return std::get<flat_mutation_reader_v2>(q._reader);
+    }
+    static bool is_inactive(const querier_base& q) noexcept {
+        return std::holds_alternative<reader_concurrency_semaphore::inactive_read_handle>(q._reader);
+    }
+    static lw_shared_ptr<shared_promise<>>& prefetch(querier_base& q) noexcept {
+        return q._prefetch;
+    }
 };
 
+static auto make_notify_handler(querier_cache::stats& stats, querier_cache::index& index, querier_cache::index::iterator it) {
+    return [&stats, &index, it] (reader_concurrency_semaphore::evict_reason reason) {
+        index.erase(it);
+        switch (reason) {
+            case reader_concurrency_semaphore::evict_reason::permit:
+                ++stats.resource_based_evictions;
+                break;
+            case reader_concurrency_semaphore::evict_reason::time:
+                ++stats.time_based_evictions;
+                break;
+            case reader_concurrency_semaphore::evict_reason::manual:
+                break;
+        }
+        --stats.population;
+    };
+}
+
+bool querier_cache::should_prefetch(reader_concurrency_semaphore& sem) const {
+    // A prefetching reader is active, so the semaphore cannot evict it to
+    // admit new reads. Only prefetch when nobody waits for admission and at
+    // least half of the semaphore's memory is free.
+    return _prefetch_enabled()
+        && _is_user_semaphore_func(sem)
+        && sem.get_stats().waiters == 0
+        && sem.available_resources().memory > sem.initial_resources().memory / 2;
+}
+
+void querier_cache::prefetch_querier(query_id key, querier_cache::index& index, querier&& q, std::chrono::seconds ttl) {
+    auto prefetch = make_lw_shared<shared_promise<>>();
+    auto it = index.emplace(key, std::make_unique<querier>(std::move(q)));
+    querier_utils::prefetch(*it->second) = prefetch;
+    ++_stats.population;
+    ++_stats.prefetches;
+
+    // The querier may be looked up (and moved out of the index) while the
+    // prefetch runs; the one still holding `prefetch` is the one we started.
+    auto find_entry = [&index, key, prefetch] {
+        auto [begin, end] = index.equal_range(key);
+        auto it = std::find_if(begin, end, [&] (const querier_cache::index::value_type& e) {
+            return querier_utils::prefetch(*e.second) == prefetch;
+        });
+        return it == end ? index.end() : it;
+    };
+
+    auto& reader = querier_utils::reader(*it->second);
+    (void)with_gate(_closing_gate, [this, &index, &reader, find_entry, prefetch, ttl] {
+        return reader.fill_buffer().then_wrapped([this, &index, find_entry, prefetch, ttl] (future<> f) {
+            auto it = find_entry();
+            if (it == index.end()) {
+                // Looked up already, the new owner waits for us.
+                if (f.failed()) {
+                    prefetch->set_exception(f.get_exception());
+                } else {
+                    prefetch->set_value();
+                }
+                return make_ready_future<>();
+            }
+
+            querier_utils::prefetch(*it->second) = nullptr;
+            prefetch->set_value();
+            if (f.failed()) {
+                qlogger.debug("Dropping querier after failing to prefetch: {}", f.get_exception());
+                auto q = std::move(it->second);
+                index.erase(it);
+                --_stats.population;
+                auto& q_ref = *q;
+                return q_ref.close().finally([q = std::move(q)] {});
+            }
+
+            auto& sem = it->second->permit().semaphore();
+            auto irh = sem.register_inactive_read(querier_utils::get_reader(*it->second));
+            if (!irh) {
+                index.erase(it);
+                --_stats.population;
+                ++_stats.resource_based_evictions;
+                return make_ready_future<>();
+            }
+            try {
+                sem.set_notify_handler(irh, make_notify_handler(_stats, index, it), ttl);
+                querier_utils::set_inactive_read_handle(*it->second, std::move(irh));
+            } catch (...) {
+                qlogger.warn("Failed to register prefetched querier: {}. Ignored as if it was evicted upon registration", std::current_exception());
+                sem.unregister_inactive_read(std::move(irh));
+                index.erase(it);
+                --_stats.population;
+            }
+            return make_ready_future<>();
+        });
+    });
+}
+
 template <typename Querier>
 void querier_cache::insert_querier(
         query_id key,
@@ -257,6 +357,14 @@ void querier_cache::insert_querier(
 
     auto& sem = q.permit().semaphore();
 
+    if constexpr (std::is_same_v<Querier, querier>) {
+        if (should_prefetch(sem)) {
+            tracing::trace(trace_state, "Prefetching the next page of querier with key {}", key);
+            prefetch_querier(key, index, std::move(q), ttl);
+            return;
+        }
+    }
+
     auto irh = sem.register_inactive_read(querier_utils::get_reader(q));
     if (!irh) {
         ++stats.resource_based_evictions;
@@ -275,22 +383,7 @@ void querier_cache::insert_querier(
         --stats.population;
     });
 
-    auto notify_handler = [&stats, &index, it] (reader_concurrency_semaphore::evict_reason reason) {
-        index.erase(it);
-        switch (reason) {
-            case reader_concurrency_semaphore::evict_reason::permit:
-                ++stats.resource_based_evictions;
-                break;
-            case reader_concurrency_semaphore::evict_reason::time:
-                ++stats.time_based_evictions;
-                break;
-            case reader_concurrency_semaphore::evict_reason::manual:
-                break;
-        }
-        --stats.population;
-    };
-
-    sem.set_notify_handler(irh, std::move(notify_handler), ttl);
+    sem.set_notify_handler(irh, make_notify_handler(stats, index, it), ttl);
     querier_utils::set_inactive_read_handle(*it->second, std::move(irh));
     cleanup_index.cancel();
     cleanup_irh.cancel();
@@ -338,12 +431,17 @@ std::optional<Querier> querier_cache::lookup_querier(
         throw std::runtime_error("lookup_querier(): found querier is not of the expected type");
     }
     auto& q = *q_ptr;
-    auto reader_opt = q.permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(q));
-    if (!reader_opt) {
-        throw std::runtime_error("lookup_querier(): found querier that is evicted");
+    if (querier_utils::is_inactive(q)) {
+        auto reader_opt = q.permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(q));
+        if (!reader_opt) {
+            throw std::runtime_error("lookup_querier(): found querier that is evicted");
+        }
+        reader_opt->set_timeout(timeout);
+        querier_utils::set_reader(q, std::move(*reader_opt));
+    } else {
+        // Still prefetching, the reader was not registered yet.
+        querier_utils::reader(q).set_timeout(timeout);
     }
-    reader_opt->set_timeout(timeout);
-    querier_utils::set_reader(q, std::move(*reader_opt));
     --stats.population;
 
     const auto can_be_used = can_be_used_for_page(_is_user_semaphore_func, q, s, ranges.front(), slice, current_sem);
@@ -423,7 +521,19 @@ std::optional<shard_mutation_querier> querier_cache::lookup_shard_mutation_queri
             std::move(trace_state), timeout);
 }
 
+future<> querier_base::wait_for_prefetch() noexcept {
+    if (!_prefetch) {
+        return make_ready_future<>();
+    }
+    return std::exchange(_prefetch, nullptr)->get_shared_future();
+}
+
 future<> querier_base::close() noexcept {
+    if (_prefetch) {
+        // The reader cannot be closed while it is still prefetching. Whether
+        // the prefetch succeeded doesn't matter anymore.
+        co_await wait_for_prefetch().handle_exception([] (std::exception_ptr) {});
+    }
     struct variant_closer {
         querier_base& q;
         future<> operator()(flat_mutation_reader_v2& reader) {
@@ -434,20 +544,27 @@ future<> querier_base::close() noexcept {
             return reader_opt ? reader_opt->close() : make_ready_future<>();
         }
     };
-    return std::visit(variant_closer{*this}, _reader);
+    co_await std::visit(variant_closer{*this}, _reader);
 }
 
 void querier_cache::set_entry_ttl(std::chrono::seconds entry_ttl) {
     _entry_ttl = entry_ttl;
 }
 
+void querier_cache::set_prefetch_enabled(utils::updateable_value<bool> enabled) {
+    _prefetch_enabled = std::move(enabled);
+}
+
 future<bool> querier_cache::evict_one() noexcept {
     for (auto ip : {&_data_querier_index, &_mutation_querier_index, &_shard_mutation_querier_index}) {
         auto& idx = *ip;
-        if (idx.empty()) {
+        // Queriers which are still prefetching are not evictable yet.
+        auto it = std::find_if(idx.begin(), idx.end(), [] (const querier_cache::index::value_type& e) {
+            return querier_utils::is_inactive(*e.second);
+        });
+        if (it == idx.end()) {
             continue;
         }
-        auto it = idx.begin();
         auto reader_opt = it->second->permit().semaphore().unregister_inactive_read(querier_utils::get_inactive_read_handle(*it->second));
         idx.erase(it);
         ++_stats.resource_based_evictions;
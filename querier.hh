@@ -8,12 +8,14 @@
 
 #pragma once
 
+#include <seastar/core/shared_future.hh>
 #include <seastar/util/closeable.hh>
 
 #include "mutation/mutation_compactor.hh"
 #include "reader_concurrency_semaphore.hh"
 #include "readers/mutation_source.hh"
 #include "full_position.hh"
+#include "utils/updateable_value.hh"
 
 #include <boost/intrusive/set.hpp>
 
@@ -69,6 +71,10 @@ class querier_base {
     std::variant<flat_mutation_reader_v2, reader_concurrency_semaphore::inactive_read_handle> _reader;
     dht::partition_ranges_view _query_ranges;
     querier_config _qr_config;
+    // Set while the reader prefetches the next page in the background, see
+    // querier_cache::set_prefetch_enabled(). The reader must not be used
+    // until the prefetch resolves, see wait_for_prefetch().
+    lw_shared_ptr<shared_promise<>> _prefetch;
 
 public:
     querier_base(reader_permit permit, lw_shared_ptr<const dht::partition_range> range,
@@ -120,6 +126,10 @@ class querier_base {
         return _permit.consumed_resources().memory;
     }
 
+    /// Wait for the background prefetch started when the querier was cached,
+    /// if any. Fails if the prefetch failed.
+    future<> wait_for_prefetch() noexcept;
+
     future<> close() noexcept;
 };
 
@@ -170,8 +180,10 @@ class querier : public querier_base {
             uint32_t partition_limit,
             gc_clock::time_point query_time,
             tracing::trace_state_ptr trace_ptr = {}) {
-        return ::query::consume_page(std::get<flat_mutation_reader_v2>(_reader), _compaction_state, *_slice, std::move(consumer), row_limit,
-                partition_limit, query_time).then_wrapped([this, trace_ptr = std::move(trace_ptr)] (auto&& fut) {
+        return wait_for_prefetch().then([this, consumer = std::move(consumer), row_limit, partition_limit, query_time] () mutable {
+            return ::query::consume_page(std::get<flat_mutation_reader_v2>(_reader), _compaction_state, *_slice, std::move(consumer), row_limit,
+                    partition_limit, query_time);
+        }).then_wrapped([this, trace_ptr = std::move(trace_ptr)] (auto&& fut) {
             const auto& cstats = _compaction_state->stats();
             tracing::trace(trace_ptr, "Page stats: {} partition(s), {} static row(s) ({} live, {} dead), {} clustering row(s) ({} live, {} dead) and {} range tombstone(s)",
                     cstats.partitions,
@@ -287,6 +299,13 @@ class shard_mutation_querier : public querier_base {
 /// Keeps the total memory consumption of cached queriers
 /// below max_queriers_memory_usage by evicting older entries upon inserting
 /// new ones if the the memory consupmtion would go above the limit.
+///
+/// When prefetching is enabled, data and mutation queriers inserted while
+/// their semaphore has plenty of spare memory fill their reader's buffer in
+/// the background before being registered as inactive reads, so the I/O for
+/// the next page overlaps with the round-trip to the client. Such queriers
+/// can be looked up while the prefetch is still running; they wait for it
+/// before reading (see querier_base::wait_for_prefetch()).
 class querier_cache {
 public:
     static const std::chrono::seconds default_entry_ttl;
@@ -311,6 +330,8 @@ class querier_cache {
         // The number of queries dropped due to scheduling group mismatch
         // between semaphores
         uint64_t scheduling_group_mismatches = 0;
+        // The subset of inserts that prefetched the next page in the background.
+        uint64_t prefetches = 0;
     };
 
     using index = std::unordered_multimap<query_id, std::unique_ptr<querier_base>>;
@@ -324,8 +345,13 @@ class querier_cache {
     stats _stats;
     gate _closing_gate;
     is_user_semaphore_func _is_user_semaphore_func;
+    utils::updateable_value<bool> _prefetch_enabled{false};
 
 private:
+    bool should_prefetch(reader_concurrency_semaphore& sem) const;
+
+    void prefetch_querier(query_id key, querier_cache::index& index, querier&& q, std::chrono::seconds ttl);
+
     template <typename Querier>
     void insert_querier(
             query_id key,
@@ -410,6 +436,10 @@ class querier_cache {
     /// Applies only to entries inserted after the change.
     void set_entry_ttl(std::chrono::seconds entry_ttl);
 
+    /// Enable or disable prefetching the next page of inserted data and
+    /// mutation queriers.
+    void set_prefetch_enabled(utils::updateable_value<bool> enabled);
+
     /// Evict a querier.
     ///
     /// Return true if a querier was evicted and false otherwise (if the cache
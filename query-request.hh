@@ -182,6 +182,10 @@ class partition_slice {
         // is a lot of dead rows. This flag is needed during rolling upgrades to support
         // old coordinators which do not tolerate pages with no live rows.
         allow_mutation_read_page_without_live_row,
+        // When set, replicas send the query::result of READ_DATA in the
+        // columnar encoding, see query-result-columnar.hh. Set by coordinators
+        // only when the whole cluster supports it.
+        columnar_result,
     };
     using option_set = enum_set<super_enum<option,
         option::send_clustering_key,
@@ -197,7 +201,8 @@ class partition_slice {
         option::bypass_cache,
         option::always_return_static_content,
         option::range_scan_data_variant,
-        option::allow_mutation_read_page_without_live_row>>;
+        option::allow_mutation_read_page_without_live_row,
+        option::columnar_result>>;
     clustering_row_ranges _row_ranges;
 public:
     column_id_vector static_columns; // TODO: consider using bitmap
@@ -286,6 +291,7 @@ enum class partition_limit : uint32_t { max = max_partitions };
 enum class tombstone_limit : uint64_t { max = max_tombstones };
 
 using is_first_page = bool_class<class is_first_page_tag>;
+using is_batch_workload = bool_class<class is_batch_workload_tag>;
 
 /*
  * This struct is used in two incompatible ways.
@@ -404,6 +410,9 @@ class read_command {
     uint32_t row_limit_high_bits;
     // Cut the page after processing this many tombstones (even if the page is empty).
     uint64_t tombstone_limit;
+    // Set for reads of sessions with the batch workload type. Replicas admit
+    // them behind other reads.
+    query::is_batch_workload batch_workload = query::is_batch_workload::no;
     api::timestamp_type read_timestamp; // not serialized
     db::allow_per_partition_rate_limit allow_limit; // not serialized
 public:
@@ -419,7 +428,8 @@ class read_command {
                  query::is_first_page is_first_page,
                  std::optional<query::max_result_size> max_result_size,
                  uint32_t row_limit_high_bits,
-                 uint64_t tombstone_limit)
+                 uint64_t tombstone_limit,
+                 query::is_batch_workload batch_workload = query::is_batch_workload::no)
         : cf_id(std::move(cf_id))
         , schema_version(std::move(schema_version))
         , slice(std::move(slice))
@@ -432,6 +442,7 @@ class read_command {
         , max_result_size(max_result_size)
         , row_limit_high_bits(row_limit_high_bits)
         , tombstone_limit(tombstone_limit)
+        , batch_workload(batch_workload)
         , read_timestamp(api::new_timestamp())
         , allow_limit(db::allow_per_partition_rate_limit::no)
     { }
@@ -499,6 +510,9 @@ struct forward_request {
     db::consistency_level cl;
     lowres_system_clock::time_point timeout;
     std::optional<std::vector<aggregation_info>> aggregation_infos;
+    // Names of the GROUP BY columns, in GROUP BY order. When set, the
+    // request is aggregated per group and the result is in forward_result::groups.
+    std::optional<std::vector<sstring>> group_by_column_names;
 };
 
 std::ostream& operator<<(std::ostream& out, const forward_request& r);
@@ -506,8 +520,19 @@ std::ostream& operator<<(std::ostream& out, const forward_request::reduction_typ
 std::ostream& operator<<(std::ostream& out, const forward_request::aggregation_info& a);
 
 struct forward_result {
+    // Result of aggregating a single GROUP BY group.
+    struct group {
+        // Values of the GROUP BY columns identifying the group.
+        std::vector<bytes_opt> key;
+        // Query result for each selected column, as in forward_result::query_results.
+        std::vector<bytes_opt> query_results;
+    };
+
     // vector storing query result for each selected column
     std::vector<bytes_opt> query_results;
+    // Per-group results of a request with GROUP BY columns; query_results
+    // is unused in that case.
+    std::vector<group> groups;
 
     struct printer {
         const std::vector<::shared_ptr<db::functions::aggregate_function>> functions;
@@ -0,0 +1,479 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <unordered_map>
+
+#include <fmt/format.h>
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+
+#include "query-result-columnar.hh"
+#include "query-result-reader.hh"
+#include "query-result-writer.hh"
+#include "utils/chunked_vector.hh"
+#include "idl/keys.dist.hh"
+#include "idl/keys.dist.impl.hh"
+
+namespace query {
+
+namespace {
+
+enum column_flags : uint8_t {
+    has_timestamps = 1 << 0,
+    has_expiries = 1 << 1,
+    has_ttls = 1 << 2,
+    dictionary_encoded = 1 << 3,
+};
+
+class bitmap_builder {
+    std::vector<int8_t> _bits;
+    size_t _size = 0;
+public:
+    void push_back(bool bit) {
+        if (_size % 8 == 0) {
+            _bits.push_back(0);
+        }
+        if (bit) {
+            _bits.back() |= 1 << (_size % 8);
+        }
+        ++_size;
+    }
+    void write(bytes_ostream& out) const {
+        ser::serialize(out, bytes_view(_bits.data(), _bits.size()));
+    }
+};
+
+bytes read_bitmap(utils::input_stream& in, size_t size) {
+    bytes bits = ser::deserialize(in, boost::type<bytes>());
+    if (bits.size() != (size + 7) / 8) {
+        throw std::runtime_error(fmt::format("Malformed columnar query result: bitmap of {} bytes for {} bits", bits.size(), size));
+    }
+    return bits;
+}
+
+bool test_bit(const bytes& bits, size_t i) {
+    return bits[i / 8] & (1 << (i % 8));
+}
+
+// An optional attribute of the cells of a column: a bitmap with a bit for
+// every cell and the values of the cells which have the attribute.
+template <typename T>
+class optional_attribute_encoder {
+    bitmap_builder _present;
+    utils::chunked_vector<T> _values;
+public:
+    void push_back(std::optional<T> value) {
+        _present.push_back(bool(value));
+        if (value) {
+            _values.push_back(*value);
+        }
+    }
+    bool empty() const {
+        return _values.empty();
+    }
+    void write(bytes_ostream& out) const {
+        _present.write(out);
+        for (const auto& v : _values) {
+            ser::serialize(out, v);
+        }
+    }
+};
+
+template <typename T>
+class optional_attribute_decoder {
+    bytes _present;
+    utils::chunked_vector<T> _values;
+    size_t _next = 0;
+public:
+    optional_attribute_decoder() = default;
+    optional_attribute_decoder(utils::input_stream& in, size_t cells)
+        : _present(read_bitmap(in, cells))
+    {
+        for (size_t i = 0; i < cells; ++i) {
+            if (test_bit(_present, i)) {
+                _values.push_back(ser::deserialize(in, boost::type<T>()));
+            }
+        }
+    }
+    // Cells have to be visited in order.
+    std::optional<T> get(size_t cell) {
+        if (_present.empty() || !test_bit(_present, cell)) {
+            return std::nullopt;
+        }
+        return _values[_next++];
+    }
+};
+
+struct managed_bytes_view_equal {
+    bool operator()(managed_bytes_view a, managed_bytes_view b) const {
+        return equal_unsigned(a, b);
+    }
+};
+
+class column_encoder {
+    bitmap_builder _present;
+    optional_attribute_encoder<api::timestamp_type> _timestamps;
+    optional_attribute_encoder<gc_clock::time_point> _expiries;
+    optional_attribute_encoder<gc_clock::duration> _ttls;
+    bytes_ostream _data;
+    utils::chunked_vector<uint32_t> _lengths;
+private:
+    // Writes the lengths of the values, followed by their data as a single bytes.
+    static future<> write_values(bytes_ostream& out, const utils::chunked_vector<managed_bytes_view>& values, size_t data_size) {
+        for (auto v : values) {
+            ser::serialize(out, uint32_t(v.size()));
+            co_await coroutine::maybe_yield();
+        }
+        ser::serialize(out, uint32_t(data_size));
+        for (auto v : values) {
+            for (bytes_view frag : fragment_range(v)) {
+                out.write(frag);
+            }
+            co_await coroutine::maybe_yield();
+        }
+    }
+public:
+    void push_back(const std::optional<ser::qr_cell_view>& cell) {
+        _present.push_back(bool(cell));
+        if (!cell) {
+            return;
+        }
+        _timestamps.push_back(cell->timestamp());
+        _expiries.push_back(cell->expiry());
+        _ttls.push_back(cell->ttl());
+        auto value = cell->value().view();
+        for (bytes_view frag : value) {
+            _data.write(frag);
+        }
+        _lengths.push_back(value.size_bytes());
+    }
+
+    future<> write(bytes_ostream& out) && {
+        // The values stay fragmented, so large cells don't need contiguous memory.
+        auto data = std::move(_data).to_managed_bytes();
+        utils::chunked_vector<managed_bytes_view> values;
+        values.reserve(_lengths.size());
+        managed_bytes_view rest(data);
+        for (auto length : _lengths) {
+            values.push_back(rest.prefix(length));
+            rest.remove_prefix(length);
+            co_await coroutine::maybe_yield();
+        }
+
+        std::unordered_map<managed_bytes_view, uint32_t, std::hash<managed_bytes_view>, managed_bytes_view_equal> dictionary;
+        utils::chunked_vector<managed_bytes_view> entries;
+        utils::chunked_vector<uint32_t> indices;
+        indices.reserve(values.size());
+        size_t entries_size = 0;
+        for (auto v : values) {
+            auto [it, inserted] = dictionary.emplace(v, entries.size());
+            if (inserted) {
+                entries.push_back(v);
+                entries_size += v.size();
+            }
+            indices.push_back(it->second);
+            co_await coroutine::maybe_yield();
+        }
+        const uint8_t index_width = entries.size() <= std::numeric_limits<uint8_t>::max() + 1 ? 1
+                : entries.size() <= std::numeric_limits<uint16_t>::max() + 1 ? 2 : 4;
+        const size_t plain_size = values.size() * sizeof(uint32_t) + data.size();
+        const size_t dictionary_size = sizeof(uint32_t) + entries.size() * sizeof(uint32_t) + entries_size + 1 + values.size() * index_width;
+        const bool use_dictionary = dictionary_size < plain_size;
+
+        _present.write(out);
+        uint8_t flags = (_timestamps.empty() ? 0 : has_timestamps)
+                | (_expiries.empty() ? 0 : has_expiries)
+                | (_ttls.empty() ? 0 : has_ttls)
+                | (use_dictionary ? dictionary_encoded : 0);
+        ser::serialize(out, flags);
+        if (flags & has_timestamps) {
+            _timestamps.write(out);
+        }
+        if (flags & has_expiries) {
+            _expiries.write(out);
+        }
+        if (flags & has_ttls) {
+            _ttls.write(out);
+        }
+        if (!use_dictionary) {
+            co_await write_values(out, values, data.size());
+            co_return;
+        }
+        ser::serialize(out, uint32_t(entries.size()));
+        co_await write_values(out, entries, entries_size);
+        ser::serialize(out, index_width);
+        for (auto i : indices) {
+            switch (index_width) {
+            case 1: ser::serialize(out, uint8_t(i)); break;
+            case 2: ser::serialize(out, uint16_t(i)); break;
+            default: ser::serialize(out, i); break;
+            }
+            co_await coroutine::maybe_yield();
+        }
+    }
+};
+
+class column_decoder {
+    bytes _present;
+    size_t _next_slot = 0;
+    size_t _next_cell = 0;
+    optional_attribute_decoder<api::timestamp_type> _timestamps;
+    optional_attribute_decoder<gc_clock::time_point> _expiries;
+    optional_attribute_decoder<gc_clock::duration> _ttls;
+    // The data of the values, kept fragmented.
+    managed_bytes _data;
+    utils::chunked_vector<managed_bytes_view> _values;
+    // Indices of the values of the cells, if dictionary encoded.
+    utils::chunked_vector<uint32_t> _indices;
+private:
+    future<> read_values(utils::input_stream& in, size_t count) {
+        utils::chunked_vector<uint32_t> lengths;
+        lengths.reserve(count);
+        size_t size = 0;
+        for (size_t i = 0; i < count; ++i) {
+            lengths.push_back(ser::deserialize(in, boost::type<uint32_t>()));
+            size += lengths.back();
+            co_await coroutine::maybe_yield();
+        }
+        managed_bytes data = ser::deserialize(in, boost::type<bytes>());
+        _data = std::move(data);
+        if (_data.size() != size) {
+            throw std::runtime_error(fmt::format("Malformed columnar query result: {} bytes of data for values of {} bytes", _data.size(), size));
+        }
+        _values.reserve(count);
+        managed_bytes_view rest(_data);
+        for (auto length : lengths) {
+            _values.push_back(rest.prefix(length));
+            rest.remove_prefix(length);
+            co_await coroutine::maybe_yield();
+        }
+    }
+    managed_bytes_view value(size_t cell) const {
+        auto i = _indices.empty() ? cell : _indices[cell];
+        if (i >= _values.size()) {
+            throw std::runtime_error(fmt::format("Malformed columnar query result: value {} out of {}", i, _values.size()));
+        }
+        return _values[i];
+    }
+public:
+    future<> read(utils::input_stream& in, size_t slots) {
+        _present = read_bitmap(in, slots);
+        size_t cells = 0;
+        for (size_t i = 0; i < slots; ++i) {
+            cells += test_bit(_present, i);
+        }
+        auto flags = ser::deserialize(in, boost::type<uint8_t>());
+        if (flags & has_timestamps) {
+            _timestamps = optional_attribute_decoder<api::timestamp_type>(in, cells);
+        }
+        if (flags & has_expiries) {
+            _expiries = optional_attribute_decoder<gc_clock::time_point>(in, cells);
+        }
+        if (flags & has_ttls) {
+            _ttls = optional_attribute_decoder<gc_clock::duration>(in, cells);
+        }
+        if (!(flags & dictionary_encoded)) {
+            co_await read_values(in, cells);
+            co_return;
+        }
+        co_await read_values(in, ser::deserialize(in, boost::type<uint32_t>()));
+        auto index_width = ser::deserialize(in, boost::type<uint8_t>());
+        _indices.reserve(cells);
+        for (size_t i = 0; i < cells; ++i) {
+            switch (index_width) {
+            case 1: _indices.push_back(ser::deserialize(in, boost::type<uint8_t>())); break;
+            case 2: _indices.push_back(ser::deserialize(in, boost::type<uint16_t>())); break;
+            case 4: _indices.push_back(ser::deserialize(in, boost::type<uint32_t>())); break;
+            default:
+                throw std::runtime_error(fmt::format("Malformed columnar query result: dictionary index width {}", index_width));
+            }
+            co_await coroutine::maybe_yield();
+        }
+    }
+
+    // Writes the cell of the next slot of the column.
+    template <typename CellsWriter>
+    void write_next(CellsWriter& w) {
+        if (!test_bit(_present, _next_slot++)) {
+            w.add().skip();
+            return;
+        }
+        auto cell = _next_cell++;
+        auto timestamp = _timestamps.get(cell);
+        auto expiry = _expiries.get(cell);
+        auto ttl = _ttls.get(cell);
+        auto wr = w.add().write();
+        auto after_timestamp = [&, wr = std::move(wr)] () mutable {
+            if (timestamp) {
+                return std::move(wr).write_timestamp(*timestamp);
+            } else {
+                return std::move(wr).skip_timestamp();
+            }
+        }();
+        auto after_value = [&, wr = std::move(after_timestamp)] () mutable {
+            if (expiry) {
+                return std::move(wr).write_expiry(*expiry);
+            } else {
+                return std::move(wr).skip_expiry();
+            }
+        }().write_fragmented_value(fragment_range(value(cell)));
+        [&, wr = std::move(after_value)] () mutable {
+            if (ttl) {
+                return std::move(wr).write_ttl(*ttl);
+            } else {
+                return std::move(wr).skip_ttl();
+            }
+        }().end_qr_cell();
+    }
+};
+
+template <typename Columns>
+void check_column_count(const Columns& columns, size_t count) {
+    if (columns.size() != count) {
+        throw std::runtime_error(fmt::format("Cannot encode query result with rows of {} and {} cells in columnar layout", columns.size(), count));
+    }
+}
+
+}
+
+future<result> encode_columnar(const result& res) {
+    auto v = ser::query_result_view{ser::as_input_stream(res.buf())};
+
+    bytes_ostream keys;
+    std::optional<std::vector<column_encoder>> static_columns;
+    std::optional<std::vector<column_encoder>> regular_columns;
+    uint32_t partition_count = 0;
+    utils::chunked_vector<std::optional<clustering_key>> clustering_keys;
+
+    for (auto&& p : v.partitions()) {
+        ++partition_count;
+        auto rows = p.rows();
+        ser::serialize(keys, p.key());
+        ser::serialize(keys, uint32_t(rows.size()));
+
+        auto static_cells = p.static_row().cells();
+        if (!static_columns) {
+            static_columns.emplace(static_cells.size());
+        }
+        check_column_count(*static_columns, static_cells.size());
+        auto sc = static_columns->begin();
+        for (auto&& cell : static_cells) {
+            (sc++)->push_back(cell);
+        }
+        co_await coroutine::maybe_yield();
+
+        for (auto&& row : rows) {
+            clustering_keys.push_back(row.key());
+            auto cells = row.cells().cells();
+            if (!regular_columns) {
+                regular_columns.emplace(cells.size());
+            }
+            check_column_count(*regular_columns, cells.size());
+            auto rc = regular_columns->begin();
+            for (auto&& cell : cells) {
+                (rc++)->push_back(cell);
+            }
+            co_await coroutine::maybe_yield();
+        }
+    }
+
+    bytes_ostream out;
+    ser::serialize(out, partition_count);
+    ser::serialize(out, uint32_t(static_columns ? static_columns->size() : 0));
+    ser::serialize(out, uint32_t(regular_columns ? regular_columns->size() : 0));
+    out.append(keys);
+    for (const auto& ck : clustering_keys) {
+        ser::serialize(out, ck);
+        co_await coroutine::maybe_yield();
+    }
+    for (auto* columns : {&static_columns, &regular_columns}) {
+        if (*columns) {
+            for (auto& c : **columns) {
+                co_await std::move(c).write(out);
+            }
+        }
+    }
+
+    co_return result(std::move(out), res.digest(), res.last_modified(), res.is_short_read(),
+            res.row_count_low_bits(), res.partition_count(), res.row_count_high_bits(), res.last_position());
+}
+
+future<result> decode_columnar(const result& res) {
+    auto in = ser::as_input_stream(res.buf());
+
+    auto partition_count = ser::deserialize(in, boost::type<uint32_t>());
+    auto static_column_count = ser::deserialize(in, boost::type<uint32_t>());
+    auto regular_column_count = ser::deserialize(in, boost::type<uint32_t>());
+
+    struct partition_header {
+        std::optional<partition_key> key;
+        uint32_t row_count;
+    };
+    utils::chunked_vector<partition_header> partitions;
+    partitions.reserve(partition_count);
+    uint64_t row_count = 0;
+    for (uint32_t i = 0; i < partition_count; ++i) {
+        auto key = ser::deserialize(in, boost::type<std::optional<partition_key>>());
+        auto rows = ser::deserialize(in, boost::type<uint32_t>());
+        partitions.push_back(partition_header{std::move(key), rows});
+        row_count += rows;
+        co_await coroutine::maybe_yield();
+    }
+    utils::chunked_vector<std::optional<clustering_key>> clustering_keys;
+    clustering_keys.reserve(row_count);
+    for (uint64_t i = 0; i < row_count; ++i) {
+        clustering_keys.push_back(ser::deserialize(in, boost::type<std::optional<clustering_key>>()));
+        co_await coroutine::maybe_yield();
+    }
+    std::vector<column_decoder> static_columns(static_column_count);
+    for (auto& c : static_columns) {
+        co_await c.read(in, partition_count);
+    }
+    std::vector<column_decoder> regular_columns(regular_column_count);
+    for (auto& c : regular_columns) {
+        co_await c.read(in, row_count);
+    }
+
+    bytes_ostream out;
+    auto pw = ser::writer_of_query_result<bytes_ostream>(out).start_partitions();
+    auto ck = clustering_keys.begin();
+    for (auto& p : partitions) {
+        auto w = pw.add();
+        auto static_cells_wr = (p.key ? std::move(w).write_key(*p.key) : std::move(w).skip_key())
+                .start_static_row()
+                .start_cells();
+        for (auto& c : static_columns) {
+            c.write_next(static_cells_wr);
+        }
+        auto rows_wr = std::move(static_cells_wr)
+                .end_cells()
+                .end_static_row()
+                .start_rows();
+        for (uint32_t i = 0; i < p.row_count; ++i, ++ck) {
+            auto cells_wr = [&] {
+                if (*ck) {
+                    return rows_wr.add().write_key(**ck).start_cells().start_cells();
+                } else {
+                    return rows_wr.add().skip_key().start_cells().start_cells();
+                }
+            }();
+            for (auto& c : regular_columns) {
+                c.write_next(cells_wr);
+            }
+            std::move(cells_wr).end_cells().end_cells().end_qr_clustered_row();
+            co_await coroutine::maybe_yield();
+        }
+        std::move(rows_wr).end_rows().end_qr_partition();
+    }
+    std::move(pw).end_partitions().end_query_result();
+
+    co_return result(std::move(out), res.digest(), res.last_modified(), res.is_short_read(),
+            res.row_count_low_bits(), res.partition_count(), res.row_count_high_bits(), res.last_position());
+}
+
+}
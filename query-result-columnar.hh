@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/future.hh>
+
+#include "query-result.hh"
+
+namespace query {
+
+// Column oriented encoding of the buffer of a query::result.
+//
+// The regular encoding (see query-result-writer.hh) is row oriented: every
+// cell is a framed qr_cell with its own optional timestamp, expiry and ttl
+// markers. For pages of wide scans most of that is redundant, so replicas
+// send pages of read commands with partition_slice::option::columnar_result
+// set in the following layout instead:
+//
+//   uint32 partition_count, uint32 static_column_count, uint32 regular_column_count
+//   partition_count x { optional<partition_key>, uint32 row_count }
+//   sum(row_count) x optional<clustering_key>
+//   static_column_count x column, with one slot per partition
+//   regular_column_count x column, with one slot per clustering row
+//
+//   column:
+//     bytes presence   - bitmap of the slots which have a live cell
+//     uint8 flags      - which of the optional blocks below are present
+//     [bytes bitmap, int64 x set bits]    - timestamps of the cells
+//     [bytes bitmap, expiry x set bits]   - expiries of the cells
+//     [bytes bitmap, ttl x set bits]      - ttls of the cells
+//     values           - either plain or dictionary encoded:
+//       plain:      cells x uint32 length, bytes data
+//       dictionary: uint32 entries, entries x uint32 length, bytes data,
+//                   uint8 index width, cells x index
+//
+// Bitmaps of the optional blocks have one bit per live cell of the column.
+// The dictionary encoding is picked for a column when it is smaller than
+// the plain one, i.e. when the column has many repeated values.
+//
+// The encoding only replaces the buffer, all other fields (digest, counts,
+// last position) are carried over unchanged. Coordinators decode the buffer
+// back to the row oriented layout as soon as they receive it, so consumers
+// of query::result never see the columnar one.
+//
+// Values are kept fragmented both ways, and the conversions yield, so large
+// pages and large cells neither need contiguous memory nor stall the reactor.
+// res has to be kept alive until the returned future resolves.
+
+// Returns a copy of res with the buffer in the columnar encoding.
+future<result> encode_columnar(const result& res);
+
+// Returns a copy of res, whose buffer is in the columnar encoding, with
+// the buffer in the row oriented encoding.
+// The returned future fails with std::runtime_error if the buffer is malformed.
+future<result> decode_columnar(const result& res);
+
+}
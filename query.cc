@@ -55,8 +55,8 @@ std::ostream& operator<<(std::ostream& out, const partition_slice& ps) {
 }
 
 std::ostream& operator<<(std::ostream& out, const read_command& r) {
-    fmt::print(out, "read_command{{cf_id={}, version={}, slice={}, limit={}, timestamp={}, partition_limit={}, query_uuid={}, is_first_page={}, read_timestamp={}}}",
-               r.cf_id, r.schema_version, r.slice, r.get_row_limit(), r.timestamp.time_since_epoch().count(), r.partition_limit, r.query_uuid, r.is_first_page, r.read_timestamp);
+    fmt::print(out, "read_command{{cf_id={}, version={}, slice={}, limit={}, timestamp={}, partition_limit={}, query_uuid={}, is_first_page={}, batch_workload={}, read_timestamp={}}}",
+               r.cf_id, r.schema_version, r.slice, r.get_row_limit(), r.timestamp.time_since_epoch().count(), r.partition_limit, r.query_uuid, r.is_first_page, r.batch_workload, r.read_timestamp);
     return out;
 }
 
@@ -87,6 +87,10 @@ std::ostream& operator<<(std::ostream& out, const forward_request& r) {
         fmt::print(out, ", aggregation_infos=[{}]",
                    fmt::join(r.aggregation_infos.value(), ","));
     }
+    if (r.group_by_column_names) {
+        fmt::print(out, ", group_by=[{}]",
+                   fmt::join(r.group_by_column_names.value(), ","));
+    }
     fmt::print(out, "cmd={}, pr={}, cl={}, timeout(ms)={}}}",
                r.cmd, r.pr, r.cl, ms);
     return out;
@@ -406,6 +410,9 @@ foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
 }
 
 std::ostream& operator<<(std::ostream& out, const query::forward_result::printer& p) {
+    if (!p.res.groups.empty()) {
+        return out << "[" << p.res.groups.size() << " groups]";
+    }
     if (p.functions.size() != p.res.query_results.size()) {
         return out << "[malformed forward_result (" << p.res.query_results.size()
             << " results, " << p.functions.size() << " aggregates)]";
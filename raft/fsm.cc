@@ -414,6 +414,20 @@ void fsm::advance_stable_idx(index_t idx) {
     index_t prev_stable_idx = _log.stable_idx();
     _log.stable_to(idx);
     logger.trace("advance_stable_idx[{}]: prev_stable_idx={}, idx={}", _my_id, prev_stable_idx, idx);
+    if (!_config.accept_own_entries_on_persist) {
+        accept_own_entries(idx);
+    }
+}
+
+void fsm::log_entries_persisted(term_t term, index_t idx) {
+    // A leader of a later term has appended a dummy entry of its
+    // own, which accepts the earlier ones once persisted.
+    if (_config.accept_own_entries_on_persist && term == _current_term) {
+        accept_own_entries(idx);
+    }
+}
+
+void fsm::accept_own_entries(index_t idx) {
     if (is_leader()) {
         auto leader_progress = leader_state().tracker.find(_my_id);
         if (leader_progress) {
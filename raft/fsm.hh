@@ -62,6 +62,10 @@ struct fsm_config {
     size_t max_log_size;
     // If set to true will enable prevoting stage during election
     bool enable_prevoting;
+    // If set to true, a leader counts its own entries as accepted
+    // only once log_entries_persisted() reports them stored, rather
+    // than as soon as they are handed out in FSM output
+    bool accept_own_entries_on_persist = false;
 };
 
 class fsm;
@@ -288,6 +292,9 @@ class fsm {
     // Called after log entries in FSM output are considered persisted.
     // Produces new FSM output.
     void advance_stable_idx(index_t idx);
+    // Called on a leader once its own log is persisted up to idx.
+    // May commit new entries.
+    void accept_own_entries(index_t idx);
     // Tick implementation on a leader
     void tick_leader();
 
@@ -427,6 +434,12 @@ class fsm {
     // in the same state in that case
     fsm_output get_output();
 
+    // Called once the log entries of an FSM output, the last of
+    // which has the given term and index, are persisted. Only has
+    // an effect with fsm_config::accept_own_entries_on_persist set,
+    // in which case a leader in the same term may now commit them.
+    void log_entries_persisted(term_t term, index_t idx);
+
     // Called to advance virtual clock of the protocol state machine.
     void tick();
 
@@ -14,6 +14,7 @@
 #include <boost/range/algorithm/copy.hpp>
 #include <boost/range/join.hpp>
 #include <map>
+#include <algorithm>
 #include <seastar/core/sleep.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/shared_future.hh>
@@ -156,6 +157,7 @@ class server_impl : public rpc_server, public server {
         uint64_t sm_load_snapshot = 0;
         uint64_t truncate_persisted_log = 0;
         uint64_t persisted_log_entries = 0;
+        uint64_t messages_sent_before_persisting = 0;
         uint64_t queue_entries_for_apply = 0;
         uint64_t applied_entries = 0;
         uint64_t snapshots_taken = 0;
@@ -342,7 +344,8 @@ future<> server_impl::start() {
                                  fsm_config {
                                      .append_request_threshold = _config.append_request_threshold,
                                      .max_log_size = _config.max_log_size,
-                                     .enable_prevoting = _config.enable_prevoting
+                                     .enable_prevoting = _config.enable_prevoting,
+                                     .accept_own_entries_on_persist = true
                                  });
 
     _applied_idx = index_t{0};
@@ -1005,6 +1008,47 @@ future<> server_impl::io_fiber(index_t last_stable) {
                 _state_machine->drop_snapshot(snp_id);
             }
 
+            // Update RPC server address mappings. Add servers which are joining
+            // the cluster according to the new configuration (obtained from the
+            // last_conf_idx).
+            //
+            // It should be done prior to sending the messages since the RPC
+            // module needs to know who should it send the messages to (actual
+            // network addresses of the joining servers).
+            rpc_config_diff rpc_diff;
+            if (batch.configuration) {
+                rpc_diff = diff_address_sets(get_rpc_config(), *batch.configuration);
+                for (const auto& addr: rpc_diff.joining) {
+                    add_to_rpc_config(addr);
+                }
+                _rpc->on_configuration_change(rpc_diff.joining, {});
+            }
+
+            auto send_messages = [&] {
+                for (auto&& m : batch.messages) {
+                    try {
+                        send_message(m.first, std::move(m.second));
+                    } catch(...) {
+                        // Not being able to send a message is not a critical error
+                        logger.debug("[{}] io_fiber failed to send a message to {}: {}", _id, m.first, std::current_exception());
+                    }
+                }
+            };
+            // Only append replies acknowledge that entries are persisted
+            // locally, so the other messages, e.g. a leader's append
+            // requests, may be sent while the entries are being persisted
+            // (see section 10.2.1 of the Raft thesis). The leader counts
+            // its own entries as accepted only once they are stored (see
+            // log_entries_persisted() below), so followers' acks received
+            // meanwhile can't commit them without a quorum of their own.
+            bool send_while_persisting = batch.log_entries.size() && std::ranges::none_of(batch.messages, [] (const auto& m) {
+                return std::holds_alternative<append_reply>(m.second);
+            });
+            if (send_while_persisting) {
+                send_messages();
+                _stats.messages_sent_before_persisting += batch.messages.size();
+            }
+
             if (batch.log_entries.size()) {
                 auto& entries = batch.log_entries;
 
@@ -1022,32 +1066,12 @@ future<> server_impl::io_fiber(index_t last_stable) {
 
                 last_stable = (*entries.crbegin())->idx;
                 _stats.persisted_log_entries += entries.size();
+                _fsm->log_entries_persisted((*entries.crbegin())->term, last_stable);
             }
 
-            // Update RPC server address mappings. Add servers which are joining
-            // the cluster according to the new configuration (obtained from the
-            // last_conf_idx).
-            //
-            // It should be done prior to sending the messages since the RPC
-            // module needs to know who should it send the messages to (actual
-            // network addresses of the joining servers).
-            rpc_config_diff rpc_diff;
-            if (batch.configuration) {
-                rpc_diff = diff_address_sets(get_rpc_config(), *batch.configuration);
-                for (const auto& addr: rpc_diff.joining) {
-                    add_to_rpc_config(addr);
-                }
-                _rpc->on_configuration_change(rpc_diff.joining, {});
-            }
-
-             // After entries are persisted we can send messages.
-            for (auto&& m : batch.messages) {
-                try {
-                    send_message(m.first, std::move(m.second));
-                } catch(...) {
-                    // Not being able to send a message is not a critical error
-                    logger.debug("[{}] io_fiber failed to send a message to {}: {}", _id, m.first, std::current_exception());
-                }
+            if (!send_while_persisting) {
+                // After entries are persisted we can send messages.
+                send_messages();
             }
 
             if (batch.configuration) {
@@ -1605,6 +1629,8 @@ void server_impl::register_metrics() {
              sm::description("how many times log was truncated on storage"), {server_id_label(_id)}),
         sm::make_total_operations("persisted_log_entries", _stats.persisted_log_entries,
              sm::description("how many log entries were persisted"), {server_id_label(_id)}),
+        sm::make_total_operations("messages_sent_before_persisting", _stats.messages_sent_before_persisting,
+             sm::description("how many messages were sent while the log entries of their batch were being persisted"), {server_id_label(_id)}),
         sm::make_total_operations("queue_entries_for_apply", _stats.queue_entries_for_apply,
              sm::description("how many log entries were queued to be applied"), {server_id_label(_id)}),
         sm::make_total_operations("applied_entries", _stats.applied_entries,
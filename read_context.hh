@@ -192,6 +192,9 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     tracing::trace_state_ptr trace_state() const { return _trace_state; }
     mutation_reader::forwarding fwd_mr() const { return _fwd_mr; }
     bool is_range_query() const { return _range_query; }
+    // Rows populated by range scans are inserted on probation, if enabled,
+    // so that scans don't push the hot working set out of cache.
+    bool populate_on_probation() const { return _range_query && _cache._tracker.scans_on_probation(); }
     autoupdating_underlying_reader& underlying() { return _underlying; }
     row_cache::phase_type phase() const { return _phase; }
     const dht::decorated_key& key() const { return *_key; }
@@ -145,6 +145,8 @@ class reader_permit::impl
         // Must be cleared on all code-paths, otherwise it will keep the permit alive in perpetuity.
         reader_permit_opt permit_keepalive;
         std::optional<reader_concurrency_semaphore::inactive_read> ir;
+        // When the permit was queued for admission.
+        std::chrono::steady_clock::time_point enqueued_at;
     };
 
 private:
@@ -166,7 +168,14 @@ class reader_permit::impl
     uint64_t _sstables_read = 0;
     size_t _requested_memory = 0;
     uint64_t _oom_kills = 0;
+    // The cost of the read so far, possibly over several pages, reported
+    // to tracing when the permit is destroyed.
+    uint64_t _sstables_read_total = 0;
+    std::chrono::steady_clock::duration _admission_queue_time{};
+    ssize_t _max_memory = 0;
     tracing::trace_state_ptr _trace_ptr;
+    reader_concurrency_semaphore::low_priority _low_priority = reader_concurrency_semaphore::low_priority::no;
+    std::chrono::steady_clock::time_point _created_at = std::chrono::steady_clock::now();
 
     // Not strictly related to the permit.
     // Used by the semaphore to to manage the permit.
@@ -294,6 +303,14 @@ class reader_permit::impl
         _semaphore._stats.sstables_read -= _sstables_read;
         _semaphore._stats.disk_reads -= bool(_sstables_read);
 
+        if (_trace_ptr) {
+            tracing::trace(_trace_ptr, "Reader permit {} cost: queued for admission {} us, read {} sstables, used at most {} bytes of memory",
+                    description(),
+                    std::chrono::duration_cast<std::chrono::microseconds>(_admission_queue_time).count(),
+                    _sstables_read_total,
+                    _max_memory);
+        }
+
         _semaphore.on_permit_destroyed(*this);
     }
 
@@ -313,6 +330,10 @@ class reader_permit::impl
         return _state;
     }
 
+    std::chrono::steady_clock::time_point created_at() const {
+        return _created_at;
+    }
+
     auxiliary_data& aux_data() {
         return _aux_data;
     }
@@ -329,6 +350,10 @@ class reader_permit::impl
         on_permit_inactive(reader_permit::state::waiting_for_execution);
     }
 
+    void on_dequeued_from_admission(std::chrono::steady_clock::duration queue_time) noexcept {
+        _admission_queue_time += queue_time;
+    }
+
     void on_admission() {
         assert(_state != reader_permit::state::active_await);
         on_permit_active();
@@ -369,6 +394,7 @@ class reader_permit::impl
     void consume(reader_resources res) {
         _semaphore.consume(*this, res);
         _resources += res;
+        _max_memory = std::max(_max_memory, _resources.memory);
     }
 
     void signal(reader_resources res) {
@@ -473,6 +499,14 @@ class reader_permit::impl
         return _trace_ptr;
     }
 
+    reader_concurrency_semaphore::low_priority is_low_priority() const noexcept {
+        return _low_priority;
+    }
+
+    void set_low_priority(reader_concurrency_semaphore::low_priority priority) noexcept {
+        _low_priority = priority;
+    }
+
     void set_trace_state(tracing::trace_state_ptr trace_ptr) noexcept {
         if (_trace_ptr) {
             // Create a continuation trace point
@@ -500,6 +534,7 @@ class reader_permit::impl
             ++_semaphore._stats.disk_reads;
         }
         ++_sstables_read;
+        ++_sstables_read_total;
         ++_semaphore._stats.sstables_read;
     }
 
@@ -554,6 +589,10 @@ reader_permit::state reader_permit::get_state() const {
     return _impl->get_state();
 }
 
+std::chrono::steady_clock::time_point reader_permit::created_at() const {
+    return _impl->created_at();
+}
+
 bool reader_permit::needs_readmission() const {
     return _impl->needs_readmission();
 }
@@ -874,9 +913,25 @@ reader_concurrency_semaphore::inactive_read_handle::operator=(inactive_read_hand
     return *this;
 }
 
-void reader_concurrency_semaphore::wait_queue::push_to_admission_queue(reader_permit::impl& p) {
+void reader_concurrency_semaphore::wait_queue::push_to_admission_queue(reader_permit::impl& p, bool by_deadline) {
     p.unlink();
-    _admission_queue.push_back(p);
+    // Low priority permits are at the back of the queue. A permit goes
+    // before all of them, unless it is low priority itself.
+    const auto low_priority = bool(p.is_low_priority());
+    const auto timeout = p.timeout();
+    auto goes_before = [&] (const reader_permit::impl& other) {
+        if (bool(other.is_low_priority()) != low_priority) {
+            return !low_priority;
+        }
+        return by_deadline && other.timeout() > timeout;
+    };
+    // Timeouts of reads of the same kind grow with arrival time,
+    // so the position is usually found right at the back.
+    auto it = _admission_queue.end();
+    while (it != _admission_queue.begin() && goes_before(*std::prev(it))) {
+        --it;
+    }
+    _admission_queue.insert(it, p);
 }
 
 void reader_concurrency_semaphore::wait_queue::push_to_memory_queue(reader_permit::impl& p) {
@@ -968,13 +1023,15 @@ void reader_concurrency_semaphore::signal(const resources& r) noexcept {
 }
 
 reader_concurrency_semaphore::reader_concurrency_semaphore(int count, ssize_t memory, sstring name, size_t max_queue_length,
-            utils::updateable_value<uint32_t> serialize_limit_multiplier, utils::updateable_value<uint32_t> kill_limit_multiplier)
+            utils::updateable_value<uint32_t> serialize_limit_multiplier, utils::updateable_value<uint32_t> kill_limit_multiplier,
+            utils::updateable_value<bool> admission_by_deadline)
     : _initial_resources(count, memory)
     , _resources(count, memory)
     , _name(std::move(name))
     , _max_queue_length(max_queue_length)
     , _serialize_limit_multiplier(std::move(serialize_limit_multiplier))
     , _kill_limit_multiplier(std::move(kill_limit_multiplier))
+    , _admission_by_deadline(std::move(admission_by_deadline))
 { }
 
 reader_concurrency_semaphore::reader_concurrency_semaphore(no_limits, sstring name)
@@ -984,7 +1041,8 @@ reader_concurrency_semaphore::reader_concurrency_semaphore(no_limits, sstring na
             std::move(name),
             std::numeric_limits<size_t>::max(),
             utils::updateable_value(std::numeric_limits<uint32_t>::max()),
-            utils::updateable_value(std::numeric_limits<uint32_t>::max())) {}
+            utils::updateable_value(std::numeric_limits<uint32_t>::max()),
+            utils::updateable_value(false)) {}
 
 reader_concurrency_semaphore::~reader_concurrency_semaphore() {
     assert(!_stats.waiters);
@@ -1198,16 +1256,40 @@ std::exception_ptr reader_concurrency_semaphore::check_queue_size(std::string_vi
     return {};
 }
 
+std::exception_ptr reader_concurrency_semaphore::check_deadline(const reader_permit::impl& permit) {
+    const auto timeout = permit.timeout();
+    if (!_admission_by_deadline() || timeout == db::no_timeout) {
+        return {};
+    }
+    if (db::timeout_clock::now() + _expected_queue_time > timeout) {
+        _stats.total_reads_rejected_by_deadline++;
+        tracing::trace(permit.trace_state(), "[reader concurrency semaphore] rejected, expected to time out in the admission queue");
+        return std::make_exception_ptr(named_semaphore_timed_out(_name));
+    }
+    return {};
+}
+
+void reader_concurrency_semaphore::on_queue_time(std::chrono::steady_clock::duration queue_time) noexcept {
+    // Weighs the last 8 or so reads.
+    _expected_queue_time += (queue_time - _expected_queue_time) / 8;
+}
+
 future<> reader_concurrency_semaphore::enqueue_waiter(reader_permit::impl& permit, wait_on wait) {
     if (auto ex = check_queue_size("wait")) {
         return make_exception_future<>(std::move(ex));
     }
+    if (wait == wait_on::admission) {
+        if (auto ex = check_deadline(permit)) {
+            return make_exception_future<>(std::move(ex));
+        }
+    }
     auto& ad = permit.aux_data();
     ad.pr = {};
     auto fut = ad.pr.get_future();
     if (wait == wait_on::admission) {
         permit.on_waiting_for_admission();
-        _wait_list.push_to_admission_queue(permit);
+        ad.enqueued_at = std::chrono::steady_clock::now();
+        _wait_list.push_to_admission_queue(permit, _admission_by_deadline());
         ++_stats.reads_enqueued_for_admission;
     } else {
         permit.on_waiting_for_memory();
@@ -1339,6 +1421,7 @@ future<> reader_concurrency_semaphore::do_wait_admission(reader_permit::impl& pe
 
     permit.on_admission();
     ++_stats.reads_admitted;
+    on_queue_time({});
     if (permit.aux_data().func) {
         return with_ready_permit(permit);
     }
@@ -1402,7 +1485,15 @@ future<> reader_concurrency_semaphore::request_memory(reader_permit::impl& permi
 
 void reader_concurrency_semaphore::dequeue_permit(reader_permit::impl& permit) {
     switch (permit.get_state()) {
-        case reader_permit::state::waiting_for_admission:
+        case reader_permit::state::waiting_for_admission: {
+            // Either admitted or timed out, the latter is a lower bound on the time it would have waited.
+            const auto queue_time = std::chrono::steady_clock::now() - permit.aux_data().enqueued_at;
+            _stats.admission_queue_time.add(queue_time);
+            on_queue_time(queue_time);
+            permit.on_dequeued_from_admission(queue_time);
+            --_stats.waiters;
+            break;
+        }
         case reader_permit::state::waiting_for_memory:
         case reader_permit::state::waiting_for_execution:
             --_stats.waiters;
@@ -1486,8 +1577,9 @@ reader_permit reader_concurrency_semaphore::make_tracking_only_permit(const sche
 }
 
 future<> reader_concurrency_semaphore::with_permit(const schema* const schema, const char* const op_name, size_t memory,
-        db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_ptr, read_func func) {
+        db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_ptr, read_func func, low_priority priority) {
     auto permit = reader_permit(*this, schema, std::string_view(op_name), {1, static_cast<ssize_t>(memory)}, timeout, std::move(trace_ptr));
+    permit->set_low_priority(priority);
     permit->aux_data().func = std::move(func);
     permit->aux_data().permit_keepalive = permit;
     return do_wait_admission(*permit);
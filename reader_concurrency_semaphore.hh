@@ -12,8 +12,10 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
 #include <seastar/core/condition-variable.hh>
+#include <seastar/util/bool_class.hh>
 #include "reader_permit.hh"
 #include "utils/updateable_value.hh"
+#include "utils/estimated_histogram.hh"
 
 namespace bi = boost::intrusive;
 
@@ -31,7 +33,11 @@ using flat_mutation_reader_v2_opt = optimized_optional<flat_mutation_reader_v2>;
 /// The semaphore can be configured with the desired limits on
 /// construction. New readers will only be admitted when there is both
 /// enough count and memory units available. Readers are admitted in
-/// FIFO order.
+/// FIFO order, or, when `admission_by_deadline` is set, in the order of
+/// their timeouts. In the latter mode, reads which are expected to time out
+/// in the queue, judging by the recently observed queue times, are rejected
+/// right away instead of being queued. In both modes, low priority reads are
+/// only admitted when no other read waits for admission.
 /// Semaphore's `name` must be provided in ctor and its only purpose is
 /// to increase readability of exceptions: both timeout exceptions and
 /// queue overflow exceptions (read below) include this `name` in messages.
@@ -90,6 +96,8 @@ class reader_concurrency_semaphore {
         uint64_t total_reads_shed_due_to_overload = 0;
         // Total number of reads killed due to the memory consumption reaching the kill limit.
         uint64_t total_reads_killed_due_to_kill_limit = 0;
+        // Total number of reads rejected because they were expected to time out while queued for admission.
+        uint64_t total_reads_rejected_by_deadline = 0;
         // Total number of reads admitted, via all admission paths.
         uint64_t reads_admitted = 0;
         // Total number of reads enqueued to wait for admission.
@@ -122,6 +130,8 @@ class reader_concurrency_semaphore {
         uint64_t sstables_read = 0;
         // Permits waiting on something: admission, memory or execution
         uint64_t waiters = 0;
+        // Time spent by reads in the admission queue, until admitted or timed out.
+        utils::time_estimated_histogram admission_queue_time;
     };
 
     using permit_list_type = bi::list<
@@ -131,6 +141,10 @@ class reader_concurrency_semaphore {
 
     using read_func = noncopyable_function<future<>(reader_permit)>;
 
+    // Low priority reads, e.g. those of batch workloads, are queued for
+    // admission behind all other reads waiting for admission.
+    using low_priority = bool_class<class low_priority_tag>;
+
 private:
     struct inactive_read;
 
@@ -169,7 +183,9 @@ class reader_concurrency_semaphore {
         bool empty() const {
             return _admission_queue.empty() && _memory_queue.empty();
         }
-        void push_to_admission_queue(reader_permit::impl& p);
+        // Pushes the permit to the back of the admission queue, or
+        // if by_deadline, before the permits with a later timeout.
+        void push_to_admission_queue(reader_permit::impl& p, bool by_deadline);
         void push_to_memory_queue(reader_permit::impl& p);
         reader_permit::impl& front();
         const reader_permit::impl& front() const;
@@ -186,6 +202,10 @@ class reader_concurrency_semaphore {
     size_t _max_queue_length = std::numeric_limits<size_t>::max();
     utils::updateable_value<uint32_t> _serialize_limit_multiplier;
     utils::updateable_value<uint32_t> _kill_limit_multiplier;
+    utils::updateable_value<bool> _admission_by_deadline;
+    // Moving average of the time reads spend waiting for admission,
+    // immediately admitted reads included.
+    std::chrono::steady_clock::duration _expected_queue_time{};
     stats _stats;
     bool _stopped = false;
     bool _evicting = false;
@@ -204,6 +224,10 @@ class reader_concurrency_semaphore {
     bool all_need_cpu_permits_are_awaiting() const;
 
     [[nodiscard]] std::exception_ptr check_queue_size(std::string_view queue_name);
+    // Fails the read if admission_by_deadline is set and the read is
+    // expected to time out before it's admitted.
+    [[nodiscard]] std::exception_ptr check_deadline(const reader_permit::impl& permit);
+    void on_queue_time(std::chrono::steady_clock::duration queue_time) noexcept;
 
     // Add the permit to the wait queue and return the future which resolves when
     // the permit is admitted (popped from the queue).
@@ -274,7 +298,8 @@ class reader_concurrency_semaphore {
             sstring name,
             size_t max_queue_length,
             utils::updateable_value<uint32_t> serialize_limit_multiplier,
-            utils::updateable_value<uint32_t> kill_limit_multiplier);
+            utils::updateable_value<uint32_t> kill_limit_multiplier,
+            utils::updateable_value<bool> admission_by_deadline);
 
     /// Create a semaphore with practically unlimited count and memory.
     ///
@@ -291,8 +316,10 @@ class reader_concurrency_semaphore {
             ssize_t memory = std::numeric_limits<ssize_t>::max(),
             size_t max_queue_length = std::numeric_limits<size_t>::max(),
             utils::updateable_value<uint32_t> serialize_limit_multipler = utils::updateable_value(std::numeric_limits<uint32_t>::max()),
-            utils::updateable_value<uint32_t> kill_limit_multipler = utils::updateable_value(std::numeric_limits<uint32_t>::max()))
-        : reader_concurrency_semaphore(count, memory, std::move(name), max_queue_length, std::move(serialize_limit_multipler), std::move(kill_limit_multipler))
+            utils::updateable_value<uint32_t> kill_limit_multipler = utils::updateable_value(std::numeric_limits<uint32_t>::max()),
+            utils::updateable_value<bool> admission_by_deadline = utils::updateable_value(false))
+        : reader_concurrency_semaphore(count, memory, std::move(name), max_queue_length, std::move(serialize_limit_multipler), std::move(kill_limit_multipler),
+                std::move(admission_by_deadline))
     {}
 
     virtual ~reader_concurrency_semaphore();
@@ -427,7 +454,11 @@ class reader_concurrency_semaphore {
     ///
     /// Some permits cannot be associated with any table, so passing nullptr as
     /// the schema parameter is allowed.
-    future<> with_permit(const schema* const schema, const char* const op_name, size_t memory, db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_ptr, read_func func);
+    ///
+    /// Low priority permits are queued for admission behind all other
+    /// permits waiting for admission.
+    future<> with_permit(const schema* const schema, const char* const op_name, size_t memory, db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_ptr, read_func func,
+            low_priority priority = low_priority::no);
 
     /// Run the function through the semaphore's execution stage with a pre-admitted permit
     ///
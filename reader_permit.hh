@@ -146,6 +146,7 @@ class reader_permit {
     const ::schema* get_schema() const;
     std::string_view get_op_name() const;
     state get_state() const;
+    std::chrono::steady_clock::time_point created_at() const;
 
     bool needs_readmission() const;
 
@@ -13,6 +13,8 @@
 #include "readers/clustering_combined.hh"
 #include "readers/range_tombstone_change_merger.hh"
 #include "readers/combined.hh"
+#include "utils/loser_tree.hh"
+#include "utils/error_injection.hh"
 
 extern logging::logger mrlog;
 
@@ -177,9 +179,15 @@ class mutation_reader_merger {
     // Determines how many times a fragment should be taken from the same
     // reader in order to enter gallop mode. Must be greater than one.
     static constexpr int gallop_mode_entering_threshold = 3;
+    // Partitions with at least this many readers can be merged with
+    // _fragment_tree rather than with _fragment_heap. The tree is yet to be
+    // measured against the heap, so it is used only when the
+    // "combined_reader_fragment_tree" error injection is enabled.
+    static constexpr size_t fragment_tree_min_readers = 8;
 private:
     struct reader_heap_compare;
     struct fragment_heap_compare;
+    struct fragment_tree_compare;
 
     struct needs_merge_tag { };
     using needs_merge = bool_class<needs_merge_tag>;
@@ -226,8 +234,20 @@ class mutation_reader_merger {
     const schema_ptr _schema;
     streamed_mutation::forwarding _fwd_sm;
     mutation_reader::forwarding _fwd_mr;
+    // Replaces _fragment_heap for partitions merged from many readers, see
+    // fragment_tree_min_readers. A winning reader whose next fragment is
+    // already buffered is moved to it in place, which takes a single replay of
+    // the tree, rather than being popped, refilled, and pushed back.
+    // The gallop mode is not used with the tree, as the winning reader stays in
+    // it anyway.
+    utils::loser_tree<reader_and_fragment, fragment_tree_compare> _fragment_tree;
+    bool _use_fragment_tree = false;
 private:
     future<mutation_fragment_batch_opt> maybe_produce_batch();
+    mutation_fragment_batch_opt produce_batch_from_fragment_tree();
+    bool current_partition_exhausted() const {
+        return _fragment_heap.empty() && _fragment_tree.empty();
+    }
     void maybe_add_readers_at_partition_boundary();
     void maybe_add_readers(const std::optional<dht::ring_position_view>& pos);
     void add_readers(std::vector<flat_mutation_reader_v2> new_readers);
@@ -346,6 +366,18 @@ struct mutation_reader_merger::fragment_heap_compare {
     }
 };
 
+struct mutation_reader_merger::fragment_tree_compare {
+    position_in_partition::less_compare cmp;
+
+    explicit fragment_tree_compare(const schema& s)
+        : cmp(s) {
+    }
+
+    bool operator()(const mutation_reader_merger::reader_and_fragment& a, const mutation_reader_merger::reader_and_fragment& b) const {
+        return cmp(a.fragment.position(), b.fragment.position());
+    }
+};
+
 bool mutation_reader_merger::in_gallop_mode() const {
     return _gallop_mode_hits >= gallop_mode_entering_threshold;
 }
@@ -354,7 +386,7 @@ void mutation_reader_merger::maybe_add_readers_at_partition_boundary() {
     // We are either crossing partition boundary or ran out of
     // readers. If there are halted readers then we are just
     // waiting for a fast-forward so there is nothing to do.
-    if (_fragment_heap.empty() && _halted_readers.empty()) {
+    if (current_partition_exhausted() && _halted_readers.empty()) {
         if (_reader_heap.empty()) {
             maybe_add_readers(std::nullopt);
         } else {
@@ -400,8 +432,12 @@ future<mutation_reader_merger::needs_merge> mutation_reader_merger::prepare_one(
                     _gallop_mode_hits = 0;
                 }
 
-                _fragment_heap.emplace_back(rk.reader, std::move(*mfo));
-                boost::range::push_heap(_fragment_heap, fragment_heap_compare(*_schema));
+                if (_use_fragment_tree) {
+                    _fragment_tree.push(reader_and_fragment(rk.reader, std::move(*mfo)));
+                } else {
+                    _fragment_heap.emplace_back(rk.reader, std::move(*mfo));
+                    boost::range::push_heap(_fragment_heap, fragment_heap_compare(*_schema));
+                }
             }
         } else if (_fwd_sm == streamed_mutation::forwarding::yes && rk.last_kind != mutation_fragment_v2::kind::partition_end) {
             // When in streamed_mutation::forwarding mode we need
@@ -454,9 +490,13 @@ void mutation_reader_merger::prepare_forwardable_readers() {
     for (auto& df : _fragment_heap) {
         _next.emplace_back(df.reader, df.fragment.mutation_fragment_kind());
     }
+    _fragment_tree.for_each([this] (reader_and_fragment& df) {
+        _next.emplace_back(df.reader, df.fragment.mutation_fragment_kind());
+    });
 
     _halted_readers.clear();
     _fragment_heap.clear();
+    _fragment_tree.clear();
 }
 
 mutation_reader_merger::mutation_reader_merger(schema_ptr schema,
@@ -466,7 +506,8 @@ mutation_reader_merger::mutation_reader_merger(schema_ptr schema,
     : _selector(std::move(selector))
     , _schema(std::move(schema))
     , _fwd_sm(fwd_sm)
-    , _fwd_mr(fwd_mr) {
+    , _fwd_mr(fwd_mr)
+    , _fragment_tree(fragment_tree_compare(*_schema)) {
     maybe_add_readers(std::nullopt);
 }
 
@@ -515,7 +556,7 @@ future<mutation_fragment_batch_opt> mutation_reader_merger::maybe_produce_batch(
 
     // If we ran out of fragments for the current partition, select the
     // readers for the next one.
-    if (_fragment_heap.empty()) {
+    if (current_partition_exhausted()) {
         if (!_halted_readers.empty() || _reader_heap.empty()) {
             return make_ready_future<mutation_fragment_batch_opt>(_current);
         }
@@ -537,8 +578,23 @@ future<mutation_fragment_batch_opt> mutation_reader_merger::maybe_produce_batch(
             _current.emplace_back(std::move(_fragment_heap.back().fragment), &*_single_reader.reader);
             _fragment_heap.clear();
             _gallop_mode_hits = 0;
+            _use_fragment_tree = false;
             return make_ready_future<mutation_fragment_batch_opt>(_current);
         }
+        _use_fragment_tree = _fragment_heap.size() >= fragment_tree_min_readers
+                && utils::get_local_injector().enter("combined_reader_fragment_tree");
+        if (_use_fragment_tree) {
+            _fragment_tree.reset(_fragment_heap.size());
+            for (auto& rf : _fragment_heap) {
+                _fragment_tree.push(std::move(rf));
+            }
+            _fragment_heap.clear();
+            _gallop_mode_hits = 0;
+        }
+    }
+
+    if (_use_fragment_tree) {
+        return make_ready_future<mutation_fragment_batch_opt>(produce_batch_from_fragment_tree());
     }
 
     const auto equal = position_in_partition::equal_compare(*_schema);
@@ -566,6 +622,26 @@ future<mutation_fragment_batch_opt> mutation_reader_merger::maybe_produce_batch(
     return make_ready_future<mutation_fragment_batch_opt>(_current);
 }
 
+mutation_fragment_batch_opt mutation_reader_merger::produce_batch_from_fragment_tree() {
+    const auto equal = position_in_partition::equal_compare(*_schema);
+    do {
+        auto& top = _fragment_tree.top();
+        const auto reader = top.reader;
+        const auto kind = top.fragment.mutation_fragment_kind();
+        _current.emplace_back(std::move(top.fragment), &*reader);
+        // Partition starts belong in _reader_heap, let prepare_one() deal with them.
+        if (!reader->is_buffer_empty() && !reader->peek_buffer().is_partition_start()) {
+            _fragment_tree.replace_top(reader_and_fragment(reader, reader->pop_mutation_fragment()));
+        } else {
+            _fragment_tree.pop();
+            _next.emplace_back(reader, kind);
+        }
+    }
+    while (!_fragment_tree.empty() && equal(_current.back().fragment.position(), _fragment_tree.top().fragment.position()));
+
+    return mutation_fragment_batch(_current);
+}
+
 future<> mutation_reader_merger::next_partition() {
     // If the last batch of fragments returned by operator() came from partition P,
     // we must forward to the partition immediately following P (as per the `next_partition`
@@ -592,6 +668,7 @@ future<> mutation_reader_merger::fast_forward_to(const dht::partition_range& pr)
     _next.clear();
     _halted_readers.clear();
     _fragment_heap.clear();
+    _fragment_tree.clear();
     _reader_heap.clear();
 
     for (auto it = _all_readers.begin(); it != _all_readers.end(); ++it) {
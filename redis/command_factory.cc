@@ -22,10 +22,12 @@ future<redis_message> command_factory::create_execute(service::storage_proxy& pr
         { "ping", commands::ping },
         { "select", commands::select },
         { "get", commands::get },
+        { "mget", commands::mget },
         { "exists", commands::exists },
         { "ttl", commands::ttl },
         { "strlen", commands::strlen },
         { "set", commands::set },
+        { "mset", commands::mset },
         { "setex", commands::setex },
         { "del", commands::del },
         { "echo", commands::echo },
@@ -40,16 +40,20 @@ future<redis_message> exists(service::storage_proxy& proxy, request& req, redis:
     if (req.arguments_size() < 1) {
         throw wrong_arguments_exception(1, req.arguments_size(), req._command);
     }
-    return do_with(size_t(0), [&proxy, &options, permit, &req] (size_t& count) {
-        return seastar::do_for_each(req._args, [&proxy, &options, permit, &count] (auto& key) {
-            return redis::read_strings(proxy, options, key, permit).then([&count] (lw_shared_ptr<strings_result> result) {
-                if (result->has_result()) {
-                    count++;
-                }
-            });
-        }).then([&count] () {
-            return redis_message::number(count);
-        });
+    return redis::read_strings(proxy, options, req._args, permit).then([&req] (auto result) {
+        // Keys mentioned multiple times are counted multiple times.
+        return redis_message::number(std::ranges::count_if(req._args, [&result] (const bytes& key) {
+            return result->contains(key);
+        }));
+    });
+}
+
+future<redis_message> mget(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() < 1) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    return redis::read_strings(proxy, options, req._args, permit).then([&req] (auto result) {
+        return redis_message::make_strings_results(req._args, *result);
     });
 }
 
@@ -162,6 +166,20 @@ future<redis_message> set(service::storage_proxy& proxy, request& req, redis::re
     });
 }
 
+future<redis_message> mset(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
+    if (req.arguments_size() == 0 || req.arguments_size() % 2 != 0) {
+        throw wrong_number_of_arguments_exception(req._command);
+    }
+    std::vector<std::pair<bytes, bytes>> entries;
+    entries.reserve(req.arguments_size() / 2);
+    for (size_t i = 0; i < req.arguments_size(); i += 2) {
+        entries.emplace_back(std::move(req._args[i]), std::move(req._args[i + 1]));
+    }
+    return redis::write_strings(proxy, options, std::move(entries), permit).then([] {
+        return redis_message::ok();
+    });
+}
+
 future<redis_message> setex(service::storage_proxy& proxy, request& req, redis::redis_options& options, service_permit permit) {
     if (req.arguments_size() != 3) {
         throw wrong_arguments_exception(3, req.arguments_size(), req._command);
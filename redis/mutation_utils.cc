@@ -71,6 +71,17 @@ future<> write_strings(service::storage_proxy& proxy, redis::redis_options& opti
     return proxy.mutate(std::vector<mutation> {std::move(m)}, write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
 }
 
+future<> write_strings(service::storage_proxy& proxy, redis::redis_options& options, std::vector<std::pair<bytes, bytes>>&& entries, service_permit permit) {
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_write_timeout();
+    std::vector<mutation> mutations;
+    mutations.reserve(entries.size());
+    for (auto& [key, data] : entries) {
+        mutations.push_back(make_mutation(proxy, options, std::move(key), std::move(data), 0));
+    }
+    auto write_consistency_level = options.get_write_consistency_level();
+    return proxy.mutate(std::move(mutations), write_consistency_level, timeout, nullptr, permit, db::allow_per_partition_rate_limit::yes);
+}
+
 
 mutation make_tombstone(service::storage_proxy& proxy, const redis_options& options, const sstring& cf_name, const bytes& key) {
     auto schema = get_schema(proxy, options.get_keyspace_name(), cf_name);
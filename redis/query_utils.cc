@@ -19,6 +19,7 @@
 #include "gc_clock.hh"
 #include "service_permit.hh"
 #include "redis/keyspace_utils.hh"
+#include <unordered_set>
 
 namespace redis {
 
@@ -61,6 +62,37 @@ class strings_result_builder {
     void accept_partition_end(const query::result_row_view& static_row) {}
 };
 
+class multi_strings_result_builder {
+    lw_shared_ptr<std::unordered_map<bytes, bytes>> _data;
+    const query::partition_slice& _partition_slice;
+    const schema_ptr _schema;
+    bytes _key;
+public:
+    multi_strings_result_builder(lw_shared_ptr<std::unordered_map<bytes, bytes>> data, const schema_ptr schema, const query::partition_slice& ps)
+        : _data(data)
+        , _partition_slice(ps)
+        , _schema(schema)
+    {
+    }
+    void accept_new_partition(const partition_key& key, uint32_t row_count) {
+        _key = key.explode().front();
+    }
+    void accept_new_partition(uint32_t row_count) {}
+    void accept_new_row(const clustering_key& key, const query::result_row_view& static_row, const query::result_row_view& row)
+    {
+        auto row_iterator = row.iterator();
+        for (auto&& id : _partition_slice.regular_columns) {
+            auto cell = row_iterator.next_atomic_cell();
+            if (cell) {
+                cell->value().with_linearized([this, &col = _schema->regular_column_at(id)] (bytes_view cell_view) {
+                    _data->insert_or_assign(_key, col.type->deserialize_value(cell_view).serialize_nonnull());
+                });
+            }
+        }
+    }
+    void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {}
+    void accept_partition_end(const query::result_row_view& static_row) {}
+};
 
 future<lw_shared_ptr<strings_result>> read_strings(service::storage_proxy& proxy, const redis_options& options, const bytes& key, service_permit permit) {
     auto schema = get_schema(proxy, options.get_keyspace_name(), redis::STRINGs);
@@ -87,6 +119,34 @@ future<lw_shared_ptr<strings_result>> query_strings(service::storage_proxy& prox
     });
 }
 
+future<lw_shared_ptr<std::unordered_map<bytes, bytes>>> read_strings(service::storage_proxy& proxy, const redis_options& options, const std::vector<bytes>& keys, service_permit permit) {
+    auto schema = get_schema(proxy, options.get_keyspace_name(), redis::STRINGs);
+    auto ps = partition_slice_builder(*schema)
+        .with_option<query::partition_slice::option::send_partition_key>()
+        .build();
+    dht::partition_range_vector partition_ranges;
+    partition_ranges.reserve(keys.size());
+    std::unordered_set<bytes> seen;
+    for (auto& key : keys) {
+        if (!seen.insert(key).second) {
+            continue;
+        }
+        auto pkey = partition_key::from_single_value(*schema, key);
+        partition_ranges.emplace_back(dht::partition_range::make_singular(dht::decorate_key(*schema, std::move(pkey))));
+    }
+    const auto max_result_size = proxy.get_max_result_size(ps);
+    const auto max_tombstones = proxy.get_tombstone_limit();
+    query::read_command cmd(schema->id(), schema->version(), ps, max_result_size, max_tombstones, query::row_limit(partition_ranges.size()), query::partition_limit(partition_ranges.size()), gc_clock::now(), std::nullopt, query_id::create_null_id(), query::is_first_page::no);
+    auto read_consistency_level = options.get_read_consistency_level();
+    db::timeout_clock::time_point timeout = db::timeout_clock::now() + options.get_read_timeout();
+    return proxy.query(schema, make_lw_shared<query::read_command>(std::move(cmd)), std::move(partition_ranges), read_consistency_level, {timeout, permit, service::client_state::for_internal_calls()}).then([ps, schema] (auto qr) {
+        return query::result_view::do_with(*qr.query_result, [&] (query::result_view v) {
+            auto pd = make_lw_shared<std::unordered_map<bytes, bytes>>();
+            v.consume(ps, multi_strings_result_builder(pd, schema, ps));
+            return pd;
+        });
+    });
+}
 
 class hashes_result_builder {
     lw_shared_ptr<std::map<bytes, bytes>> _data;
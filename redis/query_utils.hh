@@ -11,6 +11,7 @@
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/future.hh>
 #include "bytes.hh"
+#include <unordered_map>
 #include "gc_clock.hh"
 #include "query-request.hh"
 
@@ -36,6 +37,9 @@ struct strings_result {
 };
 
 seastar::future<seastar::lw_shared_ptr<strings_result>> read_strings(service::storage_proxy&, const redis_options&, const bytes&, service_permit);
+// Reads all the keys with a single multi-partition query. Keys which don't
+// exist are missing from the result.
+seastar::future<seastar::lw_shared_ptr<std::unordered_map<bytes, bytes>>> read_strings(service::storage_proxy&, const redis_options&, const std::vector<bytes>&, service_permit);
 seastar::future<seastar::lw_shared_ptr<strings_result>> query_strings(service::storage_proxy&, const redis_options&, const bytes&, service_permit, schema_ptr, query::partition_slice);
 
 seastar::future<seastar::lw_shared_ptr<std::map<bytes, bytes>>> read_hashes(service::storage_proxy&, const redis_options&, const bytes&, service_permit);
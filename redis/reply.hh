@@ -9,6 +9,7 @@
 #pragma once
 
 #include "bytes.hh"
+#include <unordered_map>
 #include <seastar/core/sharded.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/print.hh>
@@ -73,6 +74,19 @@ class redis_message final {
         write_bytes(m, result);
         return make_ready_future<redis_message>(m);
     }
+    // Replies with the value of each key, in the order of the keys, nil for missing keys.
+    static seastar::future<redis_message> make_strings_results(const std::vector<bytes>& keys, std::unordered_map<bytes, bytes>& results) {
+        auto m = make_lw_shared<scattered_message<char>> ();
+        m->append(fmt::format("*{}\r\n", keys.size()));
+        for (auto& key : keys) {
+            if (auto it = results.find(key); it != results.end()) {
+                write_bytes(m, it->second);
+            } else {
+                m->append_static("$-1\r\n");
+            }
+        }
+        return make_ready_future<redis_message>(m);
+    }
     static seastar::future<redis_message> unknown(const bytes& name) {
         return from_exception(make_message("-ERR unknown command '{}'\r\n", to_sstring(name)));
     }
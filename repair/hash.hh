@@ -6,6 +6,7 @@
 
 class decorated_key_with_hash;
 class mutation_fragment;
+class frozen_mutation_fragment;
 
 // Hash of a repair row
 class repair_hash {
@@ -31,13 +32,25 @@ using repair_hash_set = absl::btree_set<repair_hash>;
 class repair_hasher {
     uint64_t _seed;
     schema_ptr _schema;
+    // Hash rows over their serialized form, see do_hash_for_mf().
+    bool _hash_serialized_rows;
+
+    static bool can_hash_serialized_rows(const schema& s);
 public:
-    repair_hasher(uint64_t seed, schema_ptr s)
+    repair_hasher(uint64_t seed, schema_ptr s, bool hash_serialized_rows = false)
         : _seed(seed)
         , _schema(std::move(s))
+        , _hash_serialized_rows(hash_serialized_rows && can_hash_serialized_rows(*_schema))
     {}
 
     repair_hash do_hash_for_mf(const decorated_key_with_hash& dk_with_hash, const mutation_fragment& mf);
+
+    // Same as above, for a fragment which is also available serialized as fmf.
+    // When enabled, clustering and static rows are hashed over the bytes of fmf
+    // in a few xxh3 updates, instead of visiting each of their cells. The same
+    // row serializes to the same bytes on all nodes for tables without
+    // collections or counters, so only those take the fast path.
+    repair_hash do_hash_for_mf(const decorated_key_with_hash& dk_with_hash, const mutation_fragment& mf, const frozen_mutation_fragment& fmf);
 };
 
 
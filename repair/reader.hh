@@ -7,6 +7,7 @@
 #include "utils/phased_barrier.hh"
 #include "mutation/mutation_fragment.hh"
 #include "readers/mutation_fragment_v1_stream.hh"
+#include "replica/database_fwd.hh"
 
 class repair_reader {
 public:
@@ -44,6 +45,8 @@ class repair_reader {
     mutation_fragment_v1_stream _reader;
     // Current partition read from disk
     lw_shared_ptr<const decorated_key_with_hash> _current_dk;
+    // Fragment given back with unread_mutation_fragment()
+    mutation_fragment_opt _unread_fragment;
     uint64_t _reads_issued = 0;
     uint64_t _reads_finished = 0;
 
@@ -53,7 +56,8 @@ class repair_reader {
         read_strategy strategy,
         const dht::sharder& remote_sharder,
         unsigned remote_shard,
-        gc_clock::time_point compaction_time);
+        gc_clock::time_point compaction_time,
+        replica::skip_repaired_sstables skip_repaired);
 
 public:
     repair_reader(
@@ -66,11 +70,16 @@ class repair_reader {
         unsigned remote_shard,
         uint64_t seed,
         read_strategy strategy,
-        gc_clock::time_point compaction_time);
+        gc_clock::time_point compaction_time,
+        replica::skip_repaired_sstables skip_repaired = replica::skip_repaired_sstables::no);
 
     future<mutation_fragment_opt>
     read_mutation_fragment();
 
+    // Make the next read_mutation_fragment() return mf, which must be the
+    // fragment it returned last.
+    void unread_mutation_fragment(mutation_fragment mf);
+
     future<> on_end_of_stream() noexcept;
 
     future<> close() noexcept;
@@ -357,8 +357,9 @@ repair::task_manager_module::task_manager_module(tasks::task_manager& tm, repair
     , _rs(rs)
     , _range_parallelism_semaphore(std::max(size_t(1), size_t(max_repair_memory / max_repair_memory_per_range / 4)),
             named_semaphore_exception_factory{"repair range parallelism"})
+    , _max_range_parallelism(_range_parallelism_semaphore.available_units())
 {
-    auto nr = _range_parallelism_semaphore.available_units();
+    auto nr = _max_range_parallelism;
     rlogger.info("Setting max_repair_memory={}, max_repair_memory_per_range={}, max_repair_ranges_in_parallel={}",
         max_repair_memory, max_repair_memory_per_range, nr);
 }
@@ -590,6 +591,71 @@ repair::shard_repair_task_impl::shard_repair_task_impl(tasks::task_manager::modu
 {
     rlogger.debug("repair[{}]: Setting user_ranges_parallelism to {}", global_repair_id.uuid(),
             _user_ranges_parallelism ? std::to_string(_user_ranges_parallelism->available_units()) : "unlimited");
+    auto latency_target = std::chrono::milliseconds(db.local().get_config().repair_latency_target_in_ms());
+    if (_reason == streaming::stream_reason::repair && latency_target.count() > 0) {
+        auto max_parallelism = rs.get_repair_module().max_range_parallelism();
+        if (ranges_parallelism) {
+            max_parallelism = std::min(max_parallelism, size_t(std::max(*ranges_parallelism, 1)));
+        }
+        _controller = std::make_unique<repair_controller>(db.local(), table_ids, latency_target,
+                max_parallelism, task_manager_module::max_repair_memory_per_range);
+    }
+}
+
+repair::repair_controller::repair_controller(replica::database& db, std::vector<table_id> table_ids, std::chrono::microseconds latency_target,
+        size_t max_parallelism, size_t max_row_buf_size)
+    : _db(db)
+    , _table_ids(std::move(table_ids))
+    , _latency_target(latency_target)
+    , _max_parallelism(max_parallelism)
+    , _parallelism(max_parallelism)
+    , _max_row_buf_size(max_row_buf_size)
+    , _row_buf_size(max_row_buf_size)
+    , _ranges_parallelism(max_parallelism)
+    , _adjust_timer([this] { adjust(); })
+{
+    _adjust_timer.arm_periodic(adjust_interval);
+}
+
+bool repair::repair_controller::under_pressure() const {
+    if (_db.get_user_read_concurrency_semaphore().get_stats().waiters > 0) {
+        return true;
+    }
+    // The summaries hold the latency quantiles (p50, p95, p99) of the last
+    // period, in microseconds.
+    auto latency_target = _latency_target.count();
+    for (auto id : _table_ids) {
+        try {
+            auto& stats = _db.find_column_family(id).get_stats();
+            if (stats.reads.summary().summary()[2] > latency_target || stats.writes.summary().summary()[2] > latency_target) {
+                return true;
+            }
+        } catch (replica::no_such_column_family&) {
+            // Ignore dropped table
+        }
+    }
+    return false;
+}
+
+void repair::repair_controller::adjust() {
+    auto old_parallelism = _parallelism;
+    if (under_pressure()) {
+        _parallelism = std::max(size_t(1), _parallelism / 2);
+        _row_buf_size = std::max(min_row_buf_size, _row_buf_size / 2);
+    } else {
+        _parallelism = std::min(_max_parallelism, _parallelism + 1);
+        _row_buf_size = std::min(_max_row_buf_size, _row_buf_size + _max_row_buf_size / 8);
+    }
+    // The units taken by ranges being repaired are returned as they complete,
+    // so the semaphore can go below zero until then.
+    if (_parallelism > old_parallelism) {
+        _ranges_parallelism.signal(_parallelism - old_parallelism);
+    } else if (_parallelism < old_parallelism) {
+        _ranges_parallelism.consume(old_parallelism - _parallelism);
+    }
+    if (_parallelism != old_parallelism) {
+        rlogger.debug("repair_controller: ranges_parallelism={}, row_buf_size={}", _parallelism, _row_buf_size);
+    }
 }
 
 void repair::shard_repair_task_impl::check_failed_ranges() {
@@ -952,6 +1018,7 @@ struct repair_options {
 };
 
 void repair::shard_repair_task_impl::release_resources() noexcept {
+    _controller = {};
     erm = {};
     cfs = {};
     data_centers = {};
@@ -978,6 +1045,8 @@ future<> repair::shard_repair_task_impl::do_repair_ranges() {
             auto permit = co_await seastar::get_units(rs.get_repair_module().range_parallelism_semaphore(), 1);
             // Get the range parallelism specified by user
             auto user_permit = _user_ranges_parallelism ? co_await seastar::get_units(*_user_ranges_parallelism, 1) : semaphore_units<>();
+            // Get the range parallelism allowed by the foreground workload
+            auto controller_permit = _controller ? co_await seastar::get_units(_controller->ranges_parallelism(), 1) : semaphore_units<>();
             co_await repair_range(range, table_info);
             ++_ranges_complete;
             if (_reason == streaming::stream_reason::bootstrap) {
@@ -1046,6 +1115,9 @@ future<> repair::shard_repair_task_impl::run() {
         rlogger.debug("repair[{}]: got error in do_repair_ranges: {}",
             global_repair_id.uuid(), std::current_exception());
     }
+    if (_controller) {
+        _controller->stop();
+    }
     check_failed_ranges();
     co_return;
 }
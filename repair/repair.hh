@@ -177,6 +177,15 @@ struct get_sync_boundary_response {
 // Return value of the REPAIR_GET_COMBINED_ROW_HASH RPC verb
 using get_combined_row_hash_response = repair_hash;
 
+// Return value of the REPAIR_GET_RANGE_SUMMARY RPC verb
+struct repair_range_summary {
+    // The combined hash of the rows in the sub-range
+    repair_hash hash;
+    // Whether the rows were kept in the row buf, so that they can be synced
+    // without reading them again
+    bool rows_kept;
+};
+
 struct node_repair_meta_id {
     gms::inet_address ip;
     uint32_t repair_meta_id;
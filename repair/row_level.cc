@@ -28,6 +28,7 @@
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/core/byteorder.hh>
 #include <list>
 #include <vector>
 #include <algorithm>
@@ -76,6 +77,8 @@ enum class repair_state : uint16_t {
     set_estimated_partitions_finished,
     get_sync_boundary_started,
     get_sync_boundary_finished,
+    get_range_summary_started,
+    get_range_summary_finished,
     get_combined_row_hash_started,
     get_combined_row_hash_finished,
     get_row_diff_with_rpc_stream_started,
@@ -260,16 +263,36 @@ repair_hash repair_hasher::do_hash_for_mf(const decorated_key_with_hash& dk_with
     return repair_hash(h.finalize_uint64());
 }
 
+bool repair_hasher::can_hash_serialized_rows(const schema& s) {
+    return !s.is_counter() && std::ranges::none_of(s.all_columns(), [] (const column_definition& cdef) {
+        return cdef.is_multi_cell();
+    });
+}
+
+repair_hash repair_hasher::do_hash_for_mf(const decorated_key_with_hash& dk_with_hash, const mutation_fragment& mf, const frozen_mutation_fragment& fmf) {
+    if (!_hash_serialized_rows || !(mf.is_clustering_row() || mf.is_static_row())) {
+        return do_hash_for_mf(dk_with_hash, mf);
+    }
+    xx3_hasher h(_seed);
+    for (bytes_view frag : fmf.representation()) {
+        h.update(reinterpret_cast<const char*>(frag.data()), frag.size());
+    }
+    auto dk_hash = cpu_to_le(dk_with_hash.hash.hash);
+    h.update(reinterpret_cast<const char*>(&dk_hash), sizeof(dk_hash));
+    return repair_hash(h.finalize_uint64());
+}
+
 flat_mutation_reader_v2 repair_reader::make_reader(
     seastar::sharded<replica::database>& db,
     replica::column_family& cf,
     read_strategy strategy,
     const dht::sharder& remote_sharder,
     unsigned remote_shard,
-    gc_clock::time_point compaction_time) {
+    gc_clock::time_point compaction_time,
+    replica::skip_repaired_sstables skip_repaired) {
     switch (strategy) {
         case read_strategy::local: {
-            auto ms = mutation_source([&cf, compaction_time] (
+            auto ms = mutation_source([&cf, compaction_time, skip_repaired] (
                 schema_ptr s,
                 reader_permit permit,
                 const dht::partition_range& pr,
@@ -277,7 +300,7 @@ flat_mutation_reader_v2 repair_reader::make_reader(
                 tracing::trace_state_ptr,
                 streamed_mutation::forwarding,
                 mutation_reader::forwarding fwd_mr) {
-                return cf.make_streaming_reader(std::move(s), std::move(permit), pr, ps, fwd_mr, compaction_time);
+                return cf.make_streaming_reader(std::move(s), std::move(permit), pr, ps, fwd_mr, compaction_time, skip_repaired);
             });
             flat_mutation_reader_v2 rd(nullptr);
             std::tie(rd, _reader_handle) = make_manually_paused_evictable_reader_v2(
@@ -301,14 +324,14 @@ flat_mutation_reader_v2 repair_reader::make_reader(
                     return std::optional<dht::partition_range>(dht::to_partition_range(*shard_range));
                 }
                 return std::optional<dht::partition_range>();
-            }, compaction_time);
+            }, compaction_time, skip_repaired);
         }
         case read_strategy::multishard_filter: {
             // We can't have two permits with count resource for 1 repair.
             // So we release the one on _permit so the only one is the one the
             // shard reader will obtain.
             _permit.release_base_resources();
-            return make_filtering_reader(make_multishard_streaming_reader(db, _schema, _permit, _range, compaction_time),
+            return make_filtering_reader(make_multishard_streaming_reader(db, _schema, _permit, _range, compaction_time, skip_repaired),
                 [&remote_sharder, remote_shard](const dht::decorated_key& k) {
                     return remote_sharder.shard_of(k.token()) == remote_shard;
                 });
@@ -329,18 +352,22 @@ repair_reader::repair_reader(
     unsigned remote_shard,
     uint64_t seed,
     read_strategy strategy,
-    gc_clock::time_point compaction_time)
+    gc_clock::time_point compaction_time,
+    replica::skip_repaired_sstables skip_repaired)
     : _schema(s)
     , _permit(std::move(permit))
     , _range(dht::to_partition_range(range))
     , _sharder(remote_sharder, range, remote_shard)
     , _seed(seed)
     , _local_read_op(strategy == read_strategy::local ? std::optional(cf.read_in_progress()) : std::nullopt)
-    , _reader(make_reader(db, cf, strategy, remote_sharder, remote_shard, compaction_time))
+    , _reader(make_reader(db, cf, strategy, remote_sharder, remote_shard, compaction_time, skip_repaired))
 { }
 
 future<mutation_fragment_opt>
 repair_reader::read_mutation_fragment() {
+    if (_unread_fragment) {
+        return make_ready_future<mutation_fragment_opt>(std::exchange(_unread_fragment, std::nullopt));
+    }
     ++_reads_issued;
     // Use a very long timeout for the reader to break out any eventual
     // deadlock within the reader. Thirty minutes should be more than
@@ -362,11 +389,16 @@ repair_reader::read_mutation_fragment() {
     });
 }
 
+void repair_reader::unread_mutation_fragment(mutation_fragment mf) {
+    _unread_fragment = std::move(mf);
+}
+
 future<> repair_reader::on_end_of_stream() noexcept {
     return _reader.close().then([this] {
         _permit.release_base_resources();
         _reader = mutation_fragment_v1_stream(make_empty_flat_reader_v2(_schema, _permit));
         _reader_handle.reset();
+        _unread_fragment = std::nullopt;
     });
 }
 
@@ -621,7 +653,7 @@ future<std::list<repair_row>> to_repair_rows_list(repair_rows_on_wire rows, sche
                     // mutation_fragment is needed by _repair_writer.do_write()
                     // to apply the repair_row to disk
                     auto mf = make_lw_shared<mutation_fragment>(fmf.unfreeze(*s, permit));
-                    auto hash = hasher.do_hash_for_mf(*dk_ptr, *mf);
+                    auto hash = hasher.do_hash_for_mf(*dk_ptr, *mf, fmf);
                     position_in_partition pos(mf->position());
                     row_list.push_back(repair_row(std::move(fmf), std::move(pos), dk_ptr, std::move(hash), is_dirty_on_master::yes, std::move(mf)));
                     co_await coroutine::maybe_yield();
@@ -692,6 +724,100 @@ void flush_rows(schema_ptr s, std::list<repair_row>& rows, lw_shared_ptr<repair_
     }
 }
 
+std::pair<std::optional<repair_sync_boundary>, bool>
+get_common_sync_boundary(const schema& s, bool zero_rows,
+        std::vector<repair_sync_boundary>& sync_boundaries,
+        std::vector<repair_hash>& combined_hashes) {
+    if (sync_boundaries.empty()) {
+        throw std::runtime_error("sync_boundaries is empty");
+    }
+    if(combined_hashes.empty()) {
+        throw std::runtime_error("combined_hashes is empty");
+    }
+    auto cmp = repair_sync_boundary::tri_compare(s);
+    // Get the smallest sync boundary in the list as the common sync boundary
+    std::sort(sync_boundaries.begin(), sync_boundaries.end(),
+            [&cmp] (const auto& a, const auto& b) { return cmp(a, b) < 0; });
+    repair_sync_boundary sync_boundary_min = sync_boundaries.front();
+    // Check if peers have identical combined hashes and sync boundary
+    bool same_hashes = std::adjacent_find(combined_hashes.begin(), combined_hashes.end(),
+            std::not_equal_to<repair_hash>()) == combined_hashes.end();
+    bool same_boundary = std::adjacent_find(sync_boundaries.begin(), sync_boundaries.end(),
+            [&cmp] (const repair_sync_boundary& a, const repair_sync_boundary& b) { return cmp(a, b) != 0; }) == sync_boundaries.end();
+    rlogger.debug("get_common_sync_boundary: zero_rows={}, same_hashes={}, same_boundary={}, combined_hashes={}, sync_boundaries={}",
+        zero_rows, same_hashes, same_boundary, combined_hashes, sync_boundaries);
+    bool already_synced = same_hashes && same_boundary && !zero_rows;
+    return std::pair<std::optional<repair_sync_boundary>, bool>(sync_boundary_min, already_synced);
+}
+
+future<std::list<repair_row>> take_rows_up_to_boundary(const schema& s, std::list<repair_row>& row_buf, const repair_sync_boundary& boundary) {
+    auto cmp = repair_sync_boundary::tri_compare(s);
+    std::list<repair_row> rows;
+    if (row_buf.empty() || cmp(row_buf.back().boundary(), boundary) <= 0) {
+        // Fast path
+        rows.swap(row_buf);
+        co_return rows;
+    }
+    size_t sz = row_buf.size();
+    for (auto it = row_buf.rbegin(); it != row_buf.rend(); ++it) {
+        // Move the rows > boundary to rows
+        // Delete the rows > boundary from row_buf
+        // Swap rows and row_buf so that rows contains the rows up to
+        // the boundary, and row_buf contains rows after it
+        repair_row& r = *it;
+        if (cmp(r.boundary(), boundary) <= 0) {
+            break;
+        }
+        rows.push_front(std::move(r));
+        co_await coroutine::maybe_yield();
+    }
+    row_buf.resize(row_buf.size() - rows.size());
+    row_buf.swap(rows);
+    if (sz != rows.size() + row_buf.size()) {
+        throw std::runtime_error(format("incorrect row_buf and working_row_buf size, before={}, after={} + {}",
+                                        sz, rows.size(), row_buf.size()));
+    }
+    co_return rows;
+}
+
+future<std::list<repair_row>> copy_rows_within_set_diff(const std::list<repair_row>& rows, const repair_hash_set& set_diff) {
+    std::list<repair_row> ret;
+    for (const auto& r : rows) {
+        if (set_diff.contains(r.hash())) {
+            ret.push_back(r);
+        }
+        co_await coroutine::maybe_yield();
+    }
+    co_return ret;
+}
+
+future<repair_rows_on_wire> to_repair_rows_on_wire(const schema& s, std::list<repair_row> row_list) {
+    repair_rows_on_wire rows;
+    lw_shared_ptr<const decorated_key_with_hash> last_dk_with_hash;
+    for (auto& r : row_list) {
+        const auto& dk_with_hash = r.get_dk_with_hash();
+        // No need to search from the beginning of the rows. Look at the end of repair_rows_on_wire is enough.
+        if (!rows.empty() && last_dk_with_hash && dk_with_hash->dk.tri_compare(s, last_dk_with_hash->dk) == 0) {
+            rows.back().push_mutation_fragment(std::move(r.get_frozen_mutation()));
+        } else {
+            last_dk_with_hash = dk_with_hash;
+            rows.push_back(repair_row_on_wire(dk_with_hash->dk.key(), {std::move(r.get_frozen_mutation())}));
+        }
+        co_await coroutine::maybe_yield();
+    }
+    co_return rows;
+}
+
+// Must run inside a seastar thread
+repair_hash_set
+get_set_diff(const repair_hash_set& x, const repair_hash_set& y) {
+    repair_hash_set set_diff;
+    // Note std::set_difference needs x and y are sorted.
+    std::copy_if(x.begin(), x.end(), std::inserter(set_diff, set_diff.end()),
+            [&y] (auto& item) { thread::maybe_yield(); return !y.contains(item); });
+    return set_diff;
+}
+
 class repair_meta {
     friend repair_meta_tracker;
 public:
@@ -736,6 +862,8 @@ class repair_meta {
     size_t _nr_peer_nodes= 1;
     repair_stats _stats;
     std::optional<repair_reader> _repair_reader;
+    // The sub-range of the last range summary. Reads of rows stop at its end.
+    std::optional<dht::token_range> _summary_range;
     lw_shared_ptr<repair_writer> _repair_writer;
     // Contains rows read from disk
     std::list<repair_row> _row_buf;
@@ -852,7 +980,7 @@ class repair_meta {
                         return rs.get_messaging().make_sink_and_source_for_repair_put_row_diff_with_rpc_stream(repair_meta_id, addr);
                 })
             , _row_level_repair_ptr(row_level_repair_ptr)
-            , _repair_hasher(_seed, _schema)
+            , _repair_hasher(_seed, _schema, _db.local().features().repair_serialized_row_hash)
             , _compaction_time(compaction_time)
             {
             if (master) {
@@ -948,25 +1076,7 @@ class repair_meta {
     get_common_sync_boundary(bool zero_rows,
             std::vector<repair_sync_boundary>& sync_boundaries,
             std::vector<repair_hash>& combined_hashes) {
-        if (sync_boundaries.empty()) {
-            throw std::runtime_error("sync_boundaries is empty");
-        }
-        if(combined_hashes.empty()) {
-            throw std::runtime_error("combined_hashes is empty");
-        }
-        // Get the smallest sync boundary in the list as the common sync boundary
-        std::sort(sync_boundaries.begin(), sync_boundaries.end(),
-                [this] (const auto& a, const auto& b) { return this->_cmp(a, b) < 0; });
-        repair_sync_boundary sync_boundary_min = sync_boundaries.front();
-        // Check if peers have identical combined hashes and sync boundary
-        bool same_hashes = std::adjacent_find(combined_hashes.begin(), combined_hashes.end(),
-                std::not_equal_to<repair_hash>()) == combined_hashes.end();
-        bool same_boundary = std::adjacent_find(sync_boundaries.begin(), sync_boundaries.end(),
-                [this] (const repair_sync_boundary& a, const repair_sync_boundary& b) { return this->_cmp(a, b) != 0; }) == sync_boundaries.end();
-        rlogger.debug("get_common_sync_boundary: zero_rows={}, same_hashes={}, same_boundary={}, combined_hashes={}, sync_boundaries={}",
-            zero_rows, same_hashes, same_boundary, combined_hashes, sync_boundaries);
-        bool already_synced = same_hashes && same_boundary && !zero_rows;
-        return std::pair<std::optional<repair_sync_boundary>, bool>(sync_boundary_min, already_synced);
+        return ::get_common_sync_boundary(*_schema, zero_rows, sync_boundaries, combined_hashes);
     }
 
     future<> close() noexcept {
@@ -1062,6 +1172,12 @@ class repair_meta {
         });
     }
 
+    // Whether mf starts a partition after the sub-range of the last range summary
+    bool is_after_summary_range(const mutation_fragment& mf) const {
+        return _summary_range && mf.is_partition_start()
+                && _summary_range->after(mf.as_partition_start().key().token(), dht::token_comparator());
+    }
+
     void handle_mutation_fragment(mutation_fragment& mf, size_t& cur_size, size_t& new_rows_size, std::list<repair_row>& cur_rows) {
         if (mf.is_partition_start()) {
             auto& start = mf.as_partition_start();
@@ -1074,8 +1190,9 @@ class repair_meta {
             _repair_reader->clear_current_dk();
             return;
         }
-        auto hash = _repair_hasher.do_hash_for_mf(*_repair_reader->get_current_dk(), mf);
-        repair_row r(freeze(*_schema, mf), position_in_partition(mf.position()), _repair_reader->get_current_dk(), hash, is_dirty_on_master::no);
+        auto fmf = freeze(*_schema, mf);
+        auto hash = _repair_hasher.do_hash_for_mf(*_repair_reader->get_current_dk(), mf, fmf);
+        repair_row r(std::move(fmf), position_in_partition(mf.position()), _repair_reader->get_current_dk(), hash, is_dirty_on_master::no);
         rlogger.trace("Reading: r.boundary={}, r.hash={}", r.boundary(), r.hash());
         _metrics.row_from_disk_nr++;
         _metrics.row_from_disk_bytes += r.size();
@@ -1084,15 +1201,7 @@ class repair_meta {
         cur_rows.push_back(std::move(r));
     }
 
-    // Read rows from sstable until the size of rows exceeds _max_row_buf_size  - current_size
-    // This reads rows from where the reader left last time into _row_buf
-    // _current_sync_boundary or _last_sync_boundary have no effect on the reader neither.
-    future<std::tuple<std::list<repair_row>, size_t>>
-    read_rows_from_disk(size_t cur_size) {
-        using value_type = std::tuple<std::list<repair_row>, size_t>;
-        size_t new_rows_size = 0;
-        std::list<repair_row> cur_rows;
-        std::exception_ptr ex;
+    void maybe_create_repair_reader() {
         if (!_repair_reader) {
             _repair_reader.emplace(_db,
                 _cf,
@@ -1149,8 +1258,22 @@ class repair_meta {
                         read_strategy);
                     return read_strategy;
                 }),
-                _compaction_time);
+                _compaction_time,
+                // Only regular repairs can rely on the data repaired before.
+                replica::skip_repaired_sstables(_reason == streaming::stream_reason::repair && _db.local().get_config().incremental_repair()));
         }
+    }
+
+    // Read rows from sstable until the size of rows exceeds _max_row_buf_size  - current_size
+    // This reads rows from where the reader left last time into _row_buf
+    // _current_sync_boundary or _last_sync_boundary have no effect on the reader neither.
+    future<std::tuple<std::list<repair_row>, size_t>>
+    read_rows_from_disk(size_t cur_size) {
+        using value_type = std::tuple<std::list<repair_row>, size_t>;
+        size_t new_rows_size = 0;
+        std::list<repair_row> cur_rows;
+        std::exception_ptr ex;
+        maybe_create_repair_reader();
         try {
             while (cur_size < _max_row_buf_size) {
                 _gate.check();
@@ -1159,6 +1282,10 @@ class repair_meta {
                     co_await _repair_reader->on_end_of_stream();
                     break;
                 }
+                if (is_after_summary_range(*mfopt)) {
+                    _repair_reader->unread_mutation_fragment(std::move(*mfopt));
+                    break;
+                }
                 handle_mutation_fragment(*mfopt, cur_size, new_rows_size, cur_rows);
             }
         } catch (...) {
@@ -1211,33 +1338,62 @@ class repair_meta {
         co_return get_sync_boundary_response{sb_max, row_buf_combined_hash, row_buf_bytes, new_rows_size, new_rows_nr};
     }
 
-    future<> move_row_buf_to_working_row_buf() {
-        if (_cmp(_row_buf.back().boundary(), *_current_sync_boundary) <= 0) {
-            // Fast path
-            _working_row_buf.swap(_row_buf);
-            co_return;
-        }
-        size_t sz = _row_buf.size();
-        for (auto it = _row_buf.rbegin(); it != _row_buf.rend(); ++it) {
-            // Move the rows > _current_sync_boundary to _working_row_buf
-            // Delete the rows > _current_sync_boundary from _row_buf
-            // Swap _working_row_buf and _row_buf so that _working_row_buf
-            // contains rows within (_last_sync_boundary,
-            // _current_sync_boundary], _row_buf contains rows wthin
-            // (_current_sync_boundary, ...]
-            repair_row& r = *it;
-            if (_cmp(r.boundary(), *_current_sync_boundary) <= 0) {
-                break;
+    // Read the rows of the given sub-range, which must follow the sub-range of
+    // the previous call, and return their combined hash. The rows replace the
+    // ones in _row_buf if they fit in _max_row_buf_size, so that they can be
+    // synced without reading them again.
+    future<repair_range_summary>
+    get_range_summary(dht::token_range range) {
+        co_await clear_row_buf();
+        _summary_range = std::move(range);
+        repair_range_summary summary{repair_hash(), true};
+        size_t cur_size = 0;
+        size_t new_rows_size = 0;
+        std::list<repair_row> cur_rows;
+        std::exception_ptr ex;
+        maybe_create_repair_reader();
+        try {
+            while (true) {
+                _gate.check();
+                mutation_fragment_opt mfopt = co_await _repair_reader->read_mutation_fragment();
+                if (!mfopt) {
+                    co_await _repair_reader->on_end_of_stream();
+                    break;
+                }
+                if (is_after_summary_range(*mfopt)) {
+                    _repair_reader->unread_mutation_fragment(std::move(*mfopt));
+                    break;
+                }
+                auto nr_rows = cur_rows.size();
+                handle_mutation_fragment(*mfopt, cur_size, new_rows_size, cur_rows);
+                if (cur_rows.size() != nr_rows) {
+                    summary.hash.add(cur_rows.back().hash());
+                    if (!summary.rows_kept) {
+                        cur_rows.pop_back();
+                    } else if (cur_size > _max_row_buf_size) {
+                        // The rows will be read again if they are not in sync.
+                        summary.rows_kept = false;
+                        co_await utils::clear_gently(cur_rows);
+                    }
+                }
+                co_await coroutine::maybe_yield();
             }
-            _working_row_buf.push_front(std::move(r));
-            co_await coroutine::maybe_yield();
+        } catch (...) {
+            ex = std::current_exception();
         }
-        _row_buf.resize(_row_buf.size() - _working_row_buf.size());
-        _row_buf.swap(_working_row_buf);
-        if (sz != _working_row_buf.size() + _row_buf.size()) {
-            throw std::runtime_error(format("incorrect row_buf and working_row_buf size, before={}, after={} + {}",
-                                            sz, _working_row_buf.size(), _row_buf.size()));
+        if (ex) {
+            co_await _repair_reader->on_end_of_stream();
+            co_await coroutine::return_exception_ptr(std::move(ex));
         }
+        _repair_reader->pause();
+        _row_buf = std::move(cur_rows);
+        rlogger.debug("get_range_summary: meta_id={}, range={}, sub_range={}, hash={}, rows_kept={}, rows_size={}",
+                _repair_meta_id, _range, _summary_range, summary.hash, summary.rows_kept, new_rows_size);
+        co_return summary;
+    }
+
+    future<> move_row_buf_to_working_row_buf() {
+        _working_row_buf = co_await take_rows_up_to_boundary(*_schema, _row_buf, *_current_sync_boundary);
     }
 
     // Move rows from <_row_buf> to <_working_row_buf> according to
@@ -1280,16 +1436,7 @@ class repair_meta {
 
     future<std::list<repair_row>>
     copy_rows_from_working_row_buf_within_set_diff(repair_hash_set set_diff) {
-        return do_with(std::list<repair_row>(), std::move(set_diff),
-                [this] (std::list<repair_row>& rows, repair_hash_set& set_diff) {
-            return do_for_each(_working_row_buf, [&set_diff, &rows] (const repair_row& r) {
-                if (set_diff.contains(r.hash())) {
-                    rows.push_back(r);
-                }
-            }).then([&rows] {
-                return std::move(rows);
-            });
-        });
+        co_return co_await copy_rows_within_set_diff(_working_row_buf, set_diff);
     }
 
     // Return rows in the _working_row_buf with hash within the given sef_diff
@@ -1389,35 +1536,11 @@ class repair_meta {
     }
 
     future<repair_rows_on_wire> to_repair_rows_on_wire(std::list<repair_row> row_list) {
-        lw_shared_ptr<const decorated_key_with_hash> last_dk_with_hash;
-        return do_with(repair_rows_on_wire(), std::move(row_list), std::move(last_dk_with_hash),
-                [this] (repair_rows_on_wire& rows, std::list<repair_row>& row_list, lw_shared_ptr<const decorated_key_with_hash>& last_dk_with_hash) {
-            return get_repair_rows_size(row_list).then([this, &rows, &row_list, &last_dk_with_hash] (size_t row_bytes) {
-                _metrics.tx_row_nr += row_list.size();
-                _metrics.tx_row_bytes += row_bytes;
-                return do_for_each(row_list, [this, &rows, &last_dk_with_hash] (repair_row& r) {
-                    const auto& dk_with_hash = r.get_dk_with_hash();
-                    // No need to search from the beginning of the rows. Look at the end of repair_rows_on_wire is enough.
-                    if (rows.empty()) {
-                        auto pk = dk_with_hash->dk.key();
-                        last_dk_with_hash = dk_with_hash;
-                        rows.push_back(repair_row_on_wire(std::move(pk), {std::move(r.get_frozen_mutation())}));
-                    } else {
-                        auto& row = rows.back();
-                        if (last_dk_with_hash && dk_with_hash->dk.tri_compare(*_schema, last_dk_with_hash->dk) == 0) {
-                            row.push_mutation_fragment(std::move(r.get_frozen_mutation()));
-                        } else {
-                            auto pk = dk_with_hash->dk.key();
-                            last_dk_with_hash = dk_with_hash;
-                            rows.push_back(repair_row_on_wire(std::move(pk), {std::move(r.get_frozen_mutation())}));
-                        }
-                    }
-                }).then([&rows] {
-                    return std::move(rows);
-                });
-            });
-        });
-    };
+        size_t row_bytes = co_await get_repair_rows_size(row_list);
+        _metrics.tx_row_nr += row_list.size();
+        _metrics.tx_row_bytes += row_bytes;
+        co_return co_await ::to_repair_rows_on_wire(*_schema, std::move(row_list));
+    }
 
 public:
     // RPC API
@@ -1653,6 +1776,26 @@ class repair_meta {
         });
     }
 
+    // RPC API
+    // Return the combined hash of the rows in the given sub-range
+    future<repair_range_summary>
+    get_range_summary(gms::inet_address remote_node, dht::token_range range) {
+        if (remote_node == _myip) {
+            return get_range_summary_handler(std::move(range));
+        }
+        stats().rpc_call_nr++;
+        return ser::partition_checksum_rpc_verbs::send_repair_get_range_summary(&_messaging, msg_addr(remote_node), _repair_meta_id, range);
+    }
+
+    // RPC handler
+    future<repair_range_summary>
+    get_range_summary_handler(dht::token_range range) {
+        return with_gate(_gate, [this, range = std::move(range)] () mutable {
+            _cf.update_off_strategy_trigger();
+            return get_range_summary(std::move(range));
+        });
+    }
+
     // RPC API
     // Return rows in the _working_row_buf with hash within the given sef_diff
     // Must run inside a seastar thread
@@ -1912,16 +2055,6 @@ class repair_meta {
     }
 };
 
-// Must run inside a seastar thread
-static repair_hash_set
-get_set_diff(const repair_hash_set& x, const repair_hash_set& y) {
-    repair_hash_set set_diff;
-    // Note std::set_difference needs x and y are sorted.
-    std::copy_if(x.begin(), x.end(), std::inserter(set_diff, set_diff.end()),
-            [&y] (auto& item) { thread::maybe_yield(); return !y.contains(item); });
-    return set_diff;
-}
-
 static future<stop_iteration> repair_get_row_diff_with_rpc_stream_process_op(
         sharded<repair_service>& repair,
         gms::inet_address from,
@@ -2190,6 +2323,22 @@ future<repair_update_system_table_response> repair_service::repair_update_system
         auto& gc_state = local_db.get_compaction_manager().get_tombstone_gc_state();
         return gc_state.update_repair_time(req.table_uuid, req.range, req.repair_time);
     });
+    if (db.local().get_config().incremental_repair()) {
+        co_await db.invoke_on_all([&req] (replica::database& local_db) {
+            try {
+                auto& table = local_db.find_column_family(req.table_uuid);
+                if (table.uses_tablets()) {
+                    return make_ready_future<>();
+                }
+                return with_gate(table.async_gate(), [&local_db, &table, &req] {
+                    return table.mark_repaired_sstables(local_db.get_keyspace_local_ranges(req.keyspace_name));
+                });
+            } catch (replica::no_such_column_family&) {
+                // The table was dropped, nothing to mark.
+                return make_ready_future<>();
+            }
+        });
+    }
     db::system_keyspace::repair_history_entry ent;
     ent.id = req.repair_uuid;
     ent.table_uuid = req.table_uuid;
@@ -2407,6 +2556,18 @@ future<> repair_service::init_ms_handlers() {
         auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return repair_flush_hints_batchlog_handler(from, std::move(req));
     });
+    ser::partition_checksum_rpc_verbs::register_repair_get_range_summary(&ms, [this] (const rpc::client_info& cinfo, uint32_t repair_meta_id, dht::token_range range) {
+        auto src_cpu_id = cinfo.retrieve_auxiliary<uint32_t>("src_cpu_id");
+        auto from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
+        return container().invoke_on(src_cpu_id % smp::count, [from, repair_meta_id, range = std::move(range)] (repair_service& local_repair) mutable {
+            auto rm = local_repair.get_repair_meta(from, repair_meta_id);
+            rm->set_repair_state_for_local_node(repair_state::get_range_summary_started);
+            return rm->get_range_summary_handler(std::move(range)).then([rm] (repair_range_summary summary) {
+                rm->set_repair_state_for_local_node(repair_state::get_range_summary_finished);
+                return summary;
+            });
+        });
+    });
 
     return make_ready_future<>();
 }
@@ -2429,7 +2590,8 @@ future<> repair_service::uninit_ms_handlers() {
         ms.unregister_repair_set_estimated_partitions(),
         ms.unregister_repair_get_diff_algorithms(),
         ser::partition_checksum_rpc_verbs::unregister_repair_update_system_table(&ms),
-        ser::partition_checksum_rpc_verbs::unregister_repair_flush_hints_batchlog(&ms)
+        ser::partition_checksum_rpc_verbs::unregister_repair_flush_hints_batchlog(&ms),
+        ser::partition_checksum_rpc_verbs::unregister_repair_get_range_summary(&ms)
         ).discard_result();
 }
 
@@ -2497,6 +2659,9 @@ class row_level_repair {
     // A flag indicates any error during the repair
     bool _failed = false;
 
+    // A flag indicates the table was dropped during the repair
+    bool _table_dropped = false;
+
     // Seed for the repair row hashing. If we ever had a hash conflict for a row
     // and we are not using stable hash, there is chance we will fix the row in
     // the next repair.
@@ -2536,7 +2701,7 @@ class row_level_repair {
 
     size_t get_max_row_buf_size(row_level_diff_detect_algorithm algo) {
         // Max buffer size per repair round
-        return is_rpc_stream_supported(algo) ?  repair::task_manager_module::max_repair_memory_per_range : 256 * 1024;
+        return _shard_task.row_buf_size(is_rpc_stream_supported(algo) ?  repair::task_manager_module::max_repair_memory_per_range : 256 * 1024);
     }
 
     // Step A: Negotiate sync boundary to use
@@ -2828,25 +2993,184 @@ class row_level_repair {
         co_return;
     }
 
+    // Runs `func` with a repair_meta for the range on the local node, after
+    // the repair followers created theirs. Must run inside a seastar thread.
+    void with_repair_meta(const dht::token_range& range, row_level_diff_detect_algorithm algorithm, gc_clock::time_point compaction_time,
+            noncopyable_function<void (repair_meta&)> func) {
+        _shard_task.check_in_abort_or_shutdown();
+        auto repair_meta_id = _shard_task.rs.get_next_repair_meta_id().get0();
+        auto max_row_buf_size = get_max_row_buf_size(algorithm);
+        auto master_node_shard_config = shard_config {
+                this_shard_id(),
+                _shard_task.sharder.shard_count(),
+                _shard_task.sharder.sharding_ignore_msb()
+        };
+        auto s = _cf.schema();
+        auto schema_version = s->version();
+
+        auto permit = _shard_task.db.local().obtain_reader_permit(_cf, "repair-meta", db::no_timeout, {}).get0();
+
+        repair_meta master(_shard_task.rs,
+                _cf,
+                s,
+                std::move(permit),
+                range,
+                algorithm,
+                max_row_buf_size,
+                _seed,
+                repair_master::yes,
+                repair_meta_id,
+                _shard_task.reason(),
+                std::move(master_node_shard_config),
+                _all_live_peer_nodes,
+                _all_live_peer_nodes.size(),
+                this,
+                compaction_time);
+        auto auto_stop_master = defer([&master] {
+            master.stop().handle_exception([] (std::exception_ptr ep) {
+                rlogger.warn("Failed auto-stopping Row Level Repair (Master): {}. Ignored.", ep);
+            }).get();
+        });
+
+        rlogger.debug(">>> Started Row Level Repair (Master): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, schema_version={}, range={}, seed={}, max_row_buf_size={}",
+                master.myip(), _all_live_peer_nodes, master.repair_meta_id(), _shard_task.get_keyspace(), _cf_name, schema_version, range, _seed, max_row_buf_size);
+
+
+        std::vector<gms::inet_address> nodes_to_stop;
+        nodes_to_stop.reserve(master.all_nodes().size());
+        _estimated_partitions = 0;
+        try {
+            parallel_for_each(master.all_nodes(), [&, this] (repair_node_state& ns) {
+                const auto& node = ns.node;
+                ns.state = repair_state::row_level_start_started;
+                return master.repair_row_level_start(node, _shard_task.get_keyspace(), _cf_name, range, schema_version, _shard_task.reason(), compaction_time).then([&] () {
+                    ns.state = repair_state::row_level_start_finished;
+                    nodes_to_stop.push_back(node);
+                    ns.state = repair_state::get_estimated_partitions_started;
+                    return master.repair_get_estimated_partitions(node).then([this, node, &ns] (uint64_t partitions) {
+                        ns.state = repair_state::get_estimated_partitions_finished;
+                        rlogger.trace("Get repair_get_estimated_partitions for node={}, estimated_partitions={}", node, partitions);
+                        _estimated_partitions += partitions;
+                    });
+                });
+            }).get();
+
+            parallel_for_each(master.all_nodes(), [&, this] (repair_node_state& ns) {
+                const auto& node = ns.node;
+                rlogger.trace("Get repair_set_estimated_partitions for node={}, estimated_partitions={}", node, _estimated_partitions);
+                ns.state = repair_state::set_estimated_partitions_started;
+                return master.repair_set_estimated_partitions(node, _estimated_partitions).then([&ns] {
+                    ns.state = repair_state::set_estimated_partitions_finished;
+                });
+            }).get();
+
+            func(master);
+        } catch (replica::no_such_column_family& e) {
+            _table_dropped = true;
+            rlogger.warn("repair[{}]: shard={}, keyspace={}, cf={}, range={}, got error in row level repair: {}",
+                    _shard_task.global_repair_id.uuid(), this_shard_id(), _shard_task.get_keyspace(), _cf_name, range, e);
+            _failed = true;
+        } catch (std::exception& e) {
+            rlogger.warn("repair[{}]: shard={}, keyspace={}, cf={}, range={}, got error in row level repair: {}",
+                    _shard_task.global_repair_id.uuid(), this_shard_id(), _shard_task.get_keyspace(), _cf_name, range, e);
+            // In case the repair process fail, we need to call repair_row_level_stop to clean up repair followers
+            _failed = true;
+        }
+
+        parallel_for_each(nodes_to_stop, [&] (const gms::inet_address& node) {
+            master.set_repair_state(repair_state::row_level_stop_started, node);
+            return master.repair_row_level_stop(node, _shard_task.get_keyspace(), _cf_name, range).then([node, &master] {
+                master.set_repair_state(repair_state::row_level_stop_finished, node);
+            });
+        }).get();
+
+        _shard_task.update_statistics(master.stats());
+        rlogger.debug("<<< Finished Row Level Repair (Master): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, range={}, tx_hashes_nr={}, rx_hashes_nr={}, tx_row_nr={}, rx_row_nr={}, row_from_disk_bytes={}, row_from_disk_nr={}",
+                master.myip(), _all_live_peer_nodes, master.repair_meta_id(), _shard_task.get_keyspace(), _cf_name, range, master.stats().tx_hashes_nr, master.stats().rx_hashes_nr, master.stats().tx_row_nr, master.stats().rx_row_nr, master.stats().row_from_disk_bytes, master.stats().row_from_disk_nr);
+    }
+
+    // Compare the combined hash of each sub-range of the range on all the
+    // nodes, one sub-range after the other, and sync the sub-ranges whose
+    // hashes differ right away, from the rows the nodes kept while hashing
+    // them. Return the out of sync sub-ranges, with adjacent ones merged,
+    // which some node could not keep the rows of, so they have to be read
+    // again to be synced. Must run inside a seastar thread.
+    dht::token_range_vector sync_unsynced_ranges(repair_meta& master, size_t nr_splits) {
+        auto ranges = split_range_for_summary(_range, nr_splits);
+        std::vector<repair_range_summary> summaries(master.all_nodes().size());
+        dht::token_range_vector to_reread;
+        size_t nr_unsynced = 0;
+        std::optional<size_t> last_reread;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            _shard_task.check_in_abort_or_shutdown();
+            parallel_for_each(boost::irange(size_t(0), master.all_nodes().size()), [&, this] (size_t idx) {
+                auto& ns = master.all_nodes()[idx];
+                ns.state = repair_state::get_range_summary_started;
+                return master.get_range_summary(ns.node, ranges[i]).then([&, idx] (repair_range_summary summary) {
+                    master.all_nodes()[idx].state = repair_state::get_range_summary_finished;
+                    summaries[idx] = summary;
+                }).handle_exception([this, &master, idx] (std::exception_ptr ep) {
+                    auto& node = master.all_nodes()[idx].node;
+                    auto s = _cf.schema();
+                    rlogger.warn("repair[{}]: get_range_summary: got error from node={}, keyspace={}, table={}, range={}, error={}",
+                            _shard_task.global_repair_id.uuid(), node, s->ks_name(), s->cf_name(), _range, ep);
+                    return make_exception_future<>(std::move(ep));
+                });
+            }).get();
+            bool synced = std::all_of(summaries.begin(), summaries.end(), [&] (const repair_range_summary& summary) {
+                return summary.hash == summaries.front().hash;
+            });
+            if (synced) {
+                continue;
+            }
+            ++nr_unsynced;
+            bool rows_kept = std::all_of(summaries.begin(), summaries.end(), std::mem_fn(&repair_range_summary::rows_kept));
+            if (rows_kept) {
+                sync_rows(master);
+                continue;
+            }
+            // Sync adjacent sub-ranges together
+            if (last_reread && *last_reread + 1 == i) {
+                to_reread.back() = dht::token_range(to_reread.back().start(), ranges[i].end());
+            } else {
+                to_reread.push_back(ranges[i]);
+            }
+            last_reread = i;
+        }
+        rlogger.debug("repair[{}]: keyspace={}, cf={}, range={}, {} out of {} sub-ranges are not synced, these have to be read again: {}",
+                _shard_task.global_repair_id.uuid(), _shard_task.get_keyspace(), _cf_name, _range, nr_unsynced, ranges.size(), to_reread);
+        return to_reread;
+    }
+
+    // Sync the rows of the range, which the repair_meta was created for, on all the nodes.
+    // Must run inside a seastar thread.
+    void sync_rows(repair_meta& master) {
+        _common_sync_boundary = std::nullopt;
+        _skipped_sync_boundary = std::nullopt;
+        while (true) {
+            auto status = negotiate_sync_boundary(master);
+            if (status == op_status::next_round) {
+                continue;
+            } else if (status == op_status::all_done) {
+                break;
+            }
+            status = get_missing_rows_from_follower_nodes(master);
+            if (status == op_status::next_round) {
+                continue;
+            }
+            send_missing_rows_to_follower_nodes(master);
+        }
+    }
+
 public:
     future<> run() {
         return seastar::async([this] {
             _shard_task.check_in_abort_or_shutdown();
-            auto repair_meta_id = _shard_task.rs.get_next_repair_meta_id().get0();
             auto algorithm = get_common_diff_detect_algorithm(_shard_task.messaging.local(), _all_live_peer_nodes);
-            auto max_row_buf_size = get_max_row_buf_size(algorithm);
-            auto master_node_shard_config = shard_config {
-                    this_shard_id(),
-                    _shard_task.sharder.shard_count(),
-                    _shard_task.sharder.sharding_ignore_msb()
-            };
-            auto s = _cf.schema();
-            auto schema_version = s->version();
-            bool table_dropped = false;
 
             auto& mem_sem = _shard_task.rs.memory_sem();
             auto max = _shard_task.rs.max_repair_memory();
-            auto wanted = (_all_live_peer_nodes.size() + 1) * repair::task_manager_module::max_repair_memory_per_range;
+            auto wanted = (_all_live_peer_nodes.size() + 1) * _shard_task.row_buf_size(repair::task_manager_module::max_repair_memory_per_range);
             wanted = std::min(max, wanted);
             rlogger.trace("repair[{}]: Started to get memory budget, wanted={}, available={}, max_repair_memory={}",
                     _shard_task.global_repair_id.uuid(), wanted, mem_sem.current(), max);
@@ -2854,98 +3178,31 @@ class row_level_repair {
             rlogger.trace("repair[{}]: Finished to get memory budget, wanted={}, available={}, max_repair_memory={}",
                     _shard_task.global_repair_id.uuid(), wanted, mem_sem.current(), max);
 
-            auto permit = _shard_task.db.local().obtain_reader_permit(_cf, "repair-meta", db::no_timeout, {}).get0();
-
             auto compaction_time = gc_clock::now();
 
-            repair_meta master(_shard_task.rs,
-                    _cf,
-                    s,
-                    std::move(permit),
-                    _range,
-                    algorithm,
-                    max_row_buf_size,
-                    _seed,
-                    repair_master::yes,
-                    repair_meta_id,
-                    _shard_task.reason(),
-                    std::move(master_node_shard_config),
-                    _all_live_peer_nodes,
-                    _all_live_peer_nodes.size(),
-                    this,
-                    compaction_time);
-            auto auto_stop_master = defer([&master] {
-                master.stop().handle_exception([] (std::exception_ptr ep) {
-                    rlogger.warn("Failed auto-stopping Row Level Repair (Master): {}. Ignored.", ep);
-                }).get();
-            });
-
-            rlogger.debug(">>> Started Row Level Repair (Master): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, schema_version={}, range={}, seed={}, max_row_buf_size={}",
-                    master.myip(), _all_live_peer_nodes, master.repair_meta_id(), _shard_task.get_keyspace(), _cf_name, schema_version, _range, _seed, max_row_buf_size);
-
-
-            std::vector<gms::inet_address> nodes_to_stop;
-            nodes_to_stop.reserve(master.all_nodes().size());
-            try {
-                parallel_for_each(master.all_nodes(), [&, this] (repair_node_state& ns) {
-                    const auto& node = ns.node;
-                    ns.state = repair_state::row_level_start_started;
-                    return master.repair_row_level_start(node, _shard_task.get_keyspace(), _cf_name, _range, schema_version, _shard_task.reason(), compaction_time).then([&] () {
-                        ns.state = repair_state::row_level_start_finished;
-                        nodes_to_stop.push_back(node);
-                        ns.state = repair_state::get_estimated_partitions_started;
-                        return master.repair_get_estimated_partitions(node).then([this, node, &ns] (uint64_t partitions) {
-                            ns.state = repair_state::get_estimated_partitions_finished;
-                            rlogger.trace("Get repair_get_estimated_partitions for node={}, estimated_partitions={}", node, partitions);
-                            _estimated_partitions += partitions;
-                        });
-                    });
-                }).get();
-
-                parallel_for_each(master.all_nodes(), [&, this] (repair_node_state& ns) {
-                    const auto& node = ns.node;
-                    rlogger.trace("Get repair_set_estimated_partitions for node={}, estimated_partitions={}", node, _estimated_partitions);
-                    ns.state = repair_state::set_estimated_partitions_started;
-                    return master.repair_set_estimated_partitions(node, _estimated_partitions).then([&ns] {
-                        ns.state = repair_state::set_estimated_partitions_finished;
-                    });
-                }).get();
-
-                while (true) {
-                    auto status = negotiate_sync_boundary(master);
-                    if (status == op_status::next_round) {
-                        continue;
-                    } else if (status == op_status::all_done) {
-                        break;
-                    }
-                    status = get_missing_rows_from_follower_nodes(master);
-                    if (status == op_status::next_round) {
-                        continue;
-                    }
-                    send_missing_rows_to_follower_nodes(master);
-                }
-            } catch (replica::no_such_column_family& e) {
-                table_dropped = true;
-                rlogger.warn("repair[{}]: shard={}, keyspace={}, cf={}, range={}, got error in row level repair: {}",
-                        _shard_task.global_repair_id.uuid(), this_shard_id(), _shard_task.get_keyspace(), _cf_name, _range, e);
-                _failed = true;
-            } catch (std::exception& e) {
-                rlogger.warn("repair[{}]: shard={}, keyspace={}, cf={}, range={}, got error in row level repair: {}",
-                        _shard_task.global_repair_id.uuid(), this_shard_id(), _shard_task.get_keyspace(), _cf_name, _range, e);
-                // In case the repair process fail, we need to call repair_row_level_stop to clean up repair followers
-                _failed = true;
+            // Most of the time the replicas are in sync. Find the parts of
+            // the range which are not, by comparing one hash per sub-range,
+            // and sync the rows of those parts only.
+            dht::token_range_vector ranges{_range};
+            auto& db = _shard_task.db.local();
+            size_t nr_splits = db.get_config().repair_range_summary_splits();
+            if (nr_splits > 1 && db.features().repair_range_summary) {
+                with_repair_meta(_range, algorithm, compaction_time, [&] (repair_meta& master) {
+                    ranges = sync_unsynced_ranges(master, nr_splits);
+                });
             }
 
-            parallel_for_each(nodes_to_stop, [&] (const gms::inet_address& node) {
-                master.set_repair_state(repair_state::row_level_stop_started, node);
-                return master.repair_row_level_stop(node, _shard_task.get_keyspace(), _cf_name, _range).then([node, &master] {
-                    master.set_repair_state(repair_state::row_level_stop_finished, node);
+            for (const auto& range : ranges) {
+                if (_failed) {
+                    break;
+                }
+                with_repair_meta(range, algorithm, compaction_time, [this] (repair_meta& master) {
+                    sync_rows(master);
                 });
-            }).get();
+            }
 
-            _shard_task.update_statistics(master.stats());
             if (_failed) {
-                if (table_dropped) {
+                if (_table_dropped) {
                     throw replica::no_such_column_family(_shard_task.get_keyspace(),  _cf_name);
                 } else {
                     throw std::runtime_error(format("Failed to repair for keyspace={}, cf={}, range={}", _shard_task.get_keyspace(), _cf_name, _range));
@@ -2953,12 +3210,27 @@ class row_level_repair {
             } else {
                 update_system_repair_table().get();
             }
-            rlogger.debug("<<< Finished Row Level Repair (Master): local={}, peers={}, repair_meta_id={}, keyspace={}, cf={}, range={}, tx_hashes_nr={}, rx_hashes_nr={}, tx_row_nr={}, rx_row_nr={}, row_from_disk_bytes={}, row_from_disk_nr={}",
-                    master.myip(), _all_live_peer_nodes, master.repair_meta_id(), _shard_task.get_keyspace(), _cf_name, _range, master.stats().tx_hashes_nr, master.stats().rx_hashes_nr, master.stats().tx_row_nr, master.stats().rx_row_nr, master.stats().row_from_disk_bytes, master.stats().row_from_disk_nr);
         });
     }
 };
 
+dht::token_range_vector split_range_for_summary(const dht::token_range& range, size_t nr) {
+    auto start = range.start() ? dht::token::to_int64(range.start()->value()) : std::numeric_limits<int64_t>::min();
+    auto end = range.end() ? dht::token::to_int64(range.end()->value()) : std::numeric_limits<int64_t>::max();
+    auto span = uint64_t(end) - uint64_t(start);
+    auto step = std::max(span / nr, uint64_t(1));
+    dht::token_range_vector ranges;
+    ranges.reserve(nr);
+    auto prev = range.start();
+    for (uint64_t offset = step; ranges.size() + 1 < nr && offset < span; offset += step) {
+        auto t = dht::token::from_int64(int64_t(uint64_t(start) + offset));
+        ranges.emplace_back(prev, dht::token_range::bound(t, true));
+        prev = dht::token_range::bound(t, false);
+    }
+    ranges.emplace_back(prev, range.end());
+    return ranges;
+}
+
 future<> repair_cf_range_row_level(repair::shard_repair_task_impl& shard_task,
         sstring cf_name, table_id table_id, dht::token_range range,
         const std::vector<gms::inet_address>& all_peer_nodes) {
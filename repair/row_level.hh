@@ -242,6 +242,10 @@ class repair_row;
 class repair_hasher;
 class repair_writer;
 
+// Split the range, which has the (start, end] form, into at most nr
+// sub-ranges spanning roughly the same number of tokens, for the range
+// summary pass of row level repair.
+dht::token_range_vector split_range_for_summary(const dht::token_range& range, size_t nr);
 future<> repair_cf_range_row_level(repair::shard_repair_task_impl& shard_task,
         sstring cf_name, table_id table_id, dht::token_range range,
         const std::vector<gms::inet_address>& all_peer_nodes);
@@ -249,3 +253,19 @@ future<std::list<repair_row>> to_repair_rows_list(repair_rows_on_wire rows,
         schema_ptr s, uint64_t seed, repair_master is_master,
         reader_permit permit, repair_hasher hasher);
 void flush_rows(schema_ptr s, std::list<repair_row>& rows, lw_shared_ptr<repair_writer>& writer);
+
+// The steps of a round of row level repair which do not depend on where the
+// rows of a node come from.
+
+// Picks the smallest of the sync boundaries proposed by the nodes as the
+// common one, and tells whether the nodes are already in sync up to it.
+std::pair<std::optional<repair_sync_boundary>, bool>
+get_common_sync_boundary(const schema& s, bool zero_rows,
+        std::vector<repair_sync_boundary>& sync_boundaries,
+        std::vector<repair_hash>& combined_hashes);
+// Moves the rows up to and including the boundary out of the row buffer.
+future<std::list<repair_row>> take_rows_up_to_boundary(const schema& s, std::list<repair_row>& row_buf, const repair_sync_boundary& boundary);
+future<std::list<repair_row>> copy_rows_within_set_diff(const std::list<repair_row>& rows, const repair_hash_set& set_diff);
+future<repair_rows_on_wire> to_repair_rows_on_wire(const schema& s, std::list<repair_row> row_list);
+// Must run inside a seastar thread
+repair_hash_set get_set_diff(const repair_hash_set& x, const repair_hash_set& y);
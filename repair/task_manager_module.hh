@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/timer.hh>
+
 #include "node_ops/node_ops_ctl.hh"
 #include "repair/repair.hh"
 #include "tasks/task_manager.hh"
@@ -98,6 +101,48 @@ class data_sync_repair_task_impl : public repair_task_impl {
     virtual std::optional<double> expected_children_number() const override;
 };
 
+// Adjusts the resources used by a repair job on one shard to the pressure the
+// foreground workload is under, in the spirit of the compaction controller.
+// Periodically, it samples the p99 latency of the local reads and writes of the
+// repaired tables, and whether user reads are queued for admission, which means
+// the disk or memory has no headroom left. Under pressure, the number of ranges
+// repaired in parallel and the size of the row buffers are halved. Otherwise,
+// they grow back linearly, up to their configured maximum.
+class repair_controller {
+public:
+    static constexpr size_t min_row_buf_size = 256 * 1024;
+    static constexpr std::chrono::seconds adjust_interval = std::chrono::seconds(1);
+private:
+    replica::database& _db;
+    std::vector<table_id> _table_ids;
+    std::chrono::microseconds _latency_target;
+    size_t _max_parallelism;
+    size_t _parallelism;
+    size_t _max_row_buf_size;
+    size_t _row_buf_size;
+    semaphore _ranges_parallelism;
+    timer<lowres_clock> _adjust_timer;
+private:
+    bool under_pressure() const;
+    void adjust();
+public:
+    repair_controller(replica::database& db, std::vector<table_id> table_ids, std::chrono::microseconds latency_target,
+            size_t max_parallelism, size_t max_row_buf_size);
+
+    // Units of this semaphore have to be held while repairing a range.
+    semaphore& ranges_parallelism() noexcept {
+        return _ranges_parallelism;
+    }
+
+    size_t row_buf_size() const noexcept {
+        return _row_buf_size;
+    }
+
+    void stop() noexcept {
+        _adjust_timer.cancel();
+    }
+};
+
 class shard_repair_task_impl : public repair_task_impl {
 public:
     repair_service& rs;
@@ -127,6 +172,7 @@ class shard_repair_task_impl : public repair_task_impl {
     bool _aborted = false;
     std::optional<sstring> _failed_because;
     std::optional<semaphore> _user_ranges_parallelism;
+    std::unique_ptr<repair_controller> _controller;
     uint64_t _ranges_complete = 0;
 public:
     shard_repair_task_impl(tasks::task_manager::module_ptr module,
@@ -163,6 +209,12 @@ class shard_repair_task_impl : public repair_task_impl {
         return _hints_batchlog_flushed;
     }
 
+    // The size of the buffer of rows for a round of repair, at most max,
+    // shrunk by the repair controller under pressure.
+    size_t row_buf_size(size_t max) const noexcept {
+        return _controller ? std::min(max, _controller->row_buf_size()) : max;
+    }
+
     future<> repair_range(const dht::token_range& range, table_info table);
 
     size_t ranges_size() const noexcept;
@@ -193,6 +245,7 @@ class task_manager_module : public tasks::task_manager::module {
     // The semaphore used to control the maximum
     // ranges that can be repaired in parallel.
     named_semaphore _range_parallelism_semaphore;
+    size_t _max_range_parallelism;
     seastar::condition_variable _done_cond;
     void start(repair_uniq_id id);
     void done(repair_uniq_id id, bool succeeded);
@@ -221,6 +274,9 @@ class task_manager_module : public tasks::task_manager::module {
     size_t nr_running_repair_jobs();
     void abort_all_repairs();
     named_semaphore& range_parallelism_semaphore();
+    size_t max_range_parallelism() const noexcept {
+        return _max_range_parallelism;
+    }
     future<> run(repair_uniq_id id, std::function<void ()> func);
     future<repair_status> repair_await_completion(int id, std::chrono::steady_clock::time_point timeout);
     float report_progress();
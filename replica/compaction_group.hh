@@ -34,7 +34,7 @@ class compaction_group {
     table& _t;
     class table_state;
     std::unique_ptr<table_state> _table_state;
-    const size_t _group_id;
+    size_t _group_id;
     // Tokens included in this compaction_groups
     dht::token_range _token_range;
     compaction::compaction_strategy_state _compaction_strategy_state;
@@ -51,6 +51,9 @@ class compaction_group {
     seastar::condition_variable _staging_done_condition;
     // Gates async operations confined to a single group.
     seastar::gate _async_gate;
+    // Requests served by the group, reported as tablet load.
+    uint64_t _reads = 0;
+    uint64_t _writes = 0;
 private:
     // Adds new sstable to the set of sstables
     // Doesn't update the cache. The cache must be synchronized in order for reads to see
@@ -66,6 +69,7 @@ class compaction_group {
     static uint64_t calculate_disk_space_used_for(const sstables::sstable_set& set);
 
     future<> delete_sstables_atomically(std::vector<sstables::shared_sstable> sstables_to_remove);
+    future<> split_misplaced_sstable(sstables::shared_sstable sst, bool maintenance);
 public:
     compaction_group(table& t, size_t gid, dht::token_range token_range);
 
@@ -73,6 +77,18 @@ class compaction_group {
         return _group_id;
     }
 
+    // Makes the group own a sub-range of its range, when compaction groups are split.
+    // Data which is left outside the range must be moved to the groups owning it,
+    // see split_misplaced_sstables().
+    void narrow(size_t gid, dht::token_range token_range) noexcept;
+
+    // Returns true iff some sstables of the group have data outside of its token range.
+    bool has_misplaced_sstables() const;
+
+    // Rewrites sstables which have data outside of the group's token range into
+    // sstables confined to the groups owning the data, with compaction disabled.
+    future<> split_misplaced_sstables();
+
     // Stops all activity in the group, synchronizes with in-flight writes, before
     // flushing memtable(s), so all data can be found in the SSTable set.
     future<> stop() noexcept;
@@ -101,6 +117,8 @@ class compaction_group {
     size_t memtable_count() const noexcept;
     // Returns minimum timestamp from memtable list
     api::timestamp_type min_memtable_timestamp() const;
+    // Returns minimum timestamp from the memtables holding the partition
+    api::timestamp_type min_memtable_timestamp(const dht::decorated_key& dk) const;
     // Add sstable to main set
     void add_sstable(sstables::shared_sstable sstable);
     // Add sstable to maintenance set
@@ -144,6 +162,19 @@ class compaction_group {
     seastar::gate& async_gate() noexcept {
         return _async_gate;
     }
+
+    void note_read() noexcept {
+        ++_reads;
+    }
+    void note_write() noexcept {
+        ++_writes;
+    }
+    uint64_t reads() const noexcept {
+        return _reads;
+    }
+    uint64_t writes() const noexcept {
+        return _writes;
+    }
 };
 
 using compaction_group_vector = utils::chunked_vector<std::unique_ptr<compaction_group>>;
@@ -154,6 +185,8 @@ class compaction_group_manager {
     virtual compaction_group_vector make_compaction_groups() const = 0;
     virtual size_t compaction_group_of(dht::token) const = 0;
     virtual size_t log2_compaction_groups() const = 0;
+    // Called when the table changes the number of its compaction groups.
+    virtual void set_log2_compaction_groups(size_t) = 0;
 };
 
 }
@@ -55,10 +55,12 @@
 #include "utils/stall_free.hh"
 #include "utils/fmt-compat.hh"
 #include "utils/error_injection.hh"
+#include "utils/histogram_metrics_helper.hh"
 
 #include "db/timeout_clock.hh"
 #include "db/large_data_handler.hh"
 #include "db/data_listeners.hh"
+#include "db/hot_partition_replicas.hh"
 
 #include "data_dictionary/user_types_metadata.hh"
 #include <seastar/core/shared_ptr_incomplete.hh>
@@ -318,11 +320,13 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     , _cfg(cfg)
     // Allow system tables a pool of 10 MB memory to write, but never block on other regions.
     , _system_dirty_memory_manager(*this, 10 << 20, cfg.unspooled_dirty_soft_limit(), default_scheduling_group())
-    , _dirty_memory_manager(*this, dbcfg.available_memory * 0.50, cfg.unspooled_dirty_soft_limit(), dbcfg.statement_scheduling_group)
+    , _dirty_memory_manager(*this, dbcfg.available_memory * 0.50, cfg.unspooled_dirty_soft_limit(), dbcfg.statement_scheduling_group,
+            std::max<uint32_t>(cfg.memtable_flush_concurrency(), 1), cfg.dirty_memory_table_shares())
     , _dbcfg(dbcfg)
     , _flush_sg(dbcfg.memtable_scheduling_group)
-    , _memtable_controller(make_flush_controller(_cfg, _flush_sg, [this, limit = float(_dirty_memory_manager.throttle_threshold())] {
-        auto backlog = (_dirty_memory_manager.unspooled_dirty_memory()) / limit;
+    , _memtable_controller(make_flush_controller(_cfg, _flush_sg, [this] {
+        // The threshold changes while memtables borrow memory from the cache.
+        auto backlog = (_dirty_memory_manager.unspooled_dirty_memory()) / float(_dirty_memory_manager.throttle_threshold());
         if (_dirty_memory_manager.has_extraneous_flushes_requested()) {
             backlog = std::max(backlog, _memtable_controller.backlog_of_shares(200));
         }
@@ -333,7 +337,8 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
         "_read_concurrency_sem",
         max_inactive_queue_length(),
         _cfg.reader_concurrency_semaphore_serialize_limit_multiplier,
-        _cfg.reader_concurrency_semaphore_kill_limit_multiplier)
+        _cfg.reader_concurrency_semaphore_kill_limit_multiplier,
+        _cfg.reader_concurrency_semaphore_admission_by_deadline)
     // No timeouts or queue length limits - a failure here can kill an entire repair.
     // Trust the caller to limit concurrency.
     , _streaming_concurrency_sem(
@@ -342,7 +347,8 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
             "_streaming_concurrency_sem",
             std::numeric_limits<size_t>::max(),
             utils::updateable_value(std::numeric_limits<uint32_t>::max()),
-            utils::updateable_value(std::numeric_limits<uint32_t>::max()))
+            utils::updateable_value(std::numeric_limits<uint32_t>::max()),
+            utils::updateable_value(false))
     // No limits, just for accounting.
     , _compaction_concurrency_sem(reader_concurrency_semaphore::no_limits{}, "compaction")
     , _system_read_concurrency_sem(
@@ -352,8 +358,13 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
             "_system_read_concurrency_sem",
             std::numeric_limits<size_t>::max(),
             utils::updateable_value(std::numeric_limits<uint32_t>::max()),
-            utils::updateable_value(std::numeric_limits<uint32_t>::max()))
-    , _row_cache_tracker(_cfg.index_cache_fraction.operator utils::updateable_value<double>(), cache_tracker::register_metrics::yes)
+            utils::updateable_value(std::numeric_limits<uint32_t>::max()),
+            utils::updateable_value(false))
+    , _row_cache_tracker(_cfg.index_cache_fraction.operator utils::updateable_value<double>(),
+                         _cfg.cache_scans_on_probation.operator utils::updateable_value<bool>(),
+                         _cfg.compressed_cache_size_in_mb.operator utils::updateable_value<uint32_t>(),
+                         _cfg.absent_partition_cache_size_in_mb.operator utils::updateable_value<uint32_t>(),
+                         _cfg.cache_update_max_rows_per_partition.operator utils::updateable_value<uint32_t>(), cache_tracker::register_metrics::yes)
     , _apply_stage("db_apply", &database::do_apply)
     , _version(empty_version)
     , _compaction_manager(cm)
@@ -372,6 +383,10 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     , _system_sstables_manager(std::make_unique<sstables::sstables_manager>(*_nop_large_data_handler, _cfg, feat, _row_cache_tracker, dbcfg.available_memory, sst_dir_sem.local(), [&stm]{ return stm.get()->get_my_id(); }))
     , _result_memory_limiter(dbcfg.available_memory / 10)
     , _data_listeners(std::make_unique<db::data_listeners>())
+    , _hot_partition_replicas(std::make_unique<db::hot_partition_replicas>(*this, db::hot_partition_replicas::config{
+            .replicas = _cfg.hot_partition_replicas,
+            .read_threshold = _cfg.hot_partition_read_threshold,
+        }))
     , _mnotifier(mn)
     , _feat(feat)
     , _shared_token_metadata(stm)
@@ -380,6 +395,8 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     , _stop_barrier(std::move(barrier))
     , _update_memtable_flush_static_shares_action([this, &cfg] { return _memtable_controller.update_static_shares(cfg.memtable_flush_static_shares()); })
     , _memtable_flush_static_shares_observer(cfg.memtable_flush_static_shares.observe(_update_memtable_flush_static_shares_action.make_observer()))
+    , _dirty_memory_base_threshold(_dirty_memory_manager.threshold())
+    , _dirty_memory_borrowing_timer([this] { adjust_dirty_memory_borrowing(); })
 {
     assert(dbcfg.available_memory != 0); // Detect misconfigured unit tests, see #7544
 
@@ -387,6 +404,8 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     setup_metrics();
 
     _row_cache_tracker.set_compaction_scheduling_group(dbcfg.memory_compaction_scheduling_group);
+    _dirty_memory_borrowing_timer.arm_periodic(dirty_memory_borrowing_period);
+    _querier_cache.set_prefetch_enabled(_cfg.enable_paged_query_prefetch.operator utils::updateable_value<bool>());
 
     setup_scylla_memory_diagnostics_producer();
     if (_dbcfg.sstables_format) {
@@ -496,6 +515,12 @@ database::setup_metrics() {
                        sm::description("Holds the size of all (\"regular\", \"system\" and \"streaming\") used memory in bytes. Compare it to \"dirty_bytes\" to see how many memory is wasted (neither used nor available).")),
     });
 
+    _metrics.add_group("memory", {
+        sm::make_gauge("dirty_bytes_borrowed_from_cache", [this] { return _dirty_memory_borrowing.borrowed(); },
+                       sm::description("Holds the amount of memory in bytes which the regular memtables may use beyond their share of the memory, "
+                                       "lent by the row cache while writes are throttled and the cache is cold.")),
+    });
+
     _metrics.add_group("memtables", {
         sm::make_gauge("pending_flushes", _cf_stats.pending_memtables_flushes_count,
                        sm::description("Holds the current number of memtables that are currently being flushed to sstables. "
@@ -552,6 +577,10 @@ database::setup_metrics() {
         sm::make_counter("total_writes_rate_limited", _stats->total_writes_rate_limited,
                        sm::description("Counts write operations which were rejected on the replica side because the per-partition limit was reached.")),
 
+        sm::make_counter("counter_updates_coalesced", _stats->counter_updates_coalesced,
+                       sm::description("Counts counter updates which were folded into the pending update of their partition, "
+                                       "instead of being applied on their own. See enable_counter_update_coalescing.")),
+
         sm::make_counter("total_reads", _read_concurrency_sem.get_stats().total_successful_reads,
                        sm::description("Counts the total number of successful user reads on this shard."),
                        {user_label_instance}),
@@ -598,6 +627,9 @@ database::setup_metrics() {
         sm::make_gauge("querier_cache_population", _querier_cache.get_stats().population,
                        sm::description("The number of entries currently in the querier cache.")),
 
+        sm::make_counter("querier_cache_prefetches", _querier_cache.get_stats().prefetches,
+                       sm::description("Counts querier cache entries that started reading their next page in the background.")),
+
         sm::make_counter("sstable_read_queue_overloads", _read_concurrency_sem.get_stats().total_reads_shed_due_to_overload,
                        sm::description("Counts the number of times the sstable read queue was overloaded. "
                                        "A non-zero value indicates that we have to drop read requests because they arrive faster than we can serve them.")),
@@ -632,6 +664,15 @@ database::setup_metrics() {
                                        " When the queue is full, excessive reads are shed to avoid overload."),
                        {user_label_instance}),
 
+        sm::make_counter("reads_rejected_by_deadline", _read_concurrency_sem.get_stats().total_reads_rejected_by_deadline,
+                       sm::description("The number of reads rejected right away because they were expected to time out in the admission queue."
+                                       " Only happens with reader_concurrency_semaphore_admission_by_deadline enabled."),
+                       {user_label_instance}),
+
+        sm::make_histogram("reads_admission_queue_time", sm::description("Histogram of the time reads spent waiting for admission, until admitted or timed out."),
+                       {user_label_instance},
+                       [this] { return to_metrics_histogram(_read_concurrency_sem.get_stats().admission_queue_time); }).set_skip_when_empty(),
+
         sm::make_gauge("disk_reads", [this] { return _read_concurrency_sem.get_stats().disk_reads; },
                        sm::description("Holds the number of currently active disk read operations. "),
                        {user_label_instance}),
@@ -702,6 +743,10 @@ database::setup_metrics() {
                                        " When the queue is full, excessive reads are shed to avoid overload."),
                        {system_label_instance}),
 
+        sm::make_histogram("reads_admission_queue_time", sm::description("Histogram of the time reads spent waiting for admission, until admitted or timed out."),
+                       {system_label_instance},
+                       [this] { return to_metrics_histogram(_system_read_concurrency_sem.get_stats().admission_queue_time); }).set_skip_when_empty(),
+
         sm::make_gauge("disk_reads", [this] { return _system_read_concurrency_sem.get_stats().disk_reads; },
                        sm::description("Holds the number of currently active disk read operations. "),
                        {system_label_instance}),
@@ -741,6 +786,9 @@ database::setup_metrics() {
             sm::description("Number of large partitions exceeding compaction_large_partition_warning_threshold_mb. "
                 "Large partitions have performance impact and should be avoided, check the documentation for details.")),
 
+        sm::make_counter("large_data_records_dropped", [this] { return _large_data_handler->stats().records_dropped; },
+            sm::description("Number of large partition, row and cell records not written to the system tables because too many of them were pending.")),
+
         sm::make_total_operations("total_view_updates_pushed_local", _cf_stats.total_view_updates_pushed_local,
                 sm::description("Total number of view updates generated for tables and applied locally.")),
 
@@ -1033,6 +1081,9 @@ future<> database::add_column_family(keyspace& ks, schema_ptr schema, column_fam
     auto& sst_manager = is_system_table(*schema) ? get_system_sstables_manager() : get_user_sstables_manager();
     auto cf = make_lw_shared<column_family>(schema, std::move(cfg), ks.metadata()->get_storage_options_ptr(), _compaction_manager, sst_manager, *_cl_stats, _row_cache_tracker, erm);
     cf->set_durable_writes(ks.metadata()->durable_writes());
+    if (auto it = _keyspace_compaction_shares.find(schema->ks_name()); it != _keyspace_compaction_shares.end()) {
+        cf->set_compaction_shares(it->second);
+    }
 
     if (is_new) {
         cf->mark_ready_for_writes(commitlog_for(schema));
@@ -1078,6 +1129,14 @@ future<> database::add_column_family(keyspace& ks, schema_ptr schema, column_fam
     }
 }
 
+void database::set_keyspace_compaction_shares(std::unordered_map<sstring, int32_t> shares) {
+    _keyspace_compaction_shares = std::move(shares);
+    _tables_metadata.for_each_table([this] (table_id, lw_shared_ptr<table> t) {
+        auto it = _keyspace_compaction_shares.find(t->schema()->ks_name());
+        t->set_compaction_shares(it != _keyspace_compaction_shares.end() ? it->second : table::default_compaction_shares);
+    });
+}
+
 future<> database::add_column_family_and_make_directory(schema_ptr schema, is_new_cf is_new) {
     auto& ks = find_keyspace(schema->ks_name());
     co_await add_column_family(ks, schema, ks.make_column_family_config(*schema, *this), is_new);
@@ -1390,11 +1449,13 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.enable_metrics_reporting = db_config.enable_keyspace_column_family_metrics();
     cfg.enable_node_aggregated_table_metrics = db_config.enable_node_aggregated_table_metrics();
     cfg.reversed_reads_auto_bypass_cache = db_config.reversed_reads_auto_bypass_cache;
+    cfg.cache_admission_policy = db_config.cache_admission_policy;
     cfg.enable_optimized_reversed_reads = db_config.enable_optimized_reversed_reads;
     cfg.tombstone_warn_threshold = db_config.tombstone_warn_threshold();
     cfg.view_update_concurrency_semaphore = _config.view_update_concurrency_semaphore;
     cfg.view_update_concurrency_semaphore_limit = _config.view_update_concurrency_semaphore_limit;
     cfg.data_listeners = &db.data_listeners();
+    cfg.hot_partition_replicas = &db.get_hot_partition_replicas();
     cfg.enable_compacting_data_for_streaming_and_repair = db_config.enable_compacting_data_for_streaming_and_repair();
 
     return cfg;
@@ -1575,12 +1636,15 @@ class streaming_reader_lifecycle_policy
     distributed<replica::database>& _db;
     table_id _table_id;
     gc_clock::time_point _compaction_time;
+    skip_repaired_sstables _skip_repaired;
     std::vector<reader_context> _contexts;
 public:
-    streaming_reader_lifecycle_policy(distributed<replica::database>& db, table_id table_id, gc_clock::time_point compaction_time)
+    streaming_reader_lifecycle_policy(distributed<replica::database>& db, table_id table_id, gc_clock::time_point compaction_time,
+            skip_repaired_sstables skip_repaired = skip_repaired_sstables::no)
         : _db(db)
         , _table_id(table_id)
         , _compaction_time(compaction_time)
+        , _skip_repaired(skip_repaired)
         , _contexts(smp::count) {
     }
     virtual flat_mutation_reader_v2 create_reader(
@@ -1597,7 +1661,7 @@ class streaming_reader_lifecycle_policy
         _contexts[shard].read_operation = make_foreign(std::make_unique<utils::phased_barrier::operation>(cf.read_in_progress()));
         _contexts[shard].semaphore = &cf.streaming_read_concurrency_semaphore();
 
-        return cf.make_streaming_reader(std::move(schema), std::move(permit), *_contexts[shard].range, slice, fwd_mr, _compaction_time);
+        return cf.make_streaming_reader(std::move(schema), std::move(permit), *_contexts[shard].range, slice, fwd_mr, _compaction_time, _skip_repaired);
     }
     virtual const dht::partition_range* get_read_range() const override {
         const auto shard = this_shard_id();
@@ -1698,6 +1762,10 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
         co_await coroutine::return_exception(replica::rate_limit_exception());
     }
 
+    if (ranges.size() == 1 && ranges.front().is_singular() && ranges.front().start()->value().has_key()) {
+        _hot_partition_replicas->on_read(cf.schema(), ranges.front().start()->value().as_decorated_key());
+    }
+
     auto& semaphore = get_reader_concurrency_semaphore();
     auto max_result_size = cmd.max_result_size ? *cmd.max_result_size : get_unlimited_query_max_result_size();
 
@@ -1726,7 +1794,8 @@ database::query(schema_ptr s, const query::read_command& cmd, query::result_opti
             querier_opt->permit().set_trace_state(trace_state);
             f = co_await coroutine::as_future(semaphore.with_ready_permit(querier_opt->permit(), read_func));
         } else {
-            f = co_await coroutine::as_future(semaphore.with_permit(s.get(), "data-query", cf.estimate_read_memory_cost(), timeout, trace_state, read_func));
+            f = co_await coroutine::as_future(semaphore.with_permit(s.get(), "data-query", cf.estimate_read_memory_cost(), timeout, trace_state, read_func,
+                    reader_concurrency_semaphore::low_priority(bool(cmd.batch_workload))));
         }
 
         if (!f.failed()) {
@@ -1793,7 +1862,8 @@ database::query_mutations(schema_ptr s, const query::read_command& cmd, const dh
             querier_opt->permit().set_trace_state(trace_state);
             f = co_await coroutine::as_future(semaphore.with_ready_permit(querier_opt->permit(), read_func));
         } else {
-            f = co_await coroutine::as_future(semaphore.with_permit(s.get(), "mutation-query", cf.estimate_read_memory_cost(), timeout, trace_state, read_func));
+            f = co_await coroutine::as_future(semaphore.with_permit(s.get(), "mutation-query", cf.estimate_read_memory_cost(), timeout, trace_state, read_func,
+                    reader_concurrency_semaphore::low_priority(bool(cmd.batch_workload))));
         }
 
         if (!f.failed()) {
@@ -1863,6 +1933,13 @@ bool database::is_user_semaphore(const reader_concurrency_semaphore& semaphore)
         && &semaphore != &_system_read_concurrency_sem;
 }
 
+void database::foreach_reader_concurrency_semaphore(noncopyable_function<void(std::string_view, const reader_concurrency_semaphore&)> func) const {
+    func("user", _read_concurrency_sem);
+    func("streaming", _streaming_concurrency_sem);
+    func("system", _system_read_concurrency_sem);
+    func("compaction", _compaction_concurrency_sem);
+}
+
 std::ostream& operator<<(std::ostream& out, const column_family& cf) {
     fmt::print(out, "{{column_family: {}/{}}}", cf._schema->ks_name(), cf._schema->cf_name());
     return out;
@@ -1878,11 +1955,96 @@ std::ostream& operator<<(std::ostream& out, const database& db) {
     return out;
 }
 
+// Whether the counter update only increments live cells, so that it can be
+// folded into another such update by summing the increments.
+static bool is_counter_increment(const mutation& m) {
+    auto& p = m.partition();
+    if (p.partition_tombstone() || !p.row_tombstones().empty()) {
+        return false;
+    }
+    bool all_live = true;
+    auto check_cells = [&] (column_kind kind, const auto& cells) {
+        cells.for_each_cell([&] (column_id id, const atomic_cell_or_collection& c) {
+            all_live = all_live && c.as_atomic_cell(m.schema()->column_at(kind, id)).is_live();
+        });
+    };
+    check_cells(column_kind::static_column, p.static_row());
+    for (auto&& cr : p.clustered_rows()) {
+        if (cr.row().deleted_at()) {
+            return false;
+        }
+        check_cells(column_kind::regular_column, cr.row().cells());
+    }
+    return all_live;
+}
+
 future<mutation> database::do_apply_counter_update(column_family& cf, const frozen_mutation& fm, schema_ptr m_schema,
                                                    db::timeout_clock::time_point timeout,tracing::trace_state_ptr trace_state) {
     auto m = fm.unfreeze(m_schema);
     m.upgrade(cf.schema());
 
+    if (_cfg.enable_counter_update_coalescing() && is_counter_increment(m)) {
+        return apply_coalesced_counter_update(cf, std::move(m), timeout, std::move(trace_state));
+    }
+    return apply_counter_update_to_shards(cf, std::move(m), timeout, std::move(trace_state));
+}
+
+// Increments of a partition which arrive while an update of it is in
+// progress are summed into a single pending update, which is applied once
+// the update in progress is done. Every increment folded into it completes
+// with the mutation of the whole batch: replicating the same counter shard
+// state more than once is idempotent, and each increment is acknowledged
+// only after the batch it is part of is written.
+future<mutation> database::apply_coalesced_counter_update(column_family& cf, mutation m, db::timeout_clock::time_point timeout,
+                                                          tracing::trace_state_ptr trace_state) {
+    auto& in_progress = cf.counter_updates_in_progress();
+    auto it = in_progress.find(m.decorated_key());
+    if (it != in_progress.end()) {
+        auto& pending = it->second;
+        tracing::trace(trace_state, "Folding counter update into the pending update of the partition");
+        ++_stats->counter_updates_coalesced;
+        if (!pending) {
+            pending.emplace(std::move(m), timeout);
+        } else {
+            m.upgrade(pending->m.schema());
+            pending->m.apply(std::move(m));
+            pending->timeout = std::min(pending->timeout, timeout);
+        }
+        return pending->applied.get_shared_future();
+    }
+
+    auto dk = m.decorated_key();
+    in_progress.emplace(dk, std::nullopt);
+    return apply_counter_update_to_shards(cf, std::move(m), timeout, std::move(trace_state)).finally([this, &cf, dk = std::move(dk)] () mutable {
+        // Applied in the background, so that this update is acknowledged
+        // without waiting for the ones which queued behind it.
+        (void)apply_pending_counter_updates(cf, std::move(dk));
+    });
+}
+
+future<> database::apply_pending_counter_updates(column_family& cf, dht::decorated_key dk) {
+    auto op = cf.write_in_progress();
+    auto& in_progress = cf.counter_updates_in_progress();
+    while (true) {
+        auto it = in_progress.find(dk);
+        if (!it->second) {
+            in_progress.erase(it);
+            co_return;
+        }
+        auto pending = std::move(*it->second);
+        it->second.reset();
+        pending.m.upgrade(cf.schema());
+        auto f = co_await coroutine::as_future(apply_counter_update_to_shards(cf, std::move(pending.m), pending.timeout, {}));
+        if (f.failed()) {
+            pending.applied.set_exception(f.get_exception());
+        } else {
+            pending.applied.set_value(f.get());
+        }
+    }
+}
+
+future<mutation> database::apply_counter_update_to_shards(column_family& cf, mutation m, db::timeout_clock::time_point timeout,
+                                                          tracing::trace_state_ptr trace_state) {
     // prepare partition slice
     query::column_id_vector static_columns;
     static_columns.reserve(m.partition().static_row().size());
@@ -1975,11 +2137,23 @@ future<> database::apply_in_memory(const frozen_mutation& m, schema_ptr m_schema
 
     data_listeners().on_write(m_schema, m);
 
-    return cf.apply(m, std::move(m_schema), std::move(h), timeout);
+    // Checked after the write is applied, the copies of a partition may be made while
+    // the write waits for memory, and need to be dropped before the write is acknowledged.
+    return cf.apply(m, m_schema, std::move(h), timeout).then([this, &m, m_schema = std::move(m_schema)] {
+        if (_hot_partition_replicas->empty()) {
+            return make_ready_future<>();
+        }
+        return _hot_partition_replicas->on_write(m_schema, m.decorated_key(*m_schema));
+    });
 }
 
 future<> database::apply_in_memory(const mutation& m, column_family& cf, db::rp_handle&& h, db::timeout_clock::time_point timeout) {
-    return cf.apply(m, std::move(h), timeout);
+    return cf.apply(m, std::move(h), timeout).then([this, &m] {
+        if (_hot_partition_replicas->empty()) {
+            return make_ready_future<>();
+        }
+        return _hot_partition_replicas->on_write(m.schema(), m.decorated_key());
+    });
 }
 
 future<mutation> database::apply_counter_update(schema_ptr s, const frozen_mutation& m, db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_state) {
@@ -2023,22 +2197,22 @@ class wrapped_timed_out_error : public timed_out_error {
 
 // see above (#9919)
 template<typename T = std::runtime_error>
-static std::exception_ptr wrap_commitlog_add_error(schema_ptr s, const frozen_mutation& m, std::exception_ptr eptr) {
+static std::exception_ptr wrap_commitlog_add_error(schema_ptr s, const partition_key& key, std::exception_ptr eptr) {
     // it is tempting to do a full pretty print here, but the mutation is likely
     // humungous if we got an error, so just tell us where and pk...
     return make_nested_exception_ptr(T(format("Could not write mutation {}:{} ({}) to commitlog"
         , s->ks_name(), s->cf_name()
-        , m.key()
+        , key
     )), std::move(eptr));
 }
 
 future<> database::apply_with_commitlog(column_family& cf, const mutation& m, db::timeout_clock::time_point timeout) {
     db::rp_handle h;
     if (cf.commitlog() != nullptr && cf.durable_writes()) {
-        auto fm = freeze(m);
         std::exception_ptr ex;
         try {
-            commitlog_entry_writer cew(m.schema(), fm, db::commitlog::force_sync::no);
+            // Serializes m straight into the segment, without freezing it first.
+            commitlog_entry_writer cew(m.schema(), m, db::commitlog::force_sync::no);
             auto f_h = co_await coroutine::as_future(cf.commitlog()->add_entry(m.schema()->id(), cew, timeout));
             if (!f_h.failed()) {
                 h = f_h.get();
@@ -2050,9 +2224,9 @@ future<> database::apply_with_commitlog(column_family& cf, const mutation& m, db
         }
         if (ex) {
             if (try_catch<timed_out_error>(ex)) {
-                ex = wrap_commitlog_add_error<wrapped_timed_out_error>(cf.schema(), fm, std::move(ex));
+                ex = wrap_commitlog_add_error<wrapped_timed_out_error>(cf.schema(), m.key(), std::move(ex));
             } else {
-                ex = wrap_commitlog_add_error<>(cf.schema(), fm, std::move(ex));
+                ex = wrap_commitlog_add_error<>(cf.schema(), m.key(), std::move(ex));
             }
             co_await coroutine::exception(std::move(ex));
         }
@@ -2188,9 +2362,9 @@ future<> database::do_apply(schema_ptr s, const frozen_mutation& m, tracing::tra
         if (ex) {
             if (is_timeout_exception(ex)) {
                 ++_stats->total_writes_timedout;
-                ex = wrap_commitlog_add_error<wrapped_timed_out_error>(cf.schema(), m, std::move(ex));
+                ex = wrap_commitlog_add_error<wrapped_timed_out_error>(cf.schema(), m.key(), std::move(ex));
             } else {
-                ex = wrap_commitlog_add_error<>(s, m, std::move(ex));
+                ex = wrap_commitlog_add_error<>(s, m.key(), std::move(ex));
             }
             co_await coroutine::exception(std::move(ex));
         }
@@ -2392,6 +2566,21 @@ void database::revert_initial_system_read_concurrency_boost() {
     dblog.debug("Reverted system read concurrency from initial {} to normal {}", database::max_count_concurrent_reads, database::max_count_system_concurrent_reads);
 }
 
+void database::adjust_dirty_memory_borrowing() noexcept {
+    const auto& cache_stats = _row_cache_tracker.get_stats();
+    const double ratio = std::clamp(_cfg.memtable_cache_borrowing_ratio(), 0.0, 0.4);
+    const auto borrowed = _dirty_memory_borrowing.update(dirty_memory_borrowing::sample{
+        .cache_reads = cache_stats.reads,
+        .cache_reads_with_misses = cache_stats.reads_with_misses,
+        .cache_evictions = cache_stats.partition_evictions + cache_stats.row_evictions,
+        .blocked_writes = _dirty_memory_manager.region_group().blocked_requests_counter(),
+    }, size_t(_dbcfg.available_memory * ratio));
+    if (_dirty_memory_manager.threshold() != _dirty_memory_base_threshold + borrowed) {
+        dblog.debug("Memtables borrow {} bytes from the cache", borrowed);
+        _dirty_memory_manager.set_threshold(_dirty_memory_base_threshold + borrowed);
+    }
+}
+
 future<> database::start() {
     _large_data_handler->start();
     // We need the compaction manager ready early so we can reshard.
@@ -2443,6 +2632,7 @@ future<> database::stop() {
     if (_schema_commitlog) {
         co_await _schema_commitlog->release();
     }
+    _dirty_memory_borrowing_timer.cancel();
     dblog.info("Shutting down system dirty memory manager");
     co_await _system_dirty_memory_manager.shutdown();
     dblog.info("Shutting down dirty memory manager");
@@ -2453,6 +2643,8 @@ future<> database::stop() {
     co_await _user_sstables_manager->close();
     dblog.info("Closing system sstables manager");
     co_await _system_sstables_manager->close();
+    dblog.info("Stopping hot partition replicas");
+    co_await _hot_partition_replicas->stop();
     dblog.info("Stopping querier cache");
     co_await _querier_cache.stop();
     dblog.info("Stopping concurrency semaphores");
@@ -2944,6 +3136,15 @@ future<> database::drain() {
     co_await _stop_barrier.arrive_and_wait();
     co_await flush_non_system_column_families();
     co_await _stop_barrier.arrive_and_wait();
+    // All memtables of non-system tables are flushed on all shards, so tables with
+    // commitlog_bypass lose nothing if the node is stopped now.
+    if (this_shard_id() == 0 && _sys_ks) {
+        try {
+            co_await _sys_ks->set_commitlog_bypass_dirty(false);
+        } catch (...) {
+            dblog.warn("Failed to record that tables bypassing the commitlog are flushed, they will be repaired on restart: {}", std::current_exception());
+        }
+    }
     co_await flush_system_column_families();
     co_await _stop_barrier.arrive_and_wait();
     co_await _commitlog->shutdown();
@@ -3048,6 +3249,7 @@ database::as_data_dictionary() const {
 }
 
 void database::plug_system_keyspace(db::system_keyspace& sys_ks) noexcept {
+    _sys_ks = sys_ks.shared_from_this();
     _compaction_manager.plug_system_keyspace(sys_ks);
     _large_data_handler->plug_system_keyspace(sys_ks);
     _user_sstables_manager->plug_system_keyspace(sys_ks);
@@ -3057,6 +3259,7 @@ void database::unplug_system_keyspace() noexcept {
     _user_sstables_manager->unplug_system_keyspace();
     _compaction_manager.unplug_system_keyspace();
     _large_data_handler->unplug_system_keyspace();
+    _sys_ks = nullptr;
 }
 
 void database::plug_view_update_generator(db::view::view_update_generator& generator) noexcept {
@@ -3072,11 +3275,12 @@ void database::unplug_view_update_generator() noexcept {
 flat_mutation_reader_v2 make_multishard_streaming_reader(distributed<replica::database>& db,
         schema_ptr schema, reader_permit permit,
         std::function<std::optional<dht::partition_range>()> range_generator,
-        gc_clock::time_point compaction_time) {
+        gc_clock::time_point compaction_time,
+        replica::skip_repaired_sstables skip_repaired) {
 
     auto& table = db.local().find_column_family(schema);
     auto erm = table.get_effective_replication_map();
-    auto ms = mutation_source([&db, erm, compaction_time] (schema_ptr s,
+    auto ms = mutation_source([&db, erm, compaction_time, skip_repaired] (schema_ptr s,
             reader_permit permit,
             const dht::partition_range& pr,
             const query::partition_slice& ps,
@@ -3084,7 +3288,7 @@ flat_mutation_reader_v2 make_multishard_streaming_reader(distributed<replica::da
             streamed_mutation::forwarding,
             mutation_reader::forwarding fwd_mr) {
         auto table_id = s->id();
-        return make_multishard_combining_reader_v2(seastar::make_shared<replica::streaming_reader_lifecycle_policy>(db, table_id, compaction_time),
+        return make_multishard_combining_reader_v2(seastar::make_shared<replica::streaming_reader_lifecycle_policy>(db, table_id, compaction_time, skip_repaired),
                 std::move(s), erm, std::move(permit), pr, ps, std::move(trace_state), fwd_mr);
     });
     auto&& full_slice = schema->full_slice();
@@ -3093,13 +3297,14 @@ flat_mutation_reader_v2 make_multishard_streaming_reader(distributed<replica::da
 }
 
 flat_mutation_reader_v2 make_multishard_streaming_reader(distributed<replica::database>& db,
-        schema_ptr schema, reader_permit permit, const dht::partition_range& range, gc_clock::time_point compaction_time)
+        schema_ptr schema, reader_permit permit, const dht::partition_range& range, gc_clock::time_point compaction_time,
+        replica::skip_repaired_sstables skip_repaired)
 {
     const auto table_id = schema->id();
     const auto& full_slice = schema->full_slice();
     auto erm = db.local().find_column_family(schema).get_effective_replication_map();
     return make_multishard_combining_reader_v2(
-        seastar::make_shared<replica::streaming_reader_lifecycle_policy>(db, table_id, compaction_time),
+        seastar::make_shared<replica::streaming_reader_lifecycle_policy>(db, table_id, compaction_time, skip_repaired),
         std::move(schema),
         std::move(erm),
         std::move(permit),
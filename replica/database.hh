@@ -30,13 +30,16 @@
 #include "types/types.hh"
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
+#include <seastar/core/shared_future.hh>
 #include "db/commitlog/replay_position.hh"
 #include "db/commitlog/commitlog_types.hh"
 #include <limits>
 #include "schema/schema_fwd.hh"
+#include "replica/database_fwd.hh"
 #include "db/view/view.hh"
 #include "db/snapshot-ctl.hh"
 #include "memtable.hh"
+#include "mutation/mutation.hh"
 #include "row_cache.hh"
 #include "query-result.hh"
 #include "compaction/compaction_strategy.hh"
@@ -60,6 +63,7 @@
 #include "absl-flat_hash_map.hh"
 #include "utils/cross-shard-barrier.hh"
 #include "sstables/generation_type.hh"
+#include "db/partition_heavy_hitters.hh"
 #include "db/rate_limiter.hh"
 #include "db/operation_type.hh"
 #include "locator/tablets.hh"
@@ -120,6 +124,7 @@ class config;
 class extensions;
 class rp_handle;
 class data_listeners;
+class hot_partition_replicas;
 class large_data_handler;
 class system_keyspace;
 class table_selector;
@@ -174,6 +179,8 @@ class memtable_list {
     std::optional<shared_future<>> _flush_coalescing;
     seastar::scheduling_group _compaction_scheduling_group;
     replica::table_stats& _table_stats;
+    // Set by dirty_memory_manager::update_shares().
+    bool _within_dirty_memory_share = false;
 public:
     using iterator = decltype(_memtables)::iterator;
     using const_iterator = decltype(_memtables)::const_iterator;
@@ -268,6 +275,18 @@ class memtable_list {
     dirty_memory_manager_logalloc::region_group& region_group() noexcept {
         return _dirty_memory_manager->region_group();
     }
+
+    // Whether the memtables use no more than their share of the unspooled memory, as of
+    // the last flush decision of a dirty_memory_manager with table shares. Always false
+    // when table shares are disabled.
+    bool within_dirty_memory_share() const noexcept {
+        return _within_dirty_memory_share;
+    }
+
+    void set_within_dirty_memory_share(bool within) noexcept {
+        _within_dirty_memory_share = within;
+    }
+
     // This is used for explicit flushes. Will queue the memtable for flushing and proceed when the
     // dirty_memory_manager allows us to. We will not seal at this time since the flush itself
     // wouldn't happen anyway. Keeping the memtable in memory will potentially increase the time it
@@ -389,9 +408,11 @@ class table : public enable_lw_shared_from_this<table>
         db::timeout_semaphore* view_update_concurrency_semaphore;
         size_t view_update_concurrency_semaphore_limit;
         db::data_listeners* data_listeners = nullptr;
+        db::hot_partition_replicas* hot_partition_replicas = nullptr;
         // Not really table-specific (it's a global configuration parameter), but stored here
         // for easy access from `table` member functions:
         utils::updateable_value<bool> reversed_reads_auto_bypass_cache{false};
+        utils::updateable_value<std::unordered_map<sstring, sstring>> cache_admission_policy{{}};
         utils::updateable_value<bool> enable_optimized_reversed_reads{true};
         uint32_t tombstone_warn_threshold{0};
         unsigned x_log2_compaction_groups{0};
@@ -425,8 +446,16 @@ class table : public enable_lw_shared_from_this<table>
 
     compaction_manager& _compaction_manager;
     sstables::compaction_strategy _compaction_strategy;
+    // Shares of the service level the table is attributed to, scaling its compaction backlog.
+    // Initialized before the compaction groups, which pick it up when created.
+    int32_t _compaction_shares = default_compaction_shares;
     std::unique_ptr<compaction_group_manager> _cg_manager;
     compaction_group_vector _compaction_groups;
+    // Set while split_compaction_groups() runs.
+    bool _splitting_compaction_groups = false;
+    // Set when memtables may hold data of other compaction groups, which happens when
+    // groups are split, until the memtables are flushed. Point reads then consult all memtables.
+    bool _memtables_span_compaction_groups = false;
     // Compound SSTable set for all the compaction groups, which is useful for operations spanning all of them.
     lw_shared_ptr<sstables::sstable_set> _sstables;
     // Control background fibers waiting for sstables to be deleted
@@ -462,11 +491,27 @@ class table : public enable_lw_shared_from_this<table>
     std::vector<view_ptr> _views;
 
     std::unique_ptr<cell_locker> _counter_cell_locks; // Memory-intensive; allocate only when needed.
+public:
+    // An update of a counter partition which waits for the update of the
+    // partition in progress, and accumulates the increments which arrive
+    // meanwhile. See database::apply_coalesced_counter_update().
+    struct pending_counter_update {
+        mutation m;
+        db::timeout_clock::time_point timeout;
+        shared_promise<mutation> applied;
+    };
+    using counter_updates_in_progress_map = std::map<dht::decorated_key, std::optional<pending_counter_update>, dht::decorated_key::less_comparator>;
+private:
+    counter_updates_in_progress_map _counter_updates_in_progress;
 
     // Labels used to identify writes and reads for this table in the rate_limiter structure.
     db::rate_limiter::label _rate_limiter_label_for_writes;
     db::rate_limiter::label _rate_limiter_label_for_reads;
 
+    // The hottest partitions of this table on this shard, for writes and reads.
+    db::partition_heavy_hitters _heavy_hitters_for_writes;
+    db::partition_heavy_hitters _heavy_hitters_for_reads;
+
     void set_metrics();
     seastar::metrics::metric_groups _metrics;
 
@@ -516,8 +561,13 @@ class table : public enable_lw_shared_from_this<table>
 
     future<> add_sstable_and_update_cache(sstables::shared_sstable sst,
                                           sstables::offstrategy offstrategy = sstables::offstrategy::no);
-    future<> add_sstables_and_update_cache(const std::vector<sstables::shared_sstable>& ssts);
+    future<> add_sstables_and_update_cache(const std::vector<sstables::shared_sstable>& ssts,
+                                           sstables::offstrategy offstrategy = sstables::offstrategy::no);
     future<> move_sstables_from_staging(std::vector<sstables::shared_sstable>);
+    // Marks the sstables which this node opened before all of owned_ranges
+    // were repaired, with all replicas, as repaired, so that repairs with
+    // skip_repaired_sstables don't read them again.
+    future<> mark_repaired_sstables(dht::token_range_vector owned_ranges);
     sstables::shared_sstable make_sstable();
     void set_truncation_time(db_clock::time_point truncated_at) noexcept {
         _truncated_at = truncated_at;
@@ -562,12 +612,26 @@ class table : public enable_lw_shared_from_this<table>
     compaction_group& compaction_group_for_sstable(const sstables::shared_sstable& sst) const noexcept;
     // Returns a list of all compaction groups.
     const compaction_group_vector& compaction_groups() const noexcept;
+    // Accounts a read of the ranges to the compaction groups, for tablet load stats.
+    void note_reads(const dht::partition_range_vector& ranges) const noexcept;
+    void note_heavy_hitter_reads(const dht::partition_range_vector& ranges, const query::result& result) noexcept;
     // Safely iterate through compaction groups, while performing async operations on them.
     future<> parallel_foreach_compaction_group(std::function<future<>(compaction_group&)> action);
+    // Returns the number of compaction groups, in log2, the table should have for its tablet map.
+    // It's finer than the tablet map if a split is pending, so that the storage of each tablet
+    // is already split when the split is finalized.
+    size_t wanted_log2_compaction_groups() const;
+    // Splits every compaction group into two, if wanted_log2_compaction_groups() says so, and
+    // moves data to the groups which own it. Runs in the background.
+    void maybe_split_compaction_groups();
+    future<> split_compaction_groups();
 
     bool cache_enabled() const {
         return _config.enable_cache && _schema->caching_options().enabled();
     }
+    // Whether a read of the range, in the current scheduling group, goes through
+    // the cache according to the cache_admission_policy.
+    bool admit_to_cache(const dht::partition_range& range) const;
     void update_stats_for_new_sstable(const sstables::shared_sstable& sst) noexcept;
     future<> do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::offstrategy offstrategy);
     // Helpers which add sstable on behalf of a compaction group and refreshes compound set.
@@ -696,14 +760,18 @@ class table : public enable_lw_shared_from_this<table>
     // Requires ranges to be sorted and disjoint.
     // When compaction_time is engaged, the reader's output will be compacted, with the provided query time.
     // This compaction doesn't do tombstone garbage collection.
+    // When sstable_filter is engaged, only the sstables it returns true for are read.
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit,
-            const dht::partition_range_vector& ranges, gc_clock::time_point compaction_time) const;
+            const dht::partition_range_vector& ranges, gc_clock::time_point compaction_time,
+            sstables::sstable_predicate sstable_filter = {}) const;
 
     // Single range overload.
+    // With skip_repaired, the sstables marked as repaired are not read, see mark_repaired_sstables().
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
             const query::partition_slice& slice,
             mutation_reader::forwarding fwd_mr,
-            gc_clock::time_point compaction_time) const;
+            gc_clock::time_point compaction_time,
+            skip_repaired_sstables skip_repaired = skip_repaired_sstables::no) const;
 
     flat_mutation_reader_v2 make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range, gc_clock::time_point compaction_time) {
         return make_streaming_reader(schema, std::move(permit), range, schema->full_slice(), mutation_reader::forwarding::no, compaction_time);
@@ -722,6 +790,8 @@ class table : public enable_lw_shared_from_this<table>
 
     sstables::shared_sstable make_streaming_sstable_for_write();
     sstables::shared_sstable make_streaming_staging_sstable();
+    // For receiving a copy of an sstable of another node, streamed as files.
+    sstables::shared_sstable make_streaming_sstable_for_copy(sstables::sstable_version_types v, sstables::sstable_format_types f);
 
     mutation_source as_mutation_source() const;
     mutation_source as_mutation_source_excluding_staging() const;
@@ -749,6 +819,7 @@ class table : public enable_lw_shared_from_this<table>
     // TODO: expose stats, whatever, instead of exposing active memtables themselves.
     std::vector<memtable*> active_memtables();
     api::timestamp_type min_memtable_timestamp() const;
+    api::timestamp_type min_memtable_timestamp(const dht::decorated_key& dk) const;
     const row_cache& get_row_cache() const {
         return _cache;
     }
@@ -767,6 +838,16 @@ class table : public enable_lw_shared_from_this<table>
         std::abort(); // compiler will error if we get here
     }
 
+    db::partition_heavy_hitters& get_heavy_hitters_for_op_type(db::operation_type op_type) {
+        switch (op_type) {
+        case db::operation_type::write:
+            return _heavy_hitters_for_writes;
+        case db::operation_type::read:
+            return _heavy_hitters_for_reads;
+        }
+        std::abort(); // compiler will error if we get here
+    }
+
     db::rate_limiter::label& get_rate_limiter_label_for_writes() {
         return _rate_limiter_label_for_writes;
     }
@@ -777,6 +858,10 @@ class table : public enable_lw_shared_from_this<table>
 
     future<std::vector<locked_cell>> lock_counter_cells(const mutation& m, db::timeout_clock::time_point timeout);
 
+    counter_updates_in_progress_map& counter_updates_in_progress() noexcept {
+        return _counter_updates_in_progress;
+    }
+
     logalloc::occupancy_stats occupancy() const;
 public:
     table(schema_ptr schema, config cfg, lw_shared_ptr<const storage_options> sopts, compaction_manager& cm, sstables::sstables_manager& sm, cell_locker_stats& cl_stats, cache_tracker& row_cache_tracker, locator::effective_replication_map_ptr erm);
@@ -790,6 +875,9 @@ class table : public enable_lw_shared_from_this<table>
     void update_effective_replication_map(locator::effective_replication_map_ptr);
     [[gnu::always_inline]] bool uses_tablets() const;
     future<> cleanup_tablet(locator::tablet_id);
+    // Adds the load of tablet replicas hosted by this shard to stats,
+    // and the readiness of the table for a pending split.
+    void collect_tablet_load_stats(locator::load_stats& stats) const;
     future<const_mutation_partition_ptr> find_partition(schema_ptr, reader_permit permit, const dht::decorated_key& key) const;
     future<const_row_ptr> find_row(schema_ptr, reader_permit permit, const dht::decorated_key& partition_key, clustering_key clustering_key) const;
     shard_id shard_of(const mutation& m) const {
@@ -977,8 +1065,10 @@ class table : public enable_lw_shared_from_this<table>
         return _global_cache_hit_rate;
     }
 
+    // Whether writes go to the commitlog: the keyspace's durable_writes, unless the
+    // table opted out with commitlog_bypass.
     bool durable_writes() const {
-        return _durable_writes;
+        return _durable_writes && !_schema->commitlog_bypass();
     }
 
     void set_durable_writes(bool dw) {
@@ -1003,6 +1093,12 @@ class table : public enable_lw_shared_from_this<table>
         return _tombstone_gc_enabled;
     }
 
+    static constexpr int32_t default_compaction_shares = 1000;
+    // Sets the shares of the service level the table is attributed to. The
+    // compaction backlog of the table is scaled by shares / default_compaction_shares.
+    void set_compaction_shares(int32_t shares) noexcept;
+    double compaction_backlog_weight() const noexcept;
+
     bool is_auto_compaction_disabled_by_user() const {
       return _compaction_disabled_by_user;
     }
@@ -1358,6 +1454,7 @@ class database : public peering_sharded_service<database> {
         uint64_t total_writes_failed = 0;
         uint64_t total_writes_timedout = 0;
         uint64_t total_writes_rate_limited = 0;
+        uint64_t counter_updates_coalesced = 0;
         uint64_t total_reads = 0;
         uint64_t total_reads_failed = 0;
         uint64_t total_reads_rate_limited = 0;
@@ -1394,6 +1491,7 @@ class database : public peering_sharded_service<database> {
 
     cache_tracker _row_cache_tracker;
     seastar::shared_ptr<db::view::view_update_generator> _view_update_generator;
+    seastar::shared_ptr<db::system_keyspace> _sys_ks;
 
     inheriting_concrete_execution_stage<
             future<>,
@@ -1430,6 +1528,7 @@ class database : public peering_sharded_service<database> {
 
     friend db::data_listeners;
     std::unique_ptr<db::data_listeners> _data_listeners;
+    std::unique_ptr<db::hot_partition_replicas> _hot_partition_replicas;
 
     service::migration_notifier& _mnotifier;
     gms::feature_service& _feat;
@@ -1443,9 +1542,18 @@ class database : public peering_sharded_service<database> {
 
     db::rate_limiter _rate_limiter;
 
+    // Compaction shares of the tables of each keyspace, see set_keyspace_compaction_shares().
+    std::unordered_map<sstring, int32_t> _keyspace_compaction_shares;
+
     serialized_action _update_memtable_flush_static_shares_action;
     utils::observer<float> _memtable_flush_static_shares_observer;
 
+    static constexpr std::chrono::seconds dirty_memory_borrowing_period{1};
+    // The threshold of _dirty_memory_manager without the memory borrowed from the cache.
+    size_t _dirty_memory_base_threshold;
+    dirty_memory_borrowing _dirty_memory_borrowing;
+    timer<lowres_clock> _dirty_memory_borrowing_timer;
+
 public:
     data_dictionary::database as_data_dictionary() const;
     db::commitlog* commitlog_for(const schema_ptr& schema);
@@ -1476,6 +1584,7 @@ class database : public peering_sharded_service<database> {
     future<> create_in_memory_keyspace(const lw_shared_ptr<keyspace_metadata>& ksm, locator::effective_replication_map_factory& erm_factory, system_keyspace system);
     void setup_metrics();
     void setup_scylla_memory_diagnostics_producer();
+    void adjust_dirty_memory_borrowing() noexcept;
 
     future<> do_apply(schema_ptr, const frozen_mutation&, tracing::trace_state_ptr tr_state, db::timeout_clock::time_point timeout, db::commitlog_force_sync sync, db::per_partition_rate_limit::info rate_limit_info);
     future<> do_apply_many(const std::vector<frozen_mutation>&, db::timeout_clock::time_point timeout);
@@ -1483,6 +1592,11 @@ class database : public peering_sharded_service<database> {
 
     future<mutation> do_apply_counter_update(column_family& cf, const frozen_mutation& fm, schema_ptr m_schema, db::timeout_clock::time_point timeout,
                                              tracing::trace_state_ptr trace_state);
+    future<mutation> apply_counter_update_to_shards(column_family& cf, mutation m, db::timeout_clock::time_point timeout,
+                                                    tracing::trace_state_ptr trace_state);
+    future<mutation> apply_coalesced_counter_update(column_family& cf, mutation m, db::timeout_clock::time_point timeout,
+                                                    tracing::trace_state_ptr trace_state);
+    future<> apply_pending_counter_updates(column_family& cf, dht::decorated_key dk);
 
     template<typename Future>
     Future update_write_metrics(Future&& f);
@@ -1641,6 +1755,17 @@ class database : public peering_sharded_service<database> {
             db::per_partition_rate_limit::account_and_enforce account_and_enforce_info,
             db::operation_type op_type);
 
+    /// Returns up to `k` partitions of the table with the most operations of given type
+    /// recently rejected by the per-partition rate limit on this shard.
+    std::vector<db::rate_limiter::rejected_partition> get_top_rate_limited_partitions(table& tbl, db::operation_type op_type, size_t k) const {
+        return _rate_limiter.top_rejected(tbl.get_rate_limiter_label_for_op_type(op_type), k);
+    }
+
+    /// Sets the compaction shares of the tables of the keyspaces in `shares`,
+    /// including those created later. The tables of other keyspaces get
+    /// table::default_compaction_shares.
+    void set_keyspace_compaction_shares(std::unordered_map<sstring, int32_t> shares);
+
     future<std::tuple<lw_shared_ptr<query::result>, cache_temperature>> query(schema_ptr, const query::read_command& cmd, query::result_options opts,
                                                                   const dht::partition_range_vector& ranges, tracing::trace_state_ptr trace_state,
                                                                   db::timeout_clock::time_point timeout, db::per_partition_rate_limit::info rate_limit_info = std::monostate{});
@@ -1706,6 +1831,10 @@ class database : public peering_sharded_service<database> {
     }
     const db::extensions& extensions() const;
 
+    db::large_data_handler& get_large_data_handler() const noexcept {
+        return *_large_data_handler;
+    }
+
     sstables::sstables_manager& get_user_sstables_manager() const noexcept {
         assert(_user_sstables_manager);
         return *_user_sstables_manager;
@@ -1787,6 +1916,10 @@ class database : public peering_sharded_service<database> {
         return *_data_listeners;
     }
 
+    db::hot_partition_replicas& get_hot_partition_replicas() const {
+        return *_hot_partition_replicas;
+    }
+
     // Get the maximum result size for an unlimited query, appropriate for the
     // query class, which is deduced from the current scheduling group.
     query::max_result_size get_unlimited_query_max_result_size() const;
@@ -1794,6 +1927,10 @@ class database : public peering_sharded_service<database> {
     // Get the reader concurrency semaphore, appropriate for the query class,
     // which is deduced from the current scheduling group.
     reader_concurrency_semaphore& get_reader_concurrency_semaphore();
+    // The semaphore admitting user reads, whatever the scheduling group of the caller.
+    reader_concurrency_semaphore& get_user_read_concurrency_semaphore() noexcept {
+        return _read_concurrency_sem;
+    }
 
     // Convenience method to obtain an admitted permit. See reader_concurrency_semaphore::obtain_permit().
     future<reader_permit> obtain_reader_permit(table& tbl, const char* const op_name, db::timeout_clock::time_point timeout, tracing::trace_state_ptr trace_ptr);
@@ -1808,6 +1945,9 @@ class database : public peering_sharded_service<database> {
     bool uses_schema_commitlog() const;
 
     bool is_user_semaphore(const reader_concurrency_semaphore& semaphore) const;
+
+    // Calls func with the name and the semaphore, for each reader concurrency semaphore of this shard.
+    void foreach_reader_concurrency_semaphore(noncopyable_function<void(std::string_view, const reader_concurrency_semaphore&)> func) const;
 };
 
 } // namespace replica
@@ -1821,9 +1961,11 @@ future<> start_large_data_handler(sharded<replica::database>& db);
 // Opt-in for compacting the output by passing `compaction_time`, see
 // make_streaming_reader() for more details.
 flat_mutation_reader_v2 make_multishard_streaming_reader(distributed<replica::database>& db, schema_ptr schema, reader_permit permit,
-        std::function<std::optional<dht::partition_range>()> range_generator, gc_clock::time_point compaction_time);
+        std::function<std::optional<dht::partition_range>()> range_generator, gc_clock::time_point compaction_time,
+        replica::skip_repaired_sstables skip_repaired = replica::skip_repaired_sstables::no);
 
 flat_mutation_reader_v2 make_multishard_streaming_reader(distributed<replica::database>& db,
-    schema_ptr schema, reader_permit permit, const dht::partition_range& range, gc_clock::time_point compaction_time);
+    schema_ptr schema, reader_permit permit, const dht::partition_range& range, gc_clock::time_point compaction_time,
+    replica::skip_repaired_sstables skip_repaired = replica::skip_repaired_sstables::no);
 
 bool is_internal_keyspace(std::string_view name);
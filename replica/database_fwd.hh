@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <seastar/util/bool_class.hh>
+
 namespace replica {
 
 // replica/database.hh
@@ -17,6 +19,8 @@ class table;
 using column_family = table;
 class memtable_list;
 
+using skip_repaired_sstables = seastar::bool_class<class skip_repaired_sstables_tag>;
+
 }
 
 
@@ -190,6 +190,16 @@ void region_group::update_unspooled(ssize_t delta) {
     }
 }
 
+void region_group::set_limits(size_t unspooled_hard_limit, size_t unspooled_soft_limit, size_t real_hard_limit) noexcept {
+    if (!reclaimer_can_block()) {
+        return;
+    }
+    _cfg.unspooled_hard_limit = unspooled_hard_limit;
+    _cfg.unspooled_soft_limit = unspooled_soft_limit;
+    _cfg.real_hard_limit = real_hard_limit;
+    update_unspooled(0);
+}
+
 future<>
 region_group::shutdown() noexcept {
     _shutdown_requested = true;
@@ -207,7 +217,8 @@ future<flush_permit> flush_permit::reacquire_sstable_write_permit() && {
     return _manager->get_flush_permit(std::move(_background_permit));
 }
 
-dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg)
+dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg,
+        unsigned flush_concurrency, bool table_shares)
     : _db(&db)
     , _region_group("memtable (unspooled)", dirty_memory_manager_logalloc::reclaim_config{
             .unspooled_hard_limit = threshold / 2,
@@ -215,8 +226,42 @@ dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t thresho
             .real_hard_limit = threshold,
             .start_reclaiming = std::bind_front(&dirty_memory_manager::start_reclaiming, this)
       }, deferred_work_sg)
-    , _flush_serializer(1)
-    , _waiting_flush(flush_when_needed()) {}
+    , _flush_serializer(flush_concurrency)
+    , _waiting_flush(flush_when_needed())
+    , _table_shares(table_shares)
+    , _threshold(threshold)
+    , _soft_limit(soft_limit) {}
+
+void dirty_memory_manager::set_threshold(size_t threshold) noexcept {
+    _threshold = threshold;
+    _region_group.set_limits(threshold / 2, threshold * _soft_limit / 2, threshold);
+}
+
+size_t dirty_memory_borrowing::update(const sample& s, size_t max_borrowed) noexcept {
+    const auto reads = s.cache_reads - _last.cache_reads;
+    const auto reads_with_misses = s.cache_reads_with_misses - _last.cache_reads_with_misses;
+    const bool cache_evicts = s.cache_evictions != _last.cache_evictions;
+    const bool writes_blocked = s.blocked_writes != _last.blocked_writes;
+    _last = s;
+
+    const bool cache_hot = cache_evicts && reads && double(reads - reads_with_misses) / reads >= hot_cache_hit_rate;
+    if (writes_blocked && !cache_hot) {
+        _streak = std::max(_streak, 0) + 1;
+    } else {
+        _streak = std::min(_streak, 0) - 1;
+    }
+
+    const size_t step = std::max<size_t>(max_borrowed / steps, 1);
+    if (_streak >= int(periods_to_change)) {
+        _borrowed = std::min(_borrowed + step, max_borrowed);
+        _streak = 0;
+    } else if (_streak <= -int(periods_to_change)) {
+        _borrowed -= std::min(_borrowed, step);
+        _streak = 0;
+    }
+    _borrowed = std::min(_borrowed, max_borrowed);
+    return _borrowed;
+}
 
 void
 dirty_memory_manager::setup_collectd(sstring namestr) {
@@ -275,6 +320,19 @@ future<> dirty_memory_manager::flush_when_needed() {
                 // memtable. The advantage of doing this is that this is objectively the one that will
                 // release the biggest amount of memory and is less likely to be generating tiny
                 // SSTables.
+                //
+                // With table shares, we pick the CF which uses the most unspooled memory instead,
+                // which is the one over its share, if any.
+                if (_table_shares) {
+                    memtable_list* mtlist = update_shares();
+                    if (!mtlist) {
+                        return sleep(1ms);
+                    }
+                    (void)this->flush_one(*mtlist, std::move(permit)).handle_exception([] (std::exception_ptr ex) {
+                        dblog.error("Flushing memtable returned unexpected error: {}", ex);
+                    });
+                    return make_ready_future<>();
+                }
                 memtable& candidate_memtable = memtable::from_region(*(this->_region_group.get_largest_region()));
                 memtable_list& mtlist = *(candidate_memtable.get_memtable_list());
 
@@ -304,6 +362,30 @@ future<> dirty_memory_manager::flush_when_needed() {
     });
 }
 
+replica::memtable_list* dirty_memory_manager::update_shares() {
+    using namespace replica;
+    std::unordered_map<memtable_list*, size_t> usage;
+    _region_group.for_each_region([&] (dirty_memory_manager_logalloc::size_tracked_region& r) {
+        memtable& mt = memtable::from_region(r);
+        if (auto* mtlist = mt.get_memtable_list()) {
+            usage[mtlist] += mt.unspooled_memory();
+        }
+    });
+    const auto writers = std::ranges::count_if(usage, [] (auto& u) { return u.second != 0; });
+    const size_t share = _region_group.unspooled_throttle_threshold() / std::max<size_t>(writers, 1);
+    memtable_list* candidate = nullptr;
+    size_t candidate_usage = 0;
+    for (auto& [mtlist, used] : usage) {
+        mtlist->set_within_dirty_memory_share(used <= share);
+        // Only the active memtable is flushed, the others are already being flushed.
+        if (used > candidate_usage && mtlist->can_flush() && mtlist->back()->region().evictable_occupancy()) {
+            candidate = mtlist;
+            candidate_usage = used;
+        }
+    }
+    return candidate;
+}
+
 void dirty_memory_manager::start_reclaiming() noexcept {
     _should_flush.signal();
 }
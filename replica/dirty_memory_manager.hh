@@ -267,6 +267,10 @@ class region_group : public logalloc::region_listener {
     }
     void update_unspooled(ssize_t delta);
 
+    // Changes the limits of the group, releasing blocked requests if they are raised.
+    // Can't make a group which was created without an unspooled hard limit throttle.
+    void set_limits(size_t unspooled_hard_limit, size_t unspooled_soft_limit, size_t real_hard_limit) noexcept;
+
     // It would be easier to call update, but it is unfortunately broken in boost versions up to at
     // least 1.59.
     //
@@ -307,17 +311,30 @@ class region_group : public logalloc::region_listener {
     // region_groups.
     //
     // When timeout is reached first, the returned future is resolved with timed_out_error exception.
+    //
+    // Requests which are within_share are only held back by the real memory hard limit. They are
+    // issued by writers whose share of the unspooled memory is below their quota, so that they don't
+    // queue up behind the writer which drove the group over the unspooled hard limit.
     template <typename Func>
     // We disallow future-returning functions here, because otherwise memory may be available
     // when we start executing it, but no longer available in the middle of the execution.
     requires (!is_future<std::invoke_result_t<Func>>::value)
-    futurize_t<std::result_of_t<Func()>> run_when_memory_available(Func&& func, db::timeout_clock::time_point timeout);
+    futurize_t<std::result_of_t<Func()>> run_when_memory_available(Func&& func, db::timeout_clock::time_point timeout,
+            bool within_share = false);
 
     // returns a pointer to the largest region (in terms of memory usage) that sits below this
     // region group. This includes the regions owned by this region group as well as all of its
     // children.
     size_tracked_region* get_largest_region() noexcept;
 
+    // Calls func with every region of this group, in no particular order.
+    template <typename Func>
+    void for_each_region(Func&& func) {
+        for (size_tracked_region* r : _regions) {
+            func(*r);
+        }
+    }
+
     // Shutdown is mandatory for every user who has set a threshold
     // Can be called at most once.
     future<> shutdown() noexcept;
@@ -401,6 +418,9 @@ class dirty_memory_manager {
     // memtable is totally gone. That means that if we have throttled requests, they will stay
     // throttled for a long time. Even when we have unspooled dirty, that only provides a rough
     // estimate, and we can't release requests that early.
+    //
+    // When a single flush can't keep the disk busy, the serializer can be configured to let a
+    // few flushes write their data concurrently, see memtable_flush_concurrency.
     semaphore _flush_serializer;
     // We will accept a new flush before another one ends, once it is done with the data write.
     // That is so we can keep the disk always busy. But there is still some background work that is
@@ -424,6 +444,11 @@ class dirty_memory_manager {
 
     unsigned _extraneous_flushes = 0;
 
+    bool _table_shares = false;
+
+    size_t _threshold = 0;
+    double _soft_limit = 1.0;
+
     seastar::metrics::metric_groups _metrics;
 public:
     void setup_collectd(sstring namestr);
@@ -462,7 +487,22 @@ class dirty_memory_manager {
     //
     // We then set the soft limit to 80 % of the unspooled dirty hard limit, which is equal to 40 % of
     // the user-supplied threshold.
-    dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg);
+    //
+    // Flush Concurrency
+    // -----------------
+    // flush_concurrency is the number of memtables whose data is written at the same time. Each
+    // flush holds a unit of _flush_serializer until its data write completes, after which only
+    // _background_work_flush_serializer bounds it.
+    //
+    // Table Shares
+    // ------------
+    // With table_shares, each table which holds unspooled memory is entitled to an equal share of
+    // the unspooled hard limit. The flusher picks the table which uses the most of it, rather than
+    // the largest memtable, and writes to tables which are within their share are throttled only by
+    // the real hard limit. So a table which is written faster than it can be flushed doesn't stall
+    // writes to the others. The shares are recomputed on every flush decision, see update_shares().
+    dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg,
+            unsigned flush_concurrency = 1, bool table_shares = false);
     dirty_memory_manager()
         : _db(nullptr)
         , _region_group("memtable (unspooled)",
@@ -520,8 +560,20 @@ class dirty_memory_manager {
         return _region_group.unspooled_throttle_threshold();
     }
 
+    // Changes the threshold given to the constructor, the limits derived from it
+    // follow. See dirty_memory_borrowing.
+    void set_threshold(size_t threshold) noexcept;
+
+    size_t threshold() const noexcept {
+        return _threshold;
+    }
+
     future<> flush_one(replica::memtable_list& cf, flush_permit&& permit) noexcept;
 
+    // Recomputes which memtable lists are over their share of unspooled memory and
+    // returns the one which is over it the most, or nullptr if none of them can be flushed.
+    replica::memtable_list* update_shares();
+
     future<flush_permit> get_flush_permit() noexcept {
         return get_units(_background_work_flush_serializer, 1).then([this] (auto&& units) {
             return this->get_flush_permit(std::move(units));
@@ -562,10 +614,9 @@ template <typename Func>
 // when we start executing it, but no longer available in the middle of the execution.
 requires (!is_future<std::invoke_result_t<Func>>::value)
 futurize_t<std::result_of_t<Func()>>
-region_group::run_when_memory_available(Func&& func, db::timeout_clock::time_point timeout) {
-    bool blocked = 
-        !_blocked_requests.empty()
-        || under_unspooled_pressure()
+region_group::run_when_memory_available(Func&& func, db::timeout_clock::time_point timeout, bool within_share) {
+    bool blocked =
+        (!within_share && (!_blocked_requests.empty() || under_unspooled_pressure()))
         || _under_real_pressure;
 
     if (!blocked) {
@@ -594,6 +645,42 @@ region_group::blocked_requests_counter() const noexcept {
 
 }
 
+// Decides how much memory the memtables of a dirty_memory_manager borrow from the
+// row cache on top of their threshold, see database::adjust_dirty_memory_borrowing().
+//
+// Memtables and the cache share the LSA memory, the threshold only caps the former.
+// Borrowing pays off while writes are throttled and the cache is cold: it serves few
+// reads, or it doesn't need to evict to keep what it has. Once the cache becomes hot
+// and is evicting, or writes are no longer throttled, the memory is given back.
+// The amount changes in steps of 1/steps of the maximum, and only after the same
+// decision was reached in periods_to_change consecutive periods.
+class dirty_memory_borrowing {
+public:
+    // Counters sampled at the end of each period.
+    struct sample {
+        uint64_t cache_reads = 0;
+        uint64_t cache_reads_with_misses = 0;
+        uint64_t cache_evictions = 0;
+        uint64_t blocked_writes = 0;
+    };
+    static constexpr unsigned steps = 8;
+    static constexpr unsigned periods_to_change = 3;
+    // The cache is hot when at least this share of its reads hit.
+    static constexpr double hot_cache_hit_rate = 0.8;
+private:
+    sample _last;
+    size_t _borrowed = 0;
+    // Consecutive periods in favour of borrowing more, when positive, or less, when negative.
+    int _streak = 0;
+public:
+    // Takes the counters at the end of a period and returns the amount to borrow, at most max_borrowed.
+    size_t update(const sample& s, size_t max_borrowed) noexcept;
+
+    size_t borrowed() const noexcept {
+        return _borrowed;
+    }
+};
+
 extern thread_local dirty_memory_manager default_dirty_memory_manager;
 
 }
@@ -32,6 +32,7 @@
 #include "db/view/view_update_checks.hh"
 #include <unordered_map>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
 #include "db/view/view_update_generator.hh"
 
 extern logging::logger dblog;
@@ -107,6 +108,59 @@ distributed_loader::lock_table(sharded<sstables::sstable_directory>& dir, sharde
     });
 }
 
+// Load-and-stream sends the content of an sstable to the replicas which own it, no matter
+// which shard reads it. Hand out the sstables found in the upload directory so that each
+// shard streams about the same amount of data: the largest sstables are placed first, each
+// on the least loaded shard, staying on the shard which found it when that one is as good.
+future<>
+distributed_loader::balance_unsorted_sstables(sharded<sstables::sstable_directory>& dir, sstables::sstable_open_config cfg) {
+    struct sstable_info {
+        shard_id shard;
+        uint64_t size;
+        sstables::entry_descriptor desc;
+    };
+    std::vector<sstable_info> infos;
+    for (auto shard : boost::irange(0u, smp::count)) {
+        auto shard_infos = co_await dir.invoke_on(shard, [] (sstables::sstable_directory& d) {
+            std::vector<sstable_info> ret;
+            ret.reserve(d.get_unsorted_sstables().size());
+            for (auto& sst : d.get_unsorted_sstables()) {
+                ret.push_back(sstable_info{this_shard_id(), sst->data_size(), sst->get_descriptor(sstables::component_type::Data)});
+            }
+            return ret;
+        });
+        std::move(shard_infos.begin(), shard_infos.end(), std::back_inserter(infos));
+    }
+
+    std::ranges::sort(infos, std::greater<>(), &sstable_info::size);
+    std::vector<uint64_t> shard_load(smp::count);
+    std::vector<std::unordered_set<sstables::generation_type>> moved_out(smp::count);
+    std::vector<sstables::sstable_directory::sstable_entry_descriptor_vector> moved_in(smp::count);
+    size_t nr_moved = 0;
+    for (auto& info : infos) {
+        shard_id target = std::distance(shard_load.begin(), std::ranges::min_element(shard_load));
+        if (shard_load[info.shard] == shard_load[target]) {
+            target = info.shard;
+        }
+        shard_load[target] += info.size;
+        if (target != info.shard) {
+            moved_out[info.shard].insert(info.desc.generation);
+            moved_in[target].push_back(std::move(info.desc));
+            ++nr_moved;
+        }
+    }
+    dblog.info("Moving {} out of {} sstables between shards to balance their size, largest shard has {} bytes, smallest has {} bytes",
+            nr_moved, infos.size(), std::ranges::max(shard_load), std::ranges::min(shard_load));
+
+    co_await dir.invoke_on_all([&moved_out, &moved_in, cfg] (sstables::sstable_directory& d) -> future<> {
+        const auto& gens = moved_out[this_shard_id()];
+        std::erase_if(d.get_unsorted_sstables(), [&gens] (const sstables::shared_sstable& sst) {
+            return gens.contains(sst->generation());
+        });
+        co_await d.load_unsorted_sstables(std::move(moved_in[this_shard_id()]), cfg);
+    });
+}
+
 // Global resharding function. Done in two parts:
 //  - The first part spreads the foreign_sstable_open_info across shards so that all of them are
 //    resharding about the same amount of data
@@ -139,7 +193,7 @@ distributed_loader::reshape(sharded<sstables::sstable_directory>& dir, sharded<r
 // Loads SSTables into the main directory (or staging) and returns how many were loaded
 future<size_t>
 distributed_loader::make_sstables_available(sstables::sstable_directory& dir, sharded<replica::database>& db,
-        sharded<db::view::view_update_generator>& view_update_generator, bool needs_view_update, sstring ks, sstring cf) {
+        sharded<db::view::view_update_generator>& view_update_generator, bool needs_view_update, sstring ks, sstring cf, sstables::offstrategy offstrategy) {
 
     auto& table = db.local().find_column_family(ks, cf);
     auto new_sstables = std::vector<sstables::shared_sstable>();
@@ -158,10 +212,15 @@ distributed_loader::make_sstables_available(sstables::sstable_directory& dir, sh
         co_return 0;
     }
 
-    co_await table.add_sstables_and_update_cache(new_sstables).handle_exception([&table] (std::exception_ptr ep) {
+    // Staging sstables are moved to the main set once view building is done with them.
+    offstrategy = sstables::offstrategy(offstrategy && !needs_view_update);
+    co_await table.add_sstables_and_update_cache(new_sstables, offstrategy).handle_exception([&table] (std::exception_ptr ep) {
         dblog.error("Failed to load SSTables for {}.{}: {}. Aborting.", table.schema()->ks_name(), table.schema()->cf_name(), ep);
         abort();
     });
+    if (offstrategy) {
+        table.trigger_offstrategy_compaction();
+    }
 
     co_await coroutine::parallel_for_each(new_sstables, [&view_update_generator, &table] (sstables::shared_sstable sst) -> future<> {
         if (sst->requires_view_building()) {
@@ -223,14 +282,20 @@ distributed_loader::process_upload_dir(distributed<replica::database>& db, distr
         //   so that cleanup can be considered per compaction group
         auto owned_ranges_ptr = compaction::make_owned_ranges_ptr(db.local().get_keyspace_local_ranges(ks));
         reshard(directory, db, ks, cf, make_sstable, owned_ranges_ptr).get();
-        reshape(directory, db, sstables::reshape_mode::strict, ks, cf, make_sstable,
-                [] (const sstables::shared_sstable&) { return true; }).get();
+        // With background reshape, the uploaded sstables are added to the maintenance
+        // set as they are, and off-strategy compaction reshapes them once they are
+        // available, instead of holding up the load.
+        const auto offstrategy = sstables::offstrategy(db.local().get_config().enable_background_reshape());
+        if (!offstrategy) {
+            reshape(directory, db, sstables::reshape_mode::strict, ks, cf, make_sstable,
+                    [] (const sstables::shared_sstable&) { return true; }).get();
+        }
 
         // Move to staging directory to avoid clashes with future uploads. Unique generation number ensures no collisions.
         const bool use_view_update_path = db::view::check_needs_view_update_path(sys_dist_ks.local(), db.local().get_token_metadata(), *global_table, streaming::stream_reason::repair).get0();
 
-        size_t loaded = directory.map_reduce0([&db, ks, cf, use_view_update_path, &view_update_generator] (sstables::sstable_directory& dir) {
-            return make_sstables_available(dir, db, view_update_generator, use_view_update_path, ks, cf);
+        size_t loaded = directory.map_reduce0([&db, ks, cf, use_view_update_path, &view_update_generator, offstrategy] (sstables::sstable_directory& dir) {
+            return make_sstables_available(dir, db, view_update_generator, use_view_update_path, ks, cf, offstrategy);
         }, size_t(0), std::plus<size_t>()).get0();
 
         dblog.info("Loaded {} SSTables", loaded);
@@ -238,8 +303,8 @@ distributed_loader::process_upload_dir(distributed<replica::database>& db, distr
 }
 
 future<std::tuple<table_id, std::vector<std::vector<sstables::shared_sstable>>>>
-distributed_loader::get_sstables_from_upload_dir(distributed<replica::database>& db, sstring ks, sstring cf, sstables::sstable_open_config cfg) {
-    return seastar::async([&db, ks = std::move(ks), cf = std::move(cf), cfg] {
+distributed_loader::get_sstables_from_upload_dir(distributed<replica::database>& db, sstring ks, sstring cf, sstables::sstable_open_config cfg, bool balance) {
+    return seastar::async([&db, ks = std::move(ks), cf = std::move(cf), cfg, balance] {
         auto global_table = get_table_on_all_shards(db, ks, cf).get0();
         sharded<sstables::sstable_directory> directory;
         auto table_id = global_table->schema()->id();
@@ -260,6 +325,9 @@ distributed_loader::get_sstables_from_upload_dir(distributed<replica::database>&
             .sstable_open_config = cfg,
         };
         process_sstable_dir(directory, flags).get();
+        if (balance) {
+            balance_unsorted_sstables(directory, cfg).get();
+        }
         directory.invoke_on_all([&sstables_on_shards] (sstables::sstable_directory& d) mutable {
             sstables_on_shards[this_shard_id()] = d.get_unsorted_sstables();
         }).get();
@@ -385,14 +453,22 @@ future<> table_populator::populate_subdir(sstables::sstable_state state, allow_o
     // off-strategy compaction to reshape them. This will allow node to become online
     // ASAP. Given that SSTables with repair origin are disjoint, they can be efficiently
     // read from.
+    // With background reshape, the other sstables are not reshaped on boot either,
+    // but they still go to the main set: they may overlap, which the partitioned
+    // maintenance set is not meant for, and the compaction strategy (e.g. LCS
+    // levels) is what lays them out. Only sstables which are known to be disjoint
+    // are left to off-strategy compaction.
+    const bool background_reshape = do_allow_offstrategy_compaction && _db.local().get_config().enable_background_reshape();
     auto eligible_for_reshape_on_boot = [] (const sstables::shared_sstable& sst) {
         return sst->get_origin() != sstables::repair_origin;
     };
 
-    co_await distributed_loader::reshape(directory, _db, sstables::reshape_mode::relaxed, _ks, _cf, [this, state] (shard_id shard) {
-        auto gen = _global_table->calculate_generation_for_new_table();
-        return make_sstable(*_global_table, state, gen, _highest_version);
-    }, eligible_for_reshape_on_boot);
+    if (!background_reshape) {
+        co_await distributed_loader::reshape(directory, _db, sstables::reshape_mode::relaxed, _ks, _cf, [this, state] (shard_id shard) {
+            auto gen = _global_table->calculate_generation_for_new_table();
+            return make_sstable(*_global_table, state, gen, _highest_version);
+        }, eligible_for_reshape_on_boot);
+    }
 
     co_await directory.invoke_on_all([this, &eligible_for_reshape_on_boot, do_allow_offstrategy_compaction] (sstables::sstable_directory& dir) -> future<> {
         co_await dir.do_for_each_sstable([this, &eligible_for_reshape_on_boot, do_allow_offstrategy_compaction] (sstables::shared_sstable sst) {
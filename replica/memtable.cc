@@ -840,6 +840,14 @@ bool memtable::is_flushed() const noexcept {
     return bool(_underlying);
 }
 
+api::timestamp_type memtable::get_min_timestamp(const dht::decorated_key& dk) const noexcept {
+    if (is_flushed()) {
+        return get_min_timestamp();
+    }
+    auto i = partitions.find(dk, dht::ring_position_comparator(*_schema));
+    return i != partitions.end() ? get_min_timestamp() : api::max_timestamp;
+}
+
 void memtable_entry::upgrade_schema(logalloc::region& r, const schema_ptr& s, mutation_cleaner& cleaner) {
     if (schema() != s) {
         partition().upgrade(r, s, cleaner, no_cache_tracker);
@@ -216,6 +216,11 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
         return _stats_collector.get_max_timestamp();
     }
 
+    // Returns the minimum timestamp of this memtable if it holds the partition, or
+    // api::max_timestamp otherwise. Once flushed, the contents of the memtable are
+    // being moved away, so the minimum timestamp is returned regardless.
+    api::timestamp_type get_min_timestamp(const dht::decorated_key& dk) const noexcept;
+
     mutation_cleaner& cleaner() noexcept {
         return _cleaner;
     }
@@ -224,6 +229,11 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
         return _memtable_list;
     }
 
+    // The part of the memtable's memory which is not yet written to an sstable.
+    uint64_t unspooled_memory() const noexcept {
+        return occupancy().total_space() - _flushed_memory;
+    }
+
     size_t partition_count() const noexcept { return nr_partitions; }
     logalloc::occupancy_stats occupancy() const noexcept;
 
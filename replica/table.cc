@@ -27,6 +27,7 @@
 #include "checked-file-impl.hh"
 #include "view_info.hh"
 #include "db/data_listeners.hh"
+#include "db/hot_partition_replicas.hh"
 #include "memtable-sstable.hh"
 #include "compaction/compaction_manager.hh"
 #include "compaction/table_state.hh"
@@ -39,6 +40,7 @@
 #include "utils/error_injection.hh"
 #include "utils/histogram_metrics_helper.hh"
 #include "utils/fb_utilities.hh"
+#include "utils/hash.hh"
 #include "mutation/mutation_source_metadata.hh"
 #include "gms/gossiper.hh"
 #include "gms/feature_service.hh"
@@ -98,14 +100,21 @@ table::make_sstable_reader(schema_ptr s,
                                    const sstables::sstable_predicate& predicate) const {
     // CAVEAT: if make_sstable_reader() is called on a single partition
     // we want to optimize and read exactly this partition. As a
-    // consequence, fast_forward_to() will *NOT* work on the result,
-    // regardless of what the fwd_mr parameter says.
+    // consequence, with a custom predicate, fast_forward_to() will *NOT*
+    // work on the result, regardless of what the fwd_mr parameter says.
+    // Otherwise, the reader can be fast-forwarded to further keys, reusing
+    // the sstable readers it opened, see create_multi_key_sstable_reader().
     if (pr.is_singular() && pr.start()->value().has_key()) {
         const dht::ring_position& pos = pr.start()->value();
         if (_erm->shard_of(*s, pos.token()) != this_shard_id()) {
             return make_empty_flat_reader_v2(s, std::move(permit)); // range doesn't belong to this shard
         }
 
+        // Reversed sstable readers can't be fast-forwarded to other partitions.
+        if (fwd_mr && &predicate == &sstables::default_sstable_predicate() && !slice.is_reversed()) {
+            return sstables->create_multi_key_sstable_reader(const_cast<column_family*>(this), std::move(s), std::move(permit),
+                    _stats.estimated_sstable_per_read, pr, slice, std::move(trace_state), fwd);
+        }
         return sstables->create_single_key_sstable_reader(const_cast<column_family*>(this), std::move(s), std::move(permit),
                 _stats.estimated_sstable_per_read, pr, slice, std::move(trace_state), fwd, fwd_mr, predicate);
     } else {
@@ -189,8 +198,9 @@ table::add_memtables_to_reader_list(std::vector<flat_mutation_reader_v2>& reader
         }
     };
 
-    // point queries can be optimized as they span a single compaction group.
-    if (range.is_singular() && range.start()->value().has_key()) {
+    // point queries can be optimized as they span a single compaction group,
+    // unless they can be fast-forwarded to keys of other groups.
+    if (range.is_singular() && range.start()->value().has_key() && !fwd_mr && !_memtables_span_compaction_groups) {
         const dht::ring_position& pos = range.start()->value();
         auto& cg = compaction_group_for_token(pos.token());
         reserve_fn(cg.memtable_count());
@@ -253,7 +263,7 @@ table::make_reader_v2(schema_ptr s,
     });
 
     const auto bypass_cache = slice.options.contains(query::partition_slice::option::bypass_cache);
-    if (cache_enabled() && !bypass_cache && !(reversed && _config.reversed_reads_auto_bypass_cache())) {
+    if (cache_enabled() && !bypass_cache && !(reversed && _config.reversed_reads_auto_bypass_cache()) && admit_to_cache(range)) {
         if (auto reader_opt = _cache.make_reader_opt(s, permit, range, slice, &_compaction_manager.get_tombstone_gc_state(), std::move(trace_state), fwd, fwd_mr)) {
             readers.emplace_back(std::move(*reader_opt));
         }
@@ -274,6 +284,39 @@ table::make_reader_v2(schema_ptr s,
     return rd;
 }
 
+bool table::admit_to_cache(const dht::partition_range& range) const {
+    const auto& policy = _config.cache_admission_policy.get();
+    if (policy.empty()) {
+        return true;
+    }
+    auto i = policy.find(current_scheduling_group().name());
+    if (i == policy.end()) {
+        return true;
+    }
+    bool admit = true;
+    switch (parse_cache_admission(i->second).value_or(cache_admission::populate)) {
+    case cache_admission::populate:
+        break;
+    case cache_admission::populate_on_reuse:
+        if (range.is_singular() && range.start()->value().has_key()) {
+            auto h = utils::hash_combine(std::hash<table_id>()(_schema->id()), std::hash<dht::token>()(range.start()->value().token()));
+            // The reuse is recorded either way. Partitions already in the cache are read
+            // from it, only admitting new ones waits for their reuse.
+            admit = _cache.get_cache_tracker().is_reused(h) || _cache.contains(range.start()->value());
+        } else {
+            admit = false;
+        }
+        break;
+    case cache_admission::bypass:
+        admit = false;
+        break;
+    }
+    if (!admit) {
+        _cache.get_cache_tracker().on_read_bypassed_by_admission();
+    }
+    return admit;
+}
+
 sstables::shared_sstable table::make_streaming_sstable_for_write() {
     auto newtab = make_sstable(sstables::sstable_state::normal);
     tlogger.debug("Created sstable for streaming: ks={}, cf={}", schema()->ks_name(), schema()->cf_name());
@@ -286,6 +329,13 @@ sstables::shared_sstable table::make_streaming_staging_sstable() {
     return newtab;
 }
 
+sstables::shared_sstable table::make_streaming_sstable_for_copy(sstables::sstable_version_types v, sstables::sstable_format_types f) {
+    auto& sstm = get_sstables_manager();
+    auto newtab = sstm.make_sstable(_schema, _config.datadir, *_storage_opts, calculate_generation_for_new_table(), sstables::sstable_state::normal, v, f);
+    tlogger.debug("Created sstable for streaming a copy: ks={}, cf={}, version={}", schema()->ks_name(), schema()->cf_name(), v);
+    return newtab;
+}
+
 static flat_mutation_reader_v2 maybe_compact_for_streaming(flat_mutation_reader_v2 underlying, const compaction_manager& cm, gc_clock::time_point compaction_time, bool compaction_enabled) {
     if (!compaction_enabled) {
         return underlying;
@@ -301,16 +351,20 @@ static flat_mutation_reader_v2 maybe_compact_for_streaming(flat_mutation_reader_
 flat_mutation_reader_v2
 table::make_streaming_reader(schema_ptr s, reader_permit permit,
                            const dht::partition_range_vector& ranges,
-                           gc_clock::time_point compaction_time) const {
+                           gc_clock::time_point compaction_time,
+                           sstables::sstable_predicate sstable_filter) const {
     auto& slice = s->full_slice();
 
-    auto source = mutation_source([this] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
+    // The predicate must outlive the readers.
+    auto filter = sstable_filter ? make_lw_shared<sstables::sstable_predicate>(std::move(sstable_filter)) : nullptr;
+    auto source = mutation_source([this, filter] (schema_ptr s, reader_permit permit, const dht::partition_range& range, const query::partition_slice& slice,
                                       tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr) {
         std::vector<flat_mutation_reader_v2> readers;
         add_memtables_to_reader_list(readers, s, permit, range, slice, trace_state, fwd, fwd_mr, [&] (size_t memtable_count) {
             readers.reserve(memtable_count + 1);
         });
-        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, std::move(trace_state), fwd, fwd_mr));
+        readers.emplace_back(make_sstable_reader(s, permit, _sstables, range, slice, std::move(trace_state), fwd, fwd_mr,
+                filter ? *filter : sstables::default_sstable_predicate()));
         return make_combined_reader(s, std::move(permit), std::move(readers), fwd, fwd_mr);
     });
 
@@ -322,15 +376,21 @@ table::make_streaming_reader(schema_ptr s, reader_permit permit,
 }
 
 flat_mutation_reader_v2 table::make_streaming_reader(schema_ptr schema, reader_permit permit, const dht::partition_range& range,
-        const query::partition_slice& slice, mutation_reader::forwarding fwd_mr, gc_clock::time_point compaction_time) const {
+        const query::partition_slice& slice, mutation_reader::forwarding fwd_mr, gc_clock::time_point compaction_time,
+        skip_repaired_sstables skip_repaired) const {
     auto trace_state = tracing::trace_state_ptr();
     const auto fwd = streamed_mutation::forwarding::no;
 
+    static const sstables::sstable_predicate excl_repaired_predicate = [] (const sstable& sst) {
+        return !sst.is_repaired();
+    };
+
     std::vector<flat_mutation_reader_v2> readers;
     add_memtables_to_reader_list(readers, schema, permit, range, slice, trace_state, fwd, fwd_mr, [&] (size_t memtable_count) {
         readers.reserve(memtable_count + 1);
     });
-    readers.emplace_back(make_sstable_reader(schema, permit, _sstables, range, slice, std::move(trace_state), fwd, fwd_mr));
+    readers.emplace_back(make_sstable_reader(schema, permit, _sstables, range, slice, std::move(trace_state), fwd, fwd_mr,
+            skip_repaired ? excl_repaired_predicate : sstables::default_sstable_predicate()));
     return maybe_compact_for_streaming(
             make_combined_reader(std::move(schema), std::move(permit), std::move(readers), fwd, fwd_mr),
             get_compaction_manager(),
@@ -384,8 +444,27 @@ api::timestamp_type compaction_group::min_memtable_timestamp() const {
     );
 }
 
+api::timestamp_type compaction_group::min_memtable_timestamp(const dht::decorated_key& dk) const {
+    auto timestamp = api::max_timestamp;
+    for (const auto& m : *_memtables) {
+        timestamp = std::min(timestamp, m->get_min_timestamp(dk));
+    }
+    return timestamp;
+}
+
 api::timestamp_type table::min_memtable_timestamp() const {
-    return *boost::range::min_element(compaction_groups() | boost::adaptors::transformed(std::mem_fn(&compaction_group::min_memtable_timestamp)));
+    return *boost::range::min_element(compaction_groups() | boost::adaptors::transformed([] (const std::unique_ptr<compaction_group>& cg) {
+        return cg->min_memtable_timestamp();
+    }));
+}
+
+api::timestamp_type table::min_memtable_timestamp(const dht::decorated_key& dk) const {
+    if (_memtables_span_compaction_groups) {
+        return *boost::range::min_element(compaction_groups() | boost::adaptors::transformed([&dk] (const std::unique_ptr<compaction_group>& cg) {
+            return cg->min_memtable_timestamp(dk);
+        }));
+    }
+    return compaction_group_for_token(dk.token()).min_memtable_timestamp(dk);
 }
 
 // Not performance critical. Currently used for testing only.
@@ -554,10 +633,27 @@ class single_compaction_group_manager final : public compaction_group_manager {
     size_t log2_compaction_groups() const override {
         return 0;
     }
+    void set_log2_compaction_groups(size_t log2) override {
+        if (log2 != 0) {
+            on_internal_error(tlogger, format("Cannot have 2^{} compaction groups in table {}.{} without tablets", log2, _t.schema()->ks_name(), _t.schema()->cf_name()));
+        }
+    }
 };
 
+// Returns the token range of the compaction group with the given id, out of 2^log2_groups groups.
+static dht::token_range compaction_group_token_range(size_t log2_groups, size_t id) {
+    auto last = dht::last_token_of_compaction_group(log2_groups, id);
+    if (id == 0) {
+        return dht::token_range::make({dht::minimum_token(), false}, {last, true});
+    }
+    return dht::token_range::make({dht::last_token_of_compaction_group(log2_groups, id - 1), false}, {last, true});
+}
+
 class tablet_compaction_group_manager final : public compaction_group_manager {
     replica::table& _t;
+    // Compaction groups start aligned with tablets, but can be split ahead of tablets,
+    // so the layout is kept here rather than derived from the tablet map.
+    size_t _log2_groups;
 private:
     const locator::effective_replication_map_ptr& erm() const {
         return _t.get_effective_replication_map();
@@ -573,7 +669,10 @@ class tablet_compaction_group_manager final : public compaction_group_manager {
         return tm.tablets().get_tablet_map(schema()->id());
     }
 public:
-    tablet_compaction_group_manager(replica::table& t) : _t(t) {}
+    tablet_compaction_group_manager(replica::table& t)
+        : _t(t)
+        , _log2_groups(tablet_map().log2_tablets())
+    {}
 
     compaction_group_vector make_compaction_groups() const override {
         compaction_group_vector ret;
@@ -595,10 +694,13 @@ class tablet_compaction_group_manager final : public compaction_group_manager {
         return ret;
     }
     size_t compaction_group_of(dht::token t) const override {
-        return tablet_map().get_tablet_id(t).value();
+        return dht::compaction_group_of(_log2_groups, t);
     }
     size_t log2_compaction_groups() const override {
-        return log2ceil(tablet_map().tablet_count());
+        return _log2_groups;
+    }
+    void set_log2_compaction_groups(size_t log2) override {
+        _log2_groups = log2;
     }
 };
 
@@ -665,6 +767,66 @@ const compaction_group_vector& table::compaction_groups() const noexcept {
     return _compaction_groups;
 }
 
+void table::note_reads(const dht::partition_range_vector& ranges) const noexcept {
+    if (single_compaction_group_if_available()) {
+        return;
+    }
+    for (auto& range : ranges) {
+        if (range.start() && !range.start()->value().token().is_minimum()) {
+            compaction_group_for_token(range.start()->value().token()).note_read();
+        }
+    }
+}
+
+void table::note_heavy_hitter_reads(const dht::partition_range_vector& ranges, const query::result& result) noexcept {
+    // The size of the result can only be attributed to a partition when a
+    // single one was read.
+    const uint64_t bytes = ranges.size() == 1 ? result.buf().size() : 0;
+    for (auto& range : ranges) {
+        if (range.is_singular()) {
+            _heavy_hitters_for_reads.record(dht::token::to_int64(range.start()->value().token()), bytes);
+        }
+    }
+}
+
+void table::collect_tablet_load_stats(locator::load_stats& stats) const {
+    if (!uses_tablets()) {
+        return;
+    }
+    auto& tm = _erm->get_token_metadata();
+    auto& tmap = tm.tablets().get_tablet_map(_schema->id());
+    auto my_id = tm.get_my_id();
+    auto log2_groups = _cg_manager->log2_compaction_groups();
+
+    auto& decision = tmap.get_resize_decision();
+    if (decision.split_or_merge()) {
+        bool split_ready = decision.way == locator::resize_decision::way_type::split
+                && log2_groups > tmap.log2_tablets()
+                && !_splitting_compaction_groups
+                && !_memtables_span_compaction_groups
+                && std::ranges::none_of(_compaction_groups, std::mem_fn(&compaction_group::has_misplaced_sstables));
+        stats.tables.emplace(_schema->id(), locator::table_load_stats{
+            .split_ready_seq_number = split_ready ? decision.sequence_number : 0,
+        });
+    }
+
+    if (log2_groups < tmap.log2_tablets()) {
+        // The tablets were split before our groups, which can't be attributed to them.
+        return;
+    }
+    for (auto& cg : _compaction_groups) {
+        auto tid = locator::tablet_id(cg->group_id() >> (log2_groups - tmap.log2_tablets()));
+        auto shard = tmap.get_shard(tid, my_id);
+        if (!shard || *shard != this_shard_id()) {
+            continue;
+        }
+        auto& s = stats.tablets[locator::global_tablet_id{_schema->id(), tid}];
+        s.size_in_bytes += cg->live_disk_space_used();
+        s.reads += cg->reads();
+        s.writes += cg->writes();
+    }
+}
+
 future<> table::parallel_foreach_compaction_group(std::function<future<>(compaction_group&)> action) {
     // TODO: place a barrier here when we allow dynamic groups.
     co_await coroutine::parallel_for_each(compaction_groups(), [&] (const compaction_group_ptr& cg) {
@@ -675,9 +837,10 @@ future<> table::parallel_foreach_compaction_group(std::function<future<>(compact
 future<sstables::sstable_list> table::take_storage_snapshot(dht::token_range tr) {
     sstables::sstable_list ret;
 
-    for (auto cg_id : compaction_group_ids_for_token_range(tr)) {
-        auto& cg = _compaction_groups[cg_id];
-
+    // Groups can be split while we flush, but they are never destroyed.
+    auto groups = boost::copy_range<std::vector<compaction_group*>>(compaction_group_ids_for_token_range(tr)
+            | boost::adaptors::transformed([this] (size_t cg_id) { return _compaction_groups[cg_id].get(); }));
+    for (auto cg : groups) {
         // We don't care about sstables in snapshot being unlinked, as the file
         // descriptors remain opened until last reference to them are gone.
         // Also, we should be careful with taking a deletion lock here as a
@@ -705,7 +868,7 @@ void table::update_stats_for_new_sstable(const sstables::shared_sstable& sst) no
 future<>
 table::do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::offstrategy offstrategy) {
     auto permit = co_await seastar::get_units(_sstable_set_mutation_sem, 1);
-    co_return co_await get_row_cache().invalidate(row_cache::external_updater([this, sst, offstrategy] () noexcept {
+    co_await get_row_cache().invalidate(row_cache::external_updater([this, sst, offstrategy] () noexcept {
         // FIXME: this is not really noexcept, but we need to provide strong exception guarantees.
         // atomically load all opened sstables into column family.
         compaction_group& cg = compaction_group_for_sstable(sst);
@@ -716,6 +879,9 @@ table::do_add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::o
         }
         update_stats_for_new_sstable(sst);
     }), dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true}));
+    if (_config.hot_partition_replicas) {
+        co_await _config.hot_partition_replicas->invalidate(_schema->id());
+    }
 }
 
 future<>
@@ -725,10 +891,10 @@ table::add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::offs
 }
 
 future<>
-table::add_sstables_and_update_cache(const std::vector<sstables::shared_sstable>& ssts) {
+table::add_sstables_and_update_cache(const std::vector<sstables::shared_sstable>& ssts, sstables::offstrategy offstrategy) {
     for (auto& sst : ssts) {
         try {
-            co_await do_add_sstable_and_update_cache(sst, sstables::offstrategy::no);
+            co_await do_add_sstable_and_update_cache(sst, offstrategy);
         } catch (...) {
             tlogger.error("Failed to load SSTable {}: {}", sst->toc_filename(), std::current_exception());
             throw;
@@ -995,15 +1161,23 @@ table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtabl
         metadata.min_timestamp = old->get_min_timestamp();
         metadata.max_timestamp = old->get_max_timestamp();
         auto estimated_partitions = _compaction_strategy.adjust_partition_estimate(metadata, old->partition_count());
+        // The interposer may split the flush into one sstable per time window (TWCS),
+        // each written concurrently, so size every writer for its share of the memtable
+        // rather than for the whole of it, otherwise each one preallocates the full size.
+        auto estimated_data_size = old->occupancy().used_space();
+        if (auto partitions = old->partition_count(); partitions > estimated_partitions) {
+            estimated_data_size = uint64_t(double(estimated_data_size) * estimated_partitions / partitions);
+        }
 
         if (!cg.async_gate().is_closed()) {
             co_await _compaction_manager.maybe_wait_for_sstable_count_reduction(cg.as_table_state());
         }
 
-        auto consumer = _compaction_strategy.make_interposer_consumer(metadata, [this, old, permit, &newtabs, estimated_partitions, &cg] (flat_mutation_reader_v2 reader) mutable -> future<> {
+        auto consumer = _compaction_strategy.make_interposer_consumer(metadata, [this, old, permit, &newtabs, estimated_partitions, estimated_data_size, &cg] (flat_mutation_reader_v2 reader) mutable -> future<> {
           std::exception_ptr ex;
           try {
             sstables::sstable_writer_config cfg = get_sstables_manager().configure_writer("memtable");
+            cfg.estimated_data_size = estimated_data_size;
             cfg.backup = incremental_backups_enabled();
             cfg.erm = _erm;
 
@@ -1063,6 +1237,7 @@ table::try_flush_memtable_to_sstable(compaction_group& cg, lw_shared_ptr<memtabl
 void
 table::start() {
     start_compaction();
+    maybe_split_compaction_groups();
 }
 
 future<>
@@ -1638,6 +1813,7 @@ compaction_group::compaction_group(table& t, size_t group_id, dht::token_range t
     , _maintenance_sstables(t.make_maintenance_sstable_set())
 {
     _t._compaction_manager.add(as_table_state());
+    get_backlog_tracker().set_weight(_t.compaction_backlog_weight());
 }
 
 future<> compaction_group::stop() noexcept {
@@ -1649,6 +1825,106 @@ future<> compaction_group::stop() noexcept {
     co_await _t._compaction_manager.remove(as_table_state());
 }
 
+void compaction_group::narrow(size_t gid, dht::token_range token_range) noexcept {
+    _group_id = gid;
+    _token_range = std::move(token_range);
+}
+
+static bool sstable_within(const dht::token_range& range, const sstables::shared_sstable& sst) {
+    auto cmp = dht::token_comparator();
+    return range.contains(sst->get_first_decorated_key().token(), cmp) && range.contains(sst->get_last_decorated_key().token(), cmp);
+}
+
+bool compaction_group::has_misplaced_sstables() const {
+    auto misplaced = [this] (const sstables::shared_sstable& sst) {
+        return stop_iteration(!sstable_within(_token_range, sst));
+    };
+    return bool(_main_sstables->for_each_sstable_until(misplaced)) || bool(_maintenance_sstables->for_each_sstable_until(misplaced));
+}
+
+future<> compaction_group::split_misplaced_sstables() {
+    auto holder = _async_gate.hold();
+    co_await _t._compaction_manager.run_with_compaction_disabled(as_table_state(), [this] () -> future<> {
+        std::vector<std::pair<sstables::shared_sstable, bool>> misplaced; // with whether it's a maintenance sstable
+        _main_sstables->for_each_sstable([&] (const sstables::shared_sstable& sst) {
+            if (!sstable_within(_token_range, sst)) {
+                misplaced.emplace_back(sst, false);
+            }
+        });
+        _maintenance_sstables->for_each_sstable([&] (const sstables::shared_sstable& sst) {
+            if (!sstable_within(_token_range, sst)) {
+                misplaced.emplace_back(sst, true);
+            }
+        });
+        for (auto& [sst, maintenance] : misplaced) {
+            co_await split_misplaced_sstable(sst, maintenance);
+        }
+    });
+}
+
+future<> compaction_group::split_misplaced_sstable(sstables::shared_sstable sst, bool maintenance) {
+    const auto& s = _t.schema();
+    auto group_ids = _t.compaction_group_ids_for_token_range(dht::token_range::make(
+            sst->get_first_decorated_key().token(), sst->get_last_decorated_key().token()));
+    tlogger.debug("Splitting sstable {} of compaction group {} into {} groups", sst->get_filename(), group_id(), group_ids.size());
+
+    std::vector<std::pair<compaction_group*, sstables::shared_sstable>> pieces;
+    std::exception_ptr ex;
+    try {
+        for (auto id : group_ids) {
+            auto& target = *_t._compaction_groups[id];
+            auto permit = _t.compaction_concurrency_semaphore().make_tracking_only_permit(s.get(), "split_misplaced_sstable", db::no_timeout, {});
+            // Must outlive the reader.
+            auto pr = dht::to_partition_range(target.token_range());
+            auto reader = sst->make_reader(s, std::move(permit), pr, s->full_slice());
+            if (!co_await reader.peek()) {
+                co_await reader.close();
+                continue;
+            }
+            auto piece = _t.make_sstable();
+            pieces.emplace_back(&target, piece);
+            auto cfg = _t.get_sstables_manager().configure_writer("split");
+            cfg.erm = _t.get_effective_replication_map();
+            co_await piece->write_components(std::move(reader), sst->get_estimated_key_count() / group_ids.size() + 1, s, cfg,
+                    sst->get_encoding_stats_for_compaction());
+            co_await piece->open_data();
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        for (auto& [target, piece] : pieces) {
+            piece->mark_for_deletion();
+        }
+        co_await coroutine::return_exception_ptr(std::move(ex));
+    }
+
+    auto permit = co_await seastar::get_units(_t._sstable_set_mutation_sem, 1);
+    // The data doesn't change, row_cache::invalidate() is only used to synchronize the update.
+    dht::partition_range_vector empty_ranges = {};
+    co_await _t.get_row_cache().invalidate(row_cache::external_updater([&] () noexcept {
+        auto& set = maintenance ? _maintenance_sstables : _main_sstables;
+        auto new_set = make_lw_shared<sstables::sstable_set>(*set);
+        new_set->erase(sst);
+        set = std::move(new_set);
+        if (!maintenance) {
+            backlog_tracker_adjust_charges({sst}, {});
+        }
+        for (auto& [target, piece] : pieces) {
+            if (maintenance) {
+                target->add_maintenance_sstable(piece);
+            } else {
+                target->add_sstable(piece);
+            }
+        }
+        _t.refresh_compound_sstable_set();
+    }), std::move(empty_ranges));
+    _t.get_row_cache().refresh_snapshot();
+    _t.rebuild_statistics();
+
+    co_await delete_sstables_atomically({sst});
+}
+
 void compaction_group::clear_sstables() {
     _main_sstables = make_lw_shared<sstables::sstable_set>(_t._compaction_strategy.make_sstable_set(_t._schema));
     _maintenance_sstables = _t.make_maintenance_sstable_set();
@@ -1677,6 +1953,7 @@ table::table(schema_ptr schema, config config, lw_shared_ptr<const storage_optio
     , _sstables_manager(sst_manager)
     , _index_manager(this->as_data_dictionary())
     , _counter_cell_locks(_schema->is_counter() ? std::make_unique<cell_locker>(_schema, cl_stats) : nullptr)
+    , _counter_updates_in_progress(dht::decorated_key::less_comparator(_schema))
     , _row_locker(_schema)
     , _off_strategy_trigger([this] { trigger_offstrategy_compaction(); })
 {
@@ -1691,6 +1968,75 @@ void table::update_effective_replication_map(locator::effective_replication_map_
         _erm->invalidate();
     }
     _erm = std::move(erm);
+    maybe_split_compaction_groups();
+}
+
+size_t table::wanted_log2_compaction_groups() const {
+    auto& tmap = _erm->get_token_metadata().tablets().get_tablet_map(_schema->id());
+    auto log2 = tmap.log2_tablets();
+    if (tmap.get_resize_decision().way == locator::resize_decision::way_type::split) {
+        log2 += 1;
+    }
+    return log2;
+}
+
+void table::maybe_split_compaction_groups() {
+    if (!uses_tablets() || _splitting_compaction_groups || _async_gate.is_closed()) {
+        return;
+    }
+    auto& tmap = _erm->get_token_metadata().tablets().get_tablet_map(_schema->id());
+    bool splitting = tmap.get_resize_decision().way == locator::resize_decision::way_type::split;
+    if (_cg_manager->log2_compaction_groups() >= wanted_log2_compaction_groups() && !_memtables_span_compaction_groups
+            && !(splitting && std::ranges::any_of(_compaction_groups, std::mem_fn(&compaction_group::has_misplaced_sstables)))) {
+        return;
+    }
+    // Run in background, the table's async gate is waited for by stop().
+    (void)with_gate(_async_gate, [this] {
+        return split_compaction_groups();
+    }).handle_exception([this] (std::exception_ptr ex) {
+        tlogger.warn("Splitting compaction groups of {}.{} failed: {}, will retry on the next topology change", _schema->ks_name(), _schema->cf_name(), ex);
+    });
+}
+
+future<> table::split_compaction_groups() {
+    _splitting_compaction_groups = true;
+    auto reset = defer([this] { _splitting_compaction_groups = false; });
+
+    // Each group keeps the lower half of its range, and keeps its memtables and sstables,
+    // which may hold data of the upper half. A new group takes the upper half.
+    // Compaction groups are referenced by pointer across preemption points, so they
+    // must outlive the switch, which is done without preemption.
+    while (_cg_manager->log2_compaction_groups() < wanted_log2_compaction_groups()) {
+        auto log2 = _cg_manager->log2_compaction_groups() + 1;
+        tlogger.info("Splitting compaction groups of {}.{} into {}", _schema->ks_name(), _schema->cf_name(), size_t(1) << log2);
+        compaction_group_vector groups;
+        groups.reserve(_compaction_groups.size() * 2);
+        for (auto& cg : _compaction_groups) {
+            auto left = cg->group_id() * 2;
+            cg->narrow(left, compaction_group_token_range(log2, left));
+            groups.push_back(std::move(cg));
+            groups.push_back(std::make_unique<compaction_group>(*this, left + 1, compaction_group_token_range(log2, left + 1)));
+        }
+        _compaction_groups = std::move(groups);
+        _cg_manager->set_log2_compaction_groups(log2);
+        _memtables_span_compaction_groups = true;
+        refresh_compound_sstable_set();
+    }
+
+    co_await utils::get_local_injector().inject_with_handler("split_compaction_groups_wait_before_flush", [] (auto& handler) {
+        return handler.wait_for_message(std::chrono::steady_clock::now() + std::chrono::minutes{5});
+    });
+
+    // Flush memtables which may hold data of other groups, so that the data lands
+    // in sstables which can be split. Memtables created since then only receive
+    // writes of their own group.
+    if (_memtables_span_compaction_groups) {
+        co_await parallel_foreach_compaction_group(std::mem_fn(&compaction_group::flush));
+        _memtables_span_compaction_groups = false;
+    }
+
+    co_await parallel_foreach_compaction_group(std::mem_fn(&compaction_group::split_misplaced_sstables));
+    tlogger.info("Compaction groups of {}.{} are split into {}", _schema->ks_name(), _schema->cf_name(), _compaction_groups.size());
 }
 
 partition_presence_checker
@@ -1994,6 +2340,9 @@ future<> table::clear() {
     co_await parallel_foreach_compaction_group(std::mem_fn(&compaction_group::clear_memtables));
 
     co_await _cache.invalidate(row_cache::external_updater([] { /* There is no underlying mutation source */ }));
+    if (_config.hot_partition_replicas) {
+        co_await _config.hot_partition_replicas->invalidate(_schema->id());
+    }
 }
 
 // NOTE: does not need to be futurized, but might eventually, depending on
@@ -2049,6 +2398,9 @@ future<db::replay_position> table::discard_sstables(db_clock::time_point truncat
         refresh_compound_sstable_set();
         tlogger.debug("cleaning out row cache");
     }));
+    if (_config.hot_partition_replicas) {
+        co_await _config.hot_partition_replicas->invalidate(_schema->id());
+    }
     rebuild_statistics();
     co_await coroutine::parallel_for_each(p->remove, [this, p] (pruner::removed_sstable& r) -> future<> {
         if (r.enable_backlog_tracker) {
@@ -2257,7 +2609,10 @@ future<> table::generate_and_propagate_view_updates(shared_ptr<db::view::view_up
  * If an operation involves only a range of rows, not an entire partition,
  * we could in theory lock only this range and not an entire partition.
  * However, we expect this case to be rare enough to not care about and we
- * currently just lock the entire partition.
+ * currently just lock the entire partition. An operation involving several
+ * individual rows (e.g. a batch writing to a wide partition), on the other
+ * hand, locks just these rows, so it doesn't serialize with writes to other
+ * rows of the partition.
  *
  * If a base table has *multiple* views, we still read the base table row
  * only once, and have to keep a lock around this read and all the view
@@ -2280,15 +2635,25 @@ table::local_base_lock(
     // This will allow more parallelism in concurrent modifications to the
     // same row - probably not a very urgent case.
     _row_locker.upgrade(s);
-    if (rows.size() == 1 && rows[0].is_singular() && rows[0].start() && !rows[0].start()->value().is_empty(*s)) {
+    // Beyond this many rows, a single partition lock is cheaper than the row locks.
+    static constexpr size_t max_individually_locked_rows = 128;
+    auto is_single_row = [&s] (const query::clustering_range& r) {
+        return r.is_singular() && r.start() && !r.start()->value().is_empty(*s);
+    };
+    if (rows.size() == 1 && is_single_row(rows[0])) {
         // A single clustering row is involved.
         return _row_locker.lock_ck(pk, rows[0].start()->value(), true, timeout, _row_locker_stats);
+    } else if (!rows.empty() && rows.size() <= max_individually_locked_rows && std::ranges::all_of(rows, is_single_row)) {
+        // A few individual rows are involved, lock each of them.
+        return _row_locker.lock_cks(pk, boost::copy_range<std::vector<clustering_key_prefix>>(rows
+                | boost::adaptors::transformed([] (const query::clustering_range& r) { return r.start()->value(); })),
+                true, timeout, _row_locker_stats);
     } else {
-        // More than a single clustering row is involved. Most commonly it's
-        // the entire partition, so let's lock the entire partition. We could
+        // Row ranges or many rows are involved. Most commonly it's the
+        // entire partition, so let's lock the entire partition. We could
         // lock less than the entire partition in more elaborate cases where
-        // just a few individual rows are involved, or row ranges, but we
-        // don't think this will make a practical difference.
+        // just row ranges are involved, but we don't think this will make a
+        // practical difference.
         return _row_locker.lock_pk(pk, true, timeout, _row_locker_stats);
     }
 }
@@ -2419,6 +2784,7 @@ void table::do_apply(compaction_group& cg, db::rp_handle&& h, Args&&... args) {
     try {
         cg.memtables()->active_memtable().apply(std::forward<Args>(args)..., std::move(h));
         _highest_rp = std::max(_highest_rp, rp);
+        cg.note_write();
     } catch (...) {
         _failed_counter_applies_to_memtable++;
         throw;
@@ -2427,11 +2793,12 @@ void table::do_apply(compaction_group& cg, db::rp_handle&& h, Args&&... args) {
 }
 
 future<> table::apply(const mutation& m, db::rp_handle&& h, db::timeout_clock::time_point timeout) {
+    _heavy_hitters_for_writes.record(dht::token::to_int64(m.token()), 0);
     auto& cg = compaction_group_for_token(m.token());
     auto holder = cg.async_gate().hold();
     return dirty_memory_region_group().run_when_memory_available([this, &m, h = std::move(h), &cg, holder = std::move(holder)] () mutable {
         do_apply(cg, std::move(h), m);
-    }, timeout);
+    }, timeout, cg.memtables()->within_dirty_memory_share());
 }
 
 template void table::do_apply(compaction_group& cg, db::rp_handle&&, const mutation&);
@@ -2441,12 +2808,13 @@ future<> table::apply(const frozen_mutation& m, schema_ptr m_schema, db::rp_hand
         return (*_virtual_writer)(m);
     }
 
+    _heavy_hitters_for_writes.record(dht::token::to_int64(m.token(*m_schema)), m.representation().size());
     auto& cg = compaction_group_for_key(m.key(), m_schema);
     auto holder = cg.async_gate().hold();
 
     return dirty_memory_region_group().run_when_memory_available([this, &m, m_schema = std::move(m_schema), h = std::move(h), &cg, holder = std::move(holder)]() mutable {
         do_apply(cg, std::move(h), m, m_schema);
-    }, timeout);
+    }, timeout, cg.memtables()->within_dirty_memory_share());
 }
 
 template void table::do_apply(compaction_group& cg, db::rp_handle&&, const frozen_mutation&, const schema_ptr&);
@@ -2485,6 +2853,24 @@ write_memtable_to_sstable(memtable& mt, sstables::shared_sstable sst, sstables::
     });
 }
 
+// Whether the ranges are distinct partition keys in ring order, as sent by IN queries,
+// so that a single reader can be fast-forwarded through all of them.
+static bool is_batch_of_keys(const schema& s, const dht::partition_range_vector& ranges) {
+    if (ranges.size() < 2) {
+        return false;
+    }
+    dht::ring_position_comparator cmp(s);
+    for (auto it = ranges.begin(); it != ranges.end(); ++it) {
+        if (!it->is_singular() || !it->start()->value().has_key()) {
+            return false;
+        }
+        if (it != ranges.begin() && cmp(std::prev(it)->start()->value(), it->start()->value()) >= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
 future<lw_shared_ptr<query::result>>
 table::query(schema_ptr s,
         reader_permit permit,
@@ -2508,6 +2894,8 @@ table::query(schema_ptr s,
         _async_gate.leave();
     });
 
+    note_reads(partition_ranges);
+
     const auto short_read_allowed = query::short_read(cmd.slice.options.contains<query::partition_slice::option::allow_short_read>());
     auto accounter = co_await (opts.request == query::result_request::only_digest
              ? memory_limiter.new_digest_read(permit.max_result_size(), short_read_allowed)
@@ -2520,6 +2908,33 @@ table::query(schema_ptr s,
         querier_opt = std::move(*saved_querier);
     }
 
+    // A batch of keys is read with one reader, which lets the sstable set reuse the
+    // readers of sstables containing several of the keys, instead of setting up a
+    // whole reader stack per key. Stateful (paged) queries keep reading range by
+    // range, as the querier saved for the next page has to be able to resume from
+    // any of them, the querier of a batch is never saved.
+    const bool read_batch = !querier_opt && !cmd.query_uuid && !cmd.slice.is_reversed() && is_batch_of_keys(*s, partition_ranges);
+    if (read_batch) {
+        auto ms = mutation_source([this, &partition_ranges] (schema_ptr s, reader_permit permit, const dht::partition_range&,
+                const query::partition_slice& slice, tracing::trace_state_ptr trace_state, streamed_mutation::forwarding, mutation_reader::forwarding) {
+            return make_flat_multi_range_reader(std::move(s), std::move(permit), as_mutation_source(), partition_ranges, slice, std::move(trace_state));
+        });
+        query::querier_base::querier_config conf(_config.tombstone_warn_threshold);
+        querier_opt = query::querier(ms, s, permit, partition_ranges.front(), qs.cmd.slice, trace_state, conf);
+        qs.current_partition_range = qs.range_end;
+
+        std::exception_ptr ex;
+      try {
+        co_await querier_opt->consume_page(query_result_builder(*s, qs.builder), qs.remaining_rows(), qs.remaining_partitions(), qs.cmd.timestamp, trace_state);
+      } catch (...) {
+        ex = std::current_exception();
+      }
+        if (ex) {
+            co_await querier_opt->close();
+            co_return coroutine::exception(std::move(ex));
+        }
+    }
+
     while (!qs.done()) {
         auto&& range = *qs.current_partition_range++;
 
@@ -2549,7 +2964,7 @@ table::query(schema_ptr s,
         last_pos.emplace(*querier_opt->current_position());
     }
 
-    if (!saved_querier || (querier_opt && !querier_opt->are_limits_reached() && !qs.builder.is_short_read())) {
+    if (!saved_querier || read_batch || (querier_opt && !querier_opt->are_limits_reached() && !qs.builder.is_short_read())) {
         co_await querier_opt->close();
         querier_opt = {};
     }
@@ -2557,7 +2972,9 @@ table::query(schema_ptr s,
         *saved_querier = std::move(querier_opt);
     }
 
-    co_return make_lw_shared<query::result>(qs.builder.build(std::move(last_pos)));
+    auto result = make_lw_shared<query::result>(qs.builder.build(std::move(last_pos)));
+    note_heavy_hitter_reads(partition_ranges, *result);
+    co_return result;
 }
 
 future<reconcilable_result>
@@ -2686,6 +3103,21 @@ void table::set_tombstone_gc_enabled(bool tombstone_gc_enabled) noexcept {
     }
 }
 
+void table::set_compaction_shares(int32_t shares) noexcept {
+    if (shares == _compaction_shares) {
+        return;
+    }
+    _compaction_shares = shares;
+    tlogger.debug("Compaction shares of {}.{} set to {}", _schema->ks_name(), _schema->cf_name(), shares);
+    for (const compaction_group_ptr& cg : compaction_groups()) {
+        cg->get_backlog_tracker().set_weight(compaction_backlog_weight());
+    }
+}
+
+double table::compaction_backlog_weight() const noexcept {
+    return double(_compaction_shares) / default_compaction_shares;
+}
+
 flat_mutation_reader_v2
 table::make_reader_v2_excluding_staging(schema_ptr s,
         reader_permit permit,
@@ -2708,6 +3140,48 @@ table::make_reader_v2_excluding_staging(schema_ptr s,
     return make_combined_reader(s, std::move(permit), std::move(readers), fwd, fwd_mr);
 }
 
+future<> table::mark_repaired_sstables(dht::token_range_vector owned_ranges) {
+    const auto& gc_state = get_compaction_manager().get_tombstone_gc_state();
+    // Only the owned ranges matter, as repair reads only them. Taking the
+    // oldest repair of all of them keeps this cheap enough to be done after
+    // the repair of each range, at the cost of marking some sstables later.
+    auto repair_time = gc_clock::time_point::max();
+    for (const auto& r : owned_ranges) {
+        auto t = gc_state.get_repair_time_for_range(_schema->id(), r);
+        if (!t) {
+            co_return;
+        }
+        repair_time = std::min(repair_time, *t);
+        co_await coroutine::maybe_yield();
+    }
+    if (repair_time == gc_clock::time_point::max()) {
+        co_return;
+    }
+
+    // Keeps the sstables from being deleted while their statistics are rewritten.
+    auto units = co_await get_units(_sstable_deletion_sem, 1);
+    auto sstables = _sstables->all();
+    size_t marked = 0;
+    for (const auto& sst : *sstables) {
+        co_await coroutine::maybe_yield();
+        // Shared sstables are rewritten by each of their shards, staging ones
+        // are still being processed.
+        if (sst->is_repaired() || sst->is_shared() || sst->requires_view_building() || requires_cleanup(sst)) {
+            continue;
+        }
+        // Data which this node could read when the repair started was
+        // synchronized with all the other replicas.
+        if (repair_time <= to_gc_clock(sst->opened_at())) {
+            continue;
+        }
+        co_await sst->mutate_repaired_at(std::chrono::duration_cast<std::chrono::milliseconds>(repair_time.time_since_epoch()).count());
+        ++marked;
+    }
+    if (marked) {
+        tlogger.debug("Marked {} sstables of {}.{} as repaired", marked, _schema->ks_name(), _schema->cf_name());
+    }
+}
+
 future<> table::move_sstables_from_staging(std::vector<sstables::shared_sstable> sstables) {
     auto units = co_await get_units(_sstable_deletion_sem, 1);
     sstables::delayed_commit_changes delay_commit;
@@ -2929,8 +3403,9 @@ class compaction_group::table_state : public compaction::table_state {
         cfg.erm = _t.get_effective_replication_map();
         return cfg;
     }
-    api::timestamp_type min_memtable_timestamp() const override {
-        return _cg.min_memtable_timestamp();
+    api::timestamp_type min_memtable_timestamp(const dht::decorated_key& dk) const override {
+        // Not _cg's, memtables of other groups may hold the key while groups are split.
+        return _t.min_memtable_timestamp(dk);
     }
     future<> on_compaction_completion(sstables::compaction_completion_desc desc, sstables::offstrategy offstrategy) override {
         if (offstrategy) {
@@ -3046,23 +3521,41 @@ future<> compaction_group::cleanup() {
     tlogger.debug("Invalidating range {} for compaction group {} of table {} during cleanup.",
                   p_range, group_id(), _t.schema()->ks_name(), _t.schema()->cf_name());
     co_await _t._cache.invalidate(std::move(updater), p_range);
+    if (_t._config.hot_partition_replicas) {
+        co_await _t._config.hot_partition_replicas->invalidate(_t.schema()->id());
+    }
 }
 
 future<> table::cleanup_tablet(locator::tablet_id tid) {
     auto holder = async_gate().hold();
 
-    auto& cg_ptr = _compaction_groups[tid.value()];
-
-    if (!cg_ptr) {
-        throw std::runtime_error(format("Cannot cleanup tablet {} of table {}.{} because it is not allocated in this shard",
+    // The tablet is covered by several compaction groups if they were split ahead of tablets.
+    auto& tmap = _erm->get_token_metadata().tablets().get_tablet_map(_schema->id());
+    auto log2_groups = _cg_manager->log2_compaction_groups();
+    if (log2_groups < tmap.log2_tablets()) {
+        throw std::runtime_error(format("Cannot cleanup tablet {} of table {}.{} because its compaction groups are not split yet",
                                         tid, _schema->ks_name(), _schema->cf_name()));
     }
+    auto groups_per_tablet = size_t(1) << (log2_groups - tmap.log2_tablets());
+    std::vector<compaction_group*> groups;
+    for (auto id = tid.value() * groups_per_tablet; id < (tid.value() + 1) * groups_per_tablet; ++id) {
+        auto& cg_ptr = _compaction_groups[id];
+        if (!cg_ptr) {
+            throw std::runtime_error(format("Cannot cleanup tablet {} of table {}.{} because it is not allocated in this shard",
+                                            tid, _schema->ks_name(), _schema->cf_name()));
+        }
+        groups.push_back(cg_ptr.get());
+    }
 
-    // Synchronizes with in-flight writes if any, and also takes care of flushing if needed.
-    // FIXME: to be able to stop group and provide guarantee above, we must first be able to reallocate a new group if tablet is migrated back.
-    //co_await _cg.stop();
-    co_await cg_ptr->flush();
-    co_await cg_ptr->cleanup();
+    for (auto cg : groups) {
+        // Synchronizes with in-flight writes if any, and also takes care of flushing if needed.
+        // FIXME: to be able to stop group and provide guarantee above, we must first be able to reallocate a new group if tablet is migrated back.
+        //co_await _cg.stop();
+        co_await cg->flush();
+        // Data of other tablets which is left in the group after a split must survive the cleanup.
+        co_await cg->split_misplaced_sstables();
+        co_await cg->cleanup();
+    }
 
     tlogger.info("Cleaned up tablet {} of table {}.{} successfully.", tid, _schema->ks_name(), _schema->cf_name());
 
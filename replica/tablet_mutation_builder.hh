@@ -36,6 +36,7 @@ class tablet_mutation_builder {
     tablet_mutation_builder& set_replicas(dht::token last_token, locator::tablet_replica_set replicas);
     tablet_mutation_builder& set_stage(dht::token last_token, locator::tablet_transition_stage stage);
     tablet_mutation_builder& del_transition(dht::token last_token);
+    tablet_mutation_builder& set_resize_decision(locator::resize_decision);
 
     mutation build() {
         return std::move(_m);
@@ -35,11 +35,13 @@ schema_ptr make_tablets_schema() {
             .with_column("table_id", uuid_type, column_kind::partition_key)
             .with_column("tablet_count", int32_type, column_kind::static_column)
             .with_column("table_name", utf8_type, column_kind::static_column)
+            .with_column("resize_type", utf8_type, column_kind::static_column)
+            .with_column("resize_seq_number", long_type, column_kind::static_column)
             .with_column("last_token", long_type, column_kind::clustering_key)
             .with_column("replicas", replica_set_type)
             .with_column("new_replicas", replica_set_type)
             .with_column("stage", utf8_type)
-            .with_version(db::system_keyspace::generate_schema_version(id))
+            .with_version(db::system_keyspace::generate_schema_version(id, 1))
             .build();
 }
 
@@ -70,6 +72,8 @@ tablet_map_to_mutation(const tablet_map& tablets, table_id id, const sstring& ke
     m.partition().apply(tombstone(tombstone_ts, gc_now));
     m.set_static_cell("tablet_count", data_value(int(tablets.tablet_count())), ts);
     m.set_static_cell("table_name", data_value(table_name), ts);
+    m.set_static_cell("resize_type", data_value(resize_decision_way_to_string(tablets.get_resize_decision().way)), ts);
+    m.set_static_cell("resize_seq_number", data_value(int64_t(tablets.get_resize_decision().sequence_number)), ts);
 
     tablet_id tid = tablets.first_tablet();
     for (auto&& tablet : tablets.tablets()) {
@@ -104,6 +108,13 @@ tablet_mutation_builder::set_stage(dht::token last_token, locator::tablet_transi
     return *this;
 }
 
+tablet_mutation_builder&
+tablet_mutation_builder::set_resize_decision(locator::resize_decision decision) {
+    _m.set_static_cell("resize_type", data_value(resize_decision_way_to_string(decision.way)), _ts);
+    _m.set_static_cell("resize_seq_number", data_value(int64_t(decision.sequence_number)), _ts);
+    return *this;
+}
+
 tablet_mutation_builder&
 tablet_mutation_builder::del_transition(dht::token last_token) {
     auto ck = get_ck(last_token);
@@ -171,6 +182,12 @@ future<tablet_metadata> read_tablet_metadata(cql3::query_processor& qp) {
             }
             auto tablet_count = row.get_as<int>("tablet_count");
             auto tmap = tablet_map(tablet_count);
+            if (row.has("resize_type")) {
+                tmap.set_resize_decision(resize_decision{
+                    resize_decision_way_from_string(row.get_as<sstring>("resize_type")),
+                    uint64_t(row.get_or<int64_t>("resize_seq_number", 0)),
+                });
+            }
             current = active_tablet_map{table, tmap, tmap.first_tablet()};
         }
 
@@ -53,26 +53,50 @@ row_cache::create_underlying_reader(read_context& ctx, mutation_source& src, con
 
 static thread_local mutation_application_stats dummy_app_stats;
 static thread_local utils::updateable_value<double> dummy_index_cache_fraction(1.0);
+static thread_local utils::updateable_value<bool> dummy_scans_on_probation(false);
+static thread_local utils::updateable_value<uint32_t> dummy_compressed_cache_size_in_mb(0);
+static thread_local utils::updateable_value<uint32_t> dummy_absent_partition_cache_size_in_mb(0);
+static thread_local utils::updateable_value<uint32_t> dummy_update_max_rows_per_partition(0);
 
 cache_tracker::cache_tracker()
-    : cache_tracker(dummy_index_cache_fraction, dummy_app_stats, register_metrics::no)
+    : cache_tracker(dummy_index_cache_fraction, dummy_scans_on_probation, dummy_compressed_cache_size_in_mb, dummy_absent_partition_cache_size_in_mb,
+            dummy_update_max_rows_per_partition, dummy_app_stats, register_metrics::no)
 {}
 
-cache_tracker::cache_tracker(utils::updateable_value<double> index_cache_fraction, register_metrics with_metrics)
-    : cache_tracker(std::move(index_cache_fraction), dummy_app_stats, with_metrics)
+cache_tracker::cache_tracker(utils::updateable_value<double> index_cache_fraction, utils::updateable_value<bool> scans_on_probation,
+        utils::updateable_value<uint32_t> compressed_cache_size_in_mb, utils::updateable_value<uint32_t> absent_partition_cache_size_in_mb,
+        utils::updateable_value<uint32_t> update_max_rows_per_partition, register_metrics with_metrics)
+    : cache_tracker(std::move(index_cache_fraction), std::move(scans_on_probation), std::move(compressed_cache_size_in_mb),
+            std::move(absent_partition_cache_size_in_mb), std::move(update_max_rows_per_partition), dummy_app_stats, with_metrics)
 {}
 
 static thread_local cache_tracker* current_tracker;
 
-cache_tracker::cache_tracker(utils::updateable_value<double> index_cache_fraction, mutation_application_stats& app_stats, register_metrics with_metrics)
+cache_tracker::cache_tracker(utils::updateable_value<double> index_cache_fraction, utils::updateable_value<bool> scans_on_probation,
+        utils::updateable_value<uint32_t> compressed_cache_size_in_mb, utils::updateable_value<uint32_t> absent_partition_cache_size_in_mb,
+        utils::updateable_value<uint32_t> update_max_rows_per_partition, mutation_application_stats& app_stats, register_metrics with_metrics)
     : _garbage(_region, this, app_stats)
     , _memtable_cleaner(_region, nullptr, app_stats)
     , _app_stats(app_stats)
     , _index_cache_fraction(std::move(index_cache_fraction))
+    , _scans_on_probation(std::move(scans_on_probation))
+    , _compressed_cache_size_in_mb(std::move(compressed_cache_size_in_mb))
+    , _compression_timer([this] { on_compression_timer(); })
+    , _compressed_cache_size_observer(_compressed_cache_size_in_mb.observe([this] (const uint32_t&) {
+        update_compression_timer();
+    }))
+    , _absent_partition_cache_size_in_mb(std::move(absent_partition_cache_size_in_mb))
+    , _absent_partition_cache_size_observer(_absent_partition_cache_size_in_mb.observe([this] (const uint32_t& size) {
+        if (!size) {
+            _absent.clear();
+        }
+    }))
+    , _update_max_rows_per_partition(std::move(update_max_rows_per_partition))
 {
     if (with_metrics) {
         setup_metrics();
     }
+    update_compression_timer();
 
     _region.make_evictable([this] {
         return with_allocator(_region.allocator(), [this] () noexcept {
@@ -110,7 +134,8 @@ cache_tracker::cache_tracker(utils::updateable_value<double> index_cache_fractio
             //
             // Perhaps this logic should be encapsulated somewhere else, maybe in `class lru` itself.
             size_t total_cache_space = _region.occupancy().total_space();
-            size_t index_cache_space = _partition_index_cache_stats.used_bytes + _index_cached_file_stats.cached_bytes;
+            size_t index_cache_space = _partition_index_cache_stats.used_bytes + _index_cached_file_stats.cached_bytes
+                    + _promoted_index_block_cache_stats.used_bytes;
             bool should_evict_index = index_cache_space > total_cache_space * _index_cache_fraction.get();
 
             return _lru.evict(should_evict_index);
@@ -137,6 +162,7 @@ void cache_tracker::set_compaction_scheduling_group(seastar::scheduling_group sg
 namespace sstables {
 void register_index_page_cache_metrics(seastar::metrics::metric_groups&, cached_file_stats&);
 void register_index_page_metrics(seastar::metrics::metric_groups&, partition_index_cache_stats&);
+void register_promoted_index_block_metrics(seastar::metrics::metric_groups&, promoted_index_block_cache_stats&);
 };
 
 void
@@ -185,9 +211,34 @@ cache_tracker::setup_metrics() {
             sm::description("total amount of attempts to compact expired rows during read")),
         sm::make_counter("rows_compacted_away", _stats.rows_compacted_away,
             sm::description("total amount of compacted and removed rows during read")),
+        sm::make_counter("probation_row_hits", _stats.probation_row_hits,
+            sm::description("total number of rows touched by reads while in the probationary segment of the cache, which promotes them to the protected segment")),
+        sm::make_counter("protected_row_hits", _stats.protected_row_hits,
+            sm::description("total number of rows touched by reads while in the protected segment of the cache")),
+        sm::make_counter("reads_bypassed_by_admission", _stats.reads_bypassed_by_admission,
+            sm::description("total number of reads which bypassed the cache due to the cache_admission_policy of their scheduling group")),
+        sm::make_gauge("probation_rows", sm::description("number of cache entries in the probationary segment"), [this] { return _lru.probation_size(); }),
+        sm::make_gauge("protected_rows", sm::description("number of cache entries in the protected segment"), [this] { return _lru.protected_size(); }),
+        sm::make_counter("partition_compressions", _stats.partition_compressions,
+            sm::description("total number of cold partitions moved out of the cache in compressed form")),
+        sm::make_counter("compressed_partition_hits", _stats.compressed_partition_hits,
+            sm::description("total number of partitions needed by reads and restored from their compressed form")),
+        sm::make_counter("compressed_partition_evictions", sm::description("total number of compressed partitions dropped to stay within compressed_cache_size_in_mb"),
+            [this] { return _compressed.get_stats().evictions; }),
+        sm::make_gauge("compressed_partitions", sm::description("number of partitions held in compressed form"), [this] { return _compressed.size(); }),
+        sm::make_gauge("compressed_bytes", sm::description("memory used by the partitions held in compressed form"), [this] { return _compressed.memory_usage(); }),
+        sm::make_counter("absent_partition_hits", _stats.absent_partition_hits,
+            sm::description("total number of single-partition reads answered from the keys of partitions known to be absent")),
+        sm::make_counter("absent_partition_evictions", sm::description("total number of absent partition keys dropped to stay within absent_partition_cache_size_in_mb"),
+            [this] { return _absent.get_stats().evictions; }),
+        sm::make_gauge("absent_partitions", sm::description("number of keys of partitions known to be absent"), [this] { return _absent.size(); }),
+        sm::make_gauge("absent_partition_bytes", sm::description("memory used by the keys of partitions known to be absent"), [this] { return _absent.memory_usage(); }),
+        sm::make_counter("partitions_invalidated_on_update", _stats.partitions_invalidated_on_update,
+            sm::description("total number of flushed partitions which invalidated the cache instead of being merged into it, due to cache_update_max_rows_per_partition")),
     });
     sstables::register_index_page_cache_metrics(_metrics, _index_cached_file_stats);
     sstables::register_index_page_metrics(_metrics, _partition_index_cache_stats);
+    sstables::register_promoted_index_block_metrics(_metrics, _promoted_index_block_cache_stats);
 }
 
 void cache_tracker::clear() {
@@ -204,14 +255,156 @@ void cache_tracker::clear() {
         _garbage.clear();
         _memtable_cleaner.clear();
     });
+    _compressed.clear();
+    _absent.clear();
     _stats.partition_removals += partitions_before;
     _stats.row_removals += rows_before;
     allocator().invalidate_references();
 }
 
+std::optional<cache_admission> parse_cache_admission(std::string_view name) {
+    if (name == "populate") {
+        return cache_admission::populate;
+    } else if (name == "populate_on_reuse") {
+        return cache_admission::populate_on_reuse;
+    } else if (name == "bypass") {
+        return cache_admission::bypass;
+    }
+    return std::nullopt;
+}
+
+bool cache_tracker::is_reused(size_t partition_hash) {
+    // Big enough to remember the recent misses of a shard, small enough not to matter.
+    static constexpr size_t ghost_size = 1 << 15;
+    if (_admission_ghost.empty()) {
+        _admission_ghost.resize(ghost_size);
+    }
+    auto& slot = _admission_ghost[partition_hash % ghost_size];
+    return std::exchange(slot, partition_hash) == partition_hash;
+}
+
+static constexpr auto compression_period = std::chrono::milliseconds(100);
+static constexpr size_t partitions_compressed_per_period = 64;
+// How many of the least recently used entries are considered when looking for a partition to compress.
+static constexpr size_t compression_search_depth = 32;
+
+void cache_tracker::update_compression_timer() noexcept {
+    if (_compressed_cache_size_in_mb.get()) {
+        if (!_compression_timer.armed()) {
+            _evictions_at_last_compression = _stats.partition_evictions + _stats.row_evictions;
+            _compression_timer.arm_periodic(compression_period);
+        }
+    } else {
+        _compression_timer.cancel();
+        _compressed.clear();
+    }
+}
+
+void cache_tracker::on_compression_timer() noexcept {
+    // Compress only when the cache is evicting, i.e. when the least recently used
+    // partitions are about to be lost anyway.
+    auto evictions = _stats.partition_evictions + _stats.row_evictions;
+    if (evictions != _evictions_at_last_compression) {
+        _evictions_at_last_compression = evictions;
+        try {
+            compress_cold_partitions(partitions_compressed_per_period);
+        } catch (...) {
+            clogger.warn("Failed to compress cold partitions: {}", std::current_exception());
+        }
+    }
+}
+
+// Returns the cache_entry which can be moved to the compressed_partition_store, given
+// one of its LRU entries, or nullptr.
+//
+// Only complete partitions which have a single version and no snapshots qualify,
+// so that their squashed form holds all the cache knows about them. Such a partition
+// is found by its last dummy, which is usually its least recently used row, because
+// reads touch the partition before its rows.
+static cache_entry* compression_candidate(evictable& e) noexcept {
+    auto* re = dynamic_cast<rows_entry*>(&e);
+    if (!re || !re->is_last_dummy()) {
+        return nullptr;
+    }
+    mutation_partition_v2::rows_type* rows = mutation_partition_v2::rows_type::iterator(re).tree_if_last();
+    if (!rows) {
+        return nullptr;
+    }
+    partition_version& pv = partition_version::container_of(mutation_partition_v2::container_of(*rows));
+    if (!pv.is_referenced_from_entry() || pv.next()) {
+        return nullptr;
+    }
+    partition_entry& pe = partition_entry::container_of(pv);
+    if (pe.has_snapshot() || !pv.partition().is_fully_continuous()) {
+        return nullptr;
+    }
+    cache_entry& ce = cache_entry::container_of(pe);
+    if (ce.is_dummy_entry()) {
+        return nullptr;
+    }
+    // Large partitions are left to eviction, they would be dropped by the store
+    // anyway, after the cost of squashing and serializing them. Their memory usage
+    // bounds their serialized size, stop summing it once it is over the limit.
+    const schema& s = *ce.schema();
+    size_t size = pv.partition().static_row().external_memory_usage(s, column_kind::static_column);
+    for (auto& row : pv.partition().clustered_rows()) {
+        size += row.memory_usage(s);
+        if (size > compressed_partition_store::max_partition_size) {
+            return nullptr;
+        }
+    }
+    return &ce;
+}
+
+size_t cache_tracker::compress_cold_partitions(size_t max_partitions) {
+    size_t capacity = compressed_cache_capacity();
+    size_t compressed = 0;
+    while (capacity && compressed < max_partitions) {
+        bool found = _compression_section(_region, [&] {
+            cache_entry* ce = nullptr;
+            _lru.find_cold(compression_search_depth, [&] (evictable& e) {
+                ce = compression_candidate(e);
+                return ce != nullptr;
+            });
+            if (!ce) {
+                return false;
+            }
+            mutation m(ce->schema(), ce->key(), ce->partition().squashed(*ce->schema(), is_evictable::yes));
+            if (!_compressed.insert(m, capacity)) {
+                return false;
+            }
+            auto evictions = _stats.partition_evictions + _stats.row_evictions;
+            with_allocator(_region.allocator(), [&] {
+                ce->on_evicted(*this);
+                // Readers may hold iterators pointing at the entry.
+                allocator().invalidate_references();
+            });
+            // Don't let our own evictions look like memory pressure to on_compression_timer().
+            _evictions_at_last_compression += _stats.partition_evictions + _stats.row_evictions - evictions;
+            ++_stats.partition_compressions;
+            return true;
+        });
+        if (!found) {
+            break;
+        }
+        ++compressed;
+        // Called from a timer, so give the reactor back between partitions,
+        // the next period picks up where this one stopped.
+        if (need_preempt()) {
+            break;
+        }
+    }
+    return compressed;
+}
+
 void cache_tracker::touch(rows_entry& e) {
     // last dummy may not be linked if evicted
     if (e.is_linked()) {
+        if (e.on_probation()) {
+            ++_stats.probation_row_hits;
+        } else {
+            ++_stats.protected_row_hits;
+        }
         _lru.remove(e);
     }
     _lru.add(e);
@@ -225,6 +418,18 @@ void cache_tracker::insert(cache_entry& entry) {
     _region.allocator().invalidate_references();
 }
 
+void cache_tracker::insert_on_probation(cache_entry& entry) {
+    for (partition_version& pv : entry.partition().versions_from_oldest()) {
+        for (rows_entry& row : pv.partition().clustered_rows()) {
+            insert_on_probation(row);
+        }
+    }
+    ++_stats.partition_insertions;
+    ++_stats.partitions;
+    // partition_range_cursor depends on this to detect invalidation of _end
+    _region.allocator().invalidate_references();
+}
+
 void cache_tracker::on_partition_erase() noexcept {
     --_stats.partitions;
     ++_stats.partition_removals;
@@ -422,9 +627,13 @@ class single_partition_populating_reader final : public flat_mutation_reader_v2:
           return _read_context->underlying().underlying()().then([this, phase] (auto&& mfopt) {
             if (!mfopt) {
                 if (phase == _cache.phase_of(_read_context->range().start()->value())) {
-                    _cache._read_section(_cache._tracker.region(), [this] {
-                        _cache.find_or_create_missing(_read_context->key());
-                    });
+                    if (size_t capacity = _cache._tracker.absent_partition_cache_capacity()) {
+                        _cache._tracker.absent_partitions().insert(*_cache._schema, _read_context->key(), capacity);
+                    } else {
+                        _cache._read_section(_cache._tracker.region(), [this] {
+                            _cache.find_or_create_missing(_read_context->key());
+                        });
+                    }
                 } else {
                     _cache._tracker.on_mispopulate();
                 }
@@ -576,7 +785,8 @@ class range_populating_reader {
                 if (_reader.creation_phase() == _cache.phase_of(key)) {
                     return _cache._read_section(_cache._tracker.region(), [&] {
                         cache_entry& e = _cache.find_or_create_incomplete(ps, _reader.creation_phase(),
-                                                               this->can_set_continuity() ? &*_last_key : nullptr);
+                                                               this->can_set_continuity() ? &*_last_key : nullptr,
+                                                               _read_context.populate_on_probation());
                         _last_key = row_cache::previous_entry_pointer(key);
                         return make_ready_future<flat_mutation_reader_v2_opt>(e.read(_cache, _read_context, _reader.creation_phase()));
                     });
@@ -796,6 +1006,14 @@ row_cache::make_reader_opt(schema_ptr s,
                 return e.read(*this, make_context());
             } else if (i->continuous()) {
                 return {};
+            } else if (is_absent(pos)) {
+                tracing::trace(trace_state, "Range {} known to be absent", range);
+                on_partition_hit();
+                return {};
+            } else if (cache_entry* e = restore_compressed(i, hint, pos)) {
+                tracing::trace(trace_state, "Range {} restored from compressed cache", range);
+                on_partition_hit();
+                return e->read(*this, make_context());
             } else {
                 tracing::trace(trace_state, "Range {} not found in cache", range);
                 on_partition_miss();
@@ -868,6 +1086,8 @@ void row_cache::clear_on_destruction() noexcept {
             p->evict(_tracker);
         });
     });
+    _tracker.compressed_partitions().clear(_schema->id());
+    _tracker.absent_partitions().clear(_schema->id());
 }
 
 row_cache::~row_cache() {
@@ -882,6 +1102,8 @@ void row_cache::clear_now() noexcept {
         });
         _tracker.clear_continuity(*it);
     });
+    _tracker.compressed_partitions().clear(_schema->id());
+    _tracker.absent_partitions().clear(_schema->id());
 }
 
 template<typename CreateEntry, typename VisitEntry>
@@ -918,13 +1140,18 @@ cache_entry& row_cache::do_find_or_create_entry(const dht::decorated_key& key,
     });
 }
 
-cache_entry& row_cache::find_or_create_incomplete(const partition_start& ps, row_cache::phase_type phase, const previous_entry_pointer* previous) {
+cache_entry& row_cache::find_or_create_incomplete(const partition_start& ps, row_cache::phase_type phase, const previous_entry_pointer* previous,
+                                                  bool on_probation) {
     return do_find_or_create_entry(ps.key(), previous, [&] (auto i, const partitions_type::bound_hint& hint) { // create
         // Create an fully discontinuous, except for the partition tombstone, entry
         mutation_partition mp = mutation_partition::make_incomplete(*_schema, ps.partition_tombstone());
         partitions_type::iterator entry = _partitions.emplace_before(i, ps.key().token().raw(), hint,
                 _schema, ps.key(), std::move(mp));
-        _tracker.insert(*entry);
+        if (on_probation) {
+            _tracker.insert_on_probation(*entry);
+        } else {
+            _tracker.insert(*entry);
+        }
         return entry;
     }, [&] (auto i) { // visit
         _tracker.on_miss_already_populated();
@@ -948,6 +1175,37 @@ cache_entry& row_cache::find_or_create_missing(const dht::decorated_key& key) {
     });
 }
 
+bool row_cache::is_absent(const dht::ring_position& pos) {
+    absent_partition_store& store = _tracker.absent_partitions();
+    if (!pos.has_key() || !store.size() || !store.contains(*_schema, dht::decorated_key(pos.token(), *pos.key()))) {
+        return false;
+    }
+    ++_tracker._stats.absent_partition_hits;
+    return true;
+}
+
+cache_entry* row_cache::restore_compressed(partitions_type::iterator i, const partitions_type::bound_hint& hint, const dht::ring_position& pos) {
+    compressed_partition_store& store = _tracker.compressed_partitions();
+    if (!pos.has_key() || !store.size()) {
+        return nullptr;
+    }
+    std::optional<mutation> m = store.take(_schema, dht::decorated_key(pos.token(), *pos.key()));
+    if (!m) {
+        return nullptr;
+    }
+    ++_tracker._stats.compressed_partition_hits;
+    // The partition is complete and equal to what the underlying source holds,
+    // also when it's read in the previous phase during update(), because
+    // update() drops the compressed copies of the partitions it merges.
+    return with_allocator(_tracker.allocator(), [&] {
+        partitions_type::iterator entry = _partitions.emplace_before(i, m->token().raw(), hint,
+                _schema, m->decorated_key(), m->partition());
+        _tracker.insert(*entry);
+        entry->set_continuous(i->continuous());
+        return &*entry;
+    });
+}
+
 void row_cache::populate(const mutation& m, const previous_entry_pointer* previous) {
   _populate_section(_tracker.region(), [&] {
     do_find_or_create_entry(m.decorated_key(), previous, [&] (auto i, const partitions_type::bound_hint& hint) {
@@ -1060,6 +1318,8 @@ future<> row_cache::do_update(external_updater eu, replica::memtable& m, Updater
                             if (!update) {
                                 _update_section(_tracker.region(), [&] {
                                     replica::memtable_entry& mem_e = *m.partitions.begin();
+                                    _tracker.compressed_partitions().invalidate(_schema->id(), mem_e.key());
+                                    _tracker.absent_partitions().invalidate(*_schema, mem_e.key());
                                     size_entry = mem_e.size_in_allocator_without_rows(_tracker.allocator());
                                     partitions_type::bound_hint hint;
                                     auto cache_i = _partitions.lower_bound(mem_e.key(), cmp, hint);
@@ -1104,10 +1364,40 @@ future<> row_cache::do_update(external_updater eu, replica::memtable& m, Updater
   });
 }
 
+// Whether the versions of pe hold more than limit rows in total, without walking past the limit.
+static bool has_more_rows_than(partition_entry& pe, size_t limit) {
+    size_t rows = 0;
+    for (auto&& v : pe.versions()) {
+        auto& clustered_rows = v.partition().clustered_rows();
+        for (auto it = clustered_rows.begin(); it != clustered_rows.end(); ++it) {
+            if (++rows > limit) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 future<> row_cache::update(external_updater eu, replica::memtable& m) {
     return do_update(std::move(eu), m, [this] (logalloc::allocating_section& alloc,
             row_cache::partitions_type::iterator cache_i, replica::memtable_entry& mem_e, partition_presence_checker& is_present,
             real_dirty_memory_accounter& acc, const partitions_type::bound_hint& hint) mutable {
+        if (auto max_rows = _tracker.update_max_rows_per_partition(); max_rows && has_more_rows_than(mem_e.partition(), max_rows)) {
+            // Too expensive to merge, invalidate like update_invalidating() does and
+            // let the next read populate the partition from sstables.
+            if (cache_i != partitions_end() && hint.match) {
+                cache_entry& e = *cache_i;
+                e.evict(_tracker);
+                e.on_evicted(_tracker);
+            } else {
+                _tracker.clear_continuity(*cache_i);
+            }
+            ++_tracker.get_stats().partitions_invalidated_on_update;
+            // The rows are not unpinned one by one by a merge, unpin them all at once.
+            auto& allocator = _tracker.allocator();
+            acc.unpin_memory(mem_e.size_in_allocator(allocator) - mem_e.size_in_allocator_without_rows(allocator));
+            return utils::make_empty_coroutine();
+        }
         // If cache doesn't contain the entry we cannot insert it because the mutation may be incomplete.
         // FIXME: keep a bitmap indicating which sstables we do cover, so we don't have to
         //        search it.
@@ -1173,6 +1463,12 @@ void row_cache::touch(const dht::decorated_key& dk) {
  });
 }
 
+bool row_cache::contains(const dht::ring_position& pos) {
+    return _read_section(_tracker.region(), [&] {
+        return _partitions.find(pos, dht::ring_position_comparator(*_schema)) != _partitions.end();
+    });
+}
+
 void row_cache::unlink_from_lru(const dht::decorated_key& dk) {
     _read_section(_tracker.region(), [&] {
         auto i = _partitions.find(dk, dht::ring_position_comparator(*_schema));
@@ -1190,6 +1486,8 @@ void row_cache::unlink_from_lru(const dht::decorated_key& dk) {
 }
 
 void row_cache::invalidate_locked(const dht::decorated_key& dk) {
+    _tracker.compressed_partitions().invalidate(_schema->id(), dk);
+    _tracker.absent_partitions().invalidate(*_schema, dk);
     auto pos = _partitions.lower_bound(dk, dht::ring_position_comparator(*_schema));
     if (pos == partitions_end() || !pos->key().equal(*_schema, dk)) {
         _tracker.clear_continuity(*pos);
@@ -1226,6 +1524,9 @@ future<> row_cache::invalidate(external_updater eu, dht::partition_range_vector&
 
                 while (true) {
                     auto done = _update_section(_tracker.region(), [&] {
+                        // Partitions not yet invalidated could have been compressed since the last step.
+                        _tracker.compressed_partitions().invalidate(_schema->id(), range);
+                        _tracker.absent_partitions().invalidate(_schema->id(), range);
                         auto cmp = dht::ring_position_comparator(*_schema);
                         auto it = _partitions.lower_bound(*_prev_snapshot_pos, cmp);
                         auto end = _partitions.lower_bound(dht::ring_position_view::for_range_end(range), cmp);
@@ -291,13 +291,27 @@ class row_cache final {
     // Since currently every entry has to have a complete tombstone, it has to be provided here.
     // The entry which is returned will have the tombstone applied to it.
     //
+    // If the entry is created and on_probation is true, it's inserted on probation,
+    // see cache_tracker::insert_on_probation().
+    //
     // Must be run under reclaim lock
-    cache_entry& find_or_create_incomplete(const partition_start& ps, row_cache::phase_type phase, const previous_entry_pointer* previous = nullptr);
+    cache_entry& find_or_create_incomplete(const partition_start& ps, row_cache::phase_type phase, const previous_entry_pointer* previous = nullptr,
+                                           bool on_probation = false);
 
     // Creates (or touches) a cache entry for missing partition so that sstables are not
     // poked again for it.
     cache_entry& find_or_create_missing(const dht::decorated_key& key);
 
+    // Whether the partition at pos is in the cache_tracker's absent_partition_store.
+    bool is_absent(const dht::ring_position& pos);
+
+    // Moves the partition at pos back into the cache from the cache_tracker's
+    // compressed_partition_store, if it's there. i and hint are the result of
+    // looking up pos in _partitions, which must have found no entry.
+    //
+    // Must be run under reclaim lock
+    cache_entry* restore_compressed(partitions_type::iterator i, const partitions_type::bound_hint& hint, const dht::ring_position& pos);
+
     partitions_type::iterator partitions_end() {
         return std::prev(_partitions.end());
     }
@@ -429,6 +443,10 @@ class row_cache final {
     // Moves given partition to the front of LRU if present in cache.
     void touch(const dht::decorated_key&);
 
+    // Returns true if the cache has an entry for the partition at the given position.
+    // The entry may not hold all of the partition's rows.
+    bool contains(const dht::ring_position&);
+
     // Detaches current contents of given partition from LRU, so
     // that they are not evicted by memory reclaimer.
     void unlink_from_lru(const dht::decorated_key&);
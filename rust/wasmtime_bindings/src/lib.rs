@@ -39,6 +39,8 @@ mod ffi {
 
         type Module;
         fn create_module(engine: &mut Engine, script: &str) -> Result<Box<Module>>;
+        fn create_module_from_precompiled(engine: &mut Engine, bytes: &[u8]) -> Result<Box<Module>>;
+        fn serialized(self: &Module) -> &[u8];
         fn raw_size(self: &Module) -> usize;
         fn is_compiled(self: &Module) -> bool;
         fn compile(self: &mut Module, engine: &mut Engine) -> Result<()>;
@@ -152,7 +154,24 @@ fn create_module(engine: &mut Engine, script: &str) -> Result<Box<Module>> {
     Ok(module)
 }
 
+// Creates a module from the output of an earlier `create_module`, as returned by `serialized`.
+// The bytes are only checked to look like a precompiled module here; `compile` fails if they
+// were produced by an incompatible engine.
+fn create_module_from_precompiled(engine: &mut Engine, bytes: &[u8]) -> Result<Box<Module>> {
+    match engine.wasmtime_engine.detect_precompiled(bytes) {
+        Some(wasmtime::Precompiled::Module) => Ok(Box::new(Module {
+            serialized_module: bytes.to_vec(),
+            wasmtime_module: None,
+            references: 0,
+        })),
+        _ => Err(anyhow!("Not a precompiled module")),
+    }
+}
+
 impl Module {
+    fn serialized(&self) -> &[u8] {
+        &self.serialized_module
+    }
     fn raw_size(&self) -> usize {
         self.serialized_module.len()
     }
@@ -163,7 +182,8 @@ impl Module {
         if self.is_compiled() {
             return Ok(());
         }
-        // `deserialize` is safe because we put the result of `precompile_module` as input.
+        // `deserialize` is safe because we put the result of `precompile_module` as input,
+        // possibly read back from the precompiled modules directory, which only Scylla writes.
         let module = unsafe {
             wasmtime::Module::deserialize(&engine.wasmtime_engine, &self.serialized_module)
                 .map_err(|e| anyhow!("Deserialization failed: {:?}", e))?
@@ -32,6 +32,7 @@
 #include "cdc/cdc_extension.hh"
 #include "tombstone_gc_extension.hh"
 #include "db/paxos_grace_seconds_extension.hh"
+#include "db/commitlog_bypass_extension.hh"
 #include "utils/rjson.hh"
 #include "tombstone_gc_options.hh"
 #include "db/per_partition_rate_limit_extension.hh"
@@ -532,6 +533,7 @@ bool operator==(const schema& x, const schema& y)
         && x._raw._type == y._raw._type
         && x._raw._gc_grace_seconds == y._raw._gc_grace_seconds
         && x.paxos_grace_seconds() == y.paxos_grace_seconds()
+        && x.commitlog_bypass() == y.commitlog_bypass()
         && x._raw._dc_local_read_repair_chance == y._raw._dc_local_read_repair_chance
         && x._raw._read_repair_chance == y._raw._read_repair_chance
         && x._raw._min_compaction_threshold == y._raw._min_compaction_threshold
@@ -939,6 +941,9 @@ std::ostream& schema::describe(replica::database& db, std::ostream& os, bool wit
     if (cdc_options().enabled()) {
         os << "\n    AND cdc = " << cdc_options().to_sstring();
     }
+    if (commitlog_bypass()) {
+        os << "\n    AND commitlog_bypass = true";
+    }
     if (is_view() && !is_index(db, view_info()->base_id(), *this)) {
         auto is_sync_update = db::find_tag(*this, db::SYNCHRONOUS_VIEW_UPDATES_TAG_KEY);
         if (is_sync_update.has_value()) {
@@ -1366,6 +1371,12 @@ schema_ptr schema_builder::build() {
             dynamic_pointer_cast<db::paxos_grace_seconds_extension>(it->second)->get_paxos_grace_seconds();
     }
 
+    // cache `commitlog_bypass` for the write path
+    if (auto it = new_raw._extensions.find(db::commitlog_bypass_extension::NAME); it != new_raw._extensions.end()) {
+        new_raw._commitlog_bypass =
+            dynamic_pointer_cast<db::commitlog_bypass_extension>(it->second)->get_commitlog_bypass();
+    }
+
     // cache the `per_partition_rate_limit` parameters for fast access through the schema object.
     if (auto it = new_raw._extensions.find(db::per_partition_rate_limit_extension::NAME); it != new_raw._extensions.end()) {
         new_raw._per_partition_rate_limit_options =
@@ -1429,6 +1440,11 @@ schema_builder& schema_builder::set_paxos_grace_seconds(int32_t seconds) {
     return *this;
 }
 
+schema_builder& schema_builder::set_commitlog_bypass(bool bypass) {
+    add_extension(db::commitlog_bypass_extension::NAME, ::make_shared<db::commitlog_bypass_extension>(bypass));
+    return *this;
+}
+
 gc_clock::duration schema::paxos_grace_seconds() const {
     return std::chrono::duration_cast<gc_clock::duration>(
         std::chrono::seconds(
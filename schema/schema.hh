@@ -603,6 +603,7 @@ class schema final : public enable_lw_shared_from_this<schema>, public data_dict
         cf_type _type = cf_type::standard;
         int32_t _gc_grace_seconds = DEFAULT_GC_GRACE_SECONDS;
         std::optional<int32_t> _paxos_grace_seconds;
+        bool _commitlog_bypass = false;
         double _dc_local_read_repair_chance = 0.0;
         double _read_repair_chance = 0.0;
         double _crc_check_chance = 1;
@@ -749,6 +750,11 @@ class schema final : public enable_lw_shared_from_this<schema>, public data_dict
 
     gc_clock::duration paxos_grace_seconds() const;
 
+    // Writes to the table don't go to the commitlog, see db::commitlog_bypass_extension.
+    bool commitlog_bypass() const {
+        return _raw._commitlog_bypass;
+    }
+
     double dc_local_read_repair_chance() const {
         return _raw._dc_local_read_repair_chance;
     }
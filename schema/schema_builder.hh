@@ -97,6 +97,8 @@ struct schema_builder {
 
     schema_builder& set_paxos_grace_seconds(int32_t seconds);
 
+    schema_builder& set_commitlog_bypass(bool bypass);
+
     schema_builder& set_dc_local_read_repair_chance(double chance) {
         _raw._dc_local_read_repair_chance = chance;
         return *this;
@@ -254,6 +254,16 @@ template<> struct serializer<uint32_t> : public integral_serializer<uint32_t> {}
 template<> struct serializer<int64_t> : public integral_serializer<int64_t> {};
 template<> struct serializer<uint64_t> : public integral_serializer<uint64_t> {};
 
+// The size of the serialized form of T, if it is the same for all values of T, or 0 otherwise.
+// Besides integral types, only `final` IDL classes (which have no size frame) made entirely
+// of fixed-size members qualify; the IDL compiler specializes this for them.
+template<typename T>
+struct fixed_serialized_size : std::integral_constant<size_t, 0> {};
+
+template<typename T>
+requires std::is_integral_v<T>
+struct fixed_serialized_size<T> : std::integral_constant<size_t, sizeof(T)> {};
+
 template<typename Output>
 void safe_serialize_as_uint32(Output& output, uint64_t data);
 
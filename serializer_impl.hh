@@ -220,7 +220,16 @@ struct vector_serializer {
         auto sz = deserialize(in, boost::type<uint32_t>());
         Vector v;
         v.reserve(sz);
-        deserialize_array<value_type>(in, v, sz);
+        if constexpr (!can_serialize_fast<value_type>() && fixed_serialized_size<value_type>::value) {
+            // The elements occupy a known number of bytes, so deal with fragment
+            // boundaries once for all of them rather than on every member read.
+            auto elements = in.read_substream(size_t(sz) * fixed_serialized_size<value_type>::value);
+            seastar::with_serialized_stream(elements, [&] (auto& elements) {
+                deserialize_array<value_type>(elements, v, sz);
+            });
+        } else {
+            deserialize_array<value_type>(in, v, sz);
+        }
         return v;
     }
     template<typename Output>
@@ -231,7 +240,11 @@ struct vector_serializer {
     template<typename Input>
     static void skip(Input& in) {
         auto sz = deserialize(in, boost::type<uint32_t>());
-        skip_array<value_type>(in, sz);
+        if constexpr (fixed_serialized_size<value_type>::value) {
+            in.skip(size_t(sz) * fixed_serialized_size<value_type>::value);
+        } else {
+            skip_array<value_type>(in, sz);
+        }
     }
 };
 
@@ -39,6 +39,7 @@
 #include "service/storage_proxy.hh"
 
 #include "cql3/functions/aggregate_function.hh"
+#include "cql3/functions/aggregate_fcts.hh"
 #include "cql3/column_identifier.hh"
 #include "cql3/cql_config.hh"
 #include "cql3/query_options.hh"
@@ -59,8 +60,14 @@ static std::vector<::shared_ptr<db::functions::aggregate_function>> get_function
 
 class forward_aggregates {
 private:
+    schema_ptr _schema;
     std::vector<::shared_ptr<db::functions::aggregate_function>> _funcs;
     std::vector<db::functions::stateless_aggregate_function> _aggrs;
+    bool _grouped;
+
+    void merge_group_states(std::vector<bytes_opt>& states, std::vector<bytes_opt>&& other);
+    void finalize_states(std::vector<bytes_opt>& states);
+    void finalize_groups(query::forward_result& result);
 public:
     forward_aggregates(const query::forward_request& request);
     void merge(query::forward_result& result, query::forward_result&& other);
@@ -82,7 +89,10 @@ class forward_aggregates {
     }
 };
 
-forward_aggregates::forward_aggregates(const query::forward_request& request) {
+forward_aggregates::forward_aggregates(const query::forward_request& request)
+    : _schema(local_schema_registry().get(request.cmd.schema_version))
+    , _grouped(request.group_by_column_names.has_value())
+{
     _funcs = get_functions(request);
     std::vector<db::functions::stateless_aggregate_function> aggrs;
 
@@ -93,6 +103,18 @@ forward_aggregates::forward_aggregates(const query::forward_request& request) {
 }
 
 void forward_aggregates::merge(query::forward_result &result, query::forward_result&& other) {
+    if (_grouped) {
+        // Groups never span partitions, so partial results coming from
+        // different shards and nodes are disjoint. They are ordered and
+        // merged in finalize().
+        if (result.groups.empty()) {
+            result.groups = std::move(other.groups);
+        } else {
+            std::move(other.groups.begin(), other.groups.end(), std::back_inserter(result.groups));
+        }
+        return;
+    }
+
     if (result.query_results.empty()) {
         result.query_results = std::move(other.query_results);
         return;
@@ -111,12 +133,21 @@ void forward_aggregates::merge(query::forward_result &result, query::forward_res
         );
     }
 
+    merge_group_states(result.query_results, std::move(other.query_results));
+}
+
+void forward_aggregates::merge_group_states(std::vector<bytes_opt>& states, std::vector<bytes_opt>&& other) {
     for (size_t i = 0; i < _aggrs.size(); i++) {
-        result.query_results[i] = _aggrs[i].state_reduction_function->execute(std::vector({std::move(result.query_results[i]), std::move(other.query_results[i])}));
+        states[i] = _aggrs[i].state_reduction_function->execute(std::vector({std::move(states[i]), std::move(other[i])}));
     }
 }
 
 void forward_aggregates::finalize(query::forward_result &result) {
+    if (_grouped) {
+        finalize_groups(result);
+        return;
+    }
+
     if (result.query_results.empty()) {
         // An empty result means that we didn't send the aggregation request
         // to any node. I.e., it was a query that matched no partition, such
@@ -139,13 +170,73 @@ void forward_aggregates::finalize(query::forward_result &result) {
         );
     }
 
+    finalize_states(result.query_results);
+}
+
+void forward_aggregates::finalize_states(std::vector<bytes_opt>& states) {
     for (size_t i = 0; i < _aggrs.size(); i++) {
-        result.query_results[i] = _aggrs[i].state_to_result_function
-            ? _aggrs[i].state_to_result_function->execute(std::vector({std::move(result.query_results[i])}))
-            : result.query_results[i];
+        states[i] = _aggrs[i].state_to_result_function
+            ? _aggrs[i].state_to_result_function->execute(std::vector({std::move(states[i])}))
+            : states[i];
     }
 }
 
+// Puts the groups in the order a GROUP BY query executed on a single
+// coordinator returns them: by partition in ring order, then by clustering
+// prefix. Group keys consist of the whole partition key followed by
+// a (possibly empty) clustering prefix.
+void forward_aggregates::finalize_groups(query::forward_result& result) {
+    struct sortable_group {
+        dht::decorated_key pk;
+        clustering_key_prefix ck;
+        query::forward_result::group* group;
+    };
+    const auto pk_size = _schema->partition_key_size();
+    auto to_bytes = [] (auto&& values) {
+        return boost::copy_range<std::vector<bytes>>(values | boost::adaptors::transformed([] (const bytes_opt& v) {
+            if (!v) {
+                throw std::runtime_error("forward_result group key contains a null value");
+            }
+            return *v;
+        }));
+    };
+
+    std::vector<sortable_group> sorted;
+    sorted.reserve(result.groups.size());
+    for (auto& g : result.groups) {
+        if (g.key.size() < pk_size || g.query_results.size() != _aggrs.size()) {
+            on_internal_error(flogger, format("forward_aggregates::finalize(): malformed group with {} key components and {} results, "
+                    "expected at least {} key components and {} results", g.key.size(), g.query_results.size(), pk_size, _aggrs.size()));
+        }
+        auto pk = partition_key::from_exploded(*_schema, to_bytes(boost::make_iterator_range(g.key.begin(), g.key.begin() + pk_size)));
+        auto ck = clustering_key_prefix::from_exploded(*_schema, to_bytes(boost::make_iterator_range(g.key.begin() + pk_size, g.key.end())));
+        sorted.push_back({dht::decorate_key(*_schema, std::move(pk)), std::move(ck), &g});
+    }
+
+    auto ck_cmp = clustering_key_prefix::prefix_equal_tri_compare(*_schema);
+    auto tri_cmp = [&] (const sortable_group& a, const sortable_group& b) {
+        auto r = a.pk.tri_compare(*_schema, b.pk);
+        return r != 0 ? r : ck_cmp(a.ck, b.ck);
+    };
+    std::sort(sorted.begin(), sorted.end(), [&] (const sortable_group& a, const sortable_group& b) {
+        return tri_cmp(a, b) < 0;
+    });
+
+    std::vector<query::forward_result::group> groups;
+    groups.reserve(sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (i > 0 && tri_cmp(sorted[i - 1], sorted[i]) == 0) {
+            merge_group_states(groups.back().query_results, std::move(sorted[i].group->query_results));
+            continue;
+        }
+        groups.push_back(std::move(*sorted[i].group));
+    }
+    for (auto& g : groups) {
+        finalize_states(g.query_results);
+    }
+    result.groups = std::move(groups);
+}
+
 static std::vector<::shared_ptr<db::functions::aggregate_function>> get_functions(const query::forward_request& request) {
     
     schema_ptr schema = local_schema_registry().get(request.cmd.schema_version);
@@ -174,6 +265,13 @@ static std::vector<::shared_ptr<db::functions::aggregate_function>> get_function
             if (!aggr) {
                 throw std::runtime_error("Count function not found.");
             }
+        } else if (request.aggregation_infos.value()[i].name == cql3::functions::aggregate_fcts::first_function_name()) {
+            // Used for GROUP BY columns, see selection::get_reductions().
+            auto& info = request.aggregation_infos.value()[i];
+            if (info.column_names.size() != 1) {
+                throw std::runtime_error(format("Aggregate function {} expects a single column", info.name));
+            }
+            aggr = cql3::functions::aggregate_fcts::make_first_function(name_as_type(info.column_names[0]));
         } else {
             auto& info = request.aggregation_infos.value()[i];
             auto types = boost::copy_range<std::vector<data_type>>(info.column_names | boost::adaptors::transformed(name_as_type));
@@ -313,11 +411,13 @@ future<> forward_service::stop() {
 
 // Due to `cql3::selection::selection` not being serializable, it cannot be
 // stored in `forward_request`. It has to mocked on the receiving node,
-// based on requested reduction types.
+// based on requested reduction types. GROUP BY columns are appended after
+// the reductions, and their indices are stored in `group_by_cell_indices`.
 static shared_ptr<cql3::selection::selection> mock_selection(
     query::forward_request& request,
     schema_ptr schema,
-    replica::database& db
+    replica::database& db,
+    std::vector<size_t>& group_by_cell_indices
 ) {
     std::vector<cql3::selection::prepared_selector> prepared_selectors;
 
@@ -361,7 +461,20 @@ static shared_ptr<cql3::selection::selection> mock_selection(
         prepared_selectors.emplace_back(mock_singular_selection(functions[i], request.reduction_types[i], info));
     }
 
-    return cql3::selection::selection::from_selectors(db.as_data_dictionary(), schema, schema->ks_name(), std::move(prepared_selectors));
+    auto selection = cql3::selection::selection::from_selectors(db.as_data_dictionary(), schema, schema->ks_name(), std::move(prepared_selectors));
+    if (request.group_by_column_names) {
+        for (auto& name : *request.group_by_column_names) {
+            auto def = schema->get_column_definition(to_bytes(name));
+            if (!def) {
+                throw std::runtime_error(format("Unknown GROUP BY column {}", name));
+            }
+            // Always added, even if a reduction already reads the column,
+            // so that the group key ends up at the end of the output row.
+            selection->add_column_for_post_processing(*def);
+            group_by_cell_indices.push_back(selection->index_of(*def));
+        }
+    }
+    return selection;
 }
 
 future<query::forward_result> forward_service::dispatch_to_shards(
@@ -429,7 +542,8 @@ future<query::forward_result> forward_service::execute_on_this_shard(
     auto timeout = compute_timeout(req);
     auto now = gc_clock::now();
 
-    auto selection = mock_selection(req, schema, _db.local());
+    std::vector<size_t> group_by_cell_indices;
+    auto selection = mock_selection(req, schema, _db.local(), group_by_cell_indices);
     auto query_state = make_lw_shared<service::query_state>(
         client_state::for_internal_calls(),
         tr_state,
@@ -447,7 +561,7 @@ future<query::forward_result> forward_service::execute_on_this_shard(
     auto rs_builder = cql3::selection::result_set_builder(
         *selection,
         now,
-        std::vector<size_t>() // Represents empty GROUP BY indices.
+        std::move(group_by_cell_indices)
     );
 
     // We serve up to 256 ranges at a time to avoid allocating a huge vector for ranges
@@ -501,6 +615,27 @@ future<query::forward_result> forward_service::execute_on_this_shard(
     co_return co_await rs_builder.with_thread_if_needed([&req, &rs_builder, reductions = req.reduction_types, tr_state = std::move(tr_state)] {
         auto rs = rs_builder.build();
         auto& rows = rs->rows();
+        if (req.group_by_column_names) {
+            const auto key_size = req.group_by_column_names->size();
+            query::forward_result res;
+            res.groups.reserve(rows.size());
+            for (auto& row : rows) {
+                if (row.size() != reductions.size() + key_size) {
+                    flogger.error("aggregation result column count does not match requested column count");
+                    throw std::runtime_error("aggregation result column count does not match requested column count");
+                }
+                auto to_bytes_opts = [] (auto&& values) {
+                    return boost::copy_range<std::vector<bytes_opt>>(values | boost::adaptors::transformed([] (const managed_bytes_opt& x) { return to_bytes_opt(x); }));
+                };
+                res.groups.push_back(query::forward_result::group{
+                    .key = to_bytes_opts(boost::make_iterator_range(row.begin() + reductions.size(), row.end())),
+                    .query_results = to_bytes_opts(boost::make_iterator_range(row.begin(), row.begin() + reductions.size())),
+                });
+            }
+            tracing::trace(tr_state, "On shard execution produced {} groups", res.groups.size());
+            flogger.debug("on shard execution produced {} groups", res.groups.size());
+            return res;
+        }
         if (rows.size() != 1) {
             flogger.error("aggregation result row count != 1");
             throw std::runtime_error("aggregation result row count != 1");
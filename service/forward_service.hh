@@ -45,6 +45,11 @@ class storage_proxy;
 //   5. `dispatch` merges results from all coordinators and returns merged
 //      result.
 //
+// A request with `group_by_column_names` set is aggregated per group. Since
+// GROUP BY always covers the whole partition key, a group is never split
+// between shards; each shard returns the partial states of its groups, and
+// `dispatch` sorts the groups into primary key order and finalizes them.
+//
 // Splitting query into sub-queries in is implemented as:
 //   a. Partition ranges of the original query are split into a sequence of
 //      vnodes.
@@ -150,6 +150,15 @@ void migration_manager::init_messaging_service()
         auto features = self._feat.cluster_schema_features();
         auto& proxy = self._storage_proxy.container();
         auto& db = proxy.local().get_db();
+        if (options && options->group0_snapshot_transfer && options->group0_last_state_id
+                && *options->group0_last_state_id != utils::UUID{}
+                && *options->group0_last_state_id == co_await self._sys_ks.local().get_last_group0_state_id()) {
+            // The puller already applied all of our group 0 state, so only send
+            // the history, which tells it that there is nothing else to apply.
+            mlogger.debug("migration request handler: group 0 state of the puller is up to date ({})", *options->group0_last_state_id);
+            co_return rpc::tuple(std::vector<frozen_mutation>{},
+                    std::vector<canonical_mutation>{co_await db::system_keyspace::get_group0_history(db)});
+        }
         auto cm = co_await db::schema_tables::convert_schema_to_mutations(proxy, features);
         if (options->group0_snapshot_transfer) {
             // if `group0_snapshot_transfer` is `true`, the sender must also understand canonical mutations
@@ -12,6 +12,7 @@
 #include "service/paxos/proposal.hh"
 #include "service/paxos/paxos_state.hh"
 #include "db/system_keyspace.hh"
+#include "db/config.hh"
 #include "schema/schema_registry.hh"
 #include "replica/database.hh"
 
@@ -25,6 +26,7 @@ namespace service::paxos {
 logging::logger paxos_state::logger("paxos");
 thread_local paxos_state::key_lock_map paxos_state::_paxos_table_lock;
 thread_local paxos_state::key_lock_map paxos_state::_coordinator_lock;
+thread_local paxos_state::state_cache paxos_state::_state_cache;
 
 paxos_state::key_lock_map::semaphore& paxos_state::key_lock_map::get_semaphore_for_key(const dht::token& key) {
     return _locks.try_emplace(key, 1).first->second;
@@ -37,6 +39,166 @@ void paxos_state::key_lock_map::release_semaphore_for_key(const dht::token& key)
     }
 }
 
+paxos_state::state_cache::entry* paxos_state::state_cache::find(const key_type& k) {
+    auto it = _index.find(k);
+    if (it == _index.end()) {
+        return nullptr;
+    }
+    _lru.splice(_lru.begin(), _lru, it->second);
+    return &*it->second;
+}
+
+void paxos_state::state_cache::erase(lru_list::iterator it) {
+    _memory_usage -= it->memory_usage;
+    _index.erase(it->key);
+    _lru.erase(it);
+}
+
+void paxos_state::state_cache::erase(const key_type& k) {
+    auto it = _index.find(k);
+    if (it != _index.end()) {
+        erase(it->second);
+    }
+}
+
+void paxos_state::state_cache::update_memory_usage(entry& e) {
+    // The list node, the index node with its copy of the key, and the state.
+    size_t usage = sizeof(e) + 2 * sizeof(void*)
+            + sizeof(key_type) + sizeof(lru_list::iterator) + 2 * sizeof(void*)
+            + 2 * e.key.key.external_memory_usage()
+            + sizeof(paxos_state);
+    for (auto* p : {&e.state->_accepted_proposal, &e.state->_most_recent_commit}) {
+        if (*p) {
+            usage += (*p)->update.representation().size();
+        }
+    }
+    _memory_usage = _memory_usage - e.memory_usage + usage;
+    e.memory_usage = usage;
+}
+
+void paxos_state::state_cache::check_truncation(db_clock::time_point truncated_at) {
+    if (truncated_at != _truncated_at) {
+        shrink(0);
+        _truncated_at = truncated_at;
+    }
+}
+
+void paxos_state::state_cache::shrink(size_t capacity) {
+    while (_lru.size() > capacity) {
+        erase(std::prev(_lru.end()));
+    }
+}
+
+std::optional<paxos_state> paxos_state::state_cache::get(const schema& s, const dht::token& token, const partition_key& key) {
+    auto e = find(key_type{s.id(), token, key});
+    if (!e) {
+        return std::nullopt;
+    }
+    return *e->state;
+}
+
+void paxos_state::state_cache::put(const schema& s, const dht::token& token, const partition_key& key, const paxos_state& state, size_t capacity) {
+    key_type k{s.id(), token, key};
+    erase(k);
+    // The proposal columns are written with the ballot of the proposal and set to null with the
+    // ballot of a decision. Without a proposal the latest decision is the best estimate. It can only
+    // be too high, which matters only for proposals older than that decision, which are ignored anyway.
+    auto proposal_timestamp = state._accepted_proposal ? utils::UUID_gen::micros_timestamp(state._accepted_proposal->ballot)
+            : state._most_recent_commit ? utils::UUID_gen::micros_timestamp(state._most_recent_commit->ballot)
+            : api::missing_timestamp;
+    _lru.push_front(entry{k, std::make_unique<paxos_state>(state), proposal_timestamp});
+    _index.emplace(std::move(k), _lru.begin());
+    update_memory_usage(_lru.front());
+    shrink(capacity);
+}
+
+void paxos_state::state_cache::on_promise(const schema& s, const dht::token& token, const partition_key& key, utils::UUID ballot) {
+    // Promises are only saved when newer than the current one.
+    if (auto e = find(key_type{s.id(), token, key})) {
+        e->state->_promised_ballot = ballot;
+    }
+}
+
+void paxos_state::state_cache::on_accept(const schema& s, const dht::token& token, const proposal& p) {
+    key_type k{s.id(), token, p.update.key()};
+    auto e = find(k);
+    if (!e) {
+        return;
+    }
+    // Proposals are only accepted when not older than the promise.
+    e->state->_promised_ballot = p.ballot;
+    auto ts = utils::UUID_gen::micros_timestamp(p.ballot);
+    if (ts > e->proposal_timestamp) {
+        e->state->_accepted_proposal = p;
+        e->proposal_timestamp = ts;
+        update_memory_usage(*e);
+    } else if (ts == e->proposal_timestamp && !(e->state->_accepted_proposal && e->state->_accepted_proposal->ballot == p.ballot)) {
+        // The table resolves the tie by comparing values, let it do so.
+        erase(k);
+    }
+}
+
+void paxos_state::state_cache::on_decision(const schema& s, const dht::token& token, const proposal& decision) {
+    key_type k{s.id(), token, decision.update.key()};
+    auto e = find(k);
+    if (!e) {
+        return;
+    }
+    auto ts = utils::UUID_gen::micros_timestamp(decision.ballot);
+    if (ts >= e->proposal_timestamp) {
+        e->state->_accepted_proposal.reset();
+        e->proposal_timestamp = ts;
+    }
+    auto& commit = e->state->_most_recent_commit;
+    auto commit_ts = commit ? utils::UUID_gen::micros_timestamp(commit->ballot) : api::missing_timestamp;
+    if (ts > commit_ts) {
+        commit = decision;
+    } else if (ts == commit_ts && commit->ballot != decision.ballot) {
+        erase(k);
+        return;
+    }
+    update_memory_usage(*e);
+}
+
+void paxos_state::state_cache::on_prune(const schema& s, const dht::token& token, const partition_key& key, utils::UUID ballot) {
+    auto e = find(key_type{s.id(), token, key});
+    if (!e) {
+        return;
+    }
+    // Only the value of the decision is deleted, see system_keyspace::load_paxos_state()
+    // for how that is read back.
+    auto& commit = e->state->_most_recent_commit;
+    if (commit && utils::UUID_gen::micros_timestamp(commit->ballot) <= utils::UUID_gen::micros_timestamp(ballot)) {
+        commit->update = freeze(mutation(s.shared_from_this(), key));
+        update_memory_usage(*e);
+    }
+}
+
+void paxos_state::state_cache::on_write_failure(const schema& s, const dht::token& token, const partition_key& key) {
+    erase(key_type{s.id(), token, key});
+}
+
+std::optional<paxos_state> paxos_state::get_cached_state(const schema& s, const partition_key& key) {
+    return _state_cache.get(s, dht::get_token(s, key), key);
+}
+
+future<paxos_state> paxos_state::load_state(storage_proxy& sp, db::system_keyspace& sys_ks, schema_ptr schema, dht::token token,
+        partition_key key, gc_clock::time_point now, clock_type::time_point timeout) {
+    auto& db = sp.get_db().local();
+    size_t capacity = db.get_config().paxos_state_cache_size();
+    if (capacity) {
+        _state_cache.check_truncation(db.find_column_family(db::system_keyspace::NAME, db::system_keyspace::PAXOS).get_truncation_time());
+        if (auto state = _state_cache.get(*schema, token, key)) {
+            co_return std::move(*state);
+        }
+    }
+    auto state = co_await sys_ks.load_paxos_state(key, schema, now, timeout);
+    if (capacity) {
+        _state_cache.put(*schema, token, key, state, capacity);
+    }
+    co_return state;
+}
+
 future<paxos_state::guard> paxos_state::get_cas_lock(const dht::token& key, clock_type::time_point timeout) {
     guard m(_coordinator_lock, key, timeout);
     co_await m.lock();
@@ -58,7 +220,7 @@ future<prepare_response> paxos_state::prepare(storage_proxy& sp, db::system_keys
             // tombstone that hides any re-submit). See CASSANDRA-12043 for details.
             auto now_in_sec = utils::UUID_gen::unix_timestamp_in_sec(ballot);
 
-            auto f = sys_ks.load_paxos_state(key, schema, gc_clock::time_point(now_in_sec), timeout);
+            auto f = load_state(sp, sys_ks, schema, token, key, gc_clock::time_point(now_in_sec), timeout);
             return f.then([&sp, &sys_ks, &cmd, token = std::move(token), &key, ballot, tr_state, schema, only_digest, da, timeout] (paxos_state state) {
                 // If received ballot is newer that the one we already accepted it has to be accepted as well,
                 // but we will return the previously accepted proposal so that the new coordinator will use it instead of
@@ -80,12 +242,19 @@ future<prepare_response> paxos_state::prepare(storage_proxy& sp, db::system_keys
                                     prv, tr_state, timeout);
                         });
                     });
-                    return when_all(std::move(f1), std::move(f2)).then([state = std::move(state), only_digest, schema, &sys_ks] (auto t) mutable {
+                    return when_all(std::move(f1), std::move(f2)).then([state = std::move(state), only_digest, schema, &sys_ks, token, &key, ballot] (auto t) mutable {
+                        auto&& f1 = std::get<0>(t);
+                        auto&& f2 = std::get<1>(t);
+                        if (f1.failed()) {
+                            _state_cache.on_write_failure(*schema, token, key);
+                        } else {
+                            _state_cache.on_promise(*schema, token, key, ballot);
+                        }
                         if (utils::get_local_injector().enter("paxos_error_after_save_promise")) {
+                            f1.ignore_ready_future();
+                            f2.ignore_ready_future();
                             return make_exception_future<prepare_response>(utils::injected_error("injected_error_after_save_promise"));
                         }
-                        auto&& f1 = std::get<0>(t);
-                        auto&& f2 = std::get<1>(t);
                         if (f1.failed()) {
                             f2.ignore_ready_future();
                             // Failed to save promise. Nothing we can do but throw.
@@ -147,10 +316,10 @@ future<bool> paxos_state::accept(storage_proxy& sp, db::system_keyspace& sys_ks,
             [&sp, &sys_ks, token = std::move(token), &proposal, schema, tr_state, timeout] {
         utils::latency_counter lc;
         lc.start();
-        return with_locked_key(token, timeout, [&sys_ks, &proposal, schema, tr_state, timeout] () mutable {
+        return with_locked_key(token, timeout, [&sp, &sys_ks, &proposal, token, schema, tr_state, timeout] () mutable {
             auto now_in_sec = utils::UUID_gen::unix_timestamp_in_sec(proposal.ballot);
-            auto f = sys_ks.load_paxos_state(proposal.update.key(), schema, gc_clock::time_point(now_in_sec), timeout);
-            return f.then([&sys_ks, &proposal, tr_state, schema, timeout] (paxos_state state) {
+            auto f = load_state(sp, sys_ks, schema, token, proposal.update.key(), gc_clock::time_point(now_in_sec), timeout);
+            return f.then([&sys_ks, &proposal, token, tr_state, schema, timeout] (paxos_state state) {
                 // Accept the proposal if we promised to accept it or the proposal is newer than the one we promised.
                 // Otherwise the proposal was cutoff by another Paxos proposer and has to be rejected.
                 if (proposal.ballot == state._promised_ballot || proposal.ballot.timestamp() > state._promised_ballot.timestamp()) {
@@ -161,7 +330,12 @@ future<bool> paxos_state::accept(storage_proxy& sp, db::system_keyspace& sys_ks,
                         return make_exception_future<bool>(utils::injected_error("injected_error_before_save_proposal"));
                     }
 
-                    return sys_ks.save_paxos_proposal(*schema, proposal, timeout).then([] {
+                    return sys_ks.save_paxos_proposal(*schema, proposal, timeout).then_wrapped([&proposal, token, schema] (future<> f) {
+                        if (f.failed()) {
+                            _state_cache.on_write_failure(*schema, token, proposal.update.key());
+                            return make_exception_future<bool>(f.get_exception());
+                        }
+                        _state_cache.on_accept(*schema, token, proposal);
                         if (utils::get_local_injector().enter("paxos_error_after_save_proposal")) {
                             return make_exception_future<bool>(utils::injected_error("injected_error_after_save_proposal"));
                         }
@@ -227,10 +401,20 @@ future<> paxos_state::learn(storage_proxy& sp, db::system_keyspace& sys_ks, sche
             tracing::trace(tr_state, "Not committing decision {} as ballot timestamp predates last truncation time", decision);
         }
         return f.then([&sys_ks, &decision, schema, timeout] {
-            // We don't need to lock the partition key if there is no gap between loading paxos
-            // state and saving it, and here we're just blindly updating.
-            return utils::get_local_injector().inject("paxos_timeout_after_save_decision", timeout, [&sys_ks, &decision, schema, timeout] {
-                return sys_ks.save_paxos_decision(*schema, decision, timeout);
+            // There is no gap between loading paxos state and saving it here, we're just
+            // blindly updating. The key is locked only to keep _state_cache in sync with the table.
+            auto token = dht::get_token(*schema, decision.update.key());
+            return with_locked_key(token, timeout, [&sys_ks, &decision, token, schema, timeout] {
+                return utils::get_local_injector().inject("paxos_timeout_after_save_decision", timeout, [&sys_ks, &decision, schema, timeout] {
+                    return sys_ks.save_paxos_decision(*schema, decision, timeout);
+                }).then_wrapped([&decision, token, schema] (future<> f) {
+                    if (f.failed()) {
+                        _state_cache.on_write_failure(*schema, token, decision.update.key());
+                    } else {
+                        _state_cache.on_decision(*schema, token, decision);
+                    }
+                    return f;
+                });
             });
         });
     }).finally([&sp, schema, lc] () mutable {
@@ -243,7 +427,17 @@ future<> paxos_state::prune(db::system_keyspace& sys_ks, schema_ptr schema, cons
         tracing::trace_state_ptr tr_state) {
     logger.debug("Delete paxos state for ballot {}", ballot);
     tracing::trace(tr_state, "Delete paxos state for ballot {}", ballot);
-    return sys_ks.delete_paxos_decision(*schema, key, ballot, timeout);
+    auto token = dht::get_token(*schema, key);
+    return with_locked_key(token, timeout, [&sys_ks, schema, key, token, ballot, timeout] {
+        return sys_ks.delete_paxos_decision(*schema, key, ballot, timeout).then_wrapped([schema, key, token, ballot] (future<> f) {
+            if (f.failed()) {
+                _state_cache.on_write_failure(*schema, token, key);
+            } else {
+                _state_cache.on_prune(*schema, token, key, ballot);
+            }
+            return f;
+        });
+    });
 }
 
 } // end of namespace "service::paxos"
@@ -11,7 +11,9 @@
 #include "log.hh"
 #include "utils/digest_algorithm.hh"
 #include "db/timeout_clock.hh"
+#include "db_clock.hh"
 #include <unordered_map>
+#include <list>
 #include "utils/UUID_gen.hh"
 #include "service/paxos/prepare_response.hh"
 
@@ -72,6 +74,77 @@ class paxos_state {
         return _paxos_table_lock.with_locked_key(key, timeout, std::move(func));
     }
 
+    // Keeps the paxos state of recently used partitions in memory, so that
+    // the state of an uncontended partition is not read from system.paxos by
+    // every prepare and accept (see paxos_state_cache_size).
+    //
+    // The cache is write-through: it is updated after each successful write to
+    // system.paxos, by applying the write the same way the table does, i.e.
+    // column by column, by timestamp. All writes to system.paxos are done under
+    // _paxos_table_lock, so a cached state is exactly what a read from the table
+    // would return, except for TTL expiry of the table. If a write fails, its
+    // outcome is unknown and the entry is dropped. Truncating system.paxos drops
+    // all the entries.
+    class state_cache {
+        struct key_type {
+            table_id table;
+            dht::token token;
+            partition_key key;
+
+            bool operator==(const key_type& o) const {
+                return table == o.table && token == o.token && key.representation() == o.key.representation();
+            }
+        };
+        struct key_hash {
+            size_t operator()(const key_type& k) const {
+                return std::hash<dht::token>()(k.token) ^ std::hash<table_id>()(k.table);
+            }
+        };
+        struct entry {
+            key_type key;
+            std::unique_ptr<paxos_state> state;
+            // Write timestamp of the proposal columns, which decisions set to null.
+            api::timestamp_type proposal_timestamp;
+            // Memory used by the entry and its index node, see update_memory_usage().
+            size_t memory_usage = 0;
+        };
+        using lru_list = std::list<entry>;
+
+        lru_list _lru; // most recently used first
+        std::unordered_map<key_type, lru_list::iterator, key_hash> _index;
+        size_t _memory_usage = 0;
+        // Truncation time of system.paxos when the cached states were read from it.
+        db_clock::time_point _truncated_at = db_clock::time_point::min();
+
+        entry* find(const key_type& k);
+        void erase(lru_list::iterator it);
+        void erase(const key_type& k);
+        // Call when the state of the entry changes.
+        void update_memory_usage(entry& e);
+    public:
+        // Drops all the entries if system.paxos was truncated after they were read.
+        void check_truncation(db_clock::time_point truncated_at);
+        // Evicts the least recently used entries until at most capacity are left.
+        void shrink(size_t capacity);
+        size_t size() const {
+            return _lru.size();
+        }
+        size_t memory_usage() const {
+            return _memory_usage;
+        }
+        std::optional<paxos_state> get(const schema& s, const dht::token& token, const partition_key& key);
+        void put(const schema& s, const dht::token& token, const partition_key& key, const paxos_state& state, size_t capacity);
+        void on_promise(const schema& s, const dht::token& token, const partition_key& key, utils::UUID ballot);
+        void on_accept(const schema& s, const dht::token& token, const proposal& p);
+        void on_decision(const schema& s, const dht::token& token, const proposal& decision);
+        void on_prune(const schema& s, const dht::token& token, const partition_key& key, utils::UUID ballot);
+        void on_write_failure(const schema& s, const dht::token& token, const partition_key& key);
+    };
+    static thread_local state_cache _state_cache;
+
+    static future<paxos_state> load_state(storage_proxy& sp, db::system_keyspace& sys_ks, schema_ptr schema, dht::token token,
+            partition_key key, gc_clock::time_point now, clock_type::time_point timeout);
+
     utils::UUID _promised_ballot = utils::UUID_gen::min_time_UUID();
     std::optional<proposal> _accepted_proposal;
     std::optional<proposal> _most_recent_commit;
@@ -105,6 +178,29 @@ class paxos_state {
 
     static logging::logger logger;
 
+    // Applies a new paxos_state_cache_size to the cache of this shard.
+    static void resize_state_cache(size_t capacity) {
+        _state_cache.shrink(capacity);
+    }
+    static size_t state_cache_size() {
+        return _state_cache.size();
+    }
+    static size_t state_cache_memory_usage() {
+        return _state_cache.memory_usage();
+    }
+    // Returns the cached state of the partition, if any. For tests.
+    static std::optional<paxos_state> get_cached_state(const schema& s, const partition_key& key);
+
+    const utils::UUID& promised_ballot() const {
+        return _promised_ballot;
+    }
+    const std::optional<proposal>& accepted_proposal() const {
+        return _accepted_proposal;
+    }
+    const std::optional<proposal>& most_recent_commit() const {
+        return _most_recent_commit;
+    }
+
     paxos_state() {}
 
     paxos_state(utils::UUID promised, std::optional<proposal> accepted, std::optional<proposal> commit)
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "compaction_shares_updater.hh"
+#include "replica/database.hh"
+#include "log.hh"
+
+namespace qos {
+
+static logging::logger cslogger("compaction_shares_updater");
+
+compaction_shares_updater::compaction_shares_updater(service_level_controller& sl_controller, replica::database& db, const db::config& cfg)
+    : _sl_controller(sl_controller)
+    , _db(db)
+    , _cfg(cfg)
+    , _keyspace_service_levels_observer(cfg.keyspace_service_levels.observe([this] (const db::config::string_map&) { update(); }))
+{}
+
+future<> compaction_shares_updater::start() {
+    _sl_controller.register_subscriber(this);
+    update();
+    return make_ready_future<>();
+}
+
+future<> compaction_shares_updater::stop() {
+    return _sl_controller.unregister_subscriber(this);
+}
+
+void compaction_shares_updater::update() {
+    std::unordered_map<sstring, int32_t> keyspace_shares;
+    for (const auto& [keyspace, service_level] : _cfg.keyspace_service_levels()) {
+        auto it = _service_level_shares.find(service_level);
+        keyspace_shares.emplace(keyspace, it != _service_level_shares.end() ? it->second : service_level_options::default_shares);
+    }
+    cslogger.debug("Updating the compaction shares of {} keyspaces", keyspace_shares.size());
+    _db.set_keyspace_compaction_shares(std::move(keyspace_shares));
+}
+
+void compaction_shares_updater::set_shares(const sstring& service_level, const service_level_options& slo) {
+    if (std::holds_alternative<int32_t>(slo.shares)) {
+        _service_level_shares[service_level] = slo.get_shares();
+    } else {
+        _service_level_shares.erase(service_level);
+    }
+    update();
+}
+
+future<> compaction_shares_updater::on_before_service_level_add(service_level_options slo, service_level_info sl_info) {
+    set_shares(sl_info.name, slo);
+    return make_ready_future<>();
+}
+
+future<> compaction_shares_updater::on_after_service_level_remove(service_level_info sl_info) {
+    _service_level_shares.erase(sl_info.name);
+    update();
+    return make_ready_future<>();
+}
+
+future<> compaction_shares_updater::on_before_service_level_change(service_level_options slo_before, service_level_options slo_after, service_level_info sl_info) {
+    set_shares(sl_info.name, slo_after);
+    return make_ready_future<>();
+}
+
+}
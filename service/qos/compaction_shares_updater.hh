@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include "seastarx.hh"
+#include "db/config.hh"
+#include "utils/observable.hh"
+#include "service_level_controller.hh"
+#include "qos_configuration_change_subscriber.hh"
+
+namespace replica {
+class database;
+}
+
+namespace qos {
+
+/**
+ *  Applies the shares option of service levels to the compaction of the
+ *  tables of the keyspaces attributed to them by the keyspace_service_levels
+ *  configuration option, so that a tenant with low shares doesn't raise the
+ *  compaction shares of the whole node with a compaction storm of its own.
+ *  One instance runs on each shard.
+ */
+class compaction_shares_updater : public qos_configuration_change_subscriber {
+    service_level_controller& _sl_controller;
+    replica::database& _db;
+    const db::config& _cfg;
+    // The shares option of every service level which sets it.
+    std::unordered_map<sstring, int32_t> _service_level_shares;
+    utils::observer<db::config::string_map> _keyspace_service_levels_observer;
+
+    void update();
+    void set_shares(const sstring& service_level, const service_level_options& slo);
+public:
+    compaction_shares_updater(service_level_controller& sl_controller, replica::database& db, const db::config& cfg);
+
+    future<> start();
+    future<> stop();
+
+    virtual future<> on_before_service_level_add(service_level_options slo, service_level_info sl_info) override;
+    virtual future<> on_after_service_level_remove(service_level_info sl_info) override;
+    virtual future<> on_before_service_level_change(service_level_options slo_before, service_level_options slo_after, service_level_info sl_info) override;
+};
+
+}
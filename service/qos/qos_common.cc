@@ -26,6 +26,16 @@ service_level_options service_level_options::replace_defaults(const service_leve
             // leave the value as is
         },
     }, ret.timeout);
+    std::visit(overloaded_functor {
+        [&] (const unset_marker& um) {
+            ret.shares = default_values.shares;
+        },
+        [&] (const delete_marker& dm) {
+            ret.shares = unset_marker{};
+        },
+        [&] (int32_t) {
+        },
+    }, ret.shares);
     switch (ret.workload) {
     case workload_type::unspecified:
         ret.workload = default_values.workload;
@@ -55,6 +65,19 @@ service_level_options service_level_options::merge_with(const service_level_opti
             }
         },
     }, ret.timeout);
+    std::visit(overloaded_functor {
+        [&] (const unset_marker& um) {
+            ret.shares = other.shares;
+        },
+        [&] (const delete_marker& dm) {
+            ret.shares = other.shares;
+        },
+        [&] (int32_t s) {
+            if (auto* other_shares = std::get_if<int32_t>(&other.shares)) {
+                ret.shares = std::max(s, *other_shares);
+            }
+        },
+    }, ret.shares);
     // Specified workloads should be preferred over unspecified ones
     if (ret.workload == workload_type::unspecified || other.workload == workload_type::unspecified) {
         ret.workload = std::max(ret.workload, other.workload);
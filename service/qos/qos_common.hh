@@ -38,6 +38,20 @@ struct service_level_options {
     timeout_type timeout = unset_marker{};
     workload_type workload = workload_type::unspecified;
 
+    // The share of background work, like compaction, which the tables
+    // attributed to the service level get, relative to default_shares.
+    static constexpr int32_t default_shares = 1000;
+    static constexpr int32_t max_shares = 1000;
+    using shares_type = std::variant<unset_marker, delete_marker, int32_t>;
+    shares_type shares = unset_marker{};
+
+    int32_t get_shares() const noexcept {
+        if (auto* s = std::get_if<int32_t>(&shares)) {
+            return *s;
+        }
+        return default_shares;
+    }
+
     service_level_options replace_defaults(const service_level_options& other) const;
     // Merges the values of two service level options. The semantics depends
     // on the type of the parameter - e.g. for timeouts, a min value is preferred.
@@ -222,25 +222,39 @@ future<> group0_state_machine::transfer_snapshot(raft::server_id from_id, raft::
     auto& as = _abort_source;
 
     // (Ab)use MIGRATION_REQUEST to also transfer group0 history table mutation besides schema tables mutations.
-    auto [_, cm] = co_await _mm._messaging.send_migration_request(addr, as, netw::schema_pull_options { .group0_snapshot_transfer = true });
+    // Our last state ID lets the remote skip sending its state if we already applied all of it,
+    // e.g. when we restart with a raft log that fell behind the remote's snapshot.
+    auto last_state_id = co_await _client.sys_ks().get_last_group0_state_id();
+    auto [_, cm] = co_await _mm._messaging.send_migration_request(addr, as, netw::schema_pull_options {
+        .group0_snapshot_transfer = true,
+        .group0_last_state_id = last_state_id,
+    });
     if (!cm) {
         // If we're running this code then remote supports Raft group 0, so it should also support canonical mutations
         // (which were introduced a long time ago).
         on_internal_error(slogger, "Expected MIGRATION_REQUEST to return canonical mutations");
     }
 
-    auto topology_snp = co_await ser::storage_service_rpc_verbs::send_raft_pull_topology_snapshot(&_mm._messaging, addr, as, from_id, service::raft_topology_pull_params{});
-
     auto history_mut = extract_history_mutation(*cm, _sp.data_dictionary());
+    // Only the history is sent if our state is up to date with the remote's.
+    const bool up_to_date = cm->empty();
+    std::optional<service::raft_topology_snapshot> topology_snp;
+    if (up_to_date) {
+        slogger.debug("transfer snapshot from {}: group 0 state is up to date ({})", from_ip, last_state_id);
+    } else {
+        topology_snp = co_await ser::storage_service_rpc_verbs::send_raft_pull_topology_snapshot(&_mm._messaging, addr, as, from_id, service::raft_topology_pull_params{});
+    }
 
     // TODO ensure atomicity of snapshot application in presence of crashes (see TODO in `apply`)
 
     auto read_apply_mutex_holder = co_await _client.hold_read_apply_mutex(as);
 
-    co_await _mm.merge_schema_from(addr, std::move(*cm));
+    if (!up_to_date) {
+        co_await _mm.merge_schema_from(addr, std::move(*cm));
+    }
 
-    if (!topology_snp.topology_mutations.empty()) {
-        co_await _ss.merge_topology_snapshot(std::move(topology_snp));
+    if (topology_snp && !topology_snp->topology_mutations.empty()) {
+        co_await _ss.merge_topology_snapshot(std::move(*topology_snp));
         // Flush so that current supported and enabled features are readable before commitlog replay
         co_await _sp.get_db().local().flush(db::system_keyspace::NAME, db::system_keyspace::TOPOLOGY);
     }
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace service {
+
+// Load of the shard of a replica which handled a read or a write, sent back to
+// the coordinator with the reply, so that it can steer requests away from
+// replicas which are busy (see load_aware_read_balancing).
+struct replica_load {
+    // Reads waiting on the reader concurrency semaphore.
+    uint32_t queued_reads = 0;
+    // Time the replica spent handling the request, in microseconds.
+    uint32_t service_time_us = 0;
+    // Ratios, scaled from [0, 1] to [0, 255] (see to_ratio() and from_ratio()):
+    // Unspooled dirty memory, relative to the threshold at which writes are blocked.
+    uint8_t dirty_memory = 0;
+    // Normalized compaction backlog, relative to the one at which compaction
+    // gets the most shares.
+    uint8_t compaction_backlog = 0;
+    // Fraction of the time the reactor was busy, over the last sampling period.
+    uint8_t cpu_utilization = 0;
+
+    static uint8_t to_ratio(double r) noexcept {
+        return uint8_t(std::clamp(r, 0.0, 1.0) * 255);
+    }
+    static double from_ratio(uint8_t r) noexcept {
+        return r / 255.0;
+    }
+};
+
+}
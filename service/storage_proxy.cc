@@ -20,6 +20,7 @@
 #include "mutation/frozen_mutation.hh"
 #include "supervisor.hh"
 #include "query_result_merger.hh"
+#include "query-result-columnar.hh"
 #include <seastar/core/do_with.hh>
 #include "message/messaging_service.hh"
 #include "locator/tablets.hh"
@@ -27,6 +28,7 @@
 #include <seastar/core/future-util.hh>
 #include "db/read_repair_decision.hh"
 #include "db/config.hh"
+#include "db/hot_partition_replicas.hh"
 #include "db/batchlog_manager.hh"
 #include "db/hints/manager.hh"
 #include "db/system_keyspace.hh"
@@ -53,15 +55,19 @@
 #include <boost/intrusive/list.hpp>
 #include <boost/outcome/result.hpp>
 #include "utils/latency.hh"
+#include "utils/hash.hh"
+#include "utils/background_disposer.hh"
 #include "schema/schema.hh"
 #include "query_ranges_to_vnodes.hh"
 #include "schema/schema_registry.hh"
 #include <seastar/util/lazy.hh>
 #include <seastar/core/metrics.hh>
 #include <seastar/core/execution_stage.hh>
+#include <seastar/core/reactor.hh>
 #include "db/timeout_clock.hh"
 #include "multishard_mutation_query.hh"
 #include "replica/database.hh"
+#include "compaction/compaction_manager.hh"
 #include "db/consistency_level_validations.hh"
 #include "cdc/log.hh"
 #include "cdc/stats.hh"
@@ -152,6 +158,16 @@ static future<ResultTuple> add_replica_exception_to_query_result(gms::feature_se
     return encode_replica_exception_for_rpc<ResultTuple>(features, f.get_exception());
 }
 
+// The replica_load sent with a reply, or nothing if the replica predates it.
+// The error injection makes replies look like the latter, for tests.
+static const std::optional<service::replica_load>& received_replica_load(const rpc::optional<service::replica_load>& load) {
+    static const std::optional<service::replica_load> none;
+    if (utils::get_local_injector().enter("storage_proxy_reply_without_replica_load")) {
+        return none;
+    }
+    return load;
+}
+
 static bool only_me(const inet_address_vector_replica_set& replicas) {
     return replicas.size() == 1 && replicas[0] == utils::fb_utilities::get_broadcast_address();
 }
@@ -173,6 +189,28 @@ class storage_proxy::remote {
     netw::connection_drop_slot_t _connection_dropped;
     netw::connection_drop_registration_t _condrop_registration;
 
+    // Writes to a replica waiting to be sent in a single MUTATION_BATCH message,
+    // see write_batching_window_in_us. Writes from different scheduling groups
+    // are batched separately, so that they keep using their own connections.
+    struct write_batch {
+        // Shared with the mutation holders of the writes, so that batching does not copy them.
+        std::vector<lw_shared_ptr<const frozen_mutation>> mutations;
+        std::vector<uint64_t> response_ids;
+        std::vector<db::per_partition_rate_limit::info> rate_limit_infos;
+        std::vector<fencing_token> fences;
+        std::vector<promise<>> sent;
+        size_t size = 0;
+        storage_proxy::clock_type::time_point timeout = storage_proxy::clock_type::time_point::min();
+        timer<> flush_timer;
+    };
+    using write_batch_key = std::pair<gms::inet_address, scheduling_group>;
+    std::unordered_map<write_batch_key, std::unique_ptr<write_batch>, utils::tuple_hash> _write_batches;
+    // Keeps `remote` alive until all flushed batches are sent.
+    seastar::gate _write_batch_gate;
+
+    static constexpr size_t max_write_batch_mutations = 256;
+    static constexpr size_t max_write_batch_size = 128 * 1024;
+
     bool _stopped{false};
 
 public:
@@ -183,6 +221,7 @@ class storage_proxy::remote {
     {
         ser::storage_proxy_rpc_verbs::register_counter_mutation(&_ms, std::bind_front(&remote::handle_counter_mutation, this));
         ser::storage_proxy_rpc_verbs::register_mutation(&_ms, std::bind_front(&remote::receive_mutation_handler, this, _sp._write_smp_service_group));
+        ser::storage_proxy_rpc_verbs::register_mutation_batch(&_ms, std::bind_front(&remote::receive_mutation_batch_handler, this, _sp._write_smp_service_group));
         ser::storage_proxy_rpc_verbs::register_hint_mutation(&_ms, std::bind_front(&remote::receive_hint_mutation_handler, this));
         ser::storage_proxy_rpc_verbs::register_paxos_learn(&_ms, std::bind_front(&remote::handle_paxos_learn, this));
         ser::storage_proxy_rpc_verbs::register_mutation_done(&_ms, std::bind_front(&remote::handle_mutation_done, this));
@@ -203,6 +242,10 @@ class storage_proxy::remote {
 
     // Must call before destroying the `remote` object.
     future<> stop() {
+        while (!_write_batches.empty()) {
+            flush_write_batch(_write_batches.begin()->first);
+        }
+        co_await _write_batch_gate.close();
         co_await ser::storage_proxy_rpc_verbs::unregister(&_ms);
         _stopped = true;
     }
@@ -221,11 +264,31 @@ class storage_proxy::remote {
 
     // Note: none of the `send_*` functions use `remote` after yielding - by the first yield,
     // control is delegated to another service (messaging_service). Thus unfinished `send`s
-    // do not make it unsafe to destroy the `remote` object.
+    // do not make it unsafe to destroy the `remote` object. The exception are batched writes,
+    // which are sent under `_write_batch_gate`.
     //
     // Running handlers prevent the object from being destroyed,
     // assuming `stop()` is called before destruction.
 
+    future<> send_mutation(
+            netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, const std::optional<tracing::trace_info>& trace_info,
+            lw_shared_ptr<const frozen_mutation> m, const inet_address_vector_replica_set& forward, gms::inet_address reply_to, unsigned shard,
+            storage_proxy::response_id_type response_id, db::per_partition_rate_limit::info rate_limit_info,
+            fencing_token fence) {
+        // Only plain writes issued by this coordinator shard are batched: traced writes
+        // and writes carrying a forward list keep using their own messages.
+        if (forward.empty() && !trace_info && shard == this_shard_id() && reply_to == utils::fb_utilities::get_broadcast_address()
+                && !_write_batch_gate.is_closed()) {
+            auto window = std::chrono::microseconds(_sp._db.local().get_config().write_batching_window_in_us());
+            if (window.count() && _sp.features().mutation_batch_verb) {
+                return add_to_write_batch(addr.addr, window, timeout, std::move(m), response_id, rate_limit_info, fence);
+            }
+        }
+        return send_mutation(std::move(addr), timeout, trace_info, *m, forward, std::move(reply_to), shard,
+                response_id, rate_limit_info, fence);
+    }
+
+    // Sends the write in its own MUTATION message.
     future<> send_mutation(
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, const std::optional<tracing::trace_info>& trace_info,
             const frozen_mutation& m, const inet_address_vector_replica_set& forward, gms::inet_address reply_to, unsigned shard,
@@ -237,6 +300,73 @@ class storage_proxy::remote {
                 response_id, trace_info, rate_limit_info, fence);
     }
 
+    // The returned future resolves once the batch the write was added to is sent.
+    future<> add_to_write_batch(
+            gms::inet_address ep, std::chrono::microseconds window, storage_proxy::clock_type::time_point timeout,
+            lw_shared_ptr<const frozen_mutation> m, storage_proxy::response_id_type response_id,
+            db::per_partition_rate_limit::info rate_limit_info, fencing_token fence) {
+        auto key = write_batch_key(ep, current_scheduling_group());
+        auto& b = _write_batches[key];
+        if (!b) {
+            b = std::make_unique<write_batch>();
+            b->flush_timer.set_callback(key.second, [this, key] { flush_write_batch(key); });
+        }
+        b->size += m->representation().size();
+        b->mutations.push_back(std::move(m));
+        b->response_ids.push_back(response_id);
+        b->rate_limit_infos.push_back(rate_limit_info);
+        b->fences.push_back(fence);
+        auto f = b->sent.emplace_back().get_future();
+        // The message is sent with the latest timeout of its writes, so that none
+        // of them is dropped before its own deadline.
+        b->timeout = std::max(b->timeout, timeout);
+
+        // Never hold a write past its own timeout waiting for others to join.
+        auto now = timer<>::clock::now();
+        auto flush_at = now + std::min<timer<>::duration>(window,
+                std::chrono::duration_cast<timer<>::duration>(timeout - storage_proxy::clock_type::now()));
+        if (flush_at <= now || b->mutations.size() >= max_write_batch_mutations || b->size >= max_write_batch_size) {
+            flush_write_batch(key);
+        } else if (!b->flush_timer.armed() || flush_at < b->flush_timer.get_timeout()) {
+            b->flush_timer.rearm(flush_at);
+        }
+        return f;
+    }
+
+    void flush_write_batch(const write_batch_key& key) {
+        auto it = _write_batches.find(key);
+        if (it == _write_batches.end()) {
+            return;
+        }
+        auto b = std::move(it->second);
+        _write_batches.erase(it);
+        b->flush_timer.cancel();
+        // Errors are propagated to each write through write_batch::sent.
+        (void)with_gate(_write_batch_gate, [this, ep = key.first, b = std::move(b)] () mutable {
+            return send_write_batch(ep, std::move(b));
+        });
+    }
+
+    future<> send_write_batch(gms::inet_address ep, std::unique_ptr<write_batch> b) {
+        auto& stats = _sp.get_stats();
+        ++stats.write_batches;
+        stats.batched_writes += b->mutations.size();
+        auto f = co_await coroutine::as_future(ser::storage_proxy_rpc_verbs::send_mutation_batch(
+                &_ms, netw::msg_addr{ep, 0}, b->timeout,
+                b->mutations, b->response_ids, utils::fb_utilities::get_broadcast_address(), this_shard_id(),
+                b->rate_limit_infos, b->fences));
+        if (f.failed()) {
+            auto eptr = f.get_exception();
+            for (auto& p : b->sent) {
+                p.set_exception(eptr);
+            }
+        } else {
+            for (auto& p : b->sent) {
+                p.set_value();
+            }
+        }
+    }
+
     future<> send_hint_mutation(
             netw::msg_addr addr, storage_proxy::clock_type::time_point timeout, tracing::trace_state_ptr tr_state,
             const frozen_mutation& m, const inet_address_vector_replica_set& forward, gms::inet_address reply_to, unsigned shard,
@@ -263,11 +393,11 @@ class storage_proxy::remote {
 
     future<> send_mutation_done(
             netw::msg_addr addr, tracing::trace_state_ptr tr_state,
-            unsigned shard, uint64_t response_id, db::view::update_backlog backlog) {
+            unsigned shard, uint64_t response_id, db::view::update_backlog backlog, service::replica_load load) {
         tracing::trace(tr_state, "Sending mutation_done to /{}", addr.addr);
         return ser::storage_proxy_rpc_verbs::send_mutation_done(
                 &_ms, std::move(addr),
-                shard, response_id, std::move(backlog));
+                shard, response_id, std::move(backlog), std::move(load));
     }
 
     future<> send_mutation_failed(
@@ -285,7 +415,10 @@ class storage_proxy::remote {
             const query::read_command& cmd, const dht::partition_range& pr,
             fencing_token fence) {
         tracing::trace(tr_state, "read_mutation_data: sending a message to /{}", addr.addr);
-        auto&& [result, hit_rate, opt_exception] = co_await ser::storage_proxy_rpc_verbs::send_read_mutation_data(&_ms, addr, timeout, cmd, pr, fence);
+        auto&& [result, hit_rate, opt_exception, opt_load] = co_await ser::storage_proxy_rpc_verbs::send_read_mutation_data(&_ms, addr, timeout, cmd, pr, fence);
+        if (auto& load = received_replica_load(opt_load)) {
+            _sp.register_replica_load(addr.addr, *load, true);
+        }
         if (opt_exception.has_value() && *opt_exception) {
             co_await coroutine::return_exception_ptr((*opt_exception).into_exception_ptr());
         }
@@ -301,13 +434,19 @@ class storage_proxy::remote {
             query::digest_algorithm digest_algo, db::per_partition_rate_limit::info rate_limit_info,
             fencing_token fence) {
         tracing::trace(tr_state, "read_data: sending a message to /{}", addr.addr);
-        auto&& [result, hit_rate, opt_exception] =
+        auto&& [result, hit_rate, opt_exception, opt_load] =
             co_await ser::storage_proxy_rpc_verbs::send_read_data(&_ms, addr, timeout, cmd, pr, digest_algo, rate_limit_info, fence);
+        if (auto& load = received_replica_load(opt_load)) {
+            _sp.register_replica_load(addr.addr, *load, true);
+        }
         if (opt_exception.has_value() && *opt_exception) {
             co_await coroutine::return_exception_ptr((*opt_exception).into_exception_ptr());
         }
 
         tracing::trace(tr_state, "read_data: got response from /{}", addr.addr);
+        if (cmd.slice.options.contains<query::partition_slice::option::columnar_result>()) {
+            result = co_await query::decode_columnar(result);
+        }
         co_return rpc::tuple{make_foreign(::make_lw_shared<query::result>(std::move(result))), hit_rate.value_or(cache_temperature::invalid())};
     }
 
@@ -318,8 +457,11 @@ class storage_proxy::remote {
             query::digest_algorithm digest_algo, db::per_partition_rate_limit::info rate_limit_info,
             fencing_token fence) {
         tracing::trace(tr_state, "read_digest: sending a message to /{}", addr.addr);
-        auto&& [d, t, hit_rate, opt_exception, opt_last_pos] =
+        auto&& [d, t, hit_rate, opt_exception, opt_last_pos, opt_load] =
             co_await ser::storage_proxy_rpc_verbs::send_read_digest(&_ms, addr, timeout, cmd, pr, digest_algo, rate_limit_info, fence);
+        if (auto& load = received_replica_load(opt_load)) {
+            _sp.register_replica_load(addr.addr, *load, true);
+        }
         if (opt_exception.has_value() && *opt_exception) {
             co_await coroutine::return_exception_ptr((*opt_exception).into_exception_ptr());
         }
@@ -480,6 +622,7 @@ class storage_proxy::remote {
 
         const auto& m = in;
         shared_ptr<storage_proxy> p = _sp.shared_from_this();
+        auto start = utils::latency_counter::now();
         errors_info errors;
         ++p->get_stats().received_mutations;
         p->get_stats().forwarded_mutations += forward.size();
@@ -500,8 +643,9 @@ class storage_proxy::remote {
                         //
                         // Usually we will return immediately, since this work only involves appending data to the connection
                         // send buffer.
+                        auto service_time = std::chrono::duration_cast<std::chrono::microseconds>(utils::latency_counter::now() - start);
                         auto f = co_await coroutine::as_future(send_mutation_done(netw::messaging_service::msg_addr{reply_to, shard}, trace_state_ptr,
-                                shard, response_id, p->get_view_update_backlog()));
+                                shard, response_id, p->get_view_update_backlog(), p->get_local_replica_load(service_time)));
                         f.ignore_ready_future();
                     } catch (...) {
                         std::exception_ptr eptr = std::current_exception();
@@ -558,14 +702,20 @@ class storage_proxy::remote {
             rpc::optional<std::optional<tracing::trace_info>> trace_info,
             rpc::optional<db::per_partition_rate_limit::info> rate_limit_info_opt,
             rpc::optional<fencing_token> fence) {
-        tracing::trace_state_ptr trace_state_ptr;
-        auto src_addr = netw::messaging_service::get_source(cinfo);
-        auto rate_limit_info = rate_limit_info_opt.value_or(std::monostate());
-
-        auto schema_version = in.schema_version();
-        return handle_write(src_addr, t, schema_version, std::move(in), forward, reply_to, shard, response_id,
-                trace_info ? *trace_info : std::nullopt,
-                fence.value_or(fencing_token{}),
+        return handle_mutation(smp_grp, netw::messaging_service::get_source(cinfo), t, std::move(in), std::move(forward), reply_to, shard, response_id,
+                trace_info ? *trace_info : std::nullopt, rate_limit_info_opt.value_or(std::monostate()), fence.value_or(fencing_token{}));
+    }
+
+    // `in` is either a frozen_mutation, or a reference to one which outlives the returned future.
+    future<rpc::no_wait_type> handle_mutation(
+            smp_service_group smp_grp, netw::messaging_service::msg_addr src_addr, rpc::opt_time_point t,
+            auto in, inet_address_vector_replica_set forward, gms::inet_address reply_to,
+            unsigned shard, storage_proxy::response_id_type response_id, std::optional<tracing::trace_info> trace_info,
+            db::per_partition_rate_limit::info rate_limit_info, fencing_token fence) {
+        auto schema_version = static_cast<const frozen_mutation&>(in).schema_version();
+        co_return co_await handle_write(src_addr, t, schema_version, std::move(in), forward, reply_to, shard, response_id,
+                trace_info,
+                fence,
                 /* apply_fn */ [smp_grp, rate_limit_info, src_ip = src_addr.addr] (shared_ptr<storage_proxy>& p, tracing::trace_state_ptr tr_state, schema_ptr s, const frozen_mutation& m,
                         clock_type::time_point timeout, fencing_token fence) {
                     return p->apply_fence(p->mutate_locally(std::move(s), m, std::move(tr_state), db::commitlog::force_sync::no, timeout, smp_grp, rate_limit_info), fence, src_ip);
@@ -577,6 +727,24 @@ class storage_proxy::remote {
                 });
     }
 
+    future<rpc::no_wait_type> receive_mutation_batch_handler(
+            smp_service_group smp_grp, const rpc::client_info& cinfo, rpc::opt_time_point t,
+            std::vector<lw_shared_ptr<const frozen_mutation>> fms, std::vector<uint64_t> response_ids, gms::inet_address reply_to, unsigned shard,
+            std::vector<db::per_partition_rate_limit::info> rate_limit_infos, std::vector<fencing_token> fences) {
+        if (response_ids.size() != fms.size() || rate_limit_infos.size() != fms.size() || fences.size() != fms.size()) {
+            throw std::runtime_error(format("Malformed mutation batch from {}#{}: {} mutations, {} response ids, {} rate limit infos, {} fences",
+                    reply_to, shard, fms.size(), response_ids.size(), rate_limit_infos.size(), fences.size()));
+        }
+        // Each write is handled, and acknowledged, as if it had arrived in its own MUTATION message.
+        // The mutations are kept alive by `fms` until all of them are handled.
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+        co_await coroutine::parallel_for_each(boost::irange<size_t>(0, fms.size()), [&] (size_t i) -> future<> {
+            co_await handle_mutation(smp_grp, src_addr, t, std::cref(*fms[i]), {}, reply_to, shard, response_ids[i],
+                    std::nullopt, rate_limit_infos[i], fences[i]);
+        });
+        co_return netw::messaging_service::no_wait();
+    }
+
     future<rpc::no_wait_type> receive_hint_mutation_handler(
             const rpc::client_info& cinfo, rpc::opt_time_point t,
             frozen_mutation in, inet_address_vector_replica_set forward, gms::inet_address reply_to,
@@ -612,11 +780,15 @@ class storage_proxy::remote {
 
     future<rpc::no_wait_type> handle_mutation_done(
             const rpc::client_info& cinfo,
-            unsigned shard, storage_proxy::response_id_type response_id, rpc::optional<db::view::update_backlog> backlog) {
+            unsigned shard, storage_proxy::response_id_type response_id, rpc::optional<db::view::update_backlog> backlog,
+            rpc::optional<service::replica_load> load) {
         auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         _sp.get_stats().replica_cross_shard_ops += shard != this_shard_id();
         return _sp.container().invoke_on(shard, _sp._write_ack_smp_service_group,
-                [from, response_id, backlog = std::move(backlog)] (storage_proxy& sp) mutable {
+                [from, response_id, backlog = std::move(backlog), load = std::move(load)] (storage_proxy& sp) mutable {
+            if (auto& l = received_replica_load(load)) {
+                sp.register_replica_load(from, *l, false);
+            }
             sp.got_response(response_id, from, std::move(backlog));
             return netw::messaging_service::no_wait();
         });
@@ -716,7 +888,15 @@ class storage_proxy::remote {
                 query::result_options opts;
                 opts.digest_algo = da;
                 opts.request = da == query::digest_algorithm::none ? query::result_request::only_result : query::result_request::result_and_digest;
-                return p->query_result_local(erm, std::move(s), cmd, std::move(pr2.first), opts, trace_state_ptr, timeout, rate_limit_info);
+                auto f = p->query_result_local(erm, std::move(s), cmd, std::move(pr2.first), opts, trace_state_ptr, timeout, rate_limit_info);
+                if (!cmd->slice.options.contains<query::partition_slice::option::columnar_result>()) {
+                    return f;
+                }
+                using result_type = rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>;
+                return f.then([] (result_type r) -> future<result_type> {
+                    auto res = make_foreign(make_lw_shared<query::result>(co_await query::encode_columnar(*std::get<0>(r))));
+                    co_return result_type(std::move(res), std::get<1>(r));
+                });
             } else if constexpr (verb == read_verb::read_mutation_data) {
                 p->get_stats().replica_mutation_data_reads++;
                 return p->query_mutations_locally(std::move(s), std::move(cmd), pr2, timeout, trace_state_ptr);
@@ -750,35 +930,49 @@ class storage_proxy::remote {
         co_return co_await add_replica_exception_to_query_result<Result>(p->features(), std::move(f));
     }
 
-    using read_data_result_t = rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature, replica::exception_variant>;
+    // Appends the load of this replica to the reply of a read which started at `start`.
+    template<utils::Tuple ResultTuple, utils::Tuple SourceTuple>
+    future<ResultTuple> add_replica_load(future<SourceTuple> f, utils::latency_counter::time_point start) {
+        auto result = co_await std::move(f);
+        auto service_time = std::chrono::duration_cast<std::chrono::microseconds>(utils::latency_counter::now() - start);
+        co_return utils::tuple_insert<ResultTuple>(std::move(result), _sp.get_local_replica_load(service_time));
+    }
+
+    using read_data_result_t = rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature, replica::exception_variant, service::replica_load>;
     future<read_data_result_t> handle_read_data(
             const rpc::client_info& cinfo, rpc::opt_time_point t,
             query::read_command cmd1, ::compat::wrapping_partition_range pr,
             rpc::optional<query::digest_algorithm> oda,
             rpc::optional<db::per_partition_rate_limit::info> rate_limit_info_opt,
             rpc::optional<service::fencing_token> fence) {
-        return handle_read<read_data_result_t, read_verb::read_data>(cinfo, t, std::move(cmd1),
-            std::move(pr), oda, rate_limit_info_opt, fence);
+        using result_t = rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature, replica::exception_variant>;
+        auto start = utils::latency_counter::now();
+        return add_replica_load<read_data_result_t>(handle_read<result_t, read_verb::read_data>(cinfo, t, std::move(cmd1),
+            std::move(pr), oda, rate_limit_info_opt, fence), start);
     }
 
-    using read_mutation_data_result_t = rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature, replica::exception_variant>;
+    using read_mutation_data_result_t = rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature, replica::exception_variant, service::replica_load>;
     future<read_mutation_data_result_t> handle_read_mutation_data(
             const rpc::client_info& cinfo, rpc::opt_time_point t,
             query::read_command cmd1, ::compat::wrapping_partition_range pr,
             rpc::optional<service::fencing_token> fence) {
-        return handle_read<read_mutation_data_result_t, read_verb::read_mutation_data>(cinfo, t, std::move(cmd1),
-            std::move(pr), std::nullopt, std::nullopt, fence);
+        using result_t = rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature, replica::exception_variant>;
+        auto start = utils::latency_counter::now();
+        return add_replica_load<read_mutation_data_result_t>(handle_read<result_t, read_verb::read_mutation_data>(cinfo, t, std::move(cmd1),
+            std::move(pr), std::nullopt, std::nullopt, fence), start);
     }
 
-    using read_digest_result_t = rpc::tuple<query::result_digest, long, cache_temperature, replica::exception_variant, std::optional<full_position>>;
+    using read_digest_result_t = rpc::tuple<query::result_digest, long, cache_temperature, replica::exception_variant, std::optional<full_position>, service::replica_load>;
     future<read_digest_result_t> handle_read_digest(
             const rpc::client_info& cinfo, rpc::opt_time_point t,
             query::read_command cmd1, ::compat::wrapping_partition_range pr,
             rpc::optional<query::digest_algorithm> oda,
             rpc::optional<db::per_partition_rate_limit::info> rate_limit_info_opt,
             rpc::optional<service::fencing_token> fence) {
-        return handle_read<read_digest_result_t, read_verb::read_digest>(cinfo, t, std::move(cmd1),
-            std::move(pr), oda, rate_limit_info_opt, fence);
+        using result_t = rpc::tuple<query::result_digest, long, cache_temperature, replica::exception_variant, std::optional<full_position>>;
+        auto start = utils::latency_counter::now();
+        return add_replica_load<read_digest_result_t>(handle_read<result_t, read_verb::read_digest>(cinfo, t, std::move(cmd1),
+            std::move(pr), oda, rate_limit_info_opt, fence), start);
     }
 
     future<> handle_truncate(rpc::opt_time_point timeout, sstring ksname, sstring cfname) {
@@ -905,6 +1099,9 @@ using fbu = utils::fb_utilities;
 
 static inline
 query::digest_algorithm digest_algorithm(service::storage_proxy& proxy) {
+    if (proxy.features().digest_of_versions && proxy.get_db().local().get_config().digest_reads_compare_versions()) {
+        return query::digest_algorithm::xxHash_of_versions;
+    }
     return proxy.features().digest_for_null_values
             ? query::digest_algorithm::xxHash
             : query::digest_algorithm::legacy_xxHash_without_null_digest;
@@ -1045,7 +1242,7 @@ class per_destination_mutation : public mutation_holder {
         if (m) {
             tracing::trace(tr_state, "Sending a mutation to /{}", ep);
             return sp.remote().send_mutation(netw::messaging_service::msg_addr{ep, 0}, timeout, tracing::make_trace_info(tr_state),
-                    *m, forward, utils::fb_utilities::get_broadcast_address(), this_shard_id(),
+                    m, forward, utils::fb_utilities::get_broadcast_address(), this_shard_id(),
                     response_id, rate_limit_info, fence);
         }
         sp.got_response(response_id, ep, std::nullopt);
@@ -1061,6 +1258,13 @@ class per_destination_mutation : public mutation_holder {
             }
         }
     }
+    virtual void reply(gms::inet_address ep) override {
+        // A replica which replied will not need a hint.
+        auto it = _mutations.find(ep);
+        if (it != _mutations.end()) {
+            it->second = nullptr;
+        }
+    }
     dht::token& token() {
         return _token;
     }
@@ -1093,7 +1297,7 @@ class shared_mutation : public mutation_holder {
             fencing_token fence) override {
         tracing::trace(tr_state, "Sending a mutation to /{}", ep);
         return sp.remote().send_mutation(netw::messaging_service::msg_addr{ep, 0}, timeout, tracing::make_trace_info(tr_state),
-                *_mutation, forward, utils::fb_utilities::get_broadcast_address(), this_shard_id(),
+                _mutation, forward, utils::fb_utilities::get_broadcast_address(), this_shard_id(),
                 response_id, rate_limit_info, fence);
     }
     virtual bool is_shared() override {
@@ -1300,6 +1504,8 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
     storage_proxy::write_stats& _stats;
     lw_shared_ptr<cdc::operation_result_tracker> _cdc_operation_result_tracker;
     timer<storage_proxy::clock_type> _expire_timer;
+    // Set when the handler was released after achieving CL, see release_after_cl().
+    std::optional<storage_proxy::clock_type::time_point> _background_timeout;
     service_permit _permit; // holds admission permit until operation completes
     db::per_partition_rate_limit::info _rate_limit_info;
 
@@ -1377,6 +1583,24 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
         _proxy->_global_stats.background_write_bytes += _mutation_holder->size();
         _throttled = false;
         _ready.set_value(bo::success());
+        release_after_cl();
+    }
+    // Once the client got its response, keeps only what is needed to hint
+    // the replicas which did not respond yet, and hints them after
+    // background_write_timeout_in_ms rather than after the write timeout.
+    // The write stays accounted in background_write_bytes until then.
+    void release_after_cl() {
+        auto background_timeout_ms = _proxy->get_db().local().get_config().background_write_timeout_in_ms();
+        if (!background_timeout_ms || _targets.empty()) {
+            return;
+        }
+        _permit = empty_service_permit();
+        _cdc_operation_result_tracker = nullptr;
+        _background_timeout = storage_proxy::clock_type::now() + std::chrono::milliseconds(background_timeout_ms);
+        if (_expire_timer.armed() && *_background_timeout < _expire_timer.get_timeout()) {
+            _expire_timer.rearm(*_background_timeout);
+        }
+        ++stats().background_writes_released;
     }
     void signal(size_t nr = 1) {
         _cl_acks += nr;
@@ -1454,7 +1678,7 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
         }
     }
     void expire_at(storage_proxy::clock_type::time_point timeout) {
-        _expire_timer.arm(timeout);
+        _expire_timer.arm(_background_timeout ? std::min(timeout, *_background_timeout) : timeout);
     }
     void on_released() {
         _expire_timer.cancel();
@@ -1493,12 +1717,25 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
                     return std::max(lhs, rhs);
                 });
     }
-    std::chrono::microseconds calculate_delay(db::view::update_backlog backlog) {
+    // Highest write pressure reported by the targets, see storage_proxy::get_replica_write_pressure().
+    double max_write_pressure() {
+        if (!_proxy->get_db().local().get_config().load_aware_write_throttling()) {
+            return 0;
+        }
+        return boost::accumulate(
+                get_targets() | boost::adaptors::transformed([this] (gms::inet_address ep) {
+                    return _proxy->get_replica_write_pressure(ep);
+                }),
+                0.0,
+                [] (double lhs, double rhs) { return std::max(lhs, rhs); });
+    }
+    // Calculates the delay for a fill ratio between 0 and 1 of whatever the writes fill.
+    std::chrono::microseconds calculate_delay(float relative_size) {
         constexpr auto delay_limit_us = 1000000;
         auto adjust = [] (float x) { return x * x * x; };
         auto budget = std::max(storage_proxy::clock_type::duration(0),
             _expire_timer.get_timeout() - storage_proxy::clock_type::now());
-        std::chrono::microseconds ret(uint32_t(adjust(backlog.relative_size()) * delay_limit_us));
+        std::chrono::microseconds ret(uint32_t(adjust(relative_size) * delay_limit_us));
         // "budget" has millisecond resolution and can potentially be long
         // in the future so converting it to microseconds may overflow.
         // So to compare buget and ret we need to convert both to the lower
@@ -1514,15 +1751,26 @@ class abstract_write_response_handler : public seastar::enable_shared_from_this<
     template<typename Func>
     void delay(tracing::trace_state_ptr trace, Func&& on_resume) {
         auto backlog = max_backlog();
-        auto delay = calculate_delay(backlog);
+        auto delay = calculate_delay(backlog.relative_size());
         stats().last_mv_flow_control_delay = delay;
-        if (delay.count() == 0) {
+        // Replicas which are close to running out of memory for writes slow
+        // the coordinator down the same way a view update backlog does.
+        auto write_pressure = max_write_pressure();
+        auto load_delay = calculate_delay(write_pressure);
+        if (delay.count() == 0 && load_delay.count() == 0) {
             tracing::trace(trace, "Delay decision due to throttling: do not delay, resuming now");
             on_resume(this);
         } else {
             ++stats().throttled_base_writes;
-            tracing::trace(trace, "Delaying user write due to view update backlog {}/{} by {}us",
-                          backlog.current, backlog.max, delay.count());
+            if (load_delay > delay) {
+                delay = load_delay;
+                ++stats().writes_throttled_by_replica_load;
+                tracing::trace(trace, "Delaying user write due to replica write pressure {} by {}us",
+                              write_pressure, delay.count());
+            } else {
+                tracing::trace(trace, "Delaying user write due to view update backlog {}/{} by {}us",
+                              backlog.current, backlog.max, delay.count());
+            }
             // Waited on indirectly.
             (void)sleep_abortable<seastar::steady_clock_type>(delay).finally([self = shared_from_this(), on_resume = std::forward<Func>(on_resume)] {
                 --self->stats().throttled_base_writes;
@@ -2505,10 +2753,18 @@ void storage_proxy_stats::write_stats::register_stats() {
                            sm::description("number of write requests which were rejected directly on the coordinator because rate limit for the partition was reached."),
                            {storage_proxy_stats::current_scheduling_group_label(),storage_proxy_stats::rejected_by_coordinator_label(true)}).set_skip_when_empty(),
 
+            sm::make_total_operations("writes_throttled_by_replica_load", writes_throttled_by_replica_load,
+                           sm::description("number of write requests delayed because a replica reported high write pressure"),
+                           {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
             sm::make_total_operations("background_writes_failed", background_writes_failed,
                            sm::description("number of write requests that failed after CL was reached"),
                            {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
+            sm::make_total_operations("background_writes_released", background_writes_released,
+                           sm::description("number of write requests which released their resources after CL was reached, while waiting for the remaining replicas"),
+                           {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
             sm::make_total_operations("writes_coordinator_outside_replica_set", writes_coordinator_outside_replica_set,
                     sm::description("number of CQL write requests which arrived to a non-replica and had to be forwarded to a replica"),
                     {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
@@ -2616,6 +2872,18 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of speculative data read requests that were sent"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
+        sm::make_total_operations("busy_replicas_avoided", busy_replicas_avoided,
+                       sm::description("number of times a replica was left out of a read because another replica was expected to respond much sooner (see load_aware_read_balancing)"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+        sm::make_total_operations("early_speculative_reads", early_speculative_reads,
+                       sm::description("number of speculative read requests that were sent right away, because a replica chosen for the read was expected to be slow (see speculative_retry_adaptive)"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+        sm::make_total_operations("speculative_reads_over_budget", speculative_reads_over_budget,
+                       sm::description("number of speculative read requests that were not sent because of speculative_retry_max_extra_load"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_summary("cas_read_latency_summary", sm::description("CAS read latency summary"), [this] {return to_metrics_summary(cas_read.summary());})(storage_proxy_stats::current_scheduling_group_label()).set_skip_when_empty(),
         sm::make_summary("cas_write_latency_summary", sm::description("CAS write latency summary"), [this] {return to_metrics_summary(cas_write.summary());})(storage_proxy_stats::current_scheduling_group_label()).set_skip_when_empty(),
 
@@ -2644,6 +2912,14 @@ void storage_proxy_stats::stats::register_stats() {
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
 
 
+        sm::make_total_operations("write_batches", write_batches,
+                       sm::description("number of messages carrying several writes to a replica, sent when write_batching_window_in_us is set"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
+        sm::make_total_operations("batched_writes", batched_writes,
+                       sm::description("number of writes to replicas sent as part of a batch message"),
+                       {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
+
         sm::make_total_operations("cas_read_unfinished_commit", cas_read_unfinished_commit,
                        sm::description("number of transaction commit attempts that occurred on read"),
                        {storage_proxy_stats::current_scheduling_group_label()}).set_skip_when_empty(),
@@ -2837,12 +3113,21 @@ storage_proxy::storage_proxy(distributed<replica::database>& db, storage_proxy::
     , _background_write_throttle_threahsold(cfg.available_memory / 10)
     , _mutate_stage{"storage_proxy_mutate", &storage_proxy::do_mutate}
     , _max_view_update_backlog(max_view_update_backlog)
-    , _cancellable_write_handlers_list(std::make_unique<cancellable_write_handlers_list>()) {
+    , _cancellable_write_handlers_list(std::make_unique<cancellable_write_handlers_list>())
+    , _paxos_state_cache_size_observer(_db.local().get_config().paxos_state_cache_size.observe([] (uint32_t capacity) {
+        paxos::paxos_state::resize_state_cache(capacity);
+    })) {
     namespace sm = seastar::metrics;
     _metrics.add_group(storage_proxy_stats::COORDINATOR_STATS_CATEGORY, {
         sm::make_queue_length("current_throttled_writes", [this] { return _throttled_writes.size(); },
                        sm::description("number of currently throttled write requests")),
     });
+    _metrics.add_group(storage_proxy_stats::REPLICA_STATS_CATEGORY, {
+        sm::make_gauge("paxos_state_cache_partitions", [] { return paxos::paxos_state::state_cache_size(); },
+                       sm::description("number of partitions whose Paxos state is cached, see paxos_state_cache_size")),
+        sm::make_gauge("paxos_state_cache_memory_bytes", [] { return paxos::paxos_state::state_cache_memory_usage(); },
+                       sm::description("memory used by the cache of Paxos states")),
+    });
 
     slogger.trace("hinted DCs: {}", cfg.hinted_handoff_enabled.to_configuration_string());
     _hints_manager.register_metrics("hints_manager");
@@ -3622,12 +3907,13 @@ storage_proxy::mutate_atomically_result(std::vector<mutation> mutations, db::con
         service_permit _permit;
 
         const utils::UUID _batch_uuid;
+        const db_clock::time_point _written_at;
         const inet_address_vector_replica_set _batchlog_endpoints;
 
     public:
         context(storage_proxy & p, std::vector<mutation>&& mutations, lw_shared_ptr<cdc::operation_result_tracker>&& cdc_tracker, db::consistency_level cl, clock_type::time_point timeout, tracing::trace_state_ptr tr_state, service_permit permit)
                 : _p(p)
-                , _schema(_p.local_db().find_schema(db::system_keyspace::NAME, db::system_keyspace::BATCHLOG))
+                , _schema(_p.batchlog_schema())
                 , _ermp(_p.local_db().find_column_family(_schema->id()).get_effective_replication_map())
                 , _mutations(std::move(mutations))
                 , _cdc_tracker(std::move(cdc_tracker))
@@ -3637,6 +3923,7 @@ storage_proxy::mutate_atomically_result(std::vector<mutation> mutations, db::con
                 , _stats(p.get_stats())
                 , _permit(std::move(permit))
                 , _batch_uuid(utils::UUID_gen::get_time_UUID())
+                , _written_at(db_clock::now())
                 , _batchlog_endpoints(
                         [this]() -> inet_address_vector_replica_set {
                             auto local_addr = utils::fb_utilities::get_broadcast_address();
@@ -3668,16 +3955,16 @@ storage_proxy::mutate_atomically_result(std::vector<mutation> mutations, db::con
             }));
         }
         future<result<>> sync_write_to_batchlog() {
-            auto m = _p.do_get_batchlog_mutation_for(_schema, _mutations, _batch_uuid, netw::messaging_service::current_version, db_clock::now());
+            auto m = _p.do_get_batchlog_mutation_for(_schema, _mutations, _batch_uuid, netw::messaging_service::current_version, _written_at);
             tracing::trace(_trace_state, "Sending a batchlog write mutation");
             return send_batchlog_mutation(std::move(m));
         };
         future<> async_remove_from_batchlog() {
             // delete batch
-            auto key = partition_key::from_exploded(*_schema, {uuid_type->decompose(_batch_uuid)});
             auto now = service::client_state(service::client_state::internal_tag()).get_timestamp();
-            mutation m(_schema, key);
-            m.partition().apply_delete(*_schema, clustering_key_prefix::make_empty(), tombstone(now, gc_clock::now()));
+            auto m = _schema->cf_name() == db::system_keyspace::BATCHLOG_V2
+                    ? db::batchlog_manager::make_delete_mutation(_schema, this_shard_id(), _written_at, _batch_uuid, now)
+                    : db::batchlog_manager::make_legacy_delete_mutation(_schema, _batch_uuid, now);
 
             tracing::trace(_trace_state, "Sending a batchlog remove mutation");
             return send_batchlog_mutation(std::move(m), db::consistency_level::ANY).then_wrapped([] (future<result<>> f) {
@@ -3731,13 +4018,17 @@ storage_proxy::mutate_atomically_result(std::vector<mutation> mutations, db::con
     }).then_wrapped(std::move(cleanup));
 }
 
+schema_ptr storage_proxy::batchlog_schema() const {
+    // Nodes which don't know batchlog_v2 wouldn't be able to apply, or replay, its entries.
+    return local_db().find_schema(db::system_keyspace::NAME,
+            _features.batchlog_v2 ? db::system_keyspace::BATCHLOG_V2 : db::system_keyspace::BATCHLOG);
+}
+
 mutation storage_proxy::get_batchlog_mutation_for(const std::vector<mutation>& mutations, const utils::UUID& id, int32_t version, db_clock::time_point now) {
-    auto schema = local_db().find_schema(db::system_keyspace::NAME, db::system_keyspace::BATCHLOG);
-    return do_get_batchlog_mutation_for(std::move(schema), mutations, id, version, now);
+    return do_get_batchlog_mutation_for(batchlog_schema(), mutations, id, version, now);
 }
 
 mutation storage_proxy::do_get_batchlog_mutation_for(schema_ptr schema, const std::vector<mutation>& mutations, const utils::UUID& id, int32_t version, db_clock::time_point now) {
-    auto key = partition_key::from_singular(*schema, id);
     auto timestamp = api::new_timestamp();
     auto data = [&mutations] {
         std::vector<canonical_mutation> fm(mutations.begin(), mutations.end());
@@ -3748,6 +4039,18 @@ mutation storage_proxy::do_get_batchlog_mutation_for(schema_ptr schema, const st
         return to_bytes(out.linearize());
     }();
 
+    if (schema->cf_name() == db::system_keyspace::BATCHLOG_V2) {
+        auto key = partition_key::from_exploded(*schema, {
+                int32_type->decompose(int32_t(this_shard_id())),
+                timestamp_type->decompose(db::batchlog_manager::segment_of(now))});
+        auto ckey = clustering_key::from_exploded(*schema, {timestamp_type->decompose(now), uuid_type->decompose(id)});
+        mutation m(schema, key);
+        m.set_clustered_cell(ckey, to_bytes("version"), version, timestamp);
+        m.set_clustered_cell(ckey, to_bytes("data"), data_value(std::move(data)), timestamp);
+        return m;
+    }
+
+    auto key = partition_key::from_singular(*schema, id);
     mutation m(schema, key);
     m.set_cell(clustering_key_prefix::make_empty(), to_bytes("version"), version, timestamp);
     m.set_cell(clustering_key_prefix::make_empty(), to_bytes("written_at"), now, timestamp);
@@ -4286,6 +4589,9 @@ class data_read_resolver : public abstract_read_resolver {
         foreign_ptr<lw_shared_ptr<reconcilable_result>> result;
         bool reached_end = false;
         reply(gms::inet_address from_, foreign_ptr<lw_shared_ptr<reconcilable_result>> result_) : from(std::move(from_)), result(std::move(result_)) {}
+        future<> clear_gently() noexcept {
+            return utils::clear_gently(result);
+        }
     };
     struct version {
         gms::inet_address from;
@@ -4294,10 +4600,16 @@ class data_read_resolver : public abstract_read_resolver {
         bool reached_partition_end;
         version(gms::inet_address from_, std::optional<partition> par_, bool reached_end, bool reached_partition_end)
                 : from(std::move(from_)), par(std::move(par_)), reached_end(reached_end), reached_partition_end(reached_partition_end) {}
+        future<> clear_gently() noexcept {
+            return utils::clear_gently(par);
+        }
     };
     struct mutation_and_live_row_count {
         mutation mut;
         uint64_t live_row_count;
+        future<> clear_gently() noexcept {
+            return mut.clear_gently();
+        }
     };
 
     struct primary_key {
@@ -4360,7 +4672,7 @@ class data_read_resolver : public abstract_read_resolver {
     }
     void on_failure(exceptions::coordinator_exception_container&& ex) override {
         // we will not need them any more
-        _data_results.clear();
+        utils::dispose_gently(std::exchange(_data_results, {}));
     }
 
     virtual size_t response_count() const override {
@@ -4739,7 +5051,7 @@ class data_read_resolver : public abstract_read_resolver {
                 }
             }
         } else {
-            _diffs.clear();
+            utils::dispose_gently(std::exchange(_diffs, {}));
         }
 
         find_short_partitions(reconciled_partitions, versions, original_per_partition_limit, original_row_limit, original_partition_limit);
@@ -4760,6 +5072,8 @@ class data_read_resolver : public abstract_read_resolver {
             vec.emplace_back(partition(m_a_rc.live_row_count, freeze(m_a_rc.mut)));
             co_await coroutine::maybe_yield();
         }
+        utils::dispose_gently(std::move(reconciled_partitions));
+        utils::dispose_gently(std::move(versions));
 
         co_return reconcilable_result(_total_live_count, std::move(vec), _is_short_read);
     }
@@ -4906,9 +5220,13 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
     void make_data_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout, bool want_digest) {
         auto start = latency_clock::now();
+        bool track_load = track_replica_load();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            if (track_load) {
+                _proxy->register_replica_read_start(ep);
+            }
             // Waited on indirectly, shared_from_this keeps `this` alive
-            (void)make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
+            (void)make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep, start, track_load, exec = shared_from_this()] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
                 std::exception_ptr ex;
                 try {
                   if (!f.failed()) {
@@ -4917,7 +5235,12 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     resolver->add_data(ep, std::get<0>(std::move(v)));
                     ++_proxy->get_stats().data_read_completed.get_ep_stat(get_topology(), ep);
                     _used_targets.push_back(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    auto latency = latency_clock::now() - start;
+                    register_request_latency(latency);
+                    register_replica_latency(ep, latency);
+                    if (track_load) {
+                        on_replica_read_done(ep, latency);
+                    }
                     return;
                   } else {
                     ex = f.get_exception();
@@ -4926,6 +5249,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                   ex = std::current_exception();
                 }
 
+                if (track_load) {
+                    on_replica_read_done(ep, std::nullopt);
+                }
+
                 ++_proxy->get_stats().data_read_errors.get_ep_stat(get_topology(), ep);
                 resolver->error(ep, std::move(ex));
             });
@@ -4933,9 +5260,13 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
     void make_digest_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         auto start = latency_clock::now();
+        bool track_load = track_replica_load();
         for (const gms::inet_address& ep : boost::make_iterator_range(begin, end)) {
+            if (track_load) {
+                _proxy->register_replica_read_start(ep);
+            }
             // Waited on indirectly, shared_from_this keeps `this` alive
-            (void)make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start, exec = shared_from_this()] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> f) {
+            (void)make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start, track_load, exec = shared_from_this()] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> f) {
                 std::exception_ptr ex;
                 try {
                   if (!f.failed()) {
@@ -4944,7 +5275,12 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                     resolver->add_digest(ep, std::get<0>(v), std::get<1>(v), std::get<3>(std::move(v)));
                     ++_proxy->get_stats().digest_read_completed.get_ep_stat(get_topology(), ep);
                     _used_targets.push_back(ep);
-                    register_request_latency(latency_clock::now() - start);
+                    auto latency = latency_clock::now() - start;
+                    register_request_latency(latency);
+                    register_replica_latency(ep, latency);
+                    if (track_load) {
+                        on_replica_read_done(ep, latency);
+                    }
                     return;
                   } else {
                     ex = f.get_exception();
@@ -4953,6 +5289,10 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                   ex = std::current_exception();
                 }
 
+                if (track_load) {
+                    on_replica_read_done(ep, std::nullopt);
+                }
+
                 ++_proxy->get_stats().digest_read_errors.get_ep_stat(get_topology(), ep);
                 resolver->error(ep, std::move(ex));
             });
@@ -5194,6 +5534,30 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         _max_request_latency = std::max(_max_request_latency, d);
     }
 
+    void register_replica_latency(gms::inet_address ep, latency_clock::duration d) {
+        if (_proxy->get_db().local().get_config().speculative_retry_adaptive()) {
+            _proxy->register_replica_read_latency(ep, std::chrono::duration_cast<std::chrono::microseconds>(d));
+        }
+    }
+
+    bool track_replica_load() const {
+        return _proxy->get_db().local().get_config().load_aware_read_balancing();
+    }
+
+    // Called once for every read request sent while track_replica_load() was true,
+    // with the response time if the request succeeded.
+    void on_replica_read_done(gms::inet_address ep, std::optional<latency_clock::duration> latency) {
+        std::optional<std::chrono::microseconds> response_time;
+        if (latency) {
+            response_time = std::chrono::duration_cast<std::chrono::microseconds>(*latency);
+            if (fbu::is_me(ep)) {
+                // Local reads have no reply to carry the load, take it directly.
+                _proxy->register_replica_load(ep, _proxy->get_local_replica_load(*response_time), true);
+            }
+        }
+        _proxy->register_replica_read_done(ep, response_time);
+    }
+
     static constexpr latency_clock::duration NO_LATENCY{-1};
     latency_clock::duration _max_request_latency{NO_LATENCY};
 };
@@ -5225,11 +5589,39 @@ class always_speculating_read_executor : public abstract_read_executor {
 // this executor sends request to an additional replica after some time below timeout
 class speculating_read_executor : public abstract_read_executor {
     timer<storage_proxy::clock_type> _speculate_timer;
+    // Set when the speculation is limited by speculative_retry_max_extra_load.
+    bool _adaptive = false;
+    // Set when the speculation was moved forward because a chosen replica is slow.
+    bool _early = false;
+
+    // Whether one of the replicas chosen for the read is expected to respond after
+    // the speculation delay, while the extra replica is expected to respond before it.
+    // A replica which reported being overloaded is expected to be slow regardless
+    // of its past latencies.
+    bool expects_slow_replica(double percentile, std::chrono::microseconds delay) const {
+        if (!_proxy->is_replica_overloaded(_targets.back())
+                && std::any_of(_targets.begin(), _targets.end() - 1, [&] (const gms::inet_address& ep) { return _proxy->is_replica_overloaded(ep); })) {
+            return true;
+        }
+        auto extra = _proxy->get_replica_read_latency_percentile(_targets.back(), percentile);
+        if (!extra || *extra >= delay) {
+            return false;
+        }
+        return std::any_of(_targets.begin(), _targets.end() - 1, [&] (const gms::inet_address& ep) {
+            auto expected = _proxy->get_replica_read_latency_percentile(ep, percentile);
+            return expected && *expected > delay;
+        });
+    }
 public:
     using abstract_read_executor::abstract_read_executor;
     virtual void make_requests(digest_resolver_ptr resolver, storage_proxy::clock_type::time_point timeout) override {
         _speculate_timer.set_callback([this, resolver, timeout] {
             if (!resolver->is_completed()) { // at the time the callback runs request may be completed already
+                if (_adaptive && !_proxy->consume_speculative_read_budget()) {
+                    _proxy->get_stats().speculative_reads_over_budget++;
+                    return;
+                }
+                _proxy->get_stats().early_speculative_reads += int(_early);
                 resolver->add_wait_targets(1); // we send one more request so wait for it too
                 // FIXME: consider disabling for CL=*ONE
                 auto send_request = [&] (bool has_data) {
@@ -5245,9 +5637,19 @@ class speculating_read_executor : public abstract_read_executor {
             }
         });
         auto& sr = _schema->speculative_retry();
+        auto& cfg = _proxy->get_db().local().get_config();
         auto t = (sr.get_type() == speculative_retry::type::PERCENTILE) ?
-            std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()), std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2)) :
+            std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()), std::chrono::milliseconds(cfg.read_request_timeout_in_ms()/2)) :
             std::chrono::milliseconds(unsigned(sr.get_value()));
+        _adaptive = sr.get_type() == speculative_retry::type::PERCENTILE && cfg.speculative_retry_adaptive();
+        if (_adaptive) {
+            _proxy->replenish_speculative_read_budget(cfg.speculative_retry_max_extra_load());
+            _early = expects_slow_replica(sr.get_value(), t);
+            if (_early) {
+                tracing::trace(_trace_state, "Speculating right away, a replica is expected to respond after {}", t);
+                t = std::chrono::milliseconds(0);
+            }
+        }
         _speculate_timer.arm(t);
 
         // if CL + RR result in covering all replicas, getReadExecutor forces AlwaysSpeculating.  So we know
@@ -5291,6 +5693,189 @@ db::read_repair_decision storage_proxy::new_read_repair_decision(const schema& s
     return db::read_repair_decision::NONE;
 }
 
+void storage_proxy::register_replica_read_latency(gms::inet_address ep, std::chrono::microseconds latency) {
+    auto& rl = _replica_read_latencies[ep];
+    auto now = lowres_clock::now();
+    if (now - rl.last_decay > 1s) {
+        rl.last_decay = now;
+        rl.latencies *= 0.9; // decay values a little to give new data points more weight
+    }
+    rl.latencies.add(latency.count());
+}
+
+std::optional<std::chrono::microseconds> storage_proxy::get_replica_read_latency_percentile(gms::inet_address ep, double percentile) const {
+    auto it = _replica_read_latencies.find(ep);
+    if (it == _replica_read_latencies.end() || !it->second.latencies.count()) {
+        return std::nullopt;
+    }
+    return std::chrono::microseconds(it->second.latencies.percentile(percentile));
+}
+
+void storage_proxy::replenish_speculative_read_budget(double max_extra_load) {
+    // Allow short bursts, so that a replica which just got slow can be avoided
+    // by all of the reads in flight.
+    static constexpr double max_budget = 10;
+    _speculative_read_budget = std::min(_speculative_read_budget + max_extra_load, max_budget);
+}
+
+bool storage_proxy::consume_speculative_read_budget() {
+    if (_speculative_read_budget < 1) {
+        return false;
+    }
+    _speculative_read_budget -= 1;
+    return true;
+}
+
+// Weight of a new sample in the exponentially weighted averages of replica_feedback.
+static constexpr double replica_feedback_alpha = 0.1;
+
+static void update_ewma(double& avg, double sample) {
+    avg += replica_feedback_alpha * (sample - avg);
+}
+
+replica_load storage_proxy::get_local_replica_load(std::chrono::microseconds service_time) {
+    auto now = seastar::steady_clock_type::now();
+    if (now - _cpu_sample_time >= 100ms) {
+        auto busy_time = engine().total_busy_time();
+        if (_cpu_sample_time != seastar::steady_clock_type::time_point{}) {
+            _cpu_utilization = std::chrono::duration<double>(busy_time - _cpu_sample_busy_time) / std::chrono::duration<double>(now - _cpu_sample_time);
+        }
+        _cpu_sample_time = now;
+        _cpu_sample_busy_time = busy_time;
+    }
+    auto& db = _db.local();
+    const auto& dirty = db.dirty_memory_region_group();
+    return replica_load{
+        .queued_reads = uint32_t(std::min<uint64_t>(db.get_reader_concurrency_semaphore().get_stats().waiters, std::numeric_limits<uint32_t>::max())),
+        .service_time_us = uint32_t(std::min<int64_t>(service_time.count(), std::numeric_limits<uint32_t>::max())),
+        .dirty_memory = replica_load::to_ratio(double(dirty.unspooled_memory_used()) / std::max<size_t>(dirty.unspooled_throttle_threshold(), 1)),
+        .compaction_backlog = replica_load::to_ratio(db.get_compaction_manager().last_normalized_backlog() / compaction_controller::normalization_factor),
+        .cpu_utilization = replica_load::to_ratio(_cpu_utilization),
+    };
+}
+
+void storage_proxy::register_replica_load(gms::inet_address ep, const replica_load& load, bool is_read) {
+    auto& f = _replica_feedback[ep];
+    update_ewma(f.queued_reads, load.queued_reads);
+    if (is_read) {
+        update_ewma(f.service_time, load.service_time_us);
+        f.last_read_report = lowres_clock::now();
+    }
+    update_ewma(f.dirty_memory, replica_load::from_ratio(load.dirty_memory));
+    update_ewma(f.compaction_backlog, replica_load::from_ratio(load.compaction_backlog));
+    update_ewma(f.cpu_utilization, replica_load::from_ratio(load.cpu_utilization));
+    f.last_report = lowres_clock::now();
+}
+
+void storage_proxy::register_replica_read_start(gms::inet_address ep) {
+    ++_replica_feedback[ep].outstanding_reads;
+}
+
+void storage_proxy::register_replica_read_done(gms::inet_address ep, std::optional<std::chrono::microseconds> response_time) {
+    auto it = _replica_feedback.find(ep);
+    if (it == _replica_feedback.end()) {
+        return; // removed when the replica left the cluster
+    }
+    auto& f = it->second;
+    f.outstanding_reads -= f.outstanding_reads > 0;
+    if (response_time) {
+        update_ewma(f.response_time, response_time->count());
+    }
+}
+
+const storage_proxy::replica_feedback* storage_proxy::get_replica_feedback(gms::inet_address ep, bool for_reads) const {
+    // Feedback which is not refreshed is ignored, so that a replica which
+    // was avoided while busy gets requests, and reports its load, again.
+    static constexpr auto max_feedback_age = 1s;
+    auto it = _replica_feedback.find(ep);
+    if (it == _replica_feedback.end()) {
+        return nullptr;
+    }
+    auto last_report = for_reads ? it->second.last_read_report : it->second.last_report;
+    if (lowres_clock::now() - last_report > max_feedback_age) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+std::optional<double> storage_proxy::get_replica_read_score(gms::inet_address ep) const {
+    auto f = get_replica_feedback(ep, true);
+    if (!f) {
+        return std::nullopt;
+    }
+    // The queue the read is expected to find on the replica, including the
+    // reads this coordinator already sent there and which the replica did not
+    // report yet. Raising it to the third power makes a long queue dominate
+    // the small differences in service time between healthy replicas.
+    auto q = 1 + f->outstanding_reads + f->queued_reads;
+    return std::max(f->response_time - f->service_time, 0.0) + q * q * q * f->service_time;
+}
+
+bool storage_proxy::is_replica_overloaded(gms::inet_address ep) const {
+    auto f = get_replica_feedback(ep);
+    return f && f->cpu_utilization > 0.95 && f->queued_reads >= 1;
+}
+
+bool storage_proxy::is_replica_queueing_reads(gms::inet_address ep) const {
+    if (fbu::is_me(ep)) {
+        return _db.local().get_reader_concurrency_semaphore().get_stats().waiters > 0;
+    }
+    auto f = get_replica_feedback(ep, true);
+    return f && f->queued_reads >= 1;
+}
+
+double storage_proxy::get_replica_write_pressure(gms::inet_address ep) const {
+    // Flushes only speed up as dirty memory approaches the threshold (see
+    // flush_controller), so only its upper half counts as pressure.
+    auto f = get_replica_feedback(ep);
+    return f ? std::clamp((f->dirty_memory - 0.5) * 2, 0.0, 1.0) : 0.0;
+}
+
+void storage_proxy::avoid_busy_replicas(db::consistency_level cl, const locator::effective_replication_map& erm,
+        inet_address_vector_replica_set& selected, const inet_address_vector_replica_set& live_endpoints,
+        const inet_address_vector_replica_set& preferred_endpoints, std::optional<gms::inet_address>* extra) const {
+    // A replica is replaced only if another one is expected to respond this many
+    // times sooner, and by at least min_gain microseconds. Smaller differences are
+    // left to the proximity and cache hit rate based balancing.
+    static constexpr double busy_ratio = 2;
+    static constexpr double min_gain = 1000;
+
+    // Replicas without recent feedback are neither replaced nor used as replacements:
+    // the former is how a replica which was avoided gets reads again.
+    auto is_local = erm.get_topology().get_local_dc_filter();
+    for (auto& ep : selected) {
+        if (boost::range::find(preferred_endpoints, ep) != preferred_endpoints.end()) {
+            continue;
+        }
+        auto opt_score = get_replica_read_score(ep);
+        if (!opt_score) {
+            continue;
+        }
+        auto score = *opt_score;
+        auto best = ep;
+        auto best_score = score;
+        for (auto candidate : live_endpoints) {
+            if (boost::range::find(selected, candidate) != selected.end()
+                    || (db::is_datacenter_local(cl) && !is_local(candidate))) {
+                continue;
+            }
+            auto candidate_score = get_replica_read_score(candidate);
+            if (candidate_score && *candidate_score < best_score) {
+                best = candidate;
+                best_score = *candidate_score;
+            }
+        }
+        if (best != ep && score > busy_ratio * best_score && score - best_score > min_gain) {
+            slogger.trace("avoiding busy replica {} (score {}), reading from {} (score {}) instead", ep, score, best, best_score);
+            scheduling_group_get_specific<storage_proxy_stats::stats>(_stats_key).busy_replicas_avoided++;
+            if (extra && *extra == best) {
+                *extra = ep;
+            }
+            ep = best;
+        }
+    }
+}
+
 result<::shared_ptr<abstract_read_executor>> storage_proxy::get_read_executor(lw_shared_ptr<query::read_command> cmd,
         locator::effective_replication_map_ptr erm,
         schema_ptr schema,
@@ -5401,16 +5986,40 @@ storage_proxy::query_result_local(locator::effective_replication_map_ptr erm, sc
     cmd->slice.options.set_if<query::partition_slice::option::with_digest>(opts.request != query::result_request::only_result);
     if (auto shard_opt = dht::is_single_shard(erm->get_sharder(*s), *s, pr)) {
         auto shard = *shard_opt;
-        get_stats().replica_cross_shard_ops += shard != this_shard_id();
-        return _db.invoke_on(shard, _read_smp_service_group, [gs = global_schema_ptr(s), prv = dht::partition_range_vector({pr}) /* FIXME: pr is copied */, cmd, opts, timeout, gt = tracing::global_trace_state_ptr(std::move(trace_state)), rate_limit_info] (replica::database& db) mutable {
-            auto trace_state = gt.get();
-            tracing::trace(trace_state, "Start querying singular range {}", prv.front());
-            return db.query(gs, *cmd, opts, prv, trace_state, timeout, rate_limit_info).then([trace_state](std::tuple<lw_shared_ptr<query::result>, cache_temperature>&& f_ht) {
-                auto&& [f, ht] = f_ht;
-                tracing::trace(trace_state, "Querying is done");
-                return make_ready_future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>(rpc::tuple(make_foreign(std::move(f)), ht));
-            });
-        });
+        auto& hot = _db.local().get_hot_partition_replicas();
+        if (shard != this_shard_id()) {
+            auto& db = _db.local();
+            if (auto result = hot.query(s, *cmd, pr, opts)) {
+                tracing::trace(trace_state, "Queried singular range {} from the copy of the hot partition", pr);
+                auto hit_rate = db.find_column_family(s->id()).get_global_cache_hit_rate();
+                return make_ready_future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>(rpc::tuple(make_foreign(std::move(result)), hit_rate));
+            }
+        } else if (!hot.empty() && pr.is_singular() && pr.start()->value().has_key()) {
+            // The read came straight to the owner, e.g. from a shard-aware driver.
+            // Let a shard holding a copy of the hot partition serve it.
+            auto& dk = pr.start()->value().as_decorated_key();
+            auto copy_shard = hot.read_shard(s, dk);
+            if (copy_shard != this_shard_id()) {
+                // Keep the partition hot while its reads are served by the copies.
+                hot.on_read(s, dk);
+                ++get_stats().replica_cross_shard_ops;
+                return _db.invoke_on(copy_shard, _read_smp_service_group, [gs = global_schema_ptr(s), pr, cmd, opts] (replica::database& db) {
+                    schema_ptr s = gs;
+                    auto result = db.get_hot_partition_replicas().query(s, *cmd, pr, opts);
+                    auto hit_rate = result ? db.find_column_family(s->id()).get_global_cache_hit_rate() : cache_temperature();
+                    return make_ready_future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>(rpc::tuple(make_foreign(std::move(result)), hit_rate));
+                }).then([this, s, cmd, pr, opts, trace_state = std::move(trace_state), timeout, rate_limit_info, copy_shard]
+                        (rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature> r_ht) mutable {
+                    if (std::get<0>(r_ht)) {
+                        tracing::trace(trace_state, "Queried singular range {} from the copy of the hot partition on shard {}", pr, copy_shard);
+                        return make_ready_future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>(std::move(r_ht));
+                    }
+                    // The copy was dropped meanwhile.
+                    return query_singular_local(this_shard_id(), s, std::move(cmd), pr, opts, std::move(trace_state), timeout, rate_limit_info);
+                });
+            }
+        }
+        return query_singular_local(shard, std::move(s), std::move(cmd), pr, opts, std::move(trace_state), timeout, rate_limit_info);
     } else {
         // FIXME: adjust multishard_mutation_query to accept an smp_service_group and propagate it there
         tracing::trace(trace_state, "Start querying token range {}", pr);
@@ -5423,6 +6032,21 @@ storage_proxy::query_result_local(locator::effective_replication_map_ptr erm, sc
     }
 }
 
+future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>
+storage_proxy::query_singular_local(shard_id shard, schema_ptr s, lw_shared_ptr<query::read_command> cmd, const dht::partition_range& pr, query::result_options opts,
+                                    tracing::trace_state_ptr trace_state, storage_proxy::clock_type::time_point timeout, db::per_partition_rate_limit::info rate_limit_info) {
+    get_stats().replica_cross_shard_ops += shard != this_shard_id();
+    return _db.invoke_on(shard, _read_smp_service_group, [gs = global_schema_ptr(s), prv = dht::partition_range_vector({pr}) /* FIXME: pr is copied */, cmd, opts, timeout, gt = tracing::global_trace_state_ptr(std::move(trace_state)), rate_limit_info] (replica::database& db) mutable {
+        auto trace_state = gt.get();
+        tracing::trace(trace_state, "Start querying singular range {}", prv.front());
+        return db.query(gs, *cmd, opts, prv, trace_state, timeout, rate_limit_info).then([trace_state](std::tuple<lw_shared_ptr<query::result>, cache_temperature>&& f_ht) {
+            auto&& [f, ht] = f_ht;
+            tracing::trace(trace_state, "Querying is done");
+            return make_ready_future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>>(rpc::tuple(make_foreign(std::move(f)), ht));
+        });
+    });
+}
+
 void storage_proxy::handle_read_error(std::variant<exceptions::coordinator_exception_container, std::exception_ptr> failure, bool range) {
     // All errors are handled, it's OK to discard the result.
     (void)utils::result_try([&] () -> result<> {
@@ -5602,6 +6226,12 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
     if (_features.range_scan_data_variant) {
         cmd->slice.options.set<query::partition_slice::option::range_scan_data_variant>();
     }
+    // Range scans are where pages are large enough for the columnar encoding to pay off,
+    // as long as the page may hold enough rows.
+    const auto columnar_min_rows = _db.local().get_config().columnar_query_result_min_rows();
+    if (_features.columnar_query_result && columnar_min_rows && cmd->get_row_limit() >= columnar_min_rows) {
+        cmd->slice.options.set<query::partition_slice::option::columnar_result>();
+    }
 
     const auto preferred_replicas_for_range = [&preferred_replicas, &tm] (const dht::partition_range& r) {
         auto it = preferred_replicas.find(r.transform(std::mem_fn(&dht::ring_position::token)));
@@ -5784,7 +6414,18 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
         } else {
             cmd->set_row_limit(remaining_row_count);
             cmd->partition_limit = remaining_partition_count;
-            concurrency_factor *= 2;
+            if (!_db.local().get_config().range_scan_adaptive_concurrency()) {
+                concurrency_factor *= 2;
+            } else if (std::ranges::any_of(exec, [this] (const ::shared_ptr<abstract_read_executor>& e) {
+                        return std::ranges::any_of(e->used_targets(), [this] (gms::inet_address ep) { return is_replica_queueing_reads(ep); });
+                    })) {
+                // The replicas can't keep up with the ranges we already send them,
+                // more concurrency would only make the reads wait longer for their permits.
+                concurrency_factor = std::max(concurrency_factor / 2, 1);
+                slogger.trace("replicas queue reads, lowering range scan concurrency to {}", concurrency_factor);
+            } else {
+                concurrency_factor *= 2;
+            }
         }
     }
 }
@@ -5805,7 +6446,7 @@ storage_proxy::query_partition_key_range(lw_shared_ptr<query::read_command> cmd,
     query_ranges_to_vnodes_generator ranges_to_vnodes(erm->make_splitter(), schema, std::move(partition_ranges), merge_tokens);
 
     int result_rows_per_range = 0;
-    int concurrency_factor = 1;
+    int concurrency_factor = std::max<int>(1, std::min<uint32_t>(_db.local().get_config().range_scan_initial_concurrency(), std::numeric_limits<int>::max()));
 
     slogger.debug("Estimated result rows per range: {}; requested rows: {}, concurrent range requests: {}",
             result_rows_per_range, cmd->get_row_limit(), concurrency_factor);
@@ -5872,6 +6513,13 @@ storage_proxy::query_result(schema_ptr s,
     db::consistency_level cl,
     storage_proxy::coordinator_query_options query_options)
 {
+    if (query_options.cstate.get_workload_type() == service::client_state::workload_type::batch) {
+        cmd->batch_workload = query::is_batch_workload::yes;
+        if (_db.local().get_config().batch_workload_bypass_cache()) {
+            cmd->slice.options.set<query::partition_slice::option::bypass_cache>();
+        }
+    }
+
     if (slogger.is_enabled(logging::log_level::trace) || qlogger.is_enabled(logging::log_level::trace)) {
         static thread_local int next_id = 0;
         auto query_id = next_id++;
@@ -6256,7 +6904,12 @@ storage_proxy::filter_replicas_for_read(
     // There are nodes other than us in `live_endpoints`.
     auto& gossiper = remote().gossiper();
 
-    return db::filter_for_query(cl, erm, std::move(live_endpoints), preferred_endpoints, repair_decision, gossiper, extra, cf);
+    if (repair_decision != db::read_repair_decision::NONE || !_db.local().get_config().load_aware_read_balancing()) {
+        return db::filter_for_query(cl, erm, std::move(live_endpoints), preferred_endpoints, repair_decision, gossiper, extra, cf);
+    }
+    auto selected = db::filter_for_query(cl, erm, live_endpoints, preferred_endpoints, repair_decision, gossiper, extra, cf);
+    avoid_busy_replicas(cl, erm, selected, live_endpoints, preferred_endpoints, extra);
+    return selected;
 }
 
 inet_address_vector_replica_set
@@ -6303,6 +6956,20 @@ future<> storage_proxy::stop_remote() {
     _remote = nullptr;
 }
 
+future<foreign_ptr<lw_shared_ptr<query::result>>>
+storage_proxy::query_singular_locally(schema_ptr s, lw_shared_ptr<query::read_command> cmd, dht::partition_range pr,
+                                      clock_type::time_point timeout,
+                                      tracing::trace_state_ptr trace_state) {
+    auto erm = _db.local().find_column_family(s->id()).get_effective_replication_map();
+    auto replicas = erm->get_natural_endpoints_without_node_being_replaced(pr.start()->value().token());
+    if (std::ranges::find(replicas, utils::fb_utilities::get_broadcast_address()) == replicas.end()) {
+        co_return foreign_ptr<lw_shared_ptr<query::result>>();
+    }
+    auto [result, hit_rate] = co_await query_result_local(std::move(erm), std::move(s), std::move(cmd), pr, query::result_options::only_result(),
+            std::move(trace_state), timeout, db::per_partition_rate_limit::info{});
+    co_return std::move(result);
+}
+
 future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>>
 storage_proxy::query_mutations_locally(schema_ptr s, lw_shared_ptr<query::read_command> cmd, const dht::partition_range& pr,
                                        storage_proxy::clock_type::time_point timeout,
@@ -6424,15 +7091,16 @@ future<> storage_proxy::wait_for_hint_sync_point(const db::hints::sync_point spo
     std::vector<abort_source> sources;
     sources.resize(smp::count);
 
-    // If the timer is triggered, it will spawn a discarded future which triggers
-    // abort sources on all shards. We need to make sure that this future
-    // completes before exiting - we use a gate for that.
+    // If the timer is triggered, it starts triggering abort sources on all shards.
+    // We need to make sure that this completes before exiting - the future is kept,
+    // and waited for, under a gate.
     seastar::gate timer_gate;
+    std::optional<future<>> abort_on_timeout;
     seastar::timer<lowres_clock> t;
-    t.set_callback([&timer_gate, &sources] {
+    t.set_callback([&timer_gate, &sources, &abort_on_timeout] {
         // The gate is waited on at the end of the wait_for_hint_sync_point function
         // The gate is guaranteed to be open at this point
-        (void)with_gate(timer_gate, [&sources] {
+        abort_on_timeout = with_gate(timer_gate, [&sources] {
             return smp::invoke_on_all([&sources] {
                 unsigned shard = this_shard_id();
                 if (!sources[shard].abort_requested()) {
@@ -6473,9 +7141,11 @@ future<> storage_proxy::wait_for_hint_sync_point(const db::hints::sync_point spo
             wait_for(sp._hints_manager, spoint.regular_per_shard_rps),
             wait_for(sp._hints_for_views_manager, spoint.mv_per_shard_rps)
         ).discard_result();
-    }).finally([&t, &timer_gate] {
+    }).finally([&t, &timer_gate, &abort_on_timeout] {
         t.cancel();
-        return timer_gate.close();
+        return timer_gate.close().then([&abort_on_timeout] {
+            return abort_on_timeout ? std::move(*abort_on_timeout) : make_ready_future<>();
+        });
     });
 
     if (was_aborted) {
@@ -6491,6 +7161,8 @@ void storage_proxy::on_leave_cluster(const gms::inet_address& endpoint) {
     // Discarding these futures is safe. They're awaited by db::hints::manager::stop().
     (void) _hints_manager.drain_for(endpoint);
     (void) _hints_for_views_manager.drain_for(endpoint);
+    _replica_read_latencies.erase(endpoint);
+    _replica_feedback.erase(endpoint);
 }
 
 void storage_proxy::on_up(const gms::inet_address& endpoint) {};
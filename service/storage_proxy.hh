@@ -16,6 +16,7 @@
 #include <seastar/core/distributed.hh>
 #include <seastar/core/execution_stage.hh>
 #include <seastar/core/scheduling_specific.hh>
+#include <seastar/core/timer.hh>
 #include "db/read_repair_decision.hh"
 #include "db/write_type.hh"
 #include "db/hints/manager.hh"
@@ -24,12 +25,15 @@
 #include <seastar/core/metrics.hh>
 #include <seastar/rpc/rpc_types.hh>
 #include "storage_proxy_stats.hh"
+#include "replica_load.hh"
 #include "service_permit.hh"
 #include "query-result.hh"
 #include "cdc/stats.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include "db/hints/host_filter.hh"
 #include "utils/small_vector.hh"
+#include "utils/estimated_histogram.hh"
+#include "utils/updateable_value.hh"
 #include "service/endpoint_lifecycle_subscriber.hh"
 #include <seastar/core/circular_buffer.hh>
 #include "exceptions/coordinator_result.hh"
@@ -42,6 +46,7 @@ class frozen_mutation_and_schema;
 class frozen_mutation;
 class cache_temperature;
 class query_ranges_to_vnodes_generator;
+class storage_proxy_test;
 
 namespace seastar::rpc {
 
@@ -276,10 +281,48 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     db::view::node_update_backlog& _max_view_update_backlog;
     std::unordered_map<gms::inet_address, view_update_backlog_timestamped> _view_update_backlogs;
 
+    // Recent read latencies of each replica, in microseconds, for the adaptive
+    // speculative retry (see speculative_retry_adaptive). Decayed every second,
+    // so that a replica which recovers from a slow period is trusted again soon.
+    struct replica_read_latency {
+        utils::estimated_histogram latencies;
+        lowres_clock::time_point last_decay = lowres_clock::now();
+    };
+    std::unordered_map<gms::inet_address, replica_read_latency> _replica_read_latencies;
+    // Speculative reads the adaptive speculative retry may still send. Every read
+    // adds speculative_retry_max_extra_load to it, every speculative read takes 1.
+    double _speculative_read_budget = 0;
+
+    // What the coordinator knows about the load of each replica, for the load
+    // aware decisions (see load_aware_read_balancing, speculative_retry_adaptive
+    // and load_aware_write_throttling). Averages are exponentially weighted,
+    // times are in microseconds.
+    struct replica_feedback {
+        // Reported by the replica with its read and write replies.
+        double queued_reads = 0;
+        double service_time = 0; // reads only
+        double dirty_memory = 0;
+        double compaction_backlog = 0;
+        double cpu_utilization = 0;
+        lowres_clock::time_point last_report;
+        lowres_clock::time_point last_read_report;
+        // Measured by the coordinator.
+        double response_time = 0;
+        uint32_t outstanding_reads = 0;
+    };
+    std::unordered_map<gms::inet_address, replica_feedback> _replica_feedback;
+    // For the cpu_utilization of replica_load.
+    seastar::steady_clock_type::time_point _cpu_sample_time;
+    seastar::steady_clock_type::duration _cpu_sample_busy_time{};
+    double _cpu_utilization = 0;
+
     //NOTICE(sarna): This opaque pointer is here just to avoid moving write handler class definitions from .cc to .hh. It's slow path.
     class cancellable_write_handlers_list;
     std::unique_ptr<cancellable_write_handlers_list> _cancellable_write_handlers_list;
 
+    // Applies changes of paxos_state_cache_size to the cache of paxos states of this shard.
+    utils::observer<uint32_t> _paxos_state_cache_size_observer;
+
     /* This is a pointer to the shard-local part of the sharded cdc_service:
      * storage_proxy needs access to cdc_service to augument mutations.
      *
@@ -337,6 +380,36 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     inet_address_vector_replica_set filter_replicas_for_read(db::consistency_level, const locator::effective_replication_map&, const inet_address_vector_replica_set& live_endpoints, const inet_address_vector_replica_set& preferred_endpoints, replica::column_family*) const;
     bool is_alive(const gms::inet_address&) const;
     db::read_repair_decision new_read_repair_decision(const schema& s);
+    void register_replica_read_latency(gms::inet_address ep, std::chrono::microseconds latency);
+    // Returns nullopt if no recent reads completed on the replica.
+    std::optional<std::chrono::microseconds> get_replica_read_latency_percentile(gms::inet_address ep, double percentile) const;
+    // Adds the share of a single read to the speculative read budget.
+    void replenish_speculative_read_budget(double max_extra_load);
+    // Takes one speculative read out of the budget, returns false if there is none left.
+    bool consume_speculative_read_budget();
+    // The load of this shard, to be sent back with the reply to a request which took service_time.
+    replica_load get_local_replica_load(std::chrono::microseconds service_time);
+    void register_replica_load(gms::inet_address ep, const replica_load& load, bool is_read);
+    void register_replica_read_start(gms::inet_address ep);
+    void register_replica_read_done(gms::inet_address ep, std::optional<std::chrono::microseconds> response_time);
+    // Returns the feedback of the replica, or nullptr if it did not report its load recently,
+    // with a read reply if for_reads.
+    const replica_feedback* get_replica_feedback(gms::inet_address ep, bool for_reads = false) const;
+    // Expected time, in microseconds, a new read sent to the replica would take, or
+    // nullopt if not known. Lower is better. Follows the replica ranking of C3
+    // (Suresh et al., NSDI'15).
+    std::optional<double> get_replica_read_score(gms::inet_address ep) const;
+    // Whether the replica reported that its CPU is saturated while reads queue up.
+    bool is_replica_overloaded(gms::inet_address ep) const;
+    // Whether reads queue up on the replica's reader concurrency semaphore.
+    bool is_replica_queueing_reads(gms::inet_address ep) const;
+    // How close the replica is to blocking writes because of dirty memory, from 0 to 1.
+    double get_replica_write_pressure(gms::inet_address ep) const;
+    // Replaces busy replicas in `selected` with other replicas from `live_endpoints`
+    // which are expected to respond much sooner.
+    void avoid_busy_replicas(db::consistency_level cl, const locator::effective_replication_map& erm,
+            inet_address_vector_replica_set& selected, const inet_address_vector_replica_set& live_endpoints,
+            const inet_address_vector_replica_set& preferred_endpoints, std::optional<gms::inet_address>* extra) const;
     result<::shared_ptr<abstract_read_executor>> get_read_executor(lw_shared_ptr<query::read_command> cmd,
             locator::effective_replication_map_ptr ermp,
             schema_ptr schema,
@@ -355,6 +428,15 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             tracing::trace_state_ptr trace_state,
             clock_type::time_point timeout,
             db::per_partition_rate_limit::info rate_limit_info);
+    // Reads a singular range on the given shard, which owns it.
+    future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> query_singular_local(
+            shard_id shard,
+            schema_ptr,
+            lw_shared_ptr<query::read_command> cmd, const dht::partition_range& pr,
+            query::result_options opts,
+            tracing::trace_state_ptr trace_state,
+            clock_type::time_point timeout,
+            db::per_partition_rate_limit::info rate_limit_info);
     future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature, std::optional<full_position>>> query_result_local_digest(
             locator::effective_replication_map_ptr,
             schema_ptr,
@@ -517,6 +599,8 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     template <typename T>
     future<T> apply_fence(future<T> future, fencing_token fence, gms::inet_address caller_address) const;
 
+    // system.batchlog_v2 once the whole cluster supports it, system.batchlog before.
+    schema_ptr batchlog_schema() const;
     mutation do_get_batchlog_mutation_for(schema_ptr schema, const std::vector<mutation>& mutations, const utils::UUID& id, int32_t version, db_clock::time_point now);
 public:
     // Applies mutation on this node.
@@ -649,6 +733,18 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
         clock_type::time_point timeout,
         tracing::trace_state_ptr trace_state = nullptr);
 
+    /*
+     * Reads a single partition from this node's own replica, without going
+     * through the coordinator read path (no digest reads, read repair or
+     * speculative retries), which is enough for a CL=ONE read. Resolves to a
+     * null result if this node is not a natural replica of the partition,
+     * in which case the caller should use query().
+     */
+    future<foreign_ptr<lw_shared_ptr<query::result>>> query_singular_locally(
+        schema_ptr, lw_shared_ptr<query::read_command> cmd, dht::partition_range,
+        clock_type::time_point timeout,
+        tracing::trace_state_ptr trace_state = nullptr);
+
     future<bool> cas(schema_ptr schema, shared_ptr<cas_request> request, lw_shared_ptr<query::read_command> cmd,
             dht::partition_range_vector partition_ranges, coordinator_query_options query_options,
             db::consistency_level cl_for_paxos, db::consistency_level cl_for_learn,
@@ -708,6 +804,7 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     friend class shared_mutation;
     friend class hint_mutation;
     friend class cas_mutation;
+    friend class ::storage_proxy_test;
 };
 
 }
@@ -100,7 +100,9 @@ struct write_stats {
     uint64_t background_writes = 0; // client no longer waits for the write
     uint64_t throttled_writes = 0; // total number of writes ever delayed due to throttling
     uint64_t throttled_base_writes = 0; // current number of base writes delayed due to view update backlog
+    uint64_t writes_throttled_by_replica_load = 0; // total number of writes delayed due to replica write pressure
     uint64_t background_writes_failed = 0;
+    uint64_t background_writes_released = 0; // total number of writes released after CL, see background_write_timeout_in_ms
     uint64_t writes_failed_due_to_too_many_in_flight_hints = 0;
 
     uint64_t cas_write_unfinished_commit = 0;
@@ -152,6 +154,11 @@ struct stats : public write_stats {
     uint64_t forwarded_mutations = 0;
     uint64_t forwarding_errors = 0;
 
+    // number of MUTATION_BATCH messages sent as a coordinator, and of the
+    // mutations they carried
+    uint64_t write_batches = 0;
+    uint64_t batched_writes = 0;
+
     // number of read requests received as a replica
     uint64_t replica_data_reads = 0;
     uint64_t replica_digest_reads = 0;
@@ -168,6 +175,9 @@ struct stats : public write_stats {
     uint64_t read_retries = 0; // read is retried with new limit
     uint64_t speculative_digest_reads = 0;
     uint64_t speculative_data_reads = 0;
+    uint64_t early_speculative_reads = 0;
+    uint64_t speculative_reads_over_budget = 0;
+    uint64_t busy_replicas_avoided = 0;
 
     uint64_t cas_read_unfinished_commit = 0;
     uint64_t cas_foreground = 0;
@@ -856,6 +856,15 @@ class topology_coordinator {
 
     tablet_allocator& _tablet_allocator;
 
+    // Tablet stats last reported by each node, and when they were collected.
+    struct reported_load_stats {
+        locator::load_stats stats;
+        std::chrono::steady_clock::time_point time;
+    };
+    std::unordered_map<locator::host_id, reported_load_stats> _reported_load_stats;
+    // Tablet load derived from _reported_load_stats, given to the load balancer.
+    tablet_load_map_ptr _tablet_load;
+
     std::chrono::milliseconds _ring_delay;
 
     using drop_guard_and_retake = bool_class<class retake_guard_tag>;
@@ -1308,6 +1317,91 @@ class topology_coordinator {
         reason += ::format("published CDC generation with ID {}, ", gen_id);
     }
 
+    // Collects tablet stats from all normal nodes, and computes the load of each tablet,
+    // averaged over its replicas. Request rates are computed from the counters reported
+    // by the previous refresh. Nodes which fail to report keep their previous stats.
+    future<> refresh_tablet_load() {
+        auto hosts = boost::copy_range<std::vector<raft::server_id>>(_topo_sm._topology.normal_nodes | boost::adaptors::map_keys);
+        std::unordered_map<locator::host_id, reported_load_stats> reported;
+        co_await coroutine::parallel_for_each(hosts, [&] (raft::server_id id) -> future<> {
+            auto host = locator::host_id(id.uuid());
+            try {
+                auto stats = co_await ser::storage_service_rpc_verbs::send_tablet_load_stats(&_messaging, netw::msg_addr(id2ip(host)), _as, id);
+                reported.emplace(host, reported_load_stats{std::move(stats), std::chrono::steady_clock::now()});
+            } catch (...) {
+                slogger.warn("raft topology: failed to collect tablet load stats from {}: {}", host, std::current_exception());
+            }
+        });
+
+        struct tablet_load_sum {
+            tablet_load load;
+            size_t replicas = 0;
+        };
+        std::unordered_map<locator::global_tablet_id, tablet_load_sum> sums;
+        auto counter_delta = [] (uint64_t current, uint64_t previous) {
+            // The counters restart when a node restarts or gets the tablet again.
+            return current >= previous ? current - previous : current;
+        };
+        for (auto&& [host, r] : reported) {
+            auto prev = _reported_load_stats.find(host);
+            for (auto&& [tablet, stats] : r.stats.tablets) {
+                auto& sum = sums[tablet];
+                sum.load.size_in_bytes += stats.size_in_bytes;
+                sum.replicas += 1;
+                if (prev == _reported_load_stats.end()) {
+                    continue;
+                }
+                auto prev_stats = prev->second.stats.tablets.find(tablet);
+                auto secs = std::chrono::duration<double>(r.time - prev->second.time).count();
+                if (prev_stats != prev->second.stats.tablets.end() && secs > 0) {
+                    sum.load.read_rate += counter_delta(stats.reads, prev_stats->second.reads) / secs;
+                    sum.load.write_rate += counter_delta(stats.writes, prev_stats->second.writes) / secs;
+                }
+            }
+            co_await coroutine::maybe_yield();
+        }
+        for (auto&& [host, r] : _reported_load_stats) {
+            if (!reported.contains(host) && _topo_sm._topology.normal_nodes.contains(raft::server_id(host.uuid()))) {
+                reported.emplace(host, std::move(r));
+            }
+        }
+
+        auto load = make_lw_shared<tablet_load_map>();
+        for (auto&& [tablet, sum] : sums) {
+            load->emplace(tablet, tablet_load{
+                .size_in_bytes = sum.load.size_in_bytes / sum.replicas,
+                .read_rate = sum.load.read_rate / sum.replicas,
+                .write_rate = sum.load.write_rate / sum.replicas,
+            });
+        }
+        _reported_load_stats = std::move(reported);
+        _tablet_load = std::move(load);
+    }
+
+    future<> tablet_load_refresher_fiber() {
+        if (!_db.get_config().check_experimental(db::experimental_features_t::feature::TABLETS)) {
+            co_return;
+        }
+        slogger.trace("raft topology: start tablet load refresher fiber");
+
+        while (!_as.abort_requested()) {
+            if (_db.features().tablet_load_stats) {
+                try {
+                    co_await refresh_tablet_load();
+                    // Let the coordinator evaluate tablet balance with the new load.
+                    _topo_sm.event.broadcast();
+                } catch (...) {
+                    slogger.warn("raft topology: tablet load refresher fiber got error {}", std::current_exception());
+                }
+            }
+            try {
+                co_await seastar::sleep_abortable(std::chrono::seconds(_db.get_config().tablet_load_stats_refresh_interval_in_seconds()), _as);
+            } catch (...) {
+                slogger.debug("raft topology: tablet load refresher fiber sleep failed: {}", std::current_exception());
+            }
+        }
+    }
+
     // The background fiber of the topology coordinator that continually publishes committed yet unpublished
     // CDC generations. Every generation is published in a separate group 0 operation.
     //
@@ -1555,6 +1649,76 @@ class topology_coordinator {
         }
     }
 
+    future<> generate_resize_updates(std::vector<canonical_mutation>& out, const group0_guard& guard, const migration_plan& plan) {
+        for (auto&& [table, decision] : plan.resize_plan().resize) {
+            co_await coroutine::maybe_yield();
+            auto s = _db.find_schema(table);
+            out.emplace_back(
+                replica::tablet_mutation_builder(guard.write_timestamp(), s->ks_name(), table)
+                    .set_resize_decision(decision)
+                    .build());
+        }
+    }
+
+    // Returns true iff all nodes which host replicas of the table reported that
+    // their storage is split for the table's pending split decision.
+    bool is_split_ready(table_id table, const locator::tablet_map& tmap) const {
+        std::unordered_set<locator::host_id> hosts;
+        for (auto&& info : tmap.tablets()) {
+            for (auto&& r : info.replicas) {
+                hosts.insert(r.host);
+            }
+        }
+        return std::ranges::all_of(hosts, [&] (locator::host_id host) {
+            auto reported = _reported_load_stats.find(host);
+            if (reported == _reported_load_stats.end()) {
+                return false;
+            }
+            auto stats = reported->second.stats.tables.find(table);
+            return stats != reported->second.stats.tables.end()
+                    && stats->second.split_ready_seq_number == tmap.get_resize_decision().sequence_number;
+        });
+    }
+
+    // Replaces the tablet maps of tables whose pending resize can be finalized with maps which
+    // have the new tablet count. Only tables without tablet transitions are resized.
+    // Returns true iff any table was resized.
+    future<bool> generate_resize_finalization_updates(std::vector<canonical_mutation>& out, const group0_guard& guard) {
+        std::unordered_set<table_id> resized_tables;
+        auto tm = get_token_metadata_ptr();
+        for (auto&& [table, tmap] : tm->tablets().all_tables()) {
+            auto& decision = tmap.get_resize_decision();
+            if (!decision.split_or_merge() || !tmap.transitions().empty()) {
+                continue;
+            }
+            std::optional<locator::tablet_map> new_tmap;
+            if (decision.way == locator::resize_decision::way_type::split && is_split_ready(table, tmap)) {
+                new_tmap = tmap.split();
+            } else if (decision.way == locator::resize_decision::way_type::merge && tmap.can_merge()) {
+                new_tmap = tmap.merge();
+            }
+            if (!new_tmap) {
+                continue;
+            }
+            auto s = _db.find_schema(table);
+            slogger.info("raft topology: Finalizing {} of table {}.{} from {} to {} tablets", locator::resize_decision_way_to_string(decision.way),
+                         s->ks_name(), s->cf_name(), tmap.tablet_count(), new_tmap->tablet_count());
+            out.emplace_back(co_await replica::tablet_map_to_mutation(*new_tmap, table, s->ks_name(), s->cf_name(), guard.write_timestamp()));
+            resized_tables.insert(table);
+        }
+        if (_tablet_load && !resized_tables.empty()) {
+            // Tablet ids of resized tables change meaning, forget their load until it's reported again.
+            auto load = make_lw_shared<tablet_load_map>();
+            for (auto&& [tablet, l] : *_tablet_load) {
+                if (!resized_tables.contains(tablet.table)) {
+                    load->emplace(tablet, l);
+                }
+            }
+            _tablet_load = std::move(load);
+        }
+        co_return !resized_tables.empty();
+    }
+
     // When "drain" is true, we migrate tablets only as long as there are nodes to drain
     // and then change the transition state to write_both_read_old. Also, while draining,
     // we ignore pending topology requests which normally interrupt load balancing.
@@ -1675,11 +1839,19 @@ class topology_coordinator {
                 on_internal_error(slogger, "should_preempt_balancing() retook the guard");
             }
         }
+        if (!preempt && !drain) {
+            // The new tablet maps overwrite whole tablet metadata of the resized tables,
+            // so new migrations are planned only once the resize is committed.
+            preempt = co_await generate_resize_finalization_updates(updates, guard);
+        }
         if (!preempt) {
-            auto plan = co_await _tablet_allocator.balance_tablets(get_token_metadata_ptr());
+            auto plan = co_await _tablet_allocator.balance_tablets(get_token_metadata_ptr(), _tablet_load);
             if (!drain || plan.has_nodes_to_drain()) {
                 co_await generate_migration_updates(updates, guard, plan);
             }
+            if (!drain) {
+                co_await generate_resize_updates(updates, guard, plan);
+            }
         }
 
         // The updates have to be executed under the same guard which was used to read tablet metadata
@@ -2364,16 +2536,34 @@ class topology_coordinator {
 future<bool> topology_coordinator::maybe_start_tablet_migration(group0_guard guard) {
     slogger.debug("raft topology: Evaluating tablet balance");
 
+    std::vector<canonical_mutation> updates;
+    if (co_await generate_resize_finalization_updates(updates, guard)) {
+        updates.emplace_back(
+            topology_mutation_builder(guard.write_timestamp())
+                .set_version(_topo_sm._topology.version + 1)
+                .build());
+        co_await update_topology_state(std::move(guard), std::move(updates), "Finalizing tablet resize");
+        co_return true;
+    }
+
     auto tm = get_token_metadata_ptr();
-    auto plan = co_await _tablet_allocator.balance_tablets(tm);
+    auto plan = co_await _tablet_allocator.balance_tablets(tm, _tablet_load);
     if (plan.empty()) {
+        if (!plan.resize_plan().empty()) {
+            co_await generate_resize_updates(updates, guard, plan);
+            updates.emplace_back(
+                topology_mutation_builder(guard.write_timestamp())
+                    .set_version(_topo_sm._topology.version + 1)
+                    .build());
+            co_await update_topology_state(std::move(guard), std::move(updates), "Updating tablet resize decisions");
+            co_return true;
+        }
         slogger.debug("raft topology: Tablets are balanced");
         co_return false;
     }
 
-    std::vector<canonical_mutation> updates;
-
     co_await generate_migration_updates(updates, guard, plan);
+    co_await generate_resize_updates(updates, guard, plan);
 
     updates.emplace_back(
         topology_mutation_builder(guard.write_timestamp())
@@ -2424,6 +2614,7 @@ future<> topology_coordinator::run() {
 
     co_await fence_previous_coordinator();
     auto cdc_generation_publisher = cdc_generation_publisher_fiber();
+    auto tablet_load_refresher = tablet_load_refresher_fiber();
 
     while (!_as.abort_requested()) {
         bool sleep = false;
@@ -2462,6 +2653,7 @@ future<> topology_coordinator::run() {
 
     co_await _async_gate.close();
     co_await std::move(cdc_generation_publisher);
+    co_await std::move(tablet_load_refresher);
 }
 
 future<> storage_service::raft_state_monitor_fiber(raft::server& raft, sharded<db::system_distributed_keyspace>& sys_dist_ks) {
@@ -6319,6 +6511,19 @@ future<> storage_service::cleanup_tablet(locator::global_tablet_id tablet) {
     });
 }
 
+future<locator::load_stats> storage_service::load_stats_for_tablets() {
+    return _db.map_reduce0([] (replica::database& db) {
+        locator::load_stats stats;
+        db.get_tables_metadata().for_each_table([&] (table_id, lw_shared_ptr<replica::table> table) {
+            table->collect_tablet_load_stats(stats);
+        });
+        return stats;
+    }, locator::load_stats{}, [] (locator::load_stats a, const locator::load_stats& b) {
+        a += b;
+        return a;
+    });
+}
+
 future<join_node_request_result> storage_service::join_node_request_handler(join_node_request_params params) {
     join_node_request_result result;
     slogger.info("raft topology: received request to join from host_id: {}", params.host_id);
@@ -6655,6 +6860,11 @@ void storage_service::init_messaging_service(sharded<db::system_distributed_keys
             return ss.cleanup_tablet(tablet);
         });
     });
+    ser::storage_service_rpc_verbs::register_tablet_load_stats(&_messaging.local(), [handle_raft_rpc] (raft::server_id dst_id) {
+        return handle_raft_rpc(dst_id, [] (auto& ss) {
+            return ss.load_stats_for_tablets();
+        });
+    });
     if (raft_topology_change_enabled) {
         ser::join_node_rpc_verbs::register_join_node_request(&_messaging.local(), [handle_raft_rpc] (raft::server_id dst_id, service::join_node_request_params params) {
             return handle_raft_rpc(dst_id, [params = std::move(params)] (auto& ss) mutable {
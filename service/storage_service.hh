@@ -166,6 +166,8 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
                                  std::function<future<>(locator::tablet_metadata_guard&)> op);
     future<> stream_tablet(locator::global_tablet_id);
     future<> cleanup_tablet(locator::global_tablet_id);
+    // Collects the load of tablet replicas hosted by this node.
+    future<locator::load_stats> load_stats_for_tablets();
     inet_address host2ip(locator::host_id);
 public:
     storage_service(abort_source& as, distributed<replica::database>& db,
@@ -15,7 +15,6 @@
 #include "utils/error_injection.hh"
 #include "utils/stall_free.hh"
 #include "db/config.hh"
-#include "locator/load_sketch.hh"
 #include "utils/div_ceil.hh"
 
 using namespace locator;
@@ -117,6 +116,14 @@ class load_balancer_stats_manager {
 /// per-shard load. If we achieve balance according to this metric, and then rebalance the nodes internally,
 /// we will achieve global balance on all shards in the cluster.
 ///
+/// When tablet load reported by replicas is available, tablets are not counted equally. Each one weighs
+/// the average of three terms: 1, its size relative to the average tablet size, and its request rate
+/// relative to the average request rate. So the average tablet weighs 1, and a hot or big tablet weighs
+/// more than a cold or small one, but not more than what its data and requests justify. Tablets which
+/// were not reported weigh 1. When picking a tablet to move, the heaviest one which doesn't invert the
+/// load between the source and the target is preferred. Nodes whose loads differ by less than
+/// min_relative_imbalance are considered balanced.
+///
 /// The reason why we focus on nodes first before rebalancing them internally is that this results
 /// in less tablet movements than looking at shards only.
 ///
@@ -161,17 +168,30 @@ class load_balancer_stats_manager {
 /// to parallelize execution. This will be addressed in the future by keeping the data structures
 /// valid across calls and only recalculating them when starting a new round with a new token metadata version.
 ///
+/// Parameters of tablet resize decisions, see load_balancer::make_resize_plan().
+struct resize_config {
+    bool enabled = false;
+    // 0 disables the respective criterion.
+    uint64_t target_tablet_size = 0;
+    double target_tablet_request_rate = 0;
+    // Tables are never merged below their initial tablet count.
+    std::unordered_map<table_id, size_t> min_tablet_count;
+};
+
 class load_balancer {
     using global_shard_id = tablet_replica;
     using shard_id = seastar::shard_id;
 
     // Represents metric for per-node load which we want to equalize between nodes.
-    // It's an average per-shard load in terms of tablet count.
+    // It's an average per-shard load in terms of tablet weight, see tablet_weight().
     using load_type = double;
 
     struct shard_load {
         size_t tablet_count = 0;
 
+        // Sum of weights of tablets on this shard.
+        load_type load = 0;
+
         // Number of tablets which are streamed from this shard.
         size_t streaming_read_load = 0;
 
@@ -191,34 +211,37 @@ class load_balancer {
         uint64_t shard_count = 0;
         uint64_t tablet_count = 0;
 
+        // Sum of weights of tablets on this node.
+        load_type load = 0;
+
         // The average shard load on this node.
         load_type avg_load = 0;
 
         std::vector<shard_id> shards_by_load; // heap which tracks most-loaded shards using shards_by_load_cmp().
         std::vector<shard_load> shards; // Indexed by shard_id to which a given shard_load corresponds.
 
-        std::optional<locator::load_sketch> target_load_sketch;
-
-        future<load_sketch&> get_load_sketch(const token_metadata_ptr& tm) {
-            if (!target_load_sketch) {
-                target_load_sketch.emplace(tm);
-                co_await target_load_sketch->populate(id);
-            }
-            co_return *target_load_sketch;
+        // Call when load changes.
+        void update() {
+            avg_load = get_avg_load(load);
         }
 
-        // Call when tablet_count changes.
-        void update() {
-            avg_load = get_avg_load(tablet_count);
+        load_type get_avg_load(load_type l) const {
+            return l / shard_count;
         }
 
-        load_type get_avg_load(uint64_t tablets) const {
-            return double(tablets) / shard_count;
+        shard_id least_loaded_shard() const {
+            shard_id best = 0;
+            for (shard_id s = 1; s < shards.size(); ++s) {
+                if (shards[s].load < shards[best].load) {
+                    best = s;
+                }
+            }
+            return best;
         }
 
         auto shards_by_load_cmp() {
             return [this] (const auto& a, const auto& b) {
-                return shards[a].tablet_count < shards[b].tablet_count;
+                return shards[a].load < shards[b].load;
             };
         }
 
@@ -256,8 +279,66 @@ class load_balancer {
     const size_t max_read_streaming_load = 4;
 
     token_metadata_ptr _tm;
+    tablet_load_map_ptr _tablet_load;
     load_balancer_stats_manager& _stats;
+    const resize_config& _resize_config;
+
+    // Average size and request rate of tablets in _tablet_load.
+    double _avg_tablet_size = 0;
+    double _avg_tablet_rate = 0;
+
+    // With reported tablet load, node loads are sums of real weights which are
+    // practically never equal, and which change with every refresh of the load.
+    // Nodes whose loads differ by less than this fraction of the most loaded
+    // one are considered balanced, so that tablets don't keep moving back and
+    // forth over noise in the reported load.
+    static constexpr load_type min_relative_imbalance = 0.1;
 private:
+    bool is_balanced(load_type min_load, load_type max_load) const {
+        if (!_tablet_load) {
+            return max_load == min_load;
+        }
+        return max_load - min_load <= max_load * min_relative_imbalance;
+    }
+
+    // The weight of a tablet relative to the average tablet, which weighs 1.
+    load_type tablet_weight(global_tablet_id tablet) const {
+        if (!_tablet_load) {
+            return 1;
+        }
+        auto it = _tablet_load->find(tablet);
+        if (it == _tablet_load->end()) {
+            return 1;
+        }
+        auto& l = it->second;
+        load_type size_weight = _avg_tablet_size > 0 ? l.size_in_bytes / _avg_tablet_size : 1;
+        load_type rate_weight = _avg_tablet_rate > 0 ? (l.read_rate + l.write_rate) / _avg_tablet_rate : 1;
+        return (1 + size_weight + rate_weight) / 3;
+    }
+
+    // Picks the candidate tablet to move from src to dst, see the class comment.
+    global_tablet_id pick_candidate(const shard_load& src_shard, const node_load& src, const node_load* dst) const {
+        if (!_tablet_load || !dst) {
+            return *src_shard.candidates.begin();
+        }
+        std::optional<global_tablet_id> best_fit;
+        load_type best_fit_weight = 0;
+        global_tablet_id lightest = *src_shard.candidates.begin();
+        load_type lightest_weight = tablet_weight(lightest);
+        for (auto&& tablet : src_shard.candidates) {
+            auto w = tablet_weight(tablet);
+            if (w < lightest_weight) {
+                lightest = tablet;
+                lightest_weight = w;
+            }
+            if (w > best_fit_weight && src.get_avg_load(src.load - w) >= dst->get_avg_load(dst->load + w)) {
+                best_fit = tablet;
+                best_fit_weight = w;
+            }
+        }
+        return best_fit.value_or(lightest);
+    }
+
     tablet_replica_set get_replicas_for_tablet_load(const tablet_info& ti, const tablet_transition_info* trinfo) const {
         // We reflect migrations in the load as if they already happened,
         // optimistically assuming that they will succeed.
@@ -290,10 +371,23 @@ class load_balancer {
     }
 
 public:
-    load_balancer(token_metadata_ptr tm, load_balancer_stats_manager& stats)
+    load_balancer(token_metadata_ptr tm, tablet_load_map_ptr tablet_load, load_balancer_stats_manager& stats, const resize_config& rc)
         : _tm(std::move(tm))
+        , _tablet_load(std::move(tablet_load))
         , _stats(stats)
-    { }
+        , _resize_config(rc)
+    {
+        if (_tablet_load && !_tablet_load->empty()) {
+            double total_size = 0;
+            double total_rate = 0;
+            for (auto&& [tablet, l] : *_tablet_load) {
+                total_size += l.size_in_bytes;
+                total_rate += l.read_rate + l.write_rate;
+            }
+            _avg_tablet_size = total_size / _tablet_load->size();
+            _avg_tablet_rate = total_rate / _tablet_load->size();
+        }
+    }
 
     future<migration_plan> make_plan() {
         const locator::topology& topo = _tm->get_topology();
@@ -306,10 +400,113 @@ class load_balancer {
             plan.merge(std::move(dc_plan));
         }
 
+        plan.merge(co_await make_merge_colocation_plan());
+        plan.set_resize_plan(co_await make_resize_plan());
+
         lblogger.info("Prepared {} migrations", plan.size());
         co_return std::move(plan);
     }
 
+    // Tablets can only be merged with their sibling if they have the same replicas.
+    // For tables with a pending merge, moves replicas of the odd sibling to the replicas
+    // of the even one. At most one migration is started per source shard.
+    future<migration_plan> make_merge_colocation_plan() {
+        migration_plan plan;
+        std::unordered_set<tablet_replica> busy;
+        for (auto&& [table, tmap] : _tm->tablets().all_tables()) {
+            if (tmap.get_resize_decision().way != resize_decision::way_type::merge) {
+                continue;
+            }
+            for (size_t i = 0; i + 1 < tmap.tablet_count(); i += 2) {
+                auto left_id = tablet_id(i);
+                auto right_id = tablet_id(i + 1);
+                if (tmap.get_tablet_transition_info(left_id) || tmap.get_tablet_transition_info(right_id)) {
+                    continue;
+                }
+                auto& left = tmap.get_tablet_info(left_id).replicas;
+                auto& right = tmap.get_tablet_info(right_id).replicas;
+                std::unordered_set<host_id> right_hosts;
+                for (auto&& r : right) {
+                    right_hosts.insert(r.host);
+                }
+                auto src = std::find_if(right.begin(), right.end(), [&] (const tablet_replica& r) {
+                    return std::find(left.begin(), left.end(), r) == left.end() && !busy.contains(r);
+                });
+                auto dst = std::find_if(left.begin(), left.end(), [&] (const tablet_replica& r) {
+                    return std::find(right.begin(), right.end(), r) == right.end() && !right_hosts.contains(r.host);
+                });
+                if (src == right.end() || dst == left.end()) {
+                    // Either co-located already, or siblings differ only in shards, which can't be fixed by migration.
+                    continue;
+                }
+                busy.insert(*src);
+                auto mig = tablet_migration_info{global_tablet_id{table, right_id}, *src, *dst};
+                lblogger.debug("Co-locating sibling tablets for merge: {}", mig);
+                plan.add(std::move(mig));
+            }
+            co_await coroutine::maybe_yield();
+        }
+        co_return std::move(plan);
+    }
+
+    // Decides whether the tablet count of tables should change, based on the average
+    // size and request rate of their tablets. There is a hysteresis of a factor of 2
+    // on both sides of the targets, so that a split is not followed by a merge.
+    // Tables for which some tablets have no reported load are left alone.
+    future<table_resize_plan> make_resize_plan() {
+        table_resize_plan plan;
+        if (!_resize_config.enabled || !_tablet_load) {
+            co_return plan;
+        }
+        auto target_size = double(_resize_config.target_tablet_size);
+        auto target_rate = _resize_config.target_tablet_request_rate;
+        if (!target_size && !target_rate) {
+            co_return plan;
+        }
+
+        for (auto&& [table, tmap] : _tm->tablets().all_tables()) {
+            double total_size = 0;
+            double total_rate = 0;
+            bool complete = true;
+            for (auto tid : tmap.tablet_ids()) {
+                auto it = _tablet_load->find(global_tablet_id{table, tid});
+                if (it == _tablet_load->end()) {
+                    complete = false;
+                    break;
+                }
+                total_size += it->second.size_in_bytes;
+                total_rate += it->second.read_rate + it->second.write_rate;
+            }
+            co_await coroutine::maybe_yield();
+            if (!complete) {
+                continue;
+            }
+            auto avg_size = total_size / tmap.tablet_count();
+            auto avg_rate = total_rate / tmap.tablet_count();
+
+            auto way = resize_decision::way_type::none;
+            if ((target_size && avg_size > 2 * target_size) || (target_rate && avg_rate > 2 * target_rate)) {
+                way = resize_decision::way_type::split;
+            } else if ((!target_size || avg_size < target_size / 2) && (!target_rate || avg_rate < target_rate / 2)) {
+                auto min_it = _resize_config.min_tablet_count.find(table);
+                auto min_count = min_it != _resize_config.min_tablet_count.end() ? min_it->second : 1;
+                if (tmap.tablet_count() / 2 >= std::max<size_t>(min_count, 1)) {
+                    way = resize_decision::way_type::merge;
+                }
+            }
+
+            auto& current = tmap.get_resize_decision();
+            if (current.way == way) {
+                continue;
+            }
+            lblogger.info("Table {} with {} tablets of average size {} and average request rate {}: resize decision {} -> {}",
+                          table, tmap.tablet_count(), avg_size, avg_rate,
+                          resize_decision_way_to_string(current.way), resize_decision_way_to_string(way));
+            plan.resize.emplace(table, resize_decision{way, current.sequence_number + 1});
+        }
+        co_return std::move(plan);
+    }
+
     future<migration_plan> make_plan(dc_name dc) {
         migration_plan plan;
 
@@ -363,9 +560,11 @@ class load_balancer {
 
                 // We reflect migrations in the load as if they already happened,
                 // optimistically assuming that they will succeed.
+                auto weight = tablet_weight(global_tablet_id{table, tid});
                 for (auto&& replica : get_replicas_for_tablet_load(ti, trinfo)) {
                     if (nodes.contains(replica.host)) {
                         nodes[replica.host].tablet_count += 1;
+                        nodes[replica.host].load += weight;
                         // This invariant is assumed later.
                         if (replica.shard >= nodes[replica.host].shard_count) {
                             auto gtid = global_tablet_id{table, tid};
@@ -417,7 +616,7 @@ class load_balancer {
         }
 
         if (nodes_to_drain.empty()) {
-            if (!shuffle && max_load == min_load) {
+            if (!shuffle && is_balanced(min_load, max_load)) {
                 // load is balanced.
                 // TODO: Evaluate and fix intra-node balance.
                 _stats.for_dc(dc).stop_balance++;
@@ -460,6 +659,7 @@ class load_balancer {
                     }
                 }
 
+                auto weight = tablet_weight(global_tablet_id{table, tid});
                 for (auto&& replica : get_replicas_for_tablet_load(ti, trinfo)) {
                     if (!nodes.contains(replica.host)) {
                         continue;
@@ -470,7 +670,12 @@ class load_balancer {
                         node_load_info.shards_by_load.push_back(replica.shard);
                     }
                     shard_load_info.tablet_count += 1;
-                    if (!trinfo) { // migrating tablets are not candidates
+                    shard_load_info.load += weight;
+                    // Migrating tablets are not candidates. Neither are tablets of tables which are
+                    // about to be resized, unless we drain, so that balancing doesn't interfere
+                    // with preparing for the resize.
+                    bool resizing = tmap.get_resize_decision().split_or_merge();
+                    if (!trinfo && (!resizing || !nodes_to_drain.empty())) {
                         shard_load_info.candidates.emplace(global_tablet_id {table, tid});
                     }
                 }
@@ -503,8 +708,8 @@ class load_balancer {
             if (lblogger.is_enabled(seastar::log_level::debug)) {
                 shard_id shard = 0;
                 for (auto&& shard_load : node_load.shards) {
-                    lblogger.debug("shard {}: all tablets: {}, candidates: {}", tablet_replica{host, shard},
-                                   shard_load.tablet_count, shard_load.candidates.size());
+                    lblogger.debug("shard {}: all tablets: {}, load: {}, candidates: {}", tablet_replica{host, shard},
+                                   shard_load.tablet_count, shard_load.load, shard_load.candidates.size());
                     shard++;
                 }
             }
@@ -564,8 +769,10 @@ class load_balancer {
                 std::push_heap(src_node_info.shards_by_load.begin(), src_node_info.shards_by_load.end(), src_node_info.shards_by_load_cmp());
             });
 
-            auto source_tablet = *src_shard_info.candidates.begin();
+            auto source_tablet = pick_candidate(src_shard_info, src_node_info,
+                    nodes_to_drain.empty() && !nodes_by_load_dst.empty() ? &nodes[nodes_by_load_dst.front()] : nullptr);
             src_shard_info.candidates.erase(source_tablet);
+            auto weight = tablet_weight(source_tablet);
             auto& tmap = tmeta.get_tablet_map(source_tablet.table);
 
             // Pick a target node.
@@ -669,8 +876,8 @@ class load_balancer {
                 }
 
                 // Prevent load inversion which can lead to oscillations.
-                if (src_node_info.get_avg_load(nodes[src_host].tablet_count - 1) <
-                        target_info.get_avg_load(target_info.tablet_count + 1)) {
+                if (src_node_info.get_avg_load(src_node_info.load - weight) <
+                        target_info.get_avg_load(target_info.load + weight)) {
                     lblogger.debug("No more candidate nodes, load would be inverted. Next candidate is {} with "
                                    "avg_load={}, target's avg_load={}",
                             src_host, src_node_info.avg_load, target_info.avg_load);
@@ -720,8 +927,7 @@ class load_balancer {
                 }
             }
 
-            auto& target_load_sketch = co_await target_info.get_load_sketch(_tm);
-            auto dst = global_shard_id {target, target_load_sketch.next_shard(target)};
+            auto dst = global_shard_id {target, target_info.least_loaded_shard()};
             auto mig = tablet_migration_info {source_tablet, src, dst};
 
             if (target_info.shards[dst.shard].streaming_write_load < max_write_streaming_load
@@ -750,16 +956,21 @@ class load_balancer {
                 }
             }
 
+            target_info.shards[dst.shard].tablet_count += 1;
+            target_info.shards[dst.shard].load += weight;
             target_info.tablet_count += 1;
+            target_info.load += weight;
             target_info.update();
 
             src_shard_info.tablet_count -= 1;
+            src_shard_info.load -= weight;
             if (src_shard_info.tablet_count == 0) {
                 push_back_shard_candidate.cancel();
                 src_node_info.shards_by_load.pop_back();
             }
 
             src_node_info.tablet_count -= 1;
+            src_node_info.load -= weight;
             src_node_info.update();
             if (src_node_info.tablet_count == 0) {
                 push_back_node_candidate.cancel();
@@ -819,8 +1030,27 @@ class tablet_allocator_impl : public tablet_allocator::impl
         _stopped = true;
     }
 
-    future<migration_plan> balance_tablets(token_metadata_ptr tm) {
-        load_balancer lb(tm, _load_balancer_stats);
+    resize_config make_resize_config(const token_metadata& tm) const {
+        resize_config rc;
+        rc.enabled = _db.features().tablet_resize;
+        rc.target_tablet_size = _db.get_config().target_tablet_size_in_mb() * 1024 * 1024;
+        rc.target_tablet_request_rate = _db.get_config().target_tablet_request_rate();
+        for (auto&& [table, tmap] : tm.tablets().all_tables()) {
+            auto t = _db.get_tables_metadata().get_table_if_exists(table);
+            if (!t) {
+                continue;
+            }
+            auto& rs = _db.find_keyspace(t->schema()->ks_name()).get_replication_strategy();
+            if (auto tablet_rs = rs.maybe_as_tablet_aware()) {
+                rc.min_tablet_count.emplace(table, 1ul << log2ceil(tablet_rs->get_initial_tablets()));
+            }
+        }
+        return rc;
+    }
+
+    future<migration_plan> balance_tablets(token_metadata_ptr tm, tablet_load_map_ptr load) {
+        auto rc = make_resize_config(*tm);
+        load_balancer lb(tm, std::move(load), _load_balancer_stats, rc);
         co_return co_await lb.make_plan();
     }
 
@@ -870,8 +1100,8 @@ future<> tablet_allocator::stop() {
     return impl().stop();
 }
 
-future<migration_plan> tablet_allocator::balance_tablets(locator::token_metadata_ptr tm) {
-    return impl().balance_tablets(tm);
+future<migration_plan> tablet_allocator::balance_tablets(locator::token_metadata_ptr tm, tablet_load_map_ptr load) {
+    return impl().balance_tablets(tm, std::move(load));
 }
 
 tablet_allocator_impl& tablet_allocator::impl() {
@@ -22,11 +22,20 @@ struct tablet_migration_info {
     locator::tablet_replica dst;
 };
 
+/// Changes of tablet count decided by the load balancer.
+struct table_resize_plan {
+    // New resize decisions to record in tablet metadata, replacing the current ones.
+    std::unordered_map<table_id, locator::resize_decision> resize;
+
+    bool empty() const { return resize.empty(); }
+};
+
 class migration_plan {
 public:
     using migrations_vector = utils::chunked_vector<tablet_migration_info>;
 private:
     migrations_vector _migrations;
+    table_resize_plan _resize_plan;
     bool _has_nodes_to_drain = false;
 public:
     /// Returns true iff there are decommissioning nodes which own some tablet replicas.
@@ -36,20 +45,40 @@ class migration_plan {
     bool empty() const { return _migrations.empty(); }
     size_t size() const { return _migrations.size(); }
 
+    const table_resize_plan& resize_plan() const { return _resize_plan; }
+
     void add(tablet_migration_info info) {
         _migrations.emplace_back(std::move(info));
     }
 
     void merge(migration_plan&& other) {
         std::move(other._migrations.begin(), other._migrations.end(), std::back_inserter(_migrations));
+        _resize_plan.resize.merge(other._resize_plan.resize);
         _has_nodes_to_drain |= other._has_nodes_to_drain;
     }
 
+    void set_resize_plan(table_resize_plan plan) {
+        _resize_plan = std::move(plan);
+    }
+
     void set_has_nodes_to_drain(bool b) {
         _has_nodes_to_drain = b;
     }
 };
 
+/// Load of a single tablet replica, averaged over the replicas of the tablet.
+struct tablet_load {
+    uint64_t size_in_bytes = 0;
+    // Requests per second.
+    double read_rate = 0;
+    double write_rate = 0;
+};
+
+/// Load of tablets, as reported by their replicas.
+/// Tablets which are missing are assumed to have the average load.
+using tablet_load_map = std::unordered_map<locator::global_tablet_id, tablet_load>;
+using tablet_load_map_ptr = lw_shared_ptr<const tablet_load_map>;
+
 class tablet_allocator_impl;
 
 class tablet_allocator {
@@ -90,7 +119,17 @@ class tablet_allocator {
     ///
     /// The algorithm takes care of limiting the streaming load on the system, also by taking active migrations into account.
     ///
-    future<migration_plan> balance_tablets(locator::token_metadata_ptr);
+    /// If tablet load is given, tablets are weighted by their size and request rate instead of
+    /// being counted equally.
+    ///
+    /// If tablet load is given, the plan also contains resize decisions for tables whose tablets
+    /// are on average too big or too busy (split), or too small and idle (merge), see
+    /// target_tablet_size_in_mb and target_tablet_request_rate. Tables with a pending resize
+    /// are not balanced, except for draining. Instead, for tables with a pending merge, the plan
+    /// moves sibling tablets to the same replicas, so that they can be merged.
+    /// The resize decisions don't make the plan non-empty.
+    ///
+    future<migration_plan> balance_tablets(locator::token_metadata_ptr, tablet_load_map_ptr load = {});
 
     /// Should be called when the node is no longer a leader.
     void on_leadership_lost();
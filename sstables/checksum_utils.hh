@@ -25,7 +25,7 @@ concept ChecksumUtils = requires(const char* input, size_t size, uint32_t checks
     { Checksum::prefer_combine() } -> std::same_as<bool>;
 };
 
-struct adler32_utils {
+struct zlib_adler32_checksummer {
     inline static uint32_t init_checksum() {
         return adler32(0, Z_NULL, 0);
     }
@@ -48,6 +48,29 @@ struct adler32_utils {
     static constexpr bool prefer_combine() { return true; }
 };
 
+// libdeflate's adler32 is vectorized (SSE2/AVX2/NEON), unlike zlib's.
+struct libdeflate_adler32_checksummer {
+    static uint32_t init_checksum() {
+        return 1;
+    }
+
+    static uint32_t checksum(const char* input, size_t input_len) {
+        return checksum(init_checksum(), input, input_len);
+    }
+
+    static uint32_t checksum(uint32_t prev, const char* input, size_t input_len) {
+        return libdeflate_adler32(prev, input, input_len);
+    }
+
+    static uint32_t checksum_combine(uint32_t first, uint32_t second, size_t input_len2) {
+        return zlib_adler32_checksummer::checksum_combine(first, second, input_len2);
+    }
+
+    static constexpr bool prefer_combine() { return true; }
+};
+
+using adler32_utils = libdeflate_adler32_checksummer;
+
 struct zlib_crc32_checksummer {
     inline static uint32_t init_checksum() {
         return crc32(0, Z_NULL, 0);
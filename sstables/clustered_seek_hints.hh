@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace sstables {
+
+// Remembers, for a few partitions of one sstable, the promoted index block
+// where the last clustered index cursor over the partition was positioned.
+//
+// Paged reads of a wide partition recreate their readers for every page whose
+// querier was evicted from the querier cache, or which runs on a different shard,
+// and each page starts just after where the previous one stopped. A cursor which
+// finds a hint for its partition looks for the position by probing the blocks
+// following the hinted one at growing distances, instead of bisecting the whole
+// promoted index. That touches O(log(distance from the previous page)) blocks,
+// which are likely to still be cached, instead of O(log(blocks in the partition)).
+//
+// Partitions are identified by the position of their promoted index in the index
+// file. The table is direct-mapped, so hints of different partitions may replace
+// each other. Hints only narrow the search, cursors verify them before use, so
+// a stale or replaced hint is harmless.
+class clustered_seek_hints {
+    static constexpr size_t slots = 16;
+
+    struct hint {
+        // 0 marks an empty slot, the promoted index never starts at the beginning of the index file.
+        uint64_t promoted_index_start = 0;
+        uint32_t block_index = 0;
+    };
+    std::array<hint, slots> _hints{};
+private:
+    static size_t slot_of(uint64_t promoted_index_start) noexcept {
+        return (promoted_index_start * 0x9e3779b97f4a7c15ull) >> 60;
+    }
+public:
+    std::optional<uint32_t> get(uint64_t promoted_index_start) const noexcept {
+        const hint& h = _hints[slot_of(promoted_index_start)];
+        if (h.promoted_index_start != promoted_index_start) {
+            return std::nullopt;
+        }
+        return h.block_index;
+    }
+
+    void put(uint64_t promoted_index_start, uint32_t block_index) noexcept {
+        _hints[slot_of(promoted_index_start)] = hint{promoted_index_start, block_index};
+    }
+};
+
+} // namespace sstables
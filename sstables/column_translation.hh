@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <seastar/core/shared_ptr.hh>
 
@@ -60,10 +61,21 @@ class column_translation {
                 const sstable_enabled_features& features,
                 bool is_static);
 
+        static bool all_simple(const std::vector<column_info>& columns) {
+            return std::none_of(columns.begin(), columns.end(), [] (const column_info& c) {
+                return c.is_collection || c.is_counter;
+            });
+        }
+
         table_schema_version schema_uuid;
         std::vector<column_info> regular_schema_columns_from_sstable;
         std::vector<column_info> static_schema_columns_from_sstable;
         column_values_fixed_lengths clustering_column_value_fix_lengths;
+        // Whether none of the columns is a collection or a counter, in which case
+        // rows with all columns present can be parsed without looking at the kind
+        // of each column.
+        bool regular_columns_simple = true;
+        bool static_columns_simple = true;
 
         state() = default;
         state(const state&) = delete;
@@ -76,6 +88,8 @@ class column_translation {
             , regular_schema_columns_from_sstable(build(s, header.regular_columns.elements, features, false))
             , static_schema_columns_from_sstable(build(s, header.static_columns.elements, features, true))
             , clustering_column_value_fix_lengths (get_clustering_values_fixed_lengths(header))
+            , regular_columns_simple(all_simple(regular_schema_columns_from_sstable))
+            , static_columns_simple(all_simple(static_schema_columns_from_sstable))
         {}
     };
 
@@ -96,6 +110,12 @@ class column_translation {
     const std::vector<column_info>& static_columns() const {
         return _state->static_schema_columns_from_sstable;
     }
+    bool regular_columns_simple() const {
+        return _state->regular_columns_simple;
+    }
+    bool static_columns_simple() const {
+        return _state->static_columns_simple;
+    }
     const std::vector<std::optional<uint32_t>>& clustering_column_value_fix_legths() const {
         return _state->clustering_column_value_fix_lengths;
     }
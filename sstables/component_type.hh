@@ -26,6 +26,7 @@ enum class component_type {
     TemporaryTOC,
     TemporaryStatistics,
     Scylla,
+    ClusteringFilter,
     Unknown,
 };
 
@@ -63,6 +64,8 @@ struct fmt::formatter<sstables::component_type> : fmt::formatter<std::string_vie
             return formatter<std::string_view>::format("TemporaryStatistics", ctx);
         case Scylla:
             return formatter<std::string_view>::format("Scylla", ctx);
+        case ClusteringFilter:
+            return formatter<std::string_view>::format("ClusteringFilter", ctx);
         case Unknown:
             return formatter<std::string_view>::format("Unknown", ctx);
         }
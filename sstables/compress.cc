@@ -13,20 +13,31 @@
 #include <seastar/core/align.hh>
 #include <seastar/core/bitops.hh>
 #include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/fstream.hh>
+#include <seastar/core/loop.hh>
 
 #include "../compress.hh"
 #include "compress.hh"
 #include "exceptions.hh"
 #include "unimplemented.hh"
 #include "segmented_compress_params.hh"
+#include "utils/alien_worker.hh"
 #include "utils/class_registrator.hh"
+#include "utils/small_vector.hh"
 #include "reader_permit.hh"
 
 namespace sstables {
 
 extern logging::logger sstlog;
 
+// Trains compression dictionaries, which would stall the reactor for
+// milliseconds.
+static utils::alien_worker& dictionary_training_worker() {
+    static utils::alien_worker worker(std::max(1u, smp::count / 8), 10, sstlog);
+    return worker;
+}
+
 enum class mask_type : uint8_t {
     set,
     clear
@@ -313,6 +324,29 @@ compressor_ptr get_sstable_compressor(const compression& c) {
     return local_compression(c).compressor();
 }
 
+bool is_compressed_with(const compression& c, const compression_parameters& cp) {
+    auto p = cp.get_compressor();
+    if (!c || !p) {
+        return !c && !p;
+    }
+    const sstring& name = unqualified_name(compressor::namespace_prefix, p->name());
+    if (sstring(c.name.value.begin(), c.name.value.end()) != name || c.uncompressed_chunk_length() != uint32_t(cp.chunk_length())) {
+        return false;
+    }
+    for (auto& [k, v] : p->options()) {
+        if (k == compression_parameters::SSTABLE_COMPRESSION) {
+            continue;
+        }
+        auto it = boost::find_if(c.options.elements, [&k] (const option& o) {
+            return sstring(o.key.value.begin(), o.key.value.end()) == k;
+        });
+        if (it == c.options.elements.end() || sstring(it->value.value.begin(), it->value.value.end()) != v) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // locate() takes a byte position in the uncompressed stream, and finds the
 // the location of the compressed chunk on disk which contains it, and the
 // offset in this chunk.
@@ -336,6 +370,9 @@ compression::locate(uint64_t position, const compression::segmented_offsets::acc
 template <typename ChecksumType>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_source_impl : public data_source_impl {
+    // Upper bound on the amount of uncompressed data produced by one get().
+    static constexpr uint64_t max_batch_size = 128 * 1024;
+
     std::optional<input_stream<char>> _input_stream;
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::accessor _offsets;
@@ -392,36 +429,59 @@ class compressed_file_data_source_impl : public data_source_impl {
         if (!addr.chunk_len) {
             throw sstables::malformed_sstable_exception(format("compressed chunk_len must be greater than zero, chunk_start={}", addr.chunk_start));
         }
-        return _input_stream->read_exactly(addr.chunk_len).then([this, addr](temporary_buffer<char> buf) {
-            if (buf.size() != addr.chunk_len) {
-                throw sstables::malformed_sstable_exception(format("compressed reader hit premature end-of-file at file offset {}, expected chunk_len={}, actual={}", _underlying_pos, addr.chunk_len, buf.size()));
+        // Large sequential reads consume the chunks which follow the current
+        // one anyway, and they lie next to it on disk. Read and uncompress a
+        // run of them at once, so that the per-chunk costs (a read, a memory
+        // request, a buffer and a continuation) are paid once per batch.
+        // The run never extends past _end_pos, so small reads are unaffected.
+        const uint64_t ucl = _compression_metadata->uncompressed_chunk_length();
+        const uint64_t max_chunks = std::max<uint64_t>(1, max_batch_size / ucl);
+        const uint64_t first_chunk = _pos / ucl;
+        const uint64_t last_chunk = std::min((_end_pos - 1) / ucl, first_chunk + max_chunks - 1);
+        utils::small_vector<sstables::compression::chunk_and_offset, 16> chunks;
+        chunks.push_back(addr);
+        uint64_t total_len = addr.chunk_len;
+        for (auto i = first_chunk + 1; i <= last_chunk; ++i) {
+            auto next = _compression_metadata->locate(i * ucl, _offsets);
+            if (!next.chunk_len) {
+                throw sstables::malformed_sstable_exception(format("compressed chunk_len must be greater than zero, chunk_start={}", next.chunk_start));
             }
-            return _permit.request_memory(_compression_metadata->uncompressed_chunk_length()).then(
-                    [this, addr, buf = std::move(buf)] (reader_permit::resource_units res_units) mutable {
-                // The last 4 bytes of the chunk are the adler32/crc32 checksum
-                // of the rest of the (compressed) chunk.
-                auto compressed_len = addr.chunk_len - 4;
-                // FIXME: Do not always calculate checksum - Cassandra has a
-                // probability (defaulting to 1.0, but still...)
-                auto expected_checksum = read_be<uint32_t>(buf.get() + compressed_len);
-                auto actual_checksum = ChecksumType::checksum(buf.get(), compressed_len);
-                if (expected_checksum != actual_checksum) {
-                    throw sstables::malformed_sstable_exception(format("compressed chunk of size {} at file offset {} failed checksum, expected={}, actual={}", addr.chunk_len, _underlying_pos, expected_checksum, actual_checksum));
-                }
-
+            total_len += next.chunk_len;
+            chunks.push_back(next);
+        }
+        return _input_stream->read_exactly(total_len).then([this, chunks = std::move(chunks), total_len, ucl] (temporary_buffer<char> buf) mutable {
+            if (buf.size() != total_len) {
+                throw sstables::malformed_sstable_exception(format("compressed reader hit premature end-of-file at file offset {}, expected chunk_len={}, actual={}", _underlying_pos, total_len, buf.size()));
+            }
+            return _permit.request_memory(chunks.size() * ucl).then(
+                    [this, chunks = std::move(chunks), buf = std::move(buf), ucl] (reader_permit::resource_units res_units) mutable {
                 // We know that the uncompressed data will take exactly
-                // chunk_length bytes (or less, if reading the last chunk).
-                temporary_buffer<char> out(
-                        _compression_metadata->uncompressed_chunk_length());
-                // The compressed data is the whole chunk, minus the last 4
-                // bytes (which contain the checksum verified above).
-
-                auto len = _compression.uncompress(buf.get(), compressed_len, out.get_write(), out.size());
-
-                out.trim(len);
-                out.trim_front(addr.offset);
+                // chunk_length bytes per chunk (or less, if reading the last chunk).
+                temporary_buffer<char> out(chunks.size() * ucl);
+                size_t in_offset = 0;
+                size_t out_offset = 0;
+                for (auto& chunk : chunks) {
+                    auto in = buf.get() + in_offset;
+                    // The last 4 bytes of the chunk are the adler32/crc32 checksum
+                    // of the rest of the (compressed) chunk.
+                    auto compressed_len = chunk.chunk_len - 4;
+                    // FIXME: Do not always calculate checksum - Cassandra has a
+                    // probability (defaulting to 1.0, but still...)
+                    auto expected_checksum = read_be<uint32_t>(in + compressed_len);
+                    auto actual_checksum = ChecksumType::checksum(in, compressed_len);
+                    if (expected_checksum != actual_checksum) {
+                        throw sstables::malformed_sstable_exception(format("compressed chunk of size {} at file offset {} failed checksum, expected={}, actual={}", chunk.chunk_len, _underlying_pos, expected_checksum, actual_checksum));
+                    }
+
+                    // The compressed data is the whole chunk, minus the last 4
+                    // bytes (which contain the checksum verified above).
+                    out_offset += _compression.uncompress(in, compressed_len, out.get_write() + out_offset, ucl);
+                    in_offset += chunk.chunk_len;
+                    _underlying_pos += chunk.chunk_len;
+                }
+                out.trim(out_offset);
+                out.trim_front(chunks.front().offset);
                 _pos += out.size();
-                _underlying_pos += addr.chunk_len;
 
                 return make_tracked_temporary_buffer(std::move(out), std::move(res_units));
             });
@@ -486,12 +546,22 @@ enum class compressed_checksum_mode {
 template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_sink_impl : public data_sink_impl {
+    // How much data, relative to the dictionary size, is sampled before
+    // training a dictionary. Training is CPU-bound, so this, and the cap
+    // below, also bound the duration of the training.
+    static constexpr size_t dictionary_samples_factor = 8;
+    static constexpr size_t max_dictionary_samples_size = 1 << 20;
+
     output_stream<char> _out;
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::writer _offsets;
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
+    // Chunks held back until a dictionary is trained on them.
+    std::vector<temporary_buffer<char>> _samples;
+    size_t _samples_size = 0;
+    bool _training;
 public:
     compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
             : _out(std::move(out))
@@ -499,10 +569,55 @@ class compressed_file_data_sink_impl : public data_sink_impl {
             , _offsets(_compression_metadata->offsets.get_writer())
             , _compression(lc)
             , _full_checksum(ChecksumType::init_checksum())
+            , _training(_compression && _compression.compressor()->dictionary_size())
     {}
 
     virtual future<> put(net::packet data) override { abort(); }
     virtual future<> put(temporary_buffer<char> buf) override {
+        if (!_training) {
+            return write_chunk(std::move(buf));
+        }
+        _samples_size += buf.size();
+        _samples.push_back(std::move(buf));
+        if (_samples_size < std::min(_compression.compressor()->dictionary_size() * dictionary_samples_factor, max_dictionary_samples_size)) {
+            return make_ready_future<>();
+        }
+        return train_and_flush_samples();
+    }
+private:
+    future<> train_and_flush_samples() {
+        _training = false;
+        // A large last chunk could overshoot the cap, train on the chunks below it.
+        std::vector<std::string_view> views;
+        size_t views_size = 0;
+        for (const auto& b : _samples) {
+            if (!views.empty() && views_size + b.size() > max_dictionary_samples_size) {
+                break;
+            }
+            views.emplace_back(b.get(), b.size());
+            views_size += b.size();
+        }
+        // The samples are kept alive by _samples until the training is done.
+        auto dictionary = co_await dictionary_training_worker().submit([c = _compression.compressor().get(), &views] {
+            return c->train_dictionary(views);
+        });
+        if (!dictionary.empty()) {
+            auto trained = _compression.compressor()->with_dictionary(dictionary);
+            _compression = sstables::local_compression(trained);
+            // Store the dictionary with the rest of compression metadata.
+            auto& opts = _compression_metadata->options.elements;
+            opts.clear();
+            _compression_metadata->set_compressor(trained);
+            opts.push_back({{"crc_check_chance"}, {"1.0"}});
+        }
+        _samples_size = 0;
+        auto samples = std::exchange(_samples, {});
+        for (auto& buf : samples) {
+            co_await write_chunk(std::move(buf));
+        }
+    }
+
+    future<> write_chunk(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
@@ -542,8 +657,13 @@ class compressed_file_data_sink_impl : public data_sink_impl {
         auto f = _out.write(compressed.get(), compressed.size());
         return f.then([compressed = std::move(compressed)] {});
     }
+public:
     virtual future<> close() override {
-        return _out.close();
+        // Small sstables may not collect enough samples, try anyway.
+        auto f = _training ? train_and_flush_samples() : make_ready_future<>();
+        return f.then([this] {
+            return _out.close();
+        });
     }
 
     virtual size_t buffer_size() const noexcept override {
@@ -362,6 +362,11 @@ struct compression {
 // for API query only. Free function just to distinguish it from an accessor in compression
 compressor_ptr get_sstable_compressor(const compression&);
 
+// Returns true if the sstable compression metadata matches the compressor and chunk length of
+// the parameters. Options the sstable was written with which the parameters don't set, like
+// trained dictionaries, are not compared.
+bool is_compressed_with(const compression&, const compression_parameters&);
+
 // Note: compression_metadata is passed by reference; The caller is
 // responsible for keeping the compression_metadata alive as long as there
 // are open streams on it. This should happen naturally on a higher level -
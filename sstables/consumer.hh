@@ -122,7 +122,16 @@ class primitive_consumer {
             _prestate = ReadingVint;
             return read_status::waiting;
         } else {
-            const vint_size_type len = VintType::serialized_size_from_first_byte(*data.begin());
+            // Most vints in sstable data (flags, deltas, lengths) are a single
+            // byte long, so decode those inline instead of going through the
+            // generic decoder which inspects the first byte again.
+            const auto first_byte = static_cast<bytes::value_type>(*data.begin());
+            if (VintType::is_single_byte(first_byte)) {
+                dest = VintType::deserialize_single_byte(first_byte);
+                data.trim_front(1);
+                return read_status::ready;
+            }
+            const vint_size_type len = VintType::serialized_size_from_first_byte(first_byte);
             if (data.size() >= len) {
                 dest = VintType::deserialize(
                         bytes_view(reinterpret_cast<bytes::value_type*>(data.get_write()), data.size()));
@@ -76,6 +76,21 @@ static inline size_t size_unsigned_var_int(unsigned int value) {
     return size;
 }
 
+static inline unsigned int read_unsigned_var_int(const uint8_t*& from, const uint8_t* end) {
+    unsigned int value = 0;
+    for (unsigned shift = 0; shift < 32; shift += 7) {
+        if (from == end) {
+            throw std::runtime_error("truncated cardinality metadata");
+        }
+        uint8_t b = *from++;
+        value |= unsigned(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return value;
+        }
+    }
+    throw std::runtime_error("malformed var int in cardinality metadata");
+}
+
 static inline size_t write_unsigned_var_int(unsigned int value, uint8_t* to) {
     size_t size = 0;
     while ((value & 0xFFFFFF80) != 0L) {
@@ -128,11 +143,34 @@ class HyperLogLog {
         alphaMM_ = alpha * m_ * m_;
     }
 
+    /**
+     * Restores an estimator from the format written by get_bytes().
+     *
+     * @exception std::runtime_error the bytes are malformed, or use a format
+     *            which isn't supported, like the sparse one.
+     */
+    static HyperLogLog from_bytes(const uint8_t* data, size_t size) {
+        static constexpr int version = 2;
+
+        const uint8_t* end = data + size;
+        if (size < sizeof(int32_t) || read_be<int32_t>(reinterpret_cast<const char*>(data)) != -version) {
+            throw std::runtime_error("unsupported cardinality metadata version");
+        }
+        data += sizeof(int32_t);
+        auto b = read_unsigned_var_int(data, end);
+        read_unsigned_var_int(data, end); // sp
+        auto type = read_unsigned_var_int(data, end);
+        auto registers = read_unsigned_var_int(data, end);
+        if (type != 0 || b < 4 || b > 16 || registers != (1u << b) || size_t(end - data) != registers) {
+            throw std::runtime_error("unsupported cardinality metadata format");
+        }
+        HyperLogLog hll(b);
+        std::copy(data, end, hll.M_.begin());
+        return hll;
+    }
+
     static HyperLogLog from_bytes(temporary_buffer<uint8_t> bytes) {
-        // FIXME: implement class that creates a HyperLogLog from an array of bytes.
-        // This will useful if we need to work with the cardinality data from the
-        // compaction metadata.
-        abort();
+        return from_bytes(bytes.get(), bytes.size());
     }
 
     /**
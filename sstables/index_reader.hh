@@ -342,7 +342,8 @@ std::unique_ptr<clustered_index_cursor> promoted_index::make_cursor(shared_sstab
                                                     sst->_index_file_size);
         return std::make_unique<mc::bsearch_clustered_cursor>(*sst->get_schema(),
             _promoted_index_start, _promoted_index_size,
-            promoted_index_cache_metrics, permit,
+            promoted_index_cache_metrics, caching ? sst->_promoted_index_block_cache.get() : nullptr,
+            caching ? &sst->_clustered_seek_hints : nullptr, permit,
             *ck_values_fixed_lengths, cached_file_ptr, _num_blocks, trace_state);
     }
 
@@ -442,6 +443,8 @@ class index_reader {
     logalloc::region& _region;
     use_caching _use_caching;
     bool _single_page_read;
+    // Pages read on behalf of scans enter the index cache on probation.
+    partition_index_cache::on_probation _on_probation;
 
     std::unique_ptr<index_consume_entry_context<index_consumer>> make_context(uint64_t begin, uint64_t end, index_consumer& consumer) {
         auto index_file = make_tracked_index_file(*_sstable, _permit, _trace_state, _use_caching);
@@ -542,7 +545,7 @@ class index_reader {
             });
         };
 
-        return _index_cache.get_or_load(summary_idx, loader).then([this, &bound, summary_idx] (partition_index_cache::entry_ptr ref) {
+        return _index_cache.get_or_load(summary_idx, loader, _on_probation).then([this, &bound, summary_idx] (partition_index_cache::entry_ptr ref) {
             bound.current_list = std::move(ref);
             bound.current_summary_idx = summary_idx;
             bound.current_index_idx = 0;
@@ -645,8 +648,14 @@ class index_reader {
         }
 
         auto& summary = _sstable->get_summary();
+        // The token directory narrows down the part of the summary which can
+        // hold the lower bound, entries before it are known to be smaller
+        // and entries after it are known to be greater than pos.
+        auto [dir_first, dir_last] = summary.token_directory_range(pos.token());
+        auto first = std::max<uint64_t>(bound.previous_summary_idx, dir_first);
+        auto last = std::max<uint64_t>(first, dir_last);
         bound.previous_summary_idx = std::distance(std::begin(summary.entries),
-            std::lower_bound(summary.entries.begin() + bound.previous_summary_idx, summary.entries.end(), pos, index_comparator(*_sstable->_schema)));
+            std::lower_bound(summary.entries.begin() + first, summary.entries.begin() + last, pos, index_comparator(*_sstable->_schema)));
 
         if (bound.previous_summary_idx == 0) {
             sstlog.trace("index {}: first entry", fmt::ptr(this));
@@ -784,6 +793,7 @@ class index_reader {
         , _region(_sstable->manager().get_cache_tracker().region())
         , _use_caching(caching)
         , _single_page_read(single_partition_read) // all entries for a given partition are within a single page
+        , _on_probation(!single_partition_read)
     {
         if (sstlog.is_enabled(logging::log_level::trace)) {
             sstlog.trace("index {}: index_reader for {}", fmt::ptr(this), _sstable->get_filename());
@@ -802,6 +812,18 @@ class index_reader {
         return advance_to_page(_lower_bound, 0);
     }
 
+    // Loads the pages with the given summary indexes into the index cache,
+    // as pages requested by point reads, so not on probation.
+    // The indexes must be increasing. Moves the lower bound to the last page.
+    future<> warm_pages(std::vector<uint64_t> summary_indexes) {
+        _on_probation = partition_index_cache::on_probation::no;
+        return do_with(std::move(summary_indexes), [this] (const std::vector<uint64_t>& summary_indexes) {
+            return do_for_each(summary_indexes, [this] (uint64_t summary_idx) {
+                return advance_to_page(_lower_bound, summary_idx);
+            });
+        });
+    }
+
     // Advance index_reader bounds to the bounds of the supplied range
     future<> advance_to(const dht::partition_range& range) {
         return seastar::when_all_succeed(
@@ -952,6 +974,15 @@ class index_reader {
         });
     }
 
+    // Looks up the upper bound within the current partition, like
+    // advance_lower_and_check_if_present() does when given a position.
+    // Allows checking the partition entry in between.
+    //
+    // Must be called only when !eof().
+    future<> advance_upper_within_partition(position_in_partition_view pos) {
+        return advance_upper_past(pos);
+    }
+
     // Advances the upper bound to the partition immediately following the partition of the lower bound.
     //
     // Precondition: the sstable version is >= mc.
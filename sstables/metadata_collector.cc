@@ -9,6 +9,7 @@
 #include "log.hh"
 #include "metadata_collector.hh"
 #include "mutation/position_in_partition.hh"
+#include "schema/schema.hh"
 
 logging::logger mdclogger("metadata_collector");
 
@@ -51,4 +52,86 @@ void metadata_collector::update_min_max_components(position_in_partition_view po
     }
 }
 
+void metadata_collector::update_column_value(const column_definition& cdef, atomic_cell_view cell) {
+    if (!cell.is_live()) {
+        return;
+    }
+    if (_column_values.empty()) {
+        _column_values.resize(_schema.regular_columns_count());
+    }
+    auto& t = _column_values[cdef.id];
+    ++t.live_cells;
+    if (!t.has_min_max) {
+        return;
+    }
+    auto value = cell.value();
+    if (cdef.is_counter() || value.size_bytes() > max_column_value_stats_size) {
+        mdclogger.trace("{}: not tracking min/max of column {}", _name, cdef.name_as_text());
+        t.has_min_max = false;
+        t.min.reset();
+        t.max.reset();
+        return;
+    }
+    if (!t.min || cdef.type->compare(value, bytes_view(*t.min)) < 0) {
+        t.min = to_bytes(value);
+    }
+    if (!t.max || cdef.type->compare(value, bytes_view(*t.max)) > 0) {
+        t.max = to_bytes(value);
+    }
+}
+
+void metadata_collector::construct_column_value_stats(scylla_metadata::column_value_stats& m) const {
+    for (const auto& cdef : _schema.regular_columns()) {
+        if (!cdef.is_atomic()) {
+            continue;
+        }
+        column_value_stats_entry e{
+            .null_count = _clustering_rows_count,
+            .has_min_max = false,
+        };
+        if (cdef.id < _column_values.size()) {
+            const auto& t = _column_values[cdef.id];
+            // A row can have only one live cell per column.
+            e.null_count -= std::min(t.live_cells, _clustering_rows_count);
+            if (t.has_min_max && t.min) {
+                e.has_min_max = true;
+                e.min_value.value = *t.min;
+                e.max_value.value = *t.max;
+            }
+        }
+        m.map.emplace(disk_string<uint32_t>{cdef.name()}, std::move(e));
+    }
+}
+
+void metadata_collector::construct_tombstone_stats(scylla_metadata::tombstone_stats& m) const {
+    for (size_t i = 0; i < tombstone_kind_count; ++i) {
+        const auto& t = _tombstone_counts[i];
+        if (!t.count) {
+            continue;
+        }
+        tombstone_stats_entry e{ .count = t.count };
+        e.buckets.elements.reserve(t.buckets.size());
+        for (const auto& [_, b] : t.buckets) {
+            e.buckets.elements.push_back(b);
+        }
+        // Halve the resolution until the buckets fit. Merging adjacent buckets keeps
+        // each tombstone in a bucket whose max_deletion_time is not earlier than its own.
+        auto& buckets = e.buckets.elements;
+        while (buckets.size() > max_tombstone_stats_buckets) {
+            size_t n = 0;
+            for (size_t j = 0; j < buckets.size(); j += 2) {
+                auto b = buckets[j];
+                if (j + 1 < buckets.size()) {
+                    b.max_deletion_time = buckets[j + 1].max_deletion_time;
+                    b.count += buckets[j + 1].count;
+                }
+                buckets[n++] = b;
+            }
+            buckets.resize(n);
+        }
+        mdclogger.trace("{}: tombstone_stats: kind={} count={} buckets={}", _name, i + 1, e.count, buckets.size());
+        m.map.emplace(tombstone_kind(i + 1), std::move(e));
+    }
+}
+
 } // namespace sstables
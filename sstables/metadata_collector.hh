@@ -17,10 +17,13 @@
 #include "db/commitlog/replay_position.hh"
 #include "clustering_bounds_comparator.hh"
 #include "mutation/position_in_partition.hh"
+#include "mutation/atomic_cell.hh"
 #include "db/cache_tracker.hh"
 #include "locator/host_id.hh"
 
 #include <algorithm>
+#include <array>
+#include <map>
 
 namespace sstables {
 
@@ -101,8 +104,8 @@ class metadata_collector {
     static constexpr double NO_COMPRESSION_RATIO = -1.0;
 
     static hll::HyperLogLog hyperloglog(int p, int sp) {
-        // FIXME: hll::HyperLogLog doesn't support sparse format, so ignoring parameters by the time being.
-        return hll::HyperLogLog();
+        // FIXME: hll::HyperLogLog doesn't support sparse format, so ignoring sp by the time being.
+        return hll::HyperLogLog(p);
     }
 private:
     const schema& _schema;
@@ -125,14 +128,36 @@ class metadata_collector {
     bool _has_legacy_counter_shards = false;
     uint64_t _columns_count = 0;
     uint64_t _rows_count = 0;
+    uint64_t _clustering_rows_count = 0;
+
+    // Values of a regular column, for column_value_stats.
+    struct column_value_tracker {
+        uint64_t live_cells = 0;
+        bool has_min_max = true;
+        std::optional<bytes> min;
+        std::optional<bytes> max;
+    };
+    // Indexed by regular column id, empty until the first live cell.
+    std::vector<column_value_tracker> _column_values;
+
+    // Exact counts of the tombstones of one kind, for tombstone_stats.
+    struct tombstone_count_tracker {
+        uint64_t count = 0;
+        // Keyed by local deletion time / tombstone_stats_granularity.
+        std::map<int32_t, tombstone_count_bucket> buckets;
+    };
+    static constexpr size_t tombstone_kind_count = 5;
+    // Indexed by tombstone_kind - 1.
+    std::array<tombstone_count_tracker, tombstone_kind_count> _tombstone_counts;
 
     /**
      * Default cardinality estimation method is to use HyperLogLog++.
-     * Parameter here(p=13, sp=25) should give reasonable estimation
-     * while lowering bytes required to hold information.
-     * See CASSANDRA-5906 for detail.
+     * Cassandra uses p=13, sp=25, see CASSANDRA-5906 for detail.
+     * Without the sparse format, p=10 keeps the sketch, which stays in memory
+     * with the statistics of the sstable, at 1KB, for a ~3% standard error.
+     * Compaction strategies use it to estimate the overlap of sstables.
      */
-    hll::HyperLogLog _cardinality = hyperloglog(13, 25);
+    hll::HyperLogLog _cardinality = hyperloglog(10, 25);
 private:
     void convert(disk_array<uint32_t, disk_string<uint16_t>>&to, const std::optional<position_in_partition>& from);
 public:
@@ -195,6 +220,32 @@ class metadata_collector {
     // pos must be in the clustered region
     void update_min_max_components(position_in_partition_view pos);
 
+    // Values larger than that invalidate min/max tracking of their column.
+    static constexpr size_t max_column_value_stats_size = 256;
+
+    void add_clustering_row() {
+        ++_clustering_rows_count;
+    }
+
+    // Accounts a cell of an atomic regular column of a clustering row.
+    void update_column_value(const column_definition& cdef, atomic_cell_view cell);
+
+    // Tombstones are counted in buckets spanning that many seconds of local deletion time.
+    static constexpr int32_t tombstone_stats_granularity = 3600;
+    // Adjacent buckets are merged down to that many per kind when writing tombstone_stats.
+    static constexpr size_t max_tombstone_stats_buckets = 256;
+
+    // Accounts a tombstone, or expiring data, for tombstone_stats.
+    void add_tombstone(tombstone_kind kind, gc_clock::time_point local_deletion_time) {
+        bool capped;
+        int32_t ldt = adjusted_local_deletion_time(local_deletion_time, capped);
+        auto& t = _tombstone_counts[size_t(kind) - 1];
+        ++t.count;
+        auto& b = t.buckets[ldt / tombstone_stats_granularity];
+        b.max_deletion_time = b.count ? std::max(b.max_deletion_time, ldt) : ldt;
+        ++b.count;
+    }
+
     void update(column_stats&& stats) {
         _timestamp_tracker.update(stats.timestamp_tracker);
         _local_deletion_time_tracker.update(stats.local_deletion_time_tracker);
@@ -233,6 +284,10 @@ class metadata_collector {
         m.rows_count = _rows_count;
         m.originating_host_id = _host_id;
     }
+
+    void construct_column_value_stats(scylla_metadata::column_value_stats& m) const;
+
+    void construct_tombstone_stats(scylla_metadata::tombstone_stats& m) const;
 };
 
 }
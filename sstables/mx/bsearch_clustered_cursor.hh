@@ -11,6 +11,8 @@
 #include "sstables/index_entry.hh"
 #include "sstables/column_translation.hh"
 #include "sstables/promoted_index_blocks_reader.hh"
+#include "sstables/promoted_index_block_cache.hh"
+#include "sstables/clustered_seek_hints.hh"
 #include "parsers.hh"
 #include "schema/schema.hh"
 #include "utils/cached_file.hh"
@@ -32,6 +34,10 @@ namespace sstables::mc {
 ///
 /// Designed for a single user. Methods must not be invoked concurrently.
 ///
+/// Fully parsed blocks are also looked up in, and added to, the sstable's
+/// promoted_index_block_cache if one is given, so that readers of the same
+/// partition don't have to parse them again.
+///
 /// All methods provide basic exception guarantee.
 class cached_promoted_index {
 public:
@@ -158,6 +164,7 @@ class cached_promoted_index {
     uint64_t _promoted_index_start;
     uint64_t _promoted_index_size;
     metrics& _metrics;
+    promoted_index_block_cache* _shared_blocks;
     const pi_index_type _blocks_count;
     cached_file& _cached_file;
     data_consumer::primitive_consumer _primitive_parser;
@@ -233,6 +240,32 @@ class cached_promoted_index {
         });
     }
 
+    // Like read_block(), but takes the block from the shared cache if it's there
+    // and populates the cache otherwise.
+    //
+    // Postconditions:
+    //   - block.end is engaged, all fields in the block are valid
+    future<> read_block_shared(promoted_index_block& block, tracing::trace_state_ptr trace_state) {
+        if (!_shared_blocks) {
+            return read_block(block, std::move(trace_state));
+        }
+        auto key = promoted_index_block_cache::key_type{_promoted_index_start, block.index};
+        if (auto cached = _shared_blocks->get(key)) {
+            auto mem_before = block.memory_usage();
+            block.start.emplace(std::move(cached->start));
+            block.end.emplace(std::move(cached->end));
+            block.end_open_marker = cached->end_open_marker;
+            block.data_file_offset = cached->data_file_offset;
+            block.width = cached->width;
+            _metrics.used_bytes += block.memory_usage() - mem_before;
+            return make_ready_future<>();
+        }
+        return read_block(block, std::move(trace_state)).then([this, &block, key] {
+            _shared_blocks->put(key, promoted_index_block_cache::block{*block.start, *block.end,
+                    block.end_open_marker, block.data_file_offset, block.width});
+        });
+    }
+
     /// \brief Returns a pointer to promoted_index_block entry which has at least offset and index fields valid.
     future<promoted_index_block*> get_block_only_offset(pi_index_type idx, tracing::trace_state_ptr trace_state) {
         auto i = _blocks.lower_bound(idx);
@@ -263,6 +296,7 @@ class cached_promoted_index {
             uint64_t promoted_index_start,
             uint64_t promoted_index_size,
             metrics& m,
+            promoted_index_block_cache* shared_blocks,
             reader_permit permit,
             column_values_fixed_lengths cvfl,
             cached_file& f,
@@ -272,6 +306,7 @@ class cached_promoted_index {
         , _promoted_index_start(promoted_index_start)
         , _promoted_index_size(promoted_index_size)
         , _metrics(m)
+        , _shared_blocks(shared_blocks)
         , _blocks_count(blocks_count)
         , _cached_file(f)
         , _primitive_parser(permit)
@@ -296,6 +331,10 @@ class cached_promoted_index {
                 return make_ready_future<promoted_index_block*>(block);
             }
             ++_metrics.misses_l1;
+            if (_shared_blocks) {
+                // Parse the whole block, it's going to be shared.
+                return read_block_shared(*block, trace_state).then([block] { return block; });
+            }
             return read_block_start(*block, trace_state).then([block] { return block; });
         });
     }
@@ -308,7 +347,7 @@ class cached_promoted_index {
                 return make_ready_future<promoted_index_block*>(block);
             }
             ++_metrics.misses_l2;
-            return read_block(*block, trace_state).then([block] { return block; });
+            return read_block_shared(*block, trace_state).then([block] { return block; });
         });
     }
 
@@ -329,7 +368,7 @@ class cached_promoted_index {
         }
         auto& block = const_cast<promoted_index_block&>(*i);
         if (!block.end) {
-            return read_block(block, trace_state).then([&block] {
+            return read_block_shared(block, trace_state).then([&block] {
                 return make_ready_future<std::optional<uint64_t>>(block.data_file_offset);
             });
         }
@@ -361,15 +400,18 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
     using promoted_index_block = cached_promoted_index::promoted_index_block;
 
     const schema& _s;
+    const uint64_t _promoted_index_start;
     const pi_index_type _blocks_count;
     seastar::shared_ptr<cached_file> _cached_file;
     cached_promoted_index _promoted_index;
+    clustered_seek_hints* _hints;
 
     // Points to the block whose start is greater than the position of the cursor (its upper bound).
     pi_index_type _current_idx = 0;
 
     // Used internally by advance_to_upper_bound() to avoid allocating state.
     pi_index_type _upper_idx;
+    pi_index_type _gallop_step;
 
     // Points to the upper bound of the cursor.
     std::optional<position_in_partition> _current_pos;
@@ -383,6 +425,52 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
     //
     // Async calls must be serialized.
     future<> advance_to_upper_bound(position_in_partition_view pos) {
+        _upper_idx = _blocks_count;
+        return bisect(pos);
+    }
+
+    // Like advance_to_upper_bound(), for a cursor which wasn't advanced yet, but starts
+    // from the block at which the last cursor over the partition was, see clustered_seek_hints.
+    //
+    // Establishes the invariants of bisect() by probing the blocks at distances 1, 2, 4, ...
+    // after the hinted one, until one starting after pos is found, then bisects the last step.
+    future<> advance_to_upper_bound_from(pi_index_type hint, position_in_partition_view pos) {
+        _upper_idx = _blocks_count;
+        return _promoted_index.get_block_with_start(hint, _trace_state).then([this, hint, pos] (promoted_index_block* block) {
+            position_in_partition::less_compare less(_s);
+            if (less(pos, *block->start)) {
+                // The read went backwards, search before the hint.
+                _current_pos = *block->start;
+                _upper_idx = hint;
+                return bisect(pos);
+            }
+            _current_idx = hint + 1;
+            _gallop_step = 1;
+            return repeat([this, pos] {
+                if (_current_idx >= _upper_idx) {
+                    return make_ready_future<stop_iteration>(stop_iteration::yes);
+                }
+                auto probe = std::min<pi_index_type>(_current_idx + _gallop_step - 1, _upper_idx - 1);
+                sstlog.trace("mc_bsearch_clustered_cursor {}: galloping from [{}], probe={}", fmt::ptr(this), _current_idx, probe);
+                return _promoted_index.get_block_with_start(probe, _trace_state).then([this, probe, pos] (promoted_index_block* block) {
+                    position_in_partition::less_compare less(_s);
+                    if (less(pos, *block->start)) {
+                        _current_pos = *block->start;
+                        _upper_idx = probe;
+                        return stop_iteration::yes;
+                    }
+                    _current_idx = probe + 1;
+                    _gallop_step *= 2;
+                    return stop_iteration::no;
+                });
+            }).then([this, pos] {
+                return bisect(pos);
+            });
+        });
+    }
+
+    // Binary search between _current_idx and _upper_idx, the body of advance_to_upper_bound().
+    future<> bisect(position_in_partition_view pos) {
         // Binary search over blocks.
         //
         // Post conditions:
@@ -401,7 +489,6 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
         //
         // Eventually _current_idx will reach _upper_idx.
 
-        _upper_idx = _blocks_count;
         return repeat([this, pos] {
             if (_current_idx >= _upper_idx) {
                 if (_current_idx == _blocks_count) {
@@ -435,22 +522,27 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
             uint64_t promoted_index_start,
             uint64_t promoted_index_size,
             cached_promoted_index::metrics& metrics,
+            promoted_index_block_cache* shared_blocks,
+            clustered_seek_hints* hints,
             reader_permit permit,
             column_values_fixed_lengths cvfl,
             seastar::shared_ptr<cached_file> f,
             pi_index_type blocks_count,
             tracing::trace_state_ptr trace_state)
         : _s(s)
+        , _promoted_index_start(promoted_index_start)
         , _blocks_count(blocks_count)
         , _cached_file(std::move(f))
         , _promoted_index(s,
             promoted_index_start,
             promoted_index_size,
             metrics,
+            shared_blocks,
             std::move(permit),
             std::move(cvfl),
             *_cached_file,
             blocks_count)
+        , _hints(hints)
         , _trace_state(std::move(trace_state))
     { }
 
@@ -460,15 +552,25 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
         sstlog.trace("mc_bsearch_clustered_cursor {}: advance_to({}), _current_pos={}, _current_idx={}, cached={}",
             fmt::ptr(this), pos, _current_pos, _current_idx, _promoted_index.file().cached_bytes());
 
+        std::optional<pi_index_type> hint;
         if (_current_pos) {
             if (less(pos, *_current_pos)) {
                 sstlog.trace("mc_bsearch_clustered_cursor {}: same block", fmt::ptr(this));
                 return make_ready_future<std::optional<skip_info>>(std::nullopt);
             }
             ++_current_idx;
+        } else if (_current_idx == 0 && _hints) {
+            hint = _hints->get(_promoted_index_start);
+            if (hint && *hint >= _blocks_count) {
+                hint.reset();
+            }
         }
 
-        return advance_to_upper_bound(pos).then([this] {
+        auto advanced = hint ? advance_to_upper_bound_from(*hint, pos) : advance_to_upper_bound(pos);
+        return advanced.then([this] {
+            if (_hints && _current_idx > 0) {
+                _hints->put(_promoted_index_start, _current_idx - 1);
+            }
             if (_current_idx == 0) {
                 sstlog.trace("mc_bsearch_clustered_cursor {}: same block", fmt::ptr(this));
                 return make_ready_future<std::optional<skip_info>>(std::nullopt);
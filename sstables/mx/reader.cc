@@ -733,6 +733,9 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
 
         // Represents the subset of _all_columns present in current row
         boost::dynamic_bitset<uint64_t> _columns_selector; // size() == _columns.size()
+
+        // None of _all_columns is a collection or a counter
+        bool _all_simple = false;
     };
 
     row_schema _regular_row;
@@ -777,9 +780,10 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
         _row = &rs;
         _row->_columns = _row->_all_columns;
     }
-    void setup_columns(row_schema& rs, const std::vector<column_translation::column_info>& columns) {
+    void setup_columns(row_schema& rs, const std::vector<column_translation::column_info>& columns, bool all_simple) {
         rs._all_columns = boost::make_iterator_range(columns);
         rs._columns_selector = boost::dynamic_bitset<uint64_t>(columns.size());
+        rs._all_simple = all_simple;
     }
     void skip_absent_columns() {
         size_t pos = _row->_columns_selector.find_first();
@@ -1038,6 +1042,8 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                     _row->_columns_selector.flip(this->_u64);
                 }
                 skip_absent_columns();
+            } else if (_row->_all_simple) {
+                goto simple_columns_label;
             } else {
                 _row->_columns_selector.set();
             }
@@ -1151,6 +1157,65 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
             }
             _consuming = true;
             goto column_label;
+        simple_columns_label:
+            // All the columns are present in the row and none of them is a collection
+            // or a counter, so the cells are simply parsed one after another, without
+            // consulting the columns selector or the kind of each column.
+            while (!no_more_columns()) {
+                co_yield this->read_8(*_processing_data);
+                _column_flags = column_flags_m(this->_u8);
+
+                if (_column_flags.use_row_timestamp()) {
+                    _column_timestamp = _liveness.timestamp();
+                } else {
+                    co_yield this->read_unsigned_vint(*_processing_data);
+                    _column_timestamp = parse_timestamp(_header, this->_u64);
+                }
+                if (_column_flags.use_row_ttl()) {
+                    _column_local_deletion_time = _liveness.local_deletion_time();
+                    _column_ttl = _liveness.ttl();
+                } else if (!_column_flags.is_deleted() && !_column_flags.is_expiring()) {
+                    _column_local_deletion_time = gc_clock::time_point::max();
+                    _column_ttl = gc_clock::duration::zero();
+                } else {
+                    co_yield this->read_unsigned_vint(*_processing_data);
+                    _column_local_deletion_time = parse_expiry(_header, this->_u64);
+                    if (!_column_flags.is_expiring()) {
+                        _column_ttl = gc_clock::duration::zero();
+                    } else {
+                        co_yield this->read_unsigned_vint(*_processing_data);
+                        _column_ttl = parse_ttl(_header, this->_u64);
+                    }
+                }
+                if (!_column_flags.has_value()) {
+                    _column_value = fragmented_temporary_buffer();
+                } else {
+                    read_status status = read_status::waiting;
+                    if (auto len = get_column_value_length()) {
+                        status = this->read_bytes(*_processing_data, *len, _column_value);
+                    } else {
+                        status = this->read_unsigned_vint_length_bytes(*_processing_data, _column_value);
+                    }
+                    co_yield status;
+                }
+                _consuming = false;
+                if (_consumer.consume_column(get_column_info(),
+                                             bytes_view(),
+                                             fragmented_temporary_buffer::view(_column_value),
+                                             _column_timestamp,
+                                             _column_ttl,
+                                             _column_local_deletion_time,
+                                             _column_flags.is_deleted()) == data_consumer::proceed::no) {
+                    co_yield data_consumer::proceed::no;
+                }
+                _row->_columns.advance_begin(1);
+                _consuming = true;
+            }
+            _state = state::FLAGS;
+            if (_consumer.consume_row_end() == data_consumer::proceed::no) {
+                co_yield data_consumer::proceed::no;
+            }
+            goto flags_label;
         range_tombstone_body_label:
             co_yield this->read_unsigned_vint(*_processing_data);
             // Ignore result (marker_body_size or row_body_size)
@@ -1208,8 +1273,8 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
         , _has_shadowable_tombstones(sst->has_shadowable_tombstones())
         , _gen(do_process_state())
     {
-        setup_columns(_regular_row, _column_translation.regular_columns());
-        setup_columns(_static_row, _column_translation.static_columns());
+        setup_columns(_regular_row, _column_translation.regular_columns(), _column_translation.regular_columns_simple());
+        setup_columns(_static_row, _column_translation.static_columns(), _column_translation.static_columns_simple());
     }
 
     void verify_end_state() {
@@ -1514,6 +1579,39 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
     bool is_initialized() const {
         return bool(_context);
     }
+    // Tells whether the clustering filter proves that the partition the index is
+    // positioned at has nothing selected by the slice except for its (live)
+    // partition header, which the index provides as well.
+    // Precondition: _index_reader->partition_data_ready().
+    bool clustering_filter_excludes_slice() {
+        if (!_sst->has_clustering_filter() || _fwd == streamed_mutation::forwarding::yes || _slice.get_specific_ranges()) {
+            return false;
+        }
+        if (_schema->has_static_columns() && !_slice.static_columns.empty()) {
+            return false;
+        }
+        const auto& ranges = _slice.default_row_ranges();
+        if (ranges.empty() || !std::ranges::all_of(ranges, [this] (const query::clustering_range& r) {
+            return r.is_singular() && r.start()->value().is_full(*_schema);
+        })) {
+            return false;
+        }
+        // Only partitions with a promoted index have their rows in the filter.
+        if (!_index_reader->get_promoted_index_size()) {
+            return false;
+        }
+        auto tomb = _index_reader->partition_tombstone();
+        if (!tomb || tombstone(*tomb)) {
+            return false;
+        }
+        auto pk = key::from_partition_key(*_schema, _index_reader->get_partition_key());
+        if (_sst->clustering_filter_has_key(sstable::make_clustering_filter_key(pk))) {
+            return false;
+        }
+        return std::ranges::none_of(ranges, [&] (const query::clustering_range& r) {
+            return _sst->clustering_filter_has_key(sstable::make_clustering_filter_key(pk, &r.start()->value()));
+        });
+    }
     // Returns true if reader is initialized, by either a previous or current request
     future<bool> maybe_initialize() {
         if (is_initialized()) {
@@ -1522,8 +1620,7 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
         if (_single_partition_read) {
             _sst->get_stats().on_single_partition_read();
             const auto& key = dht::ring_position_view(_pr.start()->value());
-            position_in_partition_view pos = get_slice_upper_bound(*_schema, _slice, key);
-            const auto present = co_await get_index_reader().advance_lower_and_check_if_present(key, pos);
+            const auto present = co_await get_index_reader().advance_lower_and_check_if_present(key);
 
             if (!present) {
                 _sst->get_filter_tracker().add_false_positive();
@@ -1531,6 +1628,21 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
             }
 
             _sst->get_filter_tracker().add_true_positive();
+            if (clustering_filter_excludes_slice()) {
+                // Emit the partition without rows, so the result doesn't depend
+                // on whether the filter was consulted, like sstable_set does for
+                // sstables it leaves out based on clustering key metadata.
+                _sst->get_stats().on_clustering_filter_skip();
+                auto begin = _index_reader->get_data_file_position();
+                _context = data_consume_single_partition<DataConsumeRowsContext>(*_schema, _sst, _consumer, { begin, begin });
+                _read_enabled = false;
+                _monitor.on_read_started(_context->reader_position());
+                _index_in_current_partition = true;
+                on_next_partition(dht::decorate_key(*_schema, _index_reader->get_partition_key()), {});
+                on_out_of_clustering_range();
+                co_return true;
+            }
+            co_await _index_reader->advance_upper_within_partition(get_slice_upper_bound(*_schema, _slice, key));
             if (reversed()) {
                 co_await _index_reader->advance_reverse_to_next_partition();
             }
@@ -18,8 +18,10 @@
 #include "mutation/atomic_cell.hh"
 #include "utils/exceptions.hh"
 #include "db/large_data_handler.hh"
+#include "utils/bloom_filter.hh"
 
 #include <functional>
+#include <seastar/core/align.hh>
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/container/static_vector.hpp>
 #include <boost/range/adaptor/indexed.hpp>
@@ -543,6 +545,9 @@ class writer : public sstable_writer::writer_impl {
     std::optional<key> _partition_key;
     std::optional<key> _first_key, _last_key;
     index_sampling_state _index_sampling_state;
+    // Partition count and uncompressed data offset at each summary entry,
+    // turned into scylla_metadata::summary_entry_stats when sealing.
+    utils::chunked_vector<std::pair<uint64_t, uint64_t>> _summary_entry_positions;
     bytes_ostream _tmp_bufs;
 
     const sstable_schema _sst_schema;
@@ -590,8 +595,20 @@ class writer : public sstable_writer::writer_impl {
 
         // from write config
         size_t promoted_index_block_size;
+        size_t promoted_index_initial_block_size;
         size_t promoted_index_auto_scale_threshold;
     } _pi_write_m;
+    // Keys for the clustering filter, see sstable::make_clustering_filter_key().
+    // Only partitions which get a promoted index keep theirs, as narrow
+    // partitions are cheap to read anyway.
+    struct {
+        bool enabled = false;
+        bool saturated = false;
+        size_t max_keys;
+        utils::chunked_vector<utils::hashed_key> keys;
+        size_t partition_keys_start = 0;
+        bool partition_has_range_tombstones = false;
+    } _ck_filter;
     run_id _run_identifier;
     bool _write_regular_as_static; // See #4139
     large_data_stats_entry _partition_size_entry;
@@ -600,12 +617,19 @@ class writer : public sstable_writer::writer_impl {
     large_data_stats_entry _cell_size_entry;
     large_data_stats_entry _elements_in_collection_entry;
 
+    // Bound on the file extents preallocated at once for the data component.
+    static constexpr uint64_t max_data_preallocation_size = 64 << 20;
+
+    file_output_stream_options make_sink_options(component_type type) const;
     void init_file_writers();
 
     // Returns the closed writer
     std::unique_ptr<file_writer> close_writer(std::unique_ptr<file_writer>& w);
 
     void close_data_writer();
+    void add_clustering_filter_key(const clustering_key_prefix* ck);
+    void seal_clustering_filter_partition();
+    void seal_clustering_filter();
     void ensure_tombstone_is_written() {
         if (!_tombstone_written) {
             consume(tombstone());
@@ -621,9 +645,30 @@ class writer : public sstable_writer::writer_impl {
     void drain_tombstones(std::optional<position_in_partition_view> pos = {});
 
     void maybe_add_summary_entry(const dht::token& token, bytes_view key) {
-        return sstables::maybe_add_summary_entry(
+        auto partition_count = _index_sampling_state.partition_count;
+        auto entries = _sst._components->summary.entries.size();
+        sstables::maybe_add_summary_entry(
             _sst._components->summary, token, key, get_data_offset(),
             _index_writer->offset(), _index_sampling_state);
+        if (_sst._components->summary.entries.size() != entries) {
+            _summary_entry_positions.emplace_back(partition_count, _data_writer->offset());
+        }
+    }
+
+    scylla_metadata::summary_entry_stats make_summary_entry_stats() const {
+        scylla_metadata::summary_entry_stats stats;
+        stats.elements.reserve(_summary_entry_positions.size());
+        for (size_t i = 0; i != _summary_entry_positions.size(); ++i) {
+            auto [partitions, offset] = _summary_entry_positions[i];
+            auto [next_partitions, next_offset] = i + 1 != _summary_entry_positions.size()
+                    ? _summary_entry_positions[i + 1]
+                    : std::pair(_index_sampling_state.partition_count, _data_writer->offset());
+            stats.elements.push_back(summary_entry_stats_entry{
+                .partitions = uint32_t(std::min(next_partitions - partitions, uint64_t(std::numeric_limits<uint32_t>::max()))),
+                .data_size = next_offset - offset,
+            });
+        }
+        return stats;
     }
 
     void maybe_set_pi_first_clustering(const clustering_info& info);
@@ -789,6 +834,12 @@ class writer : public sstable_writer::writer_impl {
         // exactly what callers used to do anyway.
         estimated_partitions = std::max(uint64_t(1), estimated_partitions);
 
+        _ck_filter.enabled = cfg.clustering_filter && _schema.clustering_key_size() && !_write_regular_as_static
+                && _schema.bloom_filter_fp_chance() != 1.0;
+        _ck_filter.max_keys = cfg.clustering_filter_max_keys;
+        if (_ck_filter.enabled) {
+            _sst._recognized_components.insert(component_type::ClusteringFilter);
+        }
         _sst.open_sstable();
         _sst.create_data().get();
         _compression_enabled = !_sst.has_component(component_type::CRC);
@@ -798,6 +849,9 @@ class writer : public sstable_writer::writer_impl {
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
         _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
         _pi_write_m.promoted_index_block_size = cfg.promoted_index_block_size;
+        _pi_write_m.promoted_index_initial_block_size = cfg.promoted_index_initial_block_size
+                ? std::min(cfg.promoted_index_initial_block_size, cfg.promoted_index_block_size)
+                : cfg.promoted_index_block_size;
         _pi_write_m.promoted_index_auto_scale_threshold = cfg.promoted_index_auto_scale_threshold;
         _index_sampling_state.summary_byte_cost = _cfg.summary_byte_cost;
         prepare_summary(_sst._components->summary, estimated_partitions, _schema.min_index_interval());
@@ -844,6 +898,12 @@ void writer::add_pi_block() {
         _data_writer->offset() - _pi_write_m.block_start_offset,
         (_current_tombstone ? std::make_optional(_current_tombstone) : std::optional<tombstone>{})};
 
+    // Blocks start small, so that the head of medium-sized partitions is indexed
+    // finely, and double up to the configured size.
+    if (_pi_write_m.desired_block_size < _pi_write_m.promoted_index_block_size) {
+        _pi_write_m.desired_block_size = std::min(_pi_write_m.desired_block_size * 2, _pi_write_m.promoted_index_block_size);
+    }
+
     if (_pi_write_m.blocks.empty()) {
         if (!_pi_write_m.first_entry) {
             _pi_write_m.first_entry.emplace(std::move(block));
@@ -874,8 +934,28 @@ void writer::maybe_add_pi_block() {
     }
 }
 
+file_output_stream_options writer::make_sink_options(component_type type) const {
+    file_output_stream_options options;
+    options.write_behind = _cfg.write_behind;
+    if (!_cfg.write_batch_size) {
+        options.buffer_size = _sst.sstable_buffer_size;
+        return options;
+    }
+    // Writes must stay aligned, so keep the batch a multiple of the default buffer size.
+    options.buffer_size = align_up(_cfg.write_batch_size, _sst.sstable_buffer_size);
+    if (type == component_type::Data) {
+        // Preallocate the file in extents which grow with the expected size, but stay
+        // bounded, so that overestimating it doesn't waste much space.
+        options.preallocation_size = std::clamp<uint64_t>(_cfg.estimated_data_size, options.buffer_size,
+                std::max<uint64_t>(max_data_preallocation_size, options.buffer_size));
+    } else {
+        options.preallocation_size = options.buffer_size;
+    }
+    return options;
+}
+
 void writer::init_file_writers() {
-    auto out = _sst._storage->make_data_or_index_sink(_sst, component_type::Data).get0();
+    auto out = _sst._storage->make_data_or_index_sink(_sst, component_type::Data, make_sink_options(component_type::Data)).get0();
 
     if (!_compression_enabled) {
         _data_writer = std::make_unique<crc32_checksummed_file_writer>(std::move(out), _sst.sstable_buffer_size, _sst.filename(component_type::Data));
@@ -887,7 +967,7 @@ void writer::init_file_writers() {
                 _schema.get_compressor_params()), _sst.filename(component_type::Data));
     }
 
-    out = _sst._storage->make_data_or_index_sink(_sst, component_type::Index).get0();
+    out = _sst._storage->make_data_or_index_sink(_sst, component_type::Index, make_sink_options(component_type::Index)).get0();
     _index_writer = std::make_unique<file_writer>(output_stream<char>(std::move(out)), _sst.filename(component_type::Index));
 }
 
@@ -908,6 +988,51 @@ void writer::close_data_writer() {
     }
 }
 
+void writer::add_clustering_filter_key(const clustering_key_prefix* ck) {
+    if (!_ck_filter.enabled || _ck_filter.saturated) {
+        return;
+    }
+    _ck_filter.keys.push_back(sstable::make_clustering_filter_key(*_partition_key, ck));
+}
+
+void writer::seal_clustering_filter_partition() {
+    if (!_ck_filter.enabled || _ck_filter.saturated) {
+        return;
+    }
+    // Keep in sync with the condition in write_promoted_index().
+    if (_pi_write_m.promoted_index_size < 2) {
+        while (_ck_filter.keys.size() > _ck_filter.partition_keys_start) {
+            _ck_filter.keys.pop_back();
+        }
+        return;
+    }
+    if (_ck_filter.partition_has_range_tombstones) {
+        add_clustering_filter_key(nullptr);
+    }
+    if (_ck_filter.keys.size() > _ck_filter.max_keys) {
+        sstlog.debug("Too many keys for the clustering filter of {}, it will match all keys", _sst.get_filename());
+        _ck_filter.saturated = true;
+        _ck_filter.keys = {};
+    }
+}
+
+void writer::seal_clustering_filter() {
+    if (!_ck_filter.enabled) {
+        return;
+    }
+    if (_ck_filter.saturated) {
+        // A filter without hash functions matches every key.
+        _sst._components->clustering_filter = utils::filter::create_filter(0, 1, 1, utils::filter_format::m_format);
+        return;
+    }
+    _sst._components->clustering_filter = utils::i_filter::get_filter(std::max(_ck_filter.keys.size(), size_t(1)),
+            _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+    for (const auto& key : _ck_filter.keys) {
+        _sst._components->clustering_filter->add(key);
+    }
+    _ck_filter.keys = {};
+}
+
 void writer::consume_new_partition(const dht::decorated_key& dk) {
     _c_stats.start_offset = _data_writer->offset();
     _prev_row_start = _data_writer->offset();
@@ -935,7 +1060,7 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
     _pi_write_m.tomb = {};
     _pi_write_m.first_clustering.reset();
     _pi_write_m.last_clustering.reset();
-    _pi_write_m.desired_block_size = _pi_write_m.promoted_index_block_size;
+    _pi_write_m.desired_block_size = _pi_write_m.promoted_index_initial_block_size;
     _pi_write_m.auto_scale_threshold = _pi_write_m.promoted_index_auto_scale_threshold;
 
     write(_sst.get_version(), *_data_writer, p_key);
@@ -943,6 +1068,9 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
 
     _tombstone_written = false;
     _static_row_written = false;
+
+    _ck_filter.partition_keys_start = _ck_filter.keys.size();
+    _ck_filter.partition_has_range_tombstones = false;
 }
 
 void writer::consume(tombstone t) {
@@ -951,6 +1079,9 @@ void writer::consume(tombstone t) {
     write(_sst.get_version(), *_data_writer, dt);
     _partition_header_length += (_data_writer->offset() - current_pos);
     _c_stats.update(t);
+    if (t) {
+        _collector.add_tombstone(tombstone_kind::partition, t.deletion_time);
+    }
 
     _pi_write_m.tomb = t;
     _tombstone_written = true;
@@ -967,7 +1098,7 @@ void writer::maybe_record_large_partitions(const sstables::sstable& sst, const s
     auto& row_count_entry = _rows_in_partition_entry;
     size_entry.max_value = std::max(size_entry.max_value, partition_size);
     row_count_entry.max_value = std::max(row_count_entry.max_value, rows);
-    auto ret = _sst.get_large_data_handler().maybe_record_large_partitions(sst, partition_key, partition_size, rows).get0();
+    auto ret = _sst.get_large_data_handler().maybe_record_large_partitions(sst, partition_key, partition_size, rows);
     size_entry.above_threshold += unsigned(bool(ret.size));
     row_count_entry.above_threshold += unsigned(bool(ret.rows));
 }
@@ -978,7 +1109,7 @@ void writer::maybe_record_large_rows(const sstables::sstable& sst, const sstable
     if (entry.max_value < row_size) {
         entry.max_value = row_size;
     }
-    if (_sst.get_large_data_handler().maybe_record_large_rows(sst, partition_key, clustering_key, row_size).get0()) {
+    if (_sst.get_large_data_handler().maybe_record_large_rows(sst, partition_key, clustering_key, row_size)) {
         entry.above_threshold++;
     };
 }
@@ -993,7 +1124,7 @@ void writer::maybe_record_large_cells(const sstables::sstable& sst, const sstabl
     if (collection_elements_entry.max_value < collection_elements) {
         collection_elements_entry.max_value = collection_elements;
     }
-    if (_sst.get_large_data_handler().maybe_record_large_cells(_sst, *_partition_key, clustering_key, cdef, cell_size, collection_elements).get0()) {
+    if (_sst.get_large_data_handler().maybe_record_large_cells(_sst, *_partition_key, clustering_key, cdef, cell_size, collection_elements)) {
         if (cell_size > cell_size_entry.threshold) {
             cell_size_entry.above_threshold++;
         }
@@ -1075,6 +1206,7 @@ void writer::write_cell(bytes_ostream& writer, const clustering_key_prefix* clus
     _c_stats.update_timestamp(cell.timestamp());
     if (is_deleted) {
         _c_stats.update_local_deletion_time_and_tombstone_histogram(cell.deletion_time());
+        _collector.add_tombstone(tombstone_kind::cell, cell.deletion_time());
         _sst.get_stats().on_cell_tombstone_write();
         return;
     }
@@ -1085,6 +1217,7 @@ void writer::write_cell(bytes_ostream& writer, const clustering_key_prefix* clus
         // than gc_grace_seconds for all data, sstable will be considered fully expired
         // when actually nothing is expired.
         _c_stats.update_local_deletion_time_and_tombstone_histogram(cell.expiry());
+        _collector.add_tombstone(tombstone_kind::expiring, cell.expiry());
     } else { // regular live cell
         _c_stats.update_local_deletion_time(std::numeric_limits<int>::max());
     }
@@ -1103,6 +1236,7 @@ void writer::write_liveness_info(bytes_ostream& writer, const row_marker& marker
     auto write_expiring_liveness_info = [this, &writer] (gc_clock::duration ttl, gc_clock::time_point ldt) {
         _c_stats.update_ttl(ttl);
         _c_stats.update_local_deletion_time_and_tombstone_histogram(ldt);
+        _collector.add_tombstone(tombstone_kind::expiring, ldt);
         write_delta_ttl(writer, ttl);
         write_delta_local_deletion_time(writer, ldt);
     };
@@ -1125,6 +1259,9 @@ void writer::write_collection(bytes_ostream& writer, const clustering_key_prefix
         if (has_complex_deletion) {
             write_delta_deletion_time(writer, mview.tomb);
             _c_stats.update(mview.tomb);
+            if (mview.tomb) {
+                _collector.add_tombstone(tombstone_kind::cell, mview.tomb.deletion_time);
+            }
         }
 
         collection_elements = mview.cells.size();
@@ -1157,6 +1294,9 @@ void writer::write_cells(bytes_ostream& writer, const clustering_key_prefix* clu
         atomic_cell_view cell = c.as_atomic_cell(column_definition);
         ++_c_stats.cells_count;
         ++_c_stats.column_count;
+        if (kind == column_kind::regular_column && _cfg.column_value_stats) {
+            _collector.update_column_value(column_definition, cell);
+        }
         write_cell(writer, clustering_key, cell, column_definition, properties);
     });
 
@@ -1170,6 +1310,7 @@ void writer::write_row_body(bytes_ostream& writer, const clustering_row& row, bo
     write_liveness_info(writer, row.marker());
     auto write_tombstone_and_update_stats = [this, &writer] (const tombstone& t) {
         _c_stats.do_update(t);
+        _collector.add_tombstone(tombstone_kind::row, t.deletion_time);
         do_write_delta_deletion_time(writer, t);
     };
     if (row.tomb().regular()) {
@@ -1283,6 +1424,7 @@ void writer::write_clustered(const clustering_row& clustered_row, uint64_t prev_
 
     // Collect statistics
     _collector.update_min_max_components(clustered_row.position());
+    _collector.add_clustering_row();
     collect_row_stats(_data_writer->offset() - current_pos, &clustered_row.key());
 }
 
@@ -1295,6 +1437,12 @@ stop_iteration writer::consume(clustering_row&& cr) {
     ensure_tombstone_is_written();
     ensure_static_row_is_written_if_needed();
     write_clustered(cr);
+    if (cr.key().is_full(_schema)) {
+        add_clustering_filter_key(&cr.key());
+    } else {
+        // Rows with a clustering key prefix cover other rows, like range tombstones do.
+        _ck_filter.partition_has_range_tombstones = true;
+    }
 
     auto can_split_partition_at_clustering_boundary = [this] {
         // will allow size limit to be exceeded for 10%, so we won't perform unnecessary split
@@ -1370,9 +1518,13 @@ void writer::write_clustered(const rt_marker& marker, uint64_t prev_row_size) {
     auto write_marker_body = [this, &marker] (bytes_ostream& writer) {
         write_delta_deletion_time(writer, marker.tomb);
         _c_stats.update(marker.tomb);
+        if (marker.tomb) {
+            _collector.add_tombstone(tombstone_kind::range, marker.tomb.deletion_time);
+        }
         if (marker.boundary_tomb) {
             do_write_delta_deletion_time(writer, *marker.boundary_tomb);
             _c_stats.do_update(*marker.boundary_tomb);
+            _collector.add_tombstone(tombstone_kind::range, marker.boundary_tomb->deletion_time);
         }
     };
 
@@ -1394,6 +1546,7 @@ stop_iteration writer::consume(range_tombstone_change&& rtc) {
     if (!_current_tombstone && !rtc.tombstone()) {
         return stop_iteration::no;
     }
+    _ck_filter.partition_has_range_tombstones = true;
     tombstone prev_tombstone = std::exchange(_current_tombstone, rtc.tombstone());
     if (!prev_tombstone) { // start bound
         auto bv = pos.as_start_bound_view();
@@ -1421,6 +1574,7 @@ stop_iteration writer::consume_end_of_partition() {
     }
 
     write_promoted_index();
+    seal_clustering_filter_partition();
 
     // compute size of the current row.
     _c_stats.partition_size = _data_writer->offset() - _c_stats.start_offset;
@@ -1451,6 +1605,7 @@ void writer::consume_end_of_stream() {
 
     close_writer(_index_writer);
     _sst.set_first_and_last_keys();
+    auto se_stats = make_summary_entry_stats();
 
     _sst._components->statistics.contents[metadata_type::Serialization] = std::make_unique<serialization_header>(std::move(_sst_schema.header));
     seal_statistics(_sst.get_version(), _sst._components->statistics, _collector,
@@ -1459,6 +1614,8 @@ void writer::consume_end_of_stream() {
     close_data_writer();
     _sst.write_summary();
     _sst.write_filter();
+    seal_clustering_filter();
+    _sst.write_clustering_filter();
     _sst.write_statistics();
     _sst.write_compression();
     auto features = sstable_enabled_features::all();
@@ -1474,7 +1631,14 @@ void writer::consume_end_of_stream() {
     });
     const dht::sharder& sharder = _cfg.erm ? _cfg.erm->get_sharder(_schema)
                                            : _schema.get_sharder(); // Used in tests
-    _sst.write_scylla_metadata(_shard, sharder, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin);
+    scylla_metadata::column_value_stats cv_stats;
+    if (_cfg.column_value_stats) {
+        _collector.construct_column_value_stats(cv_stats);
+    }
+    scylla_metadata::tombstone_stats ts_stats;
+    _collector.construct_tombstone_stats(ts_stats);
+    _sst.write_scylla_metadata(_shard, sharder, std::move(features), std::move(identifier), std::move(ld_stats), _cfg.origin,
+            std::move(cv_stats), std::move(ts_stats), _cfg.compaction_checkpoint, std::move(se_stats));
     _sst.seal_sstable(_cfg.backup).get();
 }
 
@@ -14,6 +14,7 @@
 #include <seastar/core/loop.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/util/bool_class.hh>
 #include "utils/loading_shared_values.hh"
 #include "utils/chunked_vector.hh"
 #include "utils/bptree.hh"
@@ -28,9 +29,15 @@ namespace sstables {
 // Supports asynchronous insertion, ensures that only one entry will be loaded.
 // Entries without a live entry_ptr are linked in the LRU.
 // The instance must be destroyed only after all live_ptr:s are gone.
+//
+// Entries can be loaded on probation, which is meant for pages touched by scans.
+// Until requested again, such entries are linked at the cold end of the LRU, so
+// that a single pass over the index doesn't push out the pages which are hot
+// for point reads.
 class partition_index_cache {
 public:
     using key_type = uint64_t;
+    using on_probation = bool_class<struct on_probation_tag>;
 private:
     // Allocated inside LSA
     class entry final : public index_evictable, public lsa::weakly_referencable<entry> {
@@ -39,11 +46,13 @@ class partition_index_cache {
         key_type _key;
         std::variant<lw_shared_ptr<shared_promise<>>, partition_index_page> _page;
         size_t _size_in_allocator = 0;
+        bool _on_probation;
     public:
-        entry(partition_index_cache* parent, key_type key)
+        entry(partition_index_cache* parent, key_type key, on_probation probation)
                 : _parent(parent)
                 , _key(key)
                 , _page(make_lw_shared<shared_promise<>>())
+                , _on_probation(bool(probation))
         { }
 
         void set_page(partition_index_page&& page) noexcept {
@@ -113,7 +122,11 @@ class partition_index_cache {
         entry_ptr& operator=(std::nullptr_t) noexcept {
             if (_ref) {
                 if (_ref.unique() && _ref->ready()) {
-                    _ref->_parent->_lru.add(*_ref);
+                    if (_ref->_on_probation) {
+                        _ref->_parent->_lru.add_cold(*_ref);
+                    } else {
+                        _ref->_parent->_lru.add(*_ref);
+                    }
                 }
                 _ref = nullptr;
             }
@@ -154,6 +167,8 @@ class partition_index_cache {
     logalloc::allocating_section _as;
     lru& _lru;
     partition_index_cache_stats& _stats;
+    // Memory used by the loaded pages of this cache, _stats is shared by all caches.
+    size_t _used_bytes = 0;
 public:
 
     // Create a cache with a given LRU attached.
@@ -184,13 +199,20 @@ class partition_index_cache {
     //
     // The loader object does not survive deferring, so the caller must deal with its liveness.
     //
+    // A missing entry is inserted on probation if requested so. An entry which
+    // is on probation gets promoted once it is requested again, by any reader.
+    //
     // The returned future must be waited on before destroying this instance.
     template<typename Loader>
-    future<entry_ptr> get_or_load(const key_type& key, Loader&& loader) {
+    future<entry_ptr> get_or_load(const key_type& key, Loader&& loader, on_probation probation = on_probation::no) {
         auto i = _cache.lower_bound(key);
         if (i != _cache.end() && i->_key == key) {
             entry& cp = *i;
             auto ptr = share(cp);
+            if (cp._on_probation) {
+                cp._on_probation = false;
+                ++_stats.promotions;
+            }
             if (cp.ready()) {
                 ++_stats.hits;
                 return make_ready_future<entry_ptr>(std::move(ptr));
@@ -207,7 +229,7 @@ class partition_index_cache {
 
         entry_ptr ptr = _as(_region, [&] {
             return with_allocator(_region.allocator(), [&] {
-                auto it_and_flag = _cache.emplace(key, this, key);
+                auto it_and_flag = _cache.emplace(key, this, key, probation);
                 entry &cp = *it_and_flag.first;
                 assert(it_and_flag.second);
                 try {
@@ -228,7 +250,11 @@ class partition_index_cache {
                 e.promise()->set_value();
                 e.set_page(std::move(page));
                 _stats.used_bytes += e.size_in_allocator();
+                _used_bytes += e.size_in_allocator();
                 ++_stats.populations;
+                if (e._on_probation) {
+                    ++_stats.probationary_populations;
+                }
                 return ptr;
             } catch (...) {
                 e.promise()->set_exception(std::current_exception());
@@ -243,9 +269,25 @@ class partition_index_cache {
 
     void on_evicted(entry& p) {
         _stats.used_bytes -= p.size_in_allocator();
+        _used_bytes -= p.size_in_allocator();
         ++_stats.evictions;
     }
 
+    size_t used_bytes() const {
+        return _used_bytes;
+    }
+
+    // Returns the keys of the loaded entries which are not on probation, in increasing order.
+    std::vector<key_type> hot_keys() {
+        std::vector<key_type> keys;
+        for (auto i = _cache.begin(); i != _cache.end(); ++i) {
+            if (i->ready() && !i->_on_probation) {
+                keys.push_back(i->key());
+            }
+        }
+        return keys;
+    }
+
     // Evicts all unreferenced entries.
     future<> evict_gently() {
         auto i = _cache.begin();
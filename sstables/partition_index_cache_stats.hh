@@ -16,5 +16,7 @@ struct partition_index_cache_stats {
     uint64_t blocks = 0; // Number of times entry was not ready (>= misses)
     uint64_t evictions = 0; // Number of times entry was evicted
     uint64_t populations = 0; // Number of times entry was inserted
+    uint64_t probationary_populations = 0; // Number of times entry was inserted on probation (<= populations)
+    uint64_t promotions = 0; // Number of times entry on probation was requested again
     uint64_t used_bytes = 0; // Number of bytes entries occupy in memory
 };
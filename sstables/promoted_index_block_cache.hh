@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include "mutation/position_in_partition.hh"
+#include "sstables/types.hh"
+#include "utils/bptree.hh"
+#include "utils/lru.hh"
+#include "utils/logalloc.hh"
+#include "sstables/promoted_index_block_cache_stats.hh"
+
+namespace sstables {
+
+// Cache of parsed promoted index blocks of one sstable, shared by all its readers.
+//
+// Blocks are keyed by the position of the promoted index in the index file,
+// which identifies the partition, and by their number within the promoted index.
+// Entries live in the cache region and are linked in the LRU, so they compete
+// for memory with the rest of the index cache. Readers never hold references
+// to the entries, they copy the blocks they need out of them, so any entry
+// can be evicted at any time.
+//
+// The instance must be destroyed in the same LSA context as the region.
+class promoted_index_block_cache {
+public:
+    struct key_type {
+        uint64_t promoted_index_start;
+        uint32_t block_index;
+
+        bool operator<(const key_type& o) const noexcept {
+            return std::tie(promoted_index_start, block_index) < std::tie(o.promoted_index_start, o.block_index);
+        }
+        bool operator==(const key_type&) const noexcept = default;
+    };
+
+    // Fully parsed promoted index block.
+    struct block {
+        position_in_partition start;
+        position_in_partition end;
+        std::optional<deletion_time> end_open_marker;
+        uint64_t data_file_offset;
+        uint64_t width;
+
+        size_t external_memory_usage() const noexcept {
+            return start.external_memory_usage() + end.external_memory_usage();
+        }
+    };
+private:
+    // Allocated inside LSA
+    class entry final : public index_evictable {
+    public:
+        promoted_index_block_cache* _parent;
+        key_type _key;
+        block _block;
+        size_t _size_in_allocator;
+    public:
+        entry(promoted_index_block_cache* parent, key_type key, const block& b)
+                : _parent(parent)
+                , _key(key)
+                , _block(b)
+                , _size_in_allocator(sizeof(entry) + _block.external_memory_usage())
+        { }
+
+        entry(entry&&) noexcept = default;
+
+        void on_evicted() noexcept override;
+
+        size_t size_in_allocator() const noexcept { return _size_in_allocator; }
+        key_type key() const noexcept { return _key; }
+    };
+
+    struct key_less_comparator {
+        bool operator()(const key_type& lhs, const key_type& rhs) const noexcept {
+            return lhs < rhs;
+        }
+    };
+
+    using cache_type = bplus::tree<key_type, entry, key_less_comparator, 8, bplus::key_search::binary>;
+    cache_type _cache;
+    logalloc::region& _region;
+    logalloc::allocating_section _as;
+    lru& _lru;
+    promoted_index_block_cache_stats& _stats;
+
+    void on_evicted(entry& e) noexcept {
+        _stats.used_bytes -= e.size_in_allocator();
+        --_stats.block_count;
+        ++_stats.evictions;
+    }
+public:
+    promoted_index_block_cache(lru& lru_, logalloc::region& r, promoted_index_block_cache_stats& stats)
+            : _cache(key_less_comparator())
+            , _region(r)
+            , _lru(lru_)
+            , _stats(stats)
+    { }
+
+    ~promoted_index_block_cache() {
+        with_allocator(_region.allocator(), [&] {
+            _cache.clear_and_dispose([this] (entry* e) noexcept {
+                _lru.remove(*e);
+                on_evicted(*e);
+            });
+        });
+    }
+
+    promoted_index_block_cache(promoted_index_block_cache&&) = delete;
+    promoted_index_block_cache(const promoted_index_block_cache&) = delete;
+
+    // Returns a copy of the cached block, allocated in the current allocator,
+    // or std::nullopt if it's not cached.
+    std::optional<block> get(const key_type& key) {
+        return _as(_region, [&] () -> std::optional<block> {
+            auto i = _cache.find(key);
+            if (i == _cache.end()) {
+                ++_stats.misses;
+                return std::nullopt;
+            }
+            ++_stats.hits;
+            _lru.touch(*i);
+            return i->_block;
+        });
+    }
+
+    // Inserts a copy of the block, unless it's already cached.
+    void put(const key_type& key, const block& b) {
+        _as(_region, [&] {
+            with_allocator(_region.allocator(), [&] {
+                auto [i, inserted] = _cache.emplace(key, this, key, b);
+                if (!inserted) {
+                    return;
+                }
+                _lru.add(*i);
+                _stats.used_bytes += i->size_in_allocator();
+                ++_stats.block_count;
+                ++_stats.populations;
+            });
+        });
+    }
+
+    // Evicts all entries.
+    future<> evict_gently() {
+        auto i = _cache.begin();
+        while (i != _cache.end()) {
+            with_allocator(_region.allocator(), [&] {
+                _lru.remove(*i);
+                on_evicted(*i);
+                i = i.erase(key_less_comparator());
+            });
+            if (need_preempt() && i != _cache.end()) {
+                auto key = i->key();
+                co_await coroutine::maybe_yield();
+                i = _cache.lower_bound(key);
+            }
+        }
+    }
+};
+
+inline
+void promoted_index_block_cache::entry::on_evicted() noexcept {
+    _parent->on_evicted(*this);
+    cache_type::iterator it(this);
+    it.erase(key_less_comparator());
+}
+
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+
+struct promoted_index_block_cache_stats {
+    uint64_t hits = 0; // Number of times a parsed block was found
+    uint64_t misses = 0; // Number of times a parsed block was not found
+    uint64_t evictions = 0; // Number of times a block was evicted
+    uint64_t populations = 0; // Number of times a block was inserted
+    uint64_t block_count = 0; // Number of blocks currently cached
+    uint64_t used_bytes = 0; // Number of bytes blocks occupy in memory
+};
@@ -19,6 +19,9 @@ namespace sstables {
 struct shareable_components {
     sstables::compression compression;
     utils::filter_ptr filter;
+    // Filter over the full primary keys of rows in wide partitions,
+    // null unless the sstable has the ClusteringFilter component.
+    utils::filter_ptr clustering_filter;
     sstables::summary summary;
     sstables::statistics statistics;
     std::optional<sstables::scylla_metadata> scylla_metadata;
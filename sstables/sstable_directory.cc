@@ -153,11 +153,15 @@ future<sstables::shared_sstable> sstable_directory::load_sstable(sstables::entry
 future<sstables::shared_sstable> sstable_directory::load_sstable(sstables::entry_descriptor desc, process_flags flags) const {
     auto sst = co_await load_sstable(std::move(desc), flags.sstable_open_config);
     validate(sst, flags);
+    co_await maybe_mutate_level(sst, flags);
+    co_return sst;
+}
+
+future<> sstable_directory::maybe_mutate_level(sstables::shared_sstable sst, process_flags flags) const {
     if (flags.need_mutate_level) {
         dirlog.trace("Mutating {} to level 0\n", sst->get_filename());
         co_await sst->mutate_sstable_level(0);
     }
-    co_return sst;
 }
 
 future<>
@@ -174,32 +178,34 @@ sstable_directory::process_descriptor(sstables::entry_descriptor desc, process_f
     }
 }
 
-future<std::vector<shard_id>> sstable_directory::get_shards_for_this_sstable(const sstables::entry_descriptor& desc, process_flags flags) const {
+future<sstables::shared_sstable> sstable_directory::load_owner_shards(const sstables::entry_descriptor& desc, process_flags flags) const {
     auto sst = _manager.make_sstable(_schema, _table_dir, *_storage_opts, desc.generation, _state, desc.version, desc.format, gc_clock::now(), _error_handler_gen);
     co_await sst->load_owner_shards(_sharder);
     validate(sst, flags);
-    co_return sst->get_shards_for_this_sstable();
-}
-
-future<foreign_sstable_open_info> sstable_directory::get_open_info_for_this_sstable(const sstables::entry_descriptor& desc) const {
-    auto sst = co_await load_sstable(std::move(desc));
-    co_return co_await sst->get_open_info();
+    co_return sst;
 }
 
 future<>
 sstable_directory::sort_sstable(sstables::entry_descriptor desc, process_flags flags) {
-    auto shards = co_await get_shards_for_this_sstable(desc, flags);
+    // The sstable used to compute the owners already holds the Scylla and
+    // Statistics components, so finish loading that very object for local and
+    // shared sstables instead of opening a fresh one and parsing them again.
+    auto sst = co_await load_owner_shards(desc, flags);
+    auto shards = sst->get_shards_for_this_sstable();
     if (shards.size() == 1) {
         if (shards[0] == this_shard_id()) {
             dirlog.trace("{} identified as a local unshared SSTable", sstable_filename(desc));
-            _unshared_local_sstables.push_back(co_await load_sstable(std::move(desc), flags));
+            co_await sst->load(_sharder, flags.sstable_open_config);
+            co_await maybe_mutate_level(sst, flags);
+            _unshared_local_sstables.push_back(std::move(sst));
         } else {
             dirlog.trace("{} identified as a remote unshared SSTable, shard={}", sstable_filename(desc), shards[0]);
             _unshared_remote_sstables[shards[0]].push_back(std::move(desc));
         }
     } else {
         dirlog.trace("{} identified as a shared SSTable, shards={}", sstable_filename(desc), shards);
-        _shared_sstable_info.push_back(co_await get_open_info_for_this_sstable(desc));
+        co_await sst->load(_sharder);
+        _shared_sstable_info.push_back(co_await sst->get_open_info());
     }
 }
 
@@ -429,6 +435,16 @@ sstable_directory::load_foreign_sstables(sstable_entry_descriptor_vector info_ve
     });
 }
 
+future<>
+sstable_directory::load_unsorted_sstables(sstable_entry_descriptor_vector info_vec, sstables::sstable_open_config cfg) {
+    co_await parallel_for_each_restricted(info_vec, [this, cfg] (const sstables::entry_descriptor& info) {
+        return load_sstable(info, cfg).then([this] (auto sst) {
+            _unsorted_sstables.push_back(sst);
+            return make_ready_future<>();
+        });
+    });
+}
+
 future<>
 sstable_directory::remove_sstables(std::vector<sstables::shared_sstable> sstlist) {
     dirlog.debug("Removing {} SSTables", sstlist.size());
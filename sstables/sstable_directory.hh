@@ -174,6 +174,7 @@ class sstable_directory {
     void validate(sstables::shared_sstable sst, process_flags flags) const;
     future<sstables::shared_sstable> load_sstable(sstables::entry_descriptor desc, sstables::sstable_open_config cfg = {}) const;
     future<sstables::shared_sstable> load_sstable(sstables::entry_descriptor desc, process_flags flags) const;
+    future<> maybe_mutate_level(sstables::shared_sstable sst, process_flags flags) const;
 
     template <std::ranges::range Container, typename Func>
     requires std::is_invocable_r_v<future<>, Func, typename std::ranges::range_value_t<Container>&>
@@ -186,10 +187,9 @@ class sstable_directory {
     // Returns filename for a SSTable from its entry_descriptor.
     sstring sstable_filename(const sstables::entry_descriptor& desc) const;
 
-    // Compute owner of shards for a particular SSTable.
-    future<std::vector<shard_id>> get_shards_for_this_sstable(const sstables::entry_descriptor& desc, process_flags flags) const;
-    // Retrieves sstables::foreign_sstable_open_info for a particular SSTable.
-    future<foreign_sstable_open_info> get_open_info_for_this_sstable(const sstables::entry_descriptor& desc) const;
+    // Compute owner of shards for a particular SSTable. The returned sstable is
+    // only partially loaded and can be completed with sstable::load().
+    future<sstables::shared_sstable> load_owner_shards(const sstables::entry_descriptor& desc, process_flags flags) const;
 
 public:
     sstable_directory(replica::table& table,
@@ -207,6 +207,11 @@ class sstable_directory {
         return _unsorted_sstables;
     }
 
+    // Loads on this shard SSTables that another shard found while processing the directory
+    // unsorted, and adds them to the unsorted list. Any shard can stream any SSTable with
+    // load-and-stream, so the SSTables can be moved around to balance the work among shards.
+    future<> load_unsorted_sstables(sstable_entry_descriptor_vector info_vec, sstables::sstable_open_config cfg);
+
     future<shared_sstable> load_foreign_sstable(foreign_sstable_open_info& info);
 
     // moves unshared SSTables that don't belong to this shard to the right shards.
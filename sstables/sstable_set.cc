@@ -7,18 +7,21 @@
  */
 
 #include <seastar/util/defer.hh>
+#include <seastar/coroutine/parallel_for_each.hh>
 
-#include <boost/icl/interval_map.hpp>
+#include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/numeric.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
 #include <boost/range/algorithm/sort.hpp>
 
 #include "sstables.hh"
 
-#include "compatible_ring_position.hh"
 #include "compaction/compaction_strategy_impl.hh"
 #include "compaction/leveled_compaction_strategy.hh"
 #include "compaction/time_window_compaction_strategy.hh"
+#include "compaction/incremental_compaction_strategy.hh"
 
 #include "sstable_set_impl.hh"
 
@@ -26,6 +29,7 @@
 #include "readers/from_mutations_v2.hh"
 #include "readers/empty_v2.hh"
 #include "readers/combined.hh"
+#include "readers/delegating_v2.hh"
 
 namespace sstables {
 
@@ -220,86 +224,89 @@ sstable_set::make_incremental_selector() const {
     return incremental_selector(std::get<0>(std::move(selector)), std::get<1>(selector));
 }
 
-partitioned_sstable_set::interval_type partitioned_sstable_set::make_interval(const schema& s, const dht::partition_range& range) {
-    return interval_type::closed(
-            compatible_ring_position_or_view(s, dht::ring_position_view(range.start()->value())),
-            compatible_ring_position_or_view(s, dht::ring_position_view(range.end()->value())));
+static dht::ring_position_view first_position(const shared_sstable& sst) {
+    return dht::ring_position_view(sst->get_first_decorated_key());
 }
 
-partitioned_sstable_set::interval_type partitioned_sstable_set::make_interval(const dht::partition_range& range) const {
-    return make_interval(*_schema, range);
+static dht::ring_position_view last_position(const shared_sstable& sst) {
+    return dht::ring_position_view(sst->get_last_decorated_key());
 }
 
-partitioned_sstable_set::interval_type partitioned_sstable_set::make_interval(const schema_ptr& s, const sstable& sst) {
-    return interval_type::closed(
-            compatible_ring_position_or_view(s, dht::ring_position(sst.get_first_decorated_key())),
-            compatible_ring_position_or_view(s, dht::ring_position(sst.get_last_decorated_key())));
-}
-
-partitioned_sstable_set::interval_type partitioned_sstable_set::make_interval(const sstable& sst) {
-    return make_interval(_schema, sst);
+disjoint_sstable_layer::const_iterator disjoint_sstable_layer::lower_bound(const schema& s, dht::ring_position_view pos) const {
+    dht::ring_position_comparator cmp(s);
+    auto ends_before_pos = [&] (const shared_sstable& sst) {
+        return cmp(last_position(sst), pos) < 0;
+    };
+    auto c = std::partition_point(_chunks.begin(), _chunks.end(), [&] (const lw_shared_ptr<const chunk>& c) {
+        return ends_before_pos(c->back());
+    });
+    if (c == _chunks.end()) {
+        return end();
+    }
+    auto i = std::partition_point((*c)->begin(), (*c)->end(), ends_before_pos);
+    return const_iterator(*this, c - _chunks.begin(), i - (*c)->begin());
 }
 
-partitioned_sstable_set::interval_type partitioned_sstable_set::singular(const dht::ring_position& rp) const {
-    // We should use the view here, since this is used for queries.
-    auto rpv = dht::ring_position_view(rp);
-    auto crp = compatible_ring_position_or_view(*_schema, std::move(rpv));
-    return interval_type::closed(crp, crp);
+bool disjoint_sstable_layer::insert(const schema& s, shared_sstable sst) {
+    dht::ring_position_comparator cmp(s);
+    auto it = lower_bound(s, first_position(sst));
+    if (it != end() && cmp(first_position(*it), last_position(sst)) <= 0) {
+        return false;
+    }
+    if (_chunks.empty()) {
+        _chunks.push_back(make_lw_shared<const chunk>(chunk{std::move(sst)}));
+        _size++;
+        return true;
+    }
+    auto ci = it._chunk;
+    auto idx = it._idx;
+    if (ci == _chunks.size()) {
+        idx = _chunks[--ci]->size();
+    }
+    auto c = *_chunks[ci];
+    c.insert(c.begin() + idx, std::move(sst));
+    if (c.size() > max_chunk_size) {
+        auto half = c.size() / 2;
+        auto tail = make_lw_shared<const chunk>(std::make_move_iterator(c.begin() + half), std::make_move_iterator(c.end()));
+        c.resize(half);
+        auto head = make_lw_shared<const chunk>(std::move(c));
+        _chunks.insert(_chunks.begin() + ci + 1, std::move(tail));
+        _chunks[ci] = std::move(head);
+    } else {
+        _chunks[ci] = make_lw_shared<const chunk>(std::move(c));
+    }
+    _size++;
+    return true;
 }
 
-std::pair<partitioned_sstable_set::map_iterator, partitioned_sstable_set::map_iterator>
-partitioned_sstable_set::query(const dht::partition_range& range) const {
-    if (range.start() && range.end()) {
-        return _leveled_sstables.equal_range(make_interval(range));
+bool disjoint_sstable_layer::erase(const schema& s, const shared_sstable& sst) {
+    // All sstables ordered before sst end before its first key, so this is sst if it's in the layer.
+    auto it = lower_bound(s, first_position(sst));
+    if (it == end() || *it != sst) {
+        return false;
     }
-    else if (range.start() && !range.end()) {
-        auto start = singular(range.start()->value());
-        return { _leveled_sstables.lower_bound(start), _leveled_sstables.end() };
-    } else if (!range.start() && range.end()) {
-        auto end = singular(range.end()->value());
-        return { _leveled_sstables.begin(), _leveled_sstables.upper_bound(end) };
+    if (_chunks[it._chunk]->size() == 1) {
+        _chunks.erase(_chunks.begin() + it._chunk);
     } else {
-        return { _leveled_sstables.begin(), _leveled_sstables.end() };
+        auto c = *_chunks[it._chunk];
+        c.erase(c.begin() + it._idx);
+        _chunks[it._chunk] = make_lw_shared<const chunk>(std::move(c));
     }
+    _size--;
+    return true;
 }
 
 bool partitioned_sstable_set::store_as_unleveled(const shared_sstable& sst) const {
     return _use_level_metadata && sst->get_sstable_level() == 0;
 }
 
-dht::ring_position partitioned_sstable_set::to_ring_position(const compatible_ring_position_or_view& crp) {
-    // Ring position views, representing bounds of sstable intervals are
-    // guaranteed to have key() != nullptr;
-    const auto& pos = crp.position();
-    return dht::ring_position(pos.token(), *pos.key());
-}
-
-dht::partition_range partitioned_sstable_set::to_partition_range(const interval_type& i) {
-    return dht::partition_range::make(
-            {to_ring_position(i.lower()), boost::icl::is_left_closed(i.bounds())},
-            {to_ring_position(i.upper()), boost::icl::is_right_closed(i.bounds())});
-}
-
-dht::partition_range partitioned_sstable_set::to_partition_range(const dht::ring_position_view& pos, const interval_type& i) {
-    auto lower_bound = [&] {
-        if (pos.key()) {
-            return dht::partition_range::bound(dht::ring_position(pos.token(), *pos.key()),
-                    pos.is_after_key() == dht::ring_position_view::after_key::no);
-        } else {
-            return dht::partition_range::bound(dht::ring_position(pos.token(), pos.get_token_bound()), true);
-        }
-    }();
-    auto upper_bound = dht::partition_range::bound(to_ring_position(i.lower()), !boost::icl::is_left_closed(i.bounds()));
-    return dht::partition_range::make(std::move(lower_bound), std::move(upper_bound));
-}
-
 partitioned_sstable_set::partitioned_sstable_set(schema_ptr schema, bool use_level_metadata)
         : _schema(std::move(schema))
         , _all(make_lw_shared<sstable_list>())
         , _use_level_metadata(use_level_metadata) {
 }
 
-partitioned_sstable_set::partitioned_sstable_set(schema_ptr schema, const std::vector<shared_sstable>& unleveled_sstables, const interval_map_type& leveled_sstables,
+partitioned_sstable_set::partitioned_sstable_set(schema_ptr schema, const std::vector<shared_sstable>& unleveled_sstables, const std::vector<disjoint_sstable_layer>& leveled_sstables,
         const lw_shared_ptr<sstable_list>& all, const std::unordered_map<run_id, shared_sstable_run>& all_runs, bool use_level_metadata, uint64_t bytes_on_disk)
         : sstable_set_impl(bytes_on_disk)
         , _schema(schema)
@@ -315,15 +322,15 @@ std::unique_ptr<sstable_set_impl> partitioned_sstable_set::clone() const {
 }
 
 std::vector<shared_sstable> partitioned_sstable_set::select(const dht::partition_range& range) const {
-    auto ipair = query(range);
-    auto b = std::move(ipair.first);
-    auto e = std::move(ipair.second);
-    value_set result;
-    while (b != e) {
-        boost::copy(b++->second, std::inserter(result, result.end()));
-    }
+    dht::ring_position_comparator cmp(*_schema);
+    auto start = dht::ring_position_view::for_range_start(range);
+    auto end = dht::ring_position_view::for_range_end(range);
     auto r = _unleveled_sstables;
-    r.insert(r.end(), result.begin(), result.end());
+    for (const auto& layer : _leveled_sstables) {
+        for (auto it = layer.lower_bound(*_schema, start); it != layer.end() && cmp(first_position(*it), end) <= 0; ++it) {
+            r.push_back(*it);
+        }
+    }
     return r;
 }
 
@@ -383,8 +390,15 @@ bool partitioned_sstable_set::insert(shared_sstable sst) {
     if (store_as_unleveled(sst)) {
         _unleveled_sstables.push_back(sst);
     } else {
-        _leveled_sstables_change_cnt++;
-        _leveled_sstables.add({make_interval(*sst), value_set({sst})});
+        auto layer = std::ranges::find_if(_leveled_sstables, [&] (disjoint_sstable_layer& layer) {
+            return layer.insert(*_schema, sst);
+        });
+        if (layer == _leveled_sstables.end()) {
+            disjoint_sstable_layer new_layer;
+            // Always succeeds, an empty layer has nothing to overlap with.
+            (void)new_layer.insert(*_schema, sst);
+            _leveled_sstables.push_back(std::move(new_layer));
+        }
     }
     undo_all_insert.cancel();
     undo_all_runs_insert.cancel();
@@ -405,8 +419,12 @@ bool partitioned_sstable_set::erase(shared_sstable sst) {
     if (store_as_unleveled(sst)) {
         _unleveled_sstables.erase(std::remove(_unleveled_sstables.begin(), _unleveled_sstables.end(), sst), _unleveled_sstables.end());
     } else {
-        _leveled_sstables_change_cnt++;
-        _leveled_sstables.subtract({make_interval(*sst), value_set({sst})});
+        auto layer = std::ranges::find_if(_leveled_sstables, [&] (disjoint_sstable_layer& layer) {
+            return layer.erase(*_schema, sst);
+        });
+        if (layer != _leveled_sstables.end() && layer->empty()) {
+            _leveled_sstables.erase(layer);
+        }
     }
     return ret;
 }
@@ -419,61 +437,64 @@ partitioned_sstable_set::size() const noexcept {
 class partitioned_sstable_set::incremental_selector : public incremental_selector_impl {
     schema_ptr _schema;
     const std::vector<shared_sstable>& _unleveled_sstables;
-    const interval_map_type& _leveled_sstables;
-    const uint64_t& _leveled_sstables_change_cnt;
-    uint64_t _last_known_leveled_sstables_change_cnt;
-    map_iterator _it;
-private:
-    dht::ring_position_ext next_position(map_iterator it) {
-        if (it == _leveled_sstables.end()) {
-            return dht::ring_position_view::max();
-        } else {
-            auto&& next_position = partitioned_sstable_set::to_ring_position(it->first.lower());
-            return dht::ring_position_ext(next_position, dht::ring_position_ext::after_key(!boost::icl::is_left_closed(it->first.bounds())));
-        }
-    }
-    static bool is_before_interval(const compatible_ring_position_or_view& crp, const interval_type& interval) {
-        if (boost::icl::is_left_closed(interval.bounds())) {
-            return crp < interval.lower();
-        } else {
-            return crp <= interval.lower();
-        }
-    }
-    void maybe_invalidate_iterator(const compatible_ring_position_or_view& crp) {
-        if (_last_known_leveled_sstables_change_cnt != _leveled_sstables_change_cnt) {
-            _it = _leveled_sstables.lower_bound(interval_type::closed(crp, crp));
-            _last_known_leveled_sstables_change_cnt = _leveled_sstables_change_cnt;
-        }
-    }
+    const std::vector<disjoint_sstable_layer>& _leveled_sstables;
 public:
-    incremental_selector(schema_ptr schema, const std::vector<shared_sstable>& unleveled_sstables, const interval_map_type& leveled_sstables,
-                         const uint64_t& leveled_sstables_change_cnt)
+    incremental_selector(schema_ptr schema, const std::vector<shared_sstable>& unleveled_sstables, const std::vector<disjoint_sstable_layer>& leveled_sstables)
         : _schema(std::move(schema))
         , _unleveled_sstables(unleveled_sstables)
-        , _leveled_sstables(leveled_sstables)
-        , _leveled_sstables_change_cnt(leveled_sstables_change_cnt)
-        , _last_known_leveled_sstables_change_cnt(leveled_sstables_change_cnt)
-        , _it(leveled_sstables.begin()) {
+        , _leveled_sstables(leveled_sstables) {
     }
     virtual std::tuple<dht::partition_range, std::vector<shared_sstable>, dht::ring_position_ext> select(const dht::ring_position_view& pos) override {
-        auto crp = compatible_ring_position_or_view(*_schema, pos);
-        auto ssts = _unleveled_sstables;
         using namespace dht;
+        ring_position_comparator cmp(*_schema);
+        auto ssts = _unleveled_sstables;
 
-        maybe_invalidate_iterator(crp);
+        // The selection holds over the intersection of the ranges around pos over which
+        // no layer's selection changes, each of them being either the range of the sstable
+        // containing pos or the gap between two sstables. Bounds are kept as positions
+        // in the ring, the lower one inclusive and the upper one exclusive.
+        std::optional<ring_position_view> lower;
+        std::optional<ring_position_view> upper;
+        std::optional<ring_position_view> next;
+        auto raise_lower = [&] (ring_position_view p) {
+            if (!lower || cmp(*lower, p) < 0) {
+                lower = p;
+            }
+        };
+        auto reduce_upper = [&] (std::optional<ring_position_view>& bound, ring_position_view p) {
+            if (!bound || cmp(p, *bound) < 0) {
+                bound = p;
+            }
+        };
 
-        while (_it != _leveled_sstables.end()) {
-            if (boost::icl::contains(_it->first, crp)) {
-                ssts.insert(ssts.end(), _it->second.begin(), _it->second.end());
-                return std::make_tuple(partitioned_sstable_set::to_partition_range(_it->first), std::move(ssts), next_position(std::next(_it)));
+        for (const auto& layer : _leveled_sstables) {
+            auto it = layer.lower_bound(*_schema, pos);
+            if (it != layer.begin()) {
+                raise_lower(ring_position_view::for_after_key((*std::prev(it))->get_last_decorated_key()));
+            }
+            if (it == layer.end()) {
+                continue;
             }
-            // We don't want to skip current interval if pos lies before it.
-            if (is_before_interval(crp, _it->first)) {
-                return std::make_tuple(partitioned_sstable_set::to_partition_range(pos, _it->first), std::move(ssts), next_position(_it));
+            if (cmp(first_position(*it), pos) <= 0) {
+                ssts.push_back(*it);
+                raise_lower(first_position(*it));
+                reduce_upper(upper, ring_position_view::for_after_key((*it)->get_last_decorated_key()));
+                if (auto after = std::next(it); after != layer.end()) {
+                    reduce_upper(next, first_position(*after));
+                }
+            } else {
+                reduce_upper(upper, first_position(*it));
+                reduce_upper(next, first_position(*it));
             }
-            _it++;
         }
-        return std::make_tuple(partition_range::make_open_ended_both_sides(), std::move(ssts), ring_position_view::max());
+
+        auto to_bound = [] (ring_position_view p, bool inclusive) {
+            return partition_range::bound(ring_position(p.token(), *p.key()), inclusive);
+        };
+        auto range = partition_range(
+                lower ? std::make_optional(to_bound(*lower, lower->is_after_key() == ring_position_view::after_key::no)) : std::nullopt,
+                upper ? std::make_optional(to_bound(*upper, upper->is_after_key() == ring_position_view::after_key::yes)) : std::nullopt);
+        return std::make_tuple(std::move(range), std::move(ssts), next ? ring_position_ext(*next) : ring_position_ext::max());
     }
 };
 
@@ -737,11 +758,11 @@ std::unique_ptr<position_reader_queue> time_series_sstable_set::make_position_re
 }
 
 sstable_set_impl::selector_and_schema_t partitioned_sstable_set::make_incremental_selector() const {
-    return std::make_tuple(std::make_unique<incremental_selector>(_schema, _unleveled_sstables, _leveled_sstables, _leveled_sstables_change_cnt), std::cref(*_schema));
+    return std::make_tuple(std::make_unique<incremental_selector>(_schema, _unleveled_sstables, _leveled_sstables), std::cref(*_schema));
 }
 
 std::unique_ptr<sstable_set_impl> compaction_strategy_impl::make_sstable_set(schema_ptr schema) const {
-    // with use_level_metadata enabled, L0 sstables will not go to interval map, which suits well STCS.
+    // with use_level_metadata enabled, L0 sstables will not go to the disjoint layers, which suits well STCS.
     return std::make_unique<partitioned_sstable_set>(schema, true);
 }
 
@@ -749,6 +770,12 @@ std::unique_ptr<sstable_set_impl> leveled_compaction_strategy::make_sstable_set(
     return std::make_unique<partitioned_sstable_set>(std::move(schema));
 }
 
+std::unique_ptr<sstable_set_impl> incremental_compaction_strategy::make_sstable_set(schema_ptr schema) const {
+    // Fragments of a run are disjoint, so put them all into the disjoint layers, to
+    // have single-partition reads select only one fragment of each run.
+    return std::make_unique<partitioned_sstable_set>(std::move(schema));
+}
+
 std::unique_ptr<sstable_set_impl> time_window_compaction_strategy::make_sstable_set(schema_ptr schema) const {
     return std::make_unique<time_series_sstable_set>(std::move(schema), _options.enable_optimized_twcs_queries);
 }
@@ -848,20 +875,44 @@ class incremental_reader_selector : public reader_selector {
     }
 };
 
-// The returned function uses the bloom filter to check whether the given sstable
-// may have a partition given by the ring position `pos`.
+// Uses the bloom filter to check whether the given sstable may have
+// a partition given by the ring position `pos`.
 //
 // Returning `false` means the sstable doesn't have such a partition.
 // Returning `true` means it may, i.e. we don't know whether or not it does.
 //
-// Assumes the given `pos` and `schema` are alive during the function's lifetime.
-static std::predicate<const sstable&> auto
-make_pk_filter(const dht::ring_position& pos, const schema& schema) {
-    return [&pos, key = utils::make_hashed_key(static_cast<bytes_view>(key::from_partition_key(schema, *pos.key()))), cmp = dht::ring_position_comparator(schema)] (const sstable& sst) {
-        return cmp(pos, sst.get_first_decorated_key()) >= 0 &&
-               cmp(pos, sst.get_last_decorated_key()) <= 0 &&
-               sst.filter_has_key(key);
-    };
+// The key is hashed once, at construction.
+// Assumes the given `pos` and `schema` are alive during the object's lifetime.
+namespace {
+class pk_filter {
+    const dht::ring_position& _pos;
+    utils::hashed_key _key;
+    dht::ring_position_comparator _cmp;
+public:
+    pk_filter(const dht::ring_position& pos, const schema& schema)
+        : _pos(pos)
+        , _key(utils::make_hashed_key(static_cast<bytes_view>(key::from_partition_key(schema, *pos.key()))))
+        , _cmp(schema)
+    { }
+
+    // Checks the key against the sstable's first and last keys only.
+    bool in_key_range(const sstable& sst) const {
+        return _cmp(_pos, sst.get_first_decorated_key()) >= 0 &&
+               _cmp(_pos, sst.get_last_decorated_key()) <= 0;
+    }
+
+    void prefetch(const sstable& sst) const {
+        sst.filter_prefetch(_key);
+    }
+
+    bool filter_has_key(const sstable& sst) const {
+        return sst.filter_has_key(_key);
+    }
+
+    bool operator()(const sstable& sst) const {
+        return in_key_range(sst) && filter_has_key(sst);
+    }
+};
 }
 
 const sstable_predicate& default_sstable_predicate() {
@@ -869,18 +920,23 @@ const sstable_predicate& default_sstable_predicate() {
     return predicate;
 }
 
-static std::predicate<const sstable&> auto
-make_sstable_filter(const dht::ring_position& pos, const schema& schema, const sstable_predicate& predicate) {
-    return [pk_filter = make_pk_filter(pos, schema), &predicate] (const sstable& sst) {
-        return predicate(sst) && pk_filter(sst);
-    };
-}
-
-// Filter out sstables for reader using bloom filter and supplied predicate
+// Filter out sstables for reader using bloom filter and supplied predicate.
+//
+// The cheap checks are applied to all sstables first, then the filters of
+// the survivors are prefetched together so that their cache misses overlap,
+// and only then probed.
 static std::vector<shared_sstable>
 filter_sstable_for_reader(std::vector<shared_sstable>&& sstables, const schema& schema, const dht::ring_position& pos, const sstable_predicate& predicate) {
-    auto filter = [_filter = make_sstable_filter(pos, schema, predicate)] (const shared_sstable& sst) { return !_filter(*sst); };
-    sstables.erase(boost::remove_if(sstables, filter), sstables.end());
+    auto filter = pk_filter(pos, schema);
+    std::erase_if(sstables, [&] (const shared_sstable& sst) {
+        return !predicate(*sst) || !filter.in_key_range(*sst);
+    });
+    for (const auto& sst : sstables) {
+        filter.prefetch(*sst);
+    }
+    std::erase_if(sstables, [&] (const shared_sstable& sst) {
+        return !filter.filter_has_key(*sst);
+    });
     return std::move(sstables);
 }
 
@@ -923,6 +979,11 @@ sstable_set_impl::all_sstable_runs() const {
     throw_with_backtrace<std::bad_function_call>();
 }
 
+std::vector<shared_sstable>
+sstable_set_impl::select_sstables_for_key(const schema& s, const dht::ring_position& pos, const sstable_predicate& predicate) const {
+    return filter_sstable_for_reader(select(dht::partition_range::make_singular(pos)), s, pos, predicate);
+}
+
 flat_mutation_reader_v2
 sstable_set_impl::create_single_key_sstable_reader(
         replica::column_family* cf,
@@ -937,7 +998,7 @@ sstable_set_impl::create_single_key_sstable_reader(
         const sstable_predicate& predicate) const
 {
     const auto& pos = pr.start()->value();
-    auto selected_sstables = filter_sstable_for_reader(select(pr), *schema, pos, predicate);
+    auto selected_sstables = select_sstables_for_key(*schema, pos, predicate);
     auto num_sstables = selected_sstables.size();
     if (!num_sstables) {
         return make_empty_flat_reader_v2(schema, permit);
@@ -963,6 +1024,7 @@ sstable_set_impl::create_single_key_sstable_reader(
         readers.push_back(make_flat_mutation_reader_from_mutations_v2(schema, permit, mutation(schema, *pos.key()), slice, fwd));
     }
     sstable_histogram.add(num_readers);
+    sstables_stats::on_single_key_read(num_readers);
     return make_combined_reader(schema, std::move(permit), std::move(readers), fwd, fwd_mr);
 }
 
@@ -1002,8 +1064,15 @@ time_series_sstable_set::create_single_key_sstable_reader(
                 pr, slice, std::move(trace_state), fwd_sm, fwd_mr, predicate);
     }
 
-    auto sst_filter = make_sstable_filter(pos, *schema, predicate);
-    auto it = std::find_if(_sstables->begin(), _sstables->end(), [&] (const sst_entry& e) { return sst_filter(*e.second); });
+    auto key_filter = pk_filter(pos, *schema);
+    // Prefetch the filters of all candidates up front, so that the probes
+    // below don't pay for their cache misses one after another.
+    for (const auto& e : *_sstables) {
+        if (key_filter.in_key_range(*e.second)) {
+            key_filter.prefetch(*e.second);
+        }
+    }
+    auto it = std::find_if(_sstables->begin(), _sstables->end(), [&] (const sst_entry& e) { return predicate(*e.second) && key_filter(*e.second); });
     if (it == _sstables->end()) {
         // No sstables contain data for the queried partition.
         return make_empty_flat_reader_v2(std::move(schema), std::move(permit));
@@ -1016,15 +1085,14 @@ time_series_sstable_set::create_single_key_sstable_reader(
         return sst.make_reader(schema, permit, pr, slice, trace_state, fwd_sm);
     };
 
-    auto pk_filter = make_pk_filter(pos, *schema);
     auto ck_filter = [ranges = slice.get_all_ranges()] (const sstable& sst) { return sst.may_contain_rows(ranges); };
 
     // We're going to pass this filter into sstable_position_reader_queue. The queue guarantees that
     // the filter is going to be called at most once for each sstable and exactly once after
     // the queue is exhausted. We use that fact to gather statistics.
-    auto filter = [pk_filter = std::move(pk_filter), ck_filter = std::move(ck_filter), &stats]
+    auto filter = [key_filter = std::move(key_filter), ck_filter = std::move(ck_filter), &stats]
         (const sstable& sst) {
-            if (!pk_filter(sst)) {
+            if (!key_filter(sst)) {
                 return false;
             }
 
@@ -1263,6 +1331,175 @@ sstable_set::create_single_key_sstable_reader(
             std::move(permit), sstable_histogram, pr, slice, std::move(trace_state), fwd, fwd_mr, predicate);
 }
 
+// Reads a single key like sstable_set::create_single_key_sstable_reader(),
+// but can be fast-forwarded to other partition ranges.
+//
+// The readers of the sstables selected for the keys it's fast-forwarded to are kept
+// open and reused for the following keys which the sstables may contain.
+// So a batch of keys read in ring order walks the index of each sstable
+// forward once, instead of looking each key up from scratch.
+class multi_key_sstable_reader final : public flat_mutation_reader_v2::impl {
+    struct sstable_reader {
+        shared_sstable sst;
+        // The range the reader reads, has to outlive the reader until it's fast-forwarded.
+        dht::partition_range range;
+        flat_mutation_reader_v2_opt reader;
+    };
+
+    lw_shared_ptr<const sstable_set> _set;
+    replica::column_family* _cf;
+    utils::estimated_histogram& _sstable_histogram;
+    const query::partition_slice& _slice;
+    tracing::trace_state_ptr _trace_state;
+    streamed_mutation::forwarding _fwd;
+    std::unordered_map<const sstable*, sstable_reader> _readers;
+    // Combined reader of the current key over the sstable readers, or a range reader.
+    flat_mutation_reader_v2_opt _current;
+    bool _range_mode = false;
+private:
+    sstable_reader& open(const shared_sstable& sst, const dht::partition_range& pr) {
+        auto& r = _readers.emplace(sst.get(), sstable_reader{sst, pr, {}}).first->second;
+        tracing::trace(_trace_state, "Reading key {} from sstable {}", pr.start()->value(), seastar::value_of([&sst] { return sst->get_filename(); }));
+        r.reader = sst->make_reader(_schema, _permit, r.range, _slice, _trace_state, _fwd);
+        return r;
+    }
+
+    void combine(const dht::ring_position& pos, std::vector<flat_mutation_reader_v2> readers, size_t num_sstables) {
+        // See sstable_set_impl::create_single_key_sstable_reader().
+        if (readers.size() != num_sstables) {
+            readers.push_back(make_flat_mutation_reader_from_mutations_v2(_schema, _permit, mutation(_schema, *pos.key()), _slice, _fwd));
+        }
+        _sstable_histogram.add(readers.size());
+        sstables_stats::on_single_key_read(readers.size());
+        _current = make_combined_reader(_schema, _permit, std::move(readers), _fwd, mutation_reader::forwarding::no);
+    }
+
+    future<> close_current() noexcept {
+        if (_current) {
+            auto rd = std::move(*_current);
+            _current = {};
+            co_await rd.close();
+        }
+    }
+
+    future<> read_key(const dht::partition_range& pr) {
+        const auto& pos = pr.start()->value();
+        auto selected = _set->select_sstables_for_key(*_schema, pos, default_sstable_predicate());
+        const auto num_sstables = selected.size();
+        if (!num_sstables) {
+            co_return;
+        }
+        selected = filter_sstable_for_reader_by_ck(std::move(selected), *_cf, _schema, _slice);
+
+        std::vector<sstable_reader*> reused;
+        std::vector<flat_mutation_reader_v2> readers;
+        readers.reserve(selected.size() + 1);
+        for (const auto& sst : selected) {
+            auto it = _readers.find(sst.get());
+            if (it == _readers.end()) {
+                readers.push_back(make_delegating_reader(*open(sst, pr).reader));
+            } else {
+                it->second.range = pr;
+                reused.push_back(&it->second);
+                readers.push_back(make_delegating_reader(*it->second.reader));
+            }
+        }
+        co_await coroutine::parallel_for_each(reused, [] (sstable_reader* r) {
+            return r->reader->fast_forward_to(r->range);
+        });
+        combine(pos, std::move(readers), num_sstables);
+    }
+public:
+    multi_key_sstable_reader(lw_shared_ptr<const sstable_set> set, replica::column_family* cf, schema_ptr schema, reader_permit permit,
+            utils::estimated_histogram& sstable_histogram, const dht::partition_range& pr, const query::partition_slice& slice,
+            tracing::trace_state_ptr trace_state, streamed_mutation::forwarding fwd)
+        : impl(std::move(schema), std::move(permit))
+        , _set(std::move(set))
+        , _cf(cf)
+        , _sstable_histogram(sstable_histogram)
+        , _slice(slice)
+        , _trace_state(std::move(trace_state))
+        , _fwd(fwd)
+        // The first key is read like any single key, which keeps the optimizations
+        // of the sstable set for those. Only the keys after it reuse sstable readers.
+        , _current(_set->create_single_key_sstable_reader(cf, _schema, _permit, sstable_histogram, pr, slice, _trace_state, fwd,
+                mutation_reader::forwarding::no))
+    { }
+
+    virtual future<> fill_buffer() override {
+        if (!_current) {
+            _end_of_stream = true;
+            return make_ready_future<>();
+        }
+        return _current->fill_buffer().then([this] {
+            _end_of_stream = _current->is_end_of_stream();
+            _current->move_buffer_content_to(*this);
+        });
+    }
+
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty() && _current) {
+            return _current->next_partition();
+        }
+        return make_ready_future<>();
+    }
+
+    virtual future<> fast_forward_to(const dht::partition_range& pr) override {
+        clear_buffer();
+        _end_of_stream = false;
+        if (_range_mode) {
+            return _current->fast_forward_to(pr);
+        }
+        return close_current().then([this, &pr] {
+            if (pr.is_singular() && pr.start()->value().has_key()) {
+                return read_key(pr);
+            }
+            // Not a key, the range reader takes over from here on.
+            _range_mode = true;
+            _current = _set->make_local_shard_sstable_reader(_schema, _permit, pr, _slice, _trace_state, _fwd, mutation_reader::forwarding::yes);
+            return make_ready_future<>();
+        });
+    }
+
+    virtual future<> fast_forward_to(position_range pr) override {
+        _end_of_stream = false;
+        clear_buffer();
+        if (!_current) {
+            _end_of_stream = true;
+            return make_ready_future<>();
+        }
+        return _current->fast_forward_to(std::move(pr));
+    }
+
+    virtual future<> close() noexcept override {
+        co_await close_current();
+        for (auto& [sst, r] : _readers) {
+            co_await r.reader->close();
+        }
+    }
+};
+
+std::vector<shared_sstable>
+sstable_set::select_sstables_for_key(const schema& s, const dht::ring_position& pos, const sstable_predicate& predicate) const {
+    return _impl->select_sstables_for_key(s, pos, predicate);
+}
+
+flat_mutation_reader_v2
+sstable_set::create_multi_key_sstable_reader(
+        replica::column_family* cf,
+        schema_ptr schema,
+        reader_permit permit,
+        utils::estimated_histogram& sstable_histogram,
+        const dht::partition_range& pr,
+        const query::partition_slice& slice,
+        tracing::trace_state_ptr trace_state,
+        streamed_mutation::forwarding fwd) const {
+    assert(pr.is_singular() && pr.start()->value().has_key());
+    return make_flat_mutation_reader_v2<multi_key_sstable_reader>(shared_from_this(), cf, std::move(schema), std::move(permit),
+            sstable_histogram, pr, slice, std::move(trace_state), fwd);
+}
+
 class auto_closed_sstable_reader final : public flat_mutation_reader_v2::impl {
     shared_sstable _sst;
     flat_mutation_reader_v2_opt _reader;
@@ -101,6 +101,11 @@ class sstable_set_impl {
     using selector_and_schema_t = std::tuple<std::unique_ptr<incremental_selector_impl>, const schema&>;
     virtual selector_and_schema_t make_incremental_selector() const = 0;
 
+    // Returns the sstables which may contain the partition at `pos` and
+    // satisfy `predicate`. The key is hashed once and the bloom filters of
+    // all candidates are probed in a single pass, after being prefetched.
+    std::vector<shared_sstable> select_sstables_for_key(const schema& s, const dht::ring_position& pos, const sstable_predicate& predicate) const;
+
     virtual flat_mutation_reader_v2 create_single_key_sstable_reader(
         replica::column_family*,
         schema_ptr,
@@ -205,6 +210,26 @@ class sstable_set : public enable_lw_shared_from_this<sstable_set> {
         mutation_reader::forwarding,
         const sstable_predicate& p = default_sstable_predicate()) const;
 
+    // Like create_single_key_sstable_reader(), but the reader can be fast-forwarded
+    // to further partition ranges, read with the default sstable predicate.
+    // The readers of the sstables opened for a key are kept and fast-forwarded to
+    // the following keys, so reading a batch of keys in ring order walks the index
+    // of each sstable forward, instead of looking up each key from scratch.
+    flat_mutation_reader_v2 create_multi_key_sstable_reader(
+        replica::column_family*,
+        schema_ptr,
+        reader_permit,
+        utils::estimated_histogram&,
+        const dht::partition_range&, // must be singular and contain a key
+        const query::partition_slice&,
+        tracing::trace_state_ptr,
+        streamed_mutation::forwarding) const;
+
+    // Returns the sstables which may contain the partition at `pos` and satisfy `predicate`,
+    // see sstable_set_impl::select_sstables_for_key().
+    std::vector<shared_sstable> select_sstables_for_key(const schema& s, const dht::ring_position& pos,
+        const sstable_predicate& predicate = default_sstable_predicate()) const;
+
     /// Read a range from the sstable set.
     ///
     /// The reader is unrestricted, but will account its resource usage on the
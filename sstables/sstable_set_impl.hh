@@ -8,53 +8,98 @@
 
 #pragma once
 
-#include <boost/icl/interval_map.hpp>
-
-#include "compatible_ring_position.hh"
 #include "sstable_set.hh"
 #include "readers/clustering_combined.hh"
 #include "sstables/types_fwd.hh"
 
 namespace sstables {
 
+// A set of sstables whose partition ranges are pairwise disjoint, ordered by their first key.
+//
+// The sstables are kept in small sorted chunks which are shared between copies of the layer,
+// so copying a layer costs one pointer per chunk and an update copies only the chunk it touches.
+class disjoint_sstable_layer {
+    using chunk = std::vector<shared_sstable>;
+    static constexpr size_t max_chunk_size = 64;
+
+    std::vector<lw_shared_ptr<const chunk>> _chunks;
+    size_t _size = 0;
+public:
+    class const_iterator {
+        const disjoint_sstable_layer* _layer = nullptr;
+        size_t _chunk = 0;
+        size_t _idx = 0;
+        friend class disjoint_sstable_layer;
+        const_iterator(const disjoint_sstable_layer& layer, size_t chunk, size_t idx) noexcept
+            : _layer(&layer), _chunk(chunk), _idx(idx) {}
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = shared_sstable;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const shared_sstable*;
+        using reference = const shared_sstable&;
+
+        const_iterator() = default;
+        reference operator*() const noexcept { return (*_layer->_chunks[_chunk])[_idx]; }
+        pointer operator->() const noexcept { return &**this; }
+        const_iterator& operator++() noexcept {
+            if (++_idx == _layer->_chunks[_chunk]->size()) {
+                ++_chunk;
+                _idx = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) noexcept { auto it = *this; ++*this; return it; }
+        const_iterator& operator--() noexcept {
+            if (_idx == 0) {
+                _idx = _layer->_chunks[--_chunk]->size();
+            }
+            --_idx;
+            return *this;
+        }
+        const_iterator operator--(int) noexcept { auto it = *this; --*this; return it; }
+        bool operator==(const const_iterator& o) const noexcept { return _chunk == o._chunk && _idx == o._idx; }
+    };
+
+    const_iterator begin() const noexcept { return const_iterator(*this, 0, 0); }
+    const_iterator end() const noexcept { return const_iterator(*this, _chunks.size(), 0); }
+    size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+
+    // Returns the first sstable whose last key is not before pos, i.e. the one
+    // containing pos if there is such, or else the first one after pos.
+    const_iterator lower_bound(const schema& s, dht::ring_position_view pos) const;
+    // Returns false, leaving the layer unchanged, if sst overlaps with an sstable in the layer.
+    bool insert(const schema& s, shared_sstable sst);
+    bool erase(const schema& s, const shared_sstable& sst);
+};
+
 // specialized when sstables are partitioned in the token range space
 // e.g. leveled compaction strategy
+//
+// Sstables which don't belong to level 0 are indexed in layers of disjoint sstables. Each one
+// goes into the first layer it doesn't overlap with, so a leveled table ends up with about
+// one layer per level, while unleveled sets with overlapping sstables get as many layers
+// as needed. Copies share the layers' storage, so cloning the set doesn't copy the index.
 class partitioned_sstable_set : public sstable_set_impl {
-    using value_set = std::unordered_set<shared_sstable>;
-    using interval_map_type = boost::icl::interval_map<compatible_ring_position_or_view, value_set>;
-    using interval_type = interval_map_type::interval_type;
-    using map_iterator = interval_map_type::const_iterator;
 private:
     schema_ptr _schema;
     std::vector<shared_sstable> _unleveled_sstables;
-    interval_map_type _leveled_sstables;
+    std::vector<disjoint_sstable_layer> _leveled_sstables;
     lw_shared_ptr<sstable_list> _all;
     std::unordered_map<run_id, shared_sstable_run> _all_runs;
-    // Change counter on interval map for leveled sstables which is used by
-    // incremental selector to determine whether or not to invalidate iterators.
-    uint64_t _leveled_sstables_change_cnt = 0;
     bool _use_level_metadata = false;
 private:
-    static interval_type make_interval(const schema& s, const dht::partition_range& range);
-    interval_type make_interval(const dht::partition_range& range) const;
-    static interval_type make_interval(const schema_ptr& s, const sstable& sst);
-    interval_type make_interval(const sstable& sst);
-    interval_type singular(const dht::ring_position& rp) const;
-    std::pair<map_iterator, map_iterator> query(const dht::partition_range& range) const;
-    // SSTables are stored separately to avoid interval map's fragmentation issue when level 0 falls behind.
+    // SSTables are stored separately to avoid fragmenting the layers when level 0 falls behind.
     bool store_as_unleveled(const shared_sstable& sst) const;
 public:
-    static dht::ring_position to_ring_position(const compatible_ring_position_or_view& crp);
-    static dht::partition_range to_partition_range(const interval_type& i);
-    static dht::partition_range to_partition_range(const dht::ring_position_view& pos, const interval_type& i);
-
     partitioned_sstable_set(const partitioned_sstable_set&) = delete;
     explicit partitioned_sstable_set(schema_ptr schema, bool use_level_metadata = true);
-    // For cloning the partitioned_sstable_set (makes a deep copy, including *_all)
+    // For cloning the partitioned_sstable_set (makes a deep copy of *_all, the layers are shared)
     explicit partitioned_sstable_set(
         schema_ptr schema,
         const std::vector<shared_sstable>& unleveled_sstables,
-        const interval_map_type& leveled_sstables,
+        const std::vector<disjoint_sstable_layer>& leveled_sstables,
         const lw_shared_ptr<sstable_list>& all,
         const std::unordered_map<run_id, shared_sstable_run>& all_runs,
         bool use_level_metadata,
@@ -11,6 +11,7 @@
 #include <vector>
 #include <typeinfo>
 #include <limits>
+#include <bit>
 #include <seastar/core/future.hh>
 #include <seastar/core/future-util.hh>
 #include <seastar/core/sstring.hh>
@@ -70,6 +71,7 @@
 #include "sstables/random_access_reader.hh"
 #include "sstables/sstables_manager.hh"
 #include "sstables/partition_index_cache.hh"
+#include "sstables/promoted_index_block_cache.hh"
 #include "utils/UUID_gen.hh"
 #include "sstables_manager.hh"
 #include "tracing/traced_file.hh"
@@ -81,6 +83,7 @@
 #include "reader_concurrency_semaphore.hh"
 #include "readers/reversing_v2.hh"
 #include "readers/forwardable_v2.hh"
+#include "partition_slice_builder.hh"
 
 #include "release.hh"
 #include "utils/build_id.hh"
@@ -522,6 +525,8 @@ future<> parse(const schema& schema, sstable_version_types v, random_access_read
     }
     // Delete last element which isn't part of the on-disk format.
     s.positions.pop_back();
+
+    co_await build_summary_token_directory(s);
 }
 
 inline void write(sstable_version_types v, file_writer& out, const summary_entry& entry) {
@@ -1023,6 +1028,8 @@ void sstable::write_simple(const T& component) {
 
 template future<> sstable::read_simple<component_type::Filter>(sstables::filter& f);
 template void sstable::write_simple<component_type::Filter>(const sstables::filter& f);
+template future<> sstable::read_simple<component_type::ClusteringFilter>(sstables::filter& f);
+template void sstable::write_simple<component_type::ClusteringFilter>(const sstables::filter& f);
 
 template void sstable::write_simple<component_type::Summary>(const sstables::summary_ka&);
 
@@ -1241,6 +1248,22 @@ future<> sstable::load_first_and_last_position_in_partition() {
 double sstable::estimate_droppable_tombstone_ratio(gc_clock::time_point gc_before) const {
     auto& st = get_stats_metadata();
     auto estimated_count = st.estimated_cells_count.mean() * st.estimated_cells_count.count();
+    if (auto* ts_stats = get_tombstone_stats()) {
+        double droppable = 0;
+        for (const auto& [kind, e] : ts_stats->map) {
+            for (const auto& b : e.buckets.elements) {
+                if (b.max_deletion_time >= gc_before.time_since_epoch().count()) {
+                    break;
+                }
+                droppable += b.count;
+            }
+            // Cell tombstones and expiring cells are already accounted as cells.
+            if (kind != tombstone_kind::cell && kind != tombstone_kind::expiring) {
+                estimated_count += e.count;
+            }
+        }
+        return estimated_count > 0 ? std::min(droppable / estimated_count, 1.0) : 0.0;
+    }
     if (estimated_count > 0) {
         double droppable = st.estimated_tombstone_drop_time.sum(gc_before.time_since_epoch().count());
         return droppable / estimated_count;
@@ -1330,6 +1353,7 @@ future<> sstable::update_info_for_opened_data(sstable_open_config cfg) {
     }
     _data_file_size = st.st_size;
     _data_file_write_time = db_clock::from_time_t(st.st_mtime);
+    _opened_at = db_clock::now();
 
     auto size = co_await _index_file.size();
     _index_file_size = size;
@@ -1339,6 +1363,7 @@ future<> sstable::update_info_for_opened_data(sstable_open_config cfg) {
                                                             _manager.get_cache_tracker().get_lru(),
                                                             _manager.get_cache_tracker().region(),
                                                             _index_file_size);
+    _cached_index_file->set_max_read_ahead(_manager.config().sstable_index_read_ahead_in_kb() * 1024 / cached_file::page_size);
     _index_file = make_cached_seastar_file(*_cached_index_file);
 
     this->set_min_max_position_range();
@@ -1347,6 +1372,7 @@ future<> sstable::update_info_for_opened_data(sstable_open_config cfg) {
     if (cfg.load_first_and_last_position_metadata) {
         co_await load_first_and_last_position_in_partition();
     }
+    _manager.increment_total_reclaimable_memory_and_maybe_reclaim(this);
 }
 
 future<> sstable::create_data() noexcept {
@@ -1362,6 +1388,8 @@ future<> sstable::create_data() noexcept {
 future<> sstable::drop_caches() {
     return _cached_index_file->evict_gently().then([this] {
         return _index_cache->evict_gently();
+    }).then([this] {
+        return _promoted_index_block_cache->evict_gently();
     });
 }
 
@@ -1383,6 +1411,35 @@ future<> sstable::read_filter(sstable_open_config cfg) {
     });
 }
 
+size_t sstable::total_reclaimable_memory_size() const {
+    if (_shards.size() != 1 || _components.get_owner_shard() != this_shard_id()) {
+        return 0;
+    }
+    return filter_memory_size() + (has_clustering_filter() ? _components->clustering_filter->memory_size() : 0);
+}
+
+size_t sstable::reclaim_memory_from_components() {
+    auto reclaimed = _total_reclaimable_memory;
+    if (reclaimed) {
+        // The filters stay on disk and in _recognized_components, so they can be reloaded later.
+        _components->filter = std::make_unique<utils::filter::always_present_filter>();
+        _components->clustering_filter = nullptr;
+        _total_memory_reclaimed += reclaimed;
+        _total_reclaimable_memory = 0;
+    }
+    return reclaimed;
+}
+
+future<> sstable::reload_reclaimed_components() {
+    if (!_total_memory_reclaimed) {
+        co_return;
+    }
+    co_await read_filter();
+    co_await read_clustering_filter();
+    _total_memory_reclaimed = 0;
+    _total_reclaimable_memory = total_reclaimable_memory_size();
+}
+
 void sstable::write_filter() {
     if (!has_component(component_type::Filter)) {
         return;
@@ -1395,6 +1452,34 @@ void sstable::write_filter() {
     write_simple<component_type::Filter>(filter_ref);
 }
 
+// The clustering filter is stored in the same format as the partition filter.
+future<> sstable::read_clustering_filter(sstable_open_config cfg) {
+    if (!cfg.load_bloom_filter || !has_component(component_type::ClusteringFilter)) {
+        _components->clustering_filter = nullptr;
+        return make_ready_future<>();
+    }
+
+    return seastar::async([this] () mutable {
+        sstables::filter filter;
+        read_simple<component_type::ClusteringFilter>(filter).get();
+        auto nr_bits = filter.buckets.elements.size() * std::numeric_limits<typename decltype(filter.buckets.elements)::value_type>::digits;
+        large_bitset bs(nr_bits, std::move(filter.buckets.elements));
+        _components->clustering_filter = utils::filter::create_filter(filter.hashes, std::move(bs), utils::filter_format::m_format);
+    });
+}
+
+void sstable::write_clustering_filter() {
+    if (!has_component(component_type::ClusteringFilter)) {
+        return;
+    }
+
+    auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->clustering_filter.get());
+
+    auto&& bs = f->bits();
+    auto filter_ref = sstables::filter_ref(f->num_hashes(), bs.get_storage());
+    write_simple<component_type::ClusteringFilter>(filter_ref);
+}
+
 // This interface is only used during tests, snapshot loading and early initialization.
 // No need to set tunable priorities for it.
 future<> sstable::load(const dht::sharder& sharder, sstable_open_config cfg) noexcept {
@@ -1403,17 +1488,21 @@ future<> sstable::load(const dht::sharder& sharder, sstable_open_config cfg) noe
     // rest (hint extensions)
     co_await read_scylla_metadata();
     // Read statistics ahead of others - if summary is missing
-    // we'll attempt to re-generate it and we need statistics for that
-    co_await read_statistics();
+    // we'll attempt to re-generate it and we need statistics for that.
+    // It may already be there if load_owner_shards() ran first.
+    if (_components->statistics.contents.empty()) {
+        co_await read_statistics();
+    }
     co_await coroutine::all(
             [&] { return read_compression(); },
             [&] { return read_filter(cfg); },
+            [&] { return read_clustering_filter(cfg); },
             [&] { return read_summary(); });
     validate_min_max_metadata();
     validate_max_local_deletion_time();
     validate_partitioner();
+    set_first_and_last_keys();
     if (_shards.empty()) {
-        set_first_and_last_keys();
         _shards = compute_shards_for_this_sstable(sharder);
     }
     co_await open_data(cfg);
@@ -1517,9 +1606,40 @@ future<> seal_summary(summary& s,
     return do_for_each(s.entries, [&s] (summary_entry& e) {
         s.positions.push_back(s.header.memory_size);
         s.header.memory_size += e.key.size() + sizeof(e.position);
+    }).then([&s] {
+        return build_summary_token_directory(s);
     });
 }
 
+future<> build_summary_token_directory(summary& s) {
+    // Small summaries are cheap to bisect as a whole.
+    static constexpr uint64_t min_entries = 64;
+    // Bounds the directory to 256KiB per sstable.
+    static constexpr unsigned max_bits = 16;
+
+    s.token_directory = {};
+    s.token_directory_shift = 64;
+    const uint64_t n = s.entries.size();
+    if (n < min_entries) {
+        co_return;
+    }
+    // Aim at roughly one entry per directory slot, so that the directory
+    // never takes more memory than the positions array.
+    const unsigned bits = std::min(max_bits, unsigned(std::bit_width(n) - 1));
+    const uint64_t slots = uint64_t(1) << bits;
+    s.token_directory_shift = 64 - bits;
+    s.token_directory.reserve(slots + 1);
+    uint64_t idx = 0;
+    for (uint64_t prefix = 0; prefix < slots; ++prefix) {
+        while (idx < n && (summary::token_prefix_bits(s.entries[idx].raw_token) >> s.token_directory_shift) < prefix) {
+            ++idx;
+        }
+        s.token_directory.push_back(idx);
+        co_await coroutine::maybe_yield();
+    }
+    s.token_directory.push_back(n);
+}
+
 static
 void
 populate_statistics_offsets(sstable_version_types v, statistics& s) {
@@ -1629,7 +1749,9 @@ sstable::read_scylla_metadata() noexcept {
 
 void
 sstable::write_scylla_metadata(shard_id shard, const dht::sharder& sharder, sstable_enabled_features features, struct run_identifier identifier,
-        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin) {
+        std::optional<scylla_metadata::large_data_stats> ld_stats, sstring origin, scylla_metadata::column_value_stats cv_stats,
+        scylla_metadata::tombstone_stats ts_stats, std::optional<scylla_metadata::compaction_checkpoint> checkpoint,
+        scylla_metadata::summary_entry_stats se_stats) {
     auto&& first_key = get_first_decorated_key();
     auto&& last_key = get_last_decorated_key();
 
@@ -1656,6 +1778,18 @@ sstable::write_scylla_metadata(shard_id shard, const dht::sharder& sharder, ssta
         o.value = bytes(to_bytes_view(sstring_view(origin)));
         _components->scylla_metadata->data.set<scylla_metadata_type::SSTableOrigin>(std::move(o));
     }
+    if (!cv_stats.map.empty()) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::ColumnValueStats>(std::move(cv_stats));
+    }
+    if (!ts_stats.map.empty()) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::TombstoneStats>(std::move(ts_stats));
+    }
+    if (checkpoint) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::CompactionCheckpoint>(std::move(*checkpoint));
+    }
+    if (!se_stats.elements.empty()) {
+        _components->scylla_metadata->data.set<scylla_metadata_type::SummaryEntryStats>(std::move(se_stats));
+    }
 
     scylla_metadata::scylla_version version;
     version.value = bytes(to_bytes_view(sstring_view(scylla_version())));
@@ -1667,6 +1801,46 @@ sstable::write_scylla_metadata(shard_id shard, const dht::sharder& sharder, ssta
     write_simple<component_type::Scylla>(*_components->scylla_metadata);
 }
 
+const scylla_metadata::tombstone_stats* sstable::get_tombstone_stats() const {
+    if (!has_scylla_component()) {
+        return nullptr;
+    }
+    return _components->scylla_metadata->data.get<scylla_metadata_type::TombstoneStats, scylla_metadata::tombstone_stats>();
+}
+
+const scylla_metadata::compaction_checkpoint* sstable::get_compaction_checkpoint() const {
+    if (!has_scylla_component()) {
+        return nullptr;
+    }
+    return _components->scylla_metadata->data.get<scylla_metadata_type::CompactionCheckpoint, scylla_metadata::compaction_checkpoint>();
+}
+
+const column_value_stats_entry* sstable::get_column_value_stats(const column_definition& cdef) const {
+    if (!has_scylla_component()) {
+        return nullptr;
+    }
+    auto* cv_stats = _components->scylla_metadata->data.get<scylla_metadata_type::ColumnValueStats, scylla_metadata::column_value_stats>();
+    if (!cv_stats) {
+        return nullptr;
+    }
+    auto it = cv_stats->map.find(disk_string<uint32_t>{cdef.name()});
+    return it == cv_stats->map.end() ? nullptr : &it->second;
+}
+
+bool sstable::may_contain_column_value(const column_definition& cdef, const interval<bytes>& range) const {
+    auto* e = get_column_value_stats(cdef);
+    if (!e || !e->has_min_max) {
+        return true;
+    }
+    auto values = interval<bytes>::make(e->min_value.value, e->max_value.value);
+    return values.overlaps(range, [&cdef] (const bytes& a, const bytes& b) { return cdef.type->compare(a, b); });
+}
+
+bool sstable::may_contain_null_column_value(const column_definition& cdef) const {
+    auto* e = get_column_value_stats(cdef);
+    return !e || e->null_count;
+}
+
 bool sstable::may_contain_rows(const query::clustering_row_ranges& ranges) const {
     if (_version < sstables::sstable_version_types::md) {
         return true;
@@ -2024,6 +2198,26 @@ std::vector<std::pair<component_type, sstring>> sstable::all_components() const
     return all;
 }
 
+future<file> sstable::open_component_file(component_type c) noexcept {
+    return new_sstable_component_file(_read_error_handler, c, open_flags::ro);
+}
+
+void sstable::open_sstable_for_copy(const std::vector<component_type>& components) {
+    _recognized_components.clear();
+    _recognized_components.insert(component_type::TOC);
+    _recognized_components.insert(components.begin(), components.end());
+    _marked_for_deletion = mark_for_deletion::implicit;
+    _storage->open(*this);
+}
+
+future<output_stream<char>> sstable::make_component_output_stream(component_type c) {
+    file_output_stream_options options;
+    options.buffer_size = sstable_buffer_size;
+    options.write_behind = 10;
+    auto sink = co_await _storage->make_component_sink(*this, c, open_flags::wo | open_flags::create | open_flags::exclusive, std::move(options));
+    co_return output_stream<char>(std::move(sink));
+}
+
 future<> sstable::snapshot(const sstring& dir) const {
     return _storage->snapshot(*this, dir, storage::absolute_path::yes);
 }
@@ -2045,6 +2239,98 @@ future<> delayed_commit_changes::commit() {
     });
 }
 
+// Reads a range of partitions of an mx sstable in reverse clustering order, which
+// mx::make_reader() supports for single partitions only.
+//
+// Walks the partitions in the range with a forward reader which reads none of their
+// rows, and reads each of them with a reversed single-partition reader. So memory
+// usage is bounded by that of the latter, instead of by the size of the partitions,
+// as it is when reversing a forward read with make_reversing_reader().
+class reversed_multi_partition_reader final : public flat_mutation_reader_v2::impl {
+    shared_sstable _sst;
+    const query::partition_slice& _slice;
+    tracing::trace_state_ptr _trace_state;
+    schema_ptr _table_schema;
+    query::partition_slice _keys_slice;
+    flat_mutation_reader_v2 _keys;
+    // The range of the current partition, has to outlive its reader.
+    dht::partition_range _partition_range;
+    flat_mutation_reader_v2_opt _partition;
+private:
+    future<> open_next_partition() {
+        auto mfo = co_await _keys();
+        if (!mfo) {
+            _end_of_stream = true;
+            co_return;
+        }
+        _partition_range = dht::partition_range::make_singular(mfo->as_partition_start().key());
+        co_await _keys.next_partition();
+        _partition = mx::make_reader(_sst, _schema, _permit, _partition_range, _slice, _trace_state,
+                streamed_mutation::forwarding::no, mutation_reader::forwarding::no, default_read_monitor());
+    }
+
+    future<> close_partition() noexcept {
+        if (_partition) {
+            auto rd = std::move(*_partition);
+            _partition = {};
+            co_await rd.close();
+        }
+    }
+public:
+    // The schema and slice are those of the reversed query, see mx::make_reader().
+    reversed_multi_partition_reader(shared_sstable sst, schema_ptr schema, reader_permit permit, const dht::partition_range& range,
+            const query::partition_slice& slice, tracing::trace_state_ptr trace_state, mutation_reader::forwarding fwd_mr, read_monitor& mon)
+        : impl(std::move(schema), std::move(permit))
+        , _sst(std::move(sst))
+        , _slice(slice)
+        , _trace_state(std::move(trace_state))
+        , _table_schema(_schema->make_reversed())
+        , _keys_slice(partition_slice_builder(*_table_schema)
+                .with_ranges({})
+                .with_no_static_columns()
+                .with_no_regular_columns()
+                .build())
+        , _keys(mx::make_reader(_sst, _table_schema, _permit, range, _keys_slice, _trace_state, streamed_mutation::forwarding::no, fwd_mr, mon))
+    { }
+
+    virtual future<> fill_buffer() override {
+        while (!is_buffer_full() && !is_end_of_stream()) {
+            if (!_partition) {
+                co_await open_next_partition();
+                continue;
+            }
+            co_await _partition->fill_buffer();
+            _partition->move_buffer_content_to(*this);
+            if (_partition->is_end_of_stream()) {
+                co_await close_partition();
+            }
+        }
+    }
+
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty()) {
+            co_await close_partition();
+        }
+    }
+
+    virtual future<> fast_forward_to(const dht::partition_range& pr) override {
+        clear_buffer();
+        _end_of_stream = false;
+        co_await close_partition();
+        co_await _keys.fast_forward_to(pr);
+    }
+
+    virtual future<> fast_forward_to(position_range) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+
+    virtual future<> close() noexcept override {
+        co_await close_partition();
+        co_await _keys.close();
+    }
+};
+
 flat_mutation_reader_v2
 sstable::make_reader(
         schema_ptr schema,
@@ -2060,22 +2346,18 @@ sstable::make_reader(
         return mx::make_reader(shared_from_this(), std::move(schema), std::move(permit), range, slice, std::move(trace_state), fwd, fwd_mr, mon);
     }
 
-    // Multi-partition reversed queries are not yet supported natively in the mx reader.
-    // Therefore in this case we use `make_reversing_reader` over the forward reader.
-    // FIXME: remove this workaround eventually.
-    auto max_result_size = permit.max_result_size();
-
     if (_version >= version_types::mc) {
         // The only mx case falling through here is reversed multi-partition reader
-        auto rd = make_reversing_reader(mx::make_reader(shared_from_this(), schema->make_reversed(), std::move(permit),
-                range, half_reverse_slice(*schema, slice), std::move(trace_state), streamed_mutation::forwarding::no, fwd_mr, mon),
-            max_result_size);
+        auto rd = make_flat_mutation_reader_v2<reversed_multi_partition_reader>(shared_from_this(), std::move(schema), std::move(permit),
+                range, slice, std::move(trace_state), fwd_mr, mon);
         if (fwd) {
             rd = make_forwardable(std::move(rd));
         }
         return rd;
     }
 
+    auto max_result_size = permit.max_result_size();
+
     if (reversed) {
         // The kl reader does not support reversed queries at all.
         // Perform a forward query on it, then reverse the result.
@@ -2517,6 +2799,32 @@ future<> sstable::mutate_sstable_level(uint32_t new_level) {
     });
 }
 
+future<> sstable::mutate_repaired_at(uint64_t repaired_at) {
+    if (!has_component(component_type::Statistics)) {
+        return make_ready_future<>();
+    }
+
+    auto entry = _components->statistics.contents.find(metadata_type::Stats);
+    if (entry == _components->statistics.contents.end()) {
+        return make_ready_future<>();
+    }
+
+    auto& p = entry->second;
+    if (!p) {
+        return make_exception_future<>(std::runtime_error("Statistics is malformed"));
+    }
+    stats_metadata& s = *static_cast<stats_metadata *>(p.get());
+    if (s.repaired_at == repaired_at) {
+        return make_ready_future<>();
+    }
+
+    sstlog.debug("set repaired_at of {} from {} to {}", get_filename(), s.repaired_at, repaired_at);
+    s.repaired_at = repaired_at;
+    return seastar::async([this] {
+        rewrite_statistics();
+    });
+}
+
 int sstable::compare_by_max_timestamp(const sstable& other) const {
     auto ts1 = get_stats_metadata().max_timestamp;
     auto ts2 = other.get_stats_metadata().max_timestamp;
@@ -2526,7 +2834,10 @@ int sstable::compare_by_max_timestamp(const sstable& other) const {
 future<> sstable::close_files() {
     auto index_closed = make_ready_future<>();
     if (_index_file) {
-        index_closed = _index_file.close().handle_exception([me = shared_from_this()] (auto ep) {
+        auto read_ahead_stopped = _cached_index_file ? _cached_index_file->stop_read_ahead() : make_ready_future<>();
+        index_closed = read_ahead_stopped.then([this] {
+            return _index_file.close();
+        }).handle_exception([me = shared_from_this()] (auto ep) {
             sstlog.warn("sstable close index_file failed: {}", ep);
             general_disk_error();
         });
@@ -2720,11 +3031,30 @@ std::vector<dht::decorated_key> sstable::get_key_samples(const schema& s, const
     return res;
 }
 
+const scylla_metadata::summary_entry_stats* sstable::get_summary_entry_stats() const {
+    if (!has_scylla_component()) {
+        return nullptr;
+    }
+    auto* stats = _components->scylla_metadata->data.get<scylla_metadata_type::SummaryEntryStats, scylla_metadata::summary_entry_stats>();
+    // The summary may have been regenerated from the index since.
+    if (!stats || stats->elements.size() != _components->summary.entries.size()) {
+        return nullptr;
+    }
+    return stats;
+}
+
 uint64_t sstable::estimated_keys_for_range(const dht::token_range& range) {
     auto page_range = get_index_pages_for_range(range);
     if (!page_range) {
         return 0;
     }
+    if (auto* stats = get_summary_entry_stats()) {
+        uint64_t keys = 0;
+        for (auto i = page_range->first; i != page_range->second; ++i) {
+            keys += stats->elements[i].partitions;
+        }
+        return std::max(uint64_t(1), keys);
+    }
     using uint128_t = unsigned __int128;
     uint64_t range_pages = page_range->second - page_range->first;
     auto total_keys = get_estimated_key_count();
@@ -2733,6 +3063,21 @@ uint64_t sstable::estimated_keys_for_range(const dht::token_range& range) {
     return std::max(uint64_t(1), estimated_keys);
 }
 
+uint64_t sstable::estimated_size_for_range(const dht::token_range& range) {
+    auto page_range = get_index_pages_for_range(range);
+    if (!page_range) {
+        return 0;
+    }
+    if (auto* stats = get_summary_entry_stats()) {
+        uint64_t size = 0;
+        for (auto i = page_range->first; i != page_range->second; ++i) {
+            size += stats->elements[i].data_size;
+        }
+        return size;
+    }
+    return estimated_keys_for_range(range) * get_stats_metadata().estimated_partition_size.mean();
+}
+
 std::vector<unsigned>
 sstable::compute_shards_for_this_sstable(const dht::sharder& sharder_) const {
     std::unordered_set<unsigned> shards;
@@ -2787,10 +3132,112 @@ future<bool> sstable::has_partition_key(const utils::hashed_key& hk, const dht::
     co_return present;
 }
 
+future<uint64_t> sstable::data_size_in_ranges(const dht::partition_range_vector& ranges, reader_permit permit) {
+    auto ir = std::make_unique<sstables::index_reader>(shared_from_this(), std::move(permit));
+    uint64_t size = 0;
+    std::exception_ptr ex;
+    try {
+        for (const auto& range : ranges) {
+            co_await ir->advance_to(range);
+            auto [start, end] = ir->data_file_positions();
+            size += end.value_or(data_size()) - start;
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await ir->close();
+    if (ex) {
+        co_return coroutine::exception(std::move(ex));
+    }
+    co_return size;
+}
+
+dht::token_range_vector sstable::get_hot_index_ranges() {
+    const auto& entries = _components->summary.entries;
+    dht::token_range_vector ranges;
+    auto hot_keys = _index_cache->hot_keys();
+    for (auto i = hot_keys.begin(); i != hot_keys.end();) {
+        // Adjacent pages are merged into a single range.
+        auto first = *i;
+        auto last = first;
+        while (++i != hot_keys.end() && *i == last + 1) {
+            last = *i;
+        }
+        if (last >= entries.size()) {
+            continue;
+        }
+        auto end = last + 1 < entries.size() ? entries[last + 1].get_token() : get_last_decorated_key().token();
+        ranges.push_back(dht::token_range::make(entries[first].get_token(), end));
+    }
+    return ranges;
+}
+
+std::optional<hll::HyperLogLog> sstable::get_partition_key_sketch() const {
+    auto entry = _components->statistics.contents.find(metadata_type::Compaction);
+    if (entry == _components->statistics.contents.end() || !entry->second) {
+        return std::nullopt;
+    }
+    const auto& cardinality = static_cast<const compaction_metadata&>(*entry->second).cardinality.elements;
+    std::vector<uint8_t> bytes(cardinality.begin(), cardinality.end());
+    try {
+        return hll::HyperLogLog::from_bytes(bytes.data(), bytes.size());
+    } catch (const std::exception& e) {
+        // E.g. the sparse format, written by Cassandra.
+        sstlog.trace("Ignoring the cardinality metadata of {}: {}", get_filename(), e.what());
+        return std::nullopt;
+    }
+}
+
+sstable::index_cache_residency sstable::get_index_cache_residency() const {
+    return index_cache_residency{
+        .index_file_bytes = _cached_index_file ? _cached_index_file->cached_bytes() : 0,
+        .partition_index_bytes = _index_cache ? _index_cache->used_bytes() : 0,
+    };
+}
+
+future<> sstable::warm_index_cache(const dht::token_range_vector& ranges, reader_permit permit) {
+    std::vector<uint64_t> summary_indexes;
+    for (const auto& range : ranges) {
+        if (auto pages = get_index_pages_for_range(range)) {
+            // The ranges are sorted, but the pages of adjacent ranges may overlap.
+            auto first = summary_indexes.empty() ? pages->first : std::max(pages->first, summary_indexes.back() + 1);
+            for (auto idx = first; idx < pages->second; ++idx) {
+                summary_indexes.push_back(idx);
+            }
+        }
+    }
+    if (summary_indexes.empty()) {
+        co_return;
+    }
+    auto ir = std::make_unique<sstables::index_reader>(shared_from_this(), std::move(permit));
+    std::exception_ptr ex;
+    try {
+        co_await ir->warm_pages(std::move(summary_indexes));
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await ir->close();
+    if (ex) {
+        co_return coroutine::exception(std::move(ex));
+    }
+}
+
 utils::hashed_key sstable::make_hashed_key(const schema& s, const partition_key& key) {
     return utils::make_hashed_key(static_cast<bytes_view>(key::from_partition_key(s, key)));
 }
 
+utils::hashed_key sstable::make_clustering_filter_key(const key& pk, const clustering_key_prefix* ck) {
+    auto pk_bytes = bytes_view(pk);
+    if (!ck) {
+        return utils::make_hashed_key(pk_bytes);
+    }
+    auto ck_bytes = ck->representation();
+    bytes b(bytes::initialized_later(), pk_bytes.size() + ck_bytes.size_bytes());
+    auto out = std::copy(pk_bytes.begin(), pk_bytes.end(), b.begin());
+    read_fragmented(ck_bytes, ck_bytes.size_bytes(), out);
+    return utils::make_hashed_key(b);
+}
+
 future<>
 sstable::unlink(storage::sync_dir sync) noexcept {
     _on_delete(*this);
@@ -2829,6 +3276,12 @@ void register_index_page_cache_metrics(seastar::metrics::metric_groups& metrics,
             sm::description("Total number of bytes cached in the index page cache")),
         sm::make_gauge("index_page_cache_bytes_in_std", [&m] { return m.bytes_in_std; },
             sm::description("Total number of bytes in temporary buffers which live in the std allocator")),
+        sm::make_counter("index_page_cache_read_ahead_pages", [&m] { return m.read_ahead_pages; },
+            sm::description("Total number of index page cache pages which were inserted by sequential read-ahead")),
+        sm::make_counter("index_page_cache_read_ahead_hits", [&m] { return m.read_ahead_hits; },
+            sm::description("Total number of index page cache pages inserted by read-ahead which were later used")),
+        sm::make_counter("index_page_cache_read_ahead_waste", [&m] { return m.read_ahead_waste; },
+            sm::description("Total number of index page cache pages inserted by read-ahead which were evicted without being used")),
     });
 }
 
@@ -2845,12 +3298,34 @@ void register_index_page_metrics(seastar::metrics::metric_groups& metrics, parti
             sm::description("Index pages which got evicted from memory")),
         sm::make_counter("index_page_populations", [&m] { return m.populations; },
             sm::description("Index pages which got populated into memory")),
+        sm::make_counter("index_page_probationary_populations", [&m] { return m.probationary_populations; },
+            sm::description("Index pages which got populated into memory on probation, on behalf of scans")),
+        sm::make_counter("index_page_promotions", [&m] { return m.promotions; },
+            sm::description("Index pages on probation which got requested again and were promoted")),
         sm::make_gauge("index_page_used_bytes", [&m] { return m.used_bytes; },
             sm::description("Amount of bytes used by index pages in memory")),
 
     });
 }
 
+void register_promoted_index_block_metrics(seastar::metrics::metric_groups& metrics, promoted_index_block_cache_stats& m) {
+    namespace sm = seastar::metrics;
+    metrics.add_group("sstables", {
+        sm::make_counter("pi_shared_cache_hits", [&m] { return m.hits; },
+            sm::description("Promoted index block requests which were served from the cache shared by readers, without parsing")),
+        sm::make_counter("pi_shared_cache_misses", [&m] { return m.misses; },
+            sm::description("Promoted index block requests which had to parse the block")),
+        sm::make_counter("pi_shared_cache_evictions", [&m] { return m.evictions; },
+            sm::description("Promoted index blocks which got evicted from the cache shared by readers")),
+        sm::make_counter("pi_shared_cache_populations", [&m] { return m.populations; },
+            sm::description("Promoted index blocks which got inserted into the cache shared by readers")),
+        sm::make_gauge("pi_shared_cache_block_count", [&m] { return m.block_count; },
+            sm::description("Number of promoted index blocks currently in the cache shared by readers")),
+        sm::make_gauge("pi_shared_cache_bytes", [&m] { return m.used_bytes; },
+            sm::description("Amount of bytes used by promoted index blocks in the cache shared by readers")),
+    });
+}
+
 future<> init_metrics() {
   return seastar::smp::invoke_on_all([] {
     namespace sm = seastar::metrics;
@@ -2890,6 +3365,14 @@ future<> init_metrics() {
             sm::description("Number of range tombstones written")),
         sm::make_counter("pi_auto_scale_events", [] { return sstables_stats::get_shard_stats().promoted_index_auto_scale_events; },
             sm::description("Number of promoted index auto-scaling events")),
+        sm::make_counter("data_writes", [] { return sstables_stats::get_shard_stats().data_writes; },
+            sm::description("Number of writes issued to the data and index files of sstables being written")),
+        sm::make_counter("data_write_bytes", [] { return sstables_stats::get_shard_stats().data_write_bytes; },
+            sm::description("Number of bytes written to the data and index files of sstables being written")),
+        sm::make_gauge("data_writes_in_flight", [] { return sstables_stats::get_shard_stats().data_writes_in_flight; },
+            sm::description("Number of writes to the data and index files of sstables being written which are currently in flight")),
+        sm::make_counter("data_preallocated_bytes", [] { return sstables_stats::get_shard_stats().data_preallocated_bytes; },
+            sm::description("Number of bytes preallocated for the data and index files of sstables being written")),
 
         sm::make_counter("range_tombstone_reads", [] { return sstables_stats::get_shard_stats().range_tombstone_reads; },
             sm::description("Number of range tombstones read")),
@@ -2907,6 +3390,12 @@ future<> init_metrics() {
             sm::description("Number of partitions seeked")),
         sm::make_counter("row_reads", [] { return sstables_stats::get_shard_stats().row_reads; },
             sm::description("Number of rows read")),
+        sm::make_counter("single_key_reads", [] { return sstables_stats::get_shard_stats().single_key_reads; },
+            sm::description("Number of single key reads of sstable sets")),
+        sm::make_counter("single_key_read_sstables", [] { return sstables_stats::get_shard_stats().single_key_read_sstables; },
+            sm::description("Number of sstables read by single key reads of sstable sets. Divided by single_key_reads, it gives the read amplification.")),
+        sm::make_counter("clustering_filter_skips", [] { return sstables_stats::get_shard_stats().clustering_filter_skips; },
+            sm::description("Number of single partition reads which skipped the promoted index and rows of a partition excluded by the clustering filter")),
 
         sm::make_counter("capped_local_deletion_time", [] { return sstables_stats::get_shard_stats().capped_local_deletion_time; },
             sm::description("Number of SStables with tombstones whose local deletion time was capped at the maximum allowed value in Statistics")),
@@ -2969,6 +3458,8 @@ sstable::sstable(schema_ptr schema,
     , _format(f)
     , _index_cache(std::make_unique<partition_index_cache>(
             manager.get_cache_tracker().get_lru(), manager.get_cache_tracker().region(), manager.get_cache_tracker().get_partition_index_cache_stats()))
+    , _promoted_index_block_cache(std::make_unique<promoted_index_block_cache>(
+            manager.get_cache_tracker().get_lru(), manager.get_cache_tracker().region(), manager.get_cache_tracker().get_promoted_index_block_cache_stats()))
     , _now(now)
     , _read_error_handler(error_handler_gen(sstable_read_error))
     , _write_error_handler(error_handler_gen(sstable_write_error))
@@ -3000,6 +3491,7 @@ future<> sstable::destroy() {
     }
 
     co_await _index_cache->evict_gently();
+    co_await _promoted_index_block_cache->evict_gently();
     if (_cached_index_file) {
         co_await _cached_index_file->evict_gently();
     }
@@ -33,6 +33,7 @@
 #include "stats.hh"
 #include "utils/observable.hh"
 #include "sstables/shareable_components.hh"
+#include "sstables/clustered_seek_hints.hh"
 #include "sstables/storage.hh"
 #include "sstables/generation_type.hh"
 #include "mutation/mutation_fragment_stream_validator.hh"
@@ -54,6 +55,10 @@ namespace db {
 class large_data_handler;
 }
 
+namespace hll {
+class HyperLogLog;
+}
+
 namespace sstables {
 
 class random_access_reader;
@@ -95,23 +100,45 @@ class data_consume_context;
 
 class index_reader;
 class partition_index_cache;
+class promoted_index_block_cache;
 class sstables_manager;
 
 extern size_t summary_byte_cost(double summary_ratio);
 
 struct sstable_writer_config {
     size_t promoted_index_block_size;
+    // Size of the first promoted index block of a partition. The following
+    // ones double up to promoted_index_block_size. 0 means the same size.
+    size_t promoted_index_initial_block_size = 0;
     size_t promoted_index_auto_scale_threshold;
+    bool clustering_filter = false;
+    // Past this many keys, the clustering filter is written so that it
+    // matches everything, to bound the memory used for collecting them.
+    size_t clustering_filter_max_keys = 1 << 20;
+    // Collect the column_value_stats of the scylla metadata.
+    bool column_value_stats = false;
     uint64_t max_sstable_size = std::numeric_limits<uint64_t>::max();
+    // Size of the writes of the data and index components,
+    // 0 for the sstable buffer size and the default preallocation.
+    size_t write_batch_size = 0;
+    unsigned write_behind = 10;
+    // Expected size of the data component, 0 if unknown.
+    // Sizes the preallocated extents when write_batch_size is set.
+    uint64_t estimated_data_size = 0;
     bool backup = false;
     mutation_fragment_stream_validation_level validation_level;
     std::optional<db::replay_position> replay_position;
     std::optional<int> sstable_level;
+    // Written to the statistics, see sstable::get_repaired_at().
+    uint64_t repaired_at = 0;
     write_monitor* monitor = &default_write_monitor();
     run_id run_identifier = run_id::create_random_id();
     size_t summary_byte_cost;
     sstring origin;
     locator::effective_replication_map_ptr erm;
+    // If engaged, written to the scylla metadata so that an interrupted
+    // compaction can resume after the sstable.
+    std::optional<scylla_metadata::compaction_checkpoint> compaction_checkpoint;
 
 private:
     explicit sstable_writer_config() {}
@@ -234,6 +261,11 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // a new sstable from scratch for sharing its components.
     future<> load(const dht::sharder& sharder, sstable_open_config cfg = {}) noexcept;
     future<> open_data(sstable_open_config cfg = {}) noexcept;
+    // Drops the reclaimable components from memory, returning the
+    // amount of memory freed. Reads keep working, only less efficiently.
+    size_t reclaim_memory_from_components();
+    // Reads the reclaimed components back from disk.
+    future<> reload_reclaimed_components();
     future<> update_info_for_opened_data(sstable_open_config cfg = {});
 
     // Load set of shards that own the SSTable, while reading the minimum
@@ -324,6 +356,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     }
 
     uint64_t estimated_keys_for_range(const dht::token_range& range);
+    // Estimates the uncompressed size of the partitions in the range.
+    uint64_t estimated_size_for_range(const dht::token_range& range);
 
     std::vector<dht::decorated_key> get_key_samples(const schema& s, const dht::token_range& range);
 
@@ -370,14 +404,29 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _data_file_write_time;
     }
 
+    // When this node opened the sstable for reading, i.e. since when at the
+    // latest its data is visible to reads of this node.
+    db_clock::time_point opened_at() const {
+        return _opened_at;
+    }
+
     uint64_t filter_memory_size() const {
         return _components->filter->memory_size();
     }
 
+    // Returns the memory held by components that can be dropped under
+    // memory pressure and read back from disk later. Components shared with
+    // other shards are never reclaimed, so they don't count here.
+    size_t total_reclaimable_memory_size() const;
+
     version_types get_version() const {
         return _version;
     }
 
+    format_types get_format() const {
+        return _format;
+    }
+
     // Returns the total bytes of all components.
     uint64_t bytes_on_disk() const;
 
@@ -418,6 +467,17 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     std::vector<std::pair<component_type, sstring>> all_components() const;
 
+    // File based streaming copies the component files of an sstable as-is.
+    //
+    // Opens a component file of the sstable for reading it whole.
+    future<file> open_component_file(component_type c) noexcept;
+    // Starts writing a copy of an sstable made of the given components: lists
+    // them in the temporary TOC, so that the copy is removed if it is not
+    // sealed. Must run in a seastar thread.
+    void open_sstable_for_copy(const std::vector<component_type>& components);
+    // Creates a component file of the copy.
+    future<output_stream<char>> make_component_output_stream(component_type c);
+
     future<> snapshot(const sstring& dir) const;
 
     // Delete the sstable by unlinking all sstable files
@@ -530,6 +590,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // on-disk size of components but data and index.
     uint64_t _metadata_size_on_disk = 0;
     db_clock::time_point _data_file_write_time;
+    db_clock::time_point _opened_at;
     position_range _min_max_position_range = position_range::all_clustered_rows();
     position_in_partition _first_partition_first_position = position_in_partition::before_all_clustered_rows();
     position_in_partition _last_partition_last_position = position_in_partition::after_all_clustered_rows();
@@ -555,6 +616,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     filter_tracker _filter_tracker;
     std::unique_ptr<partition_index_cache> _index_cache;
+    std::unique_ptr<promoted_index_block_cache> _promoted_index_block_cache;
+    clustered_seek_hints _clustered_seek_hints;
 
     enum class mark_for_deletion {
         implicit = -1,
@@ -573,6 +636,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     sstables_stats _stats;
     manager_link_type _manager_link;
+    // Reclaimable memory accounted for this sstable in the sstables_manager,
+    // and the memory reclaimed from it that is yet to be reloaded.
+    size_t _total_reclaimable_memory = 0;
+    size_t _total_memory_reclaimed = 0;
 
     // The _large_data_stats map stores e.g. largest partitions, rows, cells sizes,
     // and max number of rows in a partition.
@@ -626,12 +693,20 @@ class sstable : public enable_lw_shared_from_this<sstable> {
                                sstable_enabled_features features,
                                run_identifier identifier,
                                std::optional<scylla_metadata::large_data_stats> ld_stats,
-                               sstring origin);
+                               sstring origin,
+                               scylla_metadata::column_value_stats cv_stats = {},
+                               scylla_metadata::tombstone_stats ts_stats = {},
+                               std::optional<scylla_metadata::compaction_checkpoint> checkpoint = {},
+                               scylla_metadata::summary_entry_stats se_stats = {});
 
     future<> read_filter(sstable_open_config cfg = {});
 
     void write_filter();
 
+    future<> read_clustering_filter(sstable_open_config cfg = {});
+
+    void write_clustering_filter();
+
     future<> read_summary() noexcept;
 
     void write_summary() {
@@ -788,12 +863,31 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _components->filter->is_present(key);
     }
 
+    void filter_prefetch(utils::hashed_key key) const {
+        _components->filter->prefetch(key);
+    }
+
     bool filter_has_key(const schema& s, partition_key_view key) const {
         return filter_has_key(key::from_partition_key(s, key));
     }
 
     static utils::hashed_key make_hashed_key(const schema& s, const partition_key& key);
 
+    // Keys of the clustering filter are the partition key followed by the
+    // full clustering key of a row. The partition key alone is added for
+    // partitions which also contain range tombstones.
+    static utils::hashed_key make_clustering_filter_key(const key& pk, const clustering_key_prefix* ck = nullptr);
+
+    bool has_clustering_filter() const {
+        return bool(_components->clustering_filter);
+    }
+
+    // Only rows of partitions which have a promoted index are added to the
+    // clustering filter, so a negative answer is meaningful only for those.
+    bool clustering_filter_has_key(utils::hashed_key key) const {
+        return _components->clustering_filter->is_present(key);
+    }
+
     filter_tracker& get_filter_tracker() { return _filter_tracker; }
 
     uint64_t filter_get_false_positive() const {
@@ -840,6 +934,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         const compaction_metadata& s = *static_cast<compaction_metadata *>(p.get());
         return s;
     }
+    // The HyperLogLog sketch of the partition keys, kept in the compaction metadata.
+    // Disengaged when the sstable has no sketch in a supported format.
+    std::optional<hll::HyperLogLog> get_partition_key_sketch() const;
     const serialization_header& get_serialization_header() const {
         return get_mutable_serialization_header(*_components);
     }
@@ -874,14 +971,59 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     future<> mutate_sstable_level(uint32_t);
 
+    // When all the data of the sstable was last repaired, in milliseconds
+    // since the epoch, or 0 if it may contain unrepaired data.
+    uint64_t get_repaired_at() const {
+        return get_stats_metadata().repaired_at;
+    }
+
+    bool is_repaired() const {
+        return get_repaired_at() != 0;
+    }
+
+    future<> mutate_repaired_at(uint64_t repaired_at);
+
     const summary& get_summary() const {
         return _components->summary;
     }
 
     // Gets ratio of droppable tombstone. A tombstone is considered droppable here
     // for cells expired before gc_before and regular tombstones older than gc_before.
+    // Uses the exact counts of tombstone_stats if available, and the tombstone
+    // histogram of the statistics otherwise.
     double estimate_droppable_tombstone_ratio(gc_clock::time_point gc_before) const;
 
+    // Returns the size of the data file spanned by the partitions in the given ranges,
+    // according to the index. The ranges must be sorted and disjoint.
+    future<uint64_t> data_size_in_ranges(const dht::partition_range_vector& ranges, reader_permit permit);
+
+    // Returns the token ranges spanned by the index pages which are hot in the index cache,
+    // i.e. which were loaded for, or promoted by, point reads. The ranges are sorted.
+    dht::token_range_vector get_hot_index_ranges();
+
+    // Loads the index pages which may include keys from the given token ranges into the index cache,
+    // as hot pages. Used to carry the hot pages over from the sstables this one replaces.
+    future<> warm_index_cache(const dht::token_range_vector& ranges, reader_permit permit);
+
+    // Memory used by the cached pages of the index file and by the partition index cache.
+    struct index_cache_residency {
+        size_t index_file_bytes = 0;
+        size_t partition_index_bytes = 0;
+    };
+    index_cache_residency get_index_cache_residency() const;
+
+    // Return the exact counts of the tombstones of the sstable by kind and
+    // deletion time, or nullptr if they are not available.
+    const scylla_metadata::tombstone_stats* get_tombstone_stats() const;
+
+    // Return the partition count and size following each summary entry,
+    // or nullptr if they are not available.
+    const scylla_metadata::summary_entry_stats* get_summary_entry_stats() const;
+
+    // Return the checkpoint of the compaction that wrote the sstable,
+    // or nullptr if the compaction can't be resumed after it.
+    const scylla_metadata::compaction_checkpoint* get_compaction_checkpoint() const;
+
     // get sstable open info from a loaded sstable, which can be used to quickly open a sstable
     // at another shard.
     future<foreign_sstable_open_info> get_open_info() &;
@@ -898,6 +1040,19 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // Return true if this sstable possibly stores clustering row(s) specified by ranges.
     bool may_contain_rows(const query::clustering_row_ranges& ranges) const;
 
+    // Return the statistics about the values of the regular column cdef,
+    // or nullptr if they are not available.
+    const column_value_stats_entry* get_column_value_stats(const column_definition& cdef) const;
+
+    // Return true if this sstable possibly stores a clustering row with a
+    // live cell of the regular column cdef with a value in range.
+    // This only accounts for the cells stored in this sstable.
+    bool may_contain_column_value(const column_definition& cdef, const interval<bytes>& range) const;
+
+    // Return true if this sstable possibly stores a clustering row with no
+    // live cell of the regular column cdef.
+    bool may_contain_null_column_value(const column_definition& cdef) const;
+
     // false => there are no partition tombstones, true => we don't know
     bool may_have_partition_tombstones() const {
         return !has_correct_min_max_column_names()
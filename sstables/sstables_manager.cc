@@ -15,6 +15,7 @@
 #include "gms/feature_service.hh"
 #include "db/system_keyspace.hh"
 #include "utils/s3/client.hh"
+#include "utils/s3/disk_cache.hh"
 
 namespace sstables {
 
@@ -30,10 +31,13 @@ sstables_manager::sstables_manager(
         "sstable_metadata_concurrency_sem",
         std::numeric_limits<size_t>::max(),
         utils::updateable_value(std::numeric_limits<uint32_t>::max()),
-        utils::updateable_value(std::numeric_limits<uint32_t>::max()))
+        utils::updateable_value(std::numeric_limits<uint32_t>::max()),
+        utils::updateable_value(false))
     , _dir_semaphore(dir_sem)
     , _resolve_host_id(std::move(resolve_host_id))
+    , _available_memory(available_memory)
 {
+    _components_reloader_status = components_reloader_fiber();
 }
 
 sstables_manager::~sstables_manager() {
@@ -49,6 +53,9 @@ storage_manager::storage_manager(const db::config& cfg, config stm_cfg)
     for (auto [ep, ecfg] : cfg.object_storage_config()) {
         _s3_endpoints.emplace(std::make_pair(std::move(ep), make_lw_shared<s3::endpoint_config>(std::move(ecfg))));
     }
+    if (stm_cfg.object_cache_dir && stm_cfg.object_cache_size) {
+        _object_cache = make_shared<s3::disk_cache>(*stm_cfg.object_cache_dir / format("shard-{}", this_shard_id()).c_str(), stm_cfg.object_cache_size);
+    }
 }
 
 future<> storage_manager::stop() {
@@ -61,6 +68,10 @@ future<> storage_manager::stop() {
             co_await ep.second.client->close();
         }
     }
+
+    if (_object_cache) {
+        co_await _object_cache->stop();
+    }
 }
 
 void storage_manager::update_config(const db::config& cfg) {
@@ -125,13 +136,18 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
     sstable_writer_config cfg;
 
     cfg.promoted_index_block_size = _db_config.column_index_size_in_kb() * 1024;
+    cfg.promoted_index_initial_block_size = _db_config.column_index_initial_size_in_kb() * 1024;
     cfg.promoted_index_auto_scale_threshold = (size_t)_db_config.column_index_auto_scale_threshold_in_kb() * 1024;
     if (!cfg.promoted_index_auto_scale_threshold) {
         cfg.promoted_index_auto_scale_threshold = std::numeric_limits<size_t>::max();
     }
+    cfg.clustering_filter = _db_config.enable_sstable_clustering_filter();
+    cfg.column_value_stats = _db_config.enable_sstable_column_value_stats();
+    cfg.write_batch_size = size_t(_db_config.sstable_write_batch_size_in_kb()) * 1024;
+    cfg.write_behind = std::max(_db_config.sstable_write_behind(), 1u);
     cfg.validation_level = _db_config.enable_sstable_key_validation()
             ? mutation_fragment_stream_validation_level::clustering_key
-            : mutation_fragment_stream_validation_level::token;
+            : mutation_fragment_stream_validation_level::sampled_clustering_key;
     cfg.summary_byte_cost = summary_byte_cost(_db_config.sstable_summary_ratio());
 
     cfg.origin = std::move(origin);
@@ -143,10 +159,73 @@ void sstables_manager::add(sstable* sst) {
     _active.push_back(*sst);
 }
 
+size_t sstables_manager::get_memory_available_for_reclaimable_components() const {
+    size_t limit = _available_memory * _db_config.components_memory_reclaim_threshold();
+    return limit > _total_reclaimable_memory ? limit - _total_reclaimable_memory : 0;
+}
+
+void sstables_manager::increment_total_reclaimable_memory_and_maybe_reclaim(sstable* sst) {
+    sst->_total_reclaimable_memory = sst->total_reclaimable_memory_size();
+    _total_reclaimable_memory += sst->_total_reclaimable_memory;
+
+    size_t limit = _available_memory * _db_config.components_memory_reclaim_threshold();
+    while (_total_reclaimable_memory > limit) {
+        auto largest = std::max_element(_active.begin(), _active.end(), [] (const sstable& a, const sstable& b) {
+            return a._total_reclaimable_memory < b._total_reclaimable_memory;
+        });
+        if (largest == _active.end() || largest->_total_reclaimable_memory == 0) {
+            break;
+        }
+        auto reclaimed = largest->reclaim_memory_from_components();
+        _total_reclaimable_memory -= reclaimed;
+        _total_memory_reclaimed += reclaimed;
+        _reclaimed.insert(&*largest);
+        smlogger.info("Reclaimed {} bytes of memory from components of {}. Total memory reclaimed so far is {} bytes",
+                reclaimed, largest->get_filename(), _total_memory_reclaimed);
+    }
+}
+
+future<> sstables_manager::components_reloader_fiber() {
+    while (true) {
+        co_await _components_memory_change_event.wait();
+        while (!_closing && !_reclaimed.empty()) {
+            auto smallest = std::min_element(_reclaimed.begin(), _reclaimed.end(), [] (const sstable* a, const sstable* b) {
+                return a->_total_memory_reclaimed < b->_total_memory_reclaimed;
+            });
+            // Hold a reference so that the sstable isn't deactivated while being reloaded.
+            auto sst = (*smallest)->shared_from_this();
+            auto memory = sst->_total_memory_reclaimed;
+            if (memory > get_memory_available_for_reclaimable_components()) {
+                break;
+            }
+            _reclaimed.erase(smallest);
+            try {
+                co_await sst->reload_reclaimed_components();
+            } catch (...) {
+                smlogger.warn("Failed to reload reclaimed components of {}: {}", sst->get_filename(), std::current_exception());
+                _reclaimed.insert(sst.get());
+                break;
+            }
+            _total_memory_reclaimed -= memory;
+            _total_reclaimable_memory += sst->_total_reclaimable_memory;
+            smlogger.info("Reloaded reclaimed components of {}. Total memory reclaimed so far is {} bytes", sst->get_filename(), _total_memory_reclaimed);
+        }
+        if (_closing) {
+            co_return;
+        }
+    }
+}
+
 void sstables_manager::deactivate(sstable* sst) {
     // At this point, sst has a reference count of zero, since we got here from
     // lw_shared_ptr_deleter<sstables::sstable>::dispose().
     _active.erase(_active.iterator_to(*sst));
+    _total_reclaimable_memory -= sst->_total_reclaimable_memory;
+    if (_reclaimed.erase(sst)) {
+        _total_memory_reclaimed -= sst->_total_memory_reclaimed;
+    }
+    // Freed memory may allow reclaimed components of other sstables to be reloaded.
+    _components_memory_change_event.signal();
     _undergoing_close.push_back(*sst);
     // guard against sstable::close_files() calling shared_from_this() and immediately destroying
     // the result, which will dispose of the sstable recursively
@@ -183,6 +262,8 @@ future<> sstables_manager::delete_atomically(std::vector<shared_sstable> ssts) {
 
 future<> sstables_manager::close() {
     _closing = true;
+    _components_memory_change_event.signal();
+    co_await std::exchange(_components_reloader_status, make_ready_future<>());
     maybe_done();
     co_await _done.get_future();
     co_await _sstable_metadata_concurrency_sem.stop();
@@ -9,8 +9,10 @@
 
 #pragma once
 
+#include <filesystem>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/condition-variable.hh>
 
 #include "utils/disk-error-handler.hh"
 #include "gc_clock.hh"
@@ -33,7 +35,7 @@ class config;
 
 }   // namespace db
 
-namespace s3 { class client; }
+namespace s3 { class client; class disk_cache; }
 
 namespace gms { class feature_service; }
 
@@ -60,6 +62,7 @@ class storage_manager : public peering_sharded_service<storage_manager> {
 
     semaphore _s3_clients_memory;
     std::unordered_map<sstring, s3_endpoint> _s3_endpoints;
+    shared_ptr<s3::disk_cache> _object_cache;
     std::unique_ptr<config_updater> _config_updater;
 
     void update_config(const db::config&);
@@ -67,10 +70,15 @@ class storage_manager : public peering_sharded_service<storage_manager> {
 public:
     struct config {
         size_t s3_clients_memory = 16 << 20; // 16M by default
+        // Local directory caching object ranges, disabled when unset.
+        std::optional<std::filesystem::path> object_cache_dir;
+        size_t object_cache_size = 0;
     };
 
     storage_manager(const db::config&, config cfg);
     shared_ptr<s3::client> get_endpoint_client(sstring endpoint);
+    // May return null if caching is disabled.
+    shared_ptr<s3::disk_cache> get_object_cache() const noexcept { return _object_cache; }
     future<> stop();
 };
 
@@ -109,6 +117,18 @@ class sstables_manager {
     // after system_keyspace initialization.
     noncopyable_function<locator::host_id()> _resolve_host_id;
 
+    size_t _available_memory;
+    // Memory held by the reclaimable components (bloom filters) of the
+    // active sstables, and memory reclaimed from them that is yet to be
+    // reloaded.
+    size_t _total_reclaimable_memory = 0;
+    size_t _total_memory_reclaimed = 0;
+    // Sstables whose components were reclaimed. They are reloaded by the
+    // components reloader once enough memory is freed by other sstables.
+    std::unordered_set<sstable*> _reclaimed;
+    condition_variable _components_memory_change_event;
+    future<> _components_reloader_status = make_ready_future<>();
+
 public:
     explicit sstables_manager(db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat, cache_tracker&, size_t available_memory, directory_semaphore& dir_sem, noncopyable_function<locator::host_id()>&& resolve_host_id, storage_manager* shared = nullptr);
     virtual ~sstables_manager();
@@ -128,6 +148,10 @@ class sstables_manager {
         return _storage->get_endpoint_client(std::move(endpoint));
     }
 
+    shared_ptr<s3::disk_cache> get_object_cache() const noexcept {
+        return _storage ? _storage->get_object_cache() : nullptr;
+    }
+
     virtual sstable_writer_config configure_writer(sstring origin) const;
     bool uuid_sstable_identifiers() const;
     const db::config& config() const { return _db_config; }
@@ -162,6 +186,9 @@ class sstables_manager {
 
     future<> delete_atomically(std::vector<shared_sstable> ssts);
 
+    size_t get_total_reclaimable_memory() const noexcept { return _total_reclaimable_memory; }
+    size_t get_total_memory_reclaimed() const noexcept { return _total_memory_reclaimed; }
+
 private:
     void add(sstable* sst);
     // Transition the sstable to the "inactive" state. It has no
@@ -171,6 +198,15 @@ class sstables_manager {
     void remove(sstable* sst);
     void maybe_done();
 
+    size_t get_memory_available_for_reclaimable_components() const;
+    // Accounts the reclaimable memory of a newly opened sstable, and reclaims
+    // memory from the largest components until the total is back under
+    // components_memory_reclaim_threshold.
+    void increment_total_reclaimable_memory_and_maybe_reclaim(sstable* sst);
+    // Reloads reclaimed components, smallest first, as long as they fit
+    // under the threshold.
+    future<> components_reloader_fiber();
+
     static constexpr size_t max_count_sstable_metadata_concurrent_reads{10};
     // Allow at most 10% of memory to be filled with such reads.
     size_t max_memory_sstable_metadata_concurrent_reads(size_t available_memory) { return available_memory * 0.1; }
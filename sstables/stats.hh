@@ -28,6 +28,8 @@ class sstables_stats {
         uint64_t partition_reads = 0;
         uint64_t partition_seeks = 0;
         uint64_t row_reads = 0;
+        uint64_t single_key_reads = 0;
+        uint64_t single_key_read_sstables = 0;
         uint64_t capped_local_deletion_time = 0;
         uint64_t capped_tombstone_deletion_time = 0;
         uint64_t open_for_reading = 0;
@@ -36,6 +38,11 @@ class sstables_stats {
         uint64_t closed_for_writing = 0;
         uint64_t deleted = 0;
         uint64_t promoted_index_auto_scale_events = 0;
+        uint64_t clustering_filter_skips = 0;
+        uint64_t data_writes = 0;
+        uint64_t data_write_bytes = 0;
+        uint64_t data_writes_in_flight = 0;
+        uint64_t data_preallocated_bytes = 0;
     } _shard_stats;
 
     stats& _stats = _shard_stats;
@@ -101,6 +108,16 @@ class sstables_stats {
         ++_stats.row_reads;
     }
 
+    // Called once per single-key read of an sstable set, with the number of sstables it reads.
+    static void on_single_key_read(uint64_t sstables) noexcept {
+        ++_shard_stats.single_key_reads;
+        _shard_stats.single_key_read_sstables += sstables;
+    }
+
+    inline void on_clustering_filter_skip() noexcept {
+        ++_stats.clustering_filter_skips;
+    }
+
     inline void on_capped_local_deletion_time() noexcept {
         ++_stats.capped_local_deletion_time;
     }
@@ -127,6 +144,18 @@ class sstables_stats {
         ++_stats.deleted;
     }
 
+    inline void on_data_write_issued(uint64_t bytes) noexcept {
+        ++_stats.data_writes;
+        _stats.data_write_bytes += bytes;
+        ++_stats.data_writes_in_flight;
+    }
+    inline void on_data_write_completed() noexcept {
+        --_stats.data_writes_in_flight;
+    }
+    inline void on_data_preallocation(uint64_t bytes) noexcept {
+        _stats.data_preallocated_bytes += bytes;
+    }
+
     inline void on_promoted_index_auto_scale() noexcept {
         ++_stats.promoted_index_auto_scale_events;
     }
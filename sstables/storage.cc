@@ -10,6 +10,8 @@
 
 #include <cerrno>
 #include <boost/algorithm/string.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/numeric.hpp>
 
 #include <exception>
 #include <seastar/coroutine/exception.hh>
@@ -21,6 +23,7 @@
 #include "sstables/sstable_directory.hh"
 #include "sstables/sstables_manager.hh"
 #include "sstables/sstable_version.hh"
+#include "sstables/stats.hh"
 #include "sstables/integrity_checked_file_impl.hh"
 #include "sstables/writer.hh"
 #include "db/system_keyspace.hh"
@@ -28,6 +31,7 @@
 #include "utils/overloaded_functor.hh"
 #include "utils/memory_data_sink.hh"
 #include "utils/s3/client.hh"
+#include "utils/s3/disk_cache.hh"
 
 #include "checked-file-impl.hh"
 
@@ -67,7 +71,7 @@ class filesystem_storage final : public sstables::storage {
     virtual void open(sstable& sst) override;
     virtual future<> wipe(const sstable& sst, sync_dir) noexcept override;
     virtual future<file> open_component(const sstable& sst, component_type type, open_flags flags, file_open_options options, bool check_integrity) override;
-    virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type) override;
+    virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type, file_output_stream_options options) override;
     virtual future<data_sink> make_component_sink(sstable& sst, component_type type, open_flags oflags, file_output_stream_options options) override;
     virtual future<> destroy(const sstable& sst) override { return make_ready_future<>(); }
     virtual noncopyable_function<future<>(std::vector<shared_sstable>)> atomic_deleter() const override {
@@ -78,13 +82,73 @@ class filesystem_storage final : public sstables::storage {
     virtual sstring prefix() const override { return _dir; }
 };
 
-future<data_sink> filesystem_storage::make_data_or_index_sink(sstable& sst, component_type type) {
-    file_output_stream_options options;
-    options.buffer_size = sst.sstable_buffer_size;
-    options.write_behind = 10;
+// Accounts the writes issued to the data and index components in sstables_stats.
+class write_stats_file_impl : public file_impl {
+    file _file;
+    sstables_stats _stats;
+
+    future<size_t> account(size_t len, future<size_t> f) {
+        _stats.on_data_write_issued(len);
+        return f.finally([this] {
+            _stats.on_data_write_completed();
+        });
+    }
+public:
+    explicit write_stats_file_impl(file f)
+        : file_impl(*get_file_impl(f))
+        , _file(std::move(f))
+    {}
+
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, io_intent* intent) override {
+        return account(len, get_file_impl(_file)->write_dma(pos, buffer, len, intent));
+    }
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, io_intent* intent) override {
+        auto len = boost::accumulate(iov | boost::adaptors::transformed(std::mem_fn(&iovec::iov_len)), size_t(0));
+        return account(len, get_file_impl(_file)->write_dma(pos, std::move(iov), intent));
+    }
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, io_intent* intent) override {
+        return get_file_impl(_file)->read_dma(pos, buffer, len, intent);
+    }
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, io_intent* intent) override {
+        return get_file_impl(_file)->read_dma(pos, std::move(iov), intent);
+    }
+    virtual future<> flush() override {
+        return get_file_impl(_file)->flush();
+    }
+    virtual future<struct stat> stat() override {
+        return get_file_impl(_file)->stat();
+    }
+    virtual future<> truncate(uint64_t length) override {
+        return get_file_impl(_file)->truncate(length);
+    }
+    virtual future<> discard(uint64_t offset, uint64_t length) override {
+        return get_file_impl(_file)->discard(offset, length);
+    }
+    virtual future<> allocate(uint64_t position, uint64_t length) override {
+        _stats.on_data_preallocation(length);
+        return get_file_impl(_file)->allocate(position, length);
+    }
+    virtual future<uint64_t> size() override {
+        return get_file_impl(_file)->size();
+    }
+    virtual future<> close() override {
+        return get_file_impl(_file)->close();
+    }
+    virtual std::unique_ptr<seastar::file_handle_impl> dup() override {
+        return get_file_impl(_file)->dup();
+    }
+    virtual subscription<directory_entry> list_directory(std::function<future<> (directory_entry de)> next) override {
+        return get_file_impl(_file)->list_directory(std::move(next));
+    }
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, io_intent* intent) override {
+        return get_file_impl(_file)->dma_read_bulk(offset, range_size, intent);
+    }
+};
 
+future<data_sink> filesystem_storage::make_data_or_index_sink(sstable& sst, component_type type, file_output_stream_options options) {
     assert(type == component_type::Data || type == component_type::Index);
-    return make_file_data_sink(type == component_type::Data ? std::move(sst._data_file) : std::move(sst._index_file), options);
+    auto f = type == component_type::Data ? std::move(sst._data_file) : std::move(sst._index_file);
+    return make_file_data_sink(file(make_shared<write_stats_file_impl>(std::move(f))), options);
 }
 
 future<data_sink> filesystem_storage::make_component_sink(sstable& sst, component_type type, open_flags oflags, file_output_stream_options options) {
@@ -462,7 +526,7 @@ class s3_storage : public sstables::storage {
     virtual void open(sstable& sst) override;
     virtual future<> wipe(const sstable& sst, sync_dir) noexcept override;
     virtual future<file> open_component(const sstable& sst, component_type type, open_flags flags, file_open_options options, bool check_integrity) override;
-    virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type) override;
+    virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type, file_output_stream_options options) override;
     virtual future<data_sink> make_component_sink(sstable& sst, component_type type, open_flags oflags, file_output_stream_options options) override;
     virtual future<> destroy(const sstable& sst) override {
         return make_ready_future<>();
@@ -507,10 +571,15 @@ void s3_storage::open(sstable& sst) {
 
 future<file> s3_storage::open_component(const sstable& sst, component_type type, open_flags flags, file_open_options options, bool check_integrity) {
     co_await ensure_remote_prefix(sst);
-    co_return _client->make_readable_file(make_s3_object_name(sst, type));
+    auto object_name = make_s3_object_name(sst, type);
+    auto f = _client->make_readable_file(object_name);
+    if (auto cache = sst.manager().get_object_cache()) {
+        f = s3::make_cached_file(std::move(cache), std::move(object_name), std::move(f));
+    }
+    co_return f;
 }
 
-future<data_sink> s3_storage::make_data_or_index_sink(sstable& sst, component_type type) {
+future<data_sink> s3_storage::make_data_or_index_sink(sstable& sst, component_type type, file_output_stream_options) {
     assert(type == component_type::Data || type == component_type::Index);
     co_await ensure_remote_prefix(sst);
     // FIXME: if we have file size upper bound upfront, it's better to use make_upload_sink() instead
@@ -583,7 +652,17 @@ future<> s3_storage::delete_with_system_keyspace(std::vector<shared_sstable> sst
 }
 
 future<> s3_storage::snapshot(const sstable& sst, sstring dir, absolute_path abs) const {
-    co_await coroutine::return_exception(std::runtime_error("Snapshotting S3 objects not implemented"));
+    // Snapshots are kept next to the sstable's objects, under the snapshot
+    // name (the last component of the directory the filesystem storage would
+    // link them to). The objects are copied by the server.
+    auto name = abs ? std::filesystem::path(dir.c_str()).filename().native() : std::string(dir);
+    auto prefix = _remote_prefix ? *_remote_prefix
+            : (co_await sst.manager().system_keyspace().sstables_registry_lookup_entry(_location, sst.generation())).to_sstring();
+    co_await coroutine::parallel_for_each(sst.all_components(), [&] (const std::pair<component_type, sstring>& comp) -> future<> {
+        auto source = format("/{}/{}/{}", _bucket, prefix, comp.second);
+        auto target = format("/{}/{}/{}/{}", _bucket, prefix, name, comp.second);
+        co_await _client->copy_object(std::move(source), std::move(target));
+    });
 }
 
 std::unique_ptr<sstables::storage> make_storage(sstables_manager& manager, const data_dictionary::storage_options& s_opts, sstring dir, sstable_state state) {
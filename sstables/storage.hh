@@ -59,7 +59,7 @@ class storage {
     virtual void open(sstable& sst) = 0;
     virtual future<> wipe(const sstable& sst, sync_dir) noexcept = 0;
     virtual future<file> open_component(const sstable& sst, component_type type, open_flags flags, file_open_options options, bool check_integrity) = 0;
-    virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type) = 0;
+    virtual future<data_sink> make_data_or_index_sink(sstable& sst, component_type type, file_output_stream_options options) = 0;
     virtual future<data_sink> make_component_sink(sstable& sst, component_type type, open_flags oflags, file_output_stream_options options) = 0;
     virtual future<> destroy(const sstable& sst) = 0;
     virtual noncopyable_function<future<>(std::vector<shared_sstable>)> atomic_deleter() const = 0;
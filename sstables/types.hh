@@ -174,6 +174,14 @@ struct summary_ka {
     utils::chunked_vector<uint32_t> positions;   // can be large, so use a deque instead of a vector
     utils::chunked_vector<summary_entry> entries;
 
+    // In-memory radix directory over the leading bits of the (byte-comparable)
+    // token of each entry. token_directory[p] is the index of the first entry
+    // whose token prefix is >= p, so a lookup only needs to bisect the entries
+    // sharing the searched token's prefix instead of the whole summary.
+    // Not part of the on-disk format; built by build_summary_token_directory().
+    utils::chunked_vector<uint32_t> token_directory;
+    unsigned token_directory_shift = 64;
+
     disk_string<uint32_t> first_key;
     disk_string<uint32_t> last_key;
 
@@ -193,6 +201,7 @@ struct summary_ka {
      */
     uint64_t memory_footprint() const {
         auto sz = sizeof(summary_entry) * entries.size() + sizeof(uint32_t) * positions.size() + sizeof(*this);
+        sz += sizeof(uint32_t) * token_directory.size();
         sz += first_key.value.size() + last_key.value.size();
         for (auto& sd : _summary_data) {
             sz += sd.size();
@@ -204,6 +213,23 @@ struct summary_ka {
         return entries.size();
     }
 
+    static uint64_t token_prefix_bits(int64_t raw_token) noexcept {
+        // Flip the sign bit so that unsigned order matches token order.
+        return uint64_t(raw_token) ^ (uint64_t(1) << 63);
+    }
+
+    // Returns the range [first, last) of entry indexes which must contain the
+    // lower bound of any ring position with the given token, or the whole
+    // summary if the directory is not built. The lower bound itself may be
+    // equal to `last`.
+    std::pair<uint64_t, uint64_t> token_directory_range(const dht::token& t) const {
+        if (token_directory.empty() || t._kind != dht::token::kind::key) {
+            return {0, entries.size()};
+        }
+        auto prefix = token_prefix_bits(t._data) >> token_directory_shift;
+        return {token_directory[prefix], token_directory[prefix + 1]};
+    }
+
     bytes_view add_summary_data(bytes_view data) {
         if (_summary_data.empty() || (_summary_index_pos + data.size() > _buffer_size)) {
             _buffer_size = std::min(_buffer_size << 1, 128u << 10);
@@ -533,6 +559,10 @@ enum class scylla_metadata_type : uint32_t {
     SSTableOrigin = 6,
     ScyllaBuildId = 7,
     ScyllaVersion = 8,
+    ColumnValueStats = 9,
+    TombstoneStats = 10,
+    CompactionCheckpoint = 11,
+    SummaryEntryStats = 12,
 };
 
 // UUID is used for uniqueness across nodes, such that an imported sstable
@@ -567,12 +597,87 @@ struct large_data_stats_entry {
     auto describe_type(sstable_version_types v, Describer f) { return f(max_value, threshold, above_threshold); }
 };
 
+// Statistics about the values of a regular column, across
+// all clustering rows of the sstable.
+struct column_value_stats_entry {
+    // Number of clustering rows with no live cell for the column.
+    uint64_t null_count;
+    // Whether min_value and max_value are valid. They are not kept for
+    // counters and for columns with values too large to keep around.
+    uint8_t has_min_max; // really a boolean
+    disk_string<uint32_t> min_value;
+    disk_string<uint32_t> max_value;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(null_count, has_min_max, min_value, max_value); }
+};
+
+// Kinds of tombstones counted in tombstone_stats.
+//
+// Note: For extensibility, never reuse an identifier,
+// only add new ones, since these are stored on stable storage.
+enum class tombstone_kind : uint32_t {
+    partition = 1,  // partition tombstones
+    range = 2,      // range tombstone bounds and boundaries
+    row = 3,        // row tombstones, both regular and shadowable
+    cell = 4,       // cell and collection tombstones
+    expiring = 5,   // expiring cells and row markers, counted at their expiry
+};
+
+// Tombstones whose local deletion time is at most max_deletion_time,
+// and greater than that of the previous bucket.
+struct tombstone_count_bucket {
+    int32_t max_deletion_time;
+    uint64_t count;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(max_deletion_time, count); }
+};
+
+struct tombstone_stats_entry {
+    // Number of tombstones of the kind, same as the sum of the bucket counts.
+    uint64_t count;
+    // Exact counts by local deletion time, ordered by max_deletion_time.
+    disk_array<uint32_t, tombstone_count_bucket> buckets;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(count, buckets); }
+};
+
+// Written to the output sstables of compactions that can be resumed
+// after a restart, see compaction_manager::get_resumable_compaction_job().
+struct compaction_checkpoint {
+    // Generations of all the sstables being compacted.
+    disk_array<uint32_t, disk_string<uint32_t>> inputs;
+    // Threshold size of the output sstables.
+    uint64_t max_sstable_size;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(inputs, max_sstable_size); }
+};
+
+// The partitions from a summary entry (included) to the next one (excluded),
+// or to the end of the sstable for the last entry.
+struct summary_entry_stats_entry {
+    uint32_t partitions;
+    // Uncompressed size of the partitions in the data file.
+    uint64_t data_size;
+
+    template <typename Describer>
+    auto describe_type(sstable_version_types v, Describer f) { return f(partitions, data_size); }
+};
+
 struct scylla_metadata {
     using extension_attributes = disk_hash<uint32_t, disk_string<uint32_t>, disk_string<uint32_t>>;
     using large_data_stats = disk_hash<uint32_t, large_data_type, large_data_stats_entry>;
     using sstable_origin = disk_string<uint32_t>;
     using scylla_build_id = disk_string<uint32_t>;
     using scylla_version = disk_string<uint32_t>;
+    // Keyed by column name
+    using column_value_stats = disk_hash<uint32_t, disk_string<uint32_t>, column_value_stats_entry>;
+    using tombstone_stats = disk_hash<uint32_t, tombstone_kind, tombstone_stats_entry>;
+    // One element per summary entry
+    using summary_entry_stats = disk_array<uint32_t, summary_entry_stats_entry>;
 
     disk_set_of_tagged_union<scylla_metadata_type,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::Sharding, sharding_metadata>,
@@ -582,7 +687,11 @@ struct scylla_metadata {
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::LargeDataStats, large_data_stats>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::SSTableOrigin, sstable_origin>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaBuildId, scylla_build_id>,
-            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaVersion, scylla_version>
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ScyllaVersion, scylla_version>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ColumnValueStats, column_value_stats>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::TombstoneStats, tombstone_stats>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::CompactionCheckpoint, compaction_checkpoint>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::SummaryEntryStats, summary_entry_stats>
             > data;
 
     sstable_enabled_features get_features() const {
@@ -610,6 +610,9 @@ future<> seal_summary(summary& s,
     std::optional<key>&& last_key,
     const index_sampling_state& state);
 
+// Builds the in-memory token directory of a fully populated summary.
+future<> build_summary_token_directory(summary& s);
+
 void seal_statistics(sstable_version_types, statistics&, metadata_collector&,
     const sstring partitioner, double bloom_filter_fp_chance, schema_ptr,
     const dht::decorated_key& first_key, const dht::decorated_key& last_key,
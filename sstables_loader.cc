@@ -19,6 +19,7 @@
 #include "readers/mutation_fragment_v1_stream.hh"
 #include "locator/abstract_replication_strategy.hh"
 #include "message/messaging_service.hh"
+#include "db/config.hh"
 
 #include <cfloat>
 #include <algorithm>
@@ -27,6 +28,9 @@ static logging::logger llog("sstables_loader");
 
 namespace {
 
+// The maximum number of sstables streamed by a single reader when pipelined.
+constexpr size_t pipelined_batch_sst_nr = 256;
+
 class send_meta_data {
     gms::inet_address _node;
     seastar::rpc::sink<frozen_mutation_fragment, streaming::stream_mutation_fragments_cmd> _sink;
@@ -113,10 +117,119 @@ class send_meta_data {
     }
 };
 
+future<> send_to_targets(std::unordered_map<gms::inet_address, send_meta_data>& metas, inet_address_vector_replica_set targets,
+        frozen_mutation_fragment fmf, bool is_partition_start) {
+    co_await coroutine::parallel_for_each(targets, [&metas, &fmf, is_partition_start] (const gms::inet_address& node) {
+        return metas.at(node).send(fmf, is_partition_start);
+    });
+}
+
 } // anonymous namespace
 
+class sstables_loader::task_manager_module : public tasks::task_manager::module {
+public:
+    task_manager_module(tasks::task_manager& tm) noexcept : tasks::task_manager::module(tm, "sstables_loader") {}
+};
+
+// Loads the sstables of the upload directory of a table and streams them from
+// all shards, each one running a shard_load_and_stream_task_impl child.
+class load_and_stream_task_impl : public tasks::task_manager::task::impl {
+    sstables_loader& _loader;
+    bool _primary_replica_only;
+public:
+    load_and_stream_task_impl(tasks::task_manager::module_ptr module, sstables_loader& loader, std::string ks_name, std::string cf_name, bool primary_replica_only) noexcept
+        : tasks::task_manager::task::impl(module, tasks::task_id::create_random_id(), module->new_sequence_number(), "table", std::move(ks_name), std::move(cf_name), "", tasks::task_id::create_null_id())
+        , _loader(loader)
+        , _primary_replica_only(primary_replica_only)
+    {
+        _status.progress_units = "partitions";
+    }
+
+    virtual std::string type() const override {
+        return "load_and_stream";
+    }
+protected:
+    virtual future<> run() override;
+
+    virtual std::optional<double> expected_children_number() const override {
+        return smp::count;
+    }
+};
+
+class shard_load_and_stream_task_impl : public tasks::task_manager::task::impl {
+    sstables_loader& _loader;
+    ::table_id _table_id;
+    std::vector<sstables::shared_sstable> _sstables;
+    bool _primary_replica_only;
+    bool _pipelined;
+    tasks::task_manager::task::progress _progress;
+public:
+    shard_load_and_stream_task_impl(tasks::task_manager::module_ptr module, tasks::task_id parent_id, sstables_loader& loader, std::string ks_name, std::string cf_name,
+            ::table_id table_id, std::vector<sstables::shared_sstable> sstables, bool primary_replica_only, bool pipelined) noexcept
+        : tasks::task_manager::task::impl(module, tasks::task_id::create_random_id(), 0, "shard", std::move(ks_name), std::move(cf_name), "", parent_id)
+        , _loader(loader)
+        , _table_id(table_id)
+        , _sstables(std::move(sstables))
+        , _primary_replica_only(primary_replica_only)
+        , _pipelined(pipelined)
+    {
+        _status.progress_units = "partitions";
+    }
+
+    virtual std::string type() const override {
+        return "load_and_stream";
+    }
+
+    virtual future<tasks::task_manager::task::progress> get_progress() const override {
+        return make_ready_future<tasks::task_manager::task::progress>(_progress);
+    }
+protected:
+    virtual future<> run() override {
+        return _loader.load_and_stream(_status.keyspace, _status.table, _table_id, std::move(_sstables), _primary_replica_only, _pipelined, _progress);
+    }
+};
+
+future<> load_and_stream_task_impl::run() {
+    // Load-and-stream reads the entire content from SSTables, therefore it can afford to discard the bloom filter
+    // that might otherwise consume a significant amount of memory.
+    sstables::sstable_open_config cfg {
+        .load_bloom_filter = false,
+    };
+    bool pipelined = _loader._db.local().get_config().enable_pipelined_load_and_stream();
+    ::table_id table_id;
+    std::vector<std::vector<sstables::shared_sstable>> sstables_on_shards;
+    std::tie(table_id, sstables_on_shards) = co_await replica::distributed_loader::get_sstables_from_upload_dir(_loader._db, _status.keyspace, _status.table, cfg, pipelined);
+    co_await _loader.container().invoke_on_all([&sstables_on_shards, ks_name = _status.keyspace, cf_name = _status.table, table_id, primary_replica_only = _primary_replica_only, pipelined,
+            parent_info = tasks::task_info(_status.id, _status.shard)] (sstables_loader& loader) mutable -> future<> {
+        auto task = co_await loader._task_manager_module->make_and_start_task<shard_load_and_stream_task_impl>(parent_info, parent_info.id, loader, ks_name, cf_name,
+                table_id, std::move(sstables_on_shards[this_shard_id()]), primary_replica_only, pipelined);
+        co_await task->done();
+    });
+}
+
+sstables_loader::sstables_loader(sharded<replica::database>& db,
+        sharded<db::system_distributed_keyspace>& sys_dist_ks,
+        sharded<db::view::view_update_generator>& view_update_generator,
+        netw::messaging_service& messaging,
+        tasks::task_manager& tm)
+    : _db(db)
+    , _sys_dist_ks(sys_dist_ks)
+    , _view_update_generator(view_update_generator)
+    , _messaging(messaging)
+    , _task_manager_module(make_shared<task_manager_module>(tm))
+{
+    tm.register_module(_task_manager_module->get_name(), _task_manager_module);
+}
+
+future<> sstables_loader::stop() {
+    if (auto tm = std::exchange(_task_manager_module, nullptr)) {
+        co_await tm->stop();
+    }
+}
+
 future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
-        ::table_id table_id, std::vector<sstables::shared_sstable> sstables, bool primary_replica_only) {
+        ::table_id table_id, std::vector<sstables::shared_sstable> sstables, bool primary_replica_only,
+        bool pipelined, tasks::task_manager::task::progress& progress) {
     const auto full_partition_range = dht::partition_range::make_open_ended_both_sides();
     const auto full_token_range = dht::token_range::make_open_ended_both_sides();
     auto& table = _db.local().find_column_family(table_id);
@@ -137,10 +250,18 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
 
     size_t nr_sst_total = sstables.size();
     size_t nr_sst_current = 0;
+    for (auto& sst : sstables) {
+        progress.total += sst->estimated_keys_for_range(full_token_range);
+    }
     while (!sstables.empty()) {
         auto ops_uuid = streaming::plan_id{utils::make_random_uuid()};
         auto sst_set = make_lw_shared<sstables::sstable_set>(sstables::make_partitioned_sstable_set(s, false));
-        size_t batch_sst_nr = 16;
+        // The partitioned set opens the sstables incrementally, as the reader
+        // advances, so a pipelined stream can afford to cover many more of them.
+        // It is still bounded: sstables overlapping in token range are all
+        // open at the same time, and the number of partitions announced to
+        // the replicas when the stream starts is only an estimate.
+        size_t batch_sst_nr = pipelined ? pipelined_batch_sst_nr : 16;
         std::vector<sstring> sst_names;
         std::vector<sstables::shared_sstable> sst_processed;
         size_t estimated_partitions = 0;
@@ -166,12 +287,14 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
         auto reader = mutation_fragment_v1_stream(table.make_streaming_reader(s, std::move(permit), full_partition_range, sst_set, gc_clock::now()));
         std::exception_ptr eptr;
         bool failed = false;
+        future<> pending_send = make_ready_future<>();
         try {
             netw::messaging_service& ms = _messaging;
             while (auto mf = co_await reader()) {
                 bool is_partition_start = mf->is_partition_start();
                 if (is_partition_start) {
                     ++num_partitions_processed;
+                    ++progress.completed;
                     auto& start = mf->as_partition_start();
                     const auto& current_dk = start.key();
 
@@ -193,16 +316,23 @@ future<> sstables_loader::load_and_stream(sstring ks_name, sstring cf_name,
                 }
                 frozen_mutation_fragment fmf = freeze(*s, *mf);
                 num_bytes_read += fmf.representation().size();
-                co_await coroutine::parallel_for_each(current_targets, [&metas, &fmf, is_partition_start] (const gms::inet_address& node) {
-                    return metas.at(node).send(fmf, is_partition_start);
-                });
+                // Fragments are sent in order, but when pipelined, the next
+                // fragment is read while this one is still being sent.
+                co_await std::exchange(pending_send, make_ready_future<>());
+                pending_send = send_to_targets(metas, current_targets, std::move(fmf), is_partition_start);
+                if (!pipelined) {
+                    co_await std::exchange(pending_send, make_ready_future<>());
+                }
             }
+            co_await std::exchange(pending_send, make_ready_future<>());
         } catch (...) {
             failed = true;
             eptr = std::current_exception();
             llog.warn("load_and_stream: ops_uuid={}, ks={}, table={}, send_phase, err={}",
                     ops_uuid, ks_name, cf_name, eptr);
         }
+        // The stream failed already, so the outcome of the last send doesn't matter.
+        co_await std::move(pending_send).handle_exception([] (std::exception_ptr) {});
         co_await reader.close();
         try {
             co_await coroutine::parallel_for_each(metas.begin(), metas.end(), [failed] (std::pair<const gms::inet_address, send_meta_data>& pair) {
@@ -260,17 +390,8 @@ future<> sstables_loader::load_new_sstables(sstring ks_name, sstring cf_name,
             ks_name, cf_name, load_and_stream, primary_replica_only);
     try {
         if (load_and_stream) {
-            ::table_id table_id;
-            std::vector<std::vector<sstables::shared_sstable>> sstables_on_shards;
-            // Load-and-stream reads the entire content from SSTables, therefore it can afford to discard the bloom filter
-            // that might otherwise consume a significant amount of memory.
-            sstables::sstable_open_config cfg {
-                .load_bloom_filter = false,
-            };
-            std::tie(table_id, sstables_on_shards) = co_await replica::distributed_loader::get_sstables_from_upload_dir(_db, ks_name, cf_name, cfg);
-            co_await container().invoke_on_all([&sstables_on_shards, ks_name, cf_name, table_id, primary_replica_only] (sstables_loader& loader) mutable -> future<> {
-                co_await loader.load_and_stream(ks_name, cf_name, table_id, std::move(sstables_on_shards[this_shard_id()]), primary_replica_only);
-            });
+            auto task = co_await _task_manager_module->make_and_start_task<load_and_stream_task_impl>({}, *this, ks_name, cf_name, primary_replica_only);
+            co_await task->done();
         } else {
             co_await replica::distributed_loader::process_upload_dir(_db, _sys_dist_ks, _view_update_generator, ks_name, cf_name);
         }
@@ -11,6 +11,7 @@
 #include <seastar/core/sharded.hh>
 #include "schema/schema_fwd.hh"
 #include "sstables/shared_sstable.hh"
+#include "tasks/task_manager.hh"
 
 using namespace seastar;
 
@@ -31,10 +32,14 @@ class view_update_generator;
 // Gets sstables from the upload directory and makes them available in the
 // system. Built on top of the distributed_loader functionality.
 class sstables_loader : public seastar::peering_sharded_service<sstables_loader> {
+public:
+    class task_manager_module;
+private:
     sharded<replica::database>& _db;
     sharded<db::system_distributed_keyspace>& _sys_dist_ks;
     sharded<db::view::view_update_generator>& _view_update_generator;
     netw::messaging_service& _messaging;
+    shared_ptr<task_manager_module> _task_manager_module;
 
     // Note that this is obviously only valid for the current shard. Users of
     // this facility should elect a shard to be the coordinator based on any
@@ -44,21 +49,25 @@ class sstables_loader : public seastar::peering_sharded_service<sstables_loader>
     // ever arise.
     bool _loading_new_sstables = false;
 
+    // Streams the sstables to the replicas owning their data. When pipelined, the
+    // sstables are read in larger batches, each by a single reader, and the next mutation
+    // fragment is read while the previous one is being sent. The progress is accounted
+    // in partitions.
     future<> load_and_stream(sstring ks_name, sstring cf_name,
             table_id, std::vector<sstables::shared_sstable> sstables,
-            bool primary_replica_only);
+            bool primary_replica_only, bool pipelined, tasks::task_manager::task::progress& progress);
+
+    friend class load_and_stream_task_impl;
+    friend class shard_load_and_stream_task_impl;
 
 public:
     sstables_loader(sharded<replica::database>& db,
             sharded<db::system_distributed_keyspace>& sys_dist_ks,
             sharded<db::view::view_update_generator>& view_update_generator,
-            netw::messaging_service& messaging)
-        : _db(db)
-        , _sys_dist_ks(sys_dist_ks)
-        , _view_update_generator(view_update_generator)
-        , _messaging(messaging)
-    {
-    }
+            netw::messaging_service& messaging,
+            tasks::task_manager& tm);
+
+    future<> stop();
 
     /**
      * Load new SSTables not currently tracked by the system
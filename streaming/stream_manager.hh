@@ -21,6 +21,7 @@
 #include "gms/endpoint_state.hh"
 #include "gms/application_state.hh"
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/metrics_registration.hh>
 #include <map>
 
@@ -91,6 +92,8 @@ class stream_manager : public gms::i_endpoint_state_change_subscriber, public en
     uint64_t _total_incoming_bytes{0};
     uint64_t _total_outgoing_bytes{0};
     semaphore _mutation_send_limiter{256};
+    // Receptions of STREAM_SSTABLE_FILES, which continue after the verb handler returns
+    seastar::gate _sstable_files_gate;
     seastar::metrics::metric_groups _metrics;
     std::unordered_map<streaming::stream_reason, float> _finished_percentage;
 
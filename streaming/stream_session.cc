@@ -31,11 +31,18 @@
 #include "db/view/view_update_checks.hh"
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/adaptor/transformed.hpp>
 #include "replica/database.hh"
 #include "mutation/mutation_source_metadata.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
+#include "sstables/sstables.hh"
+#include "idl/frozen_mutation.dist.hh"
+#include "idl/frozen_mutation.dist.impl.hh"
+#include <seastar/core/coroutine.hh>
 #include "consumer.hh"
-#include "readers/generating_v2.hh"
+#include "readers/flat_mutation_reader_v2.hh"
+#include "readers/upgrading_consumer.hh"
 
 namespace streaming {
 
@@ -86,6 +93,230 @@ class offstrategy_trigger {
     }
 };
 
+// Reads the mutation fragments received with STREAM_MUTATION_FRAGMENTS.
+// All the fragments of a message, which can be a whole batch, are unfrozen
+// and upgraded straight into the buffer of the reader, without going through
+// a future and an intermediate queue per fragment, like a generating reader
+// does.
+class stream_mutation_fragments_reader final : public flat_mutation_reader_v2::impl {
+    struct consumer {
+        stream_mutation_fragments_reader* _reader;
+        void operator()(mutation_fragment_v2&& mf) {
+            _reader->push_mutation_fragment(std::move(mf));
+        }
+    };
+    using source_type = rpc::source<frozen_mutation_fragment, rpc::optional<stream_mutation_fragments_cmd>>;
+
+    source_type _source;
+    sharded<stream_manager>& _sm;
+    streaming::plan_id _plan_id;
+    gms::inet_address _from;
+    lw_shared_ptr<offstrategy_trigger> _offstrategy_update;
+    upgrading_consumer<consumer> _upgrading_consumer;
+    bool _got_cmd = false;
+private:
+    void consume(frozen_mutation_fragment& fmf) {
+        _upgrading_consumer.consume(fmf.unfreeze(*_schema, _permit));
+    }
+
+    future<> consume_batch(frozen_mutation_fragment& fmf) {
+        _sm.local().update_progress(_plan_id, _from, progress_info::direction::IN, fmf.representation().size());
+        auto in = ser::as_input_stream(fmf.representation());
+        auto fragments = ser::deserialize(in, boost::type<std::vector<frozen_mutation_fragment>>());
+        if (fragments.empty()) {
+            throw std::runtime_error("Sender sent an empty batch");
+        }
+        for (auto& f : fragments) {
+            consume(f);
+            co_await coroutine::maybe_yield();
+        }
+    }
+public:
+    stream_mutation_fragments_reader(schema_ptr s, reader_permit permit, source_type source, sharded<stream_manager>& sm,
+            streaming::plan_id plan_id, gms::inet_address from, lw_shared_ptr<offstrategy_trigger> offstrategy_update)
+        : impl(s, permit)
+        , _source(std::move(source))
+        , _sm(sm)
+        , _plan_id(plan_id)
+        , _from(from)
+        , _offstrategy_update(std::move(offstrategy_update))
+        , _upgrading_consumer(*_schema, _permit, consumer{this})
+    { }
+
+    virtual future<> fill_buffer() override {
+        while (!is_end_of_stream() && !is_buffer_full()) {
+            auto opt = co_await _source();
+            if (!opt) {
+                // If the sender has sent stream_mutation_fragments_cmd it means it is
+                // a node that understands the new protocol. It must send end_of_stream
+                // before close the stream.
+                if (_got_cmd) {
+                    throw std::runtime_error("Sender did not sent end_of_stream");
+                }
+                _end_of_stream = true;
+                break;
+            }
+            auto& fmf = std::get<0>(*opt);
+            if (auto cmd = std::get<1>(*opt)) {
+                _got_cmd = true;
+                switch (*cmd) {
+                case stream_mutation_fragments_cmd::mutation_fragment_data:
+                    break;
+                case stream_mutation_fragments_cmd::mutation_fragment_batch:
+                    co_await consume_batch(fmf);
+                    _offstrategy_update->update();
+                    continue;
+                case stream_mutation_fragments_cmd::error:
+                    throw std::runtime_error("Sender failed");
+                case stream_mutation_fragments_cmd::end_of_stream:
+                    _end_of_stream = true;
+                    continue;
+                default:
+                    throw std::runtime_error("Sender sent wrong cmd");
+                }
+            }
+            auto sz = fmf.representation().size();
+            consume(fmf);
+            _sm.local().update_progress(_plan_id, _from, progress_info::direction::IN, sz);
+            _offstrategy_update->update();
+        }
+    }
+    virtual future<> next_partition() override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+    virtual future<> fast_forward_to(const dht::partition_range&) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+    virtual future<> fast_forward_to(position_range) override {
+        return make_exception_future<>(make_backtraced_exception_ptr<std::bad_function_call>());
+    }
+    virtual future<> close() noexcept override {
+        return make_ready_future<>();
+    }
+};
+
+// Writes the components of an sstable received with STREAM_SSTABLE_FILES.
+// Lives on the shard which owns the sstable. The copy is removed unless
+// finish() succeeds.
+class sstable_files_writer {
+    replica::table& _table;
+    utils::phased_barrier::operation _op;
+    sstables::shared_sstable _sst;
+    std::optional<output_stream<char>> _out;
+    sstring _component;
+public:
+    sstable_files_writer(replica::table& table, sstables::sstable_version_types version, sstables::sstable_format_types format)
+        : _table(table)
+        , _op(table.stream_in_progress())
+        , _sst(table.make_streaming_sstable_for_copy(version, format))
+    {}
+
+    future<> open(std::vector<sstring> components) {
+        return seastar::async([this, components = std::move(components)] {
+            auto types = boost::copy_range<std::vector<sstables::component_type>>(components | boost::adaptors::transformed([this] (const sstring& c) {
+                auto type = sstables::sstable::component_from_sstring(_sst->get_version(), c);
+                if (type == sstables::component_type::Unknown || type == sstables::component_type::TOC || type == sstables::component_type::TemporaryTOC) {
+                    throw std::runtime_error(format("Unexpected sstable component {}", c));
+                }
+                return type;
+            }));
+            _sst->open_sstable_for_copy(types);
+        });
+    }
+
+    future<> write(sstring component, bytes data) {
+        if (component != _component) {
+            co_await close_output();
+            auto type = sstables::sstable::component_from_sstring(_sst->get_version(), component);
+            if (!_sst->has_component(type)) {
+                throw std::runtime_error(format("Component {} was not announced by the sender", component));
+            }
+            _out = co_await _sst->make_component_output_stream(type);
+            _component = std::move(component);
+        }
+        co_await _out->write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    future<> finish(sstables::offstrategy offstrategy) {
+        co_await close_output();
+        co_await _sst->seal_sstable(false);
+        co_await _sst->load(_table.get_effective_replication_map()->get_sharder(*_table.schema()));
+        co_await _table.add_sstable_and_update_cache(_sst, offstrategy);
+    }
+
+    // Drops the unsealed copy, which removes its files
+    future<> abort() noexcept {
+        try {
+            co_await close_output();
+        } catch (...) {
+            sslog.warn("Failed to close sstable {} after failed streaming: {}", _sst->get_filename(), std::current_exception());
+        }
+        _sst = {};
+    }
+private:
+    future<> close_output() {
+        if (_out) {
+            auto out = std::move(*_out);
+            _out.reset();
+            co_await out.close();
+        }
+    }
+};
+
+static future<> receive_sstable_files(sharded<replica::database>& db, streaming::plan_id plan_id, table_id cf_id,
+        sstables::sstable_version_types version, sstables::sstable_format_types format, std::vector<sstring> components,
+        dht::token first_token, stream_reason reason, rpc::source<stream_sstable_files_cmd, sstring, bytes> source,
+        noncopyable_function<void(size_t)> update) {
+    auto& table = db.local().find_column_family(cf_id);
+    auto erm = table.get_effective_replication_map();
+    auto shard = erm->get_sharder(*table.schema()).shard_of(first_token);
+    auto writer = co_await smp::submit_to(shard, [&db, cf_id, version, format, components = std::move(components)] () mutable -> future<foreign_ptr<std::unique_ptr<sstable_files_writer>>> {
+        auto w = std::make_unique<sstable_files_writer>(db.local().find_column_family(cf_id), version, format);
+        co_await w->open(std::move(components));
+        co_return make_foreign(std::move(w));
+    });
+    std::exception_ptr ex;
+    try {
+        bool got_end_of_stream = false;
+        while (auto opt = co_await source()) {
+            auto& [cmd, component, data] = *opt;
+            switch (cmd) {
+            case stream_sstable_files_cmd::component_data: {
+                if (got_end_of_stream) {
+                    throw std::runtime_error("Sender sent data after end_of_stream");
+                }
+                update(data.size());
+                co_await smp::submit_to(shard, [&w = *writer, component = std::move(component), data = std::move(data)] () mutable {
+                    return w.write(std::move(component), std::move(data));
+                });
+                break;
+            }
+            case stream_sstable_files_cmd::error:
+                throw std::runtime_error("Sender failed");
+            case stream_sstable_files_cmd::end_of_stream:
+                got_end_of_stream = true;
+                break;
+            default:
+                throw std::runtime_error("Sender sent wrong cmd");
+            }
+        }
+        if (!got_end_of_stream) {
+            throw std::runtime_error("Sender did not sent end_of_stream");
+        }
+        co_await smp::submit_to(shard, [&w = *writer, reason] {
+            return w.finish(is_offstrategy_supported(reason));
+        });
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        co_await smp::submit_to(shard, [&w = *writer] {
+            return w.abort();
+        });
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
 void stream_manager::init_messaging_service_handler(abort_source& as) {
     auto& ms = _ms.local();
 
@@ -122,47 +353,7 @@ void stream_manager::init_messaging_service_handler(abort_source& as) {
         return _mm.local().get_schema_for_write(schema_id, from, _ms.local(), &as).then([this, from, estimated_partitions, plan_id, cf_id, source, reason] (schema_ptr s) mutable {
           return _db.local().obtain_reader_permit(s, "stream-session", db::no_timeout, {}).then([this, from, estimated_partitions, plan_id, cf_id, source, reason, s] (reader_permit permit) mutable {
             auto sink = _ms.local().make_sink_for_stream_mutation_fragments(source);
-            struct stream_mutation_fragments_cmd_status {
-                bool got_cmd = false;
-                bool got_end_of_stream = false;
-            };
-            auto cmd_status = make_lw_shared<stream_mutation_fragments_cmd_status>();
             auto offstrategy_update = make_lw_shared<offstrategy_trigger>(_db, cf_id, plan_id);
-            auto get_next_mutation_fragment = [&sm = container(), source, plan_id, from, s, cmd_status, offstrategy_update, permit] () mutable {
-                return source().then([&sm, plan_id, from, s, cmd_status, offstrategy_update, permit] (std::optional<std::tuple<frozen_mutation_fragment, rpc::optional<stream_mutation_fragments_cmd>>> opt) mutable {
-                    if (opt) {
-                        auto cmd = std::get<1>(*opt);
-                        if (cmd) {
-                            cmd_status->got_cmd = true;
-                            switch (*cmd) {
-                            case stream_mutation_fragments_cmd::mutation_fragment_data:
-                                break;
-                            case stream_mutation_fragments_cmd::error:
-                                return make_exception_future<mutation_fragment_opt>(std::runtime_error("Sender failed"));
-                            case stream_mutation_fragments_cmd::end_of_stream:
-                                cmd_status->got_end_of_stream = true;
-                                return make_ready_future<mutation_fragment_opt>();
-                            default:
-                                return make_exception_future<mutation_fragment_opt>(std::runtime_error("Sender sent wrong cmd"));
-                            }
-                        }
-                        frozen_mutation_fragment& fmf = std::get<0>(*opt);
-                        auto sz = fmf.representation().size();
-                        auto mf = fmf.unfreeze(*s, permit);
-                        sm.local().update_progress(plan_id, from.addr, progress_info::direction::IN, sz);
-                        offstrategy_update->update();
-                        return make_ready_future<mutation_fragment_opt>(std::move(mf));
-                    } else {
-                        // If the sender has sent stream_mutation_fragments_cmd it means it is
-                        // a node that understands the new protocol. It must send end_of_stream
-                        // before close the stream.
-                        if (cmd_status->got_cmd && !cmd_status->got_end_of_stream) {
-                            return make_exception_future<mutation_fragment_opt>(std::runtime_error("Sender did not sent end_of_stream"));
-                        }
-                        return make_ready_future<mutation_fragment_opt>();
-                    }
-                });
-            };
           try {
             // Make sure the table with cf_id is still present at this point.
             // Close the sink in case the table is dropped.
@@ -171,7 +362,7 @@ void stream_manager::init_messaging_service_handler(abort_source& as) {
             auto op = table.stream_in_progress();
             //FIXME: discarded future.
             (void)mutation_writer::distribute_reader_and_consume_on_shards(s, erm->get_sharder(*s),
-                make_generating_reader_v1(s, permit, std::move(get_next_mutation_fragment)),
+                make_flat_mutation_reader_v2<stream_mutation_fragments_reader>(s, permit, source, container(), plan_id, from.addr, offstrategy_update),
                 make_streaming_consumer("streaming", _db, _sys_dist_ks, _view_update_generator, estimated_partitions, reason, is_offstrategy_supported(reason)),
                 std::move(op)
             ).then_wrapped([s, plan_id, from, sink, estimated_partitions, erm] (future<uint64_t> f) mutable {
@@ -204,6 +395,37 @@ void stream_manager::init_messaging_service_handler(abort_source& as) {
         });
       });
     });
+    ms.register_stream_sstable_files([this] (const rpc::client_info& cinfo, streaming::plan_id plan_id, table_id cf_id, sstring version, sstring format, std::vector<sstring> components, dht::token first_token, streaming::stream_reason reason, rpc::source<stream_sstable_files_cmd, sstring, bytes> source) {
+        auto from = netw::messaging_service::get_source(cinfo);
+        sslog.debug("[Stream #{}] Got stream_sstable_files from {} cf_id={} components={}", plan_id, from, cf_id, components);
+        auto sink = _ms.local().make_sink_for_stream_sstable_files(source);
+      try {
+        auto v = sstables::version_from_string(version);
+        auto f = sstables::format_from_string(format);
+        // The reception is waited for by stop()
+        (void)with_gate(_sstable_files_gate, [this, plan_id, cf_id, v, f, components = std::move(components), first_token, reason, source, from, sink] () mutable {
+            return receive_sstable_files(_db, plan_id, cf_id, v, f, std::move(components), first_token, reason, source, [&sm = container(), plan_id, from] (size_t sz) {
+                sm.local().update_progress(plan_id, from.addr, progress_info::direction::IN, sz);
+            }).then_wrapped([plan_id, cf_id, from, sink] (future<> f) mutable {
+                int32_t status = 0;
+                if (f.failed()) {
+                    sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES for cf_id={}, peer={}: {}", plan_id, cf_id, from.addr, f.get_exception());
+                    status = -1;
+                }
+                return sink(status).finally([sink] () mutable {
+                    return sink.close();
+                });
+            }).handle_exception([plan_id, cf_id, from] (std::exception_ptr ep) {
+                sslog.error("[Stream #{}] Failed to handle STREAM_SSTABLE_FILES (respond phase) for cf_id={}, peer={}: {}", plan_id, cf_id, from.addr, ep);
+            });
+        });
+      } catch (...) {
+        return sink.close().then([sink, eptr = std::current_exception()] () -> future<rpc::sink<int32_t>> {
+            return make_exception_future<rpc::sink<int32_t>>(eptr);
+        });
+      }
+        return make_ready_future<rpc::sink<int32_t>>(sink);
+    });
     ms.register_stream_mutation_done([this] (const rpc::client_info& cinfo, streaming::plan_id plan_id, dht::token_range_vector ranges, table_id cf_id, unsigned dst_cpu_id) {
         const auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return container().invoke_on(dst_cpu_id, [ranges = std::move(ranges), plan_id, cf_id, from] (auto& sm) mutable {
@@ -234,6 +456,7 @@ future<> stream_manager::uninit_messaging_service_handler() {
         ms.unregister_prepare_message(),
         ms.unregister_prepare_done_message(),
         ms.unregister_stream_mutation_fragments(),
+        ms.unregister_stream_sstable_files(),
         ms.unregister_stream_mutation_done(),
         ms.unregister_complete_message()).discard_result();
 }
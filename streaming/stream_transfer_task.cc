@@ -16,6 +16,7 @@
 #include "streaming/stream_manager.hh"
 #include "streaming/stream_reason.hh"
 #include "streaming/stream_mutation_fragments_cmd.hh"
+#include "streaming/stream_sstable_files_cmd.hh"
 #include "readers/mutation_fragment_v1_stream.hh"
 #include "mutation/mutation_fragment_stream_validator.hh"
 #include "mutation/frozen_mutation.hh"
@@ -25,11 +26,18 @@
 #include "dht/i_partitioner.hh"
 #include "dht/sharder.hh"
 #include <boost/range/irange.hpp>
+#include <boost/range/adaptor/map.hpp>
+#include <boost/range/adaptor/transformed.hpp>
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_set.hpp>
 #include "sstables/sstables.hh"
+#include "idl/frozen_mutation.dist.hh"
+#include "idl/frozen_mutation.dist.impl.hh"
 #include "replica/database.hh"
 #include "gms/feature_service.hh"
+#include "db/config.hh"
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
 
 namespace streaming {
 
@@ -56,11 +64,16 @@ struct send_info {
     replica::column_family& cf;
     dht::token_range_vector ranges;
     dht::partition_range_vector prs;
+    // Sent as files, and left out of the reader
+    std::vector<sstables::shared_sstable> sstables_to_send;
+    // 0 if the peer doesn't accept batches
+    size_t max_fragment_batch_size = 0;
     mutation_fragment_v1_stream reader;
     noncopyable_function<void(size_t)> update;
     send_info(netw::messaging_service& ms_, streaming::plan_id plan_id_, replica::table& tbl_, reader_permit permit_,
               dht::token_range_vector ranges_, netw::messaging_service::msg_addr id_,
-              uint32_t dst_cpu_id_, stream_reason reason_, noncopyable_function<void(size_t)> update_fn)
+              uint32_t dst_cpu_id_, stream_reason reason_, noncopyable_function<void(size_t)> update_fn,
+              std::vector<sstables::shared_sstable> sstables_to_send_ = {})
         : ms(ms_)
         , plan_id(plan_id_)
         , cf_id(tbl_.schema()->id())
@@ -70,10 +83,22 @@ struct send_info {
         , cf(tbl_)
         , ranges(std::move(ranges_))
         , prs(dht::to_partition_ranges(ranges))
-        , reader(cf.make_streaming_reader(cf.schema(), std::move(permit_), prs, gc_clock::now()))
+        , sstables_to_send(std::move(sstables_to_send_))
+        , reader(cf.make_streaming_reader(cf.schema(), std::move(permit_), prs, gc_clock::now(), make_sstable_filter()))
         , update(std::move(update_fn))
     {
     }
+    sstables::sstable_predicate make_sstable_filter() const {
+        if (sstables_to_send.empty()) {
+            return {};
+        }
+        // sstables_to_send outlives the reader, so the raw pointers stay valid
+        auto excluded = boost::copy_range<std::unordered_set<const sstables::sstable*>>(sstables_to_send
+                | boost::adaptors::transformed([] (const sstables::shared_sstable& sst) { return sst.get(); }));
+        return [excluded = std::move(excluded)] (const sstables::sstable& sst) {
+            return !excluded.contains(&sst);
+        };
+    }
     future<bool> has_relevant_range_on_this_shard() {
         return do_with(false, ranges.begin(), [this] (bool& found_relevant_range, dht::token_range_vector::iterator& ranges_it) {
             auto stop_cond = [this, &found_relevant_range, &ranges_it] { return ranges_it == ranges.end() || found_relevant_range; };
@@ -106,6 +131,50 @@ struct send_info {
     }
 };
 
+// Packs frozen mutation fragments into a single message, so that they are
+// sent, and compressed by the rpc connection, as one frame. The target batch
+// size grows while sending has to wait for the connection, i.e. when the
+// link is the bottleneck (low bandwidth or high latency), and shrinks back
+// when the connection keeps up, to keep the receiver busy.
+class fragment_batcher {
+    static constexpr size_t min_size = 16 * 1024;
+    size_t _max_size;
+    size_t _target_size;
+    std::vector<frozen_mutation_fragment> _fragments;
+    size_t _size = 0;
+public:
+    explicit fragment_batcher(size_t max_size)
+        : _max_size(max_size)
+        , _target_size(std::min(min_size, max_size))
+    {}
+    bool enabled() const {
+        return _max_size > 0;
+    }
+    bool empty() const {
+        return _fragments.empty();
+    }
+    bool full() const {
+        return _size >= _target_size;
+    }
+    void add(frozen_mutation_fragment fmf) {
+        _size += fmf.representation().size();
+        _fragments.push_back(std::move(fmf));
+    }
+    future<> flush(rpc::sink<frozen_mutation_fragment, stream_mutation_fragments_cmd>& sink) {
+        bytes_ostream out;
+        ser::serialize(out, _fragments);
+        _fragments.clear();
+        _size = 0;
+        auto f = sink(frozen_mutation_fragment(std::move(out)), stream_mutation_fragments_cmd::mutation_fragment_batch);
+        if (!f.available()) {
+            _target_size = std::min(_target_size * 2, _max_size);
+        } else {
+            _target_size = std::max(_target_size / 2, std::min(min_size, _max_size));
+        }
+        return f;
+    }
+};
+
 future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
  return si->reader.has_more_fragments().then([si] (bool there_is_more) {
   if (!there_is_more) {
@@ -140,9 +209,9 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
 
         auto sink_op = [sink, si, got_error_from_peer] () mutable -> future<> {
             mutation_fragment_stream_validator validator(*(si->reader.schema()));
-            return do_with(std::move(sink), std::move(validator), [si, got_error_from_peer] (rpc::sink<frozen_mutation_fragment, stream_mutation_fragments_cmd>& sink, mutation_fragment_stream_validator& validator) {
-                return repeat([&sink, &validator, si, got_error_from_peer] () mutable {
-                    return si->reader().then([&sink, &validator, si, s = si->reader.schema(), got_error_from_peer] (mutation_fragment_opt mf) mutable {
+            return do_with(std::move(sink), std::move(validator), fragment_batcher(si->max_fragment_batch_size), [si, got_error_from_peer] (rpc::sink<frozen_mutation_fragment, stream_mutation_fragments_cmd>& sink, mutation_fragment_stream_validator& validator, fragment_batcher& batcher) {
+                return repeat([&sink, &validator, &batcher, si, got_error_from_peer] () mutable {
+                    return si->reader().then([&sink, &validator, &batcher, si, s = si->reader.schema(), got_error_from_peer] (mutation_fragment_opt mf) mutable {
                         if (*got_error_from_peer) {
                             return make_exception_future<stop_iteration>(std::runtime_error("Got status error code from peer"));
                         }
@@ -154,7 +223,14 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
                             frozen_mutation_fragment fmf = freeze(*s, *mf);
                             auto size = fmf.representation().size();
                             si->update(size);
-                            return sink(fmf, stream_mutation_fragments_cmd::mutation_fragment_data).then([] { return stop_iteration::no; });
+                            if (!batcher.enabled()) {
+                                return sink(fmf, stream_mutation_fragments_cmd::mutation_fragment_data).then([] { return stop_iteration::no; });
+                            }
+                            batcher.add(std::move(fmf));
+                            if (!batcher.full()) {
+                                return make_ready_future<stop_iteration>(stop_iteration::no);
+                            }
+                            return batcher.flush(sink).then([] { return stop_iteration::no; });
                         } else {
                             if (!validator.on_end_of_stream()) {
                                 return make_exception_future<stop_iteration>(std::runtime_error(format("Stream reader mutation_fragment validator failed on end_of_stream, previous={}, current=end_of_stream",
@@ -163,6 +239,8 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
                             return make_ready_future<stop_iteration>(stop_iteration::yes);
                         }
                     });
+                }).then([&sink, &batcher] () mutable {
+                    return batcher.empty() ? make_ready_future<>() : batcher.flush(sink);
                 }).then([&sink] () mutable {
                     return sink(frozen_mutation_fragment(bytes_ostream()), stream_mutation_fragments_cmd::end_of_stream);
                 }).handle_exception([&sink] (std::exception_ptr ep) mutable {
@@ -186,6 +264,133 @@ future<> send_mutation_fragments(lw_shared_ptr<send_info> si) {
  });
 }
 
+// Returns the sstables which can be sent to the peer as whole files, instead
+// of being read and sent as mutation fragments. Only sstables fully
+// contained in one of the streamed ranges qualify, so the receiver ends up
+// with exactly the same data as with mutation streaming. Sstables must not
+// need any processing on the receiver side, which rules out tables with
+// views, and the receiving shard must own all of the sstable, which is only
+// guaranteed for tablet migration.
+static std::vector<sstables::shared_sstable> get_sstables_for_file_streaming(replica::database& db, replica::table& tbl,
+        const dht::token_range_vector& ranges, stream_reason reason) {
+    std::vector<sstables::shared_sstable> ret;
+    if (reason != stream_reason::tablet_migration
+            || !db.get_config().enable_file_streaming()
+            || !db.features().file_streaming
+            || !tbl.uses_tablets()
+            || !tbl.views().empty()
+            || !tbl.get_storage_options().is_local_type()) {
+        return ret;
+    }
+    auto sstables = tbl.get_sstables();
+    for (auto& sst : *sstables) {
+        if (sst->is_shared() || sst->requires_view_building() || sst->is_quarantined()) {
+            continue;
+        }
+        auto first = sst->get_first_decorated_key().token();
+        auto last = sst->get_last_decorated_key().token();
+        auto contained = std::ranges::any_of(ranges, [&] (const dht::token_range& r) {
+            return r.contains(first, dht::token_comparator()) && r.contains(last, dht::token_comparator());
+        });
+        if (contained) {
+            ret.push_back(sst);
+        }
+    }
+    return ret;
+}
+
+static future<> send_sstable_files(lw_shared_ptr<send_info> si, sstables::shared_sstable sst) {
+    std::vector<std::pair<sstables::component_type, sstring>> components;
+    for (auto& [type, name] : sst->all_components()) {
+        if (type != sstables::component_type::TOC && type != sstables::component_type::TemporaryTOC
+                && type != sstables::component_type::TemporaryStatistics && type != sstables::component_type::Unknown) {
+            components.emplace_back(type, name);
+        }
+    }
+    auto names = boost::copy_range<std::vector<sstring>>(components | boost::adaptors::map_values);
+    sslog.debug("[Stream #{}] Sending sstable {} as files to {}, cf_id={}, components={}", si->plan_id, sst->get_filename(), si->id, si->cf_id, names);
+
+    auto [sink, source] = co_await si->ms.make_sink_and_source_for_stream_sstable_files(si->plan_id, si->cf_id,
+            sstables::version_string.at(sst->get_version()), sstables::format_string.at(sst->get_format()),
+            std::move(names), sst->get_first_decorated_key().token(), si->reason, si->id);
+
+    bool got_error_from_peer = false;
+    auto source_op = [&] () -> future<> {
+        try {
+            // Keep reading until EOS, see send_mutation_fragments()
+            while (auto status_opt = co_await source()) {
+                auto status = std::get<0>(*status_opt);
+                got_error_from_peer = status == -1;
+                sslog.debug("Got status code from peer={}, plan_id={}, cf_id={}, status={}", si->id.addr, si->plan_id, si->cf_id, status);
+            }
+        } catch (...) {
+            // Stops the sending of the remaining data
+            got_error_from_peer = true;
+            throw;
+        }
+    };
+    auto sink_op = [&] () -> future<> {
+        std::exception_ptr ex;
+        try {
+            for (auto& [type, name] : components) {
+                auto f = co_await sst->open_component_file(type);
+                auto in = make_file_input_stream(std::move(f), 0, file_input_stream_options{.buffer_size = 128 * 1024, .read_ahead = 4});
+                std::exception_ptr read_ex;
+                try {
+                    for (;;) {
+                        auto buf = co_await in.read();
+                        if (buf.empty()) {
+                            break;
+                        }
+                        if (got_error_from_peer) {
+                            throw std::runtime_error("Got status error code from peer");
+                        }
+                        si->update(buf.size());
+                        co_await sink(stream_sstable_files_cmd::component_data, name, bytes(reinterpret_cast<const int8_t*>(buf.get()), buf.size()));
+                    }
+                } catch (...) {
+                    read_ex = std::current_exception();
+                }
+                co_await in.close();
+                if (read_ex) {
+                    std::rethrow_exception(std::move(read_ex));
+                }
+            }
+            co_await sink(stream_sstable_files_cmd::end_of_stream, sstring(), bytes());
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        if (ex) {
+            // Notify the receiver the sender has failed
+            try {
+                co_await sink(stream_sstable_files_cmd::error, sstring(), bytes());
+            } catch (...) {
+            }
+        }
+        co_await sink.close();
+        if (ex) {
+            std::rethrow_exception(std::move(ex));
+        }
+    };
+    co_await when_all_succeed(source_op(), sink_op()).discard_result();
+    if (got_error_from_peer) {
+        throw std::runtime_error(format("Peer failed to receive sstable files peer={}, plan_id={}, cf_id={}", si->id.addr, si->plan_id, si->cf_id));
+    }
+}
+
+static future<> send_sstables_as_files(lw_shared_ptr<send_info> si) {
+    if (si->sstables_to_send.empty()) {
+        co_return;
+    }
+    // Unlike the reader of send_mutation_fragments(), nothing else keeps the
+    // table alive while its sstables are read.
+    auto holder = si->cf.async_gate().hold();
+    sslog.info("[Stream #{}] Start sending ks={}, cf={}, sstables={} as files", si->plan_id, si->cf.schema()->ks_name(), si->cf.schema()->cf_name(), si->sstables_to_send.size());
+    for (auto& sst : si->sstables_to_send) {
+        co_await send_sstable_files(si, sst);
+    }
+}
+
 future<> stream_transfer_task::execute() {
     auto plan_id = session->plan_id();
     auto cf_id = this->cf_id;
@@ -198,16 +403,22 @@ future<> stream_transfer_task::execute() {
     return sm.container().invoke_on_all([plan_id, cf_id, id, dst_cpu_id, ranges=this->_ranges, reason] (stream_manager& sm) mutable {
         auto& tbl = sm.db().find_column_family(cf_id);
       return sm.db().obtain_reader_permit(tbl, "stream-transfer-task", db::no_timeout, {}).then([&sm, &tbl, plan_id, cf_id, id, dst_cpu_id, ranges=std::move(ranges), reason] (reader_permit permit) mutable {
+        auto sstables_to_send = get_sstables_for_file_streaming(sm.db(), tbl, ranges, reason);
         auto si = make_lw_shared<send_info>(sm.ms(), plan_id, tbl, std::move(permit), std::move(ranges), id, dst_cpu_id, reason, [&sm, plan_id, addr = id.addr] (size_t sz) {
             sm.update_progress(plan_id, addr, streaming::progress_info::direction::OUT, sz);
-        });
+        }, std::move(sstables_to_send));
+        if (sm.db().features().streaming_fragment_batch) {
+            si->max_fragment_batch_size = size_t(sm.db().get_config().stream_fragment_batch_max_size_in_kb()) * 1024;
+        }
         return si->has_relevant_range_on_this_shard().then([si, plan_id, cf_id] (bool has_relevant_range_on_this_shard) {
             if (!has_relevant_range_on_this_shard) {
                 sslog.debug("[Stream #{}] stream_transfer_task: cf_id={}: ignore ranges on shard={}",
                         plan_id, cf_id, this_shard_id());
                 return make_ready_future<>();
             }
-            return send_mutation_fragments(std::move(si));
+            return send_sstables_as_files(si).then([si] {
+                return send_mutation_fragments(si);
+            });
         }).finally([si] {
             return si->reader.close();
         });
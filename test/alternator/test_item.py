@@ -7,7 +7,7 @@
 import pytest
 from botocore.exceptions import ClientError
 from decimal import Decimal
-from util import random_string, random_bytes
+from util import random_string, random_bytes, full_query
 
 # Basic test for creating a new item with a random name, and reading it back
 # with strong consistency.
@@ -76,6 +76,40 @@ def test_put_and_get_attribute_types(test_table):
     got_item = test_table.get_item(Key=key, ConsistentRead=True)['Item']
     assert item == got_item
 
+# GetItem writes the JSON text of its response directly from the stored
+# attributes, escaping strings itself. Check that strings which need escaping
+# (quotes, backslashes, control characters) and non-ASCII strings, as well
+# as values of all the other types, come back as they were written, and the
+# same as Query returns them.
+def test_put_and_get_attribute_special_values(test_table_s):
+    p = random_string()
+    test_items = [
+        '"quoted"',
+        'back\\slash\\',
+        '\\"',
+        'tab\there, newline\nthere\r\n',
+        '\b\f\x01\x1e\x1f\x7f',
+        'slash/',
+        'zażółć gęślą jaźń',
+        '日本語',
+        '\U0001F600',
+        b'"\\\x00\xff',
+        Decimal('-0.001'),
+        Decimal('1e10'),
+        Decimal('123456789012345678901234567890'),
+        None,
+        ['"a"', '\\', {'k"ey\\': '\n'}],
+        {'"x"': {'y\\': ['日本', b'\x01']}},
+        set(['"', '\\', '\n', 'ż']),
+        set([b'"', b'\\']),
+    ]
+    item = { str(i) : test_items[i] for i in range(len(test_items)) }
+    item['p'] = p
+    test_table_s.put_item(Item=item)
+    got_item = test_table_s.get_item(Key={'p': p}, ConsistentRead=True)['Item']
+    assert item == got_item
+    assert [got_item] == full_query(test_table_s, KeyConditionExpression='p=:p', ExpressionAttributeValues={':p': p})
+
 # The test_empty_* tests below verify support for empty items, with no
 # attributes except the key. This is a difficult case for Scylla, because
 # for an empty row to exist, Scylla needs to add a "CQL row marker".
@@ -164,6 +164,24 @@ def test_projection_expression_path(test_table_s):
     assert not 'Item' in test_table_s.get_item(Key={'p': p}, ConsistentRead=True, ProjectionExpression='a.x')
     assert not 'Item' in test_table_s.get_item(Key={'p': p}, ConsistentRead=True, ProjectionExpression='a[0]')
 
+# GetItem writes its response directly from the stored attributes, while
+# Query still builds a JSON document of each item. Check that both return
+# the same item for the same ProjectionExpression, whether it selects entire
+# attributes, nested parts of them, or both.
+def test_projection_expression_path_get_item_same_as_query(test_table_s):
+    p = random_string()
+    test_table_s.put_item(Item={
+        'p': p,
+        'a': {'b': [2, 4, {'x': 'h"i\\', 'y': 'yo\n'}], 'c': 5},
+        'b': 'zażółć',
+        'c': b'\x00\xff',
+        'd': {'x', 'y'},
+        })
+    for wanted in ['a', 'b', 'a.b', 'a.b[2].x', 'a.b[0],a.c', 'a.c,b', 'a.b[2],c,d', 'p,a.b[1],d', 'x', 'a.x,b']:
+        got_item = test_table_s.get_item(Key={'p': p}, ConsistentRead=True, ProjectionExpression=wanted)['Item']
+        queried = full_query(test_table_s, KeyConditionExpression='p=:p', ExpressionAttributeValues={':p': p}, ProjectionExpression=wanted)
+        assert [got_item] == queried
+
 # Above in test_projection_expression_toplevel_syntax() we tested how
 # name references (#name) work in top-level attributes. In the following
 # two tests we test how they work in more elaborate paths:
@@ -228,6 +228,36 @@ SEASTAR_TEST_CASE(test_aggregate_count) {
     });
 }
 
+SEASTAR_TEST_CASE(test_aggregate_groups_with_intermediate_overflow) {
+    return do_with_cql_env_thread([&] (auto& e) {
+        e.execute_cql("CREATE TABLE test(p int, c int, v bigint, primary key (p, c))").get();
+        e.execute_cql("INSERT INTO test(p, c, v) VALUES (1, 1, 9223372036854775807)").get();
+        e.execute_cql("INSERT INTO test(p, c, v) VALUES (1, 2, 9223372036854775807)").get();
+        e.execute_cql("INSERT INTO test(p, c) VALUES (1, 3)").get();
+        e.execute_cql("INSERT INTO test(p, c, v) VALUES (1, 4, -9223372036854775807)").get();
+        e.execute_cql("INSERT INTO test(p, c, v) VALUES (2, 1, -3)").get();
+        e.execute_cql("INSERT INTO test(p, c, v) VALUES (2, 2, 5)").get();
+
+        // The partial sums of the first group overflow bigint, while the sum doesn't.
+        // The second group checks that the state is reset between groups.
+        auto msg = e.execute_cql("SELECT sum(v), avg(v), min(v), max(v), count(v), count(*) FROM test GROUP BY p").get0();
+        assert_that(msg).is_rows().with_size(2).with_rows_ignore_order({
+            {{long_type->decompose(int64_t(9223372036854775807))},
+             {long_type->decompose(int64_t(3074457345618258602))},
+             {long_type->decompose(int64_t(-9223372036854775807))},
+             {long_type->decompose(int64_t(9223372036854775807))},
+             {long_type->decompose(int64_t(3))},
+             {long_type->decompose(int64_t(4))}},
+            {{long_type->decompose(int64_t(2))},
+             {long_type->decompose(int64_t(1))},
+             {long_type->decompose(int64_t(-3))},
+             {long_type->decompose(int64_t(5))},
+             {long_type->decompose(int64_t(2))},
+             {long_type->decompose(int64_t(2))}},
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_reverse_type_aggregation) {
     return do_with_cql_env_thread([&] (auto& e) {
         e.execute_cql("CREATE TABLE test(p int, c timestamp, v int, primary key (p, c)) with clustering order by (c desc)").get();
@@ -165,4 +165,63 @@ BOOST_AUTO_TEST_CASE(test_magnitude_and_precision) {
     BOOST_CHECK(res.magnitude > 1000);
     res = alternator::internal::get_magnitude_and_precision("1e-1000000000000");
     BOOST_CHECK(res.magnitude < -1000);
-}
\ No newline at end of file
+}
+// rjson::append_quoted_json_string() writes the same text rjson::print()
+// writes for the string value, so responses written directly don't differ
+// from those printed from a JSON document.
+static const std::vector<std::string> json_strings = {
+    "",
+    "hello",
+    "\"quoted\"",
+    "back\\slash\\",
+    "\\\"",
+    "tab\there, newline\nthere\r\n",
+    "\b\f",
+    std::string("\0nul\x01\x02\x1e\x1f", 8),
+    "\x7f",
+    "slash/",
+    "zażółć gęślą jaźń",
+    "日本語",
+    "\xf0\x9f\x98\x80",
+};
+
+BOOST_AUTO_TEST_CASE(test_append_quoted_json_string) {
+    for (const auto& str : json_strings) {
+        std::string out = "prefix";
+        rjson::append_quoted_json_string(out, str);
+        BOOST_REQUIRE(out.starts_with("prefix"));
+        std::string_view quoted = std::string_view(out).substr(6);
+        BOOST_REQUIRE_EQUAL(quoted, rjson::print(rjson::from_string(str)));
+        BOOST_REQUIRE_EQUAL(rjson::to_string_view(rjson::parse(quoted)), str);
+    }
+}
+
+// deserialize_item_to_json() writes the same text as printing the document
+// built by deserialize_item(), for each type an attribute may be stored as.
+BOOST_AUTO_TEST_CASE(test_deserialize_item_to_json) {
+    std::vector<std::string> items;
+    for (const auto& str : json_strings) {
+        items.push_back(format("{{\"S\":{}}}", rjson::print(rjson::from_string(str))));
+        items.push_back(format("{{\"B\":\"{}\"}}", base64_encode(to_bytes_view(str))));
+    }
+    for (auto number : {"0", "1", "-1", "12.5", "-0.001", "1e10", "1.5E-20", "123456789012345678901234567890"}) {
+        items.push_back(format("{{\"N\":\"{}\"}}", number));
+    }
+    items.push_back("{\"BOOL\":true}");
+    items.push_back("{\"BOOL\":false}");
+    // Stored as the JSON text of the entire value (NOT_SUPPORTED_YET)
+    items.push_back("{\"NULL\":true}");
+    items.push_back("{\"SS\":[\"a\\\"b\",\"c\\\\d\",\"\\u0001\",\"ż\"]}");
+    items.push_back("{\"NS\":[\"1\",\"2.5\"]}");
+    items.push_back("{\"BS\":[\"YQ==\",\"YWI=\"]}");
+    items.push_back("{\"L\":[{\"S\":\"a\\nb\"},{\"N\":\"3\"},{\"L\":[]}]}");
+    items.push_back("{\"M\":{\"k\\\"ey\":{\"S\":\"日本\"},\"n\":{\"M\":{\"x\":{\"NULL\":true}}}}}");
+
+    for (const auto& item : items) {
+        bytes serialized = alternator::serialize_item(rjson::parse(item));
+        std::string out;
+        alternator::deserialize_item_to_json(serialized, out);
+        BOOST_REQUIRE_EQUAL(out, rjson::print(alternator::deserialize_item(serialized)));
+        BOOST_REQUIRE_EQUAL(rjson::parse(out), alternator::deserialize_item(serialized));
+    }
+}
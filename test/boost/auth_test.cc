@@ -21,10 +21,13 @@
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/cql_assertions.hh"
 #include "test/lib/exception_utils.hh"
+#include "test/lib/eventually.hh"
 
 #include "auth/allow_all_authenticator.hh"
 #include "auth/authenticator.hh"
 #include "auth/password_authenticator.hh"
+#include "auth/passwords.hh"
+#include "auth/roles-metadata.hh"
 #include "auth/service.hh"
 #include "auth/authenticated_user.hh"
 #include "auth/resource.hh"
@@ -157,6 +160,61 @@ SEASTAR_TEST_CASE(test_password_authenticator_operations) {
     }, cfg);
 }
 
+// Returns the number of shards on which the credentials are accepted.
+static unsigned count_shards_accepting(cql_test_env& env, sstring username, sstring password) {
+    return env.local_auth_service().container().map_reduce0([username, password] (auth::service& s) {
+        return do_with(
+                auth::authenticator::credentials_map{
+                        {auth::authenticator::USERNAME_KEY, username},
+                        {auth::authenticator::PASSWORD_KEY, password}},
+                [&s] (const auto& credentials) {
+            return s.underlying_authenticator().authenticate(credentials).then_wrapped([] (future<auth::authenticated_user> f) {
+                try {
+                    f.get();
+                    return 1u;
+                } catch (const exceptions::authentication_exception&) {
+                    return 0u;
+                }
+            });
+        });
+    }, 0u, std::plus<unsigned>()).get();
+}
+
+SEASTAR_TEST_CASE(test_role_changes_invalidate_cached_credentials) {
+    auto cfg = make_shared<db::config>();
+    cfg->authenticator(sstring(auth::password_authenticator_name));
+    // Cache entries long enough that only invalidation can make the changes visible.
+    cfg->credentials_validity_in_ms.set(3600 * 1000);
+    cfg->credentials_update_interval_in_ms.set(3600 * 1000);
+    cfg->auth_cache_invalidation_poll_interval_in_ms.set(100);
+
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auth::role_config config {
+            .can_login = true,
+        };
+        auth::create_role(e.local_auth_service(), "user1", config, auth::authentication_options{.password = "pass"}).get();
+        BOOST_REQUIRE_EQUAL(count_shards_accepting(e, "user1", "pass"), smp::count);
+
+        // The shard which alters the role drops the cached credentials of all shards.
+        auth::alter_role(e.local_auth_service(), "user1", auth::role_config_update{}, auth::authentication_options{.password = "pass2"}).get();
+        BOOST_REQUIRE_EQUAL(count_shards_accepting(e, "user1", "pass"), 0);
+        BOOST_REQUIRE_EQUAL(count_shards_accepting(e, "user1", "pass2"), smp::count);
+
+        // A change made by another node reaches this one through the cache generation.
+        std::default_random_engine rng(std::random_device{}());
+        e.local_qp().execute_internal(format("UPDATE {} SET salted_hash = ? WHERE {} = ?", auth::meta::roles_table::qualified_name, auth::meta::roles_table::role_col_name),
+                db::consistency_level::ONE, {auth::passwords::hash("pass3", rng), sstring("user1")}, cql3::query_processor::cache_internal::no).get();
+        BOOST_REQUIRE_EQUAL(count_shards_accepting(e, "user1", "pass2"), smp::count);
+        e.local_qp().execute_internal("UPDATE system_auth.cache_generation SET generation = now() WHERE key = 'authorization'",
+                db::consistency_level::ONE, cql3::query_processor::cache_internal::no).get();
+        REQUIRE_EVENTUALLY_EQUAL(count_shards_accepting(e, "user1", "pass3"), smp::count);
+        BOOST_REQUIRE_EQUAL(count_shards_accepting(e, "user1", "pass2"), 0);
+
+        auth::drop_role(e.local_auth_service(), "user1").get();
+        BOOST_REQUIRE_EQUAL(count_shards_accepting(e, "user1", "pass3"), 0);
+    }, cfg);
+}
+
 namespace {
 
 /// Asserts that table is protected from alterations that can brick a node.
@@ -23,7 +23,9 @@
 #include "cql3/query_processor.hh"
 #include "cql3/untyped_result_set.hh"
 #include "db/batchlog_manager.hh"
+#include "db/system_keyspace.hh"
 #include "service/storage_proxy.hh"
+#include "utils/UUID_gen.hh"
 
 #include "message/messaging_service.hh"
 
@@ -57,6 +59,10 @@ SEASTAR_TEST_CASE(test_execute_batch) {
                     BOOST_CHECK_EQUAL(n, 1);
                 }).then([&bp] () mutable {
                     return bp.do_batch_log_replay();
+                }).then([&bp] () mutable {
+                    return bp.count_all_batches().then([](auto n) {
+                        BOOST_CHECK_EQUAL(n, 0);
+                    });
                 });
             });
         }).then([&qp] {
@@ -69,3 +75,50 @@ SEASTAR_TEST_CASE(test_execute_batch) {
     });
 }
 
+
+// Entries of system.batchlog_v2 from several coordinators share a segment, so
+// replaying one of them must not delete a batch which arrives afterwards with
+// an older write timestamp, e.g. from a coordinator with a lagging clock.
+SEASTAR_TEST_CASE(test_replay_segment_keeps_late_batches) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto& qp = e.local_qp();
+        auto& bp = e.batchlog_manager().local();
+        BOOST_REQUIRE(e.local_db().features().batchlog_v2);
+
+        e.execute_cql("create table cf (p1 varchar, c1 int, r1 int, PRIMARY KEY (p1, c1));").get();
+        auto s = e.local_db().find_schema("ks", "cf");
+        const column_definition& r1_col = *s->get_column_definition("r1");
+        auto key = partition_key::from_exploded(*s, {to_bytes("key1")});
+        auto c_key = clustering_key::from_exploded(*s, {int32_type->decompose(1)});
+        mutation m(s, key);
+        m.set_clustered_cell(c_key, r1_col, make_atomic_cell(int32_type, int32_type->decompose(100)));
+
+        using namespace std::chrono_literals;
+        auto version = netw::messaging_service::current_version;
+        auto written_at = db::batchlog_manager::segment_of(db_clock::now() - 3h);
+        auto bm = qp.proxy().get_batchlog_mutation_for({ m }, utils::UUID_gen::get_time_UUID(), version, written_at);
+        BOOST_REQUIRE_EQUAL(bm.schema()->cf_name(), db::system_keyspace::BATCHLOG_V2);
+        qp.proxy().mutate_locally(bm, tracing::trace_state_ptr(), db::commitlog::force_sync::no).get();
+
+        auto rs = qp.execute_internal(format("SELECT shard, segment, data, writetime(data) AS ts FROM {}.{}", db::system_keyspace::NAME, db::system_keyspace::BATCHLOG_V2),
+                cql3::query_processor::cache_internal::no).get();
+        BOOST_REQUIRE_EQUAL(rs->size(), 1);
+        auto& row = rs->one();
+
+        bp.do_batch_log_replay().get();
+        BOOST_REQUIRE_EQUAL(bp.count_all_batches().get(), 0);
+
+        // The same segment, written after the first batch but with an older timestamp.
+        qp.execute_internal(format("INSERT INTO {}.{} (shard, segment, written_at, id, data, version) VALUES (?, ?, ?, ?, ?, ?) USING TIMESTAMP ?",
+                db::system_keyspace::NAME, db::system_keyspace::BATCHLOG_V2),
+                {row.get_as<int32_t>("shard"), row.get_as<db_clock::time_point>("segment"), written_at + 1ms, utils::UUID_gen::get_time_UUID(),
+                 data_value(row.get_blob("data")), version, row.get_as<int64_t>("ts") - 1},
+                cql3::query_processor::cache_internal::no).get();
+        BOOST_REQUIRE_EQUAL(bp.count_all_batches().get(), 1);
+
+        bp.do_batch_log_replay().get();
+        BOOST_REQUIRE_EQUAL(bp.count_all_batches().get(), 0);
+        assert_that(e.execute_cql("select r1 from ks.cf where p1 = 'key1' and c1 = 1;").get())
+                .is_rows().with_rows({{int32_type->decompose(100)}});
+    });
+}
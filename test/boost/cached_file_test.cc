@@ -453,3 +453,33 @@ SEASTAR_THREAD_TEST_CASE(test_invalidation) {
     BOOST_REQUIRE_EQUAL(2, metrics.page_populations);
     BOOST_REQUIRE_EQUAL(0, metrics.page_hits);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_sequential_read_ahead) {
+    auto page_size = cached_file::page_size;
+    cached_file_stats metrics;
+    test_file tf = make_test_file(page_size * 32);
+    logalloc::region region;
+    cached_file cf(tf.f, metrics, cf_lru, region, page_size * 32);
+    cf.set_max_read_ahead(8);
+    auto stop = defer([&] { cf.stop_read_ahead().get(); });
+
+    // Random reads don't trigger read-ahead.
+    for (auto page : {0, 5, 10}) {
+        BOOST_REQUIRE_EQUAL(tf.contents.substr(page * page_size, 1), read_to_string(cf, page * page_size, 1));
+    }
+    BOOST_REQUIRE_EQUAL(3, metrics.page_misses);
+    BOOST_REQUIRE_EQUAL(0, metrics.read_ahead_pages);
+
+    // A sequential read does, and is mostly served from pages read ahead.
+    BOOST_REQUIRE_EQUAL(tf.contents.substr(page_size * 11), read_to_string(cf, page_size * 11));
+    BOOST_REQUIRE_GT(metrics.read_ahead_pages, 0);
+    BOOST_REQUIRE_GT(metrics.read_ahead_hits, 0);
+    BOOST_REQUIRE_LT(metrics.page_misses, 3 + 21);
+    BOOST_REQUIRE_EQUAL(metrics.page_populations, 3 + 21);
+
+    // Pages read ahead and never used are accounted as waste when evicted.
+    cf.stop_read_ahead().get();
+    auto unused = metrics.read_ahead_pages - metrics.read_ahead_hits;
+    cf.evict_gently().get();
+    BOOST_REQUIRE_EQUAL(metrics.read_ahead_waste, unused);
+}
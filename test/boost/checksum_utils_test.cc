@@ -74,6 +74,10 @@ void test() {
     test_combine<ReferenceImpl, Impl>();
 }
 
+BOOST_AUTO_TEST_CASE(test_libdeflate_adler32_matches_zlib) {
+    test<zlib_adler32_checksummer, libdeflate_adler32_checksummer>();
+}
+
 BOOST_AUTO_TEST_CASE(test_libdeflate_matches_zlib) {
     test<zlib_crc32_checksummer, libdeflate_crc32_checksummer>();
 }
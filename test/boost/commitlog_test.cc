@@ -9,6 +9,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
 
 #include <stdlib.h>
 #include <iostream>
@@ -24,8 +25,10 @@
 #include <seastar/core/scollectd_api.hh>
 #include <seastar/core/file.hh>
 #include <seastar/core/seastar.hh>
+#include <seastar/core/sleep.hh>
 #include <seastar/util/noncopyable_function.hh>
 #include <seastar/util/closeable.hh>
+#include <seastar/util/defer.hh>
 
 #include "utils/UUID_gen.hh"
 #include "test/lib/tmpdir.hh"
@@ -34,10 +37,13 @@
 #include "db/commitlog/commitlog_extensions.hh"
 #include "db/commitlog/rp_set.hh"
 #include "db/extensions.hh"
+#include "schema/schema_builder.hh"
+#include "compress.hh"
 #include "readers/combined.hh"
 #include "log.hh"
 #include "test/lib/exception_utils.hh"
 #include "test/lib/cql_test_env.hh"
+#include "test/lib/cql_assertions.hh"
 #include "test/lib/data_model.hh"
 #include "test/lib/sstable_utils.hh"
 #include "test/lib/mutation_source_test.hh"
@@ -103,6 +109,87 @@ SEASTAR_TEST_CASE(test_commitlog_written_to_disk_batch){
         });
 }
 
+// check that concurrent writes in batch mode with group commit are all synced
+SEASTAR_TEST_CASE(test_commitlog_batch_group_commit){
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::BATCH;
+    cfg.batch_group_commit_max_wait = std::chrono::milliseconds(10);
+    return cl_test(cfg, [](commitlog& log) -> future<> {
+        constexpr size_t writes = 100;
+        auto id = make_table_id();
+        sstring tmp = "hej bubba cow";
+        for (size_t round = 0; round < 5; ++round) {
+            co_await parallel_for_each(boost::irange<size_t>(0, writes), [&] (size_t) {
+                return log.add_mutation(id, tmp.size(), db::commitlog::force_sync::no, [&tmp] (db::commitlog::output& dst) {
+                    dst.write(tmp.data(), tmp.size());
+                }).then([] (replay_position rp) {
+                    BOOST_CHECK_NE(rp, db::replay_position());
+                });
+            });
+        }
+        BOOST_REQUIRE_EQUAL(log.get_num_batch_writes(), 5 * writes);
+        BOOST_REQUIRE_GT(log.get_num_batch_syncs(), 0u);
+        BOOST_REQUIRE_LE(log.get_num_batch_syncs(), log.get_num_batch_writes());
+        BOOST_REQUIRE_GT(log.get_flush_count(), 0u);
+    });
+}
+
+SEASTAR_TEST_CASE(test_commitlog_dedicated_segment_streams){
+    commitlog::config cfg;
+    cfg.dedicated_streams = 1;
+    cfg.commitlog_sync_period_in_ms = 10;
+    return cl_test(cfg, [](commitlog& log) -> future<> {
+        auto busy = make_table_id();
+        auto idle = make_table_id();
+        sstring tmp = "hej bubba cow";
+        std::unordered_map<table_id, replay_position> last;
+        auto write = [&] (table_id id) -> future<replay_position> {
+            auto h = co_await log.add_mutation(id, tmp.size(), db::commitlog::force_sync::no, [&tmp] (db::commitlog::output& dst) {
+                dst.write(tmp.data(), tmp.size());
+            });
+            auto rp = h.rp();
+            // the replay positions of a table must keep increasing across stream changes
+            BOOST_REQUIRE_GT(rp, last[id]);
+            last[id] = rp;
+            co_return rp;
+        };
+        for (size_t round = 0; round < 5; ++round) {
+            for (size_t i = 0; i < 100; ++i) {
+                co_await write(busy);
+            }
+            co_await write(idle);
+            co_await sleep(std::chrono::milliseconds(20));
+        }
+        // by now the busy table has a stream of its own
+        auto busy_rp = co_await write(busy);
+        auto idle_rp = co_await write(idle);
+        BOOST_REQUIRE_NE(busy_rp.id, idle_rp.id);
+    });
+}
+
+SEASTAR_TEST_CASE(test_commitlog_reserve_segments){
+    commitlog::config cfg;
+    cfg.commitlog_segment_size_in_mb = 1;
+    cfg.min_reserve_segments = 3;
+    cfg.reserve_lookahead_in_ms = 1000;
+    cfg.commitlog_sync_period_in_ms = 10;
+    return cl_test(cfg, [](commitlog& log) -> future<> {
+        sstring tmp = "hej bubba cow";
+        auto h = co_await log.add_mutation(make_table_id(), tmp.size(), db::commitlog::force_sync::no, [&tmp] (db::commitlog::output& dst) {
+            dst.write(tmp.data(), tmp.size());
+        });
+        h.release();
+        // the active segment, plus the reserve kept ready even though the
+        // write rate alone doesn't call for it
+        auto segment_size = 1024 * 1024;
+        while (log.disk_footprint() < 4 * segment_size) {
+            co_await sleep(std::chrono::milliseconds(10));
+        }
+        co_await sleep(std::chrono::milliseconds(50));
+        BOOST_REQUIRE_EQUAL(log.disk_footprint(), 4 * segment_size);
+    });
+}
+
 // check that an entry marked as sync is immediately flushed to a storage
 SEASTAR_TEST_CASE(test_commitlog_written_to_disk_sync){
     commitlog::config cfg;
@@ -662,6 +749,71 @@ SEASTAR_TEST_CASE(test_commitlog_replay_invalid_key){
 
 using namespace std::chrono_literals;
 
+SEASTAR_TEST_CASE(test_commitlog_replay_segments_of_all_shards) {
+    return do_with_cql_env_thread([] (cql_test_env& env) {
+        env.execute_cql("create table t (pk int primary key, v blob)").get();
+
+        auto& db = env.local_db();
+        auto& table = db.find_column_family("ks", "t");
+
+        // A commitlog of this shard only, with small segments and no other tables in
+        // them. The entries of all shards go there, so that replay applies them in
+        // batches sent to the other shards. The values spread them over several
+        // segments, which are replayed concurrently.
+        tmpdir tmp;
+        commitlog::config cl_cfg;
+        cl_cfg.commit_log_location = tmp.path().string();
+        cl_cfg.commitlog_segment_size_in_mb = 1;
+        auto cl = commitlog::create_commitlog(cl_cfg).get0();
+        auto close_cl = defer([&cl] {
+            cl.shutdown().get();
+            cl.clear().get();
+        });
+
+        const size_t nr_keys = 200;
+        const size_t value_size = 32 * 1024;
+        auto keys = tests::generate_partition_keys(nr_keys, table.schema(), local_shard_only::no);
+        std::vector<std::vector<bytes_opt>> expected;
+        // Keep the segments from being discarded before they are replayed.
+        std::vector<rp_handle> handles;
+        auto add_entries = [&] (size_t first, size_t last, bool with_w) {
+            auto s = table.schema();
+            for (size_t i = first; i < last; ++i) {
+                mutation m(s, keys[i]);
+                auto v = bytes(value_size, int8_t(i));
+                m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(v), api::new_timestamp());
+                if (with_w) {
+                    m.set_clustered_cell(clustering_key::make_empty(), "w", data_value(int32_t(i)), api::new_timestamp());
+                }
+                commitlog_entry_writer cew(s, freeze(m), db::commitlog::force_sync::no);
+                handles.push_back(cl.add_entry(m.column_family_id(), cew, db::no_timeout).get0());
+                expected.push_back({keys[i].key().explode().front(), v, with_w ? int32_type->decompose(int32_t(i)) : bytes_opt()});
+            }
+        };
+
+        // Entries of the old schema version are converted on the shards they are applied on.
+        add_entries(0, nr_keys / 2, false);
+        env.execute_cql("alter table t add w int").get();
+        add_entries(nr_keys / 2, nr_keys, true);
+        cl.sync_all_segments().get();
+
+        auto paths = cl.get_active_segment_names();
+        BOOST_REQUIRE_GT(paths.size(), 4);
+        auto rp = db::commitlog_replayer::create_replayer(env.db(), env.get_system_keyspace()).get0();
+        rp.recover(paths, db::commitlog::descriptor::FILENAME_PREFIX).get();
+
+        const auto& stats = rp.get_stats();
+        BOOST_REQUIRE_EQUAL(stats.applied_mutations, nr_keys);
+        BOOST_REQUIRE_EQUAL(stats.invalid_mutations, 0);
+        BOOST_REQUIRE_EQUAL(stats.skipped_mutations, 0);
+        BOOST_REQUIRE_EQUAL(stats.corrupt_bytes, 0);
+
+        assert_that(env.execute_cql("select pk, v, w from t").get0())
+                .is_rows()
+                .with_rows_ignore_order(std::move(expected));
+    });
+}
+
 SEASTAR_TEST_CASE(test_commitlog_add_entries) {
     return cl_test([](commitlog& log) {
         return seastar::async([&] {
@@ -724,6 +876,109 @@ SEASTAR_TEST_CASE(test_commitlog_add_entries) {
     });
 }
 
+SEASTAR_TEST_CASE(test_commitlog_add_entry_from_mutation) {
+    return cl_test([](commitlog& log) {
+        return seastar::async([&] {
+            constexpr auto n = 10;
+            random_mutation_generator gen(random_mutation_generator::generate_counters(false));
+            auto s = gen.schema();
+            std::vector<mutation> mutations;
+            std::vector<replay_position> rps;
+
+            for (auto i = 0; i < n; ++i) {
+                mutations.emplace_back(gen(1).front());
+                // Serialized directly, both with the column mapping (first entry
+                // of the schema in the segment) and without it.
+                commitlog_entry_writer cew(s, mutations.back(), db::commitlog::force_sync::no);
+                BOOST_CHECK_EQUAL(cew.mutation_size(), freeze(mutations.back()).representation().size());
+                auto h = log.add_entry(s->id(), cew, db::timeout_clock::now() + 60s).get0();
+                rps.emplace_back(h.release());
+            }
+
+            log.sync_all_segments().get();
+            auto segments = log.get_active_segment_names();
+            BOOST_REQUIRE(!segments.empty());
+
+            size_t found = 0;
+            for (auto& seg : segments) {
+                db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, [&](db::commitlog::buffer_and_replay_position buf_rp) {
+                    commitlog_entry_reader r(buf_rp.buffer);
+                    auto i = std::find(rps.begin(), rps.end(), buf_rp.position);
+                    if (i != rps.end()) {
+                        auto& m = mutations.at(std::distance(rps.begin(), i));
+                        BOOST_CHECK_EQUAL(r.mutation().unfreeze(s), m);
+                        ++found;
+                    }
+                    return make_ready_future<>();
+                }).get();
+            }
+            BOOST_CHECK_EQUAL(found, rps.size());
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_commitlog_add_entries_compressed) {
+    commitlog::config cfg;
+    cfg.compressor = compressor::lz4;
+    return cl_test(cfg, [](commitlog& log) {
+        return seastar::async([&] {
+            auto s = schema_builder("ks", "t")
+                    .with_column("pk", utf8_type, column_kind::partition_key)
+                    .with_column("v", utf8_type)
+                    .build();
+
+            // Values smaller than the compression threshold, spanning a single
+            // compressed chunk and spanning several.
+            std::vector<frozen_mutation> mutations;
+            for (size_t len : { size_t(16), size_t(10 * 1024), size_t(300 * 1024) }) {
+                mutation m(s, partition_key::from_single_value(*s, serialized(format("key{}", len))));
+                sstring value(len, 'x');
+                for (size_t i = 0; i < len; i += 7) {
+                    value[i] = 'a' + i % 26;
+                }
+                m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(value), 1);
+                mutations.emplace_back(freeze(m));
+            }
+
+            std::vector<commitlog_entry_writer> writers;
+            for (auto& fm : mutations) {
+                writers.emplace_back(s, fm, commitlog_entry_writer::force_sync::no);
+            }
+            {
+                auto w = writers.back();
+                w.set_compressor(cfg.compressor);
+                w.set_with_schema(true);
+                BOOST_REQUIRE(w.compressed());
+                BOOST_REQUIRE_LT(w.size(), w.uncompressed_size());
+            }
+
+            auto res = log.add_entries(writers, db::timeout_clock::now() + 60s).get0();
+            std::vector<replay_position> rps;
+            for (auto& h : res) {
+                rps.emplace_back(h.rp());
+            }
+
+            log.sync_all_segments().get();
+            auto segments = log.get_active_segment_names();
+            BOOST_REQUIRE(!segments.empty());
+
+            size_t found = 0;
+            for (auto& seg : segments) {
+                db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, [&](db::commitlog::buffer_and_replay_position buf_rp) {
+                    commitlog_entry_reader r(buf_rp.buffer);
+                    auto i = std::find(rps.begin(), rps.end(), buf_rp.position);
+                    BOOST_REQUIRE(i != rps.end());
+                    auto& fm = mutations.at(std::distance(rps.begin(), i));
+                    BOOST_CHECK_EQUAL(fm.unfreeze(s), r.mutation().unfreeze(s));
+                    ++found;
+                    return make_ready_future<>();
+                }).get();
+            }
+            BOOST_REQUIRE_EQUAL(found, mutations.size());
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_commitlog_new_segment_odsync){
     commitlog::config cfg;
     cfg.commitlog_segment_size_in_mb = 1;
@@ -15,6 +15,7 @@
 #include "test/boost/range_assert.hh"
 #include "schema/schema_builder.hh"
 #include "dht/murmur3_partitioner.hh"
+#include "utils/UUID_gen.hh"
 
 static std::vector<managed_bytes> to_bytes_vec(std::vector<sstring> values) {
     std::vector<managed_bytes> result;
@@ -387,3 +388,43 @@ SEASTAR_THREAD_TEST_CASE(test_prefix_compound_validity) {
     BOOST_REQUIRE_THROW(validate({'\x00', '\x01', 0, '\x00', '\x02', 'a', 'b', '\x00', '\x01', 'a'}), marshal_exception); // to many components
     BOOST_REQUIRE_THROW(validate({'\x00', '\x02', 'a', 'b', '\x00', '\x01', 0}), marshal_exception); // wrong order of components
 }
+
+SEASTAR_THREAD_TEST_CASE(test_prefix_equality_compare_of_fixed_width_components) {
+    const auto types = std::vector<data_type>{long_type, reversed_type_impl::get_instance(int32_type), timeuuid_type, timestamp_type};
+    const auto c = compound_type<allow_prefixes::yes>(types);
+
+    // Few distinct values, so that components are often equal, and an occasional empty value.
+    auto make_prefix = [&] {
+        std::vector<bytes> values;
+        auto size = tests::random::get_int<size_t>(0, types.size());
+        for (size_t i = 0; i < size; ++i) {
+            if (tests::random::get_int(0, 20) == 0) {
+                values.emplace_back();
+                continue;
+            }
+            switch (i) {
+            case 0: values.push_back(long_type->decompose(tests::random::get_int<int64_t>(-2, 2))); break;
+            case 1: values.push_back(int32_type->decompose(tests::random::get_int<int32_t>(-2, 2))); break;
+            case 2: values.push_back(timeuuid_type->decompose(utils::UUID_gen::get_time_UUID(
+                    std::chrono::milliseconds(tests::random::get_int(0, 2)), tests::random::get_int<int64_t>(-2, 2)))); break;
+            case 3: values.push_back(timestamp_type->decompose(db_clock::time_point(db_clock::duration(tests::random::get_int<int64_t>(-2, 2))))); break;
+            }
+        }
+        return c.serialize_value(values);
+    };
+
+    for (int i = 0; i < 10000; ++i) {
+        auto p1 = make_prefix();
+        auto p2 = make_prefix();
+        auto expected = prefix_equality_tri_compare(types.begin(), c.begin(p1), c.end(p1), c.begin(p2), c.end(p2), ::tri_compare);
+        BOOST_REQUIRE(c.prefix_equality_tri_compare(p1, p2) == expected);
+        BOOST_REQUIRE(c.prefix_equality_tri_compare(p2, p1) == (0 <=> expected));
+    }
+
+    // Components of other types take the generic path.
+    const auto mixed_types = std::vector<data_type>{long_type, utf8_type};
+    const auto mixed = compound_type<allow_prefixes::yes>(mixed_types);
+    auto p1 = mixed.serialize_value(std::vector<bytes>{long_type->decompose(int64_t(1)), utf8_type->decompose("b")});
+    auto p2 = mixed.serialize_value(std::vector<bytes>{long_type->decompose(int64_t(1)), utf8_type->decompose("a")});
+    BOOST_REQUIRE(mixed.prefix_equality_tri_compare(p1, p2) > 0);
+}
@@ -11,6 +11,9 @@
 #include <boost/test/unit_test.hpp>
 
 #include "sstables/compress.hh"
+#include "compress.hh"
+
+#include <fmt/format.h>
 
 BOOST_AUTO_TEST_CASE(segmented_offsets_basic_functionality) {
     sstables::compression::segmented_offsets offsets;
@@ -143,3 +146,69 @@ BOOST_AUTO_TEST_CASE(segmented_offsets_corner_cases) {
     BOOST_REQUIRE(accessor.at(4079) == 4079);
     BOOST_REQUIRE(accessor.at(4080) == 4080);
 }
+
+BOOST_AUTO_TEST_CASE(zstd_dictionary_training) {
+    auto c = compressor::create({
+        {compression_parameters::SSTABLE_COMPRESSION, "ZstdCompressor"},
+        {"dictionary_size_kb", "4"},
+    });
+    BOOST_REQUIRE(c);
+    BOOST_REQUIRE_EQUAL(c->dictionary_size(), 4096);
+
+    std::vector<std::string> samples;
+    for (int i = 0; i < 512; ++i) {
+        samples.push_back(fmt::format("{{\"id\": {}, \"name\": \"user{}\", \"active\": {}, \"score\": {}}}",
+                i, i * 7, i % 2 ? "true" : "false", i * 13 % 101));
+    }
+    std::vector<std::string_view> views(samples.begin(), samples.end());
+    auto dictionary = c->train_dictionary(views);
+    BOOST_REQUIRE(!dictionary.empty());
+    BOOST_REQUIRE_LE(dictionary.size(), 4096);
+    auto trained = c->with_dictionary(dictionary);
+    BOOST_REQUIRE(trained);
+    // Trained compressors don't train again.
+    BOOST_REQUIRE_EQUAL(trained->dictionary_size(), 0);
+
+    auto opts = trained->options();
+    BOOST_REQUIRE(opts.contains("dictionary"));
+    // Readers instantiate the compressor from the options stored in sstable metadata.
+    auto reader = compressor::create("ZstdCompressor", [&opts] (const sstring& key) -> compressor::opt_string {
+        auto it = opts.find(key);
+        if (it == opts.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    });
+
+    for (auto& sample : samples) {
+        std::vector<char> compressed(trained->compress_max_size(sample.size()));
+        auto len = trained->compress(sample.data(), sample.size(), compressed.data(), compressed.size());
+        std::vector<char> uncompressed(sample.size());
+        auto ulen = reader->uncompress(compressed.data(), len, uncompressed.data(), uncompressed.size());
+        BOOST_REQUIRE_EQUAL(std::string_view(uncompressed.data(), ulen), sample);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sstable_compression_matches_parameters) {
+    auto make_compression = [] (const compression_parameters& cp) {
+        sstables::compression c;
+        c.set_compressor(cp.get_compressor());
+        c.set_uncompressed_chunk_length(cp.chunk_length());
+        return c;
+    };
+
+    compression_parameters lz4({{compression_parameters::SSTABLE_COMPRESSION, "LZ4Compressor"}});
+    compression_parameters lz4_16k({{compression_parameters::SSTABLE_COMPRESSION, "LZ4Compressor"}, {compression_parameters::CHUNK_LENGTH_KB, "16"}});
+    compression_parameters zstd1({{compression_parameters::SSTABLE_COMPRESSION, "ZstdCompressor"}, {"compression_level", "1"}});
+    compression_parameters zstd3({{compression_parameters::SSTABLE_COMPRESSION, "ZstdCompressor"}, {"compression_level", "3"}});
+    auto none = compression_parameters::no_compression();
+
+    BOOST_REQUIRE(sstables::is_compressed_with(make_compression(lz4), lz4));
+    BOOST_REQUIRE(!sstables::is_compressed_with(make_compression(lz4), lz4_16k));
+    BOOST_REQUIRE(!sstables::is_compressed_with(make_compression(lz4), zstd1));
+    BOOST_REQUIRE(!sstables::is_compressed_with(make_compression(lz4), none));
+    BOOST_REQUIRE(sstables::is_compressed_with(make_compression(zstd1), zstd1));
+    BOOST_REQUIRE(!sstables::is_compressed_with(make_compression(zstd1), zstd3));
+    BOOST_REQUIRE(sstables::is_compressed_with(sstables::compression(), none));
+    BOOST_REQUIRE(!sstables::is_compressed_with(sstables::compression(), lz4));
+}
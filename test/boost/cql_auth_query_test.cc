@@ -341,3 +341,42 @@ SEASTAR_TEST_CASE(modify_table_with_index) {
                 {{int32_type->decompose(14)}});
     }, db_config_with_auth());
 }
+
+//
+// Caching of permissions and roles.
+//
+
+SEASTAR_TEST_CASE(grants_invalidate_cached_permissions) {
+    auto config_ptr = db_config_with_auth();
+    // Cache entries long enough that only invalidation can make the changes visible.
+    config_ptr->permissions_validity_in_ms.set(3600 * 1000);
+    config_ptr->permissions_update_interval_in_ms.set(3600 * 1000);
+    config_ptr->auth_cache_invalidation_poll_interval_in_ms.set(100);
+
+    return do_with_cql_env_thread([](auto&& env) {
+        cquery_nofail(env, "CREATE TABLE t (p int PRIMARY KEY)");
+        create_user_if_not_exists(env, bob);
+        cquery_nofail(env, "CREATE ROLE writer");
+
+        verify_unauthorized_then_ok(env, bob, "INSERT INTO t (p) VALUES (1)", [&env] {
+            cquery_nofail(env, "GRANT MODIFY ON t TO bob");
+        });
+
+        cquery_nofail(env, "REVOKE MODIFY ON t FROM bob");
+        with_user(env, bob, [&env] {
+            BOOST_REQUIRE_THROW(env.execute_cql("INSERT INTO t (p) VALUES (2)").get0(), exceptions::unauthorized_exception);
+        });
+
+        // Roles granted through other roles are cached as well.
+        cquery_nofail(env, "GRANT MODIFY ON t TO writer");
+        cquery_nofail(env, "GRANT writer TO bob");
+        with_user(env, bob, [&env] {
+            cquery_nofail(env, "INSERT INTO t (p) VALUES (3)");
+        });
+
+        cquery_nofail(env, "REVOKE writer FROM bob");
+        with_user(env, bob, [&env] {
+            BOOST_REQUIRE_THROW(env.execute_cql("INSERT INTO t (p) VALUES (4)").get0(), exceptions::unauthorized_exception);
+        });
+    }, config_ptr);
+}
@@ -27,6 +27,7 @@
 #include "types/list.hh"
 #include "types/set.hh"
 #include "db/config.hh"
+#include "db/large_data_handler.hh"
 #include "compaction/compaction_manager.hh"
 #include "test/lib/exception_utils.hh"
 #include "schema/schema_builder.hh"
@@ -47,10 +48,53 @@ SEASTAR_TEST_CASE(test_large_row_count) {
 
 static void flush(cql_test_env& e) {
     e.db().invoke_on_all([](replica::database& dbi) {
-        return dbi.flush_all_memtables();
+        return dbi.flush_all_memtables().then([&dbi] {
+            return dbi.get_large_data_handler().flush_records();
+        });
     }).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_top_large_partitions) {
+    auto cfg = make_shared<db::config>();
+    cfg->compaction_large_partition_warning_threshold_mb(0);
+    do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table tbl (a int, b int, c text, primary key (a, b))").get();
+        sstring blob(1024, 'x');
+        for (int a = 1; a <= 3; ++a) {
+            for (int b = 0; b < a * 10; ++b) {
+                e.execute_cql(format("insert into tbl (a, b, c) values ({}, {}, '{}');", a, b, blob)).get();
+            }
+        }
+        flush(e);
+
+        assert_that(e.execute_cql("select partition_key, rank from system.top_large_partitions where keyspace_name = 'ks' and table_name = 'tbl';").get0())
+            .is_rows()
+            .with_rows({
+                {utf8_type->decompose("3"), int32_type->decompose(1)},
+                {utf8_type->decompose("2"), int32_type->decompose(2)},
+                {utf8_type->decompose("1"), int32_type->decompose(3)},
+            });
+
+        e.execute_cql("delete from tbl where a = 3;").get();
+        flush(e);
+        e.db().invoke_on_all([] (replica::database& dbi) {
+            return dbi.get_tables_metadata().parallel_for_each_table([&dbi] (table_id, lw_shared_ptr<replica::table> t) {
+                return dbi.get_compaction_manager().perform_major_compaction(t->as_table_state());
+            });
+        }).get();
+
+        // The partitions are in the sstable written by the compaction now,
+        // the deleted one is only a partition tombstone.
+        assert_that(e.execute_cql("select partition_key, rank from system.top_large_partitions where keyspace_name = 'ks' and table_name = 'tbl';").get0())
+            .is_rows()
+            .with_rows({
+                {utf8_type->decompose("2"), int32_type->decompose(1)},
+                {utf8_type->decompose("1"), int32_type->decompose(2)},
+                {utf8_type->decompose("3"), int32_type->decompose(3)},
+            });
+    }, cfg).get();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_large_collection) {
     auto cfg = make_shared<db::config>();
     cfg->compaction_large_cell_warning_threshold_mb(1);
@@ -42,6 +42,7 @@
 #include <boost/regex.hpp>
 #include "gms/feature.hh"
 #include "service/qos/qos_common.hh"
+#include "service/qos/compaction_shares_updater.hh"
 #include "utils/UUID_gen.hh"
 #include "tombstone_gc_extension.hh"
 #include "db/tags/extension.hh"
@@ -4995,6 +4996,49 @@ SEASTAR_TEST_CASE(test_counter_column_added_into_non_counter_table) {
     });
 }
 
+SEASTAR_TEST_CASE(test_coalesced_counter_updates) {
+    cql_test_config cfg;
+    cfg.db_config->enable_counter_update_coalescing(true);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck int, s counter static, c1 counter, c2 counter, PRIMARY KEY(pk, ck))");
+
+        // Concurrent increments of the same partition queue behind the one
+        // in progress, and are folded into a single update.
+        auto updates = boost::irange(0, 100);
+        parallel_for_each(updates, [&e] (int i) {
+            return e.execute_cql(format("UPDATE t SET s = s + 1, c{} = c{} + {} WHERE pk = 0 AND ck = {}", i % 2 + 1, i % 2 + 1, i, i % 3)).discard_result();
+        }).get();
+        // Deletions are not folded, but are applied in between the folded updates.
+        parallel_for_each(updates, [&e] (int i) {
+            if (i == 50) {
+                return e.execute_cql("DELETE c1 FROM t WHERE pk = 1 AND ck = 0").discard_result();
+            }
+            return e.execute_cql("UPDATE t SET c2 = c2 + 1 WHERE pk = 1 AND ck = 0").discard_result();
+        }).get();
+
+        assert_that(e.execute_cql("SELECT s FROM t WHERE pk = 0 LIMIT 1").get()).is_rows().with_rows({
+            {long_type->decompose(int64_t(100))},
+        });
+        auto sum = [] (int ck, int parity) {
+            int64_t s = 0;
+            for (int i = 0; i < 100; ++i) {
+                if (i % 3 == ck && i % 2 == parity) {
+                    s += i;
+                }
+            }
+            return s;
+        };
+        for (int ck = 0; ck < 3; ++ck) {
+            assert_that(e.execute_cql(format("SELECT c1, c2 FROM t WHERE pk = 0 AND ck = {}", ck)).get()).is_rows().with_rows({
+                {long_type->decompose(sum(ck, 0)), long_type->decompose(sum(ck, 1))},
+            });
+        }
+        assert_that(e.execute_cql("SELECT c1, c2 FROM t WHERE pk = 1 AND ck = 0").get()).is_rows().with_rows({
+            {{}, long_type->decompose(int64_t(99))},
+        });
+    }, std::move(cfg));
+}
+
 SEASTAR_THREAD_TEST_CASE(test_invalid_using_timestamps) {
     do_with_cql_env_thread([] (cql_test_env& e) {
         auto now_nano = std::chrono::duration_cast<std::chrono::nanoseconds>(db_clock::now().time_since_epoch()).count();
@@ -5106,14 +5150,14 @@ SEASTAR_TEST_CASE(test_user_based_sla_queries) {
         e.execute_cql("CREATE SERVICE_LEVEL sl_1;").get();
         auto msg = e.execute_cql("LIST SERVICE_LEVEL sl_1;").get0();
         assert_that(msg).is_rows().with_rows({
-            {utf8_type->decompose("sl_1"), {}, {}},
+            {utf8_type->decompose("sl_1"), {}, {}, {}},
         });
         e.execute_cql("CREATE SERVICE_LEVEL sl_2;").get();
         //drop service levels
         e.execute_cql("DROP SERVICE_LEVEL sl_1;").get();
         msg = e.execute_cql("LIST ALL SERVICE_LEVELS;").get0();
         assert_that(msg).is_rows().with_rows({
-            {utf8_type->decompose("sl_2"), {}, {}},
+            {utf8_type->decompose("sl_2"), {}, {}, {}},
         });
 
         // validate exceptions (illegal requests)
@@ -5181,6 +5225,69 @@ SEASTAR_TEST_CASE(test_user_based_sla_queries) {
 // Check that `current*()` CQL functions are re-evaluated on each execute
 // even for prepared statements.
 // Refs: #8816 (https://github.com/scylladb/scylla/issues/8816)
+
+SEASTAR_TEST_CASE(test_service_level_shares) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE SERVICE_LEVEL sl_1 WITH shares = 300;").get();
+        auto msg = e.execute_cql("LIST SERVICE_LEVEL sl_1;").get0();
+        assert_that(msg).is_rows().with_rows({
+            {utf8_type->decompose("sl_1"), {}, {}, int32_type->decompose(300)},
+        });
+        e.execute_cql("ALTER SERVICE_LEVEL sl_1 WITH shares = 500;").get();
+        msg = e.execute_cql("LIST SERVICE_LEVEL sl_1;").get0();
+        assert_that(msg).is_rows().with_rows({
+            {utf8_type->decompose("sl_1"), {}, {}, int32_type->decompose(500)},
+        });
+        BOOST_REQUIRE_THROW(e.execute_cql("CREATE SERVICE_LEVEL sl_2 WITH shares = 0;").get(), exceptions::invalid_request_exception);
+        BOOST_REQUIRE_THROW(e.execute_cql("CREATE SERVICE_LEVEL sl_2 WITH shares = 1001;").get(), exceptions::invalid_request_exception);
+    });
+}
+
+SEASTAR_TEST_CASE(test_compaction_shares_updater) {
+    cql_test_config cfg;
+    auto db_cfg = cfg.db_config;
+    return do_with_cql_env_thread([db_cfg] (cql_test_env& e) {
+        e.execute_cql("CREATE KEYSPACE ks2 WITH replication = {'class': 'SimpleStrategy', 'replication_factor': 1};").get();
+        e.execute_cql("CREATE TABLE ks.t1 (pk int PRIMARY KEY, v int);").get();
+        e.execute_cql("CREATE TABLE ks2.t2 (pk int PRIMARY KEY, v int);").get();
+        auto weight = [&e] (std::string_view ks, std::string_view cf) {
+            return e.local_db().find_column_family(ks, cf).compaction_backlog_weight();
+        };
+
+        qos::compaction_shares_updater updater(e.service_level_controller_service().local(), e.local_db(), *db_cfg);
+        updater.start().get();
+        auto stop_updater = defer([&updater] { updater.stop().get(); });
+        BOOST_REQUIRE_EQUAL(weight("ks", "t1"), 1);
+
+        // A service level without shares counts with the default ones.
+        db_cfg->keyspace_service_levels.set(db::config::string_map{{"ks", "sl"}});
+        BOOST_REQUIRE_EQUAL(weight("ks", "t1"), 1);
+
+        qos::service_level_options slo;
+        slo.shares = int32_t(250);
+        updater.on_before_service_level_add(slo, {"sl"}).get();
+        BOOST_REQUIRE_EQUAL(weight("ks", "t1"), 0.25);
+        BOOST_REQUIRE_EQUAL(weight("ks2", "t2"), 1);
+
+        // Tables created later get the shares of their keyspace.
+        e.execute_cql("CREATE TABLE ks.t3 (pk int PRIMARY KEY, v int);").get();
+        BOOST_REQUIRE_EQUAL(weight("ks", "t3"), 0.25);
+
+        auto slo_after = slo;
+        slo_after.shares = int32_t(500);
+        updater.on_before_service_level_change(slo, slo_after, {"sl"}).get();
+        BOOST_REQUIRE_EQUAL(weight("ks", "t1"), 0.5);
+        BOOST_REQUIRE_EQUAL(weight("ks", "t3"), 0.5);
+
+        // Attributing the keyspace elsewhere restores the default shares.
+        db_cfg->keyspace_service_levels.set(db::config::string_map{{"ks2", "sl"}});
+        BOOST_REQUIRE_EQUAL(weight("ks", "t1"), 1);
+        BOOST_REQUIRE_EQUAL(weight("ks2", "t2"), 0.5);
+
+        updater.on_after_service_level_remove({"sl"}).get();
+        BOOST_REQUIRE_EQUAL(weight("ks2", "t2"), 1);
+    }, cfg);
+}
 SEASTAR_TEST_CASE(timeuuid_fcts_prepared_re_evaluation) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         // We don't test the `currentdate()` function since we don't
@@ -19,6 +19,8 @@
 
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/result_set_assertions.hh"
+#include "test/lib/cql_assertions.hh"
+#include "test/lib/eventually.hh"
 #include "test/lib/log.hh"
 #include "test/lib/random_utils.hh"
 #include "test/lib/test_utils.hh"
@@ -38,6 +40,7 @@
 #include "db/commitlog/commitlog.hh"
 #include "test/lib/tmpdir.hh"
 #include "db/data_listeners.hh"
+#include "db/hot_partition_replicas.hh"
 #include "multishard_mutation_query.hh"
 #include "transport/messages/result_message.hh"
 #include "compaction/compaction_manager.hh"
@@ -804,8 +807,11 @@ SEASTAR_TEST_CASE(clear_nonexistent_snapshot) {
 
 SEASTAR_TEST_CASE(test_snapshot_ctl_details) {
     return do_with_some_data({"cf"}, [] (cql_test_env& e) {
+        sharded<tasks::task_manager> tm;
+        tm.start().get();
+        auto stop_tm = deferred_stop(tm);
         sharded<db::snapshot_ctl> sc;
-        sc.start(std::ref(e.db())).get();
+        sc.start(std::ref(e.db()), std::ref(tm), db::snapshot_ctl::config{}).get();
         auto stop_sc = deferred_stop(sc);
 
         auto& cf = e.local_db().find_column_family("ks", "cf");
@@ -854,8 +860,11 @@ SEASTAR_TEST_CASE(test_snapshot_ctl_details) {
 
 SEASTAR_TEST_CASE(test_snapshot_ctl_true_snapshots_size) {
     return do_with_some_data({"cf"}, [] (cql_test_env& e) {
+        sharded<tasks::task_manager> tm;
+        tm.start().get();
+        auto stop_tm = deferred_stop(tm);
         sharded<db::snapshot_ctl> sc;
-        sc.start(std::ref(e.db())).get();
+        sc.start(std::ref(e.db()), std::ref(tm), db::snapshot_ctl::config{}).get();
         auto stop_sc = deferred_stop(sc);
 
         auto& cf = e.local_db().find_column_family("ks", "cf");
@@ -1441,3 +1450,180 @@ SEASTAR_TEST_CASE(mutation_dump_generated_schema_deterministic_id_version) {
 
     return make_ready_future<>();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_hot_partition_replicas) {
+    if (smp::count < 2) {
+        testlog.info("test_hot_partition_replicas requires at least 2 shards, skipping");
+        return;
+    }
+    cql_test_config cfg;
+    cfg.db_config->hot_partition_replicas(1, utils::config_file::config_source::CommandLine);
+    cfg.db_config->hot_partition_read_threshold(1, utils::config_file::config_source::CommandLine);
+
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.tab (pk int PRIMARY KEY, v int)").get();
+        auto s = e.local_db().find_schema("ks", "tab");
+
+        // Copies go to the next shard, so use a partition owned by the shard before this one.
+        const auto owner = (this_shard_id() + smp::count - 1) % smp::count;
+        const auto dk = tests::generate_partition_key(s, owner);
+        const auto pk = int32_type->to_string(dk.key().explode().front());
+
+        e.execute_cql(format("INSERT INTO ks.tab (pk, v) VALUES ({}, 1)", pk)).get();
+
+        auto get_stats = [&] (shard_id shard) {
+            return e.db().invoke_on(shard, [] (replica::database& db) {
+                return db.get_hot_partition_replicas().get_stats();
+            }).get();
+        };
+        auto read = [&] {
+            return e.execute_cql(format("SELECT v FROM ks.tab WHERE pk = {}", pk)).get();
+        };
+
+        BOOST_REQUIRE(eventually_true([&] {
+            assert_that(read()).is_rows().with_rows({{int32_type->decompose(1)}});
+            return get_stats(this_shard_id()).reads > 0;
+        }));
+        BOOST_REQUIRE_GT(get_stats(owner).replications, 0);
+
+        // The write drops the copy before it's acknowledged.
+        e.execute_cql(format("UPDATE ks.tab SET v = 2 WHERE pk = {}", pk)).get();
+        BOOST_REQUIRE_GT(get_stats(owner).invalidations, 0);
+        assert_that(read()).is_rows().with_rows({{int32_type->decompose(2)}});
+
+        // Truncating drops all copies of the table.
+        const auto reads = get_stats(this_shard_id()).reads;
+        BOOST_REQUIRE(eventually_true([&] {
+            assert_that(read()).is_rows().with_rows({{int32_type->decompose(2)}});
+            return get_stats(this_shard_id()).reads > reads;
+        }));
+        e.execute_cql("TRUNCATE ks.tab").get();
+        assert_that(read()).is_rows().is_empty();
+    }, std::move(cfg)).get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hot_partition_replicas_offload_owner) {
+    if (smp::count < 2) {
+        testlog.info("test_hot_partition_replicas_offload_owner requires at least 2 shards, skipping");
+        return;
+    }
+    cql_test_config cfg;
+    cfg.db_config->hot_partition_replicas(1, utils::config_file::config_source::CommandLine);
+    cfg.db_config->hot_partition_read_threshold(1, utils::config_file::config_source::CommandLine);
+
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.tab (pk int PRIMARY KEY, v int)").get();
+        auto s = e.local_db().find_schema("ks", "tab");
+
+        // Reads coordinated by the owner, as sent by shard-aware drivers,
+        // are served by the shard holding the copy in turns with the owner.
+        const auto owner = this_shard_id();
+        const auto copy_shard = (owner + 1) % smp::count;
+        const auto dk = tests::generate_partition_key(s, owner);
+        const auto pk = int32_type->to_string(dk.key().explode().front());
+
+        e.execute_cql(format("INSERT INTO ks.tab (pk, v) VALUES ({}, 1)", pk)).get();
+
+        auto copy_reads = [&] {
+            return e.db().invoke_on(copy_shard, [] (replica::database& db) {
+                return db.get_hot_partition_replicas().get_stats().reads;
+            }).get();
+        };
+        auto read = [&] {
+            return e.execute_cql(format("SELECT v FROM ks.tab WHERE pk = {}", pk)).get();
+        };
+
+        BOOST_REQUIRE(eventually_true([&] {
+            assert_that(read()).is_rows().with_rows({{int32_type->decompose(1)}});
+            return copy_reads() > 0;
+        }));
+
+        // Reads after an acknowledged write don't see the stale copy.
+        e.execute_cql(format("UPDATE ks.tab SET v = 2 WHERE pk = {}", pk)).get();
+        for (int i = 0; i < 4; ++i) {
+            assert_that(read()).is_rows().with_rows({{int32_type->decompose(2)}});
+        }
+    }, std::move(cfg)).get();
+}
+
+SEASTAR_TEST_CASE(test_query_batch_of_partition_keys) {
+    return do_with_cql_env_and_compaction_groups([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.tab (pk int, ck int, v int, PRIMARY KEY (pk, ck))").get();
+        auto& db = e.local_db();
+        auto s = db.find_schema("ks", "tab");
+        auto& t = db.find_column_family(s);
+
+        auto keys = tests::generate_partition_keys(9, s);
+        std::sort(keys.begin(), keys.end(), dht::decorated_key::less_comparator(s));
+        // The last key has no data.
+        const auto absent = keys.back();
+        keys.pop_back();
+
+        // Spread the partitions over several sstables and the memtable, with some of
+        // the sstables containing more than one of the queried keys.
+        const int rounds = 4;
+        for (int round = 0; round < rounds; ++round) {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                if ((i + round) % 3 == 0) {
+                    continue;
+                }
+                mutation m(s, keys[i]);
+                m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(round)), "v", int32_t(i * 10 + round), api::new_timestamp());
+                t.apply(m);
+            }
+            if (round != rounds - 1) {
+                t.flush().get();
+            }
+        }
+
+        // Every other key, in ring order.
+        dht::partition_range_vector ranges;
+        for (size_t i = 0; i < keys.size(); i += 2) {
+            ranges.push_back(dht::partition_range::make_singular(keys[i]));
+        }
+        ranges.push_back(dht::partition_range::make_singular(absent));
+
+        auto cmd = query::read_command(s->id(), s->version(), partition_slice_builder(*s).build(), query::max_result_size(std::numeric_limits<size_t>::max()),
+                query::tombstone_limit::max, query::row_limit(1000));
+        auto do_query = [&] (const dht::partition_range_vector& ranges) {
+            auto result = std::get<0>(db.query(s, cmd, query::result_options::only_result(), ranges, nullptr, db::no_timeout).get());
+            return query::result_set::from_raw_result(s, cmd.slice, *result);
+        };
+
+        std::vector<query::result_set_row> expected_rows;
+        for (auto& pr : ranges) {
+            auto rs = do_query({pr});
+            expected_rows.insert(expected_rows.end(), rs.rows().begin(), rs.rows().end());
+        }
+        BOOST_REQUIRE(!expected_rows.empty());
+        const auto expected = query::result_set(s, std::move(expected_rows));
+
+        // Once with a cold cache, so that the keys are read from the sstables, then from the cache.
+        // Either way, database::query() reads the whole batch with a single cache reader.
+        auto& cache_stats = db.row_cache_tracker().get_stats();
+        t.get_row_cache().evict();
+        auto reads_before = cache_stats.reads;
+        BOOST_REQUIRE_EQUAL(do_query(ranges), expected);
+        BOOST_REQUIRE_EQUAL(cache_stats.reads - reads_before, 1u);
+        reads_before = cache_stats.reads;
+        BOOST_REQUIRE_EQUAL(do_query(ranges), expected);
+        BOOST_REQUIRE_EQUAL(cache_stats.reads - reads_before, 1u);
+
+        // Paged queries read range by range, so that the saved querier can resume from any of them.
+        {
+            auto paged_cmd = cmd;
+            paged_cmd.query_uuid = query_id::create_random_id();
+            paged_cmd.is_first_page = query::is_first_page::yes;
+            reads_before = cache_stats.reads;
+            auto result = std::get<0>(db.query(s, paged_cmd, query::result_options::only_result(), ranges, nullptr, db::no_timeout).get());
+            BOOST_REQUIRE_EQUAL(query::result_set::from_raw_result(s, paged_cmd.slice, *result), expected);
+            BOOST_REQUIRE_EQUAL(cache_stats.reads - reads_before, ranges.size());
+        }
+
+        // With a row limit which stops the read in the middle of the batch.
+        cmd.set_row_limit(3);
+        auto limited = do_query(ranges);
+        BOOST_REQUIRE_EQUAL(limited.rows().size(), 3u);
+        BOOST_REQUIRE(std::equal(limited.rows().begin(), limited.rows().end(), expected.rows().begin()));
+    });
+}
@@ -263,6 +263,34 @@ SEASTAR_TEST_CASE(test_region_groups_basic_throttling) {
     });
 }
 
+SEASTAR_TEST_CASE(test_region_groups_within_share_throttling) {
+    return seastar::async([] {
+        raii_region_group rg({
+            .unspooled_hard_limit = logalloc::segment_size,
+            .real_hard_limit = 16 * logalloc::segment_size,
+        });
+        auto small_region = std::make_unique<test_region>();
+        small_region->listen(&rg);
+        auto big_region = std::make_unique<test_region>();
+        big_region->listen(&rg);
+        small_region->alloc_small();
+        big_region->alloc();
+        BOOST_REQUIRE(rg.under_unspooled_pressure());
+
+        // Writers over their share queue up behind the unspooled limit...
+        auto blocked = rg.run_when_memory_available([&small_region] { small_region->alloc_small(); }, db::no_timeout);
+        BOOST_REQUIRE(!blocked.available());
+
+        // ...but those within it only wait for the real limit, even with requests queued.
+        auto within = rg.run_when_memory_available([&small_region] { small_region->alloc_small(); }, db::no_timeout, true);
+        BOOST_REQUIRE(within.available());
+        within.get();
+
+        big_region.reset();
+        quiesce(std::move(blocked));
+    });
+}
+
 SEASTAR_TEST_CASE(test_region_groups_fifo_order) {
     // tests that requests that are queued for later execution execute in FIFO order
     return seastar::async([] {
@@ -642,3 +670,81 @@ SEASTAR_THREAD_TEST_CASE(test_size_tracked_region_move_assign) {
     r1 = std::move(r0);
     r1.allocator().free(std::exchange(p, nullptr));
 }
+
+SEASTAR_THREAD_TEST_CASE(test_region_group_set_limits) {
+    raii_region_group rg({
+        .unspooled_hard_limit = logalloc::segment_size,
+        .real_hard_limit = 16 * logalloc::segment_size,
+    });
+    auto region = std::make_unique<test_region>();
+    region->listen(&rg);
+    region->alloc();
+    region->alloc_small();
+    BOOST_REQUIRE(rg.under_unspooled_pressure());
+
+    auto fut = rg.run_when_memory_available([] {}, db::no_timeout);
+    BOOST_REQUIRE(!fut.available());
+
+    // Raising the limits releases the blocked requests.
+    rg.set_limits(8 * logalloc::segment_size, 8 * logalloc::segment_size, 16 * logalloc::segment_size);
+    BOOST_REQUIRE(!rg.under_unspooled_pressure());
+    quiesce(std::move(fut));
+
+    rg.set_limits(logalloc::segment_size, logalloc::segment_size, 16 * logalloc::segment_size);
+    BOOST_REQUIRE(rg.under_unspooled_pressure());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_dirty_memory_borrowing) {
+    constexpr size_t max_borrowed = dirty_memory_borrowing::steps * 1024;
+    constexpr size_t step = max_borrowed / dirty_memory_borrowing::steps;
+    dirty_memory_borrowing b;
+    dirty_memory_borrowing::sample s;
+
+    auto period = [&] (uint64_t blocked_writes, uint64_t reads, uint64_t reads_with_misses, uint64_t evictions) {
+        s.blocked_writes += blocked_writes;
+        s.cache_reads += reads;
+        s.cache_reads_with_misses += reads_with_misses;
+        s.cache_evictions += evictions;
+        return b.update(s, max_borrowed);
+    };
+
+    // Throttled writes with a cold cache borrow, after a few periods of hysteresis.
+    for (unsigned i = 1; i < dirty_memory_borrowing::periods_to_change; ++i) {
+        BOOST_REQUIRE_EQUAL(period(10, 100, 90, 100), 0u);
+    }
+    BOOST_REQUIRE_EQUAL(period(10, 100, 90, 100), step);
+
+    // A single period of a hot cache doesn't change anything...
+    BOOST_REQUIRE_EQUAL(period(10, 100, 1, 100), step);
+    // ...and resets the streak.
+    for (unsigned i = 1; i < dirty_memory_borrowing::periods_to_change; ++i) {
+        BOOST_REQUIRE_EQUAL(period(10, 0, 0, 0), step);
+    }
+    BOOST_REQUIRE_EQUAL(period(10, 0, 0, 0), 2 * step);
+
+    // Borrowing never goes above the maximum.
+    for (unsigned i = 0; i < dirty_memory_borrowing::periods_to_change * dirty_memory_borrowing::steps; ++i) {
+        period(10, 0, 0, 0);
+    }
+    BOOST_REQUIRE_EQUAL(b.borrowed(), max_borrowed);
+
+    // A hot cache which evicts takes the memory back, even while writes are throttled.
+    for (unsigned i = 0; i < dirty_memory_borrowing::periods_to_change; ++i) {
+        period(10, 100, 1, 100);
+    }
+    BOOST_REQUIRE_EQUAL(b.borrowed(), max_borrowed - step);
+
+    // So does the lack of write pressure.
+    for (unsigned i = 0; i < dirty_memory_borrowing::periods_to_change * dirty_memory_borrowing::steps; ++i) {
+        period(0, 0, 0, 0);
+    }
+    BOOST_REQUIRE_EQUAL(b.borrowed(), 0u);
+
+    // Lowering the maximum takes effect immediately.
+    for (unsigned i = 0; i < dirty_memory_borrowing::periods_to_change * 2; ++i) {
+        period(10, 0, 0, 0);
+    }
+    BOOST_REQUIRE_EQUAL(b.borrowed(), 2 * step);
+    s.blocked_writes += 10;
+    BOOST_REQUIRE_EQUAL(b.update(s, step), step);
+}
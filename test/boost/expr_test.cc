@@ -4671,3 +4671,67 @@ BOOST_AUTO_TEST_CASE(test_levellize_aggregation_depth) {
     // Somewhat fragile, but easiest way to test entire structure
     BOOST_REQUIRE_EQUAL(fmt::format("{:debug}", e2), "foo.my_agg(system.sum(system.$$first$$(r)), system.$$first$$(system.$$first$$(TTL(r))))");
 }
+
+// compiled_restriction must agree with is_satisfied_by() on every input.
+BOOST_AUTO_TEST_CASE(compiled_restriction_matches_is_satisfied_by) {
+    schema_ptr table_schema = schema_builder("test_ks", "test_cf")
+                                  .with_column("pk", int32_type, column_kind::partition_key)
+                                  .with_column("ck", reversed_type_impl::get_instance(long_type), column_kind::clustering_key)
+                                  .with_column("i", int32_type)
+                                  .with_column("t", utf8_type)
+                                  .with_column("ts", timestamp_type)
+                                  .with_column("d", double_type)
+                                  .build();
+    auto col = [&] (const char* name) {
+        return column_value(table_schema->get_column_definition(to_bytes(name)));
+    };
+    auto ts_raw = [] (const char* s) {
+        return raw_value::make_value(timestamp_type->from_string(s));
+    };
+
+    struct column_case {
+        const char* name;
+        std::vector<raw_value> values; // both cell values and right-hand sides
+    };
+    std::vector<column_case> cases = {
+        {"pk", {make_int_raw(-5), make_int_raw(0), make_int_raw(7), make_empty_raw()}},
+        {"ck", {make_bigint_raw(-1), make_bigint_raw(0), make_bigint_raw(1L << 40), make_empty_raw()}},
+        {"i", {make_int_raw(std::numeric_limits<int32_t>::min()), make_int_raw(3), make_int_raw(4), make_empty_raw(), raw_value::make_null()}},
+        {"t", {make_text_raw(""), make_text_raw("a"), make_text_raw("ab"), make_text_raw("b"), raw_value::make_null()}},
+        {"ts", {ts_raw("1960-01-01T00:00:00+0000"), ts_raw("2011-03-02T03:05:00+0000"), raw_value::make_null()}},
+        {"d", {make_double_raw(-1.5), make_double_raw(2.0), raw_value::make_null()}},
+    };
+    const std::vector<oper_t> ops = {oper_t::EQ, oper_t::NEQ, oper_t::LT, oper_t::LTE, oper_t::GT, oper_t::GTE};
+
+    for (const auto& c : cases) {
+        const data_type type = table_schema->get_column_definition(to_bytes(c.name))->type->without_reversed();
+        for (const auto& cell : c.values) {
+            if (cell.is_null() && (std::string_view(c.name) == "pk" || std::string_view(c.name) == "ck")) {
+                continue;
+            }
+            for (const auto& rhs : c.values) {
+                for (auto op : ops) {
+                    column_values vals = {
+                        {"pk", make_int_raw(1)}, {"ck", make_bigint_raw(1)}, {"i", make_int_raw(0)},
+                        {"t", make_text_raw("x")}, {"ts", raw_value::make_null()}, {"d", raw_value::make_null()},
+                    };
+                    vals.insert_or_assign(c.name, cell);
+                    auto [inputs, inputs_data] = make_evaluation_inputs(table_schema, vals, {rhs});
+
+                    // The same comparison with a constant, and with a bind variable,
+                    // in a conjunction with an always true factor.
+                    expression with_constant = binary_operator(col(c.name), op, constant(rhs, type));
+                    expression with_bind_variable = conjunction{{
+                        binary_operator(col("pk"), oper_t::EQ, make_int_const(1)),
+                        binary_operator(col(c.name), op, make_bind_variable(0, type)),
+                    }};
+                    for (const auto& e : {with_constant, with_bind_variable}) {
+                        compiled_restriction compiled(e, *inputs_data->selection, inputs_data->options);
+                        BOOST_REQUIRE_MESSAGE(compiled.is_satisfied_by(inputs) == is_satisfied_by(e, inputs),
+                                fmt::format("{} with {}={}", e, c.name, cell));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -23,6 +23,8 @@
 #include "sstables/sstables.hh"
 #include "cdc/cdc_extension.hh"
 #include "db/paxos_grace_seconds_extension.hh"
+#include "db/commitlog_bypass_extension.hh"
+#include "exceptions/exceptions.hh"
 #include "transport/messages/result_message.hh"
 #include "utils/overloaded_functor.hh"
 
@@ -161,6 +163,31 @@ SEASTAR_TEST_CASE(paxos_grace_seconds_extension) {
     }, std::move(cql_cfg));
 }
 
+SEASTAR_TEST_CASE(commitlog_bypass_extension) {
+    auto ext = std::make_shared<db::extensions>();
+    ext->add_schema_extension<db::commitlog_bypass_extension>(db::commitlog_bypass_extension::NAME);
+    auto cfg = ::make_shared<db::config>(ext);
+
+    return do_with_cql_env([] (cql_test_env& e) -> future<> {
+        co_await e.execute_cql("CREATE TABLE cf (pk int PRIMARY KEY, v int) WITH commitlog_bypass = true");
+        auto& t = e.local_db().find_column_family("ks", "cf");
+        BOOST_REQUIRE(!t.schema()->extensions().at(db::commitlog_bypass_extension::NAME)->is_placeholder());
+        BOOST_REQUIRE(t.schema()->commitlog_bypass());
+        BOOST_REQUIRE(!t.durable_writes());
+
+        co_await e.execute_cql("INSERT INTO cf (pk, v) VALUES (1, 2)");
+        auto msg = co_await e.execute_cql("SELECT v FROM cf WHERE pk = 1");
+        assert_that(msg).is_rows().with_rows({{int32_type->decompose(2)}});
+
+        co_await e.execute_cql("ALTER TABLE cf WITH commitlog_bypass = false");
+        BOOST_REQUIRE(!e.local_db().find_column_family("ks", "cf").schema()->commitlog_bypass());
+        BOOST_REQUIRE(e.local_db().find_column_family("ks", "cf").durable_writes());
+
+        BOOST_REQUIRE_THROW(co_await e.execute_cql("CREATE TABLE cf2 (pk int PRIMARY KEY) WITH commitlog_bypass = 'maybe'"),
+                exceptions::configuration_exception);
+    }, cfg);
+}
+
 SEASTAR_TEST_CASE(test_extension_remove) {
     auto ext = std::make_shared<db::extensions>();
     ext->add_schema_extension("knas", [](db::extensions::schema_ext_config args) {
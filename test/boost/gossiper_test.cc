@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/core/sleep.hh>
+
+#include "gms/gossiper.hh"
+#include "gms/generation-number.hh"
+
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "test/lib/cql_test_env.hh"
+
+// A heartbeat of another node which comes with no application state change
+// updates only the shard running gossip. The other shards get it with the
+// next application state change, which is copied to them immediately, or
+// with the first heartbeat after HEARTBEAT_REPLICATION_INTERVAL.
+SEASTAR_TEST_CASE(test_heartbeat_replication_to_other_shards) {
+    if (smp::count < 2) {
+        std::cerr << "Cannot run test " << get_name() << " with smp::count < 2" << std::endl;
+        return make_ready_future<>();
+    }
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto& gossiper = e.gossiper();
+        const auto node = gms::inet_address("127.0.0.100");
+        auto heart_beat = gms::heart_beat_state(gms::get_generation_number(), gms::version_generator::get_next_version());
+        auto load = gms::versioned_value::load(1.0);
+
+        auto apply = [&] {
+            auto es = gms::endpoint_state(heart_beat);
+            es.add_application_state(gms::application_state::LOAD, load);
+            gossiper.local().apply_state_locally({{node, std::move(es)}}).get();
+        };
+        auto heart_beat_version_on = [&] (unsigned shard) {
+            return gossiper.invoke_on(shard, [node] (gms::gossiper& g) {
+                return g.get_endpoint_state_ptr(node)->get_heart_beat_state().get_heart_beat_version();
+            }).get();
+        };
+        auto require_heart_beat_version = [&] (gms::version_type on_shard0, gms::version_type on_other_shards) {
+            BOOST_REQUIRE_EQUAL(heart_beat_version_on(0), on_shard0);
+            for (unsigned shard = 1; shard < smp::count; ++shard) {
+                BOOST_REQUIRE_EQUAL(heart_beat_version_on(shard), on_other_shards);
+            }
+        };
+
+        // A new node is copied to all shards.
+        apply();
+        auto replicated = heart_beat.get_heart_beat_version();
+        require_heart_beat_version(replicated, replicated);
+
+        heart_beat.update_heart_beat();
+        apply();
+        require_heart_beat_version(heart_beat.get_heart_beat_version(), replicated);
+
+        // An application state change takes the heartbeat along.
+        heart_beat.update_heart_beat();
+        load = gms::versioned_value::load(2.0);
+        apply();
+        replicated = heart_beat.get_heart_beat_version();
+        require_heart_beat_version(replicated, replicated);
+
+        heart_beat.update_heart_beat();
+        apply();
+        require_heart_beat_version(heart_beat.get_heart_beat_version(), replicated);
+
+        sleep(gms::gossiper::HEARTBEAT_REPLICATION_INTERVAL).get();
+        heart_beat.update_heart_beat();
+        apply();
+        replicated = heart_beat.get_heart_beat_version();
+        require_heart_beat_version(replicated, replicated);
+
+        gossiper.local().force_remove_endpoint(node, gms::null_permit_id).get();
+    });
+}
@@ -11,6 +11,9 @@
 #include <seastar/core/smp.hh>
 
 #include "db/hints/sync_point.hh"
+#include "db/hints/internal/hint_storage.hh"
+#include "test/lib/simple_schema.hh"
+#include "test/lib/mutation_assertions.hh"
 
 SEASTAR_TEST_CASE(test_hint_sync_point_faithful_reserialization) {
     const unsigned encoded_shard_count = 2;
@@ -65,3 +68,41 @@ SEASTAR_TEST_CASE(test_hint_sync_point_faithful_reserialization) {
 
     return make_ready_future<>();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_hint_merger_merges_hints_for_same_partition) {
+    simple_schema ss;
+    auto pk1 = ss.make_pkey(1);
+    auto pk2 = ss.make_pkey(2);
+
+    const db::replay_position rp1{0, 10, 100};
+    const db::replay_position rp2{0, 10, 200};
+    const db::replay_position rp3{0, 10, 300};
+
+    // the newer write comes first in the file, the older one must not win
+    mutation m1(ss.schema(), pk1);
+    ss.add_row(m1, ss.make_ckey(1), "new", 2);
+    mutation m2(ss.schema(), pk2);
+    ss.add_row(m2, ss.make_ckey(1), "v", 1);
+    mutation m3(ss.schema(), pk1);
+    ss.add_row(m3, ss.make_ckey(1), "old", 1);
+    ss.delete_range(m3, ss.make_ckey_range(2, 3), tombstone(1, gc_clock::now()));
+
+    db::hints::internal::hint_merger merger;
+    merger.add(m1, rp1);
+    merger.add(m2, rp2);
+    merger.add(m3, rp3);
+    BOOST_REQUIRE_EQUAL(merger.merged(), 1);
+
+    auto merged = std::move(merger).get();
+    BOOST_REQUIRE_EQUAL(merged.size(), 2);
+    for (auto& mh : merged) {
+        if (mh.m.decorated_key().equal(*ss.schema(), pk1)) {
+            auto expected = m1 + m3;
+            assert_that(mh.m).is_equal_to(expected);
+            BOOST_REQUIRE(mh.rps == std::vector<db::replay_position>({rp1, rp3}));
+        } else {
+            assert_that(mh.m).is_equal_to(m2);
+            BOOST_REQUIRE(mh.rps == std::vector<db::replay_position>({rp2}));
+        }
+    }
+}
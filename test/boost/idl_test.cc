@@ -29,6 +29,13 @@ struct simple_compound {
     }
 };
 
+struct final_simple_compound {
+    uint32_t foo;
+    uint32_t bar;
+
+    bool operator==(const final_simple_compound&) const = default;
+};
+
 class non_final_composite_test_object {
     simple_compound _x;
 public:
@@ -243,6 +250,33 @@ BOOST_AUTO_TEST_CASE(test_vector)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_vector_of_fixed_size_final)
+{
+    static_assert(ser::fixed_serialized_size<final_simple_compound>::value == 8);
+    static_assert(ser::fixed_serialized_size<simple_compound>::value == 0);
+
+    // Large enough to span several bytes_ostream fragments.
+    std::vector<final_simple_compound> vec;
+    for (uint32_t i = 0; i < 100000; i++) {
+        vec.push_back({i, ~i});
+    }
+
+    bytes_ostream buf;
+    ser::serialize(buf, vec);
+    ser::serialize(buf, uint32_t(0xdeadbeef));
+    BOOST_REQUIRE_EQUAL(buf.size(), 4 + vec.size() * 8 + 4);
+    BOOST_REQUIRE(!buf.is_linearized());
+
+    auto in1 = ser::as_input_stream(buf);
+    auto deser_vec = ser::deserialize(in1, boost::type<std::vector<final_simple_compound>>());
+    BOOST_REQUIRE(vec == deser_vec);
+    BOOST_REQUIRE_EQUAL(ser::deserialize(in1, boost::type<uint32_t>()), 0xdeadbeef);
+
+    auto in2 = ser::as_input_stream(buf);
+    ser::skip(in2, boost::type<std::vector<final_simple_compound>>());
+    BOOST_REQUIRE_EQUAL(ser::deserialize(in2, boost::type<uint32_t>()), 0xdeadbeef);
+}
+
 BOOST_AUTO_TEST_CASE(test_variant)
 {
     std::vector<simple_compound> vec = {
@@ -443,3 +443,27 @@ BOOST_AUTO_TEST_CASE(test_reset) {
     BOOST_TEST(matches(m, u8"alpha"));
     BOOST_TEST(!matches(m, u8"omega"));
 }
+
+BOOST_AUTO_TEST_CASE(test_long_literal) {
+    const char8_t* text = u8"the quick brown fox jumps over the lazy dog, then the quick brown fox sleeps";
+    BOOST_TEST(matches(matcher(u8"%lazy dog%"), text));
+    BOOST_TEST(matches(matcher(u8"%fox sleeps"), text));
+    BOOST_TEST(matches(matcher(u8"the quick%"), text));
+    BOOST_TEST(matches(matcher(u8"%sleeps%"), text));
+    BOOST_TEST(!matches(matcher(u8"%lazy cat%"), text));
+    BOOST_TEST(!matches(matcher(u8"%fox jumps"), text));
+    BOOST_TEST(!matches(matcher(u8"lazy dog%"), text));
+    BOOST_TEST(matches(matcher(u8R"(%100\%%)"), u8"a sample string that is 100% longer than thirty-two bytes"));
+    BOOST_TEST(!matches(matcher(u8R"(%100\%%)"), u8"a sample string that is 100 percent longer than thirty-two bytes"));
+}
+
+BOOST_AUTO_TEST_CASE(test_reset_literal_and_wildcard) {
+    auto m = matcher(u8"%pha");
+    BOOST_TEST(matches(m, u8"alpha"));
+    m.reset(bytes(reinterpret_cast<const char*>(u8"a_pha")));
+    BOOST_TEST(matches(m, u8"alpha"));
+    BOOST_TEST(!matches(m, u8"apha"));
+    m.reset(bytes(reinterpret_cast<const char*>(u8"%ph%")));
+    BOOST_TEST(matches(m, u8"alpha"));
+    BOOST_TEST(!matches(m, u8"omega"));
+}
@@ -96,6 +96,46 @@ SEASTAR_TEST_CASE(test_compaction) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_sample_objects) {
+    region reg;
+    std::vector<managed_ref<int64_t>> small;
+    std::vector<managed_ref<std::array<char, 100>>> large;
+    const size_t count = 64 * 1024;
+    with_allocator(reg.allocator(), [&] {
+        for (size_t i = 0; i < count; i++) {
+            small.push_back(make_managed<int64_t>());
+            large.push_back(make_managed<std::array<char, 100>>());
+        }
+    });
+    // The name of standard migrators.
+    std::string small_name = typeid(managed<int64_t>).name();
+    std::string large_name = typeid(managed<std::array<char, 100>>).name();
+
+    // Walking all segments counts all objects except those in the active segment.
+    auto sample = reg.sample_objects(std::numeric_limits<size_t>::max());
+    BOOST_REQUIRE(sample.sampled_segments > 0);
+    BOOST_REQUIRE_EQUAL(sample.occupancy.total_space(), reg.occupancy().total_space());
+    for (auto name : {small_name, large_name}) {
+        BOOST_REQUIRE(sample.types.contains(name));
+        BOOST_REQUIRE_LE(sample.types[name].count, count);
+        BOOST_REQUIRE_GT(sample.types[name].count, count * 9 / 10);
+    }
+    BOOST_REQUIRE_GT(sample.types[large_name].bytes, sample.types[small_name].bytes);
+
+    // Objects are spread evenly, so few segments give a close estimate.
+    auto estimate = reg.sample_objects(8);
+    BOOST_REQUIRE_LE(estimate.sampled_segments, 8u);
+    for (auto name : {small_name, large_name}) {
+        BOOST_REQUIRE_GT(estimate.types[name].count, count / 2);
+        BOOST_REQUIRE_LT(estimate.types[name].count, count * 2);
+    }
+
+    with_allocator(reg.allocator(), [&] {
+        small.clear();
+        large.clear();
+    });
+}
+
 SEASTAR_TEST_CASE(test_occupancy) {
     return seastar::async([] {
         region reg;
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "utils/loser_tree.hh"
+
+namespace {
+
+// A sorted stream, identified by its index, and its current value.
+struct stream_head {
+    size_t stream;
+    int value;
+};
+
+struct stream_head_less {
+    size_t* comparisons;
+
+    bool operator()(const stream_head& a, const stream_head& b) const {
+        ++*comparisons;
+        return a.value < b.value;
+    }
+};
+
+std::vector<std::vector<int>> make_streams(std::mt19937& rng, size_t n, size_t max_len) {
+    std::uniform_int_distribution<int> values(0, 1000);
+    std::uniform_int_distribution<size_t> lengths(0, max_len);
+    std::vector<std::vector<int>> streams(n);
+    for (auto& s : streams) {
+        s.resize(lengths(rng));
+        std::generate(s.begin(), s.end(), [&] { return values(rng); });
+        std::sort(s.begin(), s.end());
+    }
+    return streams;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_loser_tree_merge) {
+    std::mt19937 rng(std::random_device{}());
+    for (size_t n : {1, 2, 3, 7, 8, 9, 31, 64, 100}) {
+        auto streams = make_streams(rng, n, 50);
+        std::vector<int> expected;
+        for (auto& s : streams) {
+            expected.insert(expected.end(), s.begin(), s.end());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        size_t comparisons = 0;
+        utils::loser_tree<stream_head, stream_head_less> tree(stream_head_less{&comparisons});
+        tree.reset(n);
+        std::vector<size_t> pos(n, 0);
+        for (size_t i = 0; i < n; ++i) {
+            if (!streams[i].empty()) {
+                tree.push(stream_head{i, streams[i][pos[i]++]});
+            }
+        }
+
+        std::vector<int> merged;
+        while (!tree.empty()) {
+            auto& top = tree.top();
+            merged.push_back(top.value);
+            auto i = top.stream;
+            if (pos[i] < streams[i].size()) {
+                tree.replace_top(stream_head{i, streams[i][pos[i]++]});
+            } else {
+                tree.pop();
+            }
+        }
+        BOOST_REQUIRE(merged == expected);
+
+        // One replay per element, plus the initial one over all the matches.
+        auto depth = std::bit_width(tree.capacity()) - 1;
+        BOOST_REQUIRE_LE(comparisons, tree.capacity() + expected.size() * depth);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_loser_tree_push_pop) {
+    std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> values(0, 100);
+    size_t comparisons = 0;
+    utils::loser_tree<stream_head, stream_head_less> tree(stream_head_less{&comparisons});
+    std::multimap<int, size_t> reference;
+    size_t next_id = 0;
+
+    // Starts without capacity and grows on demand.
+    BOOST_REQUIRE_EQUAL(tree.capacity(), 0u);
+    for (int i = 0; i < 10000; ++i) {
+        auto op = values(rng);
+        if (reference.empty() || op < 40) {
+            auto v = values(rng);
+            tree.push(stream_head{next_id, v});
+            reference.emplace(v, next_id++);
+        } else if (op < 70) {
+            auto top = tree.pop();
+            BOOST_REQUIRE_EQUAL(top.value, reference.begin()->first);
+            auto it = std::find_if(reference.begin(), reference.end(), [&] (auto& e) { return e.second == top.stream; });
+            BOOST_REQUIRE(it != reference.end());
+            BOOST_REQUIRE_EQUAL(it->first, top.value);
+            reference.erase(it);
+        } else {
+            auto& top = tree.top();
+            BOOST_REQUIRE_EQUAL(top.value, reference.begin()->first);
+            auto it = std::find_if(reference.begin(), reference.end(), [&] (auto& e) { return e.second == top.stream; });
+            BOOST_REQUIRE(it != reference.end());
+            reference.erase(it);
+            auto v = values(rng);
+            tree.replace_top(stream_head{top.stream, v});
+            reference.emplace(v, top.stream);
+        }
+        BOOST_REQUIRE_EQUAL(tree.size(), reference.size());
+    }
+
+    size_t visited = 0;
+    tree.for_each([&] (stream_head& h) {
+        ++visited;
+        BOOST_REQUIRE(std::any_of(reference.begin(), reference.end(), [&] (auto& e) { return e.second == h.stream && e.first == h.value; }));
+    });
+    BOOST_REQUIRE_EQUAL(visited, reference.size());
+
+    tree.clear();
+    BOOST_REQUIRE(tree.empty());
+    tree.push(stream_head{0, 42});
+    BOOST_REQUIRE_EQUAL(tree.top().value, 42);
+}
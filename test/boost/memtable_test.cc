@@ -128,6 +128,44 @@ static future<> test_memtable(void (*run_tests)(populate_fn_ex, bool)) {
 }
 
 // plain
+SEASTAR_THREAD_TEST_CASE(test_memtable_appends_in_clustering_order) {
+    simple_schema s;
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto mt = make_lw_shared<replica::memtable>(s.schema());
+    auto pk = s.make_pkey();
+
+    // Mostly appends, with a few writes which land in the middle or overwrite.
+    mutation expected(s.schema(), pk);
+    auto apply = [&] (mutation m) {
+        expected.apply(m);
+        mt->apply(std::move(m));
+    };
+    for (int i = 0; i < 100; ++i) {
+        mutation m(s.schema(), pk);
+        s.add_row(m, s.make_ckey(i * 2), format("v{}", i));
+        if (i % 10 == 0) {
+            s.add_row(m, s.make_ckey(i * 2 + 1), "batch");
+        }
+        apply(std::move(m));
+        if (i % 25 == 24) {
+            mutation old(s.schema(), pk);
+            s.add_row(old, s.make_ckey(i), "overwrite");
+            s.add_row(old, s.make_ckey(i + 3), "middle");
+            apply(std::move(old));
+        }
+    }
+    mutation rt(s.schema(), pk);
+    s.delete_range(rt, s.make_ckey_range(190, 250));
+    apply(std::move(rt));
+    mutation after_rt(s.schema(), pk);
+    s.add_row(after_rt, s.make_ckey(300), "after");
+    apply(std::move(after_rt));
+
+    assert_that(mt->make_flat_reader(s.schema(), semaphore.make_permit()))
+        .produces(expected)
+        .produces_end_of_stream();
+}
+
 SEASTAR_TEST_CASE(test_memtable_with_many_versions_conforms_to_mutation_source_basic) {
     return test_memtable(run_mutation_source_tests_plain_basic);
 }
@@ -949,6 +987,32 @@ SEASTAR_THREAD_TEST_CASE(test_collecting_encoding_stats) {
     BOOST_CHECK(stats.min_ttl == md2_ttl);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_min_timestamp_of_partition) {
+    simple_schema ss;
+    auto s = ss.schema();
+    auto pkeys = ss.make_pkeys(3);
+
+    auto mt = make_lw_shared<replica::memtable>(s);
+    for (auto& pk : pkeys) {
+        BOOST_REQUIRE_EQUAL(mt->get_min_timestamp(pk), api::max_timestamp);
+    }
+
+    mutation m1(s, pkeys[0]);
+    ss.add_row(m1, ss.make_ckey(0), "v", 10);
+    mutation m2(s, pkeys[2]);
+    ss.add_row(m2, ss.make_ckey(0), "v", 20);
+    mt->apply(m1);
+    mt->apply(m2);
+
+    BOOST_REQUIRE_EQUAL(mt->get_min_timestamp(pkeys[0]), 10);
+    BOOST_REQUIRE_EQUAL(mt->get_min_timestamp(pkeys[1]), api::max_timestamp);
+    BOOST_REQUIRE_EQUAL(mt->get_min_timestamp(pkeys[2]), 10);
+
+    // The contents of a flushed memtable may be moved away at any time.
+    mt->mark_flushed(mt->as_data_source());
+    BOOST_REQUIRE_EQUAL(mt->get_min_timestamp(pkeys[1]), 10);
+}
+
 
 SEASTAR_TEST_CASE(memtable_flush_compresses_mutations) {
     auto db_config = make_shared<db::config>();
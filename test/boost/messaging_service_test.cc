@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/net/api.hh>
+
+#include <set>
+
+#include "message/messaging_service.hh"
+
+using namespace seastar;
+
+static const gms::inet_address local_ip("127.0.0.1");
+
+static bool is_shard_aware(uint16_t port) {
+    return port >= 49152 && port % smp::count == this_shard_id();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_shard_aware_local_address) {
+    smp::invoke_on_all([] {
+        unsigned next_slot = 0;
+        std::set<uint16_t> ports;
+        for (unsigned i = 0; i < 100; ++i) {
+            auto laddr = netw::messaging_service::shard_aware_local_address(local_ip, next_slot);
+            BOOST_REQUIRE(is_shard_aware(laddr.port()));
+            ports.insert(laddr.port());
+        }
+        // Consecutive connections come from different ports.
+        BOOST_REQUIRE_EQUAL(ports.size(), 100);
+        return make_ready_future<>();
+    }).get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_shard_aware_local_address_skips_ports_in_use) {
+    unsigned next_slot = 0;
+    auto first = netw::messaging_service::shard_aware_local_address(local_ip, next_slot);
+    auto occupied = seastar::listen(first);
+
+    next_slot = 0;
+    auto laddr = netw::messaging_service::shard_aware_local_address(local_ip, next_slot);
+    BOOST_REQUIRE(is_shard_aware(laddr.port()));
+    BOOST_REQUIRE_NE(laddr.port(), first.port());
+    BOOST_REQUIRE_EQUAL(next_slot, 2);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_shard_aware_local_address_falls_back_to_ephemeral_port) {
+    // Occupy every port the next call tries.
+    std::vector<server_socket> occupied;
+    unsigned next_slot = 0;
+    for (unsigned i = 0; i < 16; ++i) {
+        auto start = next_slot;
+        occupied.push_back(seastar::listen(netw::messaging_service::shard_aware_local_address(local_ip, next_slot)));
+        BOOST_REQUIRE_EQUAL(next_slot, start + 1);
+    }
+    next_slot = 0;
+    auto laddr = netw::messaging_service::shard_aware_local_address(local_ip, next_slot);
+    BOOST_REQUIRE_EQUAL(laddr.port(), 0);
+    BOOST_REQUIRE(gms::inet_address(laddr.addr()) == local_ip);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_shard_aware_local_address_not_local) {
+    // An address (from TEST-NET-1) which does not belong to this host can't be bound.
+    const gms::inet_address ip("192.0.2.1");
+    unsigned next_slot = 0;
+    auto laddr = netw::messaging_service::shard_aware_local_address(ip, next_slot);
+    BOOST_REQUIRE_EQUAL(laddr.port(), 0);
+    BOOST_REQUIRE(gms::inet_address(laddr.addr()) == ip);
+}
@@ -641,3 +641,47 @@ SEASTAR_THREAD_TEST_CASE(test_mutation_fragment_stream_validator_mixed_api_usage
     BOOST_REQUIRE(validator(dk0));
     BOOST_REQUIRE(!validator(dk0));
 }
+
+SEASTAR_THREAD_TEST_CASE(test_mutation_fragment_stream_validating_filter_sampled_clustering_key) {
+    simple_schema ss;
+    const auto& s = *ss.schema();
+
+    const auto dkeys = ss.make_pkeys(2);
+    const auto interval = mutation_fragment_stream_validating_filter::clustering_key_sample_interval;
+
+    using mf_kind = mutation_fragment_v2::kind;
+
+    auto validate_partition = [&] (mutation_fragment_stream_validating_filter& validator, const dht::decorated_key& dk, const std::vector<int>& cks) {
+        validator(dk);
+        validator(mf_kind::partition_start, position_in_partition_view::for_partition_start(), {});
+        for (auto ck : cks) {
+            validator(mf_kind::clustering_row, position_in_partition::for_key(ss.make_ckey(ck)), {});
+        }
+        validator.on_end_of_partition();
+    };
+
+    std::vector<int> ordered;
+    for (unsigned i = 0; i < 4 * interval; ++i) {
+        ordered.push_back(i);
+    }
+    {
+        mutation_fragment_stream_validating_filter validator(get_name(), s, mutation_fragment_stream_validation_level::sampled_clustering_key);
+        validate_partition(validator, dkeys[0], ordered);
+        validate_partition(validator, dkeys[1], ordered);
+        validator.on_end_of_stream();
+    }
+
+    // Partition keys are always validated
+    {
+        mutation_fragment_stream_validating_filter validator(get_name(), s, mutation_fragment_stream_validation_level::sampled_clustering_key);
+        validate_partition(validator, dkeys[1], {});
+        BOOST_REQUIRE_THROW(validate_partition(validator, dkeys[0], {}), invalid_mutation_fragment_stream);
+    }
+
+    // A sampled fragment is compared with the previously sampled one, so a
+    // stream in reverse order is caught, although not at its first fragment
+    {
+        mutation_fragment_stream_validating_filter validator(get_name(), s, mutation_fragment_stream_validation_level::sampled_clustering_key);
+        BOOST_REQUIRE_THROW(validate_partition(validator, dkeys[0], std::vector<int>(ordered.rbegin(), ordered.rend())), invalid_mutation_fragment_stream);
+    }
+}
@@ -14,6 +14,7 @@
 #include <boost/test/unit_test.hpp>
 #include "query-result-set.hh"
 #include "query-result-writer.hh"
+#include "query-result-columnar.hh"
 
 #include "test/lib/scylla_test_case.hh"
 #include <seastar/testing/thread_test_case.hh>
@@ -583,3 +584,84 @@ SEASTAR_THREAD_TEST_CASE(test_frozen_mutation_consumer) {
     const auto& rebuilt = *res.result;
     BOOST_REQUIRE_EQUAL(rebuilt, m);
 }
+
+static query::result make_data_query_result(schema_ptr s, reader_permit permit, const mutation_source& source, const query::partition_slice& slice) {
+    query::result::builder builder(slice, query::result_options::only_result(), make_accounter(), query::max_tombstones);
+    data_query(s, std::move(permit), source, query::full_partition_range, slice, builder);
+    return builder.build();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_columnar_result_round_trip) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    random_mutation_generator gen(random_mutation_generator::generate_counters::no);
+    schema_ptr s = gen.schema();
+    mutation_source source = make_source(gen(8));
+
+    for (auto send_metadata : {false, true}) {
+        query::partition_slice slice = make_full_slice(*s);
+        if (send_metadata) {
+            slice.options.set<query::partition_slice::option::send_timestamp>();
+            slice.options.set<query::partition_slice::option::send_expiry>();
+            slice.options.set<query::partition_slice::option::send_ttl>();
+        }
+        auto res = make_data_query_result(s, semaphore.make_permit(), source, slice);
+
+        auto encoded = query::encode_columnar(res).get();
+        BOOST_REQUIRE(encoded.row_count() == res.row_count());
+        BOOST_REQUIRE(encoded.partition_count() == res.partition_count());
+
+        auto decoded = query::decode_columnar(encoded).get();
+        BOOST_REQUIRE(decoded.buf() == res.buf());
+        BOOST_REQUIRE(decoded.row_count() == res.row_count());
+        BOOST_REQUIRE(decoded.partition_count() == res.partition_count());
+        BOOST_REQUIRE(query::result_set::from_raw_result(s, slice, decoded) == query::result_set::from_raw_result(s, slice, res));
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_columnar_result_is_smaller_for_repeated_values) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto s = make_schema();
+
+    mutation m(s, partition_key::from_single_value(*s, "key1"));
+    m.set_static_cell("s1", data_value(bytes("static")), 1);
+    for (int i = 0; i < 1000; ++i) {
+        auto ck = clustering_key::from_single_value(*s, to_bytes(fmt::format("{:04d}", i)));
+        m.set_clustered_cell(ck, "v1", data_value(bytes(i % 2 ? "odd" : "even")), 1);
+        if (i % 3 == 0) {
+            m.set_clustered_cell(ck, "v2", data_value(to_bytes(fmt::format("value-{}", i))), 1);
+        }
+    }
+    auto slice = make_full_slice(*s);
+    auto res = make_data_query_result(s, semaphore.make_permit(), make_source({m}), slice);
+
+    auto encoded = query::encode_columnar(res).get();
+    BOOST_REQUIRE_LT(encoded.buf().size(), res.buf().size() / 2);
+
+    auto decoded = query::decode_columnar(encoded).get();
+    BOOST_REQUIRE(decoded.buf() == res.buf());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_columnar_result_with_large_values) {
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto s = make_schema();
+
+    // Values larger than a fragment, both distinct and repeated, so that the
+    // plain and the dictionary encodings see fragmented values.
+    auto large = [] (char c, size_t size) {
+        return bytes(size, int8_t(c));
+    };
+    mutation m(s, partition_key::from_single_value(*s, "key1"));
+    m.set_static_cell("s1", data_value(large('s', 300 * 1024)), 1);
+    for (int i = 0; i < 8; ++i) {
+        auto ck = clustering_key::from_single_value(*s, to_bytes(fmt::format("{:04d}", i)));
+        m.set_clustered_cell(ck, "v1", data_value(large('a' + i, 200 * 1024)), 1);
+        m.set_clustered_cell(ck, "v2", data_value(large('x', 150 * 1024)), 1);
+    }
+    auto slice = make_full_slice(*s);
+    auto res = make_data_query_result(s, semaphore.make_permit(), make_source({m}), slice);
+
+    auto encoded = query::encode_columnar(res).get();
+    auto decoded = query::decode_columnar(encoded).get();
+    BOOST_REQUIRE(decoded.buf() == res.buf());
+    BOOST_REQUIRE(query::result_set::from_raw_result(s, slice, decoded) == query::result_set::from_raw_result(s, slice, res));
+}
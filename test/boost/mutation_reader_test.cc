@@ -16,6 +16,7 @@
 #include <seastar/core/thread.hh>
 #include <seastar/core/coroutine.hh>
 #include <seastar/util/closeable.hh>
+#include <seastar/util/defer.hh>
 
 #include "sstables/generation_type.hh"
 #include "test/lib/scylla_test_case.hh"
@@ -44,9 +45,11 @@
 #include "partition_slice_builder.hh"
 #include "schema/schema_registry.hh"
 #include "utils/ranges.hh"
+#include "utils/error_injection.hh"
 #include "mutation/mutation_rebuilder.hh"
 
 #include <boost/range/algorithm/sort.hpp>
+#include <boost/range/adaptor/filtered.hpp>
 #include "readers/from_mutations_v2.hh"
 #include "readers/forwardable_v2.hh"
 #include "readers/from_fragments_v2.hh"
@@ -231,6 +234,50 @@ SEASTAR_THREAD_TEST_CASE(combined_reader_galloping_changing_multiple_partitions_
         .produces_end_of_stream();
 }
 
+SEASTAR_THREAD_TEST_CASE(combined_reader_many_readers_test) {
+    // Merges with the loser tree, where error injections are supported.
+    utils::get_local_injector().enable("combined_reader_fragment_tree");
+    auto disable_tree = defer([] { utils::get_local_injector().disable("combined_reader_fragment_tree"); });
+
+    simple_schema s;
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto permit = semaphore.make_permit();
+
+    const auto k = s.make_pkeys(3);
+    const int readers = 12;
+    const int rows = 100;
+
+    // Every reader has every other row of its share of the partitions, so that
+    // rows are both interleaved across all readers, and present in two of them.
+    std::vector<flat_mutation_reader_v2> v;
+    for (int r = 0; r < readers; ++r) {
+        std::vector<mutation> muts;
+        for (int p = 0; p < 3; ++p) {
+            if ((r + p) % 4 == 3) {
+                continue;
+            }
+            auto ckeys = boost::irange(0, rows) | boost::adaptors::filtered([&] (int i) {
+                return i % readers == r || (i + 1) % readers == r;
+            });
+            muts.push_back(make_partition_with_clustering_rows(s, k[p], ckeys));
+        }
+        v.push_back(make_flat_mutation_reader_from_mutations_v2(s.schema(), permit, std::move(muts)));
+    }
+    auto rd = assert_that(make_combined_reader(s.schema(), permit, std::move(v), streamed_mutation::forwarding::no, mutation_reader::forwarding::no));
+    for (int p = 0; p < 3; ++p) {
+        auto ckeys = boost::irange(0, rows) | boost::adaptors::filtered([&] (int i) {
+            for (int r = 0; r < readers; ++r) {
+                if ((r + p) % 4 != 3 && (i % readers == r || (i + 1) % readers == r)) {
+                    return true;
+                }
+            }
+            return false;
+        });
+        rd.produces(make_partition_with_clustering_rows(s, k[p], ckeys));
+    }
+    rd.produces_end_of_stream();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_combined_reader_range_tombstone_change_merging) {
     simple_schema s;
     const auto schema = s.schema();
@@ -1225,6 +1272,12 @@ SEASTAR_TEST_CASE(test_combined_mutation_source_is_a_mutation_source) {
         run_mutation_source_tests(make_combined_populator(1));
         run_mutation_source_tests(make_combined_populator(2));
         run_mutation_source_tests(make_combined_populator(3));
+        // Enough sources for the merger to use its loser tree, where error
+        // injections are supported.
+        run_mutation_source_tests(make_combined_populator(10));
+        utils::get_local_injector().enable("combined_reader_fragment_tree");
+        auto disable_tree = defer([] { utils::get_local_injector().disable("combined_reader_fragment_tree"); });
+        run_mutation_source_tests(make_combined_populator(10));
     });
 }
 
@@ -394,6 +394,44 @@ SEASTAR_THREAD_TEST_CASE(test_udt_mutations) {
     });
 }
 
+SEASTAR_TEST_CASE(test_merge_collection_mutations_with_disjoint_keys) {
+    auto map_type = map_type_impl::get_instance(int32_type, utf8_type, true);
+    auto serialize = [&] (tombstone t, std::vector<std::pair<int32_t, sstring>> entries) {
+        collection_mutation_description m;
+        m.tomb = t;
+        for (auto& [k, v] : entries) {
+            m.cells.emplace_back(int32_type->decompose(k), make_collection_member(utf8_type, v));
+        }
+        return m.serialize(*map_type);
+    };
+    auto check_merge = [&] (const collection_mutation& a, const collection_mutation& b, const collection_mutation& expected) {
+        BOOST_REQUIRE(merge(*map_type, a, b)._data == expected._data);
+        BOOST_REQUIRE(merge(*map_type, b, a)._data == expected._data);
+    };
+
+    auto head = serialize({}, {{1, "a"}, {2, "b"}});
+    auto tail = serialize({}, {{3, "c"}, {4, "d"}});
+    auto empty = serialize({}, {});
+
+    // Appends, in either order, are spliced.
+    check_merge(head, tail, serialize({}, {{1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}}));
+    check_merge(head, empty, head);
+
+    // The merged tombstone is the later one.
+    auto older = tombstone(-1, gc_clock::now());
+    check_merge(serialize(older, {{1, "a"}}), tail, serialize(older, {{1, "a"}, {3, "c"}, {4, "d"}}));
+
+    // A tombstone covering cells of the other side must still drop them.
+    auto t = tombstone(0, gc_clock::now());
+    check_merge(head, serialize(t, {{3, "c"}}), serialize(t, {{3, "c"}}));
+
+    // Interleaved keys go through the general merge.
+    check_merge(head, serialize({}, {{0, "z"}, {2, "x"}, {5, "y"}}),
+            serialize({}, {{0, "z"}, {1, "a"}, {2, "x"}, {5, "y"}}));
+
+    return make_ready_future<>();
+}
+
 // Verify that serializing and unserializing a large collection doesn't
 // trigger any large allocations.
 // We create a 8MB collection, composed of key/value pairs of varying
@@ -1352,13 +1390,15 @@ SEASTAR_TEST_CASE(test_query_digest) {
         auto check_digests_equal = [now] (const mutation& m1, const mutation& m2) {
             auto ps1 = partition_slice_builder(*m1.schema()).build();
             auto ps2 = partition_slice_builder(*m2.schema()).build();
-            auto digest1 = *query_mutation(mutation(m1), ps1, query::max_rows, now,
-                    query::result_options::only_digest(query::digest_algorithm::xxHash)).digest();
-            auto digest2 = *query_mutation( mutation(m2), ps2, query::max_rows, now,
-                    query::result_options::only_digest(query::digest_algorithm::xxHash)).digest();
-
-            if (digest1 != digest2) {
-                BOOST_FAIL(format("Digest should be the same for {} and {}", m1, m2));
+            for (auto da : {query::digest_algorithm::xxHash, query::digest_algorithm::xxHash_of_versions}) {
+                auto digest1 = *query_mutation(mutation(m1), ps1, query::max_rows, now,
+                        query::result_options::only_digest(da)).digest();
+                auto digest2 = *query_mutation( mutation(m2), ps2, query::max_rows, now,
+                        query::result_options::only_digest(da)).digest();
+
+                if (digest1 != digest2) {
+                    BOOST_FAIL(format("Digest ({}) should be the same for {} and {}", int(da), m1, m2));
+                }
             }
         };
 
@@ -2949,6 +2989,25 @@ SEASTAR_THREAD_TEST_CASE(test_appending_hash_row_4567) {
     // Legacy check which shows incorrect handling of NULL values.
     // These checks are meaningful because legacy hashing is still used for old nodes.
     BOOST_CHECK_EQUAL(compute_legacy_hash(r1, { 0, 1, 2 }), compute_legacy_hash(r2, { 0, 1, 2 }));
+
+    auto compute_version_hash = [&] (const row& r, const query::column_id_vector& columns) {
+        auto hasher = xx_version_hasher{};
+        max_timestamp ts;
+        appending_hash<row>{}(hasher, r, *s, column_kind::regular_column, columns, ts);
+        return hasher.finalize_uint64();
+    };
+    // Values of the same size with the same timestamp are not told apart...
+    BOOST_CHECK_EQUAL(compute_version_hash(r1, { 0, 1, 2 }), compute_version_hash(r2, { 0, 1, 2 }));
+    BOOST_CHECK_NE(compute_version_hash(r2, { 0, 1, 2 }), compute_version_hash(r3, { 0, 1, 2 }));
+    // ...but different timestamps or sizes are.
+    auto r4 = row();
+    r4.append_cell(0, atomic_cell::make_live(*bytes_type, 1, bytes{}));
+    r4.append_cell(2, atomic_cell::make_live(*bytes_type, 2, to_bytes("aaa")));
+    BOOST_CHECK_NE(compute_version_hash(r1, { 0, 1, 2 }), compute_version_hash(r4, { 0, 1, 2 }));
+    auto r5 = row();
+    r5.append_cell(0, atomic_cell::make_live(*bytes_type, 1, bytes{}));
+    r5.append_cell(2, atomic_cell::make_live(*bytes_type, 1, to_bytes("aaaa")));
+    BOOST_CHECK_NE(compute_version_hash(r1, { 0, 1, 2 }), compute_version_hash(r5, { 0, 1, 2 }));
 }
 
 SEASTAR_THREAD_TEST_CASE(test_mutation_consume) {
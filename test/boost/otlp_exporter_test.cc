@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "tracing/otlp_exporter.hh"
+#include "utils/fb_utilities.hh"
+#include "utils/UUID.hh"
+
+using namespace std::chrono_literals;
+using tracing::otlp::parse_collector_address;
+
+namespace {
+
+constexpr uint16_t default_port = tracing::otlp_exporter::default_port;
+
+void check_address(std::string_view address, sstring host, uint16_t port, sstring authority) {
+    BOOST_TEST_MESSAGE(address);
+    auto parsed = parse_collector_address(address, default_port);
+    BOOST_REQUIRE_EQUAL(parsed.host, host);
+    BOOST_REQUIRE_EQUAL(parsed.port, port);
+    BOOST_REQUIRE_EQUAL(parsed.authority(), authority);
+}
+
+const rjson::value* find_attribute(const rjson::value& span, std::string_view key) {
+    for (const auto& attr : span["attributes"].GetArray()) {
+        if (rjson::to_string_view(attr["key"]) == key) {
+            return &attr["value"];
+        }
+    }
+    return nullptr;
+}
+
+std::string_view string_attribute(const rjson::value& span, std::string_view key) {
+    auto value = find_attribute(span, key);
+    BOOST_REQUIRE(value);
+    return rjson::to_string_view((*value)["stringValue"]);
+}
+
+std::string_view int_attribute(const rjson::value& span, std::string_view key) {
+    auto value = find_attribute(span, key);
+    BOOST_REQUIRE(value);
+    return rjson::to_string_view((*value)["intValue"]);
+}
+
+std::string nanos(std::chrono::system_clock::time_point tp) {
+    return fmt::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count());
+}
+
+const auto session_id = utils::UUID(0x0123456789abcdefL, 0x00000000000000ffL);
+const auto started_at = std::chrono::system_clock::time_point(1700000000s);
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_parse_collector_address) {
+    check_address("collector", "collector", default_port, "collector:4318");
+    check_address("collector:1234", "collector", 1234, "collector:1234");
+    check_address("10.0.0.1", "10.0.0.1", default_port, "10.0.0.1:4318");
+    check_address("10.0.0.1:80", "10.0.0.1", 80, "10.0.0.1:80");
+    check_address("[::1]:4317", "::1", 4317, "[::1]:4317");
+    check_address("[fe80::1]", "fe80::1", default_port, "[fe80::1]:4318");
+    // Without brackets, all of an IPv6 address is the host.
+    check_address("fe80::1", "fe80::1", default_port, "[fe80::1]:4318");
+    check_address("2001:db8::8:800:200c:417a", "2001:db8::8:800:200c:417a", default_port, "[2001:db8::8:800:200c:417a]:4318");
+
+    for (auto address : {"", ":4318", "collector:", "collector:abc", "collector:12ab", "collector:0", "collector:65536",
+            "collector:-1", "[::1", "[::1]4318", "[::1]:", "[]:4318"}) {
+        BOOST_TEST_MESSAGE(address);
+        BOOST_REQUIRE_THROW(parse_collector_address(address, default_port), std::invalid_argument);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_coordinator_span) {
+    utils::fb_utilities::set_broadcast_address(gms::inet_address("10.0.0.1"));
+    tracing::session_record session(tracing::trace_type::QUERY, 0s);
+    session.request = "Execute CQL3 query";
+    session.client = gms::inet_address("10.0.0.2");
+    session.username = "alice";
+    session.request_size = 10;
+    session.response_size = 20;
+    session.started_at = started_at;
+    session.elapsed = 1500us;
+    session.tables = {"ks.t1", "ks.t2"};
+    session.parameters = {{"query", "SELECT * FROM ks.t1"}};
+    std::deque<tracing::event_record> events;
+    events.emplace_back("Parsing a statement", 100us, started_at + 100us);
+    events.emplace_back("Done processing", 1400us, started_at + 1400us);
+
+    auto span = tracing::otlp::make_span(session_id, tracing::span_id(), tracing::span_id(0xabc), session, true, std::move(events));
+
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["traceId"]), "0123456789abcdef00000000000000ff");
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["spanId"]), "0000000000000abc");
+    BOOST_REQUIRE(!rjson::find(span, "parentSpanId"));
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["name"]), "Execute CQL3 query");
+    BOOST_REQUIRE_EQUAL(span["kind"].GetInt(), 2);
+    // Timestamps are int64 values, so they are encoded as strings.
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["startTimeUnixNano"]), nanos(started_at));
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["endTimeUnixNano"]), nanos(started_at + 1500us));
+
+    BOOST_REQUIRE_EQUAL(string_attribute(span, "scylla.command"), "QUERY");
+    BOOST_REQUIRE_EQUAL(string_attribute(span, "client.address"), "10.0.0.2");
+    BOOST_REQUIRE_EQUAL(string_attribute(span, "db.user"), "alice");
+    BOOST_REQUIRE_EQUAL(int_attribute(span, "scylla.request_size"), "10");
+    BOOST_REQUIRE_EQUAL(int_attribute(span, "scylla.response_size"), "20");
+    BOOST_REQUIRE_EQUAL(string_attribute(span, "db.sql.table"), "ks.t1,ks.t2");
+    BOOST_REQUIRE_EQUAL(string_attribute(span, "scylla.parameter.query"), "SELECT * FROM ks.t1");
+    BOOST_REQUIRE_EQUAL(string_attribute(span, "scylla.slow_query"), "true");
+    BOOST_REQUIRE_EQUAL(string_attribute(span, "net.host.name"), "10.0.0.1");
+    BOOST_REQUIRE_EQUAL(int_attribute(span, "scylla.shard"), fmt::to_string(this_shard_id()));
+
+    const auto& span_events = span["events"];
+    BOOST_REQUIRE_EQUAL(span_events.Size(), 2);
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span_events[0]["name"]), "Parsing a statement");
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span_events[0]["timeUnixNano"]), nanos(started_at + 100us));
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span_events[1]["name"]), "Done processing");
+}
+
+SEASTAR_THREAD_TEST_CASE(test_replica_span) {
+    utils::fb_utilities::set_broadcast_address(gms::inet_address("10.0.0.3"));
+    // The session record of a replica is never completed.
+    tracing::session_record session(tracing::trace_type::QUERY, 0s);
+    std::deque<tracing::event_record> events;
+    events.emplace_back("Querying", 200us, started_at + 1000us);
+    events.emplace_back("Querying done", 500us, started_at + 1300us);
+
+    auto span = tracing::otlp::make_span(session_id, tracing::span_id(0xabc), tracing::span_id(0xdef), session, false, std::move(events));
+
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["traceId"]), "0123456789abcdef00000000000000ff");
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["spanId"]), "0000000000000def");
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["parentSpanId"]), "0000000000000abc");
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["name"]), "replica");
+    BOOST_REQUIRE_EQUAL(span["kind"].GetInt(), 1);
+    // The span starts when the session started, as told by the first event.
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["startTimeUnixNano"]), nanos(started_at + 800us));
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(span["endTimeUnixNano"]), nanos(started_at + 1300us));
+    BOOST_REQUIRE(!find_attribute(span, "scylla.command"));
+    BOOST_REQUIRE(!find_attribute(span, "scylla.slow_query"));
+    BOOST_REQUIRE_EQUAL(string_attribute(span, "net.host.name"), "10.0.0.3");
+    BOOST_REQUIRE_EQUAL(span["events"].Size(), 2);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_export_request) {
+    std::deque<rjson::value> spans;
+    for (auto name : {"first", "second"}) {
+        auto span = rjson::empty_object();
+        rjson::add(span, "name", rjson::from_string(name));
+        spans.push_back(std::move(span));
+    }
+
+    auto body = tracing::otlp::make_export_request(std::move(spans));
+
+    const auto& resource_spans = body["resourceSpans"];
+    BOOST_REQUIRE_EQUAL(resource_spans.Size(), 1);
+    const auto& resource_attributes = resource_spans[0]["resource"]["attributes"];
+    BOOST_REQUIRE_EQUAL(resource_attributes.Size(), 1);
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(resource_attributes[0]["key"]), "service.name");
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(resource_attributes[0]["value"]["stringValue"]), "scylla");
+    const auto& scope_spans = resource_spans[0]["scopeSpans"];
+    BOOST_REQUIRE_EQUAL(scope_spans.Size(), 1);
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(scope_spans[0]["scope"]["name"]), "scylla.tracing");
+    const auto& exported = scope_spans[0]["spans"];
+    BOOST_REQUIRE_EQUAL(exported.Size(), 2);
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(exported[0]["name"]), "first");
+    BOOST_REQUIRE_EQUAL(rjson::to_string_view(exported[1]["name"]), "second");
+
+    // The body survives a round trip through its JSON text.
+    auto parsed = rjson::parse(rjson::print(body));
+    BOOST_REQUIRE_EQUAL(rjson::print(parsed), rjson::print(body));
+}
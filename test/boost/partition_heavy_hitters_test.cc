@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/test_case.hh>
+
+#include "db/partition_heavy_hitters.hh"
+
+using namespace seastar;
+
+SEASTAR_TEST_CASE(test_heavy_hitters_by_operations) {
+    db::partition_heavy_hitters hh;
+
+    for (int64_t token = 0; token < 1000; token++) {
+        hh.record(token, 10);
+    }
+    for (int i = 0; i < 100; i++) {
+        hh.record(-1, 10);
+        if (i % 2) {
+            hh.record(-2, 10);
+        }
+    }
+
+    auto top = hh.top(2);
+    BOOST_REQUIRE_EQUAL(top.size(), 2);
+    BOOST_REQUIRE_EQUAL(top[0].token, -1);
+    BOOST_REQUIRE_GE(top[0].operations, 100);
+    BOOST_REQUIRE_EQUAL(top[1].token, -2);
+    BOOST_REQUIRE_GE(top[1].operations, 50);
+    BOOST_REQUIRE_LT(top[1].operations, top[0].operations);
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_heavy_hitters_by_bytes) {
+    db::partition_heavy_hitters hh;
+
+    for (int i = 0; i < 10; i++) {
+        hh.record(1, 10);
+    }
+    hh.record(2, 1 << 20);
+
+    auto top = hh.top(10);
+    BOOST_REQUIRE_EQUAL(top.size(), 2);
+    BOOST_REQUIRE_EQUAL(top[0].token, 1);
+    BOOST_REQUIRE_EQUAL(top[0].operations, 10);
+    BOOST_REQUIRE_EQUAL(top[0].bytes, 100);
+    BOOST_REQUIRE_EQUAL(top[1].token, 2);
+    BOOST_REQUIRE_EQUAL(top[1].operations, 1);
+    BOOST_REQUIRE_EQUAL(top[1].bytes, 1 << 20);
+    return make_ready_future<>();
+}
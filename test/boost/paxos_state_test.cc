@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "test/lib/scylla_test_case.hh"
+#include "test/lib/cql_test_env.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "db/config.hh"
+#include "db/system_keyspace.hh"
+#include "replica/database.hh"
+#include "service/paxos/paxos_state.hh"
+
+using namespace std::chrono_literals;
+using service::paxos::paxos_state;
+
+static shared_ptr<db::config> make_config(uint32_t cache_size) {
+    auto cfg = make_shared<db::config>();
+    cfg->paxos_state_cache_size.set(cache_size);
+    return cfg;
+}
+
+static partition_key make_key(schema_ptr s, int32_t pk) {
+    return partition_key::from_single_value(*s, int32_type->decompose(pk));
+}
+
+// Runs func on the shard which owns the partition, with the table's schema there.
+template <typename Func>
+static auto on_owner(cql_test_env& e, int32_t pk, Func func) {
+    auto s = e.local_db().find_schema("ks", "t");
+    auto shard = s->get_sharder().shard_of(dht::get_token(*s, make_key(s, pk)));
+    return e.db().invoke_on(shard, [&sys_ks = e.get_system_keyspace(), pk, func = std::move(func)] (replica::database& db) mutable {
+        auto s = db.find_schema("ks", "t");
+        return func(sys_ks.local(), s, make_key(s, pk));
+    }).get();
+}
+
+static bool equal(schema_ptr s, const std::optional<service::paxos::proposal>& a, const std::optional<service::paxos::proposal>& b) {
+    if (!a || !b) {
+        return !a && !b;
+    }
+    return a->ballot == b->ballot && a->update.unfreeze(s) == b->update.unfreeze(s);
+}
+
+static bool equal(schema_ptr s, const paxos_state& a, const paxos_state& b) {
+    return a.promised_ballot() == b.promised_ballot()
+            && equal(s, a.accepted_proposal(), b.accepted_proposal())
+            && equal(s, a.most_recent_commit(), b.most_recent_commit());
+}
+
+// Checks that the state of the partition is cached, and that it is the one in system.paxos.
+static void require_coherent(cql_test_env& e, int32_t pk) {
+    on_owner(e, pk, [] (db::system_keyspace& sys_ks, schema_ptr s, partition_key key) -> future<> {
+        // Prune runs in the background of the LWT which triggered it. Retry
+        // until the state doesn't change while it is read from the table.
+        while (true) {
+            auto cached = paxos_state::get_cached_state(*s, key);
+            BOOST_REQUIRE(cached);
+            auto stored = co_await sys_ks.load_paxos_state(key, s, gc_clock::now(), db::timeout_clock::now() + 10s);
+            auto cached_after = paxos_state::get_cached_state(*s, key);
+            BOOST_REQUIRE(cached_after);
+            if (equal(s, *cached, *cached_after)) {
+                BOOST_REQUIRE(equal(s, *cached, stored));
+                co_return;
+            }
+        }
+    });
+}
+
+static size_t total_cache_size() {
+    return smp::map_reduce0([] { return paxos_state::state_cache_size(); }, size_t(0), std::plus<size_t>()).get();
+}
+
+SEASTAR_TEST_CASE(test_paxos_state_cache_coherent_after_learn) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.t (pk int PRIMARY KEY, v int)").get();
+
+        e.execute_cql("INSERT INTO ks.t (pk, v) VALUES (1, 1) IF NOT EXISTS").get();
+        require_coherent(e, 1);
+        on_owner(e, 1, [] (db::system_keyspace&, schema_ptr s, partition_key key) {
+            BOOST_REQUIRE(paxos_state::get_cached_state(*s, key)->most_recent_commit());
+            return make_ready_future<>();
+        });
+
+        e.execute_cql("UPDATE ks.t SET v = 2 WHERE pk = 1 IF v = 1").get();
+        require_coherent(e, 1);
+
+        // A round whose condition fails only saves a promise.
+        e.execute_cql("UPDATE ks.t SET v = 3 WHERE pk = 1 IF v = 1").get();
+        require_coherent(e, 1);
+    }, cql_test_config(make_config(100)));
+}
+
+SEASTAR_TEST_CASE(test_paxos_state_cache_coherent_after_prune) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.t (pk int PRIMARY KEY, v int)").get();
+        e.execute_cql("INSERT INTO ks.t (pk, v) VALUES (1, 1) IF NOT EXISTS").get();
+
+        on_owner(e, 1, [] (db::system_keyspace& sys_ks, schema_ptr s, partition_key key) -> future<> {
+            auto ballot = paxos_state::get_cached_state(*s, key)->most_recent_commit()->ballot;
+            co_await paxos_state::prune(sys_ks, s, key, ballot, db::timeout_clock::now() + 10s, nullptr);
+        });
+        require_coherent(e, 1);
+
+        e.execute_cql("UPDATE ks.t SET v = 2 WHERE pk = 1 IF v = 1").get();
+        require_coherent(e, 1);
+    }, cql_test_config(make_config(100)));
+}
+
+SEASTAR_TEST_CASE(test_paxos_state_cache_coherent_after_truncate) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.t (pk int PRIMARY KEY, v int)").get();
+        e.execute_cql("INSERT INTO ks.t (pk, v) VALUES (1, 1) IF NOT EXISTS").get();
+        require_coherent(e, 1);
+
+        replica::database::truncate_table_on_all_shards(e.db(), e.get_system_keyspace(),
+                db::system_keyspace::NAME, db::system_keyspace::PAXOS, std::nullopt, false /* with_snapshot */).get();
+
+        // The cached state, with its decision, is gone together with the one in the table.
+        e.execute_cql("UPDATE ks.t SET v = 2 WHERE pk = 1 IF v = 0").get();
+        require_coherent(e, 1);
+        on_owner(e, 1, [] (db::system_keyspace&, schema_ptr s, partition_key key) {
+            BOOST_REQUIRE(!paxos_state::get_cached_state(*s, key)->most_recent_commit());
+            return make_ready_future<>();
+        });
+    }, cql_test_config(make_config(100)));
+}
+
+SEASTAR_TEST_CASE(test_paxos_state_cache_size) {
+    auto cfg = make_config(2);
+    return do_with_cql_env_thread([cfg = cfg.get()] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.t (pk int PRIMARY KEY, v int)").get();
+
+        BOOST_REQUIRE_EQUAL(total_cache_size(), 0);
+        auto memory_usage = [] {
+            return smp::map_reduce0([] { return paxos_state::state_cache_memory_usage(); }, size_t(0), std::plus<size_t>()).get();
+        };
+        BOOST_REQUIRE_EQUAL(memory_usage(), 0);
+
+        for (int32_t pk = 0; pk < 10; ++pk) {
+            e.execute_cql(format("INSERT INTO ks.t (pk, v) VALUES ({}, {}) IF NOT EXISTS", pk, pk)).get();
+        }
+        auto size = total_cache_size();
+        BOOST_REQUIRE_GT(size, 0);
+        BOOST_REQUIRE_LE(size, 2 * smp::count);
+        BOOST_REQUIRE_GT(memory_usage(), 0);
+
+        // Disabling the cache drops everything right away.
+        smp::invoke_on_all([cfg] {
+            cfg->paxos_state_cache_size.set(0);
+        }).get();
+        BOOST_REQUIRE_EQUAL(total_cache_size(), 0);
+        BOOST_REQUIRE_EQUAL(memory_usage(), 0);
+
+        e.execute_cql("UPDATE ks.t SET v = 1 WHERE pk = 0 IF v = 0").get();
+        BOOST_REQUIRE_EQUAL(total_cache_size(), 0);
+    }, cql_test_config(cfg));
+}
@@ -341,6 +341,16 @@ class test_querier_cache {
         return *this;
     }
 
+    test_querier_cache& enable_prefetch() {
+        _cache.set_prefetch_enabled(utils::updateable_value<bool>(true));
+        return *this;
+    }
+
+    test_querier_cache& prefetches() {
+        BOOST_REQUIRE_EQUAL(_cache.get_stats().prefetches, ++_expected_stats.prefetches);
+        return *this;
+    }
+
     test_querier_cache& no_misses() {
         BOOST_REQUIRE_EQUAL(_cache.get_stats().misses, _expected_stats.misses);
         return *this;
@@ -390,6 +400,25 @@ SEASTAR_THREAD_TEST_CASE(lookup_with_wrong_key_misses) {
         .no_evictions();
 }
 
+SEASTAR_THREAD_TEST_CASE(lookup_prefetched_querier) {
+    test_querier_cache t;
+    t.enable_prefetch();
+
+    const auto data_entry = t.produce_first_page_and_save_data_querier(1);
+    t.prefetches();
+    t.assert_cache_lookup_data_querier(data_entry.key, *t.get_schema(), data_entry.expected_range, data_entry.expected_slice)
+        .no_misses()
+        .no_drops()
+        .no_evictions();
+
+    const auto mutation_entry = t.produce_first_page_and_save_mutation_querier(2);
+    t.prefetches();
+    t.assert_cache_lookup_mutation_querier(mutation_entry.key, *t.get_schema(), mutation_entry.expected_range, mutation_entry.expected_slice)
+        .no_misses()
+        .no_drops()
+        .no_evictions();
+}
+
 SEASTAR_THREAD_TEST_CASE(lookup_data_querier_as_mutation_querier_misses) {
     test_querier_cache t;
 
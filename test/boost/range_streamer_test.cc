@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "dht/range_streamer.hh"
+#include "locator/token_metadata.hh"
+#include "replica/database.hh"
+#include "streaming/stream_manager.hh"
+#include "utils/fb_utilities.hh"
+
+using inet_address = gms::inet_address;
+using ranges_per_source_map = std::unordered_map<inet_address, dht::token_range_vector>;
+using sources_for_range_map = std::unordered_map<dht::token_range, std::vector<inet_address>>;
+
+class range_streamer_test {
+public:
+    static ranges_per_source_map get_range_fetch_map(dht::range_streamer& rs, const sources_for_range_map& ranges_with_sources,
+            const sstring& keyspace, sources_for_range_map& sources_for_range) {
+        return rs.get_range_fetch_map(ranges_with_sources, rs._source_filters, keyspace, sources_for_range);
+    }
+
+    static void set_sources_for_range(dht::range_streamer& rs, const sstring& keyspace, sources_for_range_map sources_for_range) {
+        rs._sources_for_range[keyspace] = std::move(sources_for_range);
+    }
+
+    static dht::token_range_vector steal_ranges(dht::range_streamer& rs, const sstring& keyspace, inet_address thief, ranges_per_source_map& ranges_per_source) {
+        return rs.steal_ranges(keyspace, thief, ranges_per_source);
+    }
+
+    static void stream_ranges_from(dht::range_streamer& rs, const sstring& keyspace, inet_address source, ranges_per_source_map& ranges_per_source,
+            double fraction, noncopyable_function<void (const dht::token_range_vector&)> do_streaming) {
+        size_t nr_ranges_total = ranges_per_source[source].size();
+        rs.stream_ranges_from(keyspace, source, ranges_per_source, fraction, nr_ranges_total, std::move(do_streaming));
+    }
+};
+
+namespace {
+
+const sstring ks_name = "ks";
+
+// The local node and e1, e2 are in dc1, e3 is in dc2.
+const auto e0 = inet_address("192.168.0.1");
+const auto e1 = inet_address("192.168.0.2");
+const auto e2 = inet_address("192.168.0.3");
+const auto e3 = inet_address("192.168.0.4");
+
+locator::endpoint_dc_rack get_dc_rack(inet_address ep) {
+    return {
+        .dc = ep == e3 ? "dc2" : "dc1",
+        .rack = "rack1"
+    };
+}
+
+dht::token_range make_range(int64_t i) {
+    return dht::token_range::make({dht::token::from_int64(i * 10), false}, {dht::token::from_int64(i * 10 + 10), true});
+}
+
+dht::token_range_vector make_ranges(int64_t first, int64_t last) {
+    dht::token_range_vector ranges;
+    for (auto i = first; i <= last; ++i) {
+        ranges.push_back(make_range(i));
+    }
+    return ranges;
+}
+
+// The streamer never reaches the database or the stream manager in these tests.
+struct streamer_env {
+    sharded<replica::database> db;
+    sharded<streaming::stream_manager> sm;
+    abort_source as;
+    std::unique_ptr<dht::range_streamer> streamer;
+
+    streamer_env() {
+        utils::fb_utilities::set_broadcast_address(e0);
+        auto tmptr = make_lw_shared<locator::token_metadata>(locator::token_metadata::config{
+            locator::topology::config{
+                .this_endpoint = e0,
+                .local_dc_rack = get_dc_rack(e0)
+            }
+        });
+        for (auto ep : {e0, e1, e2, e3}) {
+            tmptr->update_topology(ep, get_dc_rack(ep));
+        }
+        streamer = std::make_unique<dht::range_streamer>(db, sm, std::move(tmptr), as, e0, get_dc_rack(e0), "Bootstrap", streaming::stream_reason::bootstrap);
+    }
+};
+
+template <typename Container>
+std::unordered_set<dht::token_range> to_set(const Container& ranges) {
+    return std::unordered_set<dht::token_range>(ranges.begin(), ranges.end());
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_get_range_fetch_map) {
+    streamer_env env;
+    auto r = make_ranges(0, 3);
+    sources_for_range_map ranges_with_sources = {
+        // Other sources of the datacenter of the chosen one may take the range over.
+        {r[0], {e1, e2, e3}},
+        // The only source in the datacenter of the chosen one.
+        {r[1], {e3, e1}},
+        // The local node is skipped.
+        {r[2], {e0, e2}},
+        {r[3], {e2, e1}},
+    };
+    sources_for_range_map sources_for_range;
+    auto fetch_map = range_streamer_test::get_range_fetch_map(*env.streamer, ranges_with_sources, ks_name, sources_for_range);
+
+    BOOST_REQUIRE_EQUAL(fetch_map.size(), 3);
+    BOOST_REQUIRE(to_set(fetch_map[e1]) == to_set(dht::token_range_vector{r[0]}));
+    BOOST_REQUIRE(to_set(fetch_map[e2]) == to_set(dht::token_range_vector{r[2], r[3]}));
+    BOOST_REQUIRE(to_set(fetch_map[e3]) == to_set(dht::token_range_vector{r[1]}));
+
+    BOOST_REQUIRE_EQUAL(sources_for_range.size(), 2);
+    BOOST_REQUIRE(sources_for_range[r[0]] == (std::vector<inet_address>{e1, e2}));
+    BOOST_REQUIRE(sources_for_range[r[3]] == (std::vector<inet_address>{e2, e1}));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_get_range_fetch_map_with_filter) {
+    streamer_env env;
+    env.streamer->add_source_filter(std::make_unique<dht::range_streamer::failure_detector_source_filter>(std::set<inet_address>{e1}));
+    auto r = make_ranges(0, 1);
+    sources_for_range_map ranges_with_sources = {
+        {r[0], {e1, e2, e3}},
+        {r[1], {e1, e3}},
+    };
+    sources_for_range_map sources_for_range;
+    auto fetch_map = range_streamer_test::get_range_fetch_map(*env.streamer, ranges_with_sources, ks_name, sources_for_range);
+
+    // A filtered source neither streams a range nor takes one over.
+    BOOST_REQUIRE_EQUAL(fetch_map.size(), 2);
+    BOOST_REQUIRE(to_set(fetch_map[e2]) == to_set(dht::token_range_vector{r[0]}));
+    BOOST_REQUIRE(to_set(fetch_map[e3]) == to_set(dht::token_range_vector{r[1]}));
+    BOOST_REQUIRE(sources_for_range.empty());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_steal_ranges) {
+    streamer_env env;
+    auto r = make_ranges(0, 7);
+    sources_for_range_map sources_for_range;
+    for (int i = 0; i < 6; ++i) {
+        sources_for_range[r[i]] = {e1, e2};
+    }
+    sources_for_range[r[6]] = {e1, e3};
+    sources_for_range[r[7]] = {e1, e3};
+    range_streamer_test::set_sources_for_range(*env.streamer, ks_name, std::move(sources_for_range));
+    ranges_per_source_map ranges_per_source = {
+        {e1, r},
+        {e2, {}},
+        {e3, {}},
+    };
+
+    // Half of the ranges e2 can take over, from the back of the queue.
+    auto stolen = range_streamer_test::steal_ranges(*env.streamer, ks_name, e2, ranges_per_source);
+    BOOST_REQUIRE(stolen == (dht::token_range_vector{r[5], r[4], r[3]}));
+    BOOST_REQUIRE(ranges_per_source[e1] == (dht::token_range_vector{r[0], r[1], r[2], r[6], r[7]}));
+
+    stolen = range_streamer_test::steal_ranges(*env.streamer, ks_name, e3, ranges_per_source);
+    BOOST_REQUIRE(stolen == (dht::token_range_vector{r[7]}));
+    BOOST_REQUIRE(ranges_per_source[e1] == (dht::token_range_vector{r[0], r[1], r[2], r[6]}));
+
+    // A node which isn't a source of any range takes nothing.
+    BOOST_REQUIRE(range_streamer_test::steal_ranges(*env.streamer, ks_name, e0, ranges_per_source).empty());
+    // Nor does anyone for a keyspace with a single source per range.
+    BOOST_REQUIRE(range_streamer_test::steal_ranges(*env.streamer, "other_ks", e2, ranges_per_source).empty());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_stream_ranges_from_takes_over_ranges) {
+    streamer_env env;
+    auto r = make_ranges(0, 3);
+    sources_for_range_map sources_for_range;
+    for (auto& range : r) {
+        sources_for_range[range] = {e1, e2};
+    }
+    range_streamer_test::set_sources_for_range(*env.streamer, ks_name, std::move(sources_for_range));
+    ranges_per_source_map ranges_per_source = {
+        {e1, r},
+        {e2, {}},
+    };
+
+    // e2 has no ranges of its own, and e1 doesn't stream meanwhile, so e2 ends up
+    // streaming all of them.
+    dht::token_range_vector streamed;
+    range_streamer_test::stream_ranges_from(*env.streamer, ks_name, e2, ranges_per_source, 1, [&] (const dht::token_range_vector& ranges) {
+        streamed.insert(streamed.end(), ranges.begin(), ranges.end());
+    });
+    BOOST_REQUIRE(to_set(streamed) == to_set(r));
+    BOOST_REQUIRE_EQUAL(streamed.size(), r.size());
+    BOOST_REQUIRE(ranges_per_source[e1].empty());
+    BOOST_REQUIRE(ranges_per_source[e2].empty());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_stream_ranges_from_failure) {
+    streamer_env env;
+    auto r = make_ranges(0, 7);
+    sources_for_range_map sources_for_range;
+    for (auto& range : r) {
+        sources_for_range[range] = {e1, e2};
+    }
+    range_streamer_test::set_sources_for_range(*env.streamer, ks_name, std::move(sources_for_range));
+    ranges_per_source_map ranges_per_source = {
+        {e1, make_ranges(0, 3)},
+        {e2, make_ranges(4, 7)},
+    };
+
+    // One range per stream plan, the second one fails.
+    dht::token_range_vector streamed;
+    BOOST_REQUIRE_THROW(range_streamer_test::stream_ranges_from(*env.streamer, ks_name, e1, ranges_per_source, 0.25, [&] (const dht::token_range_vector& ranges) {
+        if (!streamed.empty()) {
+            throw std::runtime_error("stream plan failed");
+        }
+        streamed.insert(streamed.end(), ranges.begin(), ranges.end());
+    }), std::runtime_error);
+    BOOST_REQUIRE(streamed == (dht::token_range_vector{r[0]}));
+    // The ranges of the failed plan are back in the queue.
+    BOOST_REQUIRE(ranges_per_source[e1] == (dht::token_range_vector{r[1], r[2], r[3]}));
+
+    // The other source streams its own ranges, but takes none over once the operation failed.
+    streamed.clear();
+    range_streamer_test::stream_ranges_from(*env.streamer, ks_name, e2, ranges_per_source, 1, [&] (const dht::token_range_vector& ranges) {
+        streamed.insert(streamed.end(), ranges.begin(), ranges.end());
+    });
+    BOOST_REQUIRE(streamed == make_ranges(4, 7));
+    BOOST_REQUIRE(ranges_per_source[e1] == (dht::token_range_vector{r[1], r[2], r[3]}));
+}
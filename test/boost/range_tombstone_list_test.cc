@@ -765,6 +765,34 @@ BOOST_AUTO_TEST_CASE(test_difference_with_smaller_tombstone) {
     BOOST_REQUIRE(it == diff.end());
 }
 
+BOOST_AUTO_TEST_CASE(test_apply_monotonically_disjoint_and_adjacent) {
+    range_tombstone_list l1(*s);
+    l1.apply(*s, rtie(0, 2, 1));
+    l1.apply(*s, rtie(4, 6, 1));
+
+    range_tombstone_list l2(*s);
+    l2.apply(*s, rtie(2, 4, 1)); // coalesced with both neighbours
+    l2.apply(*s, rtie(6, 8, 2)); // adjacent, but with a different timestamp
+    l2.apply(*s, rtie(10, 12, 1)); // disjoint
+
+    auto expected = l1;
+    expected.apply(*s, l2);
+    BOOST_REQUIRE_EQUAL(expected.size(), 3);
+
+    auto copy = l1;
+    copy.apply_monotonically(*s, l2);
+    BOOST_REQUIRE(copy.equal(*s, expected));
+
+    l1.apply_monotonically(*s, std::move(l2));
+    BOOST_REQUIRE(l2.empty());
+    BOOST_REQUIRE(l1.equal(*s, expected));
+
+    auto it = l1.begin();
+    assert_rt(rtie(0, 6, 1), *it++);
+    assert_rt(rtie(6, 8, 2), *it++);
+    assert_rt(rtie(10, 12, 1), *it++);
+}
+
 BOOST_AUTO_TEST_CASE(test_exception_safety) {
     int pos = 1;
     auto next_pos = [&] { return pos++; };
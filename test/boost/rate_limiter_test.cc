@@ -127,3 +127,38 @@ SEASTAR_TEST_CASE(test_rate_limiter_account_operation) {
     }
     BOOST_REQUIRE(encountered_rejection);
 }
+
+SEASTAR_TEST_CASE(test_rate_limiter_top_rejected) {
+    const uint64_t limit = 1;
+    test_rate_limiter::label hot_lbl;
+    test_rate_limiter::label other_lbl;
+
+    test_rate_limiter limiter;
+
+    db::per_partition_rate_limit::account_and_enforce info {
+        .random_variable = UINT32_MAX,
+    };
+
+    uint64_t rejected = 0;
+    for (int i = 0; i < 1000; i++) {
+        rejected += limiter.account_operation(hot_lbl, 1, limit, info) == test_rate_limiter::can_proceed::no;
+        limiter.account_operation(other_lbl, 2, 1000 * 1000, info);
+        co_await maybe_yield();
+    }
+    BOOST_REQUIRE_GT(rejected, 0);
+
+    auto top = limiter.top_rejected(hot_lbl, 10);
+    BOOST_REQUIRE_EQUAL(top.size(), 1);
+    BOOST_REQUIRE_EQUAL(top[0].token, 1);
+    BOOST_REQUIRE_EQUAL(top[0].count, rejected);
+    BOOST_REQUIRE(limiter.top_rejected(other_lbl, 10).empty());
+
+    // Still reported in the next time window, forgotten in the one after
+    co_await step_seconds(1);
+    BOOST_REQUIRE_EQUAL(limiter.top_rejected(hot_lbl, 10).size(), 1);
+    co_await step_seconds(1);
+    BOOST_REQUIRE(limiter.top_rejected(hot_lbl, 10).empty());
+
+    // See test_rate_limiter_time_window_wraparound_handling
+    co_await seastar::sleep(std::chrono::seconds(1));
+}
@@ -1236,7 +1236,7 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_memory_limit_no_leaks
     const auto serialize_multiplier = 2;
     const auto kill_multiplier = 3;
     reader_concurrency_semaphore semaphore(initial_resources.count, initial_resources.memory, get_name(), 100,
-            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier));
+            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier), utils::updateable_value<bool>(false));
     auto stop_sem = deferred_stop(semaphore);
 
     const size_t reader_count_target = 6;
@@ -1491,7 +1491,7 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_request_memory_preser
     const auto serialize_multiplier = 2;
     const auto kill_multiplier = std::numeric_limits<uint32_t>::max(); // we don't want this to interfere with our test
     reader_concurrency_semaphore semaphore(initial_resources.count, initial_resources.memory, get_name(), 100,
-            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier));
+            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier), utils::updateable_value<bool>(false));
     auto stop_sem = deferred_stop(semaphore);
 
     auto sponge_permit = semaphore.obtain_permit(nullptr, get_name(), 1024, db::no_timeout, {}).get0();
@@ -1554,7 +1554,7 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_blessed_read_goes_ina
     const auto serialize_multiplier = 2;
     const auto kill_multiplier = std::numeric_limits<uint32_t>::max(); // we don't want this to interfere with our test
     reader_concurrency_semaphore semaphore(initial_resources.count, initial_resources.memory, get_name(), 100,
-            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier));
+            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier), utils::updateable_value<bool>(false));
     auto stop_sem = deferred_stop(semaphore);
 
     simple_schema ss;
@@ -1616,7 +1616,7 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_permit_waiting_for_me
     const auto serialize_multiplier = 2;
     const auto kill_multiplier = std::numeric_limits<uint32_t>::max(); // we don't want this to interfere with our test
     reader_concurrency_semaphore semaphore(initial_resources.count, initial_resources.memory, get_name(), 100,
-            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier));
+            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier), utils::updateable_value<bool>(false));
     auto stop_sem = deferred_stop(semaphore);
 
     auto permit1 = semaphore.obtain_permit(nullptr, get_name(), 1024, db::no_timeout, {}).get0();
@@ -1663,7 +1663,7 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_no_unnecessary_evicti
     const auto serialize_multiplier = std::numeric_limits<uint32_t>::max();
     const auto kill_multiplier = std::numeric_limits<uint32_t>::max();
     reader_concurrency_semaphore semaphore(initial_resources.count, initial_resources.memory, get_name(), 100,
-            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier));
+            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier), utils::updateable_value<bool>(false));
     auto stop_sem = deferred_stop(semaphore);
 
     simple_schema ss;
@@ -1756,7 +1756,7 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_necessary_evicting) {
     const auto serialize_multiplier = std::numeric_limits<uint32_t>::max();
     const auto kill_multiplier = std::numeric_limits<uint32_t>::max();
     reader_concurrency_semaphore semaphore(initial_resources.count, initial_resources.memory, get_name(), 100,
-            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier));
+            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier), utils::updateable_value<bool>(false));
     auto stop_sem = deferred_stop(semaphore);
 
     simple_schema ss;
@@ -1914,7 +1914,7 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_execution_stage_wakeu
     const auto serialize_multiplier = std::numeric_limits<uint32_t>::max();
     const auto kill_multiplier = std::numeric_limits<uint32_t>::max();
     reader_concurrency_semaphore semaphore(initial_resources.count, initial_resources.memory, get_name(), 100,
-            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier));
+            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier), utils::updateable_value<bool>(false));
     auto stop_sem = deferred_stop(semaphore);
 
     auto permit1 = semaphore.obtain_permit(nullptr, get_name(), 1024, db::no_timeout, {}).get();
@@ -1944,3 +1944,79 @@ SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_execution_stage_wakeu
 
     permit2_fut.get();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_admission_by_deadline) {
+    const auto serialize_multiplier = std::numeric_limits<uint32_t>::max();
+    const auto kill_multiplier = std::numeric_limits<uint32_t>::max();
+    reader_concurrency_semaphore semaphore(1, 4 * 1024, get_name(), 100,
+            utils::updateable_value<uint32_t>(serialize_multiplier), utils::updateable_value<uint32_t>(kill_multiplier), utils::updateable_value<bool>(true));
+    auto stop_sem = deferred_stop(semaphore);
+
+    const auto now = db::timeout_clock::now();
+    reader_permit_opt permit = semaphore.obtain_permit(nullptr, get_name(), 1024, db::no_timeout, {}).get();
+
+    // Queued in arrival order, admitted in deadline order.
+    auto permit_fut1 = semaphore.obtain_permit(nullptr, get_name(), 1024, now + std::chrono::minutes(30), {});
+    auto permit_fut2 = semaphore.obtain_permit(nullptr, get_name(), 1024, now + std::chrono::minutes(10), {});
+    auto permit_fut3 = semaphore.obtain_permit(nullptr, get_name(), 1024, now + std::chrono::minutes(20), {});
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().reads_enqueued_for_admission, 3);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().total_reads_rejected_by_deadline, 0);
+
+    permit = {};
+    permit = permit_fut2.get();
+    BOOST_REQUIRE(!permit_fut1.available());
+    BOOST_REQUIRE(!permit_fut3.available());
+
+    permit = {};
+    permit = permit_fut3.get();
+    BOOST_REQUIRE(!permit_fut1.available());
+
+    permit = {};
+    permit = permit_fut1.get();
+
+    // A read timing out in the queue raises the expected queue time...
+    auto timeout_fut = semaphore.obtain_permit(nullptr, get_name(), 1024, db::timeout_clock::now() + std::chrono::milliseconds(100), {});
+    BOOST_REQUIRE_THROW(timeout_fut.get(), semaphore_timed_out);
+
+    // ...so that reads with a shorter timeout are rejected without being queued.
+    const auto enqueued = semaphore.get_stats().reads_enqueued_for_admission;
+    auto rejected_fut = semaphore.obtain_permit(nullptr, get_name(), 1024, db::timeout_clock::now() + std::chrono::milliseconds(1), {});
+    BOOST_REQUIRE(rejected_fut.failed());
+    BOOST_REQUIRE_THROW(rejected_fut.get(), semaphore_timed_out);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().total_reads_rejected_by_deadline, 1);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().reads_enqueued_for_admission, enqueued);
+
+    // Reads without a timeout are always queued.
+    auto no_timeout_fut = semaphore.obtain_permit(nullptr, get_name(), 1024, db::no_timeout, {});
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().reads_enqueued_for_admission, enqueued + 1);
+    permit = {};
+    no_timeout_fut.get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reader_concurrency_semaphore_low_priority_admission) {
+    reader_concurrency_semaphore semaphore(reader_concurrency_semaphore::for_tests{}, get_name(), 1, 4 * 1024);
+    auto stop_sem = deferred_stop(semaphore);
+
+    reader_permit_opt permit = semaphore.obtain_permit(nullptr, get_name(), 1024, db::no_timeout, {}).get();
+
+    std::vector<int> admitted;
+    auto read = [&admitted] (int id) {
+        return [&admitted, id] (reader_permit) {
+            admitted.push_back(id);
+            return make_ready_future<>();
+        };
+    };
+
+    // Low priority reads are admitted after all other queued reads, even
+    // those which arrived later.
+    using low_priority = reader_concurrency_semaphore::low_priority;
+    auto fut1 = semaphore.with_permit(nullptr, get_name(), 1024, db::no_timeout, {}, read(1), low_priority::yes);
+    auto fut2 = semaphore.with_permit(nullptr, get_name(), 1024, db::no_timeout, {}, read(2), low_priority::no);
+    auto fut3 = semaphore.with_permit(nullptr, get_name(), 1024, db::no_timeout, {}, read(3), low_priority::yes);
+    auto fut4 = semaphore.with_permit(nullptr, get_name(), 1024, db::no_timeout, {}, read(4), low_priority::no);
+    BOOST_REQUIRE_EQUAL(semaphore.get_stats().reads_enqueued_for_admission, 4);
+
+    permit = {};
+    when_all_succeed(std::move(fut1), std::move(fut2), std::move(fut3), std::move(fut4)).get();
+    BOOST_REQUIRE(admitted == std::vector<int>({2, 4, 1, 3}));
+}
@@ -21,6 +21,12 @@
 #include "test/lib/reader_concurrency_semaphore.hh"
 #include "test/lib/scylla_test_case.hh"
 #include "readers/mutation_fragment_v1_stream.hh"
+#include "replica/database.hh"
+#include "sstables/sstables.hh"
+
+#include <seastar/core/sleep.hh>
+
+using namespace std::chrono_literals;
 
 // Helper mutation_fragment_queue that stores the received stream of
 // mutation_fragments in a passed in deque of mutation_fragment_v2.
@@ -237,3 +243,111 @@ SEASTAR_TEST_CASE(test_reader_with_different_strategies) {
             repair_reader::read_strategy::multishard_split);
     });
 }
+
+// Counts the partitions which a local repair reader of this shard reads from the table.
+static future<size_t> count_repair_reader_partitions(sharded<replica::database>& db, replica::table& t, replica::skip_repaired_sstables skip_repaired) {
+    auto s = t.schema();
+    auto permit = db.local().get_reader_concurrency_semaphore().make_tracking_only_permit(nullptr, "test", db::no_timeout, {});
+    auto reader = repair_reader(db, t, s, std::move(permit), dht::token_range::make_open_ended_both_sides(),
+            s->get_sharder(), this_shard_id(), 0, repair_reader::read_strategy::local, gc_clock::now(), skip_repaired);
+    size_t partitions = 0;
+    while (auto mf = co_await reader.read_mutation_fragment()) {
+        partitions += mf->is_partition_start();
+    }
+    co_await reader.on_end_of_stream();
+    co_await reader.close();
+    co_return partitions;
+}
+
+SEASTAR_TEST_CASE(test_mark_repaired_sstables) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.t (pk int PRIMARY KEY, v int)").get();
+        for (int pk = 0; pk < 10; ++pk) {
+            e.execute_cql(format("INSERT INTO ks.t (pk, v) VALUES ({}, {})", pk, pk)).get();
+        }
+        e.db().invoke_on_all([] (replica::database& db) { return db.flush("ks", "t"); }).get();
+        // The repair time has a resolution of seconds, and must be later than the opening of the sstables.
+        sleep(1s).get();
+        const auto repair_time = gc_clock::now();
+
+        // Returns the number of sstables, and the number of them which are repaired, on all shards.
+        auto mark = [&] (size_t repaired_ranges) {
+            return e.db().map_reduce0([repaired_ranges, repair_time] (replica::database& db) -> future<std::pair<size_t, size_t>> {
+                auto& t = db.find_column_family("ks", "t");
+                auto owned_ranges = db.get_keyspace_local_ranges("ks");
+                auto& gc_state = t.get_compaction_manager().get_tombstone_gc_state();
+                for (size_t i = 0; i < std::min(repaired_ranges, owned_ranges.size()); ++i) {
+                    gc_state.update_repair_time(t.schema()->id(), owned_ranges[i], repair_time);
+                }
+                co_await t.mark_repaired_sstables(std::move(owned_ranges));
+                auto sstables = t.get_sstables();
+                for (auto& sst : *sstables) {
+                    if (sst->is_repaired()) {
+                        BOOST_REQUIRE_EQUAL(sst->get_repaired_at(), uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(repair_time.time_since_epoch()).count()));
+                    }
+                }
+                co_return std::pair(sstables->size(), size_t(std::ranges::count_if(*sstables, std::mem_fn(&sstables::sstable::is_repaired))));
+            }, std::pair<size_t, size_t>(0, 0), [] (auto a, auto b) {
+                return std::pair(a.first + b.first, a.second + b.second);
+            }).get();
+        };
+
+        // Until all the owned ranges are repaired, nothing is.
+        auto [total, repaired] = mark(1);
+        BOOST_REQUIRE_GT(total, 0);
+        BOOST_REQUIRE_EQUAL(repaired, 0);
+
+        std::tie(total, repaired) = mark(std::numeric_limits<size_t>::max());
+        BOOST_REQUIRE_EQUAL(repaired, total);
+
+        // Data which was written after the repair started stays unrepaired.
+        for (int pk = 10; pk < 20; ++pk) {
+            e.execute_cql(format("INSERT INTO ks.t (pk, v) VALUES ({}, {})", pk, pk)).get();
+        }
+        e.db().invoke_on_all([] (replica::database& db) { return db.flush("ks", "t"); }).get();
+        auto [new_total, new_repaired] = mark(std::numeric_limits<size_t>::max());
+        BOOST_REQUIRE_GT(new_total, total);
+        BOOST_REQUIRE_EQUAL(new_repaired, repaired);
+
+        // Incremental repairs read only the unrepaired sstables.
+        auto count_partitions = [&] (replica::skip_repaired_sstables skip_repaired) {
+            return e.db().map_reduce0([&db = e.db(), skip_repaired] (replica::database& local_db) {
+                return count_repair_reader_partitions(db, local_db.find_column_family("ks", "t"), skip_repaired);
+            }, size_t(0), std::plus<size_t>()).get();
+        };
+        BOOST_REQUIRE_EQUAL(count_partitions(replica::skip_repaired_sstables::no), 20);
+        BOOST_REQUIRE_EQUAL(count_partitions(replica::skip_repaired_sstables::yes), 10);
+    });
+}
+
+SEASTAR_THREAD_TEST_CASE(test_split_range_for_summary) {
+    auto check = [] (const dht::token_range& range, size_t nr, size_t expected_nr) {
+        auto ranges = split_range_for_summary(range, nr);
+        BOOST_REQUIRE_EQUAL(ranges.size(), expected_nr);
+        // The sub-ranges are adjacent and cover exactly the range.
+        BOOST_REQUIRE(ranges.front().start() == range.start());
+        BOOST_REQUIRE(ranges.back().end() == range.end());
+        for (size_t i = 0; i + 1 < ranges.size(); ++i) {
+            BOOST_REQUIRE(ranges[i].end() && ranges[i].end()->is_inclusive());
+            BOOST_REQUIRE(ranges[i + 1].start() && !ranges[i + 1].start()->is_inclusive());
+            BOOST_REQUIRE(ranges[i].end()->value() == ranges[i + 1].start()->value());
+            BOOST_REQUIRE(dht::token_comparator()(ranges[i].start() ? ranges[i].start()->value() : dht::minimum_token(), ranges[i].end()->value()) < 0);
+        }
+        return ranges;
+    };
+
+    auto full = dht::token_range::make_open_ended_both_sides();
+    auto ranges = check(full, 16, 16);
+    // Of roughly the same span.
+    BOOST_REQUIRE_EQUAL(dht::token::to_int64(ranges[0].end()->value()), std::numeric_limits<int64_t>::min() + int64_t(std::numeric_limits<uint64_t>::max() / 16));
+
+    auto range = dht::token_range::make({dht::token::from_int64(-100), false}, {dht::token::from_int64(100), true});
+    ranges = check(range, 4, 4);
+    BOOST_REQUIRE_EQUAL(dht::token::to_int64(ranges[0].end()->value()), -50);
+    BOOST_REQUIRE_EQUAL(dht::token::to_int64(ranges[1].end()->value()), 0);
+    BOOST_REQUIRE_EQUAL(dht::token::to_int64(ranges[2].end()->value()), 50);
+
+    check(range, 1, 1);
+    // Never more sub-ranges than tokens.
+    check(dht::token_range::make({dht::token::from_int64(0), false}, {dht::token::from_int64(3), true}), 16, 3);
+}
@@ -13,6 +13,7 @@
 #include <seastar/util/alloc_failure_injector.hh>
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <seastar/util/closeable.hh>
+#include <deque>
 
 #include "test/lib/scylla_test_case.hh"
 #include "test/lib/mutation_assertions.hh"
@@ -1808,6 +1809,310 @@ SEASTAR_TEST_CASE(test_lru) {
     });
 }
 
+namespace {
+
+class test_evictable final : public evictable {
+    int _id;
+    std::vector<int>& _evicted;
+    bool _on_probation = false;
+public:
+    test_evictable(int id, std::vector<int>& evicted) : _id(id), _evicted(evicted) {}
+    void on_evicted() noexcept override { _evicted.push_back(_id); }
+    bool set_on_probation(bool v) noexcept override { _on_probation = v; return true; }
+    bool on_probation() const noexcept override { return _on_probation; }
+};
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_lru_segments) {
+    auto evict_all = [] (lru& l) {
+        while (l.evict() == memory::reclaiming_result::reclaimed_something) {}
+    };
+
+    // Without admission on probation, the order is that of a plain LRU.
+    {
+        std::vector<int> evicted;
+        std::deque<test_evictable> entries;
+        lru l;
+        for (int i = 0; i < 5; ++i) {
+            l.add(entries.emplace_back(i, evicted));
+        }
+        l.touch(entries[1]);
+        evict_all(l);
+        BOOST_REQUIRE(evicted == std::vector<int>{0, 2, 3, 4, 1});
+    }
+
+    // Entries on probation are evicted before the protected ones, unless touched again.
+    {
+        std::vector<int> evicted;
+        std::deque<test_evictable> entries;
+        lru l;
+        l.add(entries.emplace_back(0, evicted));
+        l.add(entries.emplace_back(1, evicted));
+        l.add_on_probation(entries.emplace_back(2, evicted));
+        l.add_on_probation(entries.emplace_back(3, evicted));
+        l.add_on_probation(entries.emplace_back(4, evicted));
+        BOOST_REQUIRE_EQUAL(l.probation_size(), 3);
+        BOOST_REQUIRE_EQUAL(l.protected_size(), 2);
+        l.touch(entries[3]);
+        BOOST_REQUIRE_EQUAL(l.probation_size(), 2);
+        // Entries inserted before another stay in the segment of the latter.
+        l.add_before(entries[4], entries.emplace_back(5, evicted));
+        BOOST_REQUIRE_EQUAL(l.probation_size(), 3);
+        evict_all(l);
+        BOOST_REQUIRE(evicted == std::vector<int>{2, 5, 4, 0, 1, 3});
+    }
+
+    // The protected segment is kept within its fraction by demoting its least recently
+    // used entries, which doesn't change the eviction order. Demoted entries are promoted
+    // again when touched.
+    {
+        std::vector<int> evicted;
+        std::deque<test_evictable> entries;
+        lru l;
+        for (int i = 0; i < 10; ++i) {
+            l.add(entries.emplace_back(i, evicted));
+        }
+        l.add_on_probation(entries.emplace_back(10, evicted));
+        l.evict();
+        BOOST_REQUIRE(evicted == std::vector<int>{10});
+        BOOST_REQUIRE_EQUAL(l.probation_size(), 2);
+        BOOST_REQUIRE_LE(l.protected_size(), (l.protected_size() + l.probation_size()) * lru::protected_fraction);
+        l.touch(entries[1]);
+        evict_all(l);
+        BOOST_REQUIRE(evicted == std::vector<int>{10, 0, 2, 3, 4, 5, 6, 7, 8, 9, 1});
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_admission_on_reuse) {
+    BOOST_REQUIRE(parse_cache_admission("populate") == cache_admission::populate);
+    BOOST_REQUIRE(parse_cache_admission("populate_on_reuse") == cache_admission::populate_on_reuse);
+    BOOST_REQUIRE(parse_cache_admission("bypass") == cache_admission::bypass);
+    BOOST_REQUIRE(!parse_cache_admission("sometimes"));
+
+    cache_tracker tracker;
+    BOOST_REQUIRE(!tracker.is_reused(17));
+    BOOST_REQUIRE(tracker.is_reused(17));
+    BOOST_REQUIRE(!tracker.is_reused(18));
+    BOOST_REQUIRE(tracker.is_reused(17));
+    BOOST_REQUIRE(tracker.is_reused(18));
+}
+
+SEASTAR_TEST_CASE(test_compressed_cache) {
+    return seastar::async([] {
+        auto s = make_schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        memtable_snapshot_source underlying(s);
+
+        int partition_count = 10;
+        std::vector<mutation> partitions = make_ring(s, partition_count);
+        for (auto&& m : partitions) {
+            underlying.apply(m);
+        }
+
+        cache_tracker tracker(utils::updateable_value<double>(1.0), utils::updateable_value<bool>(false),
+                utils::updateable_value<uint32_t>(1), utils::updateable_value<uint32_t>(0), utils::updateable_value<uint32_t>(0),
+                cache_tracker::register_metrics::no);
+        row_cache cache(s, snapshot_source([&] { return underlying(); }), tracker);
+
+        auto read = [&] (const mutation& m) {
+            auto pr = dht::partition_range::make_singular(m.decorated_key());
+            assert_that(cache.make_reader(s, semaphore.make_permit(), pr))
+                    .produces(m)
+                    .produces_end_of_stream();
+        };
+
+        for (auto&& m : partitions) {
+            read(m);
+        }
+        // Compression stops early when the reactor needs the CPU back.
+        size_t compressed = 0;
+        while (compressed < size_t(partition_count)) {
+            auto n = tracker.compress_cold_partitions(partition_count - compressed);
+            BOOST_REQUIRE_GT(n, 0);
+            compressed += n;
+            seastar::thread::maybe_yield();
+        }
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partitions, 0);
+        BOOST_REQUIRE_EQUAL(tracker.compressed_partitions().size(), partition_count);
+        BOOST_REQUIRE_GT(tracker.compressed_partitions().memory_usage(), 0);
+
+        // Reads restore compressed partitions without going to the underlying source.
+        auto misses = tracker.get_stats().reads_with_misses;
+        read(partitions[0]);
+        read(partitions[1]);
+        read(partitions[1]);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().reads_with_misses, misses);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().compressed_partition_hits, 2);
+        BOOST_REQUIRE_EQUAL(tracker.compressed_partitions().size(), partition_count - 2);
+
+        // Updates drop the compressed copies of the partitions they change.
+        auto m2 = make_new_mutation(s, partitions[2].key());
+        auto mt = make_lw_shared<replica::memtable>(s);
+        mt->apply(m2);
+        cache.update(row_cache::external_updater([&] { underlying.apply(m2); }), *mt).get();
+        BOOST_REQUIRE_EQUAL(tracker.compressed_partitions().size(), partition_count - 3);
+        partitions[2].apply(m2);
+        read(partitions[2]);
+
+        // So do invalidations.
+        cache.invalidate(row_cache::external_updater([] {}), partitions[3].decorated_key()).get();
+        BOOST_REQUIRE_EQUAL(tracker.compressed_partitions().size(), partition_count - 4);
+        read(partitions[3]);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().compressed_partition_hits, 2);
+
+        cache.invalidate(row_cache::external_updater([] {})).get();
+        BOOST_REQUIRE_EQUAL(tracker.compressed_partitions().size(), 0);
+        for (auto&& m : partitions) {
+            read(m);
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_compressed_cache_skips_large_partitions) {
+    return seastar::async([] {
+        auto s = make_schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        memtable_snapshot_source underlying(s);
+
+        std::vector<mutation> partitions = make_ring(s, 2);
+        // Larger than the store accepts.
+        partitions[0].set_clustered_cell(clustering_key::make_empty(), "v",
+                data_value(bytes(bytes::initialized_later(), compressed_partition_store::max_partition_size + 1)), next_timestamp++);
+        for (auto&& m : partitions) {
+            underlying.apply(m);
+        }
+
+        cache_tracker tracker(utils::updateable_value<double>(1.0), utils::updateable_value<bool>(false),
+                utils::updateable_value<uint32_t>(4), utils::updateable_value<uint32_t>(0), utils::updateable_value<uint32_t>(0),
+                cache_tracker::register_metrics::no);
+        row_cache cache(s, snapshot_source([&] { return underlying(); }), tracker);
+
+        for (auto&& m : partitions) {
+            auto pr = dht::partition_range::make_singular(m.decorated_key());
+            assert_that(cache.make_reader(s, semaphore.make_permit(), pr))
+                    .produces(m)
+                    .produces_end_of_stream();
+        }
+
+        // The large partition is skipped, without stopping the search for smaller ones.
+        BOOST_REQUIRE_EQUAL(tracker.compress_cold_partitions(2), 1);
+        BOOST_REQUIRE_EQUAL(tracker.compressed_partitions().size(), 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partitions, 1);
+    });
+}
+
+SEASTAR_TEST_CASE(test_absent_partition_cache) {
+    return seastar::async([] {
+        auto s = make_schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        memtable_snapshot_source underlying(s);
+
+        // Only every other partition is present in the underlying source.
+        std::vector<mutation> partitions = make_ring(s, 6);
+        for (size_t i = 0; i < partitions.size(); i += 2) {
+            underlying.apply(partitions[i]);
+        }
+
+        cache_tracker tracker(utils::updateable_value<double>(1.0), utils::updateable_value<bool>(false),
+                utils::updateable_value<uint32_t>(0), utils::updateable_value<uint32_t>(1), utils::updateable_value<uint32_t>(0),
+                cache_tracker::register_metrics::no);
+        row_cache cache(s, snapshot_source([&] { return underlying(); }), tracker);
+
+        auto read = [&] (const mutation& m) {
+            auto pr = dht::partition_range::make_singular(m.decorated_key());
+            return assert_that(cache.make_reader(s, semaphore.make_permit(), pr));
+        };
+
+        // Absent partitions are remembered without inserting cache entries for them.
+        read(partitions[1]).produces_end_of_stream();
+        read(partitions[3]).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partitions, 0);
+        BOOST_REQUIRE_EQUAL(tracker.absent_partitions().size(), 2);
+        BOOST_REQUIRE_GT(tracker.absent_partitions().memory_usage(), 0);
+
+        auto misses = tracker.get_stats().partition_misses;
+        read(partitions[1]).produces_end_of_stream();
+        read(partitions[3]).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_misses, misses);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().absent_partition_hits, 2);
+
+        // Present partitions are still cached as usual.
+        read(partitions[0]).produces(partitions[0]).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.absent_partitions().size(), 2);
+
+        // Updates drop the keys of the partitions they add.
+        auto mt = make_lw_shared<replica::memtable>(s);
+        mt->apply(partitions[1]);
+        cache.update(row_cache::external_updater([&] { underlying.apply(partitions[1]); }), *mt).get();
+        BOOST_REQUIRE_EQUAL(tracker.absent_partitions().size(), 1);
+        read(partitions[1]).produces(partitions[1]).produces_end_of_stream();
+
+        // So do invalidations.
+        underlying.apply(partitions[3]);
+        cache.invalidate(row_cache::external_updater([] {}), partitions[3].decorated_key()).get();
+        BOOST_REQUIRE_EQUAL(tracker.absent_partitions().size(), 0);
+        read(partitions[3]).produces(partitions[3]).produces_end_of_stream();
+
+        read(partitions[5]).produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.absent_partitions().size(), 1);
+        underlying.apply(partitions[5]);
+        cache.invalidate(row_cache::external_updater([] {})).get();
+        BOOST_REQUIRE_EQUAL(tracker.absent_partitions().size(), 0);
+        read(partitions[5]).produces(partitions[5]).produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(test_scans_populate_on_probation) {
+    return seastar::async([] {
+        auto s = make_schema();
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto mt = make_lw_shared<replica::memtable>(s);
+
+        int partition_count = 10;
+        std::vector<mutation> partitions = make_ring(s, partition_count);
+        for (auto&& m : partitions) {
+            mt->apply(m);
+        }
+
+        cache_tracker tracker(utils::updateable_value<double>(1.0), utils::updateable_value<bool>(true),
+                utils::updateable_value<uint32_t>(0), utils::updateable_value<uint32_t>(0), utils::updateable_value<uint32_t>(0),
+                cache_tracker::register_metrics::no);
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        // Point reads populate the protected segment.
+        auto hot_pr = dht::partition_range::make_singular(partitions[3].decorated_key());
+        assert_that(cache.make_reader(s, semaphore.make_permit(), hot_pr))
+                .produces(partitions[3])
+                .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_lru().probation_size(), 0);
+
+        auto scan = [&] {
+            auto rd = assert_that(cache.make_reader(s, semaphore.make_permit()));
+            for (auto&& m : partitions) {
+                rd.produces(m);
+            }
+            rd.produces_end_of_stream();
+        };
+
+        // The scan populates all the other partitions on probation.
+        scan();
+        BOOST_REQUIRE_GT(tracker.get_lru().probation_size(), 0);
+        BOOST_REQUIRE_GT(tracker.get_stats().protected_row_hits, 0);
+
+        // The scanned partitions are evicted first.
+        for (int i = 0; i < partition_count - 1; ++i) {
+            evict_one_partition(tracker);
+        }
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 1);
+        auto misses = tracker.get_stats().partition_misses;
+        assert_that(cache.make_reader(s, semaphore.make_permit(), hot_pr))
+                .produces(partitions[3])
+                .produces_end_of_stream();
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_misses, misses);
+    });
+}
+
 SEASTAR_TEST_CASE(test_update_invalidating) {
     return seastar::async([] {
         simple_schema s;
@@ -1859,6 +2164,64 @@ SEASTAR_TEST_CASE(test_update_invalidating) {
     });
 }
 
+SEASTAR_TEST_CASE(test_update_invalidates_partitions_with_too_many_rows) {
+    return seastar::async([] {
+        simple_schema s;
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        cache_tracker tracker(utils::updateable_value<double>(1.0), utils::updateable_value<bool>(false),
+                utils::updateable_value<uint32_t>(0), utils::updateable_value<uint32_t>(0), utils::updateable_value<uint32_t>(2),
+                cache_tracker::register_metrics::no);
+        memtable_snapshot_source underlying(s.schema());
+
+        auto mutation_for_key = [&] (dht::decorated_key key, int rows) {
+            mutation m(s.schema(), key);
+            for (int i = 0; i < rows; ++i) {
+                s.add_row(m, s.make_ckey(i), "val");
+            }
+            return m;
+        };
+
+        auto keys = s.make_pkeys(4);
+
+        auto m1 = mutation_for_key(keys[1], 1);
+        underlying.apply(m1);
+
+        auto m2 = mutation_for_key(keys[3], 1);
+        underlying.apply(m2);
+
+        row_cache cache(s.schema(), snapshot_source([&] { return underlying(); }), tracker);
+
+        assert_that(cache.make_reader(s.schema(), semaphore.make_permit()))
+            .produces(m1)
+            .produces(m2)
+            .produces_end_of_stream();
+
+        auto mt = make_lw_shared<replica::memtable>(s.schema());
+
+        // Above the limit, in cache and not in cache.
+        auto m3 = mutation_for_key(m1.decorated_key(), 5);
+        auto m4 = mutation_for_key(keys[0], 5);
+        // Below the limit, merged.
+        auto m5 = mutation_for_key(m2.decorated_key(), 1);
+        m5.partition().apply(s.new_tombstone());
+        mt->apply(m3);
+        mt->apply(m4);
+        mt->apply(m5);
+
+        auto mt_copy = make_lw_shared<replica::memtable>(s.schema());
+        mt_copy->apply(*mt, semaphore.make_permit()).get();
+        cache.update(row_cache::external_updater([&] { underlying.apply(mt_copy); }), *mt).get();
+
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partitions_invalidated_on_update, 2);
+
+        assert_that(cache.make_reader(s.schema(), semaphore.make_permit()))
+            .produces(m4)
+            .produces(m1 + m3)
+            .produces(m2 + m5)
+            .produces_end_of_stream();
+    });
+}
+
 SEASTAR_TEST_CASE(test_scan_with_partial_partitions) {
     return seastar::async([] {
         simple_schema s;
@@ -4705,7 +5068,7 @@ SEASTAR_TEST_CASE(test_compact_range_tombstones_on_read) {
 SEASTAR_THREAD_TEST_CASE(test_cache_reader_semaphore_oom_kill) {
     simple_schema s;
     reader_concurrency_semaphore semaphore(100, 1, get_name(), std::numeric_limits<size_t>::max(), utils::updateable_value<uint32_t>(1),
-            utils::updateable_value<uint32_t>(1));
+            utils::updateable_value<uint32_t>(1), utils::updateable_value<bool>(false));
     auto stop_semaphore = deferred_stop(semaphore);
 
     cache_tracker tracker;
@@ -4737,3 +5100,24 @@ SEASTAR_THREAD_TEST_CASE(test_cache_reader_semaphore_oom_kill) {
         BOOST_REQUIRE_EQUAL(semaphore.get_stats().total_reads_killed_due_to_kill_limit, ++kill_limit_before);
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(test_cache_contains) {
+    auto s = make_schema();
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    auto m1 = make_new_mutation(s);
+    auto m2 = make_new_mutation(s);
+
+    cache_tracker tracker;
+    row_cache cache(s, snapshot_source_from_snapshot(make_source_with(m1)), tracker);
+    BOOST_REQUIRE(!cache.contains(m1.decorated_key()));
+
+    auto range = dht::partition_range::make_singular(m1.decorated_key());
+    assert_that(cache.make_reader(s, semaphore.make_permit(), range))
+        .produces(m1)
+        .produces_end_of_stream();
+    BOOST_REQUIRE(cache.contains(m1.decorated_key()));
+    BOOST_REQUIRE(!cache.contains(m2.decorated_key()));
+
+    tracker.clear();
+    BOOST_REQUIRE(!cache.contains(m1.decorated_key()));
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/sleep.hh>
+
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "test/lib/tmpdir.hh"
+#include "test/lib/random_utils.hh"
+#include "test/lib/eventually.hh"
+
+#include "utils/s3/disk_cache.hh"
+
+static constexpr size_t block_size = s3::disk_cache::block_size;
+
+static std::pair<file, sstring> make_object(const tmpdir& dir, size_t size) {
+    auto contents = tests::random::get_sstring(size);
+    auto path = (dir.path() / "object").native();
+    auto f = open_file_dma(path, open_flags::wo | open_flags::create | open_flags::truncate).get();
+    auto out = make_file_output_stream(std::move(f)).get();
+    out.write(contents.data(), contents.size()).get();
+    out.close().get();
+    return {open_file_dma(path, open_flags::ro).get(), std::move(contents)};
+}
+
+static void check_read(file& f, const sstring& contents, uint64_t pos, size_t len) {
+    auto buf = f.dma_read_bulk<char>(pos, len).get();
+    auto expected_len = pos < contents.size() ? std::min(len, contents.size() - pos) : 0;
+    BOOST_REQUIRE_EQUAL(buf.size(), expected_len);
+    BOOST_REQUIRE(std::string_view(buf.get(), buf.size()) == std::string_view(contents).substr(pos, expected_len));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_disk_cache_read_through) {
+    tmpdir object_dir;
+    tmpdir cache_dir;
+    auto [underlying, contents] = make_object(object_dir, 3 * block_size + 1000);
+
+    auto cache = make_shared<s3::disk_cache>(cache_dir.path(), 64 * block_size);
+    auto f = s3::make_cached_file(cache, "/bucket/object", underlying);
+
+    check_read(f, contents, 100, 1000);
+    BOOST_REQUIRE_EQUAL(cache->get_stats().misses, 1);
+    // Spans cached block 0 and missing blocks 1..3, the last one short
+    check_read(f, contents, 1000, 4 * block_size);
+    REQUIRE_EVENTUALLY_EQUAL(cache->get_stats().used_bytes, contents.size());
+
+    auto hits = cache->get_stats().hits;
+    auto misses = cache->get_stats().misses;
+    check_read(f, contents, 0, contents.size());
+    check_read(f, contents, block_size - 10, 20);
+    check_read(f, contents, contents.size() - 10, 100);
+    check_read(f, contents, contents.size() + 10, 100);
+    BOOST_REQUIRE_EQUAL(cache->get_stats().misses, misses);
+    BOOST_REQUIRE_GT(cache->get_stats().hits, hits);
+
+    f.close().get();
+    cache->stop().get();
+    // Both hold the cache, which has to go away before the next one
+    // registers its metrics
+    f = file();
+    cache = nullptr;
+
+    // Cached blocks survive a restart, and are evicted down to the new capacity
+    cache = make_shared<s3::disk_cache>(cache_dir.path(), 2 * block_size);
+    underlying = open_file_dma((object_dir.path() / "object").native(), open_flags::ro).get();
+    f = s3::make_cached_file(cache, "/bucket/object", underlying);
+    check_read(f, contents, 0, 10);
+    BOOST_REQUIRE_LE(cache->get_stats().used_bytes, 2 * block_size);
+    BOOST_REQUIRE_GE(cache->get_stats().evictions, 2);
+
+    f.close().get();
+    cache->stop().get();
+}
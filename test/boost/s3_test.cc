@@ -202,6 +202,38 @@ SEASTAR_THREAD_TEST_CASE(test_client_readable_file) {
     testlog.info("Check bulk read\n");
     auto buf = f.dma_read_bulk<char>(5, 8).get0();
     BOOST_REQUIRE_EQUAL(to_sstring(std::move(buf)), sstring("67890ABC"));
+
+    testlog.info("Check coalesced reads\n");
+    auto r1 = f.dma_read_bulk<char>(10, 4);
+    auto r2 = f.dma_read_bulk<char>(0, 3);
+    auto r3 = f.dma_read_bulk<char>(2, 4);
+    auto r4 = f.dma_read_bulk<char>(14, 10);
+    BOOST_REQUIRE_EQUAL(to_sstring(r1.get0()), sstring("BCDE"));
+    BOOST_REQUIRE_EQUAL(to_sstring(r2.get0()), sstring("123"));
+    BOOST_REQUIRE_EQUAL(to_sstring(r3.get0()), sstring("3456"));
+    BOOST_REQUIRE_EQUAL(to_sstring(r4.get0()), sstring("EF"));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_client_copy_object) {
+    const sstring name(fmt::format("/{}/testcpobject-{}", tests::getenv_safe("S3_BUCKET_FOR_TEST"), ::getpid()));
+    const sstring copy_name(fmt::format("/{}/testcpobject-{}-copy", tests::getenv_safe("S3_BUCKET_FOR_TEST"), ::getpid()));
+
+    testlog.info("Make client\n");
+    semaphore mem(16<<20);
+    auto cln = s3::client::make(tests::getenv_safe("S3_SERVER_ADDRESS_FOR_TEST"), make_minio_config(), mem);
+    auto close_client = deferred_close(*cln);
+
+    testlog.info("Put object {}\n", name);
+    temporary_buffer<char> data = sstring("1234567890").release();
+    cln->put_object(name, std::move(data)).get();
+    auto delete_object = deferred_delete_object(cln, name);
+
+    testlog.info("Copy object to {}\n", copy_name);
+    cln->copy_object(name, copy_name).get();
+    auto delete_copy = deferred_delete_object(cln, copy_name);
+
+    auto res = cln->get_object_contiguous(copy_name).get0();
+    BOOST_REQUIRE_EQUAL(to_sstring(std::move(res)), sstring("1234567890"));
 }
 
 SEASTAR_THREAD_TEST_CASE(test_client_put_get_tagging) {
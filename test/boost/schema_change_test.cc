@@ -667,6 +667,62 @@ SEASTAR_TEST_CASE(test_notifications) {
     });
 }
 
+SEASTAR_TEST_CASE(test_merging_only_one_kind_of_schema_objects) {
+    cql_test_config cfg;
+    cfg.db_config->enable_user_defined_functions({true}, db::config::config_source::CommandLine);
+    cfg.db_config->experimental_features({experimental_features_t::feature::UDF}, db::config::config_source::CommandLine);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create type ks.pair (a int, b int);").get();
+        e.execute_cql("create table ks.t (pk int primary key, v int, p frozen<pair>);").get();
+        e.execute_cql("create function ks.inc(val int) called on null input returns int language lua as 'return val + 1';").get();
+        e.execute_cql("create function ks.add(a int, b int) called on null input returns int language lua as 'return a + b';").get();
+        e.execute_cql("create aggregate ks.total(int) sfunc add stype int initcond 0;").get();
+        e.execute_cql("insert into ks.t (pk, v, p) values (1, 10, {a: 1, b: 2});").get();
+
+        counting_migration_listener listener;
+        e.local_mnotifier().register_listener(&listener);
+        auto listener_lease = defer([&e, &listener] { e.local_mnotifier().unregister_listener(&listener).get(); });
+
+        // The schema tables which the mutations don't touch are read neither
+        // before nor after applying them, so nothing else seems to change.
+        auto require_changes = [&] (int functions_created, int functions_dropped, int aggregates_created, int types_created) {
+            BOOST_REQUIRE_EQUAL(listener.create_function_count, functions_created);
+            BOOST_REQUIRE_EQUAL(listener.drop_function_count, functions_dropped);
+            BOOST_REQUIRE_EQUAL(listener.create_aggregate_count, aggregates_created);
+            BOOST_REQUIRE_EQUAL(listener.create_user_type_count, types_created);
+            BOOST_REQUIRE_EQUAL(listener.update_function_count + listener.update_aggregate_count + listener.drop_aggregate_count, 0);
+            BOOST_REQUIRE_EQUAL(listener.update_user_type_count + listener.drop_user_type_count, 0);
+            BOOST_REQUIRE_EQUAL(listener.create_keyspace_count + listener.update_keyspace_count + listener.drop_keyspace_count, 0);
+            BOOST_REQUIRE_EQUAL(listener.create_column_family_count + listener.update_column_family_count + listener.drop_column_family_count, 0);
+        };
+        auto require_all_usable = [&] {
+            assert_that(e.execute_cql("select ks.inc(v), p.a, p.b from ks.t;").get0()).is_rows().with_rows({{
+                int32_type->decompose(11), int32_type->decompose(1), int32_type->decompose(2),
+            }});
+            assert_that(e.execute_cql("select ks.total(v) from ks.t;").get0()).is_rows().with_rows({{int32_type->decompose(10)}});
+        };
+
+        // Only functions.
+        e.execute_cql("create function ks.twice(val int) called on null input returns int language lua as 'return 2 * val';").get();
+        require_changes(1, 0, 0, 0);
+        require_all_usable();
+
+        // Only aggregates.
+        e.execute_cql("create aggregate ks.total2(int) sfunc add stype int initcond 0;").get();
+        require_changes(1, 0, 1, 0);
+        require_all_usable();
+
+        // Only types.
+        e.execute_cql("create type ks.unused (a int);").get();
+        require_changes(1, 0, 1, 1);
+        require_all_usable();
+
+        e.execute_cql("drop function ks.twice;").get();
+        require_changes(1, 1, 1, 1);
+        require_all_usable();
+    }, std::move(cfg));
+}
+
 SEASTAR_TEST_CASE(test_drop_user_type_in_use) {
     return do_with_cql_env_thread([](cql_test_env& e) {
         e.execute_cql("create type simple_type (user_number int);").get();
@@ -5120,25 +5120,22 @@ struct large_row_handler : public db::large_data_handler {
         start();
     }
 
-    virtual future<> record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
-            const clustering_key_prefix* clustering_key, uint64_t row_size) const override {
+    virtual void record_large_rows(const sstables::sstable& sst, const sstables::key& partition_key,
+            const clustering_key_prefix* clustering_key, uint64_t row_size) override {
         const schema_ptr s = sst.get_schema();
         callback(*s, partition_key, clustering_key, row_size, nullptr, 0, 0);
-        return make_ready_future<>();
     }
 
-    virtual future<> record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
-        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) const override {
+    virtual void record_large_cells(const sstables::sstable& sst, const sstables::key& partition_key,
+        const clustering_key_prefix* clustering_key, const column_definition& cdef, uint64_t cell_size, uint64_t collection_elements) override {
         const schema_ptr s = sst.get_schema();
         callback(*s, partition_key, clustering_key, 0, &cdef, cell_size, collection_elements);
-        return make_ready_future<>();
     }
 
-    virtual future<> record_large_partitions(const sstables::sstable& sst,
-        const sstables::key& partition_key, uint64_t partition_size, uint64_t rows_count) const override {
+    virtual void record_large_partitions(const sstables::sstable& sst,
+        const sstables::key& partition_key, uint64_t partition_size, uint64_t rows_count) override {
         const schema_ptr s = sst.get_schema();
         callback(*s, partition_key, nullptr, rows_count, nullptr, 0, 0);
-        return make_ready_future<>();
     }
 
     virtual future<> delete_large_data_entries(const schema& s, sstring sstable_name, std::string_view) const override {
@@ -59,6 +59,7 @@
 #include <seastar/testing/test_case.hh>
 #include "test/lib/test_services.hh"
 #include "test/lib/cql_test_env.hh"
+#include "test/lib/cql_assertions.hh"
 #include "test/lib/reader_concurrency_semaphore.hh"
 #include "test/lib/sstable_utils.hh"
 #include "test/lib/random_utils.hh"
@@ -1149,6 +1150,33 @@ SEASTAR_TEST_CASE(tombstone_purge_test) {
                     .produces(mut3)
                     .produces_end_of_stream();
         }
+        {
+            // Older data in the memtable only prevents purging the tombstones of the partitions it holds.
+            auto mut1 = make_insert(alpha);
+            auto mut2 = make_insert(beta);
+            auto mut3 = make_delete(alpha);
+
+            auto sst1 = make_sstable_containing(sst_gen, {mut1, mut3});
+
+            forward_jump_clocks(std::chrono::seconds(ttl));
+
+            auto compact_with_memtable = [&] (const mutation& in_memtable) {
+                auto cf = env.make_table_for_tests(s);
+                auto stop_cf = deferred_stop(cf);
+                column_family_test(cf).add_sstable(sst1).get();
+                cf->apply(in_memtable);
+                return compact_sstables(sstables::compaction_descriptor({sst1}), cf, sst_gen).get0().new_sstables;
+            };
+
+            auto result = compact_with_memtable(mut2);
+            BOOST_REQUIRE_EQUAL(0, result.size());
+
+            result = compact_with_memtable(mut1);
+            BOOST_REQUIRE_EQUAL(1, result.size());
+            assert_that(sstable_reader(result[0], s, env.make_reader_permit()))
+                    .produces(mut3)
+                    .produces_end_of_stream();
+        }
         {
             // We use int32_t for representing a timestamp in seconds since the
             // UNIX epoch. This timestamp "local_deletion_time" (ldt for short)
@@ -1318,6 +1346,26 @@ SEASTAR_TEST_CASE(get_fully_expired_sstables_test) {
         auto expired_sst = *expired.begin();
         BOOST_REQUIRE(expired_sst == sst1);
     }
+
+    {
+        auto cf = env.make_table_for_tests();
+        auto close_cf = deferred_stop(cf);
+
+        // sst2 holds data older than the tombstones of sst1, but of other partitions,
+        // and the only sstable that overlaps sst1 has newer data only.
+        auto sst1 = add_sstable_for_overlapping_test(env, cf, min_key.key(), keys[1].key(), build_stats(t0, t1, t1));
+        auto sst2 = add_sstable_for_overlapping_test(env, cf, keys[2].key(), max_key.key(), build_stats(t0, t4, std::numeric_limits<int32_t>::max()));
+        auto sst3 = add_sstable_for_overlapping_test(env, cf, min_key.key(), max_key.key(), build_stats(t3, t4, std::numeric_limits<int32_t>::max()));
+        std::vector<sstables::shared_sstable> compacting = { sst1, sst2 };
+        auto expired = get_fully_expired_sstables(cf.as_table_state(), compacting, /*gc before*/gc_clock::from_time_t(15) + cf->schema()->gc_grace_seconds());
+        BOOST_REQUIRE(expired.size() == 1);
+        BOOST_REQUIRE(*expired.begin() == sst1);
+
+        // An sstable overlapping sst1 with data as old as its tombstones may be shadowed by them.
+        auto sst4 = add_sstable_for_overlapping_test(env, cf, keys[1].key(), keys[2].key(), build_stats(t1, t4, std::numeric_limits<int32_t>::max()));
+        expired = get_fully_expired_sstables(cf.as_table_state(), compacting, /*gc before*/gc_clock::from_time_t(15) + cf->schema()->gc_grace_seconds());
+        BOOST_REQUIRE(expired.empty());
+    }
   });
 }
 
@@ -1678,6 +1726,158 @@ SEASTAR_TEST_CASE(size_tiered_beyond_max_threshold_test) {
   });
 }
 
+SEASTAR_TEST_CASE(size_tiered_prefer_overlapping_sstables_test) {
+  return test_env::do_with_async([] (test_env& env) {
+    auto s = schema_builder("tests", "size_tiered_prefer_overlapping_sstables")
+            .with_column("id", utf8_type, column_kind::partition_key)
+            .with_column("value", int32_type).build();
+    auto cf = env.make_table_for_tests(s);
+    auto stop_cf = deferred_stop(cf);
+    auto sst_gen = env.make_sst_factory(s);
+
+    auto make_insert = [&] (sstring key) {
+        mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+        m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), api::new_timestamp());
+        return m;
+    };
+
+    std::vector<sstables::shared_sstable> candidates;
+    std::vector<sstables::shared_sstable> overlapping;
+    // A tier of 5 sstables which share no partition.
+    for (auto i = 0; i < 5; i++) {
+        auto sst = make_sstable_containing(sst_gen, {make_insert(format("disjoint{}", i))});
+        sstables::test(sst).set_data_file_size(100 * 1024 * 1024);
+        candidates.push_back(std::move(sst));
+    }
+    // A tier of 4 sstables which all contain the same partitions.
+    for (auto i = 0; i < 4; i++) {
+        std::vector<mutation> muts;
+        for (auto k = 0; k < 20; k++) {
+            muts.push_back(make_insert(format("shared{}", k)));
+        }
+        auto sst = make_sstable_containing(sst_gen, std::move(muts));
+        sstables::test(sst).set_data_file_size(1024 * 1024 * 1024);
+        overlapping.push_back(sst);
+        candidates.push_back(std::move(sst));
+    }
+
+    auto by_size = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+    auto desc = get_sstables_for_compaction(by_size, cf.as_table_state(), candidates);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), 5u);
+
+    auto by_overlap = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {{"prefer_overlapping_sstables", "true"}});
+    desc = get_sstables_for_compaction(by_overlap, cf.as_table_state(), candidates);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), 4u);
+    BOOST_REQUIRE(std::ranges::is_permutation(desc.sstables, overlapping));
+  });
+}
+
+SEASTAR_TEST_CASE(repaired_sstables_are_compacted_separately_test) {
+  return test_env::do_with_async([] (test_env& env) {
+    auto s = schema_builder("tests", "repaired_sstables_are_compacted_separately")
+            .with_column("id", utf8_type, column_kind::partition_key)
+            .with_column("value", int32_type).build();
+    auto cf = env.make_table_for_tests(s);
+    auto stop_cf = deferred_stop(cf);
+    auto sst_gen = env.make_sst_factory(s);
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+
+    auto make_sstable = [&, key = 0] (uint64_t repaired_at) mutable {
+        mutation m(s, partition_key::from_exploded(*s, {to_bytes(format("key{}", key++))}));
+        m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), api::new_timestamp());
+        auto sst = make_sstable_containing(sst_gen, {std::move(m)});
+        if (repaired_at) {
+            sst->mutate_repaired_at(repaired_at).get();
+        }
+        BOOST_REQUIRE_EQUAL(sst->get_repaired_at(), repaired_at);
+        // All in the same size tier.
+        sstables::test(sst).set_data_file_size(1024 * 1024);
+        return sst;
+    };
+
+    std::vector<sstables::shared_sstable> unrepaired;
+    std::vector<sstables::shared_sstable> repaired;
+    for (auto i = 0; i < 4; i++) {
+        unrepaired.push_back(make_sstable(0));
+        repaired.push_back(make_sstable(1000 + i));
+    }
+    auto candidates = unrepaired;
+    candidates.insert(candidates.end(), repaired.begin(), repaired.end());
+
+    // The unrepaired data goes first.
+    auto desc = get_sstables_for_compaction(cs, cf.as_table_state(), candidates);
+    BOOST_REQUIRE(std::ranges::is_permutation(desc.sstables, unrepaired));
+
+    // Without enough unrepaired sstables for a job, the repaired ones are
+    // compacted, but never together with the unrepaired ones.
+    candidates.erase(candidates.begin());
+    desc = get_sstables_for_compaction(cs, cf.as_table_state(), candidates);
+    BOOST_REQUIRE(std::ranges::is_permutation(desc.sstables, repaired));
+
+    candidates.resize(candidates.size() - 1);
+    desc = get_sstables_for_compaction(cs, cf.as_table_state(), candidates);
+    BOOST_REQUIRE(desc.sstables.empty());
+
+    // The output is repaired as of the oldest repair of the input, unless
+    // some of the input is unrepaired.
+    auto compact = [&] (std::vector<sstables::shared_sstable> input) {
+        auto result = compact_sstables(sstables::compaction_descriptor(std::move(input)), cf, sst_gen).get();
+        BOOST_REQUIRE_EQUAL(result.new_sstables.size(), 1);
+        return result.new_sstables.front()->get_repaired_at();
+    };
+    BOOST_REQUIRE_EQUAL(compact(repaired), 1000);
+    BOOST_REQUIRE_EQUAL(compact({repaired.back(), unrepaired.back()}), 0);
+  });
+}
+
+SEASTAR_TEST_CASE(incremental_compaction_strategy_test) {
+  return test_env::do_with_async([] (test_env& env) {
+    auto cf = env.make_table_for_tests();
+    auto stop_cf = deferred_stop(cf);
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, {{"sstable_size_in_mb", "1"}});
+    const uint64_t fragment_size = 1024 * 1024;
+
+    std::vector<sstables::shared_sstable> candidates;
+    auto add_run = [&] (size_t fragments, uint64_t size) {
+        auto run_identifier = sstables::run_id::create_random_id();
+        for (size_t i = 0; i < fragments; i++) {
+            auto sst = cf.make_sstable();
+            sstables::test(sst).set_data_file_size(size);
+            sstables::test(sst).set_run_identifier(run_identifier);
+            candidates.push_back(std::move(sst));
+        }
+    };
+    // A 1GB run, in a tier of its own.
+    add_run(1, 1000 * fragment_size);
+    auto big_run = candidates.front();
+
+    auto backlog_tracker = cs.make_backlog_tracker();
+    backlog_tracker.replace_sstables({}, candidates);
+    BOOST_REQUIRE_EQUAL(backlog_tracker.backlog(), 0);
+
+    // 4 runs of 100MB, which STCS would see as 400 small sstables.
+    auto old_candidates = candidates;
+    for (auto i = 0; i < 4; i++) {
+        add_run(100, fragment_size);
+    }
+    backlog_tracker.replace_sstables(old_candidates, candidates);
+    BOOST_REQUIRE_GT(backlog_tracker.backlog(), 0);
+
+    auto desc = get_sstables_for_compaction(cs, cf.as_table_state(), candidates);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), 400u);
+    BOOST_REQUIRE_EQUAL(desc.fan_in(), 4u);
+    BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, fragment_size);
+    BOOST_REQUIRE(std::ranges::find(desc.sstables, big_run) == desc.sstables.end());
+
+    auto cleanup_jobs = cs.get_cleanup_compaction_jobs(cf.as_table_state(), candidates);
+    BOOST_REQUIRE_EQUAL(cleanup_jobs.size(), 5u);
+    for (auto& job : cleanup_jobs) {
+        BOOST_REQUIRE_EQUAL(job.fan_in(), 1u);
+        BOOST_REQUIRE(job.run_identifier == job.sstables.front()->run_identifier());
+    }
+  });
+}
+
 SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     return test_env::do_with_async([] (test_env& env) {
         auto make_schema = [&] (std::string_view cf, sstables::compaction_strategy_type cst) {
@@ -4573,6 +4773,24 @@ SEASTAR_TEST_CASE(simple_backlog_controller_test) {
     });
 }
 
+SEASTAR_TEST_CASE(read_amplification_backlog_test) {
+    constexpr float threshold = 4;
+    // Disabled
+    BOOST_REQUIRE_EQUAL(compaction_controller::read_amplification_backlog(100, 0), 0.0f);
+    // At or below the threshold, reads don't contribute
+    BOOST_REQUIRE_EQUAL(compaction_controller::read_amplification_backlog(0, threshold), 0.0f);
+    BOOST_REQUIRE_EQUAL(compaction_controller::read_amplification_backlog(threshold, threshold), 0.0f);
+    // Grows with the read amplification
+    auto b1 = compaction_controller::read_amplification_backlog(threshold + 1, threshold);
+    auto b2 = compaction_controller::read_amplification_backlog(threshold + 2, threshold);
+    BOOST_REQUIRE_GT(b1, 0.0f);
+    BOOST_REQUIRE_GT(b2, b1);
+    // Reaches the maximum output at four times the threshold, and stays there
+    BOOST_REQUIRE_EQUAL(compaction_controller::read_amplification_backlog(4 * threshold, threshold), compaction_controller::normalization_factor);
+    BOOST_REQUIRE_EQUAL(compaction_controller::read_amplification_backlog(10 * threshold, threshold), compaction_controller::normalization_factor);
+    return make_ready_future<>();
+}
+
 SEASTAR_TEST_CASE(test_compaction_strategy_cleanup_method) {
     return test_env::do_with_async([] (test_env& env) {
         constexpr size_t all_files = 64;
@@ -5308,3 +5526,190 @@ SEASTAR_TEST_CASE(produces_optimal_filter_by_estimating_correctly_partitions_per
         BOOST_REQUIRE(comp.components->filter->memory_size() >= filter->memory_size());
     });
 }
+
+SEASTAR_TEST_CASE(major_compaction_in_sub_ranges_test) {
+    cql_test_config test_cfg;
+
+    auto& db_cfg = *test_cfg.db_config;
+    db_cfg.major_compaction_max_parallelism(4);
+    db_cfg.major_compaction_min_split_size_in_mb(0);
+    db_cfg.enable_commitlog(false);
+
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.cf (pk int PRIMARY KEY, v int) WITH compaction = {'class': 'NullCompactionStrategy'};").get();
+        auto& t = e.local_db().find_column_family("ks", "cf");
+
+        static constexpr int keys_nr = 1000;
+        static constexpr int rounds_nr = 4;
+        for (int round = 0; round < rounds_nr; round++) {
+            for (int pk = 0; pk < keys_nr; pk++) {
+                e.execute_cql(format("INSERT INTO ks.cf (pk, v) VALUES ({}, {});", pk, round)).get();
+            }
+            t.flush().get();
+        }
+        BOOST_REQUIRE_EQUAL(t.get_sstables()->size(), size_t(rounds_nr));
+
+        t.compact_all_sstables().get();
+
+        // One output per sub-range, replacing all the input.
+        testlog.info("sstables after major compaction: {}", t.get_sstables()->size());
+        BOOST_REQUIRE_EQUAL(t.get_sstables()->size(), 4u);
+
+        assert_that(e.execute_cql("SELECT count(*) FROM ks.cf;").get0())
+            .is_rows()
+            .with_rows({{long_type->decompose(int64_t(keys_nr))}});
+        assert_that(e.execute_cql(format("SELECT count(*) FROM ks.cf WHERE v = {} ALLOW FILTERING;", rounds_nr - 1)).get0())
+            .is_rows()
+            .with_rows({{long_type->decompose(int64_t(keys_nr))}});
+    }, test_cfg);
+}
+
+SEASTAR_TEST_CASE(cleanup_skips_sstables_not_requiring_rewrite_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type)
+                .build();
+        auto sst_gen = env.make_sst_factory(s);
+
+        auto keys = tests::generate_partition_keys(30, s);
+        std::sort(keys.begin(), keys.end(), dht::decorated_key::less_comparator(s));
+        auto make_sstable = [&] (size_t first, size_t last) {
+            std::vector<mutation> muts;
+            for (auto i = first; i <= last; i++) {
+                mutation m(s, keys[i]);
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(i)), api::new_timestamp());
+                muts.push_back(std::move(m));
+            }
+            return make_sstable_containing(sst_gen, std::move(muts));
+        };
+        auto owned_range = [&] (size_t first, size_t last) {
+            return dht::token_range::make(keys[first].token(), keys[last].token());
+        };
+
+        // The owned ranges leave a gap between keys 4 and 5, which holds no partition.
+        auto owned_ranges = compaction::make_owned_ranges_ptr({ owned_range(0, 4), owned_range(5, 9), owned_range(20, 24) });
+        // Spans the gap, so it requires cleanup, but holds no unowned data.
+        auto kept = make_sstable(0, 9);
+        // Holds no owned data.
+        auto dropped = make_sstable(10, 19);
+        // Holds both owned and unowned data.
+        auto rewritten = make_sstable(20, 29);
+
+        auto t = env.make_table_for_tests(s);
+        auto stop = deferred_stop(t);
+        t->disable_auto_compaction().get();
+        auto& cm = t->get_compaction_manager();
+        for (auto& sst : {kept, dropped, rewritten}) {
+            t->add_sstable_and_update_cache(sst).get();
+        }
+        auto dropped_bytes = dropped->data_size();
+        auto kept_bytes = kept->data_size();
+
+        t->perform_cleanup_compaction(std::move(owned_ranges)).get();
+        BOOST_REQUIRE(cm.sstables_requiring_cleanup(t->as_table_state()).empty());
+        BOOST_REQUIRE_EQUAL(cm.get_stats().cleanup_dropped_sstables, 1u);
+        BOOST_REQUIRE_GT(cm.get_stats().cleanup_skipped_bytes, dropped_bytes + kept_bytes);
+
+        auto sstables = t->get_sstables();
+        BOOST_REQUIRE_EQUAL(sstables->size(), 2u);
+        BOOST_REQUIRE(sstables->contains(kept));
+        BOOST_REQUIRE(!sstables->contains(dropped));
+        BOOST_REQUIRE(!sstables->contains(rewritten));
+
+        auto new_sst = *std::ranges::find_if(*sstables, [&] (const shared_sstable& sst) { return sst != kept; });
+        auto reader = assert_that(new_sst->as_mutation_source().make_reader_v2(s, env.make_reader_permit()));
+        for (size_t i = 20; i <= 24; i++) {
+            reader.produces(keys[i]);
+        }
+        reader.produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(resume_interrupted_compaction_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type)
+                .build();
+        auto sst_gen = env.make_sst_factory(s);
+
+        auto keys = tests::generate_partition_keys(100, s);
+        std::sort(keys.begin(), keys.end(), dht::decorated_key::less_comparator(s));
+        std::vector<mutation> latest;
+        auto make_sstable = [&] (int32_t value) {
+            std::vector<mutation> muts;
+            for (auto& key : keys) {
+                mutation m(s, key);
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(value), api::new_timestamp());
+                muts.push_back(std::move(m));
+            }
+            latest = muts;
+            return make_sstable_containing(sst_gen, std::move(muts));
+        };
+        auto inputs = std::vector<shared_sstable>{ make_sstable(1), make_sstable(2) };
+        auto max_sstable_size = inputs.front()->ondisk_data_size() / 5;
+
+        auto t = env.make_table_for_tests(s);
+        auto stop = deferred_stop(t);
+        t->disable_auto_compaction().get();
+        for (auto& sst : inputs) {
+            t->add_sstable_and_update_cache(sst).get();
+        }
+
+        auto desc = sstables::compaction_descriptor(inputs, 0, max_sstable_size);
+        auto run = desc.run_identifier;
+        auto output = compact_sstables(std::move(desc), t, sst_gen).get0().new_sstables;
+        BOOST_REQUIRE_GT(output.size(), 2u);
+        for (auto& sst : output) {
+            auto* checkpoint = sst->get_compaction_checkpoint();
+            BOOST_REQUIRE(checkpoint);
+            BOOST_REQUIRE_EQUAL(checkpoint->inputs.elements.size(), inputs.size());
+            BOOST_REQUIRE_EQUAL(checkpoint->max_sstable_size, max_sstable_size);
+        }
+
+        // Nothing to resume while no output is present.
+        auto& cm = t->get_compaction_manager();
+        BOOST_REQUIRE(cm.get_resumable_compaction_job(t.as_table_state()).sstables.empty());
+
+        // Simulate a compaction stopped by a shutdown after sealing its first two output sstables.
+        std::sort(output.begin(), output.end(), [&] (const shared_sstable& a, const shared_sstable& b) {
+            return a->get_first_decorated_key().tri_compare(*s, b->get_first_decorated_key()) < 0;
+        });
+        auto kept = std::vector<shared_sstable>(output.begin(), output.begin() + 2);
+        for (auto& sst : kept) {
+            t->add_sstable_and_update_cache(sst).get();
+        }
+
+        auto resume = cm.get_resumable_compaction_job(t.as_table_state());
+        BOOST_REQUIRE_EQUAL(resume.sstables.size(), inputs.size());
+        for (auto& sst : inputs) {
+            BOOST_REQUIRE(std::ranges::find(resume.sstables, sst) != resume.sstables.end());
+        }
+        BOOST_REQUIRE_EQUAL(resume.run_identifier, run);
+        BOOST_REQUIRE_EQUAL(resume.max_sstable_bytes, max_sstable_size);
+        BOOST_REQUIRE(resume.resume_after);
+        BOOST_REQUIRE(resume.resume_after->equal(*s, kept.back()->get_last_decorated_key()));
+
+        auto resumed = compact_sstables(std::move(resume), t, sst_gen).get0().new_sstables;
+        BOOST_REQUIRE(!resumed.empty());
+        std::sort(resumed.begin(), resumed.end(), [&] (const shared_sstable& a, const shared_sstable& b) {
+            return a->get_first_decorated_key().tri_compare(*s, b->get_first_decorated_key()) < 0;
+        });
+
+        // The kept and the resumed outputs make up a single run holding every partition once, with its latest value.
+        auto all = kept;
+        all.insert(all.end(), resumed.begin(), resumed.end());
+        size_t i = 0;
+        for (auto& sst : all) {
+            BOOST_REQUIRE_EQUAL(sst->run_identifier(), run);
+            auto reader = sstable_reader(sst, s, env.make_reader_permit());
+            auto close_reader = deferred_close(reader);
+            while (auto m = read_mutation_from_flat_mutation_reader(reader).get()) {
+                BOOST_REQUIRE_LT(i, latest.size());
+                BOOST_REQUIRE_EQUAL(*m, latest[i++]);
+            }
+        }
+        BOOST_REQUIRE_EQUAL(i, latest.size());
+    });
+}
@@ -293,3 +293,39 @@ SEASTAR_THREAD_TEST_CASE(test_sstable_reversing_reader_random_schema) {
         }
     }).get();
 }
+
+// Reversed reads of multiple partitions shouldn't have to fit whole partitions
+// in memory, see reversed_multi_partition_reader.
+SEASTAR_THREAD_TEST_CASE(test_sstable_reversed_multi_partition_read_of_wide_partitions) {
+    simple_schema s;
+    auto query_schema = s.schema()->make_reversed();
+    const sstring value(1024, 'v');
+
+    std::vector<mutation> muts;
+    for (auto& pk : s.make_pkeys(3)) {
+        mutation m(s.schema(), pk);
+        for (int ck = 0; ck < 256; ++ck) {
+            s.add_row(m, s.make_ckey(ck), value);
+        }
+        muts.push_back(std::move(m));
+    }
+
+    auto rev_full_slice = native_reverse_slice_to_legacy_reverse_slice(*query_schema, query_schema->full_slice());
+    rev_full_slice.options.set(query::partition_slice::option::reversed);
+
+    sstables::test_env::do_with_async([&, version = writable_sstable_versions[1]] (sstables::test_env& env) {
+        tmpdir dir;
+        auto source = make_sstable_mutation_source(env, s.schema(), dir.path().string(), muts, env.manager().configure_writer(), version);
+
+        // Each partition is several times larger than the limit.
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+        auto permit = semaphore.make_permit();
+        permit.set_max_result_size(query::max_result_size(64 * 1024, 128 * 1024));
+
+        auto rd = assert_that(source.make_reader_v2(query_schema, permit, query::full_partition_range, rev_full_slice));
+        for (auto& m : muts) {
+            rd.produces(reverse(m));
+        }
+        rd.produces_end_of_stream();
+    }).get();
+}
@@ -52,6 +52,7 @@
 #include "readers/from_fragments_v2.hh"
 #include "test/lib/random_schema.hh"
 #include "test/lib/exception_utils.hh"
+#include "test/lib/eventually.hh"
 
 namespace fs = std::filesystem;
 
@@ -3193,3 +3194,42 @@ SEASTAR_TEST_CASE(test_sstable_set_predicate) {
         }
     });
 }
+
+SEASTAR_TEST_CASE(test_bloom_filter_reclaim_and_reload) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto& mgr = env.manager();
+
+        auto make_sst = [&] {
+            mutation m(s, ss.make_pkey());
+            ss.add_row(m, ss.make_ckey(0), "v");
+            return make_sstable_containing(env.make_sstable(s), {std::move(m)});
+        };
+
+        auto sst1 = make_sst();
+        auto filter_size = sst1->filter_memory_size();
+        BOOST_REQUIRE_GT(filter_size, 0);
+        BOOST_REQUIRE_EQUAL(mgr.get_total_reclaimable_memory(), filter_size);
+        BOOST_REQUIRE_EQUAL(mgr.get_total_memory_reclaimed(), 0);
+
+        // Leave room for one and a half filters, so that opening a second
+        // sstable forces one of the filters out of memory.
+        env.db_config().components_memory_reclaim_threshold.set(1.5 * filter_size / memory::stats().total_memory());
+        auto sst2 = make_sst();
+        BOOST_REQUIRE_EQUAL(mgr.get_total_reclaimable_memory(), filter_size);
+        BOOST_REQUIRE_EQUAL(mgr.get_total_memory_reclaimed(), filter_size);
+        auto& reclaimed = sst1->filter_memory_size() ? sst2 : sst1;
+        auto& resident = sst1->filter_memory_size() ? sst1 : sst2;
+        BOOST_REQUIRE_EQUAL(reclaimed->filter_memory_size(), 0);
+
+        // Reads keep working from an sstable without a filter in memory.
+        BOOST_REQUIRE(reclaimed->filter_has_key(*s, reclaimed->get_first_partition_key()));
+
+        // Releasing the resident sstable makes room for the reclaimed filter.
+        resident = {};
+        REQUIRE_EVENTUALLY_EQUAL(reclaimed->filter_memory_size(), filter_size);
+        BOOST_REQUIRE_EQUAL(mgr.get_total_reclaimable_memory(), filter_size);
+        BOOST_REQUIRE_EQUAL(mgr.get_total_memory_reclaimed(), 0);
+    });
+}
@@ -15,6 +15,7 @@
 #include "sstables/shared_sstable.hh"
 #include "sstables/sstable_directory.hh"
 #include "replica/distributed_loader.hh"
+#include "compaction/table_state.hh"
 #include "test/lib/sstable_utils.hh"
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/tmpdir.hh"
@@ -26,6 +27,8 @@
 
 #include <fmt/core.h>
 #include <boost/algorithm/string/erase.hpp>
+#include <ranges>
+#include <unordered_set>
 
 class distributed_loader_for_tests {
 public:
@@ -38,6 +41,9 @@ class distributed_loader_for_tests {
     static future<> reshard(sharded<sstables::sstable_directory>& dir, sharded<replica::database>& db, sstring ks_name, sstring table_name, sstables::compaction_sstable_creator_fn creator, compaction::owned_ranges_ptr owned_ranges_ptr = nullptr) {
         return replica::distributed_loader::reshard(dir, db, std::move(ks_name), std::move(table_name), std::move(creator), std::move(owned_ranges_ptr));
     }
+    static future<> balance_unsorted_sstables(sharded<sstables::sstable_directory>& dir, sstables::sstable_open_config cfg) {
+        return replica::distributed_loader::balance_unsorted_sstables(dir, cfg);
+    }
 };
 
 schema_ptr test_table_schema() {
@@ -74,6 +80,19 @@ make_sstable_for_this_shard(std::function<sstables::shared_sstable()> sst_factor
     return make_sstable_containing(sst_factory, {m});
 }
 
+// Must be called from a seastar thread.
+static sstables::shared_sstable
+make_sstable_with_partitions(std::function<sstables::shared_sstable()> sst_factory, size_t nr_partitions) {
+    auto s = test_table_schema();
+    std::vector<mutation> muts;
+    for (auto& key : tests::generate_partition_keys(nr_partitions, s)) {
+        mutation m(s, key);
+        m.set_clustered_cell(clustering_key::make_empty(), bytes("c"), data_value(int32_t(0)), api::timestamp_type(0));
+        muts.push_back(std::move(m));
+    }
+    return make_sstable_containing(sst_factory, std::move(muts));
+}
+
 /// Create a shared SSTable belonging to all shards for the following schema: "create table cf (p text PRIMARY KEY, c int)"
 ///
 /// Arguments passed to the function are passed to table::make_sstable
@@ -778,3 +797,100 @@ SEASTAR_THREAD_TEST_CASE(test_system_datadir_layout) {
         BOOST_REQUIRE(!file_exists(tbl_dirname.native()).get());
     }, cfg).get();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_background_reshape_keeps_overlapping_sstables_in_main_set) {
+    sstring ks = "ks";
+    sstring cf = "test";
+    tmpdir data_dir;
+    cql_test_config cfg;
+    cfg.db_config->data_file_directories({
+        data_dir.path().native(),
+    }, db::config::config_source::CommandLine);
+    cfg.db_config->enable_background_reshape.set(true);
+
+    // Every flush writes the same keys, so the sstables all overlap.
+    do_with_cql_env_thread([&] (cql_test_env& e) {
+        e.execute_cql(format("create table {}.{} (p text PRIMARY KEY, c int) with compaction = {{'class': 'SizeTieredCompactionStrategy', 'enabled': 'false'}}", ks, cf)).get();
+        for (int i = 0; i < 4; i++) {
+            e.execute_cql(format("insert into {}.{} (p, c) values ('one', {})", ks, cf, i)).get();
+            e.execute_cql(format("insert into {}.{} (p, c) values ('two', {})", ks, cf, i)).get();
+            e.db().invoke_on_all([&] (replica::database& db) {
+                return db.find_column_family(ks, cf).flush();
+            }).get();
+        }
+    }, cfg).get();
+
+    do_with_cql_env_thread([&] (cql_test_env& e) {
+        e.db().invoke_on_all([&] (replica::database& db) {
+            auto& t = db.find_column_family(ks, cf);
+            return t.parallel_foreach_table_state([] (compaction::table_state& ts) {
+                BOOST_REQUIRE_EQUAL(ts.maintenance_sstable_set().size(), 0);
+                return make_ready_future<>();
+            });
+        }).get();
+        size_t main_sstables = e.db().map_reduce0([&] (replica::database& db) {
+            return db.find_column_family(ks, cf).get_sstable_set().size();
+        }, size_t(0), std::plus<size_t>()).get();
+        BOOST_REQUIRE_GE(main_sstables, 4);
+
+        auto res = e.execute_cql(format("select * from {}.{}", ks, cf)).get();
+        assert_that(res).is_rows().with_size(2).with_rows_ignore_order({
+            { utf8_type->decompose("one"), int32_type->decompose(3) },
+            { utf8_type->decompose("two"), int32_type->decompose(3) }
+        });
+    }, cfg).get();
+}
+
+// Test that the unsorted SSTables found by the shards are spread so that every
+// shard gets about the same amount of data, and that the SSTables moved to
+// another shard are loaded there.
+SEASTAR_THREAD_TEST_CASE(sstable_directory_balance_unsorted_sstables) {
+    sstables::test_env::do_with_sharded_async([] (sharded<test_env>& env) {
+        auto& dir = env.local().tempdir();
+
+        sharded<sstables::sstable_generation_generator> sharded_gen;
+        sharded_gen.start(0).get();
+        auto stop_generator = deferred_stop(sharded_gen);
+
+        // SSTables of growing sizes, so that the shards find uneven amounts of data.
+        const unsigned nr_sstables = 4 * smp::count;
+        std::unordered_map<sstables::generation_type, uint64_t> sizes;
+        for (unsigned i = 0; i < nr_sstables; ++i) {
+            auto generation = sharded_gen.invoke_on(0, [] (auto& gen) {
+                return gen(sstables::uuid_identifiers::no);
+            }).get();
+            auto sst = make_sstable_with_partitions(std::bind(new_sstable, std::ref(env.local()), dir.path(), generation), (i + 1) * 10);
+            sizes.emplace(generation, sst->data_size());
+        }
+        const uint64_t max_size = std::ranges::max(sizes | std::views::values);
+
+        with_sstable_directory(dir.path(), sstables::sstable_state::normal, env, [&] (sharded<sstables::sstable_directory>& sstdir) {
+            distributed_loader_for_tests::process_sstable_dir(sstdir, { .sort_sstables_according_to_owner = false }).get();
+            distributed_loader_for_tests::balance_unsorted_sstables(sstdir, {}).get();
+
+            auto shard_sstables = sstdir.map([] (sstables::sstable_directory& d) {
+                std::vector<std::pair<sstables::generation_type, uint64_t>> ret;
+                for (auto& sst : d.get_unsorted_sstables()) {
+                    ret.emplace_back(sst->generation(), sst->data_size());
+                }
+                return ret;
+            }).get();
+
+            std::unordered_set<sstables::generation_type> seen;
+            std::vector<uint64_t> loads;
+            for (auto& sstables : shard_sstables) {
+                uint64_t load = 0;
+                for (auto& [generation, size] : sstables) {
+                    BOOST_REQUIRE(seen.insert(generation).second);
+                    BOOST_REQUIRE_EQUAL(size, sizes.at(generation));
+                    load += size;
+                }
+                loads.push_back(load);
+            }
+            BOOST_REQUIRE_EQUAL(seen.size(), nr_sstables);
+            // Placing the largest SSTables first, each on the least loaded shard,
+            // keeps the shards within one SSTable of each other.
+            BOOST_REQUIRE_LE(std::ranges::max(loads) - std::ranges::min(loads), max_size);
+        });
+    }).get();
+}
@@ -19,6 +19,8 @@
 #include <seastar/core/do_with.hh>
 #include <seastar/core/thread.hh>
 #include "sstables/sstables.hh"
+#include "sstables/sstable_set.hh"
+#include "sstables/metadata_collector.hh"
 #include "replica/database.hh"
 #include "timestamp.hh"
 #include "schema/schema_builder.hh"
@@ -969,6 +971,102 @@ SEASTAR_TEST_CASE(test_promoted_index_blocks_are_monotonic_with_auto_scaling) {
     });
 }
 
+SEASTAR_TEST_CASE(test_promoted_index_initial_block_size) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("p", int32_type, column_kind::partition_key)
+                .with_column("c", int32_type, column_kind::clustering_key)
+                .with_column("v", bytes_type)
+                .set_compressor_params(compression_parameters::no_compression())
+                .build();
+        auto make_ck = [&] (int c) {
+            return clustering_key::from_exploded(*s, {int32_type->decompose(c)});
+        };
+
+        // A partition of about 32KiB, below the regular block size.
+        mutation m(s, tests::generate_partition_key(s));
+        for (int c = 0; c < 32; ++c) {
+            m.set_clustered_cell(make_ck(c), *s->get_column_definition("v"), atomic_cell::make_live(*bytes_type, 1, bytes(1024, int8_t(c)), { }));
+        }
+        auto mt = make_lw_shared<replica::memtable>(s);
+        mt->apply(m);
+
+        auto block_offsets = [&] (shared_sstable sst) {
+            auto ir = get_index_reader(sst, env.make_reader_permit());
+            auto close_ir = deferred_close(*ir);
+            ir->read_partition_data().get();
+            std::vector<uint64_t> offsets;
+            if (ir->get_promoted_index_size()) {
+                auto* cur = ir->current_clustered_cursor();
+                while (auto ei = cur->next_entry().get0()) {
+                    offsets.push_back(ei->offset);
+                }
+            }
+            return offsets;
+        };
+
+        sstable_writer_config cfg = env.manager().configure_writer();
+        cfg.promoted_index_block_size = 64 * 1024;
+        cfg.promoted_index_initial_block_size = 0;
+        BOOST_REQUIRE(block_offsets(make_sstable_easy(env, mt, cfg)).empty());
+
+        cfg.promoted_index_initial_block_size = 4 * 1024;
+        auto sst = make_sstable_easy(env, mt, cfg);
+        auto offsets = block_offsets(sst);
+        // Blocks of about 4, 8 and 16KiB, and the remainder.
+        BOOST_REQUIRE_EQUAL(offsets.size(), 4);
+        for (size_t i = 2; i < offsets.size(); ++i) {
+            BOOST_REQUIRE_GT(offsets[i] - offsets[i - 1], offsets[i - 1] - offsets[i - 2]);
+        }
+        assert_that(get_index_reader(sst, env.make_reader_permit())).has_monotonic_positions(*s);
+
+        auto ranges = query::clustering_row_ranges{query::clustering_range::make_starting_with(make_ck(20))};
+        auto slice = partition_slice_builder(*s).with_ranges(ranges).build();
+        assert_that(sst->as_mutation_source().make_reader_v2(s, env.make_reader_permit(), dht::partition_range::make_singular(m.decorated_key()), slice))
+                .produces(m, ranges)
+                .produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(test_clustered_seek_hints) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("p", int32_type, column_kind::partition_key)
+                .with_column("c", int32_type, column_kind::clustering_key)
+                .with_column("v", bytes_type)
+                .build();
+        auto make_ck = [&] (int c) {
+            return clustering_key::from_exploded(*s, {int32_type->decompose(c)});
+        };
+
+        mutation m(s, tests::generate_partition_key(s));
+        for (int c = 0; c < 512; ++c) {
+            m.set_clustered_cell(make_ck(c), *s->get_column_definition("v"), atomic_cell::make_live(*bytes_type, 1, bytes(64, int8_t(c)), { }));
+        }
+        auto mt = make_lw_shared<replica::memtable>(s);
+        mt->apply(m);
+
+        sstable_writer_config cfg = env.manager().configure_writer();
+        cfg.promoted_index_block_size = 100;
+        auto sst = make_sstable_easy(env, mt, cfg);
+
+        // Each read starts where the hints left by the previous one point, going forward
+        // by pages of growing size, then backwards, and past the last block.
+        auto read_from = [&] (int start, int end) {
+            auto ranges = query::clustering_row_ranges{query::clustering_range::make(
+                    {make_ck(start), true}, {make_ck(end), false})};
+            auto slice = partition_slice_builder(*s).with_ranges(ranges).build();
+            assert_that(sst->as_mutation_source().make_reader_v2(s, env.make_reader_permit(), dht::partition_range::make_singular(m.decorated_key()), slice))
+                    .produces(m, ranges)
+                    .produces_end_of_stream();
+        };
+        for (int start : {0, 1, 2, 10, 11, 40, 200, 201, 500, 300, 5, 0, 511, 100}) {
+            testlog.trace("reading from {}", start);
+            read_from(start, std::min(start + 7, 512));
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(test_promoted_index_blocks_are_monotonic_compound_dense) {
    return test_env::do_with_async([] (test_env& env) {
       for (const auto version : writable_sstable_versions) {
@@ -1287,7 +1385,8 @@ SEASTAR_TEST_CASE(test_key_count_estimation) {
             {
                 auto est = sst->estimated_keys_for_range(dht::token_range::make_open_ended_both_sides());
                 testlog.trace("est([-inf; +inf]) = {}", est);
-                BOOST_REQUIRE_EQUAL(est, sst->get_estimated_key_count());
+                // Exact when the partition counts of the summary entries are available
+                BOOST_REQUIRE_EQUAL(est, sst->get_summary_entry_stats() ? count : sst->get_estimated_key_count());
             }
 
             for (int size : {1, 64, 256, 512, 1024, 4096, count}) {
@@ -1325,6 +1424,50 @@ SEASTAR_TEST_CASE(test_key_count_estimation) {
     });
 }
 
+SEASTAR_TEST_CASE(test_size_estimation_with_skewed_partitions) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cf")
+            .with_column("pk", bytes_type, column_kind::partition_key)
+            .with_column("v", bytes_type)
+            .build();
+
+        // The partitions of the first half of the token range are small,
+        // those of the second half are large.
+        const size_t count = 2'000;
+        const size_t large_value_size = 10'000;
+        std::vector<dht::decorated_key> pks = tests::generate_partition_keys(count, s, local_shard_only::yes, tests::key_size{8, 8});
+        auto mt = make_lw_shared<replica::memtable>(s);
+        for (size_t i = 0; i < count; ++i) {
+            mutation m(s, pks[i]);
+            auto value = bytes(i < count / 2 ? 1 : large_value_size, int8_t(i));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("v"), data_value(std::move(value)), 1 /* ts */);
+            mt->apply(m);
+        }
+
+        auto _ = env.tempdir().make_sweeper();
+        shared_sstable sst = make_sstable_easy(env, mt, env.manager().configure_writer(), sstables::get_highest_sstable_version(), count);
+        BOOST_REQUIRE(sst->get_summary_entry_stats());
+
+        auto full = dht::token_range::make_open_ended_both_sides();
+        BOOST_REQUIRE_EQUAL(sst->estimated_keys_for_range(full), count);
+        BOOST_REQUIRE_GE(sst->estimated_size_for_range(full), count / 2 * large_value_size);
+
+        auto small_half = dht::token_range::make(pks[0].token(), pks[count / 2 - 1].token());
+        auto large_half = dht::token_range::make(pks[count / 2].token(), pks[count - 1].token());
+        auto small_keys = sst->estimated_keys_for_range(small_half);
+        auto large_keys = sst->estimated_keys_for_range(large_half);
+        testlog.info("small half: {} keys, {} bytes; large half: {} keys, {} bytes",
+                small_keys, sst->estimated_size_for_range(small_half), large_keys, sst->estimated_size_for_range(large_half));
+        // Each estimate may include the partitions of the summary entry which
+        // straddles both halves, i.e. a single large partition at most.
+        BOOST_REQUIRE_GE(small_keys, count / 2);
+        BOOST_REQUIRE_LE(small_keys, count / 2 + count / 10);
+        BOOST_REQUIRE_GE(large_keys, count / 2);
+        BOOST_REQUIRE_LE(large_keys, count / 2 + count / 10);
+        BOOST_REQUIRE_GT(sst->estimated_size_for_range(large_half), 10 * sst->estimated_size_for_range(small_half));
+    });
+}
+
 SEASTAR_TEST_CASE(test_large_index_pages_do_not_cause_large_allocations) {
   return test_env::do_with_async([] (test_env& env) {
     // We create a sequence of partitions such that first we have a partition with a very long key, then
@@ -1643,3 +1786,252 @@ SEASTAR_TEST_CASE(writer_handles_subsequent_range_tombstone_changes_without_tomb
     });
 }
 
+
+SEASTAR_TEST_CASE(test_clustering_filter) {
+    return test_env::do_with_async([] (test_env& env) {
+      for (const auto version : writable_sstable_versions) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("p", int32_type, column_kind::partition_key)
+                .with_column("c", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type)
+                .build();
+        auto make_ck = [&] (int c) {
+            return clustering_key::from_exploded(*s, {int32_type->decompose(c)});
+        };
+        auto keys = tests::generate_partition_keys(2, s);
+        auto cell = atomic_cell::make_live(*int32_type, 1, int32_type->decompose(88), { });
+
+        // No row 5 in either partition, but a range tombstone covers it in the second one.
+        mutation m1(s, keys[0]);
+        mutation m2(s, keys[1]);
+        for (int c = 0; c < 10; ++c) {
+            if (c != 5) {
+                m1.set_clustered_cell(make_ck(c), *s->get_column_definition("v"), atomic_cell(*int32_type, cell));
+                m2.set_clustered_cell(make_ck(c), *s->get_column_definition("v"), atomic_cell(*int32_type, cell));
+            }
+        }
+        m2.partition().apply_row_tombstone(*s, range_tombstone(make_ck(4), bound_kind::incl_start, make_ck(6), bound_kind::incl_end, {1, gc_clock::now()}));
+
+        auto mt = make_lw_shared<replica::memtable>(s);
+        mt->apply(m1);
+        mt->apply(m2);
+        sstable_writer_config cfg = env.manager().configure_writer();
+        cfg.promoted_index_block_size = 1;
+        cfg.clustering_filter = true;
+        auto sst = env.reusable_sst(make_sstable_easy(env, mt, cfg, version)).get();
+
+        BOOST_REQUIRE(sst->has_component(component_type::ClusteringFilter));
+        BOOST_REQUIRE(sst->has_clustering_filter());
+
+        auto read_row = [&] (const mutation& m, int c) {
+            auto ranges = query::clustering_row_ranges{query::clustering_range::make_singular(make_ck(c))};
+            auto slice = partition_slice_builder(*s).with_ranges(ranges).build();
+            auto skips_before = sstables_stats::get_shard_stats().clustering_filter_skips;
+            assert_that(sst->as_mutation_source().make_reader_v2(s, env.make_reader_permit(), dht::partition_range::make_singular(m.decorated_key()), slice))
+                    .produces(m, ranges)
+                    .produces_end_of_stream();
+            return sstables_stats::get_shard_stats().clustering_filter_skips - skips_before;
+        };
+
+        BOOST_REQUIRE_EQUAL(read_row(m1, 3), 0);
+        BOOST_REQUIRE_EQUAL(read_row(m1, 5), 1);
+        BOOST_REQUIRE_EQUAL(read_row(m2, 3), 0);
+        // The range tombstone disables the filter for the second partition.
+        BOOST_REQUIRE_EQUAL(read_row(m2, 5), 0);
+      }
+    });
+}
+
+SEASTAR_TEST_CASE(test_write_batching) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("p", int32_type, column_kind::partition_key)
+                .with_column("c", int32_type, column_kind::clustering_key)
+                .with_column("v", bytes_type)
+                .set_compressor_params(compression_parameters::no_compression())
+                .build();
+        auto& v_def = *s->get_column_definition("v");
+
+        mutation m(s, tests::generate_partition_key(s));
+        for (int c = 0; c < 64; ++c) {
+            auto ck = clustering_key::from_exploded(*s, {int32_type->decompose(c)});
+            m.set_clustered_cell(ck, v_def, atomic_cell::make_live(*bytes_type, 1, bytes(100 * 1024, int8_t(c)), { }));
+        }
+        auto mt = make_lw_shared<replica::memtable>(s);
+        mt->apply(m);
+
+        auto write = [&] (size_t write_batch_size) {
+            sstable_writer_config cfg = env.manager().configure_writer();
+            cfg.write_batch_size = write_batch_size;
+            cfg.write_behind = 4;
+            cfg.estimated_data_size = 8 << 20;
+            auto writes_before = sstables_stats::get_shard_stats().data_writes;
+            auto bytes_before = sstables_stats::get_shard_stats().data_write_bytes;
+            auto sst = make_sstable_easy(env, mt, cfg);
+            assert_that(sst->as_mutation_source().make_reader_v2(s, env.make_reader_permit()))
+                    .produces(m)
+                    .produces_end_of_stream();
+            BOOST_REQUIRE_EQUAL(sstables_stats::get_shard_stats().data_writes_in_flight, 0);
+            auto writes = sstables_stats::get_shard_stats().data_writes - writes_before;
+            auto bytes = sstables_stats::get_shard_stats().data_write_bytes - bytes_before;
+            BOOST_REQUIRE_GE(bytes, sst->data_size());
+            return writes;
+        };
+
+        // Larger batches issue fewer writes for the same data.
+        BOOST_REQUIRE_LT(write(4 << 20), write(0));
+    });
+}
+
+SEASTAR_TEST_CASE(test_column_value_stats) {
+    return test_env::do_with_async([] (test_env& env) {
+      for (const auto version : writable_sstable_versions) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("p", int32_type, column_kind::partition_key)
+                .with_column("c", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type)
+                .with_column("t", utf8_type)
+                .build();
+        auto& v_def = *s->get_column_definition("v");
+        auto& t_def = *s->get_column_definition("t");
+        auto make_ck = [&] (int c) {
+            return clustering_key::from_exploded(*s, {int32_type->decompose(c)});
+        };
+        auto v_range = [] (int start, int end) {
+            return interval<bytes>::make(int32_type->decompose(start), int32_type->decompose(end));
+        };
+
+        // Row 7 has no value of v.
+        mutation m(s, tests::generate_partition_key(s));
+        for (int c = 0; c < 8; ++c) {
+            if (c != 7) {
+                m.set_clustered_cell(make_ck(c), v_def, atomic_cell::make_live(*int32_type, 1, int32_type->decompose(c + 3), { }));
+            }
+            m.set_clustered_cell(make_ck(c), t_def, atomic_cell::make_live(*utf8_type, 1, utf8_type->decompose(sstring(format("t{}", c))), { }));
+        }
+        auto make_sst = [&] (const mutation& m, bool column_value_stats) {
+            auto mt = make_lw_shared<replica::memtable>(s);
+            mt->apply(m);
+            sstable_writer_config cfg = env.manager().configure_writer();
+            cfg.column_value_stats = column_value_stats;
+            return env.reusable_sst(make_sstable_easy(env, mt, cfg, version)).get();
+        };
+
+        // Nothing is collected unless enabled.
+        auto sst = make_sst(m, false);
+        BOOST_REQUIRE(!sst->get_column_value_stats(v_def));
+        BOOST_REQUIRE(sst->may_contain_column_value(v_def, v_range(10, 20)));
+
+        sst = make_sst(m, true);
+        auto* v_stats = sst->get_column_value_stats(v_def);
+        BOOST_REQUIRE(v_stats);
+        BOOST_REQUIRE_EQUAL(v_stats->null_count, 1);
+        BOOST_REQUIRE(v_stats->has_min_max);
+        BOOST_REQUIRE(v_stats->min_value.value == int32_type->decompose(3));
+        BOOST_REQUIRE(v_stats->max_value.value == int32_type->decompose(9));
+        BOOST_REQUIRE(sst->may_contain_null_column_value(v_def));
+        BOOST_REQUIRE(!sst->may_contain_null_column_value(t_def));
+
+        BOOST_REQUIRE(sst->may_contain_column_value(v_def, v_range(0, 3)));
+        BOOST_REQUIRE(sst->may_contain_column_value(v_def, v_range(9, 20)));
+        BOOST_REQUIRE(!sst->may_contain_column_value(v_def, v_range(10, 20)));
+        BOOST_REQUIRE(!sst->may_contain_column_value(v_def, interval<bytes>::make_ending_with({int32_type->decompose(3), false})));
+        BOOST_REQUIRE(sst->may_contain_column_value(t_def, interval<bytes>::make_singular(utf8_type->decompose(sstring("t3")))));
+        BOOST_REQUIRE(!sst->may_contain_column_value(t_def, interval<bytes>::make_singular(utf8_type->decompose(sstring("u")))));
+
+        // Deleted rows hold no live value.
+        mutation m_del(s, m.decorated_key());
+        m_del.partition().apply_delete(*s, make_ck(100), tombstone(1, gc_clock::now()));
+        m_del.apply(m);
+        auto sst_del = make_sst(m_del, true);
+        BOOST_REQUIRE(!sst_del->may_contain_column_value(v_def, v_range(10, 20)));
+      }
+    });
+}
+
+SEASTAR_TEST_CASE(test_tombstone_stats) {
+    return test_env::do_with_async([] (test_env& env) {
+      for (const auto version : writable_sstable_versions) {
+        auto s = schema_builder("ks", "cf")
+                .with_column("p", int32_type, column_kind::partition_key)
+                .with_column("c", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type)
+                .build();
+        auto& v_def = *s->get_column_definition("v");
+        auto make_ck = [&] (int c) {
+            return clustering_key::from_exploded(*s, {int32_type->decompose(c)});
+        };
+        auto early = gc_clock::time_point(gc_clock::duration(10000));
+        auto late = gc_clock::time_point(gc_clock::duration(100000));
+        auto keys = tests::generate_partition_keys(4, s);
+
+        std::vector<mutation> muts;
+        // A partition tombstone.
+        muts.emplace_back(s, keys[0]);
+        muts.back().partition().apply(tombstone(1, early));
+        // Three row tombstones.
+        muts.emplace_back(s, keys[1]);
+        for (int c = 0; c < 3; ++c) {
+            muts.back().partition().apply_delete(*s, make_ck(c), tombstone(1, early));
+        }
+        // A range tombstone, written as two bounds.
+        muts.emplace_back(s, keys[2]);
+        muts.back().partition().apply_delete(*s, range_tombstone(make_ck(0), bound_kind::incl_start, make_ck(5), bound_kind::incl_end, tombstone(1, late)));
+        // Four cell tombstones and an expiring cell.
+        muts.emplace_back(s, keys[3]);
+        for (int c = 0; c < 4; ++c) {
+            muts.back().set_clustered_cell(make_ck(c), v_def, atomic_cell::make_dead(1, early));
+        }
+        muts.back().set_clustered_cell(make_ck(4), v_def, atomic_cell::make_live(*int32_type, 1, int32_type->decompose(4), late, std::chrono::seconds(10)));
+
+        auto sst = env.reusable_sst(make_sstable_containing(env.make_sstable(s, version), muts)).get();
+
+        auto* ts_stats = sst->get_tombstone_stats();
+        BOOST_REQUIRE(ts_stats);
+        auto require_count = [&] (tombstone_kind kind, uint64_t count, gc_clock::time_point deletion_time) {
+            auto it = ts_stats->map.find(kind);
+            BOOST_REQUIRE(it != ts_stats->map.end());
+            BOOST_REQUIRE_EQUAL(it->second.count, count);
+            BOOST_REQUIRE_EQUAL(it->second.buckets.elements.size(), 1u);
+            BOOST_REQUIRE_EQUAL(it->second.buckets.elements[0].max_deletion_time, deletion_time.time_since_epoch().count());
+            BOOST_REQUIRE_EQUAL(it->second.buckets.elements[0].count, count);
+        };
+        require_count(tombstone_kind::partition, 1, early);
+        require_count(tombstone_kind::row, 3, early);
+        require_count(tombstone_kind::range, 2, late);
+        require_count(tombstone_kind::cell, 4, early);
+        require_count(tombstone_kind::expiring, 1, late);
+
+        // Unlike the tombstone histogram, the exact counts account for tombstones of partitions without cells.
+        auto nothing_droppable = sst->estimate_droppable_tombstone_ratio(early);
+        auto some_droppable = sst->estimate_droppable_tombstone_ratio(early + std::chrono::seconds(1));
+        auto all_droppable = sst->estimate_droppable_tombstone_ratio(late + std::chrono::seconds(1));
+        BOOST_REQUIRE_EQUAL(nothing_droppable, 0.0);
+        BOOST_REQUIRE_GT(some_droppable, 0.0);
+        BOOST_REQUIRE_GT(all_droppable, some_droppable);
+        BOOST_REQUIRE_LE(all_droppable, 1.0);
+
+        // Partition tombstones an hour apart, more than fit in the buckets.
+        const auto partitions = metadata_collector::max_tombstone_stats_buckets + 44;
+        std::vector<mutation> spread_muts;
+        for (const auto& key : tests::generate_partition_keys(partitions, s)) {
+            auto deletion_time = gc_clock::time_point(gc_clock::duration(spread_muts.size() * metadata_collector::tombstone_stats_granularity));
+            spread_muts.emplace_back(s, key);
+            spread_muts.back().partition().apply(tombstone(1, deletion_time));
+        }
+        auto spread_sst = env.reusable_sst(make_sstable_containing(env.make_sstable(s, version), spread_muts)).get();
+        auto& e = spread_sst->get_tombstone_stats()->map.at(tombstone_kind::partition);
+        BOOST_REQUIRE_EQUAL(e.count, partitions);
+        BOOST_REQUIRE_LE(e.buckets.elements.size(), metadata_collector::max_tombstone_stats_buckets);
+        uint64_t total = 0;
+        int32_t prev_max_deletion_time = -1;
+        for (const auto& b : e.buckets.elements) {
+            BOOST_REQUIRE_GT(b.max_deletion_time, prev_max_deletion_time);
+            prev_max_deletion_time = b.max_deletion_time;
+            total += b.count;
+        }
+        BOOST_REQUIRE_EQUAL(total, partitions);
+        BOOST_REQUIRE_EQUAL(prev_max_deletion_time, int32_t((partitions - 1) * metadata_collector::tombstone_stats_granularity));
+      }
+    });
+}
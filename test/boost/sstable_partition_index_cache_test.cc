@@ -12,6 +12,8 @@
 #include <seastar/testing/thread_test_case.hh>
 
 #include "sstables/partition_index_cache.hh"
+#include "sstables/promoted_index_block_cache.hh"
+#include "sstables/clustered_seek_hints.hh"
 #include "test/lib/simple_schema.hh"
 
 using namespace sstables;
@@ -272,3 +274,169 @@ SEASTAR_THREAD_TEST_CASE(test_evict_gently) {
 
     cache.evict_gently().get();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_probation) {
+    ::lru lru;
+    simple_schema s;
+    logalloc::region r;
+    partition_index_cache_stats stats;
+    partition_index_cache_stats old_stats;
+
+    partition_index_cache cache(lru, r, stats);
+
+    auto clear_lru = defer([&] {
+        with_allocator(r.allocator(), [&] {
+            lru.evict_all();
+        });
+    });
+
+    auto page0_loader = [&] (partition_index_cache::key_type k) {
+        return make_page0(r, s);
+    };
+
+    auto no_loader = [&] (partition_index_cache::key_type k) -> future<partition_index_page> {
+        throw std::runtime_error("should not have been invoked");
+    };
+
+    auto evict_one = [&] {
+        with_allocator(r.allocator(), [&] {
+            lru.evict();
+        });
+    };
+
+    old_stats = stats;
+
+    cache.get_or_load(0, page0_loader).get();
+    cache.get_or_load(1, page0_loader, partition_index_cache::on_probation::yes).get();
+    cache.get_or_load(2, page0_loader, partition_index_cache::on_probation::yes).get();
+
+    BOOST_REQUIRE_EQUAL(stats.populations, old_stats.populations + 3);
+    BOOST_REQUIRE_EQUAL(stats.probationary_populations, old_stats.probationary_populations + 2);
+
+    // Pages on probation go first, even though page 0 is older.
+    evict_one();
+    evict_one();
+    BOOST_REQUIRE_EQUAL(stats.evictions, old_stats.evictions + 2);
+    has_page0(cache.get_or_load(0, no_loader).get());
+
+    // A page loaded on probation and requested again is promoted.
+    cache.get_or_load(1, page0_loader, partition_index_cache::on_probation::yes).get();
+    has_page0(cache.get_or_load(1, no_loader, partition_index_cache::on_probation::yes).get());
+    BOOST_REQUIRE_EQUAL(stats.promotions, old_stats.promotions + 1);
+
+    evict_one();
+    BOOST_REQUIRE_EQUAL(stats.evictions, old_stats.evictions + 3);
+    has_page0(cache.get_or_load(1, no_loader).get());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_hot_keys) {
+    ::lru lru;
+    simple_schema s;
+    logalloc::region r;
+    partition_index_cache_stats stats;
+
+    partition_index_cache cache(lru, r, stats);
+
+    auto clear_lru = defer([&] {
+        with_allocator(r.allocator(), [&] {
+            lru.evict_all();
+        });
+    });
+
+    auto page0_loader = [&] (partition_index_cache::key_type k) {
+        return make_page0(r, s);
+    };
+
+    cache.get_or_load(3, page0_loader).get();
+    cache.get_or_load(1, page0_loader).get();
+    cache.get_or_load(2, page0_loader, partition_index_cache::on_probation::yes).get();
+    cache.get_or_load(4, page0_loader, partition_index_cache::on_probation::yes).get();
+    BOOST_REQUIRE(cache.hot_keys() == std::vector<partition_index_cache::key_type>({1, 3}));
+
+    // Promoted pages become hot.
+    cache.get_or_load(4, page0_loader, partition_index_cache::on_probation::yes).get();
+    BOOST_REQUIRE(cache.hot_keys() == std::vector<partition_index_cache::key_type>({1, 3, 4}));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_promoted_index_block_cache) {
+    ::lru lru;
+    simple_schema s;
+    logalloc::region r;
+    promoted_index_block_cache_stats stats;
+    promoted_index_block_cache cache(lru, r, stats);
+
+    auto make_block = [&] (int first, int last, uint64_t offset) {
+        return promoted_index_block_cache::block{
+            position_in_partition::for_key(s.make_ckey(first)),
+            position_in_partition::for_key(s.make_ckey(last)),
+            std::nullopt,
+            offset,
+            100,
+        };
+    };
+    auto key0 = promoted_index_block_cache::key_type{10, 0};
+    auto key1 = promoted_index_block_cache::key_type{10, 1};
+    auto other_partition_key0 = promoted_index_block_cache::key_type{20, 0};
+
+    BOOST_REQUIRE(!cache.get(key0));
+    BOOST_REQUIRE_EQUAL(stats.misses, 1);
+
+    cache.put(key0, make_block(0, 1, 1000));
+    cache.put(key1, make_block(2, 3, 1100));
+    cache.put(key1, make_block(2, 3, 1100));
+    BOOST_REQUIRE_EQUAL(stats.populations, 2);
+    BOOST_REQUIRE_EQUAL(stats.block_count, 2);
+    BOOST_REQUIRE(stats.used_bytes > 0);
+
+    r.full_compaction();
+
+    position_in_partition::equal_compare eq(*s.schema());
+    auto b1 = cache.get(key1);
+    BOOST_REQUIRE(b1);
+    BOOST_REQUIRE(eq(b1->start, position_in_partition::for_key(s.make_ckey(2))));
+    BOOST_REQUIRE(eq(b1->end, position_in_partition::for_key(s.make_ckey(3))));
+    BOOST_REQUIRE_EQUAL(b1->data_file_offset, 1100);
+    BOOST_REQUIRE_EQUAL(stats.hits, 1);
+    BOOST_REQUIRE(!cache.get(other_partition_key0));
+
+    with_allocator(r.allocator(), [&] {
+        lru.evict_all();
+    });
+
+    BOOST_REQUIRE_EQUAL(stats.evictions, 2);
+    BOOST_REQUIRE_EQUAL(stats.block_count, 0);
+    BOOST_REQUIRE_EQUAL(stats.used_bytes, 0);
+    BOOST_REQUIRE(!cache.get(key0));
+
+    // Copies handed out survive eviction.
+    BOOST_REQUIRE(eq(b1->start, position_in_partition::for_key(s.make_ckey(2))));
+
+    cache.put(key0, make_block(0, 1, 1000));
+    cache.evict_gently().get();
+    BOOST_REQUIRE_EQUAL(stats.block_count, 0);
+    BOOST_REQUIRE_EQUAL(stats.used_bytes, 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_clustered_seek_hints) {
+    clustered_seek_hints hints;
+
+    BOOST_REQUIRE(!hints.get(100));
+
+    hints.put(100, 3);
+    BOOST_REQUIRE_EQUAL(hints.get(100).value_or(0), 3u);
+    hints.put(100, 7);
+    BOOST_REQUIRE_EQUAL(hints.get(100).value_or(0), 7u);
+
+    // Hints of other partitions are not returned, even when they share a slot.
+    for (uint64_t pi_start = 101; pi_start < 200; ++pi_start) {
+        BOOST_REQUIRE(!hints.get(pi_start));
+    }
+    for (uint64_t pi_start = 101; pi_start < 200; ++pi_start) {
+        hints.put(pi_start, pi_start);
+    }
+    for (uint64_t pi_start = 101; pi_start < 200; ++pi_start) {
+        auto h = hints.get(pi_start);
+        BOOST_REQUIRE(!h || *h == pi_start);
+    }
+    BOOST_REQUIRE_EQUAL(hints.get(199).value_or(0), 199u);
+}
@@ -167,3 +167,61 @@ SEASTAR_TEST_CASE(test_partitioned_sstable_set_bytes_on_disk) {
         BOOST_REQUIRE_EQUAL(sst_set->bytes_on_disk(), ss1->bytes_on_disk() + ss2->bytes_on_disk());
     });
 }
+
+SEASTAR_TEST_CASE(test_partitioned_sstable_set_overlapping_sstables) {
+    return test_env::do_with_async([] (test_env& env) {
+        simple_schema ss;
+        auto s = ss.schema();
+        auto pkeys = ss.make_pkeys(8);
+        sstable_writer_config cfg = env.manager().configure_writer("");
+
+        auto make_sstable = [&] (size_t first, size_t last) {
+            std::vector<mutation> muts;
+            for (auto i = first; i <= last; i++) {
+                muts.emplace_back(s, pkeys[i]);
+                ss.add_row(muts.back(), ss.make_ckey(0), "val");
+            }
+            return make_sstable_easy(env, make_flat_mutation_reader_from_mutations_v2(s, env.make_reader_permit(), std::move(muts)), cfg);
+        };
+        auto sst_a = make_sstable(0, 1);
+        auto sst_b = make_sstable(2, 3);
+        auto sst_c = make_sstable(4, 5);
+        // Overlaps with all of the above.
+        auto sst_d = make_sstable(1, 4);
+
+        auto set = make_sstable_set(s, make_lw_shared<sstable_list>({sst_a, sst_b, sst_c, sst_d}), false);
+
+        auto select = [&] (const sstable_set& set, size_t key) {
+            return boost::copy_range<std::unordered_set<shared_sstable>>(set.select(dht::partition_range::make_singular(pkeys[key])));
+        };
+        using expected = std::unordered_set<shared_sstable>;
+        BOOST_REQUIRE(select(set, 0) == expected({sst_a}));
+        BOOST_REQUIRE(select(set, 1) == expected({sst_a, sst_d}));
+        BOOST_REQUIRE(select(set, 4) == expected({sst_c, sst_d}));
+        BOOST_REQUIRE(select(set, 5) == expected({sst_c}));
+        BOOST_REQUIRE(select(set, 7).empty());
+
+        {
+            auto sel = set.make_incremental_selector();
+            auto selected = [&] (size_t key) {
+                return boost::copy_range<expected>(sel.select(pkeys[key]).sstables);
+            };
+            BOOST_REQUIRE(selected(0) == expected({sst_a}));
+            BOOST_REQUIRE(selected(1) == expected({sst_a, sst_d}));
+            BOOST_REQUIRE(selected(2) == expected({sst_b, sst_d}));
+            BOOST_REQUIRE(selected(5) == expected({sst_c}));
+            auto last = sel.select(pkeys[6]);
+            BOOST_REQUIRE(last.sstables.empty());
+            BOOST_REQUIRE(last.next_position.is_max());
+        }
+
+        // Updating a copy leaves the original alone.
+        auto copy = set;
+        copy.erase(sst_d);
+        BOOST_REQUIRE(select(copy, 1) == expected({sst_a}));
+        BOOST_REQUIRE(select(set, 1) == expected({sst_a, sst_d}));
+        copy.insert(make_sstable(6, 7));
+        BOOST_REQUIRE_EQUAL(select(copy, 7).size(), 1);
+        BOOST_REQUIRE(select(set, 7).empty());
+    });
+}
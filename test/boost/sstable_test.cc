@@ -32,6 +32,7 @@
 #include "test/lib/tmpdir.hh"
 #include "partition_slice_builder.hh"
 #include "sstables/sstable_mutation_reader.hh"
+#include "sstables/writer.hh"
 
 #include <boost/range/combine.hpp>
 
@@ -931,3 +932,40 @@ BOOST_AUTO_TEST_CASE(test_parse_path_bad) {
         BOOST_CHECK_THROW(parse_path(path), std::exception);
     }
 }
+
+// Verifies that the summary token directory always points at a range
+// which contains the lower bound of the searched token.
+SEASTAR_THREAD_TEST_CASE(test_summary_token_directory) {
+    for (size_t count : {0, 1, 63, 64, 1000, 100000}) {
+        sstables::summary s;
+        std::vector<int64_t> tokens;
+        tokens.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            tokens.push_back(dht::token::to_int64(dht::token::get_random_token()));
+        }
+        std::sort(tokens.begin(), tokens.end());
+        for (auto t : tokens) {
+            s.entries.push_back(summary_entry(dht::token::from_int64(t), bytes_view(), 0));
+        }
+        build_summary_token_directory(s).get();
+        BOOST_REQUIRE_EQUAL(s.token_directory.empty(), count < 64);
+
+        auto check = [&] (int64_t raw) {
+            auto t = dht::token::from_int64(raw);
+            auto [first, last] = s.token_directory_range(t);
+            BOOST_REQUIRE_LE(first, last);
+            BOOST_REQUIRE_LE(last, count);
+            auto lb = std::distance(tokens.begin(), std::lower_bound(tokens.begin(), tokens.end(), t.raw()));
+            BOOST_REQUIRE_LE(first, lb);
+            BOOST_REQUIRE_LE(lb, last);
+        };
+        for (auto t : tokens) {
+            check(t);
+        }
+        for (int i = 0; i < 1000; ++i) {
+            check(dht::token::to_int64(dht::token::get_random_token()));
+        }
+        check(std::numeric_limits<int64_t>::max());
+        check(std::numeric_limits<int64_t>::min() + 1);
+    }
+}
@@ -8,6 +8,7 @@
 
 #include "test/lib/scylla_test_case.hh"
 #include "utils/stall_free.hh"
+#include "utils/background_disposer.hh"
 #include "utils/small_vector.hh"
 #include "utils/chunked_vector.hh"
 
@@ -530,3 +531,40 @@ SEASTAR_THREAD_TEST_CASE(test_clear_gently_vector_of_optimized_optionals) {
     utils::clear_gently(v).get();
     BOOST_REQUIRE_EQUAL(cleared_gently, 1);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_background_disposer) {
+    int cleared_gently = 0;
+    auto make_vector = [&cleared_gently] {
+        std::vector<clear_gently_tracker<int>> v;
+        for (int i = 0; i < 10; ++i) {
+            v.emplace_back(i, [&cleared_gently] (int) {
+                cleared_gently++;
+            });
+        }
+        return v;
+    };
+
+    utils::background_disposer disposer;
+
+    // Not started, the object stays with the caller.
+    auto v = make_vector();
+    disposer.dispose(std::move(v));
+    BOOST_REQUIRE_EQUAL(v.size(), 10u);
+    BOOST_REQUIRE_EQUAL(disposer.get_stats().queued, 0u);
+
+    disposer.start(current_scheduling_group());
+    disposer.dispose(std::move(v));
+    disposer.dispose(make_vector());
+    BOOST_REQUIRE_EQUAL(disposer.get_stats().queued, 2u);
+    disposer.stop().get();
+    BOOST_REQUIRE_EQUAL(disposer.size(), 0u);
+    BOOST_REQUIRE_EQUAL(disposer.get_stats().disposed, 2u);
+    BOOST_REQUIRE_EQUAL(cleared_gently, 20);
+
+    // Can be started again after being stopped.
+    disposer.start(current_scheduling_group());
+    disposer.dispose(make_vector());
+    disposer.stop().get();
+    BOOST_REQUIRE_EQUAL(disposer.get_stats().disposed, 3u);
+    BOOST_REQUIRE_EQUAL(cleared_gently, 30);
+}
@@ -18,6 +18,47 @@
 #include "query_ranges_to_vnodes.hh"
 #include "partition_slice_builder.hh"
 #include "schema/schema_builder.hh"
+#include "locator/token_metadata.hh"
+
+using namespace std::chrono_literals;
+
+class storage_proxy_test {
+    service::storage_proxy& _sp;
+public:
+    explicit storage_proxy_test(service::storage_proxy& sp) : _sp(sp) { }
+
+    void replenish_speculative_read_budget(double max_extra_load) {
+        _sp.replenish_speculative_read_budget(max_extra_load);
+    }
+    bool consume_speculative_read_budget() {
+        return _sp.consume_speculative_read_budget();
+    }
+    // Sets the averages directly, rather than through register_replica_load(),
+    // so that they don't have to converge first.
+    void set_replica_feedback(gms::inet_address ep, double queued_reads, double service_time) {
+        auto& f = _sp._replica_feedback[ep];
+        f.queued_reads = queued_reads;
+        f.service_time = service_time;
+        f.response_time = service_time;
+        f.last_report = f.last_read_report = lowres_clock::now();
+    }
+    void age_replica_feedback(gms::inet_address ep, lowres_clock::duration read_age, lowres_clock::duration age) {
+        auto& f = _sp._replica_feedback.at(ep);
+        f.last_read_report -= read_age;
+        f.last_report -= age;
+    }
+    bool has_replica_feedback(gms::inet_address ep, bool for_reads) const {
+        return _sp.get_replica_feedback(ep, for_reads) != nullptr;
+    }
+    std::optional<double> get_replica_read_score(gms::inet_address ep) const {
+        return _sp.get_replica_read_score(ep);
+    }
+    inet_address_vector_replica_set avoid_busy_replicas(db::consistency_level cl, const locator::effective_replication_map& erm,
+            inet_address_vector_replica_set selected, const inet_address_vector_replica_set& live_endpoints) const {
+        _sp.avoid_busy_replicas(cl, erm, selected, live_endpoints, {}, nullptr);
+        return selected;
+    }
+};
 
 // Returns random keys sorted in ring order.
 // The schema must have a single bytes_type partition key column.
@@ -133,3 +174,108 @@ SEASTAR_THREAD_TEST_CASE(test_split_stats) {
     stats1->register_metrics_for("DC1", ep1);
     stats2->register_metrics_for("DC1", ep1);
 }
+
+SEASTAR_TEST_CASE(test_speculative_read_budget) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        storage_proxy_test sp(e.get_storage_proxy().local());
+
+        BOOST_REQUIRE(!sp.consume_speculative_read_budget());
+        // Every read adds its share, a speculative read needs a whole one.
+        sp.replenish_speculative_read_budget(0.5);
+        BOOST_REQUIRE(!sp.consume_speculative_read_budget());
+        sp.replenish_speculative_read_budget(0.5);
+        BOOST_REQUIRE(sp.consume_speculative_read_budget());
+        BOOST_REQUIRE(!sp.consume_speculative_read_budget());
+
+        // Bursts are capped.
+        for (int i = 0; i < 100; ++i) {
+            sp.replenish_speculative_read_budget(1);
+        }
+        for (int i = 0; i < 10; ++i) {
+            BOOST_REQUIRE(sp.consume_speculative_read_budget());
+        }
+        BOOST_REQUIRE(!sp.consume_speculative_read_budget());
+    });
+}
+
+SEASTAR_TEST_CASE(test_avoid_busy_replicas) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        storage_proxy_test sp(e.get_storage_proxy().local());
+        auto ep1 = gms::inet_address("10.0.0.1");
+        auto ep2 = gms::inet_address("10.0.0.2");
+        auto ep3 = gms::inet_address("10.0.0.3");
+        auto ep4 = gms::inet_address("10.0.0.4");
+
+        // ep1 (this node), ep2 and ep3 are in dc1, ep4 in dc2.
+        locator::token_metadata::config tm_cfg;
+        tm_cfg.topo_cfg.this_endpoint = ep1;
+        tm_cfg.topo_cfg.local_dc_rack = {"dc1", "rack1"};
+        auto tmptr = locator::make_token_metadata_ptr(tm_cfg);
+        int64_t token = 0;
+        for (auto [ep, dc] : {std::pair(ep1, "dc1"), std::pair(ep2, "dc1"), std::pair(ep3, "dc1"), std::pair(ep4, "dc2")}) {
+            tmptr->update_topology(ep, locator::endpoint_dc_rack{dc, "rack1"});
+            tmptr->update_normal_tokens(std::unordered_set<dht::token>({dht::token::from_int64(token += 1000)}), ep).get();
+        }
+        auto rs = locator::abstract_replication_strategy::create_replication_strategy("SimpleStrategy", {{"replication_factor", "3"}});
+        auto erm = locator::calculate_effective_replication_map(rs, tmptr).get0();
+        const inet_address_vector_replica_set live{ep1, ep2, ep3, ep4};
+        auto read_from = [&] (db::consistency_level cl) {
+            auto selected = sp.avoid_busy_replicas(cl, *erm, {ep2}, live);
+            BOOST_REQUIRE_EQUAL(selected.size(), 1);
+            return selected[0];
+        };
+
+        // Without feedback nothing is replaced.
+        BOOST_REQUIRE(!sp.get_replica_read_score(ep2));
+        BOOST_REQUIRE_EQUAL(read_from(db::consistency_level::ONE), ep2);
+
+        // The score grows with the cube of the expected queue.
+        sp.set_replica_feedback(ep2, 0, 1000);
+        BOOST_REQUIRE_EQUAL(*sp.get_replica_read_score(ep2), 1000);
+        sp.set_replica_feedback(ep2, 1, 1000);
+        BOOST_REQUIRE_EQUAL(*sp.get_replica_read_score(ep2), 8000);
+
+        // A replica is replaced only by one expected to respond both 2x
+        // and 1ms sooner.
+        sp.set_replica_feedback(ep2, 0, 1000);
+        sp.set_replica_feedback(ep3, 0, 400);
+        BOOST_REQUIRE_EQUAL(read_from(db::consistency_level::ONE), ep2);
+        sp.set_replica_feedback(ep2, 0, 3000);
+        sp.set_replica_feedback(ep3, 0, 1600);
+        BOOST_REQUIRE_EQUAL(read_from(db::consistency_level::ONE), ep2);
+        sp.set_replica_feedback(ep3, 0, 1400);
+        BOOST_REQUIRE_EQUAL(read_from(db::consistency_level::ONE), ep3);
+        sp.set_replica_feedback(ep2, 1, 1000);
+        sp.set_replica_feedback(ep3, 0, 1000);
+        BOOST_REQUIRE_EQUAL(read_from(db::consistency_level::ONE), ep3);
+
+        // The fastest replica wins, but LOCAL_* reads stay in the local DC.
+        sp.set_replica_feedback(ep4, 0, 100);
+        BOOST_REQUIRE_EQUAL(read_from(db::consistency_level::ONE), ep4);
+        BOOST_REQUIRE_EQUAL(read_from(db::consistency_level::LOCAL_ONE), ep3);
+        BOOST_REQUIRE_EQUAL(read_from(db::consistency_level::LOCAL_QUORUM), ep3);
+        sp.age_replica_feedback(ep3, 2s, 2s);
+        BOOST_REQUIRE_EQUAL(read_from(db::consistency_level::LOCAL_ONE), ep2);
+    });
+}
+
+SEASTAR_TEST_CASE(test_replica_feedback_staleness) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        storage_proxy_test sp(e.get_storage_proxy().local());
+        auto ep = gms::inet_address("10.0.0.2");
+
+        sp.set_replica_feedback(ep, 1, 1000);
+        sp.age_replica_feedback(ep, 900ms, 900ms);
+        BOOST_REQUIRE(sp.has_replica_feedback(ep, true));
+        BOOST_REQUIRE(sp.get_replica_read_score(ep));
+
+        // A replica which only acked writes lately has no read feedback.
+        sp.age_replica_feedback(ep, 200ms, 0s);
+        BOOST_REQUIRE(sp.has_replica_feedback(ep, false));
+        BOOST_REQUIRE(!sp.has_replica_feedback(ep, true));
+        BOOST_REQUIRE(!sp.get_replica_read_score(ep));
+
+        sp.age_replica_feedback(ep, 0s, 2s);
+        BOOST_REQUIRE(!sp.has_replica_feedback(ep, false));
+    });
+}
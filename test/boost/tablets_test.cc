@@ -12,6 +12,7 @@
 #include "test/lib/random_utils.hh"
 #include <seastar/testing/thread_test_case.hh>
 #include "test/lib/cql_test_env.hh"
+#include "test/lib/cql_assertions.hh"
 #include "test/lib/log.hh"
 #include "db/config.hh"
 #include "schema/schema_builder.hh"
@@ -20,6 +21,7 @@
 #include "replica/tablet_mutation_builder.hh"
 #include "locator/tablets.hh"
 #include "service/tablet_allocator.hh"
+#include "service/storage_service.hh"
 #include "locator/tablet_sharder.hh"
 #include "locator/load_sketch.hh"
 #include "locator/tablet_replication_strategy.hh"
@@ -230,6 +232,38 @@ SEASTAR_TEST_CASE(test_tablet_metadata_persistence) {
     }, tablet_cql_test_config());
 }
 
+SEASTAR_TEST_CASE(test_resize_decision_persistence) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto h1 = host_id(utils::UUID_gen::get_time_UUID());
+        auto table1 = add_table(e).get0();
+
+        tablet_metadata tm;
+        tablet_map tmap(2);
+        for (auto tid : tmap.tablet_ids()) {
+            tmap.set_tablet(tid, tablet_info{tablet_replica_set{tablet_replica{h1, 0}}});
+        }
+        tm.set_tablet_map(table1, tmap);
+        verify_tablet_metadata_persistence(e, tm);
+
+        tmap.set_resize_decision(resize_decision{resize_decision::way_type::split, 1});
+        tm.set_tablet_map(table1, tmap);
+        verify_tablet_metadata_persistence(e, tm);
+
+        tmap.set_resize_decision(resize_decision{resize_decision::way_type::merge, 2});
+        tm.set_tablet_map(table1, tmap);
+        verify_tablet_metadata_persistence(e, tm);
+
+        // The decision can be updated without rewriting the tablet map.
+        auto s = e.local_db().find_schema(table1);
+        e.local_db().apply(freeze({tablet_mutation_builder(next_timestamp++, s->ks_name(), table1)
+                .set_resize_decision(resize_decision{resize_decision::way_type::none, 3})
+                .build()}), db::no_timeout).get();
+        auto tm2 = read_tablet_metadata(e.local_qp()).get0();
+        BOOST_REQUIRE_EQUAL(tm2.get_tablet_map(table1).get_resize_decision().sequence_number, 3);
+        BOOST_REQUIRE(!tm2.get_tablet_map(table1).get_resize_decision().split_or_merge());
+    }, tablet_cql_test_config());
+}
+
 SEASTAR_TEST_CASE(test_get_shard) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         auto h1 = host_id(utils::UUID_gen::get_time_UUID());
@@ -589,6 +623,42 @@ SEASTAR_THREAD_TEST_CASE(test_token_ownership_splitting) {
     }
 }
 
+SEASTAR_THREAD_TEST_CASE(test_tablet_map_split_and_merge) {
+    auto h1 = host_id(next_uuid());
+    auto h2 = host_id(next_uuid());
+
+    tablet_map tmap(2);
+    tmap.set_tablet(tablet_id(0), tablet_info{tablet_replica_set{tablet_replica{h1, 0}}});
+    tmap.set_tablet(tablet_id(1), tablet_info{tablet_replica_set{tablet_replica{h2, 1}}});
+    tmap.set_resize_decision(resize_decision{resize_decision::way_type::split, 7});
+
+    auto split = tmap.split();
+    BOOST_REQUIRE_EQUAL(split.tablet_count(), 4);
+    BOOST_REQUIRE(!split.get_resize_decision().split_or_merge());
+    BOOST_REQUIRE_EQUAL(split.get_resize_decision().sequence_number, 7);
+    for (auto tid : tmap.tablet_ids()) {
+        auto left = tablet_id(size_t(tid) * 2);
+        auto right = tablet_id(size_t(tid) * 2 + 1);
+        BOOST_REQUIRE(split.get_tablet_info(left) == tmap.get_tablet_info(tid));
+        BOOST_REQUIRE(split.get_tablet_info(right) == tmap.get_tablet_info(tid));
+        BOOST_REQUIRE_EQUAL(split.get_first_token(left), tmap.get_first_token(tid));
+        BOOST_REQUIRE_EQUAL(split.get_last_token(right), tmap.get_last_token(tid));
+        BOOST_REQUIRE_EQUAL(dht::next_token(split.get_last_token(left)), split.get_first_token(right));
+    }
+
+    BOOST_REQUIRE(split.can_merge());
+    auto merged = split.merge();
+    BOOST_REQUIRE_EQUAL(merged.tablet_count(), 2);
+    for (auto tid : tmap.tablet_ids()) {
+        BOOST_REQUIRE(merged.get_tablet_info(tid) == tmap.get_tablet_info(tid));
+    }
+
+    // Siblings on different replicas can't be merged.
+    BOOST_REQUIRE(!tmap.can_merge());
+    split.set_tablet(tablet_id(1), tablet_info{tablet_replica_set{tablet_replica{h1, 1}}});
+    BOOST_REQUIRE(!split.can_merge());
+}
+
 // Reflects the plan in a given token metadata as if the migrations were fully executed.
 static
 void apply_plan(token_metadata& tm, const migration_plan& plan) {
@@ -620,9 +690,9 @@ void apply_plan_as_in_progress(token_metadata& tm, const migration_plan& plan) {
 }
 
 static
-void rebalance_tablets(tablet_allocator& talloc, shared_token_metadata& stm) {
+void rebalance_tablets(tablet_allocator& talloc, shared_token_metadata& stm, tablet_load_map_ptr load = {}) {
     while (true) {
-        auto plan = talloc.balance_tablets(stm.get()).get0();
+        auto plan = talloc.balance_tablets(stm.get(), load).get0();
         if (plan.empty()) {
             break;
         }
@@ -1288,6 +1358,127 @@ SEASTAR_THREAD_TEST_CASE(test_load_balancing_with_two_empty_nodes) {
   }).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_load_balancing_with_tablet_load) {
+  do_with_cql_env_thread([] (auto& e) {
+    // Verifies that tablets are weighted by the load reported for them,
+    // so that a hot tablet is balanced against several cold ones.
+
+    inet_address ip1("192.168.0.1");
+    inet_address ip2("192.168.0.2");
+
+    auto host1 = host_id(next_uuid());
+    auto host2 = host_id(next_uuid());
+
+    auto table1 = table_id(next_uuid());
+
+    unsigned shard_count = 1;
+
+    semaphore sem(1);
+    shared_token_metadata stm([&sem] () noexcept { return get_units(sem, 1); }, locator::token_metadata::config{
+        locator::topology::config{
+            .this_endpoint = ip1,
+            .local_dc_rack = locator::endpoint_dc_rack::default_location
+        }
+    });
+
+    auto load = make_lw_shared<tablet_load_map>();
+    std::optional<global_tablet_id> hot_tablet;
+
+    stm.mutate_token_metadata([&] (auto& tm) {
+        tm.update_host_id(host1, ip1);
+        tm.update_host_id(host2, ip2);
+        tm.update_topology(ip1, locator::endpoint_dc_rack::default_location, std::nullopt, shard_count);
+        tm.update_topology(ip2, locator::endpoint_dc_rack::default_location, std::nullopt, shard_count);
+
+        tablet_map tmap(4);
+        for (auto tid : tmap.tablet_ids()) {
+            tmap.set_tablet(tid, tablet_info {
+                tablet_replica_set {
+                    tablet_replica {host1, 0},
+                }
+            });
+            auto gid = global_tablet_id{table1, tid};
+            if (!hot_tablet) {
+                hot_tablet = gid;
+            }
+            load->emplace(gid, tablet_load{
+                .size_in_bytes = 1000,
+                .read_rate = gid == *hot_tablet ? 100.0 : 0.0,
+            });
+        }
+        tablet_metadata tmeta;
+        tmeta.set_tablet_map(table1, std::move(tmap));
+        tm.set_tablets(std::move(tmeta));
+        return make_ready_future<>();
+    }).get();
+
+    rebalance_tablets(e.get_tablet_allocator().local(), stm, load);
+
+    // The hot tablet weighs as much as the three cold ones together.
+    auto& tmap = stm.get()->tablets().get_tablet_map(table1);
+    for (auto tid : tmap.tablet_ids()) {
+        auto expected = global_tablet_id{table1, tid} == *hot_tablet ? host2 : host1;
+        BOOST_REQUIRE_EQUAL(tmap.get_tablet_info(tid).replicas.front().host, expected);
+    }
+  }).get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_load_balancing_ignores_small_imbalance_of_tablet_load) {
+  do_with_cql_env_thread([] (auto& e) {
+    // Verifies that tablets don't move when the loads of nodes differ only slightly,
+    // which is the normal state with reported tablet load.
+
+    inet_address ip1("192.168.0.1");
+    inet_address ip2("192.168.0.2");
+
+    auto host1 = host_id(next_uuid());
+    auto host2 = host_id(next_uuid());
+
+    auto table1 = table_id(next_uuid());
+
+    unsigned shard_count = 1;
+
+    semaphore sem(1);
+    shared_token_metadata stm([&sem] () noexcept { return get_units(sem, 1); }, locator::token_metadata::config{
+        locator::topology::config{
+            .this_endpoint = ip1,
+            .local_dc_rack = locator::endpoint_dc_rack::default_location
+        }
+    });
+
+    auto load = make_lw_shared<tablet_load_map>();
+
+    stm.mutate_token_metadata([&] (auto& tm) {
+        tm.update_host_id(host1, ip1);
+        tm.update_host_id(host2, ip2);
+        tm.update_topology(ip1, locator::endpoint_dc_rack::default_location, std::nullopt, shard_count);
+        tm.update_topology(ip2, locator::endpoint_dc_rack::default_location, std::nullopt, shard_count);
+
+        tablet_map tmap(4);
+        for (auto tid : tmap.tablet_ids()) {
+            // Two tablets on each node, one of those on host2 a bit smaller than the rest.
+            bool on_host1 = tid.value() < 2;
+            tmap.set_tablet(tid, tablet_info {
+                tablet_replica_set {
+                    tablet_replica {on_host1 ? host1 : host2, 0},
+                }
+            });
+            load->emplace(global_tablet_id{table1, tid}, tablet_load{
+                .size_in_bytes = tid.value() == 3 ? 900u : 1000u,
+                .read_rate = 10.0,
+            });
+        }
+        tablet_metadata tmeta;
+        tmeta.set_tablet_map(table1, std::move(tmap));
+        tm.set_tablets(std::move(tmeta));
+        return make_ready_future<>();
+    }).get();
+
+    auto plan = e.get_tablet_allocator().local().balance_tablets(stm.get(), load).get0();
+    BOOST_REQUIRE(plan.empty());
+  }).get();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_load_balancing_with_random_load) {
   do_with_cql_env_thread([] (auto& e) {
     const int n_hosts = 6;
@@ -1396,3 +1587,154 @@ SEASTAR_THREAD_TEST_CASE(test_load_balancing_with_random_load) {
     }
   }).get();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_load_balancer_resize_decisions) {
+    auto cfg = tablet_cql_test_config();
+    cfg.db_config->target_tablet_size_in_mb(1);
+    do_with_cql_env_thread([] (auto& e) {
+        inet_address ip1("192.168.0.1");
+        auto host1 = host_id(next_uuid());
+
+        auto big_table = table_id(next_uuid());
+        auto small_table = table_id(next_uuid());
+        auto unknown_table = table_id(next_uuid());
+        auto splitting_table = table_id(next_uuid());
+
+        semaphore sem(1);
+        shared_token_metadata stm([&sem] () noexcept { return get_units(sem, 1); }, locator::token_metadata::config{
+            locator::topology::config{
+                .this_endpoint = ip1,
+                .local_dc_rack = locator::endpoint_dc_rack::default_location
+            }
+        });
+
+        constexpr uint64_t MiB = 1024 * 1024;
+        auto load = make_lw_shared<tablet_load_map>();
+
+        stm.mutate_token_metadata([&] (auto& tm) {
+            tm.update_host_id(host1, ip1);
+            tm.update_topology(ip1, locator::endpoint_dc_rack::default_location, std::nullopt, 1);
+
+            tablet_metadata tmeta;
+            auto add = [&] (table_id table, uint64_t size, bool with_load, resize_decision decision) {
+                tablet_map tmap(4);
+                for (auto tid : tmap.tablet_ids()) {
+                    tmap.set_tablet(tid, tablet_info{tablet_replica_set{tablet_replica{host1, 0}}});
+                    if (with_load) {
+                        load->emplace(global_tablet_id{table, tid}, tablet_load{.size_in_bytes = size});
+                    }
+                }
+                tmap.set_resize_decision(decision);
+                tmeta.set_tablet_map(table, std::move(tmap));
+            };
+            add(big_table, 3 * MiB, true, {});
+            add(small_table, MiB / 4, true, {});
+            add(unknown_table, 3 * MiB, false, {});
+            add(splitting_table, 3 * MiB, true, resize_decision{resize_decision::way_type::split, 5});
+            tm.set_tablets(std::move(tmeta));
+            return make_ready_future<>();
+        }).get();
+
+        auto plan = e.get_tablet_allocator().local().balance_tablets(stm.get(), load).get0();
+        auto& resize = plan.resize_plan().resize;
+        BOOST_REQUIRE_EQUAL(resize.size(), 2);
+        BOOST_REQUIRE(resize.at(big_table).way == resize_decision::way_type::split);
+        BOOST_REQUIRE_EQUAL(resize.at(big_table).sequence_number, 1);
+        BOOST_REQUIRE(resize.at(small_table).way == resize_decision::way_type::merge);
+        // Tables without complete load, and tables with the right pending decision, are left alone.
+        BOOST_REQUIRE(!resize.contains(unknown_table));
+        BOOST_REQUIRE(!resize.contains(splitting_table));
+    }, std::move(cfg)).get();
+}
+
+#ifdef SCYLLA_ENABLE_ERROR_INJECTION
+SEASTAR_TEST_CASE(test_split_compaction_groups) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE KEYSPACE ks_split WITH replication = {'class': 'NetworkTopologyStrategy', 'replication_factor': 1, 'initial_tablets': 2}").get();
+        e.execute_cql("CREATE TABLE ks_split.t (pk int PRIMARY KEY, v int)").get();
+        auto s = e.local_db().find_schema("ks_split", "t");
+        auto id = s->id();
+
+        auto write = [&] (int pk, int v) {
+            e.execute_cql(format("INSERT INTO ks_split.t (pk, v) VALUES ({}, {})", pk, v)).get();
+        };
+        auto flush = [&] {
+            e.db().invoke_on_all([id] (replica::database& db) {
+                return db.find_column_family(id).flush();
+            }).get();
+        };
+        std::map<int, int> expected;
+        auto check = [&] {
+            for (auto& [pk, v] : expected) {
+                auto msg = e.execute_cql(format("SELECT v FROM ks_split.t WHERE pk = {}", pk)).get0();
+                assert_that(msg).is_rows().with_rows({{int32_type->decompose(v)}});
+            }
+            auto msg = e.execute_cql("SELECT pk FROM ks_split.t").get0();
+            assert_that(msg).is_rows().with_size(expected.size());
+        };
+
+        // Sstables which span the halves of their groups, and memtables which do too.
+        const int keys = 64;
+        for (int pk = 0; pk < keys / 2; ++pk) {
+            write(pk, pk);
+            expected[pk] = pk;
+        }
+        flush();
+        for (int pk = keys / 2; pk < keys; ++pk) {
+            write(pk, pk);
+            expected[pk] = pk;
+        }
+
+        utils::get_local_injector().enable_on_all("split_compaction_groups_wait_before_flush", true).get();
+        e.local_db().apply(freeze({tablet_mutation_builder(next_timestamp++, s->ks_name(), id)
+                .set_resize_decision(resize_decision{resize_decision::way_type::split, 1})
+                .build()}), db::no_timeout).get();
+        e.get_storage_service().local().load_tablet_metadata().get();
+
+        // Groups are split, but their memtables are not flushed yet. Point reads must
+        // see data of the key's group in the memtables of the other groups.
+        for (int pk = 0; pk < keys; pk += 2) {
+            write(pk, pk + keys);
+            expected[pk] = pk + keys;
+        }
+        for (int pk = keys; pk < keys + 8; ++pk) {
+            write(pk, pk);
+            expected[pk] = pk;
+        }
+        check();
+
+        utils::get_local_injector().receive_message_on_all("split_compaction_groups_wait_before_flush").get();
+
+        // Once memtables are flushed and the misplaced sstables are rewritten into
+        // per-group ones, replicas report readiness for the split.
+        auto split_ready = [&] {
+            return e.db().map_reduce0([id] (replica::database& db) {
+                locator::load_stats stats;
+                db.find_column_family(id).collect_tablet_load_stats(stats);
+                auto it = stats.tables.find(id);
+                return it != stats.tables.end() && it->second.split_ready_seq_number == 1;
+            }, true, std::logical_and<bool>()).get0();
+        };
+        int attempts = 0;
+        while (!split_ready()) {
+            BOOST_REQUIRE_LT(++attempts, 6000);
+            seastar::sleep(std::chrono::milliseconds(10)).get();
+        }
+        check();
+
+        // Cleanup of a tablet covers all of its groups, and nothing of the other tablet.
+        auto& tmap = e.local_db().get_token_metadata().tablets().get_tablet_map(id);
+        BOOST_REQUIRE_EQUAL(tmap.tablet_count(), 2);
+        auto cleaned = tablet_id(0);
+        e.db().invoke_on_all([id, cleaned] (replica::database& db) {
+            return db.find_column_family(id).cleanup_tablet(cleaned);
+        }).get();
+        std::erase_if(expected, [&] (const auto& kv) {
+            auto token = dht::get_token(*s, partition_key::from_singular(*s, kv.first));
+            return tmap.get_tablet_id(token) == cleaned;
+        });
+        BOOST_REQUIRE(!expected.empty());
+        check();
+    }, tablet_cql_test_config());
+}
+#endif
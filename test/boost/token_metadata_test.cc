@@ -257,3 +257,30 @@ SEASTAR_THREAD_TEST_CASE(test_replace_node_with_same_endpoint) {
         inet_address_vector_topology_change{e1});
     BOOST_REQUIRE_EQUAL(token_metadata->get_endpoint(t1), e1);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_sorted_tokens_after_token_changes) {
+    const auto e1 = inet_address("192.168.0.1");
+    const auto e2 = inet_address("192.168.0.2");
+    const auto t1 = dht::token::from_int64(1);
+    const auto t10 = dht::token::from_int64(10);
+    const auto t100 = dht::token::from_int64(100);
+    const auto t1000 = dht::token::from_int64(1000);
+
+    auto token_metadata = create_token_metadata(e1);
+    token_metadata->update_topology(e1, get_dc_rack(e1));
+    token_metadata->update_topology(e2, get_dc_rack(e2));
+    token_metadata->update_normal_tokens({t100, t1}, e1).get();
+    token_metadata->update_normal_tokens({t1000}, e2).get();
+    BOOST_REQUIRE(token_metadata->sorted_tokens() == (std::vector<dht::token>{t1, t100, t1000}));
+
+    auto clone = token_metadata->clone_async().get0();
+    clone.update_normal_tokens({t10, t1000}, e2).get();
+    clone.update_normal_tokens({t1}, e1).get();
+    BOOST_REQUIRE(clone.sorted_tokens() == (std::vector<dht::token>{t1, t10, t1000}));
+    // The original is not affected by changes to its clone.
+    BOOST_REQUIRE(token_metadata->sorted_tokens() == (std::vector<dht::token>{t1, t100, t1000}));
+
+    clone.remove_endpoint(e2);
+    BOOST_REQUIRE(clone.sorted_tokens() == (std::vector<dht::token>{t1}));
+    clone.clear_gently().get();
+}
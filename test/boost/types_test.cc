@@ -871,6 +871,23 @@ BOOST_AUTO_TEST_CASE(test_map_to_json) {
     BOOST_REQUIRE_EQUAL(to_json_string(*m, map_v.serialize()), "{\"42\": \"abc\", \"42\": \"abc\"}");
 }
 
+BOOST_AUTO_TEST_CASE(test_string_to_json_escaping) {
+    auto to_json = [] (std::string_view s) {
+        return to_json_string(*utf8_type, utf8_type->decompose(sstring(s)));
+    };
+    BOOST_REQUIRE_EQUAL(to_json(""), "\"\"");
+    BOOST_REQUIRE_EQUAL(to_json("no escaping needed at all here"), "\"no escaping needed at all here\"");
+    // Characters to escape at various offsets from word boundaries.
+    BOOST_REQUIRE_EQUAL(to_json("\"quoted\""), "\"\\\"quoted\\\"\"");
+    BOOST_REQUIRE_EQUAL(to_json("0123456789abcdef\\x"), "\"0123456789abcdef\\\\x\"");
+    BOOST_REQUIRE_EQUAL(to_json("01234567\n\t\x01"), "\"01234567\\n\\t\\u0001\"");
+    // Non-ASCII bytes are not control characters.
+    BOOST_REQUIRE_EQUAL(to_json("z\u00f3\u0142w z\u00f3\u0142w"), "\"z\u00f3\u0142w z\u00f3\u0142w\"");
+
+    auto b = from_hex("01abff");
+    BOOST_REQUIRE_EQUAL(to_json_string(*bytes_type, b), "\"0x01abff\"");
+}
+
 BOOST_AUTO_TEST_CASE(test_set_to_string) {
     auto m = set_type_impl::get_instance(int32_type, true);
     using native_type = std::vector<data_value>;
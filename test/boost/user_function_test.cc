@@ -1101,3 +1101,33 @@ SEASTAR_TEST_CASE(test_user_function_filtering) {
                                 std::runtime_error, message_contains("User function cannot be executed in this context"));
     });
 }
+
+SEASTAR_TEST_CASE(test_user_function_globals_are_per_call) {
+    return with_udf_enabled([] (cql_test_env& e) {
+        // Calls reuse interpreter states, which must not carry the globals set by previous calls.
+        e.execute_cql("CREATE TABLE my_table (key int PRIMARY KEY, val text);").get();
+        for (int i = 0; i < 5; ++i) {
+            e.execute_cql(format("INSERT INTO my_table (key, val) VALUES ({}, 'v{}');", i, i)).get();
+        }
+        e.execute_cql("CREATE FUNCTION count_calls(val text) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua "
+                "AS 'if n == nil then n = 0 end n = n + 1 return n';").get();
+        e.execute_cql("CREATE FUNCTION count_calls_g(val text) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua "
+                "AS '_G.m = (_G.m or 0) + 1 return m';").get();
+        // Overwriting a library only affects the call which does it.
+        e.execute_cql("CREATE FUNCTION upper_once(val text) CALLED ON NULL INPUT RETURNS text LANGUAGE Lua "
+                "AS 'local r = string.upper(val) string = nil return r';").get();
+
+        for (int round = 0; round < 2; ++round) {
+            auto res = e.execute_cql("SELECT count_calls(val), count_calls_g(val) FROM my_table;").get0();
+            std::vector<std::vector<bytes_opt>> ones(5, {int32_type->decompose(1), int32_type->decompose(1)});
+            assert_that(res).is_rows().with_rows_ignore_order(ones);
+
+            res = e.execute_cql("SELECT upper_once(val) FROM my_table;").get0();
+            std::vector<std::vector<bytes_opt>> upper;
+            for (int i = 0; i < 5; ++i) {
+                upper.push_back({utf8_type->decompose(format("V{}", i))});
+            }
+            assert_that(res).is_rows().with_rows_ignore_order(upper);
+        }
+    });
+}
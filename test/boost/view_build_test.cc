@@ -1022,3 +1022,47 @@ SEASTAR_THREAD_TEST_CASE(test_view_update_generator_buffering_with_empty_mutatio
 
     vuc.consume_end_of_stream();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_view_update_coalescing) {
+    cql_test_config test_cfg;
+    auto& db_cfg = *test_cfg.db_config;
+
+    // Long enough for all the writes below to fall into a single window.
+    db_cfg.view_update_coalescing_window_in_us(5000000);
+
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table t (p int, c int, v int, primary key (p, c))").get();
+        e.execute_cql("create materialized view tv as select * from t "
+                      "where p is not null and c is not null and v is not null "
+                      "primary key (v, c, p)").get();
+
+        auto& gen = e.get_view_update_generator();
+        auto sum = [&] (auto f) {
+            return gen.map_reduce0([f] (db::view::view_update_generator& g) { return uint64_t(f(g)); }, uint64_t(0), std::plus<uint64_t>()).get0();
+        };
+        auto held = [&] { return sum(std::mem_fn(&db::view::view_update_generator::coalescing_view_updates)); };
+        auto pushed = [&] {
+            return e.db().map_reduce0([] (replica::database& db) {
+                return db.find_column_family("ks", "t").get_view_stats().view_updates_pushed_local;
+            }, uint64_t(0), std::plus<uint64_t>()).get0();
+        };
+        auto coalesced_before = sum(std::mem_fn(&db::view::view_update_generator::coalesced_view_updates));
+        auto pushed_before = pushed();
+
+        // Rows of one base partition, so that their updates are generated
+        // on one shard, all mapping to the view partition v = 7.
+        for (int c = 0; c < 5; ++c) {
+            e.execute_cql(format("insert into t (p, c, v) values (1, {}, 7)", c)).get();
+        }
+        BOOST_REQUIRE_EQUAL(held(), 1);
+        BOOST_REQUIRE_EQUAL(sum(std::mem_fn(&db::view::view_update_generator::coalesced_view_updates)) - coalesced_before, 4);
+
+        // Once the window passes, they are sent in a single write.
+        REQUIRE_EVENTUALLY_EQUAL(held(), 0);
+        REQUIRE_EVENTUALLY_EQUAL(pushed() - pushed_before, 1);
+        eventually([&] {
+            auto msg = e.execute_cql("select c from tv where v = 7").get0();
+            assert_that(msg).is_rows().with_size(5);
+        });
+    }, std::move(test_cfg)).get();
+}
@@ -47,6 +47,11 @@ void check_bytes_and_roundtrip(typename Vint::value_type value, BytesInspector&&
     const auto deserialized = Vint::deserialize(view);
     BOOST_REQUIRE_EQUAL(deserialized, value);
     test_serialized_size_from_first_byte<Vint>(size, view);
+
+    BOOST_REQUIRE_EQUAL(Vint::is_single_byte(view[0]), size == 1);
+    if (size == 1) {
+        BOOST_REQUIRE_EQUAL(Vint::deserialize_single_byte(view[0]), value);
+    }
 };
 
 // Check that the encoded value decodes back to the value.
@@ -102,3 +102,29 @@ SEASTAR_THREAD_TEST_CASE(test_system_config_table_no_live_update) {
         );
     }).get();
 }
+
+SEASTAR_THREAD_TEST_CASE(test_reader_semaphores_table) {
+    do_with_cql_env_thread([] (cql_test_env& env) {
+        auto res = env.execute_cql("SELECT semaphore FROM system.reader_semaphores WHERE shard = 0;").get0();
+        assert_that(res).is_rows().with_rows({
+            { utf8_type->decompose(sstring("compaction")) },
+            { utf8_type->decompose(sstring("streaming")) },
+            { utf8_type->decompose(sstring("system")) },
+            { utf8_type->decompose(sstring("user")) },
+        });
+
+        res = env.execute_cql("SELECT * FROM system.reader_permits;").get0();
+        assert_that(res).is_rows();
+    }).get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_table_cache_state_table) {
+    do_with_cql_env_thread([] (cql_test_env& env) {
+        env.execute_cql("CREATE TABLE ks.tbl (pk int PRIMARY KEY, v int);").get();
+        env.execute_cql("INSERT INTO ks.tbl (pk, v) VALUES (0, 0);").get();
+        env.execute_cql("SELECT * FROM ks.tbl WHERE pk = 0;").get();
+
+        auto res = env.execute_cql("SELECT shard FROM system.table_cache_state WHERE keyspace_name = 'ks' AND table_name = 'tbl';").get0();
+        assert_that(res).is_rows().with_size(smp::count);
+    }).get();
+}
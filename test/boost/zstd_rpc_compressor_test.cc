@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/util/variant_utils.hh>
+
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "test/lib/random_utils.hh"
+
+#include "message/zstd_rpc_compressor.hh"
+
+using namespace seastar;
+
+static constexpr size_t head_space = 4;
+
+// Splits data into a buffer made of fragments of fragment_size.
+static rpc::snd_buf make_snd_buf(const sstring& data, size_t fragment_size) {
+    if (data.size() <= fragment_size) {
+        return rpc::snd_buf(temporary_buffer<char>(data.data(), data.size()));
+    }
+    std::vector<temporary_buffer<char>> fragments;
+    for (size_t pos = 0; pos < data.size(); pos += fragment_size) {
+        auto size = std::min(fragment_size, data.size() - pos);
+        fragments.emplace_back(data.data() + pos, size);
+    }
+    return rpc::snd_buf(std::move(fragments), data.size());
+}
+
+static std::vector<temporary_buffer<char>> get_fragments(auto& buf) {
+    std::vector<temporary_buffer<char>> fragments;
+    std::visit(make_visitor(
+        [&] (temporary_buffer<char>& b) {
+            fragments.push_back(std::move(b));
+        },
+        [&] (std::vector<temporary_buffer<char>>& bufs) {
+            std::move(bufs.begin(), bufs.end(), std::back_inserter(fragments));
+        }), buf.bufs);
+    return fragments;
+}
+
+// What the receiver gets: the compressed data, without the head space.
+static sstring compressed_data(rpc::snd_buf buf) {
+    sstring ret;
+    for (auto& b : get_fragments(buf)) {
+        ret += sstring(b.get(), b.size());
+    }
+    BOOST_REQUIRE_EQUAL(ret.size(), buf.size);
+    return ret.substr(head_space);
+}
+
+static rpc::rcv_buf make_rcv_buf(const sstring& data, size_t fragment_size) {
+    auto snd = make_snd_buf(data, fragment_size);
+    auto fragments = get_fragments(snd);
+    if (fragments.size() == 1) {
+        return rpc::rcv_buf(std::move(fragments.front()));
+    }
+    return rpc::rcv_buf(std::move(fragments), data.size());
+}
+
+static sstring to_sstring(rpc::rcv_buf buf) {
+    sstring ret;
+    for (auto& b : get_fragments(buf)) {
+        BOOST_REQUIRE_LE(b.size(), rpc::snd_buf::chunk_size);
+        ret += sstring(b.get(), b.size());
+    }
+    BOOST_REQUIRE_EQUAL(ret.size(), buf.size);
+    return ret;
+}
+
+static sstring round_trip(netw::zstd_rpc_compressor& c, const sstring& data, size_t in_fragment_size, size_t out_fragment_size) {
+    auto compressed = compressed_data(c.compress(head_space, make_snd_buf(data, in_fragment_size)));
+    return to_sstring(c.decompress(make_rcv_buf(compressed, out_fragment_size)));
+}
+
+static sstring make_compressible_data(size_t size) {
+    auto word = tests::random::get_sstring(16);
+    sstring data;
+    while (data.size() < size) {
+        data += word + tests::random::get_sstring(tests::random::get_int<size_t>(0, 8));
+    }
+    return data.substr(0, size);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_round_trip) {
+    netw::zstd_rpc_compressor c(3);
+    for (auto size : {size_t(1), size_t(100), size_t(4096), size_t(100000)}) {
+        auto data = make_compressible_data(size);
+        BOOST_REQUIRE_EQUAL(round_trip(c, data, size, size), data);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_round_trip_empty) {
+    netw::zstd_rpc_compressor c(3);
+    BOOST_REQUIRE_EQUAL(round_trip(c, sstring(), 1, 1), sstring());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_round_trip_fragmented) {
+    netw::zstd_rpc_compressor c(3);
+    auto data = make_compressible_data(1000000);
+    for (auto fragment_size : {size_t(1), size_t(7), size_t(1000), size_t(rpc::snd_buf::chunk_size)}) {
+        BOOST_REQUIRE_EQUAL(round_trip(c, data, fragment_size, fragment_size), data);
+        BOOST_REQUIRE_EQUAL(round_trip(c, data, fragment_size, 3), data);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_round_trip_large) {
+    netw::zstd_rpc_compressor c(3);
+    // Incompressible, so that the compressed data spans many fragments too.
+    auto data = tests::random::get_sstring(8 << 20);
+    auto compressed = c.compress(head_space, make_snd_buf(data, rpc::snd_buf::chunk_size));
+    BOOST_REQUIRE_GT(get_fragments(compressed).size(), 1);
+    for (auto& b : get_fragments(compressed)) {
+        BOOST_REQUIRE_LE(b.size(), head_space + rpc::snd_buf::chunk_size);
+    }
+    BOOST_REQUIRE_EQUAL(round_trip(c, data, rpc::snd_buf::chunk_size, 1 << 20), data);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_compressors_share_contexts) {
+    netw::zstd_rpc_compressor fast(1);
+    netw::zstd_rpc_compressor strong(19);
+    auto data = make_compressible_data(100000);
+    auto compressed_fast = compressed_data(fast.compress(head_space, make_snd_buf(data, 1000)));
+    auto compressed_strong = compressed_data(strong.compress(head_space, make_snd_buf(data, 1000)));
+    // Each compressor applies its own level to the shared context.
+    BOOST_REQUIRE_LT(compressed_strong.size(), compressed_fast.size());
+    BOOST_REQUIRE_EQUAL(to_sstring(strong.decompress(make_rcv_buf(compressed_fast, 1000))), data);
+    BOOST_REQUIRE_EQUAL(to_sstring(fast.decompress(make_rcv_buf(compressed_strong, 1000))), data);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_truncated_frames_are_rejected) {
+    netw::zstd_rpc_compressor c(3);
+    auto data = make_compressible_data(100000);
+    auto compressed = compressed_data(c.compress(head_space, make_snd_buf(data, 1000)));
+    BOOST_REQUIRE_THROW(c.decompress(rpc::rcv_buf(temporary_buffer<char>())), std::runtime_error);
+    for (auto size : {size_t(1), size_t(5), compressed.size() / 2, compressed.size() - 1}) {
+        BOOST_REQUIRE_THROW(c.decompress(make_rcv_buf(compressed.substr(0, size), 100)), std::runtime_error);
+    }
+    // The context is usable after a failure.
+    BOOST_REQUIRE_EQUAL(to_sstring(c.decompress(make_rcv_buf(compressed, 100))), data);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_corrupt_frames_are_rejected) {
+    netw::zstd_rpc_compressor c(3);
+    auto data = make_compressible_data(100000);
+    auto compressed = compressed_data(c.compress(head_space, make_snd_buf(data, 1000)));
+    for (auto pos : {size_t(0), compressed.size() / 2, compressed.size() - 1}) {
+        auto corrupt = compressed;
+        corrupt[pos] ^= 0x5a;
+        BOOST_REQUIRE_THROW(c.decompress(make_rcv_buf(corrupt, 100)), std::runtime_error);
+    }
+    BOOST_REQUIRE_THROW(c.decompress(make_rcv_buf(tests::random::get_sstring(1000), 100)), std::runtime_error);
+    BOOST_REQUIRE_EQUAL(to_sstring(c.decompress(make_rcv_buf(compressed, 100))), data);
+}
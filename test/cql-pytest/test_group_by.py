@@ -158,5 +158,20 @@ def test_group_by_non_aggregated_mutation_attribute_of_column(cql, table1):
     assert [row[1] for row in results] == [100000001, 100000003, 100000005, 100000007]
     assert all([[row[2] > 900000] for row in results])
 
+# GROUP BY aggregations over many partitions may be executed in parallel
+# by the shards owning the data. The groups must still be returned in token
+# order, followed by clustering order, as a scan would return them.
+def test_group_by_many_partitions_order(cql, test_keyspace):
+    with new_test_table(cql, test_keyspace, "p int, c int, v int, PRIMARY KEY (p, c)") as table:
+        stmt = cql.prepare(f'INSERT INTO {table} (p, c, v) VALUES (?, ?, ?)')
+        for p in range(50):
+            for c in range(3):
+                cql.execute(stmt, [p, c, p * 10 + c])
+        partitions = [row.p for row in cql.execute(f'SELECT DISTINCT p FROM {table}')]
+        assert [(p, 3, p * 30 + 3) for p in partitions] == list(cql.execute(f'SELECT p, count(*), sum(v) FROM {table} GROUP BY p'))
+        assert [(p, c, 1, p * 10 + c) for p in partitions for c in range(3)] == list(cql.execute(f'SELECT p, c, count(*), max(v) FROM {table} GROUP BY p, c'))
+        # Columns which are only grouped by, but not selected
+        assert [(3,) for p in partitions] == list(cql.execute(f'SELECT count(*) FROM {table} GROUP BY p'))
+
 # NOTE: we have tests for the combination of GROUP BY and SELECT DISTINCT
 # in test_distinct.py (reproducing issue #12479).
@@ -7,6 +7,7 @@
  */
 
 #include "test/lib/alternator_test_env.hh"
+#include "test/lib/cql_test_env.hh"
 #include "alternator/rmw_operation.hh"
 #include "replica/database.hh"
 #include <seastar/core/coroutine.hh>
@@ -46,7 +47,23 @@ future<> alternator_test_env::start(std::string_view isolation_level) {
     }
 }
 
+future<> alternator_test_env::start_server(cql_test_env& env, uint16_t port) {
+    co_await _memory_limiter.start(memory::stats().total_memory());
+    co_await _server.start(
+            std::ref(_executor),
+            std::ref(_proxy),
+            std::ref(_gossiper),
+            sharded_parameter([&env] { return std::ref(env.local_auth_service()); }),
+            sharded_parameter([&env] { return std::ref(env.service_level_controller_service().local()); }));
+    co_await _server.invoke_on_all([this, port] (alternator::server& server) {
+        return server.init(net::inet_address("127.0.0.1"), port, std::nullopt, std::nullopt, false,
+                &_memory_limiter.local().get_semaphore(), utils::updateable_value<uint32_t>(5000));
+    });
+}
+
 future<> alternator_test_env::stop() {
+    co_await _server.stop();
+    co_await _memory_limiter.stop();
     co_await _executor.stop();
     co_await _cdc_metadata.stop();
     co_await _sdks.stop();
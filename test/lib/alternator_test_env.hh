@@ -12,6 +12,8 @@
 #include <seastar/core/future.hh>
 
 #include "alternator/executor.hh"
+#include "alternator/server.hh"
+#include "service/memory_limiter.hh"
 #include "utils/rjson.hh"
 #include "db/system_distributed_keyspace.hh"
 #include "cdc/metadata.hh"
@@ -28,6 +30,8 @@ namespace gms {
 class gossiper;
 }
 
+class cql_test_env;
+
 // Test environment for alternator frontend.
 // The interface is minimal and does not cover alternator streams,
 // because this environment has limited use as well - microbenchmarks.
@@ -50,6 +54,10 @@ class alternator_test_env {
     sharded<cdc::metadata> _cdc_metadata;
 
     sharded<alternator::executor> _executor;
+
+    // Only started by start_server()
+    sharded<service::memory_limiter> _memory_limiter;
+    sharded<alternator::server> _server;
 public:
     alternator_test_env(
             sharded<gms::gossiper>& gossiper,
@@ -63,6 +71,9 @@ class alternator_test_env {
     {}
 
     future<> start(std::string_view isolation_level);
+    // Starts the HTTP server of alternator on all shards, listening on
+    // 127.0.0.1:port, without authorization. Must be called after start().
+    future<> start_server(cql_test_env& env, uint16_t port);
     future<> stop();
     future<> flush_memtables();
 
@@ -109,6 +109,7 @@ cql_test_config::cql_test_config(shared_ptr<db::config> cfg)
 
     db_config->add_cdc_extension();
     db_config->add_per_partition_rate_limit_extension();
+    db_config->add_commitlog_bypass_extension();
 
     db_config->flush_schema_tables_after_modification.set(false);
     db_config->commitlog_use_o_dsync(false);
@@ -335,6 +336,10 @@ class single_node_cql_env : public cql_test_env {
         return _view_update_generator.local();
     }
 
+    virtual sharded<db::view::view_update_generator>& get_view_update_generator() override {
+        return _view_update_generator;
+    }
+
     virtual service::migration_notifier& local_mnotifier() override {
         return _mnotifier.local();
     }
@@ -363,6 +368,10 @@ class single_node_cql_env : public cql_test_env {
         return _sys_ks;
     }
 
+    virtual sharded<db::system_distributed_keyspace>& get_system_distributed_keyspace() override {
+        return _sys_dist_ks;
+    }
+
     virtual sharded<service::tablet_allocator>& get_tablet_allocator() override {
         return _tablet_allocator;
     }
@@ -371,6 +380,10 @@ class single_node_cql_env : public cql_test_env {
         return _proxy;
     }
 
+    virtual sharded<service::storage_service>& get_storage_service() override {
+        return _ss;
+    }
+
     virtual sharded<gms::feature_service>& get_feature_service() override {
         return _feature_service;
     }
@@ -379,6 +392,10 @@ class single_node_cql_env : public cql_test_env {
         return _sstm;
     }
 
+    virtual sharded<qos::service_level_controller>& service_level_controller_service() override {
+        return _sl_controller;
+    }
+
     virtual future<> refresh_client_state() override {
         return _core_local.invoke_on_all([] (core_local_state& state) {
             return state.client_state.maybe_update_per_service_level_params();
@@ -547,6 +564,8 @@ class single_node_cql_env : public cql_test_env {
                     .available_memory = dbcfg.available_memory,
                     .static_shares = cfg->compaction_static_shares,
                     .throughput_mb_per_sec = cfg->compaction_throughput_mb_per_sec,
+                    .major_compaction_max_parallelism = cfg->major_compaction_max_parallelism,
+                    .major_compaction_min_split_size_in_mb = cfg->major_compaction_min_split_size_in_mb,
                 };
             });
             _cm.start(std::move(get_cm_cfg), std::ref(abort_sources), std::ref(_task_manager)).get();
@@ -33,6 +33,7 @@ class database;
 
 namespace db {
 class batchlog_manager;
+class system_distributed_keyspace;
 }
 
 namespace db::view {
@@ -44,6 +45,10 @@ namespace auth {
 class service;
 }
 
+namespace qos {
+class service_level_controller;
+}
+
 namespace cql3 {
     class query_processor;
 }
@@ -54,6 +59,7 @@ class client_state;
 class migration_manager;
 class raft_group0_client;
 class raft_group_registry;
+class storage_service;
 
 }
 
@@ -148,6 +154,8 @@ class cql_test_env {
 
     virtual db::view::view_update_generator& local_view_update_generator() = 0;
 
+    virtual sharded<db::view::view_update_generator>& get_view_update_generator() = 0;
+
     virtual service::migration_notifier& local_mnotifier() = 0;
 
     virtual sharded<service::migration_manager>& migration_manager() = 0;
@@ -164,14 +172,20 @@ class cql_test_env {
 
     virtual sharded<db::system_keyspace>& get_system_keyspace() = 0;
 
+    virtual sharded<db::system_distributed_keyspace>& get_system_distributed_keyspace() = 0;
+
     virtual sharded<service::tablet_allocator>& get_tablet_allocator() = 0;
 
     virtual sharded<service::storage_proxy>& get_storage_proxy() = 0;
 
+    virtual sharded<service::storage_service>& get_storage_service() = 0;
+
     virtual sharded<gms::feature_service>& get_feature_service() = 0;
 
     virtual sharded<sstables::storage_manager>& get_sstorage_manager() = 0;
 
+    virtual sharded<qos::service_level_controller>& service_level_controller_service() = 0;
+
     data_dictionary::database data_dictionary();
 };
 
@@ -107,8 +107,8 @@ class table_for_tests::table_state : public compaction::table_state {
         return _sstables_manager.configure_writer(std::move(origin));
     }
 
-    api::timestamp_type min_memtable_timestamp() const override {
-        return table().min_memtable_timestamp();
+    api::timestamp_type min_memtable_timestamp(const dht::decorated_key& dk) const override {
+        return table().min_memtable_timestamp(dk);
     }
     future<> on_compaction_completion(sstables::compaction_completion_desc desc, sstables::offstrategy offstrategy) override {
         return table().as_table_state().on_compaction_completion(std::move(desc), offstrategy);
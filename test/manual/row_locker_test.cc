@@ -312,3 +312,33 @@ SEASTAR_TEST_CASE(test_block_partition_row) {
         flock1.get0();
     });
 }
+
+// Locking several rows at once should only block writers of these rows, not
+// of other rows of the same partition, and overlapping batches, whatever the
+// order of their rows, should wait for each other instead of deadlocking.
+SEASTAR_TEST_CASE(test_block_multiple_rows) {
+    return seastar::async([&] {
+        auto s = make_schema();
+        row_locker rl(s);
+        auto pk = make_pk(s, "pk1");
+        auto ck1 = make_ck(s, "ck1");
+        auto ck2 = make_ck(s, "ck2");
+        auto ck3 = make_ck(s, "ck3");
+        auto lock = rl.lock_cks(pk, {ck2, ck1, ck1}, true, db::timeout_clock::time_point::max(), row_locker_stats).get0();
+        auto ignore = [] (auto) { };
+        // Other rows of the partition can be locked.
+        ignore(rl.lock_ck(pk, ck3, true, db::timeout_clock::time_point::max(), row_locker_stats).get0());
+        // The locked rows, and the partition, cannot.
+        auto flock1 = rl.lock_ck(pk, ck1, true, db::timeout_clock::time_point::max(), row_locker_stats);
+        auto flock2 = rl.lock_cks(pk, {ck3, ck2}, true, db::timeout_clock::time_point::max(), row_locker_stats);
+        auto flock3 = rl.lock_pk(pk, true, db::timeout_clock::time_point::max(), row_locker_stats);
+        BOOST_REQUIRE(!flock1.available());
+        BOOST_REQUIRE(!flock2.available());
+        BOOST_REQUIRE(!flock3.available());
+        ignore(std::move(lock));
+        ignore(flock1.get0());
+        ignore(flock2.get0());
+        ignore(flock3.get0());
+        BOOST_REQUIRE(rl.empty() == true);
+    });
+}
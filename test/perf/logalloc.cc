@@ -11,6 +11,7 @@
 #include <seastar/core/sstring.hh>
 #include <seastar/core/thread.hh>
 #include <seastar/core/reactor.hh>
+#include <seastar/util/defer.hh>
 
 #include <fmt/core.h>
 #include <random>
@@ -32,11 +33,63 @@ static constexpr unsigned nr_seq_allocations = 1024;
 static constexpr unsigned nr_iterations = 20000;
 static constexpr unsigned nr_sizes = 32;
 
+struct cell {
+    uint64_t value;
+    char padding[56];
+};
+
+// Reads objects scattered over many segments in random order, which is
+// dominated by TLB and cache misses, like cache hits on a large cache.
+static void test_random_reads(size_t memory, unsigned nr_reads) {
+    logalloc::region reg;
+    auto& allocator = reg.allocator();
+    std::vector<cell*> cells;
+    cells.reserve(memory / sizeof(cell));
+    for (size_t i = 0; i < memory / sizeof(cell); ++i) {
+        void* mem = allocator.alloc<cell>(sizeof(cell));
+        cells.push_back(new (mem) cell{i});
+    }
+    // Exercise the reclaimer, so that the layout of segments is the one it leaves behind.
+    logalloc::shard_tracker().reclaim(memory / 4);
+
+    std::mt19937 g(std::random_device{}());
+    std::shuffle(cells.begin(), cells.end(), g);
+
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < nr_reads; ++i) {
+        sum += cells[i % cells.size()]->value;
+    }
+    std::chrono::duration<double, std::nano> total = std::chrono::steady_clock::now() - start;
+    fmt::print("Random reads: {:.2f} ns/read (sum {})\n", total.count() / nr_reads, sum);
+
+    for (auto c : cells) {
+        allocator.destroy(c);
+    }
+}
+
 int main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
     app_template app;
-    return app.run(argc, argv, [] {
+    app.add_options()
+        ("reclaim-huge-page-spans", "Give segments back to the seastar allocator in whole huge pages")
+        ("read-memory", bpo::value<size_t>()->default_value(1024), "Memory [MiB] filled with objects read in random order")
+        ("reads", bpo::value<unsigned>()->default_value(100000000), "Number of random reads")
+        ;
+    return app.run(argc, argv, [&app] {
         return seastar::async([&] {
             logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory()).get();
+            logalloc::tracker::config st_cfg;
+            st_cfg.defragment_on_idle = false;
+            st_cfg.abort_on_lsa_bad_alloc = false;
+            st_cfg.lsa_reclamation_step = 1;
+            st_cfg.background_reclaim_sched_group = default_scheduling_group();
+            st_cfg.reclaim_huge_page_spans = app.configuration().contains("reclaim-huge-page-spans");
+            logalloc::shard_tracker().configure(st_cfg);
+            auto stop_tracker = defer([] () noexcept {
+                logalloc::shard_tracker().stop().get();
+            });
+
             logalloc::region reg;
 
             std::array<piggie*, nr_seq_allocations> objects;
@@ -73,6 +126,8 @@ int main(int argc, char** argv) {
             }
 
             fmt::print("Total time: {} s\n", total.count());
+
+            test_random_reads(app.configuration()["read-memory"].as<size_t>() << 20, app.configuration()["reads"].as<unsigned>());
         });
     });
 }
@@ -8,6 +8,12 @@
 
 #include <boost/range/irange.hpp>
 
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <json/json.h>
+
+#include <seastar/util/closeable.hh>
 #include <seastar/util/defer.hh>
 #include <seastar/core/app-template.hh>
 #include <seastar/core/thread.hh>
@@ -20,6 +26,10 @@
 #include "test/lib/tmpdir.hh"
 #include "sstables/sstables.hh"
 #include "mutation/canonical_mutation.hh"
+#include "collection_mutation.hh"
+#include "counters.hh"
+#include "types/map.hh"
+#include "readers/flat_mutation_reader_v2.hh"
 #include "test/lib/sstable_utils.hh"
 #include "test/lib/test_services.hh"
 #include "test/lib/sstable_test_env.hh"
@@ -141,15 +151,30 @@ struct mutation_settings {
     size_t partition_key_size;
     size_t clustering_key_size;
     size_t data_size;
+    // When non-zero, regular columns are maps with this many entries.
+    size_t collection_size = 0;
+    // Regular columns are counters.
+    bool counters = false;
 };
 
+static data_type regular_column_type(const mutation_settings& settings) {
+    if (settings.counters) {
+        return counter_type;
+    }
+    if (settings.collection_size) {
+        return map_type_impl::get_instance(int32_type, bytes_type, true);
+    }
+    return bytes_type;
+}
+
 static schema_ptr make_schema(const mutation_settings& settings) {
     auto builder = schema_builder("ks", "cf")
         .with_column("pk", bytes_type, column_kind::partition_key)
         .with_column("ck", bytes_type, column_kind::clustering_key);
 
+    auto type = regular_column_type(settings);
     for (size_t i = 0; i < settings.column_count; ++i) {
-        builder.with_column(to_bytes(random_name(settings.column_name_size)), bytes_type);
+        builder.with_column(to_bytes(random_name(settings.column_name_size)), type);
     }
 
     return builder.build();
@@ -161,21 +186,82 @@ static mutation make_mutation(schema_ptr s, mutation_settings settings) {
     for (size_t i = 0; i < settings.row_count; ++i) {
         auto ck = clustering_key::from_single_value(*s, bytes_type->decompose(data_value(random_bytes(settings.clustering_key_size))));
         for (auto&& col : s->regular_columns()) {
-            m.set_clustered_cell(ck, col,
-                atomic_cell::make_live(*bytes_type, 1,
-                    bytes_type->decompose(data_value(random_bytes(settings.data_size)))));
+            if (settings.counters) {
+                counter_cell_builder b;
+                b.add_shard(counter_shard(counter_id::create_random_id(), std::rand(), 1));
+                m.set_clustered_cell(ck, col, b.build(1));
+            } else if (settings.collection_size) {
+                collection_mutation_description cm;
+                for (size_t j = 0; j < settings.collection_size; ++j) {
+                    cm.cells.emplace_back(int32_type->decompose(int32_t(j)),
+                        atomic_cell::make_live(*bytes_type, 1, random_bytes(settings.data_size), atomic_cell::collection_member::yes));
+                }
+                m.set_clustered_cell(ck, col, cm.serialize(*col.type));
+            } else {
+                m.set_clustered_cell(ck, col,
+                    atomic_cell::make_live(*bytes_type, 1,
+                        bytes_type->decompose(data_value(random_bytes(settings.data_size)))));
+            }
         }
     }
     return m;
 }
 
+// Where the out-of-line memory of the keys and cells of a mutation goes.
+//
+// managed_bytes keeps values of up to sizeof(managed_bytes) - 1 bytes inline, longer ones
+// take a blob with its own header. Cells always spill, as the blob holds the timestamp
+// and flags along with the value, so identical values of different cells differ in storage.
+struct blob_sizes {
+    size_t keys = 0;
+    size_t external_keys = 0;
+    size_t key_external_memory = 0;
+    size_t cells = 0;
+    size_t cell_external_memory = 0;
+    size_t cell_value_bytes = 0;
+    // Bytes of cell values which repeat a value of an earlier cell of the same column.
+    size_t duplicate_cell_value_bytes = 0;
+};
+
+static blob_sizes calculate_blob_sizes(const schema& s, const std::vector<mutation>& muts) {
+    blob_sizes result;
+    std::unordered_map<column_id, std::unordered_set<bytes>> values;
+    for (auto& m : muts) {
+        for (const rows_entry& e : m.partition().clustered_rows()) {
+            ++result.keys;
+            result.key_external_memory += e.key().external_memory_usage();
+            result.external_keys += e.key().external_memory_usage() != 0;
+            e.row().cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection& c) {
+                auto& def = s.regular_column_at(id);
+                ++result.cells;
+                result.cell_external_memory += c.external_memory_usage(*def.type);
+                if (!def.type->is_atomic()) {
+                    return;
+                }
+                auto value = to_bytes(c.as_atomic_cell(def).value());
+                result.cell_value_bytes += value.size();
+                if (!values[id].insert(value).second) {
+                    result.duplicate_cell_value_bytes += value.size();
+                }
+            });
+        }
+    }
+    return result;
+}
+
 struct sizes {
     size_t memtable;
     size_t cache;
     std::map<sstables::sstable::version_types, size_t> sstable;
+    // In-memory components of the sstable of the highest version.
+    size_t sstable_summary;
+    size_t sstable_filter;
+    // Memory taken by the partition index cache entries after reading every partition.
+    size_t partition_index_cache;
     size_t frozen;
     size_t canonical;
     size_t query_result;
+    blob_sizes blobs;
 };
 
 static sizes calculate_sizes(cache_tracker& tracker, const mutation_settings& settings) {
@@ -201,6 +287,7 @@ static sizes calculate_sizes(cache_tracker& tracker, const mutation_settings& se
     result.frozen = freeze(m).representation().size();
     result.canonical = canonical_mutation(m).representation().size();
     result.query_result = query_mutation(mutation(m), partition_slice_builder(*s).build()).buf().size();
+    result.blobs = calculate_blob_sizes(*s, muts);
 
     tmpdir sstable_dir;
     sstables::test_env::do_with_async([&] (sstables::test_env& env) {
@@ -211,12 +298,134 @@ static sizes calculate_sizes(cache_tracker& tracker, const mutation_settings& se
             write_memtable_to_sstable_for_test(*mt2, sst).get();
             sst->open_data().get();
             result.sstable[v] = sst->data_size();
+
+            if (v != sstables::get_highest_sstable_version()) {
+                continue;
+            }
+            result.sstable_summary = sst->get_summary().memory_footprint();
+            result.sstable_filter = sst->filter_memory_size();
+            auto& index_cache_stats = env.manager().get_cache_tracker().get_partition_index_cache_stats();
+            auto index_cache_initial = index_cache_stats.used_bytes;
+            for (auto& pm : muts) {
+                auto pr = dht::partition_range::make_singular(pm.decorated_key());
+                auto rd = sst->make_reader(s, env.make_reader_permit(), pr, s->full_slice());
+                auto close_rd = deferred_close(rd);
+                rd().get();
+            }
+            result.partition_index_cache = index_cache_stats.used_bytes - index_cache_initial;
         }
     }).get();
 
     return result;
 }
 
+struct shape {
+    std::string name;
+    mutation_settings settings;
+};
+
+// The shapes measured with --matrix, meant to cover the layouts which changes
+// to the in-memory representation of partitions and rows affect differently.
+static std::vector<shape> matrix_shapes() {
+    auto base = mutation_settings{
+        .column_count = 5,
+        .column_name_size = 2,
+        .row_count = 1,
+        .partition_count = 1,
+        .partition_key_size = 10,
+        .clustering_key_size = 10,
+        .data_size = 32,
+    };
+    std::vector<shape> shapes;
+    shapes.push_back({"narrow_rows", base});
+    auto wide = base;
+    wide.row_count = 1000;
+    shapes.push_back({"wide_rows", wide});
+    auto collections = base;
+    collections.row_count = 10;
+    collections.collection_size = 10;
+    collections.data_size = 8;
+    shapes.push_back({"collections", collections});
+    auto counters = base;
+    counters.row_count = 10;
+    counters.counters = true;
+    shapes.push_back({"counters", counters});
+    auto small_partitions = base;
+    small_partitions.partition_count = 1000;
+    small_partitions.column_count = 1;
+    small_partitions.partition_key_size = 8;
+    small_partitions.clustering_key_size = 8;
+    small_partitions.data_size = 8;
+    shapes.push_back({"small_partitions", small_partitions});
+    return shapes;
+}
+
+static void print_sizes(const sizes& sizes) {
+    std::cout << "mutation footprint:" << "\n";
+    std::cout << " - in cache:     " << sizes.cache << "\n";
+    std::cout << " - in memtable:  " << sizes.memtable << "\n";
+    std::cout << " - in sstable:\n";
+    for (auto v : sizes.sstable) {
+        std::cout << "   " << fmt::to_string(v.first) << ":   " << v.second << "\n";
+    }
+    std::cout << " - sstable summary:       " << sizes.sstable_summary << "\n";
+    std::cout << " - sstable filter:        " << sizes.sstable_filter << "\n";
+    std::cout << " - partition index cache: " << sizes.partition_index_cache << "\n";
+    std::cout << " - frozen:       " << sizes.frozen << "\n";
+    std::cout << " - canonical:    " << sizes.canonical << "\n";
+    std::cout << " - query result: " << sizes.query_result << "\n";
+
+    std::cout << "\n";
+    std::cout << "managed_bytes blobs (sizeof(managed_bytes) = " << sizeof(managed_bytes) << "):\n";
+    std::cout << " - clustering keys:          " << sizes.blobs.keys << ", out of line: " << sizes.blobs.external_keys << "\n";
+    std::cout << " - key external memory:      " << sizes.blobs.key_external_memory << "\n";
+    std::cout << " - cells:                    " << sizes.blobs.cells << "\n";
+    std::cout << " - cell external memory:     " << sizes.blobs.cell_external_memory << "\n";
+    std::cout << " - cell value bytes:         " << sizes.blobs.cell_value_bytes << "\n";
+    std::cout << " - duplicate cell value bytes: " << sizes.blobs.duplicate_cell_value_bytes << "\n";
+}
+
+// The footprint of a shape, with the per-row and per-partition figures which regression checks compare.
+static Json::Value sizes_to_json(const shape& sh, const sizes& sizes) {
+    const auto& st = sh.settings;
+    const double rows = st.partition_count * st.row_count;
+    const double partitions = st.partition_count;
+    auto per = [&] (size_t bytes) {
+        Json::Value v;
+        v["bytes"] = Json::UInt64(bytes);
+        v["bytes_per_row"] = bytes / rows;
+        v["bytes_per_partition"] = bytes / partitions;
+        return v;
+    };
+
+    Json::Value result;
+    result["shape"] = sh.name;
+
+    Json::Value params;
+    params["column_count"] = Json::UInt64(st.column_count);
+    params["row_count"] = Json::UInt64(st.row_count);
+    params["partition_count"] = Json::UInt64(st.partition_count);
+    params["partition_key_size"] = Json::UInt64(st.partition_key_size);
+    params["clustering_key_size"] = Json::UInt64(st.clustering_key_size);
+    params["data_size"] = Json::UInt64(st.data_size);
+    params["collection_size"] = Json::UInt64(st.collection_size);
+    params["counters"] = st.counters;
+    result["parameters"] = std::move(params);
+
+    result["memtable"] = per(sizes.memtable);
+    result["cache"] = per(sizes.cache);
+    result["sstable_summary"] = per(sizes.sstable_summary);
+    result["sstable_filter"] = per(sizes.sstable_filter);
+    result["partition_index_cache"] = per(sizes.partition_index_cache);
+    for (auto& [v, size] : sizes.sstable) {
+        result["sstable_data"][fmt::to_string(v)] = Json::UInt64(size);
+    }
+    result["frozen"] = Json::UInt64(sizes.frozen);
+    result["canonical"] = Json::UInt64(sizes.canonical);
+    result["query_result"] = Json::UInt64(sizes.query_result);
+    return result;
+}
+
 int main(int argc, char** argv) {
     namespace bpo = boost::program_options;
     app_template app;
@@ -228,7 +437,11 @@ int main(int argc, char** argv) {
         ("partition-count", bpo::value<size_t>()->default_value(1), "partition count")
         ("partition-key-size", bpo::value<size_t>()->default_value(10), "partition key size")
         ("clustering-key-size", bpo::value<size_t>()->default_value(10), "clustering key size")
-        ("data-size", bpo::value<size_t>()->default_value(32), "cell data size");
+        ("data-size", bpo::value<size_t>()->default_value(32), "cell data size")
+        ("collection-size", bpo::value<size_t>()->default_value(0), "make regular columns maps with this many entries")
+        ("counters", "make regular columns counters")
+        ("matrix", "measure a fixed set of schema shapes instead of the one given by the options above")
+        ("json-result", bpo::value<std::string>(), "name of the json result file, with an object per shape");
 
     return app.run(argc, argv, [&] {
         if (smp::count != 1) {
@@ -240,30 +453,39 @@ int main(int argc, char** argv) {
         }
 
         return do_with_cql_env_thread([&](cql_test_env& env) {
-            mutation_settings settings;
-            settings.column_count = app.configuration()["column-count"].as<size_t>();
-            settings.column_name_size = app.configuration()["column-name-size"].as<size_t>();
-            settings.row_count = app.configuration()["row-count"].as<size_t>();
-            settings.partition_count = app.configuration()["partition-count"].as<size_t>();
-            settings.partition_key_size = app.configuration()["partition-key-size"].as<size_t>();
-            settings.clustering_key_size = app.configuration()["clustering-key-size"].as<size_t>();
-            settings.data_size = app.configuration()["data-size"].as<size_t>();
+            std::vector<shape> shapes;
+            if (app.configuration().contains("matrix")) {
+                shapes = matrix_shapes();
+            } else {
+                mutation_settings settings;
+                settings.column_count = app.configuration()["column-count"].as<size_t>();
+                settings.column_name_size = app.configuration()["column-name-size"].as<size_t>();
+                settings.row_count = app.configuration()["row-count"].as<size_t>();
+                settings.partition_count = app.configuration()["partition-count"].as<size_t>();
+                settings.partition_key_size = app.configuration()["partition-key-size"].as<size_t>();
+                settings.clustering_key_size = app.configuration()["clustering-key-size"].as<size_t>();
+                settings.data_size = app.configuration()["data-size"].as<size_t>();
+                settings.collection_size = app.configuration()["collection-size"].as<size_t>();
+                settings.counters = app.configuration().contains("counters");
+                shapes.push_back({"custom", settings});
+            }
 
             auto& tracker = env.local_db().find_column_family("system", "local").get_row_cache().get_cache_tracker();
-            auto sizes = calculate_sizes(tracker, settings);
-
-            std::cout << "mutation footprint:" << "\n";
-            std::cout << " - in cache:     " << sizes.cache << "\n";
-            std::cout << " - in memtable:  " << sizes.memtable << "\n";
-            std::cout << " - in sstable:\n";
-            for (auto v : sizes.sstable) {
-                std::cout << "   " << fmt::to_string(v.first) << ":   " << v.second << "\n";
+            Json::Value results{Json::arrayValue};
+            for (auto& sh : shapes) {
+                auto sizes = calculate_sizes(tracker, sh.settings);
+                if (shapes.size() > 1) {
+                    std::cout << sh.name << ":\n";
+                }
+                print_sizes(sizes);
+                std::cout << "\n";
+                results.append(sizes_to_json(sh, sizes));
+            }
+            if (app.configuration().contains("json-result")) {
+                auto out = std::ofstream(app.configuration()["json-result"].as<std::string>());
+                out << results;
             }
-            std::cout << " - frozen:       " << sizes.frozen << "\n";
-            std::cout << " - canonical:    " << sizes.canonical << "\n";
-            std::cout << " - query result: " << sizes.query_result << "\n";
 
-            std::cout << "\n";
             size_calculator::print_cache_entry_size();
 
             auto cache_st = tracker.region().collect_stats();
@@ -9,8 +9,13 @@
 #include "perf.hh"
 #include <seastar/core/reactor.hh>
 #include <seastar/core/memory.hh>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <json/json.h>
+#include <fstream>
 #include "seastarx.hh"
 #include "reader_concurrency_semaphore.hh"
+#include "release.hh"
 
 
 uint64_t perf_mallocs() {
@@ -21,6 +26,34 @@ uint64_t perf_tasks_processed() {
     return engine().get_sched_stats().tasks_processed;
 }
 
+uint64_t perf_cpu_time_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(engine().total_busy_time()).count();
+}
+
+reactor_stall_tracker::reactor_stall_tracker()
+    : _timer([this] { tick(); })
+{}
+
+void reactor_stall_tracker::tick() {
+    auto now = clk::now();
+    auto stall = now - _expected;
+    if (stall > task_quota) {
+        ++_violations;
+    }
+    _max_stall = std::max(_max_stall, stall);
+    _expected = now + task_quota;
+    _timer.arm(_expected);
+}
+
+void reactor_stall_tracker::start() {
+    _expected = clk::now() + task_quota;
+    _timer.arm(_expected);
+}
+
+void reactor_stall_tracker::stop() {
+    _timer.cancel();
+}
+
 void scheduling_latency_measurer::schedule_tick() {
     seastar::schedule(make_task(default_scheduling_group(), [self = weak_from_this()] () mutable {
         if (self) {
@@ -49,11 +82,60 @@ std::ostream& operator<<(std::ostream& out, const scheduling_latency_measurer& s
 
 std::ostream&
 operator<<(std::ostream& os, const perf_result& result) {
-    fmt::print(os, "{:.2f} tps ({:5.1f} allocs/op, {:5.1f} tasks/op, {:7.0f} insns/op, {:8} errors)",
-            result.throughput, result.mallocs_per_op, result.tasks_per_op, result.instructions_per_op, result.errors);
+    fmt::print(os, "{:.2f} tps ({:5.1f} allocs/op, {:5.1f} tasks/op, {:7.0f} insns/op, {:8} errors, {:5} quota violations, {:7.3f} ms max stall)",
+            result.throughput, result.mallocs_per_op, result.tasks_per_op, result.instructions_per_op, result.errors,
+            result.task_quota_violations, result.max_stall_ms);
     return os;
 }
 
+Json::Value make_json_result(const std::string& test_type, const perf_result& median, double mad, double max, double min) {
+    Json::Value results;
+
+    Json::Value stats;
+    stats["median tps"] = median.throughput;
+    stats["allocs_per_op"] = median.mallocs_per_op;
+    stats["tasks_per_op"] = median.tasks_per_op;
+    stats["instructions_per_op"] = median.instructions_per_op;
+    stats["errors"] = Json::UInt64(median.errors);
+    stats["task_quota_violations"] = Json::UInt64(median.task_quota_violations);
+    stats["max_stall_ms"] = median.max_stall_ms;
+    stats["mad tps"] = mad;
+    stats["max tps"] = max;
+    stats["min tps"] = min;
+    results["stats"] = std::move(stats);
+
+    results["test_properties"]["type"] = test_type;
+
+    // <version>-<release>
+    auto version_components = std::vector<std::string>{};
+    auto sver = scylla_version();
+    boost::algorithm::split(version_components, sver, boost::is_any_of("-"));
+    // <scylla-build>.<date>.<git-hash>
+    auto release_components = std::vector<std::string>{};
+    boost::algorithm::split(release_components, version_components[1], boost::is_any_of("."));
+
+    Json::Value version;
+    version["commit_id"] = release_components[2];
+    version["date"] = release_components[1];
+    version["version"] = version_components[0];
+
+    // It'd be nice to have std::chrono::format(), wouldn't it?
+    auto current_time = std::time(nullptr);
+    char time_str[100];
+    ::tm time_buf;
+    std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", ::localtime_r(&current_time, &time_buf));
+    version["run_date_time"] = time_str;
+
+    results["versions"]["scylla-server"] = std::move(version);
+
+    return results;
+}
+
+void write_json_result(const std::string& result_file, const Json::Value& result) {
+    auto out = std::ofstream(result_file);
+    out << result;
+}
+
 aio_writes_result_mixin::aio_writes_result_mixin()
     : aio_writes(engine().get_io_stats().aio_writes)
     , aio_write_bytes(engine().get_io_stats().aio_write_bytes)
@@ -65,8 +147,20 @@ void aio_writes_result_mixin::update(aio_writes_result_mixin& result, const exec
 }
 
 std::ostream& operator<<(std::ostream& os, const perf_result_with_aio_writes& result) {
-    fmt::print(os, "{:.2f} tps ({:5.1f} allocs/op, {:5.1f} tasks/op, {:7.0f} insns/op, {:8} errors, {:7.2f} bytes/op, {:5.1f} writes/op)",
-            result.throughput, result.mallocs_per_op, result.tasks_per_op, result.instructions_per_op, result.errors, result.aio_write_bytes, result.aio_writes);
+    fmt::print(os, "{:.2f} tps ({:5.1f} allocs/op, {:5.1f} tasks/op, {:7.0f} insns/op, {:8} errors, {:7.2f} bytes/op, {:5.1f} writes/op, {:5} quota violations, {:7.3f} ms max stall)",
+            result.throughput, result.mallocs_per_op, result.tasks_per_op, result.instructions_per_op, result.errors, result.aio_write_bytes, result.aio_writes,
+            result.task_quota_violations, result.max_stall_ms);
+    return os;
+}
+
+void cpu_time_result_mixin::update(cpu_time_result_mixin& result, const executor_shard_stats& stats) {
+    result.cpu_time_per_op_us = double(stats.cpu_time_ns) / 1000 / stats.invocations;
+}
+
+std::ostream& operator<<(std::ostream& os, const perf_result_with_cpu_time& result) {
+    fmt::print(os, "{:.2f} tps ({:5.1f} allocs/op, {:5.1f} tasks/op, {:7.0f} insns/op, {:7.1f} cpu-us/op, {:8} errors, {:5} quota violations, {:7.3f} ms max stall)",
+            result.throughput, result.mallocs_per_op, result.tasks_per_op, result.instructions_per_op, result.cpu_time_per_op_us, result.errors,
+            result.task_quota_violations, result.max_stall_ms);
     return os;
 }
 
@@ -12,6 +12,7 @@
 #include <seastar/core/future-util.hh>
 #include <seastar/core/distributed.hh>
 #include <seastar/core/weak_ptr.hh>
+#include <seastar/core/timer.hh>
 #include <seastar/coroutine/as_future.hh>
 #include "seastarx.hh"
 #include "utils/extremum_tracking.hh"
@@ -24,6 +25,10 @@
 #include <iosfwd>
 #include <boost/range/irange.hpp>
 
+namespace Json {
+class Value;
+}
+
 template <typename Func>
 static
 void time_it(Func func, int iterations = 5, int iterations_between_clock_readings = 1000) {
@@ -53,6 +58,10 @@ struct executor_shard_stats {
     uint64_t tasks_executed = 0;
     uint64_t instructions_retired = 0;
     uint64_t errors = 0;
+    uint64_t cpu_time_ns = 0;
+    uint64_t task_quota_violations = 0;
+    // Not a counter, the longest stall seen since the executor started
+    uint64_t max_stall_ns = 0;
 };
 
 inline
@@ -63,6 +72,9 @@ operator+(executor_shard_stats a, executor_shard_stats b) {
     a.tasks_executed += b.tasks_executed;
     a.instructions_retired += b.instructions_retired;
     a.errors += b.errors;
+    a.cpu_time_ns += b.cpu_time_ns;
+    a.task_quota_violations += b.task_quota_violations;
+    a.max_stall_ns = std::max(a.max_stall_ns, b.max_stall_ns);
     return a;
 }
 
@@ -74,11 +86,43 @@ operator-(executor_shard_stats a, executor_shard_stats b) {
     a.tasks_executed -= b.tasks_executed;
     a.instructions_retired -= b.instructions_retired;
     a.errors -= b.errors;
+    a.cpu_time_ns -= b.cpu_time_ns;
+    a.task_quota_violations -= b.task_quota_violations;
     return a;
 }
 
 uint64_t perf_tasks_processed();
 uint64_t perf_mallocs();
+// Busy time of the reactor of this shard. Unlike the CPU time of the reactor
+// thread, it does not include polling while idle.
+uint64_t perf_cpu_time_ns();
+
+// Detects reactor stalls: a timer which should fire every task quota is
+// late by about as long as the task which kept the reactor from polling.
+// Unlike scheduling_latency_measurer, it does not keep the reactor busy.
+class reactor_stall_tracker {
+    using clk = std::chrono::steady_clock;
+    // The default task quota of seastar
+    static constexpr std::chrono::microseconds task_quota{500};
+
+    timer<clk> _timer;
+    clk::time_point _expected;
+    uint64_t _violations = 0;
+    clk::duration _max_stall = clk::duration::zero();
+private:
+    void tick();
+public:
+    reactor_stall_tracker();
+    void start();
+    void stop();
+    // Number of times the reactor did not poll for more than a task quota
+    uint64_t task_quota_violations() const {
+        return _violations;
+    }
+    uint64_t max_stall_ns() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(_max_stall).count();
+    }
+};
 
 // Drives concurrent and continuous execution of given asynchronous action
 // until a deadline. Counts invocations and collects statistics.
@@ -92,6 +136,7 @@ class executor {
     uint64_t _count;
     uint64_t _errors;
     linux_perf_event _instructions_retired_counter = linux_perf_event::user_instructions_retired();
+    reactor_stall_tracker _stall_tracker;
 private:
     executor_shard_stats executor_shard_stats_snapshot();
     future<> run_worker() {
@@ -122,10 +167,12 @@ class executor {
     future<executor_shard_stats> run() {
         auto stats_start = executor_shard_stats_snapshot();
         _instructions_retired_counter.enable();
+        _stall_tracker.start();
         auto idx = boost::irange(0, (int)_n_workers);
         return parallel_for_each(idx.begin(), idx.end(), [this] (auto idx) mutable {
             return this->run_worker();
         }).then([this, stats_start] {
+            _stall_tracker.stop();
             _instructions_retired_counter.disable();
             auto stats_end = executor_shard_stats_snapshot();
             return stats_end - stats_start;
@@ -146,6 +193,9 @@ executor<Func>::executor_shard_stats_snapshot() {
         .tasks_executed = perf_tasks_processed(),
         .instructions_retired = _instructions_retired_counter.read(),
         .errors = _errors,
+        .cpu_time_ns = perf_cpu_time_ns(),
+        .task_quota_violations = _stall_tracker.task_quota_violations(),
+        .max_stall_ns = _stall_tracker.max_stall_ns(),
     };
 }
 
@@ -155,10 +205,23 @@ struct perf_result {
     double tasks_per_op;
     double instructions_per_op;
     uint64_t errors;
+    uint64_t task_quota_violations;
+    double max_stall_ms;
 };
 
 std::ostream& operator<<(std::ostream& os, const perf_result& result);
 
+// Makes the json result of a test, in the schema shared by all the perf
+// tools so that the results of different builds can be compared:
+//   "stats": the throughput of the iterations, and the costs and stalls of
+//            the median iteration,
+//   "test_properties": {"type": test_type},
+//   "versions": the version of scylla which ran the test.
+// Tools add their "parameters", and stats of their own, to the result.
+Json::Value make_json_result(const std::string& test_type, const perf_result& median, double mad, double max, double min);
+
+void write_json_result(const std::string& result_file, const Json::Value& result);
+
 // Use to make a perf_result with aio_writes added. Need to give "update" as
 // update-func to time_parallel_ex to make it work.
 struct aio_writes_result_mixin {
@@ -174,6 +237,18 @@ struct perf_result_with_aio_writes : public perf_result, public aio_writes_resul
 
 std::ostream& operator<<(std::ostream& os, const perf_result_with_aio_writes& result);
 
+// Use to make a perf_result with the CPU time per operation added. Need to
+// give "update" as update-func to time_parallel_ex to make it work.
+struct cpu_time_result_mixin {
+    double cpu_time_per_op_us;
+
+    static void update(cpu_time_result_mixin& result, const executor_shard_stats& stats);
+};
+
+struct perf_result_with_cpu_time : public perf_result, public cpu_time_result_mixin {};
+
+std::ostream& operator<<(std::ostream& os, const perf_result_with_cpu_time& result);
+
 /**
  * Measures throughput of an asynchronous action. Executes the action on all cores
  * in parallel, with given number of concurrent executions per core.
@@ -210,6 +285,8 @@ std::vector<Res> time_parallel_ex(Func func, unsigned concurrency_per_core, int
         result.tasks_per_op = double(stats.tasks_executed) / stats.invocations;
         result.instructions_per_op = double(stats.instructions_retired) / stats.invocations;
         result.errors = stats.errors;
+        result.task_quota_violations = stats.task_quota_violations;
+        result.max_stall_ms = stats.max_stall_ns / 1e6;
 
         uf(result, stats);
 
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/http/client.hh>
+#include <seastar/testing/test_runner.hh>
+#include <seastar/util/short_streams.hh>
+
+#include <boost/range/irange.hpp>
+#include <json/json.h>
+
+#include "test/lib/cql_test_env.hh"
+#include "test/lib/alternator_test_env.hh"
+#include "test/lib/random_utils.hh"
+#include "test/perf/perf.hh"
+#include "utils/http.hh"
+#include "db/config.hh"
+#include "db/extensions.hh"
+#include "db/tags/extension.hh"
+
+static logging::logger plog("perf_alternator");
+
+static const sstring table_name = "alternator_perf";
+
+struct test_config {
+    enum class run_mode { get_item, put_item, query, batch_write_item };
+
+    run_mode mode;
+    unsigned partitions;
+    unsigned rows_per_partition;
+    unsigned attributes;
+    unsigned item_size;
+    unsigned batch_size;
+    unsigned concurrency;
+    unsigned duration_in_seconds;
+    unsigned operations_per_shard = 0;
+    bool flush_memtables;
+    bool stop_on_error;
+    uint16_t port;
+    // The non-key attributes of an item, as they appear in a request:
+    // , "a0": {"S": "..."}, "a1": ...
+    sstring attributes_json;
+};
+
+std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
+    switch (m) {
+        case test_config::run_mode::get_item: return os << "GetItem";
+        case test_config::run_mode::put_item: return os << "PutItem";
+        case test_config::run_mode::query: return os << "Query";
+        case test_config::run_mode::batch_write_item: return os << "BatchWriteItem";
+    }
+    abort();
+}
+
+std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
+    return os << "{partitions=" << cfg.partitions
+           << ", rows_per_partition=" << cfg.rows_per_partition
+           << ", attributes=" << cfg.attributes
+           << ", item_size=" << cfg.item_size
+           << ", batch_size=" << cfg.batch_size
+           << ", concurrency=" << cfg.concurrency
+           << ", operation=" << cfg.mode
+           << "}";
+}
+
+// An HTTP client of the alternator server of this process. Requests go
+// through the loopback interface, so the whole HTTP path of the server,
+// including the cost of the client, is measured.
+class alternator_client {
+    http::experimental::client _http;
+public:
+    alternator_client(uint16_t port, unsigned max_connections)
+        : _http(std::make_unique<utils::http::dns_connection_factory>("127.0.0.1", port, false, plog), max_connections)
+    { }
+
+    future<> stop() {
+        return _http.close();
+    }
+
+    future<> request(std::string_view operation, sstring body) {
+        auto req = http::request::make("POST", "localhost", "/");
+        req._headers["X-Amz-Target"] = format("DynamoDB_20120810.{}", operation);
+        req.write_body("json", std::move(body));
+        return _http.make_request(std::move(req), [] (const http::reply&, input_stream<char>&& in_) -> future<> {
+            auto in = std::move(in_);
+            co_await util::skip_entire_stream(in);
+        }, http::reply::status_type::ok);
+    }
+};
+
+static sstring make_item(const test_config& cfg, unsigned partition, unsigned row) {
+    return format(R"({{"p": {{"S": "{}"}}, "c": {{"N": "{}"}}{}}})", partition, row, cfg.attributes_json);
+}
+
+static unsigned random_partition(const test_config& cfg) {
+    return tests::random::get_int<unsigned>(cfg.partitions - 1);
+}
+
+static unsigned random_row(const test_config& cfg) {
+    return tests::random::get_int<unsigned>(cfg.rows_per_partition - 1);
+}
+
+static void create_table(alternator_client& client) {
+    client.request("CreateTable", format(R"({{
+            "TableName": "{}",
+            "BillingMode": "PAY_PER_REQUEST",
+            "AttributeDefinitions": [
+                {{"AttributeName": "p", "AttributeType": "S"}},
+                {{"AttributeName": "c", "AttributeType": "N"}}
+            ],
+            "KeySchema": [
+                {{"AttributeName": "p", "KeyType": "HASH"}},
+                {{"AttributeName": "c", "KeyType": "RANGE"}}
+            ]
+        }})", table_name)).get();
+}
+
+static void create_items(alternator_client& client, test_config& cfg) {
+    std::cout << "Creating " << cfg.partitions << " partitions of " << cfg.rows_per_partition << " items..." << std::endl;
+    max_concurrent_for_each(boost::irange(0u, cfg.partitions), 100, [&] (unsigned partition) {
+        return do_for_each(boost::irange(0u, cfg.rows_per_partition), [&client, &cfg, partition] (unsigned row) {
+            return client.request("PutItem", format(R"({{"TableName": "{}", "Item": {}}})", table_name, make_item(cfg, partition, row)));
+        });
+    }).get();
+}
+
+static future<> do_request(alternator_client& client, const test_config& cfg) {
+    switch (cfg.mode) {
+    case test_config::run_mode::get_item:
+        return client.request("GetItem", format(R"({{"TableName": "{}", "Key": {{"p": {{"S": "{}"}}, "c": {{"N": "{}"}}}}}})",
+                table_name, random_partition(cfg), random_row(cfg)));
+    case test_config::run_mode::put_item:
+        return client.request("PutItem", format(R"({{"TableName": "{}", "Item": {}}})",
+                table_name, make_item(cfg, random_partition(cfg), random_row(cfg))));
+    case test_config::run_mode::query:
+        return client.request("Query", format(R"({{"TableName": "{}", "KeyConditionExpression": "p = :p", )"
+                R"("ExpressionAttributeValues": {{":p": {{"S": "{}"}}}}}})", table_name, random_partition(cfg)));
+    case test_config::run_mode::batch_write_item: {
+        sstring requests;
+        for (unsigned i = 0; i < cfg.batch_size; ++i) {
+            requests += format(R"({}{{"PutRequest": {{"Item": {}}}}})", i ? ", " : "", make_item(cfg, random_partition(cfg), random_row(cfg)));
+        }
+        return client.request("BatchWriteItem", format(R"({{"RequestItems": {{"{}": [{}]}}}})", table_name, requests));
+    }
+    }
+    abort();
+}
+
+static std::vector<perf_result_with_cpu_time> do_alternator_test(cql_test_env& env, std::string isolation_level, test_config& cfg) {
+    std::cout << "Running test with config: " << cfg << std::endl;
+
+    alternator_test_env alternator_env(env.gossiper(), env.get_storage_proxy(), env.migration_manager(), env.qp());
+    alternator_env.start(isolation_level).get();
+    auto stop_alternator_env = defer([&] {
+        alternator_env.stop().get();
+    });
+    alternator_env.start_server(env, cfg.port).get();
+
+    sharded<alternator_client> clients;
+    clients.start(cfg.port, cfg.concurrency).get();
+    auto stop_clients = defer([&] {
+        clients.stop().get();
+    });
+
+    create_table(clients.local());
+    if (cfg.mode != test_config::run_mode::put_item && cfg.mode != test_config::run_mode::batch_write_item) {
+        create_items(clients.local(), cfg);
+        if (cfg.flush_memtables) {
+            std::cout << "Flushing partitions..." << std::endl;
+            alternator_env.flush_memtables().get();
+        }
+    }
+
+    return time_parallel_ex<perf_result_with_cpu_time>([&clients, &cfg] {
+        return do_request(clients.local(), cfg);
+    }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error, cpu_time_result_mixin::update);
+}
+
+namespace perf {
+
+int scylla_alternator_main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("random-seed", boost::program_options::value<unsigned>(), "Random number generator seed")
+        ("operation", bpo::value<std::string>()->default_value("GetItem"), "operation to test: GetItem, PutItem, Query or BatchWriteItem")
+        ("partitions", bpo::value<unsigned>()->default_value(10000), "number of partitions")
+        ("rows-per-partition", bpo::value<unsigned>()->default_value(1), "number of items per partition, read by a Query")
+        ("attributes", bpo::value<unsigned>()->default_value(5), "number of non-key attributes of an item")
+        ("item-size", bpo::value<unsigned>()->default_value(200), "size of the non-key attributes of an item, in bytes")
+        ("batch-size", bpo::value<unsigned>()->default_value(25), "number of items written by a BatchWriteItem")
+        ("duration", bpo::value<unsigned>()->default_value(5), "test duration in seconds")
+        ("concurrency", bpo::value<unsigned>()->default_value(100), "workers per core")
+        ("operations-per-shard", bpo::value<unsigned>(), "run this many operations per shard (overrides duration)")
+        ("flush", "flush memtables before test")
+        ("stop-on-error", bpo::value<bool>()->default_value(true), "stop after encountering the first error")
+        ("isolation", bpo::value<std::string>()->default_value("only_rmw_uses_lwt"), "alternator write isolation")
+        ("port", bpo::value<uint16_t>()->default_value(8000), "port of the alternator HTTP server")
+        ("json-result", bpo::value<std::string>(), "name of the json result file")
+        ;
+
+    set_abort_on_internal_error(true);
+
+    return app.run(argc, argv, [&app] {
+        auto conf_seed = app.configuration()["random-seed"];
+        auto seed = conf_seed.empty() ? std::random_device()() : conf_seed.as<unsigned>();
+        std::cout << "random-seed=" << seed << '\n';
+        return smp::invoke_on_all([seed] {
+            seastar::testing::local_random_engine.seed(seed + this_shard_id());
+        }).then([&app] () -> future<> {
+            auto ext = std::make_shared<db::extensions>();
+            ext->add_schema_extension<db::tags_extension>(db::tags_extension::NAME);
+            auto db_cfg = ::make_shared<db::config>(ext);
+            cql_test_config cql_cfg(db_cfg);
+          return do_with_cql_env_thread([&app] (cql_test_env& env) {
+            auto cfg = test_config();
+            auto operation = app.configuration()["operation"].as<std::string>();
+            if (operation == "GetItem") {
+                cfg.mode = test_config::run_mode::get_item;
+            } else if (operation == "PutItem") {
+                cfg.mode = test_config::run_mode::put_item;
+            } else if (operation == "Query") {
+                cfg.mode = test_config::run_mode::query;
+            } else if (operation == "BatchWriteItem") {
+                cfg.mode = test_config::run_mode::batch_write_item;
+            } else {
+                throw std::invalid_argument(format("unsupported operation: {}", operation));
+            }
+            cfg.partitions = std::max(app.configuration()["partitions"].as<unsigned>(), 1u);
+            cfg.rows_per_partition = std::max(app.configuration()["rows-per-partition"].as<unsigned>(), 1u);
+            cfg.attributes = app.configuration()["attributes"].as<unsigned>();
+            cfg.item_size = app.configuration()["item-size"].as<unsigned>();
+            cfg.batch_size = std::clamp(app.configuration()["batch-size"].as<unsigned>(), 1u, 25u);
+            cfg.duration_in_seconds = app.configuration()["duration"].as<unsigned>();
+            cfg.concurrency = app.configuration()["concurrency"].as<unsigned>();
+            if (app.configuration().contains("operations-per-shard")) {
+                cfg.operations_per_shard = app.configuration()["operations-per-shard"].as<unsigned>();
+            }
+            cfg.flush_memtables = app.configuration().contains("flush");
+            cfg.stop_on_error = app.configuration()["stop-on-error"].as<bool>();
+            cfg.port = app.configuration()["port"].as<uint16_t>();
+            for (unsigned i = 0; i < cfg.attributes; ++i) {
+                auto size = cfg.item_size / cfg.attributes + (i < cfg.item_size % cfg.attributes);
+                cfg.attributes_json += format(R"(, "a{}": {{"S": "{}"}})", i, tests::random::get_sstring(size));
+            }
+
+            auto results = do_alternator_test(env, app.configuration()["isolation"].as<std::string>(), cfg);
+
+            auto compare_throughput = [] (const perf_result& a, const perf_result& b) { return a.throughput < b.throughput; };
+            std::sort(results.begin(), results.end(), compare_throughput);
+            auto median_result = results[results.size() / 2];
+            std::vector<double> absolute_deviations;
+            for (auto& r : results) {
+                absolute_deviations.push_back(std::abs(r.throughput - median_result.throughput));
+            }
+            std::sort(absolute_deviations.begin(), absolute_deviations.end());
+            auto mad = absolute_deviations[results.size() / 2];
+            std::cout << format("\nmedian {}\nmedian absolute deviation: {:.2f}\nmaximum: {:.2f}\nminimum: {:.2f}\n",
+                    median_result, mad, results.back().throughput, results.front().throughput);
+
+            if (app.configuration().contains("json-result")) {
+                auto json = make_json_result("alternator_" + operation, median_result, mad, results.back().throughput, results.front().throughput);
+                Json::Value params;
+                params["concurrency"] = cfg.concurrency;
+                params["partitions"] = cfg.partitions;
+                params["rows-per-partition"] = cfg.rows_per_partition;
+                params["item-size"] = cfg.item_size;
+                params["cpus"] = smp::count;
+                params["duration"] = cfg.duration_in_seconds;
+                json["parameters"] = std::move(params);
+                json["stats"]["cpu_us_per_op"] = median_result.cpu_time_per_op_us;
+                write_json_result(app.configuration()["json-result"].as<std::string>(), json);
+            }
+          }, std::move(cql_cfg));
+        });
+    });
+}
+
+} // namespace perf
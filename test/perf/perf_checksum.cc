@@ -53,3 +53,8 @@ PERF_TEST_F(crc_test, perf_zlib_crc32_checksum) {
     perf_tests::do_not_optimize(
         zlib_crc32_checksummer::checksum(data.data(), data.size()));
 }
+
+PERF_TEST_F(crc_test, perf_zlib_adler32) {
+    perf_tests::do_not_optimize(
+        zlib_adler32_checksummer::checksum(data.data(), data.size()));
+}
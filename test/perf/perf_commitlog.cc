@@ -6,7 +6,7 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  */
 
-#include <fstream>
+#include <unordered_set>
 
 #include <boost/range/irange.hpp>
 #include <boost/algorithm/string/split.hpp>
@@ -25,11 +25,22 @@
 
 #include "db/config.hh"
 #include "schema/schema_builder.hh"
-#include "release.hh"
 #include "db/config.hh"
 #include "db/extensions.hh"
 #include "db/commitlog/commitlog.hh"
 #include "utils/UUID_gen.hh"
+#include "utils/estimated_histogram.hh"
+
+// One point of the workload matrix, see the list options in main().
+struct workload {
+    sstring sync_mode;
+    bool use_o_dsync;
+    unsigned segment_size_in_mb;
+    // "uniform" picks entry sizes uniformly between min-data-size and max-data-size,
+    // "exponential" mostly picks small entries, with a long tail of large ones.
+    sstring size_distribution;
+    unsigned tables;
+};
 
 struct test_config {
     unsigned concurrency;
@@ -41,12 +52,22 @@ struct test_config {
 
     uint64_t min_flush_delay_in_ms;
     uint64_t max_flush_delay_in_ms;
+
+    workload wl;
 };
 
 using clperf_result = perf_result_with_aio_writes;
 
-static void write_json_result(std::string result_file, const test_config& cfg, clperf_result median, double mad, double max, double min) {
-    Json::Value results;
+// What a workload measured, besides the per-iteration throughput.
+struct workload_stats {
+    // Latency of add_mutation() in microseconds, merged from all shards.
+    utils::estimated_histogram add_latency;
+    uint64_t segments_created = 0;
+    uint64_t segments_destroyed = 0;
+};
+
+static Json::Value make_json_result(const test_config& cfg, clperf_result median, double mad, double max, double min, const workload_stats& ws) {
+    auto results = ::make_json_result("commitlog_write", median, mad, max, min);
 
     Json::Value params;
     params["concurrency"] = cfg.concurrency;
@@ -58,97 +79,216 @@ static void write_json_result(std::string result_file, const test_config& cfg, c
     params["min-flush-delay-in-ms"] = cfg.min_flush_delay_in_ms;
     params["max-flush-delay-in-ms"] = cfg.max_flush_delay_in_ms;
 
+    params["commitlog-sync"] = cfg.wl.sync_mode;
+    params["commitlog-use-o-dsync"] = cfg.wl.use_o_dsync;
+    params["commitlog-segment-size-in-mb"] = cfg.wl.segment_size_in_mb;
+    params["size-distribution"] = cfg.wl.size_distribution;
+    params["tables"] = cfg.wl.tables;
+
     params["concurrency,cpus,duration"] = fmt::format("{},{},{}", cfg.concurrency, smp::count, cfg.duration_in_seconds);
     results["parameters"] = std::move(params);
 
-    Json::Value stats;
-    stats["median tps"] = median.throughput;
-    stats["allocs_per_op"] = median.mallocs_per_op;
-    stats["tasks_per_op"] = median.tasks_per_op;
-    stats["instructions_per_op"] = median.instructions_per_op;
+    auto& stats = results["stats"];
     stats["aio_writes"] = median.aio_writes;
     stats["aio_write_bytes"] = median.aio_write_bytes;
-    stats["mad tps"] = mad;
-    stats["max tps"] = max;
-    stats["min tps"] = min;
-    results["stats"] = std::move(stats);
-
-    std::string test_type = "commitlog_write";
-    results["test_properties"]["type"] = test_type;
-
-    // <version>-<release>
-    auto version_components = std::vector<std::string>{};
-    auto sver = scylla_version();
-    boost::algorithm::split(version_components, sver, boost::is_any_of("-"));
-    // <scylla-build>.<date>.<git-hash>
-    auto release_components = std::vector<std::string>{};
-    boost::algorithm::split(release_components, version_components[1], boost::is_any_of("."));
-
-    Json::Value version;
-    version["commit_id"] = release_components[2];
-    version["date"] = release_components[1];
-    version["version"] = version_components[0];
-
-    // It'd be nice to have std::chrono::format(), wouldn't it?
-    auto current_time = std::time(nullptr);
-    char time_str[100];
-    ::tm time_buf;
-    std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", ::localtime_r(&current_time, &time_buf));
-    version["run_date_time"] = time_str;
-
-    results["versions"]["scylla-server"] = std::move(version);
-
-    auto out = std::ofstream(result_file);
-    out << results;
+    stats["p50 add latency us"] = Json::Int64(ws.add_latency.percentile(0.5));
+    stats["p99 add latency us"] = Json::Int64(ws.add_latency.percentile(0.99));
+    stats["segments created"] = Json::UInt64(ws.segments_created);
+    stats["segments destroyed"] = Json::UInt64(ws.segments_destroyed);
+    stats["segments created per second"] = double(ws.segments_created) / cfg.duration_in_seconds;
+
+    return results;
 }
 
 struct commitlog_service {
     test_config cfg;
     std::uniform_int_distribution<unsigned> delay_dist;
     std::uniform_int_distribution<size_t> size_dist;
+    std::exponential_distribution<double> exp_size_dist;
+    std::uniform_int_distribution<unsigned> table_dist;
+    std::vector<table_id> tables;
     std::optional<db::commitlog> log;
     std::optional<db::commitlog::flush_handler_anchor> fa;
+    // Tables asked to flush, released together when flush_timer fires.
+    std::unordered_set<table_id> pending_flushes;
     timer<> flush_timer;
+    utils::estimated_histogram add_latency;
 
     commitlog_service(const test_config& c)
         : cfg(c)
         , delay_dist(cfg.min_flush_delay_in_ms, cfg.max_flush_delay_in_ms)
         , size_dist(cfg.min_data_size, cfg.max_data_size)
-    {}
+        // Averages at 1/16 of the configured size range above the minimum.
+        , exp_size_dist(16.0 / std::max<size_t>(cfg.max_data_size - cfg.min_data_size, 1))
+        , table_dist(0, cfg.wl.tables - 1)
+    {
+        for (unsigned i = 0; i < cfg.wl.tables; ++i) {
+            tables.push_back(table_id(utils::UUID_gen::get_time_UUID()));
+        }
+    }
 
     future<> init(const db::commitlog::config& cfg) {
         assert(!log);
         log.emplace(co_await db::commitlog::create_commitlog(cfg));
         fa.emplace(log->add_flush_handler(std::bind(&commitlog_service::flush_handler, this, std::placeholders::_1, std::placeholders::_2)));
+        flush_timer.set_callback([this] {
+            for (auto& id : std::exchange(pending_flushes, {})) {
+                log->discard_completed_segments(id);
+            }
+        });
     }
     future<> stop() {
+        flush_timer.cancel();
         if (log) {
             co_await log->shutdown();
             co_await log->clear();
         }
     }
     void flush_handler(db::cf_id_type id, db::replay_position pos) {
+        pending_flushes.insert(id);
         if (!flush_timer.armed()) {
-            flush_timer.set_callback([id, this] { log->discard_completed_segments(id); });
             flush_timer.arm(std::chrono::milliseconds(delay_dist(tests::random::gen())));
         }
     }
+    size_t next_size() {
+        if (cfg.wl.size_distribution == "exponential") {
+            auto extra = size_t(exp_size_dist(tests::random::gen()));
+            return std::min(cfg.min_data_size + extra, cfg.max_data_size);
+        }
+        return size_dist(tests::random::gen());
+    }
+    const table_id& next_table() {
+        return tables[table_dist(tests::random::gen())];
+    }
+    workload_stats stats() const {
+        return workload_stats{add_latency, log->get_num_segments_created(), log->get_num_segments_destroyed()};
+    }
 };
 
-static std::vector<clperf_result> do_commitlog_test(distributed<commitlog_service>& cls, test_config& cfg) {
-    auto uuid = table_id(utils::UUID_gen::get_time_UUID());
+static workload_stats merge_stats(workload_stats a, const workload_stats& b) {
+    a.add_latency.merge(b.add_latency);
+    a.segments_created += b.segments_created;
+    a.segments_destroyed += b.segments_destroyed;
+    return a;
+}
 
+static std::vector<clperf_result> do_commitlog_test(distributed<commitlog_service>& cls, test_config& cfg) {
     return time_parallel_ex<clperf_result>([&] {
         auto& log = cls.local();
-        size_t size = log.size_dist(tests::random::gen());
-        return log.log->add_mutation(uuid, size, db::commitlog::force_sync::no, [size](db::commitlog::output& dst) {
+        size_t size = log.next_size();
+        auto start = std::chrono::steady_clock::now();
+        return log.log->add_mutation(log.next_table(), size, db::commitlog::force_sync::no, [size](db::commitlog::output& dst) {
             dst.fill('1', size);
-        }).then([](db::rp_handle h) {
+        }).then([&log, start](db::rp_handle h) {
             h.release();
+            log.add_latency.add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
         });
     }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, true, &clperf_result::update);
 }
 
+static std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> res;
+    boost::algorithm::split(res, s, boost::is_any_of(","));
+    return res;
+}
+
+static bool parse_bool(const std::string& s) {
+    if (s == "true" || s == "1") {
+        return true;
+    }
+    if (s == "false" || s == "0") {
+        return false;
+    }
+    throw std::invalid_argument(fmt::format("Invalid boolean value: {}", s));
+}
+
+static std::vector<workload> make_workloads(const boost::program_options::variables_map& opts, const db::config& db_cfg) {
+    auto list = [&] (const char* name, std::string dflt) {
+        return split_list(opts.contains(name) ? opts[name].as<std::string>() : dflt);
+    };
+
+    std::vector<workload> res;
+    for (auto& sync_mode : list("commitlog-sync", db_cfg.commitlog_sync())) {
+        for (auto& o_dsync : list("commitlog-use-o-dsync", db_cfg.commitlog_use_o_dsync() ? "true" : "false")) {
+            for (auto& segment_size : list("commitlog-segment-size-in-mb", std::to_string(db_cfg.commitlog_segment_size_in_mb()))) {
+                for (auto& size_distribution : list("size-distribution", "uniform")) {
+                    if (size_distribution != "uniform" && size_distribution != "exponential") {
+                        throw std::invalid_argument(fmt::format("Unknown size distribution: {}", size_distribution));
+                    }
+                    for (auto& tables : list("tables", "1")) {
+                        auto n = std::stoul(tables);
+                        if (n == 0) {
+                            throw std::invalid_argument("Number of tables must be positive");
+                        }
+                        res.push_back(workload{sync_mode, parse_bool(o_dsync), unsigned(std::stoul(segment_size)), size_distribution, unsigned(n)});
+                    }
+                }
+            }
+        }
+    }
+    return res;
+}
+
+static future<Json::Value> run_workload(db::config& db_cfg, test_config cfg) {
+    db_cfg.commitlog_sync(cfg.wl.sync_mode);
+    db_cfg.commitlog_use_o_dsync(cfg.wl.use_o_dsync);
+    db_cfg.commitlog_segment_size_in_mb(cfg.wl.segment_size_in_mb);
+
+    std::cout << format("\nworkload: commitlog-sync={} commitlog-use-o-dsync={} commitlog-segment-size-in-mb={} size-distribution={} tables={}\n",
+            cfg.wl.sync_mode, cfg.wl.use_o_dsync, cfg.wl.segment_size_in_mb, cfg.wl.size_distribution, cfg.wl.tables);
+
+    db::commitlog::config cl_cfg = db::commitlog::config::from_db_config(db_cfg, current_scheduling_group(), memory::stats().total_memory());
+    tmpdir tmp;
+    cl_cfg.commit_log_location = tmp.path().string();
+
+    distributed<commitlog_service> test_commitlog;
+
+    //logging::logger_registry().set_logger_level("commitlog", logging::log_level::debug);
+
+    co_await test_commitlog.start(cfg);
+    co_await test_commitlog.invoke_on_all(std::mem_fn(&commitlog_service::init), cl_cfg);
+    std::exception_ptr ex;
+    Json::Value json;
+
+    try {
+        if (cfg.max_data_size > test_commitlog.local().log->max_record_size()) {
+            throw std::invalid_argument(sstring("Too large max data size: ") + std::to_string(cfg.max_data_size));
+        }
+        // test "framework" expects seastar thread
+        auto results = co_await seastar::async([&] {
+            return do_commitlog_test(test_commitlog, cfg);
+        });
+        auto ws = co_await test_commitlog.map_reduce0(std::mem_fn(&commitlog_service::stats), workload_stats{}, merge_stats);
+
+        auto compare_throughput = [] (perf_result a, perf_result b) { return a.throughput < b.throughput; };
+        std::sort(results.begin(), results.end(), compare_throughput);
+        auto median_result = results[results.size() / 2];
+        auto median = median_result.throughput;
+        auto min = results[0].throughput;
+        auto max = results[results.size() - 1].throughput;
+        auto absolute_deviations = boost::copy_range<std::vector<double>>(
+                results
+                | boost::adaptors::transformed(std::mem_fn(&perf_result::throughput))
+                | boost::adaptors::transformed([&] (double r) { return abs(r - median); }));
+        std::sort(absolute_deviations.begin(), absolute_deviations.end());
+        auto mad = absolute_deviations[results.size() / 2];
+        std::cout << format("\nmedian {}\nmedian absolute deviation: {:.2f}\nmaximum: {:.2f}\nminimum: {:.2f}\n", median_result, mad, max, min);
+        std::cout << format("add latency p50: {}us p99: {}us\nsegments created: {} destroyed: {}\n",
+                ws.add_latency.percentile(0.5), ws.add_latency.percentile(0.99), ws.segments_created, ws.segments_destroyed);
+
+        json = make_json_result(cfg, median_result, mad, max, min, ws);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+
+    co_await test_commitlog.stop();
+
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    co_return json;
+}
+
 int main(int argc, char** argv) {
     namespace bpo = boost::program_options;
     app_template app;
@@ -158,11 +298,16 @@ int main(int argc, char** argv) {
         ("concurrency", bpo::value<unsigned>()->default_value(100), "workers per core")
         ("operations-per-shard", bpo::value<unsigned>(), "run this many operations per shard (overrides duration)")
 
-        ("commitlog-sync", bpo::value<sstring>(), "commitlog sync method (pediodic/batch)")
-        ("commitlog-segment-size-in-mb", bpo::value<unsigned>(), "commitlog segment size")
+        // The options below take a comma-separated list of values. The test is run
+        // for every combination of them, each in a fresh commitlog.
+        ("commitlog-sync", bpo::value<std::string>(), "commitlog sync methods (periodic/batch)")
+        ("commitlog-segment-size-in-mb", bpo::value<std::string>(), "commitlog segment sizes")
+        ("commitlog-use-o-dsync", bpo::value<std::string>(), "whether or not to use O_DSYNC mode for commitlog segments io (true/false)")
+        ("size-distribution", bpo::value<std::string>(), "distributions of the size of data elements added (uniform/exponential, default uniform)")
+        ("tables", bpo::value<std::string>(), "numbers of tables which data elements are added for (default 1)")
+
         ("commitlog-total-space-in-mb", bpo::value<unsigned>(), "total commitlog size")
         ("commitlog-sync-period-in-ms", bpo::value<unsigned>(), "how long the system waits for other writes before performing a sync in \"periodic\" mode")
-        ("commitlog-use-o-dsync", bpo::value<bool>()->default_value(true), "whether or not to use O_DSYNC mode for commitlog segments io")
         ("commitlog-use-hard-size-limit", bpo::value<bool>()->default_value(true), "whether or not to use a hard size limit for commitlog disk usage")
 
         ("min-data-size", bpo::value<size_t>()->default_value(200), "minimum size of data element added")
@@ -171,7 +316,7 @@ int main(int argc, char** argv) {
         ("min-flush-delay-in-ms", bpo::value<uint64_t>()->default_value(10), "minimum flush response delay")
         ("max-flush-delay-in-ms", bpo::value<uint64_t>()->default_value(800), "maximum flush response delay")
 
-        ("json-result", bpo::value<std::string>(), "name of the json result file")
+        ("json-result", bpo::value<std::string>(), "name of the json result file, which gets an array with the result of each workload")
         ;
 
     set_abort_on_internal_error(true);
@@ -189,21 +334,12 @@ int main(int argc, char** argv) {
         auto ext = std::make_shared<db::extensions>(); // TODO: maybe add commitlog file extension + delays or errors.
         auto db_cfg = ::make_shared<db::config>(ext);
 
-        if (app.configuration().contains("commitlog-sync")) {
-            db_cfg->commitlog_sync(app.configuration()["commitlog-sync"].as<sstring>());
-        }
-        if (app.configuration().contains("commitlog-segment-size-in-mb")) {
-            db_cfg->commitlog_segment_size_in_mb(app.configuration()["commitlog-segment-size-in-mb"].as<unsigned>());
-        }
         if (app.configuration().contains("commitlog-total-space-in-mb")) {
             db_cfg->commitlog_total_space_in_mb(app.configuration()["commitlog-total-space-in-mb"].as<unsigned>());
         }
         if (app.configuration().contains("commitlog-sync-period-in-ms")) {
             db_cfg->commitlog_sync_period_in_ms(app.configuration()["commitlog-sync-period-in-ms"].as<unsigned>());
         }
-        if (app.configuration().contains("commitlog-use-o-dsync")) {
-            db_cfg->commitlog_use_o_dsync(app.configuration()["commitlog-use-o-dsync"].as<bool>());
-        }
         if (app.configuration().contains("commitlog-use-hard-size-limit")) {
             db_cfg->commitlog_use_hard_size_limit(app.configuration()["commitlog-use-hard-size-limit"].as<bool>());
         }
@@ -217,7 +353,7 @@ int main(int argc, char** argv) {
         cfg.min_data_size = app.configuration()["min-data-size"].as<size_t>();
         cfg.max_data_size = app.configuration()["max-data-size"].as<size_t>();
         cfg.min_flush_delay_in_ms = app.configuration()["min-flush-delay-in-ms"].as<uint64_t>();
-        cfg.max_flush_delay_in_ms = app.configuration()["min-flush-delay-in-ms"].as<uint64_t>();
+        cfg.max_flush_delay_in_ms = app.configuration()["max-flush-delay-in-ms"].as<uint64_t>();
 
         if (cfg.min_data_size > cfg.max_data_size) {
             cfg.max_data_size = cfg.min_data_size;
@@ -226,52 +362,14 @@ int main(int argc, char** argv) {
             cfg.max_flush_delay_in_ms = cfg.min_flush_delay_in_ms;
         }
 
-        db::commitlog::config cl_cfg = db::commitlog::config::from_db_config(*db_cfg, current_scheduling_group(), memory::stats().total_memory());
-        tmpdir tmp;
-        cl_cfg.commit_log_location = tmp.path().string();
-
-        distributed<commitlog_service> test_commitlog;
-
-        //logging::logger_registry().set_logger_level("commitlog", logging::log_level::debug);
-
-        co_await test_commitlog.start(cfg);
-        co_await test_commitlog.invoke_on_all(std::mem_fn(&commitlog_service::init), cl_cfg);
-        std::exception_ptr ex;
-
-        try {
-            if (cfg.max_data_size > test_commitlog.local().log->max_record_size()) {
-                throw std::invalid_argument(sstring("Too large max data size: ") + std::to_string(cfg.max_data_size));
-            }
-            // test "framework" expects seastar thread
-            auto results = co_await seastar::async([&] {
-                return do_commitlog_test(test_commitlog, cfg);
-            });
-
-            auto compare_throughput = [] (perf_result a, perf_result b) { return a.throughput < b.throughput; };
-            std::sort(results.begin(), results.end(), compare_throughput);
-            auto median_result = results[results.size() / 2];
-            auto median = median_result.throughput;
-            auto min = results[0].throughput;
-            auto max = results[results.size() - 1].throughput;
-            auto absolute_deviations = boost::copy_range<std::vector<double>>(
-                    results
-                    | boost::adaptors::transformed(std::mem_fn(&perf_result::throughput))
-                    | boost::adaptors::transformed([&] (double r) { return abs(r - median); }));
-            std::sort(absolute_deviations.begin(), absolute_deviations.end());
-            auto mad = absolute_deviations[results.size() / 2];
-            std::cout << format("\nmedian {}\nmedian absolute deviation: {:.2f}\nmaximum: {:.2f}\nminimum: {:.2f}\n", median_result, mad, max, min);
-
-            if (app.configuration().contains("json-result")) {
-                write_json_result(app.configuration()["json-result"].as<std::string>(), cfg, median_result, mad, max, min);
-            }
-        } catch (...) {
-            ex = std::current_exception();
+        Json::Value results(Json::arrayValue);
+        for (auto& wl : make_workloads(app.configuration(), *db_cfg)) {
+            cfg.wl = wl;
+            results.append(co_await run_workload(*db_cfg, cfg));
         }
 
-        co_await test_commitlog.stop();
-
-        if (ex) {
-            std::rethrow_exception(ex);
+        if (app.configuration().contains("json-result")) {
+            write_json_result(app.configuration()["json-result"].as<std::string>(), results);
         }
     });
 }
@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/thread_cputime_clock.hh>
+#include <seastar/util/closeable.hh>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <random>
+
+// hack: sstable_utils.hh falsely depends on Boost.Test, but we can't include it with
+// with statically linked boost
+#define BOOST_REQUIRE(x) (void)(x)
+#define BOOST_CHECK_NO_THROW(x) (void)(x)
+
+#include "compaction/compaction_manager.hh"
+#include "compaction/time_window_compaction_strategy.hh"
+#include "replica/memtable.hh"
+#include "schema/schema_builder.hh"
+#include "compress.hh"
+#include "utils/logalloc.hh"
+
+#include "test/perf/perf.hh"
+#include "test/lib/log.hh"
+#include "test/lib/sstable_test_env.hh"
+#include "test/lib/sstable_utils.hh"
+#include "test/lib/test_services.hh"
+
+using namespace sstables;
+
+static const double MiB = 1 << 20;
+
+namespace {
+
+// One point of the scenario matrix.
+struct scenario {
+    compaction_strategy_type strategy;
+    double overlap;
+    double tombstone_ratio;
+    sstring compression;
+    unsigned rows_per_partition;
+};
+
+struct config {
+    unsigned sstables;
+    unsigned partitions;
+    unsigned value_size;
+    unsigned lcs_sstable_size_in_mb;
+    unsigned iterations;
+    uint64_t seed;
+};
+
+struct result {
+    uint64_t input_bytes = 0;
+    uint64_t input_ondisk_bytes = 0;
+    uint64_t output_bytes = 0;
+    uint64_t output_sstables = 0;
+    double duration = 0;
+    double cpu_time = 0;
+    uint64_t allocations = 0;
+    uint64_t instructions = 0;
+
+    result& operator+=(const result& o) {
+        input_bytes += o.input_bytes;
+        input_ondisk_bytes += o.input_ondisk_bytes;
+        output_bytes += o.output_bytes;
+        output_sstables += o.output_sstables;
+        duration += o.duration;
+        cpu_time += o.cpu_time;
+        allocations += o.allocations;
+        instructions += o.instructions;
+        return *this;
+    }
+};
+
+}
+
+static compaction_strategy_type parse_strategy(const sstring& name) {
+    if (name == "stcs") {
+        return compaction_strategy_type::size_tiered;
+    } else if (name == "lcs") {
+        return compaction_strategy_type::leveled;
+    } else if (name == "twcs") {
+        return compaction_strategy_type::time_window;
+    }
+    return compaction_strategy::type(name);
+}
+
+template <typename T>
+static std::vector<T> parse_list(const sstring& value, std::function<T(const sstring&)> parse) {
+    std::vector<sstring> items;
+    boost::split(items, value, boost::is_any_of(","));
+    std::vector<T> ret;
+    for (auto& item : items) {
+        if (!item.empty()) {
+            ret.push_back(parse(item));
+        }
+    }
+    if (ret.empty()) {
+        throw std::invalid_argument(format("empty list: '{}'", value));
+    }
+    return ret;
+}
+
+static schema_ptr make_schema(const scenario& sc, const config& cfg) {
+    std::map<sstring, sstring> strategy_options;
+    switch (sc.strategy) {
+    case compaction_strategy_type::leveled:
+        strategy_options.emplace("sstable_size_in_mb", to_sstring(cfg.lcs_sstable_size_in_mb));
+        break;
+    case compaction_strategy_type::time_window:
+        // Every input sstable is written into its own one hour window, see make_input().
+        strategy_options.emplace(time_window_compaction_strategy_options::COMPACTION_WINDOW_UNIT_KEY, "HOURS");
+        strategy_options.emplace(time_window_compaction_strategy_options::COMPACTION_WINDOW_SIZE_KEY, "1");
+        break;
+    default:
+        break;
+    }
+    auto cp = sc.compression == "none"
+            ? compression_parameters::no_compression()
+            : compression_parameters({{compression_parameters::SSTABLE_COMPRESSION, sc.compression}});
+    return schema_builder("perf", "compaction")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("ck", int32_type, column_kind::clustering_key)
+            .with_column("v", bytes_type)
+            .set_compaction_strategy(sc.strategy)
+            .set_compaction_strategy_options(std::move(strategy_options))
+            .set_compressor_params(cp)
+            .build();
+}
+
+// Writes the input sstables of the scenario. Each sstable has cfg.partitions
+// partitions, the first `overlap` part of them are shared by all sstables, the
+// rest is unique to the sstable. A `tombstone_ratio` part of the rows are
+// row tombstones, instead of live rows.
+static std::vector<shared_sstable> make_input(table_for_tests& table, const scenario& sc, const config& cfg) {
+    auto s = table.schema();
+    std::mt19937_64 rng(cfg.seed);
+    std::bernoulli_distribution is_tombstone(sc.tombstone_ratio);
+
+    // Values are drawn from a small alphabet, so that compression has
+    // something to work with.
+    std::vector<bytes> values(1024);
+    std::uniform_int_distribution<int> letter('a', 'p');
+    for (auto& v : values) {
+        v = bytes(bytes::initialized_later{}, cfg.value_size);
+        std::generate(v.begin(), v.end(), [&] { return letter(rng); });
+    }
+    std::uniform_int_distribution<size_t> value_idx(0, values.size() - 1);
+
+    const unsigned shared = cfg.partitions * sc.overlap;
+    const unsigned unique = cfg.partitions - shared;
+    const auto v_name = to_bytes("v");
+    const auto now = gc_clock::now();
+    const api::timestamp_type window = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::hours(1)).count();
+    const api::timestamp_type base_ts = api::new_timestamp() - cfg.sstables * window;
+
+    std::vector<shared_sstable> ssts;
+    for (unsigned i = 0; i < cfg.sstables; ++i) {
+        auto ts = sc.strategy == compaction_strategy_type::time_window ? base_ts + i * window : base_ts + i;
+        auto mt = make_lw_shared<replica::memtable>(s);
+        for (unsigned p = 0; p < cfg.partitions; ++p) {
+            int32_t key = p < shared ? p : shared + i * unique + (p - shared);
+            mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(key)));
+            for (unsigned r = 0; r < sc.rows_per_partition; ++r) {
+                auto ck = clustering_key::from_single_value(*s, int32_type->decompose(int32_t(r)));
+                if (is_tombstone(rng)) {
+                    m.partition().apply_delete(*s, ck, tombstone(ts, now));
+                } else {
+                    m.set_clustered_cell(ck, v_name, data_value(values[value_idx(rng)]), ts);
+                }
+            }
+            mt->apply(std::move(m));
+        }
+        ssts.push_back(make_sstable_containing(table.make_sstable(), std::move(mt)));
+    }
+    return ssts;
+}
+
+static result compact(table_for_tests& table, const std::vector<shared_sstable>& input, const config& cfg) {
+    auto& table_s = table.as_table_state();
+    auto descriptor = compaction_descriptor(input);
+    if (table.schema()->compaction_strategy() == compaction_strategy_type::leveled) {
+        descriptor = compaction_descriptor(input, 1, uint64_t(cfg.lcs_sstable_size_in_mb) << 20);
+    }
+
+    result res;
+    for (auto& sst : input) {
+        res.input_bytes += sst->data_size();
+        res.input_ondisk_bytes += sst->ondisk_data_size();
+    }
+
+    linux_perf_event instructions_retired = linux_perf_event::user_instructions_retired();
+    auto mallocs_before = perf_mallocs();
+    auto cpu_before = thread_cputime_clock::now();
+    auto start = std::chrono::steady_clock::now();
+    instructions_retired.enable();
+
+    auto ret = compact_sstables(table.get_compaction_manager(), std::move(descriptor), table_s, table.make_sst_factory()).get();
+
+    instructions_retired.disable();
+    res.duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    res.cpu_time = std::chrono::duration<double>(thread_cputime_clock::now() - cpu_before).count();
+    res.allocations = perf_mallocs() - mallocs_before;
+    res.instructions = instructions_retired.read();
+
+    res.output_sstables = ret.new_sstables.size();
+    for (auto& sst : ret.new_sstables) {
+        res.output_bytes += sst->data_size();
+        sst->unlink().get();
+    }
+    return res;
+}
+
+static void run_scenario(test_env& env, const scenario& sc, const config& cfg) {
+    auto table = env.make_table_for_tests(make_schema(sc, cfg));
+    auto close_table = deferred_stop(table);
+
+    auto input = make_input(table, sc, cfg);
+
+    result total;
+    for (unsigned i = 0; i < cfg.iterations; ++i) {
+        total += compact(table, input, cfg);
+    }
+    for (auto& sst : input) {
+        sst->unlink().get();
+    }
+
+    auto input_mb = total.input_bytes / MiB;
+    fmt::print("{:<6} overlap={:<4.2f} tombstones={:<4.2f} compression={:<18} rows={:<6} | "
+               "in {:8.2f} MiB ({:8.2f} MiB on disk) out {:8.2f} MiB in {:3} sstables | "
+               "{:8.2f} MiB/s {:8.2f} cpu-ms/MiB {:10.0f} allocs/MiB {:12.0f} insns/MiB\n",
+            compaction_strategy::name(sc.strategy), sc.overlap, sc.tombstone_ratio, sc.compression, sc.rows_per_partition,
+            input_mb / cfg.iterations, total.input_ondisk_bytes / MiB / cfg.iterations,
+            total.output_bytes / MiB / cfg.iterations, total.output_sstables / cfg.iterations,
+            input_mb / total.duration, total.cpu_time * 1000 / input_mb,
+            total.allocations / input_mb, total.instructions / input_mb);
+}
+
+namespace perf {
+
+int scylla_compaction_main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+            ("strategies", bpo::value<sstring>()->default_value("stcs,lcs,twcs"), "Comma separated list of compaction strategies which shape the input, "
+                "either stcs, lcs, twcs, or the full name of a strategy")
+            ("overlaps", bpo::value<sstring>()->default_value("0,0.5,1"), "Comma separated list of the ratios of partitions which are present in all input sstables")
+            ("tombstone-ratios", bpo::value<sstring>()->default_value("0,0.2"), "Comma separated list of the ratios of rows which are deleted")
+            ("compressions", bpo::value<sstring>()->default_value("none,LZ4Compressor"), "Comma separated list of sstable compressors, or none")
+            ("rows-per-partition", bpo::value<sstring>()->default_value("1,100"), "Comma separated list of partition widths, in rows")
+            ("sstables", bpo::value<unsigned>()->default_value(4), "Number of input sstables")
+            ("partitions", bpo::value<unsigned>()->default_value(1000), "Number of partitions per input sstable")
+            ("value-size", bpo::value<unsigned>()->default_value(100), "Size of the value of a row, in bytes")
+            ("lcs-sstable-size-in-mb", bpo::value<unsigned>()->default_value(160), "Size of the output sstables of leveled compaction")
+            ("iterations", bpo::value<unsigned>()->default_value(3), "Number of times the input of a scenario is compacted")
+            ("random-seed", bpo::value<uint64_t>()->default_value(0), "Seed of the generator of the input")
+            ("verbose", "Enables standard logging")
+            ;
+    return app.run(argc, argv, [&] {
+        return seastar::async([&] {
+            auto& opts = app.configuration();
+            if (!opts.contains("verbose")) {
+                auto testlog_level = logging::logger_registry().get_logger_level("testlog");
+                logging::logger_registry().set_all_loggers_level(seastar::log_level::warn);
+                logging::logger_registry().set_logger_level("testlog", testlog_level);
+            }
+
+            auto to_double = [] (const sstring& v) { return std::stod(v); };
+            auto strategies = parse_list<compaction_strategy_type>(opts["strategies"].as<sstring>(), parse_strategy);
+            auto overlaps = parse_list<double>(opts["overlaps"].as<sstring>(), to_double);
+            auto tombstone_ratios = parse_list<double>(opts["tombstone-ratios"].as<sstring>(), to_double);
+            auto compressions = parse_list<sstring>(opts["compressions"].as<sstring>(), [] (const sstring& v) { return v; });
+            auto widths = parse_list<unsigned>(opts["rows-per-partition"].as<sstring>(), [] (const sstring& v) { return unsigned(std::stoul(v)); });
+
+            config cfg{
+                .sstables = opts["sstables"].as<unsigned>(),
+                .partitions = opts["partitions"].as<unsigned>(),
+                .value_size = opts["value-size"].as<unsigned>(),
+                .lcs_sstable_size_in_mb = opts["lcs-sstable-size-in-mb"].as<unsigned>(),
+                .iterations = std::max(opts["iterations"].as<unsigned>(), 1u),
+                .seed = opts["random-seed"].as<uint64_t>(),
+            };
+
+            logalloc::prime_segment_pool(memory::stats().total_memory(), memory::min_free_memory()).get();
+            test_env::do_with_async([&] (test_env& env) {
+                for (auto strategy : strategies) {
+                    for (auto overlap : overlaps) {
+                        for (auto tombstone_ratio : tombstone_ratios) {
+                            for (auto& compression : compressions) {
+                                for (auto width : widths) {
+                                    run_scenario(env, scenario{strategy, overlap, tombstone_ratio, compression, width}, cfg);
+                                }
+                            }
+                        }
+                    }
+                }
+            }).get();
+        });
+    });
+}
+
+} // namespace perf
@@ -13,6 +13,8 @@
 
 #include "mutation/frozen_mutation.hh"
 #include "mutation/mutation_partition_view.hh"
+#include "idl/uuid.dist.hh"
+#include "idl/uuid.dist.impl.hh"
 
 namespace tests {
 
@@ -57,4 +59,41 @@ PERF_TEST_F(frozen_mutation, apply_one_small_row)
     perf_tests::do_not_optimize(m);
 }
 
+// Vectors of small fixed-size items, as sent in repair and tablet messages.
+class uuid_vector {
+    std::vector<utils::UUID> _uuids;
+    bytes_ostream _serialized;
+public:
+    uuid_vector() {
+        _uuids.reserve(10000);
+        for (int i = 0; i < 10000; ++i) {
+            _uuids.push_back(utils::make_random_uuid());
+        }
+        ser::serialize(_serialized, _uuids);
+    }
+    const std::vector<utils::UUID>& uuids() const { return _uuids; }
+    const bytes_ostream& serialized() const { return _serialized; }
+};
+
+PERF_TEST_F(uuid_vector, serialize)
+{
+    bytes_ostream out;
+    ser::serialize(out, uuids());
+    perf_tests::do_not_optimize(out);
+}
+
+PERF_TEST_F(uuid_vector, deserialize)
+{
+    auto in = ser::as_input_stream(serialized());
+    auto v = ser::deserialize(in, boost::type<std::vector<utils::UUID>>());
+    perf_tests::do_not_optimize(v);
+}
+
+PERF_TEST_F(uuid_vector, skip)
+{
+    auto in = ser::as_input_stream(serialized());
+    ser::skip(in, boost::type<std::vector<utils::UUID>>());
+    perf_tests::do_not_optimize(in);
+}
+
 }
@@ -9,6 +9,8 @@
 
 #include "replica/database.hh"
 #include "schema/schema_builder.hh"
+#include "mutation/frozen_mutation.hh"
+#include "utils/logalloc.hh"
 #include "test/perf/perf.hh"
 #include <seastar/core/app-template.hh>
 #include <seastar/core/reactor.hh>
@@ -49,6 +51,30 @@ int main(int argc, char* argv[]) {
             m.set_clustered_cell(c_key, col, make_atomic_cell(col.type, value));
             mt.apply(std::move(m));
         });
+
+        std::cout << "Timing frozen mutation of all columns within one row...\n";
+
+        mutation m(s, key);
+        for (auto& cname : cnames) {
+            const column_definition& col = *s->get_column_definition(to_bytes(cname));
+            m.set_clustered_cell(c_key, col, make_atomic_cell(col.type, value));
+        }
+        auto fm = freeze(m);
+
+        time_it([&] {
+            mt.apply(fm, s);
+        });
+
+        // The memtable write path allocates both from the standard allocator and from LSA
+        const int iterations = 100000;
+        auto mallocs_before = perf_mallocs();
+        auto lsa_before = logalloc::shard_tracker().statistics();
+        for (int i = 0; i < iterations; i++) {
+            mt.apply(fm, s);
+        }
+        auto lsa_allocated = (logalloc::shard_tracker().statistics() - lsa_before).memory_allocated;
+        std::cout << format("{:.2f} allocs/op, {:.2f} LSA bytes allocated/op\n",
+                double(perf_mallocs() - mallocs_before) / iterations, double(lsa_allocated) / iterations);
         engine().exit(0);
     });
 }
@@ -0,0 +1,528 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/core/thread_cputime_clock.hh>
+#include <seastar/testing/test_runner.hh>
+#include <random>
+
+#include "repair/hash.hh"
+#include "repair/reader.hh"
+#include "repair/repair.hh"
+#include "repair/row.hh"
+#include "repair/row_level.hh"
+#include "repair/writer.hh"
+#include "replica/database.hh"
+#include "service/storage_proxy.hh"
+#include "streaming/stream_reason.hh"
+#include "gms/feature_service.hh"
+#include "test/lib/cql_test_env.hh"
+#include "test/perf/perf.hh"
+
+namespace {
+
+// The two "nodes" of the benchmark are two tables of the same schema in a
+// single node; node_a plays the repair master and node_b the follower.
+const sstring ks_name = "ks";
+const sstring master_table = "node_a";
+const sstring follower_table = "node_b";
+
+struct test_config {
+    enum class run_mode { repair, stream };
+
+    run_mode mode;
+    unsigned partitions;
+    unsigned rows_per_partition;
+    unsigned value_size;
+    double divergence;
+    std::chrono::microseconds latency;
+    uint64_t bandwidth; // bytes per second of the whole link, 0 for unlimited
+    size_t row_buf_size;
+    uint64_t seed;
+};
+
+std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
+    switch (m) {
+        case test_config::run_mode::repair: return os << "repair";
+        case test_config::run_mode::stream: return os << "stream";
+    }
+    abort();
+}
+
+std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
+    return os << "{mode=" << cfg.mode
+           << ", partitions=" << cfg.partitions
+           << ", rows_per_partition=" << cfg.rows_per_partition
+           << ", value_size=" << cfg.value_size
+           << ", divergence=" << cfg.divergence
+           << ", latency_us=" << cfg.latency.count()
+           << ", bandwidth=" << cfg.bandwidth
+           << ", row_buf_size=" << cfg.row_buf_size
+           << "}";
+}
+
+struct repair_stats {
+    uint64_t rounds = 0;
+    uint64_t identical_rounds = 0;
+    uint64_t rows_read = 0;
+    uint64_t rows_sent = 0;
+    uint64_t messages = 0;
+    uint64_t wire_bytes = 0;
+    uint64_t hashing_ns = 0;
+    uint64_t cpu_ns = 0;
+    uint64_t allocations = 0;
+    size_t max_row_buf_bytes = 0;
+
+    repair_stats& operator+=(const repair_stats& o) {
+        rounds += o.rounds;
+        identical_rounds += o.identical_rounds;
+        rows_read += o.rows_read;
+        rows_sent += o.rows_sent;
+        messages += o.messages;
+        wire_bytes += o.wire_bytes;
+        hashing_ns += o.hashing_ns;
+        cpu_ns += o.cpu_ns;
+        allocations += o.allocations;
+        max_row_buf_bytes = std::max(max_row_buf_bytes, o.max_row_buf_bytes);
+        return *this;
+    }
+};
+
+// The network between the nodes. Every message is delayed by the one-way
+// latency and by the time it takes to transmit it. Shards repair their own
+// token ranges independently, so each gets an equal share of the bandwidth.
+class simulated_link {
+    std::chrono::microseconds _latency;
+    double _bytes_per_us;
+    repair_stats& _stats;
+public:
+    simulated_link(const test_config& cfg, repair_stats& stats)
+        : _latency(cfg.latency)
+        , _bytes_per_us(double(cfg.bandwidth) / smp::count / 1e6)
+        , _stats(stats)
+    { }
+
+    // Must run inside a seastar thread
+    void send(size_t bytes) {
+        _stats.messages++;
+        _stats.wire_bytes += bytes;
+        auto delay = _latency;
+        if (_bytes_per_us) {
+            delay += std::chrono::microseconds(uint64_t(bytes / _bytes_per_us));
+        }
+        if (delay.count()) {
+            seastar::sleep(delay).get();
+        }
+    }
+
+    // Must run inside a seastar thread
+    void rpc(size_t request_bytes, size_t response_bytes) {
+        send(request_bytes);
+        send(response_bytes);
+    }
+};
+
+size_t wire_size(const repair_rows_on_wire& rows) {
+    size_t size = 0;
+    for (auto& p : rows) {
+        size += p.get_key().representation().size();
+        for (auto& fmf : p.get_mutation_fragments()) {
+            size += fmf.representation().size();
+        }
+    }
+    return size;
+}
+
+size_t wire_size(const repair_sync_boundary& b) {
+    return b.pk.key().representation().size() + (b.position.has_key() ? b.position.key().representation().size() : 0);
+}
+
+repair_hash combined_hash(const std::list<repair_row>& rows) {
+    repair_hash h;
+    for (auto& r : rows) {
+        h.add(r.hash());
+    }
+    return h;
+}
+
+repair_hash_set row_hashes(const std::list<repair_row>& rows) {
+    repair_hash_set hashes;
+    for (auto& r : rows) {
+        hashes.insert(r.hash());
+    }
+    return hashes;
+}
+
+// One side of the repair: reads the rows of the table on this shard into a
+// row buffer, the way repair_meta does, and applies the rows it receives
+// through a repair_writer.
+class repair_node {
+    replica::table& _table;
+    schema_ptr _schema;
+    reader_permit _permit;
+    uint64_t _seed;
+    bool _hash_rows;
+    repair_hasher _hasher;
+    repair_reader _reader;
+    lw_shared_ptr<repair_writer> _writer;
+    std::list<repair_row> _row_buf;
+    size_t _row_buf_size = 0;
+    bool _end_of_stream = false;
+    repair_stats& _stats;
+
+    std::optional<repair_row> read_row() {
+        while (!_end_of_stream) {
+            mutation_fragment_opt mfopt = _reader.read_mutation_fragment().get();
+            if (!mfopt) {
+                _reader.on_end_of_stream().get();
+                _end_of_stream = true;
+                break;
+            }
+            auto& mf = *mfopt;
+            if (mf.is_partition_start()) {
+                auto& start = mf.as_partition_start();
+                _reader.set_current_dk(start.key());
+                if (!start.partition_tombstone()) {
+                    continue;
+                }
+            } else if (mf.is_end_of_partition()) {
+                _reader.clear_current_dk();
+                continue;
+            }
+            auto fmf = freeze(*_schema, mf);
+            std::optional<repair_hash> hash;
+            if (_hash_rows) {
+                auto start = thread_cputime_clock::now();
+                hash = _hasher.do_hash_for_mf(*_reader.get_current_dk(), mf, fmf);
+                _stats.hashing_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(thread_cputime_clock::now() - start).count();
+            }
+            _stats.rows_read++;
+            return repair_row(std::move(fmf), position_in_partition(mf.position()), _reader.get_current_dk(), std::move(hash), is_dirty_on_master::no);
+        }
+        return std::nullopt;
+    }
+public:
+    repair_node(cql_test_env& env, const sstring& cf_name, const test_config& cfg, streaming::stream_reason reason, repair_stats& stats)
+        : _table(env.local_db().find_column_family(ks_name, cf_name))
+        , _schema(_table.schema())
+        , _permit(make_reader_permit(env))
+        , _seed(cfg.seed)
+        , _hash_rows(cfg.mode == test_config::run_mode::repair)
+        , _hasher(_seed, _schema, env.local_db().features().repair_serialized_row_hash)
+        , _reader(env.db(), _table, _schema, _permit, dht::token_range::make_open_ended_both_sides(),
+                _schema->get_sharder(), this_shard_id(), _seed, repair_reader::read_strategy::local, gc_clock::now())
+        , _writer(make_repair_writer(_schema, _permit, reason, env.db(), env.get_system_distributed_keyspace(), env.get_view_update_generator()))
+        , _stats(stats)
+    { }
+
+    future<> stop() {
+        co_await _writer->wait_for_writer_done();
+        co_await _reader.close();
+    }
+
+    const schema_ptr& schema() const {
+        return _schema;
+    }
+
+    size_t row_buf_size() const {
+        return _row_buf_size;
+    }
+
+    // Reads rows until the row buffer holds at least max_size bytes or the
+    // table is exhausted, and proposes the last row of the buffer as the
+    // boundary of the round, like repair_meta::get_sync_boundary().
+    // Must run inside a seastar thread
+    get_sync_boundary_response fill_row_buf(size_t max_size) {
+        uint64_t new_rows_nr = 0;
+        while (_row_buf_size < max_size) {
+            auto r = read_row();
+            if (!r) {
+                break;
+            }
+            _row_buf_size += r->size();
+            _row_buf.push_back(std::move(*r));
+            new_rows_nr++;
+        }
+        _reader.pause();
+        // Streaming rows are not hashed.
+        auto hash = _hash_rows ? combined_hash(_row_buf) : repair_hash();
+        get_sync_boundary_response res{std::nullopt, hash, _row_buf_size, 0, new_rows_nr};
+        if (!_row_buf.empty()) {
+            res.boundary = _row_buf.back().boundary();
+        }
+        return res;
+    }
+
+    // Must run inside a seastar thread
+    std::list<repair_row> take_working_rows(const repair_sync_boundary& boundary) {
+        auto rows = take_rows_up_to_boundary(*_schema, _row_buf, boundary).get();
+        for (auto& r : rows) {
+            _row_buf_size -= r.size();
+        }
+        return rows;
+    }
+
+    // Applies the rows received from the other node, like repair_meta does
+    // on the master (flush_rows) or on a follower (do_apply_rows).
+    // Must run inside a seastar thread
+    void apply_rows(repair_rows_on_wire rows, repair_master is_master) {
+        if (rows.empty()) {
+            return;
+        }
+        auto row_list = to_repair_rows_list(std::move(rows), _schema, _seed, is_master, _permit, _hasher).get();
+        if (is_master) {
+            flush_rows(_schema, row_list, _writer);
+            return;
+        }
+        _writer->create_writer();
+        for (auto& r : row_list) {
+            _writer->do_write(r.get_dk_with_hash(), std::move(r.get_mutation_fragment())).get();
+        }
+    }
+};
+
+// Repairs (or streams) the token ranges of this shard from node_a to
+// node_b, round by round, following the verbs of row-level repair:
+// get_sync_boundary, get_combined_row_hash, get_full_row_hashes,
+// get_row_diff and put_row_diff. The decisions of a round are made by the
+// same functions repair_meta uses; only the transport is simulated.
+// Must run inside a seastar thread
+repair_stats repair_shard(cql_test_env& env, const test_config& cfg) {
+    repair_stats stats;
+    auto reason = cfg.mode == test_config::run_mode::repair ? streaming::stream_reason::repair : streaming::stream_reason::bootstrap;
+    simulated_link link(cfg, stats);
+    repair_node master(env, master_table, cfg, reason, stats);
+    repair_node follower(env, follower_table, cfg, reason, stats);
+    auto stop_nodes = defer([&] {
+        master.stop().get();
+        follower.stop().get();
+    });
+    const auto& s = *master.schema();
+    auto start_cpu = perf_cpu_time_ns();
+    auto start_allocations = perf_mallocs();
+
+    if (cfg.mode == test_config::run_mode::stream) {
+        // The follower has no data, so the master sends all of it.
+        while (auto boundary = master.fill_row_buf(cfg.row_buf_size).boundary) {
+            stats.rounds++;
+            auto rows = master.take_working_rows(*boundary);
+            stats.max_row_buf_bytes = std::max(stats.max_row_buf_bytes, master.row_buf_size());
+            stats.rows_sent += rows.size();
+            auto wire = to_repair_rows_on_wire(s, std::move(rows)).get();
+            link.rpc(wire_size(wire), 0);
+            follower.apply_rows(std::move(wire), repair_master::no);
+        }
+    }
+
+    while (cfg.mode == test_config::run_mode::repair) {
+        // get_sync_boundary
+        std::vector<repair_sync_boundary> sync_boundaries;
+        std::vector<repair_hash> combined_hashes;
+        bool zero_rows = false;
+        for (auto* node : {&master, &follower}) {
+            auto res = node->fill_row_buf(cfg.row_buf_size);
+            if (node == &follower) {
+                link.rpc(sizeof(uint64_t), (res.boundary ? wire_size(*res.boundary) : 0) + sizeof(repair_hash));
+            }
+            if (res.boundary && res.row_buf_size > 0) {
+                sync_boundaries.push_back(*res.boundary);
+                combined_hashes.push_back(res.row_buf_combined_csum);
+            } else {
+                zero_rows = true;
+            }
+        }
+        if (sync_boundaries.empty()) {
+            break;
+        }
+        auto [boundary, already_synced] = get_common_sync_boundary(s, zero_rows, sync_boundaries, combined_hashes);
+        stats.rounds++;
+        stats.max_row_buf_bytes = std::max(stats.max_row_buf_bytes, master.row_buf_size() + follower.row_buf_size());
+        auto master_rows = master.take_working_rows(*boundary);
+        auto follower_rows = follower.take_working_rows(*boundary);
+        if (already_synced) {
+            stats.identical_rounds++;
+            continue;
+        }
+
+        // get_combined_row_hash
+        link.rpc(wire_size(*boundary), sizeof(repair_hash));
+        if (combined_hash(master_rows) == combined_hash(follower_rows)) {
+            stats.identical_rounds++;
+            continue;
+        }
+
+        // get_full_row_hashes
+        auto master_hashes = row_hashes(master_rows);
+        auto follower_hashes = row_hashes(follower_rows);
+        link.rpc(0, follower_hashes.size() * sizeof(repair_hash));
+
+        // get_row_diff: the master asks for the rows it does not have.
+        auto missing_on_master = get_set_diff(follower_hashes, master_hashes);
+        if (!missing_on_master.empty()) {
+            auto rows = copy_rows_within_set_diff(follower_rows, missing_on_master).get();
+            stats.rows_sent += rows.size();
+            auto wire = to_repair_rows_on_wire(s, std::move(rows)).get();
+            link.rpc(missing_on_master.size() * sizeof(repair_hash), wire_size(wire));
+            master.apply_rows(std::move(wire), repair_master::yes);
+        }
+
+        // put_row_diff: the master sends the rows the follower does not have.
+        auto missing_on_follower = get_set_diff(master_hashes, follower_hashes);
+        if (!missing_on_follower.empty()) {
+            auto rows = copy_rows_within_set_diff(master_rows, missing_on_follower).get();
+            stats.rows_sent += rows.size();
+            auto wire = to_repair_rows_on_wire(s, std::move(rows)).get();
+            link.rpc(wire_size(wire), 0);
+            follower.apply_rows(std::move(wire), repair_master::no);
+        }
+    }
+
+    stats.cpu_ns = perf_cpu_time_ns() - start_cpu;
+    stats.allocations = perf_mallocs() - start_allocations;
+    return stats;
+}
+
+void create_tables(cql_test_env& env) {
+    for (auto& cf_name : {master_table, follower_table}) {
+        env.execute_cql(format("CREATE TABLE {}.{} (pk bigint, ck int, v blob, PRIMARY KEY (pk, ck))", ks_name, cf_name)).get();
+    }
+}
+
+// Writes the same rows to both nodes, except for a fraction of them, given
+// by the divergence, which are missing on one of the nodes or differ in
+// their value. In stream mode the follower is left empty.
+void populate(cql_test_env& env, const test_config& cfg) {
+    std::cout << "Populating " << cfg.partitions << " partitions of " << cfg.rows_per_partition << " rows..." << std::endl;
+    auto s_a = env.local_db().find_schema(ks_name, master_table);
+    auto s_b = env.local_db().find_schema(ks_name, follower_table);
+    std::mt19937_64 rng(cfg.seed);
+    std::uniform_real_distribution<double> diverge(0, 1);
+    std::uniform_int_distribution<int> kind(0, 2);
+    auto make_value = [&] {
+        bytes v(bytes::initialized_later(), cfg.value_size);
+        std::generate(v.begin(), v.end(), [&] { return int8_t(rng()); });
+        return data_value(std::move(v));
+    };
+    const api::timestamp_type ts = 1;
+    const unsigned batch_size = 100;
+    std::vector<mutation> muts;
+    for (unsigned pk = 0; pk < cfg.partitions; ++pk) {
+        mutation m_a(s_a, partition_key::from_single_value(*s_a, long_type->decompose(int64_t(pk))));
+        mutation m_b(s_b, partition_key::from_single_value(*s_b, long_type->decompose(int64_t(pk))));
+        for (unsigned ck = 0; ck < cfg.rows_per_partition; ++ck) {
+            auto ckey = clustering_key::from_single_value(*s_a, int32_type->decompose(int32_t(ck)));
+            auto value = make_value();
+            if (cfg.mode == test_config::run_mode::stream) {
+                m_a.set_clustered_cell(ckey, "v", value, ts);
+                continue;
+            }
+            if (diverge(rng) >= cfg.divergence) {
+                m_a.set_clustered_cell(ckey, "v", value, ts);
+                m_b.set_clustered_cell(ckey, "v", value, ts);
+                continue;
+            }
+            switch (kind(rng)) {
+            case 0:
+                m_a.set_clustered_cell(ckey, "v", value, ts);
+                break;
+            case 1:
+                m_b.set_clustered_cell(ckey, "v", value, ts);
+                break;
+            default:
+                m_a.set_clustered_cell(ckey, "v", value, ts);
+                m_b.set_clustered_cell(ckey, "v", make_value(), ts + 1);
+                break;
+            }
+        }
+        if (!m_a.partition().empty()) {
+            muts.push_back(std::move(m_a));
+        }
+        if (!m_b.partition().empty()) {
+            muts.push_back(std::move(m_b));
+        }
+        if (muts.size() >= batch_size || pk + 1 == cfg.partitions) {
+            env.get_storage_proxy().local().mutate_locally(std::exchange(muts, {}), tracing::trace_state_ptr()).get();
+        }
+    }
+    env.db().invoke_on_all(&replica::database::flush_all_memtables).get();
+}
+
+} // anonymous namespace
+
+namespace perf {
+
+int scylla_repair_main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("mode", bpo::value<std::string>()->default_value("repair"), "repair, to repair diverged nodes, or stream, to send all rows to an empty node")
+        ("partitions", bpo::value<unsigned>()->default_value(10000), "number of partitions")
+        ("rows-per-partition", bpo::value<unsigned>()->default_value(10), "number of rows per partition")
+        ("value-size", bpo::value<unsigned>()->default_value(100), "size of the value of a row, in bytes")
+        ("divergence", bpo::value<double>()->default_value(0.01), "ratio of rows which differ between the nodes")
+        ("latency-us", bpo::value<unsigned>()->default_value(100), "one-way latency of the simulated network, in microseconds")
+        ("bandwidth-mbps", bpo::value<unsigned>()->default_value(0), "bandwidth of the simulated network, in megabits per second, 0 for unlimited")
+        ("row-buf-size", bpo::value<unsigned>()->default_value(256 * 1024), "size of the row buffer of a repair round, in bytes")
+        ("random-seed", bpo::value<uint64_t>(), "random number generator seed")
+        ;
+
+    set_abort_on_internal_error(true);
+
+    return app.run(argc, argv, [&app] {
+        auto& opts = app.configuration();
+        auto seed = opts.contains("random-seed") ? opts["random-seed"].as<uint64_t>() : std::random_device()();
+        std::cout << "random-seed=" << seed << '\n';
+        return do_with_cql_env_thread([&opts, seed] (cql_test_env& env) {
+            test_config cfg;
+            auto mode = opts["mode"].as<std::string>();
+            if (mode == "repair") {
+                cfg.mode = test_config::run_mode::repair;
+            } else if (mode == "stream") {
+                cfg.mode = test_config::run_mode::stream;
+            } else {
+                throw std::invalid_argument(format("unsupported mode: {}", mode));
+            }
+            cfg.partitions = std::max(opts["partitions"].as<unsigned>(), 1u);
+            cfg.rows_per_partition = std::max(opts["rows-per-partition"].as<unsigned>(), 1u);
+            cfg.value_size = opts["value-size"].as<unsigned>();
+            cfg.divergence = std::clamp(opts["divergence"].as<double>(), 0.0, 1.0);
+            cfg.latency = std::chrono::microseconds(opts["latency-us"].as<unsigned>());
+            cfg.bandwidth = uint64_t(opts["bandwidth-mbps"].as<unsigned>()) * 1000 * 1000 / 8;
+            cfg.row_buf_size = std::max(opts["row-buf-size"].as<unsigned>(), 1u);
+            cfg.seed = seed;
+            std::cout << "Running test with config: " << cfg << std::endl;
+
+            create_tables(env);
+            populate(env, cfg);
+
+            auto start = std::chrono::steady_clock::now();
+            auto stats = env.db().map_reduce0([&env, &cfg] (replica::database&) {
+                return seastar::async([&env, &cfg] {
+                    return repair_shard(env, cfg);
+                });
+            }, repair_stats(), [] (repair_stats a, const repair_stats& b) { return a += b; }).get();
+            auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::cout << format("\n{:.0f} rows/s ({} rows read in {:.3f} s)\n", stats.rows_read / elapsed, stats.rows_read, elapsed);
+            std::cout << format("rounds: {} ({} identical)\n", stats.rounds, stats.identical_rounds);
+            std::cout << format("rows sent: {}\n", stats.rows_sent);
+            std::cout << format("on the wire: {} bytes in {} messages ({:.1f} bytes/row read)\n",
+                    stats.wire_bytes, stats.messages, double(stats.wire_bytes) / std::max(stats.rows_read, uint64_t(1)));
+            std::cout << format("hashing: {:.3f} ms cpu ({:.1f} ns/row, {:.1f}% of the cpu time)\n",
+                    stats.hashing_ns / 1e6, double(stats.hashing_ns) / std::max(stats.rows_read, uint64_t(1)),
+                    100.0 * stats.hashing_ns / std::max(stats.cpu_ns, uint64_t(1)));
+            std::cout << format("cpu: {:.1f} us/row\n", stats.cpu_ns / 1e3 / std::max(stats.rows_read, uint64_t(1)));
+            std::cout << format("memory: {:.1f} allocs/row, {} bytes peak row buffer per shard\n",
+                    double(stats.allocations) / std::max(stats.rows_read, uint64_t(1)), stats.max_row_buf_bytes);
+        });
+    });
+}
+
+} // namespace perf
@@ -18,18 +18,28 @@
 
 seastar::logger plog("perf");
 
+struct upload_options {
+    std::optional<unsigned> max_connections;
+    std::optional<unsigned> parts_in_flight;
+};
+
 class tester {
     std::chrono::seconds _duration;
     unsigned _parallel;
+    bool _upload;
     std::string _object_name;
     size_t _object_size;
     semaphore _mem;
     shared_ptr<s3::client> _client;
     utils::estimated_histogram _reads_hist;
+    utils::estimated_histogram _uploads_hist;
+    uint64_t _uploaded_bytes = 0;
     unsigned _errors = 0;
 
-    static s3::endpoint_config_ptr make_config() {
+    static s3::endpoint_config_ptr make_config(upload_options uopts) {
         s3::endpoint_config cfg;
+        cfg.max_connections = uopts.max_connections;
+        cfg.upload_parts_in_flight = uopts.parts_in_flight;
         cfg.port = 443;
         cfg.use_https = true;
         cfg.aws.emplace();
@@ -48,19 +58,25 @@ class tester {
     std::chrono::steady_clock::time_point now() const { return std::chrono::steady_clock::now(); }
 
 public:
-    tester(std::chrono::seconds dur, unsigned prl, size_t obj_size)
+    tester(std::chrono::seconds dur, unsigned prl, bool upload, size_t obj_size, upload_options uopts)
             : _duration(dur)
             , _parallel(prl)
+            , _upload(upload)
             , _object_name(fmt::format("/{}/perfobject-{}-{}", tests::getenv_safe("S3_BUCKET_FOR_TEST"), ::getpid(), this_shard_id()))
             , _object_size(obj_size)
             , _mem(memory::stats().total_memory())
-            , _client(s3::client::make(tests::getenv_safe("S3_SERVER_ADDRESS_FOR_TEST"), make_config(), _mem))
+            , _client(s3::client::make(tests::getenv_safe("S3_SERVER_ADDRESS_FOR_TEST"), make_config(uopts), _mem))
     {}
 
     future<> start() {
-        plog.debug("Creating {} of {} bytes", _object_name, _object_size);
+        co_await upload_object(_object_name);
+    }
+
+private:
+    future<> upload_object(std::string object_name) {
+        plog.debug("Creating {} of {} bytes", object_name, _object_size);
 
-        auto out = output_stream<char>(_client->make_upload_sink(_object_name));
+        auto out = output_stream<char>(_client->make_upload_sink(object_name));
         std::exception_ptr ex;
         try {
             auto rnd = tests::random::get_bytes(chunk_size);
@@ -80,7 +96,21 @@ class tester {
         }
     }
 
-private:
+    future<> do_run_uploads(unsigned fnr) {
+        auto until = now() + _duration;
+        auto object_name = fmt::format("{}-upload-{}", _object_name, fnr);
+        do {
+            auto start = now();
+            try {
+                co_await upload_object(object_name);
+                _uploaded_bytes += _object_size;
+                _uploads_hist.add(std::chrono::duration_cast<std::chrono::milliseconds>(now() - start).count());
+            } catch (...) {
+                _errors++;
+            }
+        } while (now() < until);
+        co_await _client->delete_object(object_name);
+    }
 
     future<> do_run() {
         auto until = now() + _duration;
@@ -102,7 +132,11 @@ class tester {
         co_await coroutine::parallel_for_each(boost::irange(0u, _parallel), [this] (auto fnr) -> future<> {
             plog.debug("Running {} fiber", fnr);
             co_await seastar::sleep(std::chrono::milliseconds(fnr)); // make some discrepancy
-            co_await do_run();
+            if (_upload) {
+                co_await do_run_uploads(fnr);
+            } else {
+                co_await do_run();
+            }
         });
     }
 
@@ -121,7 +155,12 @@ class tester {
                 hist.percentile(1.0)
             );
         };
-        plog.info("reads total: {:5}, errors: {:5}; latencies: {}", _reads_hist._count, _errors, print_percentiles(_reads_hist));
+        if (_upload) {
+            plog.info("uploads total: {:5}, errors: {:5}; throughput: {:.1f} MB/s; latencies: {}", _uploads_hist._count, _errors,
+                    double(_uploaded_bytes) / (1 << 20) / _duration.count(), print_percentiles(_uploads_hist));
+        } else {
+            plog.info("reads total: {:5}, errors: {:5}; latencies: {}", _reads_hist._count, _errors, print_percentiles(_reads_hist));
+        }
     }
 };
 
@@ -132,15 +171,26 @@ int main(int argc, char** argv) {
         ("duration", bpo::value<unsigned>()->default_value(10), "seconds to run")
         ("parallel", bpo::value<unsigned>()->default_value(1), "number of parallel fibers")
         ("object_size", bpo::value<size_t>()->default_value(1 << 20), "size of test object")
+        ("upload", "measure uploads of object_size objects instead of reads")
+        ("max_connections", bpo::value<unsigned>(), "maximum number of connections to the endpoint")
+        ("upload_parts_in_flight", bpo::value<unsigned>(), "maximum number of parts each upload sends at once")
     ;
 
     return app.run(argc, argv, [&app] () -> future<> {
         auto dur = std::chrono::seconds(app.configuration()["duration"].as<unsigned>());
         auto prl = app.configuration()["parallel"].as<unsigned>();
         auto osz = app.configuration()["object_size"].as<size_t>();
+        auto upload = app.configuration().contains("upload");
+        upload_options uopts;
+        if (app.configuration().contains("max_connections")) {
+            uopts.max_connections = app.configuration()["max_connections"].as<unsigned>();
+        }
+        if (app.configuration().contains("upload_parts_in_flight")) {
+            uopts.parts_in_flight = app.configuration()["upload_parts_in_flight"].as<unsigned>();
+        }
         sharded<tester> test;
         plog.info("Creating");
-        co_await test.start(dur, prl, osz);
+        co_await test.start(dur, prl, upload, osz, uopts);
         plog.info("Starting");
         co_await test.invoke_on_all(&tester::start);
         try {
@@ -11,17 +11,21 @@
 #include <json/json.h>
 
 #include <boost/range/irange.hpp>
+#include <atomic>
+#include <cmath>
+#include <numeric>
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/alternator_test_env.hh"
 #include "test/perf/perf.hh"
 #include <seastar/core/app-template.hh>
 #include <seastar/testing/test_runner.hh>
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/sleep.hh>
 #include "test/lib/random_utils.hh"
 
 #include "db/config.hh"
 #include "schema/schema_builder.hh"
-#include "release.hh"
-#include <fstream>
 #include "service/storage_proxy.hh"
 #include "cql3/query_processor.hh"
 #include "db/config.hh"
@@ -38,6 +42,46 @@ static bytes make_key(uint64_t sequence) {
     return b;
 };
 
+// Draws ranks from [0, n) following the zipfian distribution with the given
+// skew, rank 0 being the most popular. Uses the algorithm of Gray et al.,
+// "Quickly Generating Billion-Record Synthetic Databases", like YCSB does.
+class zipfian_distribution {
+    uint64_t _n;
+    double _theta;
+    double _alpha;
+    double _zetan;
+    double _eta;
+
+    static double zeta(uint64_t n, double theta) {
+        double sum = 0;
+        for (uint64_t i = 1; i <= n; ++i) {
+            sum += 1 / std::pow(double(i), theta);
+        }
+        return sum;
+    }
+public:
+    explicit zipfian_distribution(uint64_t n, double theta = 0.99)
+            : _n(n)
+            , _theta(theta)
+            , _alpha(1 / (1 - theta))
+            , _zetan(zeta(n, theta))
+            , _eta((1 - std::pow(2.0 / n, 1 - theta)) / (1 - zeta(2, theta) / _zetan)) {
+    }
+
+    template <typename RandomEngine>
+    uint64_t operator()(RandomEngine& engine) const {
+        auto u = std::uniform_real_distribution<double>(0, 1)(engine);
+        auto uz = u * _zetan;
+        if (uz < 1) {
+            return 0;
+        }
+        if (uz < 1 + std::pow(0.5, _theta)) {
+            return std::min<uint64_t>(1, _n - 1);
+        }
+        return std::min<uint64_t>(_n * std::pow(_eta * u - _eta + 1, _alpha), _n - 1);
+    }
+};
+
 static void execute_update_for_key(cql_test_env& env, const bytes& key) {
     env.execute_cql(fmt::format("UPDATE cf SET "
         "\"C0\" = 0x8f75da6b3dcec90c8a404fb9a5f6b0621e62d39c69ba5758e5f41b78311fbb26cc7a,"
@@ -59,8 +103,11 @@ static void execute_counter_update_for_key(cql_test_env& env, const bytes& key)
 };
 
 struct test_config {
-    enum class run_mode { read, write, del };
+    enum class run_mode { read, write, del, mixed };
     enum class frontend_type { cql, alternator };
+    enum class key_distribution { uniform, zipfian, latest };
+    // Operations of the mixed workload, the index of their weight in mix.
+    enum class mixed_op { read, write, scan, count };
 
     run_mode mode;
     frontend_type frontend;
@@ -74,6 +121,18 @@ struct test_config {
     bool stop_on_error;
     sstring timeout;
     bool bypass_cache;
+    key_distribution distribution = key_distribution::uniform;
+    // Ranks of the keys for the zipfian and latest distributions.
+    std::optional<zipfian_distribution> zipf;
+    // One past the highest key written so far, for the latest distribution.
+    std::atomic<uint64_t> latest_sequence = 0;
+    // Mixed workload
+    std::array<unsigned, size_t(mixed_op::count)> mix = {};
+    unsigned tables = 1;
+    unsigned rows_per_partition = 1;
+    unsigned scan_limit = 100;
+    unsigned flush_period_ms = 0;
+    unsigned compaction_period_ms = 0;
 };
 
 std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
@@ -81,6 +140,26 @@ std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
         case test_config::run_mode::write: return os << "write";
         case test_config::run_mode::read: return os << "read";
         case test_config::run_mode::del: return os << "delete";
+        case test_config::run_mode::mixed: return os << "mixed";
+    }
+    abort();
+}
+
+std::ostream& operator<<(std::ostream& os, const test_config::key_distribution& d) {
+    switch (d) {
+        case test_config::key_distribution::uniform: return os << "uniform";
+        case test_config::key_distribution::zipfian: return os << "zipfian";
+        case test_config::key_distribution::latest: return os << "latest";
+    }
+    abort();
+}
+
+static std::string_view to_string(test_config::mixed_op op) {
+    switch (op) {
+        case test_config::mixed_op::read: return "read";
+        case test_config::mixed_op::write: return "write";
+        case test_config::mixed_op::scan: return "scan";
+        case test_config::mixed_op::count: break;
     }
     abort();
 }
@@ -100,7 +179,18 @@ std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
            << ", frontend=" << cfg.frontend
            << ", query_single_key=" << (cfg.query_single_key ? "yes" : "no")
            << ", counters=" << (cfg.counters ? "yes" : "no")
-           << "}";
+           << ", key_distribution=" << cfg.distribution;
+    if (cfg.mode == test_config::run_mode::mixed) {
+        os << ", mix=read:" << cfg.mix[size_t(test_config::mixed_op::read)]
+           << "/write:" << cfg.mix[size_t(test_config::mixed_op::write)]
+           << "/scan:" << cfg.mix[size_t(test_config::mixed_op::scan)]
+           << ", tables=" << cfg.tables
+           << ", rows_per_partition=" << cfg.rows_per_partition
+           << ", scan_limit=" << cfg.scan_limit
+           << ", flush_period_ms=" << cfg.flush_period_ms
+           << ", compaction_period_ms=" << cfg.compaction_period_ms;
+    }
+    return os << "}";
 }
 
 static void create_partitions(cql_test_env& env, test_config& cfg) {
@@ -120,7 +210,30 @@ static void create_partitions(cql_test_env& env, test_config& cfg) {
 }
 
 static int64_t make_random_seq(test_config& cfg) {
-    return cfg.query_single_key ? 0 : tests::random::get_int<uint64_t>(cfg.partitions - 1);
+    if (cfg.query_single_key) {
+        return 0;
+    }
+    switch (cfg.distribution) {
+    case test_config::key_distribution::uniform:
+        return tests::random::get_int<uint64_t>(cfg.partitions - 1);
+    case test_config::key_distribution::zipfian:
+        return (*cfg.zipf)(tests::random::gen());
+    case test_config::key_distribution::latest: {
+        auto latest = cfg.latest_sequence.load(std::memory_order_relaxed);
+        auto rank = (*cfg.zipf)(tests::random::gen());
+        return latest > rank ? latest - 1 - rank : 0;
+    }
+    }
+    abort();
+}
+
+// With the latest distribution, writes insert new keys, which reads then
+// prefer. Otherwise, writes overwrite keys chosen like reads do.
+static int64_t make_write_seq(test_config& cfg) {
+    if (cfg.distribution == test_config::key_distribution::latest && !cfg.query_single_key) {
+        return cfg.latest_sequence.fetch_add(1, std::memory_order_relaxed);
+    }
+    return make_random_seq(cfg);
 }
 
 static bytes make_random_key(test_config& cfg) {
@@ -157,7 +270,7 @@ static std::vector<perf_result> test_write(cql_test_env& env, test_config& cfg)
             "WHERE \"KEY\" = ?", usings);
     auto id = env.prepare(query).get0();
     return time_parallel([&env, &cfg, id] {
-            bytes key = make_random_key(cfg);
+            bytes key = make_key(make_write_seq(cfg));
             return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
         }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
 }
@@ -190,7 +303,7 @@ static std::vector<perf_result> test_counter_update(cql_test_env& env, test_conf
             "WHERE \"KEY\" = ?", usings);
     auto id = env.prepare(query).get0();
     return time_parallel([&env, &cfg, id] {
-            bytes key = make_random_key(cfg);
+            bytes key = make_key(make_write_seq(cfg));
             return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
         }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
 }
@@ -206,6 +319,168 @@ static schema_ptr make_counter_schema(std::string_view ks_name) {
             .build();
 }
 
+static schema_ptr make_regular_schema(std::string_view ks_name, std::string_view cf_name) {
+    return schema_builder(ks_name, cf_name)
+            .with_column("KEY", bytes_type, column_kind::partition_key)
+            .with_column("C0", bytes_type)
+            .with_column("C1", bytes_type)
+            .with_column("C2", bytes_type)
+            .with_column("C3", bytes_type)
+            .with_column("C4", bytes_type)
+            .build();
+}
+
+static schema_ptr make_clustered_schema(std::string_view ks_name, std::string_view cf_name) {
+    return schema_builder(ks_name, cf_name)
+            .with_column("KEY", bytes_type, column_kind::partition_key)
+            .with_column("CK", int32_type, column_kind::clustering_key)
+            .with_column("V", bytes_type)
+            .build();
+}
+
+// A table of the mixed workload. Tables alternate between the regular
+// schema, with one row per partition, and a clustered schema, with
+// rows_per_partition rows per partition.
+struct mixed_table {
+    sstring name;
+    bool clustered;
+    // Indexed by test_config::mixed_op
+    std::vector<cql3::prepared_cache_key_type> statements;
+};
+
+using op_latency_histogram = utils::approx_exponential_histogram<4, 33554432, 4>;
+
+static mixed_table create_mixed_table(cql_test_env& env, test_config& cfg, unsigned idx) {
+    mixed_table t{format("mixed_{}", idx), bool(idx % 2), {}};
+    env.create_table([&t] (std::string_view ks_name) {
+        return t.clustered ? *make_clustered_schema(ks_name, t.name) : *make_regular_schema(ks_name, t.name);
+    }).get();
+
+    if (t.clustered) {
+        t.statements.push_back(env.prepare(format("SELECT \"V\" FROM {} WHERE \"KEY\" = ? AND \"CK\" = ?", t.name)).get0());
+        t.statements.push_back(env.prepare(format("UPDATE {} SET "
+                "\"V\" = 0x8f75da6b3dcec90c8a404fb9a5f6b0621e62d39c69ba5758e5f41b78311fbb26cc7a "
+                "WHERE \"KEY\" = ? AND \"CK\" = ?", t.name)).get0());
+        t.statements.push_back(env.prepare(format("SELECT \"CK\", \"V\" FROM {} WHERE token(\"KEY\") > token(?) LIMIT {}",
+                t.name, cfg.scan_limit)).get0());
+    } else {
+        t.statements.push_back(env.prepare(format("SELECT \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" FROM {} WHERE \"KEY\" = ?", t.name)).get0());
+        t.statements.push_back(env.prepare(format("UPDATE {} SET "
+                "\"C0\" = 0x8f75da6b3dcec90c8a404fb9a5f6b0621e62d39c69ba5758e5f41b78311fbb26cc7a,"
+                "\"C1\" = 0xa8761a2127160003033a8f4f3d1069b7833ebe24ef56b3beee728c2b686ca516fa51,"
+                "\"C2\" = 0x583449ce81bfebc2e1a695eb59aad5fcc74d6d7311fc6197b10693e1a161ca2e1c64,"
+                "\"C3\" = 0x62bcb1dbc0ff953abc703bcb63ea954f437064c0c45366799658bd6b91d0f92908d7,"
+                "\"C4\" = 0x222fcbe31ffa1e689540e1499b87fa3f9c781065fccd10e4772b4c7039c2efd0fb27 "
+                "WHERE \"KEY\" = ?", t.name)).get0());
+        t.statements.push_back(env.prepare(format("SELECT \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" FROM {} WHERE token(\"KEY\") > token(?) LIMIT {}",
+                t.name, cfg.scan_limit)).get0());
+    }
+
+    std::cout << "Creating " << cfg.partitions << " partitions in " << t.name << "..." << std::endl;
+    auto& write = t.statements[size_t(test_config::mixed_op::write)];
+    max_concurrent_for_each(boost::irange(0u, cfg.partitions), 100, [&] (unsigned sequence) -> future<> {
+        if (!t.clustered) {
+            return env.execute_prepared(write, {{cql3::raw_value::make_value(make_key(sequence))}}).discard_result();
+        }
+        return do_for_each(boost::irange(0u, cfg.rows_per_partition), [&env, &write, sequence] (unsigned ck) {
+            return env.execute_prepared(write, {{
+                    cql3::raw_value::make_value(make_key(sequence)),
+                    cql3::raw_value::make_value(int32_type->decompose(int32_t(ck)))}}).discard_result();
+        });
+    }).get();
+    return t;
+}
+
+static test_config::mixed_op pick_mixed_op(const test_config& cfg) {
+    auto total = std::accumulate(cfg.mix.begin(), cfg.mix.end(), 0u);
+    auto r = tests::random::get_int<unsigned>(total - 1);
+    for (size_t op = 0; op < cfg.mix.size(); ++op) {
+        if (r < cfg.mix[op]) {
+            return test_config::mixed_op(op);
+        }
+        r -= cfg.mix[op];
+    }
+    abort();
+}
+
+// Runs func every period_ms, until aborted. Does nothing if period_ms is 0.
+static future<> run_periodically(unsigned period_ms, abort_source& as, noncopyable_function<future<>()> func) {
+    if (!period_ms) {
+        co_return;
+    }
+    while (!as.abort_requested()) {
+        try {
+            co_await sleep_abortable(std::chrono::milliseconds(period_ms), as);
+        } catch (const sleep_aborted&) {
+            co_return;
+        }
+        co_await func();
+    }
+}
+
+// Runs a mix of reads, writes and scans against several tables, with keys
+// following cfg.distribution, while memtables are flushed and tables are
+// compacted in the background. Interference between these is invisible in
+// the single operation modes.
+static std::vector<perf_result> test_mixed(cql_test_env& env, test_config& cfg) {
+    std::vector<mixed_table> tables;
+    for (unsigned i = 0; i < cfg.tables; ++i) {
+        tables.push_back(create_mixed_table(env, cfg, i));
+    }
+    if (cfg.flush_memtables) {
+        std::cout << "Flushing partitions..." << std::endl;
+        env.db().invoke_on_all(&replica::database::flush_all_memtables).get();
+    }
+
+    abort_source as;
+    auto flusher = run_periodically(cfg.flush_period_ms, as, [&env] {
+        return env.db().invoke_on_all(&replica::database::flush_all_memtables);
+    });
+    auto compactor = run_periodically(cfg.compaction_period_ms, as, [&env, &tables] {
+        return env.db().invoke_on_all([&tables] (replica::database& db) {
+            return parallel_for_each(tables, [&db] (const mixed_table& t) {
+                return db.find_column_family("ks", t.name).compact_all_sstables();
+            });
+        });
+    });
+    auto stop_background = defer([&] {
+        as.request_abort();
+        when_all_succeed(std::move(flusher), std::move(compactor)).discard_result().get();
+    });
+
+    std::vector<std::array<op_latency_histogram, size_t(test_config::mixed_op::count)>> latencies(smp::count);
+    auto results = time_parallel([&env, &cfg, &tables, &latencies] {
+            auto op = pick_mixed_op(cfg);
+            auto& t = tables[tests::random::get_int<size_t>(tables.size() - 1)];
+            auto sequence = op == test_config::mixed_op::write ? make_write_seq(cfg) : make_random_seq(cfg);
+            std::vector<cql3::raw_value> values;
+            values.push_back(cql3::raw_value::make_value(make_key(sequence)));
+            if (t.clustered && op != test_config::mixed_op::scan) {
+                auto ck = tests::random::get_int<int32_t>(cfg.rows_per_partition - 1);
+                values.push_back(cql3::raw_value::make_value(int32_type->decompose(ck)));
+            }
+            auto start = std::chrono::steady_clock::now();
+            return env.execute_prepared(t.statements[size_t(op)], std::move(values)).discard_result().then([&latencies, op, start] {
+                auto latency = std::chrono::steady_clock::now() - start;
+                latencies[this_shard_id()][size_t(op)].add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+            });
+        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard, cfg.stop_on_error);
+
+    std::cout << "\nlatencies [us]:\n";
+    for (size_t op = 0; op < size_t(test_config::mixed_op::count); ++op) {
+        op_latency_histogram hist;
+        for (auto& shard_latencies : latencies) {
+            hist.merge(shard_latencies[op]);
+        }
+        if (!hist.count()) {
+            continue;
+        }
+        std::cout << format("{:<6} count: {:<10} 50%: {:<8} 90%: {:<8} 99%: {:<8} 99.9%: {:<8} max: {}\n",
+                to_string(test_config::mixed_op(op)), hist.count(), hist.quantile(0.5), hist.quantile(0.9), hist.quantile(0.99), hist.quantile(0.999), hist.max());
+    }
+    return results;
+}
+
 static void create_alternator_table(service::client_state& state, alternator::executor& executor) {
     executor.create_table(state, tracing::trace_state_ptr(), empty_service_permit(), rjson::parse(
         R"(
@@ -340,7 +615,7 @@ static std::vector<perf_result> test_alternator_write(service::client_state& sta
                 "ReturnValues": "NONE"
             }
         )";
-        auto key = std::to_string(make_random_seq(cfg));
+        auto key = std::to_string(make_write_seq(cfg));
         // Chunked content is used to minimize string copying, and thus extra allocations
         rjson::chunked_content content;
         content.reserve(3);
@@ -400,6 +675,8 @@ static std::vector<perf_result> do_alternator_test(std::string isolation_level,
             return test_alternator_write(state, executor, cfg);
         case test_config::run_mode::del:
             return test_alternator_delete(state, std::move(flush_memtables), executor, cfg);
+        case test_config::run_mode::mixed:
+            throw std::invalid_argument("the mixed workload is not supported by the alternator frontend");
         };
     } catch (const alternator::api_error& e) {
         std::cout << "Alternator API error: " << e._msg << std::endl;
@@ -412,18 +689,14 @@ static std::vector<perf_result> do_cql_test(cql_test_env& env, test_config& cfg)
     assert(cfg.frontend == test_config::frontend_type::cql);
 
     std::cout << "Running test with config: " << cfg << std::endl;
+    if (cfg.mode == test_config::run_mode::mixed) {
+        return test_mixed(env, cfg);
+    }
     env.create_table([&cfg] (auto ks_name) {
         if (cfg.counters) {
             return *make_counter_schema(ks_name);
         }
-        return *schema_builder(ks_name, "cf")
-                .with_column("KEY", bytes_type, column_kind::partition_key)
-                .with_column("C0", bytes_type)
-                .with_column("C1", bytes_type)
-                .with_column("C2", bytes_type)
-                .with_column("C3", bytes_type)
-                .with_column("C4", bytes_type)
-                .build();
+        return *make_regular_schema(ks_name, table_name);
     }).get();
 
     switch (cfg.mode) {
@@ -437,66 +710,34 @@ static std::vector<perf_result> do_cql_test(cql_test_env& env, test_config& cfg)
         }
     case test_config::run_mode::del:
         return test_delete(env, cfg);
+    case test_config::run_mode::mixed:
+        break;
     };
     abort();
 }
 
 void write_json_result(std::string result_file, const test_config& cfg, perf_result median, double mad, double max, double min) {
-    Json::Value results;
-
-    Json::Value params;
-    params["concurrency"] = cfg.concurrency;
-    params["partitions"] = cfg.partitions;
-    params["cpus"] = smp::count;
-    params["duration"] = cfg.duration_in_seconds;
-    params["concurrency,partitions,cpus,duration"] = fmt::format("{},{},{},{}", cfg.concurrency, cfg.partitions, smp::count, cfg.duration_in_seconds);
-    results["parameters"] = std::move(params);
-
-    Json::Value stats;
-    stats["median tps"] = median.throughput;
-    stats["allocs_per_op"] = median.mallocs_per_op;
-    stats["tasks_per_op"] = median.tasks_per_op;
-    stats["instructions_per_op"] = median.instructions_per_op;
-    stats["mad tps"] = mad;
-    stats["max tps"] = max;
-    stats["min tps"] = min;
-    results["stats"] = std::move(stats);
-
     std::string test_type;
     switch (cfg.mode) {
     case test_config::run_mode::read: test_type = "read"; break;
     case test_config::run_mode::write: test_type = "write"; break;
     case test_config::run_mode::del: test_type = "delete"; break;
+    case test_config::run_mode::mixed: test_type = "mixed"; break;
     }
     if (cfg.counters) {
         test_type += "_counters";
     }
-    results["test_properties"]["type"] = test_type;
-
-    // <version>-<release>
-    auto version_components = std::vector<std::string>{};
-    auto sver = scylla_version();
-    boost::algorithm::split(version_components, sver, boost::is_any_of("-"));
-    // <scylla-build>.<date>.<git-hash>
-    auto release_components = std::vector<std::string>{};
-    boost::algorithm::split(release_components, version_components[1], boost::is_any_of("."));
-
-    Json::Value version;
-    version["commit_id"] = release_components[2];
-    version["date"] = release_components[1];
-    version["version"] = version_components[0];
+    auto results = make_json_result(test_type, median, mad, max, min);
 
-    // It'd be nice to have std::chrono::format(), wouldn't it?
-    auto current_time = std::time(nullptr);
-    char time_str[100];
-    ::tm time_buf;
-    std::strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", ::localtime_r(&current_time, &time_buf));
-    version["run_date_time"] = time_str;
-
-    results["versions"]["scylla-server"] = std::move(version);
+    Json::Value params;
+    params["concurrency"] = cfg.concurrency;
+    params["partitions"] = cfg.partitions;
+    params["cpus"] = smp::count;
+    params["duration"] = cfg.duration_in_seconds;
+    params["concurrency,partitions,cpus,duration"] = fmt::format("{},{},{},{}", cfg.concurrency, cfg.partitions, smp::count, cfg.duration_in_seconds);
+    results["parameters"] = std::move(params);
 
-    auto out = std::ofstream(result_file);
-    out << results;
+    write_json_result(result_file, results);
 }
 
 namespace perf {
@@ -521,6 +762,14 @@ int scylla_simple_query_main(int argc, char** argv) {
         ("stop-on-error", bpo::value<bool>()->default_value(true), "stop after encountering the first error")
         ("timeout", bpo::value<std::string>()->default_value(""), "use timeout")
         ("bypass-cache", "use bypass cache when querying")
+        ("key-distribution", bpo::value<std::string>()->default_value("uniform"), "distribution of the keys of operations: uniform, zipfian or latest (writes insert new keys, reads prefer recent ones)")
+        ("workload", bpo::value<std::string>(), "run a mix of operations against several tables instead of a single kind of operation, "
+            "given as weights of operations, e.g. read=70,write=20,scan=10")
+        ("tables", bpo::value<unsigned>()->default_value(2), "number of tables of the mixed workload, alternating between a regular and a clustered schema")
+        ("rows-per-partition", bpo::value<unsigned>()->default_value(10), "number of rows per partition of the clustered tables of the mixed workload")
+        ("scan-limit", bpo::value<unsigned>()->default_value(100), "number of rows read by a scan of the mixed workload")
+        ("flush-period-ms", bpo::value<unsigned>()->default_value(0), "flush memtables with this period during the mixed workload, 0 to disable")
+        ("compaction-period-ms", bpo::value<unsigned>()->default_value(0), "compact the tables with this period during the mixed workload, 0 to disable")
         ;
 
     set_abort_on_internal_error(true);
@@ -567,6 +816,48 @@ int scylla_simple_query_main(int argc, char** argv) {
             cfg.stop_on_error = app.configuration()["stop-on-error"].as<bool>();
             cfg.timeout = app.configuration()["timeout"].as<std::string>();
             cfg.bypass_cache = app.configuration().contains("bypass-cache");
+            auto distribution = app.configuration()["key-distribution"].as<std::string>();
+            if (distribution == "uniform") {
+                cfg.distribution = test_config::key_distribution::uniform;
+            } else if (distribution == "zipfian") {
+                cfg.distribution = test_config::key_distribution::zipfian;
+            } else if (distribution == "latest") {
+                cfg.distribution = test_config::key_distribution::latest;
+            } else {
+                throw std::invalid_argument(format("unknown key distribution: {}", distribution));
+            }
+            if (cfg.distribution != test_config::key_distribution::uniform) {
+                cfg.zipf.emplace(cfg.partitions);
+            }
+            cfg.latest_sequence = cfg.partitions;
+            if (app.configuration().contains("workload")) {
+                cfg.mode = test_config::run_mode::mixed;
+                std::vector<std::string> ops;
+                auto workload = app.configuration()["workload"].as<std::string>();
+                boost::algorithm::split(ops, workload, boost::is_any_of(","));
+                for (auto& op : ops) {
+                    std::vector<std::string> op_weight;
+                    boost::algorithm::split(op_weight, op, boost::is_any_of("="));
+                    std::optional<size_t> idx;
+                    for (size_t i = 0; i < cfg.mix.size(); ++i) {
+                        if (to_string(test_config::mixed_op(i)) == op_weight[0]) {
+                            idx = i;
+                        }
+                    }
+                    if (op_weight.size() != 2 || !idx) {
+                        throw std::invalid_argument(format("invalid workload: {}", workload));
+                    }
+                    cfg.mix[*idx] = std::stoul(op_weight[1]);
+                }
+                if (std::accumulate(cfg.mix.begin(), cfg.mix.end(), 0u) == 0) {
+                    throw std::invalid_argument(format("workload has no operations: {}", workload));
+                }
+                cfg.tables = std::max(app.configuration()["tables"].as<unsigned>(), 1u);
+                cfg.rows_per_partition = std::max(app.configuration()["rows-per-partition"].as<unsigned>(), 1u);
+                cfg.scan_limit = app.configuration()["scan-limit"].as<unsigned>();
+                cfg.flush_period_ms = app.configuration()["flush-period-ms"].as<unsigned>();
+                cfg.compaction_period_ms = app.configuration()["compaction-period-ms"].as<unsigned>();
+            }
             auto results = cfg.frontend == test_config::frontend_type::cql
                     ? do_cql_test(env, cfg)
                     : do_alternator_test(app.configuration()["alternator"].as<std::string>(),
@@ -96,6 +96,46 @@ static future<> test_basic_operations(app_template& app) {
         testlog.info("Size of tablet_metadata in memory: {} KiB",
                      (tm.external_memory_usage() + sizeof(tablet_metadata)) / 1024);
 
+        // Tablet lookup as done for every request by tablet_effective_replication_map.
+        {
+            const size_t nr_tokens = 1 << 20;
+            const int nr_passes = 10;
+            std::vector<dht::token> tokens;
+            tokens.reserve(nr_tokens);
+            for (size_t i = 0; i < nr_tokens; ++i) {
+                tokens.push_back(dht::token::get_random_token());
+                thread::maybe_yield();
+            }
+            auto& tmap = tm.get_tablet_map(ids[0]);
+            size_t nr_replicas = 0;
+            auto time_to_lookup = duration_in_seconds([&] {
+                for (int pass = 0; pass < nr_passes; ++pass) {
+                    aborted.check();
+                    for (auto& t : tokens) {
+                        auto tid = tmap.get_tablet_id(t);
+                        if (!tmap.get_tablet_transition_info(tid)) {
+                            nr_replicas += tmap.get_tablet_info(tid).replicas.size();
+                        }
+                    }
+                    thread::maybe_yield();
+                }
+            });
+            assert(nr_replicas == nr_tokens * nr_passes * rf);
+            testlog.info("Looked up {} tokens in {:.6f} [ms], {:.3f} [ns/lookup]", nr_tokens * nr_passes,
+                         time_to_lookup.count() * 1000, time_to_lookup.count() * 1e9 / (nr_tokens * nr_passes));
+        }
+
+        // Rebuilding a single table's tablet map, as done when its tablet metadata changes.
+        {
+            auto& tmap = tm.get_tablet_map(ids[0]);
+            std::optional<tablet_map> tmap2;
+            auto time_to_rebuild = duration_in_seconds([&] {
+                tmap2.emplace(tmap);
+            });
+            testlog.info("Copied a tablet map in {:.6f} [ms]", time_to_rebuild.count() * 1000);
+            tmap2->clear_gently().get();
+        }
+
         tablet_metadata tm2;
         auto time_to_copy = duration_in_seconds([&] {
             tm2 = tm;
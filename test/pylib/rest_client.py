@@ -245,6 +245,14 @@ class ScyllaRESTAPIClient():
             url += "?cf={table}"
         await self.client.post(url, host=node_ip)
 
+    async def repair(self, node_ip: str, keyspace: str) -> None:
+        """Repair the keyspace on the node and wait for the repair to finish"""
+        sequence_number = await self.client._fetch("POST", f"/storage_service/repair_async/{keyspace}",
+                                                   response_type = "json", host = node_ip)
+        status = await self.client.get_json("/storage_service/repair_status", host=node_ip,
+                                            params={"id": str(sequence_number)})
+        assert status == "SUCCESSFUL", f"repair of {keyspace} on {node_ip} finished with {status}"
+
     async def keyspace_compaction(self, node_ip: str, keyspace: str, table: Optional[str] = None) -> None:
         """Compact the specified or all tables in the keyspace"""
         url = f"/storage_service/keyspace_compaction/{keyspace}"
@@ -67,3 +67,31 @@ SEASTAR_THREAD_TEST_CASE(test_release_memory_if_add_entry_throws) {
     cluster.read(read_value{0, 1}).get();
 #endif
 }
+
+SEASTAR_THREAD_TEST_CASE(test_leader_commits_only_persisted_entries) {
+    raft_cluster<std::chrono::steady_clock> cluster(
+            test_case { .nodes = 2 },
+            ::apply_changes,
+            0,
+            0,
+            0, false, tick_delay, rpc_config{});
+    cluster.start_all().get0();
+    auto stop = defer([&cluster] {
+        delay_store_log_entries = raft::server_id{};
+        store_log_entries_sync.signal(store_log_entries_sync.waiters());
+        cluster.stop_all().get();
+    });
+    cluster.add_entries(1, 0).get0();
+
+    delay_store_log_entries = to_raft_id(0);
+    auto committed = cluster.add_entries(1, 0);
+    // The leader sends the entry out while storing it, so the follower
+    // acks it, but that is no quorum without the leader's own copy
+    cluster.wait_log(1).get();
+    seastar::sleep(tick_delay).get();
+    BOOST_REQUIRE(!committed.available());
+
+    delay_store_log_entries = raft::server_id{};
+    store_log_entries_sync.signal();
+    committed.get();
+}
@@ -17,6 +17,10 @@ raft::snapshot_id delay_apply_snapshot{utils::UUID(0, 0xdeadbeaf)};
 // sending of a snaphot with that id will be delayed until snapshot_sync is signaled
 raft::snapshot_id delay_send_snapshot{utils::UUID(0xdeadbeaf, 0)};
 
+seastar::semaphore store_log_entries_sync(0);
+// storing of log entries on the server with that id will be delayed until store_log_entries_sync is signaled
+raft::server_id delay_store_log_entries;
+
 std::vector<raft::server_id> to_raft_id_vec(std::vector<node_id> nodes) noexcept {
     std::vector<raft::server_id> ret;
     for (auto node: nodes) {
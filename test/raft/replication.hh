@@ -291,6 +291,10 @@ extern raft::snapshot_id delay_apply_snapshot;
 // sending of a snaphot with that id will be delayed until snapshot_sync is signaled
 extern raft::snapshot_id delay_send_snapshot;
 
+extern seastar::semaphore store_log_entries_sync;
+// storing of log entries on the server with that id will be delayed until store_log_entries_sync is signaled
+extern raft::server_id delay_store_log_entries;
+
 // Test connectivity configuration
 struct rpc_config {
     bool drops = false;
@@ -479,7 +483,12 @@ class raft_cluster<Clock>::persistence : public raft::persistence {
     future<raft::snapshot_descriptor> load_snapshot_descriptor() override {
         return make_ready_future<raft::snapshot_descriptor>(_conf.snapshot);
     }
-    future<> store_log_entries(const std::vector<raft::log_entry_ptr>& entries) override { return seastar::sleep(1us); };
+    future<> store_log_entries(const std::vector<raft::log_entry_ptr>& entries) override {
+        if (_id == delay_store_log_entries) {
+            co_await store_log_entries_sync.wait();
+        }
+        co_await seastar::sleep(1us);
+    }
     future<raft::log_entries> load_log() override {
         raft::log_entries log;
         for (auto&& e : _conf.log) {
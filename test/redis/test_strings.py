@@ -147,6 +147,83 @@ def test_exists_lots_of_keys(redis_host, redis_port):
         keys.append(k)
     assert r.exists(*keys) == len(keys)
 
+def test_exists_repeated_and_missing_keys(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key1 = random_string(10)
+    key2 = random_string(10)
+
+    r.set(key1, random_string(10))
+    r.delete(key2)
+    # Keys mentioned multiple times are counted multiple times.
+    assert r.exists(key1, key1, key2, key2) == 2
+    assert r.exists(key2, key2) == 0
+
+def test_mset_mget(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    entries = {random_string(10): random_string(10) for _ in range(30)}
+
+    assert r.mset(entries) == True
+    keys = list(entries.keys())
+    assert r.mget(keys) == [entries[k] for k in keys]
+    for k in keys:
+        assert r.get(k) == entries[k]
+
+def test_mget_missing_and_repeated_keys(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key1 = random_string(10)
+    val1 = random_string(10)
+    key2 = random_string(10)
+    val2 = random_string(10)
+    key3 = random_string(10)
+
+    r.set(key1, val1)
+    r.set(key2, val2)
+    r.delete(key3)
+    # Values are returned in the order of the keys, with None for missing keys.
+    assert r.mget(key3, key2, key1, key2) == [None, val2, val1, val2]
+    assert r.mget(key3) == [None]
+
+def test_mset_overwrites(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key1 = random_string(10)
+    key2 = random_string(10)
+    val = random_string(10)
+
+    r.set(key1, random_string(10))
+    assert r.mset({key1: val, key2: ""}) == True
+    assert r.mget(key1, key2) == [val, ""]
+
+def test_mset_removes_ttl(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+    val = random_string(10)
+
+    assert r.setex(key, 100, random_string(10)) == True
+    assert r.mset({key: val}) == True
+    assert r.get(key) == val
+    assert r.ttl(key) == -1
+
+def test_mset_wrong_number_of_arguments(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    key = random_string(10)
+
+    with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+        r.execute_command("MSET")
+    assert "wrong number of arguments for 'mset' command" in str(excinfo.value)
+    with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+        r.execute_command("MSET", key)
+    assert "wrong number of arguments for 'mset' command" in str(excinfo.value)
+    with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+        r.execute_command("MSET", key, random_string(10), random_string(10))
+    assert "wrong number of arguments for 'mset' command" in str(excinfo.value)
+    assert r.exists(key) == 0
+
+def test_mget_wrong_number_of_arguments(redis_host, redis_port):
+    r = connect(redis_host, redis_port)
+    with pytest.raises(redis.exceptions.ResponseError) as excinfo:
+        r.execute_command("MGET")
+    assert "wrong number of arguments for 'mget' command" in str(excinfo.value)
+
 def test_setex_ttl(redis_host, redis_port):
     r = connect(redis_host, redis_port)
     key = random_string(10)
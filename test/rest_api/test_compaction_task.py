@@ -1,10 +1,13 @@
 import sys
+import time
+from collections import defaultdict
+from contextlib import ExitStack
 
 # Use the util.py library from ../cql-pytest:
 sys.path.insert(1, sys.path[0] + '/../cql-pytest')
-from util import new_test_table, new_test_keyspace
-from rest_util import set_tmp_task_ttl
-from task_manager_utils import wait_for_task, list_tasks, check_child_parent_relationship, drain_module_tasks
+from util import new_test_table, new_test_keyspace, config_value_context
+from rest_util import set_tmp_task_ttl, scylla_inject_error, ThreadWrapper
+from task_manager_utils import wait_for_task, list_tasks, abort_task, get_task_status, check_child_parent_relationship, drain_module_tasks
 
 module_name = "compaction"
 long_time = 1000000000
@@ -59,6 +62,8 @@ def test_rewrite_sstables_keyspace_compaction_task(cql, this_dc, rest_api):
     check_compaction_task(cql, this_dc, rest_api, lambda keyspace, _: rest_api.send("GET", f"storage_service/keyspace_upgrade_sstables/{keyspace}"), "upgrade sstables compaction", task_tree_depth)
     # scrub sstables compaction
     check_compaction_task(cql, this_dc, rest_api, lambda keyspace, _: rest_api.send("GET", f"storage_service/keyspace_scrub/{keyspace}"), "scrub sstables compaction", task_tree_depth)
+    # recompress sstables compaction
+    check_compaction_task(cql, this_dc, rest_api, lambda keyspace, _: rest_api.send("POST", f"storage_service/keyspace_recompress_sstables/{keyspace}", {'io_budget_mb_per_sec': 100}), "recompress sstables compaction", task_tree_depth)
 
 def test_reshaping_compaction_task(cql, this_dc, rest_api):
     task_tree_depth = 2
@@ -88,3 +93,82 @@ def test_regular_compaction_task(cql, this_dc, rest_api):
                 failed = [status["task_id"] for status in statuses if status["state"] != "done"]
                 assert not failed, f"Regular compaction tasks with ids = {failed} failed"
     drain_module_tasks(rest_api, module_name)
+
+def create_tables(cql, keyspace, nr_tables, stack):
+    schema = 'p int, v text, primary key (p)'
+    for i in range(nr_tables):
+        t = stack.enter_context(new_test_table(cql, keyspace, schema))
+        cql.execute(f"INSERT INTO {t} (p, v) VALUES ({i}, 'hello')")
+
+# Returns the statuses of the table tasks of the keyspace major compaction, grouped by shard.
+def get_table_tasks_by_shard(rest_api, keyspace):
+    tasks = defaultdict(list)
+    for task in list_tasks(rest_api, module_name, internal=True, keyspace=keyspace):
+        if task["type"] == "major compaction" and task["scope"] == "table":
+            status = get_task_status(rest_api, task["task_id"])
+            tasks[status["shard"]].append(status)
+    return tasks
+
+def wait_for_top_level_task(rest_api, keyspace):
+    while True:
+        tasks = [task for task in list_tasks(rest_api, module_name, keyspace=keyspace) if task["type"] == "major compaction" and task["scope"] == "keyspace"]
+        if tasks:
+            return tasks[0]
+        time.sleep(0.1)
+
+def test_major_keyspace_compaction_tables_concurrency_and_abort(cql, this_dc, rest_api):
+    nr_tables = 5
+    concurrency = 2
+    drain_module_tasks(rest_api, module_name)
+    with set_tmp_task_ttl(rest_api, long_time), config_value_context(cql, 'compaction_tables_concurrency', str(concurrency)):
+        with new_test_keyspace(cql, f"WITH REPLICATION = {{ 'class' : 'NetworkTopologyStrategy', '{this_dc}' : 1 }}") as keyspace, ExitStack() as stack:
+            create_tables(cql, keyspace, nr_tables, stack)
+            # Tables which are admitted wait for the message, the others wait for their turn.
+            injection = "major_keyspace_compaction_table_task_wait"
+            with scylla_inject_error(rest_api, injection):
+                compaction = ThreadWrapper(target=lambda: rest_api.send("POST", f"storage_service/keyspace_compaction/{keyspace}"))
+                compaction.start()
+                top_level_task = wait_for_top_level_task(rest_api, keyspace)
+                nr_shards = len(get_task_status(rest_api, top_level_task["task_id"])["children_ids"])
+                while sum(len(tasks) for tasks in get_table_tasks_by_shard(rest_api, keyspace).values()) < nr_tables * nr_shards:
+                    time.sleep(0.1)
+                # Let the shards admit their tables.
+                time.sleep(1)
+
+                abort_task(rest_api, top_level_task["task_id"])
+                resp = rest_api.send("POST", f"v2/error_injection/injection/{injection}/message")
+                resp.raise_for_status()
+                resp = compaction.join()
+                assert not resp.ok
+
+            assert wait_for_task(rest_api, top_level_task["task_id"])["state"] == "failed"
+            # The admitted tables run to completion, the ones which waited for their turn are not started.
+            for shard, tasks in get_table_tasks_by_shard(rest_api, keyspace).items():
+                states = sorted(wait_for_task(rest_api, task["id"])["state"] for task in tasks)
+                assert states == ["done"] * concurrency + ["failed"] * (nr_tables - concurrency), f"unexpected table task states on shard {shard}"
+    drain_module_tasks(rest_api, module_name)
+
+def test_major_keyspace_compaction_table_task_failure(cql, this_dc, rest_api):
+    nr_tables = 5
+    concurrency = 2
+    drain_module_tasks(rest_api, module_name)
+    with set_tmp_task_ttl(rest_api, long_time), config_value_context(cql, 'compaction_tables_concurrency', str(concurrency)):
+        with new_test_keyspace(cql, f"WITH REPLICATION = {{ 'class' : 'NetworkTopologyStrategy', '{this_dc}' : 1 }}") as keyspace, ExitStack() as stack:
+            create_tables(cql, keyspace, nr_tables, stack)
+            # The first table admitted on each shard fails.
+            with scylla_inject_error(rest_api, "major_keyspace_compaction_table_task_fail", one_shot=True):
+                resp = rest_api.send("POST", f"storage_service/keyspace_compaction/{keyspace}")
+                assert not resp.ok
+
+            top_level_task = wait_for_top_level_task(rest_api, keyspace)
+            status = wait_for_task(rest_api, top_level_task["task_id"])
+            assert status["state"] == "failed"
+            assert "injected table task failure" in status["error"]
+            # The failure stops admitting tables, and all table tasks are finished
+            # by the time the keyspace task fails.
+            for shard, tasks in get_table_tasks_by_shard(rest_api, keyspace).items():
+                states = [task["state"] for task in tasks]
+                assert all(state in ("done", "failed") for state in states), f"unfinished table tasks on shard {shard}"
+                assert states.count("failed") >= nr_tables - concurrency + 1, f"too many tables started on shard {shard}"
+                assert any("injected table task failure" in task["error"] for task in tasks)
+    drain_module_tasks(rest_api, module_name)
@@ -0,0 +1,32 @@
+import sys
+
+# Use the util.py library from ../cql-pytest:
+sys.path.insert(1, sys.path[0] + '/../cql-pytest')
+from util import new_test_table, new_test_keyspace
+from rest_util import set_tmp_task_ttl
+from task_manager_utils import wait_for_task, list_tasks, list_modules, check_child_parent_relationship, drain_module_tasks
+
+module_name = "sstables_loader"
+long_time = 1000000000
+
+def test_sstables_loader_module(rest_api):
+    assert module_name in list_modules(rest_api), "sstables_loader module was not listed"
+
+def test_load_and_stream_task(cql, this_dc, rest_api):
+    drain_module_tasks(rest_api, module_name)
+    with set_tmp_task_ttl(rest_api, long_time):
+        with new_test_keyspace(cql, f"WITH REPLICATION = {{ 'class' : 'NetworkTopologyStrategy', '{this_dc}' : 1 }}") as keyspace:
+            with new_test_table(cql, keyspace, 'p int, v text, primary key (p)') as t0:
+                [_, table] = t0.split(".")
+                resp = rest_api.send("POST", f"storage_service/sstables/{keyspace}", {'cf': table, 'load_and_stream': 'true'})
+                resp.raise_for_status()
+
+                tasks = [task for task in list_tasks(rest_api, module_name, keyspace=keyspace, table=table) if task["type"] == "load_and_stream"]
+                assert len(tasks) == 1, "load_and_stream task was not created"
+
+                status = wait_for_task(rest_api, tasks[0]["task_id"])
+                assert status["state"] == "done", f"load_and_stream task failed: {status['error']}"
+                assert status["progress_units"] == "partitions"
+                # A child task streams the sstables found on each shard.
+                check_child_parent_relationship(rest_api, status, 1, False)
+    drain_module_tasks(rest_api, module_name)
@@ -0,0 +1,77 @@
+#
+# Copyright (C) 2026-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+import logging
+import time
+import pytest
+
+from cassandra.cluster import ConsistencyLevel # type: ignore
+from cassandra.query import SimpleStatement # type: ignore
+
+from test.pylib.manager_client import ManagerClient
+from test.pylib.util import wait_for_cql_and_get_hosts
+
+
+logger = logging.getLogger(__name__)
+
+
+async def set_min_rows(cql, host, min_rows: int):
+    await cql.run_async(f"update system.config set value = '{min_rows}' where name = 'columnar_query_result_min_rows'", host=host)
+
+
+async def scan(cql, host, query: str, page_size: int):
+    stmt = SimpleStatement(query, consistency_level=ConsistencyLevel.ONE, fetch_size=page_size)
+    return sorted((tuple(r) for r in await cql.run_async(stmt, host=host)), key=repr)
+
+
+def without_ttls(rows, ttl_column):
+    """Ttls decrease between scans, so only keep whether the cell has one"""
+    if ttl_column is None:
+        return rows
+    return [r[:ttl_column] + (r[ttl_column] is not None,) + r[ttl_column + 1:] for r in rows]
+
+
+@pytest.mark.asyncio
+async def test_columnar_query_result(manager: ManagerClient) -> None:
+    """Range scans return the same rows whether the replicas send the pages
+       in the columnar encoding or not"""
+    servers = [await manager.server_add(cmdline=['--smp', '2']) for _ in range(2)]
+    cql = manager.get_cql()
+    # With a single replica, the coordinator reads half of the ranges from the other node.
+    await cql.run_async("create keyspace ks with replication = {'class': 'SimpleStrategy', 'replication_factor': 1}")
+    await cql.run_async("create table ks.t (pk int, ck int, s text static, v1 text, v2 int, v3 blob, primary key (pk, ck))")
+    hosts = await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+
+    nr_partitions = 50
+    nr_rows = 40
+    for pk in range(nr_partitions):
+        if pk % 3:
+            await cql.run_async(f"insert into ks.t (pk, s) values ({pk}, 'static-{pk}')")
+        for ck in range(nr_rows):
+            # Repeated values, nulls and cells with a ttl.
+            v2 = "null" if ck % 4 == 0 else str(ck % 5)
+            await cql.run_async(f"insert into ks.t (pk, ck, v1, v2) values ({pk}, {ck}, '{'odd' if ck % 2 else 'even'}', {v2})"
+                                + (" using ttl 100000" if ck % 7 == 0 else ""))
+    # Large values, larger than a fragment.
+    for pk in range(5):
+        await cql.run_async(f"update ks.t set v3 = 0x{'%02x' % pk * (200 * 1024)} where pk = {pk} and ck = 0")
+
+    # Queries, with the column of the ttl in their results.
+    queries = [
+        ("select * from ks.t", None),
+        ("select pk, ck, v1, writetime(v1), ttl(v1) from ks.t", 4),
+        ("select pk, s, v2 from ks.t where v2 = 1 allow filtering", None),
+    ]
+    host = hosts[0]
+    for query, ttl_column in queries:
+        for page_size in [7, 1000, 5000]:
+            await set_min_rows(cql, host, 0)
+            expected = await scan(cql, host, query, page_size)
+            await set_min_rows(cql, host, 1)
+            result = await scan(cql, host, query, page_size)
+            logger.info(f"{query} with pages of {page_size} rows returned {len(result)} rows")
+            assert len(result) > 0
+            assert without_ttls(result, ttl_column) == without_ttls(expected, ttl_column)
@@ -0,0 +1,91 @@
+#
+# Copyright (C) 2026-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+import asyncio
+import logging
+import time
+import pytest
+
+from cassandra.cluster import ConsistencyLevel # type: ignore
+from cassandra.query import SimpleStatement # type: ignore
+
+from test.pylib.manager_client import ManagerClient
+from test.pylib.rest_client import inject_error_one_shot
+from test.pylib.util import wait_for, wait_for_cql_and_get_hosts
+from test.topology.conftest import skip_mode
+
+
+logger = logging.getLogger(__name__)
+
+
+async def last_state_id(cql, host):
+    stmt = SimpleStatement("select state_id from system.group0_history where key = 'history' limit 1",
+                           consistency_level=ConsistencyLevel.ONE)
+    rows = await cql.run_async(stmt, host=host)
+    return rows[0].state_id if rows else None
+
+
+async def wait_for_state_id(cql, host, state_id):
+    async def caught_up():
+        return True if await last_state_id(cql, host) == state_id else None
+    await wait_for(caught_up, time.time() + 60)
+
+
+async def columns(cql, host, table: str) -> set[str]:
+    stmt = SimpleStatement(f"select column_name from system_schema.columns where keyspace_name = 'ks' and table_name = '{table}'",
+                           consistency_level=ConsistencyLevel.ONE)
+    return {r.column_name for r in await cql.run_async(stmt, host=host)}
+
+
+@pytest.mark.asyncio
+@skip_mode('release', 'error injections are not supported in release mode')
+async def test_group0_snapshot_transfer_of_up_to_date_state(manager: ManagerClient) -> None:
+    """A node whose group 0 log fell behind the leader's snapshot gets only the group 0
+       history in the snapshot transfer if it already applied the leader's last state,
+       and the full state otherwise"""
+    cmdline = ['--logger-log-level', 'group0_raft_sm=trace']
+    servers = [await manager.server_add(cmdline=cmdline) for _ in range(3)]
+    cql = manager.get_cql()
+    await cql.run_async("create keyspace ks with replication = {'class': 'SimpleStrategy', 'replication_factor': 1}")
+    await cql.run_async("create table ks.t (pk int primary key)")
+    hosts = await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+    state_id = await last_state_id(cql, hosts[0])
+    await wait_for_state_id(cql, hosts[2], state_id)
+
+    # Snapshots are taken, and the log truncated, every few entries from now on.
+    await asyncio.gather(*[inject_error_one_shot(manager.api, s.ip_addr, 'raft_server_snapshot_reduce_threshold')
+                           for s in servers[:2]])
+
+    logger.info("Stopping %s", servers[2])
+    await manager.server_stop_gracefully(servers[2].server_id)
+    # Joining group 0 changes its configuration a few times, but not the group 0 state.
+    servers += [await manager.server_add(cmdline=cmdline) for _ in range(2)]
+    hosts = await wait_for_cql_and_get_hosts(cql, servers[:2] + servers[3:], time.time() + 60)
+    assert await last_state_id(cql, hosts[0]) == state_id
+
+    log = await manager.server_open_log(servers[2].server_id)
+    mark = await log.mark()
+    await manager.server_start(servers[2].server_id)
+    await log.wait_for("transfer snapshot from .*: group 0 state is up to date", from_mark=mark)
+    hosts = await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+    assert await last_state_id(cql, hosts[2]) == state_id
+    assert await columns(cql, hosts[2], 't') == {'pk'}
+
+    # A node which lags behind still gets the full state.
+    logger.info("Stopping %s", servers[2])
+    await manager.server_stop_gracefully(servers[2].server_id)
+    await cql.run_async("create table ks.t2 (pk int primary key)", host=hosts[0])
+    for c in ['v1', 'v2', 'v3']:
+        await cql.run_async(f"alter table ks.t2 add {c} int", host=hosts[0])
+    state_id = await last_state_id(cql, hosts[0])
+
+    mark = await log.mark()
+    await manager.server_start(servers[2].server_id)
+    await log.wait_for("transfer snapshot from", from_mark=mark)
+    hosts = await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+    await wait_for_state_id(cql, hosts[2], state_id)
+    assert not await log.grep("group 0 state is up to date", from_mark=mark)
+    assert await columns(cql, hosts[2], 't2') == {'pk', 'v1', 'v2', 'v3'}
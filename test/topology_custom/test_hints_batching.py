@@ -0,0 +1,83 @@
+#
+# Copyright (C) 2026-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+import logging
+import time
+import pytest
+
+from cassandra.cluster import ConsistencyLevel # type: ignore
+from cassandra.query import SimpleStatement # type: ignore
+
+from test.pylib.manager_client import ManagerClient
+from test.pylib.util import wait_for, wait_for_cql_and_get_hosts
+from test.topology.conftest import skip_mode
+
+
+logger = logging.getLogger(__name__)
+
+
+async def get_sent_hints(manager: ManagerClient, server) -> int:
+    metrics = await manager.metrics.query(server.ip_addr)
+    return int(metrics.get('scylla_hints_manager_sent') or 0)
+
+
+async def write_hints_and_replay(manager: ManagerClient, config: dict, nr_rows: int, injection: str = None) -> None:
+    """Writes nr_rows while the second node is down, so that the first one stores hints for them,
+       and checks that the hints bring the second node up to date once it is back"""
+    config = {
+        **config,
+        'error_injections_at_startup': ['decrease_hints_flush_period'],
+    }
+    servers = [await manager.server_add(cmdline=['--smp', '2'], config=config) for _ in range(2)]
+    cql = manager.get_cql()
+    await cql.run_async("create keyspace ks with replication = {'class': 'SimpleStrategy', 'replication_factor': 2}")
+    await cql.run_async("create table ks.t (pk int primary key, v int)")
+    hosts = await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+
+    await manager.server_stop_gracefully(servers[1].server_id)
+    for pk in range(nr_rows):
+        stmt = SimpleStatement(f"insert into ks.t (pk, v) values ({pk}, {pk})", consistency_level=ConsistencyLevel.ONE)
+        await cql.run_async(stmt, host=hosts[0])
+
+    if injection:
+        await manager.api.enable_injection(servers[0].ip_addr, injection, one_shot=True)
+    await manager.server_start(servers[1].server_id)
+
+    async def all_hints_sent():
+        sent = await get_sent_hints(manager, servers[0])
+        logger.info(f"{sent} hints sent")
+        if sent >= nr_rows:
+            return True
+    await wait_for(all_hints_sent, time.time() + 120)
+
+    # The second node has all the rows on its own.
+    await manager.server_stop_gracefully(servers[0].server_id)
+    hosts = await wait_for_cql_and_get_hosts(cql, [servers[1]], time.time() + 60)
+    rows = await cql.run_async(SimpleStatement("select pk, v from ks.t", consistency_level=ConsistencyLevel.ONE), host=hosts[0])
+    assert sorted((r.pk, r.v) for r in rows) == [(pk, pk) for pk in range(nr_rows)]
+
+
+@pytest.mark.asyncio
+@skip_mode('release', 'error injections are not supported in release mode')
+@pytest.mark.parametrize("batch_size_in_kb,concurrency", [(0, 0), (64, 0), (64, 1), (1, 2)])
+async def test_hints_batching(manager: ManagerClient, batch_size_in_kb: int, concurrency: int) -> None:
+    """Hints are replayed, one by one or in batches, with the default and with a small send concurrency"""
+    config = {
+        'hints_send_batch_size_in_kb': batch_size_in_kb,
+        'max_hinted_handoff_concurrency': concurrency,
+    }
+    await write_hints_and_replay(manager, config, nr_rows=500)
+
+
+@pytest.mark.asyncio
+@skip_mode('release', 'error injections are not supported in release mode')
+async def test_hints_batch_failure(manager: ManagerClient) -> None:
+    """A batch which fails as a whole is retried, and replay carries on"""
+    config = {
+        'hints_send_batch_size_in_kb': 1,
+        'max_hinted_handoff_concurrency': 2,
+    }
+    await write_hints_and_replay(manager, config, nr_rows=200, injection='hint_sender_batch_fail')
@@ -0,0 +1,71 @@
+#
+# Copyright (C) 2026-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+import logging
+import time
+import pytest
+
+from cassandra.cluster import ConsistencyLevel # type: ignore
+from cassandra.query import SimpleStatement # type: ignore
+
+from test.pylib.manager_client import ManagerClient
+from test.pylib.util import wait_for_cql_and_get_hosts
+
+
+logger = logging.getLogger(__name__)
+
+
+async def get_rows_from_disk(manager: ManagerClient, server) -> int:
+    """Returns the number of rows the server read from disk for repairs"""
+    metrics = await manager.metrics.query(server.ip_addr)
+    return int(metrics.get('scylla_repair_row_from_disk_nr') or 0)
+
+
+async def insert(cql, host, pks):
+    for pk in pks:
+        stmt = SimpleStatement(f"insert into ks.t (pk, v) values ({pk}, {pk})", consistency_level=ConsistencyLevel.ONE)
+        await cql.run_async(stmt, host=host)
+
+
+@pytest.mark.asyncio
+@pytest.mark.parametrize("splits", [0, 16])
+async def test_repair_reads_rows_once(manager: ManagerClient, splits: int) -> None:
+    """Repair syncs the missing rows, and reads every row only once, also the
+       rows of the sub-ranges which the range summary finds out of sync"""
+    config = {
+        'repair_range_summary_splits': splits,
+        # The missing rows have to be synced by repair.
+        'hinted_handoff_enabled': False,
+    }
+    servers = [await manager.server_add(cmdline=['--smp', '1'], config=config) for _ in range(2)]
+    cql = manager.get_cql()
+    await cql.run_async("create keyspace ks with replication = {'class': 'SimpleStrategy', 'replication_factor': 2}")
+    await cql.run_async("create table ks.t (pk int primary key, v int)")
+    hosts = await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+
+    nr_rows = 100
+    await insert(cql, hosts[0], range(nr_rows))
+    await manager.server_stop_gracefully(servers[1].server_id)
+    nr_missing = 3
+    await insert(cql, hosts[0], range(nr_rows, nr_rows + nr_missing))
+    await manager.server_start(servers[1].server_id)
+    await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+    for server in servers:
+        await manager.api.keyspace_flush(server.ip_addr, "ks")
+
+    before = [await get_rows_from_disk(manager, server) for server in servers]
+    await manager.api.repair(servers[0].ip_addr, "ks")
+    after = [await get_rows_from_disk(manager, server) for server in servers]
+
+    from_disk = [a - b for a, b in zip(after, before)]
+    logger.info(f"rows read from disk: {from_disk}")
+    assert from_disk == [nr_rows + nr_missing, nr_rows]
+
+    # The other node has all the rows on its own.
+    await manager.server_stop_gracefully(servers[0].server_id)
+    hosts = await wait_for_cql_and_get_hosts(cql, [servers[1]], time.time() + 60)
+    rows = await cql.run_async(SimpleStatement("select pk from ks.t", consistency_level=ConsistencyLevel.ONE), host=hosts[0])
+    assert sorted(r.pk for r in rows) == list(range(nr_rows + nr_missing))
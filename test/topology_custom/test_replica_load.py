@@ -0,0 +1,54 @@
+#
+# Copyright (C) 2026-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+import logging
+import time
+import pytest
+
+from cassandra.cluster import ConsistencyLevel # type: ignore
+from cassandra.query import SimpleStatement # type: ignore
+
+from test.pylib.manager_client import ManagerClient
+from test.pylib.util import wait_for_cql_and_get_hosts
+from test.topology.conftest import skip_mode
+
+
+logger = logging.getLogger(__name__)
+
+
+@pytest.mark.asyncio
+@skip_mode('release', 'error injections are not supported in release mode')
+async def test_replies_without_replica_load(manager: ManagerClient) -> None:
+    """A coordinator using the replica load for reads and writes accepts replies which
+       don't carry it, as sent by nodes of older versions"""
+    config = {
+        'load_aware_read_balancing': True,
+        'speculative_retry_adaptive': True,
+        'load_aware_write_throttling': True,
+    }
+    # The first node gets all replies as if the other nodes were of an older version.
+    servers = [await manager.server_add(config={**config, 'error_injections_at_startup': ['storage_proxy_reply_without_replica_load']})]
+    servers += [await manager.server_add(config=config) for _ in range(2)]
+    cql = manager.get_cql()
+    await cql.run_async("create keyspace ks with replication = {'class': 'SimpleStrategy', 'replication_factor': 3}")
+    await cql.run_async("create table ks.t (pk int primary key, v int) with speculative_retry = '99PERCENTILE'")
+    hosts = await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+
+    nr_rows = 100
+    for pk in range(nr_rows):
+        stmt = SimpleStatement(f"insert into ks.t (pk, v) values ({pk}, {pk})", consistency_level=ConsistencyLevel.ALL)
+        await cql.run_async(stmt, host=hosts[0])
+    for host in hosts:
+        for cl in [ConsistencyLevel.ONE, ConsistencyLevel.QUORUM, ConsistencyLevel.ALL]:
+            for pk in range(0, nr_rows, 10):
+                stmt = SimpleStatement(f"select v from ks.t where pk = {pk}", consistency_level=cl)
+                assert [r.v for r in await cql.run_async(stmt, host=host)] == [pk]
+
+    # Without any load reported by the other nodes, the first one had no reason to avoid
+    # or throttle them.
+    metrics = await manager.metrics.query(servers[0].ip_addr)
+    for name in ['busy_replicas_avoided', 'writes_throttled_by_replica_load']:
+        assert int(metrics.get(f'scylla_storage_proxy_coordinator_{name}') or 0) == 0
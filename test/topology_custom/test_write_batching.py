@@ -0,0 +1,127 @@
+#
+# Copyright (C) 2026-present ScyllaDB
+#
+# SPDX-License-Identifier: AGPL-3.0-or-later
+#
+
+import asyncio
+import logging
+import time
+import pytest
+
+from cassandra.cluster import ConsistencyLevel # type: ignore
+from cassandra.query import SimpleStatement # type: ignore
+
+from test.pylib.manager_client import ManagerClient
+from test.pylib.util import wait_for_cql_and_get_hosts
+
+
+logger = logging.getLogger(__name__)
+
+
+async def start_cluster(manager: ManagerClient, window_us: int, timeout_ms: int = 20000):
+    """Starts two single shard nodes which batch writes to each other with the given window,
+       and creates a table replicated on both of them. Returns the servers and their hosts."""
+    config = {
+        'write_batching_window_in_us': window_us,
+        'write_request_timeout_in_ms': timeout_ms,
+    }
+    servers = [await manager.server_add(cmdline=['--smp', '1'], config=config) for _ in range(2)]
+    cql = manager.get_cql()
+    await cql.run_async("create keyspace ks with replication = {'class': 'SimpleStrategy', 'replication_factor': 2}")
+    await cql.run_async("create table ks.t (pk int primary key, v blob)")
+    hosts = await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+    return servers, hosts
+
+
+async def get_batch_metrics(manager: ManagerClient, server) -> tuple[int, int]:
+    """Returns the number of batch messages sent by the server and of writes they carried"""
+    metrics = await manager.metrics.query(server.ip_addr)
+    batches = metrics.get('scylla_storage_proxy_coordinator_write_batches') or 0
+    writes = metrics.get('scylla_storage_proxy_coordinator_batched_writes') or 0
+    return int(batches), int(writes)
+
+
+async def insert(cql, host, pk: int, size: int = 1, cl = ConsistencyLevel.ALL):
+    stmt = SimpleStatement(f"insert into ks.t (pk, v) values ({pk}, 0x{'00' * size})", consistency_level=cl)
+    await cql.run_async(stmt, host=host)
+
+
+@pytest.mark.asyncio
+async def test_write_batching(manager: ManagerClient) -> None:
+    """Concurrent writes to the same replica are sent in fewer messages than writes"""
+    servers, hosts = await start_cluster(manager, window_us=100000)
+    cql = manager.get_cql()
+
+    before = await get_batch_metrics(manager, servers[0])
+    nr_writes = 100
+    await asyncio.gather(*[insert(cql, hosts[0], pk) for pk in range(nr_writes)])
+    after = await get_batch_metrics(manager, servers[0])
+
+    batches, writes = after[0] - before[0], after[1] - before[1]
+    logger.info(f"{writes} writes sent in {batches} batches")
+    # Every write has exactly one remote replica.
+    assert writes == nr_writes
+    assert 0 < batches < writes
+
+    rows = await cql.run_async(SimpleStatement("select pk from ks.t", consistency_level=ConsistencyLevel.ALL))
+    assert sorted(r.pk for r in rows) == list(range(nr_writes))
+
+
+@pytest.mark.asyncio
+async def test_write_batch_flushed_on_timer(manager: ManagerClient) -> None:
+    """A write which no other write joins is sent once the window passes"""
+    window = 1
+    servers, hosts = await start_cluster(manager, window_us=window * 1000000)
+    cql = manager.get_cql()
+
+    before = await get_batch_metrics(manager, servers[0])
+    start = time.time()
+    await insert(cql, hosts[0], 0)
+    elapsed = time.time() - start
+    after = await get_batch_metrics(manager, servers[0])
+
+    assert after[0] - before[0] == 1
+    assert after[1] - before[1] == 1
+    # The write waited for the timer, as it was the only one in its batch.
+    assert elapsed >= window * 0.9
+
+
+@pytest.mark.asyncio
+async def test_write_batch_flushed_on_size(manager: ManagerClient) -> None:
+    """A batch is sent without waiting for the window once it is large enough"""
+    window = 10
+    servers, hosts = await start_cluster(manager, window_us=window * 1000000, timeout_ms=window * 2000)
+    cql = manager.get_cql()
+
+    before = await get_batch_metrics(manager, servers[0])
+    start = time.time()
+    # Larger than the size limit of a batch, so it fills one on its own.
+    await insert(cql, hosts[0], 0, size=130 * 1024)
+    elapsed = time.time() - start
+    after = await get_batch_metrics(manager, servers[0])
+
+    assert after[0] - before[0] == 1
+    assert after[1] - before[1] == 1
+    assert elapsed < window
+
+
+@pytest.mark.asyncio
+async def test_write_batch_pending_on_shutdown(manager: ManagerClient) -> None:
+    """Shutting down a node does not wait for, nor leak, writes waiting in a batch"""
+    window = 60
+    servers, hosts = await start_cluster(manager, window_us=window * 1000000, timeout_ms=window * 2000)
+    cql = manager.get_cql()
+
+    # Acknowledged by the coordinator itself, while the write to the other replica
+    # waits in a batch for the whole window.
+    await insert(cql, hosts[0], 0, cl=ConsistencyLevel.ONE)
+
+    start = time.time()
+    await manager.server_stop_gracefully(servers[0].server_id)
+    assert time.time() - start < window
+
+    await manager.server_start(servers[0].server_id)
+    await wait_for_cql_and_get_hosts(cql, servers, time.time() + 60)
+    rows = await cql.run_async(SimpleStatement("select pk from ks.t where pk = 0", consistency_level=ConsistencyLevel.ALL))
+    assert [r.pk for r in rows] == [0]
@@ -11,6 +11,7 @@ from test.pylib.util import wait_for_cql_and_get_hosts
 from test.topology.util import reconnect_driver
 
 import pytest
+import os
 import asyncio
 import logging
 import time
@@ -195,3 +196,105 @@ async def test_topology_changes(manager: ManagerClient):
     await check()
 
     await cql.run_async("DROP KEYSPACE test;")
+
+
+@pytest.mark.asyncio
+async def test_tablet_split(manager: ManagerClient):
+    logger.info("Bootstrapping cluster")
+    cfg = {'target_tablet_size_in_mb': 1, 'tablet_load_stats_refresh_interval_in_seconds': 1}
+    servers = [await manager.server_add(config=cfg), await manager.server_add(config=cfg)]
+
+    cql = manager.get_cql()
+    await cql.run_async("CREATE KEYSPACE test WITH replication = {'class': 'NetworkTopologyStrategy', "
+                        "'replication_factor': 1, 'initial_tablets': 2};")
+    await cql.run_async("CREATE TABLE test.test (pk int PRIMARY KEY, c blob);")
+
+    async def tablet_count():
+        rows = await cql.run_async("SELECT tablet_count FROM system.tablets WHERE keyspace_name = 'test' ALLOW FILTERING;")
+        return rows[0].tablet_count
+
+    assert await tablet_count() == 2
+
+    # Incompressible values, 8MB in total, so that tablets are well above twice the target size.
+    logger.info("Populating table")
+    keys = range(512)
+    values = {k: os.urandom(16 * 1024) for k in keys}
+    insert = cql.prepare("INSERT INTO test.test (pk, c) VALUES (?, ?);")
+    await asyncio.gather(*[cql.run_async(insert, [k, values[k]]) for k in keys])
+
+    async def check():
+        logger.info("Checking table")
+        rows = await cql.run_async("SELECT * FROM test.test;")
+        assert len(rows) == len(keys)
+        for r in rows:
+            assert r.c == values[r.pk]
+        # Point reads go to a single compaction group.
+        for k in keys[::16]:
+            rows = await cql.run_async(f"SELECT c FROM test.test WHERE pk = {k};")
+            assert rows[0].c == values[k]
+
+    # Part of the data stays in memtables, which have to be flushed before the split.
+    for s in servers:
+        await manager.api.keyspace_flush(s.ip_addr, "test", "test")
+    await asyncio.gather(*[cql.run_async(insert, [k, values[k]]) for k in keys[::2]])
+
+    logger.info("Waiting for the split")
+    deadline = time.time() + 120
+    while await tablet_count() < 4:
+        assert time.time() < deadline, "tablets were not split"
+        await asyncio.sleep(1)
+
+    await check()
+
+    # Migrations move the split tablets and clean them up on their old replicas.
+    logger.info("Adding new server")
+    await manager.server_add(config=cfg)
+    time.sleep(5) # Give load balancer some time to do work
+    await check()
+
+    await cql.run_async("DROP KEYSPACE test;")
+
+
+@pytest.mark.asyncio
+async def test_tablet_migration_with_file_streaming(manager: ManagerClient):
+    """Migrated tablets whose sstables are sent as whole files have all their data on the new replica"""
+    cfg = {'enable_file_streaming': True}
+    servers = [await manager.server_add(config=cfg)]
+
+    cql = manager.get_cql()
+    await cql.run_async("CREATE KEYSPACE test WITH replication = {'class': 'NetworkTopologyStrategy', "
+                  "'replication_factor': 1, 'initial_tablets': 8};")
+    await cql.run_async("CREATE TABLE test.test (pk int PRIMARY KEY, c int);")
+
+    keys = range(256)
+    await asyncio.gather(*[cql.run_async(f"INSERT INTO test.test (pk, c) VALUES ({k}, {k});") for k in keys])
+    await manager.api.keyspace_flush(servers[0].ip_addr, "test", "test")
+    # Only in the memtable, so streamed as mutation fragments.
+    await asyncio.gather(*[cql.run_async(f"UPDATE test.test SET c = {k + 1} WHERE pk = {k};") for k in keys[::2]])
+
+    async def check():
+        logger.info("Checking table")
+        rows = await cql.run_async("SELECT * FROM test.test;")
+        assert len(rows) == len(keys)
+        for r in rows:
+            assert r.c == (r.pk + 1 if r.pk % 2 == 0 else r.pk)
+
+    log = await manager.server_open_log(servers[0].server_id)
+    mark = await log.mark()
+
+    # All the tablets move to the new server.
+    servers.append(await manager.server_add(config=cfg))
+    await manager.decommission_node(servers[0].server_id)
+
+    assert await log.grep(r"Start sending ks=test, cf=test, sstables=\d+ as files", from_mark=mark)
+    new_log = await manager.server_open_log(servers[1].server_id)
+    assert not await new_log.grep("Failed to handle STREAM_SSTABLE_FILES")
+
+    await check()
+    # The received sstables are complete, and readable after a restart.
+    await manager.server_restart(servers[1].server_id)
+    cql = await reconnect_driver(manager)
+    await wait_for_cql_and_get_hosts(cql, [servers[1]], time.time() + 60)
+    await check()
+
+    await cql.run_async("DROP KEYSPACE test;")
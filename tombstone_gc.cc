@@ -9,6 +9,7 @@
 #include <chrono>
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_map.hpp>
+#include <boost/icl/interval_set.hpp>
 #include "schema/schema.hh"
 #include "dht/i_partitioner.hh"
 #include "gc_clock.hh"
@@ -175,6 +176,24 @@ void tombstone_gc_state::update_repair_time(table_id id, const dht::token_range&
     m->map += std::make_pair(locator::token_metadata::range_to_interval(range), repair_time);
 }
 
+std::optional<gc_clock::time_point> tombstone_gc_state::get_repair_time_for_range(const table_id& id, const dht::token_range& range) const {
+    auto m = get_repair_history_map_for_table(id);
+    if (!m) {
+        return std::nullopt;
+    }
+    auto interval = locator::token_metadata::range_to_interval(range);
+    boost::icl::interval_set<dht::token> covered;
+    auto repair_time = gc_clock::time_point::max();
+    for (auto& x : boost::make_iterator_range(m->map.equal_range(interval))) {
+        covered += x.first;
+        repair_time = std::min(repair_time, x.second);
+    }
+    if (!boost::icl::contains(covered, interval)) {
+        return std::nullopt;
+    }
+    return repair_time;
+}
+
 static bool needs_repair_before_gc(const replica::database& db, sstring ks_name) {
     // If a table uses local replication strategy or rf one, there is no
     // need to run repair even if tombstone_gc mode = repair.
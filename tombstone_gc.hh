@@ -70,6 +70,10 @@ class tombstone_gc_state {
     gc_clock::time_point get_gc_before_for_key(schema_ptr s, const dht::decorated_key& dk, const gc_clock::time_point& query_time) const;
 
     void update_repair_time(table_id id, const dht::token_range& range, gc_clock::time_point repair_time);
+
+    // Returns the time of the oldest repair which covered a part of the range,
+    // or nullopt unless the whole range is covered by the recorded repairs.
+    std::optional<gc_clock::time_point> get_repair_time_for_range(const table_id& id, const dht::token_range& range) const;
 };
 
 void validate_tombstone_gc_options(const tombstone_gc_options* options, data_dictionary::database db, sstring ks_name);
@@ -8,10 +8,12 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/join.hpp>
+#include <boost/range/irange.hpp>
 #include <filesystem>
 #include <source_location>
 #include <fmt/chrono.h>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/util/closeable.hh>
 
 #include "compaction/compaction.hh"
@@ -273,11 +275,12 @@ std::optional<schema_with_source> try_load_schema_autodetect(const bpo::variable
     return {};
 }
 
-const std::vector<sstables::shared_sstable> load_sstables(schema_ptr schema, sstables::sstables_manager& sst_man, const std::vector<sstring>& sstable_names) {
+const std::vector<sstables::shared_sstable> load_sstables(schema_ptr schema, sstables::sstables_manager& sst_man, const std::vector<sstring>& sstable_names,
+        size_t buffer_size) {
     std::vector<sstables::shared_sstable> sstables;
     sstables.resize(sstable_names.size());
 
-    parallel_for_each(sstable_names, [schema, &sst_man, &sstable_names, &sstables] (const sstring& sst_name) -> future<> {
+    parallel_for_each(sstable_names, [schema, &sst_man, &sstable_names, &sstables, buffer_size] (const sstring& sst_name) -> future<> {
         const auto i = std::distance(sstable_names.begin(), std::find(sstable_names.begin(), sstable_names.end(), sst_name));
         const auto sst_path = std::filesystem::path(sst_name);
 
@@ -294,7 +297,8 @@ const std::vector<sstables::shared_sstable> load_sstables(schema_ptr schema, sst
         auto ed = sstables::parse_path(sst_path, schema->ks_name(), schema->cf_name());
         const auto dir_path = sst_path.parent_path();
         data_dictionary::storage_options local;
-        auto sst = sst_man.make_sstable(schema, dir_path.c_str(), local, ed.generation, sstables::sstable_state::normal, ed.version, ed.format);
+        auto sst = sst_man.make_sstable(schema, dir_path.c_str(), local, ed.generation, sstables::sstable_state::normal, ed.version, ed.format,
+                gc_clock::now(), default_io_error_handler_gen(), buffer_size);
 
         try {
             co_await sst->load(schema->get_sharder(), sstables::sstable_open_config{.load_first_and_last_position_metadata = false});
@@ -891,7 +895,7 @@ class scylla_sstable_table_state : public compaction::table_state {
     virtual sstables::sstables_manager& get_sstables_manager() noexcept override { return _sst_man; }
     virtual sstables::shared_sstable make_sstable() const override { return do_make_sstable(); }
     virtual sstables::sstable_writer_config configure_writer(sstring origin) const override { return do_configure_writer(std::move(origin)); }
-    virtual api::timestamp_type min_memtable_timestamp() const override { return api::min_timestamp; }
+    virtual api::timestamp_type min_memtable_timestamp(const dht::decorated_key&) const override { return api::min_timestamp; }
     virtual future<> on_compaction_completion(sstables::compaction_completion_desc desc, sstables::offstrategy offstrategy) override { return make_ready_future<>(); }
     virtual bool is_auto_compaction_disabled_by_user() const noexcept override { return false; }
     virtual bool tombstone_gc_enabled() const noexcept override { return false; }
@@ -913,6 +917,19 @@ void validate_output_dir(std::filesystem::path output_dir, bool accept_nonempty_
     }
 }
 
+// Invokes func for the index of each sstable, processing at most --jobs
+// sstables concurrently.
+// Operations are expected to store per-sstable results by index and print
+// them after, to keep the output in the order the sstables were provided in.
+void for_each_sstable_concurrently(const std::vector<sstables::shared_sstable>& sstables, const bpo::variables_map& vm,
+        noncopyable_function<future<>(size_t)> func) {
+    const auto jobs = vm["jobs"].as<unsigned>();
+    if (!jobs) {
+        throw std::invalid_argument("--jobs has to be greater than 0");
+    }
+    max_concurrent_for_each(boost::irange(size_t(0), sstables.size()), jobs, std::ref(func)).get();
+}
+
 void validate_operation(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables,
         sstables::sstables_manager& sst_man, const bpo::variables_map& vm) {
     if (sstables.empty()) {
@@ -920,9 +937,12 @@ void validate_operation(schema_ptr schema, reader_permit permit, const std::vect
     }
 
     abort_source abort;
-    for (const auto& sst : sstables) {
-        const auto errors = sst->validate(permit, abort, [] (sstring what) { sst_log.info("{}", what); }).get();
-        fmt::print("{}: {}\n", sst->get_filename(), errors == 0 ? "valid" : "invalid");
+    std::vector<uint64_t> errors(sstables.size());
+    for_each_sstable_concurrently(sstables, vm, [&] (size_t i) -> future<> {
+        errors[i] = co_await sstables[i]->validate(permit, abort, [] (sstring what) { sst_log.info("{}", what); });
+    });
+    for (size_t i = 0; i < sstables.size(); ++i) {
+        fmt::print("{}: {}\n", sstables[i]->get_filename(), errors[i] == 0 ? "valid" : "invalid");
     }
 }
 
@@ -1385,6 +1405,21 @@ const char* to_string(sstables::scylla_metadata_type t) {
         case sstables::scylla_metadata_type::SSTableOrigin: return "sstable_origin";
         case sstables::scylla_metadata_type::ScyllaVersion: return "scylla_version";
         case sstables::scylla_metadata_type::ScyllaBuildId: return "scylla_build_id";
+        case sstables::scylla_metadata_type::ColumnValueStats: return "column_value_stats";
+        case sstables::scylla_metadata_type::TombstoneStats: return "tombstone_stats";
+        case sstables::scylla_metadata_type::CompactionCheckpoint: return "compaction_checkpoint";
+        case sstables::scylla_metadata_type::SummaryEntryStats: return "summary_entry_stats";
+    }
+    std::abort();
+}
+
+const char* to_string(sstables::tombstone_kind k) {
+    switch (k) {
+        case sstables::tombstone_kind::partition: return "partition";
+        case sstables::tombstone_kind::range: return "range";
+        case sstables::tombstone_kind::row: return "row";
+        case sstables::tombstone_kind::cell: return "cell";
+        case sstables::tombstone_kind::expiring: return "expiring";
     }
     std::abort();
 }
@@ -1479,6 +1514,69 @@ class scylla_metadata_visitor : public boost::static_visitor<> {
         }
         _writer.EndObject();
     }
+    void operator()(const sstables::scylla_metadata::column_value_stats& val) const {
+        _writer.StartObject();
+        for (const auto& [k, v] : val.map) {
+            _writer.Key(disk_string_to_string(k));
+            _writer.StartObject();
+            _writer.Key("null_count");
+            _writer.Uint64(v.null_count);
+            if (v.has_min_max) {
+                _writer.Key("min_value");
+                _writer.String(to_hex(v.min_value.value));
+                _writer.Key("max_value");
+                _writer.String(to_hex(v.max_value.value));
+            }
+            _writer.EndObject();
+        }
+        _writer.EndObject();
+    }
+    void operator()(const sstables::scylla_metadata::tombstone_stats& val) const {
+        _writer.StartObject();
+        for (const auto& [k, v] : val.map) {
+            _writer.Key(to_string(k));
+            _writer.StartObject();
+            _writer.Key("count");
+            _writer.Uint64(v.count);
+            _writer.Key("buckets");
+            _writer.StartArray();
+            for (const auto& b : v.buckets.elements) {
+                _writer.StartObject();
+                _writer.Key("max_deletion_time");
+                _writer.Int(b.max_deletion_time);
+                _writer.Key("count");
+                _writer.Uint64(b.count);
+                _writer.EndObject();
+            }
+            _writer.EndArray();
+            _writer.EndObject();
+        }
+        _writer.EndObject();
+    }
+    void operator()(const sstables::compaction_checkpoint& val) const {
+        _writer.StartObject();
+        _writer.Key("inputs");
+        _writer.StartArray();
+        for (const auto& input : val.inputs.elements) {
+            _writer.String(disk_string_to_string(input));
+        }
+        _writer.EndArray();
+        _writer.Key("max_sstable_size");
+        _writer.Uint64(val.max_sstable_size);
+        _writer.EndObject();
+    }
+    void operator()(const sstables::scylla_metadata::summary_entry_stats& val) const {
+        _writer.StartArray();
+        for (const auto& e : val.elements) {
+            _writer.StartObject();
+            _writer.Key("partitions");
+            _writer.Uint(e.partitions);
+            _writer.Key("data_size");
+            _writer.Uint64(e.data_size);
+            _writer.EndObject();
+        }
+        _writer.EndArray();
+    }
     template <typename Size>
     void operator()(const sstables::disk_string<Size>& val) const {
         _writer.String(disk_string_to_string(val));
@@ -1516,14 +1614,17 @@ void dump_scylla_metadata_operation(schema_ptr schema, reader_permit permit, con
 }
 
 void validate_checksums_operation(schema_ptr schema, reader_permit permit, const std::vector<sstables::shared_sstable>& sstables,
-        sstables::sstables_manager& sst_man, const bpo::variables_map&) {
+        sstables::sstables_manager& sst_man, const bpo::variables_map& vm) {
     if (sstables.empty()) {
         throw std::invalid_argument("no sstables specified on the command line");
     }
 
-    for (auto& sst : sstables) {
-        const auto valid = sstables::validate_checksums(sst, permit).get();
-        sst_log.info("validated the checksums of {}: {}", sst->get_filename(), valid ? "valid" : "invalid");
+    std::vector<bool> valid(sstables.size());
+    for_each_sstable_concurrently(sstables, vm, [&] (size_t i) -> future<> {
+        valid[i] = co_await sstables::validate_checksums(sstables[i], permit);
+    });
+    for (size_t i = 0; i < sstables.size(); ++i) {
+        sst_log.info("validated the checksums of {}: {}", sstables[i]->get_filename(), valid[i] ? "valid" : "invalid");
     }
 }
 
@@ -2441,6 +2542,7 @@ void write_operation(schema_ptr schema, reader_permit permit, const std::vector<
         {"partition_region", mutation_fragment_stream_validation_level::partition_region},
         {"token", mutation_fragment_stream_validation_level::token},
         {"partition_key", mutation_fragment_stream_validation_level::partition_key},
+        {"sampled_clustering_key", mutation_fragment_stream_validation_level::sampled_clustering_key},
         {"clustering_key", mutation_fragment_stream_validation_level::clustering_key},
     };
     if (!sstables.empty()) {
@@ -2533,6 +2635,7 @@ const std::vector<operation_option> global_options {
     typed_option<>("system-schema", "the table designated by --keyspace and --table is a system table, use the hard-coded in-memory hard-coded schema for it"),
     typed_option<sstring>("scylla-yaml-file", "path to the scylla.yaml config file, to obtain the data directory path from, this can be also provided directly with --scylla-data-dir"),
     typed_option<sstring>("scylla-data-dir", "path to the scylla data dir (usually /var/lib/scylla/data), to read the schema tables from"),
+    typed_option<size_t>("buffer-size", sstables::default_sstable_buffer_size, "size of the buffers used to read the sstable components, in bytes; larger buffers make scanning large sstables faster, at the cost of memory"),
 };
 
 const std::vector<operation_option> global_positional_options{
@@ -2688,7 +2791,10 @@ validation will happen on the fragment level.
 
 See https://docs.scylladb.com/operating-scylla/admin-tools/scylla-sstable#validate
 for more information on this operation.
-)"},
+)",
+            {
+                    typed_option<unsigned>("jobs", 1u, "number of sstables to validate concurrently"),
+            }},
             validate_operation},
 /* scrub */
     {{"scrub",
@@ -2724,7 +2830,10 @@ component.
 
 See https://docs.scylladb.com/operating-scylla/admin-tools/scylla-sstable#validate-checksums
 for more information on this operation.
-)"},
+)",
+            {
+                    typed_option<unsigned>("jobs", 1u, "number of sstables to validate concurrently"),
+            }},
             validate_checksums_operation},
 /* decompress */
     {{"decompress",
@@ -2770,7 +2879,7 @@ for more information on this operation, including the schema of the JSON input.
                     typed_option<std::string>("input-file", "the file containing the input"),
                     typed_option<std::string>("output-dir", ".", "directory to place the output sstable(s) to"),
                     typed_option<sstables::generation_type::int_t>("generation", "generation of generated sstable"),
-                    typed_option<std::string>("validation-level", "clustering_key", "degree of validation on the output, one of (partition_region, token, partition_key, clustering_key)"),
+                    typed_option<std::string>("validation-level", "clustering_key", "degree of validation on the output, one of (partition_region, token, partition_key, sampled_clustering_key, clustering_key)"),
             }},
             write_operation},
 /* script */
@@ -2941,7 +3050,7 @@ Validate the specified sstables:
         std::vector<sstables::shared_sstable> sstables;
         if (app_config.count("sstables")) {
             try {
-                sstables = load_sstables(schema, sst_man, app_config["sstables"].as<std::vector<sstring>>());
+                sstables = load_sstables(schema, sst_man, app_config["sstables"].as<std::vector<sstring>>(), app_config["buffer-size"].as<size_t>());
             } catch (...) {
                 fmt::print(std::cerr, "error loading sstables: {}\n", std::current_exception());
                 return 1;
@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <charconv>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/http/request.hh>
+#include <seastar/util/short_streams.hh>
+#include "tracing/otlp_exporter.hh"
+#include "cql3/query_processor.hh"
+#include "db/config.hh"
+#include "utils/fb_utilities.hh"
+#include "utils/class_registrator.hh"
+#include "utils/http.hh"
+
+namespace tracing {
+
+static logging::logger otlp_logger("otlp_exporter");
+
+// OTLP span kinds
+static constexpr int span_kind_internal = 1;
+static constexpr int span_kind_server = 2;
+
+namespace otlp {
+
+sstring collector_address::authority() const {
+    if (host.find(':') != sstring::npos) {
+        return format("[{}]:{}", host, port);
+    }
+    return format("{}:{}", host, port);
+}
+
+collector_address parse_collector_address(std::string_view address, uint16_t default_port) {
+    if (address.empty()) {
+        throw std::invalid_argument("tracing_otlp_collector_address has to be set to use the OTLP tracing backend");
+    }
+    auto invalid = [address] (std::string_view reason) {
+        return std::invalid_argument(format("Invalid tracing_otlp_collector_address '{}': {}", address, reason));
+    };
+    std::string_view host = address;
+    std::optional<std::string_view> port;
+    if (address.starts_with('[')) {
+        auto end = address.find(']');
+        if (end == std::string_view::npos) {
+            throw invalid("missing ']'");
+        }
+        host = address.substr(1, end - 1);
+        auto rest = address.substr(end + 1);
+        if (!rest.empty()) {
+            if (rest[0] != ':') {
+                throw invalid("expected ':' after ']'");
+            }
+            port = rest.substr(1);
+        }
+    } else if (auto pos = address.find(':'); pos != std::string_view::npos && address.find(':', pos + 1) == std::string_view::npos) {
+        host = address.substr(0, pos);
+        port = address.substr(pos + 1);
+    }
+    // Otherwise, the address has no colon, or is an IPv6 address without brackets and so without a port.
+    if (host.empty()) {
+        throw invalid("missing host");
+    }
+    if (!port) {
+        return collector_address{sstring(host), default_port};
+    }
+    unsigned value = 0;
+    auto [end, ec] = std::from_chars(port->data(), port->data() + port->size(), value);
+    if (port->empty() || ec != std::errc() || end != port->data() + port->size() || value == 0 || value > std::numeric_limits<uint16_t>::max()) {
+        throw invalid(format("invalid port '{}'", *port));
+    }
+    return collector_address{sstring(host), uint16_t(value)};
+}
+
+}
+
+struct otlp_session_state final : public backend_session_state_base {
+    // Events of a coordinator's session are held until the session is over,
+    // so that the whole session becomes a single span.
+    std::deque<event_record> events;
+    // The number of spans a replica's session has been exported as so far.
+    unsigned exported_spans = 0;
+};
+
+static rjson::value make_string(std::string_view s) {
+    return rjson::from_string(s);
+}
+
+static rjson::value make_nanos(std::chrono::system_clock::time_point tp) {
+    return make_string(fmt::format("{}", std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count()));
+}
+
+static void add_attribute(rjson::value& attributes, std::string_view key, rjson::value value) {
+    auto attr = rjson::empty_object();
+    rjson::add(attr, "key", make_string(key));
+    rjson::add(attr, "value", std::move(value));
+    rjson::push_back(attributes, std::move(attr));
+}
+
+static void add_string_attribute(rjson::value& attributes, std::string_view key, std::string_view value) {
+    auto v = rjson::empty_object();
+    rjson::add(v, "stringValue", make_string(value));
+    add_attribute(attributes, key, std::move(v));
+}
+
+static void add_int_attribute(rjson::value& attributes, std::string_view key, int64_t value) {
+    auto v = rjson::empty_object();
+    // int64 values are encoded as strings in OTLP/JSON
+    rjson::add(v, "intValue", make_string(fmt::format("{}", value)));
+    add_attribute(attributes, key, std::move(v));
+}
+
+static sstring trace_id(const utils::UUID& session_id) {
+    return format("{:016x}{:016x}", uint64_t(session_id.get_most_significant_bits()), uint64_t(session_id.get_least_significant_bits()));
+}
+
+static sstring span_id_hex(span_id id) {
+    return format("{:016x}", id.get_id());
+}
+
+rjson::value otlp::make_span(const utils::UUID& session_id, span_id parent_id, span_id id, const session_record& session,
+        bool slow_query, std::deque<event_record> events) {
+    auto span = rjson::empty_object();
+    rjson::add(span, "traceId", make_string(trace_id(session_id)));
+    rjson::add(span, "spanId", make_string(span_id_hex(id)));
+    if (parent_id.get_id() != span_id::illegal_id) {
+        rjson::add(span, "parentSpanId", make_string(span_id_hex(parent_id)));
+    }
+
+    auto attributes = rjson::empty_array();
+    std::chrono::system_clock::time_point start, end;
+    if (session.ready()) {
+        rjson::add(span, "name", make_string(session.request));
+        rjson::add(span, "kind", span_kind_server);
+        start = session.started_at;
+        end = start + std::chrono::duration_cast<std::chrono::system_clock::duration>(session.elapsed);
+        add_string_attribute(attributes, "scylla.command", type_to_string(session.command));
+        add_string_attribute(attributes, "client.address", fmt::format("{}", session.client));
+        add_string_attribute(attributes, "db.user", session.username);
+        add_int_attribute(attributes, "scylla.request_size", session.request_size);
+        add_int_attribute(attributes, "scylla.response_size", session.response_size);
+        if (!session.tables.empty()) {
+            add_string_attribute(attributes, "db.sql.table", fmt::format("{}", fmt::join(session.tables, ",")));
+        }
+        for (const auto& [name, value] : session.parameters) {
+            add_string_attribute(attributes, format("scylla.parameter.{}", name), value);
+        }
+        if (slow_query) {
+            add_string_attribute(attributes, "scylla.slow_query", "true");
+        }
+    } else {
+        rjson::add(span, "name", make_string("replica"));
+        rjson::add(span, "kind", span_kind_internal);
+        // Event records hold the time elapsed since the session started.
+        start = end = std::chrono::system_clock::now();
+        if (!events.empty()) {
+            start = events.front().event_time_point - std::chrono::duration_cast<std::chrono::system_clock::duration>(events.front().elapsed);
+            end = events.back().event_time_point;
+        }
+    }
+    add_string_attribute(attributes, "net.host.name", fmt::format("{}", utils::fb_utilities::get_broadcast_address()));
+    add_int_attribute(attributes, "scylla.shard", this_shard_id());
+    rjson::add(span, "startTimeUnixNano", make_nanos(start));
+    rjson::add(span, "endTimeUnixNano", make_nanos(end));
+    rjson::add(span, "attributes", std::move(attributes));
+
+    auto span_events = rjson::empty_array();
+    for (const auto& e : events) {
+        auto event = rjson::empty_object();
+        rjson::add(event, "timeUnixNano", make_nanos(e.event_time_point));
+        rjson::add(event, "name", make_string(e.message));
+        rjson::push_back(span_events, std::move(event));
+    }
+    rjson::add(span, "events", std::move(span_events));
+    return span;
+}
+
+static rjson::value make_span(const one_session_records& records, span_id id, std::deque<event_record> events) {
+    return otlp::make_span(records.session_id, records.parent_id, id, records.session_rec, records.do_log_slow_query, std::move(events));
+}
+
+rjson::value otlp::make_export_request(std::deque<rjson::value> spans) {
+    auto json_spans = rjson::empty_array();
+    for (auto& span : spans) {
+        rjson::push_back(json_spans, std::move(span));
+    }
+
+    auto scope = rjson::empty_object();
+    rjson::add(scope, "name", make_string("scylla.tracing"));
+    auto scope_spans = rjson::empty_object();
+    rjson::add(scope_spans, "scope", std::move(scope));
+    rjson::add(scope_spans, "spans", std::move(json_spans));
+    auto scope_spans_array = rjson::empty_array();
+    rjson::push_back(scope_spans_array, std::move(scope_spans));
+
+    auto resource_attributes = rjson::empty_array();
+    add_string_attribute(resource_attributes, "service.name", "scylla");
+    auto resource = rjson::empty_object();
+    rjson::add(resource, "attributes", std::move(resource_attributes));
+    auto resource_spans = rjson::empty_object();
+    rjson::add(resource_spans, "resource", std::move(resource));
+    rjson::add(resource_spans, "scopeSpans", std::move(scope_spans_array));
+    auto resource_spans_array = rjson::empty_array();
+    rjson::push_back(resource_spans_array, std::move(resource_spans));
+    auto body = rjson::empty_object();
+    rjson::add(body, "resourceSpans", std::move(resource_spans_array));
+    return body;
+}
+
+otlp_exporter::otlp_exporter(tracing& tr)
+    : i_tracing_backend_helper(tr)
+{}
+
+future<> otlp_exporter::start(cql3::query_processor& qp, service::migration_manager& mm) {
+    const auto& cfg = qp.db().get_config();
+    auto address = otlp::parse_collector_address(cfg.tracing_otlp_collector_address(), default_port);
+    _host = address.authority();
+    _max_buffered_spans = cfg.tracing_otlp_max_buffered_spans();
+    _http.emplace(std::make_unique<utils::http::dns_connection_factory>(std::string(address.host), address.port, false, otlp_logger), 1);
+
+    namespace sm = seastar::metrics;
+    _metrics.add_group("tracing_otlp_exporter", {
+        sm::make_counter("exported_spans", [this] { return _stats.exported_spans; },
+                        sm::description("Counts the spans sent to the OpenTelemetry collector.")),
+
+        sm::make_counter("dropped_spans", [this] { return _stats.dropped_spans; },
+                        sm::description("Counts the spans dropped because too many spans were waiting to be sent, "
+                                        "e.g. because the OpenTelemetry collector is slow or unavailable.")),
+
+        sm::make_counter("export_errors", [this] { return _stats.export_errors; },
+                        sm::description("Counts the failed attempts to send a batch of spans. The spans of a failed batch are lost.")),
+    });
+
+    otlp_logger.info("Exporting tracing spans to {}", _host);
+    co_return;
+}
+
+future<> otlp_exporter::shutdown() {
+    co_await _pending_exports.close();
+    if (_http) {
+        co_await _http->close();
+    }
+}
+
+void otlp_exporter::write_records_bulk(records_bulk& bulk) {
+    for (auto& records : bulk) {
+        auto& state = static_cast<otlp_session_state&>(*records->backend_state_ptr);
+        std::move(records->events_recs.begin(), records->events_recs.end(), std::back_inserter(state.events));
+        records->events_recs.clear();
+        bool session_record_is_ready = records->session_rec.ready();
+        bool is_replica = records->parent_id.get_id() != span_id::illegal_id;
+
+        try {
+            if (session_record_is_ready) {
+                buffer_span(make_span(*records, records->my_span_id, std::move(state.events)));
+            } else if (is_replica && !state.events.empty()) {
+                // A replica's session doesn't report when it's over, so each batch
+                // of its events becomes a span. Batches after the first get their
+                // own span IDs, since span IDs have to be unique within a trace.
+                auto id = state.exported_spans ? span_id::make_span_id() : records->my_span_id;
+                buffer_span(make_span(*records, id, std::move(state.events)));
+                ++state.exported_spans;
+            }
+        } catch (...) {
+            otlp_logger.debug("{}: failed to make a span: {}", records->session_id, std::current_exception());
+            ++_stats.dropped_spans;
+        }
+        if (session_record_is_ready || is_replica) {
+            state.events.clear();
+        }
+
+        records->data_consumed();
+    }
+
+    maybe_export();
+}
+
+std::unique_ptr<backend_session_state_base> otlp_exporter::allocate_session_state() const {
+    return std::make_unique<otlp_session_state>();
+}
+
+void otlp_exporter::buffer_span(rjson::value span) {
+    if (_spans.size() >= _max_buffered_spans) {
+        ++_stats.dropped_spans;
+        return;
+    }
+    _spans.push_back(std::move(span));
+}
+
+void otlp_exporter::maybe_export() {
+    if (_exporting || _spans.empty() || _pending_exports.is_closed()) {
+        return;
+    }
+    _exporting = true;
+    (void)with_gate(_pending_exports, [this] {
+        return export_spans(std::exchange(_spans, {})).finally([this] {
+            _exporting = false;
+            // Spans buffered while the previous batch was being sent
+            maybe_export();
+        });
+    });
+}
+
+future<> otlp_exporter::export_spans(std::deque<rjson::value> spans) {
+    auto count = spans.size();
+    std::exception_ptr ex;
+    try {
+        auto body = otlp::make_export_request(std::move(spans));
+        auto req = http::request::make("POST", _host, sstring(traces_path));
+        req.write_body("json", sstring(rjson::print(body)));
+        co_await _http->make_request(std::move(req), [] (const http::reply& rep, input_stream<char>&& in_) -> future<> {
+            auto in = std::move(in_);
+            co_await util::skip_entire_stream(in);
+        }, http::reply::status_type::ok);
+        _stats.exported_spans += count;
+        co_return;
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    ++_stats.export_errors;
+    static thread_local logger::rate_limit rate_limit(std::chrono::seconds(30));
+    otlp_logger.log(log_level::warn, rate_limit, "Failed to export {} spans: {}", count, ex);
+}
+
+using registry = class_registrator<i_tracing_backend_helper, otlp_exporter, tracing&>;
+static registry registrator("otlp_exporter");
+
+}
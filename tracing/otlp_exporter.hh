@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/http/client.hh>
+#include "tracing/tracing.hh"
+#include "utils/rjson.hh"
+
+namespace tracing {
+
+namespace otlp {
+
+// The address of the collector, as set in tracing_otlp_collector_address:
+// a host name, an IPv4 address or an IPv6 address in brackets, optionally
+// followed by ":port". An IPv6 address without a port may also be given
+// without brackets.
+struct collector_address {
+    sstring host;
+    uint16_t port;
+
+    // The address in the form of the HTTP Host header.
+    sstring authority() const;
+};
+
+// Throws std::invalid_argument if the address is malformed.
+collector_address parse_collector_address(std::string_view address, uint16_t default_port);
+
+// Returns the span of a tracing session with the given events.
+rjson::value make_span(const utils::UUID& session_id, span_id parent_id, span_id id, const session_record& session,
+        bool slow_query, std::deque<event_record> events);
+
+// Returns the body of an OTLP/JSON export request with the given spans.
+rjson::value make_export_request(std::deque<rjson::value> spans);
+
+}
+
+// A tracing backend which, instead of writing the records into the
+// system_traces keyspace, exports them as spans to an OpenTelemetry collector,
+// using OTLP over HTTP with the JSON encoding.
+//
+// Each tracing session becomes a span of the trace identified by the session
+// ID. The coordinator's session becomes a span once the session is over, and
+// a replica's session becomes a span each time its records are written.
+// Spans are buffered per shard, up to a configured limit beyond which new
+// spans are dropped, and are sent in batches, one request at a time, so that
+// a slow or unavailable collector doesn't turn tracing into a load of its own.
+//
+// Which requests are traced is decided exactly like for other backends: by
+// the tracing probability (head-based sampling) and by slow query logging,
+// whose records are only written for requests slower than the threshold
+// (tail-based sampling).
+class otlp_exporter final : public i_tracing_backend_helper {
+public:
+    static constexpr std::string_view traces_path = "/v1/traces";
+    static constexpr uint16_t default_port = 4318;
+
+private:
+    seastar::gate _pending_exports;
+    std::optional<seastar::http::experimental::client> _http;
+    sstring _host;
+    size_t _max_buffered_spans = 0;
+    // Spans waiting for the next export.
+    std::deque<rjson::value> _spans;
+    bool _exporting = false;
+
+    struct stats {
+        uint64_t exported_spans = 0;
+        uint64_t dropped_spans = 0;
+        uint64_t export_errors = 0;
+    } _stats;
+
+    seastar::metrics::metric_groups _metrics;
+
+public:
+    otlp_exporter(tracing& tr);
+
+    virtual future<> start(cql3::query_processor& qp, service::migration_manager& mm) override;
+    virtual future<> shutdown() override;
+
+    virtual void write_records_bulk(records_bulk& bulk) override;
+    virtual std::unique_ptr<backend_session_state_base> allocate_session_state() const override;
+
+private:
+    void buffer_span(rjson::value span);
+
+    // Starts sending the buffered spans, unless an export is already in progress.
+    void maybe_export();
+
+    future<> export_spans(std::deque<rjson::value> spans);
+};
+
+}
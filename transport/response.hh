@@ -34,10 +34,20 @@ enum class cql_binary_opcode : uint8_t {
 };
 
 class response {
+public:
+    // Bodies smaller than this are sent uncompressed even when compression was
+    // negotiated. The compression flag is set per frame, and for small bodies the
+    // compression overhead outweighs the few bytes it might save.
+    static constexpr size_t min_compressed_body_size = 256;
+private:
     int16_t           _stream;
     cql_binary_opcode _opcode;
     uint8_t           _flags = 0; // a bitwise OR mask of zero or more cql_frame_flags values
     bytes_ostream _body;
+    // Latencies of the stages of the request which happen where the response
+    // is produced, possibly on another shard, for the server's metrics.
+    std::chrono::steady_clock::duration _prepared_lookup_time{};
+    std::chrono::steady_clock::duration _serialization_time{};
 public:
     template<typename T>
     class placeholder;
@@ -88,6 +98,19 @@ class response {
     size_t size() const {
         return _body.size();
     }
+
+    void set_prepared_lookup_time(std::chrono::steady_clock::duration d) noexcept {
+        _prepared_lookup_time = d;
+    }
+    std::chrono::steady_clock::duration prepared_lookup_time() const noexcept {
+        return _prepared_lookup_time;
+    }
+    void set_serialization_time(std::chrono::steady_clock::duration d) noexcept {
+        _serialization_time = d;
+    }
+    std::chrono::steady_clock::duration serialization_time() const noexcept {
+        return _serialization_time;
+    }
 private:
     void compress(cql_compression compression);
     void compress_lz4();
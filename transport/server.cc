@@ -64,6 +64,7 @@
 #include "utils/bit_cast.hh"
 #include "db/config.hh"
 #include "utils/reusable_buffer.hh"
+#include "utils/histogram_metrics_helper.hh"
 
 template<typename T = void>
 using coordinator_result = exceptions::coordinator_result<T>;
@@ -146,6 +147,19 @@ sstring to_string(cql_binary_opcode op) {
     return format("Unknown CQL binary opcode {}", static_cast<unsigned>(op));
 }
 
+static sstring to_string(cql_sg_stats::request_stage stage) {
+    using request_stage = cql_sg_stats::request_stage;
+    switch (stage) {
+    case request_stage::read:            return "read";
+    case request_stage::prepared_lookup: return "prepared_lookup";
+    case request_stage::process:         return "process";
+    case request_stage::serialize:       return "serialize";
+    case request_stage::write:           return "write";
+    case request_stage::count:           break;
+    }
+    return format("Unknown request stage {}", static_cast<unsigned>(stage));
+}
+
 sstring to_string(const event::status_change::status_type t) {
     using type = event::status_change::status_type;
     switch (t) {
@@ -224,6 +238,15 @@ void cql_sg_stats::register_metrics()
                                  sm::description("Counts the total number of sent response bytes for CQL requests of a specific kind."),
                                  {{"kind", to_string(opcode)}, {"scheduling_group_name", cur_sg_name}}).set_skip_when_empty()
         );
+
+        for (uint8_t s = 0; s < static_cast<uint8_t>(request_stage::count); ++s) {
+            transport_metrics.emplace_back(
+                    sm::make_histogram("cql_request_stage_latency", [this, opcode, s] { return to_metrics_histogram(get_cql_opcode_stats(opcode).stage_latency[s]); },
+                                     sm::description("Latency histogram, in microseconds, of a stage of serving CQL requests of a specific kind. "
+                                                     "The process stage includes the prepared_lookup and serialize ones."),
+                                     {{"kind", to_string(opcode)}, {"stage", to_string(request_stage(s))}, {"scheduling_group_name", cur_sg_name}}).set_skip_when_empty()
+            );
+        }
     }
 
     _metrics.add_group("transport", std::move(transport_metrics));
@@ -267,6 +290,14 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
                         sm::description(
                             seastar::format("Holds an incrementing counter with the requests that ever blocked due to reaching the memory quota limit ({}B). "
                                             "The first derivative of this value shows how often we block due to memory exhaustion in the \"CQL transport\" component.", _max_request_size))),
+        sm::make_counter("response_flushes", _stats.response_flushes,
+                        sm::description("Holds an incrementing counter with the flushes of responses to client connections. "
+                                            "Responses which complete together are written with a single flush, so requests_served divided by this value is the average number of responses per flush.")),
+        sm::make_counter("requests_bounced", _stats.requests_bounced,
+                        sm::description("Holds an incrementing counter with the requests that had to be moved to another shard to be executed, e.g. LWT requests sent to a shard which does not own the partition.")),
+        sm::make_counter("requests_bounced_time_us", _stats.requests_bounced_time_us,
+                        sm::description("Holds an incrementing counter with the time, in microseconds, that requests spent on the shard which received them before being moved to another shard. "
+                                            "Divided by requests_bounced, it gives the average cost of a bounce.")),
         sm::make_counter("requests_shed", _stats.requests_shed,
                         sm::description("Holds an incrementing counter with the requests that were shed due to overload (threshold configured via max_concurrent_requests_per_shard). "
                                             "The first derivative of this value shows how often we shed requests due to overload in the \"CQL transport\" component.")),
@@ -425,6 +456,7 @@ future<foreign_ptr<std::unique_ptr<cql_server::response>>>
 
     auto linearization_buffer = std::make_unique<bytes_ostream>();
     auto linearization_buffer_ptr = linearization_buffer.get();
+    auto process_start = std::chrono::steady_clock::now();
     return futurize_invoke([this, cqlop, stream, &fbuf, &client_state, linearization_buffer_ptr, permit = std::move(permit), trace_state] () mutable {
         // When using authentication, we need to ensure we are doing proper state transitions,
         // i.e. we cannot simply accept any query/exec ops unless auth is complete
@@ -466,7 +498,7 @@ future<foreign_ptr<std::unique_ptr<cql_server::response>>>
         case cql_binary_opcode::REGISTER:      return wrap_in_foreign(process_register(stream, std::move(in), client_state, trace_state));
         default:                               throw exceptions::protocol_exception(format("Unknown opcode {:d}", int(cqlop)));
         }
-    }).then_wrapped([this, cqlop, &cql_stats, stream, &client_state, linearization_buffer = std::move(linearization_buffer), trace_state] (future<result_with_foreign_response_ptr> f) {
+    }).then_wrapped([this, cqlop, &cql_stats, stream, &client_state, linearization_buffer = std::move(linearization_buffer), trace_state, process_start] (future<result_with_foreign_response_ptr> f) {
         auto stop_trace = defer([&] {
             tracing::stop_foreground(trace_state);
         });
@@ -508,6 +540,13 @@ future<foreign_ptr<std::unique_ptr<cql_server::response>>>
 
             tracing::set_response_size(trace_state, response->size());
             cql_stats.response_size += response->size();
+            cql_stats.add_stage_latency(cql_sg_stats::request_stage::process, std::chrono::steady_clock::now() - process_start);
+            if (cqlop == cql_binary_opcode::EXECUTE || cqlop == cql_binary_opcode::BATCH) {
+                cql_stats.add_stage_latency(cql_sg_stats::request_stage::prepared_lookup, response->prepared_lookup_time());
+            }
+            if (res_op == cql_binary_opcode::RESULT) {
+                cql_stats.add_stage_latency(cql_sg_stats::request_stage::serialize, response->serialization_time());
+            }
             return response;
         },  utils::result_catch<exceptions::unavailable_exception>([&] (const auto& ex) {
             clogger.debug("{}: request resulted in unavailable_error, stream {}, code {}, message [{}]",
@@ -740,7 +779,13 @@ future<> cql_server::connection::process_request() {
               return make_ready_future<>();
           }
           semaphore_units<> mem_permit = mem_permit_fut.get0();
-          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit))] (fragmented_temporary_buffer buf) mutable {
+          auto read_start = std::chrono::steady_clock::now();
+          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit)), read_start] (fragmented_temporary_buffer buf) mutable {
+            // Unknown opcodes are rejected by process_request_one().
+            auto* cql_stats = op < uint8_t(cql_binary_opcode::OPCODES_COUNT) ? &_server.get_cql_opcode_stats(cql_binary_opcode(op)) : nullptr;
+            if (cql_stats) {
+                cql_stats->add_stage_latency(cql_sg_stats::request_stage::read, std::chrono::steady_clock::now() - read_start);
+            }
 
             ++_server._stats.requests_served;
             ++_server._stats.requests_serving;
@@ -765,7 +810,7 @@ future<> cql_server::connection::process_request() {
                     _process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit) :
                     process_request_one(istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit);
 
-            future<> request_response_future = request_process_future.then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave), stream] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+            future<> request_response_future = request_process_future.then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave), stream, cql_stats] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
                 try {
                     if (response_f.failed()) {
                         const auto message = format("request processing failed, error [{}]", response_f.get_exception());
@@ -774,7 +819,7 @@ future<> cql_server::connection::process_request() {
                                                   message,
                                                   tracing::trace_state_ptr()));
                     } else {
-                        write_response(response_f.get0(), std::move(mem_permit), _compression);
+                        write_response(response_f.get0(), std::move(mem_permit), _compression, cql_stats);
                     }
                     _ready_to_respond = _ready_to_respond.finally([leave = std::move(leave)] {});
                 } catch (...) {
@@ -988,13 +1033,16 @@ future<cql_server::result_with_foreign_response_ptr>
 cql_server::connection::process(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit,
         tracing::trace_state_ptr trace_state, Process process_fn) {
     fragmented_temporary_buffer::istream is = in.get_stream();
+    auto start = std::chrono::steady_clock::now();
 
     return process_fn(client_state, _server._query_processor, in, stream,
             _version, permit, trace_state, true, {})
-            .then([stream, &client_state, this, is, permit, process_fn, trace_state]
+            .then([stream, &client_state, this, is, permit, process_fn, trace_state, start]
                    (process_fn_return_type msg) mutable {
         auto* bounce_msg = std::get_if<shared_ptr<messages::result_message::bounce_to_shard>>(&msg);
         if (bounce_msg) {
+            ++_server._stats.requests_bounced;
+            _server._stats.requests_bounced_time_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
             return process_on_shard(*bounce_msg, stream, is, client_state, std::move(permit), trace_state, process_fn);
         }
         auto ptr = std::get<cql_server::result_with_foreign_response_ptr>(std::move(msg));
@@ -1043,25 +1091,39 @@ cql_server::connection::process_query(uint16_t stream, request_reader in, servic
     return process(stream, in, client_state, std::move(permit), std::move(trace_state), process_query_internal);
 }
 
-future<std::unique_ptr<cql_server::response>> cql_server::connection::process_prepare(uint16_t stream, request_reader in, service::client_state& client_state,
-        tracing::trace_state_ptr trace_state) {
-
-    auto query = sstring(in.read_long_string_view());
-
-    tracing::add_query(trace_state, query);
-    tracing::begin(trace_state, "Preparing CQL3 query", client_state.get_client_address());
-
+future<> cql_server::prepare_on_other_shards(const sstring& query, const service::client_state& client_state) {
+    auto key = cql3::query_processor::compute_id(query, client_state.get_raw_keyspace());
+    if (auto it = _preparing_on_other_shards.find(key); it != _preparing_on_other_shards.end()) {
+        return it->second.get_future();
+    }
     auto cpu_id = this_shard_id();
     auto cpus = boost::irange(0u, smp::count);
-    return parallel_for_each(cpus.begin(), cpus.end(), [this, query, cpu_id, &client_state] (unsigned int c) mutable {
+    auto f = parallel_for_each(cpus.begin(), cpus.end(), [this, query, cpu_id, &client_state] (unsigned int c) mutable {
         if (c != cpu_id) {
             return smp::submit_to(c, [this, query, &client_state] () mutable {
-                return _server._query_processor.local().prepare(std::move(query), client_state, false).discard_result();
+                return _query_processor.local().prepare(std::move(query), client_state, false).discard_result();
             });
         } else {
             return make_ready_future<>();
         }
-    }).then([this, query, stream, &client_state, trace_state] () mutable {
+    }).finally([this, key] {
+        _preparing_on_other_shards.erase(key);
+    });
+    if (f.available()) {
+        return f;
+    }
+    return _preparing_on_other_shards.emplace(key, shared_future<>(std::move(f))).first->second.get_future();
+}
+
+future<std::unique_ptr<cql_server::response>> cql_server::connection::process_prepare(uint16_t stream, request_reader in, service::client_state& client_state,
+        tracing::trace_state_ptr trace_state) {
+
+    auto query = sstring(in.read_long_string_view());
+
+    tracing::add_query(trace_state, query);
+    tracing::begin(trace_state, "Preparing CQL3 query", client_state.get_client_address());
+
+    return _server.prepare_on_other_shards(query, client_state).then([this, query, stream, &client_state, trace_state] () mutable {
         tracing::trace(trace_state, "Done preparing on remote shards");
         return _server._query_processor.local().prepare(std::move(query), client_state, false).then([this, stream, trace_state] (auto msg) {
             tracing::trace(trace_state, "Done preparing on a local shard - preparing a result. ID is [{}]", seastar::value_of([&msg] {
@@ -1082,11 +1144,13 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
 
     // First, try to lookup in the cache of already authorized statements. If the corresponding entry is not found there
     // look for the prepared statement and then authorize it.
+    auto lookup_start = std::chrono::steady_clock::now();
     auto prepared = qp.local().get_prepared(client_state.user(), cache_key);
     if (!prepared) {
         needs_authorization = true;
         prepared = qp.local().get_prepared(cache_key);
     }
+    auto lookup_time = std::chrono::steady_clock::now() - lookup_start;
 
     if (!prepared) {
         throw exceptions::prepared_query_not_found_exception(id);
@@ -1130,14 +1194,16 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
 
     tracing::trace(trace_state, "Processing a statement");
     return qp.local().execute_prepared_without_checking_exception_message(query_state, std::move(stmt), options, std::move(prepared), std::move(cache_key), needs_authorization)
-            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version] (auto msg) {
+            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version, lookup_time] (auto msg) {
         if (msg->move_to_shard()) {
             return process_fn_return_type(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg));
         } else if (msg->is_exception()) {
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            auto response = make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata);
+            response->set_prepared_lookup_time(lookup_time);
+            return process_fn_return_type(make_foreign(std::move(response)));
         }
     });
 }
@@ -1165,6 +1231,8 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
         tracing::begin(trace_state, "Execute batch of CQL3 queries", client_state.get_client_address());
     }
 
+    std::chrono::steady_clock::duration lookup_time{};
+
     for ([[gnu::unused]] auto i : boost::irange(0u, n)) {
         const auto kind = in.read_byte();
 
@@ -1188,6 +1256,7 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
 
             // First, try to lookup in the cache of already authorized statements. If the corresponding entry is not found there
             // look for the prepared statement and then authorize it.
+            auto lookup_start = std::chrono::steady_clock::now();
             ps = qp.local().get_prepared(client_state.user(), cache_key);
             if (!ps) {
                 ps = qp.local().get_prepared(cache_key);
@@ -1197,6 +1266,7 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
                 // authorize a particular prepared statement only once
                 needs_authorization = pending_authorization_entries.emplace(std::move(cache_key), ps->checked_weak_from_this()).second;
             }
+            lookup_time += std::chrono::steady_clock::now() - lookup_start;
             if (init_trace) {
                 tracing::add_query(trace_state, ps->statement->raw_cql_statement);
             }
@@ -1251,14 +1321,16 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
 
     auto batch = ::make_shared<cql3::statements::batch_statement>(cql3::statements::batch_statement::type(type), std::move(modifications), cql3::attributes::none(), qp.local().get_cql_stats());
     return qp.local().execute_batch_without_checking_exception_message(batch, query_state, options, std::move(pending_authorization_entries))
-            .then([stream, batch, q_state = std::move(q_state), trace_state = query_state.get_trace_state(), version] (auto msg) {
+            .then([stream, batch, q_state = std::move(q_state), trace_state = query_state.get_trace_state(), version, lookup_time] (auto msg) {
         if (msg->move_to_shard()) {
             return process_fn_return_type(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg));
         } else if (msg->is_exception()) {
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, trace_state, version)));
+            auto response = make_result(stream, *msg, trace_state, version);
+            response->set_prepared_lookup_time(lookup_time);
+            return process_fn_return_type(make_foreign(std::move(response)));
         }
     });
 }
@@ -1534,6 +1606,7 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
 std::unique_ptr<cql_server::response>
 make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
         cql_protocol_version_type version, bool skip_metadata) {
+    auto start = std::chrono::steady_clock::now();
     auto response = std::make_unique<cql_server::response>(stream, cql_binary_opcode::RESULT, tr_state);
     if (__builtin_expect(!msg.warnings().empty() && version > 3, false)) {
         response->set_frame_flag(cql_frame_flags::warning);
@@ -1541,6 +1614,7 @@ make_result(int16_t stream, messages::result_message& msg, const tracing::trace_
     }
     cql_server::fmt_visitor fmt{version, *response, skip_metadata};
     msg.accept(fmt);
+    response->set_serialization_time(std::chrono::steady_clock::now() - start);
     return response;
 }
 
@@ -1573,19 +1647,32 @@ cql_server::connection::make_schema_change_event(const event::schema_change& eve
     return response;
 }
 
-void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit, cql_compression compression)
+void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit, cql_compression compression,
+        cql_sg_stats::request_kind_stats* stats)
 {
-    _ready_to_respond = _ready_to_respond.then([this, compression, response = std::move(response), permit = std::move(permit)] () mutable {
+    // Responses are written in order, and the flush is left to the last one queued,
+    // so that responses completing together reach the socket in a single write.
+    ++_pending_responses;
+    auto write_start = std::chrono::steady_clock::now();
+    _ready_to_respond = _ready_to_respond.then([this, compression, response = std::move(response), permit = std::move(permit), stats, write_start] () mutable {
         auto message = response->make_message(_version, compression);
         message.on_delete([response = std::move(response)] { });
         return _write_buf.write(std::move(message)).then([this] {
+            if (--_pending_responses) {
+                return make_ready_future<>();
+            }
+            ++_server._stats.response_flushes;
             return _write_buf.flush();
+        }).then([stats, write_start] {
+            if (stats) {
+                stats->add_stage_latency(cql_sg_stats::request_stage::write, std::chrono::steady_clock::now() - write_start);
+            }
         });
     });
 }
 
 scattered_message<char> cql_server::response::make_message(uint8_t version, cql_compression compression) {
-    if (compression != cql_compression::none) {
+    if (compression != cql_compression::none && _body.size() >= min_compressed_body_size) {
         compress(compression);
     }
     scattered_message<char> msg;
@@ -25,10 +25,12 @@
 #include <seastar/core/sharded.hh>
 #include <seastar/core/execution_stage.hh>
 #include "utils/updateable_value.hh"
+#include "utils/estimated_histogram.hh"
 #include "generic_server.hh"
 #include "service/query_state.hh"
 #include "cql3/query_options.hh"
 #include "transport/messages/result_message.hh"
+#include "cql3/prepared_statements_cache.hh"
 #include "utils/chunked_vector.hh"
 #include "exceptions/coordinator_result.hh"
 #include "db/operation_type.hh"
@@ -115,10 +117,28 @@ struct cql_server_config {
  * CQL op-code stats collected for each scheduling group
  */
 struct cql_sg_stats {
+    // Stages of serving a request, whose latency is tracked per kind of request.
+    enum class request_stage : uint8_t {
+        read,               // reading and decompressing the request frame
+        prepared_lookup,    // looking up prepared statements (EXECUTE and BATCH)
+        process,            // producing the response, including the lookup and serialization
+        serialize,          // serializing the result into the response
+        write,              // writing the response to the socket
+        count,
+    };
+
+    // Microsecond resolution, from 16us to 33s.
+    using stage_latency_histogram = utils::approx_exponential_histogram<16, 33554432, 4>;
+
     struct request_kind_stats {
         uint64_t count = 0;
         uint64_t request_size = 0;
         uint64_t response_size = 0;
+        std::array<stage_latency_histogram, static_cast<size_t>(request_stage::count)> stage_latency;
+
+        void add_stage_latency(request_stage stage, std::chrono::steady_clock::duration d) noexcept {
+            stage_latency[static_cast<size_t>(stage)].add(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+        }
     };
 
     cql_sg_stats();
@@ -139,6 +159,9 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         uint32_t requests_serving = 0;
         uint64_t requests_blocked_memory = 0;
         uint64_t requests_shed = 0;
+        uint64_t response_flushes = 0;
+        uint64_t requests_bounced = 0;
+        uint64_t requests_bounced_time_us = 0;
 
         std::unordered_map<exceptions::exception_code, uint64_t> errors;
     };
@@ -160,6 +183,11 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
     qos::service_level_controller& _sl_controller;
     gms::gossiper& _gossiper;
     scheduling_group_key _stats_key;
+    // Statements being prepared on the other shards on behalf of a PREPARE
+    // request received on this shard. Concurrent PREPAREs of the same
+    // statement, e.g. from all clients re-preparing after a restart, wait for
+    // the preparation in progress instead of starting their own.
+    std::unordered_map<cql3::prepared_cache_key_type, shared_future<>> _preparing_on_other_shards;
 public:
     cql_server(distributed<cql3::query_processor>& qp, auth::service&,
             service::memory_limiter& ml,
@@ -179,6 +207,8 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
 
     future<utils::chunked_vector<client_data>> get_client_data();
 private:
+    future<> prepare_on_other_shards(const sstring& query, const service::client_state& client_state);
+
     class fmt_visitor;
     friend class connection;
     friend std::unique_ptr<cql_server::response> make_result(int16_t stream, messages::result_message& msg,
@@ -196,6 +226,8 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         unsigned _request_cpu = 0;
         bool _ready = false;
         bool _authenticating = false;
+        // Responses queued on _ready_to_respond and not yet written.
+        unsigned _pending_responses = 0;
 
         enum class tracing_request_type : uint8_t {
             not_requested,
@@ -268,7 +300,9 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         process_on_shard(::shared_ptr<messages::result_message::bounce_to_shard> bounce_msg, uint16_t stream, fragmented_temporary_buffer::istream is, service::client_state& cs,
                 service_permit permit, tracing::trace_state_ptr trace_state, Process process_fn);
 
-        void write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit = empty_service_permit(), cql_compression compression = cql_compression::none);
+        // If `stats` is given, the time until the response is written is recorded there.
+        void write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit = empty_service_permit(), cql_compression compression = cql_compression::none,
+                cql_sg_stats::request_kind_stats* stats = nullptr);
 
         friend event_notifier;
     };
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <csignal>
+#include <unistd.h>
+
+#include <seastar/core/posix.hh>
+
+#include "utils/alien_worker.hh"
+
+namespace utils {
+
+alien_worker::alien_worker(unsigned threads, int niceness, seastar::logger& log) {
+    _threads.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        _threads.emplace_back([this, &log, niceness] { run(log, niceness); });
+    }
+}
+
+alien_worker::~alien_worker() {
+    for (size_t i = 0; i < _threads.size(); ++i) {
+        push(std::nullopt);
+    }
+    for (auto& t : _threads) {
+        t.join();
+    }
+}
+
+void alien_worker::push(std::optional<seastar::noncopyable_function<void() noexcept>> item) {
+    std::unique_lock lock(_mutex);
+    _pending.push(std::move(item));
+    lock.unlock();
+    _cv.notify_one();
+}
+
+void alien_worker::run(seastar::logger& log, int niceness) {
+    sigset_t mask;
+    sigfillset(&mask);
+    auto r = ::pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+    seastar::throw_pthread_error(r);
+
+    errno = 0;
+    int nice_value = nice(niceness);
+    if (nice_value == -1 && errno != 0) {
+        log.warn("Unable to renice an alien worker thread (system error number {}); the thread will compete with reactor. Try adding CAP_SYS_NICE", errno);
+    }
+
+    for (;;) {
+        std::unique_lock lock(_mutex);
+        _cv.wait(lock, [this] { return !_pending.empty(); });
+        auto item = std::move(_pending.front());
+        _pending.pop();
+        lock.unlock();
+        if (!item) {
+            break;
+        }
+        (*item)();
+    }
+}
+
+}
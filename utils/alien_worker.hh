@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <seastar/core/alien.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/util/log.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+namespace utils {
+
+// A pool of threads outside of the reactor, running functions which can't
+// be preempted and would stall it otherwise, e.g. password hashing.
+// The threads are niced, so they yield to the reactor threads.
+//
+// The result of a function is delivered to the shard which submitted it.
+// Submitting shards must not stop until their submissions are resolved.
+class alien_worker {
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    // Disengaged items stop the threads.
+    std::queue<std::optional<seastar::noncopyable_function<void() noexcept>>> _pending;
+    std::vector<std::thread> _threads;
+
+    void push(std::optional<seastar::noncopyable_function<void() noexcept>> item);
+    void run(seastar::logger& log, int niceness);
+
+public:
+    alien_worker(unsigned threads, int niceness, seastar::logger& log);
+    ~alien_worker();
+
+    alien_worker(const alien_worker&) = delete;
+    alien_worker& operator=(const alien_worker&) = delete;
+
+    template <typename Func>
+    requires std::is_invocable_v<Func> && (!std::is_void_v<std::invoke_result_t<Func>>)
+    seastar::future<std::invoke_result_t<Func>> submit(Func func) {
+        using result_type = std::invoke_result_t<Func>;
+        // The promise stays in the coroutine frame, it is never moved by
+        // the worker thread.
+        seastar::promise<result_type> pr;
+        auto fut = pr.get_future();
+        push([&pr, func = std::move(func), &alien = seastar::engine().alien(), shard = seastar::this_shard_id()] () mutable noexcept {
+            try {
+                seastar::alien::run_on(alien, shard, [&pr, result = func()] () mutable noexcept {
+                    pr.set_value(std::move(result));
+                });
+            } catch (...) {
+                seastar::alien::run_on(alien, shard, [&pr, ex = std::current_exception()] () mutable noexcept {
+                    pr.set_exception(std::move(ex));
+                });
+            }
+        });
+        co_return co_await std::move(fut);
+    }
+};
+
+}
@@ -8,6 +8,8 @@
 
 
 #include "array-search.hh"
+#include <cstring>
+#include <string_view>
 #ifdef __x86_64__
 #include <x86intrin.h>
 #define arch_target(name) [[gnu::target(name)]]
@@ -52,6 +54,16 @@ arch_target("default") unsigned array_search_x32_eq_impl(uint8_t val, const uint
     return array_search_eq_impl(val, arr, 32 * nr);
 }
 
+static inline size_t array_search_substring_scalar(const uint8_t* haystack, size_t haystack_size, const uint8_t* needle, size_t needle_size) {
+    auto h = std::string_view(reinterpret_cast<const char*>(haystack), haystack_size);
+    auto pos = h.find(std::string_view(reinterpret_cast<const char*>(needle), needle_size));
+    return pos == std::string_view::npos ? haystack_size : pos;
+}
+
+arch_target("default") size_t array_search_substring_impl(const uint8_t* haystack, size_t haystack_size, const uint8_t* needle, size_t needle_size) {
+    return array_search_substring_scalar(haystack, haystack_size, needle, needle_size);
+}
+
 #ifdef __x86_64__
 
 /*
@@ -136,6 +148,39 @@ arch_target("avx2") unsigned array_search_x32_eq_impl(uint8_t val, const uint8_t
     return len;
 }
 
+/*
+ * AVX2 version of substring search. Checks 32 candidate offsets at once:
+ * an offset is compared in full only if both the first and the last byte
+ * of the needle match there.
+ */
+arch_target("avx2") size_t array_search_substring_impl(const uint8_t* haystack, size_t haystack_size, const uint8_t* needle, size_t needle_size) {
+    if (needle_size == 0) {
+        return 0;
+    }
+    if (needle_size > haystack_size) {
+        return haystack_size;
+    }
+
+    auto first = _mm256_set1_epi8(needle[0]);
+    auto last = _mm256_set1_epi8(needle[needle_size - 1]);
+    size_t off = 0;
+    for (; off + needle_size - 1 + 32 <= haystack_size; off += 32) {
+        auto block_first = _mm256_lddqu_si256((__m256i*)&haystack[off]);
+        auto block_last = _mm256_lddqu_si256((__m256i*)&haystack[off + needle_size - 1]);
+        unsigned m = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+        while (m != 0) {
+            auto pos = off + __builtin_ctz(m);
+            if (needle_size <= 2 || std::memcmp(&haystack[pos + 1], &needle[1], needle_size - 2) == 0) {
+                return pos;
+            }
+            m &= m - 1;
+        }
+    }
+
+    auto pos = array_search_substring_scalar(&haystack[off], haystack_size - off, needle, needle_size);
+    return pos == haystack_size - off ? haystack_size : off + pos;
+}
+
 #endif
 
 int array_search_gt(int64_t val, const int64_t* array, const int capacity, const int size) {
@@ -154,4 +199,8 @@ unsigned array_search_x32_eq(uint8_t val, const uint8_t* array, int nr) {
     return array_search_x32_eq_impl(val, array, nr);
 }
 
+size_t array_search_substring(const uint8_t* haystack, size_t haystack_size, const uint8_t* needle, size_t needle_size) {
+    return array_search_substring_impl(haystack, haystack_size, needle, needle_size);
+}
+
 }
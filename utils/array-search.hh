@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
@@ -57,4 +58,12 @@ unsigned array_search_16_eq(uint8_t val, const uint8_t* array);
 unsigned array_search_32_eq(uint8_t val, const uint8_t* array);
 unsigned array_search_x32_eq(uint8_t val, const uint8_t* array, int nr);
 
+/*
+ * array_search_substring(haystack, haystack_size, needle, needle_size)
+ *
+ * Returns the offset of the first occurrence of needle in haystack, or
+ * haystack_size if there's none. An empty needle is found at offset 0.
+ */
+size_t array_search_substring(const uint8_t* haystack, size_t haystack_size, const uint8_t* needle, size_t needle_size);
+
 }
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/with_scheduling_group.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+
+#include "utils/background_disposer.hh"
+
+namespace utils {
+
+static thread_local background_disposer the_background_disposer;
+
+background_disposer& local_background_disposer() noexcept {
+    return the_background_disposer;
+}
+
+void background_disposer::start(scheduling_group sg) {
+    assert(!_started);
+    _started = true;
+    _stopping = false;
+    _done = with_scheduling_group(sg, [this] {
+        return run();
+    });
+}
+
+future<> background_disposer::run() {
+    while (!_stopping || !_queue.empty()) {
+        if (_queue.empty()) {
+            co_await _cv.wait();
+            continue;
+        }
+        auto d = std::move(_queue.front());
+        _queue.pop_front();
+        co_await d->clear_gently();
+        d.reset();
+        ++_stats.disposed;
+        co_await coroutine::maybe_yield();
+    }
+}
+
+future<> background_disposer::stop() noexcept {
+    if (!_started) {
+        co_return;
+    }
+    _stopping = true;
+    _cv.signal();
+    co_await std::exchange(_done, make_ready_future<>());
+    _started = false;
+}
+
+} // namespace utils
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/condition-variable.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/chunked_fifo.hh>
+
+#include <memory>
+
+#include "utils/stall_free.hh"
+
+namespace utils {
+
+// Destroys objects in the background, a little at a time.
+//
+// Freeing a large structure in the standard allocator (a mutation with many rows,
+// a vector of query results, ...) is done in a single task and stalls the reactor
+// for as long as it takes. Code which is done with such an object can hand it over
+// to the disposer instead, which takes it apart with clear_gently() in a fiber
+// running in the scheduling group it was started in, and destroys what's left.
+//
+// Structures which live in LSA memory are freed with mutation_cleaner instead.
+class background_disposer {
+public:
+    struct stats {
+        uint64_t queued = 0;
+        uint64_t disposed = 0;
+    };
+private:
+    struct disposable {
+        virtual ~disposable() = default;
+        virtual future<> clear_gently() noexcept = 0;
+    };
+
+    template <typename T>
+    struct disposable_object final : public disposable {
+        T _obj;
+        explicit disposable_object(T&& obj) : _obj(std::move(obj)) {}
+        virtual future<> clear_gently() noexcept override {
+            return internal::clear_gently(_obj);
+        }
+    };
+
+    chunked_fifo<std::unique_ptr<disposable>> _queue;
+    condition_variable _cv;
+    bool _started = false;
+    bool _stopping = false;
+    future<> _done = make_ready_future<>();
+    stats _stats;
+private:
+    future<> run();
+public:
+    background_disposer() = default;
+    background_disposer(background_disposer&&) = delete;
+
+    // Starts the fiber which disposes of queued objects in the given scheduling group.
+    void start(scheduling_group sg);
+
+    // Waits for the objects queued so far to be disposed of.
+    future<> stop() noexcept;
+
+    // Takes obj over, to be destroyed in the background.
+    //
+    // When the disposer is not running, or memory for the queue entry can't be
+    // allocated, obj is left as is, for the caller to destroy it.
+    template <typename T>
+    requires (!std::is_lvalue_reference_v<T>)
+    void dispose(T&& obj) noexcept {
+        if (!_started) {
+            return;
+        }
+        try {
+            _queue.push_back(std::make_unique<disposable_object<T>>(std::move(obj)));
+        } catch (...) {
+            return;
+        }
+        ++_stats.queued;
+        _cv.signal();
+    }
+
+    size_t size() const noexcept { return _queue.size(); }
+    const stats& get_stats() const noexcept { return _stats; }
+};
+
+// The disposer of this shard.
+background_disposer& local_background_disposer() noexcept;
+
+// Hands obj over to the disposer of this shard, see background_disposer::dispose().
+template <typename T>
+requires (!std::is_lvalue_reference_v<T>)
+void dispose_gently(T&& obj) noexcept {
+    local_background_disposer().dispose(std::move(obj));
+}
+
+} // namespace utils
@@ -51,19 +51,48 @@ bloom_filter::~bloom_filter() noexcept {
 }
 
 bool bloom_filter::is_present(hashed_key key) {
+    // The bit positions are spread over the whole bitset, so testing them one
+    // by one serializes a cache miss per position. Compute a batch of
+    // positions first and prefetch all of them, so the misses overlap, and
+    // only then test the bits.
+    static constexpr int batch_size = 8;
+    std::array<int64_t, batch_size> batch;
+    int in_batch = 0;
+    auto test_batch = [&] {
+        for (int j = 0; j < in_batch; ++j) {
+            if (!_bitset.test(batch[j])) {
+                return false;
+            }
+        }
+        in_batch = 0;
+        return true;
+    };
     bool result = true;
-    for_each_index(key, _hash_count, _bitset.size(), _format, [this, &result] (auto i) {
-        if (!_bitset.test(i)) {
+    for_each_index(key, _hash_count, _bitset.size(), _format, [&] (auto i) {
+        _bitset.prefetch(i);
+        batch[in_batch++] = i;
+        if (in_batch == batch_size && !test_batch()) {
             result = false;
             return stop_iteration::yes;
         }
         return stop_iteration::no;
     });
-    return result;
+    return result && test_batch();
+}
+
+void bloom_filter::prefetch(hashed_key key) {
+    for_each_index(key, _hash_count, _bitset.size(), _format, [this] (auto i) {
+        _bitset.prefetch(i);
+        return stop_iteration::no;
+    });
 }
 
 void bloom_filter::add(const bytes_view& key) {
-    for_each_index(make_hashed_key(key), _hash_count, _bitset.size(), _format, [this] (auto i) {
+    add(make_hashed_key(key));
+}
+
+void bloom_filter::add(hashed_key key) {
+    for_each_index(key, _hash_count, _bitset.size(), _format, [this] (auto i) {
         _bitset.set(i);
         return stop_iteration::no;
     });
@@ -18,6 +18,8 @@
 
 #include <seastar/core/file.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/weak_ptr.hh>
 #include <seastar/coroutine/maybe_yield.hh>
 
 #include <map>
@@ -33,7 +35,10 @@ using namespace seastar;
 ///
 /// The object is movable but this is only allowed before readers are created.
 ///
-class cached_file {
+/// Optionally, detects sequential reading from disk and reads following pages
+/// ahead in the background, see set_max_read_ahead().
+///
+class cached_file : public seastar::weakly_referencable<cached_file> {
 public:
     // Must be aligned to _file.disk_read_dma_alignment(). 4K is always safe.
     static constexpr size_t page_size = 4096;
@@ -56,6 +61,7 @@ class cached_file {
         logalloc::lsa_buffer _lsa_buf;
         temporary_buffer<char> _buf; // Empty when not shared. May mirror _lsa_buf when shared.
         size_t _use_count = 0;
+        bool _read_ahead = false; // Read ahead and not used yet.
     public:
         struct cached_page_del {
             void operator()(cached_page* cp) {
@@ -150,48 +156,149 @@ class cached_file {
 
     offset_type _last_page_size;
     page_idx_type _last_page;
+
+    // Sequential read-ahead state.
+    page_count_type _max_read_ahead_pages = 0; // 0 disables read-ahead
+    page_count_type _read_ahead_window = 0;
+    // The page following the last one read from disk.
+    page_idx_type _next_sequential_page = std::numeric_limits<page_idx_type>::max();
+    // Pages [_read_ahead_start, _read_ahead_end) are being read ahead, when non-empty.
+    page_idx_type _read_ahead_start = 0;
+    page_idx_type _read_ahead_end = 0;
+    std::optional<shared_future<>> _read_ahead;
 private:
+    size_t read_size(page_idx_type idx, page_count_type count) const {
+        return (idx + count) > _last_page
+                ? (_last_page_size + (_last_page - idx) * page_size)
+                : count * page_size;
+    }
+
+    // Inserts the pages read from disk, starting at idx, returns the first one.
+    // Pages which are not returned are placed in the LRU, as there's no guarantee they will be fetched later.
+    cached_page::ptr_type populate(page_idx_type idx, temporary_buffer<char> buf, bool read_ahead) {
+        cached_page::ptr_type first_page;
+        while (buf.size()) {
+            auto this_size = std::min(page_size, buf.size());
+            // _cache.emplace() needs to run under allocating section even though it lives in the std space
+            // because bplus::tree operations are not reentrant, so we need to prevent memory reclamation.
+            auto it_and_flag = _as(_region, [&] {
+                auto this_buf = buf.share();
+                this_buf.trim(this_size);
+                return _cache.emplace(idx, this, idx, std::move(this_buf));
+            });
+            buf.trim_front(this_size);
+            ++idx;
+            cached_page &cp = *it_and_flag.first;
+            if (it_and_flag.second) {
+                ++_metrics.page_populations;
+                _metrics.cached_bytes += cp.size_in_allocator();
+                _cached_bytes += cp.size_in_allocator();
+                if (read_ahead) {
+                    cp._read_ahead = true;
+                    ++_metrics.read_ahead_pages;
+                }
+            }
+            cached_page::ptr_type ptr = cp.share();
+            if (!first_page) {
+                first_page = std::move(ptr);
+            }
+        }
+        return first_page;
+    }
+
+    bool read_ahead_in_progress() const noexcept {
+        return _read_ahead_start < _read_ahead_end;
+    }
+
+    // Reads _read_ahead_window pages starting at start in the background.
+    void start_read_ahead(page_idx_type start) {
+        auto end = std::min(start + _read_ahead_window, _last_page + 1);
+        auto i = _cache.lower_bound(start);
+        while (start < end && i != _cache.end() && i->idx == start) {
+            ++start;
+            ++i;
+        }
+        _next_sequential_page = end;
+        if (start >= end) {
+            return;
+        }
+        _read_ahead_start = start;
+        _read_ahead_end = end;
+        auto read = _file.dma_read_exactly<char>(start * page_size, read_size(start, end - start));
+        _read_ahead.emplace(read.then_wrapped([this, wp = weak_from_this(), start, f = _file] (future<temporary_buffer<char>> buf_fut) {
+            if (!wp) {
+                buf_fut.ignore_ready_future();
+                return;
+            }
+            _read_ahead_start = _read_ahead_end = 0;
+            if (buf_fut.failed()) {
+                // The pages will be read again on demand.
+                buf_fut.ignore_ready_future();
+                return;
+            }
+            try {
+                populate(start, buf_fut.get0(), true);
+            } catch (...) {
+                // Same as above, read-ahead is only an optimization.
+            }
+        }));
+    }
+
+    // Called on a miss which reads pages [idx, end) from disk.
+    void on_read(page_idx_type idx, page_idx_type end) {
+        if (idx == _next_sequential_page) {
+            _read_ahead_window = std::min(std::max<page_count_type>(_read_ahead_window * 2, 2), _max_read_ahead_pages);
+        } else {
+            _read_ahead_window = 0;
+        }
+        _next_sequential_page = end;
+        if (_read_ahead_window && !read_ahead_in_progress() && end <= _last_page) {
+            start_read_ahead(end);
+        }
+    }
+
+    void on_read_ahead_hit(cached_page& cp) {
+        ++_metrics.read_ahead_hits;
+        cp._read_ahead = false;
+        // Stay ahead of a reader which consumes pages read ahead, so that it never waits for the disk.
+        if (!read_ahead_in_progress() && _read_ahead_window && _next_sequential_page <= _last_page
+                && cp.idx + _read_ahead_window / 2 >= _next_sequential_page) {
+            _read_ahead_window = std::min(_read_ahead_window * 2, _max_read_ahead_pages);
+            start_read_ahead(_next_sequential_page);
+        }
+    }
+
     future<cached_page::ptr_type> get_page_ptr(page_idx_type idx,
             page_count_type read_ahead,
-            tracing::trace_state_ptr trace_state) {
+            tracing::trace_state_ptr trace_state,
+            bool wait_for_read_ahead = true) {
         auto i = _cache.lower_bound(idx);
         if (i != _cache.end() && i->idx == idx) {
             ++_metrics.page_hits;
             tracing::trace(trace_state, "page cache hit: file={}, page={}", _file_name, idx);
             cached_page& cp = *i;
-            return make_ready_future<cached_page::ptr_type>(cp.share());
+            auto ptr = cp.share();
+            if (cp._read_ahead) {
+                on_read_ahead_hit(cp);
+            }
+            return make_ready_future<cached_page::ptr_type>(std::move(ptr));
+        }
+        if (wait_for_read_ahead && idx >= _read_ahead_start && idx < _read_ahead_end) {
+            // The page is on its way, don't read it twice.
+            tracing::trace(trace_state, "page cache: waiting for read-ahead: file={}, page={}", _file_name, idx);
+            return _read_ahead->get_future().then([this, idx, read_ahead, trace_state = std::move(trace_state)] () mutable {
+                return get_page_ptr(idx, read_ahead, std::move(trace_state), false);
+            });
         }
         tracing::trace(trace_state, "page cache miss: file={}, page={}, readahead={}", _file_name, idx, read_ahead);
         ++_metrics.page_misses;
-        size_t size = (idx + read_ahead) > _last_page
-                ? (_last_page_size + (_last_page - idx) * page_size)
-                : read_ahead * page_size;
+        size_t size = read_size(idx, read_ahead);
+        if (_max_read_ahead_pages) {
+            on_read(idx, std::min(idx + read_ahead, _last_page + 1));
+        }
         return _file.dma_read_exactly<char>(idx * page_size, size)
             .then([this, idx] (temporary_buffer<char>&& buf) mutable {
-                cached_page::ptr_type first_page;
-                while (buf.size()) {
-                    auto this_size = std::min(page_size, buf.size());
-                    // _cache.emplace() needs to run under allocating section even though it lives in the std space
-                    // because bplus::tree operations are not reentrant, so we need to prevent memory reclamation.
-                    auto it_and_flag = _as(_region, [&] {
-                        auto this_buf = buf.share();
-                        this_buf.trim(this_size);
-                        return _cache.emplace(idx, this, idx, std::move(this_buf));
-                    });
-                    buf.trim_front(this_size);
-                    ++idx;
-                    cached_page &cp = *it_and_flag.first;
-                    if (it_and_flag.second) {
-                        ++_metrics.page_populations;
-                        _metrics.cached_bytes += cp.size_in_allocator();
-                        _cached_bytes += cp.size_in_allocator();
-                    }
-                    // pages read ahead will be placed into LRU, as there's no guarantee they will be fetched later.
-                    cached_page::ptr_type ptr = cp.share();
-                    if (!first_page) {
-                        first_page = std::move(ptr);
-                    }
-                }
+                auto first_page = populate(idx, std::move(buf), false);
                 utils::get_local_injector().inject("cached_file_get_first_page", []() {
                     throw std::bad_alloc();
                 });
@@ -319,6 +426,9 @@ class cached_file {
         _metrics.cached_bytes -= p.size_in_allocator();
         _cached_bytes -= p.size_in_allocator();
         ++_metrics.page_evictions;
+        if (p._read_ahead) {
+            ++_metrics.read_ahead_waste;
+        }
     }
 
     size_t evict_range(cache_type::iterator start, cache_type::iterator end) noexcept {
@@ -405,7 +515,7 @@ class cached_file {
     ///
     /// Returns a stream with data which starts at position pos in the area managed by this instance.
     /// This cached_file instance must outlive the returned stream and buffers returned by the stream.
-    /// The stream does not do any read-ahead.
+    /// The stream does not read ahead beyond size_hint, but the cached_file may, see set_max_read_ahead().
     ///
     /// \param pos The offset of the first byte to read, relative to the cached file area.
     /// \param permit Holds reader_permit under which returned buffers should be accounted.
@@ -421,6 +531,27 @@ class cached_file {
         return stream(*this, std::move(permit), std::move(trace_state), page_idx, offset, size_hint);
     }
 
+    /// \brief Enables sequential read-ahead.
+    ///
+    /// When pages are read from disk sequentially, following pages are read ahead
+    /// in the background, in windows which double with every sequential read,
+    /// up to max_pages. Pages read ahead are placed in the LRU.
+    /// Zero disables read-ahead, which is the default.
+    void set_max_read_ahead(page_count_type max_pages) {
+        _max_read_ahead_pages = max_pages;
+        _read_ahead_window = std::min(_read_ahead_window, max_pages);
+    }
+
+    /// \brief Disables read-ahead and waits for the pending one, if any.
+    ///
+    /// Must be called before the underlying file is closed, if read-ahead was enabled.
+    future<> stop_read_ahead() {
+        set_max_read_ahead(0);
+        if (_read_ahead) {
+            co_await _read_ahead->get_future();
+        }
+    }
+
     /// \brief Returns the number of bytes in the area managed by this instance.
     offset_type size() const {
         return _size;
@@ -17,4 +17,7 @@ struct cached_file_stats {
     uint64_t page_populations = 0;
     uint64_t cached_bytes = 0;
     uint64_t bytes_in_std = 0; // memory used by active temporary_buffer:s
+    uint64_t read_ahead_pages = 0; // pages populated by read-ahead
+    uint64_t read_ahead_hits = 0; // pages read ahead which were used
+    uint64_t read_ahead_waste = 0; // pages read ahead which were evicted without being used
 };
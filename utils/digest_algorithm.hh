@@ -17,6 +17,11 @@ enum class digest_algorithm : uint8_t {
     MD5 = 1,
     legacy_xxHash_without_null_digest = 2,
     xxHash = 3, // default algorithm
+    // Like xxHash, but atomic cell values are represented by their size only.
+    // Replicas which applied the same writes still agree, and the cost no
+    // longer depends on the size of the values. Writes of different values
+    // with the same timestamp are not told apart.
+    xxHash_of_versions = 4,
 };
 
 }
@@ -23,7 +23,7 @@ struct noop_hasher {
 };
 
 class digester final {
-    std::variant<noop_hasher, md5_hasher, xx_hasher, legacy_xx_hasher_without_null_digest> _impl;
+    std::variant<noop_hasher, md5_hasher, xx_hasher, legacy_xx_hasher_without_null_digest, xx_version_hasher> _impl;
 
 public:
     explicit digester(digest_algorithm algo) {
@@ -37,6 +37,9 @@ class digester final {
         case digest_algorithm::legacy_xxHash_without_null_digest:
             _impl = legacy_xx_hasher_without_null_digest();
             break;
+        case digest_algorithm::xxHash_of_versions:
+            _impl = xx_version_hasher();
+            break;
         case digest_algorithm ::none:
             _impl = noop_hasher();
             break;
@@ -60,8 +63,12 @@ class digester final {
 
 using default_hasher = xx_hasher;
 
+// The cached cell hashes are hashes of the whole cell, so they cannot be
+// used by xx_version_hasher. It doesn't need them, cells are cheap to hash
+// without their values.
 template<typename Hasher>
-using using_hash_of_hash = std::negation<std::disjunction<std::is_same<Hasher, md5_hasher>, std::is_same<Hasher, noop_hasher>>>;
+using using_hash_of_hash = std::negation<std::disjunction<std::is_same<Hasher, md5_hasher>, std::is_same<Hasher, noop_hasher>,
+        std::is_same<Hasher, xx_version_hasher>>>;
 
 template<typename Hasher>
 inline constexpr bool using_hash_of_hash_v = using_hash_of_hash<Hasher>::value;
@@ -37,6 +37,11 @@ class dns_connection_factory : public seastar::http::experimental::connection_fa
 
         co_await coroutine::all(
             [state, host = _host, port = _port] () -> future<> {
+                // Host names are resolved to IPv4 addresses, so IPv6 ones are used as they are.
+                if (host.find(':') != std::string::npos) {
+                    state->addr = socket_address(net::inet_address(sstring(host)), port);
+                    co_return;
+                }
                 auto hent = co_await net::dns::get_host_by_name(host, net::inet_address::family::INET);
                 state->addr = socket_address(hent.addr_list.front(), port);
             },
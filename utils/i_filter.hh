@@ -38,8 +38,12 @@ struct i_filter {
     virtual ~i_filter() {}
 
     virtual void add(const bytes_view& key) = 0;
+    virtual void add(hashed_key) = 0;
     virtual bool is_present(const bytes_view& key) = 0;
     virtual bool is_present(hashed_key) = 0;
+    // Hints that is_present(key) is going to be called soon, so that the
+    // memory it touches can be brought into the cache ahead of time.
+    virtual void prefetch(hashed_key) {}
     virtual void clear() = 0;
     virtual void close() = 0;
 
@@ -44,6 +44,10 @@ class large_bitset {
         auto idx2 = idx;
         return (_storage[idx1] >> idx2) & 1;
     }
+    // Hints the CPU to bring the word holding the bit into the cache.
+    void prefetch(size_t idx) const {
+        __builtin_prefetch(&_storage[idx / bits_per_int()]);
+    }
     void set(size_t idx) {
         auto idx1 = idx / bits_per_int();
         idx %= bits_per_int();
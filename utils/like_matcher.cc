@@ -9,9 +9,11 @@
 
 
 #include "like_matcher.hh"
+#include "array-search.hh"
 
 #include <boost/regex/icu.hpp>
 #include <boost/locale/encoding.hpp>
+#include <optional>
 #include <string>
 
 namespace {
@@ -75,33 +77,105 @@ wstring regex_from_pattern(bytes_view pattern) {
     return re;
 }
 
+/// A pattern consisting of a single literal, optionally preceded and/or followed by '%'.
+struct literal_pattern {
+    std::string literal;
+    bool any_prefix = false; ///< Pattern starts with '%'.
+    bool any_suffix = false; ///< Pattern ends with '%'.
+};
+
+/// Returns the pattern as a literal_pattern, or nullopt if it needs the general matcher.
+///
+/// Works on the UTF-8 bytes directly: wildcards and the escape character are ASCII, and an ASCII
+/// byte never occurs inside a multi-byte UTF-8 sequence.
+std::optional<literal_pattern> literal_from_pattern(bytes_view pattern) {
+    literal_pattern ret;
+    bool escaping = false;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        const auto c = pattern[i];
+        if (escaping) {
+            if (ret.any_suffix) {
+                return std::nullopt;
+            }
+            ret.literal.push_back(char(c));
+            escaping = false;
+        } else if (c == '\\') {
+            escaping = true;
+        } else if (c == '_') {
+            return std::nullopt;
+        } else if (c == '%') {
+            if (ret.literal.empty() && !ret.any_suffix) {
+                ret.any_prefix = true;
+            } else {
+                ret.any_suffix = true;
+            }
+        } else if (ret.any_suffix) {
+            return std::nullopt; // A '%' inside the literal.
+        } else {
+            ret.literal.push_back(char(c));
+        }
+    }
+    if (escaping) {
+        // Unescaped backslash at the end matches itself, see regex_from_pattern().
+        if (ret.any_suffix) {
+            return std::nullopt;
+        }
+        ret.literal.push_back('\\');
+    }
+    return ret;
+}
+
 } // anonymous namespace
 
 class like_matcher::impl {
     bytes _pattern;
-    boost::u32regex _re; // Performs pattern matching.
+    std::optional<literal_pattern> _literal; // Matches simple patterns without a regex.
+    std::optional<boost::u32regex> _re; // Performs pattern matching for all other patterns.
   public:
     explicit impl(bytes_view pattern);
     bool operator()(bytes_view text) const;
     void reset(bytes_view pattern);
   private:
-    void init_re() {
-        _re = boost::make_u32regex(regex_from_pattern(_pattern), boost::u32regex::basic | boost::u32regex::optimize);
+    void init() {
+        _literal = literal_from_pattern(_pattern);
+        if (_literal) {
+            _re.reset();
+        } else {
+            _re = boost::make_u32regex(regex_from_pattern(_pattern), boost::u32regex::basic | boost::u32regex::optimize);
+        }
     }
+    bool match_literal(bytes_view text) const;
 };
 
 like_matcher::impl::impl(bytes_view pattern) : _pattern(pattern) {
-    init_re();
+    init();
+}
+
+bool like_matcher::impl::match_literal(bytes_view text) const {
+    const bytes_view literal = to_bytes_view(_literal->literal);
+    if (_literal->any_prefix && _literal->any_suffix) {
+        return literal.empty() || utils::array_search_substring(
+                reinterpret_cast<const uint8_t*>(text.data()), text.size(),
+                reinterpret_cast<const uint8_t*>(literal.data()), literal.size()) != text.size();
+    } else if (_literal->any_prefix) {
+        return text.ends_with(literal);
+    } else if (_literal->any_suffix) {
+        return text.starts_with(literal);
+    }
+    return text == literal;
 }
 
 bool like_matcher::impl::operator()(bytes_view text) const {
-    return boost::u32regex_match(text.begin(), text.end(), _re);
+    if (_literal) {
+        return match_literal(text);
+    }
+    return boost::u32regex_match(text.begin(), text.end(), *_re);
 }
 
 void like_matcher::impl::reset(bytes_view pattern) {
     if (pattern != _pattern) {
         _pattern = bytes(pattern);
-        init_re();
+        init();
     }
 }
 
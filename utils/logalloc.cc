@@ -35,6 +35,7 @@
 #include "utils/vle.hh"
 #include "utils/coarse_steady_clock.hh"
 
+#include <bit>
 #include <random>
 #include <chrono>
 
@@ -90,6 +91,11 @@ namespace {
 class migrators_base {
 protected:
     std::vector<const migrate_fn_type*> _migrators;
+public:
+    // One past the highest index in use.
+    size_t size() const noexcept {
+        return _migrators.size();
+    }
 };
 
 #ifdef DEBUG_LSA_SANITIZER
@@ -370,16 +376,26 @@ using clock = std::chrono::steady_clock;
 class background_reclaimer {
     scheduling_group _sg;
     noncopyable_function<void (size_t target)> _reclaim;
+    static constexpr size_t free_memory_threshold = 60'000'000;
+    static constexpr auto adjust_period = 50ms;
+    // How long the free memory kept by the main loop should last at the recent consumption rate.
+    static constexpr auto reserve_horizon = 200ms;
     timer<lowres_clock> _adjust_shares_timer;
+    // The free memory the main loop keeps, at least free_memory_threshold.
+    size_t _free_memory_goal = free_memory_threshold;
+    // Memory consumed per adjust_period, exponentially averaged.
+    double _consumption_rate = 0;
+    size_t _last_free_memory;
+    uint64_t _memory_released = 0;
+    uint64_t _last_memory_released = 0;
     // If engaged, main loop is not running, set_value() to wake it.
     promise<>* _main_loop_wait = nullptr;
     future<> _done;
     bool _stopping = false;
-    static constexpr size_t free_memory_threshold = 60'000'000;
 private:
     bool have_work() const {
 #ifndef SEASTAR_DEFAULT_ALLOCATOR
-        return memory::free_memory() < free_memory_threshold;
+        return memory::free_memory() < _free_memory_goal;
 #else
         return false;
 #endif
@@ -405,16 +421,31 @@ class background_reclaimer {
             if (_stopping) {
                 break;
             }
-            _reclaim(free_memory_threshold - memory::free_memory());
+            _reclaim(_free_memory_goal - memory::free_memory());
             co_await coroutine::maybe_yield();
         }
         llogger.debug("background_reclaimer::main_loop: exit");
     }
+    // Sizes the free memory goal so that a burst of allocations at the recent rate
+    // is served from free memory for reserve_horizon, rather than by reclaiming
+    // synchronously in the allocating fiber.
+    void update_free_memory_goal() {
+        auto free = memory::free_memory();
+        // What free memory dropped by, plus what reclaim released in the meantime.
+        auto consumed = std::max<int64_t>(0, int64_t(_last_free_memory) - int64_t(free) + int64_t(_memory_released - _last_memory_released));
+        _last_free_memory = free;
+        _last_memory_released = _memory_released;
+        _consumption_rate = _consumption_rate * 0.75 + consumed * 0.25;
+        auto max_goal = std::max(free_memory_threshold, memory::stats().total_memory() / 16);
+        auto goal = size_t(_consumption_rate * (reserve_horizon / adjust_period));
+        _free_memory_goal = std::clamp(goal, free_memory_threshold, max_goal);
+    }
     void adjust_shares() {
+        update_free_memory_goal();
         if (have_work()) {
-            auto shares = 1 + (1000 * (free_memory_threshold - memory::free_memory())) / free_memory_threshold;
+            auto shares = 1 + (1000 * (_free_memory_goal - memory::free_memory())) / _free_memory_goal;
             _sg.set_shares(shares);
-            llogger.trace("background_reclaimer::adjust_shares: {}", shares);
+            llogger.trace("background_reclaimer::adjust_shares: {}, goal: {}", shares, _free_memory_goal);
             if (_main_loop_wait) {
                 main_loop_wake();
             }
@@ -425,9 +456,10 @@ class background_reclaimer {
             : _sg(sg)
             , _reclaim(std::move(reclaim))
             , _adjust_shares_timer(default_scheduling_group(), [this] { adjust_shares(); })
+            , _last_free_memory(memory::free_memory())
             , _done(with_scheduling_group(_sg, [this] { return main_loop(); })) {
         if (sg != default_scheduling_group()) {
-            _adjust_shares_timer.arm_periodic(50ms);
+            _adjust_shares_timer.arm_periodic(adjust_period);
         }
     }
     future<> stop() {
@@ -435,6 +467,13 @@ class background_reclaimer {
         main_loop_wake();
         return std::move(_done);
     }
+    // To be called with the memory released by every reclaim, background or not.
+    void on_memory_released(size_t bytes) noexcept {
+        _memory_released += bytes;
+    }
+    size_t free_memory_goal() const noexcept {
+        return _free_memory_goal;
+    }
 };
 
 class segment_pool;
@@ -501,6 +540,7 @@ class tracker::impl {
     occupancy_stats global_occupancy() const noexcept;
     occupancy_stats region_occupancy() const noexcept;
     occupancy_stats occupancy() const noexcept;
+    object_sample sample_objects(size_t max_segments_per_region);
     size_t non_lsa_used_space() const noexcept;
     // Set the minimum number of segments reclaimed during single reclamation cycle.
     void set_reclamation_step(size_t step_in_segments) noexcept { _reclamation_step = step_in_segments; }
@@ -571,6 +611,10 @@ occupancy_stats tracker::region_occupancy() const noexcept {
     return _impl->region_occupancy();
 }
 
+object_sample tracker::sample_objects(size_t max_segments_per_region) {
+    return _impl->sample_objects(max_segments_per_region);
+}
+
 occupancy_stats tracker::occupancy() const noexcept {
     return _impl->occupancy();
 }
@@ -978,6 +1022,8 @@ class segment_pool {
     size_t _free_segments = 0;
     size_t _current_emergency_reserve_goal = 1;
     size_t _emergency_reserve_max = 30;
+    // reclaim_segments() doesn't stop in the middle of an aligned span of this size.
+    size_t _reclaim_span = segment::size;
     bool _allocation_failure_flag = false;
     bool _allocation_enabled = true;
 
@@ -1030,6 +1076,9 @@ class segment_pool {
         return _allocation_enabled && _store.can_allocate_more_segments();
     }
     bool compact_segment(segment* seg);
+    bool in_same_reclaim_span(uintptr_t seg1, const segment* seg2) const noexcept {
+        return (seg1 ^ reinterpret_cast<uintptr_t>(seg2)) < _reclaim_span;
+    }
 public:
     explicit segment_pool(logalloc::tracker::impl& tracker);
     logalloc::tracker::impl& tracker() { return _tracker; }
@@ -1054,6 +1103,12 @@ class segment_pool {
     void set_emergency_reserve_max(size_t new_size) noexcept { _emergency_reserve_max = new_size; }
     size_t emergency_reserve_max() const noexcept { return _emergency_reserve_max; }
     void set_current_emergency_reserve_goal(size_t goal) noexcept { _current_emergency_reserve_goal = goal; }
+    // With a span larger than a segment, reclaim_segments() keeps releasing segments
+    // past its target until it reaches the next span boundary.
+    void set_reclaim_span(size_t span) noexcept {
+        assert(span >= segment::size && std::has_single_bit(span));
+        _reclaim_span = span;
+    }
     void clear_allocation_failure_flag() noexcept { _allocation_failure_flag = false; }
     bool allocation_failure_flag() const noexcept { return _allocation_failure_flag; }
     void refill_emergency_reserve();
@@ -1207,6 +1262,8 @@ size_t segment_pool::reclaim_segments(size_t target, is_preemptible preempt) {
 
     // Reclamation. Migrate segments to higher addresses and shrink segment pool.
     size_t reclaimed_segments = 0;
+    // Address of the last segment released, see set_reclaim_span().
+    uintptr_t last_released = 0;
 
     reclaim_timer timing_guard("reclaim_segments", preempt, target * segment::size, target, *this, [&] (log_level level) {
         timing_logger.log(level, "- reclaimed {} out of requested {} segments", reclaimed_segments, target);
@@ -1227,10 +1284,12 @@ size_t segment_pool::reclaim_segments(size_t target, is_preemptible preempt) {
     size_t failed_reclaims_allowance = 10;
 
     for (size_t src_idx = _lsa_owned_segments_bitmap.find_first_set();
-            reclaimed_segments != target && src_idx != utils::dynamic_bitset::npos
-                    && _free_segments > _current_emergency_reserve_goal;
+            src_idx != utils::dynamic_bitset::npos && _free_segments > _current_emergency_reserve_goal;
             src_idx = _lsa_owned_segments_bitmap.find_next_set(src_idx)) {
         auto src = segment_from_idx(src_idx);
+        if (reclaimed_segments >= target && !(reclaimed_segments && in_same_reclaim_span(last_released, src))) {
+            break;
+        }
         if (!_lsa_free_segments_bitmap.test(src_idx)) {
             if (!compact_segment(src)) {
                 if (--failed_reclaims_allowance == 0) {
@@ -1241,6 +1300,7 @@ size_t segment_pool::reclaim_segments(size_t target, is_preemptible preempt) {
         }
         _lsa_free_segments_bitmap.clear(src_idx);
         _lsa_owned_segments_bitmap.clear(src_idx);
+        last_released = reinterpret_cast<uintptr_t>(src);
         _store.free_segment(src);
         ++reclaimed_segments;
         --_free_segments;
@@ -2001,6 +2061,43 @@ class region_impl final : public basic_region_impl {
         _region = new_region;
     }
 
+    void sample_objects(size_t max_segments, object_sample& sample) {
+        // The sample allocates, which must not compact the segments under our feet.
+        tracker_reclaimer_lock rl(_tracker);
+        const size_t segments = _closed_occupancy.total_space() / segment::size;
+        max_segments = std::max<size_t>(1, max_segments);
+        const size_t step = std::max<size_t>(1, (segments + max_segments - 1) / max_segments);
+        // Allocated up front, the walk over live objects doesn't allocate.
+        std::vector<object_sample::type_stats> sampled(static_migrators().size());
+        size_t i = 0;
+        for (auto& desc : _segment_descs) {
+            if (i++ % step) {
+                continue;
+            }
+            ++sample.sampled_segments;
+            if (desc.kind() == segment_kind::bufs) {
+                sample.types["lsa_buffer"].bytes += desc.occupancy().used_space() * step;
+                continue;
+            }
+            for_each_live(segment_pool().segment_from(desc), [&] (const object_descriptor* od, void*, size_t size) {
+                auto& t = sampled[od->migrator()->index()];
+                ++t.count;
+                t.bytes += size;
+            });
+        }
+        for (uint32_t index = 0; index < sampled.size(); ++index) {
+            auto& t = sampled[index];
+            if (!t.count) {
+                continue;
+            }
+            auto& total = sample.types[static_migrators()[index]->name()];
+            total.count += t.count * step;
+            total.bytes += t.bytes * step;
+        }
+        sample.types["non_lsa"].bytes += _non_lsa_occupancy.used_space();
+        sample.occupancy += occupancy();
+    }
+
     // Note: allocation is disallowed in this path
     // since we don't instantiate reclaiming_lock
     // while traversing _regions
@@ -2337,6 +2434,7 @@ void tracker::configure(const config& cfg) {
     }
     _impl->setup_background_reclaim(cfg.background_reclaim_sched_group);
     _impl->set_sanitizer_report_backtrace(cfg.sanitizer_report_backtrace);
+    _impl->segment_pool().set_reclaim_span(cfg.reclaim_huge_page_spans ? huge_page_size : segment::size);
 }
 
 memory::reclaiming_result tracker::reclaim(seastar::memory::reclaimer::request r) {
@@ -2400,6 +2498,23 @@ occupancy_stats region::occupancy() const noexcept {
     return get_impl().occupancy();
 }
 
+object_sample region::sample_objects(size_t max_segments) {
+    object_sample sample;
+    get_impl().sample_objects(max_segments, sample);
+    return sample;
+}
+
+object_sample& object_sample::operator+=(const object_sample& other) {
+    for (auto& [name, t] : other.types) {
+        auto& total = types[name];
+        total.count += t.count;
+        total.bytes += t.bytes;
+    }
+    occupancy += other.occupancy;
+    sampled_segments += other.sampled_segments;
+    return *this;
+}
+
 lsa_buffer region::alloc_buf(size_t buffer_size) {
     return get_impl().alloc_buf(buffer_size);
 }
@@ -2471,6 +2586,15 @@ occupancy_stats tracker::impl::region_occupancy() const noexcept {
     return total;
 }
 
+object_sample tracker::impl::sample_objects(size_t max_segments_per_region) {
+    reclaiming_lock _(*this);
+    object_sample sample;
+    for (region::impl* r : _regions) {
+        r->sample_objects(max_segments_per_region, sample);
+    }
+    return sample;
+}
+
 occupancy_stats tracker::impl::occupancy() const noexcept {
     auto occ = region_occupancy();
     {
@@ -2603,7 +2727,11 @@ size_t tracker::impl::reclaim(size_t memory_to_release, is_preemptible preempt)
     }
     reclaiming_lock rl(*this);
     reclaim_timer timing_guard("reclaim", preempt, memory_to_release, 0, *this);
-    return timing_guard.set_memory_released(reclaim_locked(memory_to_release, preempt));
+    auto released = timing_guard.set_memory_released(reclaim_locked(memory_to_release, preempt));
+    if (_background_reclaimer) {
+        _background_reclaimer->on_memory_released(released);
+    }
+    return released;
 }
 
 size_t tracker::impl::reclaim_locked(size_t memory_to_release, is_preemptible preempt) {
@@ -2815,6 +2943,9 @@ tracker::impl::impl() : _segment_pool(std::make_unique<logalloc::segment_pool>(*
         sm::make_gauge("occupancy", [this] { return region_occupancy().used_fraction() * 100; },
                        sm::description("Holds a current portion (in percents) of the used memory.")),
 
+        sm::make_gauge("background_reclaim_free_memory_goal", [this] { return _background_reclaimer ? _background_reclaimer->free_memory_goal() : 0; },
+                       sm::description("Holds the amount of free memory the background reclaimer keeps, sized from the recent memory consumption rate.")),
+
         sm::make_counter("segments_compacted", [this] { return _segment_pool->statistics().segments_compacted; },
                         sm::description("Counts a number of compacted segments.")),
 
@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <string>
 #include <seastar/core/memory.hh>
 #include <seastar/core/condition-variable.hh>
 #include <seastar/core/smp.hh>
@@ -31,6 +33,7 @@ class allocating_section;
 constexpr int segment_size_shift = 17; // 128K; see #151, #152
 constexpr size_t segment_size = 1 << segment_size_shift;
 constexpr size_t max_zone_segments = 256;
+constexpr size_t huge_page_size = 2 << 20; // transparent huge pages with 4K base pages
 
 //
 // Frees some amount of objects from the region to which it's attached.
@@ -64,6 +67,9 @@ class tracker {
         bool sanitizer_report_backtrace = false; // Better reports but slower
         size_t lsa_reclamation_step;
         scheduling_group background_reclaim_sched_group;
+        // Whether segments are given back to the seastar allocator in whole huge pages,
+        // so that LSA memory doesn't share huge pages with general purpose memory.
+        bool reclaim_huge_page_spans = false;
     };
 
     struct stats {
@@ -142,6 +148,9 @@ class tracker {
     // Returns aggregate statistics for all pools.
     occupancy_stats region_occupancy() const noexcept;
 
+    // Sums up region::sample_objects() of all regions.
+    object_sample sample_objects(size_t max_segments_per_region);
+
     // Returns statistics for all segments allocated by LSA on this shard.
     occupancy_stats occupancy() const noexcept;
 
@@ -291,6 +300,23 @@ class occupancy_stats {
     friend std::ostream& operator<<(std::ostream&, const occupancy_stats&);
 };
 
+// Estimate of the memory taken by LSA objects of each type, see region::sample_objects().
+struct object_sample {
+    struct type_stats {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+    };
+    // Keyed by the name of the objects' migrator, extrapolated from the sampled segments.
+    // Buffers allocated with alloc_buf() are counted under "lsa_buffer", objects allocated
+    // outside of segments under "non_lsa".
+    std::map<std::string, type_stats> types;
+    // Of all sampled regions, exact.
+    occupancy_stats occupancy;
+    size_t sampled_segments = 0;
+
+    object_sample& operator+=(const object_sample& other);
+};
+
 class basic_region_impl : public allocation_strategy {
 protected:
     tracker& _tracker;
@@ -347,6 +373,11 @@ class region {
 
     occupancy_stats occupancy() const noexcept;
 
+    // Estimates what types of objects the region's memory is taken by, by walking
+    // the objects of at most max_segments of its segments, evenly spread.
+    // Doesn't allocate in the region and doesn't yield, so the cost is bounded by max_segments.
+    object_sample sample_objects(size_t max_segments);
+
     tracker& get_tracker() const {
         return _impl->get_tracker();
     }
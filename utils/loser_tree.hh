@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+// Tournament tree of losers, for merging many sorted streams.
+//
+// Elements are kept in slots, the leaves of a complete binary tree. Every
+// internal node remembers the slot which lost the match played there, and
+// the slot of the least element, the overall winner, is kept on top.
+// Replacing or removing the least element replays only the matches on the
+// path from its slot up to the root, so it costs log2(capacity) comparisons
+// at most, against up to twice as many for a binary heap pop, and touches
+// the same nodes whatever the elements are.
+// Empty slots lose all their matches without being compared.
+//
+// Inserting an element anywhere else invalidates the matches. They are all
+// replayed, with at most capacity - 1 comparisons, the next time the least
+// element is accessed, so inserts are best done in batches, e.g. when
+// (re)filling the tree.
+template <typename T, typename Less>
+class loser_tree {
+    Less _less;
+    std::vector<std::optional<T>> _slots;
+    // _nodes[0] is the winner, _nodes[i] for 0 < i < capacity() the loser of
+    // the match at node i. The children of node i are the nodes 2i and 2i + 1,
+    // the parent of slot j is the node (j + capacity()) / 2.
+    std::vector<unsigned> _nodes;
+    // Winners of the matches, used only when replaying all of them.
+    std::vector<unsigned> _winners;
+    std::vector<unsigned> _free_slots;
+    size_t _size = 0;
+    bool _valid = true;
+private:
+    bool beats(unsigned a, unsigned b) const {
+        return _slots[a] && (!_slots[b] || _less(*_slots[a], *_slots[b]));
+    }
+
+    void replay(unsigned slot) {
+        auto winner = slot;
+        for (auto n = (slot + capacity()) / 2; n > 0; n /= 2) {
+            if (beats(_nodes[n], winner)) {
+                std::swap(_nodes[n], winner);
+            }
+        }
+        _nodes[0] = winner;
+    }
+
+    void replay_all() {
+        const auto cap = capacity();
+        auto winner_of = [&] (size_t n) -> unsigned {
+            return n >= cap ? n - cap : _winners[n];
+        };
+        for (auto n = cap - 1; n > 0; --n) {
+            auto l = winner_of(2 * n);
+            auto r = winner_of(2 * n + 1);
+            if (beats(r, l)) {
+                std::swap(l, r);
+            }
+            _winners[n] = l;
+            _nodes[n] = r;
+        }
+        _nodes[0] = cap > 1 ? _winners[1] : 0;
+        _valid = true;
+    }
+
+    void ensure_valid() {
+        if (!_valid) {
+            replay_all();
+        }
+    }
+public:
+    // The tree has no capacity until it's reset or pushed to.
+    explicit loser_tree(Less less = Less())
+        : _less(std::move(less))
+    { }
+
+    // Removes all elements, and sets the capacity to at least the given number of elements.
+    void reset(size_t capacity) {
+        capacity = std::bit_ceil(std::max<size_t>(capacity, 1));
+        _slots.clear();
+        _slots.resize(capacity);
+        _nodes.assign(capacity, 0);
+        _winners.assign(capacity, 0);
+        _free_slots.clear();
+        for (auto i = capacity; i > 0; --i) {
+            _free_slots.push_back(i - 1);
+        }
+        _size = 0;
+        _valid = true;
+    }
+
+    void clear() {
+        if (capacity()) {
+            reset(capacity());
+        }
+    }
+
+    size_t capacity() const noexcept {
+        return _slots.size();
+    }
+
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    // Inserts an element, growing the tree if it's full.
+    void push(T v) {
+        if (_free_slots.empty()) {
+            auto cap = capacity();
+            auto new_cap = std::max<size_t>(cap * 2, 1);
+            _slots.resize(new_cap);
+            _nodes.resize(new_cap);
+            _winners.resize(new_cap);
+            for (auto i = new_cap; i > cap; --i) {
+                _free_slots.push_back(i - 1);
+            }
+        }
+        auto slot = _free_slots.back();
+        _free_slots.pop_back();
+        _slots[slot].emplace(std::move(v));
+        ++_size;
+        _valid = false;
+    }
+
+    // Returns the least element.
+    // The tree must not be empty.
+    T& top() {
+        assert(!empty());
+        ensure_valid();
+        return *_slots[_nodes[0]];
+    }
+
+    // Removes the least element, and returns it.
+    // The tree must not be empty.
+    T pop() {
+        assert(!empty());
+        ensure_valid();
+        auto slot = _nodes[0];
+        T v = std::move(*_slots[slot]);
+        _slots[slot].reset();
+        _free_slots.push_back(slot);
+        --_size;
+        replay(slot);
+        return v;
+    }
+
+    // Replaces the least element with v, which is cheaper than pop() followed by push().
+    // The tree must not be empty.
+    void replace_top(T v) {
+        assert(!empty());
+        ensure_valid();
+        auto slot = _nodes[0];
+        _slots[slot].emplace(std::move(v));
+        replay(slot);
+    }
+
+    // Calls func on every element, in no particular order.
+    template <typename Func>
+    void for_each(Func&& func) {
+        for (auto& slot : _slots) {
+            if (slot) {
+                func(*slot);
+            }
+        }
+    }
+};
+
+} // namespace utils
@@ -10,6 +10,7 @@
 
 #include <boost/intrusive/list.hpp>
 #include <seastar/core/memory.hh>
+#include <type_traits>
 
 class evictable {
     friend class lru;
@@ -51,8 +52,23 @@ class evictable {
         return _lru_link.is_linked();
     }
 
+    // Elements which can be linked in the probationary segment of the LRU (see lru::add_on_probation())
+    // remember whether they are there, so that the LRU can tell which segment they are linked in.
+    // Returns false if the element doesn't support probation.
+    virtual bool set_on_probation(bool) noexcept {
+        return false;
+    }
+
+    virtual bool on_probation() const noexcept {
+        return false;
+    }
+
+    // The segment is swapped together with the link.
     void swap(evictable& o) noexcept {
         _lru_link.swap_nodes(o._lru_link);
+        bool p = on_probation();
+        set_on_probation(o.on_probation());
+        o.set_on_probation(p);
     }
 
     virtual bool is_index() const noexcept {
@@ -76,12 +92,28 @@ class index_evictable : public evictable {
 };
 
 // Implements LRU cache replacement for row cache and sstable index cache.
+//
+// The LRU is segmented. Elements which are referenced once, e.g. by a scan, can be
+// admitted to the probationary segment, where they are evicted before any element of
+// the protected segment. They are promoted to the protected segment when touched again.
+// This way a single pass over many elements doesn't push out the hot working set.
+// The protected segment is kept within protected_fraction of all elements by demoting its
+// least recently used elements to the most recently used end of the probationary segment.
+//
+// Demotion doesn't change the order in which elements are evicted: the eviction order is
+// always that of the probationary segment followed by the protected one. Only admission
+// on probation puts an element ahead of the protected segment in that order.
 class lru {
+public:
+    static constexpr float protected_fraction = 0.8f;
 private:
     using lru_type = boost::intrusive::list<evictable,
         boost::intrusive::member_hook<evictable, evictable::lru_link_type, &evictable::_lru_link>,
         boost::intrusive::constant_time_size<false>>; // we need this to have bi::auto_unlink on hooks.
-    lru_type _list;
+    lru_type _list; // The protected segment.
+    lru_type _probation_list;
+    size_t _size = 0;
+    size_t _probation_size = 0;
 
     // See the comment to index_evictable.
     using index_lru_type = boost::intrusive::list<index_evictable,
@@ -91,8 +123,31 @@ class lru {
 
     using reclaiming_result = seastar::memory::reclaiming_result;
 
+    bool protected_segment_too_large() const noexcept {
+        return _size > (_size + _probation_size) * protected_fraction;
+    }
+
+    // Demotes the least recently used elements of the protected segment until it fits in
+    // protected_fraction, or until its least recently used element doesn't support probation.
+    void demote() noexcept {
+        while (protected_segment_too_large()) {
+            evictable& e = _list.front();
+            if (!e.set_on_probation(true)) {
+                break;
+            }
+            _list.pop_front();
+            --_size;
+            _probation_list.push_back(e);
+            ++_probation_size;
+        }
+    }
 public:
     ~lru() {
+        while (!_probation_list.empty()) {
+            evictable& e = _probation_list.front();
+            remove(e);
+            e.on_evicted();
+        }
         while (!_list.empty()) {
             evictable& e = _list.front();
             remove(e);
@@ -101,14 +156,49 @@ class lru {
     }
 
     void remove(evictable& e) noexcept {
-        _list.erase(_list.iterator_to(e));
+        if (e.on_probation()) {
+            _probation_list.erase(_probation_list.iterator_to(e));
+            --_probation_size;
+            e.set_on_probation(false);
+        } else {
+            _list.erase(_list.iterator_to(e));
+            --_size;
+        }
         if (e.is_index()) {
             _index_list.erase(_index_list.iterator_to(static_cast<index_evictable&>(e)));
         }
     }
 
     void add(evictable& e) noexcept {
+        e.set_on_probation(false);
         _list.push_back(e);
+        ++_size;
+        if (e.is_index()) {
+            _index_list.push_back(static_cast<index_evictable&>(e));
+        }
+    }
+
+    // Like add(e) but links e as the least recently used element, so that it is
+    // evicted first in the absence of later touches.
+    void add_cold(evictable& e) noexcept {
+        e.set_on_probation(false);
+        _list.push_front(e);
+        ++_size;
+        if (e.is_index()) {
+            _index_list.push_front(static_cast<index_evictable&>(e));
+        }
+    }
+
+    // Like add(e) but links e as the most recently used element of the probationary segment,
+    // so that it is evicted before the protected segment unless touched again.
+    // Falls back to add(e) if e doesn't support probation.
+    void add_on_probation(evictable& e) noexcept {
+        if (!e.set_on_probation(true)) {
+            add(e);
+            return;
+        }
+        _probation_list.push_back(e);
+        ++_probation_size;
         if (e.is_index()) {
             _index_list.push_back(static_cast<index_evictable&>(e));
         }
@@ -116,7 +206,14 @@ class lru {
 
     // Like add(e) but makes sure that e is evicted right before "more_recent" in the absence of later touches.
     void add_before(evictable& more_recent, evictable& e) noexcept {
-        _list.insert(_list.iterator_to(more_recent), e);
+        if (more_recent.on_probation() && e.set_on_probation(true)) {
+            _probation_list.insert(_probation_list.iterator_to(more_recent), e);
+            ++_probation_size;
+        } else {
+            e.set_on_probation(false);
+            _list.insert(_list.iterator_to(more_recent), e);
+            ++_size;
+        }
     }
 
     void touch(evictable& e) noexcept {
@@ -124,18 +221,56 @@ class lru {
         add(e);
     }
 
+    // Number of elements in the probationary segment.
+    size_t probation_size() const noexcept {
+        return _probation_size;
+    }
+
+    // Number of elements in the protected segment.
+    size_t protected_size() const noexcept {
+        return _size;
+    }
+
+    // Returns the first element among the at most `limit` ones which would be evicted next,
+    // in eviction order, for which pred returns true. Returns nullptr if there's none.
+    template <typename Predicate>
+    requires std::is_invocable_r_v<bool, Predicate, evictable&>
+    evictable* find_cold(size_t limit, Predicate&& pred) noexcept {
+        for (lru_type* l : {&_probation_list, &_list}) {
+            for (evictable& e : *l) {
+                if (!limit--) {
+                    return nullptr;
+                }
+                if (pred(e)) {
+                    return &e;
+                }
+            }
+        }
+        return nullptr;
+    }
+
     // Evicts a single element from the LRU
     template <bool Shallow = false>
     reclaiming_result do_evict(bool should_evict_index) noexcept {
-        if (_list.empty()) {
+        if (_list.empty() && _probation_list.empty()) {
             return reclaiming_result::reclaimed_nothing;
         }
-        evictable& e = (should_evict_index && !_index_list.empty()) ? _index_list.front() : _list.front();
-        remove(e);
+        demote();
+        evictable* e;
+        if (should_evict_index && !_index_list.empty()) {
+            e = &_index_list.front();
+        } else if (_probation_list.empty() || protected_segment_too_large()) {
+            // In the latter case the least recently used protected element doesn't support
+            // probation, so it's an index entry, which can be evicted out of order.
+            e = &_list.front();
+        } else {
+            e = &_probation_list.front();
+        }
+        remove(*e);
         if constexpr (!Shallow) {
-            e.on_evicted();
+            e->on_evicted();
         } else {
-            e.on_evicted_shallow();
+            e->on_evicted_shallow();
         }
         return reclaiming_result::reclaimed_something;
     }
@@ -564,6 +564,46 @@ sstring quote_json_string(const sstring& value) {
     return oss.str();
 }
 
+void append_quoted_json_string(std::string& out, std::string_view value) {
+    static constexpr char hex[] = "0123456789ABCDEF";
+    out.push_back('"');
+    for (char c : value) {
+        switch (c) {
+        case '"':
+            out.append("\\\"");
+            break;
+        case '\\':
+            out.append("\\\\");
+            break;
+        case '\b':
+            out.append("\\b");
+            break;
+        case '\f':
+            out.append("\\f");
+            break;
+        case '\n':
+            out.append("\\n");
+            break;
+        case '\r':
+            out.append("\\r");
+            break;
+        case '\t':
+            out.append("\\t");
+            break;
+        default:
+            if (is_control_char(c)) {
+                out.append("\\u00");
+                out.push_back(hex[(c >> 4) & 0xF]);
+                out.push_back(hex[c & 0xF]);
+            } else {
+                out.push_back(c);
+            }
+            break;
+        }
+    }
+    out.push_back('"');
+}
+
 } // end namespace rjson
 
 std::ostream& std::operator<<(std::ostream& os, const rjson::value& v) {
@@ -334,6 +334,9 @@ rjson::value from_string_map(const std::map<sstring, sstring>& map);
 // The function operates on sstrings for historical reasons.
 sstring quote_json_string(const sstring& value);
 
+// Appends the value, quoted and escaped as a JSON string, to out.
+void append_quoted_json_string(std::string& out, std::string_view value);
+
 inline bytes base64_decode(const value& v) {
     return ::base64_decode(std::string_view(v.GetString(), v.GetStringLength()));
 }
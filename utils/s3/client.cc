@@ -8,6 +8,7 @@
 
 #include <initializer_list>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <rapidxml.h>
 #include <boost/algorithm/string/split.hpp>
@@ -15,6 +16,7 @@
 #include <boost/range/adaptor/map.hpp>
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/gate.hh>
+#include <seastar/core/later.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/util/short_streams.hh>
 #include <seastar/http/request.hh>
@@ -165,7 +167,7 @@ client::group_client& client::find_or_create_client() {
         // Limit the maximum number of connections this group's http client
         // may have proportional to its shares. Shares are typically in the
         // range of 100...1000, thus resulting in 1..10 connections
-        auto max_connections = std::max((unsigned)(sg.get_shares() / 100), 1u);
+        auto max_connections = _cfg->max_connections.value_or(std::max((unsigned)(sg.get_shares() / 100), 1u));
         it = _https.emplace(std::piecewise_construct,
             std::forward_as_tuple(sg),
             std::forward_as_tuple(std::move(factory), max_connections)
@@ -416,11 +418,13 @@ class client::upload_sink_base : public data_sink_impl {
     sstring _upload_id;
     utils::chunked_vector<sstring> _part_etags;
     gate _bg_flushes;
+    std::optional<semaphore> _parts_in_flight;
 
     future<> start_upload();
     future<> finalize_upload();
     future<> upload_part(memory_data_sink_buffers bufs);
     future<> upload_part(std::unique_ptr<upload_sink> source);
+    future<> copy_part(sstring source_name, range r);
     future<> abort_upload();
 
     bool upload_started() const noexcept {
@@ -432,6 +436,9 @@ class client::upload_sink_base : public data_sink_impl {
         : _client(std::move(cln))
         , _object_name(std::move(object_name))
     {
+        if (auto n = _client->_cfg->upload_parts_in_flight) {
+            _parts_in_flight.emplace(std::max(*n, 1u));
+        }
     }
 
     virtual future<> put(net::packet) override {
@@ -547,6 +554,12 @@ future<> client::upload_sink_base::upload_part(memory_data_sink_buffers bufs) {
         co_await start_upload();
     }
 
+    // Released once the part upload completes, so at most that many parts
+    // keep their buffers and a connection busy at a time.
+    std::optional<semaphore_units<>> in_flight;
+    if (_parts_in_flight) {
+        in_flight.emplace(co_await get_units(*_parts_in_flight, 1));
+    }
     auto claim = co_await _client->claim_memory(bufs.size());
 
     unsigned part_number = _part_etags.size();
@@ -598,7 +611,7 @@ future<> client::upload_sink_base::upload_part(memory_data_sink_buffers bufs) {
     }).handle_exception([this, part_number] (auto ex) {
         // ... the exact exception only remains in logs
         s3l.warn("couldn't upload part {}: {} (upload id {})", part_number, ex, _upload_id);
-    }).finally([gh = std::move(gh)] {});
+    }).finally([gh = std::move(gh), in_flight = std::move(in_flight)] {});
 }
 
 future<> client::upload_sink_base::abort_upload() {
@@ -736,6 +749,37 @@ future<> client::upload_sink_base::upload_part(std::unique_ptr<upload_sink> piec
     }).finally([gh = std::move(gh), piece_ptr = std::move(piece_ptr)] {});
 }
 
+future<> client::upload_sink_base::copy_part(sstring source_name, range r) {
+    if (!upload_started()) {
+        co_await start_upload();
+    }
+
+    unsigned part_number = _part_etags.size();
+    _part_etags.emplace_back();
+    s3l.trace("PUT part {} from {} bytes {}-{} (upload id {})", part_number, source_name, r.off, r.off + r.len - 1, _upload_id);
+    auto req = http::request::make("PUT", _client->_host, _object_name);
+    req.query_parameters["partNumber"] = format("{}", part_number + 1);
+    req.query_parameters["uploadId"] = _upload_id;
+    req._headers["x-amz-copy-source"] = source_name;
+    req._headers["x-amz-copy-source-range"] = format("bytes={}-{}", r.off, r.off + r.len - 1);
+
+    // See comment in upload_part(memory_data_sink_buffers) overload regarding the
+    // _bg_flushes usage and _part_etags assignments
+    auto gh = _bg_flushes.hold();
+    (void)_client->make_request(std::move(req), [this, part_number] (const http::reply& rep, input_stream<char>&& in_) mutable -> future<> {
+        auto in = std::move(in_);
+        auto body = co_await util::read_entire_stream_contiguous(in);
+        auto etag = parse_multipart_copy_upload_etag(body);
+        if (etag.empty()) {
+            co_await coroutine::return_exception(std::runtime_error("cannot copy part upload"));
+        }
+        s3l.trace("copy-uploaded {} part data -> etag = {} (upload id {})", part_number, etag, _upload_id);
+        _part_etags[part_number] = std::move(etag);
+    }).handle_exception([this, part_number] (auto ex) {
+        s3l.warn("couldn't copy-upload part {}: {} (upload id {})", part_number, ex, _upload_id);
+    }).finally([gh = std::move(gh)] {});
+}
+
 class client::upload_jumbo_sink final : public upload_sink_base {
     // "Part numbers can be any number from 1 to 10,000, inclusive."
     // https://docs.aws.amazon.com/AmazonS3/latest/API/API_UploadPart.html
@@ -787,6 +831,61 @@ class client::upload_jumbo_sink final : public upload_sink_base {
     }
 };
 
+// Copies objects too large for a single CopyObject request, part by
+// part, with UploadPartCopy.
+class client::multipart_copy final : public upload_sink_base {
+public:
+    // "The maximum size of an object you can copy in a single operation is 5 GB"
+    // https://docs.aws.amazon.com/AmazonS3/latest/API/API_CopyObject.html
+    static constexpr uint64_t maximum_part_size = 5ull << 30;
+
+    multipart_copy(shared_ptr<client> cln, sstring object_name)
+        : upload_sink_base(std::move(cln), std::move(object_name))
+    {}
+
+    virtual future<> put(temporary_buffer<char>) override {
+        throw_with_backtrace<std::runtime_error>("s3 multipart copy doesn't take data");
+    }
+
+    future<> copy(sstring source_name, uint64_t size) {
+        for (uint64_t off = 0; off < size; off += maximum_part_size) {
+            co_await copy_part(source_name, range{off, std::min(maximum_part_size, size - off)});
+        }
+        co_await finalize_upload();
+    }
+};
+
+future<> client::copy_object(sstring source_name, sstring target_name) {
+    auto size = co_await get_object_size(source_name);
+    if (size > multipart_copy::maximum_part_size) {
+        multipart_copy copy(shared_from_this(), std::move(target_name));
+        std::exception_ptr ex;
+        try {
+            co_await copy.copy(std::move(source_name), size);
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await copy.close();
+        if (ex) {
+            co_await coroutine::return_exception_ptr(std::move(ex));
+        }
+        co_return;
+    }
+
+    // see https://docs.aws.amazon.com/AmazonS3/latest/API/API_CopyObject.html
+    s3l.trace("PUT {} copy of {}", target_name, source_name);
+    auto req = http::request::make("PUT", _host, target_name);
+    req._headers["x-amz-copy-source"] = source_name;
+    co_await make_request(std::move(req), [&target_name] (const http::reply& rep, input_stream<char>&& in_) -> future<> {
+        auto in = std::move(in_);
+        auto body = co_await util::read_entire_stream_contiguous(in);
+        // The copy may fail after the 200 OK status was sent, the body tells
+        if (body.find("<CopyObjectResult") == sstring::npos) {
+            co_await coroutine::return_exception(std::runtime_error(format("cannot copy object to {}", target_name)));
+        }
+    });
+}
+
 data_sink client::make_upload_sink(sstring object_name) {
     return data_sink(std::make_unique<upload_sink>(shared_from_this(), std::move(object_name)));
 }
@@ -799,10 +898,91 @@ class client::readable_file : public file_impl {
     shared_ptr<client> _client;
     sstring _object_name;
 
+    // Reads issued back to back, e.g. by read-ahead or by several readers of
+    // nearby index pages, are collected until the next task quota and the ones
+    // that are close to each other are served by a single ranged GET.
+    static constexpr uint64_t coalescing_gap = 16 << 10;
+    static constexpr uint64_t max_coalesced_size = 1 << 20;
+
+    struct pending_read {
+        range rng;
+        promise<temporary_buffer<char>> pr;
+    };
+    std::vector<pending_read> _pending;
+
     [[noreturn]] void unsupported() {
         throw_with_backtrace<std::logic_error>("unsupported operation on s3 readable file");
     }
 
+    future<temporary_buffer<char>> read_range(range r) {
+        if (r.len == 0) {
+            return make_ready_future<temporary_buffer<char>>();
+        }
+        _pending.push_back(pending_read{r, {}});
+        auto f = _pending.back().pr.get_future();
+        if (_pending.size() == 1) {
+            // Callers wait for the returned futures, so they keep the file alive until then
+            (void)yield().then([this] {
+                return read_pending();
+            }).handle_exception([] (std::exception_ptr ex) {
+                // The pending reads get broken_promise
+                s3l.warn("couldn't issue coalesced reads: {}", ex);
+            });
+        }
+        return f;
+    }
+
+    future<> read_coalesced(std::span<pending_read> reads) {
+        auto off = reads.front().rng.off;
+        uint64_t end = off;
+        for (auto& r : reads) {
+            end = std::max(end, r.rng.off + r.rng.len);
+        }
+        if (reads.size() > 1) {
+            s3l.trace("coalesced {} reads of {} into bytes {}-{}", reads.size(), _object_name, off, end - 1);
+        }
+        temporary_buffer<char> buf;
+        try {
+            buf = co_await _client->get_object_contiguous(_object_name, range{ off, end - off });
+        } catch (...) {
+            auto ex = std::current_exception();
+            for (auto& r : reads) {
+                r.pr.set_exception(ex);
+            }
+            co_return;
+        }
+        for (auto& r : reads) {
+            auto pos = r.rng.off - off;
+            if (pos >= buf.size()) {
+                r.pr.set_value(temporary_buffer<char>());
+            } else {
+                r.pr.set_value(buf.share(pos, std::min(r.rng.len, buf.size() - pos)));
+            }
+        }
+    }
+
+    future<> read_pending() {
+        auto reads = std::exchange(_pending, {});
+        std::ranges::sort(reads, std::less<>(), [] (const pending_read& r) { return r.rng.off; });
+        std::vector<std::span<pending_read>> groups;
+        size_t begin = 0;
+        uint64_t end = reads[0].rng.off + reads[0].rng.len;
+        for (size_t i = 1; i < reads.size(); i++) {
+            auto& r = reads[i];
+            auto new_end = std::max(end, r.rng.off + r.rng.len);
+            if (r.rng.off > end + coalescing_gap || new_end - reads[begin].rng.off > max_coalesced_size) {
+                groups.emplace_back(reads.data() + begin, i - begin);
+                begin = i;
+                new_end = r.rng.off + r.rng.len;
+            }
+            end = new_end;
+        }
+        groups.emplace_back(reads.data() + begin, reads.size() - begin);
+        co_await coroutine::parallel_for_each(groups, [this] (std::span<pending_read> group) {
+            return read_coalesced(group);
+        });
+    }
+
 public:
     readable_file(shared_ptr<client> cln, sstring object_name)
         : _client(std::move(cln))
@@ -861,13 +1041,13 @@ class client::readable_file : public file_impl {
     }
 
     virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, io_intent*) override {
-        auto buf = co_await _client->get_object_contiguous(_object_name, range{ pos, len });
+        auto buf = co_await read_range(range{ pos, len });
         std::copy_n(buf.get(), buf.size(), reinterpret_cast<uint8_t*>(buffer));
         co_return buf.size();
     }
 
     virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, io_intent*) override {
-        auto buf = co_await _client->get_object_contiguous(_object_name, range{ pos, utils::iovec_len(iov) });
+        auto buf = co_await read_range(range{ pos, utils::iovec_len(iov) });
         uint64_t off = 0;
         for (auto& v : iov) {
             auto sz = std::min(v.iov_len, buf.size() - off);
@@ -881,7 +1061,7 @@ class client::readable_file : public file_impl {
     }
 
     virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, io_intent*) override {
-        auto buf = co_await _client->get_object_contiguous(_object_name, range{ offset, range_size });
+        auto buf = co_await read_range(range{ offset, range_size });
         co_return temporary_buffer<uint8_t>(reinterpret_cast<uint8_t*>(buf.get_write()), buf.size(), buf.release());
     }
 
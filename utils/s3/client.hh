@@ -43,6 +43,7 @@ class client : public enable_shared_from_this<client> {
     class upload_sink_base;
     class upload_sink;
     class upload_jumbo_sink;
+    class multipart_copy;
     class readable_file;
     std::string _host;
     endpoint_config_ptr _cfg;
@@ -94,6 +95,9 @@ class client : public enable_shared_from_this<client> {
     future<> put_object(sstring object_name, temporary_buffer<char> buf);
     future<> put_object(sstring object_name, ::memory_data_sink_buffers bufs);
     future<> delete_object(sstring object_name);
+    // Copies the object within the object storage, the data never goes
+    // through this client.
+    future<> copy_object(sstring source_name, sstring target_name);
 
     file make_readable_file(sstring object_name);
     data_sink make_upload_sink(sstring object_name);
@@ -28,6 +28,14 @@ struct endpoint_config {
     };
 
     std::optional<aws_config> aws;
+
+    // Maximum number of connections to the endpoint each scheduling group
+    // may have. When unset, it's derived from the group's shares.
+    std::optional<unsigned> max_connections;
+    // Maximum number of parts of a single multipart upload which can be
+    // uploaded at the same time. When unset, only the connections limit and
+    // the client memory apply.
+    std::optional<unsigned> upload_parts_in_flight;
 };
 
 using endpoint_config_ptr = seastar::lw_shared_ptr<endpoint_config>;
@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/seastar.hh>
+#include "utils/s3/disk_cache.hh"
+#include "utils/small_vector.hh"
+#include "utils/lister.hh"
+#include "log.hh"
+
+namespace s3 {
+
+static logging::logger s3cl("s3_cache");
+
+static constexpr std::string_view tmp_suffix = ".tmp";
+
+disk_cache::disk_cache(std::filesystem::path dir, size_t capacity)
+    : _dir(std::move(dir))
+    , _capacity(capacity)
+{
+    namespace sm = seastar::metrics;
+    _metrics.add_group("s3_cache", {
+        sm::make_counter("hits", [this] { return _stats.hits; },
+            sm::description("Object block reads served from the local disk cache")),
+        sm::make_counter("misses", [this] { return _stats.misses; },
+            sm::description("Object block reads which had to go to the object storage")),
+        sm::make_counter("evictions", [this] { return _stats.evictions; },
+            sm::description("Object blocks evicted from the local disk cache")),
+        sm::make_gauge("used_bytes", [this] { return _stats.used_bytes; },
+            sm::description("Amount of bytes used by object blocks in the local disk cache")),
+    });
+}
+
+sstring disk_cache::block_file_name(const sstring& object_name, uint64_t block) {
+    sstring escaped;
+    for (auto c : object_name) {
+        switch (c) {
+        case '/': escaped += "%2F"; break;
+        case '%': escaped += "%25"; break;
+        default: escaped += c;
+        }
+    }
+    return format("{}.{}", escaped, block);
+}
+
+future<> disk_cache::ensure_loaded() {
+    if (!_loaded) {
+        _loaded.emplace(load());
+    }
+    return _loaded->get_future();
+}
+
+future<> disk_cache::load() {
+    co_await recursive_touch_directory(_dir.native());
+    co_await lister::scan_dir(_dir, lister::dir_entry_types::of<directory_entry_type::regular>(), [this] (std::filesystem::path dir, directory_entry de) -> future<> {
+        auto path = dir / de.name.c_str();
+        if (std::string_view(de.name).ends_with(tmp_suffix)) {
+            // Left behind by a store interrupted by a restart
+            co_await remove_file(path.native());
+            co_return;
+        }
+        auto size = co_await file_size(path.native());
+        _blocks.emplace(de.name, _lru.insert(_lru.end(), block_entry{de.name, size}));
+        _stats.used_bytes += size;
+    });
+    evict_to_fit(0);
+    s3cl.info("Loaded {} cached blocks ({} bytes) from {}", _blocks.size(), _stats.used_bytes, _dir.native());
+}
+
+void disk_cache::evict_to_fit(size_t size) {
+    while (!_lru.empty() && _stats.used_bytes + size > _capacity) {
+        auto e = std::move(_lru.front());
+        _lru.pop_front();
+        _blocks.erase(e.name);
+        _stats.used_bytes -= e.size;
+        ++_stats.evictions;
+        if (!_gate.is_closed()) {
+            // Readers which already opened the file can keep reading it
+            (void)with_gate(_gate, [path = (_dir / e.name.c_str()).native()] {
+                return remove_file(path).handle_exception([path] (std::exception_ptr ep) {
+                    s3cl.warn("Failed to remove evicted block {}: {}", path, ep);
+                });
+            });
+        }
+    }
+}
+
+future<std::optional<temporary_buffer<char>>> disk_cache::get(const sstring& object_name, uint64_t block) {
+    auto holder = _gate.hold();
+    co_await ensure_loaded();
+    auto name = block_file_name(object_name, block);
+    auto it = _blocks.find(name);
+    if (it == _blocks.end()) {
+        ++_stats.misses;
+        co_return std::nullopt;
+    }
+    _lru.splice(_lru.end(), _lru, it->second);
+    auto size = it->second->size;
+
+    std::optional<temporary_buffer<char>> ret;
+    std::exception_ptr ex;
+    try {
+        auto f = co_await open_file_dma((_dir / name.c_str()).native(), open_flags::ro);
+        try {
+            ret = co_await f.dma_read_bulk<char>(0, size);
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        co_await f.close();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    if (ex) {
+        // Most likely evicted in the meantime
+        s3cl.debug("Failed to read cached block {}: {}", name, ex);
+        ++_stats.misses;
+        co_return std::nullopt;
+    }
+    if (ret->size() != size) {
+        s3cl.warn("Cached block {} is {} bytes long, expected {}", name, ret->size(), size);
+        ++_stats.misses;
+        co_return std::nullopt;
+    }
+    ++_stats.hits;
+    co_return ret;
+}
+
+void disk_cache::put(const sstring& object_name, uint64_t block, temporary_buffer<char> data) {
+    if (_gate.is_closed() || data.empty() || data.size() > block_size || data.size() > _capacity) {
+        return;
+    }
+    auto name = block_file_name(object_name, block);
+    if (_blocks.contains(name) || !_storing.insert(name).second) {
+        return;
+    }
+    (void)with_gate(_gate, [this, name = std::move(name), data = std::move(data)] () mutable {
+        return store(name, std::move(data)).handle_exception([name] (std::exception_ptr ep) {
+            s3cl.warn("Failed to cache block {}: {}", name, ep);
+        }).finally([this, name] {
+            _storing.erase(name);
+        });
+    });
+}
+
+future<> disk_cache::store(sstring name, temporary_buffer<char> data) {
+    co_await ensure_loaded();
+    auto tmp_path = (_dir / (name + sstring(tmp_suffix)).c_str()).native();
+    auto f = co_await open_file_dma(tmp_path, open_flags::wo | open_flags::create | open_flags::truncate);
+    auto out = co_await make_file_output_stream(std::move(f));
+    std::exception_ptr ex;
+    try {
+        co_await out.write(data.get(), data.size());
+        co_await out.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await out.close();
+    if (ex) {
+        co_await remove_file(tmp_path);
+        std::rethrow_exception(ex);
+    }
+    // Publish the block only once it is complete, so that a restart never picks up a partial one.
+    co_await rename_file(tmp_path, (_dir / name.c_str()).native());
+    evict_to_fit(data.size());
+    _blocks.emplace(name, _lru.insert(_lru.end(), block_entry{name, data.size()}));
+    _stats.used_bytes += data.size();
+}
+
+future<> disk_cache::stop() {
+    return _gate.close();
+}
+
+namespace {
+
+class cached_object_file : public file_impl {
+    shared_ptr<disk_cache> _cache; // null on shards other than the one the file was opened on
+    sstring _object_name;
+    file _underlying;
+
+    static constexpr size_t block_size = disk_cache::block_size;
+
+    [[noreturn]] void unsupported() {
+        throw_with_backtrace<std::logic_error>("unsupported operation on cached s3 readable file");
+    }
+
+    future<temporary_buffer<char>> fetch(uint64_t first_block, uint64_t nr_blocks) {
+        auto buf = co_await _underlying.dma_read_bulk<char>(first_block * block_size, nr_blocks * block_size);
+        for (uint64_t i = 0; i * block_size < buf.size(); i++) {
+            auto len = std::min(block_size, buf.size() - i * block_size);
+            _cache->put(_object_name, first_block + i, buf.share(i * block_size, len));
+        }
+        co_return buf;
+    }
+
+    // Reads [offset, offset + len) through the cache. Blocks which are not
+    // cached are fetched in one request spanning from the first missing
+    // block to the last missing one.
+    future<temporary_buffer<char>> read(uint64_t offset, size_t len) {
+        if (!_cache || !len) {
+            co_return co_await _underlying.dma_read_bulk<char>(offset, len);
+        }
+        auto first = offset / block_size;
+        auto last = (offset + len - 1) / block_size;
+        utils::small_vector<temporary_buffer<char>, 4> blocks;
+        std::optional<uint64_t> first_missing, last_missing;
+        for (auto b = first; b <= last; b++) {
+            auto cached = co_await _cache->get(_object_name, b);
+            if (!cached) {
+                first_missing = first_missing.value_or(b);
+                last_missing = b;
+            }
+            blocks.push_back(cached ? std::move(*cached) : temporary_buffer<char>());
+        }
+        if (first_missing) {
+            auto fetched = co_await fetch(*first_missing, *last_missing - *first_missing + 1);
+            for (auto b = *first_missing; b <= *last_missing; b++) {
+                auto pos = (b - *first_missing) * block_size;
+                auto& blk = blocks[b - first];
+                if (blk.empty() && pos < fetched.size()) {
+                    blk = fetched.share(pos, std::min(block_size, fetched.size() - pos));
+                }
+            }
+        }
+
+        auto skip = offset - first * block_size;
+        if (blocks.size() == 1) {
+            auto& blk = blocks.front();
+            if (skip >= blk.size()) {
+                co_return temporary_buffer<char>();
+            }
+            blk.trim_front(skip);
+            blk.trim(std::min(len, blk.size()));
+            co_return std::move(blk);
+        }
+        temporary_buffer<char> ret(len);
+        size_t filled = 0;
+        for (auto& blk : blocks) {
+            if (skip < blk.size()) {
+                auto n = std::min(blk.size() - skip, len - filled);
+                std::copy_n(blk.get() + skip, n, ret.get_write() + filled);
+                filled += n;
+            }
+            if (blk.size() < block_size) {
+                break; // end of object
+            }
+            skip = 0;
+        }
+        ret.trim(filled);
+        co_return ret;
+    }
+
+public:
+    cached_object_file(shared_ptr<disk_cache> cache, sstring object_name, file underlying)
+        : _cache(std::move(cache))
+        , _object_name(std::move(object_name))
+        , _underlying(std::move(underlying))
+    {
+    }
+
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, io_intent*) override { unsupported(); }
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, io_intent*) override { unsupported(); }
+    virtual future<> truncate(uint64_t length) override { unsupported(); }
+    virtual subscription<directory_entry> list_directory(std::function<future<> (directory_entry de)> next) override { unsupported(); }
+
+    virtual future<> flush(void) override { return make_ready_future<>(); }
+    virtual future<> allocate(uint64_t position, uint64_t length) override { return make_ready_future<>(); }
+    virtual future<> discard(uint64_t offset, uint64_t length) override { return make_ready_future<>(); }
+
+    class handle_impl final : public file_handle_impl {
+        file_handle _h;
+        sstring _object_name;
+    public:
+        handle_impl(file_handle h, sstring object_name)
+                : _h(std::move(h))
+                , _object_name(std::move(object_name))
+        {}
+
+        virtual std::unique_ptr<file_handle_impl> clone() const override {
+            return std::make_unique<handle_impl>(_h, _object_name);
+        }
+
+        // The cache is shard-local, so the file opened from the handle
+        // reads the object directly.
+        virtual shared_ptr<file_impl> to_file() && override {
+            return make_shared<cached_object_file>(nullptr, std::move(_object_name), std::move(_h).to_file());
+        }
+    };
+
+    virtual std::unique_ptr<file_handle_impl> dup() override {
+        return std::make_unique<handle_impl>(_underlying.dup(), _object_name);
+    }
+
+    virtual future<uint64_t> size(void) override {
+        return _underlying.size();
+    }
+
+    virtual future<struct stat> stat(void) override {
+        return _underlying.stat();
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, io_intent*) override {
+        auto buf = co_await read(pos, len);
+        std::copy_n(buf.get(), buf.size(), reinterpret_cast<char*>(buffer));
+        co_return buf.size();
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, io_intent*) override {
+        size_t len = 0;
+        for (auto& v : iov) {
+            len += v.iov_len;
+        }
+        auto buf = co_await read(pos, len);
+        uint64_t off = 0;
+        for (auto& v : iov) {
+            auto sz = std::min(v.iov_len, buf.size() - off);
+            if (sz == 0) {
+                break;
+            }
+            std::copy_n(buf.get() + off, sz, reinterpret_cast<char*>(v.iov_base));
+            off += sz;
+        }
+        co_return off;
+    }
+
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, io_intent*) override {
+        auto buf = co_await read(offset, range_size);
+        co_return temporary_buffer<uint8_t>(reinterpret_cast<uint8_t*>(buf.get_write()), buf.size(), buf.release());
+    }
+
+    virtual future<> close() override {
+        return _underlying.close();
+    }
+};
+
+} // anonymous namespace
+
+file make_cached_file(shared_ptr<disk_cache> cache, sstring object_name, file underlying) {
+    return file(make_shared<cached_object_file>(std::move(cache), std::move(object_name), std::move(underlying)));
+}
+
+} // s3 namespace
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <seastar/core/file.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/shared_ptr.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+using namespace seastar;
+
+namespace s3 {
+
+// Read-through cache of S3 object ranges kept on local disk.
+//
+// Objects are split into fixed size blocks, each block is stored in its own
+// file in the cache directory. Objects are never modified once uploaded, so
+// cached blocks never need to be invalidated, they only get evicted in LRU
+// order when the total size exceeds the capacity. The directory contents are
+// picked up again on restart, in no particular LRU order.
+//
+// The cache is shard-local and the directory must not be shared with other
+// shards or processes.
+class disk_cache : public enable_shared_from_this<disk_cache> {
+public:
+    static constexpr size_t block_size = 128 * 1024;
+
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t used_bytes = 0;
+    };
+private:
+    struct block_entry {
+        sstring name;
+        size_t size;
+    };
+    using lru_type = std::list<block_entry>;
+
+    std::filesystem::path _dir;
+    size_t _capacity;
+    lru_type _lru; // least recently used first
+    std::unordered_map<sstring, lru_type::iterator> _blocks;
+    std::unordered_set<sstring> _storing; // blocks being written to disk
+    std::optional<shared_future<>> _loaded;
+    gate _gate;
+    stats _stats;
+    seastar::metrics::metric_groups _metrics;
+
+    static sstring block_file_name(const sstring& object_name, uint64_t block);
+    future<> ensure_loaded();
+    future<> load();
+    future<> store(sstring name, temporary_buffer<char> data);
+    void evict_to_fit(size_t size);
+public:
+    disk_cache(std::filesystem::path dir, size_t capacity);
+
+    // Returns the cached contents of the given block of the object,
+    // or a disengaged optional if they are not cached.
+    future<std::optional<temporary_buffer<char>>> get(const sstring& object_name, uint64_t block);
+    // Stores the contents of the given block of the object, in the background.
+    // Only the last block of an object may be shorter than block_size.
+    void put(const sstring& object_name, uint64_t block, temporary_buffer<char> data);
+
+    const stats& get_stats() const noexcept { return _stats; }
+
+    future<> stop();
+};
+
+// Wraps a file reading an S3 object so that reads are served from the cache
+// where possible, and blocks fetched from the underlying file populate it.
+file make_cached_file(shared_ptr<disk_cache> cache, sstring object_name, file underlying);
+
+} // s3 namespace
@@ -55,9 +55,35 @@ class xx_hasher {
     }
 };
 
+// Hashes with xxh3, which is much faster than xxh64 on long inputs. Meant for
+// few large updates, such as hashing already serialized data.
+class xx3_hasher {
+    XXH3_state_t _state;
+
+public:
+    explicit xx3_hasher(uint64_t seed = 0) noexcept {
+        XXH3_64bits_reset_withSeed(&_state, seed);
+    }
+
+    void update(const char* ptr, size_t length) noexcept {
+        XXH3_64bits_update(&_state, ptr, length);
+    }
+
+    uint64_t finalize_uint64() noexcept {
+        return XXH3_64bits_digest(&_state);
+    }
+};
+
 // Used to specialize templates in order to fix a bug
 // in handling null values: #4567
 class legacy_xx_hasher_without_null_digest : public xx_hasher {
 public:
     explicit legacy_xx_hasher_without_null_digest(uint64_t seed = 0) noexcept : xx_hasher(seed) {}
 };
+
+// Used to specialize templates for digest_algorithm::xxHash_of_versions,
+// which hashes the size of atomic cell values instead of their contents.
+class xx_version_hasher : public xx_hasher {
+public:
+    explicit xx_version_hasher(uint64_t seed = 0) noexcept : xx_hasher(seed) {}
+};
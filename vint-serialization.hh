@@ -50,6 +50,16 @@ struct unsigned_vint final {
     static value_type deserialize(bytes_view v);
 
     static vint_size_type serialized_size_from_first_byte(bytes::value_type first_byte);
+
+    // Whether the vint starting with first_byte is one byte long.
+    static constexpr bool is_single_byte(bytes::value_type first_byte) noexcept {
+        return static_cast<int8_t>(first_byte) >= 0;
+    }
+
+    // Decodes a one byte long vint, see is_single_byte().
+    static constexpr value_type deserialize_single_byte(bytes::value_type first_byte) noexcept {
+        return value_type(static_cast<uint8_t>(first_byte));
+    }
 };
 
 struct signed_vint final {
@@ -62,4 +72,14 @@ struct signed_vint final {
     static value_type deserialize(bytes_view v);
 
     static vint_size_type serialized_size_from_first_byte(bytes::value_type first_byte);
+
+    static constexpr bool is_single_byte(bytes::value_type first_byte) noexcept {
+        return unsigned_vint::is_single_byte(first_byte);
+    }
+
+    static constexpr value_type deserialize_single_byte(bytes::value_type first_byte) noexcept {
+        // Zig-zag decoding, see the top of this file.
+        const auto n = unsigned_vint::deserialize_single_byte(first_byte);
+        return static_cast<int64_t>((n >> 1) ^ -(n & 1));
+    }
 };
@@ -12,19 +12,81 @@
 // which are available only when the library is linked statically.
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd.h"
+#include "zdict.h"
 
 #include "compress.hh"
+#include "utils/base64.hh"
 #include "utils/class_registrator.hh"
 #include "utils/reusable_buffer.hh"
 #include <concepts>
+#include <unordered_map>
 
 static const sstring COMPRESSION_LEVEL = "compression_level";
+static const sstring DICTIONARY_SIZE_KB = "dictionary_size_kb";
+// Set only on compressors instantiated from sstable metadata, holds the
+// base64-encoded dictionary. Not a user-settable option.
+static const sstring DICTIONARY = "dictionary";
 static const sstring COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdCompressor";
 static const size_t DCTX_SIZE = ZSTD_estimateDCtxSize();
+// CompressionInfo.db option values have a 16-bit length, and must
+// hold the dictionary in its base64 encoding.
+static constexpr size_t MAX_DICTIONARY_SIZE_KB = 32;
+
+// A digested decompression dictionary, shared by all compressors on
+// a shard which were instantiated with the same dictionary, so that
+// readers of an sstable don't digest it anew every time.
+class zstd_ddict : public enable_lw_shared_from_this<zstd_ddict> {
+    static thread_local std::unordered_map<sstring, zstd_ddict*> _cache;
+
+    sstring _encoded;
+    ZSTD_DDict* _ddict;
+public:
+    zstd_ddict(sstring encoded, const bytes& raw)
+        : _encoded(std::move(encoded))
+        , _ddict(ZSTD_createDDict(raw.data(), raw.size()))
+    {
+        if (!_ddict) {
+            throw std::runtime_error("Unable to create ZSTD decompression dictionary");
+        }
+        _cache.emplace(_encoded, this);
+    }
+    ~zstd_ddict() {
+        _cache.erase(_encoded);
+        ZSTD_freeDDict(_ddict);
+    }
+    zstd_ddict(const zstd_ddict&) = delete;
+    zstd_ddict& operator=(const zstd_ddict&) = delete;
+
+    const ZSTD_DDict* get() const noexcept {
+        return _ddict;
+    }
+
+    static lw_shared_ptr<zstd_ddict> get_or_create(const sstring& encoded, const bytes& raw) {
+        if (auto it = _cache.find(encoded); it != _cache.end()) {
+            return it->second->shared_from_this();
+        }
+        return make_lw_shared<zstd_ddict>(encoded, raw);
+    }
+};
+
+thread_local std::unordered_map<sstring, zstd_ddict*> zstd_ddict::_cache;
+
+struct zstd_cdict_deleter {
+    void operator()(ZSTD_CDict* cdict) const noexcept {
+        ZSTD_freeCDict(cdict);
+    }
+};
 
 class zstd_processor : public compressor {
     int _compression_level = 3;
     size_t _cctx_size;
+    int32_t _chunk_len;
+    size_t _dictionary_size = 0;
+    sstring _encoded_dictionary;
+    mutable std::unique_ptr<ZSTD_CDict, zstd_cdict_deleter> _cdict;
+    lw_shared_ptr<zstd_ddict> _ddict;
+
+    const ZSTD_CDict* get_cdict() const;
 
     static auto with_dctx(std::invocable<ZSTD_DCtx*> auto f) {
         // The decompression context has a fixed size of ~128 KiB,
@@ -80,6 +142,10 @@ class zstd_processor : public compressor {
                     size_t output_len) const override;
     size_t compress_max_size(size_t input_len) const override;
 
+    size_t dictionary_size() const override;
+    bytes train_dictionary(const std::vector<std::string_view>& samples) const override;
+    compressor_ptr with_dictionary(const bytes& dictionary) const override;
+
     std::set<sstring> option_names() const override;
     std::map<sstring, sstring> options() const override;
 };
@@ -107,19 +173,57 @@ zstd_processor::zstd_processor(const opt_getter& opts)
     if (!chunk_len_kb) {
         chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB_ERR);
     }
-    auto chunk_len = chunk_len_kb
+    _chunk_len = chunk_len_kb
        // This parameter has already been validated.
        ? std::stoi(*chunk_len_kb) * 1024
        : compression_parameters::DEFAULT_CHUNK_LENGTH;
 
+    auto dictionary_size_kb = opts(DICTIONARY_SIZE_KB);
+    if (dictionary_size_kb) {
+        size_t size_kb;
+        try {
+            size_kb = std::stoul(*dictionary_size_kb);
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(
+                format("Invalid integer value {} for {}", *dictionary_size_kb, DICTIONARY_SIZE_KB));
+        }
+        if (size_kb > MAX_DICTIONARY_SIZE_KB) {
+            throw exceptions::configuration_exception(
+                format("{} must be between 0 and {}, got {}", DICTIONARY_SIZE_KB, MAX_DICTIONARY_SIZE_KB, size_kb));
+        }
+        _dictionary_size = size_kb * 1024;
+    }
+
+    auto dictionary = opts(DICTIONARY);
+    if (dictionary && !dictionary->empty()) {
+        _encoded_dictionary = std::move(*dictionary);
+        _ddict = zstd_ddict::get_or_create(_encoded_dictionary, base64_decode(_encoded_dictionary));
+    }
+
     // We assume that the uncompressed input length is always <= chunk_len.
-    auto cparams = ZSTD_getCParams(_compression_level, chunk_len, 0);
+    auto cparams = ZSTD_getCParams(_compression_level, _chunk_len, _ddict ? base64_decoded_len(_encoded_dictionary) : 0);
     _cctx_size = ZSTD_estimateCCtxSize_usingCParams(cparams);
+}
 
+const ZSTD_CDict* zstd_processor::get_cdict() const {
+    // Only the writer which trained the dictionary compresses with it,
+    // so it is digested lazily, sparing the readers.
+    if (!_cdict) {
+        auto raw = base64_decode(_encoded_dictionary);
+        auto cparams = ZSTD_getCParams(_compression_level, _chunk_len, raw.size());
+        _cdict.reset(ZSTD_createCDict_advanced(raw.data(), raw.size(), ZSTD_dlm_byCopy, ZSTD_dct_fullDict, cparams, ZSTD_defaultCMem));
+        if (!_cdict) {
+            throw std::runtime_error("Unable to create ZSTD compression dictionary");
+        }
+    }
+    return _cdict.get();
 }
 
 size_t zstd_processor::uncompress(const char* input, size_t input_len, char* output, size_t output_len) const {
     auto ret = with_dctx([&] (ZSTD_DCtx* dctx) {
+        if (_ddict) {
+            return ZSTD_decompress_usingDDict(dctx, output, output_len, input, input_len, _ddict->get());
+        }
         return ZSTD_decompressDCtx(dctx, output, output_len, input, input_len);
     });
     if (ZSTD_isError(ret)) {
@@ -131,6 +235,9 @@ size_t zstd_processor::uncompress(const char* input, size_t input_len, char* out
 
 size_t zstd_processor::compress(const char* input, size_t input_len, char* output, size_t output_len) const {
     auto ret = with_cctx(_cctx_size, [&] (ZSTD_CCtx* cctx) {
+        if (_ddict) {
+            return ZSTD_compress_usingCDict(cctx, output, output_len, input, input_len, get_cdict());
+        }
         return ZSTD_compressCCtx(cctx, output, output_len, input, input_len, _compression_level);
     });
     if (ZSTD_isError(ret)) {
@@ -143,12 +250,65 @@ size_t zstd_processor::compress_max_size(size_t input_len) const {
     return ZSTD_compressBound(input_len);
 }
 
+size_t zstd_processor::dictionary_size() const {
+    // A compressor which already has a dictionary was instantiated
+    // for a particular sstable and is not going to train another one.
+    return _encoded_dictionary.empty() ? _dictionary_size : 0;
+}
+
+bytes zstd_processor::train_dictionary(const std::vector<std::string_view>& samples) const {
+    if (!dictionary_size()) {
+        return {};
+    }
+    std::vector<size_t> sample_sizes;
+    sample_sizes.reserve(samples.size());
+    size_t total_size = 0;
+    for (auto& sample : samples) {
+        sample_sizes.push_back(sample.size());
+        total_size += sample.size();
+    }
+    std::unique_ptr<char[]> samples_buffer(new char[total_size]);
+    auto out = samples_buffer.get();
+    for (auto& sample : samples) {
+        out = std::copy(sample.begin(), sample.end(), out);
+    }
+
+    bytes dict(bytes::initialized_later(), _dictionary_size);
+    auto ret = ZDICT_trainFromBuffer(dict.data(), dict.size(), samples_buffer.get(), sample_sizes.data(), sample_sizes.size());
+    if (ZDICT_isError(ret)) {
+        // Typically not enough samples, the data will do without a dictionary.
+        return {};
+    }
+    dict.resize(ret);
+    return dict;
+}
+
+compressor_ptr zstd_processor::with_dictionary(const bytes& dictionary) const {
+    std::map<sstring, sstring> opts = options();
+    opts.emplace(compression_parameters::CHUNK_LENGTH_KB, std::to_string(_chunk_len / 1024));
+    opts.emplace(DICTIONARY, base64_encode(dictionary));
+    return seastar::make_shared<zstd_processor>([&opts] (const sstring& key) -> opt_string {
+        auto it = opts.find(key);
+        if (it == opts.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    });
+}
+
 std::set<sstring> zstd_processor::option_names() const {
-    return {COMPRESSION_LEVEL};
+    return {COMPRESSION_LEVEL, DICTIONARY_SIZE_KB};
 }
 
 std::map<sstring, sstring> zstd_processor::options() const {
-    return {{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    std::map<sstring, sstring> opts{{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    if (_dictionary_size) {
+        opts.emplace(DICTIONARY_SIZE_KB, std::to_string(_dictionary_size / 1024));
+    }
+    if (!_encoded_dictionary.empty()) {
+        opts.emplace(DICTIONARY, _encoded_dictionary);
+    }
+    return opts;
 }
 
 static const class_registrator<compressor, zstd_processor, const compressor::opt_getter&>